@@ -53,13 +53,13 @@ if [[ $(uname -m) != "arm64" && $(uname) == "Darwin" ]]; then
 
 bazel build \
   ${BAZEL_OPTIMIZATION} \
-  -- //tensorflow_io:python/ops/libtensorflow_io.so //tensorflow_io:python/ops/libtensorflow_io_plugins.so //tensorflow_io_gcs_filesystem/...
+  -- //tensorflow_io:python/ops/op_libraries //tensorflow_io:python/ops/libtensorflow_io_plugins.so //tensorflow_io_gcs_filesystem/...
 
 elif [[ $(uname -m) == "arm64" && $(uname) == "Darwin" ]]; then
 
 bazel build \
   ${BAZEL_OPTIMIZATION} \
-  -- //tensorflow_io_gcs_filesystem/... //tensorflow_io:python/ops/libtensorflow_io.so //tensorflow_io:python/ops/libtensorflow_io_plugins.so
+  -- //tensorflow_io_gcs_filesystem/... //tensorflow_io:python/ops/op_libraries //tensorflow_io:python/ops/libtensorflow_io_plugins.so
 
 else
 
@@ -16,7 +16,12 @@
 
 @@ArrowDataset
 @@ArrowFeatherDataset
+@@ArrowFlightDataset
+@@ArrowScannerDataset
+@@ArrowShmStreamWriter
 @@ArrowStreamDataset
+@@ArrowWriter
+@@ParquetWriter
 @@list_feather_columns
 """
 
@@ -25,14 +30,24 @@ from tensorflow.python.util.all_util import remove_undocumented
 
 from tensorflow_io.python.ops.arrow_dataset_ops import ArrowDataset
 from tensorflow_io.python.ops.arrow_dataset_ops import ArrowFeatherDataset
+from tensorflow_io.python.ops.arrow_dataset_ops import ArrowFlightDataset
+from tensorflow_io.python.ops.arrow_dataset_ops import ArrowScannerDataset
+from tensorflow_io.python.ops.arrow_dataset_ops import ArrowShmStreamWriter
 from tensorflow_io.python.ops.arrow_dataset_ops import ArrowStreamDataset
+from tensorflow_io.python.ops.arrow_dataset_ops import ArrowWriter
+from tensorflow_io.python.ops.arrow_dataset_ops import ParquetWriter
 from tensorflow_io.python.ops.arrow_dataset_ops import list_feather_columns
 
 
 _allowed_symbols = [
     "ArrowDataset",
     "ArrowFeatherDataset",
+    "ArrowFlightDataset",
+    "ArrowScannerDataset",
+    "ArrowShmStreamWriter",
     "ArrowStreamDataset",
+    "ArrowWriter",
+    "ParquetWriter",
     "list_feather_columns",
 ]
 
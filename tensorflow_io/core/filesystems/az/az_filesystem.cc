@@ -13,30 +13,70 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <string.h>
+
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
 #include <ostream>
 #include <sstream>
+#include <vector>
 
 #if defined(_MSC_VER)
 #include <Windows.h>
 #include <io.h>
 #endif
 
+#include "absl/strings/escaping.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "azure/storage/blobs/blob_container_client.hpp"
 #include "azure/storage/blobs/block_blob_client.hpp"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
+#include "tensorflow_io/core/filesystems/glob_match.h"
+#include "tensorflow_io/core/filesystems/parallel_read.h"
+#include "tensorflow_io/core/filesystems/ram_file_block_cache.h"
 
 namespace tensorflow {
 namespace io {
 namespace az {
 namespace {
+
+// The read cache is disabled unless TF_AZURE_READ_CACHE_MAX_SIZE_MB is set.
+constexpr size_t kAzReadCacheBlockSizeMB = 64;
+constexpr size_t kAzReadCacheMaxSizeMB = 0;
+constexpr uint64_t kAzReadCacheMaxStaleness = 0;
+// Sequential reads smaller than this are served from a buffer of this size,
+// filled with a single ranged download. Zero disables read-ahead.
+constexpr size_t kAzReadAheadSize = 4 * 1024 * 1024;  // 4 MB
+// Writable files upload blocks of this size as they are appended, with up to
+// kAzWriteConcurrency uploads in flight. A block size of zero writes to a
+// temporary file instead, uploaded as a whole on every sync.
+constexpr size_t kAzWriteBlockSizeMB = 8;
+constexpr size_t kAzWriteConcurrency = 8;
+// GetMatchingPaths lists up to this many virtual directories at a time.
+constexpr size_t kAzListConcurrency = 16;
+
+template <typename T>
+T GetEnvOrDefault(const char* name, T default_value) {
+  const char* env = std::getenv(name);
+  T value;
+  if (env == nullptr || !absl::SimpleAtoi(env, &value)) return default_value;
+  return value;
+}
+
 // TODO: DO NOT use a hardcoded path
 bool GetTmpFilename(std::string* filename) {
   if (!filename) {
@@ -260,86 +300,272 @@ void ListResources(const std::string& dir, const std::string& delimiter,
   TF_SetStatus(status, TF_OK, "");
 }
 
+// Lists the blobs and the virtual directories, ending with `/`, whose names
+// start with `prefix` and have no `/` after it.
+void ListBlobsByHierarchy(
+    const Azure::Storage::Blobs::BlobContainerClient& blob_client,
+    const std::string& prefix, std::vector<std::string>* blobs,
+    std::vector<std::string>* blob_prefixes, TF_Status* status) {
+  TF_VLog(1, "ListBlobsByHierarchy: %s\n", prefix.c_str());
+  Azure::Storage::Blobs::ListBlobsOptions options;
+  options.Prefix = prefix;
+  try {
+    for (auto response = blob_client.ListBlobsByHierarchy("/", options);
+         response.HasPage(); response.MoveToNextPage()) {
+      for (const auto& list_blob_item : response.Blobs) {
+        blobs->push_back(list_blob_item.Name);
+      }
+      blob_prefixes->insert(blob_prefixes->end(),
+                            response.BlobPrefixes.begin(),
+                            response.BlobPrefixes.end());
+    }
+  } catch (const Azure::Storage::StorageException& e) {
+    const std::string error_message = absl::StrCat(
+        "Failed to list blobs of ", prefix, StorageExceptionInfo(e));
+    TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+    return;
+  }
+  TF_SetStatus(status, TF_OK, "");
+}
+
+// Runs `fn(0)` to `fn(n - 1)` on up to `concurrency` threads, including the
+// calling one.
+void ParallelFor(size_t n, size_t concurrency,
+                 const std::function<void(size_t)>& fn) {
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) fn(i);
+  };
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < std::min(n, concurrency); ++i) {
+    workers.push_back(std::async(std::launch::async, worker));
+  }
+  worker();
+  for (auto& w : workers) w.get();
+}
+
+// Downloads up to `n` bytes of the blob at `offset` into `buffer`. Returns
+// the number of bytes downloaded, which is less than `n` only at the end of
+// the blob, or -1 on error.
+int64_t DownloadBlobRange(const Azure::Storage::Blobs::BlobClient& blob_client,
+                          const std::string& path, uint64_t offset, size_t n,
+                          char* buffer, TF_Status* status) {
+  Azure::Storage::Blobs::DownloadBlobToOptions download_options;
+  download_options.Range = Azure::Core::Http::HttpRange();
+  download_options.Range.Value().Offset = offset;
+  download_options.Range.Value().Length = n;
+  try {
+    auto response = blob_client.DownloadTo(reinterpret_cast<uint8_t*>(buffer),
+                                           n, download_options);
+    TF_SetStatus(status, TF_OK, "");
+    const auto& length = response.Value.ContentRange.Length;
+    return length.HasValue() ? length.Value() : n;
+  } catch (const Azure::Storage::StorageException& e) {
+    if (e.StatusCode ==
+        Azure::Core::Http::HttpStatusCode::RangeNotSatisfiable) {
+      // The offset is at or past the end of the blob.
+      TF_SetStatus(status, TF_OK, "");
+      return 0;
+    }
+    const std::string error_message = absl::StrCat(
+        "Failed to get contents of ", path, StorageExceptionInfo(e));
+    TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+    return -1;
+  }
+}
+
+// The state of the filesystem shared by its files.
+struct AzBlobFileSystem {
+  // Cache of blob contents shared by all random access files.
+  std::unique_ptr<RamFileBlockCache> file_block_cache;
+  size_t read_ahead_size;
+  size_t write_block_size;
+  size_t write_concurrency;
+  size_t list_concurrency;
+};
+
 class AzBlobRandomAccessFile {
  public:
-  AzBlobRandomAccessFile(const std::string& account,
-                         const std::string& container,
-                         const std::string& object)
-      : account_(account), container_(container), object_(object) {}
+  // The blob client and size are looked up once, when the file is opened.
+  // `file_block_cache` may be null, and is used instead of read-ahead when it
+  // is enabled.
+  AzBlobRandomAccessFile(const std::string& path,
+                         Azure::Storage::Blobs::BlobClient blob_client,
+                         uint64_t file_size,
+                         RamFileBlockCache* file_block_cache,
+                         size_t read_ahead_size)
+      : path_(path),
+        blob_client_(std::move(blob_client)),
+        file_size_(file_size),
+        file_block_cache_(file_block_cache != nullptr &&
+                                  file_block_cache->IsCacheEnabled()
+                              ? file_block_cache
+                              : nullptr),
+        read_ahead_size_(read_ahead_size) {}
   ~AzBlobRandomAccessFile() {}
   int64_t Read(uint64_t offset, size_t n, char* buffer,
                TF_Status* status) const {
-    TF_VLog(1, "ReadFileFromAz az://%s/%s/%s from %u for n: %u\n",
-            account_.c_str(), container_.c_str(), object_.c_str(), offset, n);
+    TF_VLog(1, "ReadFileFromAz %s from %u for n: %u\n", path_.c_str(), offset,
+            n);
     // If n == 0, then return OkStatus()
     // otherwise, if bytes_read < n then return OutofRange
     if (n == 0) {
       TF_SetStatus(status, TF_OK, "");
       return 0;
     }
-    auto blob_container_client =
-        CreateAzBlobClientWrapper(account_, container_);
-    auto blob_client = blob_container_client->GetBlobClient(object_);
-    int64_t file_size;
-    try {
-      auto blob_property = blob_client.GetProperties();
-      file_size = blob_property.Value.BlobSize;
-    } catch (const Azure::Storage::StorageException& e) {
-      const std::string error_message =
-          absl::StrCat("Failed to get properties of az://", account_, "/",
-                       container_, "/", object_, StorageExceptionInfo(e));
-      TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
-      return 0;
-    }
 
     size_t bytes_to_read = n;
-    if (offset >= file_size) {
+    if (offset >= file_size_) {
       bytes_to_read = 0;
-    } else if (offset + n > file_size) {
-      bytes_to_read = file_size - offset;
+    } else if (offset + n > file_size_) {
+      bytes_to_read = file_size_ - offset;
     }
 
+    int64_t read = 0;
     if (bytes_to_read > 0) {
-      Azure::Storage::Blobs::DownloadBlobToOptions download_options;
-      download_options.Range = Azure::Core::Http::HttpRange();
-      download_options.Range.Value().Offset = offset;
-      download_options.Range.Value().Length = bytes_to_read;
-
-      try {
-        blob_client.DownloadTo(reinterpret_cast<uint8_t*>(buffer),
-                               bytes_to_read, download_options);
-      } catch (const Azure::Storage::StorageException& e) {
-        const std::string error_message =
-            absl::StrCat("Failed to get contents of az://", account_, "/",
-                         container_, "/", object_, StorageExceptionInfo(e));
-        TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
-        return 0;
+      if (file_block_cache_ != nullptr) {
+        read = file_block_cache_->Read(path_, offset, bytes_to_read, buffer,
+                                       status);
+      } else {
+        read = ReadWithReadAhead(offset, bytes_to_read, buffer, status);
       }
+      if (read < 0) return 0;
     }
 
-    if (bytes_to_read < n) {
+    if (static_cast<size_t>(read) < n) {
       TF_SetStatus(status, TF_OUT_OF_RANGE, "EOF reached");
-      return bytes_to_read;
+      return read;
     }
     TF_SetStatus(status, TF_OK, "");
-    return bytes_to_read;
+    return read;
+  }
+
+  // Downloads `n` bytes at `offset`, within the blob, bypassing the block
+  // cache and the read-ahead buffer.
+  int64_t ReadUncached(uint64_t offset, size_t n, char* buffer,
+                       TF_Status* status) const {
+    return DownloadBlobRange(blob_client_, path_, offset, n, buffer, status);
   }
 
+  uint64_t file_size() const { return file_size_; }
+
  private:
-  std::string account_;
-  std::string container_;
-  std::string object_;
+  // Serves reads that continue the previous read from a buffer of
+  // `read_ahead_size_` bytes, refilled from the blob when it runs out. Other
+  // reads, and reads at least as large as the buffer, are downloaded as is.
+  int64_t ReadWithReadAhead(uint64_t offset, size_t n, char* buffer,
+                            TF_Status* status) const {
+    size_t copied = 0;
+    bool sequential;
+    {
+      absl::MutexLock l(&mu_);
+      sequential = offset == next_offset_;
+      next_offset_ = offset + n;
+      if (offset >= buffer_offset_ &&
+          offset < buffer_offset_ + buffer_.size()) {
+        copied = std::min<size_t>(n, buffer_offset_ + buffer_.size() - offset);
+        memcpy(buffer, &buffer_[offset - buffer_offset_], copied);
+      }
+    }
+    if (copied == n) {
+      TF_SetStatus(status, TF_OK, "");
+      return n;
+    }
+    offset += copied;
+    if (!sequential || n - copied >= read_ahead_size_) {
+      int64_t read = DownloadBlobRange(blob_client_, path_, offset, n - copied,
+                                       buffer + copied, status);
+      return read < 0 ? -1 : copied + read;
+    }
+    // The download is done without holding the lock, so that concurrent
+    // reads of the file are not serialized on it.
+    std::vector<char> data(std::min<uint64_t>(read_ahead_size_,
+                                              file_size_ - offset));
+    int64_t read = DownloadBlobRange(blob_client_, path_, offset, data.size(),
+                                     data.data(), status);
+    if (read < 0) return -1;
+    data.resize(read);
+    size_t remaining = std::min<size_t>(n - copied, data.size());
+    memcpy(buffer + copied, data.data(), remaining);
+    absl::MutexLock l(&mu_);
+    buffer_.swap(data);
+    buffer_offset_ = offset;
+    return copied + remaining;
+  }
+
+  const std::string path_;
+  const Azure::Storage::Blobs::BlobClient blob_client_;
+  const uint64_t file_size_;
+  RamFileBlockCache* const file_block_cache_;  // not owned
+  const size_t read_ahead_size_;
+
+  mutable absl::Mutex mu_;
+  // The offset right after the last read.
+  mutable uint64_t next_offset_ ABSL_GUARDED_BY(mu_) = 0;
+  // The read-ahead buffer, holding the blob contents at `buffer_offset_`.
+  mutable std::vector<char> buffer_ ABSL_GUARDED_BY(mu_);
+  mutable uint64_t buffer_offset_ ABSL_GUARDED_BY(mu_) = 0;
 };
 
+// Opens `path` for random access, looking up the size of the blob. Returns
+// null with `status` set if the blob cannot be opened.
+std::unique_ptr<AzBlobRandomAccessFile> OpenAzBlobRandomAccessFile(
+    const AzBlobFileSystem* az_fs, const std::string& path,
+    const std::string& account, const std::string& container,
+    const std::string& object, TF_Status* status) {
+  using namespace std::chrono;
+
+  auto blob_container_client = CreateAzBlobClientWrapper(account, container);
+  auto blob_client = blob_container_client->GetBlobClient(object);
+  uint64_t file_size;
+  int64_t mtime_nsec;
+  try {
+    auto blob_property = blob_client.GetProperties();
+    file_size = blob_property.Value.BlobSize;
+    auto az_last_modified = blob_property.Value.LastModified.time_since_epoch();
+    mtime_nsec = duration_cast<nanoseconds>(az_last_modified).count();
+  } catch (const Azure::Storage::StorageException& e) {
+    const std::string error_message = absl::StrCat(
+        "Failed to get properties of ", path, StorageExceptionInfo(e));
+    TF_SetStatus(status,
+                 e.StatusCode == Azure::Core::Http::HttpStatusCode::NotFound
+                     ? TF_NOT_FOUND
+                     : TF_INTERNAL,
+                 error_message.c_str());
+    return nullptr;
+  }
+
+  RamFileBlockCache* file_block_cache = az_fs->file_block_cache.get();
+  if (file_block_cache->IsCacheEnabled()) {
+    // Drops the cached blocks of a blob that has been modified.
+    file_block_cache->ValidateAndUpdateFileSignature(
+        path, mtime_nsec ^ static_cast<int64_t>(file_size << 1));
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return std::unique_ptr<AzBlobRandomAccessFile>(new AzBlobRandomAccessFile(
+      path, std::move(blob_client), file_size, file_block_cache,
+      az_fs->read_ahead_size));
+}
+
+// Writes a block blob. With a non-zero `block_size` appended data is staged
+// in blocks of `block_size` bytes, with up to `max_concurrency` concurrent
+// StageBlock calls, and Sync commits the list of blocks staged so far: data
+// is uploaded once, however often the file is synced. Otherwise appended
+// data goes to a temporary file that is uploaded as a whole on each Sync.
 class AzBlobWritableFile {
  public:
   AzBlobWritableFile(const std::string& account, const std::string& container,
-                     const std::string& object)
+                     const std::string& object, size_t block_size,
+                     size_t max_concurrency)
       : account_(account),
         container_(container),
         object_(object),
+        block_size_(block_size),
+        max_concurrency_((std::max)(max_concurrency, static_cast<size_t>(1))),
+        blob_client_(CreateAzBlobClientWrapper(account, container)
+                         ->GetBlockBlobClient(object)),
         sync_needed_(true) {
-    if (GetTmpFilename(&tmp_content_filename_)) {
+    if (block_size_ == 0 && GetTmpFilename(&tmp_content_filename_)) {
       outfile_.open(tmp_content_filename_,
                     std::ofstream::binary | std::ofstream::app);
     }
@@ -352,6 +578,25 @@ class AzBlobWritableFile {
   }
 
   void Append(const char* buffer, size_t n, TF_Status* status) {
+    if (block_size_ > 0) {
+      if (closed_) {
+        TF_SetStatus(status, TF_FAILED_PRECONDITION, "The file is closed");
+        return;
+      }
+      sync_needed_ = true;
+      while (n > 0) {
+        size_t copied = (std::min)(n, block_size_ - buffer_.size());
+        buffer_.append(buffer, copied);
+        buffer += copied;
+        n -= copied;
+        if (buffer_.size() == block_size_) {
+          StageBlock(status);
+          if (TF_GetCode(status) != TF_OK) return;
+        }
+      }
+      TF_SetStatus(status, TF_OK, "");
+      return;
+    }
     if (!outfile_.is_open()) {
       TF_SetStatus(status, TF_FAILED_PRECONDITION,
                    "The internal temporary file is not writable");
@@ -368,7 +613,16 @@ class AzBlobWritableFile {
     }
     TF_SetStatus(status, TF_OK, "");
   }
+
+  // Staged blocks are only committed by Sync and Close, so that frequent
+  // flushes do not split the blob into many small blocks.
+  void Flush(TF_Status* status) {
+    if (block_size_ == 0) return Sync(status);
+    TF_SetStatus(status, TF_OK, "");
+  }
+
   void Sync(TF_Status* status) {
+    if (block_size_ > 0) return SyncBlocks(status);
     if (!outfile_.is_open()) {
       TF_SetStatus(status, TF_FAILED_PRECONDITION,
                    "The internal temporary file is not writable");
@@ -388,11 +642,8 @@ class AzBlobWritableFile {
     TF_VLog(1, "WriteFileToAz: az://%s/%s/%s\n", account_.c_str(),
             container_.c_str(), object_.c_str());
 
-    auto blob_container_client =
-        CreateAzBlobClientWrapper(account_, container_);
-    auto blob_client = blob_container_client->GetBlockBlobClient(object_);
     try {
-      blob_client.UploadFrom(tmp_content_filename_);
+      blob_client_.UploadFrom(tmp_content_filename_);
     } catch (const Azure::Storage::StorageException& e) {
       const std::string error_message =
           absl::StrCat("Failed to upload to az://", account_, "/", container_,
@@ -405,6 +656,15 @@ class AzBlobWritableFile {
   }
 
   void Close(TF_Status* status) {
+    if (block_size_ > 0) {
+      if (!closed_) {
+        SyncBlocks(status);
+        if (TF_GetCode(status) != TF_OK) return;
+        closed_ = true;
+      }
+      TF_SetStatus(status, TF_OK, "");
+      return;
+    }
     if (outfile_.is_open()) {
       Sync(status);
       if (TF_GetCode(status) != TF_OK) {
@@ -417,50 +677,110 @@ class AzBlobWritableFile {
   }
 
  private:
+  // Stages the buffered data as the next block, after waiting for the oldest
+  // upload in flight if there are `max_concurrency_` of them.
+  void StageBlock(TF_Status* status) {
+    while (pending_.size() >= max_concurrency_) {
+      WaitForOldestBlock(status);
+      if (TF_GetCode(status) != TF_OK) return;
+    }
+    // All block ids of a blob must have the same length.
+    std::string index = std::to_string(block_ids_.size());
+    index.insert(0, 10 - (std::min)(index.size(), static_cast<size_t>(10)),
+                 '0');
+    std::string block_id = absl::Base64Escape(index);
+    block_ids_.push_back(block_id);
+
+    std::string data;
+    data.swap(buffer_);
+    auto blob_client = blob_client_;
+    pending_.push_back(std::async(
+        std::launch::async,
+        [blob_client, block_id, data = std::move(data)]() -> std::string {
+          Azure::Core::IO::MemoryBodyStream stream(
+              reinterpret_cast<const uint8_t*>(data.data()), data.size());
+          try {
+            blob_client.StageBlock(block_id, stream);
+          } catch (const Azure::Storage::StorageException& e) {
+            return StorageExceptionInfo(e);
+          }
+          return "";
+        }));
+    TF_SetStatus(status, TF_OK, "");
+  }
+
+  void WaitForOldestBlock(TF_Status* status) {
+    std::string error = pending_.front().get();
+    pending_.pop_front();
+    if (!error.empty()) {
+      const std::string error_message =
+          absl::StrCat("Failed to stage a block of az://", account_, "/",
+                       container_, "/", object_, error);
+      TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+      return;
+    }
+    TF_SetStatus(status, TF_OK, "");
+  }
+
+  // Stages the remaining buffered data, waits for all staged blocks and
+  // commits the block list.
+  void SyncBlocks(TF_Status* status) {
+    if (closed_ || !sync_needed_) {
+      TF_SetStatus(status, TF_OK, "");
+      return;
+    }
+    if (!buffer_.empty()) {
+      StageBlock(status);
+      if (TF_GetCode(status) != TF_OK) return;
+    }
+    TF_SetStatus(status, TF_OK, "");
+    while (!pending_.empty()) {
+      // Waits for all uploads even after an error, and keeps the first one.
+      TF_Status* block_status = TF_NewStatus();
+      WaitForOldestBlock(block_status);
+      if (TF_GetCode(block_status) != TF_OK && TF_GetCode(status) == TF_OK) {
+        TF_SetStatus(status, TF_GetCode(block_status),
+                     TF_Message(block_status));
+      }
+      TF_DeleteStatus(block_status);
+    }
+    if (TF_GetCode(status) != TF_OK) return;
+
+    TF_VLog(1, "CommitBlockList: az://%s/%s/%s, %u blocks\n",
+            account_.c_str(), container_.c_str(), object_.c_str(),
+            block_ids_.size());
+    try {
+      blob_client_.CommitBlockList(block_ids_);
+    } catch (const Azure::Storage::StorageException& e) {
+      const std::string error_message =
+          absl::StrCat("Failed to commit blocks of az://", account_, "/",
+                       container_, "/", object_, StorageExceptionInfo(e));
+      TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+      return;
+    }
+    sync_needed_ = false;
+    TF_SetStatus(status, TF_OK, "");
+  }
+
   std::string account_;
   std::string container_;
   std::string object_;
+  const size_t block_size_;
+  const size_t max_concurrency_;
+  const Azure::Storage::Blobs::BlockBlobClient blob_client_;
   std::string tmp_content_filename_;
   std::ofstream outfile_;
   bool sync_needed_;  // whether there is buffered data that needs to be synced
+  // The data appended since the last staged block, and the ids of all staged
+  // blocks, in order.
+  std::string buffer_;
+  std::vector<std::string> block_ids_;
+  // The uploads in flight, oldest first, each returning an error message or
+  // an empty string.
+  std::deque<std::future<std::string>> pending_;
+  bool closed_ = false;
 };
 
-#if 0
-Status GetMatchingPaths(const std::string& pattern, std::vector<std::string>* results) {
-  const std::string& fixed_prefix =
-      pattern.substr(0, pattern.find_first_of("*?[\\"));
-
-  std::string account, container, object;
-  TF_RETURN_IF_ERROR(
-      ParseAzBlobPathClass(fixed_prefix, true, &account, &container, &object));
-
-  auto blob_client = CreateAzBlobClientWrapper(account, container);
-
-  std::vector<std::string> blobs;
-  TF_RETURN_IF_ERROR(ListResources(fixed_prefix, "", blob_client, &blobs));
-
-  std::string container_path;
-  if (pattern.find(kAzBlobEndpoint) != std::string::npos) {
-    container_path =
-        io::JoinPath("az://", account + kAzBlobEndpoint, container);
-  } else {
-    container_path = io::JoinPath("az://", account, container);
-  }
-
-  std::transform(std::begin(blobs), std::end(blobs), std::begin(blobs),
-                 [&container_path](const std::string& path) {
-                   return io::JoinPath(container_path, path);
-                 });
-
-  std::copy_if(std::begin(blobs), std::end(blobs), std::back_inserter(*results),
-               [&pattern](const std::string& full_path) {
-                 return Env::Default()->MatchPath(full_path, pattern);
-               });
-
-  return OkStatus();
-}
-#endif
-
 // SECTION 1. Implementation for `TF_RandomAccessFile`
 // ----------------------------------------------------------------------------
 namespace tf_random_access_file {
@@ -473,7 +793,8 @@ static void Cleanup(TF_RandomAccessFile* file) {
 static int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
                     char* buffer, TF_Status* status) {
   auto az_file = static_cast<AzBlobRandomAccessFile*>(file->plugin_file);
-  return az_file->Read(offset, n, buffer, status);
+  FilesystemRequest request("az", "read", status);
+  return request.Bytes(az_file->Read(offset, n, buffer, status));
 }
 
 }  // namespace tf_random_access_file
@@ -490,6 +811,8 @@ static void Cleanup(TF_WritableFile* file) {
 static void Append(const TF_WritableFile* file, const char* buffer, size_t n,
                    TF_Status* status) {
   auto az_file = static_cast<AzBlobWritableFile*>(file->plugin_file);
+  FilesystemRequest request("az", "write", status);
+  request.Bytes(n);
   az_file->Append(buffer, n, status);
 }
 
@@ -500,16 +823,18 @@ static int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
 
 static void Flush(const TF_WritableFile* file, TF_Status* status) {
   auto az_file = static_cast<AzBlobWritableFile*>(file->plugin_file);
-  az_file->Sync(status);
+  az_file->Flush(status);
 }
 
 static void Sync(const TF_WritableFile* file, TF_Status* status) {
   auto az_file = static_cast<AzBlobWritableFile*>(file->plugin_file);
+  FilesystemRequest request("az", "sync", status);
   az_file->Sync(status);
 }
 
 static void Close(const TF_WritableFile* file, TF_Status* status) {
   auto az_file = static_cast<AzBlobWritableFile*>(file->plugin_file);
+  FilesystemRequest request("az", "sync", status);
   az_file->Close(status);
 }
 
@@ -518,11 +843,25 @@ static void Close(const TF_WritableFile* file, TF_Status* status) {
 // SECTION 3. Implementation for `TF_ReadOnlyMemoryRegion`
 // ----------------------------------------------------------------------------
 namespace tf_read_only_memory_region {
-void Cleanup(TF_ReadOnlyMemoryRegion* region) {}
+typedef struct AzBlobMemoryRegion {
+  std::unique_ptr<char[]> data;
+  uint64_t length;
+} AzBlobMemoryRegion;
+
+void Cleanup(TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<AzBlobMemoryRegion*>(region->plugin_memory_region);
+  delete r;
+}
 
-const void* Data(const TF_ReadOnlyMemoryRegion* region) { return nullptr; }
+const void* Data(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<AzBlobMemoryRegion*>(region->plugin_memory_region);
+  return reinterpret_cast<const void*>(r->data.get());
+}
 
-uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
+uint64_t Length(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<AzBlobMemoryRegion*>(region->plugin_memory_region);
+  return r->length;
+}
 
 }  // namespace tf_read_only_memory_region
 
@@ -531,10 +870,52 @@ uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
 namespace tf_az_filesystem {
 
 static void Init(TF_Filesystem* filesystem, TF_Status* status) {
+  auto az_fs = new AzBlobFileSystem();
+  filesystem->plugin_filesystem = az_fs;
+
+  size_t block_size = GetEnvOrDefault("TF_AZURE_READ_CACHE_BLOCK_SIZE_MB",
+                                      kAzReadCacheBlockSizeMB) *
+                      1024 * 1024;
+  size_t max_bytes = GetEnvOrDefault("TF_AZURE_READ_CACHE_MAX_SIZE_MB",
+                                     kAzReadCacheMaxSizeMB) *
+                     1024 * 1024;
+  uint64_t max_staleness = GetEnvOrDefault("TF_AZURE_READ_CACHE_MAX_STALENESS",
+                                           kAzReadCacheMaxStaleness);
+  az_fs->file_block_cache = std::make_unique<RamFileBlockCache>(
+      block_size, max_bytes, max_staleness,
+      [](const std::string& path, size_t offset, size_t n, char* buffer,
+         TF_Status* status) -> int64_t {
+        std::string account, container, object;
+        ParseAzBlobPath(path, false, &account, &container, &object, status);
+        if (TF_GetCode(status) != TF_OK) return -1;
+        auto blob_container_client =
+            CreateAzBlobClientWrapper(account, container);
+        return DownloadBlobRange(blob_container_client->GetBlobClient(object),
+                                 path, offset, n, buffer, status);
+      });
+  az_fs->file_block_cache->SetLookupObserver(
+      [](bool hit) { RecordCacheLookup("az", "block", hit); });
+  az_fs->file_block_cache->SetMemoryBudgetComponent("az_block_cache");
+  az_fs->read_ahead_size =
+      GetEnvOrDefault("TF_AZURE_READ_AHEAD_SIZE", kAzReadAheadSize);
+  az_fs->write_block_size =
+      GetEnvOrDefault("TF_AZURE_WRITE_BLOCK_SIZE_MB", kAzWriteBlockSizeMB) *
+      1024 * 1024;
+  az_fs->write_concurrency =
+      GetEnvOrDefault("TF_AZURE_WRITE_CONCURRENCY", kAzWriteConcurrency);
+  az_fs->list_concurrency = std::max<size_t>(
+      GetEnvOrDefault("TF_AZURE_LIST_CONCURRENCY", kAzListConcurrency), 1);
+  TF_VLog(1,
+          "Azure read cache block size: %u, max size: %u, max staleness: %u, "
+          "read-ahead size: %u\n",
+          block_size, max_bytes, max_staleness, az_fs->read_ahead_size);
   TF_SetStatus(status, TF_OK, "");
 }
 
-static void Cleanup(TF_Filesystem* filesystem) {}
+static void Cleanup(TF_Filesystem* filesystem) {
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  delete az_fs;
+}
 
 static void NewRandomAccessFile(const TF_Filesystem* filesystem,
                                 const char* path, TF_RandomAccessFile* file,
@@ -544,9 +925,11 @@ static void NewRandomAccessFile(const TF_Filesystem* filesystem,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  file->plugin_file = new AzBlobRandomAccessFile(account, container, object);
-
-  TF_SetStatus(status, TF_OK, "");
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  file->plugin_file =
+      OpenAzBlobRandomAccessFile(az_fs, path, account, container, object,
+                                 status)
+          .release();
 }
 
 static void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
@@ -556,7 +939,10 @@ static void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  file->plugin_file = new AzBlobWritableFile(account, container, object);
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  file->plugin_file =
+      new AzBlobWritableFile(account, container, object,
+                             az_fs->write_block_size, az_fs->write_concurrency);
 
   TF_SetStatus(status, TF_OK, "");
 }
@@ -568,17 +954,53 @@ static void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  file->plugin_file = new AzBlobWritableFile(account, container, object);
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  file->plugin_file =
+      new AzBlobWritableFile(account, container, object,
+                             az_fs->write_block_size, az_fs->write_concurrency);
 
   TF_SetStatus(status, TF_OK, "");
 }
 
+// Downloads the whole blob in chunks downloaded concurrently into a single
+// buffer, bypassing the block cache.
 static void NewReadOnlyMemoryRegionFromFile(const TF_Filesystem* filesystem,
                                             const char* path,
                                             TF_ReadOnlyMemoryRegion* region,
                                             TF_Status* status) {
-  TF_SetStatus(status, TF_UNIMPLEMENTED,
-               "NewReadOnlyMemoryRegionFromFile not implemented");
+  TF_VLog(1, "NewReadOnlyMemoryRegionFromFile %s\n", path);
+  std::string account, container, object;
+  ParseAzBlobPath(path, false, &account, &container, &object, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return;
+  }
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  std::unique_ptr<AzBlobRandomAccessFile> file = OpenAzBlobRandomAccessFile(
+      az_fs, path, account, container, object, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return;
+  }
+  uint64_t size = file->file_size();
+  if (size == 0) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, "File is empty");
+    return;
+  }
+
+  std::unique_ptr<char[]> data(new char[size]);
+  int64_t read = ParallelRead(
+      [&file](uint64_t offset, size_t n, char* buffer, TF_Status* s) {
+        return file->ReadUncached(offset, n, buffer, s);
+      },
+      0, size, data.get(), kMemoryRegionReadThreads, kMemoryRegionMinChunkSize,
+      status);
+  if (TF_GetCode(status) != TF_OK) {
+    return;
+  }
+
+  region->plugin_memory_region =
+      new tf_read_only_memory_region::AzBlobMemoryRegion(
+          {std::move(data), static_cast<uint64_t>(read)});
+  TF_SetStatus(status, TF_OK, "");
 }
 
 static void CreateDir(const TF_Filesystem* filesystem, const char* path,
@@ -629,6 +1051,8 @@ static void DeleteFile(const TF_Filesystem* filesystem, const char* path,
     TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
     return;
   }
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  az_fs->file_block_cache->RemoveFile(path);
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -780,6 +1204,9 @@ static void RenameFile(const TF_Filesystem* filesystem, const char* src,
     return;
   }
 
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  az_fs->file_block_cache->RemoveFile(src);
+  az_fs->file_block_cache->RemoveFile(dst);
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -795,8 +1222,13 @@ static void CopyFile(const TF_Filesystem* filesystem, const char* src,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  std::unique_ptr<AzBlobRandomAccessFile> src_file(
-      new AzBlobRandomAccessFile(src_account, src_container, src_object));
+  auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+  std::unique_ptr<AzBlobRandomAccessFile> src_file =
+      OpenAzBlobRandomAccessFile(az_fs, src, src_account, src_container,
+                                 src_object, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return;
+  }
 
   std::string dst_account, dst_container, dst_object;
   ParseAzBlobPath(dst, false, &dst_account, &dst_container, &dst_object,
@@ -805,7 +1237,9 @@ static void CopyFile(const TF_Filesystem* filesystem, const char* src,
     return;
   }
   std::unique_ptr<AzBlobWritableFile> dst_file(
-      new AzBlobWritableFile(dst_account, dst_container, dst_object));
+      new AzBlobWritableFile(dst_account, dst_container, dst_object,
+                             az_fs->write_block_size,
+                             az_fs->write_concurrency));
 
   uint64_t offset = 0;
   std::unique_ptr<char[]> buffer(new char[kCopyFileBufferSize]);
@@ -929,6 +1363,7 @@ static bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
 static void Stat(const TF_Filesystem* filesystem, const char* path,
                  TF_FileStatistics* stats, TF_Status* status) {
   TF_VLog(1, "Stat on path: %s\n", path);
+  FilesystemRequest request("az", "stat", status);
 
   using namespace std::chrono;
 
@@ -973,6 +1408,7 @@ static void Stat(const TF_Filesystem* filesystem, const char* path,
 static int GetChildren(const TF_Filesystem* filesystem, const char* path,
                        char*** entries, TF_Status* status) {
   TF_VLog(1, "GetChildren on path: %s\n", path);
+  FilesystemRequest request("az", "list", status);
   std::string account, container, object;
   ParseAzBlobPath(path, true, &account, &container, &object, status);
   if (TF_GetCode(status) != TF_OK) {
@@ -1036,6 +1472,118 @@ static int GetChildren(const TF_Filesystem* filesystem, const char* path,
   return num_entries;
 }
 
+// The glob is expanded one path component at a time: every virtual
+// directory matching the components so far is listed, concurrently and with
+// one client, only with the literal prefix of the next component and only up
+// to the next `/`, so that non-matching subtrees are never listed.
+static int GetMatchingPaths(const TF_Filesystem* filesystem, const char* glob,
+                            char*** entries, TF_Status* status) {
+  TF_VLog(1, "GetMatchingPaths for glob: %s\n", glob);
+  FilesystemRequest request("az", "list", status);
+  std::string account, container, object;
+  ParseAzBlobPath(glob, true, &account, &container, &object, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  const std::string glob_str(glob);
+  const size_t object_start = glob_str.size() - object.size();
+  if (container.empty() ||
+      glob_str.find_first_of(kGlobChars) < object_start) {
+    const std::string error_message = absl::StrCat(
+        "Wildcards in the account or container of ", glob,
+        " are not supported");
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, error_message.c_str());
+    return -1;
+  }
+  // The results keep the account and container as written in the glob.
+  const std::string root = glob_str.substr(0, object_start);
+
+  std::vector<std::string> result;
+  if (object.find_first_of(kGlobChars) == std::string::npos) {
+    // Not a glob, the path only matches itself.
+    PathExists(filesystem, glob, status);
+    if (TF_GetCode(status) == TF_OK) {
+      result.push_back(glob_str);
+    } else if (TF_GetCode(status) != TF_NOT_FOUND) {
+      return -1;
+    }
+  } else {
+    auto az_fs = static_cast<AzBlobFileSystem*>(filesystem->plugin_filesystem);
+    auto blob_container_client = CreateAzBlobClientWrapper(account, container);
+
+    while (!object.empty() && object.back() == '/') object.pop_back();
+    std::vector<std::string> components = absl::StrSplit(object, '/');
+
+    std::vector<std::string> dirs = {""};
+    for (size_t i = 0; i < components.size() && !dirs.empty(); ++i) {
+      const std::string& component = components[i];
+      const bool last = i + 1 == components.size();
+      const size_t wildcard = component.find_first_of(kGlobChars);
+      if (wildcard == std::string::npos && !last) {
+        // A literal directory is appended to the blob name prefix of the
+        // next hierarchical listing. Without a hierarchical namespace, a
+        // directory exists only as long as a blob name starts with it.
+        for (auto& dir : dirs) dir += component + "/";
+        continue;
+      }
+
+      const size_t num_dirs = dirs.size();
+      std::vector<std::vector<std::string>> blobs(num_dirs);
+      std::vector<std::vector<std::string>> blob_prefixes(num_dirs);
+      std::vector<TF_Status*> statuses(num_dirs);
+      for (auto& list_status : statuses) list_status = TF_NewStatus();
+      ParallelFor(num_dirs, az_fs->list_concurrency, [&](size_t j) {
+        ListBlobsByHierarchy(*blob_container_client,
+                             dirs[j] + component.substr(0, wildcard),
+                             &blobs[j], &blob_prefixes[j], statuses[j]);
+      });
+      TF_SetStatus(status, TF_OK, "");
+      for (auto list_status : statuses) {
+        if (TF_GetCode(status) == TF_OK && TF_GetCode(list_status) != TF_OK) {
+          TF_SetStatus(status, TF_GetCode(list_status),
+                       TF_Message(list_status));
+        }
+        TF_DeleteStatus(list_status);
+      }
+      if (TF_GetCode(status) != TF_OK) return -1;
+
+      std::vector<std::string> next_dirs;
+      for (size_t j = 0; j < num_dirs; ++j) {
+        const size_t length = dirs[j].length();
+        for (const auto& blob_prefix : blob_prefixes[j]) {
+          const std::string name =
+              blob_prefix.substr(length, blob_prefix.length() - length - 1);
+          if (!MatchGlobComponent(component, name)) continue;
+          if (last) {
+            result.push_back(root + dirs[j] + name);
+          } else {
+            next_dirs.push_back(blob_prefix);
+          }
+        }
+        if (!last) continue;
+        for (const auto& blob : blobs[j]) {
+          const std::string name = blob.substr(length);
+          if (!name.empty() && MatchGlobComponent(component, name)) {
+            result.push_back(root + blob);
+          }
+        }
+      }
+      dirs = std::move(next_dirs);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+  }
+
+  int num_entries = result.size();
+  *entries = static_cast<char**>(
+      plugin_memory_allocate(num_entries * sizeof((*entries)[0])));
+  for (int i = 0; i < num_entries; i++) {
+    (*entries)[i] = static_cast<char*>(
+        plugin_memory_allocate(strlen(result[i].c_str()) + 1));
+    memcpy((*entries)[i], result[i].c_str(), strlen(result[i].c_str()) + 1);
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return num_entries;
+}
+
 static int64_t GetFileSize(const TF_Filesystem* filesystem, const char* path,
                            TF_Status* status) {
   TF_VLog(1, "GetFileSize on path: %s\n", path);
@@ -1117,6 +1665,7 @@ void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri) {
   ops->filesystem_ops->is_directory = tf_az_filesystem::IsDirectory;
   ops->filesystem_ops->get_file_size = tf_az_filesystem::GetFileSize;
   ops->filesystem_ops->get_children = tf_az_filesystem::GetChildren;
+  ops->filesystem_ops->get_matching_paths = tf_az_filesystem::GetMatchingPaths;
   ops->filesystem_ops->translate_name = tf_az_filesystem::TranslateName;
 }
 
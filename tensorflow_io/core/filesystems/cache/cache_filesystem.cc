@@ -0,0 +1,796 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/base/const_init.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/c/logging.h"
+#include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/filesystem_plugins.h"
+
+namespace tensorflow {
+namespace io {
+namespace cache {
+
+// Implementation of a read-through cache in front of the other filesystems of
+// tensorflow-io, registered as `cache+<scheme>` (e.g. `cache+s3://bucket/key`).
+//
+// Random access files are read in blocks which are kept in a size-bounded
+// directory on local disk, shared by all processes of the host:
+//   * Blocks are keyed by the path, modification time and length of the file,
+//     so that a file that changed is never served from stale blocks.
+//   * The least recently used blocks are evicted once the directory grows
+//     past its maximum size.
+//   * A block is fetched by one reader of the host at a time, while the other
+//     readers wait on its lock file, and is published with an atomic rename.
+// Every other operation is forwarded to the wrapped filesystem.
+
+constexpr char kCachePrefix[] = "cache+";
+constexpr char kCacheDir[] = "TFIO_CACHE_DIR";
+constexpr char kCacheBlockSizeMB[] = "TFIO_CACHE_BLOCK_SIZE_MB";
+constexpr char kCacheMaxSizeMB[] = "TFIO_CACHE_MAX_SIZE_MB";
+constexpr size_t kDefaultCacheBlockSizeMB = 16;
+constexpr size_t kDefaultCacheMaxSizeMB = 100 * 1024;
+// Temporary files of fills that did not finish are removed after this many
+// seconds.
+constexpr time_t kStaleTmpFileSeconds = 3600;
+// The maximum number of schemes that can be wrapped.
+constexpr size_t kMaxSchemes = 8;
+
+template <typename T>
+T GetEnvOrDefault(const char* name, T default_value) {
+  const char* env = std::getenv(name);
+  T value;
+  if (env == nullptr || !absl::SimpleAtoi(env, &value)) return default_value;
+  return value;
+}
+
+// Returns the path of the wrapped filesystem for `path`, i.e. `path` without
+// the `cache+` prefix of its scheme.
+static std::string InnerPath(const char* path) {
+  std::string inner_path(path);
+  if (inner_path.compare(0, strlen(kCachePrefix), kCachePrefix) == 0) {
+    inner_path.erase(0, strlen(kCachePrefix));
+  }
+  return inner_path;
+}
+
+// A 64-bit FNV-1a hash, which is stable across processes and builds.
+static uint64_t Fingerprint(const std::string& s) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : s) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static bool CreateDirs(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos;
+       pos = dir.find('/', pos + 1)) {
+    mkdir(dir.substr(0, pos).c_str(), 0755);
+  }
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+  struct stat st;
+  return stat(dir.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// The on-disk block cache. Blocks are stored as files named by the hash of
+// their key, under a subdirectory named by the first byte of the hash.
+class DiskCache {
+ public:
+  // The callback that reads `n` bytes at `offset` of the file on a miss.
+  typedef std::function<int64_t(uint64_t offset, size_t n, char* buffer,
+                                TF_Status* status)>
+      BlockFetcher;
+
+  DiskCache(std::string dir, size_t block_size, uint64_t max_bytes)
+      : dir_(std::move(dir)), block_size_(block_size), max_bytes_(max_bytes) {}
+
+  // Returns the cache of the process, configured from the environment.
+  static DiskCache* Default(TF_Status* status) {
+    static absl::Mutex mu(absl::kConstInit);
+    static DiskCache* cache = nullptr;
+    absl::MutexLock l(&mu);
+    if (cache == nullptr) {
+      std::string dir;
+      const char* dir_str = getenv(kCacheDir);
+      if (dir_str != nullptr && dir_str[0] != '\0') {
+        dir = dir_str;
+      } else {
+        const char* tmp_dir = getenv("TMPDIR");
+        dir = absl::StrCat(tmp_dir != nullptr ? tmp_dir : "/tmp",
+                           "/tensorflow_io_cache");
+      }
+      if (!CreateDirs(dir)) {
+        TF_SetStatusFromIOError(status, errno, dir.c_str());
+        return nullptr;
+      }
+      size_t block_size =
+          GetEnvOrDefault(kCacheBlockSizeMB, kDefaultCacheBlockSizeMB) * 1024 *
+          1024;
+      uint64_t max_bytes =
+          GetEnvOrDefault(kCacheMaxSizeMB, kDefaultCacheMaxSizeMB) * 1024 *
+          1024;
+      TF_VLog(1,
+              "Cache filesystem at %s with block size %zu bytes and max size "
+              "%llu bytes\n",
+              dir.c_str(), block_size,
+              static_cast<unsigned long long>(max_bytes));
+      cache = new DiskCache(dir, (std::max)(block_size, size_t(1)), max_bytes);
+      cache->Evict();
+    }
+    TF_SetStatus(status, TF_OK, "");
+    return cache;
+  }
+
+  size_t block_size() const { return block_size_; }
+
+  // Reads block `index` of the file with key `key` into `block`, which is
+  // sized to the expected length of the block. On a miss the block is
+  // fetched with `fetcher` and cached; `block` is shrunk if the fetch
+  // returns fewer bytes, in which case nothing is cached.
+  void ReadBlock(const std::string& key, uint64_t index,
+                 std::vector<char>* block, const BlockFetcher& fetcher,
+                 TF_Status* status) {
+    const std::string subdir = BlockDir(key);
+    const std::string path = BlockPath(subdir, key, index);
+    if (ReadCached(path, block)) return TF_SetStatus(status, TF_OK, "");
+
+    // Only one reader of the host fetches a block. Others wait for the lock
+    // and then find the block cached.
+    mkdir(subdir.c_str(), 0755);
+    const std::string lock_path = path + ".lock";
+    int lock_fd = open(lock_path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (lock_fd >= 0) {
+      while (flock(lock_fd, LOCK_EX) != 0 && errno == EINTR) {
+      }
+      if (ReadCached(path, block)) {
+        close(lock_fd);
+        return TF_SetStatus(status, TF_OK, "");
+      }
+    }
+
+    int64_t r = fetcher(index * block_size_, block->size(), block->data(),
+                        status);
+    if (r == static_cast<int64_t>(block->size())) {
+      TF_SetStatus(status, TF_OK, "");
+      Insert(path, *block);
+    } else if (TF_GetCode(status) == TF_OK ||
+               TF_GetCode(status) == TF_OUT_OF_RANGE) {
+      // The file is shorter than when it was opened.
+      block->resize(r > 0 ? r : 0);
+      TF_SetStatus(status, TF_OK, "");
+    }
+
+    if (lock_fd >= 0) {
+      // The block is published before the lock file is removed, so a reader
+      // that creates a new lock file finds it.
+      unlink(lock_path.c_str());
+      close(lock_fd);
+    }
+  }
+
+  // Removes the least recently used blocks until the cache is below 90% of
+  // its maximum size. Only one process of the host scans at a time.
+  void Evict() {
+    const std::string lock_path = absl::StrCat(dir_, "/.evict.lock");
+    int lock_fd = open(lock_path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (lock_fd < 0) return;
+    if (flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+      close(lock_fd);
+      return;
+    }
+
+    struct Entry {
+      time_t mtime;
+      uint64_t size;
+      std::string path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    const time_t now = time(nullptr);
+    DIR* root = opendir(dir_.c_str());
+    while (root != nullptr) {
+      struct dirent* subdir_entry = readdir(root);
+      if (subdir_entry == nullptr) break;
+      if (subdir_entry->d_name[0] == '.') continue;
+      const std::string subdir = absl::StrCat(dir_, "/", subdir_entry->d_name);
+      DIR* dir = opendir(subdir.c_str());
+      while (dir != nullptr) {
+        struct dirent* entry = readdir(dir);
+        if (entry == nullptr) break;
+        if (entry->d_name[0] == '.') continue;
+        const std::string name(entry->d_name);
+        const std::string path = absl::StrCat(subdir, "/", name);
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        if (name.find(".tmp") != std::string::npos) {
+          if (now - st.st_mtime > kStaleTmpFileSeconds) unlink(path.c_str());
+          continue;
+        }
+        if (name.find(".lock") != std::string::npos) continue;
+        entries.push_back({st.st_mtime, static_cast<uint64_t>(st.st_size),
+                           path});
+        total += st.st_size;
+      }
+      if (dir != nullptr) closedir(dir);
+    }
+    if (root != nullptr) closedir(root);
+
+    if (total > max_bytes_) {
+      std::sort(entries.begin(), entries.end(),
+                [](const Entry& a, const Entry& b) {
+                  return a.mtime < b.mtime;
+                });
+      const uint64_t target = max_bytes_ - max_bytes_ / 10;
+      for (const auto& entry : entries) {
+        if (total <= target) break;
+        if (unlink(entry.path.c_str()) == 0) total -= entry.size;
+      }
+      TF_VLog(1, "Cache filesystem evicted down to %llu bytes\n",
+              static_cast<unsigned long long>(total));
+    }
+    close(lock_fd);
+  }
+
+ private:
+  std::string BlockDir(const std::string& key) const {
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx",
+             static_cast<unsigned long long>(Fingerprint(key)));
+    return absl::StrCat(dir_, "/", std::string(hash, 2));
+  }
+
+  std::string BlockPath(const std::string& subdir, const std::string& key,
+                        uint64_t index) const {
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx",
+             static_cast<unsigned long long>(Fingerprint(key)));
+    return absl::StrCat(subdir, "/", hash, "_", index);
+  }
+
+  // Reads the cached block at `path` into `block` if it has the expected
+  // size, and marks it as recently used.
+  bool ReadCached(const std::string& path, std::vector<char>* block) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<uint64_t>(st.st_size) != block->size()) {
+      close(fd);
+      return false;
+    }
+    size_t read = 0;
+    while (read < block->size()) {
+      ssize_t r = pread(fd, block->data() + read, block->size() - read, read);
+      if (r < 0 && errno == EINTR) continue;
+      if (r <= 0) break;
+      read += r;
+    }
+    if (read == block->size()) futimens(fd, nullptr);
+    close(fd);
+    return read == block->size();
+  }
+
+  // Writes `block` to `path` through a temporary file. Failures only mean
+  // that the block stays uncached.
+  void Insert(const std::string& path, const std::vector<char>& block) {
+    const std::string tmp_path =
+        absl::StrCat(path, ".tmp", getpid(), "_", tmp_counter_++);
+    int fd = open(tmp_path.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC,
+                  0644);
+    if (fd < 0) return;
+    size_t written = 0;
+    while (written < block.size()) {
+      ssize_t r = write(fd, block.data() + written, block.size() - written);
+      if (r < 0 && errno == EINTR) continue;
+      if (r <= 0) break;
+      written += r;
+    }
+    if (close(fd) != 0 || written != block.size() ||
+        rename(tmp_path.c_str(), path.c_str()) != 0) {
+      unlink(tmp_path.c_str());
+      return;
+    }
+    // Scan for eviction each time a tenth of the maximum size was added.
+    if (added_bytes_.fetch_add(block.size()) + block.size() >=
+        max_bytes_ / 10) {
+      added_bytes_ = 0;
+      Evict();
+    }
+  }
+
+  const std::string dir_;
+  const size_t block_size_;
+  const uint64_t max_bytes_;
+  // The bytes this process cached since the last eviction scan.
+  std::atomic<uint64_t> added_bytes_{0};
+  std::atomic<uint64_t> tmp_counter_{0};
+};
+
+// The filesystems wrapped by the `cache+` schemes, in registration order.
+typedef struct InnerScheme {
+  std::string scheme;
+  TF_FilesystemPluginOps ops;
+} InnerScheme;
+static InnerScheme* inner_schemes[kMaxSchemes];
+static size_t num_inner_schemes = 0;
+
+typedef struct CacheFileSystem {
+  const InnerScheme* inner;
+  TF_Filesystem inner_filesystem;
+  DiskCache* cache;
+} CacheFileSystem;
+
+// SECTION 1. Implementation for `TF_RandomAccessFile`
+// ----------------------------------------------------------------------------
+namespace tf_random_access_file {
+typedef struct CacheFile {
+  const CacheFileSystem* cache_fs;
+  std::string path;
+  std::string key;
+  uint64_t length;
+  absl::Mutex mu;
+  // The wrapped file, opened on the first miss so that files that are fully
+  // cached are never opened on the remote store.
+  bool opened ABSL_GUARDED_BY(mu);
+  TF_RandomAccessFile inner_file;
+  CacheFile(const CacheFileSystem* cache_fs, std::string path, std::string key,
+            uint64_t length)
+      : cache_fs(cache_fs),
+        path(std::move(path)),
+        key(std::move(key)),
+        length(length),
+        mu(),
+        opened(false),
+        inner_file({nullptr}) {}
+} CacheFile;
+
+void Cleanup(TF_RandomAccessFile* file) {
+  auto cache_file = static_cast<CacheFile*>(file->plugin_file);
+  {
+    absl::MutexLock l(&cache_file->mu);
+    if (cache_file->opened) {
+      cache_file->cache_fs->inner->ops.random_access_file_ops->cleanup(
+          &cache_file->inner_file);
+    }
+  }
+  delete cache_file;
+}
+
+static int64_t ReadInner(CacheFile* cache_file, uint64_t offset, size_t n,
+                         char* buffer, TF_Status* status) {
+  auto ops = &cache_file->cache_fs->inner->ops;
+  {
+    absl::MutexLock l(&cache_file->mu);
+    if (!cache_file->opened) {
+      ops->filesystem_ops->new_random_access_file(
+          &cache_file->cache_fs->inner_filesystem, cache_file->path.c_str(),
+          &cache_file->inner_file, status);
+      if (TF_GetCode(status) != TF_OK) return -1;
+      cache_file->opened = true;
+    }
+  }
+  return ops->random_access_file_ops->read(&cache_file->inner_file, offset, n,
+                                           buffer, status);
+}
+
+int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
+             char* buffer, TF_Status* status) {
+  auto cache_file = static_cast<CacheFile*>(file->plugin_file);
+  auto cache = cache_file->cache_fs->cache;
+  const size_t block_size = cache->block_size();
+  const uint64_t end = (std::min)(offset + n, cache_file->length);
+  std::vector<char> block;
+  int64_t read = 0;
+  for (uint64_t index = offset / block_size; index * block_size < end;
+       ++index) {
+    const uint64_t block_start = index * block_size;
+    block.resize((std::min)(static_cast<uint64_t>(block_size),
+                            cache_file->length - block_start));
+    cache->ReadBlock(
+        cache_file->key, index, &block,
+        [cache_file](uint64_t fetch_offset, size_t fetch_n,
+                     char* fetch_buffer, TF_Status* fetch_status) {
+          return ReadInner(cache_file, fetch_offset, fetch_n, fetch_buffer,
+                           fetch_status);
+        },
+        status);
+    if (TF_GetCode(status) != TF_OK) return -1;
+    const uint64_t start = (std::max)(offset, block_start);
+    const uint64_t stop = (std::min)(end, block_start + block.size());
+    if (start >= stop) break;
+    memcpy(buffer + read, block.data() + (start - block_start), stop - start);
+    read += stop - start;
+    if (block.size() < block_size) break;
+  }
+  if (static_cast<size_t>(read) < n) {
+    TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
+  } else {
+    TF_SetStatus(status, TF_OK, "");
+  }
+  return read;
+}
+
+}  // namespace tf_random_access_file
+
+// SECTION 2. Implementation for `TF_WritableFile`
+// ----------------------------------------------------------------------------
+namespace tf_writable_file {
+typedef struct CacheWritableFile {
+  const TF_WritableFileOps* ops;
+  TF_WritableFile inner_file;
+} CacheWritableFile;
+
+void Cleanup(TF_WritableFile* file) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  cache_file->ops->cleanup(&cache_file->inner_file);
+  delete cache_file;
+}
+
+void Append(const TF_WritableFile* file, const char* buffer, size_t n,
+            TF_Status* status) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  cache_file->ops->append(&cache_file->inner_file, buffer, n, status);
+}
+
+int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  if (cache_file->ops->tell == nullptr) {
+    TF_SetStatus(status, TF_UNIMPLEMENTED, "Tell is not supported");
+    return -1;
+  }
+  return cache_file->ops->tell(&cache_file->inner_file, status);
+}
+
+void Flush(const TF_WritableFile* file, TF_Status* status) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  if (cache_file->ops->flush == nullptr) return TF_SetStatus(status, TF_OK, "");
+  cache_file->ops->flush(&cache_file->inner_file, status);
+}
+
+void Sync(const TF_WritableFile* file, TF_Status* status) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  if (cache_file->ops->sync == nullptr) return TF_SetStatus(status, TF_OK, "");
+  cache_file->ops->sync(&cache_file->inner_file, status);
+}
+
+void Close(const TF_WritableFile* file, TF_Status* status) {
+  auto cache_file = static_cast<CacheWritableFile*>(file->plugin_file);
+  cache_file->ops->close(&cache_file->inner_file, status);
+}
+
+}  // namespace tf_writable_file
+
+// SECTION 3. Implementation for `TF_ReadOnlyMemoryRegion`
+// ----------------------------------------------------------------------------
+namespace tf_read_only_memory_region {
+typedef struct CacheMemoryRegion {
+  const TF_ReadOnlyMemoryRegionOps* ops;
+  TF_ReadOnlyMemoryRegion inner_region;
+} CacheMemoryRegion;
+
+void Cleanup(TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<CacheMemoryRegion*>(region->plugin_memory_region);
+  r->ops->cleanup(&r->inner_region);
+  delete r;
+}
+
+const void* Data(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<CacheMemoryRegion*>(region->plugin_memory_region);
+  return r->ops->data(&r->inner_region);
+}
+
+uint64_t Length(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<CacheMemoryRegion*>(region->plugin_memory_region);
+  return r->ops->length(&r->inner_region);
+}
+
+}  // namespace tf_read_only_memory_region
+
+// SECTION 4. Implementation for `TF_Filesystem`, the actual filesystem
+// ----------------------------------------------------------------------------
+namespace tf_cache_filesystem {
+
+static CacheFileSystem* GetCacheFileSystem(const TF_Filesystem* filesystem) {
+  return static_cast<CacheFileSystem*>(filesystem->plugin_filesystem);
+}
+
+template <size_t kIndex>
+void Init(TF_Filesystem* filesystem, TF_Status* status) {
+  auto cache = DiskCache::Default(status);
+  if (TF_GetCode(status) != TF_OK) return;
+  auto cache_fs = new CacheFileSystem();
+  cache_fs->inner = inner_schemes[kIndex];
+  cache_fs->inner_filesystem.plugin_filesystem = nullptr;
+  cache_fs->cache = cache;
+  cache_fs->inner->ops.filesystem_ops->init(&cache_fs->inner_filesystem,
+                                            status);
+  if (TF_GetCode(status) != TF_OK) {
+    delete cache_fs;
+    return;
+  }
+  filesystem->plugin_filesystem = cache_fs;
+}
+
+// The init function of each wrapped scheme, by registration order.
+static void (*const kInits[kMaxSchemes])(TF_Filesystem*, TF_Status*) = {
+    Init<0>, Init<1>, Init<2>, Init<3>, Init<4>, Init<5>, Init<6>, Init<7>};
+
+void Cleanup(TF_Filesystem* filesystem) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->cleanup(&cache_fs->inner_filesystem);
+  delete cache_fs;
+}
+
+void NewRandomAccessFile(const TF_Filesystem* filesystem, const char* path,
+                         TF_RandomAccessFile* file, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  auto ops = cache_fs->inner->ops.filesystem_ops;
+  if (ops->stat == nullptr) {
+    return TF_SetStatus(status, TF_UNIMPLEMENTED,
+                        "Caching requires Stat of the wrapped filesystem");
+  }
+  std::string inner_path = InnerPath(path);
+  TF_FileStatistics stats;
+  ops->stat(&cache_fs->inner_filesystem, inner_path.c_str(), &stats, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  if (stats.is_directory) {
+    return TF_SetStatus(status, TF_FAILED_PRECONDITION,
+                        absl::StrCat(path, " is a directory").c_str());
+  }
+  // The wrapped filesystems do not expose ETags, so the modification time
+  // and length identify the version of the file.
+  std::string key =
+      absl::StrCat(inner_path, "@", stats.mtime_nsec, "@", stats.length);
+  file->plugin_file = new tf_random_access_file::CacheFile(
+      cache_fs, inner_path, key, stats.length);
+  TF_SetStatus(status, TF_OK, "");
+}
+
+static void NewWritableFileImpl(
+    const TF_Filesystem* filesystem, const char* path, TF_WritableFile* file,
+    void (*open)(const TF_Filesystem*, const char*, TF_WritableFile*,
+                 TF_Status*),
+    TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  auto cache_file = new tf_writable_file::CacheWritableFile{
+      cache_fs->inner->ops.writable_file_ops, {nullptr}};
+  open(&cache_fs->inner_filesystem, InnerPath(path).c_str(),
+       &cache_file->inner_file, status);
+  if (TF_GetCode(status) != TF_OK) {
+    delete cache_file;
+    return;
+  }
+  file->plugin_file = cache_file;
+}
+
+void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
+                     TF_WritableFile* file, TF_Status* status) {
+  auto ops = GetCacheFileSystem(filesystem)->inner->ops.filesystem_ops;
+  NewWritableFileImpl(filesystem, path, file, ops->new_writable_file, status);
+}
+
+void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
+                       TF_WritableFile* file, TF_Status* status) {
+  auto ops = GetCacheFileSystem(filesystem)->inner->ops.filesystem_ops;
+  NewWritableFileImpl(filesystem, path, file, ops->new_appendable_file,
+                      status);
+}
+
+void NewReadOnlyMemoryRegionFromFile(const TF_Filesystem* filesystem,
+                                     const char* path,
+                                     TF_ReadOnlyMemoryRegion* region,
+                                     TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  auto r = new tf_read_only_memory_region::CacheMemoryRegion{
+      cache_fs->inner->ops.read_only_memory_region_ops, {nullptr}};
+  cache_fs->inner->ops.filesystem_ops->new_read_only_memory_region_from_file(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), &r->inner_region,
+      status);
+  if (TF_GetCode(status) != TF_OK) {
+    delete r;
+    return;
+  }
+  region->plugin_memory_region = r;
+}
+
+#define FORWARD_PATH_OP(name, op)                                       \
+  void name(const TF_Filesystem* filesystem, const char* path,          \
+            TF_Status* status) {                                        \
+    auto cache_fs = GetCacheFileSystem(filesystem);                     \
+    cache_fs->inner->ops.filesystem_ops->op(&cache_fs->inner_filesystem, \
+                                            InnerPath(path).c_str(),    \
+                                            status);                    \
+  }
+
+FORWARD_PATH_OP(CreateDir, create_dir)
+FORWARD_PATH_OP(RecursivelyCreateDir, recursively_create_dir)
+FORWARD_PATH_OP(DeleteFile, delete_file)
+FORWARD_PATH_OP(DeleteDir, delete_dir)
+FORWARD_PATH_OP(PathExists, path_exists)
+
+#undef FORWARD_PATH_OP
+
+void DeleteRecursively(const TF_Filesystem* filesystem, const char* path,
+                       uint64_t* undeleted_files, uint64_t* undeleted_dirs,
+                       TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->delete_recursively(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), undeleted_files,
+      undeleted_dirs, status);
+}
+
+void RenameFile(const TF_Filesystem* filesystem, const char* src,
+                const char* dst, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->rename_file(
+      &cache_fs->inner_filesystem, InnerPath(src).c_str(),
+      InnerPath(dst).c_str(), status);
+}
+
+void CopyFile(const TF_Filesystem* filesystem, const char* src,
+              const char* dst, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->copy_file(
+      &cache_fs->inner_filesystem, InnerPath(src).c_str(),
+      InnerPath(dst).c_str(), status);
+}
+
+void Stat(const TF_Filesystem* filesystem, const char* path,
+          TF_FileStatistics* stats, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->stat(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), stats, status);
+}
+
+bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
+                 TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  return cache_fs->inner->ops.filesystem_ops->is_directory(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), status);
+}
+
+int64_t GetFileSize(const TF_Filesystem* filesystem, const char* path,
+                    TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  return cache_fs->inner->ops.filesystem_ops->get_file_size(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), status);
+}
+
+int GetChildren(const TF_Filesystem* filesystem, const char* path,
+                char*** entries, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  return cache_fs->inner->ops.filesystem_ops->get_children(
+      &cache_fs->inner_filesystem, InnerPath(path).c_str(), entries, status);
+}
+
+int GetMatchingPaths(const TF_Filesystem* filesystem, const char* glob,
+                     char*** entries, TF_Status* status) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  int num_entries = cache_fs->inner->ops.filesystem_ops->get_matching_paths(
+      &cache_fs->inner_filesystem, InnerPath(glob).c_str(), entries, status);
+  if (TF_GetCode(status) != TF_OK) return num_entries;
+  // The matches are full paths of the wrapped scheme.
+  for (int i = 0; i < num_entries; i++) {
+    std::string entry = absl::StrCat(kCachePrefix, (*entries)[i]);
+    plugin_memory_free((*entries)[i]);
+    (*entries)[i] = strdup(entry.c_str());
+  }
+  return num_entries;
+}
+
+void FlushCaches(const TF_Filesystem* filesystem) {
+  auto cache_fs = GetCacheFileSystem(filesystem);
+  cache_fs->inner->ops.filesystem_ops->flush_caches(
+      &cache_fs->inner_filesystem);
+}
+
+static char* TranslateName(const TF_Filesystem* filesystem, const char* uri) {
+  return strdup(uri);
+}
+
+}  // namespace tf_cache_filesystem
+
+void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri,
+                                 void (*provide)(TF_FilesystemPluginOps*,
+                                                 const char*)) {
+  TF_SetFilesystemVersionMetadata(ops);
+  ops->scheme = strdup(uri);
+  if (num_inner_schemes == kMaxSchemes) {
+    TF_Log(TF_ERROR, "Too many cache filesystem schemes, skipping %s", uri);
+    return;
+  }
+  const size_t index = num_inner_schemes++;
+  auto inner = new InnerScheme();
+  inner->scheme = InnerPath(uri);
+  provide(&inner->ops, inner->scheme.c_str());
+  inner_schemes[index] = inner;
+  auto inner_ops = inner->ops.filesystem_ops;
+
+  ops->random_access_file_ops = static_cast<TF_RandomAccessFileOps*>(
+      plugin_memory_allocate(TF_RANDOM_ACCESS_FILE_OPS_SIZE));
+  ops->random_access_file_ops->cleanup = tf_random_access_file::Cleanup;
+  ops->random_access_file_ops->read = tf_random_access_file::Read;
+
+  ops->writable_file_ops = static_cast<TF_WritableFileOps*>(
+      plugin_memory_allocate(TF_WRITABLE_FILE_OPS_SIZE));
+  ops->writable_file_ops->cleanup = tf_writable_file::Cleanup;
+  ops->writable_file_ops->append = tf_writable_file::Append;
+  ops->writable_file_ops->tell = tf_writable_file::Tell;
+  ops->writable_file_ops->flush = tf_writable_file::Flush;
+  ops->writable_file_ops->sync = tf_writable_file::Sync;
+  ops->writable_file_ops->close = tf_writable_file::Close;
+
+  ops->read_only_memory_region_ops = static_cast<TF_ReadOnlyMemoryRegionOps*>(
+      plugin_memory_allocate(TF_READ_ONLY_MEMORY_REGION_OPS_SIZE));
+  ops->read_only_memory_region_ops->cleanup =
+      tf_read_only_memory_region::Cleanup;
+  ops->read_only_memory_region_ops->data = tf_read_only_memory_region::Data;
+  ops->read_only_memory_region_ops->length = tf_read_only_memory_region::Length;
+
+  // Operations the wrapped filesystem leaves unset are left unset too, so
+  // that TensorFlow applies the same fallbacks.
+  ops->filesystem_ops = static_cast<TF_FilesystemOps*>(
+      plugin_memory_allocate(TF_FILESYSTEM_OPS_SIZE));
+  ops->filesystem_ops->init = tf_cache_filesystem::kInits[index];
+  ops->filesystem_ops->cleanup = tf_cache_filesystem::Cleanup;
+  ops->filesystem_ops->new_random_access_file =
+      tf_cache_filesystem::NewRandomAccessFile;
+#define SET_IF_WRAPPED(op, function) \
+  if (inner_ops->op != nullptr) ops->filesystem_ops->op = function;
+  SET_IF_WRAPPED(new_writable_file, tf_cache_filesystem::NewWritableFile);
+  SET_IF_WRAPPED(new_appendable_file, tf_cache_filesystem::NewAppendableFile);
+  SET_IF_WRAPPED(new_read_only_memory_region_from_file,
+                 tf_cache_filesystem::NewReadOnlyMemoryRegionFromFile);
+  SET_IF_WRAPPED(create_dir, tf_cache_filesystem::CreateDir);
+  SET_IF_WRAPPED(recursively_create_dir,
+                 tf_cache_filesystem::RecursivelyCreateDir);
+  SET_IF_WRAPPED(delete_file, tf_cache_filesystem::DeleteFile);
+  SET_IF_WRAPPED(delete_dir, tf_cache_filesystem::DeleteDir);
+  SET_IF_WRAPPED(delete_recursively, tf_cache_filesystem::DeleteRecursively);
+  SET_IF_WRAPPED(copy_file, tf_cache_filesystem::CopyFile);
+  SET_IF_WRAPPED(rename_file, tf_cache_filesystem::RenameFile);
+  SET_IF_WRAPPED(path_exists, tf_cache_filesystem::PathExists);
+  SET_IF_WRAPPED(stat, tf_cache_filesystem::Stat);
+  SET_IF_WRAPPED(is_directory, tf_cache_filesystem::IsDirectory);
+  SET_IF_WRAPPED(get_file_size, tf_cache_filesystem::GetFileSize);
+  SET_IF_WRAPPED(get_children, tf_cache_filesystem::GetChildren);
+  SET_IF_WRAPPED(get_matching_paths, tf_cache_filesystem::GetMatchingPaths);
+  SET_IF_WRAPPED(flush_caches, tf_cache_filesystem::FlushCaches);
+#undef SET_IF_WRAPPED
+  ops->filesystem_ops->translate_name = tf_cache_filesystem::TranslateName;
+}
+
+}  // namespace cache
+
+}  // namespace io
+}  // namespace tensorflow
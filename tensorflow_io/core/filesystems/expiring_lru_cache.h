@@ -0,0 +1,288 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_EXPIRING_LRU_CACHE_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_EXPIRING_LRU_CACHE_H_
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "tensorflow/c/tf_status.h"
+
+namespace tensorflow {
+namespace io {
+
+// A thread-safe cache of values keyed by string (typically a path), in which
+// entries expire `max_age` seconds after they are inserted. A `max_age` of
+// zero disables the cache. If `max_entries` is non-zero the least recently
+// used entry is evicted once the cache holds more than `max_entries`.
+//
+// Failures of a computation with a given code, e.g. `TF_NOT_FOUND` for a
+// missing object, may be cached too as negative entries, for at most
+// `negative_max_age` seconds, so that polling a path that does not exist
+// does not send a request every time.
+//
+// The cache may be split into shards by the hash of the key, each shard with
+// its own lock, LRU list and an equal share of `max_entries`, so that
+// concurrent lookups of different keys do not contend on one lock. The LRU
+// order is then only kept within every shard.
+//
+// This is the stat and matching-paths cache of the GCS, S3, Azure and HTTP
+// filesystems.
+template <typename T>
+class ExpiringLRUCache {
+ public:
+  // A `negative_max_age` of 0 means that no failure is cached.
+  ExpiringLRUCache(uint64_t max_age, size_t max_entries,
+                   std::function<uint64_t()> timer_seconds = nullptr,
+                   uint64_t negative_max_age = 0, size_t num_shards = 1)
+      : max_age_(max_age),
+        negative_max_age_(max_age > 0 ? negative_max_age : 0),
+        max_entries_(max_entries),
+        timer_seconds_(timer_seconds != nullptr
+                           ? std::move(timer_seconds)
+                           : [] { return absl::ToUnixSeconds(absl::Now()); }) {
+    num_shards = std::max<size_t>(num_shards, 1);
+    if (max_entries_ > 0) num_shards = std::min(num_shards, max_entries_);
+    shard_max_entries_ = (max_entries_ + num_shards - 1) / num_shards;
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(new Shard());
+    }
+  }
+
+  // Inserts `value` with key `key`, replacing an existing entry.
+  void Insert(const std::string& key, const T& value) {
+    if (max_age_ == 0) return;
+    Shard* shard = ShardFor(key);
+    absl::MutexLock lock(&shard->mu);
+    InsertLocked(shard, key, value, TF_OK, "");
+  }
+
+  // Deletes the entry with key `key`. Returns true if it was in the cache.
+  bool Delete(const std::string& key) {
+    Shard* shard = ShardFor(key);
+    absl::MutexLock lock(&shard->mu);
+    return DeleteLocked(shard, key);
+  }
+
+  // Deletes the entry with key `key` if it is a negative one, e.g. once the
+  // path it was computed for has been created.
+  void DeleteNegative(const std::string& key) {
+    if (negative_max_age_ == 0) return;
+    Shard* shard = ShardFor(key);
+    absl::MutexLock lock(&shard->mu);
+    auto it = shard->cache.find(key);
+    if (it != shard->cache.end() && it->second.code != TF_OK) {
+      DeleteLocked(shard, key);
+    }
+  }
+
+  // Deletes all entries whose key starts with `prefix`.
+  void DeletePrefix(const std::string& prefix) {
+    for (const auto& shard : shards_) {
+      absl::MutexLock lock(&shard->mu);
+      auto it = shard->cache.lower_bound(prefix);
+      while (it != shard->cache.end() &&
+             it->first.compare(0, prefix.size(), prefix) == 0) {
+        shard->lru_list.erase(it->second.lru_iterator);
+        it = shard->cache.erase(it);
+      }
+    }
+  }
+
+  // Looks up the entry with key `key`. Returns true and copies the value to
+  // `value` if it exists and has not expired. Negative entries are not
+  // returned.
+  bool Lookup(const std::string& key, T* value) {
+    if (max_age_ == 0) return false;
+    bool hit;
+    {
+      Shard* shard = ShardFor(key);
+      absl::MutexLock lock(&shard->mu);
+      hit = LookupLocked(shard, key, value, TF_OK, nullptr);
+    }
+    if (lookup_observer_) lookup_observer_(hit);
+    return hit;
+  }
+
+  // Sets a callback run after every lookup of an enabled cache with whether
+  // it was a hit, e.g. to export the hit ratio. Must be set before the cache
+  // is shared between threads.
+  void SetLookupObserver(std::function<void(bool hit)> observer) {
+    lookup_observer_ = std::move(observer);
+  }
+
+  typedef std::function<void(const std::string&, T*, TF_Status*)> ComputeFunc;
+
+  // Looks up the entry with key `key`, and on a miss computes and inserts it
+  // with `compute_func`. If `compute_func` sets `status` to `negative_code`,
+  // other than `TF_OK`, the failure is cached as a negative entry, which
+  // later calls with the same `negative_code` return as is.
+  //
+  // The lock is not held while the value is computed, so concurrent misses
+  // for different keys do not wait on each other's round trips; concurrent
+  // misses of one key may then compute it more than once.
+  void LookupOrCompute(const std::string& key, T* value,
+                       const ComputeFunc& compute_func, TF_Status* status,
+                       TF_Code negative_code = TF_OK) {
+    if (max_age_ == 0) return compute_func(key, value, status);
+
+    Shard* shard = ShardFor(key);
+    bool hit;
+    {
+      absl::MutexLock lock(&shard->mu);
+      hit = LookupLocked(shard, key, value, negative_code, status);
+    }
+    if (lookup_observer_) lookup_observer_(hit);
+    if (hit) return;
+    compute_func(key, value, status);
+    const TF_Code code = TF_GetCode(status);
+    if (code == TF_OK || (code == negative_code && negative_max_age_ > 0)) {
+      absl::MutexLock lock(&shard->mu);
+      InsertLocked(shard, key, *value, code, TF_Message(status));
+    }
+  }
+
+  // Clears the cache.
+  void Clear() {
+    for (const auto& shard : shards_) {
+      absl::MutexLock lock(&shard->mu);
+      shard->cache.clear();
+      shard->lru_list.clear();
+    }
+  }
+
+  uint64_t max_age() const { return max_age_; }
+  uint64_t negative_max_age() const { return negative_max_age_; }
+  size_t max_entries() const { return max_entries_; }
+  size_t num_shards() const { return shards_.size(); }
+
+ private:
+  struct Entry {
+    // The time (in seconds) at which the entry was inserted.
+    uint64_t timestamp;
+    // The entry's value, unset for a negative entry.
+    T value;
+    // `TF_OK`, or the code and message of the failure of a negative entry.
+    TF_Code code;
+    std::string message;
+    // A list iterator pointing to the entry's position in the LRU list.
+    std::list<std::string>::iterator lru_iterator;
+  };
+
+  // A shard of the cache, holding the keys that hash to it.
+  struct Shard {
+    // Guards access to the cache and the LRU list.
+    absl::Mutex mu;
+    // The cache (a map from string key to Entry). Ordered, so that all
+    // entries under a prefix can be removed.
+    std::map<std::string, Entry> cache ABSL_GUARDED_BY(mu);
+    // The LRU list of entries. The front of the list identifies the most
+    // recently accessed entry.
+    std::list<std::string> lru_list ABSL_GUARDED_BY(mu);
+  };
+
+  Shard* ShardFor(const std::string& key) const {
+    if (shards_.size() == 1) return shards_[0].get();
+    return shards_[std::hash<std::string>()(key) % shards_.size()].get();
+  }
+
+  // Looks up a positive entry, or a negative entry of `negative_code` if it
+  // is not `TF_OK`, and sets `status` of a hit to the code of the entry.
+  bool LookupLocked(Shard* shard, const std::string& key, T* value,
+                    TF_Code negative_code, TF_Status* status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    auto it = shard->cache.find(key);
+    if (it == shard->cache.end()) return false;
+    const Entry& entry = it->second;
+    if (entry.code != TF_OK && entry.code != negative_code) return false;
+    const uint64_t max_age =
+        entry.code == TF_OK ? max_age_ : negative_max_age_;
+    shard->lru_list.erase(entry.lru_iterator);
+    if (timer_seconds_() - entry.timestamp > max_age) {
+      shard->cache.erase(it);
+      return false;
+    }
+    if (entry.code == TF_OK) *value = entry.value;
+    if (status != nullptr) {
+      TF_SetStatus(status, entry.code, entry.message.c_str());
+    }
+    shard->lru_list.push_front(it->first);
+    it->second.lru_iterator = shard->lru_list.begin();
+    return true;
+  }
+
+  void InsertLocked(Shard* shard, const std::string& key, const T& value,
+                    TF_Code code, const std::string& message)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    shard->lru_list.push_front(key);
+    Entry entry{timer_seconds_(), value, code, message,
+                shard->lru_list.begin()};
+    auto insert = shard->cache.insert(std::make_pair(key, entry));
+    if (!insert.second) {
+      shard->lru_list.erase(insert.first->second.lru_iterator);
+      insert.first->second = entry;
+    } else if (shard_max_entries_ > 0 &&
+               shard->cache.size() > shard_max_entries_) {
+      shard->cache.erase(shard->lru_list.back());
+      shard->lru_list.pop_back();
+    }
+  }
+
+  bool DeleteLocked(Shard* shard, const std::string& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    auto it = shard->cache.find(key);
+    if (it == shard->cache.end()) return false;
+    shard->lru_list.erase(it->second.lru_iterator);
+    shard->cache.erase(it);
+    return true;
+  }
+
+  // The maximum age of entries in the cache, in seconds. A value of 0 means
+  // that no entry is ever placed in the cache.
+  const uint64_t max_age_;
+
+  // The maximum age of negative entries, in seconds. A value of 0 means that
+  // no failure is cached.
+  const uint64_t negative_max_age_;
+
+  // The maximum number of entries in the cache. A value of 0 means there is
+  // no limit on entry count.
+  const size_t max_entries_;
+
+  // The maximum number of entries in each shard.
+  size_t shard_max_entries_;
+
+  // The callback to read timestamps.
+  std::function<uint64_t()> timer_seconds_;
+
+  // The callback run after every lookup.
+  std::function<void(bool hit)> lookup_observer_;
+
+  // The shards of the cache.
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_EXPIRING_LRU_CACHE_H_
@@ -0,0 +1,202 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// Computes the length of the key, counting the calls. Keys starting with
+// "missing" fail with TF_NOT_FOUND, and keys starting with "broken" with
+// TF_INTERNAL.
+class LengthCompute {
+ public:
+  ExpiringLRUCache<int>::ComputeFunc Func() {
+    return [this](const std::string& key, int* value, TF_Status* status) {
+      ++calls_;
+      if (key.compare(0, 7, "missing") == 0) {
+        return TF_SetStatus(status, TF_NOT_FOUND, "not found");
+      }
+      if (key.compare(0, 6, "broken") == 0) {
+        return TF_SetStatus(status, TF_INTERNAL, "broken");
+      }
+      *value = key.size();
+      TF_SetStatus(status, TF_OK, "");
+    };
+  }
+
+  int calls() const { return calls_; }
+
+ private:
+  std::atomic<int> calls_{0};
+};
+
+TEST(ExpiringLRUCacheTest, NEGATIVE_ENTRIES) {
+  uint64_t now = 1000;
+  ExpiringLRUCache<int> cache(
+      10, 0, [&now] { return now; }, 2);
+  LengthCompute compute;
+  TF_Status* status = TF_NewStatus();
+  int value = 0;
+
+  cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(TF_NOT_FOUND, TF_GetCode(status));
+  cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(TF_NOT_FOUND, TF_GetCode(status));
+  EXPECT_STREQ("not found", TF_Message(status));
+  EXPECT_EQ(1, compute.calls());
+  // Negative entries are neither returned by Lookup, nor to callers that
+  // do not expect their code.
+  EXPECT_FALSE(cache.Lookup("missing", &value));
+  cache.LookupOrCompute("missing", &value, compute.Func(), status);
+  EXPECT_EQ(2, compute.calls());
+
+  // Other failures are not cached.
+  cache.LookupOrCompute("broken", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  cache.LookupOrCompute("broken", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(TF_INTERNAL, TF_GetCode(status));
+  EXPECT_EQ(4, compute.calls());
+
+  // Negative entries expire after their own max age.
+  cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(4, compute.calls());
+  now += 3;
+  cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(5, compute.calls());
+
+  // DeleteNegative only drops negative entries.
+  cache.LookupOrCompute("path", &value, compute.Func(), status, TF_NOT_FOUND);
+  EXPECT_EQ(TF_OK, TF_GetCode(status));
+  EXPECT_EQ(4, value);
+  EXPECT_EQ(6, compute.calls());
+  cache.DeleteNegative("path");
+  EXPECT_TRUE(cache.Lookup("path", &value));
+  cache.DeleteNegative("missing");
+  cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                        TF_NOT_FOUND);
+  EXPECT_EQ(7, compute.calls());
+  TF_DeleteStatus(status);
+}
+
+TEST(ExpiringLRUCacheTest, NEGATIVE_ENTRIES_DISABLED) {
+  ExpiringLRUCache<int> cache(10, 0, nullptr, 0);
+  LengthCompute compute;
+  TF_Status* status = TF_NewStatus();
+  int value = 0;
+  for (int i = 0; i < 2; ++i) {
+    cache.LookupOrCompute("missing", &value, compute.Func(), status,
+                          TF_NOT_FOUND);
+    EXPECT_EQ(TF_NOT_FOUND, TF_GetCode(status));
+  }
+  EXPECT_EQ(2, compute.calls());
+  TF_DeleteStatus(status);
+
+  // Without a max age nothing is cached, negative entries included.
+  ExpiringLRUCache<int> disabled(0, 0, nullptr, 10);
+  EXPECT_EQ(0, disabled.negative_max_age());
+}
+
+TEST(ExpiringLRUCacheTest, SHARDS) {
+  uint64_t now = 1000;
+  ExpiringLRUCache<int> cache(
+      10, 16, [&now] { return now; }, 0, 4);
+  ASSERT_EQ(4, cache.num_shards());
+  for (int i = 0; i < 64; ++i) {
+    cache.Insert(std::to_string(i), i);
+  }
+  // Every shard holds at most its share of the entries.
+  int cached = 0;
+  int value = 0;
+  for (int i = 0; i < 64; ++i) {
+    if (cache.Lookup(std::to_string(i), &value)) {
+      EXPECT_EQ(i, value);
+      ++cached;
+    }
+  }
+  EXPECT_LE(cached, 16);
+  EXPECT_GT(cached, 0);
+  // The most recent entry of every shard is kept.
+  EXPECT_TRUE(cache.Lookup("63", &value));
+
+  now += 11;
+  EXPECT_FALSE(cache.Lookup("63", &value));
+
+  // The shards are capped to one entry each.
+  ExpiringLRUCache<int> capped(10, 2, nullptr, 0, 8);
+  EXPECT_EQ(2, capped.num_shards());
+}
+
+TEST(ExpiringLRUCacheTest, DELETE_PREFIX) {
+  ExpiringLRUCache<int> cache(10, 0, nullptr, 0, 4);
+  for (const char* key : {"s3://b/a", "s3://b/a/x", "s3://b/a/y/z", "s3://b/ab",
+                          "s3://b/c"}) {
+    cache.Insert(key, 1);
+  }
+  // Entries under the prefix are deleted from every shard.
+  cache.DeletePrefix("s3://b/a/");
+  int value = 0;
+  EXPECT_TRUE(cache.Lookup("s3://b/a", &value));
+  EXPECT_FALSE(cache.Lookup("s3://b/a/x", &value));
+  EXPECT_FALSE(cache.Lookup("s3://b/a/y/z", &value));
+  EXPECT_TRUE(cache.Lookup("s3://b/ab", &value));
+  EXPECT_TRUE(cache.Lookup("s3://b/c", &value));
+}
+
+TEST(ExpiringLRUCacheTest, CONCURRENT_LOOKUPS) {
+  ExpiringLRUCache<int> cache(100, 0, nullptr, 100, 4);
+  LengthCompute compute;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      TF_Status* status = TF_NewStatus();
+      for (int i = 0; i < 500; ++i) {
+        std::string key = std::string(i % 2 ? "missing" : "path") +
+                          std::to_string((i + t) % 32);
+        int value = -1;
+        cache.LookupOrCompute(key, &value, compute.Func(), status,
+                              TF_NOT_FOUND);
+        if (i % 2) {
+          EXPECT_EQ(TF_NOT_FOUND, TF_GetCode(status));
+        } else {
+          EXPECT_EQ(TF_OK, TF_GetCode(status));
+          EXPECT_EQ(static_cast<int>(key.size()), value);
+        }
+      }
+      TF_DeleteStatus(status);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  // Concurrent misses of a key may compute it more than once, but every
+  // thread computes every key at most once.
+  EXPECT_LE(compute.calls(), 8 * 64);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
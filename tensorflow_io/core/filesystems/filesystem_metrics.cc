@@ -0,0 +1,315 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// Latency histogram buckets, 10us * 2^i for i in [0, kLatencyBuckets), so
+// that the last one ends at about 84s. Shared by TF monitoring and the
+// Prometheus text.
+constexpr double kLatencyScaleMicros = 10;
+constexpr int kLatencyBuckets = kFilesystemLatencyBuckets;
+constexpr uint64_t kDefaultDumpIntervalSecs = 10;
+
+const char* CodeName(TF_Code code) {
+  switch (code) {
+    case TF_OK:
+      return "OK";
+    case TF_CANCELLED:
+      return "CANCELLED";
+    case TF_INVALID_ARGUMENT:
+      return "INVALID_ARGUMENT";
+    case TF_DEADLINE_EXCEEDED:
+      return "DEADLINE_EXCEEDED";
+    case TF_NOT_FOUND:
+      return "NOT_FOUND";
+    case TF_ALREADY_EXISTS:
+      return "ALREADY_EXISTS";
+    case TF_PERMISSION_DENIED:
+      return "PERMISSION_DENIED";
+    case TF_UNAUTHENTICATED:
+      return "UNAUTHENTICATED";
+    case TF_RESOURCE_EXHAUSTED:
+      return "RESOURCE_EXHAUSTED";
+    case TF_FAILED_PRECONDITION:
+      return "FAILED_PRECONDITION";
+    case TF_ABORTED:
+      return "ABORTED";
+    case TF_OUT_OF_RANGE:
+      return "OUT_OF_RANGE";
+    case TF_UNIMPLEMENTED:
+      return "UNIMPLEMENTED";
+    case TF_INTERNAL:
+      return "INTERNAL";
+    case TF_UNAVAILABLE:
+      return "UNAVAILABLE";
+    case TF_DATA_LOSS:
+      return "DATA_LOSS";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+uint64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Rewrites the file `path` with the Prometheus text every `interval` seconds.
+void DumpLoop(FilesystemMetrics* metrics, std::string path,
+              uint64_t interval) {
+  const std::string tmp_path = path + ".tmp";
+  while (true) {
+    std::this_thread::sleep_for(std::chrono::seconds(interval));
+    std::string text = metrics->PrometheusText();
+    FILE* file = fopen(tmp_path.c_str(), "w");
+    if (file == nullptr) continue;
+    bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+    written = fclose(file) == 0 && written;
+    if (written) rename(tmp_path.c_str(), path.c_str());
+  }
+}
+
+std::string LatencyBound(int bucket) {
+  if (bucket == kLatencyBuckets) return "+Inf";
+  return absl::StrCat(kLatencyScaleMicros * (1ULL << bucket) / 1e6);
+}
+
+}  // namespace
+
+// The TF monitoring metrics, named after the prefix. The names are kept
+// alongside the metrics, which refer to them.
+struct FilesystemMetrics::Monitoring {
+  Monitoring(const std::string& prefix, const std::string& plugins)
+      : requests_name(absl::StrCat("/tensorflow/io/", prefix, "/requests")),
+        requests_description(absl::StrCat("Requests of ", plugins, ".")),
+        bytes_name(absl::StrCat("/tensorflow/io/", prefix, "/bytes")),
+        bytes_description(
+            absl::StrCat("Bytes read and written by ", plugins, ".")),
+        retries_name(absl::StrCat("/tensorflow/io/", prefix, "/retries")),
+        retries_description(
+            absl::StrCat("Retried requests of ", plugins, ".")),
+        latency_name(absl::StrCat("/tensorflow/io/", prefix, "/latency_usec")),
+        latency_description(absl::StrCat(
+            "Latency in microseconds of the requests of ", plugins, ".")),
+        cache_lookups_name(
+            absl::StrCat("/tensorflow/io/", prefix, "/cache_lookups")),
+        cache_lookups_description(
+            absl::StrCat("Lookups in the caches of ", plugins, ".")),
+        requests(monitoring::Counter<3>::New(
+            requests_name, requests_description, "filesystem", "op",
+            "status")),
+        bytes(monitoring::Counter<2>::New(bytes_name, bytes_description,
+                                          "filesystem", "op")),
+        retries(monitoring::Counter<2>::New(
+            retries_name, retries_description, "filesystem", "op")),
+        latency(monitoring::Sampler<2>::New(
+            {latency_name, latency_description, "filesystem", "op"},
+            monitoring::Buckets::Exponential(kLatencyScaleMicros, 2,
+                                             kLatencyBuckets))),
+        cache_lookups(monitoring::Counter<3>::New(
+            cache_lookups_name, cache_lookups_description, "filesystem",
+            "cache", "result")) {}
+
+  const std::string requests_name, requests_description;
+  const std::string bytes_name, bytes_description;
+  const std::string retries_name, retries_description;
+  const std::string latency_name, latency_description;
+  const std::string cache_lookups_name, cache_lookups_description;
+  std::unique_ptr<monitoring::Counter<3>> requests;
+  std::unique_ptr<monitoring::Counter<2>> bytes;
+  std::unique_ptr<monitoring::Counter<2>> retries;
+  std::unique_ptr<monitoring::Sampler<2>> latency;
+  std::unique_ptr<monitoring::Counter<3>> cache_lookups;
+};
+
+FilesystemMetrics::FilesystemMetrics(const std::string& prefix,
+                                     const std::string& plugins)
+    : prefix_(prefix), monitoring_(new Monitoring(prefix, plugins)) {}
+
+FilesystemMetrics::~FilesystemMetrics() = default;
+
+FilesystemMetrics* FilesystemMetrics::Default() {
+  static FilesystemMetrics* metrics = new FilesystemMetrics(
+      "filesystem", "the filesystem plugins of tensorflow-io");
+  return metrics;
+}
+
+void FilesystemMetrics::MaybeStartDumpThread() {
+  std::call_once(dump_once_, [this] {
+    const std::string env =
+        absl::StrCat("TFIO_", absl::AsciiStrToUpper(prefix_), "_METRICS_");
+    const char* path = std::getenv((env + "FILE").c_str());
+    if (path == nullptr || path[0] == '\0') return;
+    uint64_t interval = kDefaultDumpIntervalSecs;
+    const char* interval_env = std::getenv((env + "INTERVAL_SECS").c_str());
+    if (interval_env != nullptr &&
+        (!absl::SimpleAtoi(interval_env, &interval) || interval == 0)) {
+      interval = kDefaultDumpIntervalSecs;
+    }
+    std::thread(DumpLoop, this, std::string(path), interval).detach();
+  });
+}
+
+template <typename T>
+T* FilesystemMetrics::GetStats(std::map<Labels, T> FilesystemMetrics::*map,
+                               const char* first, const char* second) {
+  MaybeStartDumpThread();
+  Labels labels(first, second);
+  {
+    absl::ReaderMutexLock l(&mu_);
+    auto it = (this->*map).find(labels);
+    if (it != (this->*map).end()) return &it->second;
+  }
+  absl::MutexLock l(&mu_);
+  return &(this->*map)[labels];
+}
+
+void FilesystemMetrics::RecordRequest(const char* filesystem, const char* op,
+                                      TF_Code code, uint64_t micros,
+                                      uint64_t bytes) {
+  monitoring_->requests->GetCell(filesystem, op, CodeName(code))
+      ->IncrementBy(1);
+  monitoring_->latency->GetCell(filesystem, op)
+      ->Add(static_cast<double>(micros));
+  if (bytes > 0) {
+    monitoring_->bytes->GetCell(filesystem, op)->IncrementBy(bytes);
+  }
+
+  OpStats* stats = GetStats(&FilesystemMetrics::ops_, filesystem, op);
+  stats->requests.fetch_add(1, std::memory_order_relaxed);
+  if (code != TF_OK && code != TF_OUT_OF_RANGE) {
+    stats->errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  stats->bytes.fetch_add(bytes, std::memory_order_relaxed);
+  stats->latency_sum_micros.fetch_add(micros, std::memory_order_relaxed);
+  int bucket = 0;
+  while (bucket < kLatencyBuckets &&
+         micros > kLatencyScaleMicros * (1ULL << bucket)) {
+    ++bucket;
+  }
+  stats->latency_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void FilesystemMetrics::RecordRetry(const char* filesystem, const char* op) {
+  monitoring_->retries->GetCell(filesystem, op)->IncrementBy(1);
+  GetStats(&FilesystemMetrics::ops_, filesystem, op)
+      ->retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FilesystemMetrics::RecordCacheLookup(const char* filesystem,
+                                          const char* cache, bool hit) {
+  monitoring_->cache_lookups->GetCell(filesystem, cache, hit ? "hit" : "miss")
+      ->IncrementBy(1);
+  CacheStats* stats = GetStats(&FilesystemMetrics::caches_, filesystem, cache);
+  (hit ? stats->hits : stats->misses).fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string FilesystemMetrics::PrometheusText() {
+  absl::ReaderMutexLock l(&mu_);
+  const std::string name = absl::StrCat("tfio_", prefix_, "_");
+  std::string text;
+  auto counter = [&](const char* suffix, const char* help,
+                     std::atomic<uint64_t> OpStats::*field) {
+    absl::StrAppend(&text, "# HELP ", name, suffix, " ", help, "\n# TYPE ",
+                    name, suffix, " counter\n");
+    for (const auto& entry : ops_) {
+      absl::StrAppend(&text, name, suffix, "{filesystem=\"", entry.first.first,
+                      "\",op=\"", entry.first.second, "\"} ",
+                      (entry.second.*field).load(std::memory_order_relaxed),
+                      "\n");
+    }
+  };
+  counter("requests_total", "Requests.", &OpStats::requests);
+  counter("errors_total", "Failed requests.", &OpStats::errors);
+  counter("bytes_total", "Bytes read or written.", &OpStats::bytes);
+  counter("retries_total", "Retried requests.", &OpStats::retries);
+
+  const std::string histogram = name + "latency_seconds";
+  absl::StrAppend(&text, "# HELP ", histogram, " Request latency.\n# TYPE ",
+                  histogram, " histogram\n");
+  for (const auto& entry : ops_) {
+    const std::string labels = absl::StrCat(
+        "filesystem=\"", entry.first.first, "\",op=\"", entry.first.second,
+        "\"");
+    uint64_t cumulative = 0;
+    for (int bucket = 0; bucket <= kLatencyBuckets; ++bucket) {
+      cumulative += entry.second.latency_buckets[bucket].load(
+          std::memory_order_relaxed);
+      absl::StrAppend(&text, histogram, "_bucket{", labels, ",le=\"",
+                      LatencyBound(bucket), "\"} ", cumulative, "\n");
+    }
+    absl::StrAppend(
+        &text, histogram, "_sum{", labels, "} ",
+        entry.second.latency_sum_micros.load(std::memory_order_relaxed) / 1e6,
+        "\n", histogram, "_count{", labels, "} ", cumulative, "\n");
+  }
+
+  const std::string lookups = name + "cache_lookups_total";
+  absl::StrAppend(&text, "# HELP ", lookups, " Cache lookups.\n# TYPE ",
+                  lookups, " counter\n");
+  for (const auto& entry : caches_) {
+    for (bool hit : {true, false}) {
+      absl::StrAppend(
+          &text, lookups, "{filesystem=\"", entry.first.first, "\",cache=\"",
+          entry.first.second, "\",result=\"", hit ? "hit" : "miss", "\"} ",
+          (hit ? entry.second.hits : entry.second.misses)
+              .load(std::memory_order_relaxed),
+          "\n");
+    }
+  }
+  return text;
+}
+
+FilesystemRequest::FilesystemRequest(const char* filesystem, const char* op,
+                                     const TF_Status* status,
+                                     FilesystemMetrics* metrics)
+    : filesystem_(filesystem),
+      op_(op),
+      status_(status),
+      metrics_(metrics),
+      start_micros_(NowMicros()),
+      trace_(filesystem, IOTraceStage::kIOWait, op) {}
+
+FilesystemRequest::~FilesystemRequest() {
+  metrics_->RecordRequest(filesystem_, op_, TF_GetCode(status_),
+                          NowMicros() - start_micros_, bytes_);
+}
+
+int64_t FilesystemRequest::Bytes(int64_t bytes) {
+  if (bytes > 0) {
+    bytes_ += bytes;
+    trace_.AddBytes(bytes);
+  }
+  return bytes;
+}
+
+}  // namespace io
+}  // namespace tensorflow
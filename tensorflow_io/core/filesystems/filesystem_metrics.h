@@ -0,0 +1,167 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_FILESYSTEM_METRICS_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_FILESYSTEM_METRICS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
+
+namespace tensorflow {
+namespace io {
+
+constexpr int kFilesystemLatencyBuckets = 24;
+
+// I/O metrics of filesystem plugins, labeled by filesystem (e.g. "s3") and
+// operation ("read", "write", "sync", "stat", "list" or "copy"). For a
+// `prefix` of "filesystem" they are exported to TF monitoring as
+//
+//   /tensorflow/io/filesystem/requests{filesystem, op, status}
+//   /tensorflow/io/filesystem/bytes{filesystem, op}
+//   /tensorflow/io/filesystem/retries{filesystem, op}
+//   /tensorflow/io/filesystem/latency_usec{filesystem, op}  (histogram)
+//   /tensorflow/io/filesystem/cache_lookups{filesystem, cache, result}
+//
+// and, if TFIO_FILESYSTEM_METRICS_FILE is set, written to that file in the
+// Prometheus text format, as tfio_filesystem_* metrics, every
+// TFIO_FILESYSTEM_METRICS_INTERVAL_SECS seconds (10 by default), e.g. for the
+// textfile collector of the node exporter.
+//
+// TF monitoring names must be unique in a process, so libraries that may be
+// loaded together, such as the tensorflow-io and GCS filesystem plugins,
+// each keep their metrics under their own prefix.
+class FilesystemMetrics {
+ public:
+  // `plugins` completes the descriptions of the metrics, e.g. "the GCS
+  // filesystem plugin of tensorflow-io".
+  FilesystemMetrics(const std::string& prefix, const std::string& plugins);
+  ~FilesystemMetrics();
+
+  FilesystemMetrics(const FilesystemMetrics&) = delete;
+  FilesystemMetrics& operator=(const FilesystemMetrics&) = delete;
+
+  // The metrics of the filesystem plugins of tensorflow-io, under the
+  // "filesystem" prefix.
+  static FilesystemMetrics* Default();
+
+  // Records a request that took `micros` microseconds and transferred
+  // `bytes`. Latencies fall into buckets of up to 10us * 2^i, for i in
+  // [0, kFilesystemLatencyBuckets), and a last bucket past them. A short
+  // read at the end of a file, TF_OUT_OF_RANGE, is not counted as an error.
+  void RecordRequest(const char* filesystem, const char* op, TF_Code code,
+                     uint64_t micros, uint64_t bytes);
+
+  // Records a retry of an operation, e.g. after a throttled request.
+  void RecordRetry(const char* filesystem, const char* op);
+
+  // Records a lookup in a cache of a filesystem (e.g. "block" or "stat").
+  void RecordCacheLookup(const char* filesystem, const char* cache, bool hit);
+
+  // Returns all metrics recorded so far in the Prometheus text format.
+  std::string PrometheusText();
+
+ private:
+  struct Monitoring;
+
+  // The totals of an operation of a filesystem, kept for the Prometheus
+  // text. Entries are never removed, so that they can be updated without
+  // holding `mu_`.
+  struct OpStats {
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> retries{0};
+    std::atomic<uint64_t> latency_sum_micros{0};
+    // The last bucket counts the latencies past the last bound.
+    std::atomic<uint64_t> latency_buckets[kFilesystemLatencyBuckets + 1] = {};
+  };
+
+  struct CacheStats {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  typedef std::pair<std::string, std::string> Labels;
+
+  template <typename T>
+  T* GetStats(std::map<Labels, T> FilesystemMetrics::*map, const char* first,
+              const char* second);
+
+  // Starts rewriting the file named by TFIO_<PREFIX>_METRICS_FILE, once.
+  void MaybeStartDumpThread();
+
+  const std::string prefix_;
+  std::unique_ptr<Monitoring> monitoring_;
+  std::once_flag dump_once_;
+
+  absl::Mutex mu_;
+  std::map<Labels, OpStats> ops_ ABSL_GUARDED_BY(mu_);
+  std::map<Labels, CacheStats> caches_ ABSL_GUARDED_BY(mu_);
+};
+
+// Records one request in `metrics`, from its construction to its
+// destruction, with the status code of `status` at destruction. `filesystem`
+// and `op` must be string literals. Every request is also an IOTrace span
+// "tfio:<filesystem>:io_wait" of the TF profiler, tagged with its operation
+// and bytes.
+class FilesystemRequest {
+ public:
+  FilesystemRequest(const char* filesystem, const char* op,
+                    const TF_Status* status,
+                    FilesystemMetrics* metrics = FilesystemMetrics::Default());
+  ~FilesystemRequest();
+
+  FilesystemRequest(const FilesystemRequest&) = delete;
+  FilesystemRequest& operator=(const FilesystemRequest&) = delete;
+
+  // Records `bytes` transferred by the request if positive, and returns it,
+  // so that `return request.Bytes(Read(...));` records a read.
+  int64_t Bytes(int64_t bytes);
+
+ private:
+  const char* const filesystem_;
+  const char* const op_;
+  const TF_Status* const status_;
+  FilesystemMetrics* const metrics_;
+  const uint64_t start_micros_;
+  uint64_t bytes_ = 0;
+  IOTrace trace_;
+};
+
+// Records a retry of an operation in the default metrics.
+inline void RecordFilesystemRetry(const char* filesystem, const char* op) {
+  FilesystemMetrics::Default()->RecordRetry(filesystem, op);
+}
+
+// Records a cache lookup in the default metrics.
+inline void RecordCacheLookup(const char* filesystem, const char* cache,
+                              bool hit) {
+  FilesystemMetrics::Default()->RecordCacheLookup(filesystem, cache, hit);
+}
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_FILESYSTEM_METRICS_H_
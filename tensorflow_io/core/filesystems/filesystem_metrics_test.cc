@@ -0,0 +1,177 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// Expects `text` to hold `line` as a whole line.
+void ExpectLine(const std::string& text, const std::string& line) {
+  EXPECT_NE(std::string::npos, ("\n" + text).find("\n" + line + "\n"))
+      << "missing line: " << line << "\nin:\n"
+      << text;
+}
+
+TEST(FilesystemMetricsTest, COUNTERS) {
+  FilesystemMetrics metrics("counters_test", "the tests");
+  metrics.RecordRequest("s3", "read", TF_OK, 100, 4096);
+  // A short read at the end of a file is not an error.
+  metrics.RecordRequest("s3", "read", TF_OUT_OF_RANGE, 100, 10);
+  metrics.RecordRequest("s3", "read", TF_NOT_FOUND, 100, 0);
+  metrics.RecordRetry("s3", "read");
+  metrics.RecordRequest("az", "stat", TF_OK, 100, 0);
+
+  const std::string text = metrics.PrometheusText();
+  ExpectLine(text, "# TYPE tfio_counters_test_requests_total counter");
+  ExpectLine(text,
+             "tfio_counters_test_requests_total{filesystem=\"s3\","
+             "op=\"read\"} 3");
+  ExpectLine(text,
+             "tfio_counters_test_errors_total{filesystem=\"s3\","
+             "op=\"read\"} 1");
+  ExpectLine(text,
+             "tfio_counters_test_bytes_total{filesystem=\"s3\","
+             "op=\"read\"} 4106");
+  ExpectLine(text,
+             "tfio_counters_test_retries_total{filesystem=\"s3\","
+             "op=\"read\"} 1");
+  ExpectLine(text,
+             "tfio_counters_test_requests_total{filesystem=\"az\","
+             "op=\"stat\"} 1");
+  ExpectLine(text,
+             "tfio_counters_test_errors_total{filesystem=\"az\","
+             "op=\"stat\"} 0");
+}
+
+TEST(FilesystemMetricsTest, LATENCY_BUCKETS) {
+  FilesystemMetrics metrics("latency_test", "the tests");
+  // The bounds of the buckets are inclusive, and the last bucket holds the
+  // latencies past 10us * 2^23.
+  for (uint64_t micros : {0, 10, 11, 20, 150, 100000000}) {
+    metrics.RecordRequest("s3", "read", TF_OK, micros, 0);
+  }
+  const std::string text = metrics.PrometheusText();
+  const std::string bucket =
+      "tfio_latency_test_latency_seconds_bucket{filesystem=\"s3\","
+      "op=\"read\",le=";
+  ExpectLine(text, "# TYPE tfio_latency_test_latency_seconds histogram");
+  ExpectLine(text, bucket + "\"1e-05\"} 2");
+  ExpectLine(text, bucket + "\"2e-05\"} 4");
+  ExpectLine(text, bucket + "\"4e-05\"} 4");
+  ExpectLine(text, bucket + "\"0.00016\"} 5");
+  ExpectLine(text, bucket + "\"83.8861\"} 5");
+  ExpectLine(text, bucket + "\"+Inf\"} 6");
+  ExpectLine(text,
+             "tfio_latency_test_latency_seconds_count{filesystem=\"s3\","
+             "op=\"read\"} 6");
+  ExpectLine(text,
+             "tfio_latency_test_latency_seconds_sum{filesystem=\"s3\","
+             "op=\"read\"} 100");
+}
+
+TEST(FilesystemMetricsTest, CACHE_LOOKUPS) {
+  FilesystemMetrics metrics("cache_test", "the tests");
+  metrics.RecordCacheLookup("s3", "block", true);
+  metrics.RecordCacheLookup("s3", "block", true);
+  metrics.RecordCacheLookup("s3", "block", false);
+  metrics.RecordCacheLookup("s3", "stat", false);
+  const std::string text = metrics.PrometheusText();
+  const std::string lookups = "tfio_cache_test_cache_lookups_total";
+  ExpectLine(text, "# TYPE " + lookups + " counter");
+  ExpectLine(text, lookups +
+                       "{filesystem=\"s3\",cache=\"block\",result=\"hit\"} 2");
+  ExpectLine(text, lookups +
+                       "{filesystem=\"s3\",cache=\"block\",result=\"miss\"} 1");
+  ExpectLine(text, lookups +
+                       "{filesystem=\"s3\",cache=\"stat\",result=\"hit\"} 0");
+  ExpectLine(text, lookups +
+                       "{filesystem=\"s3\",cache=\"stat\",result=\"miss\"} 1");
+}
+
+TEST(FilesystemMetricsTest, FILESYSTEM_REQUEST) {
+  FilesystemMetrics metrics("request_test", "the tests");
+  TF_Status* status = TF_NewStatus();
+  TF_SetStatus(status, TF_OK, "");
+  {
+    FilesystemRequest request("s3", "write", status, &metrics);
+    EXPECT_EQ(-1, request.Bytes(-1));
+    EXPECT_EQ(7, request.Bytes(7));
+    EXPECT_EQ(5, request.Bytes(5));
+    // The status is read when the request ends.
+    TF_SetStatus(status, TF_UNAVAILABLE, "throttled");
+  }
+  TF_DeleteStatus(status);
+  const std::string text = metrics.PrometheusText();
+  ExpectLine(text,
+             "tfio_request_test_requests_total{filesystem=\"s3\","
+             "op=\"write\"} 1");
+  ExpectLine(text,
+             "tfio_request_test_errors_total{filesystem=\"s3\","
+             "op=\"write\"} 1");
+  ExpectLine(text,
+             "tfio_request_test_bytes_total{filesystem=\"s3\","
+             "op=\"write\"} 12");
+}
+
+TEST(FilesystemMetricsTest, DEFAULT_METRICS) {
+  RecordCacheLookup("default_test", "block", true);
+  RecordFilesystemRetry("default_test", "read");
+  const std::string text = FilesystemMetrics::Default()->PrometheusText();
+  ExpectLine(text,
+             "tfio_filesystem_cache_lookups_total{filesystem="
+             "\"default_test\",cache=\"block\",result=\"hit\"} 1");
+  ExpectLine(text,
+             "tfio_filesystem_retries_total{filesystem=\"default_test\","
+             "op=\"read\"} 1");
+}
+
+TEST(FilesystemMetricsTest, DUMP_FILE) {
+  const std::string path = ::testing::TempDir() + "/dump_test_metrics.prom";
+  remove(path.c_str());
+  setenv("TFIO_DUMP_TEST_METRICS_FILE", path.c_str(), 1);
+  setenv("TFIO_DUMP_TEST_METRICS_INTERVAL_SECS", "1", 1);
+  // The dump thread refers to the metrics until the process exits.
+  FilesystemMetrics* metrics = new FilesystemMetrics("dump_test", "the tests");
+  metrics->RecordRequest("s3", "read", TF_OK, 100, 1);
+
+  std::string text;
+  for (int i = 0; i < 50 && text.empty(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    text = contents.str();
+  }
+  EXPECT_EQ(metrics->PrometheusText(), text);
+  ExpectLine(text,
+             "tfio_dump_test_requests_total{filesystem=\"s3\","
+             "op=\"read\"} 1");
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -31,7 +31,7 @@ TFIO_PLUGIN_EXPORT void TF_InitPlugin(TF_FilesystemPluginInfo* info) {
   info->plugin_memory_free = tensorflow::io::plugin_memory_free;
   info->num_schemes = 7;
 #if !defined(_MSC_VER)
-  info->num_schemes = 8;
+  info->num_schemes = 16;
 #endif
   info->ops = static_cast<TF_FilesystemPluginOps*>(
       tensorflow::io::plugin_memory_allocate(info->num_schemes *
@@ -45,5 +45,24 @@ TFIO_PLUGIN_EXPORT void TF_InitPlugin(TF_FilesystemPluginInfo* info) {
   tensorflow::io::hdfs::ProvideFilesystemSupportFor(&info->ops[6], "har");
 #if !defined(_MSC_VER)
   tensorflow::io::oss::ProvideFilesystemSupportFor(&info->ops[7], "oss");
+
+  // Local disk caches in front of the schemes above, e.g. `cache+s3://`.
+  const struct {
+    const char* uri;
+    void (*provide)(TF_FilesystemPluginOps*, const char*);
+  } cached_schemes[] = {
+      {"cache+az", tensorflow::io::az::ProvideFilesystemSupportFor},
+      {"cache+http", tensorflow::io::http::ProvideFilesystemSupportFor},
+      {"cache+https", tensorflow::io::http::ProvideFilesystemSupportFor},
+      {"cache+s3", tensorflow::io::s3::ProvideFilesystemSupportFor},
+      {"cache+hdfs", tensorflow::io::hdfs::ProvideFilesystemSupportFor},
+      {"cache+viewfs", tensorflow::io::hdfs::ProvideFilesystemSupportFor},
+      {"cache+har", tensorflow::io::hdfs::ProvideFilesystemSupportFor},
+      {"cache+oss", tensorflow::io::oss::ProvideFilesystemSupportFor},
+  };
+  for (int i = 0; i < 8; ++i) {
+    tensorflow::io::cache::ProvideFilesystemSupportFor(
+        &info->ops[8 + i], cached_schemes[i].uri, cached_schemes[i].provide);
+  }
 #endif
 }
@@ -32,6 +32,16 @@ void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri);
 
 }  // namespace az
 
+namespace cache {
+
+// Registers `uri` (e.g. "cache+s3") as a local disk cache in front of the
+// filesystem that `provide` registers for the scheme after "cache+".
+void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri,
+                                 void (*provide)(TF_FilesystemPluginOps*,
+                                                 const char*));
+
+}  // namespace cache
+
 namespace hdfs {
 
 void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri);
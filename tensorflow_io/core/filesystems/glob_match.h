@@ -0,0 +1,100 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_GLOB_MATCH_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_GLOB_MATCH_H_
+
+#include <stddef.h>
+
+#include "absl/strings/string_view.h"
+
+namespace tensorflow {
+namespace io {
+
+// Glob matching of the file systems that expand `GetMatchingPaths` one path
+// component at a time, listing only the prefixes that can still match.
+
+// The characters that make a path component a glob, as in TensorFlow.
+inline constexpr char kGlobChars[] = "*?[\\";
+
+// Matches the character `c` against the single character pattern at
+// `pattern[*pos]` (`?`, a `[...]` class, an escaped or a literal character)
+// and advances `*pos` past it.
+inline bool MatchGlobChar(absl::string_view pattern, size_t* pos, char c) {
+  char p = pattern[*pos];
+  if (p == '?') {
+    ++*pos;
+    return true;
+  }
+  if (p == '\\' && *pos + 1 < pattern.size()) {
+    *pos += 2;
+    return pattern[*pos - 1] == c;
+  }
+  if (p == '[') {
+    size_t i = *pos + 1;
+    bool negate =
+        i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) ++i;
+    bool matched = false;
+    for (bool first = true; i < pattern.size() && (first || pattern[i] != ']');
+         first = false, ++i) {
+      char low = pattern[i], high = pattern[i];
+      if (i + 2 < pattern.size() && pattern[i + 1] == '-' &&
+          pattern[i + 2] != ']') {
+        high = pattern[i + 2];
+        i += 2;
+      }
+      if (low <= c && c <= high) matched = true;
+    }
+    if (i < pattern.size()) {
+      *pos = i + 1;
+      return matched != negate;
+    }
+    // An unterminated class is a literal `[`.
+  }
+  ++*pos;
+  return p == c;
+}
+
+// Matches a path component against a component of a glob, with the
+// `fnmatch(FNM_PATHNAME)` syntax of `GetMatchingPaths` in TensorFlow.
+inline bool MatchGlobComponent(absl::string_view pattern,
+                               absl::string_view name) {
+  size_t p = 0, n = 0;
+  size_t star = absl::string_view::npos, star_n = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      star = ++p;
+      star_n = n;
+      continue;
+    }
+    size_t next = p;
+    if (p < pattern.size() && MatchGlobChar(pattern, &next, name[n])) {
+      p = next;
+      ++n;
+      continue;
+    }
+    if (star == absl::string_view::npos) return false;
+    // Let the last `*` match one more character.
+    p = star;
+    n = ++star_n;
+  }
+  while (p < pattern.size() && pattern[p] == '*') ++p;
+  return p == pattern.size();
+}
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_GLOB_MATCH_H_
@@ -16,24 +16,30 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 #if defined(_MSC_VER)
 #include <Windows.h>
 #else
 #include <dlfcn.h>
 #endif
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "hdfs/hdfs.h"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
+#include "tensorflow_io/core/filesystems/parallel_read.h"
 
 namespace tensorflow {
 namespace io {
@@ -164,6 +170,7 @@ class LibHDFS {
   std::function<hdfsBuilder*()> hdfsNewBuilder;
   std::function<void(hdfsBuilder*, const char*)> hdfsBuilderSetNameNode;
   std::function<int(const char*, char**)> hdfsConfGetStr;
+  std::function<void(char*)> hdfsConfStrFree;
   std::function<int(hdfsFS, hdfsFile)> hdfsCloseFile;
   std::function<tSize(hdfsFS, hdfsFile, tOffset, void*, tSize)> hdfsPread;
   std::function<tSize(hdfsFS, hdfsFile, const void*, tSize)> hdfsWrite;
@@ -179,6 +186,19 @@ class LibHDFS {
   std::function<int(hdfsFS, const char*)> hdfsCreateDirectory;
   std::function<hdfsFileInfo*(hdfsFS, const char*)> hdfsGetPathInfo;
   std::function<int(hdfsFS, const char*, const char*)> hdfsRename;
+  std::function<int(hdfsFS, hdfsFile, tOffset)> hdfsSeek;
+
+  // The zero-copy read API, bound only if libhdfs provides it. Check
+  // `zero_copy_supported` before use.
+  bool zero_copy_supported = false;
+  std::function<hadoopRzOptions*()> hadoopRzOptionsAlloc;
+  std::function<int(hadoopRzOptions*, int)> hadoopRzOptionsSetSkipChecksum;
+  std::function<void(hadoopRzOptions*)> hadoopRzOptionsFree;
+  std::function<hadoopRzBuffer*(hdfsFile, hadoopRzOptions*, int32_t)>
+      hadoopReadZero;
+  std::function<int32_t(const hadoopRzBuffer*)> hadoopRzBufferLength;
+  std::function<const void*(const hadoopRzBuffer*)> hadoopRzBufferGet;
+  std::function<void(hdfsFile, hadoopRzBuffer*)> hadoopRzBufferFree;
 
  private:
   void LoadAndBind(TF_Status* status) {
@@ -197,6 +217,7 @@ class LibHDFS {
       BIND_HDFS_FUNC(hdfsNewBuilder);
       BIND_HDFS_FUNC(hdfsBuilderSetNameNode);
       BIND_HDFS_FUNC(hdfsConfGetStr);
+      BIND_HDFS_FUNC(hdfsConfStrFree);
       BIND_HDFS_FUNC(hdfsCloseFile);
       BIND_HDFS_FUNC(hdfsPread);
       BIND_HDFS_FUNC(hdfsWrite);
@@ -211,6 +232,27 @@ class LibHDFS {
       BIND_HDFS_FUNC(hdfsCreateDirectory);
       BIND_HDFS_FUNC(hdfsGetPathInfo);
       BIND_HDFS_FUNC(hdfsRename);
+      BIND_HDFS_FUNC(hdfsSeek);
+
+      // Older libhdfs builds lack the zero-copy read API, in which case
+      // reads always go through hdfsPread.
+      auto BindZeroCopy = [this](void** handle, TF_Status* status) {
+        BIND_HDFS_FUNC(hadoopRzOptionsAlloc);
+        BIND_HDFS_FUNC(hadoopRzOptionsSetSkipChecksum);
+        BIND_HDFS_FUNC(hadoopRzOptionsFree);
+        BIND_HDFS_FUNC(hadoopReadZero);
+        BIND_HDFS_FUNC(hadoopRzBufferLength);
+        BIND_HDFS_FUNC(hadoopRzBufferGet);
+        BIND_HDFS_FUNC(hadoopRzBufferFree);
+      };
+      TF_Status* zero_copy_status = TF_NewStatus();
+      BindZeroCopy(handle, zero_copy_status);
+      zero_copy_supported = TF_GetCode(zero_copy_status) == TF_OK;
+      if (!zero_copy_supported) {
+        TF_VLog(1, "HadoopFileSystem zero-copy reads unavailable: %s",
+                TF_Message(zero_copy_status));
+      }
+      TF_DeleteStatus(zero_copy_status);
 
 #undef BIND_HDFS_FUNC
     };
@@ -253,6 +295,25 @@ class LibHDFS {
   void* handle_;
 };
 
+// The number of handles a random access file opens at most, so that
+// concurrent reads at different offsets do not wait on each other. Overridden
+// by HDFS_READ_HANDLES.
+constexpr size_t kHDFSReadHandles = 4;
+
+// The buffer size passed to hdfsOpenFile for reading, overridden by
+// HDFS_READ_BUFFER_SIZE. Zero uses the libhdfs default.
+constexpr int kHDFSReadBufferSize = 0;
+
+// Reads of at least this many bytes use zero-copy reads when short-circuit
+// local reads are enabled, overridden by HDFS_ZERO_COPY_READ_MIN_SIZE. Zero
+// disables zero-copy reads.
+constexpr size_t kHDFSZeroCopyReadMinSize = 1 << 20;
+
+// Appends to a writable file are coalesced into writes of this many bytes,
+// so that small appends do not each cross JNI into the Java output stream.
+// Overridden by HDFS_WRITE_BUFFER_SIZE, zero writes every append through.
+constexpr size_t kHDFSWriteBufferSize = 8 << 20;
+
 // SECTION 1. Implementation for `TF_RandomAccessFile`
 // ----------------------------------------------------------------------------
 namespace tf_random_access_file {
@@ -261,17 +322,33 @@ typedef struct HDFSRandomAccessFile {
   std::string hdfs_path;
   hdfsFS fs;
   LibHDFS* libhdfs;
+  int buffer_size;
+  size_t max_handles;
+  // Zero if zero-copy reads are disabled.
+  size_t zero_copy_min_size;
+  bool zero_copy_skip_checksum;
   absl::Mutex mu;
-  hdfsFile handle ABSL_GUARDED_BY(mu);
+  absl::CondVar cv;
+  // The handles that are not used by any read, and the number of handles
+  // that are open.
+  std::vector<hdfsFile> handles ABSL_GUARDED_BY(mu);
+  size_t open_handles ABSL_GUARDED_BY(mu);
   bool disable_eof_retried;
   HDFSRandomAccessFile(std::string path, std::string hdfs_path, hdfsFS fs,
-                       LibHDFS* libhdfs, hdfsFile handle)
+                       LibHDFS* libhdfs, hdfsFile handle, int buffer_size,
+                       size_t max_handles, size_t zero_copy_min_size,
+                       bool zero_copy_skip_checksum)
       : path(std::move(path)),
         hdfs_path(std::move(hdfs_path)),
         fs(fs),
         libhdfs(libhdfs),
+        buffer_size(buffer_size),
+        max_handles((std::max)(max_handles, static_cast<size_t>(1))),
+        zero_copy_min_size(zero_copy_min_size),
+        zero_copy_skip_checksum(zero_copy_skip_checksum),
         mu(),
-        handle(handle) {
+        handles({handle}),
+        open_handles(1) {
     const char* disable_eof_retried_str =
         getenv("HDFS_DISABLE_READ_EOF_RETRIED");
     if (disable_eof_retried_str && disable_eof_retried_str[0] == '1') {
@@ -286,13 +363,90 @@ void Cleanup(TF_RandomAccessFile* file) {
   auto hdfs_file = static_cast<HDFSRandomAccessFile*>(file->plugin_file);
   {
     absl::MutexLock l(&hdfs_file->mu);
-    if (hdfs_file->handle != nullptr) {
-      hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, hdfs_file->handle);
+    for (auto handle : hdfs_file->handles) {
+      hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, handle);
     }
   }
   delete hdfs_file;
 }
 
+// Takes an unused handle, opening a new one if fewer than `max_handles` are
+// open, or waits for one. Returns nullptr if the file could not be opened.
+static hdfsFile AcquireHandle(HDFSRandomAccessFile* hdfs_file,
+                              TF_Status* status) {
+  {
+    absl::MutexLock l(&hdfs_file->mu);
+    while (hdfs_file->handles.empty() &&
+           hdfs_file->open_handles >= hdfs_file->max_handles) {
+      hdfs_file->cv.Wait(&hdfs_file->mu);
+    }
+    if (!hdfs_file->handles.empty()) {
+      hdfsFile handle = hdfs_file->handles.back();
+      hdfs_file->handles.pop_back();
+      return handle;
+    }
+    ++hdfs_file->open_handles;
+  }
+  hdfsFile handle = hdfs_file->libhdfs->hdfsOpenFile(
+      hdfs_file->fs, hdfs_file->hdfs_path.c_str(), O_RDONLY,
+      hdfs_file->buffer_size, 0, 0);
+  if (handle == nullptr) {
+    TF_SetStatusFromIOError(status, errno, hdfs_file->path.c_str());
+    absl::MutexLock l(&hdfs_file->mu);
+    --hdfs_file->open_handles;
+    hdfs_file->cv.Signal();
+  }
+  return handle;
+}
+
+// Returns `handle` for other reads, or accounts for a handle that has been
+// closed if it is nullptr.
+static void ReleaseHandle(HDFSRandomAccessFile* hdfs_file, hdfsFile handle) {
+  absl::MutexLock l(&hdfs_file->mu);
+  if (handle != nullptr) {
+    hdfs_file->handles.push_back(handle);
+  } else {
+    --hdfs_file->open_handles;
+  }
+  hdfs_file->cv.Signal();
+}
+
+// Reads up to `n` bytes at `offset` with zero-copy reads, which map the
+// block replicas of the local DataNode instead of copying them through JNI.
+// Returns the number of bytes read, stopping early at the end of the file or
+// when a zero-copy read is not possible, e.g. the replica is not local; the
+// caller reads the rest with hdfsPread.
+static int64_t ReadZeroCopy(HDFSRandomAccessFile* hdfs_file, hdfsFile handle,
+                            uint64_t offset, size_t n, char* buffer) {
+  auto libhdfs = hdfs_file->libhdfs;
+  if (libhdfs->hdfsSeek(hdfs_file->fs, handle,
+                        static_cast<tOffset>(offset)) != 0) {
+    return 0;
+  }
+  auto options = libhdfs->hadoopRzOptionsAlloc();
+  if (options == nullptr) return 0;
+  if (hdfs_file->zero_copy_skip_checksum) {
+    libhdfs->hadoopRzOptionsSetSkipChecksum(options, 1);
+  }
+  int64_t read = 0;
+  while (n > 0) {
+    int32_t read_n = static_cast<int32_t>(
+        (std::min)(n, static_cast<size_t>(std::numeric_limits<int>::max())));
+    auto rz_buffer = libhdfs->hadoopReadZero(handle, options, read_n);
+    if (rz_buffer == nullptr) break;
+    int32_t r = libhdfs->hadoopRzBufferLength(rz_buffer);
+    if (r > 0) {
+      memcpy(buffer + read, libhdfs->hadoopRzBufferGet(rz_buffer), r);
+      n -= r;
+      read += r;
+    }
+    libhdfs->hadoopRzBufferFree(handle, rz_buffer);
+    if (r <= 0) break;
+  }
+  libhdfs->hadoopRzOptionsFree(options);
+  return read;
+}
+
 int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
              char* buffer, TF_Status* status) {
   auto hdfs_file = static_cast<HDFSRandomAccessFile*>(file->plugin_file);
@@ -300,6 +454,7 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
   auto fs = hdfs_file->fs;
   auto hdfs_path = hdfs_file->hdfs_path.c_str();
   auto path = hdfs_file->path.c_str();
+  FilesystemRequest request("hdfs", "read", status);
 
   char* dst = buffer;
   bool eof_retried = false;
@@ -307,12 +462,18 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
     // eof_retried = true, avoid calling hdfsOpenFile in Read, Fixes #42597
     eof_retried = true;
   }
+  // Each read uses its own handle, so that concurrent reads of the file
+  // proceed in parallel.
+  auto handle = AcquireHandle(hdfs_file, status);
+  if (handle == nullptr) return -1;
   int64_t read = 0;
+  if (hdfs_file->zero_copy_min_size > 0 && n >= hdfs_file->zero_copy_min_size) {
+    read = ReadZeroCopy(hdfs_file, handle, offset, n, dst);
+    dst += read;
+    n -= read;
+    offset += read;
+  }
   while (TF_GetCode(status) == TF_OK && n > 0) {
-    // We lock inside the loop rather than outside so we don't block other
-    // concurrent readers.
-    absl::MutexLock l(&hdfs_file->mu);
-    auto handle = hdfs_file->handle;
     // Max read length is INT_MAX-2.
     // Actual max array size in java depends on JVM's implentation
     // So we choose INT_MAX-8, which is the maximum "safe" number.
@@ -332,17 +493,18 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
       // contents.
       //
       // Fixes #5438
-      if (handle != nullptr && libhdfs->hdfsCloseFile(fs, handle) != 0) {
+      if (libhdfs->hdfsCloseFile(fs, handle) != 0) {
         TF_SetStatusFromIOError(status, errno, path);
+        ReleaseHandle(hdfs_file, nullptr);
         return -1;
       }
-      hdfs_file->handle =
-          libhdfs->hdfsOpenFile(fs, hdfs_path, O_RDONLY, 0, 0, 0);
-      if (hdfs_file->handle == nullptr) {
+      handle = libhdfs->hdfsOpenFile(fs, hdfs_path, O_RDONLY,
+                                     hdfs_file->buffer_size, 0, 0);
+      if (handle == nullptr) {
         TF_SetStatusFromIOError(status, errno, path);
+        ReleaseHandle(hdfs_file, nullptr);
         return -1;
       }
-      handle = hdfs_file->handle;
       eof_retried = true;
     } else if (eof_retried && r == 0) {
       TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
@@ -352,7 +514,8 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
       TF_SetStatusFromIOError(status, errno, path);
     }
   }
-  return read;
+  ReleaseHandle(hdfs_file, handle);
+  return request.Bytes(read);
 }
 
 }  // namespace tf_random_access_file
@@ -365,25 +528,21 @@ typedef struct HDFSWritableFile {
   hdfsFS fs;
   LibHDFS* libhdfs;
   hdfsFile handle;
+  // The appended bytes that are not written to the handle yet, at most
+  // buffer_size of them.
+  size_t buffer_size;
+  std::string buffer;
   HDFSWritableFile(std::string hdfs_path, hdfsFS fs, LibHDFS* libhdfs,
-                   hdfsFile handle)
+                   hdfsFile handle, size_t buffer_size)
       : hdfs_path(std::move(hdfs_path)),
         fs(fs),
         libhdfs(libhdfs),
-        handle(handle) {}
+        handle(handle),
+        buffer_size(buffer_size) {}
 } HDFSWritableFile;
 
-void Cleanup(TF_WritableFile* file) {
-  auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
-  hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, hdfs_file->handle);
-  hdfs_file->fs = nullptr;
-  hdfs_file->handle = nullptr;
-  delete hdfs_file;
-}
-
-void Append(const TF_WritableFile* file, const char* buffer, size_t n,
-            TF_Status* status) {
-  auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
+static void Write(HDFSWritableFile* hdfs_file, const char* buffer, size_t n,
+                  TF_Status* status) {
   auto libhdfs = hdfs_file->libhdfs;
   auto fs = hdfs_file->fs;
   auto handle = hdfs_file->handle;
@@ -413,19 +572,64 @@ void Append(const TF_WritableFile* file, const char* buffer, size_t n,
   TF_SetStatus(status, TF_OK, "");
 }
 
+// Writes the buffered bytes to the handle.
+static void WriteBuffer(HDFSWritableFile* hdfs_file, TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+  if (hdfs_file->buffer.empty()) return;
+  Write(hdfs_file, hdfs_file->buffer.data(), hdfs_file->buffer.size(), status);
+  if (TF_GetCode(status) != TF_OK) return;
+  hdfs_file->buffer.clear();
+}
+
+void Cleanup(TF_WritableFile* file) {
+  auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
+  if (hdfs_file->handle != nullptr) {
+    // Files that are not closed keep what was appended, as unbuffered
+    // files do.
+    TF_Status* status = TF_NewStatus();
+    WriteBuffer(hdfs_file, status);
+    TF_DeleteStatus(status);
+    hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, hdfs_file->handle);
+  }
+  hdfs_file->fs = nullptr;
+  hdfs_file->handle = nullptr;
+  delete hdfs_file;
+}
+
+void Append(const TF_WritableFile* file, const char* buffer, size_t n,
+            TF_Status* status) {
+  auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("hdfs", "write", status);
+  request.Bytes(n);
+  if (hdfs_file->buffer.size() + n <= hdfs_file->buffer_size) {
+    hdfs_file->buffer.append(buffer, n);
+    return TF_SetStatus(status, TF_OK, "");
+  }
+  WriteBuffer(hdfs_file, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  // Appends that would fill most of the buffer go straight to the handle
+  if (n > hdfs_file->buffer_size / 2) {
+    return Write(hdfs_file, buffer, n, status);
+  }
+  hdfs_file->buffer.append(buffer, n);
+}
+
 int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
   auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
   int64_t position =
       hdfs_file->libhdfs->hdfsTell(hdfs_file->fs, hdfs_file->handle);
-  if (position == -1)
+  if (position == -1) {
     TF_SetStatusFromIOError(status, errno, hdfs_file->hdfs_path.c_str());
-  else
-    TF_SetStatus(status, TF_OK, "");
-  return position;
+    return position;
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return position + hdfs_file->buffer.size();
 }
 
 void Flush(const TF_WritableFile* file, TF_Status* status) {
   auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
+  WriteBuffer(hdfs_file, status);
+  if (TF_GetCode(status) != TF_OK) return;
   if (hdfs_file->libhdfs->hdfsHFlush(hdfs_file->fs, hdfs_file->handle) != 0)
     TF_SetStatusFromIOError(status, errno, hdfs_file->hdfs_path.c_str());
   else
@@ -434,6 +638,9 @@ void Flush(const TF_WritableFile* file, TF_Status* status) {
 
 void Sync(const TF_WritableFile* file, TF_Status* status) {
   auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("hdfs", "sync", status);
+  WriteBuffer(hdfs_file, status);
+  if (TF_GetCode(status) != TF_OK) return;
   if (hdfs_file->libhdfs->hdfsHSync(hdfs_file->fs, hdfs_file->handle) != 0)
     TF_SetStatusFromIOError(status, errno, hdfs_file->hdfs_path.c_str());
   else
@@ -442,8 +649,12 @@ void Sync(const TF_WritableFile* file, TF_Status* status) {
 
 void Close(const TF_WritableFile* file, TF_Status* status) {
   auto hdfs_file = static_cast<HDFSWritableFile*>(file->plugin_file);
-  TF_SetStatus(status, TF_OK, "");
-  if (hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, hdfs_file->handle) != 0)
+  FilesystemRequest request("hdfs", "sync", status);
+  WriteBuffer(hdfs_file, status);
+  // The handle is closed even if the buffer could not be written
+  if (hdfs_file->libhdfs->hdfsCloseFile(hdfs_file->fs, hdfs_file->handle) !=
+          0 &&
+      TF_GetCode(status) == TF_OK)
     TF_SetStatusFromIOError(status, errno, hdfs_file->hdfs_path.c_str());
   hdfs_file->fs = nullptr;
   hdfs_file->handle = nullptr;
@@ -454,11 +665,25 @@ void Close(const TF_WritableFile* file, TF_Status* status) {
 // SECTION 3. Implementation for `TF_ReadOnlyMemoryRegion`
 // ----------------------------------------------------------------------------
 namespace tf_read_only_memory_region {
-void Cleanup(TF_ReadOnlyMemoryRegion* region) {}
+typedef struct HDFSMemoryRegion {
+  std::unique_ptr<char[]> data;
+  uint64_t length;
+} HDFSMemoryRegion;
+
+void Cleanup(TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HDFSMemoryRegion*>(region->plugin_memory_region);
+  delete r;
+}
 
-const void* Data(const TF_ReadOnlyMemoryRegion* region) { return nullptr; }
+const void* Data(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HDFSMemoryRegion*>(region->plugin_memory_region);
+  return reinterpret_cast<const void*>(r->data.get());
+}
 
-uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
+uint64_t Length(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HDFSMemoryRegion*>(region->plugin_memory_region);
+  return r->length;
+}
 
 }  // namespace tf_read_only_memory_region
 
@@ -592,14 +817,74 @@ void NewRandomAccessFile(const TF_Filesystem* filesystem, const char* path,
   std::string scheme, namenode, hdfs_path;
   ParseHadoopPath(path, &scheme, &namenode, &hdfs_path);
 
-  auto handle = libhdfs->hdfsOpenFile(fs, hdfs_path.c_str(), O_RDONLY, 0, 0, 0);
+  int buffer_size = kHDFSReadBufferSize;
+  const char* buffer_size_str = getenv("HDFS_READ_BUFFER_SIZE");
+  if (buffer_size_str != nullptr) {
+    absl::SimpleAtoi(buffer_size_str, &buffer_size);
+  }
+  size_t max_handles = kHDFSReadHandles;
+  const char* max_handles_str = getenv("HDFS_READ_HANDLES");
+  if (max_handles_str != nullptr) {
+    absl::SimpleAtoi(max_handles_str, &max_handles);
+  }
+  // Zero-copy reads only avoid the JNI copy for short-circuit local reads,
+  // and without skipping checksums only for replicas cached by the DataNode.
+  size_t zero_copy_min_size = 0;
+  bool zero_copy_skip_checksum = false;
+  if (libhdfs->zero_copy_supported) {
+    auto GetConfBool = [libhdfs](const char* key) {
+      char* value = nullptr;
+      if (libhdfs->hdfsConfGetStr(key, &value) != 0 || value == nullptr) {
+        return false;
+      }
+      bool result = strcmp(value, "true") == 0;
+      libhdfs->hdfsConfStrFree(value);
+      return result;
+    };
+    if (GetConfBool("dfs.client.read.shortcircuit")) {
+      zero_copy_min_size = kHDFSZeroCopyReadMinSize;
+      const char* zero_copy_min_size_str =
+          getenv("HDFS_ZERO_COPY_READ_MIN_SIZE");
+      if (zero_copy_min_size_str != nullptr) {
+        absl::SimpleAtoi(zero_copy_min_size_str, &zero_copy_min_size);
+      }
+      zero_copy_skip_checksum =
+          GetConfBool("dfs.client.read.shortcircuit.skip.checksum");
+    }
+  }
+
+  auto handle = libhdfs->hdfsOpenFile(fs, hdfs_path.c_str(), O_RDONLY,
+                                      buffer_size, 0, 0);
   if (handle == nullptr) return TF_SetStatusFromIOError(status, errno, path);
 
   file->plugin_file = new tf_random_access_file::HDFSRandomAccessFile(
-      path, hdfs_path, fs, libhdfs, handle);
+      path, hdfs_path, fs, libhdfs, handle, buffer_size, max_handles,
+      zero_copy_min_size, zero_copy_skip_checksum);
   TF_SetStatus(status, TF_OK, "");
 }
 
+// The options of writable files, read from the environment:
+// HDFS_WRITE_BUFFER_SIZE for the buffer of the plugin, and
+// HDFS_WRITE_STREAM_BUFFER_SIZE, HDFS_WRITE_REPLICATION and
+// HDFS_WRITE_BLOCK_SIZE for the bufferSize, replication and blocksize passed
+// to hdfsOpenFile, where zero uses the configuration of the cluster.
+typedef struct HDFSWriteOptions {
+  size_t buffer_size = kHDFSWriteBufferSize;
+  int stream_buffer_size = 0;
+  int replication = 0;
+  int32_t block_size = 0;
+  HDFSWriteOptions() {
+    const char* value = getenv("HDFS_WRITE_BUFFER_SIZE");
+    if (value != nullptr) absl::SimpleAtoi(value, &buffer_size);
+    value = getenv("HDFS_WRITE_STREAM_BUFFER_SIZE");
+    if (value != nullptr) absl::SimpleAtoi(value, &stream_buffer_size);
+    value = getenv("HDFS_WRITE_REPLICATION");
+    if (value != nullptr) absl::SimpleAtoi(value, &replication);
+    value = getenv("HDFS_WRITE_BLOCK_SIZE");
+    if (value != nullptr) absl::SimpleAtoi(value, &block_size);
+  }
+} HDFSWriteOptions;
+
 void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
                      TF_WritableFile* file, TF_Status* status) {
   auto hadoop_file =
@@ -615,11 +900,14 @@ void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   std::string scheme, namenode, hdfs_path;
   ParseHadoopPath(path, &scheme, &namenode, &hdfs_path);
 
-  auto handle = libhdfs->hdfsOpenFile(fs, hdfs_path.c_str(), O_WRONLY, 0, 0, 0);
+  HDFSWriteOptions options;
+  auto handle = libhdfs->hdfsOpenFile(
+      fs, hdfs_path.c_str(), O_WRONLY, options.stream_buffer_size,
+      static_cast<short>(options.replication), options.block_size);
   if (handle == nullptr) return TF_SetStatusFromIOError(status, errno, path);
 
-  file->plugin_file =
-      new tf_writable_file::HDFSWritableFile(hdfs_path, fs, libhdfs, handle);
+  file->plugin_file = new tf_writable_file::HDFSWritableFile(
+      hdfs_path, fs, libhdfs, handle, options.buffer_size);
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -658,26 +946,53 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   // hdfsOpenFile is called.
   auto libHDFSMode = fileExists ? (O_WRONLY | O_APPEND) : O_WRONLY;
 
-  auto handle =
-      libhdfs->hdfsOpenFile(fs, hdfs_path.c_str(), libHDFSMode, 0, 0, 0);
+  // Replication and block size only apply to new files
+  HDFSWriteOptions options;
+  auto handle = libhdfs->hdfsOpenFile(
+      fs, hdfs_path.c_str(), libHDFSMode, options.stream_buffer_size,
+      static_cast<short>(options.replication), options.block_size);
   if (handle == nullptr) return TF_SetStatusFromIOError(status, errno, path);
-  file->plugin_file =
-      new tf_writable_file::HDFSWritableFile(hdfs_path, fs, libhdfs, handle);
+  file->plugin_file = new tf_writable_file::HDFSWritableFile(
+      hdfs_path, fs, libhdfs, handle, options.buffer_size);
   TF_SetStatus(status, TF_OK, "");
 }
 
+int64_t GetFileSize(const TF_Filesystem* filesystem, const char* path,
+                    TF_Status* status);
+
+// The file is read into memory rather than mapped: chunks of it are read
+// concurrently, one per pooled read handle of the file.
 void NewReadOnlyMemoryRegionFromFile(const TF_Filesystem* filesystem,
                                      const char* path,
                                      TF_ReadOnlyMemoryRegion* region,
                                      TF_Status* status) {
-  // hadoopReadZero() technically supports this call with the following
-  // caveats:
-  // - It only works up to 2 GB. We'd have to Stat() the file to ensure that
-  //   it fits.
-  // - If not on the local filesystem, the entire file will be read, making
-  //   it inefficient for callers that assume typical mmap() behavior.
-  TF_SetStatus(status, TF_UNIMPLEMENTED,
-               "HDFS does not support ReadOnlyMemoryRegion");
+  int64_t size = GetFileSize(filesystem, path, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  if (size == 0) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, "File is empty");
+    return;
+  }
+
+  TF_RandomAccessFile file;
+  NewRandomAccessFile(filesystem, path, &file, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  auto hdfs_file = static_cast<tf_random_access_file::HDFSRandomAccessFile*>(
+      file.plugin_file);
+
+  std::unique_ptr<char[]> data(new char[size]);
+  int64_t read = ParallelRead(
+      [&file](uint64_t offset, size_t n, char* buffer, TF_Status* s) {
+        return tf_random_access_file::Read(&file, offset, n, buffer, s);
+      },
+      0, size, data.get(), hdfs_file->max_handles, kMemoryRegionMinChunkSize,
+      status);
+  tf_random_access_file::Cleanup(&file);
+  if (TF_GetCode(status) != TF_OK) return;
+
+  region->plugin_memory_region =
+      new tf_read_only_memory_region::HDFSMemoryRegion(
+          {std::move(data), static_cast<uint64_t>(read)});
+  TF_SetStatus(status, TF_OK, "");
 }
 
 void PathExists(const TF_Filesystem* filesystem, const char* path,
@@ -704,6 +1019,7 @@ void PathExists(const TF_Filesystem* filesystem, const char* path,
 
 void Stat(const TF_Filesystem* filesystem, const char* path,
           TF_FileStatistics* stats, TF_Status* status) {
+  FilesystemRequest request("hdfs", "stat", status);
   auto hadoop_file =
       static_cast<HadoopFileSystem*>(filesystem->plugin_filesystem)
           ->Load(status);
@@ -872,6 +1188,7 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
 
 int GetChildren(const TF_Filesystem* filesystem, const char* path,
                 char*** entries, TF_Status* status) {
+  FilesystemRequest request("hdfs", "list", status);
   auto hadoop_file =
       static_cast<HadoopFileSystem*>(filesystem->plugin_filesystem)
           ->Load(status);
@@ -14,17 +14,25 @@ limitations under the License.
 ==============================================================================*/
 
 #include <curl/curl.h>
+#include <string.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
+#include "tensorflow_io/core/filesystems/parallel_read.h"
 
 namespace tensorflow {
 namespace io {
@@ -44,14 +52,106 @@ void CurlInitialize() {
   }
 }
 
+// The maximum number of idle curl handles kept for reuse.
+constexpr size_t kMaxIdleCurlHandles = 64;
+
+// Sequential reads smaller than this are served from a buffer of this size,
+// filled with a single ranged request. Overridden by HTTP_READ_AHEAD_SIZE,
+// zero disables read-ahead.
+constexpr size_t kReadAheadSize = 4 * 1024 * 1024;  // 4 MB
+// The statistics of a URL are cached for this many seconds, overridden by
+// HTTP_STAT_CACHE_MAX_AGE, zero disables the cache.
+constexpr uint64_t kStatCacheMaxAge = 5;
+constexpr size_t kStatCacheMaxEntries = 1024;
+
+template <typename T>
+T GetEnvOrDefault(const char* name, T default_value) {
+  const char* env = std::getenv(name);
+  T value;
+  if (env == nullptr || !absl::SimpleAtoi(env, &value)) return default_value;
+  return value;
+}
+
+// A pool of curl easy handles. The handles share their connection, TLS
+// session and DNS caches, so that requests to a host reuse its open
+// connections instead of paying a TCP and TLS handshake each.
+class CurlHandlePool {
+ public:
+  static CurlHandlePool* Default() {
+    static CurlHandlePool* pool = new CurlHandlePool();
+    return pool;
+  }
+
+  // Returns an idle handle, or a new one. Returns nullptr if curl could not
+  // create a handle.
+  CURL* Acquire() {
+    {
+      absl::MutexLock l(&mu_);
+      if (!idle_.empty()) {
+        CURL* curl = idle_.back();
+        idle_.pop_back();
+        return curl;
+      }
+    }
+    return curl_easy_init();
+  }
+
+  // Returns `curl` to the pool. Its options are reset, but its connections
+  // are kept open.
+  void Release(CURL* curl) {
+    curl_easy_reset(curl);
+    {
+      absl::MutexLock l(&mu_);
+      if (idle_.size() < kMaxIdleCurlHandles) {
+        idle_.push_back(curl);
+        return;
+      }
+    }
+    curl_easy_cleanup(curl);
+  }
+
+  CURLSH* share() const { return share_; }
+
+ private:
+  CurlHandlePool() {
+    CurlInitialize();
+    share_ = curl_share_init();
+    if (share_ == nullptr) return;
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlHandlePool::Lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlHandlePool::Unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  }
+
+  static void Lock(CURL* handle, curl_lock_data data,
+                   curl_lock_access access, void* userptr) {
+    static_cast<CurlHandlePool*>(userptr)->share_mu_[data].Lock();
+  }
+
+  static void Unlock(CURL* handle, curl_lock_data data, void* userptr) {
+    static_cast<CurlHandlePool*>(userptr)->share_mu_[data].Unlock();
+  }
+
+  CURLSH* share_ = nullptr;
+  absl::Mutex share_mu_[CURL_LOCK_DATA_LAST];
+
+  absl::Mutex mu_;
+  std::vector<CURL*> idle_ ABSL_GUARDED_BY(mu_);
+};
+
 class CurlHttpRequest {
  public:
   CurlHttpRequest() {}
-  ~CurlHttpRequest() {}
+  ~CurlHttpRequest() {
+    if (curl_ != nullptr) {
+      CurlHandlePool::Default()->Release(curl_);
+    }
+  }
 
   void Initialize(TF_Status* status) {
-    CurlInitialize();
-    curl_ = curl_easy_init();
+    curl_ = CurlHandlePool::Default()->Acquire();
     if (curl_ == nullptr) {
       TF_SetStatus(status, TF_INTERNAL, "Couldn't initialize a curl session.");
       return;
@@ -59,6 +159,16 @@ class CurlHttpRequest {
 
     CURLcode s = CURLE_OK;
 
+    CURLSH* share = CurlHandlePool::Default()->share();
+    if (share != nullptr) {
+      if ((s = curl_easy_setopt(curl_, CURLOPT_SHARE, share)) != CURLE_OK) {
+        std::string error_message =
+            absl::StrCat("Unable to set CURLOPT_SHARE: ", s);
+        TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+        return;
+      }
+    }
+
     const char* ca_bundle = std::getenv("CURL_CA_BUNDLE");
     if (ca_bundle != nullptr) {
       if ((s = curl_easy_setopt(curl_, CURLOPT_CAINFO, ca_bundle)) !=
@@ -97,11 +207,23 @@ class CurlHttpRequest {
       return;
     }
 
-    // TODO: Enable HTTP/2.
-    if ((s = curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
-                              CURL_HTTP_VERSION_1_1)) != CURLE_OK) {
+    // Negotiate HTTP/2 over TLS when both curl and the server support it.
+    const bool http2 =
+        curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2;
+    const long http_version =
+        http2 ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1;
+    if ((s = curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION, http_version)) !=
+        CURLE_OK) {
       std::string error_message = absl::StrCat(
-          "Unable to set CURLOPT_HTTP_VERSION (CURL_HTTP_VERSION_1_1): ", s);
+          "Unable to set CURLOPT_HTTP_VERSION (", http_version, "): ", s);
+      TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
+      return;
+    }
+
+    // Keep idle connections of the pool alive.
+    if ((s = curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L)) != CURLE_OK) {
+      std::string error_message =
+          absl::StrCat("Unable to set CURLOPT_TCP_KEEPALIVE: ", s);
       TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
       return;
     }
@@ -207,8 +329,9 @@ class CurlHttpRequest {
     return direct_response_.bytes_transferred_;
   }
 
+  // Header names are case insensitive.
   std::string GetResponseHeader(const std::string& name) {
-    const auto& header = response_headers_.find(name);
+    const auto& header = response_headers_.find(absl::AsciiStrToLower(name));
     return header != response_headers_.end() ? header->second : "";
   }
 
@@ -534,7 +657,7 @@ class CurlHttpRequest {
     absl::string_view header(reinterpret_cast<const char*>(ptr), size * nmemb);
     absl::string_view::size_type p = header.find(": ");
     if (p != absl::string_view::npos) {
-      std::string name(header.substr(0, p));
+      std::string name = absl::AsciiStrToLower(header.substr(0, p));
       std::string value(header.substr(p + 2, -1));
       absl::StripTrailingAsciiWhitespace(&value);
       that->response_headers_[name] = value;
@@ -543,9 +666,30 @@ class CurlHttpRequest {
   }
 };
 
+typedef ExpiringLRUCache<TF_FileStatistics> StatCache;
+
+// Returns the total size of the file from the `Content-Range` header of a
+// ranged response, e.g. "bytes 0-99/1234", or -1 if it is unknown.
+int64_t ParseContentRangeSize(const std::string& content_range) {
+  size_t slash = content_range.rfind('/');
+  int64_t size;
+  if (slash == std::string::npos ||
+      !absl::SimpleAtoi(content_range.substr(slash + 1), &size)) {
+    return -1;
+  }
+  return size;
+}
+
 class HTTPRandomAccessFile {
  public:
-  HTTPRandomAccessFile(const std::string& uri) : uri_(uri) {}
+  // `stat_cache` may be null, otherwise the size of the file learned from
+  // ranged responses is inserted to it, so that a later Stat or GetFileSize
+  // of the URL does not send a request of its own.
+  HTTPRandomAccessFile(const std::string& uri, size_t read_ahead_size,
+                       StatCache* stat_cache)
+      : uri_(uri),
+        read_ahead_size_(read_ahead_size),
+        stat_cache_(stat_cache) {}
   ~HTTPRandomAccessFile() {}
   int64_t Read(uint64_t offset, size_t n, char* buffer,
                TF_Status* status) const {
@@ -555,6 +699,23 @@ class HTTPRandomAccessFile {
       TF_SetStatus(status, TF_OK, "");
       return 0;
     }
+    size_t bytes_to_read = ReadWithReadAhead(offset, n, buffer, status);
+    if (TF_GetCode(status) != TF_OK) {
+      return 0;
+    }
+    if (bytes_to_read < n) {
+      TF_SetStatus(status, TF_OUT_OF_RANGE, "EOF reached");
+      return bytes_to_read;
+    }
+    TF_SetStatus(status, TF_OK, "");
+    return bytes_to_read;
+  }
+
+ private:
+  // Requests up to `n` bytes at `offset`. Returns the number of bytes
+  // received, which is less than `n` only at the end of the file.
+  size_t ReadRange(uint64_t offset, size_t n, char* buffer,
+                   TF_Status* status) const {
     CurlHttpRequest request;
     request.Initialize(status);
     if (TF_GetCode(status) != TF_OK) {
@@ -576,17 +737,75 @@ class HTTPRandomAccessFile {
     if (TF_GetCode(status) != TF_OK) {
       return 0;
     }
-    size_t bytes_to_read = request.GetResultBufferDirectBytesTransferred();
-    if (bytes_to_read < n) {
-      TF_SetStatus(status, TF_OUT_OF_RANGE, "EOF reached");
-      return bytes_to_read;
+    if (stat_cache_ != nullptr) {
+      int64_t size =
+          ParseContentRangeSize(request.GetResponseHeader("Content-Range"));
+      if (size >= 0) {
+        TF_FileStatistics stats;
+        stats.length = size;
+        stats.mtime_nsec = 0;
+        stats.is_directory = false;
+        stat_cache_->Insert(uri_, stats);
+      }
     }
-    TF_SetStatus(status, TF_OK, "");
-    return bytes_to_read;
+    return request.GetResultBufferDirectBytesTransferred();
+  }
+
+  // Serves reads that continue the previous read from a buffer of
+  // `read_ahead_size_` bytes, refilled when it runs out. Other reads, and
+  // reads at least as large as the buffer, are requested as is.
+  size_t ReadWithReadAhead(uint64_t offset, size_t n, char* buffer,
+                           TF_Status* status) const {
+    size_t copied = 0;
+    bool sequential;
+    {
+      absl::MutexLock l(&mu_);
+      sequential = offset == next_offset_;
+      next_offset_ = offset + n;
+      if (offset >= buffer_offset_ &&
+          offset < buffer_offset_ + buffer_.size()) {
+        copied = std::min<size_t>(n, buffer_offset_ + buffer_.size() - offset);
+        memcpy(buffer, &buffer_[offset - buffer_offset_], copied);
+      }
+      if (copied == n || (copied > 0 && buffer_eof_)) {
+        // The buffer holds the end of the file.
+        TF_SetStatus(status, TF_OK, "");
+        return copied;
+      }
+    }
+    offset += copied;
+    if (!sequential || n - copied >= read_ahead_size_) {
+      return copied + ReadRange(offset, n - copied, buffer + copied, status);
+    }
+    // The request is sent without holding the lock, so that concurrent
+    // reads of the file are not serialized on it.
+    std::vector<char> data(read_ahead_size_);
+    size_t received = ReadRange(offset, data.size(), data.data(), status);
+    if (TF_GetCode(status) != TF_OK) {
+      return 0;
+    }
+    data.resize(received);
+    size_t remaining = std::min<size_t>(n - copied, data.size());
+    memcpy(buffer + copied, data.data(), remaining);
+    absl::MutexLock l(&mu_);
+    buffer_eof_ = received < read_ahead_size_;
+    buffer_.swap(data);
+    buffer_offset_ = offset;
+    return copied + remaining;
   }
 
- private:
   std::string uri_;
+  const size_t read_ahead_size_;
+  StatCache* const stat_cache_;
+
+  mutable absl::Mutex mu_;
+  // The offset right after the last read.
+  mutable uint64_t next_offset_ ABSL_GUARDED_BY(mu_) = 0;
+  // The read-ahead buffer, holding the file contents at `buffer_offset_`,
+  // and whether it reaches the end of the file.
+  mutable std::vector<char> buffer_ ABSL_GUARDED_BY(mu_);
+  mutable uint64_t buffer_offset_ ABSL_GUARDED_BY(mu_) = 0;
+  mutable bool buffer_eof_ ABSL_GUARDED_BY(mu_) = false;
 };
 
 // SECTION 1. Implementation for `TF_RandomAccessFile`
@@ -601,7 +820,8 @@ static void Cleanup(TF_RandomAccessFile* file) {
 static int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
                     char* buffer, TF_Status* status) {
   auto http_file = static_cast<HTTPRandomAccessFile*>(file->plugin_file);
-  return http_file->Read(offset, n, buffer, status);
+  FilesystemRequest request("http", "read", status);
+  return request.Bytes(http_file->Read(offset, n, buffer, status));
 }
 
 }  // namespace tf_random_access_file
@@ -639,11 +859,25 @@ static void Close(const TF_WritableFile* file, TF_Status* status) {
 // SECTION 3. Implementation for `TF_ReadOnlyMemoryRegion`
 // ----------------------------------------------------------------------------
 namespace tf_read_only_memory_region {
-void Cleanup(TF_ReadOnlyMemoryRegion* region) {}
+typedef struct HTTPMemoryRegion {
+  std::unique_ptr<char[]> data;
+  uint64_t length;
+} HTTPMemoryRegion;
+
+void Cleanup(TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HTTPMemoryRegion*>(region->plugin_memory_region);
+  delete r;
+}
 
-const void* Data(const TF_ReadOnlyMemoryRegion* region) { return nullptr; }
+const void* Data(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HTTPMemoryRegion*>(region->plugin_memory_region);
+  return reinterpret_cast<const void*>(r->data.get());
+}
 
-uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
+uint64_t Length(const TF_ReadOnlyMemoryRegion* region) {
+  auto r = static_cast<HTTPMemoryRegion*>(region->plugin_memory_region);
+  return r->length;
+}
 
 }  // namespace tf_read_only_memory_region
 
@@ -651,16 +885,40 @@ uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
 // ----------------------------------------------------------------------------
 namespace tf_http_filesystem {
 
+// The state of the filesystem shared by its files.
+struct HTTPFileSystem {
+  // Cache of the statistics of URLs, learned from Stat and ranged reads.
+  std::unique_ptr<StatCache> stat_cache;
+};
+
 static void Init(TF_Filesystem* filesystem, TF_Status* status) {
+  auto http_fs = new HTTPFileSystem();
+  filesystem->plugin_filesystem = http_fs;
+  http_fs->stat_cache = std::make_unique<StatCache>(
+      GetEnvOrDefault("HTTP_STAT_CACHE_MAX_AGE", kStatCacheMaxAge),
+      GetEnvOrDefault("HTTP_STAT_CACHE_MAX_ENTRIES", kStatCacheMaxEntries));
+  http_fs->stat_cache->SetLookupObserver(
+      [](bool hit) { RecordCacheLookup("http", "stat", hit); });
   TF_SetStatus(status, TF_OK, "");
 }
 
-static void Cleanup(TF_Filesystem* filesystem) {}
+static void Cleanup(TF_Filesystem* filesystem) {
+  auto http_fs = static_cast<HTTPFileSystem*>(filesystem->plugin_filesystem);
+  delete http_fs;
+}
+
+static StatCache* GetStatCache(const TF_Filesystem* filesystem) {
+  return static_cast<HTTPFileSystem*>(filesystem->plugin_filesystem)
+      ->stat_cache.get();
+}
 
 static void NewRandomAccessFile(const TF_Filesystem* filesystem,
                                 const char* path, TF_RandomAccessFile* file,
                                 TF_Status* status) {
-  file->plugin_file = new HTTPRandomAccessFile(path);
+  size_t read_ahead_size =
+      GetEnvOrDefault("HTTP_READ_AHEAD_SIZE", kReadAheadSize);
+  file->plugin_file = new HTTPRandomAccessFile(path, read_ahead_size,
+                                               GetStatCache(filesystem));
 
   TF_SetStatus(status, TF_OK, "");
 }
@@ -675,12 +933,36 @@ static void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_UNIMPLEMENTED, "NewAppendableFile not implemented");
 }
 
+static int64_t GetFileSize(const TF_Filesystem* filesystem, const char* path,
+                           TF_Status* status);
+
+// Reads the whole file in chunks requested concurrently, each with its own
+// range request, into a single buffer.
 static void NewReadOnlyMemoryRegionFromFile(const TF_Filesystem* filesystem,
                                             const char* path,
                                             TF_ReadOnlyMemoryRegion* region,
                                             TF_Status* status) {
-  TF_SetStatus(status, TF_UNIMPLEMENTED,
-               "NewReadOnlyMemoryRegionFromFile not implemented");
+  uint64_t size = GetFileSize(filesystem, path, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  if (size == 0) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, "File is empty");
+    return;
+  }
+  std::unique_ptr<char[]> data(new char[size]);
+  // Without read-ahead every chunk is sent as its own range request.
+  HTTPRandomAccessFile file(path, 0, GetStatCache(filesystem));
+  int64_t read = ParallelRead(
+      [&file](uint64_t offset, size_t n, char* buffer, TF_Status* s) {
+        return file.Read(offset, n, buffer, s);
+      },
+      0, size, data.get(), kMemoryRegionReadThreads, kMemoryRegionMinChunkSize,
+      status);
+  if (TF_GetCode(status) != TF_OK) return;
+
+  region->plugin_memory_region =
+      new tf_read_only_memory_region::HTTPMemoryRegion(
+          {std::move(data), static_cast<uint64_t>(read)});
+  TF_SetStatus(status, TF_OK, "");
 }
 
 static void CreateDir(const TF_Filesystem* filesystem, const char* path,
@@ -720,8 +1002,8 @@ static void CopyFile(const TF_Filesystem* filesystem, const char* src,
   TF_SetStatus(status, TF_UNIMPLEMENTED, "CopyFile not implemented");
 }
 
-static void Stat(const TF_Filesystem* filesystem, const char* path,
-                 TF_FileStatistics* stats, TF_Status* status) {
+static void StatHTTP(const std::string& path, TF_FileStatistics* stats,
+                     TF_Status* status) {
   CurlHttpRequest request;
   request.Initialize(status);
   if (TF_GetCode(status) != TF_OK) {
@@ -763,6 +1045,12 @@ static void Stat(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
+static void Stat(const TF_Filesystem* filesystem, const char* path,
+                 TF_FileStatistics* stats, TF_Status* status) {
+  FilesystemRequest metrics("http", "stat", status);
+  GetStatCache(filesystem)->LookupOrCompute(path, stats, StatHTTP, status);
+}
+
 static void PathExists(const TF_Filesystem* filesystem, const char* path,
                        TF_Status* status) {
   TF_FileStatistics stats;
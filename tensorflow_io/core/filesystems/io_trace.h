@@ -0,0 +1,100 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_IO_TRACE_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_IO_TRACE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/profiler/lib/traceme_encode.h"
+
+namespace tensorflow {
+namespace io {
+
+// Stages of the hot path of a kernel or file system of tensorflow-io, so
+// that input pipeline stalls are attributed the same way across formats.
+enum class IOTraceStage {
+  // Waiting for data from a file system, a server or a broker.
+  kIOWait,
+  // Decompressing blocks, pages or chunks.
+  kDecompress,
+  // Decoding a format to values, e.g. Avro records or audio frames.
+  kDecode,
+  // Converting or copying values to output tensors.
+  kFill,
+};
+
+inline const char* IOTraceStageName(IOTraceStage stage) {
+  switch (stage) {
+    case IOTraceStage::kIOWait:
+      return "io_wait";
+    case IOTraceStage::kDecompress:
+      return "decompress";
+    case IOTraceStage::kDecode:
+      return "decode";
+    case IOTraceStage::kFill:
+      return "fill";
+  }
+  return "unknown";
+}
+
+// A span of the TF profiler trace viewer from construction to destruction,
+// named "tfio:<component>:<stage>", e.g. "tfio:parquet:decode" or
+// "tfio:s3:io_wait", and tagged with the bytes and records it processed and
+// with an operation if set. `component` and `operation` must be string
+// literals.
+//
+// While tracing is disabled a span costs one relaxed atomic load: its name
+// is only made and its tags only encoded while the profiler is recording.
+class IOTrace {
+ public:
+  IOTrace(const char* component, IOTraceStage stage,
+          const char* operation = nullptr)
+      : operation_(operation), trace_([component, stage] {
+          return absl::StrCat("tfio:", component, ":",
+                              IOTraceStageName(stage));
+        }) {}
+
+  ~IOTrace() {
+    trace_.AppendMetadata([this] {
+      if (operation_ != nullptr) {
+        return profiler::TraceMeEncode(
+            {{"op", operation_}, {"bytes", bytes_}, {"records", records_}});
+      }
+      return profiler::TraceMeEncode(
+          {{"bytes", bytes_}, {"records", records_}});
+    });
+  }
+
+  IOTrace(const IOTrace&) = delete;
+  IOTrace& operator=(const IOTrace&) = delete;
+
+  void AddBytes(int64_t bytes) { bytes_ += bytes; }
+  void AddRecords(int64_t records) { records_ += records; }
+
+ private:
+  const char* const operation_;
+  int64_t bytes_ = 0;
+  int64_t records_ = 0;
+  profiler::TraceMe trace_;
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_IO_TRACE_H_
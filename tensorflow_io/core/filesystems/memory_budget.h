@@ -0,0 +1,196 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_MEMORY_BUDGET_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_MEMORY_BUDGET_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/numbers.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#if defined(_MSC_VER)
+#define TFIO_MEMORY_BUDGET_EXPORT
+#else
+#define TFIO_MEMORY_BUDGET_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace tensorflow {
+namespace io {
+
+// Process-wide memory budget of the readers, prefetchers and caches of
+// tensorflow-io, so that several datasets and file systems running in one
+// process share one limit instead of each sizing its memory independently.
+// Components account the bytes they buffer with Reserve and Release, under
+// a component name (e.g. "atds" or "s3"), and:
+//
+//   - prefetchers pause while Exhausted(), once they hold some memory, or
+//     block in WaitForMemory before reading ahead, so that they resume when
+//     memory is released instead of growing without bound,
+//   - caches TryReserve their blocks and evict instead of growing when it
+//     fails.
+//
+// The limit is TFIO_MEMORY_BUDGET_MB megabytes. If it is unset or 0 memory
+// is only accounted, so that Usage() still reports the memory held by each
+// component. WaitForMemory waits at most TFIO_MEMORY_BUDGET_WAIT_MS
+// milliseconds (10000 by default) and then lets the caller overcommit, so a
+// pipeline that waits for memory it holds itself slows down rather than
+// deadlocks.
+//
+// Global() is an inline function with default visibility, so that its
+// budget is unique in the process (STB_GNU_UNIQUE on Linux) although every
+// shared library of tensorflow-io includes this header.
+class MemoryBudget {
+ public:
+  // Bytes currently and at most held by a component.
+  struct Usage {
+    int64_t bytes = 0;
+    int64_t peak_bytes = 0;
+  };
+
+  TFIO_MEMORY_BUDGET_EXPORT static MemoryBudget* Global();
+
+  MemoryBudget(int64_t limit_bytes, absl::Duration max_wait)
+      : limit_bytes_(limit_bytes), max_wait_(max_wait) {}
+
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  // Limit in bytes, 0 if unlimited.
+  int64_t limit_bytes() const { return limit_bytes_; }
+
+  // Accounts `bytes` held by `component`, even beyond the limit.
+  void Reserve(const std::string& component, int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mu_) {
+    if (bytes <= 0) {
+      return;
+    }
+    absl::MutexLock l(&mu_);
+    ReserveLocked(component, bytes);
+  }
+
+  // Accounts `bytes` held by `component` if they fit in the limit, and
+  // returns whether they did.
+  bool TryReserve(const std::string& component, int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mu_) {
+    if (bytes <= 0) {
+      return true;
+    }
+    absl::MutexLock l(&mu_);
+    if (!FitsLocked(bytes)) {
+      return false;
+    }
+    ReserveLocked(component, bytes);
+    return true;
+  }
+
+  // Waits until `bytes` fit in the limit, or at most the maximum wait, then
+  // accounts them. Returns false if they were accounted beyond the limit.
+  bool WaitForMemory(const std::string& component, int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mu_) {
+    if (bytes <= 0) {
+      return true;
+    }
+    absl::MutexLock l(&mu_);
+    const absl::Time deadline = absl::Now() + max_wait_;
+    // An allocation larger than the limit proceeds once it is alone.
+    while (!FitsLocked(bytes) && used_bytes_ > 0) {
+      if (released_.WaitWithDeadline(&mu_, deadline)) {
+        break;
+      }
+    }
+    const bool fits = FitsLocked(bytes) || used_bytes_ == 0;
+    ReserveLocked(component, bytes);
+    return fits;
+  }
+
+  // Releases `bytes` previously accounted to `component`.
+  void Release(const std::string& component, int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mu_) {
+    if (bytes <= 0) {
+      return;
+    }
+    absl::MutexLock l(&mu_);
+    Usage& usage = usage_[component];
+    bytes = std::min(bytes, usage.bytes);
+    usage.bytes -= bytes;
+    used_bytes_ -= bytes;
+    released_.SignalAll();
+  }
+
+  // Whether the memory held by all components reached the limit.
+  bool Exhausted() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(&mu_);
+    return limit_bytes_ > 0 && used_bytes_ >= limit_bytes_;
+  }
+
+  int64_t used_bytes() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(&mu_);
+    return used_bytes_;
+  }
+
+  // Memory held by each component that reserved any.
+  std::map<std::string, Usage> usage() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(&mu_);
+    return usage_;
+  }
+
+ private:
+  static int64_t ReadEnv(const char* name, int64_t default_value) {
+    const char* value = getenv(name);
+    int64_t parsed;
+    if (value == nullptr || !absl::SimpleAtoi(value, &parsed) || parsed < 0) {
+      return default_value;
+    }
+    return parsed;
+  }
+
+  bool FitsLocked(int64_t bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return limit_bytes_ <= 0 || used_bytes_ + bytes <= limit_bytes_;
+  }
+
+  void ReserveLocked(const std::string& component, int64_t bytes)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Usage& usage = usage_[component];
+    usage.bytes += bytes;
+    usage.peak_bytes = std::max(usage.peak_bytes, usage.bytes);
+    used_bytes_ += bytes;
+  }
+
+  const int64_t limit_bytes_;
+  const absl::Duration max_wait_;
+  absl::Mutex mu_;
+  absl::CondVar released_;
+  int64_t used_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  std::map<std::string, Usage> usage_ ABSL_GUARDED_BY(mu_);
+};
+
+inline MemoryBudget* MemoryBudget::Global() {
+  static MemoryBudget* budget = new MemoryBudget(
+      ReadEnv("TFIO_MEMORY_BUDGET_MB", 0) << 20,
+      absl::Milliseconds(ReadEnv("TFIO_MEMORY_BUDGET_WAIT_MS", 10000)));
+  return budget;
+}
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_MEMORY_BUDGET_H_
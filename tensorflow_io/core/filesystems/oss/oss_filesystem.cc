@@ -19,6 +19,9 @@ limitations under the License.
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "aos_string.h"
@@ -31,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/platform/file_system_helper.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
 
 namespace tensorflow {
@@ -123,19 +127,71 @@ class OSSConnection {
   oss_request_options_t* _options = NULL;
 };
 
+/// Reads the bytes [offset, offset + n) of an OSS object into `buffer`, and
+/// sets `bytes_read` to the number of bytes received.
+Status ReadRangeFromOSS(const std::string& host, const std::string& access_id,
+                        const std::string& access_key,
+                        const std::string& bucket, const std::string& object,
+                        uint64 offset, size_t n, char* buffer,
+                        size_t* bytes_read) {
+  OSSConnection conn(host, access_id, access_key);
+  aos_pool_t* _pool = conn.getPool();
+  oss_request_options_t* _options = conn.getRequestOptions();
+  aos_string_t bucket_;
+  aos_string_t object_;
+  aos_table_t* headers_;
+  aos_list_t tmp_buffer;
+  aos_table_t* resp_headers;
+
+  aos_list_init(&tmp_buffer);
+  aos_str_set(&bucket_, bucket.c_str());
+  aos_str_set(&object_, object.c_str());
+  headers_ = aos_table_make(_pool, 1);
+
+  std::string range("bytes=");
+  range.append(std::to_string(offset))
+      .append("-")
+      .append(std::to_string(offset + n - 1));
+  apr_table_set(headers_, "Range", range.c_str());
+  VLOG(1) << "read from OSS with " << range.c_str();
+
+  aos_status_t* s =
+      oss_get_object_to_buffer(_options, &bucket_, &object_, headers_, NULL,
+                               &tmp_buffer, &resp_headers);
+  if (!aos_status_is_ok(s)) {
+    string msg;
+    oss_error_message(s, &msg);
+    VLOG(0) << "read " << object << " failed, errMsg: " << msg;
+    return errors::Internal("read failed: ", object, " errMsg: ", msg);
+  }
+
+  // copy data to local buffer
+  aos_buf_t* content = NULL;
+  size_t pos = 0;
+  aos_list_for_each_entry(aos_buf_t, content, &tmp_buffer, node) {
+    size_t size = std::min<size_t>(aos_buf_size(content), n - pos);
+    memcpy(buffer + pos, content->pos, size);
+    pos += size;
+  }
+  *bytes_read = pos;
+  return OkStatus();
+}
+
 class OSSRandomAccessFile : public RandomAccessFile {
  public:
   OSSRandomAccessFile(const std::string& endPoint, const std::string& accessKey,
                       const std::string& accessKeySecret,
                       const std::string& bucket, const std::string& object,
-                      size_t read_ahead_bytes, size_t file_length)
+                      size_t read_ahead_bytes, size_t max_windows,
+                      size_t file_length)
       : shost(endPoint),
         sak(accessKey),
         ssk(accessKeySecret),
         sbucket(bucket),
         sobject(object),
-        total_file_length_(file_length) {
-    read_ahead_bytes_ = std::min(read_ahead_bytes, file_length);
+        total_file_length_(file_length),
+        max_windows_(std::max<size_t>(max_windows, 1)) {
+    read_ahead_bytes_ = std::max<size_t>(read_ahead_bytes, 1);
   }
 
   Status Read(uint64 offset, size_t n, StringPiece* result,
@@ -148,116 +204,156 @@ class OSSRandomAccessFile : public RandomAccessFile {
                                 total_file_length_);
     }
 
+    const size_t requested = n;
     if (offset + n > total_file_length_) {
       n = total_file_length_ - offset;
     }
 
     VLOG(1) << "read " << sobject << " from " << offset << " to " << offset + n;
 
-    mutex_lock lock(mu_);
-    const bool range_start_included = offset >= buffer_start_offset_;
-    const bool range_end_included =
-        offset + n <= buffer_start_offset_ + buffer_size_;
-    if (range_start_included && range_end_included) {
-      // The requested range can be filled from the buffer.
-      const size_t offset_in_buffer =
-          std::min<uint64>(offset - buffer_start_offset_, buffer_size_);
-      const auto copy_size = std::min(n, buffer_size_ - offset_in_buffer);
-      VLOG(1) << "read from buffer " << offset_in_buffer << " to "
-              << offset_in_buffer + copy_size << " total " << buffer_size_;
-      std::copy(buffer_.begin() + offset_in_buffer,
-                buffer_.begin() + offset_in_buffer + copy_size, scratch);
-      *result = StringPiece(scratch, copy_size);
+    if (n >= read_ahead_bytes_ * max_windows_) {
+      // Reads larger than the whole window cache bypass it.
+      size_t bytes_read = 0;
+      TF_RETURN_IF_ERROR(ReadRangeFromOSS(shost, sak, ssk, sbucket, sobject,
+                                          offset, n, scratch, &bytes_read));
+      *result = StringPiece(scratch, bytes_read);
     } else {
-      // Update the buffer content based on the new requested range.
-      const size_t desired_buffer_size =
-          std::min(n + read_ahead_bytes_, total_file_length_);
-      if (n > buffer_.capacity() ||
-          desired_buffer_size > 2 * buffer_.capacity()) {
-        // Re-allocate only if buffer capacity increased significantly.
-        VLOG(1) << "reserve buffer to " << desired_buffer_size;
-        buffer_.reserve(desired_buffer_size);
+      size_t copied = 0;
+      const uint64 first = offset / read_ahead_bytes_;
+      const uint64 last = (offset + n - 1) / read_ahead_bytes_;
+      bool sequential;
+      {
+        mutex_lock lock(mu_);
+        sequential = first == last_window_ || first == last_window_ + 1;
+        last_window_ = last;
       }
-
-      buffer_start_offset_ = offset;
-      VLOG(1) << "load buffer" << buffer_start_offset_;
-      TF_RETURN_IF_ERROR(LoadBufferFromOSS(desired_buffer_size));
-
-      // Set the results.
-      memcpy(scratch, buffer_.data(), std::min(buffer_size_, n));
-      *result = StringPiece(scratch, std::min(buffer_size_, n));
+      for (uint64 index = first; index <= last; ++index) {
+        std::shared_ptr<Window> window;
+        TF_RETURN_IF_ERROR(GetWindow(index, &window));
+        const uint64 window_start = index * read_ahead_bytes_;
+        const uint64 start = std::max<uint64>(offset, window_start);
+        const uint64 end =
+            std::min<uint64>(offset + n, window_start + window->data.size());
+        if (start >= end) break;
+        memcpy(scratch + copied, window->data.data() + (start - window_start),
+               end - start);
+        copied += end - start;
+        if (end < window_start + read_ahead_bytes_) break;
+      }
+      *result = StringPiece(scratch, copied);
+      if (sequential) Prefetch(last + 1);
     }
 
-    if (result->size() < n) {
+    if (result->size() < requested) {
       // This is not an error per se. The RandomAccessFile interface expects
       // that Read returns OutOfRange if fewer bytes were read than requested.
       return errors::OutOfRange("EOF reached, ", result->size(),
-                                " bytes were read out of ", n,
+                                " bytes were read out of ", requested,
                                 " bytes requested.");
     }
     return OkStatus();
   }
 
  private:
-  /// A helper function to actually read the data from OSS. This function loads
-  /// buffer_ from OSS based on its current capacity.
-  Status LoadBufferFromOSS(size_t desired_buffer_size) const
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    size_t range_start = buffer_start_offset_;
-    size_t range_end = buffer_start_offset_ + std::min(buffer_.capacity() - 1,
-                                                       desired_buffer_size - 1);
-    range_end = std::min(range_end, total_file_length_ - 1);
-
-    OSSConnection conn(shost, sak, ssk);
-    aos_pool_t* _pool = conn.getPool();
-    oss_request_options_t* _options = conn.getRequestOptions();
-    aos_string_t bucket_;
-    aos_string_t object_;
-    aos_table_t* headers_;
-    aos_list_t tmp_buffer;
-    aos_table_t* resp_headers;
-
-    aos_list_init(&tmp_buffer);
-    aos_str_set(&_options->config->endpoint, shost.c_str());
-    aos_str_set(&_options->config->access_key_id, sak.c_str());
-    aos_str_set(&_options->config->access_key_secret, ssk.c_str());
-    _options->config->is_cname = 0;
-    _options->ctl = aos_http_controller_create(_options->pool, 0);
-    aos_str_set(&bucket_, sbucket.c_str());
-    aos_str_set(&object_, sobject.c_str());
-    headers_ = aos_table_make(_pool, 1);
-
-    std::string range("bytes=");
-    range.append(std::to_string(range_start))
-        .append("-")
-        .append(std::to_string(range_end));
-    apr_table_set(headers_, "Range", range.c_str());
-    VLOG(1) << "read from OSS with " << range.c_str();
-
-    aos_status_t* s =
-        oss_get_object_to_buffer(_options, &bucket_, &object_, headers_, NULL,
-                                 &tmp_buffer, &resp_headers);
-    if (aos_status_is_ok(s)) {
-      aos_buf_t* content = NULL;
-      int64_t size = 0;
-      int64_t pos = 0;
-      buffer_.clear();
-      buffer_size_ = 0;
-
-      // copy data to local buffer
-      aos_list_for_each_entry(aos_buf_t, content, &tmp_buffer, node) {
-        size = aos_buf_size(content);
-        std::copy(content->pos, content->pos + size, buffer_.begin() + pos);
-        pos += size;
+  /// A window of `read_ahead_bytes_` bytes of the file, aligned to its size.
+  /// `data` is written only by the fetch of the window, before `done` is set.
+  struct Window {
+    mutex mu;
+    condition_variable cv;
+    bool done TF_GUARDED_BY(mu) = false;
+    Status status TF_GUARDED_BY(mu);
+    std::vector<char> data;
+  };
+
+  /// Fetches `size` bytes of the file at `offset` into `window`.
+  static void FetchWindow(const std::string& host,
+                          const std::string& access_id,
+                          const std::string& access_key,
+                          const std::string& bucket, const std::string& object,
+                          uint64 offset, size_t size,
+                          const std::shared_ptr<Window>& window) {
+    window->data.resize(size);
+    size_t bytes_read = 0;
+    Status status = ReadRangeFromOSS(host, access_id, access_key, bucket,
+                                     object, offset, size, window->data.data(),
+                                     &bytes_read);
+    window->data.resize(status.ok() ? bytes_read : 0);
+    mutex_lock lock(window->mu);
+    window->status = status;
+    window->done = true;
+    window->cv.notify_all();
+  }
+
+  /// Returns the window at `index` from the cache, or inserts it. Sets
+  /// `inserted` if the caller has to fetch the new window.
+  std::shared_ptr<Window> LookupOrInsert(uint64 index, bool* inserted) const {
+    mutex_lock lock(mu_);
+    auto it = windows_.find(index);
+    if (it != windows_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, it->second.second);
+      *inserted = false;
+      return it->second.first;
+    }
+    auto window = std::make_shared<Window>();
+    lru_list_.push_front(index);
+    windows_.emplace(index, std::make_pair(window, lru_list_.begin()));
+    while (windows_.size() > max_windows_) {
+      windows_.erase(lru_list_.back());
+      lru_list_.pop_back();
+    }
+    *inserted = true;
+    return window;
+  }
+
+  /// Returns the window at `index` in `window`, fetching it on a miss and
+  /// waiting for a fetch already in flight.
+  Status GetWindow(uint64 index, std::shared_ptr<Window>* window) const {
+    bool inserted;
+    *window = LookupOrInsert(index, &inserted);
+    const uint64 window_start = index * read_ahead_bytes_;
+    if (inserted) {
+      FetchWindow(shost, sak, ssk, sbucket, sobject, window_start,
+                  std::min<uint64>(read_ahead_bytes_,
+                                   total_file_length_ - window_start),
+                  *window);
+    }
+    Status status;
+    {
+      mutex_lock lock((*window)->mu);
+      while (!(*window)->done) (*window)->cv.wait(lock);
+      status = (*window)->status;
+    }
+    if (!status.ok()) {
+      // Drop the failed window so that the next read retries it.
+      mutex_lock lock(mu_);
+      auto it = windows_.find(index);
+      if (it != windows_.end() && it->second.first == *window) {
+        lru_list_.erase(it->second.second);
+        windows_.erase(it);
       }
-      buffer_size_ = pos;
-      return OkStatus();
-    } else {
-      string msg;
-      oss_error_message(s, &msg);
-      VLOG(0) << "read " << sobject << " failed, errMsg: " << msg;
-      return errors::Internal("read failed: ", sobject, " errMsg: ", msg);
     }
+    return status;
+  }
+
+  /// Starts fetching the window at `index` in the background, unless it is
+  /// past the end of the file or already cached.
+  void Prefetch(uint64 index) const {
+    const uint64 window_start = index * read_ahead_bytes_;
+    if (window_start >= total_file_length_) return;
+    bool inserted;
+    auto window = LookupOrInsert(index, &inserted);
+    if (!inserted) return;
+    // The closure owns copies of everything it uses, so that it may outlive
+    // the file.
+    const size_t size =
+        std::min<uint64>(read_ahead_bytes_, total_file_length_ - window_start);
+    Env::Default()->SchedClosure([host = shost, access_id = sak,
+                                  access_key = ssk, bucket = sbucket,
+                                  object = sobject, window_start, size,
+                                  window]() {
+      FetchWindow(host, access_id, access_key, bucket, object, window_start,
+                  size, window);
+    });
   }
 
   std::string shost;
@@ -266,13 +362,21 @@ class OSSRandomAccessFile : public RandomAccessFile {
   std::string sbucket;
   std::string sobject;
   const size_t total_file_length_;
+  // The size of the windows, which are aligned to it.
   size_t read_ahead_bytes_;
+  // The maximum number of windows cached.
+  const size_t max_windows_;
 
   mutable mutex mu_;
-  mutable std::vector<char> buffer_ TF_GUARDED_BY(mu_);
-  // The original file offset of the first byte in the buffer.
-  mutable size_t buffer_start_offset_ TF_GUARDED_BY(mu_) = 0;
-  mutable size_t buffer_size_ TF_GUARDED_BY(mu_) = 0;
+  // The cached windows by index, with their position in the LRU list. The
+  // front of the list is the most recently used window.
+  mutable std::map<uint64, std::pair<std::shared_ptr<Window>,
+                                     std::list<uint64>::iterator>>
+      windows_ TF_GUARDED_BY(mu_);
+  mutable std::list<uint64> lru_list_ TF_GUARDED_BY(mu_);
+  // The index of the last window of the previous read, to detect sequential
+  // reads. The initial value makes a first read from the start sequential.
+  mutable uint64 last_window_ TF_GUARDED_BY(mu_) = kuint64max;
 };
 
 class OSSReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -580,7 +684,7 @@ Status OSSFileSystem::NewRandomAccessFile(
       conn.getPool(), conn.getRequestOptions(), bucket, object, &stat));
   result->reset(new OSSRandomAccessFile(host, access_id, access_key, bucket,
                                         object, read_ahead_bytes_,
-                                        stat.length));
+                                        read_cache_windows_, stat.length));
   return OkStatus();
 }
 
@@ -1364,9 +1468,10 @@ static void Cleanup(TF_RandomAccessFile* file) {
 static int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
                     char* buffer, TF_Status* status) {
   auto oss_file = static_cast<OSSRandomAccessFile*>(file->plugin_file);
+  FilesystemRequest request("oss", "read", status);
   StringPiece result;
   ToTF_Status(oss_file->Read(offset, n, &result, buffer), status);
-  return result.size();
+  return request.Bytes(result.size());
 }
 
 }  // namespace tf_random_access_file
@@ -1383,6 +1488,8 @@ static void Cleanup(TF_WritableFile* file) {
 static void Append(const TF_WritableFile* file, const char* buffer, size_t n,
                    TF_Status* status) {
   auto oss_file = static_cast<OSSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("oss", "write", status);
+  request.Bytes(n);
   ToTF_Status(oss_file->Append(StringPiece(buffer, n)), status);
 }
 
@@ -1398,11 +1505,13 @@ static void Flush(const TF_WritableFile* file, TF_Status* status) {
 
 static void Sync(const TF_WritableFile* file, TF_Status* status) {
   auto oss_file = static_cast<OSSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("oss", "sync", status);
   ToTF_Status(oss_file->Sync(), status);
 }
 
 static void Close(const TF_WritableFile* file, TF_Status* status) {
   auto oss_file = static_cast<OSSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("oss", "sync", status);
   ToTF_Status(oss_file->Close(), status);
 }
 
@@ -1525,6 +1634,7 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
 void CopyFile(const TF_Filesystem* filesystem, const char* src, const char* dst,
               TF_Status* status) {
   auto oss_fs = static_cast<OSSFileSystem*>(filesystem->plugin_filesystem);
+  FilesystemRequest request("oss", "copy", status);
   ToTF_Status(oss_fs->CopyFile(src, dst), status);
 }
 
@@ -1538,6 +1648,7 @@ bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
 void Stat(const TF_Filesystem* filesystem, const char* path,
           TF_FileStatistics* stats, TF_Status* status) {
   auto oss_fs = static_cast<OSSFileSystem*>(filesystem->plugin_filesystem);
+  FilesystemRequest request("oss", "stat", status);
   ToTF_Status(oss_fs->Stat(path, stats), status);
 }
 
@@ -1551,7 +1662,10 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
                 char*** entries, TF_Status* status) {
   auto oss_fs = static_cast<OSSFileSystem*>(filesystem->plugin_filesystem);
   std::vector<std::string> result;
-  ToTF_Status(oss_fs->GetChildren(path, &result), status);
+  {
+    FilesystemRequest request("oss", "list", status);
+    ToTF_Status(oss_fs->GetChildren(path, &result), status);
+  }
   int num_entries = result.size();
   *entries = static_cast<char**>(
       plugin_memory_allocate(num_entries * sizeof((*entries)[0])));
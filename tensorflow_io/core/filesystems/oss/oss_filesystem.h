@@ -117,6 +117,10 @@ class OSSFileSystem {
   //  in the RandomAccessFile implementation. Defaults to 5Mb.
   const size_t read_ahead_bytes_ = 5 * 1024 * 1024;
 
+  // The number of aligned windows of read_ahead_bytes_ bytes that each
+  // RandomAccessFile caches.
+  const size_t read_cache_windows_ = 4;
+
   // The number of bytes for each upload part. Defaults to 64MB
   const size_t upload_part_bytes_ = 64 * 1024 * 1024;
 
@@ -0,0 +1,80 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_io/core/filesystems/parallel_read.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace tensorflow {
+namespace io {
+
+int64_t ParallelRead(const RangeReader& read, uint64_t offset, size_t n,
+                     char* buffer, size_t num_threads, size_t min_chunk_size,
+                     TF_Status* status) {
+  num_threads = (std::max)(num_threads, static_cast<size_t>(1));
+  const size_t chunk_size = (std::max)(
+      (std::max)(min_chunk_size, static_cast<size_t>(1)),
+      (n + num_threads - 1) / num_threads);
+  const size_t num_chunks = n == 0 ? 0 : (n + chunk_size - 1) / chunk_size;
+  if (num_chunks <= 1) return read(offset, n, buffer, status);
+
+  struct Chunk {
+    size_t n;
+    int64_t read = 0;
+    std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status{
+        TF_NewStatus(), TF_DeleteStatus};
+  };
+  std::vector<Chunk> chunks(num_chunks);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    chunks[i].n = (std::min)(chunk_size, n - i * chunk_size);
+  }
+  std::atomic<size_t> next_chunk(0);
+  auto worker = [&]() {
+    for (size_t i = next_chunk++; i < num_chunks; i = next_chunk++) {
+      TF_SetStatus(chunks[i].status.get(), TF_OK, "");
+      chunks[i].read = read(offset + i * chunk_size, chunks[i].n,
+                            buffer + i * chunk_size, chunks[i].status.get());
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < (std::min)(num_threads, num_chunks); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) thread.join();
+
+  int64_t total = 0;
+  for (const auto& chunk : chunks) {
+    TF_Code code = TF_GetCode(chunk.status.get());
+    if (code != TF_OK && code != TF_OUT_OF_RANGE) {
+      TF_SetStatus(status, code, TF_Message(chunk.status.get()));
+      return total > 0 ? total : -1;
+    }
+    if (chunk.read > 0) total += chunk.read;
+    if (chunk.read < static_cast<int64_t>(chunk.n)) break;
+  }
+  if (static_cast<size_t>(total) < n) {
+    TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
+  } else {
+    TF_SetStatus(status, TF_OK, "");
+  }
+  return total;
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,48 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_PARALLEL_READ_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_PARALLEL_READ_H_
+
+#include <functional>
+
+#include "tensorflow/c/tf_status.h"
+
+namespace tensorflow {
+namespace io {
+
+// Reads up to `n` bytes at `offset`, returning the number of bytes written
+// to `buffer`, which is less than `n` only at the end of the file, or -1. A
+// short read may set `status` to TF_OUT_OF_RANGE.
+typedef std::function<int64_t(uint64_t offset, size_t n, char* buffer,
+                              TF_Status* status)>
+    RangeReader;
+
+// Reads `n` bytes at `offset` into `buffer` with `read`, split into chunks of
+// at least `min_chunk_size` bytes that are read by up to `num_threads`
+// threads at once. Returns the number of bytes read up to the first short or
+// failed chunk, with `status` set to the error of a failed chunk.
+int64_t ParallelRead(const RangeReader& read, uint64_t offset, size_t n,
+                     char* buffer, size_t num_threads, size_t min_chunk_size,
+                     TF_Status* status);
+
+// The default number of threads and minimum chunk size with which
+// NewReadOnlyMemoryRegionFromFile reads files.
+constexpr size_t kMemoryRegionReadThreads = 8;
+constexpr size_t kMemoryRegionMinChunkSize = 8 * 1024 * 1024;
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_PARALLEL_READ_H_
@@ -0,0 +1,540 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_io/core/filesystems/ram_file_block_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+uint64_t NowSeconds() { return absl::ToUnixSeconds(absl::Now()); }
+
+}  // namespace
+
+RamFileBlockCache::RamFileBlockCache(size_t block_size, size_t max_bytes,
+                                     uint64_t max_staleness,
+                                     BlockFetcher block_fetcher,
+                                     std::function<uint64_t()> timer_seconds,
+                                     size_t prefetch_blocks,
+                                     size_t prefetch_threads, size_t num_shards)
+    : block_size_(block_size),
+      max_bytes_(max_bytes),
+      max_staleness_(max_staleness),
+      block_fetcher_(std::move(block_fetcher)),
+      timer_seconds_(timer_seconds != nullptr ? std::move(timer_seconds)
+                                              : NowSeconds),
+      prefetch_blocks_(block_size > 0 && max_bytes > 0 ? prefetch_blocks : 0) {
+  if (block_size_ > 0) {
+    num_shards = std::min(num_shards, max_bytes_ / block_size_);
+  }
+  num_shards = std::max<size_t>(num_shards, 1);
+  shard_max_bytes_ = max_bytes_ / num_shards;
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(new Shard());
+  }
+  if (max_staleness_ > 0) {
+    pruning_thread_.reset(new std::thread([this] { Prune(); }));
+  }
+  if (prefetch_blocks_ > 0) {
+    for (size_t i = 0; i < std::max<size_t>(prefetch_threads, 1); ++i) {
+      prefetch_threads_.emplace_back([this] { PrefetchLoop(); });
+    }
+  }
+}
+
+RamFileBlockCache::~RamFileBlockCache() {
+  if (pruning_thread_) {
+    stop_pruning_thread_.Notify();
+    pruning_thread_->join();
+  }
+  {
+    absl::MutexLock l(&prefetch_mu_);
+    stop_prefetch_ = true;
+    prefetch_cv_.SignalAll();
+  }
+  for (auto& thread : prefetch_threads_) thread.join();
+  if (!budget_component_.empty()) {
+    MemoryBudget::Global()->Release(budget_component_, CacheSize());
+  }
+}
+
+RamFileBlockCache::Shard* RamFileBlockCache::ShardFor(const Key& key) const {
+  if (shards_.size() == 1) return shards_[0].get();
+  size_t hash = std::hash<std::string>()(key.first);
+  hash ^= key.second / block_size_ + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return shards_[hash % shards_.size()].get();
+}
+
+bool RamFileBlockCache::BlockNotStale(const std::shared_ptr<Block>& block) {
+  absl::MutexLock l(&block->mu);
+  if (block->state != FetchState::FINISHED) {
+    return true;  // No need to check for staleness.
+  }
+  if (max_staleness_ == 0) return true;  // Not enforcing staleness.
+  return timer_seconds_() - block->timestamp <= max_staleness_;
+}
+
+std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
+    const Key& key) {
+  Shard* shard = ShardFor(key);
+  {
+    absl::MutexLock lock(&shard->mu);
+    auto entry = shard->block_map.find(key);
+    if (entry == shard->block_map.end()) {
+      return InsertBlock_Locked(shard, key);
+    }
+    if (BlockNotStale(entry->second)) {
+      return entry->second;
+    }
+  }
+  // Remove the stale file and continue. The blocks of the file may live in
+  // any shard, so the shard lock is released first.
+  RemoveFile(key.first);
+  absl::MutexLock lock(&shard->mu);
+  auto entry = shard->block_map.find(key);
+  if (entry != shard->block_map.end()) {
+    // Inserted again by a concurrent reader.
+    return entry->second;
+  }
+  return InsertBlock_Locked(shard, key);
+}
+
+std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::LookupFetched(
+    const Key& key) {
+  Shard* shard = ShardFor(key);
+  absl::ReaderMutexLock lock(&shard->mu);
+  auto entry = shard->block_map.find(key);
+  if (entry == shard->block_map.end()) return nullptr;
+  const std::shared_ptr<Block>& block = entry->second;
+  if (!block->finished.load(std::memory_order_acquire)) return nullptr;
+  if (max_staleness_ > 0 &&
+      timer_seconds_() - block->timestamp > max_staleness_) {
+    return nullptr;
+  }
+  block->referenced.store(true, std::memory_order_relaxed);
+  return block;
+}
+
+std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::InsertBlock_Locked(
+    Shard* shard, const Key& key) {
+  // Insert a new empty block, setting the bookkeeping to sentinel values
+  // in order to update them as appropriate.
+  auto new_entry = std::make_shared<Block>();
+  shard->lru_list.push_front(key);
+  shard->lra_list.push_front(key);
+  new_entry->lru_iterator = shard->lru_list.begin();
+  new_entry->lra_iterator = shard->lra_list.begin();
+  new_entry->timestamp = timer_seconds_();
+  shard->block_map.emplace(std::make_pair(key, new_entry));
+  return new_entry;
+}
+
+// Remove blocks from the shard until we do not exceed its maximum size.
+void RamFileBlockCache::Trim(Shard* shard) {
+  // Over the memory budget, the shard keeps one block so reads progress.
+  auto over_budget = [this, shard]() {
+    return !budget_component_.empty() && shard->cache_size > block_size_ &&
+           MemoryBudget::Global()->Exhausted();
+  };
+  while (!shard->lru_list.empty() &&
+         (shard->cache_size > shard_max_bytes_ || over_budget())) {
+    auto entry = shard->block_map.find(shard->lru_list.back());
+    // A block that has been hit since it was last moved gets a second chance.
+    if (entry->second->referenced.exchange(false, std::memory_order_relaxed)) {
+      shard->lru_list.splice(shard->lru_list.begin(), shard->lru_list,
+                             entry->second->lru_iterator);
+      continue;
+    }
+    RemoveBlock(shard, entry);
+  }
+}
+
+// Moves the block to the front of the LRU list if it isn't already there.
+void RamFileBlockCache::UpdateLRU(const Key& key,
+                                  const std::shared_ptr<Block>& block,
+                                  TF_Status* status) {
+  Shard* shard = ShardFor(key);
+  {
+    absl::MutexLock lock(&shard->mu);
+    if (block->timestamp == 0) {
+      // The block was evicted from another thread. Allow it to remain
+      // evicted.
+      return TF_SetStatus(status, TF_OK, "");
+    }
+    if (block->lru_iterator != shard->lru_list.begin()) {
+      shard->lru_list.erase(block->lru_iterator);
+      shard->lru_list.push_front(key);
+      block->lru_iterator = shard->lru_list.begin();
+    }
+    Trim(shard);
+  }
+
+  // Check for inconsistent state. If there is a block later in the same file
+  // in the cache, and our current block is not block size, this likely means
+  // we have inconsistent state within the cache. Note: it's possible some
+  // incomplete reads may still go undetected.
+  if (block->data.size() < block_size_) {
+    {
+      absl::MutexLock lock(&file_mu_);
+      size_t& file_size =
+          file_size_.emplace(key.first, std::numeric_limits<size_t>::max())
+              .first->second;
+      file_size = std::min(file_size, key.second + block->data.size());
+    }
+    if (HasLaterBlock(key)) {
+      return TF_SetStatus(status, TF_INTERNAL,
+                          "Block cache contents are inconsistent.");
+    }
+  }
+
+  TF_SetStatus(status, TF_OK, "");
+}
+
+bool RamFileBlockCache::HasLaterBlock(const Key& key) {
+  // Blocks past the end of the file that are prefetched, or have been found
+  // empty, are not inconsistent.
+  Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    auto fcmp = shard->block_map.upper_bound(fmax);
+    if (fcmp != shard->block_map.begin() && key < (--fcmp)->first) {
+      absl::MutexLock l(&fcmp->second->mu);
+      if (fcmp->second->state == FetchState::FINISHED &&
+          !fcmp->second->data.empty()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void RamFileBlockCache::MaybeFetch(const Key& key,
+                                   const std::shared_ptr<Block>& block,
+                                   TF_Status* status) {
+  bool downloaded_block = false;
+  block->mu.Lock();
+  // Loop until either block content is successfully fetched, or our request
+  // encounters an error.
+  bool done = false;
+  while (!done) {
+    switch (block->state) {
+      case FetchState::ERROR:
+        // TF_FALLTHROUGH_INTENDED
+      case FetchState::CREATED: {
+        block->state = FetchState::FETCHING;
+        block->mu.Unlock();  // Release the lock while making the API call.
+        block->data.clear();
+        block->data.resize(block_size_, 0);
+        int64_t bytes_transferred = block_fetcher_(
+            key.first, key.second, block_size_, block->data.data(), status);
+        block->mu.Lock();
+        if (TF_GetCode(status) == TF_OK) {
+          block->data.resize(bytes_transferred, 0);
+          // Shrink the data capacity to the actual size used.
+          std::vector<char>(block->data).swap(block->data);
+          downloaded_block = true;
+          block->state = FetchState::FINISHED;
+        } else {
+          block->state = FetchState::ERROR;
+        }
+        block->cond_var.SignalAll();
+        done = true;
+        break;
+      }
+      case FetchState::FETCHING:
+        block->cond_var.Wait(&block->mu);
+        continue;
+      case FetchState::FINISHED:
+        TF_SetStatus(status, TF_OK, "");
+        done = true;
+        break;
+    }
+  }
+  block->mu.Unlock();
+
+  // Account for the block only once it is fetched, and refresh its timestamp
+  // unless it has been evicted in the meantime.
+  if (downloaded_block) {
+    Shard* shard = ShardFor(key);
+    absl::MutexLock l(&shard->mu);
+    if (block->timestamp != 0) {
+      block->cached_bytes = block->data.capacity();
+      shard->cache_size += block->cached_bytes;
+      if (!budget_component_.empty()) {
+        MemoryBudget::Global()->Reserve(budget_component_,
+                                        block->cached_bytes);
+      }
+      // Put to beginning of LRA list.
+      shard->lra_list.erase(block->lra_iterator);
+      shard->lra_list.push_front(key);
+      block->lra_iterator = shard->lra_list.begin();
+      block->timestamp = timer_seconds_();
+    }
+    // Published after the timestamp, which the hit path reads.
+    block->finished.store(true, std::memory_order_release);
+  }
+}
+
+int64_t RamFileBlockCache::Read(const std::string& filename, size_t offset,
+                                size_t n, char* buffer, TF_Status* status) {
+  if (n == 0) {
+    TF_SetStatus(status, TF_OK, "");
+    return 0;
+  }
+  if (!IsCacheEnabled() || n > max_bytes_) {
+    // The cache is effectively disabled, so we pass the read through to the
+    // fetcher without breaking it up into blocks.
+    return block_fetcher_(filename, offset, n, buffer, status);
+  }
+  // Calculate the block-aligned start and end of the read.
+  size_t start = block_size_ * (offset / block_size_);
+  size_t finish = block_size_ * ((offset + n) / block_size_);
+  if (finish < offset + n) {
+    finish += block_size_;
+  }
+  if (prefetch_blocks_ > 0 &&
+      UpdateAccessPattern(filename, start, finish)) {
+    // Queued before the blocks of this read are fetched, so that the
+    // prefetches overlap with them.
+    SchedulePrefetch(filename, finish);
+  }
+  size_t total_bytes_transferred = 0;
+  // Now iterate through the blocks, reading them one at a time.
+  for (size_t pos = start; pos < finish; pos += block_size_) {
+    Key key = std::make_pair(filename, pos);
+    // In sharded mode, hits on fetched blocks skip the exclusive lock.
+    std::shared_ptr<Block> block =
+        shards_.size() > 1 ? LookupFetched(key) : nullptr;
+    if (block == nullptr) {
+      // Look up the block, fetching and inserting it if necessary, and
+      // update the LRU iterator for the key and block.
+      block = Lookup(key);
+      if (lookup_observer_) {
+        lookup_observer_(block->finished.load(std::memory_order_acquire));
+      }
+      MaybeFetch(key, block, status);
+      if (TF_GetCode(status) != TF_OK) return -1;
+      UpdateLRU(key, block, status);
+      if (TF_GetCode(status) != TF_OK) return -1;
+    } else if (lookup_observer_) {
+      lookup_observer_(true);
+    }
+    // Copy the relevant portion of the block into the result buffer.
+    const auto& data = block->data;
+    if (offset >= pos + data.size()) {
+      // The requested offset is at or beyond the end of the file.
+      break;
+    }
+    auto begin = data.begin();
+    if (offset > pos) {
+      // The block begins before the slice we're reading.
+      begin += offset - pos;
+    }
+    auto end = data.end();
+    if (pos + data.size() > offset + n) {
+      // The block extends past the end of the slice we're reading.
+      end -= (pos + data.size()) - (offset + n);
+    }
+    if (begin < end) {
+      size_t bytes_to_copy = end - begin;
+      memcpy(&buffer[total_bytes_transferred], &*begin, bytes_to_copy);
+      total_bytes_transferred += bytes_to_copy;
+    }
+    if (data.size() < block_size_) {
+      // The block was a partial block and thus signals EOF at its upper
+      // bound.
+      break;
+    }
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return total_bytes_transferred;
+}
+
+bool RamFileBlockCache::ValidateAndUpdateFileSignature(
+    const std::string& filename, int64_t file_signature) {
+  {
+    absl::MutexLock lock(&file_mu_);
+    auto it = file_signature_map_.find(filename);
+    if (it == file_signature_map_.end()) {
+      file_signature_map_[filename] = file_signature;
+      return true;
+    }
+    if (it->second == file_signature) {
+      return true;
+    }
+    it->second = file_signature;
+  }
+  // Remove the file from cache if the signatures don't match.
+  RemoveFile(filename);
+  return false;
+}
+
+bool RamFileBlockCache::UpdateAccessPattern(const std::string& filename,
+                                            size_t start, size_t finish) {
+  absl::MutexLock lock(&file_mu_);
+  auto it = last_block_.find(filename);
+  bool sequential = it != last_block_.end() &&
+                    (start == it->second || start == it->second + block_size_);
+  last_block_[filename] = finish - block_size_;
+  return sequential;
+}
+
+void RamFileBlockCache::SchedulePrefetch(const std::string& filename,
+                                         size_t start) {
+  size_t file_size = std::numeric_limits<size_t>::max();
+  {
+    absl::MutexLock lock(&file_mu_);
+    auto it = file_size_.find(filename);
+    if (it != file_size_.end()) file_size = it->second;
+  }
+  std::vector<std::pair<Key, std::shared_ptr<Block>>> blocks;
+  for (size_t i = 0; i < prefetch_blocks_; ++i) {
+    Key key = std::make_pair(filename, start + i * block_size_);
+    if (key.second >= file_size) break;
+    Shard* shard = ShardFor(key);
+    absl::MutexLock lock(&shard->mu);
+    // Cached or already being fetched.
+    if (shard->block_map.find(key) != shard->block_map.end()) continue;
+    blocks.emplace_back(key, InsertBlock_Locked(shard, key));
+  }
+  if (blocks.empty()) return;
+  absl::MutexLock l(&prefetch_mu_);
+  for (auto& block : blocks) prefetch_queue_.push_back(std::move(block));
+  prefetch_cv_.SignalAll();
+}
+
+void RamFileBlockCache::PrefetchLoop() {
+  TF_Status* status = TF_NewStatus();
+  while (true) {
+    std::pair<Key, std::shared_ptr<Block>> entry;
+    {
+      absl::MutexLock l(&prefetch_mu_);
+      while (prefetch_queue_.empty() && !stop_prefetch_) {
+        prefetch_cv_.Wait(&prefetch_mu_);
+      }
+      if (stop_prefetch_) break;
+      entry = std::move(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
+    {
+      Shard* shard = ShardFor(entry.first);
+      absl::MutexLock lock(&shard->mu);
+      // Evicted before its turn came.
+      if (entry.second->timestamp == 0) continue;
+    }
+    // A reader that got to the block first fetches it, and a failed
+    // prefetch leaves the block in ERROR state for the reader to retry.
+    MaybeFetch(entry.first, entry.second, status);
+    if (TF_GetCode(status) == TF_OK) {
+      UpdateLRU(entry.first, entry.second, status);
+    }
+  }
+  TF_DeleteStatus(status);
+}
+
+size_t RamFileBlockCache::CacheSize() const {
+  size_t cache_size = 0;
+  for (const auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    cache_size += shard->cache_size;
+  }
+  return cache_size;
+}
+
+void RamFileBlockCache::Prune() {
+  while (!stop_pruning_thread_.WaitForNotificationWithTimeout(
+      absl::Seconds(1))) {
+    std::set<std::string> expired;
+    for (auto& shard : shards_) {
+      absl::MutexLock lock(&shard->mu);
+      uint64_t now = timer_seconds_();
+      for (auto it = shard->lra_list.rbegin(); it != shard->lra_list.rend();
+           ++it) {
+        if (now - shard->block_map.find(*it)->second->timestamp <=
+            max_staleness_) {
+          // The oldest block is not yet expired. Come back later.
+          break;
+        }
+        expired.insert(it->first);
+      }
+    }
+    for (const auto& filename : expired) RemoveFile(filename);
+  }
+}
+
+void RamFileBlockCache::Flush() {
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    // Blocks that are still being fetched must not be accounted afterwards.
+    for (auto& entry : shard->block_map) entry.second->timestamp = 0;
+    shard->block_map.clear();
+    shard->lru_list.clear();
+    shard->lra_list.clear();
+    if (!budget_component_.empty()) {
+      MemoryBudget::Global()->Release(budget_component_, shard->cache_size);
+    }
+    shard->cache_size = 0;
+  }
+  absl::MutexLock lock(&file_mu_);
+  last_block_.clear();
+  file_size_.clear();
+}
+
+void RamFileBlockCache::RemoveFile(const std::string& filename) {
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    RemoveFile_Locked(shard.get(), filename);
+  }
+  absl::MutexLock lock(&file_mu_);
+  last_block_.erase(filename);
+  file_size_.erase(filename);
+}
+
+void RamFileBlockCache::RemoveFile_Locked(Shard* shard,
+                                          const std::string& filename) {
+  Key begin = std::make_pair(filename, 0);
+  auto it = shard->block_map.lower_bound(begin);
+  while (it != shard->block_map.end() && it->first.first == filename) {
+    auto next = std::next(it);
+    RemoveBlock(shard, it);
+    it = next;
+  }
+}
+
+void RamFileBlockCache::RemoveBlock(Shard* shard, BlockMap::iterator entry) {
+  // This signals that the block is removed, and should not be inadvertently
+  // reinserted into the cache in UpdateLRU.
+  entry->second->timestamp = 0;
+  shard->lru_list.erase(entry->second->lru_iterator);
+  shard->lra_list.erase(entry->second->lra_iterator);
+  shard->cache_size -= entry->second->cached_bytes;
+  if (!budget_component_.empty()) {
+    MemoryBudget::Global()->Release(budget_component_,
+                                    entry->second->cached_bytes);
+  }
+  shard->block_map.erase(entry);
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,315 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_RAM_FILE_BLOCK_CACHE_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_RAM_FILE_BLOCK_CACHE_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "tensorflow/c/tf_status.h"
+
+namespace tensorflow {
+namespace io {
+
+// An LRU block cache of file contents, keyed by {filename, offset}.
+//
+// This class should be shared by read-only random access files on a remote
+// filesystem (e.g. S3). It is the block cache of the GCS, S3 and Azure
+// filesystems.
+//
+// The cache may be split into shards by the hash of {filename, offset}, each
+// shard with its own lock, LRU list and an equal share of `max_bytes`. In
+// sharded mode a hit on a fetched block only takes a shared lock of its
+// shard: instead of moving the block to the front of the LRU list, the hit
+// marks the block referenced, and eviction gives referenced blocks a second
+// chance.
+class RamFileBlockCache {
+ public:
+  // The callback executed when a block is not found in the cache, and needs
+  // to be fetched from the backing filesystem. This callback is provided when
+  // the cache is constructed. It returns the number of bytes written to
+  // `buffer`; a short read at the end of the file must leave `status` OK.
+  typedef std::function<int64_t(const std::string& filename, size_t offset,
+                                size_t buffer_size, char* buffer,
+                                TF_Status* status)>
+      BlockFetcher;
+
+  // If `prefetch_blocks` is non-zero, the next `prefetch_blocks` blocks of a
+  // file are fetched by `prefetch_threads` background threads once the file
+  // is read sequentially, i.e. a read starts in the last block or the block
+  // after the last block of the previous read of the file. Readers of a
+  // block that is being prefetched wait for that fetch.
+  //
+  // `num_shards` is capped so that every shard holds at least one block.
+  RamFileBlockCache(size_t block_size, size_t max_bytes, uint64_t max_staleness,
+                    BlockFetcher block_fetcher,
+                    std::function<uint64_t()> timer_seconds = nullptr,
+                    size_t prefetch_blocks = 0, size_t prefetch_threads = 1,
+                    size_t num_shards = 1);
+
+  ~RamFileBlockCache();
+
+  // Reads `n` bytes from `filename` starting at `offset` into `buffer`.
+  // Returns the number of bytes read, which is less than `n` only at the end
+  // of the file, or -1 with `status` set to the error of the block fetcher.
+  //
+  // Reads are split into blocks of `block_size_` bytes, each block is looked
+  // up in the cache and fetched with the block fetcher on a miss. Requests
+  // larger than the whole cache bypass it.
+  int64_t Read(const std::string& filename, size_t offset, size_t n,
+               char* buffer, TF_Status* status);
+
+  // Validates the given file signature with the existing file signature in
+  // the cache. Returns true if the signature doesn't change or the file did
+  // not exist before. If the signature changes, all cached blocks of the file
+  // are removed and false is returned.
+  bool ValidateAndUpdateFileSignature(const std::string& filename,
+                                      int64_t file_signature);
+
+  // Removes all cached blocks for `filename`.
+  void RemoveFile(const std::string& filename);
+
+  // Removes all cached data.
+  void Flush();
+
+  // Accessors for cache parameters.
+  size_t block_size() const { return block_size_; }
+  size_t max_bytes() const { return max_bytes_; }
+  uint64_t max_staleness() const { return max_staleness_; }
+  size_t prefetch_blocks() const { return prefetch_blocks_; }
+  size_t num_shards() const { return shards_.size(); }
+
+  // The current size (in bytes) of the cache.
+  size_t CacheSize() const;
+
+  // Returns true if the cache is enabled. If false, the BlockFetcher
+  // callback is always executed during Read.
+  bool IsCacheEnabled() const { return block_size_ > 0 && max_bytes_ > 0; }
+
+  // Sets a callback run for every block looked up by Read with whether the
+  // block was already fetched, e.g. to export the hit ratio. Must be set
+  // before the cache is shared between threads.
+  void SetLookupObserver(std::function<void(bool hit)> observer) {
+    lookup_observer_ = std::move(observer);
+  }
+
+  // Accounts the cached bytes to the process-wide MemoryBudget under
+  // `component`. While the budget is exhausted, a miss evicts blocks of its
+  // shard instead of growing it. Must be set before the cache is used.
+  void SetMemoryBudgetComponent(std::string component) {
+    budget_component_ = std::move(component);
+  }
+
+ private:
+  // The size of the blocks stored in the LRU cache, as well as the size of
+  // the reads from the underlying filesystem.
+  const size_t block_size_;
+  // The maximum number of bytes (sum of block sizes) allowed in the LRU
+  // cache.
+  const size_t max_bytes_;
+  // The maximum staleness of any block in the LRU cache, in seconds.
+  const uint64_t max_staleness_;
+  // The callback to read a block from the underlying filesystem.
+  const BlockFetcher block_fetcher_;
+  // The callback to read timestamps.
+  const std::function<uint64_t()> timer_seconds_;
+  // The number of blocks fetched ahead of sequential readers.
+  const size_t prefetch_blocks_;
+  // The maximum number of bytes allowed in each shard.
+  size_t shard_max_bytes_;
+  // The callback run for every block looked up by Read.
+  std::function<void(bool hit)> lookup_observer_;
+  // The MemoryBudget component of the cached bytes, or empty.
+  std::string budget_component_;
+
+  // \brief The key type for the file block cache.
+  //
+  // The file block cache key is a {filename, offset} pair.
+  typedef std::pair<std::string, size_t> Key;
+
+  // \brief The state of a block.
+  //
+  // A block begins in the CREATED stage. The first thread will attempt to
+  // read the block from the filesystem, transitioning the state of the block
+  // to FETCHING. After completing, if the read was successful the state
+  // should be FINISHED. Otherwise the state should be ERROR. A subsequent
+  // read can re-fetch the block if the state is ERROR.
+  enum class FetchState {
+    CREATED,
+    FETCHING,
+    FINISHED,
+    ERROR,
+  };
+
+  // \brief A block of a file.
+  //
+  // A file block consists of the block data, the block's current position in
+  // the LRU cache, the timestamp (seconds since epoch) at which the block
+  // was cached, and the fetch state. The data is only written by the thread
+  // that moves the block to FETCHING, and only read once it is FINISHED.
+  // The bookkeeping fields are guarded by the mutex of the block's shard.
+  struct Block {
+    // The block data.
+    std::vector<char> data;
+    // A list iterator pointing to the block's position in the LRU list.
+    std::list<Key>::iterator lru_iterator;
+    // A list iterator pointing to the block's position in the LRA list.
+    std::list<Key>::iterator lra_iterator;
+    // The timestamp (seconds since epoch) at which the block was cached, or
+    // 0 once it has been evicted.
+    uint64_t timestamp;
+    // The bytes of the block accounted in cache_size_, zero until the block
+    // has been fetched.
+    size_t cached_bytes = 0;
+    // Set once the state is FINISHED, so that hits can skip `mu`.
+    std::atomic<bool> finished{false};
+    // Set by hits in sharded mode, and cleared when eviction gives the block
+    // a second chance.
+    std::atomic<bool> referenced{false};
+    // Mutex to guard state variable
+    absl::Mutex mu;
+    // The state of the block.
+    FetchState state ABSL_GUARDED_BY(mu) = FetchState::CREATED;
+    // Wait on cond_var if state is FETCHING.
+    absl::CondVar cond_var;
+  };
+
+  // \brief The block map type for the file block cache.
+  //
+  // The block map is an ordered map from Key to Block.
+  typedef std::map<Key, std::shared_ptr<Block>> BlockMap;
+
+  // \brief A shard of the cache.
+  //
+  // A shard holds the blocks whose key hashes to it, with their LRU and LRA
+  // lists and byte count.
+  struct Shard {
+    // Guards access to the block map, LRU list, and cached byte count.
+    mutable absl::Mutex mu;
+    // The block map (map from Key to Block).
+    BlockMap block_map ABSL_GUARDED_BY(mu);
+    // The LRU list of block keys. The front of the list identifies the most
+    // recently accessed block.
+    std::list<Key> lru_list ABSL_GUARDED_BY(mu);
+    // The LRA (least recently added) list of block keys. The front of the
+    // list identifies the most recently added block.
+    //
+    // Note: blocks are added to lra_list only after they have successfully
+    // been fetched from the underlying block store.
+    std::list<Key> lra_list ABSL_GUARDED_BY(mu);
+    // The combined number of bytes in all of the cached blocks.
+    size_t cache_size ABSL_GUARDED_BY(mu) = 0;
+  };
+
+  // Returns the shard of `key`.
+  Shard* ShardFor(const Key& key) const;
+
+  // Prunes the cache by removing files with expired blocks.
+  void Prune();
+
+  bool BlockNotStale(const std::shared_ptr<Block>& block);
+
+  // Look up a Key in the block cache.
+  std::shared_ptr<Block> Lookup(const Key& key);
+
+  // Returns the block at `key` if it is fetched and not stale, marking it
+  // referenced, or nullptr. Takes only a shared lock of the shard.
+  std::shared_ptr<Block> LookupFetched(const Key& key);
+
+  // Inserts a new block in CREATED state for `key`.
+  std::shared_ptr<Block> InsertBlock_Locked(Shard* shard, const Key& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Records the blocks [start, finish) as the last read of `filename`, and
+  // returns whether the read continues the previous one.
+  bool UpdateAccessPattern(const std::string& filename, size_t start,
+                           size_t finish) ABSL_LOCKS_EXCLUDED(file_mu_);
+
+  // Queues fetches of the blocks of `filename` from offset `start` on, up to
+  // `prefetch_blocks_` blocks and not past the known end of the file.
+  void SchedulePrefetch(const std::string& filename, size_t start);
+
+  // The loop of the prefetch threads.
+  void PrefetchLoop();
+
+  // Fetches the block if it is not FINISHED yet, waiting on other readers
+  // that are fetching it.
+  void MaybeFetch(const Key& key, const std::shared_ptr<Block>& block,
+                  TF_Status* status);
+
+  // Trims the shard to make room for another entry.
+  void Trim(Shard* shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Update the LRU iterator for the block at `key`.
+  void UpdateLRU(const Key& key, const std::shared_ptr<Block>& block,
+                 TF_Status* status);
+
+  // Returns true if a fetched, non-empty block of `key.first` past
+  // `key.second` is cached in any shard.
+  bool HasLaterBlock(const Key& key);
+
+  // Remove all blocks of a file from `shard`, with its mutex already held.
+  void RemoveFile_Locked(Shard* shard, const std::string& filename)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Remove the block `entry` from the block map and LRU list, and update the
+  // cache size accordingly.
+  void RemoveBlock(Shard* shard, BlockMap::iterator entry)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // The cache pruning thread that removes files with expired blocks.
+  std::unique_ptr<std::thread> pruning_thread_;
+
+  // Notification for stopping the cache pruning thread.
+  absl::Notification stop_pruning_thread_;
+
+  // The threads fetching the blocks queued by SchedulePrefetch.
+  std::vector<std::thread> prefetch_threads_;
+  absl::Mutex prefetch_mu_;
+  absl::CondVar prefetch_cv_;
+  std::deque<std::pair<Key, std::shared_ptr<Block>>> prefetch_queue_
+      ABSL_GUARDED_BY(prefetch_mu_);
+  bool stop_prefetch_ ABSL_GUARDED_BY(prefetch_mu_) = false;
+
+  // The shards of the cache. Shard mutexes are acquired before block
+  // mutexes, and never while another shard mutex or file_mu_ is held.
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  // Guards access to the per-file state below.
+  absl::Mutex file_mu_;
+
+  // A filename->file_signature map.
+  std::map<std::string, int64_t> file_signature_map_ ABSL_GUARDED_BY(file_mu_);
+
+  // The offset of the last block of the last read of a file, and the size
+  // of the file once a partial block of it has been read.
+  std::map<std::string, size_t> last_block_ ABSL_GUARDED_BY(file_mu_);
+  std::map<std::string, size_t> file_size_ ABSL_GUARDED_BY(file_mu_);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_RAM_FILE_BLOCK_CACHE_H_
@@ -0,0 +1,300 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/filesystems/ram_file_block_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "gtest/gtest.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+constexpr size_t kBlockSize = 16;
+
+// The backing files of a cache, recording the offsets of every fetch.
+class FakeFiles {
+ public:
+  void Set(const std::string& filename, const std::string& content) {
+    absl::MutexLock l(&mu_);
+    files_[filename] = content;
+  }
+
+  RamFileBlockCache::BlockFetcher Fetcher() {
+    return [this](const std::string& filename, size_t offset, size_t n,
+                  char* buffer, TF_Status* status) -> int64_t {
+      absl::MutexLock l(&mu_);
+      fetches_[filename].push_back(offset);
+      const std::string& content = files_[filename];
+      if (offset >= content.size()) {
+        TF_SetStatus(status, TF_OK, "");
+        return 0;
+      }
+      size_t bytes = std::min(n, content.size() - offset);
+      memcpy(buffer, content.data() + offset, bytes);
+      TF_SetStatus(status, TF_OK, "");
+      return bytes;
+    };
+  }
+
+  // The offsets fetched from `filename`, in fetch order.
+  std::vector<size_t> Fetches(const std::string& filename) {
+    absl::MutexLock l(&mu_);
+    return fetches_[filename];
+  }
+
+  size_t NumFetches(const std::string& filename) {
+    return Fetches(filename).size();
+  }
+
+ private:
+  absl::Mutex mu_;
+  std::map<std::string, std::string> files_ ABSL_GUARDED_BY(mu_);
+  std::map<std::string, std::vector<size_t>> fetches_ ABSL_GUARDED_BY(mu_);
+};
+
+std::string MakeContent(size_t size, char seed) {
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    content[i] = static_cast<char>(seed + i % 64);
+  }
+  return content;
+}
+
+// Reads `n` bytes at `offset` and expects them to match `content`.
+void ExpectRead(RamFileBlockCache& cache, const std::string& filename,
+                const std::string& content, size_t offset, size_t n) {
+  TF_Status* status = TF_NewStatus();
+  std::string buffer(n, '\0');
+  int64_t bytes = cache.Read(filename, offset, n, &buffer[0], status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TF_DeleteStatus(status);
+  if (offset >= content.size()) {
+    EXPECT_EQ(0, bytes);
+    return;
+  }
+  ASSERT_EQ(std::min(n, content.size() - offset), bytes);
+  EXPECT_EQ(content.substr(offset, bytes), buffer.substr(0, bytes));
+}
+
+TEST(RamFileBlockCacheTest, HIT_AND_MISS) {
+  FakeFiles files;
+  const std::string content = MakeContent(100, 'a');
+  files.Set("a", content);
+  RamFileBlockCache cache(kBlockSize, 64 * kBlockSize, 0, files.Fetcher(),
+                          nullptr, 0, 1, 4);
+  ASSERT_EQ(4, cache.num_shards());
+  int hits = 0;
+  int misses = 0;
+  cache.SetLookupObserver([&](bool hit) { hit ? ++hits : ++misses; });
+
+  // The read spans blocks 0 and 1, both missed.
+  ExpectRead(cache, "a", content, 5, 20);
+  EXPECT_EQ((std::vector<size_t>{0, kBlockSize}), files.Fetches("a"));
+  EXPECT_EQ(0, hits);
+  EXPECT_EQ(2, misses);
+
+  // Both blocks are hit, and block 2 is missed.
+  ExpectRead(cache, "a", content, 0, 40);
+  EXPECT_EQ(3, files.NumFetches("a"));
+  EXPECT_EQ(2, hits);
+  EXPECT_EQ(3, misses);
+  EXPECT_EQ(3 * kBlockSize, cache.CacheSize());
+
+  // The partial last block ends the read at the end of the file.
+  ExpectRead(cache, "a", content, 90, 40);
+  ExpectRead(cache, "a", content, 90, 40);
+  EXPECT_EQ((std::vector<size_t>{0, kBlockSize, 2 * kBlockSize,
+                                 5 * kBlockSize, 6 * kBlockSize}),
+            files.Fetches("a"));
+  EXPECT_EQ(4 * kBlockSize + content.size() % kBlockSize, cache.CacheSize());
+
+  cache.RemoveFile("a");
+  EXPECT_EQ(0, cache.CacheSize());
+  ExpectRead(cache, "a", content, 0, 10);
+  EXPECT_EQ(6, files.NumFetches("a"));
+}
+
+TEST(RamFileBlockCacheTest, EVICTS_PER_SHARD) {
+  FakeFiles files;
+  const std::string content = MakeContent(32 * kBlockSize, 'a');
+  files.Set("a", content);
+  // Every shard holds a single block.
+  RamFileBlockCache cache(kBlockSize, 4 * kBlockSize, 0, files.Fetcher(),
+                          nullptr, 0, 1, 4);
+  ASSERT_EQ(4, cache.num_shards());
+  for (size_t block = 0; block < 32; ++block) {
+    ExpectRead(cache, "a", content, block * kBlockSize, kBlockSize);
+    EXPECT_LE(cache.CacheSize(), cache.max_bytes());
+  }
+  EXPECT_EQ(32, files.NumFetches("a"));
+  // At most four blocks are still cached, the others are fetched again.
+  for (size_t block = 0; block < 32; ++block) {
+    ExpectRead(cache, "a", content, block * kBlockSize, kBlockSize);
+  }
+  EXPECT_GE(files.NumFetches("a"), 32 + 28);
+
+  // The shards are capped to one block each.
+  RamFileBlockCache capped(kBlockSize, 2 * kBlockSize, 0, files.Fetcher(),
+                           nullptr, 0, 1, 8);
+  EXPECT_EQ(2, capped.num_shards());
+}
+
+TEST(RamFileBlockCacheTest, STALE_BLOCKS) {
+  FakeFiles files;
+  const std::string content = MakeContent(4 * kBlockSize, 'a');
+  files.Set("a", content);
+  std::atomic<uint64_t> now(1000);
+  RamFileBlockCache cache(
+      kBlockSize, 64 * kBlockSize, 10, files.Fetcher(),
+      [&now] { return now.load(); }, 0, 1, 4);
+  ExpectRead(cache, "a", content, 0, 4 * kBlockSize);
+  EXPECT_EQ(4, files.NumFetches("a"));
+
+  now += 10;
+  ExpectRead(cache, "a", content, 0, 4 * kBlockSize);
+  EXPECT_EQ(4, files.NumFetches("a"));
+
+  // A stale block drops and fetches again all blocks of the file, in every
+  // shard.
+  now += 1;
+  ExpectRead(cache, "a", content, 0, 4 * kBlockSize);
+  EXPECT_EQ(8, files.NumFetches("a"));
+  EXPECT_EQ(4 * kBlockSize, cache.CacheSize());
+}
+
+TEST(RamFileBlockCacheTest, INCONSISTENT_STATE) {
+  FakeFiles files;
+  files.Set("a", MakeContent(4 * kBlockSize, 'a'));
+  RamFileBlockCache cache(kBlockSize, 64 * kBlockSize, 0, files.Fetcher(),
+                          nullptr, 0, 1, 4);
+  TF_Status* status = TF_NewStatus();
+  char buffer[kBlockSize];
+  ASSERT_EQ(kBlockSize,
+            cache.Read("a", 2 * kBlockSize, kBlockSize, buffer, status));
+  ASSERT_EQ(TF_OK, TF_GetCode(status));
+
+  // The file shrinks behind the cache: block 1 is now partial, while block
+  // 2, possibly in another shard, is still cached.
+  files.Set("a", MakeContent(kBlockSize + 4, 'a'));
+  EXPECT_EQ(-1, cache.Read("a", kBlockSize, kBlockSize, buffer, status));
+  EXPECT_EQ(TF_INTERNAL, TF_GetCode(status));
+
+  // A new signature of the file drops its blocks, so its new content is
+  // read.
+  EXPECT_TRUE(cache.ValidateAndUpdateFileSignature("a", 1));
+  EXPECT_TRUE(cache.ValidateAndUpdateFileSignature("a", 1));
+  EXPECT_FALSE(cache.ValidateAndUpdateFileSignature("a", 2));
+  EXPECT_EQ(0, cache.CacheSize());
+  EXPECT_EQ(4, cache.Read("a", kBlockSize, kBlockSize, buffer, status));
+  EXPECT_EQ(TF_OK, TF_GetCode(status));
+  TF_DeleteStatus(status);
+}
+
+TEST(RamFileBlockCacheTest, CONCURRENT_READS) {
+  FakeFiles files;
+  std::vector<std::string> contents;
+  for (int i = 0; i < 4; ++i) {
+    contents.push_back(MakeContent(50 * kBlockSize + 7 * i, 'a' + i));
+    files.Set(std::to_string(i), contents.back());
+  }
+  // Small enough that the readers evict each other's blocks.
+  RamFileBlockCache cache(kBlockSize, 16 * kBlockSize, 0, files.Fetcher(),
+                          nullptr, 0, 1, 4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 200; ++i) {
+        int file = (t + i) % contents.size();
+        size_t offset = (i * 37 + t * 11) % contents[file].size();
+        size_t n = 1 + (i * 13) % (3 * kBlockSize);
+        ExpectRead(cache, std::to_string(file), contents[file], offset, n);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_LE(cache.CacheSize(), cache.max_bytes());
+}
+
+TEST(RamFileBlockCacheTest, PREFETCH_SEQUENTIAL_READS) {
+  FakeFiles files;
+  const std::string content = MakeContent(6 * kBlockSize + 3, 'a');
+  files.Set("a", content);
+  RamFileBlockCache cache(kBlockSize, 64 * kBlockSize, 0, files.Fetcher(),
+                          nullptr, 2, 2, 4);
+  for (size_t block = 0; block < 8; ++block) {
+    ExpectRead(cache, "a", content, block * kBlockSize, kBlockSize);
+  }
+  // Blocks prefetched ahead of the reader are not fetched by it again.
+  std::vector<size_t> fetches = files.Fetches("a");
+  std::sort(fetches.begin(), fetches.end());
+  EXPECT_EQ(fetches.end(), std::unique(fetches.begin(), fetches.end()));
+  for (size_t block = 0; block < 7; ++block) {
+    EXPECT_TRUE(std::binary_search(fetches.begin(), fetches.end(),
+                                   block * kBlockSize));
+  }
+
+  // A random read does not prefetch.
+  ExpectRead(cache, "b", "", 0, 1);
+  ExpectRead(cache, "b", "", 10 * kBlockSize, 1);
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_EQ(2, files.NumFetches("b"));
+}
+
+TEST(RamFileBlockCacheTest, MEMORY_BUDGET_ACCOUNTING) {
+  const std::string component = "ram_file_block_cache_test";
+  auto used = [&component] {
+    return MemoryBudget::Global()->usage()[component].bytes;
+  };
+  FakeFiles files;
+  const std::string content = MakeContent(10 * kBlockSize, 'a');
+  files.Set("a", content);
+  {
+    RamFileBlockCache cache(kBlockSize, 4 * kBlockSize, 0, files.Fetcher(),
+                            nullptr, 0, 1, 2);
+    cache.SetMemoryBudgetComponent(component);
+    ExpectRead(cache, "a", content, 0, 2 * kBlockSize);
+    EXPECT_EQ(2 * kBlockSize, used());
+    // Evicted blocks are released.
+    for (size_t block = 0; block < 10; ++block) {
+      ExpectRead(cache, "a", content, block * kBlockSize, kBlockSize);
+      EXPECT_EQ(cache.CacheSize(), used());
+    }
+    cache.RemoveFile("a");
+    EXPECT_EQ(0, used());
+    ExpectRead(cache, "a", content, 0, kBlockSize);
+    cache.Flush();
+    EXPECT_EQ(0, used());
+    ExpectRead(cache, "a", content, 0, kBlockSize);
+    EXPECT_EQ(kBlockSize, used());
+  }
+  // The cache releases its blocks once destroyed.
+  EXPECT_EQ(0, used());
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,187 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_io/core/filesystems/read_ahead.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "absl/synchronization/notification.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+
+namespace tensorflow {
+namespace io {
+
+// A range of the file fetched ahead of the readers. `data` is only written
+// by the fetch, and `read` and the status are valid once `done` is notified.
+struct ReadAhead::Window {
+  Window(uint64_t offset, uint64_t size, const std::string& memory_component)
+      : offset(offset), size(size), memory_component(memory_component) {}
+
+  ~Window() { MemoryBudget::Global()->Release(memory_component, size); }
+
+  const uint64_t offset;
+  const uint64_t size;
+  const std::string memory_component;
+  std::unique_ptr<char[]> data;
+  uint64_t read = 0;
+  TF_Code code = TF_OK;
+  std::string message;
+  absl::Notification done;
+};
+
+ReadAhead::ReadAhead(uint64_t min_size, uint64_t max_size, size_t max_windows,
+                     int sequential_reads,
+                     const std::string& memory_component, ReadFunc fetch_fn,
+                     ReadFunc read_fn, ScheduleFunc schedule_fn)
+    : min_size_(min_size),
+      max_size_(std::max(min_size, max_size)),
+      max_windows_(max_windows),
+      sequential_reads_(sequential_reads),
+      memory_component_(memory_component),
+      fetch_fn_(std::make_shared<const ReadFunc>(std::move(fetch_fn))),
+      read_fn_(std::move(read_fn)),
+      schedule_fn_(std::move(schedule_fn)),
+      window_size_(min_size) {}
+
+size_t ReadAhead::NumWindows() {
+  absl::MutexLock l(&mu_);
+  return windows_.size();
+}
+
+bool ReadAhead::StartReadLocked(uint64_t offset, size_t n) {
+  // Reads larger than a window are better served by one request.
+  if (n >= max_size_ || max_windows_ == 0 || min_size_ == 0) return false;
+  if (!windows_.empty() && offset >= windows_.front()->offset &&
+      offset < windows_.back()->offset + windows_.back()->size) {
+    next_offset_ = std::max<uint64_t>(next_offset_, offset + n);
+    return true;
+  }
+  sequential_count_ = offset == next_offset_ ? sequential_count_ + 1 : 0;
+  next_offset_ = offset + n;
+  if (sequential_count_ < sequential_reads_) return false;
+  // A new sequential stream, the windows fetched so far are of no use.
+  windows_.clear();
+  window_size_ = min_size_;
+  return true;
+}
+
+void ReadAhead::ScheduleLocked(uint64_t offset) {
+  while (windows_.size() < max_windows_) {
+    uint64_t start = offset;
+    if (!windows_.empty()) {
+      const auto& last = windows_.back();
+      // Nothing to fetch past the end of the file.
+      if (last->done.HasBeenNotified() && last->code == TF_OK &&
+          last->read < last->size)
+        return;
+      start = last->offset + last->size;
+    }
+    if (!MemoryBudget::Global()->TryReserve(memory_component_, window_size_))
+      return;
+    auto window =
+        std::make_shared<Window>(start, window_size_, memory_component_);
+    window->data.reset(new char[window->size]);
+    auto fetch_fn = fetch_fn_;
+    if (!schedule_fn_([fetch_fn, window]() {
+          TF_Status* status = TF_NewStatus();
+          auto read = (*fetch_fn)(window->offset, window->size,
+                                  window->data.get(), status);
+          // A short window marks the end of the file.
+          if (TF_GetCode(status) == TF_OK ||
+              TF_GetCode(status) == TF_OUT_OF_RANGE) {
+            window->read = std::max<int64_t>(read, 0);
+          } else {
+            window->code = TF_GetCode(status);
+            window->message = TF_Message(status);
+          }
+          TF_DeleteStatus(status);
+          window->done.Notify();
+        }))
+      return;
+    windows_.push_back(std::move(window));
+    window_size_ = std::min(window_size_ * 2, max_size_);
+  }
+}
+
+std::shared_ptr<ReadAhead::Window> ReadAhead::FindLocked(uint64_t offset) {
+  for (const auto& window : windows_) {
+    if (offset >= window->offset && offset < window->offset + window->size)
+      return window;
+  }
+  return nullptr;
+}
+
+int64_t ReadAhead::Read(uint64_t offset, size_t n, char* buffer,
+                        TF_Status* status) {
+  bool read_ahead;
+  {
+    absl::MutexLock l(&mu_);
+    read_ahead = StartReadLocked(offset, n);
+  }
+  if (!read_ahead) return read_fn_(offset, n, buffer, status);
+
+  size_t copied = 0;
+  bool eof = false;
+  while (copied < n && !eof) {
+    const uint64_t position = offset + copied;
+    std::shared_ptr<Window> window;
+    {
+      absl::MutexLock l(&mu_);
+      ScheduleLocked(position);
+      window = FindLocked(position);
+    }
+    // The window was consumed by another reader, or could not be scheduled.
+    if (window == nullptr) break;
+    window->done.WaitForNotification();
+    if (window->code != TF_OK) {
+      {
+        absl::MutexLock l(&mu_);
+        // Fetched again by the next read.
+        windows_.clear();
+      }
+      TF_SetStatus(status, window->code, window->message.c_str());
+      return -1;
+    }
+    const uint64_t end = window->offset + window->read;
+    if (position < end) {
+      size_t count = std::min<uint64_t>(end - position, n - copied);
+      memcpy(buffer + copied, window->data.get() + (position - window->offset),
+             count);
+      copied += count;
+    }
+    eof = window->read < window->size && offset + copied >= end;
+    absl::MutexLock l(&mu_);
+    while (!windows_.empty() &&
+           windows_.front()->offset + windows_.front()->size <=
+               offset + copied)
+      windows_.pop_front();
+  }
+
+  if (copied < n && !eof) {
+    auto read =
+        read_fn_(offset + copied, n - copied, buffer + copied, status);
+    if (read < 0) return -1;
+    return copied + read;
+  }
+  if (copied < n)
+    TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
+  else
+    TF_SetStatus(status, TF_OK, "");
+  return copied;
+}
+
+}  // namespace io
+}  // namespace tensorflow
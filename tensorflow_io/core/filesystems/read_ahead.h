@@ -0,0 +1,112 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_FILESYSTEMS_READ_AHEAD_H_
+#define TENSORFLOW_IO_CORE_FILESYSTEMS_READ_AHEAD_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/c/tf_status.h"
+
+namespace tensorflow {
+namespace io {
+
+// Sequential read-ahead of one random access file of a remote filesystem.
+//
+// Once the file has been read sequentially `sequential_reads` times,
+// `max_windows` contiguous windows past the read position are fetched in the
+// background. Every new window is twice the size of the previous one, up to
+// `max_size`. Reads that fall in the windows are served from them, so that
+// concurrent readers of one file at interleaved offsets share the windows
+// instead of resetting each other's. Other reads go straight to the file,
+// and drop the windows only once they form a new sequential stream.
+//
+// The memory of the windows is accounted to `memory_component` of
+// MemoryBudget::Global(), and no window is fetched while the budget is
+// exhausted.
+//
+// The lock of the read-ahead is not held while a reader waits for a window
+// or copies out of it, so concurrent reads only contend to find their
+// windows.
+class ReadAhead {
+ public:
+  // Reads `n` bytes at `offset` into `buffer`, and returns the number of
+  // bytes read. A short read at the end of the file sets `TF_OUT_OF_RANGE`,
+  // other errors return -1.
+  typedef std::function<int64_t(uint64_t offset, size_t n, char* buffer,
+                                TF_Status* status)>
+      ReadFunc;
+
+  // Runs `fn` in the background. Returns false if it could not.
+  typedef std::function<bool(std::function<void()> fn)> ScheduleFunc;
+
+  // Windows are fetched with `fetch_fn`, run by `schedule_fn`, and the reads
+  // not served by windows with `read_fn`. Functions and windows are shared
+  // with the fetches in flight, so the read-ahead may be destroyed before
+  // they complete.
+  ReadAhead(uint64_t min_size, uint64_t max_size, size_t max_windows,
+            int sequential_reads, const std::string& memory_component,
+            ReadFunc fetch_fn, ReadFunc read_fn, ScheduleFunc schedule_fn);
+
+  ReadAhead(const ReadAhead&) = delete;
+  ReadAhead& operator=(const ReadAhead&) = delete;
+
+  // Reads `n` bytes at `offset` into `buffer`, with the contract of
+  // `ReadFunc`. Safe to call concurrently.
+  int64_t Read(uint64_t offset, size_t n, char* buffer, TF_Status* status);
+
+  // The number of windows fetched or being fetched.
+  size_t NumWindows() ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Window;
+
+  // Updates the sequential state with a read, and returns whether it is to
+  // be served from the windows.
+  bool StartReadLocked(uint64_t offset, size_t n)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Keeps `max_windows_` windows in flight, the first one starting at
+  // `offset` if there are none.
+  void ScheduleLocked(uint64_t offset) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the window that holds `offset`, or nullptr.
+  std::shared_ptr<Window> FindLocked(uint64_t offset)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t min_size_;
+  const uint64_t max_size_;
+  const size_t max_windows_;
+  const int sequential_reads_;
+  const std::string memory_component_;
+  const std::shared_ptr<const ReadFunc> fetch_fn_;
+  const ReadFunc read_fn_;
+  const ScheduleFunc schedule_fn_;
+
+  absl::Mutex mu_;
+  uint64_t next_offset_ ABSL_GUARDED_BY(mu_) = 0;
+  int sequential_count_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t window_size_ ABSL_GUARDED_BY(mu_) = 0;
+  std::deque<std::shared_ptr<Window>> windows_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_FILESYSTEMS_READ_AHEAD_H_
@@ -0,0 +1,273 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow_io/core/filesystems/read_ahead.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+constexpr uint64_t kMinSize = 64;
+constexpr uint64_t kMaxSize = 256;
+constexpr size_t kWindows = 2;
+constexpr int kSequentialReads = 2;
+constexpr char kComponent[] = "read_ahead_test";
+
+// A file in memory, counting the reads of the read-ahead and the fetches of
+// its windows, and the threads that run the fetches.
+class FakeFile {
+ public:
+  explicit FakeFile(size_t size) : content_(size, '\0') {
+    for (size_t i = 0; i < size; ++i) content_[i] = static_cast<char>(i * 7);
+  }
+
+  ~FakeFile() {
+    for (auto& thread : threads_) thread.join();
+  }
+
+  std::unique_ptr<ReadAhead> NewReadAhead() {
+    return std::unique_ptr<ReadAhead>(new ReadAhead(
+        kMinSize, kMaxSize, kWindows, kSequentialReads, kComponent,
+        [this](uint64_t offset, size_t n, char* buffer, TF_Status* status) {
+          {
+            absl::MutexLock l(&mu_);
+            fetches_++;
+          }
+          absl::Notification* block = block_fetches_;
+          if (block != nullptr) block->WaitForNotification();
+          return ReadFile(offset, n, buffer, status, fetch_code_);
+        },
+        [this](uint64_t offset, size_t n, char* buffer, TF_Status* status) {
+          {
+            absl::MutexLock l(&mu_);
+            reads_++;
+          }
+          return ReadFile(offset, n, buffer, status, TF_OK);
+        },
+        [this](std::function<void()> fn) {
+          absl::MutexLock l(&mu_);
+          threads_.emplace_back(std::move(fn));
+          return true;
+        }));
+  }
+
+  std::string Content(uint64_t offset, size_t n) const {
+    if (offset >= content_.size()) return "";
+    return content_.substr(offset, n);
+  }
+
+  // Fails the fetches of windows with `code`.
+  void FailFetches(TF_Code code) { fetch_code_ = code; }
+
+  // Blocks the fetches of windows until `notification` is notified.
+  void BlockFetches(absl::Notification* notification) {
+    block_fetches_ = notification;
+  }
+
+  int fetches() {
+    absl::MutexLock l(&mu_);
+    return fetches_;
+  }
+
+  int reads() {
+    absl::MutexLock l(&mu_);
+    return reads_;
+  }
+
+ private:
+  int64_t ReadFile(uint64_t offset, size_t n, char* buffer, TF_Status* status,
+                   TF_Code code) {
+    if (code != TF_OK) {
+      TF_SetStatus(status, code, "fetch failed");
+      return -1;
+    }
+    std::string content = Content(offset, n);
+    memcpy(buffer, content.data(), content.size());
+    if (content.size() < n)
+      TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
+    else
+      TF_SetStatus(status, TF_OK, "");
+    return content.size();
+  }
+
+  std::string content_;
+  std::atomic<TF_Code> fetch_code_{TF_OK};
+  std::atomic<absl::Notification*> block_fetches_{nullptr};
+  absl::Mutex mu_;
+  int fetches_ ABSL_GUARDED_BY(mu_) = 0;
+  int reads_ ABSL_GUARDED_BY(mu_) = 0;
+  std::vector<std::thread> threads_ ABSL_GUARDED_BY(mu_);
+};
+
+// Reads `n` bytes at `offset` and expects them to match the file, and a
+// short read to set `TF_OUT_OF_RANGE`.
+void ExpectRead(FakeFile* file, ReadAhead* read_ahead, uint64_t offset,
+                size_t n) {
+  std::string expected = file->Content(offset, n);
+  std::vector<char> buffer(n);
+  TF_Status* status = TF_NewStatus();
+  int64_t read = read_ahead->Read(offset, n, buffer.data(), status);
+  EXPECT_EQ(expected.size(), read) << "offset " << offset;
+  EXPECT_EQ(expected.size() < n ? TF_OUT_OF_RANGE : TF_OK, TF_GetCode(status))
+      << TF_Message(status);
+  EXPECT_EQ(expected, std::string(buffer.data(), std::max<int64_t>(read, 0)));
+  TF_DeleteStatus(status);
+}
+
+TEST(ReadAheadTest, SEQUENTIAL_HITS) {
+  FakeFile file(4000);
+  auto read_ahead = file.NewReadAhead();
+  // The first read starts the sequential stream, the following ones are
+  // served from the windows, which double up to the maximum size.
+  for (uint64_t offset = 0; offset < 4000; offset += 50) {
+    ExpectRead(&file, read_ahead.get(), offset, 50);
+  }
+  ExpectRead(&file, read_ahead.get(), 4000, 50);
+  EXPECT_EQ(1, file.reads());
+  // Windows of 64, 128 and then 256 bytes up to the end.
+  EXPECT_GE(file.fetches(), 17);
+}
+
+TEST(ReadAheadTest, SHORT_READ_AT_END) {
+  FakeFile file(1000);
+  auto read_ahead = file.NewReadAhead();
+  for (uint64_t offset = 0; offset < 960; offset += 40) {
+    ExpectRead(&file, read_ahead.get(), offset, 40);
+  }
+  ExpectRead(&file, read_ahead.get(), 960, 100);
+  EXPECT_EQ(1, file.reads());
+}
+
+TEST(ReadAheadTest, RANDOM_ACCESS_FALLBACK) {
+  FakeFile file(4000);
+  auto read_ahead = file.NewReadAhead();
+  for (uint64_t offset : {3000, 100, 2000, 500, 3900}) {
+    ExpectRead(&file, read_ahead.get(), offset, 100);
+  }
+  EXPECT_EQ(5, file.reads());
+  EXPECT_EQ(0, file.fetches());
+  EXPECT_EQ(0, read_ahead->NumWindows());
+
+  // Reads larger than a window bypass them too.
+  ExpectRead(&file, read_ahead.get(), 0, kMaxSize);
+  ExpectRead(&file, read_ahead.get(), kMaxSize, kMaxSize);
+  ExpectRead(&file, read_ahead.get(), 2 * kMaxSize, kMaxSize);
+  EXPECT_EQ(8, file.reads());
+  EXPECT_EQ(0, file.fetches());
+}
+
+TEST(ReadAheadTest, RANDOM_READS_KEEP_WINDOWS) {
+  FakeFile file(4000);
+  auto read_ahead = file.NewReadAhead();
+  ExpectRead(&file, read_ahead.get(), 0, 10);
+  ExpectRead(&file, read_ahead.get(), 10, 10);
+  EXPECT_EQ(kWindows, read_ahead->NumWindows());
+  // A read elsewhere goes to the file, and leaves the windows of the
+  // sequential stream to it.
+  ExpectRead(&file, read_ahead.get(), 3000, 10);
+  EXPECT_EQ(2, file.reads());
+  EXPECT_EQ(kWindows, read_ahead->NumWindows());
+  ExpectRead(&file, read_ahead.get(), 20, 10);
+  EXPECT_EQ(2, file.reads());
+}
+
+TEST(ReadAheadTest, CONCURRENT_READERS) {
+  constexpr int kReaders = 4;
+  constexpr size_t kChunk = 16;
+  FakeFile file(8000);
+  auto read_ahead = file.NewReadAhead();
+  ExpectRead(&file, read_ahead.get(), 0, kChunk);
+  ExpectRead(&file, read_ahead.get(), kChunk, kChunk);
+  // The readers read interleaved chunks past the stream, e.g. the threads of
+  // a parallel reader of one file.
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&, i]() {
+      for (uint64_t offset = (2 + i) * kChunk; offset < 8000;
+           offset += kReaders * kChunk) {
+        ExpectRead(&file, read_ahead.get(), offset, kChunk);
+      }
+    });
+  }
+  for (auto& reader : readers) reader.join();
+  EXPECT_GT(file.fetches(), 0);
+  // Some chunks may be read from the file when another reader consumed
+  // their window first, but not all of them.
+  EXPECT_LT(file.reads(), 8000 / kChunk);
+}
+
+TEST(ReadAheadTest, READ_WHILE_WAITING) {
+  FakeFile file(4000);
+  absl::Notification release;
+  file.BlockFetches(&release);
+  auto read_ahead = file.NewReadAhead();
+  ExpectRead(&file, read_ahead.get(), 0, 10);
+  std::thread sequential(
+      [&]() { ExpectRead(&file, read_ahead.get(), 10, 10); });
+  while (file.fetches() == 0) std::this_thread::yield();
+  // The sequential reader waits for its window without holding the lock.
+  ExpectRead(&file, read_ahead.get(), 3000, 10);
+  EXPECT_EQ(2, file.reads());
+  release.Notify();
+  sequential.join();
+}
+
+TEST(ReadAheadTest, FETCH_ERROR) {
+  FakeFile file(4000);
+  file.FailFetches(TF_UNAVAILABLE);
+  auto read_ahead = file.NewReadAhead();
+  ExpectRead(&file, read_ahead.get(), 0, 10);
+  std::vector<char> buffer(10);
+  TF_Status* status = TF_NewStatus();
+  EXPECT_EQ(-1, read_ahead->Read(10, 10, buffer.data(), status));
+  EXPECT_EQ(TF_UNAVAILABLE, TF_GetCode(status));
+  TF_DeleteStatus(status);
+  EXPECT_EQ(0, read_ahead->NumWindows());
+
+  // The windows are fetched again once the errors stop.
+  file.FailFetches(TF_OK);
+  ExpectRead(&file, read_ahead.get(), 20, 10);
+  ExpectRead(&file, read_ahead.get(), 30, 10);
+  EXPECT_EQ(1, file.reads());
+}
+
+TEST(ReadAheadTest, MEMORY_BUDGET) {
+  {
+    FakeFile file(4000);
+    auto read_ahead = file.NewReadAhead();
+    ExpectRead(&file, read_ahead.get(), 0, 10);
+    ExpectRead(&file, read_ahead.get(), 10, 10);
+    EXPECT_EQ(kMinSize + 2 * kMinSize,
+              MemoryBudget::Global()->usage()[kComponent].bytes);
+  }
+  EXPECT_EQ(0, MemoryBudget::Global()->usage()[kComponent].bytes);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
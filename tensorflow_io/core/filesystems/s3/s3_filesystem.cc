@@ -25,20 +25,34 @@ limitations under the License.
 #include <aws/s3/model/CopyObjectRequest.h>
 #include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadBucketRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsV2Request.h>
+#include <aws/s3/model/PutObjectRequest.h>
 #include <aws/s3/model/UploadPartCopyRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <vector>
+
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
+#include "tensorflow_io/core/filesystems/glob_match.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+#include "tensorflow_io/core/filesystems/read_ahead.h"
 #include "tensorflow_io/core/filesystems/s3/aws_logging.h"
 
 namespace tensorflow {
@@ -49,7 +63,10 @@ namespace s3 {
 constexpr char kS3FileSystemAllocationTag[] = "S3FileSystemAllocation";
 constexpr char kS3ClientAllocationTag[] = "S3ClientAllocation";
 constexpr int64_t kS3TimeoutMsec = 300000;  // 5 min
-constexpr int kS3GetChildrenMaxKeys = 100;
+// The maximum number of keys of a ListObjectsV2 page and of a DeleteObjects
+// request.
+constexpr int kS3GetChildrenMaxKeys = 1000;
+constexpr int kS3DeleteObjectsMaxKeys = 1000;
 
 constexpr char kExecutorTag[] = "TransferManagerExecutorAllocation";
 constexpr int kExecutorPoolSize = 25;
@@ -58,9 +75,37 @@ constexpr uint64_t kS3MultiPartUploadChunkSize = 50 * 1024 * 1024;    // 50 MB
 constexpr uint64_t kS3MultiPartDownloadChunkSize = 50 * 1024 * 1024;  // 50 MB
 constexpr size_t kDownloadRetries = 3;
 constexpr size_t kUploadRetries = 3;
+// S3 rejects parts smaller than 5 MB, except for the last one.
+constexpr uint64_t kS3MultiPartUploadMinPartSize = 5 * 1024 * 1024;  // 5 MB
+constexpr size_t kS3StreamingUploadMaxPartsInFlight = 4;
+// A multipart copy has at most 10000 parts, each of at most 5 GB, which is
+// also the largest object a single CopyObject can copy.
+constexpr uint64_t kS3MultiPartCopyMaxParts = 10000;
+constexpr uint64_t kS3MultiPartCopyMaxPartSize =
+    5ULL * 1024 * 1024 * 1024;  // 5 GB
 
 constexpr size_t kS3ReadAppendableFileBufferSize = 1024 * 1024;  // 1 MB
 
+// The defaults of the read and stat caches follow the GCS filesystem: the
+// read cache is disabled, `Stat` results are kept for 5 seconds.
+constexpr size_t kS3ReadCacheBlockSizeMB = 64;
+constexpr size_t kS3ReadCacheMaxSizeMB = 0;
+constexpr uint64_t kS3ReadCacheMaxStaleness = 0;
+constexpr size_t kS3ReadCachePrefetchBlocks = 0;
+constexpr size_t kS3ReadCachePrefetchThreads = 4;
+constexpr size_t kS3ReadCacheShards = 1;
+constexpr uint64_t kS3StatCacheMaxAge = 5;
+constexpr size_t kS3StatCacheMaxEntries = 1024;
+
+// Read-ahead starts after this many consecutive sequential reads of a file,
+// with windows of 1 MB that double up to 32 MB. It is disabled unless
+// S3_READ_AHEAD_WINDOWS is set, since every open file may then hold that
+// many windows, e.g. 128 MB for 4 windows.
+constexpr int kS3ReadAheadSequentialReads = 2;
+constexpr uint64_t kS3ReadAheadMinSize = 1024 * 1024;       // 1 MB
+constexpr uint64_t kS3ReadAheadMaxSize = 32 * 1024 * 1024;  // 32 MB
+constexpr size_t kS3ReadAheadWindows = 0;
+
 static inline void TF_SetStatusFromAWSError(
     const Aws::Client::AWSError<Aws::S3::S3Errors>& error, TF_Status* status) {
   auto http_code = error.GetResponseCode();
@@ -225,6 +270,29 @@ static int GetExecutor(tf_s3_filesystem::S3File* s3_file) {
   return temp_value;
 }
 
+// Returns the integer value of the environment variable `name`, or
+// `default_value` if it is not set or not an integer.
+template <typename T>
+static T GetEnvOrDefault(const char* name, T default_value) {
+  T value;
+  const char* env = getenv(name);
+  if (env == nullptr || !absl::SimpleAtoi(env, &value)) return default_value;
+  return value;
+}
+
+// Drops the cached contents and `Stat` result of `path` after it has been
+// written or removed through this filesystem.
+static void InvalidateCaches(tf_s3_filesystem::S3File* s3_file,
+                             const std::string& path) {
+  if (s3_file->file_block_cache) s3_file->file_block_cache->RemoveFile(path);
+  if (s3_file->stat_cache) {
+    s3_file->stat_cache->Delete(path);
+    // Directories are stat'ed both with and without the trailing slash.
+    if (!path.empty() && path.back() == '/')
+      s3_file->stat_cache->Delete(path.substr(0, path.length() - 1));
+  }
+}
+
 static void GetTransferManager(
     const Aws::Transfer::TransferDirection& direction,
     tf_s3_filesystem::S3File* s3_file) {
@@ -253,8 +321,20 @@ static void GetTransferManager(
     Aws::Transfer::TransferManagerConfiguration config(s3_file->executor.get());
     config.s3Client = s3_file->s3_client;
     config.bufferSize = temp_value;
-    // must be larger than pool size * multi part chunk size
-    config.transferBufferMaxHeapSize = (executor_pool_size + 1) * temp_value;
+    // must be larger than pool size * multi part chunk size for every
+    // executor thread to transfer a part. The heap is accounted to the
+    // process-wide memory budget; if it does not fit, the TransferManager
+    // gets two buffers and its parts wait for them instead.
+    uint64_t heap_size = (executor_pool_size + 1) * temp_value;
+    MemoryBudget* budget = MemoryBudget::Global();
+    if (!budget->TryReserve("s3_transfer_manager", heap_size)) {
+      TF_VLog(1, "S3 TransferManager heap of %u bytes exceeds the budget\n",
+              heap_size);
+      heap_size = 2 * temp_value;
+      budget->Reserve("s3_transfer_manager", heap_size);
+    }
+    config.transferBufferMaxHeapSize = heap_size;
+    s3_file->transfer_manager_heap_size += heap_size;
     s3_file->transfer_managers.emplace(
         direction, Aws::Transfer::TransferManager::Create(config));
   }
@@ -269,6 +349,12 @@ typedef struct S3File {
   std::shared_ptr<Aws::S3::S3Client> s3_client;
   std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager;
   bool use_multi_part_download;
+  // The path the block cache is keyed by, and the cache of the filesystem.
+  // `file_block_cache` is nullptr if the cache is disabled.
+  std::string path;
+  RamFileBlockCache* file_block_cache;
+  // nullptr if read-ahead is disabled or the block cache is used.
+  std::shared_ptr<ReadAhead> read_ahead = nullptr;
 } S3File;
 
 // AWS Streams destroy the buffer (buf) passed, so creating a new
@@ -281,6 +367,25 @@ class TFS3UnderlyingStream : public Aws::IOStream {
   virtual ~TFS3UnderlyingStream() = default;
 };
 
+// A stream that writes into a buffer it does not own, through a stream
+// buffer of its own. The SDK takes a new stream from the response stream
+// factory for every attempt of a request and writes the body, or the error
+// of a failed attempt, into it, so every retry starts over at the start of
+// the buffer.
+class TFS3BufferStream : public Aws::IOStream {
+ public:
+  using Base = Aws::IOStream;
+  TFS3BufferStream(char* buffer, size_t n)
+      : Base(nullptr),
+        stream_buf_(reinterpret_cast<unsigned char*>(buffer), n) {
+    rdbuf(&stream_buf_);
+  }
+  virtual ~TFS3BufferStream() = default;
+
+ private:
+  Aws::Utils::Stream::PreallocatedStreamBuf stream_buf_;
+};
+
 void Cleanup(TF_RandomAccessFile* file) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
   delete s3_file;
@@ -294,8 +399,11 @@ static int64_t ReadS3Client(S3File* s3_file, uint64_t offset, size_t n,
   Aws::String bytes =
       absl::StrCat("bytes=", offset, "-", offset + n - 1).c_str();
   get_object_request.SetRange(bytes);
-  get_object_request.SetResponseStreamFactory(
-      []() { return Aws::New<Aws::StringStream>(kS3FileSystemAllocationTag); });
+  // The body is written straight into the caller's buffer, instead of a
+  // heap allocated string stream that is copied out afterwards.
+  get_object_request.SetResponseStreamFactory([buffer, n]() {
+    return Aws::New<TFS3BufferStream>(kS3FileSystemAllocationTag, buffer, n);
+  });
 
   auto get_object_outcome = s3_file->s3_client->GetObject(get_object_request);
   if (!get_object_outcome.IsSuccess())
@@ -308,7 +416,6 @@ static int64_t ReadS3Client(S3File* s3_file, uint64_t offset, size_t n,
   int64_t read = get_object_outcome.GetResult().GetContentLength();
   if (read < n)
     TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
-  get_object_outcome.GetResult().GetBody().read(buffer, read);
   return read;
 }
 
@@ -331,6 +438,7 @@ static int64_t ReadS3TransferManager(S3File* s3_file, uint64_t offset, size_t n,
              Aws::Http::HttpResponseCode::REQUESTED_RANGE_NOT_SATISFIABLE &&
          retries++ < kDownloadRetries) {
     // Only failed parts will be downloaded again.
+    RecordFilesystemRetry("s3", "read");
     TF_VLog(
         1,
         "Retrying read of s3://%s/%s after failure. Current retry count: %u\n",
@@ -351,15 +459,33 @@ static int64_t ReadS3TransferManager(S3File* s3_file, uint64_t offset, size_t n,
   return read;
 }
 
+// Reads from S3 bypassing the block cache. Sets `TF_OUT_OF_RANGE` if fewer
+// than `n` bytes are read.
+static int64_t ReadUncached(S3File* s3_file, uint64_t offset, size_t n,
+                            char* buffer, TF_Status* status) {
+  if (s3_file->use_multi_part_download)
+    return ReadS3TransferManager(s3_file, offset, n, buffer, status);
+  else
+    return ReadS3Client(s3_file, offset, n, buffer, status);
+}
+
 int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
              char* buffer, TF_Status* status) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
   TF_VLog(1, "ReadFilefromS3 s3://%s/%s from %u for n: %u\n",
           s3_file->bucket.c_str(), s3_file->object.c_str(), offset, n);
-  if (s3_file->use_multi_part_download)
-    return ReadS3TransferManager(s3_file, offset, n, buffer, status);
-  else
-    return ReadS3Client(s3_file, offset, n, buffer, status);
+  FilesystemRequest request("s3", "read", status);
+  if (s3_file->read_ahead != nullptr)
+    return request.Bytes(s3_file->read_ahead->Read(offset, n, buffer, status));
+  if (s3_file->file_block_cache == nullptr)
+    return request.Bytes(ReadUncached(s3_file, offset, n, buffer, status));
+
+  int64_t read = s3_file->file_block_cache->Read(s3_file->path, offset, n,
+                                                 buffer, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  if (read < n)
+    TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
+  return request.Bytes(read);
 }
 
 }  // namespace tf_random_access_file
@@ -367,43 +493,322 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
 // SECTION 2. Implementation for `TF_WritableFile`
 // ----------------------------------------------------------------------------
 namespace tf_writable_file {
+// State of a streaming upload. Instead of staging the whole file on local
+// disk until `Sync`, a part of a multipart upload is sent as soon as
+// `part_size` bytes have been appended. At most `max_parts_in_flight` parts
+// are buffered in memory while they are uploaded concurrently, `Append`
+// waits for one of them to finish otherwise. The object only appears on
+// `Close`; `Sync` and `Flush` upload nothing but report failed parts.
+typedef struct StreamingUpload {
+  uint64_t part_size;
+  size_t max_parts_in_flight;
+  // The part that is appended to, and the size of the file so far.
+  std::shared_ptr<std::string> part;
+  uint64_t position = 0;
+  int next_part_number = 1;
+  // Empty until the first part is sent, and again once it is completed.
+  Aws::String upload_id;
+  bool closed = false;
+  // Updated by the callbacks of the parts.
+  absl::Mutex mu;
+  absl::CondVar cv;
+  size_t parts_in_flight ABSL_GUARDED_BY(mu) = 0;
+  std::map<int, Aws::String> etags ABSL_GUARDED_BY(mu);
+  TF_Code code ABSL_GUARDED_BY(mu) = TF_OK;
+  std::string message ABSL_GUARDED_BY(mu);
+} StreamingUpload;
+
+typedef struct UploadPartAsyncContext
+    : public Aws::Client::AsyncCallerContext {
+  std::shared_ptr<StreamingUpload> upload;
+  std::shared_ptr<std::string> data;
+  // The body of the request reads the part in place.
+  std::shared_ptr<Aws::Utils::Stream::PreallocatedStreamBuf> stream_buf;
+  int part_number;
+  size_t retries;
+} UploadPartAsyncContext;
+
+static void UploadPartAsync(const Aws::S3::S3Client* s3_client,
+                            const Aws::String& bucket,
+                            const Aws::String& object,
+                            std::shared_ptr<StreamingUpload> upload,
+                            std::shared_ptr<std::string> data,
+                            int part_number, size_t retries);
+
+static void UploadPartCallback(
+    const Aws::S3::S3Client* s3_client,
+    const Aws::S3::Model::UploadPartRequest& request,
+    const Aws::S3::Model::UploadPartOutcome& outcome,
+    const std::shared_ptr<const UploadPartAsyncContext>& context) {
+  auto upload = context->upload;
+  if (!outcome.IsSuccess() && context->retries < kUploadRetries) {
+    RecordFilesystemRetry("s3", "sync");
+    TF_VLog(1,
+            "Retrying upload of part %d of s3://%s/%s after failure. Current "
+            "retry count: %u\n",
+            context->part_number, request.GetBucket().c_str(),
+            request.GetKey().c_str(), context->retries + 1);
+    return UploadPartAsync(s3_client, request.GetBucket(), request.GetKey(),
+                           upload, context->data, context->part_number,
+                           context->retries + 1);
+  }
+  absl::MutexLock l(&upload->mu);
+  if (outcome.IsSuccess()) {
+    upload->etags[context->part_number] = outcome.GetResult().GetETag();
+  } else if (upload->code == TF_OK) {
+    TF_Status* status = TF_NewStatus();
+    TF_SetStatusFromAWSError(outcome.GetError(), status);
+    upload->code = TF_GetCode(status);
+    upload->message = TF_Message(status);
+    TF_DeleteStatus(status);
+  }
+  upload->parts_in_flight--;
+  upload->cv.SignalAll();
+}
+
+static void UploadPartAsync(const Aws::S3::S3Client* s3_client,
+                            const Aws::String& bucket,
+                            const Aws::String& object,
+                            std::shared_ptr<StreamingUpload> upload,
+                            std::shared_ptr<std::string> data,
+                            int part_number, size_t retries) {
+  auto context =
+      Aws::MakeShared<UploadPartAsyncContext>("UploadPartAsyncContext");
+  context->stream_buf =
+      Aws::MakeShared<Aws::Utils::Stream::PreallocatedStreamBuf>(
+          "S3StreamBuf", reinterpret_cast<unsigned char*>(&(*data)[0]),
+          data->size());
+  context->upload = upload;
+  context->data = data;
+  context->part_number = part_number;
+  context->retries = retries;
+
+  Aws::S3::Model::UploadPartRequest request;
+  request.WithBucket(bucket)
+      .WithKey(object)
+      .WithPartNumber(part_number)
+      .WithUploadId(upload->upload_id)
+      .WithContentLength(data->size());
+  request.SetBody(Aws::MakeShared<tf_random_access_file::TFS3UnderlyingStream>(
+      "S3UploadStream", context->stream_buf.get()));
+  auto callback =
+      [](const Aws::S3::S3Client* client,
+         const Aws::S3::Model::UploadPartRequest& request,
+         const Aws::S3::Model::UploadPartOutcome& outcome,
+         const std::shared_ptr<const Aws::Client::AsyncCallerContext>&
+             context) {
+        UploadPartCallback(
+            client, request, outcome,
+            std::static_pointer_cast<const UploadPartAsyncContext>(context));
+      };
+  s3_client->UploadPartAsync(request, callback, context);
+}
+
+// Waits until at most `max_parts` parts are in flight, or one of them
+// failed, and sets `status` to the error of the failed part.
+static void WaitForParts(StreamingUpload* upload, size_t max_parts,
+                         TF_Status* status) {
+  absl::MutexLock l(&upload->mu);
+  while (upload->code == TF_OK && upload->parts_in_flight > max_parts)
+    upload->cv.Wait(&upload->mu);
+  TF_SetStatus(status, upload->code, upload->message.c_str());
+}
+
 typedef struct S3File {
   Aws::String bucket;
   Aws::String object;
   std::shared_ptr<Aws::S3::S3Client> s3_client;
   std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager;
   bool sync_needed;
+  // nullptr in streaming mode.
   std::shared_ptr<Aws::Utils::TempFile> outfile;
+  // The filesystem, whose caches are invalidated after every upload.
+  tf_s3_filesystem::S3File* filesystem;
+  // nullptr unless the file is uploaded while it is written.
+  std::shared_ptr<StreamingUpload> streaming_upload;
   S3File(Aws::String bucket, Aws::String object,
          std::shared_ptr<Aws::S3::S3Client> s3_client,
-         std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager)
+         std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager,
+         tf_s3_filesystem::S3File* filesystem,
+         std::shared_ptr<StreamingUpload> streaming_upload)
       : bucket(bucket),
         object(object),
         s3_client(s3_client),
         transfer_manager(transfer_manager),
-        outfile(Aws::MakeShared<Aws::Utils::TempFile>(
-            kS3FileSystemAllocationTag,
+        outfile(streaming_upload ? nullptr : NewTempFile()),
+        filesystem(filesystem),
+        streaming_upload(streaming_upload) {}
+
+  static std::shared_ptr<Aws::Utils::TempFile> NewTempFile() {
+    return Aws::MakeShared<Aws::Utils::TempFile>(
+        kS3FileSystemAllocationTag,
 #if defined(_MSC_VER)
-            // On Windows, `Aws::FileSystem::CreateTempFilePath()` return
-            // `C:\Users\username\AppData\Local\Temp\`. Adding template will
-            // cause an error.
-            nullptr,
+        // On Windows, `Aws::FileSystem::CreateTempFilePath()` return
+        // `C:\Users\username\AppData\Local\Temp\`. Adding template will
+        // cause an error.
+        nullptr,
 #else
-            "/tmp/_s3_filesystem_XXXXXX",
+        "/tmp/_s3_filesystem_XXXXXX",
 #endif
-            std::ios_base::binary | std::ios_base::trunc | std::ios_base::in |
-                std::ios_base::out)) {
+        std::ios_base::binary | std::ios_base::trunc | std::ios_base::in |
+            std::ios_base::out);
   }
 } S3File;
 
+static void AbortStreamingUpload(S3File* s3_file, TF_Status* status) {
+  Aws::S3::Model::AbortMultipartUploadRequest request;
+  request.WithBucket(s3_file->bucket)
+      .WithKey(s3_file->object)
+      .WithUploadId(s3_file->streaming_upload->upload_id);
+  auto outcome = s3_file->s3_client->AbortMultipartUpload(request);
+  s3_file->streaming_upload->upload_id.clear();
+  if (!outcome.IsSuccess())
+    TF_SetStatusFromAWSError(outcome.GetError(), status);
+  else
+    TF_SetStatus(status, TF_OK, "");
+}
+
+// Sends the current part of a streaming upload, creating the multipart
+// upload first if needed.
+static void UploadStreamingPart(S3File* s3_file, TF_Status* status) {
+  auto upload = s3_file->streaming_upload;
+  if (upload->upload_id.empty()) {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.WithBucket(s3_file->bucket)
+        .WithKey(s3_file->object)
+        .WithContentType("application/octet-stream");
+    auto outcome = s3_file->s3_client->CreateMultipartUpload(request);
+    if (!outcome.IsSuccess())
+      return TF_SetStatusFromAWSError(outcome.GetError(), status);
+    upload->upload_id = outcome.GetResult().GetUploadId();
+  }
+  WaitForParts(upload.get(), upload->max_parts_in_flight - 1, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  {
+    absl::MutexLock l(&upload->mu);
+    upload->parts_in_flight++;
+  }
+  UploadPartAsync(s3_file->s3_client.get(), s3_file->bucket, s3_file->object,
+                  upload, std::move(upload->part),
+                  upload->next_part_number++, 0);
+  // The file is at least a part large, the next part will be full too.
+  upload->part = std::make_shared<std::string>();
+  upload->part->reserve(upload->part_size);
+}
+
+static void AppendStreaming(S3File* s3_file, const char* buffer, size_t n,
+                            TF_Status* status) {
+  auto upload = s3_file->streaming_upload;
+  if (upload->closed)
+    return TF_SetStatus(status, TF_FAILED_PRECONDITION,
+                        "The file has been closed.");
+  while (n > 0) {
+    size_t count =
+        std::min<uint64_t>(n, upload->part_size - upload->part->size());
+    upload->part->append(buffer, count);
+    upload->position += count;
+    buffer += count;
+    n -= count;
+    if (upload->part->size() == upload->part_size) {
+      UploadStreamingPart(s3_file, status);
+      if (TF_GetCode(status) != TF_OK) return;
+    }
+  }
+  TF_SetStatus(status, TF_OK, "");
+}
+
+// Completes a streaming upload. Files smaller than a part are uploaded with a
+// single PutObject.
+static void CloseStreaming(S3File* s3_file, TF_Status* status) {
+  auto upload = s3_file->streaming_upload;
+  if (upload->closed) return TF_SetStatus(status, TF_OK, "");
+  upload->closed = true;
+  TF_VLog(1, "WriteFileToS3: s3://%s/%s\n", s3_file->bucket.c_str(),
+          s3_file->object.c_str());
+
+  if (upload->upload_id.empty()) {
+    auto& data = *upload->part;
+    size_t retries = 0;
+    while (true) {
+      Aws::Utils::Stream::PreallocatedStreamBuf stream_buf(
+          reinterpret_cast<unsigned char*>(&data[0]), data.size());
+      Aws::S3::Model::PutObjectRequest request;
+      request.WithBucket(s3_file->bucket)
+          .WithKey(s3_file->object)
+          .WithContentType("application/octet-stream")
+          .WithContentLength(data.size());
+      request.SetBody(
+          Aws::MakeShared<tf_random_access_file::TFS3UnderlyingStream>(
+              "S3UploadStream", &stream_buf));
+      auto outcome = s3_file->s3_client->PutObject(request);
+      if (outcome.IsSuccess()) break;
+      if (retries++ >= kUploadRetries)
+        return TF_SetStatusFromAWSError(outcome.GetError(), status);
+    }
+  } else {
+    if (!upload->part->empty()) {
+      UploadStreamingPart(s3_file, status);
+      if (TF_GetCode(status) != TF_OK) return;
+    }
+    WaitForParts(upload.get(), 0, status);
+    if (TF_GetCode(status) != TF_OK) {
+      TF_Status* abort_status = TF_NewStatus();
+      AbortStreamingUpload(s3_file, abort_status);
+      TF_DeleteStatus(abort_status);
+      return;
+    }
+
+    Aws::S3::Model::CompletedMultipartUpload completed_multipart_upload;
+    {
+      absl::MutexLock l(&upload->mu);
+      for (const auto& etag : upload->etags) {
+        Aws::S3::Model::CompletedPart completed_part;
+        completed_part.SetPartNumber(etag.first);
+        completed_part.SetETag(etag.second);
+        completed_multipart_upload.AddParts(completed_part);
+      }
+    }
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.WithBucket(s3_file->bucket)
+        .WithKey(s3_file->object)
+        .WithUploadId(upload->upload_id)
+        .WithMultipartUpload(completed_multipart_upload);
+    auto outcome = s3_file->s3_client->CompleteMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      TF_SetStatusFromAWSError(outcome.GetError(), status);
+      TF_Status* abort_status = TF_NewStatus();
+      AbortStreamingUpload(s3_file, abort_status);
+      TF_DeleteStatus(abort_status);
+      return;
+    }
+    upload->upload_id.clear();
+  }
+  upload->part.reset();
+  InvalidateCaches(
+      s3_file->filesystem,
+      absl::StrCat("s3://", s3_file->bucket, "/", s3_file->object));
+  TF_SetStatus(status, TF_OK, "");
+}
+
 void Cleanup(TF_WritableFile* file) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
+  // A streaming upload that was not completed must not linger in the bucket.
+  if (s3_file->streaming_upload &&
+      !s3_file->streaming_upload->upload_id.empty()) {
+    TF_Status* status = TF_NewStatus();
+    AbortStreamingUpload(s3_file, status);
+    TF_DeleteStatus(status);
+  }
   delete s3_file;
 }
 
 void Append(const TF_WritableFile* file, const char* buffer, size_t n,
             TF_Status* status) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
+  FilesystemRequest request("s3", "write", status);
+  request.Bytes(n);
+  if (s3_file->streaming_upload)
+    return AppendStreaming(s3_file, buffer, n, status);
   if (!s3_file->outfile) {
     TF_SetStatus(status, TF_FAILED_PRECONDITION,
                  "The internal temporary file is not writable.");
@@ -420,6 +825,10 @@ void Append(const TF_WritableFile* file, const char* buffer, size_t n,
 
 int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
+  if (s3_file->streaming_upload) {
+    TF_SetStatus(status, TF_OK, "");
+    return s3_file->streaming_upload->position;
+  }
   auto position = static_cast<int64_t>(s3_file->outfile->tellp());
   if (position == -1)
     TF_SetStatus(status, TF_INTERNAL,
@@ -431,6 +840,10 @@ int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
 
 void Sync(const TF_WritableFile* file, TF_Status* status) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
+  FilesystemRequest request("s3", "sync", status);
+  if (s3_file->streaming_upload)
+    return WaitForParts(s3_file->streaming_upload.get(),
+                        std::numeric_limits<size_t>::max(), status);
   if (!s3_file->outfile) {
     TF_SetStatus(status, TF_FAILED_PRECONDITION,
                  "The internal temporary file is not writable.");
@@ -454,6 +867,7 @@ void Sync(const TF_WritableFile* file, TF_Status* status) {
   while (handle->GetStatus() == Aws::Transfer::TransferStatus::FAILED &&
          retries++ < kUploadRetries) {
     // if multipart upload was used, only the failed parts will be re-sent
+    RecordFilesystemRetry("s3", "sync");
     TF_VLog(1,
             "Retrying upload of s3://%s/%s after failure. Current retry count: "
             "%u\n",
@@ -463,6 +877,9 @@ void Sync(const TF_WritableFile* file, TF_Status* status) {
   }
   if (handle->GetStatus() != Aws::Transfer::TransferStatus::COMPLETED)
     return TF_SetStatusFromAWSError(handle->GetLastError(), status);
+  InvalidateCaches(
+      s3_file->filesystem,
+      absl::StrCat("s3://", s3_file->bucket, "/", s3_file->object));
   s3_file->outfile->clear();
   s3_file->outfile->seekp(position);
   s3_file->sync_needed = false;
@@ -475,6 +892,10 @@ void Flush(const TF_WritableFile* file, TF_Status* status) {
 
 void Close(const TF_WritableFile* file, TF_Status* status) {
   auto s3_file = static_cast<S3File*>(file->plugin_file);
+  if (s3_file->streaming_upload) {
+    FilesystemRequest request("s3", "sync", status);
+    return CloseStreaming(s3_file, status);
+  }
   if (s3_file->outfile) {
     Sync(file, status);
     if (TF_GetCode(status) != TF_OK) return;
@@ -519,14 +940,98 @@ S3File::S3File()
       transfer_managers(),
       multi_part_chunk_sizes(),
       use_multi_part_download(true),
+      file_block_cache(nullptr),
+      stat_cache(nullptr),
+      read_ahead_min_size(kS3ReadAheadMinSize),
+      read_ahead_max_size(kS3ReadAheadMaxSize),
+      read_ahead_windows(kS3ReadAheadWindows),
+      use_streaming_upload(false),
+      streaming_upload_max_parts_in_flight(kS3StreamingUploadMaxPartsInFlight),
+      transfer_manager_heap_size(0),
       initialization_lock() {}
+
+// Fetches a block of the read cache, `path` is the full `s3://` path.
+static int64_t LoadBufferFromS3(S3File* s3_file, const std::string& path,
+                                size_t offset, size_t n, char* buffer,
+                                TF_Status* status) {
+  Aws::String bucket, object;
+  ParseS3Path(path.c_str(), false, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  GetS3Client(s3_file);
+  GetTransferManager(Aws::Transfer::TransferDirection::DOWNLOAD, s3_file);
+  tf_random_access_file::S3File file(
+      {bucket, object, s3_file->s3_client,
+       s3_file->transfer_managers[Aws::Transfer::TransferDirection::DOWNLOAD],
+       s3_file->use_multi_part_download, path, nullptr});
+  auto read =
+      tf_random_access_file::ReadUncached(&file, offset, n, buffer, status);
+  // A short block at the end of the object is not an error for the cache.
+  if (TF_GetCode(status) == TF_OUT_OF_RANGE) TF_SetStatus(status, TF_OK, "");
+  return read;
+}
+
 void Init(TF_Filesystem* filesystem, TF_Status* status) {
-  filesystem->plugin_filesystem = new S3File();
+  auto s3_file = new S3File();
+  filesystem->plugin_filesystem = s3_file;
+
+  size_t block_size = GetEnvOrDefault("S3_READ_CACHE_BLOCK_SIZE_MB",
+                                      kS3ReadCacheBlockSizeMB) *
+                      1024 * 1024;
+  size_t max_bytes =
+      GetEnvOrDefault("S3_READ_CACHE_MAX_SIZE_MB", kS3ReadCacheMaxSizeMB) *
+      1024 * 1024;
+  uint64_t max_staleness = GetEnvOrDefault("S3_READ_CACHE_MAX_STALENESS",
+                                           kS3ReadCacheMaxStaleness);
+  size_t prefetch_blocks = GetEnvOrDefault("S3_READ_CACHE_PREFETCH_BLOCKS",
+                                           kS3ReadCachePrefetchBlocks);
+  size_t prefetch_threads = GetEnvOrDefault("S3_READ_CACHE_PREFETCH_THREADS",
+                                            kS3ReadCachePrefetchThreads);
+  size_t shards = GetEnvOrDefault("S3_READ_CACHE_SHARDS", kS3ReadCacheShards);
+  s3_file->file_block_cache = std::make_unique<RamFileBlockCache>(
+      block_size, max_bytes, max_staleness,
+      [s3_file](const std::string& path, size_t offset, size_t n,
+                char* buffer, TF_Status* status) {
+        return LoadBufferFromS3(s3_file, path, offset, n, buffer, status);
+      },
+      nullptr, prefetch_blocks, prefetch_threads, shards);
+  s3_file->file_block_cache->SetLookupObserver(
+      [](bool hit) { RecordCacheLookup("s3", "block", hit); });
+  TF_VLog(1,
+          "S3 read cache block size: %u, max size: %u, max staleness: %u, "
+          "shards: %u\n",
+          block_size, max_bytes, max_staleness,
+          s3_file->file_block_cache->num_shards());
+  s3_file->file_block_cache->SetMemoryBudgetComponent("s3_block_cache");
+
+  uint64_t stat_cache_max_age =
+      GetEnvOrDefault("S3_STAT_CACHE_MAX_AGE", kS3StatCacheMaxAge);
+  size_t stat_cache_max_entries =
+      GetEnvOrDefault("S3_STAT_CACHE_MAX_ENTRIES", kS3StatCacheMaxEntries);
+  s3_file->stat_cache = std::make_unique<ExpiringLRUCache<TF_FileStatistics>>(
+      stat_cache_max_age, stat_cache_max_entries);
+  s3_file->stat_cache->SetLookupObserver(
+      [](bool hit) { RecordCacheLookup("s3", "stat", hit); });
+
+  s3_file->read_ahead_min_size =
+      GetEnvOrDefault("S3_READ_AHEAD_MIN_SIZE", kS3ReadAheadMinSize);
+  s3_file->read_ahead_max_size =
+      std::max(s3_file->read_ahead_min_size,
+               GetEnvOrDefault("S3_READ_AHEAD_MAX_SIZE", kS3ReadAheadMaxSize));
+  s3_file->read_ahead_windows =
+      GetEnvOrDefault("S3_READ_AHEAD_WINDOWS", kS3ReadAheadWindows);
+
+  s3_file->use_streaming_upload =
+      GetEnvOrDefault("S3_STREAMING_UPLOAD", 0) == 1;
+  s3_file->streaming_upload_max_parts_in_flight =
+      GetEnvOrDefault("S3_STREAMING_UPLOAD_MAX_PARTS_IN_FLIGHT",
+                      kS3StreamingUploadMaxPartsInFlight);
   TF_SetStatus(status, TF_OK, "");
 }
 
 void Cleanup(TF_Filesystem* filesystem) {
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  MemoryBudget::Global()->Release("s3_transfer_manager",
+                                  s3_file->transfer_manager_heap_size);
   delete s3_file;
 }
 
@@ -539,13 +1044,72 @@ void NewRandomAccessFile(const TF_Filesystem* filesystem, const char* path,
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetS3Client(s3_file);
   GetTransferManager(Aws::Transfer::TransferDirection::DOWNLOAD, s3_file);
-  file->plugin_file = new tf_random_access_file::S3File(
+  RamFileBlockCache* file_block_cache = nullptr;
+  if (s3_file->file_block_cache->IsCacheEnabled()) {
+    file_block_cache = s3_file->file_block_cache.get();
+    // Blocks cached for an older version of the object are dropped. S3 has
+    // no generation number like GCS, so the signature is derived from the
+    // modification time and the size. Errors are left to the first read.
+    TF_FileStatistics stats;
+    Stat(filesystem, path, &stats, status);
+    if (TF_GetCode(status) == TF_OK &&
+        !file_block_cache->ValidateAndUpdateFileSignature(
+            path, stats.mtime_nsec ^ (stats.length << 1)))
+      TF_VLog(1, "Object %s changed, dropped its cached blocks\n", path);
+  }
+  auto random_access_file = new tf_random_access_file::S3File(
       {bucket, object, s3_file->s3_client,
        s3_file->transfer_managers[Aws::Transfer::TransferDirection::DOWNLOAD],
-       s3_file->use_multi_part_download});
+       s3_file->use_multi_part_download, path, file_block_cache});
+  if (file_block_cache == nullptr && s3_file->read_ahead_windows > 0 &&
+      s3_file->read_ahead_min_size > 0) {
+    // Windows are fetched with single ranged GETs, since a fetch runs on the
+    // executor of the TransferManager and must not wait for parts queued
+    // behind it.
+    tf_random_access_file::S3File fetch_file(
+        {bucket, object, s3_file->s3_client, nullptr, false, "", nullptr});
+    tf_random_access_file::S3File read_file(
+        {bucket, object, s3_file->s3_client,
+         random_access_file->transfer_manager,
+         random_access_file->use_multi_part_download, "", nullptr});
+    auto executor = s3_file->executor;
+    random_access_file->read_ahead = std::make_shared<ReadAhead>(
+        s3_file->read_ahead_min_size, s3_file->read_ahead_max_size,
+        s3_file->read_ahead_windows, kS3ReadAheadSequentialReads,
+        "s3_read_ahead",
+        [fetch_file](uint64_t offset, size_t n, char* buffer,
+                     TF_Status* status) mutable {
+          return tf_random_access_file::ReadS3Client(&fetch_file, offset, n,
+                                                     buffer, status);
+        },
+        [read_file](uint64_t offset, size_t n, char* buffer,
+                    TF_Status* status) mutable {
+          return tf_random_access_file::ReadUncached(&read_file, offset, n,
+                                                     buffer, status);
+        },
+        [executor](std::function<void()> fn) {
+          return executor->Submit(std::move(fn));
+        });
+  }
+  file->plugin_file = random_access_file;
   TF_SetStatus(status, TF_OK, "");
 }
 
+// Returns the state of a streaming upload if they are enabled, nullptr
+// otherwise. Requires the upload TransferManager to be set up.
+static std::shared_ptr<tf_writable_file::StreamingUpload> NewStreamingUpload(
+    S3File* s3_file) {
+  if (!s3_file->use_streaming_upload) return nullptr;
+  auto upload = std::make_shared<tf_writable_file::StreamingUpload>();
+  auto chunk_size =
+      s3_file->multi_part_chunk_sizes[Aws::Transfer::TransferDirection::UPLOAD];
+  upload->part_size = std::max(kS3MultiPartUploadMinPartSize, chunk_size);
+  upload->max_parts_in_flight =
+      std::max<size_t>(1, s3_file->streaming_upload_max_parts_in_flight);
+  upload->part = std::make_shared<std::string>();
+  return upload;
+}
+
 void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
                      TF_WritableFile* file, TF_Status* status) {
   Aws::String bucket, object;
@@ -557,7 +1121,8 @@ void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD, s3_file);
   file->plugin_file = new tf_writable_file::S3File(
       bucket, object, s3_file->s3_client,
-      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD]);
+      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD],
+      s3_file, NewStreamingUpload(s3_file));
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -583,7 +1148,8 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
       });
   writer->plugin_file = new tf_writable_file::S3File(
       bucket, object, s3_file->s3_client,
-      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD]);
+      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD],
+      s3_file, NewStreamingUpload(s3_file));
   TF_SetStatus(status, TF_OK, "");
 
   // Wraping inside a `std::unique_ptr` to prevent memory-leaking.
@@ -626,8 +1192,8 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
-void Stat(const TF_Filesystem* filesystem, const char* path,
-          TF_FileStatistics* stats, TF_Status* status) {
+static void StatS3(const TF_Filesystem* filesystem, const char* path,
+                   TF_FileStatistics* stats, TF_Status* status) {
   TF_VLog(1, "Stat on path: %s\n", path);
   Aws::String bucket, object;
   ParseS3Path(path, true, &bucket, &object, status);
@@ -695,6 +1261,19 @@ void Stat(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
+void Stat(const TF_Filesystem* filesystem, const char* path,
+          TF_FileStatistics* stats, TF_Status* status) {
+  auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  FilesystemRequest request("s3", "stat", status);
+  s3_file->stat_cache->LookupOrCompute(
+      path, stats,
+      [filesystem](const std::string& path, TF_FileStatistics* stats,
+                   TF_Status* status) {
+        StatS3(filesystem, path.c_str(), stats, status);
+      },
+      status);
+}
+
 void PathExists(const TF_Filesystem* filesystem, const char* path,
                 TF_Status* status) {
   TF_FileStatistics stats;
@@ -749,6 +1328,26 @@ void NewReadOnlyMemoryRegionFromFile(const TF_Filesystem* filesystem,
   TF_SetStatus(status, TF_OK, "");
 }
 
+// Runs `fn(i)` for every `i` in `[0, n)` on the executor of the filesystem
+// and waits for all of them.
+static void ParallelFor(S3File* s3_file, size_t n,
+                        const std::function<void(size_t)>& fn) {
+  if (n == 1) return fn(0);
+  absl::Mutex mu;
+  absl::CondVar done;
+  size_t pending = n;
+  for (size_t i = 0; i < n; ++i) {
+    auto task = [&, i]() {
+      fn(i);
+      absl::MutexLock l(&mu);
+      if (--pending == 0) done.Signal();
+    };
+    if (!s3_file->executor->Submit(task)) task();
+  }
+  absl::MutexLock l(&mu);
+  while (pending > 0) done.Wait(&mu);
+}
+
 static void SimpleCopyFile(const Aws::String& source,
                            const Aws::String& bucket_dst,
                            const Aws::String& object_dst, S3File* s3_file,
@@ -817,8 +1416,8 @@ static void MultiPartCopyCallback(
 static void MultiPartCopy(const Aws::String& source,
                           const Aws::String& bucket_dst,
                           const Aws::String& object_dst, const size_t num_parts,
-                          const uint64_t file_size, S3File* s3_file,
-                          TF_Status* status) {
+                          const uint64_t chunk_size, const uint64_t file_size,
+                          S3File* s3_file, TF_Status* status) {
   TF_VLog(1, "MultiPartCopy from %s to %s/%s\n", source.c_str(),
           bucket_dst.c_str(), object_dst.c_str());
   Aws::S3::Model::CreateMultipartUploadRequest create_multipart_upload_request;
@@ -843,9 +1442,6 @@ static void MultiPartCopy(const Aws::String& source,
   // Condition variable to be used with above mutex for synchronization.
   absl::CondVar multi_part_copy_cv;
 
-  auto chunk_size =
-      s3_file->multi_part_chunk_sizes[Aws::Transfer::TransferDirection::UPLOAD];
-
   TF_VLog(1, "Copying from %s in %u parts of size %u each\n", source.c_str(),
           num_parts, chunk_size);
   size_t retries = 0;
@@ -912,6 +1508,7 @@ static void MultiPartCopy(const Aws::String& source,
                                           status);
         } else {
           // Retry.
+          RecordFilesystemRetry("s3", "copy");
           TF_Log(TF_ERROR,
                  "Retrying failed copy of part %u due to an error with S3\n",
                  part_number);
@@ -969,25 +1566,25 @@ void CopyFile(const TF_Filesystem* filesystem, const char* src, const char* dst,
 
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD, s3_file);
-  auto chunk_size =
-      s3_file->multi_part_chunk_sizes[Aws::Transfer::TransferDirection::UPLOAD];
-  size_t num_parts = 1;
-  if (file_size > chunk_size) num_parts = ceil((float)file_size / chunk_size);
+  uint64_t chunk_size = std::min(
+      s3_file->multi_part_chunk_sizes[Aws::Transfer::TransferDirection::UPLOAD],
+      kS3MultiPartCopyMaxPartSize);
+  // Objects that would need more parts are copied in larger parts.
+  chunk_size = std::max(
+      chunk_size, (file_size + kS3MultiPartCopyMaxParts - 1) /
+                      kS3MultiPartCopyMaxParts);
+  size_t num_parts = (file_size + chunk_size - 1) / chunk_size;
   if (num_parts == 1)
     SimpleCopyFile(copy_src, bucket_dst, object_dst, s3_file, status);
-  else if (num_parts > 10000)
-    TF_SetStatus(
-        status, TF_UNIMPLEMENTED,
-        absl::StrCat("MultiPartCopy with number of parts more than 10000 is "
-                     "not supported. Your object ",
-                     src, " required ", num_parts,
-                     " as multi_part_copy_part_size is set to ", chunk_size,
-                     ". You can control this part size using the environment "
-                     "variable S3_MULTI_PART_COPY_PART_SIZE to increase it.")
-            .c_str());
+  else if (chunk_size > kS3MultiPartCopyMaxPartSize)
+    TF_SetStatus(status, TF_INVALID_ARGUMENT,
+                 absl::StrCat("The object ", src, " of ", file_size,
+                              " bytes is too large to be copied")
+                     .c_str());
   else
-    MultiPartCopy(copy_src, bucket_dst, object_dst, num_parts, file_size,
-                  s3_file, status);
+    MultiPartCopy(copy_src, bucket_dst, object_dst, num_parts, chunk_size,
+                  file_size, s3_file, status);
+  if (TF_GetCode(status) == TF_OK) InvalidateCaches(s3_file, dst);
 }
 
 void DeleteFile(const TF_Filesystem* filesystem, const char* path,
@@ -1004,9 +1601,9 @@ void DeleteFile(const TF_Filesystem* filesystem, const char* path,
   auto delete_object_outcome =
       s3_file->s3_client->DeleteObject(delete_object_request);
   if (!delete_object_outcome.IsSuccess())
-    TF_SetStatusFromAWSError(delete_object_outcome.GetError(), status);
-  else
-    TF_SetStatus(status, TF_OK, "");
+    return TF_SetStatusFromAWSError(delete_object_outcome.GetError(), status);
+  InvalidateCaches(s3_file, path);
+  TF_SetStatus(status, TF_OK, "");
 }
 
 void CreateDir(const TF_Filesystem* filesystem, const char* path,
@@ -1105,6 +1702,7 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
 
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetS3Client(s3_file);
+  GetExecutor(s3_file);
 
   if (object_src.back() == '/') {
     if (object_dst.back() != '/') {
@@ -1116,11 +1714,12 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
     }
   }
 
-  Aws::S3::Model::DeleteObjectRequest delete_object_request;
+  // The objects of every page of the listing are copied concurrently, and
+  // then deleted with a single DeleteObjects request.
   Aws::S3::Model::ListObjectsV2Request list_objects_request;
   list_objects_request.WithBucket(bucket_src)
       .WithPrefix(object_src)
-      .WithMaxKeys(kS3GetChildrenMaxKeys);
+      .WithMaxKeys(kS3DeleteObjectsMaxKeys);
   list_objects_request.SetResponseStreamFactory(
       []() { return Aws::New<Aws::StringStream>(kS3FileSystemAllocationTag); });
 
@@ -1132,30 +1731,95 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
       return TF_SetStatusFromAWSError(list_objects_outcome.GetError(), status);
 
     list_objects_result = list_objects_outcome.GetResult();
-    for (const auto& object : list_objects_result.GetContents()) {
-      Aws::String key_src = object.GetKey();
+    list_objects_request.SetContinuationToken(
+        list_objects_result.GetNextContinuationToken());
+    const auto& objects = list_objects_result.GetContents();
+    if (objects.empty()) continue;
+
+    std::vector<TF_Status*> statuses(objects.size());
+    for (auto& copy_status : statuses) copy_status = TF_NewStatus();
+    ParallelFor(s3_file, objects.size(), [&](size_t i) {
+      Aws::String key_src = objects[i].GetKey();
       Aws::String key_dst = key_src;
       key_dst.replace(0, object_src.length(), object_dst);
       CopyFile(filesystem, ("s3://" + bucket_src + "/" + key_src).c_str(),
-               ("s3://" + bucket_dst + "/" + key_dst).c_str(), status);
-      if (TF_GetCode(status) != TF_OK) return;
+               ("s3://" + bucket_dst + "/" + key_dst).c_str(), statuses[i]);
+    });
+    TF_SetStatus(status, TF_OK, "");
+    for (auto copy_status : statuses) {
+      if (TF_GetCode(status) == TF_OK && TF_GetCode(copy_status) != TF_OK)
+        TF_SetStatus(status, TF_GetCode(copy_status), TF_Message(copy_status));
+      TF_DeleteStatus(copy_status);
+    }
+    if (TF_GetCode(status) != TF_OK) return;
 
-      delete_object_request.WithBucket(bucket_src).WithKey(key_src);
-      auto delete_object_outcome =
-          s3_file->s3_client->DeleteObject(delete_object_request);
-      if (!delete_object_outcome.IsSuccess())
-        return TF_SetStatusFromAWSError(delete_object_outcome.GetError(),
-                                        status);
+    Aws::S3::Model::Delete delete_objects;
+    for (const auto& object : objects) {
+      delete_objects.AddObjects(
+          Aws::S3::Model::ObjectIdentifier().WithKey(object.GetKey()));
+      InvalidateCaches(s3_file,
+                       absl::StrCat("s3://", bucket_src, "/", object.GetKey()));
     }
+    delete_objects.SetQuiet(true);
+    Aws::S3::Model::DeleteObjectsRequest delete_objects_request;
+    delete_objects_request.WithBucket(bucket_src).WithDelete(
+        std::move(delete_objects));
+    auto delete_objects_outcome =
+        s3_file->s3_client->DeleteObjects(delete_objects_request);
+    if (!delete_objects_outcome.IsSuccess())
+      return TF_SetStatusFromAWSError(delete_objects_outcome.GetError(),
+                                      status);
+    // In quiet mode only the keys that could not be deleted are returned.
+    const auto& errors = delete_objects_outcome.GetResult().GetErrors();
+    if (!errors.empty())
+      return TF_SetStatus(
+          status, TF_UNKNOWN,
+          absl::StrCat("Could not delete s3://", bucket_src, "/",
+                       errors.front().GetKey(), ": ",
+                       errors.front().GetMessage())
+              .c_str());
+  } while (list_objects_result.GetIsTruncated());
+  TF_SetStatus(status, TF_OK, "");
+}
+
+// Lists all keys under `prefix`, and the common prefixes up to the next `/`
+// if `use_delimiter` is set, in pages of `kS3GetChildrenMaxKeys`.
+static void ListObjects(S3File* s3_file, const Aws::String& bucket,
+                        const Aws::String& prefix, bool use_delimiter,
+                        std::vector<Aws::String>* keys,
+                        std::vector<Aws::String>* common_prefixes,
+                        TF_Status* status) {
+  Aws::S3::Model::ListObjectsV2Request list_objects_request;
+  list_objects_request.WithBucket(bucket)
+      .WithPrefix(prefix)
+      .WithMaxKeys(kS3GetChildrenMaxKeys);
+  if (use_delimiter) list_objects_request.WithDelimiter("/");
+  list_objects_request.SetResponseStreamFactory(
+      []() { return Aws::New<Aws::StringStream>(kS3FileSystemAllocationTag); });
+
+  bool is_truncated;
+  do {
+    auto list_objects_outcome =
+        s3_file->s3_client->ListObjectsV2(list_objects_request);
+    if (!list_objects_outcome.IsSuccess())
+      return TF_SetStatusFromAWSError(list_objects_outcome.GetError(), status);
+
+    const auto& list_objects_result = list_objects_outcome.GetResult();
+    for (const auto& object : list_objects_result.GetCommonPrefixes())
+      common_prefixes->push_back(object.GetPrefix());
+    for (const auto& object : list_objects_result.GetContents())
+      keys->push_back(object.GetKey());
     list_objects_request.SetContinuationToken(
         list_objects_result.GetNextContinuationToken());
-  } while (list_objects_result.GetIsTruncated());
+    is_truncated = list_objects_result.GetIsTruncated();
+  } while (is_truncated);
   TF_SetStatus(status, TF_OK, "");
 }
 
 int GetChildren(const TF_Filesystem* filesystem, const char* path,
                 char*** entries, TF_Status* status) {
   TF_VLog(1, "GetChildren for path: %s\n", path);
+  FilesystemRequest request("s3", "list", status);
   Aws::String bucket, prefix;
   ParseS3Path(path, true, &bucket, &prefix, status);
   if (TF_GetCode(status) != TF_OK) return -1;
@@ -1164,43 +1828,125 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetS3Client(s3_file);
 
-  Aws::S3::Model::ListObjectsV2Request list_objects_request;
-  list_objects_request.WithBucket(bucket)
-      .WithPrefix(prefix)
-      .WithMaxKeys(kS3GetChildrenMaxKeys)
-      .WithDelimiter("/");
-  list_objects_request.SetResponseStreamFactory(
-      []() { return Aws::New<Aws::StringStream>(kS3FileSystemAllocationTag); });
+  std::vector<Aws::String> keys, common_prefixes;
+  ListObjects(s3_file, bucket, prefix, true, &keys, &common_prefixes, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
 
-  Aws::S3::Model::ListObjectsV2Result list_objects_result;
   std::vector<Aws::String> result;
-  do {
-    auto list_objects_outcome =
-        s3_file->s3_client->ListObjectsV2(list_objects_request);
-    if (!list_objects_outcome.IsSuccess()) {
-      TF_SetStatusFromAWSError(list_objects_outcome.GetError(), status);
+  for (const auto& common_prefix : common_prefixes) {
+    Aws::String entry = common_prefix.substr(
+        prefix.length(), common_prefix.length() - prefix.length() - 1);
+    if (entry.length() > 0) result.push_back(entry);
+  }
+  for (const auto& key : keys) {
+    Aws::String entry = key.substr(prefix.length());
+    if (entry.length() > 0) result.push_back(entry);
+  }
+
+  int num_entries = result.size();
+  *entries = static_cast<char**>(
+      plugin_memory_allocate(num_entries * sizeof((*entries)[0])));
+  for (int i = 0; i < num_entries; i++)
+    (*entries)[i] = strdup(result[i].c_str());
+  TF_SetStatus(status, TF_OK, "");
+  return num_entries;
+}
+
+int GetMatchingPaths(const TF_Filesystem* filesystem, const char* glob,
+                     char*** entries, TF_Status* status) {
+  TF_VLog(1, "GetMatchingPaths for glob: %s\n", glob);
+  FilesystemRequest request("s3", "list", status);
+  Aws::String bucket, object;
+  ParseS3Path(glob, true, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  if (bucket.find_first_of(kGlobChars) != Aws::String::npos) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT,
+                 absl::StrCat("Wildcards in the bucket of ", glob,
+                              " are not supported")
+                     .c_str());
+    return -1;
+  }
+
+  auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  GetS3Client(s3_file);
+  GetExecutor(s3_file);
+
+  std::vector<Aws::String> result;
+  if (object.find_first_of(kGlobChars) == Aws::String::npos) {
+    // Not a glob, the path only matches itself.
+    PathExists(filesystem, glob, status);
+    if (TF_GetCode(status) == TF_OK)
+      result.push_back(glob);
+    else if (TF_GetCode(status) != TF_NOT_FOUND)
       return -1;
+  } else {
+    while (!object.empty() && object.back() == '/') object.pop_back();
+    std::vector<Aws::String> components;
+    for (size_t start = 0;;) {
+      size_t end = object.find('/', start);
+      components.push_back(object.substr(start, end - start));
+      if (end == Aws::String::npos) break;
+      start = end + 1;
     }
 
-    list_objects_result = list_objects_outcome.GetResult();
-    for (const auto& object : list_objects_result.GetCommonPrefixes()) {
-      Aws::String s = object.GetPrefix();
-      s.erase(s.length() - 1);
-      Aws::String entry = s.substr(prefix.length());
-      if (entry.length() > 0) {
-        result.push_back(entry);
+    // The glob is expanded one component at a time. Every directory that
+    // matches the components so far is listed concurrently, only with the
+    // literal prefix of the next component, and only up to the next `/`.
+    std::vector<Aws::String> dirs = {""};
+    for (size_t i = 0; i < components.size() && !dirs.empty(); ++i) {
+      const auto& component = components[i];
+      bool last = i + 1 == components.size();
+      size_t wildcard = component.find_first_of(kGlobChars);
+      if (wildcard == Aws::String::npos && !last) {
+        // A literal directory only extends the key prefix of the next
+        // ListObjectsV2, which returns no key or common prefix if no object
+        // is under it.
+        for (auto& dir : dirs) dir += component + "/";
+        continue;
       }
-    }
-    for (const auto& object : list_objects_result.GetContents()) {
-      Aws::String s = object.GetKey();
-      Aws::String entry = s.substr(prefix.length());
-      if (entry.length() > 0) {
-        result.push_back(entry);
+
+      size_t num_dirs = dirs.size();
+      std::vector<std::vector<Aws::String>> keys(num_dirs);
+      std::vector<std::vector<Aws::String>> common_prefixes(num_dirs);
+      std::vector<TF_Status*> statuses(num_dirs);
+      for (auto& list_status : statuses) list_status = TF_NewStatus();
+      ParallelFor(s3_file, num_dirs, [&](size_t j) {
+        ListObjects(s3_file, bucket, dirs[j] + component.substr(0, wildcard),
+                    true, &keys[j], &common_prefixes[j], statuses[j]);
+      });
+      TF_SetStatus(status, TF_OK, "");
+      for (auto list_status : statuses) {
+        if (TF_GetCode(status) == TF_OK && TF_GetCode(list_status) != TF_OK)
+          TF_SetStatus(status, TF_GetCode(list_status),
+                       TF_Message(list_status));
+        TF_DeleteStatus(list_status);
       }
+      if (TF_GetCode(status) != TF_OK) return -1;
+
+      std::vector<Aws::String> next_dirs;
+      for (size_t j = 0; j < num_dirs; ++j) {
+        size_t length = dirs[j].length();
+        for (const auto& common_prefix : common_prefixes[j]) {
+          Aws::String name = common_prefix.substr(
+              length, common_prefix.length() - length - 1);
+          if (!MatchGlobComponent(component, name)) continue;
+          if (last)
+            result.push_back("s3://" + bucket + "/" + dirs[j] + name);
+          else
+            next_dirs.push_back(common_prefix);
+        }
+        if (!last) continue;
+        for (const auto& key : keys[j]) {
+          Aws::String name = key.substr(length);
+          if (!name.empty() && MatchGlobComponent(component, name))
+            result.push_back("s3://" + bucket + "/" + key);
+        }
+      }
+      dirs = std::move(next_dirs);
     }
-    list_objects_request.SetContinuationToken(
-        list_objects_result.GetNextContinuationToken());
-  } while (list_objects_result.GetIsTruncated());
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+  }
 
   int num_entries = result.size();
   *entries = static_cast<char**>(
@@ -1211,6 +1957,93 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
   return num_entries;
 }
 
+// Deletes all objects under the directory `path` with DeleteObjects
+// requests of up to `kS3DeleteObjectsMaxKeys` keys, one for every page of
+// the listing.
+void DeleteRecursively(const TF_Filesystem* filesystem, const char* path,
+                       uint64_t* undeleted_files, uint64_t* undeleted_dirs,
+                       TF_Status* status) {
+  TF_VLog(1, "DeleteRecursively: %s\n", path);
+  *undeleted_files = 0;
+  *undeleted_dirs = 0;
+  Aws::String bucket, object;
+  ParseS3Path(path, true, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  GetS3Client(s3_file);
+
+  TF_FileStatistics stats;
+  Stat(filesystem, path, &stats, status);
+  if (TF_GetCode(status) != TF_OK) {
+    (*undeleted_dirs)++;
+    return;
+  }
+  if (!stats.is_directory) {
+    DeleteFile(filesystem, path, status);
+    if (TF_GetCode(status) != TF_OK) (*undeleted_files)++;
+    return;
+  }
+
+  Aws::String prefix = object;
+  if (!prefix.empty() && prefix.back() != '/') prefix.push_back('/');
+  Aws::S3::Model::ListObjectsV2Request list_objects_request;
+  list_objects_request.WithBucket(bucket).WithPrefix(prefix).WithMaxKeys(
+      kS3DeleteObjectsMaxKeys);
+  list_objects_request.SetResponseStreamFactory(
+      []() { return Aws::New<Aws::StringStream>(kS3FileSystemAllocationTag); });
+
+  bool is_truncated;
+  do {
+    auto list_objects_outcome =
+        s3_file->s3_client->ListObjectsV2(list_objects_request);
+    if (!list_objects_outcome.IsSuccess())
+      return TF_SetStatusFromAWSError(list_objects_outcome.GetError(), status);
+    const auto& list_objects_result = list_objects_outcome.GetResult();
+    is_truncated = list_objects_result.GetIsTruncated();
+    list_objects_request.SetContinuationToken(
+        list_objects_result.GetNextContinuationToken());
+    if (list_objects_result.GetContents().empty()) continue;
+
+    Aws::S3::Model::Delete delete_objects;
+    for (const auto& object : list_objects_result.GetContents()) {
+      delete_objects.AddObjects(
+          Aws::S3::Model::ObjectIdentifier().WithKey(object.GetKey()));
+      if (s3_file->file_block_cache)
+        s3_file->file_block_cache->RemoveFile(
+            absl::StrCat("s3://", bucket, "/", object.GetKey()));
+    }
+    delete_objects.SetQuiet(true);
+    Aws::S3::Model::DeleteObjectsRequest delete_objects_request;
+    delete_objects_request.WithBucket(bucket).WithDelete(
+        std::move(delete_objects));
+    auto delete_objects_outcome =
+        s3_file->s3_client->DeleteObjects(delete_objects_request);
+    if (!delete_objects_outcome.IsSuccess())
+      return TF_SetStatusFromAWSError(delete_objects_outcome.GetError(),
+                                      status);
+    // In quiet mode only the keys that could not be deleted are returned.
+    for (const auto& error : delete_objects_outcome.GetResult().GetErrors()) {
+      TF_VLog(1, "Failed to delete s3://%s/%s: %s\n", bucket.c_str(),
+              error.GetKey().c_str(), error.GetMessage().c_str());
+      if (!error.GetKey().empty() && error.GetKey().back() == '/')
+        (*undeleted_dirs)++;
+      else
+        (*undeleted_files)++;
+    }
+  } while (is_truncated);
+
+  if (s3_file->stat_cache) {
+    Aws::String root = path;
+    while (!root.empty() && root.back() == '/') root.pop_back();
+    s3_file->stat_cache->DeletePrefix(std::string(root.c_str()));
+  }
+  if (*undeleted_files > 0 || *undeleted_dirs > 0)
+    return TF_SetStatus(
+        status, TF_UNKNOWN,
+        absl::StrCat("Could not delete all objects under ", path).c_str());
+  TF_SetStatus(status, TF_OK, "");
+}
+
 static char* TranslateName(const TF_Filesystem* filesystem, const char* uri) {
   return strdup(uri);
 }
@@ -1258,12 +2091,15 @@ void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri) {
       tf_s3_filesystem::RecursivelyCreateDir;
   ops->filesystem_ops->delete_file = tf_s3_filesystem::DeleteFile;
   ops->filesystem_ops->delete_dir = tf_s3_filesystem::DeleteDir;
+  ops->filesystem_ops->delete_recursively = tf_s3_filesystem::DeleteRecursively;
   ops->filesystem_ops->copy_file = tf_s3_filesystem::CopyFile;
   ops->filesystem_ops->rename_file = tf_s3_filesystem::RenameFile;
   ops->filesystem_ops->path_exists = tf_s3_filesystem::PathExists;
   ops->filesystem_ops->get_file_size = tf_s3_filesystem::GetFileSize;
   ops->filesystem_ops->stat = tf_s3_filesystem::Stat;
   ops->filesystem_ops->get_children = tf_s3_filesystem::GetChildren;
+  ops->filesystem_ops->get_matching_paths =
+      tf_s3_filesystem::GetMatchingPaths;
   ops->filesystem_ops->translate_name = tf_s3_filesystem::TranslateName;
 }
 
@@ -25,6 +25,8 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/c/experimental/filesystem/filesystem_interface.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
+#include "tensorflow_io/core/filesystems/ram_file_block_cache.h"
 
 namespace tensorflow {
 namespace io {
@@ -67,6 +69,24 @@ typedef struct S3File {
   Aws::UnorderedMap<Aws::Transfer::TransferDirection, uint64_t>
       multi_part_chunk_sizes;
   bool use_multi_part_download;
+  // Cache of object contents shared by all random access files, disabled
+  // unless S3_READ_CACHE_MAX_SIZE_MB is set.
+  std::unique_ptr<RamFileBlockCache> file_block_cache;
+  // Cache of `Stat` results, used by `GetFileSize` and `PathExists` too.
+  std::unique_ptr<ExpiringLRUCache<TF_FileStatistics>> stat_cache;
+  // Sequential read-ahead of random access files, configured with the
+  // S3_READ_AHEAD_* environment variables. Disabled unless
+  // S3_READ_AHEAD_WINDOWS is set. The windows of all files are accounted to
+  // the "s3_read_ahead" component of the MemoryBudget.
+  uint64_t read_ahead_min_size;
+  uint64_t read_ahead_max_size;
+  size_t read_ahead_windows;
+  // Whether writable files upload parts while they are written, enabled with
+  // S3_STREAMING_UPLOAD=1.
+  bool use_streaming_upload;
+  size_t streaming_upload_max_parts_in_flight;
+  // Bytes of the TransferManager heaps accounted to the MemoryBudget.
+  uint64_t transfer_manager_heap_size;
   absl::Mutex initialization_lock;
   S3File();
 } S3File;
@@ -97,6 +117,11 @@ void Stat(const TF_Filesystem* filesystem, const char* path,
           TF_FileStatistics* stats, TF_Status* status);
 void DeleteDir(const TF_Filesystem* filesystem, const char* path,
                TF_Status* status);
+void DeleteRecursively(const TF_Filesystem* filesystem, const char* path,
+                       uint64_t* undeleted_files, uint64_t* undeleted_dirs,
+                       TF_Status* status);
+int GetMatchingPaths(const TF_Filesystem* filesystem, const char* glob,
+                     char*** entries, TF_Status* status);
 void CopyFile(const TF_Filesystem* filesystem, const char* src, const char* dst,
               TF_Status* status);
 void RenameFile(const TF_Filesystem* filesystem, const char* src,
@@ -3,17 +3,27 @@ package main
 import "C"
 
 import (
+	"bufio"
 	"context"
 	"crypto/tls"
+	"encoding/binary"
 	"fmt"
+	"io"
+	"io/ioutil"
+	"math"
+	"mime"
 	"net/http"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
 	"time"
 
+	"github.com/golang/protobuf/proto"
 	"github.com/prometheus/client_golang/api"
 	"github.com/prometheus/client_golang/api/prometheus/v1"
 	dto "github.com/prometheus/client_model/go"
 	"github.com/prometheus/common/model"
-	"github.com/prometheus/prom2json"
 )
 
 //export QuerySpecs
@@ -57,85 +67,250 @@ func QuerySpecs(endpoint string, query string, timestamp int64, jobs [][]byte, i
 
 }
 
-//export QueryRange
-func QueryRange(endpoint string, query string, start int64, end int64, job string, instance string, name string, timestamp []int64, value []float64) int {
+// The most points of a series a query returns, below the 11,000 points
+// Prometheus allows.
+const maxQueryPoints = 10000
+
+//export QueryRangeSeries
+func QueryRangeSeries(endpoint string, query string, start int64, jobs []string, instances []string, names []string, timestamp []int64, value []float64) int {
 	client, err := api.NewClient(api.Config{
 		Address: endpoint,
 	})
 	if err != nil {
 		return -1
 	}
-	r := v1.Range{
-		Start: time.Unix(start/1000, (start%1000)*1000000),
-		End:   time.Unix(end/1000, (end%1000)*1000000),
-		Step:  time.Second,
+	// The row of each series in value, which holds the points of a series per
+	// row at their offset from start in seconds.
+	rows := make(map[[3]string]int, len(names))
+	for index := 0; index < len(jobs) && index < len(instances) && index < len(names); index++ {
+		rows[[3]string{jobs[index], instances[index], names[index]}] = index
 	}
-	v, err := v1.NewAPI(client).QueryRange(context.Background(), query, r)
-	if err != nil {
-		return -1
+	points := len(timestamp)
+	for i := 0; i < points; i++ {
+		timestamp[i] = start + int64(i)*1000
 	}
-	if m, ok := v.(model.Matrix); ok && m.Len() > 0 {
-		for index := 0; index < len(m); index++ {
-			if m[index].Metric["job"] == model.LabelValue(job) && m[index].Metric["instance"] == model.LabelValue(instance) && m[index].Metric["__name__"] == model.LabelValue(name) {
-				for i := 0; i < len(m[index].Values) && i < len(timestamp) && i < len(value); i++ {
-					v := m[index].Values[i]
-					timestamp[i] = int64(v.Timestamp)
-					value[i] = float64(v.Value)
+	for i := range value {
+		value[i] = math.NaN()
+	}
+	// All the series are queried at once, in windows of at most
+	// maxQueryPoints points that are queried concurrently.
+	var wg sync.WaitGroup
+	var failed int32
+	for first := 0; first < points; first += maxQueryPoints {
+		last := first + maxQueryPoints
+		if last > points {
+			last = points
+		}
+		wg.Add(1)
+		go func(first int, last int) {
+			defer wg.Done()
+			from := start + int64(first)*1000
+			to := start + int64(last-1)*1000
+			r := v1.Range{
+				Start: time.Unix(from/1000, (from%1000)*1000000),
+				End:   time.Unix(to/1000, (to%1000)*1000000),
+				Step:  time.Second,
+			}
+			v, err := v1.NewAPI(client).QueryRange(context.Background(), query, r)
+			if err != nil {
+				atomic.StoreInt32(&failed, 1)
+				return
+			}
+			m, ok := v.(model.Matrix)
+			if !ok {
+				return
+			}
+			for _, series := range m {
+				row, ok := rows[[3]string{string(series.Metric["job"]), string(series.Metric["instance"]), string(series.Metric["__name__"])}]
+				if !ok || (row+1)*points > len(value) {
+					continue
+				}
+				for _, p := range series.Values {
+					i := int((int64(p.Timestamp) - start) / 1000)
+					if i >= first && i < last {
+						value[row*points+i] = float64(p.Value)
+					}
 				}
-
-				return len(m[index].Values)
 			}
-		}
+		}(first, last)
 	}
-	return 0
+	wg.Wait()
+	if failed != 0 {
+		return -1
+	}
+	return points
+}
+
+// The exposition formats Scrape accepts, the delimited protobuf format
+// preferred as its families can be skipped without being parsed.
+const scrapeAccept = `application/vnd.google.protobuf;proto=io.prometheus.client.MetricFamily;encoding=delimited;q=0.7,text/plain;version=0.0.4;q=0.3`
+
+// The client of all scrapes, so that the connections to each exporter are
+// kept alive and reused across scrapes instead of made for each of them.
+var scrapeClient = &http.Client{
+	Transport: &http.Transport{
+		Proxy:               http.ProxyFromEnvironment,
+		TLSClientConfig:     &tls.Config{InsecureSkipVerify: true},
+		MaxIdleConns:        1024,
+		MaxIdleConnsPerHost: 16,
+		IdleConnTimeout:     90 * time.Second,
+	},
 }
 
 //export Scrape
 func Scrape(endpoint string, metric string, value []float64) int {
-	skipServerCertCheck := true
-	transport := &http.Transport{
-		TLSClientConfig: &tls.Config{InsecureSkipVerify: skipServerCertCheck},
+	if len(value) == 0 {
+		return -1
 	}
-
-	mfChan := make(chan *dto.MetricFamily, 1024)
-
-	err := prom2json.FetchMetricFamilies(endpoint, mfChan, transport)
+	req, err := http.NewRequest("GET", endpoint, nil)
 	if err != nil {
 		return -1
 	}
-	for mf := range mfChan {
-		for _, m := range mf.Metric {
-			if metric == mf.GetName() {
-				if len(value) > 0 {
-					value[0] = getValue(m)
-					return 0
-				}
-			}
-		}
+	req.Header.Add("Accept", scrapeAccept)
+	resp, err := scrapeClient.Do(req)
+	if err != nil {
+		return -1
 	}
-	return -1
+	defer func() {
+		// The rest of the body is read so that the connection is reused.
+		io.Copy(ioutil.Discard, resp.Body)
+		resp.Body.Close()
+	}()
+	if resp.StatusCode != http.StatusOK {
+		return -1
+	}
+	var found bool
+	mediatype, params, err := mime.ParseMediaType(resp.Header.Get("Content-Type"))
+	if err == nil && mediatype == "application/vnd.google.protobuf" &&
+		params["encoding"] == "delimited" &&
+		params["proto"] == "io.prometheus.client.MetricFamily" {
+		found, err = scrapeProtobuf(bufio.NewReader(resp.Body), metric, value)
+	} else {
+		found, err = scrapeText(bufio.NewReader(resp.Body), metric, value)
+	}
+	if err != nil || !found {
+		return -1
+	}
+	return 0
+}
 
+// Reads the length delimited metric families of r up to the family named
+// metric, whose first metric is stored to value[0]. The families before it
+// are skipped by their name field, without being unmarshaled.
+func scrapeProtobuf(r *bufio.Reader, metric string, value []float64) (bool, error) {
+	var buf []byte
+	for {
+		size, err := binary.ReadUvarint(r)
+		if err == io.EOF {
+			return false, nil
+		}
+		if err != nil {
+			return false, err
+		}
+		if uint64(cap(buf)) < size {
+			buf = make([]byte, size)
+		}
+		buf = buf[:size]
+		if _, err := io.ReadFull(r, buf); err != nil {
+			return false, err
+		}
+		if name, ok := familyName(buf); ok && name != metric {
+			continue
+		}
+		mf := &dto.MetricFamily{}
+		if err := proto.Unmarshal(buf, mf); err != nil {
+			return false, err
+		}
+		if mf.GetName() == metric && len(mf.Metric) > 0 {
+			value[0] = getValue(mf.Metric[0])
+			return true, nil
+		}
+	}
 }
-func getValue(m *dto.Metric) float64 {
-	if m.Gauge != nil {
-		return m.GetGauge().GetValue()
+
+// Returns the name of a serialized MetricFamily if it is its first field,
+// as written by the Prometheus client libraries.
+func familyName(buf []byte) (string, bool) {
+	// The key of field 1, name, of wire type 2, length delimited.
+	if len(buf) == 0 || buf[0] != 0x0a {
+		return "", false
 	}
-	if m.Counter != nil {
-		return m.GetCounter().GetValue()
+	size, n := binary.Uvarint(buf[1:])
+	if n <= 0 || uint64(len(buf)-1-n) < size {
+		return "", false
 	}
-	if m.Untyped != nil {
-		return m.GetUntyped().GetValue()
+	return string(buf[1+n : 1+n+int(size)]), true
+}
+
+// Reads the text exposition format of r up to the first sample of metric,
+// which is stored to value[0]. Only the lines of metric are parsed.
+func scrapeText(r *bufio.Reader, metric string, value []float64) (bool, error) {
+	scanner := bufio.NewScanner(r)
+	scanner.Buffer(make([]byte, 64<<10), 1<<20)
+	for scanner.Scan() {
+		line := scanner.Text()
+		if strings.HasPrefix(line, "#") {
+			// Summaries and histograms have no value of their own.
+			fields := strings.Fields(line)
+			if len(fields) == 4 && fields[1] == "TYPE" && fields[2] == metric &&
+				(fields[3] == "summary" || fields[3] == "histogram") {
+				value[0] = 0
+				return true, nil
+			}
+			continue
+		}
+		if !strings.HasPrefix(line, metric) {
+			continue
+		}
+		rest := line[len(metric):]
+		if strings.HasPrefix(rest, "{") {
+			end := labelsEnd(rest)
+			if end < 0 {
+				return false, fmt.Errorf("invalid labels: %q", line)
+			}
+			rest = rest[end+1:]
+		} else if !strings.HasPrefix(rest, " ") && !strings.HasPrefix(rest, "\t") {
+			// Another metric that metric is a prefix of.
+			continue
+		}
+		fields := strings.Fields(rest)
+		if len(fields) == 0 {
+			return false, fmt.Errorf("invalid sample: %q", line)
+		}
+		v, err := strconv.ParseFloat(fields[0], 64)
+		if err != nil {
+			return false, err
+		}
+		value[0] = v
+		return true, nil
 	}
-	return 0.
+	return false, scanner.Err()
+}
+
+// Returns the index of the brace that closes the labels at the start of s,
+// skipping the braces of quoted label values, or -1.
+func labelsEnd(s string) int {
+	quoted := false
+	for i := 1; i < len(s); i++ {
+		switch {
+		case quoted && s[i] == '\\':
+			i++
+		case s[i] == '"':
+			quoted = !quoted
+		case !quoted && s[i] == '}':
+			return i
+		}
+	}
+	return -1
 }
 
 func main() {
 	key := make([]int64, 20, 20)
 	val := make([]float64, 20, 20)
 	end := time.Now().Unix() * 1000
-	start := end - 5*1000
+	start := end - 20*1000
 	fmt.Println(start, end)
-	returned := QueryRange("http://localhost:9090", "coredns_dns_request_count_total", start, end, "", "", "", key, val)
+	returned := QueryRangeSeries("http://localhost:9090", "coredns_dns_request_count_total", start, []string{""}, []string{""}, []string{""}, key, val)
 	fmt.Println(returned)
 	for i := range key {
 		fmt.Printf("%d, %q, %v\n", i, model.TimeFromUnix(key[i]).Time(), val[i])
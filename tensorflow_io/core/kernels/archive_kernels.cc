@@ -15,12 +15,20 @@ limitations under the License.
 #include <archive.h>
 #include <archive_entry.h>
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
+#include "zlib.h"
 
 namespace tensorflow {
 namespace data {
@@ -49,20 +57,508 @@ class ArchiveRandomAccessFile : public SizedRandomAccessFile {
       }
     }
     p->callback_read_offset_ += data.size();
-    *buff = p->callback_read_buffer_;
+    *buff = data.data();
     return data.size();
   }
+  static int64_t CallbackSeek(struct archive* a, void* client_data,
+                              int64_t offset, int whence) {
+    class ArchiveRandomAccessFile* p =
+        (class ArchiveRandomAccessFile*)client_data;
+    uint64 size;
+    if (!p->GetFileSize(&size).ok()) {
+      return ARCHIVE_FATAL;
+    }
+    int64 position = offset;
+    if (whence == SEEK_CUR) {
+      position += p->callback_read_offset_;
+    } else if (whence == SEEK_END) {
+      position += size;
+    }
+    if (position < 0) {
+      return ARCHIVE_FATAL;
+    }
+    p->callback_read_offset_ = std::min<int64>(position, size);
+    return p->callback_read_offset_;
+  }
+  static int64_t CallbackSkip(struct archive* a, void* client_data,
+                              int64_t request) {
+    class ArchiveRandomAccessFile* p =
+        (class ArchiveRandomAccessFile*)client_data;
+    uint64 size;
+    if (!p->GetFileSize(&size).ok()) {
+      return ARCHIVE_FATAL;
+    }
+    const int64 left = static_cast<int64>(size) - p->callback_read_offset_;
+    const int64 skipped = std::max<int64>(0, std::min<int64>(request, left));
+    p->callback_read_offset_ += skipped;
+    return skipped;
+  }
+
+  // Opens `archive` on the file, which lets libarchive skip and seek past
+  // the data of entries instead of reading it.
+  Status Open(struct archive* archive) {
+    archive_read_set_read_callback(archive, CallbackRead);
+    archive_read_set_seek_callback(archive, CallbackSeek);
+    archive_read_set_skip_callback(archive, CallbackSkip);
+    archive_read_set_callback_data(archive, this);
+    if (archive_read_open1(archive) != ARCHIVE_OK) {
+      return errors::InvalidArgument("unable to open datainput: ",
+                                     archive_error_string(archive));
+    }
+    return OkStatus();
+  }
+
+  // Reads up to `n` bytes at `offset` into `buffer`, which may be read
+  // concurrently with other reads but not with the callbacks.
+  Status ReadAt(const uint64 offset, const size_t n, char* buffer,
+                size_t* bytes_read) {
+    StringPiece result;
+    Status status = Read(offset, n, &result, buffer);
+    if (!status.ok() && !errors::IsOutOfRange(status)) {
+      return status;
+    }
+    if (result.data() != buffer && result.size() > 0) {
+      memcpy(buffer, result.data(), result.size());
+    }
+    *bytes_read = result.size();
+    return OkStatus();
+  }
+
   // CallbackRead
-  char callback_read_buffer_[4096];
+  char callback_read_buffer_[65536];
   int64 callback_read_offset_ = 0;
 };
 
+bool IsTarFormat(const string& archive_format) {
+  return archive_format.find("tar") != string::npos ||
+         archive_format.find("pax") != string::npos;
+}
+
+// The entries of a tar archive, as the offsets and sizes of their data in
+// the tar stream. For a gzip compressed tar, the index also has the access
+// points where inflating may start, every kSpan bytes or so of the tar
+// stream, each with the 32 KB of the stream before it, as in zlib's zran
+// example. Entries are then inflated from the point before them, instead
+// of from the start of the archive.
+struct ArchiveIndex {
+  struct Entry {
+    int64 offset;
+    int64 size;
+  };
+  struct Point {
+    // The offset in the tar stream and in the file, and the bits of the
+    // byte before `in` that start the deflate block when the block does
+    // not start on a byte boundary.
+    int64 out;
+    int64 in;
+    int bits;
+    string window;
+  };
+
+  static constexpr int64 kSpan = 1 << 20;
+  static constexpr size_t kWindowBytes = 32768;
+
+  std::vector<string> names;
+  std::unordered_map<string, Entry> entries;
+  std::vector<Point> points;
+};
+
+// Parses the headers of a tar stream fed in pieces into an index, with the
+// long names of GNU and pax extended headers.
+class TarIndexBuilder {
+ public:
+  explicit TarIndexBuilder(ArchiveIndex* index) : index_(index) {}
+
+  // Whether the end of the archive has been reached.
+  bool done() const { return done_; }
+
+  Status Add(const char* data, size_t n) {
+    while (n > 0 && !done_) {
+      size_t k;
+      if (skip_ > 0) {
+        k = std::min<uint64>(skip_, n);
+        if (capture_left_ > 0) {
+          const size_t c = std::min<uint64>(capture_left_, k);
+          capture_.append(data, c);
+          capture_left_ -= c;
+        }
+        skip_ -= k;
+        if (skip_ == 0 && !capture_.empty()) {
+          Captured();
+        }
+      } else {
+        k = std::min(kBlockBytes - header_.size(), n);
+        header_.append(data, k);
+        if (header_.size() == kBlockBytes) {
+          TF_RETURN_IF_ERROR(Header(position_ + k));
+          header_.clear();
+        }
+      }
+      data += k;
+      n -= k;
+      position_ += k;
+    }
+    return OkStatus();
+  }
+
+ private:
+  static uint64 Number(const char* field, const size_t size) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(field);
+    uint64 value = 0;
+    if (u[0] & 0x80) {
+      // base-256 encoding of large values
+      value = u[0] & 0x7f;
+      for (size_t i = 1; i < size; i++) {
+        value = (value << 8) | u[i];
+      }
+      return value;
+    }
+    for (size_t i = 0; i < size && field[i] != '\0'; i++) {
+      if (field[i] >= '0' && field[i] <= '7') {
+        value = value * 8 + (field[i] - '0');
+      }
+    }
+    return value;
+  }
+
+  static string Field(const char* field, const size_t size) {
+    return string(field, strnlen(field, size));
+  }
+
+  // Parses the header ending at `end` in the tar stream.
+  Status Header(const int64 end) {
+    const char* h = header_.data();
+    if (std::all_of(header_.begin(), header_.end(),
+                    [](char c) { return c == '\0'; })) {
+      done_ = true;
+      return OkStatus();
+    }
+    uint64 size = Number(h + 124, 12);
+    const char type = h[156];
+    if (type == 'L' || type == 'x') {
+      // The long name of the next entry, or its pax attributes.
+      capture_type_ = type;
+      capture_left_ = size;
+      capture_.clear();
+    } else if (type != 'g' && type != 'K') {
+      string name = long_name_;
+      if (name.empty()) {
+        name = Field(h, 100);
+        if (memcmp(h + 257, "ustar", 5) == 0 && h[345] != '\0') {
+          name = Field(h + 345, 155) + "/" + name;
+        }
+      }
+      if (pax_size_ >= 0) {
+        size = pax_size_;
+      }
+      if (index_->entries.find(name) == index_->entries.end()) {
+        index_->names.push_back(name);
+      }
+      index_->entries[name] = ArchiveIndex::Entry{
+          end, (type == '0' || type == '\0' || type == '7')
+                   ? static_cast<int64>(size)
+                   : 0};
+      long_name_.clear();
+      pax_size_ = -1;
+      // Links and directories have no data, whatever their size.
+      if (type == '1' || type == '2' || type == '5') {
+        size = 0;
+      }
+    }
+    skip_ = (size + kBlockBytes - 1) / kBlockBytes * kBlockBytes;
+    return OkStatus();
+  }
+
+  void Captured() {
+    if (capture_type_ == 'L') {
+      long_name_ = Field(capture_.data(), capture_.size());
+    } else {
+      // pax records are "<length> <key>=<value>\n"
+      size_t p = 0;
+      while (p < capture_.size()) {
+        const size_t space = capture_.find(' ', p);
+        const uint64 length = strtoull(capture_.c_str() + p, nullptr, 10);
+        if (space == string::npos || length == 0 || space >= p + length ||
+            p + length > capture_.size()) {
+          break;
+        }
+        const string record =
+            capture_.substr(space + 1, p + length - space - 2);
+        const size_t equal = record.find('=');
+        if (equal != string::npos) {
+          const string key = record.substr(0, equal);
+          if (key == "path") {
+            long_name_ = record.substr(equal + 1);
+          } else if (key == "size") {
+            pax_size_ = strtoll(record.c_str() + equal + 1, nullptr, 10);
+          }
+        }
+        p += length;
+      }
+    }
+    capture_.clear();
+  }
+
+  static constexpr size_t kBlockBytes = 512;
+
+  ArchiveIndex* index_;
+  int64 position_ = 0;
+  string header_;
+  // The bytes of data and padding left to skip, of which the first
+  // `capture_left_` are kept.
+  uint64 skip_ = 0;
+  uint64 capture_left_ = 0;
+  char capture_type_ = 0;
+  string capture_;
+  string long_name_;
+  int64 pax_size_ = -1;
+  bool done_ = false;
+};
+
+// Indexes an uncompressed tar archive.
+Status BuildTarIndex(ArchiveRandomAccessFile* file, ArchiveIndex* index) {
+  static constexpr size_t kChunkBytes = 1 << 20;
+  TarIndexBuilder builder(index);
+  string buffer(kChunkBytes, '\0');
+  uint64 offset = 0;
+  while (!builder.done()) {
+    size_t n = 0;
+    TF_RETURN_IF_ERROR(file->ReadAt(offset, kChunkBytes, &buffer[0], &n));
+    if (n == 0) {
+      break;
+    }
+    TF_RETURN_IF_ERROR(builder.Add(buffer.data(), n));
+    offset += n;
+  }
+  return OkStatus();
+}
+
+// Indexes a gzip compressed tar archive, inflating it once, with an access
+// point at the deflate block boundaries every ArchiveIndex::kSpan bytes.
+Status BuildGzipTarIndex(ArchiveRandomAccessFile* file, ArchiveIndex* index) {
+  static constexpr size_t kChunkBytes = 1 << 16;
+  uint64 size;
+  TF_RETURN_IF_ERROR(file->GetFileSize(&size));
+  TarIndexBuilder builder(index);
+  string input(kChunkBytes, '\0');
+  string window(ArchiveIndex::kWindowBytes, '\0');
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // Decodes gzip headers, of each member of the file.
+  if (inflateInit2(&stream, 31) != Z_OK) {
+    return errors::Internal("failed to initialize inflate");
+  }
+  std::unique_ptr<z_stream, int (*)(z_stream*)> scope(&stream, inflateEnd);
+  uint64 offset = 0;
+  int64 in = 0;
+  int64 out = 0;
+  int64 last = 0;
+  while (!builder.done()) {
+    if (stream.avail_in == 0) {
+      size_t n = 0;
+      TF_RETURN_IF_ERROR(file->ReadAt(offset, kChunkBytes, &input[0], &n));
+      if (n == 0) {
+        return errors::DataLoss("unexpected end of gzip stream");
+      }
+      offset += n;
+      stream.next_in = reinterpret_cast<Bytef*>(&input[0]);
+      stream.avail_in = n;
+    }
+    if (stream.avail_out == 0) {
+      stream.next_out = reinterpret_cast<Bytef*>(&window[0]);
+      stream.avail_out = window.size();
+    }
+    const Bytef* next_out = stream.next_out;
+    in += stream.avail_in;
+    out += stream.avail_out;
+    const int code = inflate(&stream, Z_BLOCK);
+    in -= stream.avail_in;
+    out -= stream.avail_out;
+    TF_RETURN_IF_ERROR(builder.Add(reinterpret_cast<const char*>(next_out),
+                                   stream.next_out - next_out));
+    if (code == Z_STREAM_END) {
+      if (stream.avail_in == 0 && offset >= size) {
+        break;
+      }
+      inflateReset(&stream);
+      continue;
+    }
+    if (code != Z_OK && code != Z_BUF_ERROR) {
+      return errors::DataLoss("failed to inflate: ",
+                              stream.msg != nullptr ? stream.msg : "");
+    }
+    // At the end of a deflate block that is not the last one.
+    if ((stream.data_type & 128) && !(stream.data_type & 64) &&
+        (out == 0 || out - last > ArchiveIndex::kSpan)) {
+      ArchiveIndex::Point point{out, in, stream.data_type & 7, string()};
+      const size_t left = stream.avail_out;
+      point.window.reserve(window.size());
+      point.window.append(window, window.size() - left, left);
+      point.window.append(window, 0, window.size() - left);
+      index->points.push_back(std::move(point));
+      last = out;
+    }
+  }
+  return OkStatus();
+}
+
+// Inflates the `size` bytes at `offset` of the tar stream of a gzip
+// compressed tar into `output`, from the access point before them.
+Status ReadGzipTarEntry(ArchiveRandomAccessFile* file,
+                        const ArchiveIndex& index, const int64 offset,
+                        const int64 size, char* output) {
+  static constexpr size_t kChunkBytes = 1 << 16;
+  auto it = std::upper_bound(
+      index.points.begin(), index.points.end(), offset,
+      [](int64 value, const ArchiveIndex::Point& p) { return value < p.out; });
+  if (it == index.points.begin()) {
+    return errors::Internal("no access point before ", offset);
+  }
+  const ArchiveIndex::Point& point = *(--it);
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, -15) != Z_OK) {
+    return errors::Internal("failed to initialize inflate");
+  }
+  std::unique_ptr<z_stream, int (*)(z_stream*)> scope(&stream, inflateEnd);
+  string input(kChunkBytes, '\0');
+  uint64 in = point.in - (point.bits ? 1 : 0);
+  auto fill = [&]() -> Status {
+    size_t n = 0;
+    TF_RETURN_IF_ERROR(file->ReadAt(in, kChunkBytes, &input[0], &n));
+    if (n == 0) {
+      return errors::DataLoss("unexpected end of gzip stream");
+    }
+    in += n;
+    stream.next_in = reinterpret_cast<Bytef*>(&input[0]);
+    stream.avail_in = n;
+    return OkStatus();
+  };
+  TF_RETURN_IF_ERROR(fill());
+  if (point.bits) {
+    const int byte = *stream.next_in;
+    stream.next_in++;
+    stream.avail_in--;
+    inflatePrime(&stream, point.bits, byte >> (8 - point.bits));
+  }
+  inflateSetDictionary(&stream,
+                       reinterpret_cast<const Bytef*>(point.window.data()),
+                       point.window.size());
+
+  string discard(ArchiveIndex::kWindowBytes, '\0');
+  int64 skip = offset - point.out;
+  int64 produced = 0;
+  // The gzip trailer left to skip once the member of the point ends, after
+  // which the next members are inflated with their headers.
+  int64 trailer = -1;
+  while (produced < size) {
+    if (stream.avail_in == 0) {
+      TF_RETURN_IF_ERROR(fill());
+    }
+    if (trailer > 0) {
+      const uInt k = std::min<int64>(trailer, stream.avail_in);
+      stream.next_in += k;
+      stream.avail_in -= k;
+      trailer -= k;
+      if (trailer == 0) {
+        inflateReset2(&stream, 31);
+      }
+      continue;
+    }
+    uInt want;
+    if (skip > 0) {
+      want = std::min<int64>(skip, discard.size());
+      stream.next_out = reinterpret_cast<Bytef*>(&discard[0]);
+    } else {
+      want = std::min<int64>(size - produced, 1 << 30);
+      stream.next_out = reinterpret_cast<Bytef*>(output + produced);
+    }
+    stream.avail_out = want;
+    const int code = inflate(&stream, Z_NO_FLUSH);
+    const int64 got = want - stream.avail_out;
+    if (skip > 0) {
+      skip -= got;
+    } else {
+      produced += got;
+    }
+    if (code == Z_STREAM_END) {
+      if (trailer < 0) {
+        trailer = 8;
+      } else {
+        inflateReset(&stream);
+      }
+    } else if (code != Z_OK && code != Z_BUF_ERROR) {
+      return errors::DataLoss("failed to inflate: ",
+                              stream.msg != nullptr ? stream.msg : "");
+    }
+  }
+  return OkStatus();
+}
+
+// The indexes of the archives read, by filename and size, so that each is
+// scanned once however many of its entries are read.
+class ArchiveIndexCache {
+ public:
+  static ArchiveIndexCache* Default() {
+    static ArchiveIndexCache* cache = new ArchiveIndexCache();
+    return cache;
+  }
+
+  // Returns the index of the archive, of the format "tar" or "tar.gz",
+  // building it when it is not in the cache. Archives in memory are not
+  // cached.
+  Status Get(const string& filename, const string& format,
+             const bool cacheable, ArchiveRandomAccessFile* file,
+             std::shared_ptr<const ArchiveIndex>* index) {
+    uint64 size;
+    TF_RETURN_IF_ERROR(file->GetFileSize(&size));
+    const string key = strings::StrCat(format, ":", size, ":", filename);
+    if (cacheable) {
+      mutex_lock l(mu_);
+      auto it = indexes_.find(key);
+      if (it != indexes_.end()) {
+        *index = it->second;
+        return OkStatus();
+      }
+    }
+    std::shared_ptr<ArchiveIndex> built(new ArchiveIndex());
+    if (format == "tar") {
+      TF_RETURN_IF_ERROR(BuildTarIndex(file, built.get()));
+    } else {
+      TF_RETURN_IF_ERROR(BuildGzipTarIndex(file, built.get()));
+    }
+    *index = built;
+    if (cacheable) {
+      mutex_lock l(mu_);
+      if (indexes_.emplace(key, built).second) {
+        keys_.push_back(key);
+        while (keys_.size() > kMaxIndexes) {
+          indexes_.erase(keys_.front());
+          keys_.pop_front();
+        }
+      }
+    }
+    return OkStatus();
+  }
+
+ private:
+  static constexpr size_t kMaxIndexes = 64;
+
+  mutex mu_;
+  std::unordered_map<string, std::shared_ptr<const ArchiveIndex>> indexes_
+      TF_GUARDED_BY(mu_);
+  // The keys from the oldest, which is evicted first.
+  std::deque<string> keys_ TF_GUARDED_BY(mu_);
+};
+
 class ListArchiveEntriesOp : public OpKernel {
  public:
   explicit ListArchiveEntriesOp(OpKernelConstruction* context)
       : OpKernel(context) {
     env_ = context->env();
     OP_REQUIRES_OK(context, context->GetAttr("filters", &filters_));
+    OP_REQUIRES_OK(context, context->GetAttr("seek_index", &seek_index_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -70,7 +566,7 @@ class ListArchiveEntriesOp : public OpKernel {
     const string filename = filename_tensor.scalar<tstring>()();
 
     const Tensor& memory_tensor = context->input(1);
-    const string memory = memory_tensor.scalar<tstring>()();
+    const tstring& memory = memory_tensor.scalar<tstring>()();
 
     std::unique_ptr<ArchiveRandomAccessFile> file(new ArchiveRandomAccessFile(
         env_, filename, memory.data(), memory.size()));
@@ -88,19 +584,17 @@ class ListArchiveEntriesOp : public OpKernel {
         archive_read_support_filter_gzip(archive.get());
         archive_read_support_format_raw(archive.get());
       }
+      if (filter == "tar") {
+        archive_read_support_filter_none(archive.get());
+        archive_read_support_format_tar(archive.get());
+      }
       if (filter == "tar.gz") {
         archive_read_support_filter_gzip(archive.get());
         archive_read_support_format_tar(archive.get());
       }
     }
 
-    OP_REQUIRES(
-        context,
-        (archive_read_open(archive.get(), file.get(), NULL,
-                           ArchiveRandomAccessFile::CallbackRead,
-                           NULL) == ARCHIVE_OK),
-        errors::InvalidArgument("unable to open datainput for ", filename, ": ",
-                                archive_error_string(archive.get())));
+    OP_REQUIRES_OK(context, file->Open(archive.get()));
 
     string format;
     std::vector<string> entries;
@@ -128,9 +622,14 @@ class ListArchiveEntriesOp : public OpKernel {
               break;
             }
           }
+          if (filter == "tar") {
+            if (IsTarFormat(archive_format) && archive_filter == "none") {
+              format = "tar";
+              break;
+            }
+          }
           if (filter == "tar.gz") {
-            if (archive_format == "GNU tar format" &&
-                archive_filter == "gzip") {
+            if (IsTarFormat(archive_format) && archive_filter == "gzip") {
               format = "tar.gz";
               break;
             }
@@ -141,6 +640,16 @@ class ListArchiveEntriesOp : public OpKernel {
             context, format != "",
             errors::InvalidArgument("unsupported archive: ", archive_format,
                                     "|", archive_filter));
+        // The entries of an indexed archive are those of the index, which
+        // ReadArchive then reuses.
+        if (format == "tar" || (format == "tar.gz" && seek_index_)) {
+          std::shared_ptr<const ArchiveIndex> index;
+          OP_REQUIRES_OK(context, ArchiveIndexCache::Default()->Get(
+                                      filename, format, memory.empty(),
+                                      file.get(), &index));
+          entries = index->names;
+          break;
+        }
       }
     }
 
@@ -164,12 +673,14 @@ class ListArchiveEntriesOp : public OpKernel {
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::vector<string> filters_ TF_GUARDED_BY(mu_);
+  bool seek_index_ TF_GUARDED_BY(mu_);
 };
 
 class ReadArchiveOp : public OpKernel {
  public:
   explicit ReadArchiveOp(OpKernelConstruction* context) : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("seek_index", &seek_index_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -191,7 +702,7 @@ class ReadArchiveOp : public OpKernel {
     }
 
     const Tensor& memory_tensor = context->input(3);
-    const string memory = memory_tensor.scalar<tstring>()();
+    const tstring& memory = memory_tensor.scalar<tstring>()();
 
     Tensor* output_tensor;
     OP_REQUIRES_OK(context,
@@ -214,6 +725,16 @@ class ReadArchiveOp : public OpKernel {
       return;
     }
 
+    if (format == "tar" || (format == "tar.gz" && seek_index_)) {
+      std::shared_ptr<const ArchiveIndex> index;
+      OP_REQUIRES_OK(context, ArchiveIndexCache::Default()->Get(
+                                  filename, format, memory.empty(),
+                                  file.get(), &index));
+      OP_REQUIRES_OK(context, ReadIndexed(context, file.get(), format, *index,
+                                          entries_tensor, output_tensor));
+      return;
+    }
+
     std::unique_ptr<struct archive, void (*)(struct archive*)> archive(
         archive_read_new(), [](struct archive* a) { archive_read_free(a); });
     if (format == "gz") {
@@ -239,13 +760,7 @@ class ReadArchiveOp : public OpKernel {
                   errors::InvalidArgument("unsupported format: ", format));
     }
 
-    OP_REQUIRES(
-        context,
-        (archive_read_open(archive.get(), file.get(), NULL,
-                           ArchiveRandomAccessFile::CallbackRead,
-                           NULL) == ARCHIVE_OK),
-        errors::InvalidArgument("unable to open datainput for ", filename, ": ",
-                                archive_error_string(archive.get())));
+    OP_REQUIRES_OK(context, file->Open(archive.get()));
 
     struct archive_entry* entry;
     while (archive_read_next_header(archive.get(), &entry) == ARCHIVE_OK) {
@@ -271,8 +786,52 @@ class ReadArchiveOp : public OpKernel {
   }
 
  private:
+  // Reads the entries from the index, each directly from its offset for a
+  // tar or from the access point before it for a tar.gz, in parallel.
+  Status ReadIndexed(OpKernelContext* context, ArchiveRandomAccessFile* file,
+                     const string& format, const ArchiveIndex& index,
+                     const Tensor& entries_tensor, Tensor* output_tensor) {
+    const int64 count = entries_tensor.NumElements();
+    std::vector<Status> statuses(count);
+    // Each unit of work is one entry, so the cost keeps them on their own
+    // threads.
+    static constexpr int64 kCostPerEntry = 1 << 20;
+    const DeviceBase::CpuWorkerThreads* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerEntry, [&](int64 begin, int64 end) {
+            for (int64 i = begin; i < end; i++) {
+              auto it = index.entries.find(entries_tensor.flat<tstring>()(i));
+              if (it == index.entries.end()) {
+                continue;
+              }
+              const ArchiveIndex::Entry& entry = it->second;
+              tstring& output = output_tensor->flat<tstring>()(i);
+              output.resize_uninitialized(entry.size);
+              if (format == "tar.gz") {
+                statuses[i] = ReadGzipTarEntry(file, index, entry.offset,
+                                               entry.size, &output[0]);
+                continue;
+              }
+              size_t bytes_read = 0;
+              statuses[i] =
+                  file->ReadAt(entry.offset, entry.size, &output[0],
+                               &bytes_read);
+              if (statuses[i].ok() &&
+                  bytes_read != static_cast<size_t>(entry.size)) {
+                statuses[i] = errors::DataLoss("truncated entry ", it->first);
+              }
+            }
+          });
+    for (const Status& status : statuses) {
+      TF_RETURN_IF_ERROR(status);
+    }
+    return OkStatus();
+  }
+
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  bool seek_index_ TF_GUARDED_BY(mu_);
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>ListArchiveEntries").Device(DEVICE_CPU),
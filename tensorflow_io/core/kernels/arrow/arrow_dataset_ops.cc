@@ -13,14 +13,31 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "arrow/api.h"
+#include "arrow/compute/api.h"
+#include "arrow/dataset/api.h"
+#include "arrow/filesystem/api.h"
+#include "arrow/flight/api.h"
 #include "arrow/io/stdio.h"
 #include "arrow/ipc/api.h"
 #include "arrow/result.h"
+#include "arrow/util/byte_size.h"
+#include "parquet/properties.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_kernels.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_stream_client.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_util.h"
@@ -66,6 +83,372 @@ Status GetBatchMode(string batch_mode_str, ArrowBatchMode* batch_mode) {
   return OkStatus();
 }
 
+// Arrow buffer over the string of a scalar string tensor, holds a reference to
+// the tensor so that the string outlives any slice of the buffer
+class TensorStringBuffer : public arrow::Buffer {
+ public:
+  explicit TensorStringBuffer(const Tensor& tensor)
+      : arrow::Buffer(reinterpret_cast<const uint8_t*>(
+                          tensor.scalar<tstring>()().data()),
+                      tensor.scalar<tstring>()().size()),
+        tensor_(tensor) {}
+
+ private:
+  const Tensor tensor_;
+};
+
+// Limits of the queue of record batches that are read ahead on a background
+// thread, read-ahead is disabled if max_batches is 0
+struct ArrowReadAheadOptions {
+  int64 max_batches = 0;
+  // The queue is also full once it holds max_bytes of batches, 0 for no limit
+  int64 max_bytes = 0;
+};
+
+// How the selected columns are converted to output tensors
+struct ArrowColumnOptions {
+  // Thresholds of a batch to convert its columns in parallel on the inter-op
+  // thread pool, parallel conversion is disabled if parallel_min_columns is 0
+  int64 parallel_min_columns = 0;
+  // Estimated bytes of the selected rows of all columns
+  int64 parallel_min_bytes = 0;
+  // Positions in the selected columns of list columns that are output as the
+  // flat values and int32 row splits of a RaggedTensor
+  std::vector<int32> ragged_columns;
+  // Positions of dictionary columns that are output as int64 indices and the
+  // dictionary values
+  std::vector<int32> dictionary_columns;
+};
+
+// How a selected column is output, as one dense tensor, or as two component
+// tensors: the values and row splits of a ragged column, or the indices and
+// dictionary of a dictionary column
+enum class ArrowColumnEncoding { kDense, kRagged, kDictionary };
+
+// Get the encoding of each of the selected columns
+std::vector<ArrowColumnEncoding> GetColumnEncodings(
+    size_t num_columns, const ArrowColumnOptions& options) {
+  std::vector<ArrowColumnEncoding> encodings(num_columns,
+                                             ArrowColumnEncoding::kDense);
+  for (int32 i : options.ragged_columns) {
+    if (i >= 0 && static_cast<size_t>(i) < num_columns) {
+      encodings[i] = ArrowColumnEncoding::kRagged;
+    }
+  }
+  for (int32 i : options.dictionary_columns) {
+    if (i >= 0 && static_cast<size_t>(i) < num_columns) {
+      encodings[i] = ArrowColumnEncoding::kDictionary;
+    }
+  }
+  return encodings;
+}
+
+// Get the index of the first output component of each column
+std::vector<size_t> GetComponentOffsets(
+    const std::vector<ArrowColumnEncoding>& encodings) {
+  std::vector<size_t> offsets;
+  offsets.reserve(encodings.size());
+  size_t offset = 0;
+  for (ArrowColumnEncoding encoding : encodings) {
+    offsets.push_back(offset);
+    offset += encoding == ArrowColumnEncoding::kDense ? 1 : 2;
+  }
+  return offsets;
+}
+
+// Check the ragged and dictionary positions are valid for the selected
+// columns, and that the outputs have a type for every component
+Status ValidateColumnOptions(const ArrowColumnOptions& options,
+                             size_t num_columns, size_t num_outputs,
+                             const int64 batch_size,
+                             const ArrowBatchMode batch_mode) {
+  std::vector<bool> seen(num_columns, false);
+  for (const std::vector<int32>* positions :
+       {&options.ragged_columns, &options.dictionary_columns}) {
+    for (int32 i : *positions) {
+      if (i < 0 || static_cast<size_t>(i) >= num_columns) {
+        return errors::InvalidArgument("Column position ", i,
+                                       " is out of range for ", num_columns,
+                                       " selected columns");
+      }
+      if (seen[i]) {
+        return errors::InvalidArgument("Column position ", i,
+                                       " is listed more than once");
+      }
+      seen[i] = true;
+    }
+  }
+  if (!options.ragged_columns.empty() && batch_size == 0 &&
+      batch_mode != ArrowBatchMode::BATCH_AUTO) {
+    return errors::InvalidArgument("Ragged columns require batching");
+  }
+  size_t num_components = num_columns + options.ragged_columns.size() +
+                          options.dictionary_columns.size();
+  if (num_components != num_outputs) {
+    return errors::InvalidArgument("Expected ", num_components,
+                                   " output types for the column components",
+                                   ", received: ", num_outputs);
+  }
+  return OkStatus();
+}
+
+// Record batch reader that reads the batches of another source on a
+// background thread into a bounded queue, so that the IPC reads and
+// deserialization overlap with the consumer. The queued bytes are accounted
+// to the process-wide MemoryBudget, and the queue is also full while the
+// budget is exhausted. The source is only called from the background thread.
+// Destruction waits for a read in progress.
+class ReadAheadRecordBatchReader : public arrow::RecordBatchReader {
+ public:
+  using ReadNextFn =
+      std::function<arrow::Status(std::shared_ptr<arrow::RecordBatch>*)>;
+
+  ReadAheadRecordBatchReader(Env* env, std::shared_ptr<arrow::Schema> schema,
+                             ReadNextFn read_next,
+                             const ArrowReadAheadOptions& options)
+      : schema_(std::move(schema)),
+        read_next_(std::move(read_next)),
+        options_(options) {
+    thread_.reset(env->StartThread(ThreadOptions(), "arrow_read_ahead",
+                                   [this]() { ReadLoop(); }));
+  }
+
+  ~ReadAheadRecordBatchReader() override {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cond_var_.notify_all();
+    }
+    // Joins the background thread
+    thread_.reset();
+    mutex_lock l(mu_);
+    io::MemoryBudget::Global()->Release(kBudgetComponent, queued_bytes_);
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  // Returns the next batch, nullptr at the end of the source or if reading
+  // the source failed with the returned status
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    mutex_lock l(mu_);
+    while (queue_.empty() && !done_) {
+      cond_var_.wait(l);
+    }
+    if (queue_.empty()) {
+      *batch = nullptr;
+      return status_;
+    }
+    *batch = std::move(queue_.front().first);
+    queued_bytes_ -= queue_.front().second;
+    io::MemoryBudget::Global()->Release(kBudgetComponent,
+                                        queue_.front().second);
+    queue_.pop_front();
+    cond_var_.notify_all();
+    return arrow::Status::OK();
+  }
+
+ private:
+  void ReadLoop() {
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        while (!cancelled_ && IsFullLocked()) {
+          cond_var_.wait(l);
+        }
+        if (cancelled_) {
+          return;
+        }
+      }
+      std::shared_ptr<arrow::RecordBatch> batch;
+      arrow::Status status = read_next_(&batch);
+      mutex_lock l(mu_);
+      if (!status.ok() || batch == nullptr) {
+        status_ = status;
+        done_ = true;
+        cond_var_.notify_all();
+        return;
+      }
+      int64 bytes = arrow::util::TotalBufferSize(*batch);
+      queued_bytes_ += bytes;
+      io::MemoryBudget::Global()->Reserve(kBudgetComponent, bytes);
+      queue_.emplace_back(std::move(batch), bytes);
+      cond_var_.notify_all();
+    }
+  }
+
+  // The queue holds at least one batch regardless of the byte limit and of
+  // the memory budget
+  bool IsFullLocked() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return static_cast<int64>(queue_.size()) >= options_.max_batches ||
+           (!queue_.empty() &&
+            ((options_.max_bytes > 0 && queued_bytes_ >= options_.max_bytes) ||
+             io::MemoryBudget::Global()->Exhausted()));
+  }
+
+  static constexpr char kBudgetComponent[] = "arrow_read_ahead";
+
+  const std::shared_ptr<arrow::Schema> schema_;
+  const ReadNextFn read_next_;
+  const ArrowReadAheadOptions options_;
+  mutex mu_;
+  condition_variable cond_var_;
+  std::deque<std::pair<std::shared_ptr<arrow::RecordBatch>, int64>> queue_
+      TF_GUARDED_BY(mu_);
+  int64 queued_bytes_ TF_GUARDED_BY(mu_) = 0;
+  bool done_ TF_GUARDED_BY(mu_) = false;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  arrow::Status status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_;
+};
+
+// Record batch reader over the endpoints of a Flight. Up to num_threads
+// endpoints are streamed concurrently on background threads into a bounded
+// queue, so the batches of different endpoints may interleave. Batches of one
+// endpoint are returned in order, and all batches in order if num_threads is
+// 1. Endpoints without a location are read from default_location.
+class FlightEndpointsReader : public arrow::RecordBatchReader {
+ public:
+  FlightEndpointsReader(Env* env, std::shared_ptr<arrow::Schema> schema,
+                        const arrow::flight::Location& default_location,
+                        std::vector<arrow::flight::FlightEndpoint> endpoints,
+                        int num_threads)
+      : schema_(std::move(schema)),
+        default_location_(default_location),
+        endpoints_(std::move(endpoints)),
+        max_queued_batches_(2 * num_threads) {
+    num_threads = std::min<int>(num_threads, endpoints_.size());
+    num_active_ = num_threads;
+    for (int i = 0; i < num_threads; i++) {
+      threads_.emplace_back(env->StartThread(
+          ThreadOptions(), "arrow_flight_endpoint", [this]() { ReadLoop(); }));
+    }
+  }
+
+  ~FlightEndpointsReader() override {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      for (arrow::flight::FlightStreamReader* stream : streams_) {
+        stream->Cancel();
+      }
+      cond_var_.notify_all();
+    }
+    // Joins the background threads
+    threads_.clear();
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  // Returns the next batch, nullptr once all endpoints have been read. Fails
+  // if reading any of the endpoints failed.
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    mutex_lock l(mu_);
+    while (queue_.empty() && num_active_ > 0 && status_.ok()) {
+      cond_var_.wait(l);
+    }
+    ARROW_RETURN_NOT_OK(status_);
+    if (queue_.empty()) {
+      *batch = nullptr;
+      return arrow::Status::OK();
+    }
+    *batch = std::move(queue_.front());
+    queue_.pop_front();
+    cond_var_.notify_all();
+    return arrow::Status::OK();
+  }
+
+ private:
+  void ReadLoop() {
+    // Each thread keeps a client to the location of its last endpoint
+    std::unique_ptr<arrow::flight::FlightClient> client;
+    std::string client_uri;
+    while (true) {
+      size_t index;
+      {
+        mutex_lock l(mu_);
+        if (cancelled_ || next_endpoint_ >= endpoints_.size()) {
+          break;
+        }
+        index = next_endpoint_++;
+      }
+      arrow::Status status = ReadEndpoint(endpoints_[index], &client,
+                                          &client_uri);
+      if (!status.ok()) {
+        mutex_lock l(mu_);
+        if (status_.ok() && !cancelled_) {
+          status_ = status;
+        }
+        cancelled_ = true;
+        break;
+      }
+    }
+    mutex_lock l(mu_);
+    num_active_--;
+    cond_var_.notify_all();
+  }
+
+  arrow::Status ReadEndpoint(
+      const arrow::flight::FlightEndpoint& endpoint,
+      std::unique_ptr<arrow::flight::FlightClient>* client,
+      std::string* client_uri) {
+    const arrow::flight::Location& location = endpoint.locations.empty()
+                                                  ? default_location_
+                                                  : endpoint.locations[0];
+    if (*client == nullptr || *client_uri != location.ToString()) {
+      client->reset();
+      ARROW_RETURN_NOT_OK(
+          arrow::flight::FlightClient::Connect(location, client));
+      *client_uri = location.ToString();
+    }
+    std::unique_ptr<arrow::flight::FlightStreamReader> stream;
+    ARROW_RETURN_NOT_OK((*client)->DoGet(endpoint.ticket, &stream));
+    {
+      mutex_lock l(mu_);
+      if (cancelled_) {
+        return arrow::Status::OK();
+      }
+      streams_.insert(stream.get());
+    }
+    arrow::Status status;
+    while (true) {
+      arrow::flight::FlightStreamChunk chunk;
+      status = stream->Next(&chunk);
+      if (!status.ok() || chunk.data == nullptr) {
+        break;
+      }
+      mutex_lock l(mu_);
+      while (!cancelled_ &&
+             static_cast<int>(queue_.size()) >= max_queued_batches_) {
+        cond_var_.wait(l);
+      }
+      if (cancelled_) {
+        break;
+      }
+      queue_.push_back(std::move(chunk.data));
+      cond_var_.notify_all();
+    }
+    mutex_lock l(mu_);
+    streams_.erase(stream.get());
+    // A cancelled stream fails, which is not an error of the dataset
+    return cancelled_ ? arrow::Status::OK() : status;
+  }
+
+  const std::shared_ptr<arrow::Schema> schema_;
+  const arrow::flight::Location default_location_;
+  const std::vector<arrow::flight::FlightEndpoint> endpoints_;
+  const int max_queued_batches_;
+  mutex mu_;
+  condition_variable cond_var_;
+  std::deque<std::shared_ptr<arrow::RecordBatch>> queue_ TF_GUARDED_BY(mu_);
+  std::unordered_set<arrow::flight::FlightStreamReader*> streams_
+      TF_GUARDED_BY(mu_);
+  size_t next_endpoint_ TF_GUARDED_BY(mu_) = 0;
+  int num_active_ TF_GUARDED_BY(mu_) = 0;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  arrow::Status status_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
 // Base class for defining a Dataset over Arrow record batches with an
 // iterator that iterates over rows of the batch to get Tensors
 class ArrowDatasetBase : public DatasetBase {
@@ -73,13 +456,20 @@ class ArrowDatasetBase : public DatasetBase {
   ArrowDatasetBase(OpKernelContext* ctx, const std::vector<int32>& columns,
                    const int64 batch_size, const ArrowBatchMode batch_mode,
                    const DataTypeVector& output_types,
-                   const std::vector<PartialTensorShape>& output_shapes)
+                   const std::vector<PartialTensorShape>& output_shapes,
+                   const ArrowColumnOptions& column_options,
+                   const ArrowReadAheadOptions& read_ahead =
+                       ArrowReadAheadOptions())
       : DatasetBase(DatasetContext(ctx)),
         columns_(columns),
         batch_size_(batch_size),
         batch_mode_(batch_mode),
         output_types_(output_types),
-        output_shapes_(output_shapes) {}
+        output_shapes_(output_shapes),
+        column_options_(column_options),
+        read_ahead_(read_ahead),
+        encodings_(GetColumnEncodings(columns.size(), column_options)),
+        component_offsets_(GetComponentOffsets(encodings_)) {}
 
   const DataTypeVector& output_dtypes() const override { return output_types_; }
 
@@ -87,6 +477,10 @@ class ArrowDatasetBase : public DatasetBase {
     return output_shapes_;
   }
 
+  // Returns true if the memory of the record batches is kept alive by the
+  // Arrow buffers, so that output tensors may alias it and outlive the dataset
+  virtual bool CanAliasBuffers() const { return true; }
+
  protected:
   // Abstract base class for iterating over rows of Arrow record
   // batches. Implementations will define how record batches are
@@ -106,11 +500,12 @@ class ArrowDatasetBase : public DatasetBase {
       // If in initial state, setup and read first batch
       if (current_batch_ == nullptr && current_row_idx_ == 0) {
         TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        dictionaries_.resize(this->dataset()->columns_.size());
       }
 
-      std::vector<Tensor>* result_tensors = out_tensors;
-      auto partial_batches =
-          std::vector<std::shared_ptr<std::vector<Tensor>>>();
+      // Zero-copy slices of the record batches of a batch that spans more
+      // than one record batch, copied once into the output tensors
+      std::vector<std::shared_ptr<arrow::RecordBatch>> partial_batches;
       int64 partial_batch_size = 0;
       bool have_result = false;
 
@@ -119,7 +514,11 @@ class ArrowDatasetBase : public DatasetBase {
         // Try to go to next batch if consumed all rows in current batch
         if (current_batch_ != nullptr &&
             current_row_idx_ >= current_batch_->num_rows()) {
+          io::IOTrace trace("arrow", io::IOTraceStage::kIOWait);
           TF_RETURN_IF_ERROR(NextStreamLocked(ctx->env()));
+          if (current_batch_ != nullptr) {
+            trace.AddRecords(current_batch_->num_rows());
+          }
         }
 
         // Check if reached end of stream
@@ -131,8 +530,8 @@ class ArrowDatasetBase : public DatasetBase {
           if (partial_batch_size > 0 &&
               this->dataset()->batch_mode_ !=
                   ArrowBatchMode::BATCH_DROP_REMAINDER) {
-            // Copy partial batched tensors to output tensors
-            TF_RETURN_IF_ERROR(AppendPartialTensors(
+            // Copy partial batches to output tensors
+            TF_RETURN_IF_ERROR(AssemblePartialBatchesLocked(
                 ctx, partial_batch_size, partial_batches, out_tensors));
             have_result = true;
             // No more results, so end the sequence
@@ -150,48 +549,43 @@ class ArrowDatasetBase : public DatasetBase {
                   // Use set batch size minus any partials already read
                   this->dataset()->batch_size_ - partial_batch_size;
 
-          // Prepare a partial batch to save, either current record batch is too
-          // small or continuing to fill previous partial batch
+          // Save a slice of a partial batch, either current record batch is
+          // too small or continuing to fill previous partial batch
           if (batch_size != 0 &&
               (partial_batch_size > 0 ||
                current_row_idx_ + batch_size > current_batch_->num_rows())) {
             int64 rows_remaining =
                 current_batch_->num_rows() - current_row_idx_;
             batch_size = std::min(batch_size, rows_remaining);
-            partial_batches.push_back(std::make_shared<std::vector<Tensor>>());
-            result_tensors = partial_batches.back().get();
+            partial_batches.push_back(
+                current_batch_->Slice(current_row_idx_, batch_size));
             partial_batch_size += batch_size;
-          }
-
-          // Assign Tensors for each column in the current row
-          for (size_t i = 0; i < this->dataset()->columns_.size(); ++i) {
-            int32 col = this->dataset()->columns_[i];
-            DataType output_type = this->dataset()->output_types_[i];
-            std::shared_ptr<arrow::Array> arr = current_batch_->column(col);
-
-            // Get the TensorShape for the column batch
-            TensorShape output_shape = TensorShape({});
-            TF_RETURN_IF_ERROR(ArrowUtil::AssignShape(
-                arr, current_row_idx_, batch_size, &output_shape));
 
-            // Allocate a new tensor and assign Arrow data to it
-            Tensor tensor(ctx->allocator({}), output_type, output_shape);
-            TF_RETURN_IF_ERROR(
-                ArrowUtil::AssignTensor(arr, current_row_idx_, &tensor));
-
-            result_tensors->emplace_back(std::move(tensor));
-          }
-
-          // If not batching or have a full batch, then have a result to return
-          if (partial_batch_size == 0 ||
-              partial_batch_size == this->dataset()->batch_size_) {
-            have_result = true;
-
-            // If have partial batches, copy partial tensors to output tensors
-            if (!partial_batches.empty()) {
-              TF_RETURN_IF_ERROR(AppendPartialTensors(
+            // If have a full batch, copy the slices to output tensors
+            if (partial_batch_size == this->dataset()->batch_size_) {
+              TF_RETURN_IF_ERROR(AssemblePartialBatchesLocked(
                   ctx, partial_batch_size, partial_batches, out_tensors));
+              have_result = true;
             }
+          } else {
+            // Whole record batches are returned in auto batch mode, so the
+            // tensors can alias the Arrow buffers without keeping more than
+            // the current batch alive
+            const bool alias_buffers =
+                this->dataset()->batch_mode_ == ArrowBatchMode::BATCH_AUTO &&
+                this->dataset()->CanAliasBuffers();
+
+            // Assign Tensors for each column in the current row
+            std::shared_ptr<arrow::RecordBatch> batch = current_batch_;
+            int64 row_idx = current_row_idx_;
+            TF_RETURN_IF_ERROR(ConvertColumns(
+                ctx, UseParallelColumnsLocked(batch_size),
+                [&](size_t i, Tensor* tensor) {
+                  return ConvertColumn(ctx, batch, i, row_idx, batch_size,
+                                       alias_buffers, tensor);
+                },
+                out_tensors));
+            have_result = true;
           }
 
           // Increment to next row or batch
@@ -205,73 +599,252 @@ class ArrowDatasetBase : public DatasetBase {
     }
 
    private:
-    Status AppendPartialTensors(
+    // Convert the rows of column i of the batch to a tensor
+    Status ConvertColumn(IteratorContext* ctx,
+                         const std::shared_ptr<arrow::RecordBatch>& batch,
+                         size_t i, int64 row_idx, int64 batch_size,
+                         bool alias_buffers, Tensor* tensor) {
+      int32 col = this->dataset()->columns_[i];
+      size_t offset = this->dataset()->component_offsets_[i];
+      std::shared_ptr<arrow::Array> arr = batch->column(col);
+      switch (this->dataset()->encodings_[i]) {
+        case ArrowColumnEncoding::kRagged:
+          return ConvertRaggedColumn(ctx, i, {arr->Slice(row_idx, batch_size)},
+                                     alias_buffers, tensor);
+        case ArrowColumnEncoding::kDictionary:
+          return ConvertDictionaryColumn(
+              ctx, i, {arr->Slice(row_idx, std::max<int64>(batch_size, 1))},
+              batch_size == 0, tensor);
+        case ArrowColumnEncoding::kDense:
+          break;
+      }
+      DataType output_type = this->dataset()->output_types_[offset];
+
+      // Get the TensorShape for the column batch
+      TensorShape output_shape = TensorShape({});
+      TF_RETURN_IF_ERROR(
+          ArrowUtil::AssignShape(arr, row_idx, batch_size, &output_shape));
+
+      // Alias the Arrow data if possible, otherwise allocate a new tensor and
+      // assign Arrow data to it
+      bool aliased = false;
+      if (alias_buffers) {
+        TF_RETURN_IF_ERROR(ArrowUtil::AliasTensor(
+            arr, row_idx, output_type, output_shape, tensor, &aliased));
+      }
+      if (!aliased) {
+        *tensor = Tensor(ctx->allocator({}), output_type, output_shape);
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignTensor(arr, row_idx, tensor));
+      }
+      return OkStatus();
+    }
+
+    // Copy column i of the slices of partial batches into one tensor of
+    // batch_size rows, each slice is assigned to its rows of the tensor
+    Status AssembleColumn(
         IteratorContext* ctx, int64 batch_size,
-        const std::vector<std::shared_ptr<std::vector<Tensor>>>& partials,
-        std::vector<Tensor>* out_tensors) {
+        const std::vector<std::shared_ptr<arrow::RecordBatch>>& partials,
+        size_t i, Tensor* tensor) {
+      int32 col = this->dataset()->columns_[i];
+      ArrowColumnEncoding encoding = this->dataset()->encodings_[i];
+      if (encoding != ArrowColumnEncoding::kDense) {
+        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        arrays.reserve(partials.size());
+        for (const std::shared_ptr<arrow::RecordBatch>& partial : partials) {
+          arrays.push_back(partial->column(col));
+        }
+        if (encoding == ArrowColumnEncoding::kRagged) {
+          return ConvertRaggedColumn(ctx, i, arrays, false, tensor);
+        }
+        return ConvertDictionaryColumn(ctx, i, arrays, false, tensor);
+      }
+      size_t offset = this->dataset()->component_offsets_[i];
+      DataType output_type = this->dataset()->output_types_[offset];
       int64 batch_index = 0;
+      for (const std::shared_ptr<arrow::RecordBatch>& partial : partials) {
+        std::shared_ptr<arrow::Array> arr = partial->column(col);
+        TensorShape partial_shape = TensorShape({});
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignShape(arr, 0, partial->num_rows(),
+                                                  &partial_shape));
+
+        // Allocate tensor sized to batch on first slice
+        if (batch_index == 0) {
+          TensorShape shape = partial_shape;
+          shape.set_dim(0, batch_size);
+          *tensor = Tensor(ctx->allocator({}), output_type, shape);
+        } else {
+          for (int d = 1; d < partial_shape.dims(); ++d) {
+            if (partial_shape.dim_size(d) != tensor->dim_size(d)) {
+              return errors::InvalidArgument(
+                  "Batching variable-length arrays is unsupported");
+            }
+          }
+        }
 
-      // If only one partial batch, can just move to output
-      if (partials.size() == 1) {
-        *out_tensors = std::move(*partials.at(0).get());
-        return OkStatus();
+        // Assign the slice to its rows of the output batch
+        Tensor rows =
+            tensor->Slice(batch_index, batch_index + partial->num_rows());
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignTensor(arr, 0, &rows));
+        batch_index += partial->num_rows();
       }
+      return OkStatus();
+    }
 
-      // Copy all partial tensors to a single output tensor
-      for (auto it_partial = partials.begin(); it_partial != partials.end();
-           it_partial++) {
-        int64 partial_batch_size = 0;
-        for (size_t i = 0; i < (*it_partial)->size(); ++i) {
-          const Tensor& element = (*it_partial)->at(i);
-          partial_batch_size = element.dim_size(0);
-
-          // Allocate tensor sized to batch on first iteration
-          if (it_partial == partials.begin()) {
-            TensorShape shape = element.shape();
-            shape.set_dim(0, batch_size);
-            Tensor output(ctx->allocator({}), element.dtype(), shape);
-            out_tensors->emplace_back(std::move(output));
-          }
+    // Convert the rows of ragged column i to its values and row splits
+    // components at tensors[0] and tensors[1]
+    Status ConvertRaggedColumn(
+        IteratorContext* ctx, size_t i,
+        const std::vector<std::shared_ptr<arrow::Array>>& arrays, bool alias,
+        Tensor* tensors) {
+      size_t offset = this->dataset()->component_offsets_[i];
+      DataType values_type = this->dataset()->output_types_[offset];
+      return ArrowUtil::AssignRaggedTensor(arrays, ctx->allocator({}),
+                                           values_type, alias, &tensors[0],
+                                           &tensors[1]);
+    }
 
-          // Copy partial batch to the output batch
-          TF_RETURN_IF_ERROR(
-              CopyElementsToParent(element, &out_tensors->at(i), batch_index));
+    // Convert the rows of dictionary column i to its indices and dictionary
+    // components at tensors[0] and tensors[1]. The dictionary tensor is
+    // converted once and reused while the record batches share it, so only
+    // the indices are converted for each batch
+    Status ConvertDictionaryColumn(
+        IteratorContext* ctx, size_t i,
+        const std::vector<std::shared_ptr<arrow::Array>>& arrays, bool scalar,
+        Tensor* tensors) {
+      std::shared_ptr<arrow::Array> dictionary;
+      for (const std::shared_ptr<arrow::Array>& array : arrays) {
+        if (array->type_id() != arrow::Type::DICTIONARY) {
+          continue;
+        }
+        const std::shared_ptr<arrow::Array>& array_dictionary =
+            static_cast<const arrow::DictionaryArray&>(*array).dictionary();
+        if (dictionary == nullptr) {
+          dictionary = array_dictionary;
+        } else if (dictionary != array_dictionary &&
+                   !dictionary->Equals(array_dictionary)) {
+          return errors::InvalidArgument(
+              "Batching rows of dictionary arrays with different "
+              "dictionaries is unsupported");
         }
-        batch_index += partial_batch_size;
       }
-      return OkStatus();
-    }
+      TF_RETURN_IF_ERROR(ArrowUtil::AssignDictionaryIndices(
+          arrays, ctx->allocator({}), &tensors[0]));
+      if (scalar) {
+        Tensor index(DT_INT64, TensorShape({}));
+        if (!index.CopyFrom(tensors[0], TensorShape({}))) {
+          return errors::Internal("Expected one dictionary index");
+        }
+        tensors[0] = std::move(index);
+      }
 
-    template <typename T>
-    Status HandleElementsToParent(const Tensor& element, Tensor* parent,
-                                  int64 index) {
-      // TODO: look into removing this loop, move tensor instead of copy
-      for (int64 i = 0; i < element.dim_size(0); ++i) {
-        parent->flat_outer_dims<T>().chip(index + i, 0) =
-            element.flat_outer_dims<T>().chip(i, 0);
+      // Dictionaries are pre-sized under mu_, each column has its own entry
+      std::pair<std::shared_ptr<arrow::Array>, Tensor>& cached =
+          dictionaries_[i];
+      if (cached.first != dictionary) {
+        size_t offset = this->dataset()->component_offsets_[i];
+        DataType output_type = this->dataset()->output_types_[offset + 1];
+        TensorShape shape = TensorShape({});
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignShape(
+            dictionary, 0, dictionary->length(), &shape));
+        Tensor tensor(ctx->allocator({}), output_type, shape);
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignTensor(dictionary, 0, &tensor));
+        cached = std::make_pair(dictionary, std::move(tensor));
       }
+      tensors[1] = cached.second;
       return OkStatus();
     }
 
-    Status CopyElementsToParent(const Tensor& element, Tensor* parent,
-                                int64 index) {
-#define HANDLE_TYPE(T)                                                   \
-  case DataTypeToEnum<T>::value: {                                       \
-    return HandleElementsToParent<T>(std::move(element), parent, index); \
-  }
+    Status AssemblePartialBatchesLocked(
+        IteratorContext* ctx, int64 batch_size,
+        const std::vector<std::shared_ptr<arrow::RecordBatch>>& partials,
+        std::vector<Tensor>* out_tensors) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return ConvertColumns(
+          ctx, UseParallelColumnsLocked(batch_size),
+          [&](size_t i, Tensor* tensor) {
+            return AssembleColumn(ctx, batch_size, partials, i, tensor);
+          },
+          out_tensors);
+    }
 
-      switch (element.dtype()) {
-        TF_CALL_ALL_TYPES(HANDLE_TYPE);
-        TF_CALL_QUANTIZED_TYPES(HANDLE_TYPE);
-#if TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION == 3
-        TF_CALL_uint32(HANDLE_TYPE);
-        TF_CALL_uint64(HANDLE_TYPE);
-#endif
-#undef HANDLE_TYPE
-        default:
-          return errors::Unimplemented(
-              "CopyElementsToParent Unhandled data type: ", element.dtype());
+    // Check if the columns of a batch of rows are converted in parallel, the
+    // bytes of the rows are estimated from the buffers of the columns of the
+    // current, or else the last record batch
+    bool UseParallelColumnsLocked(int64 batch_size)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const ArrowColumnOptions& options =
+          this->dataset()->column_options_;
+      const std::vector<int32>& columns = this->dataset()->columns_;
+      if (options.parallel_min_columns <= 0 ||
+          static_cast<int64>(columns.size()) < options.parallel_min_columns) {
+        return false;
+      }
+      if (options.parallel_min_bytes <= 0) {
+        return true;
       }
+      if (current_batch_ != nullptr &&
+          current_batch_.get() != bytes_per_row_batch_) {
+        int64 bytes = 0;
+        for (int32 col : columns) {
+          bytes += arrow::util::TotalBufferSize(*current_batch_->column(col));
+        }
+        int64 num_rows = std::max<int64>(current_batch_->num_rows(), 1);
+        bytes_per_row_ = bytes / num_rows;
+        bytes_per_row_batch_ = current_batch_.get();
+      }
+      int64 rows = std::max<int64>(batch_size, 1);
+      return bytes_per_row_ * rows >= options.parallel_min_bytes;
+    }
+
+    // Convert the columns to the output tensors with convert(i, &tensor). In
+    // parallel, the columns are split into one strided group per thread of
+    // the runner of the iterator context, the first group is converted on the
+    // calling thread.
+    Status ConvertColumns(IteratorContext* ctx, bool parallel,
+                          const std::function<Status(size_t, Tensor*)>& convert,
+                          std::vector<Tensor>* out_tensors) {
+      io::IOTrace trace("arrow", io::IOTraceStage::kFill);
+      const size_t num_columns = this->dataset()->columns_.size();
+      const std::vector<size_t>& offsets = this->dataset()->component_offsets_;
+      std::vector<Tensor> tensors(this->dataset()->output_types_.size());
+      size_t num_groups = 1;
+      if (parallel) {
+        num_groups = std::min<size_t>(
+            num_columns, std::max(1, ctx->runner_threadpool_size()));
+      }
+      std::vector<Status> statuses(num_groups);
+      auto convert_group = [&](size_t group) {
+        for (size_t i = group; i < num_columns; i += num_groups) {
+          Status status = convert(i, &tensors[offsets[i]]);
+          if (!status.ok()) {
+            statuses[group] = status;
+            return;
+          }
+        }
+      };
+      if (num_groups > 1) {
+        BlockingCounter counter(num_groups - 1);
+        for (size_t group = 1; group < num_groups; ++group) {
+          (*ctx->runner())([&, group]() {
+            convert_group(group);
+            counter.DecrementCount();
+          });
+        }
+        convert_group(0);
+        counter.Wait();
+      } else {
+        convert_group(0);
+      }
+      for (const Status& status : statuses) {
+        TF_RETURN_IF_ERROR(status);
+      }
+      if (!tensors.empty()) {
+        trace.AddRecords(tensors[0].dims() > 0 ? tensors[0].dim_size(0) : 1);
+      }
+      for (Tensor& tensor : tensors) {
+        trace.AddBytes(tensor.TotalBytes());
+        out_tensors->emplace_back(std::move(tensor));
+      }
+      return OkStatus();
     }
 
    protected:
@@ -305,11 +878,74 @@ class ArrowDatasetBase : public DatasetBase {
       current_row_idx_ = 1;
     }
 
+    // Wraps the reader to read the record batches ahead on a background
+    // thread if read-ahead is enabled for the dataset
+    std::shared_ptr<arrow::RecordBatchReader> MaybeReadAhead(
+        Env* env, std::shared_ptr<arrow::RecordBatchReader> reader) {
+      const ArrowReadAheadOptions& options = this->dataset()->read_ahead_;
+      if (options.max_batches <= 0) {
+        return reader;
+      }
+      std::shared_ptr<arrow::Schema> schema = reader->schema();
+      return std::make_shared<ReadAheadRecordBatchReader>(
+          env, std::move(schema),
+          [reader](std::shared_ptr<arrow::RecordBatch>* batch) {
+            return reader->ReadNext(batch);
+          },
+          options);
+    }
+
+    // Reads the record batches of the file reader in order on a background
+    // thread, nullptr if read-ahead is disabled for the dataset
+    std::shared_ptr<arrow::RecordBatchReader> MaybeReadAheadFile(
+        Env* env, std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader) {
+      const ArrowReadAheadOptions& options = this->dataset()->read_ahead_;
+      if (options.max_batches <= 0) {
+        return nullptr;
+      }
+      int index = 0;
+      return std::make_shared<ReadAheadRecordBatchReader>(
+          env, reader->schema(),
+          [reader, index](
+              std::shared_ptr<arrow::RecordBatch>* batch) mutable {
+            if (index >= reader->num_record_batches()) {
+              *batch = nullptr;
+              return arrow::Status::OK();
+            }
+            ARROW_ASSIGN_OR_RAISE(*batch, reader->ReadRecordBatch(index++));
+            return arrow::Status::OK();
+          },
+          options);
+    }
+
+    // Read the record batch at the index of the file reader into
+    // current_batch_, from the read-ahead reader if there is one
+    Status ReadFileBatchLocked(
+        const std::shared_ptr<arrow::ipc::RecordBatchFileReader>& reader,
+        const std::shared_ptr<arrow::RecordBatchReader>& read_ahead,
+        int index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (read_ahead != nullptr) {
+        CHECK_ARROW(read_ahead->ReadNext(&current_batch_));
+        return OkStatus();
+      }
+      arrow::Result<std::shared_ptr<arrow::RecordBatch>> result =
+          reader->ReadRecordBatch(index);
+      CHECK_ARROW(result.status());
+      current_batch_ = std::move(result).ValueUnsafe();
+      return OkStatus();
+    }
+
     // Check columns of batch in stream are expected data type
     Status CheckBatchColumnTypes(std::shared_ptr<arrow::RecordBatch> batch) {
       for (size_t i = 0; i < this->dataset()->columns_.size(); ++i) {
         int32 col = this->dataset()->columns_[i];
-        DataType dt = this->dataset()->output_types_[i];
+        size_t offset = this->dataset()->component_offsets_[i];
+        if (this->dataset()->encodings_[i] ==
+            ArrowColumnEncoding::kDictionary) {
+          // The values are the second component of a dictionary column
+          offset += 1;
+        }
+        DataType dt = this->dataset()->output_types_[offset];
         std::shared_ptr<arrow::Array> arr = batch->column(col);
         TF_RETURN_IF_ERROR(ArrowUtil::CheckArrayType(arr->type(), dt));
       }
@@ -320,6 +956,13 @@ class ArrowDatasetBase : public DatasetBase {
     std::shared_ptr<arrow::RecordBatch> current_batch_ TF_GUARDED_BY(mu_) =
         nullptr;
     int64_t current_row_idx_ TF_GUARDED_BY(mu_) = 0;
+    // Record batch that bytes_per_row_ was estimated from, compared only
+    const arrow::RecordBatch* bytes_per_row_batch_ TF_GUARDED_BY(mu_) =
+        nullptr;
+    int64 bytes_per_row_ TF_GUARDED_BY(mu_) = 0;
+    // Last dictionary array and its tensor of each dictionary column
+    std::vector<std::pair<std::shared_ptr<arrow::Array>, Tensor>>
+        dictionaries_;
   };
 
   const std::vector<int32> columns_;
@@ -327,6 +970,40 @@ class ArrowDatasetBase : public DatasetBase {
   const ArrowBatchMode batch_mode_;
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
+  const ArrowColumnOptions column_options_;
+  const ArrowReadAheadOptions read_ahead_;
+  const std::vector<ArrowColumnEncoding> encodings_;
+  const std::vector<size_t> component_offsets_;
+
+  // Add the column conversion attributes to the graph attributes
+  void AddColumnAttrs(
+      DatasetGraphDefBuilder* b,
+      std::vector<std::pair<StringPiece, AttrValue>>* attrs) const {
+    AttrValue min_columns;
+    b->BuildAttrValue(column_options_.parallel_min_columns, &min_columns);
+    AttrValue min_bytes;
+    b->BuildAttrValue(column_options_.parallel_min_bytes, &min_bytes);
+    AttrValue ragged_columns;
+    b->BuildAttrValue(column_options_.ragged_columns, &ragged_columns);
+    AttrValue dictionary_columns;
+    b->BuildAttrValue(column_options_.dictionary_columns, &dictionary_columns);
+    attrs->emplace_back("parallel_columns", min_columns);
+    attrs->emplace_back("parallel_columns_min_bytes", min_bytes);
+    attrs->emplace_back("ragged_columns", ragged_columns);
+    attrs->emplace_back("dictionary_columns", dictionary_columns);
+  }
+
+  // Add the read-ahead attributes of the dataset to the graph attributes
+  void AddReadAheadAttrs(
+      DatasetGraphDefBuilder* b,
+      std::vector<std::pair<StringPiece, AttrValue>>* attrs) const {
+    AttrValue max_batches;
+    b->BuildAttrValue(read_ahead_.max_batches, &max_batches);
+    AttrValue max_bytes;
+    b->BuildAttrValue(read_ahead_.max_bytes, &max_bytes);
+    attrs->emplace_back("read_ahead_batches", max_batches);
+    attrs->emplace_back("read_ahead_bytes", max_bytes);
+  }
 };
 
 // Abstract base class to define an Arrow OpKernel with output_types and
@@ -348,6 +1025,14 @@ class ArrowOpKernelBase : public DatasetOpKernel {
                   errors::InvalidArgument("Output shape must be a scalar, "
                                           "vector, matrix or unknown"));
     }
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("parallel_columns",
+                                     &column_options_.parallel_min_columns));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("parallel_columns_min_bytes",
+                                     &column_options_.parallel_min_bytes));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("ragged_columns",
+                                     &column_options_.ragged_columns));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dictionary_columns",
+                                     &column_options_.dictionary_columns));
   }
 
  private:
@@ -374,6 +1059,10 @@ class ArrowOpKernelBase : public DatasetOpKernel {
     ArrowBatchMode batch_mode;
     OP_REQUIRES_OK(ctx, GetBatchMode(batch_mode_str, &batch_mode));
 
+    OP_REQUIRES_OK(ctx, ValidateColumnOptions(column_options_, columns.size(),
+                                              output_types_.size(), batch_size,
+                                              batch_mode));
+
     ArrowDatasetBase* arrow_output;
     MakeArrowDataset(ctx, columns, batch_size, batch_mode, output_types_,
                      output_shapes_, &arrow_output);
@@ -389,8 +1078,23 @@ class ArrowOpKernelBase : public DatasetOpKernel {
       const std::vector<PartialTensorShape>& output_shapes,
       ArrowDatasetBase** output) = 0;
 
+  // Get the read-ahead attributes, for the ops that support read-ahead
+  Status GetReadAheadAttrs(OpKernelConstruction* ctx) {
+    TF_RETURN_IF_ERROR(
+        ctx->GetAttr("read_ahead_batches", &read_ahead_.max_batches));
+    TF_RETURN_IF_ERROR(
+        ctx->GetAttr("read_ahead_bytes", &read_ahead_.max_bytes));
+    if (read_ahead_.max_batches < 0 || read_ahead_.max_bytes < 0) {
+      return errors::InvalidArgument(
+          "read_ahead_batches and read_ahead_bytes must be >= 0");
+    }
+    return OkStatus();
+  }
+
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
+  ArrowColumnOptions column_options_;
+  ArrowReadAheadOptions read_ahead_;
 };
 
 // Op to create an ArrowZeroCopyDataset that consumes Arrow record batches
@@ -398,7 +1102,9 @@ class ArrowOpKernelBase : public DatasetOpKernel {
 class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
  public:
   explicit ArrowZeroCopyDatasetOp(OpKernelConstruction* ctx)
-      : ArrowOpKernelBase(ctx) {}
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, GetReadAheadAttrs(ctx));
+  }
 
   virtual void MakeArrowDataset(
       OpKernelContext* ctx, const std::vector<int32>& columns,
@@ -415,7 +1121,8 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
     OP_REQUIRES_OK(
         ctx, ParseScalarArgument<int64_t>(ctx, "buffer_size", &buffer_size));
     *output = new Dataset(ctx, buffer, buffer_size, columns, batch_size,
-                          batch_mode, output_types_, output_shapes_);
+                          batch_mode, output_types_, output_shapes_,
+                          column_options_, read_ahead_);
   }
 
  private:
@@ -425,9 +1132,11 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
             const int64 buffer_size, const std::vector<int32>& columns,
             const int64 batch_size, const ArrowBatchMode batch_mode,
             const DataTypeVector& output_types,
-            const std::vector<PartialTensorShape>& output_shapes)
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options,
+            const ArrowReadAheadOptions& read_ahead)
         : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
-                           output_shapes),
+                           output_shapes, column_options, read_ahead),
           buffer_ptr_(buffer_ptr),
           buffer_size_(buffer_size) {}
 
@@ -437,6 +1146,10 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
       return "ArrowZeroCopyDatasetOp::Dataset";
     }
 
+    // The buffer is owned in Python and may be released once the dataset is
+    // gone, so the output tensors must not alias it
+    bool CanAliasBuffers() const override { return false; }
+
    protected:
     Status AsGraphDefInternal(SerializationContext* ctx,
                               DatasetGraphDefBuilder* b,
@@ -455,8 +1168,12 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
       tstring batch_mode_str;
       TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
       TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AddReadAheadAttrs(b, &attrs);
       TF_RETURN_IF_ERROR(b->AddDataset(
-          this, {buffer, size, columns, batch_size, batch_mode}, output));
+          this, {buffer, size, columns, batch_size, batch_mode}, attrs,
+          output));
       return OkStatus();
     }
 
@@ -484,11 +1201,10 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
         CHECK_ARROW(result.status());
         reader_ = std::move(result).ValueUnsafe();
         num_batches_ = reader_->num_record_batches();
+        read_ahead_ = MaybeReadAheadFile(env, reader_);
         if (num_batches_ > 0) {
-          arrow::Result<std::shared_ptr<arrow::RecordBatch>> result =
-              reader_->ReadRecordBatch(current_batch_idx_);
-          CHECK_ARROW(result.status());
-          current_batch_ = std::move(result).ValueUnsafe();
+          TF_RETURN_IF_ERROR(
+              ReadFileBatchLocked(reader_, read_ahead_, current_batch_idx_));
           TF_RETURN_IF_ERROR(CheckBatchColumnTypes(current_batch_));
         }
         return OkStatus();
@@ -498,16 +1214,15 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
         ArrowBaseIterator<Dataset>::NextStreamLocked(env);
         if (++current_batch_idx_ < num_batches_) {
-          arrow::Result<std::shared_ptr<arrow::RecordBatch>> result =
-              reader_->ReadRecordBatch(current_batch_idx_);
-          CHECK_ARROW(result.status());
-          current_batch_ = std::move(result).ValueUnsafe();
+          TF_RETURN_IF_ERROR(
+              ReadFileBatchLocked(reader_, read_ahead_, current_batch_idx_));
         }
         return OkStatus();
       }
 
       void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
         ArrowBaseIterator<Dataset>::ResetStreamsLocked();
+        read_ahead_.reset();
         reader_.reset();
         current_batch_idx_ = 0;
         num_batches_ = 0;
@@ -518,6 +1233,7 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
           TF_GUARDED_BY(mu_);
       std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader_
           TF_GUARDED_BY(mu_);
+      std::shared_ptr<arrow::RecordBatchReader> read_ahead_ TF_GUARDED_BY(mu_);
       int current_batch_idx_ TF_GUARDED_BY(mu_) = 0;
       int num_batches_ TF_GUARDED_BY(mu_) = 0;
     };
@@ -532,7 +1248,9 @@ class ArrowZeroCopyDatasetOp : public ArrowOpKernelBase {
 class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
  public:
   explicit ArrowSerializedDatasetOp(OpKernelConstruction* ctx)
-      : ArrowOpKernelBase(ctx) {}
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, GetReadAheadAttrs(ctx));
+  }
 
   virtual void MakeArrowDataset(
       OpKernelContext* ctx, const std::vector<int32>& columns,
@@ -545,7 +1263,8 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
     OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(batches_tensor->shape()),
                 errors::InvalidArgument("serialized_batches must be a scalar"));
     *output = new Dataset(ctx, *batches_tensor, columns, batch_size, batch_mode,
-                          output_types_, output_shapes_);
+                          output_types_, output_shapes_, column_options_,
+                          read_ahead_);
   }
 
  private:
@@ -556,9 +1275,11 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
     Dataset(OpKernelContext* ctx, const Tensor batches_tensor,
             const std::vector<int32>& columns, const int64 batch_size,
             const ArrowBatchMode batch_mode, const DataTypeVector& output_types,
-            const std::vector<PartialTensorShape>& output_shapes)
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options,
+            const ArrowReadAheadOptions& read_ahead)
         : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
-                           output_shapes),
+                           output_shapes, column_options, read_ahead),
           batches_(std::move(batches_tensor)) {}
 
     string DebugString() const override {
@@ -590,8 +1311,11 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
       tstring batch_mode_str;
       TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
       TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AddReadAheadAttrs(b, &attrs);
       TF_RETURN_IF_ERROR(b->AddDataset(
-          this, {batches, columns, batch_size, batch_mode}, output));
+          this, {batches, columns, batch_size, batch_mode}, attrs, output));
       return OkStatus();
     }
 
@@ -610,17 +1334,18 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
      private:
       Status SetupStreamsLocked(Env* env)
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
-        const string& batches = dataset()->batches_.scalar<tstring>()();
-        auto buffer = std::make_shared<arrow::Buffer>(batches);
+        // The buffer holds a reference to the tensor of serialized batches,
+        // output tensors that alias the batches keep it alive
+        auto buffer = std::make_shared<TensorStringBuffer>(dataset()->batches_);
         auto buffer_reader = std::make_shared<arrow::io::BufferReader>(buffer);
         auto result = arrow::ipc::RecordBatchFileReader::Open(buffer_reader);
         CHECK_ARROW(result.status());
         reader_ = std::move(result).ValueUnsafe();
         num_batches_ = reader_->num_record_batches();
+        read_ahead_ = MaybeReadAheadFile(env, reader_);
         if (num_batches_ > 0) {
-          auto result = reader_->ReadRecordBatch(current_batch_idx_);
-          CHECK_ARROW(result.status());
-          current_batch_ = std::move(result).ValueUnsafe();
+          TF_RETURN_IF_ERROR(
+              ReadFileBatchLocked(reader_, read_ahead_, current_batch_idx_));
           TF_RETURN_IF_ERROR(CheckBatchColumnTypes(current_batch_));
         }
         return OkStatus();
@@ -630,15 +1355,15 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
         ArrowBaseIterator<Dataset>::NextStreamLocked(env);
         if (++current_batch_idx_ < num_batches_) {
-          auto result = reader_->ReadRecordBatch(current_batch_idx_);
-          CHECK_ARROW(result.status());
-          current_batch_ = std::move(result).ValueUnsafe();
+          TF_RETURN_IF_ERROR(
+              ReadFileBatchLocked(reader_, read_ahead_, current_batch_idx_));
         }
         return OkStatus();
       }
 
       void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
         ArrowBaseIterator<Dataset>::ResetStreamsLocked();
+        read_ahead_.reset();
         reader_.reset();
         current_batch_idx_ = 0;
         num_batches_ = 0;
@@ -646,6 +1371,7 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
 
       std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader_
           TF_GUARDED_BY(mu_);
+      std::shared_ptr<arrow::RecordBatchReader> read_ahead_ TF_GUARDED_BY(mu_);
       int current_batch_idx_ TF_GUARDED_BY(mu_) = 0;
       int num_batches_ TF_GUARDED_BY(mu_) = 0;
     };
@@ -660,7 +1386,9 @@ class ArrowSerializedDatasetOp : public ArrowOpKernelBase {
 class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
  public:
   explicit ArrowFeatherDatasetOp(OpKernelConstruction* ctx)
-      : ArrowOpKernelBase(ctx) {}
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("memory_map", &memory_map_));
+  }
 
   virtual void MakeArrowDataset(
       OpKernelContext* ctx, const std::vector<int32>& columns,
@@ -680,7 +1408,8 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
     }
 
     *output = new Dataset(ctx, filenames, columns, batch_size, batch_mode,
-                          output_types_, output_shapes_);
+                          output_types_, output_shapes_, column_options_,
+                          memory_map_);
   }
 
  private:
@@ -689,10 +1418,13 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
     Dataset(OpKernelContext* ctx, const std::vector<string>& filenames,
             const std::vector<int32>& columns, const int64 batch_size,
             const ArrowBatchMode batch_mode, const DataTypeVector& output_types,
-            const std::vector<PartialTensorShape>& output_shapes)
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options,
+            const bool memory_map)
         : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
-                           output_shapes),
-          filenames_(filenames) {}
+                           output_shapes, column_options),
+          filenames_(filenames),
+          memory_map_(memory_map) {}
 
     string DebugString() const override {
       return "ArrowFeatherDatasetOp::Dataset";
@@ -714,8 +1446,13 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
       tstring batch_mode_str;
       TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
       TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AttrValue memory_map;
+      b->BuildAttrValue(memory_map_, &memory_map);
+      attrs.emplace_back("memory_map", memory_map);
       TF_RETURN_IF_ERROR(b->AddDataset(
-          this, {filenames, columns, batch_size, batch_mode}, output));
+          this, {filenames, columns, batch_size, batch_mode}, attrs, output));
       return OkStatus();
     }
 
@@ -736,16 +1473,23 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
         const string& filename = dataset()->filenames_[current_file_idx_];
 
+        // Record batches of a memory mapped file reference the mapped pages
+        std::shared_ptr<arrow::io::RandomAccessFile> in_file;
+        if (dataset()->memory_map_) {
+          TF_RETURN_IF_ERROR(OpenMemoryMappedFile(filename, &in_file));
+        }
+
         // Init a TF file from the filename and determine size
         // TODO: set optional memory to nullptr until input arg is added
-        std::shared_ptr<SizedRandomAccessFile> tf_file(
-            new SizedRandomAccessFile(env, filename, nullptr, 0));
-        uint64 size;
-        TF_RETURN_IF_ERROR(tf_file->GetFileSize(&size));
-
-        // Wrap the TF file in Arrow interface to be used in Feather reader
-        std::shared_ptr<ArrowRandomAccessFile> in_file(
-            new ArrowRandomAccessFile(tf_file.get(), size));
+        std::shared_ptr<SizedRandomAccessFile> tf_file;
+        if (in_file == nullptr) {
+          tf_file.reset(new SizedRandomAccessFile(env, filename, nullptr, 0));
+          uint64 size;
+          TF_RETURN_IF_ERROR(tf_file->GetFileSize(&size));
+
+          // Wrap the TF file in Arrow interface to be used in Feather reader
+          in_file.reset(new ArrowRandomAccessFile(tf_file.get(), size));
+        }
 
         // Create the Feather reader
         std::shared_ptr<arrow::ipc::feather::Reader> reader;
@@ -800,7 +1544,10 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
     };
 
     const std::vector<string> filenames_;
+    const bool memory_map_;
   };
+
+  bool memory_map_;
 };
 
 // Op to create an Arrow Dataset that consumes record batches from an input
@@ -810,7 +1557,9 @@ class ArrowFeatherDatasetOp : public ArrowOpKernelBase {
 class ArrowStreamDatasetOp : public ArrowOpKernelBase {
  public:
   explicit ArrowStreamDatasetOp(OpKernelConstruction* ctx)
-      : ArrowOpKernelBase(ctx) {}
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, GetReadAheadAttrs(ctx));
+  }
 
   virtual void MakeArrowDataset(
       OpKernelContext* ctx, const std::vector<int32>& columns,
@@ -830,7 +1579,8 @@ class ArrowStreamDatasetOp : public ArrowOpKernelBase {
     }
 
     *output = new Dataset(ctx, endpoints, columns, batch_size, batch_mode,
-                          output_types_, output_shapes_);
+                          output_types_, output_shapes_, column_options_,
+                          read_ahead_);
   }
 
  private:
@@ -839,9 +1589,11 @@ class ArrowStreamDatasetOp : public ArrowOpKernelBase {
     Dataset(OpKernelContext* ctx, const std::vector<string>& endpoints,
             const std::vector<int32>& columns, const int64 batch_size,
             const ArrowBatchMode batch_mode, const DataTypeVector& output_types,
-            const std::vector<PartialTensorShape>& output_shapes)
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options,
+            const ArrowReadAheadOptions& read_ahead)
         : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
-                           output_shapes),
+                           output_shapes, column_options, read_ahead),
           endpoints_(endpoints) {}
 
     string DebugString() const override {
@@ -864,8 +1616,11 @@ class ArrowStreamDatasetOp : public ArrowOpKernelBase {
       tstring batch_mode_str;
       TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
       TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AddReadAheadAttrs(b, &attrs);
       TF_RETURN_IF_ERROR(b->AddDataset(
-          this, {endpoints, columns, batch_size, batch_mode}, output));
+          this, {endpoints, columns, batch_size, batch_mode}, attrs, output));
       return OkStatus();
     }
 
@@ -904,7 +1659,7 @@ class ArrowStreamDatasetOp : public ArrowOpKernelBase {
         auto result =
             arrow::ipc::RecordBatchStreamReader::Open(in_stream_.get());
         CHECK_ARROW(result.status());
-        reader_ = std::move(result).ValueUnsafe();
+        reader_ = MaybeReadAhead(env, std::move(result).ValueUnsafe());
         CHECK_ARROW(reader_->ReadNext(&current_batch_));
         TF_RETURN_IF_ERROR(CheckBatchColumnTypes(current_batch_));
         return OkStatus();
@@ -938,6 +1693,573 @@ class ArrowStreamDatasetOp : public ArrowOpKernelBase {
   };
 };
 
+// Op to create an ArrowFlightDataset that reads the endpoints of an Arrow
+// Flight. The FlightInfo of the descriptor is fetched from the location, and
+// the endpoints of the shard are streamed concurrently.
+class ArrowFlightDatasetOp : public ArrowOpKernelBase {
+ public:
+  explicit ArrowFlightDatasetOp(OpKernelConstruction* ctx)
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_parallel_endpoints",
+                                     &num_parallel_endpoints_));
+    OP_REQUIRES(ctx, num_parallel_endpoints_ > 0,
+                errors::InvalidArgument("num_parallel_endpoints must be > 0"));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_shards", &num_shards_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("shard_index", &shard_index_));
+    OP_REQUIRES(ctx, num_shards_ > 0,
+                errors::InvalidArgument("num_shards must be > 0"));
+    OP_REQUIRES(ctx, 0 <= shard_index_ && shard_index_ < num_shards_,
+                errors::InvalidArgument("shard_index must be in [0, ",
+                                        num_shards_, ")"));
+  }
+
+  virtual void MakeArrowDataset(
+      OpKernelContext* ctx, const std::vector<int32>& columns,
+      const int64 batch_size, const ArrowBatchMode batch_mode,
+      const DataTypeVector& output_types,
+      const std::vector<PartialTensorShape>& output_shapes,
+      ArrowDatasetBase** output) override {
+    tstring location;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "location", &location));
+
+    const Tensor* descriptor_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("descriptor", &descriptor_tensor));
+    OP_REQUIRES(
+        ctx, descriptor_tensor->dims() <= 1,
+        errors::InvalidArgument("`descriptor` must be a scalar or vector."));
+    std::vector<string> descriptor;
+    descriptor.reserve(descriptor_tensor->NumElements());
+    for (int i = 0; i < descriptor_tensor->NumElements(); ++i) {
+      descriptor.push_back(descriptor_tensor->flat<tstring>()(i));
+    }
+
+    tstring descriptor_type;
+    OP_REQUIRES_OK(
+        ctx, ParseScalarArgument(ctx, "descriptor_type", &descriptor_type));
+    OP_REQUIRES(ctx, descriptor_type == "cmd" || descriptor_type == "path",
+                errors::InvalidArgument(
+                    "`descriptor_type` must be 'cmd' or 'path', received: ",
+                    descriptor_type));
+    OP_REQUIRES(ctx, descriptor_type != "cmd" || descriptor.size() == 1,
+                errors::InvalidArgument(
+                    "`descriptor` must be a single command if "
+                    "`descriptor_type` is 'cmd'."));
+
+    *output = new Dataset(ctx, location, descriptor, descriptor_type, columns,
+                          batch_size, batch_mode, output_types_,
+                          output_shapes_, column_options_,
+                          num_parallel_endpoints_, num_shards_, shard_index_);
+  }
+
+ private:
+  class Dataset : public ArrowDatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const tstring& location,
+            const std::vector<string>& descriptor,
+            const tstring& descriptor_type, const std::vector<int32>& columns,
+            const int64 batch_size, const ArrowBatchMode batch_mode,
+            const DataTypeVector& output_types,
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options,
+            const int64 num_parallel_endpoints, const int64 num_shards,
+            const int64 shard_index)
+        : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
+                           output_shapes, column_options),
+          location_(location),
+          descriptor_(descriptor),
+          descriptor_type_(descriptor_type),
+          num_parallel_endpoints_(num_parallel_endpoints),
+          num_shards_(num_shards),
+          shard_index_(shard_index) {}
+
+    string DebugString() const override {
+      return "ArrowFlightDatasetOp::Dataset";
+    }
+
+    Status CheckExternalState() const override { return OkStatus(); }
+
+   protected:
+    Status AsGraphDefInternal(SerializationContext* ctx,
+                              DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* location = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(location_, &location));
+      Node* descriptor = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(descriptor_, &descriptor));
+      Node* descriptor_type = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(descriptor_type_, &descriptor_type));
+      Node* columns = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(columns_, &columns));
+      Node* batch_size = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+      Node* batch_mode = nullptr;
+      tstring batch_mode_str;
+      TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AttrValue num_parallel_endpoints;
+      b->BuildAttrValue(num_parallel_endpoints_, &num_parallel_endpoints);
+      attrs.emplace_back("num_parallel_endpoints", num_parallel_endpoints);
+      AttrValue num_shards;
+      b->BuildAttrValue(num_shards_, &num_shards);
+      attrs.emplace_back("num_shards", num_shards);
+      AttrValue shard_index;
+      b->BuildAttrValue(shard_index_, &shard_index);
+      attrs.emplace_back("shard_index", shard_index);
+      TF_RETURN_IF_ERROR(b->AddDataset(
+          this,
+          {location, descriptor, descriptor_type, columns, batch_size,
+           batch_mode},
+          attrs, output));
+      return OkStatus();
+    }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return std::unique_ptr<IteratorBase>(
+          new Iterator({this, strings::StrCat(prefix, "::ArrowFlight")}));
+    }
+
+   private:
+    class Iterator : public ArrowBaseIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : ArrowBaseIterator<Dataset>(params) {}
+
+     private:
+      Status SetupStreamsLocked(Env* env)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        arrow::flight::Location location;
+        CHECK_ARROW(
+            arrow::flight::Location::Parse(dataset()->location_, &location));
+        std::unique_ptr<arrow::flight::FlightClient> client;
+        CHECK_ARROW(arrow::flight::FlightClient::Connect(location, &client));
+
+        arrow::flight::FlightDescriptor descriptor =
+            dataset()->descriptor_type_ == "cmd"
+                ? arrow::flight::FlightDescriptor::Command(
+                      dataset()->descriptor_[0])
+                : arrow::flight::FlightDescriptor::Path(
+                      dataset()->descriptor_);
+        std::unique_ptr<arrow::flight::FlightInfo> info;
+        CHECK_ARROW(client->GetFlightInfo(descriptor, &info));
+        arrow::ipc::DictionaryMemo memo;
+        std::shared_ptr<arrow::Schema> schema;
+        CHECK_ARROW(info->GetSchema(&memo, &schema));
+
+        // Endpoints are assigned to the shards round-robin
+        std::vector<arrow::flight::FlightEndpoint> endpoints;
+        const std::vector<arrow::flight::FlightEndpoint>& all_endpoints =
+            info->endpoints();
+        for (size_t i = dataset()->shard_index_; i < all_endpoints.size();
+             i += dataset()->num_shards_) {
+          endpoints.push_back(all_endpoints[i]);
+        }
+        VLOG(5) << "ArrowFlightDataset reads " << endpoints.size() << " of "
+                << all_endpoints.size() << " endpoints";
+
+        reader_ = std::make_shared<FlightEndpointsReader>(
+            env, schema, location, std::move(endpoints),
+            dataset()->num_parallel_endpoints_);
+        CHECK_ARROW(reader_->ReadNext(&current_batch_));
+        if (current_batch_ != nullptr) {
+          TF_RETURN_IF_ERROR(CheckBatchColumnTypes(current_batch_));
+        }
+        return OkStatus();
+      }
+
+      Status NextStreamLocked(Env* env)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        ArrowBaseIterator<Dataset>::NextStreamLocked(env);
+        CHECK_ARROW(reader_->ReadNext(&current_batch_));
+        return OkStatus();
+      }
+
+      void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        ArrowBaseIterator<Dataset>::ResetStreamsLocked();
+        reader_.reset();
+      }
+
+      std::shared_ptr<arrow::RecordBatchReader> reader_ TF_GUARDED_BY(mu_);
+    };
+
+    const tstring location_;
+    const std::vector<string> descriptor_;
+    const tstring descriptor_type_;
+    const int64 num_parallel_endpoints_;
+    const int64 num_shards_;
+    const int64 shard_index_;
+  };
+
+  int64 num_parallel_endpoints_;
+  int64 num_shards_;
+  int64 shard_index_;
+};
+
+// Op to create an ArrowScannerDataset that scans the Parquet, Feather or
+// Arrow IPC fragments under a directory with arrow::dataset. Only the
+// projected columns are read, and the filter is pushed down to skip hive
+// partitions and Parquet row groups by their statistics before the rows are
+// filtered. Parquet files can be split into a fragment per row group, which
+// the scanner reads in parallel, and their column chunks can be pre-buffered
+// with coalesced range reads, e.g. for remote filesystems.
+class ArrowScannerDatasetOp : public ArrowOpKernelBase {
+ public:
+  explicit ArrowScannerDatasetOp(OpKernelConstruction* ctx)
+      : ArrowOpKernelBase(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("split_row_groups", &split_row_groups_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("pre_buffer", &pre_buffer_));
+  }
+
+  virtual void MakeArrowDataset(
+      OpKernelContext* ctx, const std::vector<int32>& columns,
+      const int64 batch_size, const ArrowBatchMode batch_mode,
+      const DataTypeVector& output_types,
+      const std::vector<PartialTensorShape>& output_shapes,
+      ArrowDatasetBase** output) override {
+    tstring path;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "path", &path));
+    tstring format;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "format", &format));
+    OP_REQUIRES(
+        ctx, format == "parquet" || format == "feather" || format == "ipc",
+        errors::InvalidArgument(
+            "`format` must be 'parquet', 'feather' or 'ipc', received: ",
+            format));
+    tstring partitioning;
+    OP_REQUIRES_OK(ctx,
+                   ParseScalarArgument(ctx, "partitioning", &partitioning));
+    OP_REQUIRES(ctx, partitioning.empty() || partitioning == "hive",
+                errors::InvalidArgument(
+                    "`partitioning` must be '' or 'hive', received: ",
+                    partitioning));
+
+    std::vector<string> column_names;
+    OP_REQUIRES_OK(ctx, ParseStringVector(ctx, "column_names", &column_names));
+    OP_REQUIRES(ctx, column_names.size() >= columns.size(),
+                errors::InvalidArgument(
+                    "`column_names` must name every selected column"));
+    ArrowScanFilter filter;
+    OP_REQUIRES_OK(ctx,
+                   ParseStringVector(ctx, "filter_fields", &filter.fields));
+    OP_REQUIRES_OK(ctx, ParseStringVector(ctx, "filter_ops", &filter.ops));
+    OP_REQUIRES_OK(ctx,
+                   ParseStringVector(ctx, "filter_values", &filter.values));
+    OP_REQUIRES(ctx,
+                filter.fields.size() == filter.ops.size() &&
+                    filter.fields.size() == filter.values.size(),
+                errors::InvalidArgument("`filter_fields`, `filter_ops` and "
+                                        "`filter_values` must be the same "
+                                        "length"));
+    for (const string& op : filter.ops) {
+      string function;
+      OP_REQUIRES_OK(ctx, GetCompareFunction(op, &function));
+    }
+
+    *output = new Dataset(ctx, path, format, partitioning, column_names,
+                          filter, split_row_groups_, pre_buffer_, columns,
+                          batch_size, batch_mode, output_types_,
+                          output_shapes_, column_options_);
+  }
+
+ private:
+  // Conjunction of `field op value` comparisons, the values are parsed to
+  // the type of the field in the schema of the dataset
+  struct ArrowScanFilter {
+    std::vector<string> fields;
+    std::vector<string> ops;
+    std::vector<string> values;
+  };
+
+  static Status ParseStringVector(OpKernelContext* ctx, StringPiece name,
+                                  std::vector<string>* values) {
+    const Tensor* tensor;
+    TF_RETURN_IF_ERROR(ctx->input(name, &tensor));
+    if (tensor->dims() > 1) {
+      return errors::InvalidArgument("`", name,
+                                     "` must be a scalar or vector.");
+    }
+    values->reserve(tensor->NumElements());
+    for (int64 i = 0; i < tensor->NumElements(); ++i) {
+      values->push_back(tensor->flat<tstring>()(i));
+    }
+    return OkStatus();
+  }
+
+  static Status GetCompareFunction(const string& op, string* function) {
+    static const auto* functions = new std::unordered_map<string, string>({
+        {"==", "equal"},
+        {"!=", "not_equal"},
+        {"<", "less"},
+        {"<=", "less_equal"},
+        {">", "greater"},
+        {">=", "greater_equal"},
+    });
+    auto it = functions->find(op);
+    if (it == functions->end()) {
+      return errors::InvalidArgument("Unsupported filter op: ", op);
+    }
+    *function = it->second;
+    return OkStatus();
+  }
+
+  class Dataset : public ArrowDatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const tstring& path, const tstring& format,
+            const tstring& partitioning,
+            const std::vector<string>& column_names,
+            const ArrowScanFilter& filter, const bool split_row_groups,
+            const bool pre_buffer, const std::vector<int32>& columns,
+            const int64 batch_size, const ArrowBatchMode batch_mode,
+            const DataTypeVector& output_types,
+            const std::vector<PartialTensorShape>& output_shapes,
+            const ArrowColumnOptions& column_options)
+        : ArrowDatasetBase(ctx, columns, batch_size, batch_mode, output_types,
+                           output_shapes, column_options),
+          path_(path),
+          format_(format),
+          partitioning_(partitioning),
+          column_names_(column_names),
+          filter_(filter),
+          split_row_groups_(split_row_groups),
+          pre_buffer_(pre_buffer) {}
+
+    string DebugString() const override {
+      return "ArrowScannerDatasetOp::Dataset";
+    }
+
+    Status CheckExternalState() const override { return OkStatus(); }
+
+   protected:
+    Status AsGraphDefInternal(SerializationContext* ctx,
+                              DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* path = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(path_, &path));
+      Node* format = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(format_, &format));
+      Node* partitioning = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(partitioning_, &partitioning));
+      Node* column_names = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(column_names_, &column_names));
+      Node* filter_fields = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(filter_.fields, &filter_fields));
+      Node* filter_ops = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(filter_.ops, &filter_ops));
+      Node* filter_values = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(filter_.values, &filter_values));
+      Node* columns = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(columns_, &columns));
+      Node* batch_size = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+      Node* batch_mode = nullptr;
+      tstring batch_mode_str;
+      TF_RETURN_IF_ERROR(GetBatchModeStr(batch_mode_, &batch_mode_str));
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_mode_str, &batch_mode));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddColumnAttrs(b, &attrs);
+      AttrValue split_row_groups;
+      b->BuildAttrValue(split_row_groups_, &split_row_groups);
+      attrs.emplace_back("split_row_groups", split_row_groups);
+      AttrValue pre_buffer;
+      b->BuildAttrValue(pre_buffer_, &pre_buffer);
+      attrs.emplace_back("pre_buffer", pre_buffer);
+      TF_RETURN_IF_ERROR(b->AddDataset(
+          this,
+          {path, format, partitioning, column_names, filter_fields, filter_ops,
+           filter_values, columns, batch_size, batch_mode},
+          attrs, output));
+      return OkStatus();
+    }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return std::unique_ptr<IteratorBase>(
+          new Iterator({this, strings::StrCat(prefix, "::ArrowScanner")}));
+    }
+
+   private:
+    // Build the filter expression, true if there are no comparisons
+    Status MakeFilter(const arrow::Schema& schema,
+                      arrow::compute::Expression* expression) const {
+      std::vector<arrow::compute::Expression> comparisons;
+      for (size_t i = 0; i < filter_.fields.size(); ++i) {
+        std::shared_ptr<arrow::Field> field =
+            schema.GetFieldByName(filter_.fields[i]);
+        if (field == nullptr) {
+          return errors::InvalidArgument("Filter field not in dataset: ",
+                                         filter_.fields[i]);
+        }
+        auto result = arrow::Scalar::Parse(field->type(), filter_.values[i]);
+        CHECK_ARROW(result.status());
+        string function;
+        TF_RETURN_IF_ERROR(GetCompareFunction(filter_.ops[i], &function));
+        std::shared_ptr<arrow::Scalar> value = std::move(result).ValueUnsafe();
+        comparisons.push_back(arrow::compute::call(
+            function, {arrow::compute::field_ref(filter_.fields[i]),
+                       arrow::compute::literal(std::move(value))}));
+      }
+      *expression = arrow::compute::and_(comparisons);
+      return OkStatus();
+    }
+
+    // Discover the fragments under the path and make a scanner of the
+    // projected columns and the filter
+    Status MakeScanner(
+        std::shared_ptr<arrow::dataset::Scanner>* scanner) const {
+      std::string base_dir;
+      auto fs_result =
+          arrow::fs::FileSystemFromUriOrPath(string(path_), &base_dir);
+      CHECK_ARROW(fs_result.status());
+      std::shared_ptr<arrow::fs::FileSystem> filesystem =
+          std::move(fs_result).ValueUnsafe();
+
+      std::shared_ptr<arrow::dataset::FileFormat> file_format;
+      if (format_ == "parquet") {
+        auto parquet_format =
+            std::make_shared<arrow::dataset::ParquetFileFormat>();
+        if (pre_buffer_) {
+          // The column chunks of a row group are fetched ahead, with nearby
+          // ranges coalesced into fewer and larger reads.
+          auto scan_options =
+              std::make_shared<arrow::dataset::ParquetFragmentScanOptions>();
+          scan_options->arrow_reader_properties->set_pre_buffer(true);
+          scan_options->arrow_reader_properties->set_cache_options(
+              arrow::io::CacheOptions::LazyDefaults());
+          parquet_format->default_fragment_scan_options = scan_options;
+        }
+        file_format = parquet_format;
+      } else {
+        // Feather V2 files are Arrow IPC files
+        file_format = std::make_shared<arrow::dataset::IpcFileFormat>();
+      }
+
+      arrow::fs::FileSelector selector;
+      selector.base_dir = base_dir;
+      selector.recursive = true;
+      arrow::dataset::FileSystemFactoryOptions options;
+      options.partition_base_dir = base_dir;
+      if (partitioning_ == "hive") {
+        options.partitioning = arrow::dataset::HivePartitioning::MakeFactory();
+      }
+      auto factory_result = arrow::dataset::FileSystemDatasetFactory::Make(
+          filesystem, selector, file_format, options);
+      CHECK_ARROW(factory_result.status());
+      auto dataset_result = (*factory_result)->Finish();
+      CHECK_ARROW(dataset_result.status());
+      std::shared_ptr<arrow::dataset::Dataset> dataset =
+          std::move(dataset_result).ValueUnsafe();
+
+      arrow::compute::Expression filter;
+      TF_RETURN_IF_ERROR(MakeFilter(*dataset->schema(), &filter));
+      if (split_row_groups_ && format_ == "parquet") {
+        TF_RETURN_IF_ERROR(
+            SplitRowGroups(filesystem, file_format, filter, &dataset));
+      }
+      auto builder_result = dataset->NewScan();
+      CHECK_ARROW(builder_result.status());
+      std::shared_ptr<arrow::dataset::ScannerBuilder> builder =
+          std::move(builder_result).ValueUnsafe();
+      CHECK_ARROW(builder->Project(column_names_));
+      CHECK_ARROW(builder->Filter(filter));
+      CHECK_ARROW(builder->UseThreads(true));
+      if (batch_size_ > 0) {
+        CHECK_ARROW(builder->BatchSize(batch_size_));
+      }
+      auto scanner_result = builder->Finish();
+      CHECK_ARROW(scanner_result.status());
+      *scanner = std::move(scanner_result).ValueUnsafe();
+      return OkStatus();
+    }
+
+    // Replace the file fragments of `dataset` by one fragment per row group,
+    // leaving out the row groups whose statistics fail the filter.
+    Status SplitRowGroups(
+        const std::shared_ptr<arrow::fs::FileSystem>& filesystem,
+        const std::shared_ptr<arrow::dataset::FileFormat>& file_format,
+        const arrow::compute::Expression& filter,
+        std::shared_ptr<arrow::dataset::Dataset>* dataset) const {
+      auto fragments_result = (*dataset)->GetFragments(filter);
+      CHECK_ARROW(fragments_result.status());
+      auto fragments = std::move(fragments_result).ValueUnsafe().ToVector();
+      CHECK_ARROW(fragments.status());
+      std::vector<std::shared_ptr<arrow::dataset::FileFragment>> row_groups;
+      for (const auto& fragment : *fragments) {
+        auto parquet_fragment =
+            std::static_pointer_cast<arrow::dataset::ParquetFileFragment>(
+                fragment);
+        auto split_result = parquet_fragment->SplitByRowGroup(filter);
+        CHECK_ARROW(split_result.status());
+        for (const auto& row_group : *split_result) {
+          row_groups.push_back(
+              std::static_pointer_cast<arrow::dataset::FileFragment>(
+                  row_group));
+        }
+      }
+      auto result = arrow::dataset::FileSystemDataset::Make(
+          (*dataset)->schema(), (*dataset)->partition_expression(),
+          file_format, filesystem, std::move(row_groups));
+      CHECK_ARROW(result.status());
+      *dataset = std::move(result).ValueUnsafe();
+      return OkStatus();
+    }
+
+    class Iterator : public ArrowBaseIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : ArrowBaseIterator<Dataset>(params) {}
+
+     private:
+      Status SetupStreamsLocked(Env* env)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        std::shared_ptr<arrow::dataset::Scanner> scanner;
+        TF_RETURN_IF_ERROR(dataset()->MakeScanner(&scanner));
+        auto result = scanner->ToRecordBatchReader();
+        CHECK_ARROW(result.status());
+        reader_ = std::move(result).ValueUnsafe();
+        TF_RETURN_IF_ERROR(ReadNextNonEmptyLocked());
+        if (current_batch_ != nullptr) {
+          TF_RETURN_IF_ERROR(CheckBatchColumnTypes(current_batch_));
+        }
+        return OkStatus();
+      }
+
+      Status NextStreamLocked(Env* env)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        ArrowBaseIterator<Dataset>::NextStreamLocked(env);
+        return ReadNextNonEmptyLocked();
+      }
+
+      void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+        ArrowBaseIterator<Dataset>::ResetStreamsLocked();
+        reader_.reset();
+      }
+
+      // The filter can leave batches without rows, they are skipped
+      Status ReadNextNonEmptyLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        do {
+          CHECK_ARROW(reader_->ReadNext(&current_batch_));
+        } while (current_batch_ != nullptr && current_batch_->num_rows() == 0);
+        return OkStatus();
+      }
+
+      std::shared_ptr<arrow::RecordBatchReader> reader_ TF_GUARDED_BY(mu_);
+    };
+
+    const tstring path_;
+    const tstring format_;
+    const tstring partitioning_;
+    const std::vector<string> column_names_;
+    const ArrowScanFilter filter_;
+    const bool split_row_groups_;
+    const bool pre_buffer_;
+  };
+
+  bool split_row_groups_;
+  bool pre_buffer_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>ArrowZeroCopyDataset").Device(DEVICE_CPU),
                         ArrowZeroCopyDatasetOp);
 
@@ -950,5 +2272,11 @@ REGISTER_KERNEL_BUILDER(Name("IO>ArrowFeatherDataset").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("IO>ArrowStreamDataset").Device(DEVICE_CPU),
                         ArrowStreamDatasetOp);
 
+REGISTER_KERNEL_BUILDER(Name("IO>ArrowFlightDataset").Device(DEVICE_CPU),
+                        ArrowFlightDatasetOp);
+
+REGISTER_KERNEL_BUILDER(Name("IO>ArrowScannerDataset").Device(DEVICE_CPU),
+                        ArrowScannerDatasetOp);
+
 }  // namespace data
 }  // namespace tensorflow
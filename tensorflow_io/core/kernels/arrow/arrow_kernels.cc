@@ -23,12 +23,32 @@ limitations under the License.
 #include "arrow/table.h"
 #include "generated/feather_generated.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_util.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 
 namespace tensorflow {
 namespace data {
 
+Status OpenMemoryMappedFile(
+    const string& filename,
+    std::shared_ptr<arrow::io::RandomAccessFile>* file) {
+  StringPiece scheme, host, path;
+  io::ParseURI(filename, &scheme, &host, &path);
+  if (!scheme.empty() && scheme != "file") {
+    *file = nullptr;
+    return OkStatus();
+  }
+  arrow::Result<std::shared_ptr<arrow::io::MemoryMappedFile>> result =
+      arrow::io::MemoryMappedFile::Open(string(path),
+                                        arrow::io::FileMode::READ);
+  if (!result.ok()) {
+    return errors::Internal(result.status().ToString());
+  }
+  *file = std::move(result).ValueUnsafe();
+  return OkStatus();
+}
+
 namespace {
 
 class ArrowReadableResourceBase : public ResourceBase {
@@ -544,21 +564,29 @@ class FeatherReadable : public IOReadableInterface {
         new SizedRandomAccessFile(env_, filename, memory_data, memory_size));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
 
-    std::shared_ptr<ArrowRandomAccessFile> feather_file;
-    feather_file.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
-    auto maybe_reader = arrow::ipc::feather::Reader::Open(feather_file);
+    // Local files are memory mapped, others are read through the TF file
+    // system
+    if (memory_data == nullptr) {
+      TF_RETURN_IF_ERROR(OpenMemoryMappedFile(filename, &feather_file_));
+    }
+    if (feather_file_ == nullptr) {
+      feather_file_.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
+    }
+    // The buffers of the columns read are decompressed in parallel.
+    arrow::ipc::IpcReadOptions options = arrow::ipc::IpcReadOptions::Defaults();
+    options.use_threads = true;
+    auto maybe_reader =
+        arrow::ipc::feather::Reader::Open(feather_file_, options);
     if (!maybe_reader.ok()) {
       return errors::Internal(maybe_reader.status().ToString());
     }
-    std::shared_ptr<arrow::ipc::feather::Reader> reader =
-        maybe_reader.ValueOrDie();
-    std::shared_ptr<arrow::Schema> schema = reader->schema();
+    reader_ = maybe_reader.ValueOrDie();
+    std::shared_ptr<arrow::Schema> schema = reader_->schema();
 
-    std::shared_ptr<arrow::Table> table;
-    arrow::Status s = reader->Read(&table);
-    if (!s.ok()) {
-      return errors::Internal(s.ToString());
-    }
+    // Only the schema and the footer are read here, the columns are read
+    // as they are first accessed.
+    int64 num_rows = 0;
+    TF_RETURN_IF_ERROR(ReadNumRows(&num_rows));
 
     for (int i = 0; i < schema->num_fields(); i++) {
       ::tensorflow::DataType dtype = ::tensorflow::DataType::DT_INVALID;
@@ -602,7 +630,7 @@ class FeatherReadable : public IOReadableInterface {
         default:
           break;
       }
-      shapes_.push_back(TensorShape({static_cast<int64>(table->num_rows())}));
+      shapes_.push_back(TensorShape({num_rows}));
       dtypes_.push_back(dtype);
       columns_.push_back(schema->field(i)->name());
       columns_index_[schema->field(i)->name()] = i;
@@ -653,25 +681,11 @@ class FeatherReadable : public IOReadableInterface {
       return OkStatus();
     }
 
-    if (feather_file_.get() == nullptr) {
-      feather_file_.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
-      arrow::Result<std::shared_ptr<arrow::ipc::feather::Reader>> result =
-          arrow::ipc::feather::Reader::Open(feather_file_);
-      if (!result.ok()) {
-        return errors::Internal(result.status().ToString());
-      }
-      reader_ = std::move(result).ValueUnsafe();
-    }
-
-    std::shared_ptr<arrow::Table> table;
-    arrow::Status s = reader_->Read(&table);
-    if (!s.ok()) {
-      return errors::Internal(s.ToString());
-    }
-    std::shared_ptr<arrow::ChunkedArray> column = table->column(column_index);
+    std::shared_ptr<arrow::ChunkedArray> column;
+    TF_RETURN_IF_ERROR(ReadColumn(column_index, &column));
 
     std::shared_ptr<::arrow::ChunkedArray> slice =
-        column->Slice(element_start, element_stop);
+        column->Slice(element_start, element_stop - element_start);
 
 #define FEATHER_PROCESS_TYPE(TTYPE, ATYPE)                     \
   {                                                            \
@@ -747,12 +761,77 @@ class FeatherReadable : public IOReadableInterface {
   }
 
  private:
+  // Reads the number of rows from the footer of a V1 file, or from the
+  // metadata of the record batches of a V2 (Arrow IPC) file.
+  Status ReadNumRows(int64* num_rows) {
+    if (reader_->version() >= arrow::ipc::feather::kFeatherV2Version) {
+      auto maybe_file_reader =
+          arrow::ipc::RecordBatchFileReader::Open(feather_file_);
+      if (!maybe_file_reader.ok()) {
+        return errors::Internal(maybe_file_reader.status().ToString());
+      }
+      auto maybe_num_rows = maybe_file_reader.ValueOrDie()->CountRows();
+      if (!maybe_num_rows.ok()) {
+        return errors::Internal(maybe_num_rows.status().ToString());
+      }
+      *num_rows = maybe_num_rows.ValueOrDie();
+      return OkStatus();
+    }
+    // FEA1.....[metadata][uint32 metadata_length]FEA1
+    const uint64 footer_length = sizeof(uint32) + 4;
+    if (file_size_ < footer_length) {
+      return errors::InvalidArgument("incomplete feather file");
+    }
+    string buffer;
+    buffer.resize(footer_length);
+    StringPiece result;
+    TF_RETURN_IF_ERROR(file_->Read(file_size_ - footer_length,
+                                   footer_length, &result, &buffer[0]));
+    uint32 metadata_length = 0;
+    memcpy(&metadata_length, result.data(), sizeof(uint32));
+    if (metadata_length + footer_length > file_size_) {
+      return errors::InvalidArgument("incomplete feather file");
+    }
+    buffer.resize(metadata_length);
+    TF_RETURN_IF_ERROR(
+        file_->Read(file_size_ - footer_length - metadata_length,
+                    metadata_length, &result, &buffer[0]));
+    const ::arrow::ipc::feather::fbs::CTable* table =
+        ::arrow::ipc::feather::fbs::GetCTable(result.data());
+    *num_rows = table->num_rows();
+    return OkStatus();
+  }
+
+  // Returns the column at `column_index`, read and decompressed alone on
+  // first access and kept for later reads.
+  Status ReadColumn(int64 column_index,
+                    std::shared_ptr<arrow::ChunkedArray>* column) {
+    mutex_lock l(mu_);
+    auto it = column_cache_.find(column_index);
+    if (it != column_cache_.end()) {
+      *column = it->second;
+      return OkStatus();
+    }
+    std::shared_ptr<arrow::Table> table;
+    arrow::Status s =
+        reader_->Read(std::vector<int>{static_cast<int>(column_index)}, &table);
+    if (!s.ok()) {
+      return errors::Internal(s.ToString());
+    }
+    *column = table->column(0);
+    column_cache_[column_index] = *column;
+    return OkStatus();
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
   uint64 file_size_ TF_GUARDED_BY(mu_);
-  std::shared_ptr<ArrowRandomAccessFile> feather_file_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<arrow::io::RandomAccessFile> feather_file_
+      TF_GUARDED_BY(mu_);
   std::shared_ptr<arrow::ipc::feather::Reader> reader_ TF_GUARDED_BY(mu_);
+  std::unordered_map<int64, std::shared_ptr<arrow::ChunkedArray>>
+      column_cache_ TF_GUARDED_BY(mu_);
 
   std::vector<DataType> dtypes_;
   std::vector<TensorShape> shapes_;
@@ -760,12 +839,14 @@ class FeatherReadable : public IOReadableInterface {
   std::unordered_map<string, int64> columns_index_;
 };
 
-REGISTER_KERNEL_BUILDER(Name("IO>FeatherReadableInit").Device(DEVICE_CPU),
-                        IOInterfaceInitOp<FeatherReadable>);
-REGISTER_KERNEL_BUILDER(Name("IO>FeatherReadableSpec").Device(DEVICE_CPU),
-                        IOInterfaceSpecOp<FeatherReadable>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>FeatherReadableInit").Device(DEVICE_CPU),
+    IOInterfaceInitOp<IOReadableReadAhead<FeatherReadable>>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>FeatherReadableSpec").Device(DEVICE_CPU),
+    IOInterfaceSpecOp<IOReadableReadAhead<FeatherReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>FeatherReadableRead").Device(DEVICE_CPU),
-                        IOReadableReadOp<FeatherReadable>);
+                        IOReadableReadOp<IOReadableReadAhead<FeatherReadable>>);
 
 }  // namespace data
 }  // namespace tensorflow
@@ -33,6 +33,13 @@ class ArrowRandomAccessFile : public ::arrow::io::RandomAccessFile {
  public:
   explicit ArrowRandomAccessFile(tensorflow::RandomAccessFile* file, int64 size)
       : file_(file), size_(size), position_(0) {}
+  // Files backed by memory are read without copies, into buffers that do
+  // not own their data and are only valid as long as the memory is.
+  explicit ArrowRandomAccessFile(SizedRandomAccessFile* file, int64 size)
+      : file_(file),
+        zero_copy_file_(file->SupportsZeroCopy() ? file : nullptr),
+        size_(size),
+        position_(0) {}
 
   ~ArrowRandomAccessFile() {}
   arrow::Status Close() override { return arrow::Status::OK(); }
@@ -51,6 +58,12 @@ class ArrowRandomAccessFile : public ::arrow::io::RandomAccessFile {
     return result.size();
   }
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override {
+    if (zero_copy_file_ != nullptr) {
+      ARROW_ASSIGN_OR_RAISE(std::shared_ptr<arrow::Buffer> buffer,
+                            ReadAt(position_, nbytes));
+      position_ += buffer->size();
+      return buffer;
+    }
     arrow::Result<std::shared_ptr<arrow::ResizableBuffer>> result =
         arrow::AllocateResizableBuffer(nbytes);
     ARROW_RETURN_NOT_OK(result);
@@ -63,7 +76,9 @@ class ArrowRandomAccessFile : public ::arrow::io::RandomAccessFile {
     return buffer;
   }
   arrow::Result<int64_t> GetSize() override { return size_; }
-  bool supports_zero_copy() const override { return false; }
+  bool supports_zero_copy() const override {
+    return zero_copy_file_ != nullptr;
+  }
   arrow::Result<int64_t> ReadAt(int64_t position, int64_t nbytes,
                                 void* out) override {
     StringPiece result;
@@ -75,6 +90,15 @@ class ArrowRandomAccessFile : public ::arrow::io::RandomAccessFile {
   }
   arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(
       int64_t position, int64_t nbytes) override {
+    if (zero_copy_file_ != nullptr) {
+      StringPiece result;
+      Status status = zero_copy_file_->ReadZeroCopy(position, nbytes, &result);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return arrow::Status::IOError(status.message());
+      }
+      return std::make_shared<arrow::Buffer>(
+          reinterpret_cast<const uint8_t*>(result.data()), result.size());
+    }
     string buffer;
     buffer.resize(nbytes);
     StringPiece result;
@@ -88,10 +112,18 @@ class ArrowRandomAccessFile : public ::arrow::io::RandomAccessFile {
 
  private:
   tensorflow::RandomAccessFile* file_;
+  SizedRandomAccessFile* zero_copy_file_ = nullptr;
   int64 size_;
   int64 position_;
 };
 
+// Opens a local file, a path without scheme or with the file:// scheme, as a
+// memory mapped Arrow file. Buffers read from it reference the mapped pages
+// instead of copies, so processes reading the same file share the page cache.
+// Sets file to nullptr for other file systems.
+Status OpenMemoryMappedFile(const string& filename,
+                            std::shared_ptr<arrow::io::RandomAccessFile>* file);
+
 }  // namespace data
 }  // namespace tensorflow
 
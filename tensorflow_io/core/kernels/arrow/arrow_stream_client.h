@@ -16,12 +16,40 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_CORE_KERNELS_ARROW_STREAM_CLIENT_H_
 #define TENSORFLOW_IO_CORE_KERNELS_ARROW_STREAM_CLIENT_H_
 
+#include <cstdint>
+
 #include "arrow/io/api.h"
 
 namespace tensorflow {
 namespace data {
 
-// Class to wrap a socket as a readable Arrow InputStream
+// Layout of the shared memory of a "shm://<name>" endpoint, a POSIX shared
+// memory object created by a producer on the same host. The header is
+// followed by a ring of `capacity` bytes that carries the Arrow IPC stream.
+// The producer copies bytes into the ring at write_pos % capacity, then
+// advances write_pos and increments write_seq. The consumer advances
+// read_pos and increments read_seq when it copied bytes out. Both sequence
+// words are futex doorbells on Linux, waiters also poll them so a producer
+// that does not wake the consumer only adds latency. Positions count all
+// bytes ever written or read, and the producer sets `closed` after the last
+// byte of the stream was published.
+struct ArrowShmRingHeader {
+  static constexpr uint64_t kMagic = 0x314d48534f494654;  // "TFIOSHM1"
+  uint64_t magic;
+  uint64_t capacity;
+  uint64_t write_pos;
+  uint32_t write_seq;
+  uint32_t closed;
+  char producer_padding[32];
+  uint64_t read_pos;
+  uint32_t read_seq;
+  char consumer_padding[52];
+};
+static_assert(sizeof(ArrowShmRingHeader) == 128,
+              "Producers depend on the layout of ArrowShmRingHeader");
+
+// Class to wrap a socket, or a shared memory ring, as a readable Arrow
+// InputStream
 class ArrowStreamClient : public arrow::io::InputStream {
  public:
   ArrowStreamClient(const std::string& endpoint);
@@ -35,9 +63,15 @@ class ArrowStreamClient : public arrow::io::InputStream {
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override;
 
  private:
+  arrow::Status ConnectShm(const std::string& name);
+  arrow::Result<int64_t> ReadShm(int64_t nbytes, void* out);
+
   const std::string endpoint_;
   int sock_;
   int64_t pos_;
+  // Mapping of a shm:// endpoint, nullptr for sockets
+  ArrowShmRingHeader* shm_ = nullptr;
+  size_t shm_size_ = 0;
 };
 
 }  // namespace data
@@ -14,9 +14,19 @@ limitations under the License.
 ==============================================================================*/
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
 
 #include "arrow/api.h"
 #include "arrow/io/api.h"
@@ -27,12 +37,45 @@ limitations under the License.
 
 namespace tensorflow {
 namespace data {
+namespace {
+
+// Time a reader of the shared memory ring waits for a doorbell before it
+// polls the positions again
+constexpr int64_t kShmPollNanos = 10 * 1000 * 1000;
+
+uint64_t LoadAcquire(const uint64_t* value) {
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+uint32_t LoadAcquire(const uint32_t* value) {
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+// Wait until the sequence word is no longer `seq`, or the poll interval ends
+void WaitSeq(uint32_t* word, uint32_t seq) {
+#if defined(__linux__)
+  struct timespec timeout = {0, kShmPollNanos};
+  syscall(SYS_futex, word, FUTEX_WAIT, seq, &timeout, nullptr, 0);
+#else
+  struct timespec timeout = {0, kShmPollNanos / 10};
+  nanosleep(&timeout, nullptr);
+#endif
+}
+
+void RingSeq(uint32_t* word) {
+  __atomic_add_fetch(word, 1, __ATOMIC_RELEASE);
+#if defined(__linux__)
+  syscall(SYS_futex, word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+}  // namespace
 
 ArrowStreamClient::ArrowStreamClient(const std::string& endpoint)
     : endpoint_(endpoint), sock_(-1), pos_(0) {}
 
 ArrowStreamClient::~ArrowStreamClient() {
-  if (sock_ != -1) {
+  if (!closed()) {
     Close();
   }
 }
@@ -90,6 +133,8 @@ arrow::Status ArrowStreamClient::Connect() {
       return arrow::Status::IOError("Connection failed to AF_UNIX: " + host);
     }
 
+  } else if (socket_family == "shm") {
+    return ConnectShm(host);
   } else {
     return arrow::Status::Invalid("Unsupported socket family: " +
                                   socket_family);
@@ -98,7 +143,89 @@ arrow::Status ArrowStreamClient::Connect() {
   return arrow::Status::OK();
 }
 
+arrow::Status ArrowStreamClient::ConnectShm(const std::string& name) {
+  if (shm_ != nullptr) {
+    return arrow::Status::OK();
+  }
+  std::string shm_name = name.empty() || name[0] == '/' ? name : "/" + name;
+  int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return arrow::Status::IOError("Connection failed to shared memory: " +
+                                  name);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(ArrowShmRingHeader)) {
+    close(fd);
+    return arrow::Status::IOError("Shared memory too small for a ring: " +
+                                  name);
+  }
+  void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return arrow::Status::IOError("Failed to map shared memory: " + name);
+  }
+  ArrowShmRingHeader* header = static_cast<ArrowShmRingHeader*>(addr);
+  if (header->magic != ArrowShmRingHeader::kMagic || header->capacity == 0 ||
+      header->capacity > st.st_size - sizeof(ArrowShmRingHeader)) {
+    munmap(addr, st.st_size);
+    return arrow::Status::IOError("Shared memory is not an Arrow ring: " +
+                                  name);
+  }
+  shm_ = header;
+  shm_size_ = st.st_size;
+  return arrow::Status::OK();
+}
+
+arrow::Result<int64_t> ArrowStreamClient::ReadShm(int64_t nbytes, void* out) {
+  const uint64_t capacity = shm_->capacity;
+  const uint8_t* ring =
+      reinterpret_cast<const uint8_t*>(shm_) + sizeof(ArrowShmRingHeader);
+  uint8_t* dest = static_cast<uint8_t*>(out);
+  int64_t bytes_read = 0;
+  uint64_t read_pos = shm_->read_pos;
+  while (bytes_read < nbytes) {
+    // Load the doorbell before the position, so a write after the position
+    // was loaded changes the doorbell and the wait returns right away
+    uint32_t seq = LoadAcquire(&shm_->write_seq);
+    uint64_t available = LoadAcquire(&shm_->write_pos) - read_pos;
+    if (available == 0) {
+      if (LoadAcquire(&shm_->closed) != 0 &&
+          LoadAcquire(&shm_->write_pos) == read_pos) {
+        break;
+      }
+      WaitSeq(&shm_->write_seq, seq);
+      continue;
+    }
+
+    // Copy up to the end of the ring, the rest is copied on the next loop
+    uint64_t offset = read_pos % capacity;
+    uint64_t length = std::min<uint64_t>(
+        {available, static_cast<uint64_t>(nbytes - bytes_read),
+         capacity - offset});
+    std::memcpy(dest + bytes_read, ring + offset, length);
+    bytes_read += length;
+    read_pos += length;
+    __atomic_store_n(&shm_->read_pos, read_pos, __ATOMIC_RELEASE);
+    RingSeq(&shm_->read_seq);
+  }
+  pos_ += bytes_read;
+  return bytes_read;
+}
+
 arrow::Status ArrowStreamClient::Close() {
+  if (shm_ != nullptr) {
+    int status = munmap(shm_, shm_size_);
+    shm_ = nullptr;
+    shm_size_ = 0;
+    if (status != 0) {
+      return arrow::Status::IOError("Failed to unmap shared memory");
+    }
+    return arrow::Status::OK();
+  }
+
   int status = close(sock_);
   sock_ = -1;
 
@@ -109,7 +236,9 @@ arrow::Status ArrowStreamClient::Close() {
   return arrow::Status::OK();
 }
 
-bool ArrowStreamClient::closed() const { return sock_ == -1; }
+bool ArrowStreamClient::closed() const {
+  return sock_ == -1 && shm_ == nullptr;
+}
 
 arrow::Result<int64_t> ArrowStreamClient::Tell() const { return pos_; }
 
@@ -118,6 +247,9 @@ arrow::Result<int64_t> ArrowStreamClient::Read(int64_t nbytes, void* out) {
   if (nbytes == 0) {
     return 0;
   }
+  if (shm_ != nullptr) {
+    return ReadShm(nbytes, out);
+  }
 
   int status = recv(sock_, out, nbytes, MSG_WAITALL);
   if (status == 0) {
@@ -18,7 +18,9 @@ limitations under the License.
 #include "arrow/adapters/tensorflow/convert.h"
 #include "arrow/api.h"
 #include "arrow/ipc/api.h"
+#include "arrow/type_traits.h"
 #include "arrow/util/io_util.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -282,7 +284,8 @@ class ArrowAssignTensorImpl : public arrow::ArrayVisitor {
 
   virtual arrow::Status Visit(const arrow::StringArray& array) override {
     auto shape = out_tensor_->shape();
-    auto output_flat = out_tensor_->flat<tstring>();
+    // The tensor may be a slice of rows of a batch that is not aligned
+    auto output_flat = out_tensor_->unaligned_flat<tstring>();
 
     for (int64 j = 0; j < shape.num_elements(); ++j) {
       output_flat(j) = array.GetString(i_ + j);
@@ -293,7 +296,7 @@ class ArrowAssignTensorImpl : public arrow::ArrayVisitor {
 
   virtual arrow::Status Visit(const arrow::BinaryArray& array) override {
     auto shape = out_tensor_->shape();
-    auto output_flat = out_tensor_->flat<tstring>();
+    auto output_flat = out_tensor_->unaligned_flat<tstring>();
 
     for (int64 j = 0; j < shape.num_elements(); ++j) {
       output_flat(j) = array.GetString(i_ + j);
@@ -314,6 +317,195 @@ Status AssignTensor(std::shared_ptr<arrow::Array> array, int64 i,
   return visitor.AssignTensor(array, i, out_tensor);
 }
 
+// TensorBuffer over the memory of an Arrow buffer, holds a reference to the
+// Arrow buffer which in turn keeps the record batch memory alive
+class ArrowTensorBuffer : public TensorBuffer {
+ public:
+  ArrowTensorBuffer(std::shared_ptr<arrow::Buffer> buffer, const uint8_t* data,
+                    size_t size)
+      : TensorBuffer(const_cast<uint8_t*>(data)),
+        buffer_(std::move(buffer)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("arrow");
+  }
+
+  // Prevents kernels from forwarding the buffer and writing into Arrow memory
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  std::shared_ptr<arrow::Buffer> buffer_;
+  const size_t size_;
+};
+
+Status AliasTensor(std::shared_ptr<arrow::Array> array, int64 i,
+                   ::tensorflow::DataType dtype, const TensorShape& shape,
+                   Tensor* out_tensor, bool* aliased) {
+  *aliased = false;
+  if (array->null_count() != 0 || shape.num_elements() == 0) {
+    return OkStatus();
+  }
+
+  // The values of a batch of lists with the same length are contiguous
+  std::shared_ptr<arrow::Array> values = array;
+  int64 values_offset = i;
+  if (array->type_id() == arrow::Type::LIST) {
+    const auto& list_array = static_cast<const arrow::ListArray&>(*array);
+    values = list_array.values();
+    values_offset = list_array.value_offset(i);
+    if (values->null_count() != 0) {
+      return OkStatus();
+    }
+  }
+
+  arrow::Type::type type_id = values->type_id();
+  if (!(arrow::is_integer(type_id) || arrow::is_floating(type_id))) {
+    return OkStatus();
+  }
+  const auto& fw_type =
+      static_cast<const arrow::FixedWidthType&>(*values->type());
+  const int64 type_width = fw_type.bit_width() / 8;
+  if (type_width != DataTypeSize(dtype)) {
+    return OkStatus();
+  }
+
+  static const int VALUE_BUFFER = 1;
+  std::shared_ptr<arrow::Buffer> buffer = values->data()->buffers[VALUE_BUFFER];
+  if (buffer == nullptr) {
+    return OkStatus();
+  }
+  const int64 start = (values->offset() + values_offset) * type_width;
+  const int64 size = shape.num_elements() * type_width;
+  if (start + size > buffer->size()) {
+    return errors::Internal("Arrow array of ", buffer->size(),
+                            " bytes is too small for tensor of shape ",
+                            shape.DebugString());
+  }
+  const uint8_t* data = buffer->data() + start;
+  if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return OkStatus();
+  }
+
+  ArrowTensorBuffer* tensor_buffer =
+      new ArrowTensorBuffer(std::move(buffer), data, size);
+  *out_tensor = Tensor(dtype, shape, tensor_buffer);
+  tensor_buffer->Unref();
+  *aliased = true;
+  return OkStatus();
+}
+
+Status AssignRaggedTensor(
+    const std::vector<std::shared_ptr<arrow::Array>>& arrays,
+    Allocator* allocator, ::tensorflow::DataType values_dtype, bool alias,
+    Tensor* out_values, Tensor* out_row_splits) {
+  int64 num_rows = 0;
+  int64 num_values = 0;
+  for (const std::shared_ptr<arrow::Array>& array : arrays) {
+    if (array->type_id() != arrow::Type::LIST) {
+      return errors::InvalidArgument(
+          "Ragged columns must be Arrow list arrays, received: ",
+          array->type()->ToString());
+    }
+    if (array->null_count() != 0) {
+      return errors::Internal(
+          "Arrow arrays with null values not currently supported");
+    }
+    const auto& list_array = static_cast<const arrow::ListArray&>(*array);
+    num_rows += list_array.length();
+    num_values += list_array.value_offset(list_array.length()) -
+                  list_array.value_offset(0);
+  }
+
+  // Offsets of an unsliced list are already the row splits
+  bool aliased = false;
+  static const int OFFSET_BUFFER = 1;
+  if (alias && arrays.size() == 1 &&
+      arrays[0]->data()->buffers[OFFSET_BUFFER] != nullptr) {
+    const auto& list_array = static_cast<const arrow::ListArray&>(*arrays[0]);
+    std::shared_ptr<arrow::Buffer> offsets =
+        list_array.data()->buffers[OFFSET_BUFFER];
+    const uint8_t* data =
+        offsets->data() + list_array.offset() * sizeof(int32_t);
+    if (list_array.value_offset(0) == 0 &&
+        reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+      const size_t size = (num_rows + 1) * sizeof(int32_t);
+      ArrowTensorBuffer* tensor_buffer =
+          new ArrowTensorBuffer(std::move(offsets), data, size);
+      *out_row_splits =
+          Tensor(DT_INT32, TensorShape({num_rows + 1}), tensor_buffer);
+      tensor_buffer->Unref();
+      aliased = true;
+    }
+  }
+  if (!aliased) {
+    *out_row_splits = Tensor(allocator, DT_INT32, TensorShape({num_rows + 1}));
+    auto row_splits = out_row_splits->flat<int32>();
+    int64 row = 0;
+    int32 split = 0;
+    row_splits(0) = 0;
+    for (const std::shared_ptr<arrow::Array>& array : arrays) {
+      const auto& list_array = static_cast<const arrow::ListArray&>(*array);
+      for (int64 j = 0; j < list_array.length(); ++j) {
+        split += list_array.value_length(j);
+        row_splits(++row) = split;
+      }
+    }
+  }
+
+  // Copy the values of each array to its rows of the flat values
+  *out_values = Tensor(allocator, values_dtype, TensorShape({num_values}));
+  int64 values_index = 0;
+  for (const std::shared_ptr<arrow::Array>& array : arrays) {
+    const auto& list_array = static_cast<const arrow::ListArray&>(*array);
+    int64 length = list_array.value_offset(list_array.length()) -
+                   list_array.value_offset(0);
+    if (length == 0) {
+      continue;
+    }
+    std::shared_ptr<arrow::Array> values =
+        list_array.values()->Slice(list_array.value_offset(0), length);
+    Tensor rows = out_values->Slice(values_index, values_index + length);
+    TF_RETURN_IF_ERROR(AssignTensor(values, 0, &rows));
+    values_index += length;
+  }
+  return OkStatus();
+}
+
+Status AssignDictionaryIndices(
+    const std::vector<std::shared_ptr<arrow::Array>>& arrays,
+    Allocator* allocator, Tensor* out_indices) {
+  int64 num_rows = 0;
+  for (const std::shared_ptr<arrow::Array>& array : arrays) {
+    if (array->type_id() != arrow::Type::DICTIONARY) {
+      return errors::InvalidArgument(
+          "Dictionary columns must be Arrow dictionary arrays, received: ",
+          array->type()->ToString());
+    }
+    if (array->null_count() != 0) {
+      return errors::Internal(
+          "Arrow arrays with null values not currently supported");
+    }
+    num_rows += array->length();
+  }
+
+  *out_indices = Tensor(allocator, DT_INT64, TensorShape({num_rows}));
+  auto indices = out_indices->flat<int64>();
+  int64 row = 0;
+  for (const std::shared_ptr<arrow::Array>& array : arrays) {
+    const auto& dict_array = static_cast<const arrow::DictionaryArray&>(*array);
+    for (int64 j = 0; j < dict_array.length(); ++j) {
+      indices(row++) = dict_array.GetValueIndex(j);
+    }
+  }
+  return OkStatus();
+}
+
 // Check the type of an Arrow array matches expected tensor type
 class ArrowArrayTypeCheckerImpl : public arrow::TypeVisitor {
  public:
@@ -337,6 +529,10 @@ class ArrowArrayTypeCheckerImpl : public arrow::TypeVisitor {
     return CheckScalarType(type.value_type());
   }
 
+  virtual arrow::Status Visit(const arrow::DictionaryType& type) {
+    return CheckScalarType(type.value_type());
+  }
+
   // Check scalar types with arrow::adapters::tensorflow
   arrow::Status CheckScalarType(std::shared_ptr<arrow::DataType> scalar_type) {
     DataType converted_type;
@@ -62,6 +62,31 @@ Status AssignSpec(std::shared_ptr<arrow::Array> array, int64 i,
 Status AssignTensor(std::shared_ptr<arrow::Array> array, int64 i,
                     Tensor* out_tensor);
 
+// Wrap the elements of an Arrow Array in a Tensor without copying them. The
+// Tensor keeps a reference to the Arrow buffer. Only arrays of integers or
+// floats without nulls, and lists of them, whose values are aligned for
+// Eigen can be aliased, otherwise `aliased` is set to false and the Tensor is
+// left untouched
+Status AliasTensor(std::shared_ptr<arrow::Array> array, int64 i,
+                   ::tensorflow::DataType dtype, const TensorShape& shape,
+                   Tensor* out_tensor, bool* aliased);
+
+// Concatenate the rows of list arrays, e.g. slices of one column of
+// consecutive record batches, to the flat values and int32 row splits of a
+// RaggedTensor with one ragged dimension. The lists may have any length. The
+// row splits alias the offsets buffer of a single array whose offsets start
+// at 0 if alias is true, otherwise they are copied and rebased
+Status AssignRaggedTensor(
+    const std::vector<std::shared_ptr<arrow::Array>>& arrays,
+    Allocator* allocator, ::tensorflow::DataType values_dtype, bool alias,
+    Tensor* out_values, Tensor* out_row_splits);
+
+// Concatenate the indices of dictionary arrays to an int64 tensor with one
+// element per row, the arrays must share their dictionary
+Status AssignDictionaryIndices(
+    const std::vector<std::shared_ptr<arrow::Array>>& arrays,
+    Allocator* allocator, Tensor* out_indices);
+
 // Checks the Arrow Array datatype matches the expected TF datatype
 Status CheckArrayType(std::shared_ptr<arrow::DataType> type,
                       ::tensorflow::DataType expected_type);
@@ -0,0 +1,655 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "arrow/api.h"
+#include "arrow/io/api.h"
+#include "arrow/ipc/api.h"
+#include "arrow/util/compression.h"
+#include "parquet/arrow/writer.h"
+#include "parquet/properties.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow_io/core/kernels/arrow/arrow_util.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Arrow OutputStream that appends to a TensorFlow WritableFile, so that any
+// file system registered with TensorFlow can be the destination
+class ArrowWritableFile : public arrow::io::OutputStream {
+ public:
+  explicit ArrowWritableFile(std::unique_ptr<WritableFile> file)
+      : file_(std::move(file)), position_(0) {}
+
+  arrow::Status Close() override {
+    if (file_ == nullptr) {
+      return arrow::Status::OK();
+    }
+    Status status = file_->Close();
+    file_.reset();
+    if (!status.ok()) {
+      return arrow::Status::IOError(status.message());
+    }
+    return arrow::Status::OK();
+  }
+  bool closed() const override { return file_ == nullptr; }
+  arrow::Result<int64_t> Tell() const override { return position_; }
+  arrow::Status Write(const void* data, int64_t nbytes) override {
+    Status status =
+        file_->Append(StringPiece(static_cast<const char*>(data), nbytes));
+    if (!status.ok()) {
+      return arrow::Status::IOError(status.message());
+    }
+    position_ += nbytes;
+    return arrow::Status::OK();
+  }
+  arrow::Status Flush() override {
+    Status status = file_->Flush();
+    if (!status.ok()) {
+      return arrow::Status::IOError(status.message());
+    }
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::unique_ptr<WritableFile> file_;
+  int64_t position_;
+};
+
+// Arrow Buffer that references the memory of a tensor and keeps the tensor
+// alive, so numeric columns are written without a copy
+class ArrowTensorDataBuffer : public arrow::Buffer {
+ public:
+  explicit ArrowTensorDataBuffer(const Tensor& tensor)
+      : arrow::Buffer(
+            reinterpret_cast<const uint8_t*>(tensor.tensor_data().data()),
+            tensor.tensor_data().size()),
+        tensor_(tensor) {}
+
+ private:
+  const Tensor tensor_;
+};
+
+// Make the array of a column, numeric buffers reference the tensor
+Status MakeArray(const Tensor& value, std::shared_ptr<arrow::Array>* out) {
+  std::shared_ptr<arrow::DataType> type;
+  TF_RETURN_IF_ERROR(ArrowUtil::GetArrowType(value.dtype(), &type));
+  const int64 num_values = value.NumElements();
+  std::shared_ptr<arrow::Array> values;
+  if (value.dtype() == DT_STRING) {
+    arrow::StringBuilder builder;
+    auto flat = value.flat<tstring>();
+    for (int64 i = 0; i < num_values; ++i) {
+      arrow::Status status = builder.Append(flat(i).data(), flat(i).size());
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    arrow::Status status = builder.Finish(&values);
+    if (!status.ok()) {
+      return errors::Internal(status.ToString());
+    }
+  } else if (value.dtype() == DT_BOOL) {
+    // Arrow booleans are bit packed
+    arrow::BooleanBuilder builder;
+    auto flat = value.flat<bool>();
+    for (int64 i = 0; i < num_values; ++i) {
+      arrow::Status status = builder.Append(flat(i));
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    arrow::Status status = builder.Finish(&values);
+    if (!status.ok()) {
+      return errors::Internal(status.ToString());
+    }
+  } else {
+    std::shared_ptr<arrow::Buffer> data =
+        std::make_shared<ArrowTensorDataBuffer>(value);
+    values = arrow::MakeArray(
+        arrow::ArrayData::Make(type, num_values, {nullptr, data}, 0));
+  }
+  if (value.dims() == 1) {
+    *out = std::move(values);
+    return OkStatus();
+  }
+
+  // Rows of a matrix are lists of the same length
+  const int64 num_rows = value.dim_size(0);
+  const int64 width = value.dim_size(1);
+  arrow::Int32Builder offsets_builder;
+  for (int64 i = 0; i <= num_rows; ++i) {
+    arrow::Status status =
+        offsets_builder.Append(static_cast<int32_t>(i * width));
+    if (!status.ok()) {
+      return errors::Internal(status.ToString());
+    }
+  }
+  std::shared_ptr<arrow::Array> offsets;
+  arrow::Status status = offsets_builder.Finish(&offsets);
+  if (!status.ok()) {
+    return errors::Internal(status.ToString());
+  }
+  arrow::Result<std::shared_ptr<arrow::Array>> result =
+      arrow::ListArray::FromArrays(*offsets, *values);
+  if (!result.ok()) {
+    return errors::Internal(result.status().ToString());
+  }
+  *out = std::move(result).ValueUnsafe();
+  return OkStatus();
+}
+
+// Make the arrays of the columns of a batch, which must all have num_rows
+// rows, and check there is one tensor per column
+Status MakeArrays(const std::vector<Tensor>& values, size_t num_columns,
+                  std::vector<std::shared_ptr<arrow::Array>>* arrays,
+                  int64* num_rows) {
+  if (values.size() != num_columns) {
+    return errors::InvalidArgument("Expected ", num_columns,
+                                   " tensors, received: ", values.size());
+  }
+  *num_rows = -1;
+  arrays->clear();
+  arrays->reserve(values.size());
+  for (const Tensor& value : values) {
+    if (value.dims() < 1 || value.dims() > 2) {
+      return errors::InvalidArgument(
+          "Tensors must have shape [rows] or [rows, n], received: ",
+          value.shape().DebugString());
+    }
+    if (*num_rows >= 0 && value.dim_size(0) != *num_rows) {
+      return errors::InvalidArgument(
+          "Tensors of a batch must have the same number of rows");
+    }
+    *num_rows = value.dim_size(0);
+    std::shared_ptr<arrow::Array> array;
+    TF_RETURN_IF_ERROR(MakeArray(value, &array));
+    arrays->push_back(std::move(array));
+  }
+  return OkStatus();
+}
+
+// Writes batches of tensors as record batches of an Arrow IPC file or
+// stream. The schema is made from the dtypes and shapes of the first batch:
+// a tensor of shape [rows] is a column of its dtype, and a tensor of shape
+// [rows, n] is a list column with n values per row.
+class ArrowWriterResource : public ResourceBase {
+ public:
+  ArrowWriterResource(Env* env) : env_(env) {}
+  ~ArrowWriterResource() {
+    if (sink_ != nullptr) {
+      Close().IgnoreError();
+    }
+  }
+
+  Status Init(const string& filename, const std::vector<string>& column_names,
+              const string& format, const string& compression) {
+    mutex_lock l(mu_);
+    if (format != "file" && format != "feather" && format != "stream") {
+      return errors::InvalidArgument(
+          "format must be 'file', 'feather' or 'stream', received: ", format);
+    }
+    options_ = arrow::ipc::IpcWriteOptions::Defaults();
+    if (!compression.empty()) {
+      arrow::Compression::type codec_type;
+      if (compression == "lz4") {
+        codec_type = arrow::Compression::LZ4_FRAME;
+      } else if (compression == "zstd") {
+        codec_type = arrow::Compression::ZSTD;
+      } else {
+        return errors::InvalidArgument(
+            "compression must be '', 'lz4' or 'zstd', received: ",
+            compression);
+      }
+      auto codec = arrow::util::Codec::Create(codec_type);
+      if (!codec.ok()) {
+        return errors::Internal(codec.status().ToString());
+      }
+      options_.codec = std::shared_ptr<arrow::util::Codec>(
+          std::move(codec).ValueUnsafe());
+    }
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file));
+    sink_ = std::make_shared<ArrowWritableFile>(std::move(file));
+    filename_ = filename;
+    column_names_ = column_names;
+    stream_ = format == "stream";
+    return OkStatus();
+  }
+
+  Status Write(const std::vector<Tensor>& values) {
+    mutex_lock l(mu_);
+    if (sink_ == nullptr) {
+      return errors::FailedPrecondition("Arrow writer is closed: ", filename_);
+    }
+    int64 num_rows;
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    TF_RETURN_IF_ERROR(
+        MakeArrays(values, column_names_.size(), &arrays, &num_rows));
+
+    if (writer_ == nullptr) {
+      std::vector<std::shared_ptr<arrow::Field>> fields;
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        fields.push_back(arrow::field(column_names_[i], arrays[i]->type()));
+      }
+      schema_ = arrow::schema(fields);
+      arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchWriter>> result =
+          stream_ ? arrow::ipc::MakeStreamWriter(sink_, schema_, options_)
+                  : arrow::ipc::MakeFileWriter(sink_, schema_, options_);
+      if (!result.ok()) {
+        return errors::Internal(result.status().ToString());
+      }
+      writer_ = std::move(result).ValueUnsafe();
+    } else {
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        if (!arrays[i]->type()->Equals(schema_->field(i)->type())) {
+          return errors::InvalidArgument(
+              "Column ", column_names_[i], " was written as ",
+              schema_->field(i)->type()->ToString(), ", received: ",
+              arrays[i]->type()->ToString());
+        }
+      }
+    }
+
+    std::shared_ptr<arrow::RecordBatch> batch =
+        arrow::RecordBatch::Make(schema_, num_rows, std::move(arrays));
+    arrow::Status status = writer_->WriteRecordBatch(*batch);
+    if (!status.ok()) {
+      return errors::Internal(status.ToString());
+    }
+    return OkStatus();
+  }
+
+  // Write the footer of a file, or the end of a stream, and close the file
+  Status Close() {
+    mutex_lock l(mu_);
+    if (writer_ != nullptr) {
+      arrow::Status status = writer_->Close();
+      writer_.reset();
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    if (sink_ != nullptr) {
+      arrow::Status status = sink_->Close();
+      sink_.reset();
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    return OkStatus();
+  }
+
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return strings::StrCat("ArrowWriterResource[", filename_, "]");
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string filename_ TF_GUARDED_BY(mu_);
+  std::vector<string> column_names_ TF_GUARDED_BY(mu_);
+  bool stream_ TF_GUARDED_BY(mu_) = false;
+  arrow::ipc::IpcWriteOptions options_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<ArrowWritableFile> sink_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<arrow::Schema> schema_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer_ TF_GUARDED_BY(mu_);
+};
+
+class ArrowWriterInitOp : public ResourceOpKernel<ArrowWriterResource> {
+ public:
+  explicit ArrowWriterInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<ArrowWriterResource>(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("format", &format_));
+    OP_REQUIRES_OK(context, context->GetAttr("compression", &compression_));
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<ArrowWriterResource>::Compute(context);
+    mutex_lock l(mu_);
+    const Tensor* filename_tensor;
+    OP_REQUIRES_OK(context, context->input("filename", &filename_tensor));
+    const string& filename = filename_tensor->scalar<tstring>()();
+
+    const Tensor* column_names_tensor;
+    OP_REQUIRES_OK(context,
+                   context->input("column_names", &column_names_tensor));
+    OP_REQUIRES(
+        context, column_names_tensor->dims() <= 1,
+        errors::InvalidArgument("`column_names` must be a scalar or vector."));
+    std::vector<string> column_names;
+    column_names.reserve(column_names_tensor->NumElements());
+    for (int64 i = 0; i < column_names_tensor->NumElements(); ++i) {
+      column_names.push_back(column_names_tensor->flat<tstring>()(i));
+    }
+
+    OP_REQUIRES_OK(context, resource_->Init(filename, column_names, format_,
+                                            compression_));
+  }
+
+  Status CreateResource(ArrowWriterResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new ArrowWriterResource(env_);
+    return OkStatus();
+  }
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string format_;
+  string compression_;
+};
+
+class ArrowWriterWriteOp : public OpKernel {
+ public:
+  explicit ArrowWriterWriteOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    ArrowWriterResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "writer", &resource));
+    core::ScopedUnref unref(resource);
+
+    OpInputList values_list;
+    OP_REQUIRES_OK(context, context->input_list("values", &values_list));
+    std::vector<Tensor> values(values_list.begin(), values_list.end());
+    OP_REQUIRES_OK(context, resource->Write(values));
+  }
+};
+
+class ArrowWriterCloseOp : public OpKernel {
+ public:
+  explicit ArrowWriterCloseOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    ArrowWriterResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "writer", &resource));
+    core::ScopedUnref unref(resource);
+    OP_REQUIRES_OK(context, resource->Close());
+  }
+};
+
+// Writes batches of tensors to a Parquet file. Batches are buffered as
+// Arrow arrays, without a copy for numeric columns, until row_group_size
+// rows are buffered, then written as one row group, so only one row group
+// is held in memory and the file is streamed to its file system a row group
+// at a time. The schema is made from the first batch as in
+// ArrowWriterResource.
+class ParquetWriterResource : public ResourceBase {
+ public:
+  ParquetWriterResource(Env* env) : env_(env) {}
+  ~ParquetWriterResource() {
+    if (sink_ != nullptr) {
+      Close().IgnoreError();
+    }
+  }
+
+  Status Init(const string& filename, const std::vector<string>& column_names,
+              const string& compression, int64 row_group_size,
+              bool dictionary) {
+    mutex_lock l(mu_);
+    if (row_group_size <= 0) {
+      return errors::InvalidArgument(
+          "row_group_size must be positive, received: ", row_group_size);
+    }
+    parquet::WriterProperties::Builder builder;
+    if (compression == "snappy") {
+      builder.compression(parquet::Compression::SNAPPY);
+    } else if (compression == "zstd") {
+      builder.compression(parquet::Compression::ZSTD);
+    } else if (compression.empty()) {
+      builder.compression(parquet::Compression::UNCOMPRESSED);
+    } else {
+      return errors::InvalidArgument(
+          "compression must be '', 'snappy' or 'zstd', received: ",
+          compression);
+    }
+    if (dictionary) {
+      builder.enable_dictionary();
+    } else {
+      builder.disable_dictionary();
+    }
+    builder.max_row_group_length(row_group_size);
+    properties_ = builder.build();
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file));
+    sink_ = std::make_shared<ArrowWritableFile>(std::move(file));
+    filename_ = filename;
+    column_names_ = column_names;
+    row_group_size_ = row_group_size;
+    columns_.assign(column_names.size(), arrow::ArrayVector());
+    buffered_rows_ = 0;
+    return OkStatus();
+  }
+
+  Status Write(const std::vector<Tensor>& values) {
+    mutex_lock l(mu_);
+    if (sink_ == nullptr) {
+      return errors::FailedPrecondition("Parquet writer is closed: ",
+                                        filename_);
+    }
+    int64 num_rows;
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    TF_RETURN_IF_ERROR(
+        MakeArrays(values, column_names_.size(), &arrays, &num_rows));
+
+    if (writer_ == nullptr) {
+      std::vector<std::shared_ptr<arrow::Field>> fields;
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        fields.push_back(arrow::field(column_names_[i], arrays[i]->type()));
+      }
+      schema_ = arrow::schema(fields);
+      arrow::Status status = parquet::arrow::FileWriter::Open(
+          *schema_, arrow::default_memory_pool(), sink_, properties_,
+          parquet::default_arrow_writer_properties(), &writer_);
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    } else {
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        if (!arrays[i]->type()->Equals(schema_->field(i)->type())) {
+          return errors::InvalidArgument(
+              "Column ", column_names_[i], " was written as ",
+              schema_->field(i)->type()->ToString(), ", received: ",
+              arrays[i]->type()->ToString());
+        }
+      }
+    }
+
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      columns_[i].push_back(std::move(arrays[i]));
+    }
+    buffered_rows_ += num_rows;
+    if (buffered_rows_ >= row_group_size_) {
+      // Write whole row groups, the remaining rows stay buffered
+      TF_RETURN_IF_ERROR(
+          WriteRowGroups(buffered_rows_ / row_group_size_ * row_group_size_));
+    }
+    return OkStatus();
+  }
+
+  // Write the buffered rows as a last row group, then the footer, and close
+  // the file
+  Status Close() {
+    mutex_lock l(mu_);
+    if (writer_ != nullptr) {
+      Status flushed = OkStatus();
+      if (sink_ != nullptr && buffered_rows_ > 0) {
+        flushed = WriteRowGroups(buffered_rows_);
+      }
+      arrow::Status status = writer_->Close();
+      writer_.reset();
+      TF_RETURN_IF_ERROR(flushed);
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    if (sink_ != nullptr) {
+      arrow::Status status = sink_->Close();
+      sink_.reset();
+      if (!status.ok()) {
+        return errors::Internal(status.ToString());
+      }
+    }
+    return OkStatus();
+  }
+
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return strings::StrCat("ParquetWriterResource[", filename_, "]");
+  }
+
+ private:
+  // Write the first num_rows buffered rows in row groups of row_group_size_
+  Status WriteRowGroups(int64 num_rows) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> chunked;
+    chunked.reserve(columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      chunked.push_back(std::make_shared<arrow::ChunkedArray>(
+          std::move(columns_[i]), schema_->field(i)->type()));
+    }
+    std::shared_ptr<arrow::Table> table =
+        arrow::Table::Make(schema_, std::move(chunked), buffered_rows_);
+    arrow::Status status =
+        writer_->WriteTable(*table->Slice(0, num_rows), row_group_size_);
+    std::shared_ptr<arrow::Table> rest = table->Slice(num_rows);
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      columns_[i] = rest->column(i)->chunks();
+    }
+    buffered_rows_ -= num_rows;
+    if (!status.ok()) {
+      return errors::Internal(status.ToString());
+    }
+    return OkStatus();
+  }
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string filename_ TF_GUARDED_BY(mu_);
+  std::vector<string> column_names_ TF_GUARDED_BY(mu_);
+  int64 row_group_size_ TF_GUARDED_BY(mu_) = 0;
+  std::shared_ptr<parquet::WriterProperties> properties_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<ArrowWritableFile> sink_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<arrow::Schema> schema_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<parquet::arrow::FileWriter> writer_ TF_GUARDED_BY(mu_);
+  // Buffered arrays of each column, of buffered_rows_ rows
+  std::vector<arrow::ArrayVector> columns_ TF_GUARDED_BY(mu_);
+  int64 buffered_rows_ TF_GUARDED_BY(mu_) = 0;
+};
+
+class ParquetWriterInitOp : public ResourceOpKernel<ParquetWriterResource> {
+ public:
+  explicit ParquetWriterInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<ParquetWriterResource>(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("compression", &compression_));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("row_group_size", &row_group_size_));
+    OP_REQUIRES_OK(context, context->GetAttr("dictionary", &dictionary_));
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<ParquetWriterResource>::Compute(context);
+    mutex_lock l(mu_);
+    const Tensor* filename_tensor;
+    OP_REQUIRES_OK(context, context->input("filename", &filename_tensor));
+    const string& filename = filename_tensor->scalar<tstring>()();
+
+    const Tensor* column_names_tensor;
+    OP_REQUIRES_OK(context,
+                   context->input("column_names", &column_names_tensor));
+    OP_REQUIRES(
+        context, column_names_tensor->dims() <= 1,
+        errors::InvalidArgument("`column_names` must be a scalar or vector."));
+    std::vector<string> column_names;
+    column_names.reserve(column_names_tensor->NumElements());
+    for (int64 i = 0; i < column_names_tensor->NumElements(); ++i) {
+      column_names.push_back(column_names_tensor->flat<tstring>()(i));
+    }
+
+    OP_REQUIRES_OK(context,
+                   resource_->Init(filename, column_names, compression_,
+                                   row_group_size_, dictionary_));
+  }
+
+  Status CreateResource(ParquetWriterResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new ParquetWriterResource(env_);
+    return OkStatus();
+  }
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string compression_;
+  int64 row_group_size_;
+  bool dictionary_;
+};
+
+class ParquetWriterWriteOp : public OpKernel {
+ public:
+  explicit ParquetWriterWriteOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    ParquetWriterResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "writer", &resource));
+    core::ScopedUnref unref(resource);
+
+    OpInputList values_list;
+    OP_REQUIRES_OK(context, context->input_list("values", &values_list));
+    std::vector<Tensor> values(values_list.begin(), values_list.end());
+    OP_REQUIRES_OK(context, resource->Write(values));
+  }
+};
+
+class ParquetWriterCloseOp : public OpKernel {
+ public:
+  explicit ParquetWriterCloseOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    ParquetWriterResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "writer", &resource));
+    core::ScopedUnref unref(resource);
+    OP_REQUIRES_OK(context, resource->Close());
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("IO>ArrowWriterInit").Device(DEVICE_CPU),
+                        ArrowWriterInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ArrowWriterWrite").Device(DEVICE_CPU),
+                        ArrowWriterWriteOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ArrowWriterClose").Device(DEVICE_CPU),
+                        ArrowWriterCloseOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ParquetWriterInit").Device(DEVICE_CPU),
+                        ParquetWriterInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ParquetWriterWrite").Device(DEVICE_CPU),
+                        ParquetWriterWriteOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ParquetWriterClose").Device(DEVICE_CPU),
+                        ParquetWriterCloseOp);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
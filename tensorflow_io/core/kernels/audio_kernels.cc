@@ -15,7 +15,14 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/audio_kernels.h"
 
+#include <map>
+#include <tuple>
+
 #include "speex/speex_resampler.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
+#include "tensorflow_io/core/kernels/audio_samples.h"
 
 namespace tensorflow {
 namespace data {
@@ -71,15 +78,19 @@ class AudioReadableResource : public AudioReadableResourceBase {
     StringPiece result;
     TF_RETURN_IF_ERROR(file->Read(0, sizeof(header), &result, header));
     if (memcmp(header, "RIFF", 4) == 0) {
+      format_ = "wav";
       return WAVReadableResourceInit(env_, filename, optional_memory,
                                      optional_length, resource_);
     } else if (memcmp(header, "OggS", 4) == 0) {
+      format_ = "ogg";
       return OggVorbisReadableResourceInit(env_, filename, optional_memory,
                                            optional_length, resource_);
     } else if (memcmp(header, "fLaC", 4) == 0) {
+      format_ = "flac";
       return FlacReadableResourceInit(env_, filename, optional_memory,
                                       optional_length, resource_);
     }
+    format_ = "mp3";
     Status status = MP3ReadableResourceInit(env_, filename, optional_memory,
                                             optional_length, resource_);
     if (status.ok()) {
@@ -100,7 +111,15 @@ class AudioReadableResource : public AudioReadableResourceBase {
               std::function<Status(const TensorShape& shape, Tensor** value)>
                   allocate_func) override {
     mutex_lock l(mu_);
-    return resource_->Read(start, stop, allocate_func);
+    io::IOTrace trace("audio", io::IOTraceStage::kDecode, format_);
+    return resource_->Read(
+        start, stop,
+        [&](const TensorShape& shape, Tensor** value) -> Status {
+          TF_RETURN_IF_ERROR(allocate_func(shape, value));
+          trace.AddRecords(shape.dims() > 0 ? shape.dim_size(0) : 0);
+          trace.AddBytes((*value)->TotalBytes());
+          return OkStatus();
+        });
   }
   string DebugString() const override {
     mutex_lock l(mu_);
@@ -111,6 +130,8 @@ class AudioReadableResource : public AudioReadableResourceBase {
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<AudioReadableResourceBase> resource_ TF_GUARDED_BY(mu_);
+  // The format of resource_, a string literal for the decode span.
+  const char* format_ TF_GUARDED_BY(mu_) = nullptr;
 };
 
 class AudioReadableInitOp : public ResourceOpKernel<AudioReadableResource> {
@@ -217,6 +238,215 @@ class AudioReadableReadOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// Encodes the chunks written to it to a file, with the encoder of the format
+// made on the first chunk from its channels and dtype, which the chunks
+// after it must match. The file is closed on Close, or else once the
+// resource is destroyed.
+class AudioWritableResource : public ResourceBase {
+ public:
+  AudioWritableResource(Env* env) : env_(env) {}
+  ~AudioWritableResource() {
+    Status status = Close();
+    if (!status.ok()) {
+      LOG(ERROR) << "unable to close " << filename_ << ": " << status;
+    }
+  }
+
+  Status Init(const string& filename, const int64 rate,
+              const string& format) {
+    mutex_lock l(mu_);
+    format_ = format.empty() ? string(io::Extension(filename)) : format;
+    if (format_ == "mp4" || format_ == "m4a" || format_ == "aac") {
+      return errors::Unimplemented(
+          "streaming encode of mp4(aac) is not supported: ", filename);
+    }
+    if (format_ != "wav" && format_ != "flac" && format_ != "mp3") {
+      return errors::InvalidArgument("unknown format ", format_, ": ",
+                                     filename);
+    }
+    if (rate <= 0) {
+      return errors::InvalidArgument("invalid rate ", rate);
+    }
+    filename_ = filename;
+    rate_ = rate;
+    return env_->NewWritableFile(filename, &file_);
+  }
+  Status Write(const Tensor& value) {
+    mutex_lock l(mu_);
+    if (file_.get() == nullptr) {
+      return errors::FailedPrecondition("file is closed: ", filename_);
+    }
+    if (value.dims() != 2) {
+      return errors::InvalidArgument("chunk must be [samples, channels]: ",
+                                     value.shape().DebugString());
+    }
+    if (encoder_.get() == nullptr) {
+      channels_ = value.dim_size(1);
+      dtype_ = value.dtype();
+      if (format_ == "wav") {
+        TF_RETURN_IF_ERROR(WAVWritableEncoderInit(file_.get(), rate_,
+                                                  channels_, dtype_, encoder_));
+      } else if (format_ == "flac") {
+        TF_RETURN_IF_ERROR(FlacWritableEncoderInit(
+            file_.get(), rate_, channels_, dtype_, encoder_));
+      } else {
+        TF_RETURN_IF_ERROR(MP3WritableEncoderInit(file_.get(), rate_,
+                                                  channels_, dtype_, encoder_));
+      }
+    }
+    if (value.dim_size(1) != channels_ || value.dtype() != dtype_) {
+      return errors::InvalidArgument(
+          "chunk of ", value.dim_size(1), " channels and ",
+          DataTypeString(value.dtype()), " does not match the ", channels_,
+          " channels and ", DataTypeString(dtype_), " written before");
+    }
+    if (value.dim_size(0) == 0) {
+      return OkStatus();
+    }
+    return encoder_->Write(value);
+  }
+  Status Close() {
+    mutex_lock l(mu_);
+    if (file_.get() == nullptr) {
+      return OkStatus();
+    }
+    Status status;
+    if (encoder_.get() != nullptr) {
+      status.Update(encoder_->Finish());
+      encoder_.reset(nullptr);
+    }
+    status.Update(file_->Close());
+    file_.reset(nullptr);
+    return status;
+  }
+  string DebugString() const override { return "AudioWritableResource"; }
+
+ protected:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string filename_ TF_GUARDED_BY(mu_);
+  string format_ TF_GUARDED_BY(mu_);
+  int64 rate_ TF_GUARDED_BY(mu_);
+  int64 channels_ TF_GUARDED_BY(mu_);
+  DataType dtype_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> file_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<AudioWritableEncoderBase> encoder_ TF_GUARDED_BY(mu_);
+};
+
+class AudioWritableInitOp : public ResourceOpKernel<AudioWritableResource> {
+ public:
+  explicit AudioWritableInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<AudioWritableResource>(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("format", &format_));
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<AudioWritableResource>::Compute(context);
+
+    const Tensor* filename_tensor;
+    OP_REQUIRES_OK(context, context->input("filename", &filename_tensor));
+
+    const Tensor* rate_tensor;
+    OP_REQUIRES_OK(context, context->input("rate", &rate_tensor));
+
+    OP_REQUIRES_OK(context,
+                   resource_->Init(filename_tensor->scalar<tstring>()(),
+                                   rate_tensor->scalar<int64>()(), format_));
+  }
+  Status CreateResource(AudioWritableResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new AudioWritableResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  string format_;
+};
+
+class AudioWritableWriteOp : public OpKernel {
+ public:
+  explicit AudioWritableWriteOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    AudioWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* value_tensor;
+    OP_REQUIRES_OK(context, context->input("value", &value_tensor));
+
+    OP_REQUIRES_OK(context, resource->Write(*value_tensor));
+  }
+};
+
+class AudioWritableCloseOp : public OpKernel {
+ public:
+  explicit AudioWritableCloseOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    AudioWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    OP_REQUIRES_OK(context, resource->Close());
+  }
+};
+
+// Resampler states kept per thread and per configuration, which the ops
+// reset and reuse instead of creating and destroying one per call.
+class ResamplerCache {
+ public:
+  ~ResamplerCache() {
+    for (auto& entry : states_) {
+      speex_resampler_destroy(entry.second);
+    }
+  }
+
+  // Returns the resampler of the calling thread, valid until the next call
+  // from that thread.
+  static Status Get(const int64 channels, const int64 rate_in,
+                    const int64 rate_out, const int64 quality,
+                    SpeexResamplerState** state) {
+    thread_local ResamplerCache cache;
+    const auto key = std::make_tuple(channels, rate_in, rate_out, quality);
+    auto it = cache.states_.find(key);
+    if (it != cache.states_.end()) {
+      speex_resampler_reset_mem(it->second);
+      *state = it->second;
+      return OkStatus();
+    }
+    int err = 0;
+    SpeexResamplerState* created =
+        speex_resampler_init(channels, rate_in, rate_out, quality, &err);
+    if (created == nullptr) {
+      return errors::InvalidArgument("unable to initialize resampler: ", err);
+    }
+    if (cache.states_.size() >= kMaxStates) {
+      for (auto& entry : cache.states_) {
+        speex_resampler_destroy(entry.second);
+      }
+      cache.states_.clear();
+    }
+    cache.states_[key] = created;
+    *state = created;
+    return OkStatus();
+  }
+
+ private:
+  static constexpr size_t kMaxStates = 16;
+
+  std::map<std::tuple<int64, int64, int64, int64>, SpeexResamplerState*>
+      states_;
+};
+
 class AudioResampleOp : public OpKernel {
  public:
   explicit AudioResampleOp(OpKernelConstruction* context) : OpKernel(context) {}
@@ -236,19 +466,9 @@ class AudioResampleOp : public OpKernel {
     int64 samples_in = input_tensor->shape().dim_size(0);
     int64 channels = input_tensor->shape().dim_size(1);
 
-    std::unique_ptr<SpeexResamplerState, void (*)(SpeexResamplerState*)> state(
-        nullptr, [](SpeexResamplerState* p) {
-          if (p != nullptr) {
-            speex_resampler_destroy(p);
-          }
-        });
-
-    int err = 0;
-    state.reset(
-        speex_resampler_init(channels, rate_in, rate_out, quality_, &err));
-    OP_REQUIRES(
-        context, (state.get() != nullptr),
-        errors::InvalidArgument("unable to initialize resampler: ", err));
+    SpeexResamplerState* state = nullptr;
+    OP_REQUIRES_OK(context, ResamplerCache::Get(channels, rate_in, rate_out,
+                                                quality_, &state));
 
     int64 samples_out = samples_in * rate_out / rate_in;
     Tensor* output_tensor;
@@ -261,7 +481,7 @@ class AudioResampleOp : public OpKernel {
         uint32_t processed_in = samples_in;
         uint32_t processed_out = samples_out;
         int returned = speex_resampler_process_interleaved_int(
-            state.get(), input_tensor->flat<int16>().data(), &processed_in,
+            state, input_tensor->flat<int16>().data(), &processed_in,
             output_tensor->flat<int16>().data(), &processed_out);
         OP_REQUIRES(context, (returned == 0),
                     errors::InvalidArgument("process error: ", returned));
@@ -277,7 +497,7 @@ class AudioResampleOp : public OpKernel {
         uint32_t processed_in = samples_in;
         uint32_t processed_out = samples_out;
         int returned = speex_resampler_process_interleaved_float(
-            state.get(), input_tensor->flat<float>().data(), &processed_in,
+            state, input_tensor->flat<float>().data(), &processed_in,
             output_tensor->flat<float>().data(), &processed_out);
         OP_REQUIRES(context, (returned == 0),
                     errors::InvalidArgument("process error: ", returned));
@@ -298,6 +518,277 @@ class AudioResampleOp : public OpKernel {
   static const int64 quality_ = SPEEX_RESAMPLER_QUALITY_DEFAULT;
 };
 
+// Decodes a clip, of any of the formats of AudioReadableResource, into float
+// samples at `rate_out`, optionally mixed down to mono. The clip is decoded,
+// converted, mixed down and resampled in chunks, so that the samples at the
+// rate and channels of the clip are only held one chunk at a time.
+class AudioDecodeResampleOp : public OpKernel {
+ public:
+  explicit AudioDecodeResampleOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("mono", &mono_));
+    OP_REQUIRES_OK(context, context->GetAttr("quality", &quality_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const tstring& input = input_tensor->scalar<tstring>()();
+
+    const Tensor* rate_out_tensor;
+    OP_REQUIRES_OK(context, context->input("rate_out", &rate_out_tensor));
+    const int64 rate_out = rate_out_tensor->scalar<int64>()();
+    OP_REQUIRES(context, rate_out > 0,
+                errors::InvalidArgument("rate_out must be positive: ",
+                                        rate_out));
+
+    OP_REQUIRES(context, !input.empty(),
+                errors::InvalidArgument("audio clip is empty"));
+    AudioReadableResource* resource = new AudioReadableResource(env_);
+    core::ScopedUnref unref(resource);
+    OP_REQUIRES_OK(context,
+                   resource->Init("memory", input.data(), input.size()));
+    TensorShape shape;
+    DataType dtype;
+    int32 rate_in;
+    OP_REQUIRES_OK(context, resource->Spec(&shape, &dtype, &rate_in));
+    OP_REQUIRES(context, rate_in > 0,
+                errors::InvalidArgument("invalid rate of clip: ", rate_in));
+
+    const int64 samples_in = shape.dim_size(0);
+    const int64 channels_in = shape.dim_size(1);
+    const int64 channels = mono_ ? 1 : channels_in;
+    const int64 samples_out = samples_in * rate_out / rate_in;
+
+    SpeexResamplerState* state = nullptr;
+    if (rate_in != rate_out) {
+      OP_REQUIRES_OK(context, ResamplerCache::Get(channels, rate_in, rate_out,
+                                                  quality_, &state));
+    }
+
+    Tensor value;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(
+                       DT_FLOAT, TensorShape({samples_out, channels}), &value));
+    float* out = value.flat<float>().data();
+
+    Tensor chunk;
+    std::vector<float> converted;
+    std::vector<float> mixed;
+    int64 produced = 0;
+    for (int64 start = 0; start < samples_in && produced < samples_out;
+         start += kChunkSize) {
+      const int64 stop = std::min(start + kChunkSize, samples_in);
+      OP_REQUIRES_OK(
+          context,
+          resource->Read(start, stop,
+                         [&](const TensorShape& chunk_shape,
+                             Tensor** chunk_value) -> Status {
+                           chunk = Tensor(dtype, chunk_shape);
+                           *chunk_value = &chunk;
+                           return OkStatus();
+                         }));
+      const int64 frames = chunk.dim_size(0);
+      const float* samples = nullptr;
+      OP_REQUIRES_OK(context, Convert(chunk, &converted, &samples));
+      if (mono_ && channels_in > 1) {
+        mixed.resize(frames);
+        for (int64 i = 0; i < frames; i++) {
+          float sum = 0.0f;
+          for (int64 c = 0; c < channels_in; c++) {
+            sum += samples[i * channels_in + c];
+          }
+          mixed[i] = sum / channels_in;
+        }
+        samples = mixed.data();
+      }
+      if (state == nullptr) {
+        const int64 count = std::min(frames, samples_out - produced);
+        memcpy(out + produced * channels, samples,
+               count * channels * sizeof(float));
+        produced += count;
+        continue;
+      }
+      uint32_t processed_in = frames;
+      uint32_t processed_out = samples_out - produced;
+      int returned = speex_resampler_process_interleaved_float(
+          state, samples, &processed_in, out + produced * channels,
+          &processed_out);
+      OP_REQUIRES(context, (returned == 0),
+                  errors::InvalidArgument("process error: ", returned));
+      produced += processed_out;
+    }
+    context->set_output(0, produced < samples_out ? value.Slice(0, produced)
+                                                  : value);
+  }
+
+ private:
+  // Points `samples` at the chunk as float, converted into `converted` from
+  // integers.
+  static Status Convert(const Tensor& chunk, std::vector<float>* converted,
+                        const float** samples) {
+    const int64 count = chunk.NumElements();
+    if (chunk.dtype() == DT_FLOAT) {
+      *samples = chunk.flat<float>().data();
+      return OkStatus();
+    }
+    converted->resize(count);
+    switch (chunk.dtype()) {
+      case DT_UINT8:
+        ConvertSamples(chunk.flat<uint8>().data(), count, converted->data());
+        break;
+      case DT_INT16:
+        ConvertSamples(chunk.flat<int16>().data(), count, converted->data());
+        break;
+      case DT_INT32:
+        ConvertSamples(chunk.flat<int32>().data(), count, converted->data());
+        break;
+      default:
+        return errors::InvalidArgument("data type ",
+                                       DataTypeString(chunk.dtype()),
+                                       " not supported");
+    }
+    *samples = converted->data();
+    return OkStatus();
+  }
+
+  // The number of frames read, converted and resampled at a time.
+  static constexpr int64 kChunkSize = 1 << 16;
+
+  Env* env_;
+  bool mono_;
+  int64 quality_;
+};
+
+// Decodes a batch of clips, of any of the formats of AudioReadableResource,
+// with one clip per unit of work of the CPU worker threads. The samples of
+// all clips are concatenated along the first dimension, with row splits, and
+// integer samples are scaled to [-1.0, 1.0) for float32.
+class AudioDecodeBatchOp : public OpKernel {
+ public:
+  explicit AudioDecodeBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const int64 count = input_tensor->NumElements();
+
+    // Each unit of work is one clip, so the cost keeps them on their own
+    // threads.
+    static constexpr int64 kCostPerClip = 1 << 20;
+    const DeviceBase::CpuWorkerThreads* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+
+    std::vector<Tensor> clips(count);
+    std::vector<int32> rates(count);
+    std::vector<Status> statuses(count);
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerClip, [&](int64 begin, int64 end) {
+            for (int64 i = begin; i < end; i++) {
+              statuses[i] = Decode(input_tensor->flat<tstring>()(i),
+                                   &clips[i], &rates[i]);
+            }
+          });
+
+    Tensor* row_splits_tensor = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, TensorShape({count + 1}),
+                                            &row_splits_tensor));
+    auto row_splits = row_splits_tensor->flat<int64>();
+    row_splits(0) = 0;
+    int64 channels = 0;
+    for (int64 i = 0; i < count; i++) {
+      OP_REQUIRES_OK(context, statuses[i]);
+      const DataType dtype = clips[i].dtype();
+      OP_REQUIRES(context, dtype == dtype_ || dtype_ == DT_FLOAT,
+                  errors::InvalidArgument("clip ", i, " of ",
+                                          DataTypeString(dtype),
+                                          " can not be decoded as ",
+                                          DataTypeString(dtype_)));
+      if (i == 0) {
+        channels = clips[i].dim_size(1);
+      }
+      OP_REQUIRES(context, clips[i].dim_size(1) == channels,
+                  errors::InvalidArgument("clip ", i, " has ",
+                                          clips[i].dim_size(1),
+                                          " channels instead of ", channels));
+      row_splits(i + 1) = row_splits(i) + clips[i].dim_size(0);
+    }
+
+    Tensor* value_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({row_splits(count), channels}),
+                                &value_tensor));
+    Tensor* rate_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(2, TensorShape({count}),
+                                                     &rate_tensor));
+    for (int64 i = 0; i < count; i++) {
+      rate_tensor->flat<int32>()(i) = rates[i];
+    }
+
+    const int64 size = DataTypeSize(dtype_);
+    char* base = static_cast<char*>(value_tensor->data());
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerClip, [&](int64 begin, int64 end) {
+            for (int64 i = begin; i < end; i++) {
+              const Tensor& clip = clips[i];
+              const int64 offset = row_splits(i) * channels;
+              const int64 samples = clip.NumElements();
+              if (samples == 0) {
+                continue;
+              }
+              if (clip.dtype() == dtype_) {
+                memcpy(base + offset * size, clip.tensor_data().data(),
+                       samples * size);
+                continue;
+              }
+              float* out = reinterpret_cast<float*>(base) + offset;
+              switch (clip.dtype()) {
+                case DT_UINT8:
+                  ConvertSamples(clip.flat<uint8>().data(), samples, out);
+                  break;
+                case DT_INT16:
+                  ConvertSamples(clip.flat<int16>().data(), samples, out);
+                  break;
+                case DT_INT32:
+                  ConvertSamples(clip.flat<int32>().data(), samples, out);
+                  break;
+                default:
+                  break;
+              }
+            }
+          });
+  }
+
+ private:
+  Status Decode(const tstring& input, Tensor* clip, int32* rate) {
+    if (input.empty()) {
+      return errors::InvalidArgument("audio clip is empty");
+    }
+    AudioReadableResource* resource = new AudioReadableResource(env_);
+    core::ScopedUnref unref(resource);
+    TF_RETURN_IF_ERROR(resource->Init("memory", input.data(), input.size()));
+    TensorShape shape;
+    DataType dtype;
+    TF_RETURN_IF_ERROR(resource->Spec(&shape, &dtype, rate));
+    return resource->Read(
+        0, shape.dim_size(0),
+        [&](const TensorShape& value_shape, Tensor** value) -> Status {
+          *clip = Tensor(dtype, value_shape);
+          *value = clip;
+          return OkStatus();
+        });
+  }
+
+  Env* env_;
+  DataType dtype_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableInit").Device(DEVICE_CPU),
                         AudioReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableSpec").Device(DEVICE_CPU),
@@ -305,8 +796,19 @@ REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableSpec").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableRead").Device(DEVICE_CPU),
                         AudioReadableReadOp);
 
+REGISTER_KERNEL_BUILDER(Name("IO>AudioWritableInit").Device(DEVICE_CPU),
+                        AudioWritableInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioWritableWrite").Device(DEVICE_CPU),
+                        AudioWritableWriteOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioWritableClose").Device(DEVICE_CPU),
+                        AudioWritableCloseOp);
+
 REGISTER_KERNEL_BUILDER(Name("IO>AudioResample").Device(DEVICE_CPU),
                         AudioResampleOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeBatch").Device(DEVICE_CPU),
+                        AudioDecodeBatchOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeResample").Device(DEVICE_CPU),
+                        AudioDecodeResampleOp);
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -56,5 +56,27 @@ Status MP4AACReadableResourceInit(
     const size_t optional_length,
     std::unique_ptr<AudioReadableResourceBase>& resource);
 
+// Encodes the chunks of a waveform written in succession to a file, with the
+// state of the encoder kept between the chunks, so that encoded bytes reach
+// the file as the chunks come. The chunks are [samples, channels] of the
+// channels and dtype the encoder was made for.
+class AudioWritableEncoderBase {
+ public:
+  virtual ~AudioWritableEncoderBase() {}
+  virtual Status Write(const Tensor& value) = 0;
+  // Encodes what the encoder holds back, once all the chunks are written.
+  virtual Status Finish() = 0;
+};
+
+Status WAVWritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder);
+Status FlacWritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder);
+Status MP3WritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder);
+
 }  // namespace data
 }  // namespace tensorflow
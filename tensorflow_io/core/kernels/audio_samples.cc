@@ -0,0 +1,354 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/audio_samples.h"
+
+#include <cstring>
+
+#include "tensorflow_io/core/kernels/cpu_info.h"
+
+#ifdef TFIO_DISPATCH_X86
+#include <immintrin.h>
+// SSE2 is part of x86-64, later extensions are compiled per function and only
+// called when the CPU has them.
+#define TFIO_AUDIO_SAMPLES_X86
+#endif
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+static constexpr float kUInt8Scale = 1.0f / 128.0f;
+static constexpr float kInt16Scale = 1.0f / 32768.0f;
+static constexpr float kInt32Scale = 1.0f / 2147483648.0f;
+
+// Interleaves samples [start, count) of the planes one at a time.
+template <typename In, typename Out, typename Convert>
+void InterleaveScalar(const In* const* planes, const int64 channels,
+                      const int64 start, const int64 count, Out* out,
+                      Convert convert) {
+  if (channels == 1) {
+    for (int64 i = start; i < count; i++) {
+      out[i] = convert(planes[0][i]);
+    }
+    return;
+  }
+  for (int64 i = start; i < count; i++) {
+    for (int64 c = 0; c < channels; c++) {
+      out[i * channels + c] = convert(planes[c][i]);
+    }
+  }
+}
+
+#ifdef TFIO_AUDIO_SAMPLES_X86
+// The SIMD loops below return how many samples they handled, which leaves a
+// tail shorter than a vector to the scalar loops.
+
+int64 InterleaveStereoSSE2(const float* left, const float* right,
+                           const int64 count, float* out) {
+  int64 i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 l = _mm_loadu_ps(left + i);
+    __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+  return i;
+}
+
+// Keeps the low 16 bits of each int32 sign extended, so that the saturating
+// pack truncates as the scalar conversion does.
+inline __m128i LoadInt32AsInt16(const int32* in) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
+
+int64 InterleaveStereoSSE2(const int32* left, const int32* right,
+                           const int64 count, int16* out) {
+  int64 i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i l = _mm_packs_epi32(LoadInt32AsInt16(left + i),
+                                LoadInt32AsInt16(left + i + 4));
+    __m128i r = _mm_packs_epi32(LoadInt32AsInt16(right + i),
+                                LoadInt32AsInt16(right + i + 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                     _mm_unpacklo_epi16(l, r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 8),
+                     _mm_unpackhi_epi16(l, r));
+  }
+  return i;
+}
+
+int64 InterleaveStereoSSE2(const int32* left, const int32* right,
+                           const int64 count, int32* out) {
+  int64 i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i l = _mm_slli_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i)), 8);
+    __m128i r = _mm_slli_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i)), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                     _mm_unpacklo_epi32(l, r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 4),
+                     _mm_unpackhi_epi32(l, r));
+  }
+  return i;
+}
+
+int64 DeinterleaveStereoSSE2(const float* in, const int64 count, float* left,
+                             float* right) {
+  int64 i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 a = _mm_loadu_ps(in + 2 * i);
+    __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  return i;
+}
+
+TFIO_TARGET("ssse3")
+int64 UnpackInt24SSSE3(const char* in, const int64 count, int32* out) {
+  // Moves the 3 bytes of each sample to the upper bytes of an int32, with
+  // zero (index -1) in the lowest byte.
+  const __m128i shuffle =
+      _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  int64 i = 0;
+  // Each load reads 16 bytes for the 12 of 4 samples, so it stops before the
+  // last 6 samples to stay within `in`.
+  for (; i + 6 <= count; i += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm_shuffle_epi8(v, shuffle));
+  }
+  return i;
+}
+
+int64 ConvertInt16SSE2(const int16* in, const int64 count, float* out) {
+  const __m128 scale = _mm_set1_ps(kInt16Scale);
+  int64 i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    // Sign extends by moving each sample to the upper half of an int32.
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  return i;
+}
+
+TFIO_TARGET("avx2")
+int64 ConvertInt16AVX2(const int16* in, const int64 count, float* out) {
+  const __m256 scale = _mm256_set1_ps(kInt16Scale);
+  int64 i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i v = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  return i;
+}
+
+int64 ConvertInt32SSE2(const int32* in, const int64 count, float* out) {
+  const __m128 scale = _mm_set1_ps(kInt32Scale);
+  int64 i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+  }
+  return i;
+}
+
+TFIO_TARGET("avx2")
+int64 ConvertInt32AVX2(const int32* in, const int64 count, float* out) {
+  const __m256 scale = _mm256_set1_ps(kInt32Scale);
+  int64 i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  return i;
+}
+
+int64 MultiplySSE2(const float* in, const float* window, const int64 count,
+                   float* out) {
+  int64 i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(out + i,
+                  _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(window + i)));
+  }
+  return i;
+}
+
+TFIO_TARGET("avx")
+int64 MultiplyAVX(const float* in, const float* window, const int64 count,
+                  float* out) {
+  int64 i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i),
+                                            _mm256_loadu_ps(window + i)));
+  }
+  return i;
+}
+
+using MultiplyFunc = int64 (*)(const float* in, const float* window,
+                               const int64 count, float* out);
+
+MultiplyFunc SelectMultiply() {
+  return io::CanDispatch(io::DispatchISA::kAVX) ? MultiplyAVX : MultiplySSE2;
+}
+
+template <typename In>
+using ConvertFunc = int64 (*)(const In* in, const int64 count, float* out);
+
+ConvertFunc<int16> SelectConvertInt16() {
+  return io::CanDispatch(io::DispatchISA::kAVX2) ? ConvertInt16AVX2
+                                                 : ConvertInt16SSE2;
+}
+ConvertFunc<int32> SelectConvertInt32() {
+  return io::CanDispatch(io::DispatchISA::kAVX2) ? ConvertInt32AVX2
+                                                 : ConvertInt32SSE2;
+}
+#endif  // TFIO_AUDIO_SAMPLES_X86
+
+}  // namespace
+
+void InterleaveSamples(const float* const* planes, const int64 channels,
+                       const int64 count, float* out) {
+  if (channels == 1) {
+    if (count > 0) memcpy(out, planes[0], count * sizeof(float));
+    return;
+  }
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  if (channels == 2) {
+    i = InterleaveStereoSSE2(planes[0], planes[1], count, out);
+  }
+#endif
+  InterleaveScalar(planes, channels, i, count, out,
+                   [](const float v) { return v; });
+}
+
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, uint8* out) {
+  InterleaveScalar(planes, channels, 0, count, out, [](const int32 v) {
+    return static_cast<uint8>(v + 0x80);
+  });
+}
+
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, int16* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  if (channels == 2) {
+    i = InterleaveStereoSSE2(planes[0], planes[1], count, out);
+  }
+#endif
+  InterleaveScalar(planes, channels, i, count, out,
+                   [](const int32 v) { return static_cast<int16>(v); });
+}
+
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, int32* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  if (channels == 2) {
+    i = InterleaveStereoSSE2(planes[0], planes[1], count, out);
+  }
+#endif
+  InterleaveScalar(planes, channels, i, count, out, [](const int32 v) {
+    return static_cast<int32>(static_cast<uint32>(v) << 8);
+  });
+}
+
+void DeinterleaveSamples(const float* in, const int64 channels,
+                         const int64 count, float* const* planes) {
+  if (channels == 1) {
+    if (count > 0) memcpy(planes[0], in, count * sizeof(float));
+    return;
+  }
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  if (channels == 2) {
+    i = DeinterleaveStereoSSE2(in, count, planes[0], planes[1]);
+  }
+#endif
+  for (; i < count; i++) {
+    for (int64 c = 0; c < channels; c++) {
+      planes[c][i] = in[i * channels + c];
+    }
+  }
+}
+
+void UnpackInt24Samples(const char* in, const int64 count, int32* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  static const bool ssse3 = io::CanDispatch(io::DispatchISA::kSSE4_2);
+  if (ssse3) {
+    i = UnpackInt24SSSE3(in, count, out);
+  }
+#endif
+  const uint8* p = reinterpret_cast<const uint8*>(in);
+  for (; i < count; i++) {
+    const uint32 v = (static_cast<uint32>(p[i * 3]) << 8) |
+                     (static_cast<uint32>(p[i * 3 + 1]) << 16) |
+                     (static_cast<uint32>(p[i * 3 + 2]) << 24);
+    out[i] = static_cast<int32>(v);
+  }
+}
+
+void ConvertSamples(const uint8* in, const int64 count, float* out) {
+  for (int64 i = 0; i < count; i++) {
+    out[i] = (static_cast<float>(in[i]) - 128.0f) * kUInt8Scale;
+  }
+}
+
+void ConvertSamples(const int16* in, const int64 count, float* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  static const ConvertFunc<int16> convert = SelectConvertInt16();
+  i = convert(in, count, out);
+#endif
+  for (; i < count; i++) {
+    out[i] = static_cast<float>(in[i]) * kInt16Scale;
+  }
+}
+
+void ConvertSamples(const int32* in, const int64 count, float* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  static const ConvertFunc<int32> convert = SelectConvertInt32();
+  i = convert(in, count, out);
+#endif
+  for (; i < count; i++) {
+    out[i] = static_cast<float>(in[i]) * kInt32Scale;
+  }
+}
+
+void MultiplySamples(const float* in, const float* window, const int64 count,
+                     float* out) {
+  int64 i = 0;
+#ifdef TFIO_AUDIO_SAMPLES_X86
+  static const MultiplyFunc multiply = SelectMultiply();
+  i = multiply(in, window, count, out);
+#endif
+  for (; i < count; i++) {
+    out[i] = in[i] * window[i];
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,63 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AUDIO_SAMPLES_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AUDIO_SAMPLES_H_
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data {
+
+// Conversions of blocks of PCM samples shared by the audio decoders and
+// encoders. The common cases have SIMD versions, picked once at runtime from
+// the features of the CPU, with scalar loops for the others.
+
+// Interleaves `count` samples of each of the `channels` planes into `out`, as
+// [count, channels]. Integer planes hold the samples of a FLAC frame, which
+// are stored offset by 0x80 to uint8, as is to int16, and shifted left by 8
+// from 24 bits to int32.
+void InterleaveSamples(const float* const* planes, const int64 channels,
+                       const int64 count, float* out);
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, uint8* out);
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, int16* out);
+void InterleaveSamples(const int32* const* planes, const int64 channels,
+                       const int64 count, int32* out);
+
+// Splits `count` samples of [count, channels] `in` into the `channels`
+// planes.
+void DeinterleaveSamples(const float* in, const int64 channels,
+                         const int64 count, float* const* planes);
+
+// Unpacks `count` little endian 24 bit samples into the upper 24 bits of
+// int32 samples.
+void UnpackInt24Samples(const char* in, const int64 count, int32* out);
+
+// Scales `count` integer samples to float samples in [-1.0, 1.0).
+void ConvertSamples(const uint8* in, const int64 count, float* out);
+void ConvertSamples(const int16* in, const int64 count, float* out);
+void ConvertSamples(const int32* in, const int64 count, float* out);
+
+// Multiplies `count` samples of `in` by those of `window` into `out`, which
+// may be `in`.
+void MultiplySamples(const float* in, const float* window, const int64 count,
+                     float* out);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AUDIO_SAMPLES_H_
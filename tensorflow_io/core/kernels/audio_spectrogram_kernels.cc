@@ -0,0 +1,445 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/kernels/audio_samples.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using Complex = std::complex<float>;
+
+// Multiplies without the checks for infinities of std::complex, which are
+// out of line calls.
+inline Complex Multiply(const Complex a, const Complex b) {
+  return Complex(a.real() * b.real() - a.imag() * b.imag(),
+                 a.real() * b.imag() + a.imag() * b.real());
+}
+
+// A forward complex FFT of any size, planned once: sizes that are a power of
+// two run radix 2, the others run Bluestein's algorithm over a power of two
+// size of at least 2 * n - 1.
+class ComplexFFT {
+ public:
+  explicit ComplexFFT(const int64 n) : n_(n) {
+    size_ = 1;
+    while (size_ < n_) {
+      size_ <<= 1;
+    }
+    if (size_ != n_) {
+      size_ = 1;
+      while (size_ < 2 * n_ - 1) {
+        size_ <<= 1;
+      }
+    }
+    int64 bits = 0;
+    while ((int64{1} << bits) < size_) {
+      bits++;
+    }
+    reverse_.resize(size_);
+    for (int64 i = 0; i < size_; i++) {
+      int64 r = 0;
+      for (int64 b = 0; b < bits; b++) {
+        r |= ((i >> b) & 1) << (bits - 1 - b);
+      }
+      reverse_[i] = r;
+    }
+    twiddles_.resize(size_ / 2);
+    for (int64 i = 0; i < size_ / 2; i++) {
+      const double angle = -2.0 * M_PI * i / size_;
+      twiddles_[i] = Complex(std::cos(angle), std::sin(angle));
+    }
+    if (size_ == n_) {
+      return;
+    }
+    // The chirp is exp(-i * pi * k^2 / n), with k^2 taken modulo 2 * n so
+    // that the angle stays accurate for long transforms.
+    chirp_.resize(n_);
+    for (int64 k = 0; k < n_; k++) {
+      const double angle = -M_PI * ((k * k) % (2 * n_)) / n_;
+      chirp_[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+    // The transform of the conjugate chirp, circularly symmetric and scaled
+    // by the 1 / size of the inverse transform.
+    kernel_.assign(size_, Complex(0.0f, 0.0f));
+    for (int64 k = 0; k < n_; k++) {
+      kernel_[k] = std::conj(chirp_[k]);
+      if (k > 0) {
+        kernel_[size_ - k] = std::conj(chirp_[k]);
+      }
+    }
+    Radix2(kernel_.data());
+    for (int64 k = 0; k < size_; k++) {
+      kernel_[k] /= static_cast<float>(size_);
+    }
+  }
+
+  int64 size() const { return n_; }
+
+  // Transforms the n values of `data` in place, with `scratch` for Bluestein.
+  void Forward(Complex* data, std::vector<Complex>* scratch) const {
+    if (size_ == n_) {
+      Radix2(data);
+      return;
+    }
+    scratch->assign(size_, Complex(0.0f, 0.0f));
+    Complex* a = scratch->data();
+    for (int64 k = 0; k < n_; k++) {
+      a[k] = Multiply(data[k], chirp_[k]);
+    }
+    Radix2(a);
+    // The inverse transform is the conjugate of the forward transform of
+    // the conjugate.
+    for (int64 k = 0; k < size_; k++) {
+      a[k] = std::conj(Multiply(a[k], kernel_[k]));
+    }
+    Radix2(a);
+    for (int64 k = 0; k < n_; k++) {
+      data[k] = Multiply(chirp_[k], std::conj(a[k]));
+    }
+  }
+
+ private:
+  void Radix2(Complex* data) const {
+    for (int64 i = 0; i < size_; i++) {
+      if (i < reverse_[i]) {
+        std::swap(data[i], data[reverse_[i]]);
+      }
+    }
+    for (int64 length = 2; length <= size_; length <<= 1) {
+      const int64 half = length / 2;
+      const int64 step = size_ / length;
+      for (int64 i = 0; i < size_; i += length) {
+        for (int64 j = 0; j < half; j++) {
+          const Complex u = data[i + j];
+          const Complex v = Multiply(data[i + j + half], twiddles_[j * step]);
+          data[i + j] = u + v;
+          data[i + j + half] = u - v;
+        }
+      }
+    }
+  }
+
+  const int64 n_;
+  int64 size_;
+  std::vector<int64> reverse_;
+  std::vector<Complex> twiddles_;
+  std::vector<Complex> chirp_;
+  std::vector<Complex> kernel_;
+};
+
+// The power spectrum of real frames of nfft samples, through a complex FFT of
+// half the size for an even nfft.
+class PowerSpectrum {
+ public:
+  explicit PowerSpectrum(const int64 nfft)
+      : nfft_(nfft), fft_(nfft % 2 == 0 ? nfft / 2 : nfft) {
+    if (nfft_ % 2 != 0) {
+      return;
+    }
+    twiddles_.resize(nfft_ / 2 + 1);
+    for (int64 k = 0; k <= nfft_ / 2; k++) {
+      const double angle = -2.0 * M_PI * k / nfft_;
+      twiddles_[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+  }
+
+  int64 bins() const { return nfft_ / 2 + 1; }
+
+  // Returns the buffer a frame of nfft samples is written to, as floats.
+  float* Frame(std::vector<Complex>* buffer) const {
+    buffer->resize(fft_.size());
+    return reinterpret_cast<float*>(buffer->data());
+  }
+
+  // Computes the bins() powers of the frame in `buffer`.
+  void Compute(std::vector<Complex>* buffer, std::vector<Complex>* scratch,
+               float* power) const {
+    Complex* z = buffer->data();
+    if (nfft_ % 2 != 0) {
+      // The frame was written as the first half of the buffer, and is
+      // spread out to the real parts.
+      const float* frame = reinterpret_cast<const float*>(z);
+      scratch->assign(frame, frame + nfft_);
+      std::copy(scratch->begin(), scratch->end(), z);
+      fft_.Forward(z, scratch);
+      for (int64 k = 0; k < bins(); k++) {
+        power[k] = std::norm(z[k]);
+      }
+      return;
+    }
+    // The even and odd samples are the real and imaginary parts of z, whose
+    // transform Z splits into those of the even and odd samples.
+    fft_.Forward(z, scratch);
+    const int64 half = nfft_ / 2;
+    for (int64 k = 0; k <= half; k++) {
+      const Complex a = z[k % half];
+      const Complex b = std::conj(z[(half - k) % half]);
+      const Complex even = (a + b) * 0.5f;
+      const Complex odd = Multiply(a - b, Complex(0.0f, -0.5f));
+      power[k] = std::norm(even + Multiply(twiddles_[k], odd));
+    }
+  }
+
+ private:
+  const int64 nfft_;
+  const ComplexFFT fft_;
+  std::vector<Complex> twiddles_;
+};
+
+// The triangular filters of tf.signal.linear_to_mel_weight_matrix, each kept
+// as the weights of the bins it spans only.
+class MelFilterbank {
+ public:
+  MelFilterbank(const int64 bins, const int64 rate, const int64 mels,
+                const double fmin, const double fmax)
+      : start_(mels), weights_(mels) {
+    const double nyquist = rate / 2.0;
+    const double lower = HertzToMel(fmin);
+    const double upper = HertzToMel(fmax);
+    for (int64 m = 0; m < mels; m++) {
+      const double left = lower + (upper - lower) * m / (mels + 1);
+      const double center = lower + (upper - lower) * (m + 1) / (mels + 1);
+      const double right = lower + (upper - lower) * (m + 2) / (mels + 1);
+      start_[m] = bins;
+      // The bin of 0 Hz is always left out.
+      for (int64 k = 1; k < bins; k++) {
+        const double mel = HertzToMel(nyquist * k / (bins - 1));
+        const double weight = std::min((mel - left) / (center - left),
+                                       (right - mel) / (right - center));
+        if (weight <= 0.0) {
+          if (start_[m] < bins) {
+            break;
+          }
+          continue;
+        }
+        if (start_[m] == bins) {
+          start_[m] = k;
+        }
+        weights_[m].push_back(weight);
+      }
+    }
+  }
+
+  int64 mels() const { return weights_.size(); }
+
+  void Compute(const float* spectrum, float* out) const {
+    for (size_t m = 0; m < weights_.size(); m++) {
+      const float* bins = spectrum + start_[m];
+      const std::vector<float>& weights = weights_[m];
+      float sum = 0.0f;
+      for (size_t k = 0; k < weights.size(); k++) {
+        sum += weights[k] * bins[k];
+      }
+      out[m] = sum;
+    }
+  }
+
+ private:
+  static double HertzToMel(const double hertz) {
+    return 1127.0 * std::log1p(hertz / 700.0);
+  }
+
+  std::vector<int64> start_;
+  std::vector<std::vector<float>> weights_;
+};
+
+// Computes the magnitude spectrogram of 1-D audio as tfio.audio.spectrogram
+// does, and then its mel scale, its log and its MFCCs, in one pass over the
+// frames. The window and the FFT are planned once per kernel, and the mel
+// filterbank once per rate.
+template <typename T>
+class AudioMelSpectrogramOp : public OpKernel {
+ public:
+  explicit AudioMelSpectrogramOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("nfft", &nfft_));
+    OP_REQUIRES_OK(context, context->GetAttr("window", &window_length_));
+    OP_REQUIRES_OK(context, context->GetAttr("stride", &stride_));
+    OP_REQUIRES_OK(context, context->GetAttr("mels", &mels_));
+    OP_REQUIRES_OK(context, context->GetAttr("fmin", &fmin_));
+    OP_REQUIRES_OK(context, context->GetAttr("fmax", &fmax_));
+    OP_REQUIRES_OK(context, context->GetAttr("power", &power_));
+    OP_REQUIRES_OK(context, context->GetAttr("log", &log_));
+    OP_REQUIRES_OK(context, context->GetAttr("mfcc", &mfcc_));
+    OP_REQUIRES(context, nfft_ > 0 && window_length_ > 0 && stride_ > 0,
+                errors::InvalidArgument(
+                    "nfft, window and stride must be positive: ", nfft_, ", ",
+                    window_length_, ", ", stride_));
+    OP_REQUIRES(context, mels_ > 0,
+                errors::InvalidArgument("mels must be positive: ", mels_));
+    OP_REQUIRES(context, 0 <= fmin_ && fmin_ < fmax_,
+                errors::InvalidArgument("invalid frequency range: [", fmin_,
+                                        ", ", fmax_, ")"));
+    OP_REQUIRES(context, 0 <= mfcc_ && mfcc_ <= mels_,
+                errors::InvalidArgument("mfcc must be in [0, ", mels_,
+                                        "]: ", mfcc_));
+
+    // The periodic Hann window of tf.signal.hann_window, cut to nfft as
+    // tf.signal.stft does.
+    window_length_ = std::min(window_length_, nfft_);
+    window_.resize(window_length_);
+    for (int64 i = 0; i < window_length_; i++) {
+      window_[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / window_length_);
+    }
+    spectrum_.reset(new PowerSpectrum(nfft_));
+
+    // The DCT-II of tf.signal.mfccs_from_log_mel_spectrograms.
+    dct_.resize(mfcc_ * mels_);
+    for (int64 k = 0; k < mfcc_; k++) {
+      for (int64 n = 0; n < mels_; n++) {
+        dct_[k * mels_ + n] =
+            2.0 * std::cos(M_PI * k * (2 * n + 1) / (2.0 * mels_)) /
+            std::sqrt(2.0 * mels_);
+      }
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_tensor->shape()),
+                errors::InvalidArgument("input must be 1-D, got shape ",
+                                        input_tensor->shape().DebugString()));
+    const Tensor* rate_tensor;
+    OP_REQUIRES_OK(context, context->input("rate", &rate_tensor));
+    const int64 rate = rate_tensor->scalar<int64>()();
+    OP_REQUIRES(context, rate > 0 && fmax_ <= rate / 2.0,
+                errors::InvalidArgument("fmax ", fmax_,
+                                        " must not exceed the Nyquist rate of ",
+                                        rate));
+
+    std::shared_ptr<const MelFilterbank> filterbank;
+    {
+      mutex_lock l(mu_);
+      std::shared_ptr<const MelFilterbank>& cached = filterbanks_[rate];
+      if (cached == nullptr) {
+        cached = std::make_shared<const MelFilterbank>(spectrum_->bins(), rate,
+                                                       mels_, fmin_, fmax_);
+      }
+      filterbank = cached;
+    }
+
+    const int64 samples = input_tensor->NumElements();
+    // The frames of tf.signal.stft with pad_end, zero padded past the end.
+    const int64 frames = (samples + stride_ - 1) / stride_;
+    const int64 columns = mfcc_ > 0 ? mfcc_ : mels_;
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({frames, columns}),
+                                &output_tensor));
+
+    const float* input = input_tensor->flat<float>().data();
+    T* output = output_tensor->flat<T>().data();
+    auto compute = [&](int64 start, int64 limit) {
+      std::vector<Complex> buffer, scratch;
+      std::vector<float> power(spectrum_->bins());
+      std::vector<float> mel(mels_);
+      std::vector<float> row(columns);
+      for (int64 f = start; f < limit; f++) {
+        const int64 offset = f * stride_;
+        const int64 count = std::min(window_length_, samples - offset);
+        float* frame = spectrum_->Frame(&buffer);
+        MultiplySamples(input + offset, window_.data(), count, frame);
+        std::fill(frame + count, frame + nfft_, 0.0f);
+        spectrum_->Compute(&buffer, &scratch, power.data());
+        Magnitude(power.data(), power.size());
+        filterbank->Compute(power.data(), mel.data());
+        if (log_ || mfcc_ > 0) {
+          for (int64 m = 0; m < mels_; m++) {
+            mel[m] = std::log(mel[m] + kLogOffset);
+          }
+        }
+        const float* values = mel.data();
+        if (mfcc_ > 0) {
+          for (int64 k = 0; k < mfcc_; k++) {
+            const float* dct = dct_.data() + k * mels_;
+            float sum = 0.0f;
+            for (int64 m = 0; m < mels_; m++) {
+              sum += dct[m] * mel[m];
+            }
+            row[k] = sum;
+          }
+          values = row.data();
+        }
+        for (int64 c = 0; c < columns; c++) {
+          output[f * columns + c] = static_cast<T>(values[c]);
+        }
+      }
+    };
+    const DeviceBase::CpuWorkerThreads* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+    // Each frame is a transform of nfft samples, followed by the filterbank.
+    const int64 cost = nfft_ * 32 + mels_ * (spectrum_->bins() + columns);
+    Shard(worker_threads->num_threads, worker_threads->workers, frames, cost,
+          compute);
+  }
+
+ private:
+  // Raises the power of each bin to the magnitude |X|^power.
+  void Magnitude(float* bins, const int64 count) const {
+    if (power_ == 2.0f) {
+      return;
+    }
+    for (int64 k = 0; k < count; k++) {
+      bins[k] = power_ == 1.0f ? std::sqrt(bins[k])
+                               : std::pow(bins[k], power_ * 0.5f);
+    }
+  }
+
+  // Added before the log, as tf.signal.mfccs_from_log_mel_spectrograms
+  // suggests.
+  static constexpr float kLogOffset = 1e-6f;
+
+  int64 nfft_;
+  int64 window_length_;
+  int64 stride_;
+  int64 mels_;
+  float fmin_;
+  float fmax_;
+  float power_;
+  bool log_;
+  int64 mfcc_;
+  std::vector<float> window_;
+  std::unique_ptr<PowerSpectrum> spectrum_;
+  std::vector<float> dct_;
+
+  mutex mu_;
+  std::map<int64, std::shared_ptr<const MelFilterbank>> filterbanks_
+      TF_GUARDED_BY(mu_);
+};
+
+REGISTER_KERNEL_BUILDER(Name("IO>AudioMelSpectrogram")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<float>("dtype"),
+                        AudioMelSpectrogramOp<float>);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioMelSpectrogram")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<Eigen::half>("dtype"),
+                        AudioMelSpectrogramOp<Eigen::half>);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #include "FLAC/stream_decoder.h"
 #include "FLAC/stream_encoder.h"
 #include "tensorflow_io/core/kernels/audio_kernels.h"
+#include "tensorflow_io/core/kernels/audio_samples.h"
 
 namespace tensorflow {
 namespace data {
@@ -30,7 +31,10 @@ class FlacStreamDecoder {
         samples(0),
         channels(0),
         rate(0),
-        bits_per_sample(0) {}
+        bits_per_sample(0),
+        sample_index(0),
+        sample_start(0),
+        sample_value(nullptr) {}
   ~FlacStreamDecoder() {}
 
   void SetTensor(int64 start, Tensor* value) {
@@ -102,6 +106,12 @@ class FlacStreamDecoder {
     if (frame->header.number_type != FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER) {
       return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
     }
+    // Without a tensor the frames are only counted, for streams of unknown
+    // length.
+    if (p->sample_value == nullptr) {
+      p->samples = frame->header.number.sample_number + frame->header.blocksize;
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
 
     if (p->sample_index != frame->header.number.sample_number) {
       return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
@@ -114,35 +124,22 @@ class FlacStreamDecoder {
             : (p->sample_start + p->sample_value->shape().dim_size(0) -
                p->sample_index);
 
+    const int64 channels = frame->header.channels;
+    const int64 offset = (p->sample_index - p->sample_start) * channels;
     switch (p->sample_value->dtype()) {
       case DT_UINT8:
         // convert to unsigned by adding 0x80
-        for (int64 channel = 0; channel < frame->header.channels; channel++) {
-          for (int64 index = 0; index < samples_to_read; index++) {
-            int64 sample_index = p->sample_index + index - p->sample_start;
-            p->sample_value->tensor<uint8, 2>()(sample_index, channel) =
-                (static_cast<uint8>(buffer[channel][index] + 0x80));
-          }
-        }
+        InterleaveSamples(buffer, channels, samples_to_read,
+                          p->sample_value->flat<uint8>().data() + offset);
         break;
       case DT_INT16:
-        for (int64 channel = 0; channel < frame->header.channels; channel++) {
-          for (int64 index = 0; index < samples_to_read; index++) {
-            int64 sample_index = p->sample_index + index - p->sample_start;
-            p->sample_value->tensor<int16, 2>()(sample_index, channel) =
-                buffer[channel][index];
-          }
-        }
+        InterleaveSamples(buffer, channels, samples_to_read,
+                          p->sample_value->flat<int16>().data() + offset);
         break;
       case DT_INT32:
         // left shift 8 bit as we want to fill int32
-        for (int64 channel = 0; channel < frame->header.channels; channel++) {
-          for (int64 index = 0; index < samples_to_read; index++) {
-            int64 sample_index = p->sample_index + index - p->sample_start;
-            p->sample_value->tensor<int32, 2>()(sample_index, channel) =
-                (static_cast<int32>(buffer[channel][index]) << 8);
-          }
-        }
+        InterleaveSamples(buffer, channels, samples_to_read,
+                          p->sample_value->flat<int32>().data() + offset);
         break;
       default:
         return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
@@ -261,6 +258,14 @@ class FlacReadableResource : public AudioReadableResourceBase {
       return errors::InvalidArgument("unable to read metadata");
     }
 
+    // Streams written as they were encoded, such as by FlacWritableEncoder,
+    // have no total of samples, which is then counted through the frames.
+    if (stream_decoder_->samples == 0) {
+      if (!FLAC__stream_decoder_process_until_end_of_stream(decoder_.get())) {
+        return errors::InvalidArgument("unable to count samples");
+      }
+    }
+
     int64 samples = stream_decoder_->samples;
     int64 channels = stream_decoder_->channels;
     int64 rate = stream_decoder_->rate;
@@ -534,6 +539,135 @@ class AudioEncodeFlacOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// Keeps one stream encoder from the first chunk to Finish, and appends the
+// frames to the file as the encoder emits them. The file cannot be seeked
+// back, so the STREAMINFO block keeps the unknown total of samples it is
+// written with.
+class FlacWritableEncoder : public AudioWritableEncoderBase {
+ public:
+  FlacWritableEncoder(WritableFile* file)
+      : file_(file), encoder_(nullptr, [](FLAC__StreamEncoder* p) {
+          if (p != nullptr) {
+            FLAC__stream_encoder_delete(p);
+          }
+        }) {}
+  ~FlacWritableEncoder() {}
+
+  Status Init(const int64 rate, const int64 channels, const DataType dtype) {
+    int64 bytes_per_sample;
+    switch (dtype) {
+      case DT_UINT8:
+        bytes_per_sample = 1;
+        break;
+      case DT_INT16:
+        bytes_per_sample = 2;
+        break;
+      case DT_INT32:
+        bytes_per_sample = 3;
+        break;
+      default:
+        return errors::InvalidArgument("data type ", DataTypeString(dtype),
+                                       " not supported");
+    }
+    dtype_ = dtype;
+    channels_ = channels;
+
+    encoder_.reset(FLAC__stream_encoder_new());
+    if (encoder_.get() == nullptr) {
+      return errors::ResourceExhausted("unable to create encoder");
+    }
+    if (!FLAC__stream_encoder_set_verify(encoder_.get(), true)) {
+      return errors::InvalidArgument("unable to set verify");
+    }
+    if (!FLAC__stream_encoder_set_channels(encoder_.get(), channels)) {
+      return errors::InvalidArgument("unable to set channels");
+    }
+    if (!FLAC__stream_encoder_set_bits_per_sample(encoder_.get(),
+                                                  bytes_per_sample * 8)) {
+      return errors::InvalidArgument("unable to set bits per sample");
+    }
+    if (!FLAC__stream_encoder_set_sample_rate(encoder_.get(), rate)) {
+      return errors::InvalidArgument("unable to set rate");
+    }
+    FLAC__StreamEncoderInitStatus s = FLAC__stream_encoder_init_stream(
+        encoder_.get(), FlacWritableEncoder::WriteCallback, nullptr, nullptr,
+        FlacStreamEncoder::MetadataCallback, this);
+    if (s != FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+      return errors::InvalidArgument("unable to initialize stream: ", s);
+    }
+    pcm_.reset(
+        new FLAC__int32[FlacStreamEncoder::kSampleBufferCount * channels]);
+    return status_;
+  }
+  Status Write(const Tensor& value) override {
+    const int64 samples = value.dim_size(0);
+    int64 count = 0;
+    while (count < samples) {
+      int64 chunk = (count + FlacStreamEncoder::kSampleBufferCount < samples)
+                        ? (FlacStreamEncoder::kSampleBufferCount)
+                        : (samples - count);
+      const int64 offset = count * channels_;
+      const int64 elements = chunk * channels_;
+      switch (dtype_) {
+        case DT_UINT8:
+          // convert to signed by sub 0x80
+          for (int64 i = 0; i < elements; i++) {
+            pcm_[i] =
+                static_cast<int32>(value.flat<uint8>()(offset + i)) - 0x80;
+          }
+          break;
+        case DT_INT16:
+          for (int64 i = 0; i < elements; i++) {
+            pcm_[i] = value.flat<int16>()(offset + i);
+          }
+          break;
+        case DT_INT32:
+          // right shift 8 bit as int32 was filled
+          for (int64 i = 0; i < elements; i++) {
+            pcm_[i] = (value.flat<int32>()(offset + i) >> 8);
+          }
+          break;
+        default:
+          return errors::InvalidArgument("data type ", DataTypeString(dtype_),
+                                         " not supported");
+      }
+      if (!FLAC__stream_encoder_process_interleaved(encoder_.get(),
+                                                    pcm_.get(), chunk)) {
+        TF_RETURN_IF_ERROR(status_);
+        return errors::InvalidArgument("unable to process interleaved stream");
+      }
+      count += chunk;
+    }
+    return status_;
+  }
+  Status Finish() override {
+    if (!FLAC__stream_encoder_finish(encoder_.get())) {
+      TF_RETURN_IF_ERROR(status_);
+      return errors::InvalidArgument("unable to finish stream");
+    }
+    return status_;
+  }
+
+ private:
+  static FLAC__StreamEncoderWriteStatus WriteCallback(
+      const FLAC__StreamEncoder* encoder, const FLAC__byte buffer[],
+      size_t bytes, uint32_t samples, uint32_t current_frame,
+      void* client_data) {
+    FlacWritableEncoder* p = static_cast<FlacWritableEncoder*>(client_data);
+    p->status_.Update(
+        p->file_->Append(StringPiece((const char*)buffer, bytes)));
+    return p->status_.ok() ? FLAC__STREAM_ENCODER_WRITE_STATUS_OK
+                           : FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+  }
+
+  WritableFile* file_;
+  DataType dtype_;
+  int64 channels_;
+  std::unique_ptr<FLAC__StreamEncoder, void (*)(FLAC__StreamEncoder*)> encoder_;
+  std::unique_ptr<FLAC__int32[]> pcm_;
+  Status status_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeFlac").Device(DEVICE_CPU),
                         AudioDecodeFlacOp);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioEncodeFlac").Device(DEVICE_CPU),
@@ -552,5 +686,14 @@ Status FlacReadableResourceInit(
   return status;
 }
 
+Status FlacWritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder) {
+  std::unique_ptr<FlacWritableEncoder> flac(new FlacWritableEncoder(file));
+  TF_RETURN_IF_ERROR(flac->Init(rate, channels, dtype));
+  encoder = std::move(flac);
+  return OkStatus();
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -48,6 +48,7 @@ static int (*lame_set_mode)(lame_t, MPEG_mode);
 static int (*lame_set_num_channels)(lame_t, int);
 static int (*lame_set_in_samplerate)(lame_t, int);
 static int (*lame_set_VBR)(lame_t, vbr_mode);
+static int (*lame_set_bWriteVbrTag)(lame_t, int);
 static int (*lame_init_params)(lame_t);
 static int (*lame_encode_buffer_ieee_float)(lame_t gfp, const float pcm_l[],
                                             const float pcm_r[],
@@ -133,6 +134,7 @@ class MP3ReadableResource : public AudioReadableResourceBase {
     shape_ = TensorShape({samples, channels});
     dtype_ = DT_FLOAT;
     rate_ = rate;
+    position_ = -1;
 
     return OkStatus();
   }
@@ -145,6 +147,10 @@ class MP3ReadableResource : public AudioReadableResourceBase {
     return OkStatus();
   }
 
+  // MP3D_SEEK_TO_SAMPLE seeks through the frame index that minimp3 builds
+  // while opening, and decodes from a few frames before the one holding the
+  // sample to refill the bit reservoir. Reads that continue the previous one
+  // skip the seek, and with it that redecoding.
   Status Read(const int64 start, const int64 stop,
               std::function<Status(const TensorShape& shape, Tensor** value)>
                   allocate_func) override {
@@ -159,10 +165,14 @@ class MP3ReadableResource : public AudioReadableResourceBase {
     TF_RETURN_IF_ERROR(allocate_func(
         TensorShape({sample_stop - sample_start, shape_.dim_size(1)}), &value));
 
-    if (mp3dec_ex_seek(&mp3dec_ex_, sample_start * shape_.dim_size(1))) {
-      return errors::InvalidArgument("seek to ", sample_start,
-                                     " failed: ", mp3dec_ex_.last_error);
+    if (sample_start != position_) {
+      position_ = -1;
+      if (mp3dec_ex_seek(&mp3dec_ex_, sample_start * shape_.dim_size(1))) {
+        return errors::InvalidArgument("seek to ", sample_start,
+                                       " failed: ", mp3dec_ex_.last_error);
+      }
     }
+    position_ = -1;
     size_t returned = mp3dec_ex_read(&mp3dec_ex_, value->flat<float>().data(),
                                      value->NumElements());
     if (returned != value->NumElements()) {
@@ -170,6 +180,7 @@ class MP3ReadableResource : public AudioReadableResourceBase {
                                      sample_start,
                                      " failed: ", mp3dec_ex_.last_error);
     }
+    position_ = sample_stop;
     return OkStatus();
   }
   string DebugString() const override { return "MP3ReadableResource"; }
@@ -187,6 +198,8 @@ class MP3ReadableResource : public AudioReadableResourceBase {
   mp3dec_io_t mp3dec_io_;
   mp3dec_ex_t mp3dec_ex_;
   std::unique_ptr<mp3dec_ex_t, void (*)(mp3dec_ex_t*)> mp3dec_ex_scope_;
+  // The next sample the decoder returns, or -1 when it is unknown.
+  int64 position_ TF_GUARDED_BY(mu_) = -1;
 };
 
 class AudioDecodeMP3Op : public OpKernel {
@@ -252,6 +265,8 @@ bool LoadLame() {
     *(void**)(&lame_set_num_channels) = dlsym(lib, "lame_set_num_channels");
     *(void**)(&lame_set_in_samplerate) = dlsym(lib, "lame_set_in_samplerate");
     *(void**)(&lame_set_VBR) = dlsym(lib, "lame_set_VBR");
+    // Optional, used to leave the VBR tag out of streamed files.
+    *(void**)(&lame_set_bWriteVbrTag) = dlsym(lib, "lame_set_bWriteVbrTag");
     *(void**)(&lame_init_params) = dlsym(lib, "lame_init_params");
     *(void**)(&lame_encode_buffer_ieee_float) =
         dlsym(lib, "lame_encode_buffer_ieee_float");
@@ -366,10 +381,106 @@ class AudioEncodeMP3Op : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 
   static bool lame_available_;
+
+  friend class MP3WritableEncoder;
 };
 
 bool AudioEncodeMP3Op::lame_available_ = LoadLame();
 
+// Keeps one lame state from the first chunk to Finish, and appends the
+// frames to the file as each chunk is encoded. The file cannot be seeked
+// back to fill in the VBR tag frame, so none is written.
+class MP3WritableEncoder : public AudioWritableEncoderBase {
+ public:
+  MP3WritableEncoder(WritableFile* file)
+      : file_(file), lame_(nullptr, [](void* p) {
+          if (p != nullptr) {
+            lame_close(p);
+          }
+        }) {}
+  ~MP3WritableEncoder() {}
+
+  Status Init(const int64 rate, const int64 channels, const DataType dtype) {
+    if (!AudioEncodeMP3Op::lame_available_) {
+      return errors::InvalidArgument("lame library is not available");
+    }
+    if (dtype != DT_FLOAT) {
+      return errors::InvalidArgument("data type ", DataTypeString(dtype),
+                                     " not supported");
+    }
+    if (channels != 1 && channels != 2) {
+      return errors::InvalidArgument("only 1 or 2 channles supported: ",
+                                     channels);
+    }
+    channels_ = channels;
+
+    lame_.reset(lame_init());
+    if (lame_.get() == nullptr) {
+      return errors::InvalidArgument("unable to initialize lame");
+    }
+    int status;
+    status = lame_set_mode(lame_.get(), channels == 1 ? MONO : STEREO);
+    if (status != 0) {
+      return errors::InvalidArgument("unable to set mode: ", status);
+    }
+    status = lame_set_num_channels(lame_.get(), channels);
+    if (status != 0) {
+      return errors::InvalidArgument("unable to set channels: ", status);
+    }
+    status = lame_set_in_samplerate(lame_.get(), rate);
+    if (status != 0) {
+      return errors::InvalidArgument("unable to set rate: ", status);
+    }
+    status = lame_set_VBR(lame_.get(), vbr_default);
+    if (status != 0) {
+      return errors::InvalidArgument("unable to set vbr: ", status);
+    }
+    if (lame_set_bWriteVbrTag != nullptr) {
+      lame_set_bWriteVbrTag(lame_.get(), 0);
+    }
+    status = lame_init_params(lame_.get());
+    if (status != 0) {
+      return errors::InvalidArgument("unable to init params ", status);
+    }
+    return OkStatus();
+  }
+  Status Write(const Tensor& value) override {
+    const int64 samples = value.dim_size(0);
+    const float* pcm = value.flat<float>().data();
+    // worse case according to lame:
+    // mp3buf_size in bytes = 1.25*num_samples + 7200
+    buffer_.resize(samples * 5 / 4 + 7200);
+    unsigned char* mp3buf = (unsigned char*)&buffer_[0];
+    int status;
+    if (channels_ == 1) {
+      status = lame_encode_buffer_ieee_float(lame_.get(), pcm, nullptr, samples,
+                                             mp3buf, buffer_.size());
+    } else {
+      status = lame_encode_buffer_interleaved_ieee_float(
+          lame_.get(), pcm, samples, mp3buf, buffer_.size());
+    }
+    if (status < 0) {
+      return errors::InvalidArgument("unable to encode: ", status);
+    }
+    return file_->Append(StringPiece(buffer_.data(), status));
+  }
+  Status Finish() override {
+    buffer_.resize(7200);
+    int status = lame_encode_flush(
+        lame_.get(), (unsigned char*)&buffer_[0], buffer_.size());
+    if (status < 0) {
+      return errors::InvalidArgument("unable to flush: ", status);
+    }
+    return file_->Append(StringPiece(buffer_.data(), status));
+  }
+
+ private:
+  WritableFile* file_;
+  int64 channels_;
+  std::unique_ptr<void, void (*)(void*)> lame_;
+  string buffer_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeMP3").Device(DEVICE_CPU),
                         AudioDecodeMP3Op);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioEncodeMP3").Device(DEVICE_CPU),
@@ -389,5 +500,14 @@ Status MP3ReadableResourceInit(
   return status;
 }
 
+Status MP3WritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder) {
+  std::unique_ptr<MP3WritableEncoder> mp3(new MP3WritableEncoder(file));
+  TF_RETURN_IF_ERROR(mp3->Init(rate, channels, dtype));
+  encoder = std::move(mp3);
+  return OkStatus();
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
 #include "tensorflow_io/core/kernels/audio_kernels.h"
 
 #define MINIMP4_IMPLEMENTATION
@@ -353,29 +356,126 @@ class MP4AACReadableResource : public AudioReadableResourceBase {
       return OkStatus();
     }
 
-    void* state = state_.get();
-    int64 codec = codec_;
-    int64 rate = rate_;
-    int64 channels = shape_.dim_size(1);
-
     int64 lower, upper, extra;
     TF_RETURN_IF_ERROR(PartitionsLookup(partitions_, sample_start, sample_stop,
                                         &lower, &upper, &extra));
 
-    // we need append padding_ at the end.
-    upper += padding_;
+    // The sample table locates every packet, so decoding starts at the
+    // packet of sample_start rather than at the beginning of the track.
+    const int64 packets = mp4d_demux_.track[track_index_].sample_count;
+    std::vector<Packet> table(std::min(upper + padding_, packets));
+    for (int64 i = std::max<int64>(lower - kDecodePreroll, 0);
+         i < static_cast<int64>(table.size()); i++) {
+      unsigned frame_bytes, timestamp, duration;
+      table[i].offset = MP4D_frame_offset(&mp4d_demux_, track_index_, i,
+                                          &frame_bytes, &timestamp, &duration);
+      table[i].bytes = frame_bytes;
+      table[i].duration = duration;
+    }
+
+    // Packet ranges of at least kDecodeRangePackets are decoded in parallel,
+    // each by a decoder of its own that starts kDecodePreroll packets early,
+    // so that its first packets of output are complete.
+    const int64 ranges = std::max<int64>(
+        std::min<int64>((upper - lower) / kDecodeRangePackets,
+                        port::MaxParallelism()),
+        1);
+    std::vector<int64> range_start(ranges + 1);
+    std::vector<int64> range_offset(ranges + 1);
+    int64 frames = 0;
+    for (int64 r = 0, i = lower; r <= ranges; r++) {
+      const int64 packet = lower + (upper - lower) * r / ranges;
+      for (; i < packet; i++) {
+        frames += table[i].duration;
+      }
+      range_start[r] = packet;
+      range_offset[r] = frames;
+    }
+
+    const int64 channels = shape_.dim_size(1);
+    SizedRandomAccessFile* file = file_.get();
+    string data_out;
+    data_out.resize(frames * channels * sizeof(float));
+    std::vector<Status> statuses(ranges);
+    auto decode = [&](int64 r) {
+      statuses[r] =
+          DecodeRange(file, table, range_start[r], range_start[r + 1],
+                      &data_out[range_offset[r] * channels * sizeof(float)]);
+    };
+    if (ranges == 1) {
+      decode(0);
+    } else {
+      BlockingCounter counter(ranges - 1);
+      for (int64 r = 1; r < ranges; r++) {
+        DecodeThreads()->Schedule([&decode, &counter, r] {
+          decode(r);
+          counter.DecrementCount();
+        });
+      }
+      decode(0);
+      counter.Wait();
+    }
+    for (const Status& status : statuses) {
+      TF_RETURN_IF_ERROR(status);
+    }
+
+    char* base = (char*)(value->flat<float>().data());
+    char* data = (char*)&data_out[0] + extra * channels * sizeof(float);
+    memcpy(base, data, value->NumElements() * sizeof(float));
+    return OkStatus();
+  }
+  string DebugString() const override { return "MP4AACReadableResource"; }
+
+ private:
+  struct Packet {
+    MP4D_file_offset_t offset = 0;
+    unsigned bytes = 0;
+    unsigned duration = 0;
+  };
+
+  // The packets decoded before a range, whose output is discarded, as an
+  // AAC frame overlaps the frame before it.
+  static constexpr int64 kDecodePreroll = 2;
+  // The fewest packets that a parallel decode range holds.
+  static constexpr int64 kDecodeRangePackets = 256;
+
+  static thread::ThreadPool* DecodeThreads() {
+    static thread::ThreadPool* threads = new thread::ThreadPool(
+        Env::Default(), "mp4_aac_decode", port::MaxParallelism());
+    return threads;
+  }
+
+  // Decodes the packets [first, last) of table, the padding_ packets after
+  // them included, into data_out, with a decoder of its own.
+  Status DecodeRange(SizedRandomAccessFile* file,
+                     const std::vector<Packet>& table, const int64 first,
+                     const int64 last, char* data_out) {
+    std::unique_ptr<void, void (*)(void*)> state(
+        DecodeAACFunctionInit(codec_, rate_, shape_.dim_size(1)),
+        [](void* p) {
+          if (p != nullptr) {
+            DecodeAACFunctionFini(p);
+          }
+        });
+    if (state.get() == nullptr) {
+      return errors::InvalidArgument("unable to initialize mp4 state");
+    }
+    const int64 channels = shape_.dim_size(1);
+    const int64 lower = std::max<int64>(first - kDecodePreroll, 0);
+    const int64 upper =
+        std::min<int64>(last + padding_, static_cast<int64>(table.size()));
 
     static const int64 header_bytes = 7;
 
     int64 bytes = 0;
     int64 frames = 0;
+    int64 preroll_frames = 0;
     for (int64 i = lower; i < upper; i++) {
-      unsigned frame_bytes, timestamp, duration;
-      MP4D_file_offset_t frame_offset = MP4D_frame_offset(
-          &mp4d_demux_, track_index_, i, &frame_bytes, &timestamp, &duration);
-
-      bytes += frame_bytes + header_bytes;
-      frames += duration;
+      bytes += table[i].bytes + header_bytes;
+      frames += table[i].duration;
+      if (i < first) {
+        preroll_frames += table[i].duration;
+      }
     }
     string data_in_chunk;
     data_in_chunk.resize(bytes);
@@ -383,21 +483,23 @@ class MP4AACReadableResource : public AudioReadableResourceBase {
 
     int64 offset = 0;
     for (int64 i = lower; i < upper; i++) {
-      unsigned frame_bytes, timestamp, duration;
-      MP4D_file_offset_t frame_offset = MP4D_frame_offset(
-          &mp4d_demux_, track_index_, i, &frame_bytes, &timestamp, &duration);
+      const MP4D_file_offset_t frame_offset = table[i].offset;
+      const unsigned frame_bytes = table[i].bytes;
 
       char* data_in = (char*)&data_in_chunk[offset];
       int64 size_in = frame_bytes + header_bytes;
 
       StringPiece result;
-      TF_RETURN_IF_ERROR(file_->Read(frame_offset, frame_bytes, &result,
-                                     (char*)&data_in[header_bytes]));
+      TF_RETURN_IF_ERROR(file->Read(frame_offset, frame_bytes, &result,
+                                    (char*)&data_in[header_bytes]));
       if (result.size() != frame_bytes) {
         return errors::InvalidArgument(
             "unable to read ", frame_bytes, " from offset ", frame_offset,
             " for track ", track_index_, " and sample indices in ", i);
       }
+      if (result.data() != &data_in[header_bytes]) {
+        memcpy(&data_in[header_bytes], result.data(), frame_bytes);
+      }
       size_in_chunk.push_back(size_in);
 
       // Add ADTS Header (without CRC)
@@ -416,23 +518,27 @@ class MP4AACReadableResource : public AudioReadableResourceBase {
     }
 
     int64 size_out = frames * channels * sizeof(float);
-    string data_out;
-    data_out.resize(size_out);
-    int64 status =
-        DecodeAACFunctionCall(state, codec, rate, channels, &data_in_chunk[0],
-                              (int64_t*)&size_in_chunk[0], size_in_chunk.size(),
-                              frames, (void*)&data_out[0], size_out);
+    string decoded;
+    decoded.resize(size_out);
+    io::IOTrace trace("audio", io::IOTraceStage::kDecode, "mp4");
+    trace.AddRecords(frames);
+    trace.AddBytes(size_out);
+    int64 status = DecodeAACFunctionCall(
+        state.get(), codec_, rate_, channels, &data_in_chunk[0],
+        (int64_t*)&size_in_chunk[0], size_in_chunk.size(), frames,
+        (void*)&decoded[0], size_out);
     if (status != 0) {
       return errors::InvalidArgument("unable to convert AAC data: ", status);
     }
-    char* base = (char*)(value->flat<float>().data());
-    char* data = (char*)&data_out[0] + extra * channels * sizeof(float);
-    memcpy(base, data, value->NumElements() * sizeof(float));
+    int64 range_frames = 0;
+    for (int64 i = first; i < last; i++) {
+      range_frames += table[i].duration;
+    }
+    memcpy(data_out, &decoded[preroll_frames * channels * sizeof(float)],
+           range_frames * channels * sizeof(float));
     return OkStatus();
   }
-  string DebugString() const override { return "MP4AACReadableResource"; }
 
- private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
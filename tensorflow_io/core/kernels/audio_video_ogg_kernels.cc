@@ -13,7 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+
 #include "tensorflow_io/core/kernels/audio_kernels.h"
+#include "tensorflow_io/core/kernels/audio_samples.h"
 #include "vorbis/codec.h"
 #include "vorbis/vorbisenc.h"
 #include "vorbis/vorbisfile.h"
@@ -105,6 +108,12 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
 
     vorbis_info* vi = ov_info(&ogg_vorbis_file_, -1);
     int64 samples = ov_pcm_total(&ogg_vorbis_file_, -1);
+    // Granule positions restart in each link of a chained stream, so only
+    // single links are indexed.
+    indexed_ = (ov_streams(&ogg_vorbis_file_) == 1);
+    pages_.clear();
+    index_offset_ = 0;
+    position_ = -1;
     int64 channels = vi->channels;
     int64 rate = vi->rate;
 
@@ -136,10 +145,7 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
     TF_RETURN_IF_ERROR(allocate_func(
         TensorShape({sample_stop - sample_start, shape_.dim_size(1)}), &value));
 
-    int returned = ov_pcm_seek(&ogg_vorbis_file_, sample_start);
-    if (returned < 0) {
-      return errors::InvalidArgument("seek failed: ", returned);
-    }
+    TF_RETURN_IF_ERROR(Seek(sample_start));
 
     int64 channels = value->shape().dim_size(1);
 
@@ -156,19 +162,121 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
       if (chunk == 0) {
         return errors::InvalidArgument("not enough data: ");
       }
-      for (int64 c = 0; c < channels; c++) {
-        for (int64 i = 0; i < chunk; i++) {
-          value->matrix<float>()(samples_read + i, c) = buffer[c][i];
-        }
-      }
+      InterleaveSamples(buffer, channels, chunk,
+                        value->flat<float>().data() + samples_read * channels);
       samples_read += chunk;
     }
+    position_ = sample_stop;
 
     return OkStatus();
   }
   string DebugString() const override { return "OggVorbisReadableResource"; }
 
  private:
+  // Positions the decoder at `sample`. Reads that continue the previous one
+  // do not seek, and the others jump to a page shortly before `sample` from
+  // the index and decode up to it, instead of bisecting the file as
+  // ov_pcm_seek does.
+  Status Seek(const int64 sample) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (sample == position_) {
+      return OkStatus();
+    }
+    position_ = -1;
+    int64 pcm = -1;
+    if (indexed_) {
+      TF_RETURN_IF_ERROR(ExtendIndex(sample));
+      // Decoding from the start of the page two before the one holding
+      // `sample` starts before it, despite the overlap of packets.
+      auto it = std::upper_bound(
+          pages_.begin(), pages_.end(), sample,
+          [](const int64 s, const std::pair<int64, int64>& page) {
+            return s < page.first;
+          });
+      const int64 page = (it - pages_.begin()) - 2;
+      if (page >= 0 &&
+          ov_raw_seek(&ogg_vorbis_file_, pages_[page].second) == 0) {
+        pcm = ov_pcm_tell(&ogg_vorbis_file_);
+      }
+    }
+    if (pcm < 0 || pcm > sample) {
+      int returned = ov_pcm_seek(&ogg_vorbis_file_, sample);
+      if (returned < 0) {
+        return errors::InvalidArgument("seek failed: ", returned);
+      }
+      position_ = sample;
+      return OkStatus();
+    }
+    float** buffer;
+    while (pcm < sample) {
+      int bitstream = 0;
+      long chunk =
+          ov_read_float(&ogg_vorbis_file_, &buffer, sample - pcm, &bitstream);
+      if (chunk < 0) {
+        return errors::InvalidArgument("read failed: ", chunk);
+      }
+      if (chunk == 0) {
+        return errors::InvalidArgument("not enough data: ");
+      }
+      pcm += chunk;
+    }
+    position_ = sample;
+    return OkStatus();
+  }
+
+  // Scans the pages from where the index ends, until a page past `sample` or
+  // the end of the file, recording the granule position of each page with
+  // the offset of the page.
+  Status ExtendIndex(const int64 sample) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (!pages_.empty() && pages_.back().first > sample) {
+      return OkStatus();
+    }
+    ogg_sync_state sync;
+    ogg_sync_init(&sync);
+    std::unique_ptr<ogg_sync_state, void (*)(ogg_sync_state*)> sync_scope(
+        &sync, [](ogg_sync_state* p) { ogg_sync_clear(p); });
+    int64 read_offset = index_offset_;
+    int64 page_offset = index_offset_;
+    while (read_offset < static_cast<int64>(file_size_)) {
+      const int64 length =
+          std::min<int64>(kIndexChunkSize, file_size_ - read_offset);
+      char* data = ogg_sync_buffer(&sync, length);
+      StringPiece result;
+      Status status = file_->Read(read_offset, length, &result, data);
+      if (!status.ok() && !errors::IsOutOfRange(status)) {
+        return status;
+      }
+      if (result.size() == 0) {
+        break;
+      }
+      if (result.data() != data) {
+        memcpy(data, result.data(), result.size());
+      }
+      ogg_sync_wrote(&sync, result.size());
+      read_offset += result.size();
+      ogg_page page;
+      long returned;
+      while ((returned = ogg_sync_pageseek(&sync, &page)) != 0) {
+        if (returned < 0) {
+          page_offset -= returned;
+          continue;
+        }
+        const int64 granule = ogg_page_granulepos(&page);
+        if (granule > 0 && (pages_.empty() || granule > pages_.back().first)) {
+          pages_.emplace_back(granule, page_offset);
+        }
+        page_offset += returned;
+        index_offset_ = page_offset;
+      }
+      if (!pages_.empty() && pages_.back().first > sample) {
+        break;
+      }
+    }
+    return OkStatus();
+  }
+
+  // The number of bytes scanned at a time for the index.
+  static constexpr int64 kIndexChunkSize = 1 << 16;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -179,6 +287,14 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
 
   OggVorbis_File ogg_vorbis_file_;
   std::unique_ptr<OggVorbisStream> stream_;
+
+  // The granule positions of the pages scanned so far, the samples before
+  // their ends, with the offsets of the pages.
+  bool indexed_ TF_GUARDED_BY(mu_) = false;
+  std::vector<std::pair<int64, int64>> pages_ TF_GUARDED_BY(mu_);
+  int64 index_offset_ TF_GUARDED_BY(mu_) = 0;
+  // The next sample the decoder returns, or -1 when it is unknown.
+  int64 position_ TF_GUARDED_BY(mu_) = -1;
 };
 
 class AudioDecodeVorbisOp : public OpKernel {
@@ -366,11 +482,8 @@ class AudioEncodeVorbisOp : public OpKernel {
     float** buffer = vorbis_analysis_buffer(&vd, samples);
 
     // uninterleave samples
-    for (int64 i = 0; i < samples; i++) {
-      for (int64 c = 0; c < channels; c++) {
-        buffer[c][i] = input_tensor->matrix<float>()(i, c);
-      }
-    }
+    DeinterleaveSamples(input_tensor->flat<float>().data(), channels, samples,
+                        buffer);
 
     ogg_packet op;
 
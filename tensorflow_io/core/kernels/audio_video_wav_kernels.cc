@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow_io/core/kernels/audio_kernels.h"
+#include "tensorflow_io/core/kernels/audio_samples.h"
 
 namespace tensorflow {
 namespace data {
@@ -120,7 +121,12 @@ class WAVReadableResource : public AudioReadableResourceBase {
     if (header_.riff_size + 8 != file_size_) {
       // corrupted file?
     }
-    int64 filesize = header_.riff_size + 8;
+    // Streams of unknown length, as WAVWritableEncoder writes them, have the
+    // largest sizes, and the data in them is the rest of the file.
+    int64 filesize = static_cast<uint32>(header_.riff_size) + 8;
+    if (filesize > file_size_) {
+      filesize = file_size_;
+    }
     int64 position = header_length_ + header_.fmt_size - 16;
 
     int64 nSamples = 0;
@@ -130,19 +136,24 @@ class WAVReadableResource : public AudioReadableResourceBase {
       TF_RETURN_IF_ERROR(
           file_->Read(position, sizeof(head), &result, (char*)(&head)));
       position += result.size();
+      int64 size = static_cast<uint32>(head.size);
       if (memcmp(head.mark, "data", 4) == 0) {
+        if (position + size > filesize) {
+          size = std::max<int64>(filesize - position, 0) /
+                 header_.nBlockAlign * header_.nBlockAlign;
+        }
         // Data should be block aligned
         // bytes = nSamples * nBlockAlign
-        if (head.size % header_.nBlockAlign != 0) {
+        if (size % header_.nBlockAlign != 0) {
           return errors::InvalidArgument("data chunk should be block aligned (",
                                          header_.nBlockAlign,
-                                         "), received: ", head.size);
+                                         "), received: ", size);
         }
-        nSamples += head.size / header_.nBlockAlign;
+        nSamples += size / header_.nBlockAlign;
         partitions_.emplace_back(nSamples);
         partitions_offset_.emplace_back(position);
       }
-      position += head.size;
+      position += size;
     } while (position < filesize);
 
     // Note: 8 bit is always 0-255 (uint8)
@@ -243,29 +254,25 @@ class WAVReadableResource : public AudioReadableResourceBase {
       int64 offset = partitions_offset_[i] + chunk_offset * header_.nBlockAlign;
       int64 length = chunk_length * header_.nBlockAlign;
 
-      string buffer;
-      buffer.resize(length);
-
       StringPiece result;
-      TF_RETURN_IF_ERROR(file_->Read(offset, length, &result, &buffer[0]));
-
       switch (header_.wBitsPerSample) {
         case 8:
         case 16:
         case 32:
-          memcpy(base + base_offset * header_.nBlockAlign, (char*)(&buffer[0]),
-                 chunk_length * header_.nBlockAlign);
-          break;
-        case 24:  // 24 stands for int24 (converts to INT32)
-          for (int64 i = 0; i < chunk_length * channels; i++) {
-            char* in_p = (char*)(&buffer[0]) + i * 3;
-            char* out_p = base + base_offset * header_.nBlockAlign + i * 4;
-            out_p[3] = in_p[2];
-            out_p[2] = in_p[1];
-            out_p[1] = in_p[0];
-            out_p[0] = 0x00;
-          }
+          // The samples are stored as they are, and read straight into the
+          // value.
+          TF_RETURN_IF_ERROR(
+              file_->Read(offset, length, &result,
+                          base + base_offset * header_.nBlockAlign));
           break;
+        case 24: {  // 24 stands for int24 (converts to INT32)
+          string buffer;
+          buffer.resize(length);
+          TF_RETURN_IF_ERROR(file_->Read(offset, length, &result, &buffer[0]));
+          UnpackInt24Samples(
+              result.data(), chunk_length * channels,
+              reinterpret_cast<int32*>(base) + base_offset * channels);
+        } break;
         default:
           return errors::InvalidArgument(
               "unsupported wBitsPerSample and header.nBlockAlign: ",
@@ -475,6 +482,84 @@ class AudioEncodeWAVOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// Writes the header of a stream of unknown length, with the largest sizes,
+// and appends the samples of the chunks as they come.
+class WAVWritableEncoder : public AudioWritableEncoderBase {
+ public:
+  WAVWritableEncoder(WritableFile* file) : file_(file) {}
+  ~WAVWritableEncoder() {}
+
+  Status Init(const int64 rate, const int64 channels, const DataType dtype) {
+    if (channels != static_cast<int16>(channels)) {
+      return errors::InvalidArgument("channels ", channels, " > max(int16)");
+    }
+    if (rate != static_cast<int32>(rate)) {
+      return errors::InvalidArgument("rate ", rate, " > max(int32)");
+    }
+    switch (dtype) {
+      case DT_UINT8:
+        bytes_per_sample_ = 1;
+        break;
+      case DT_INT16:
+        bytes_per_sample_ = 2;
+        break;
+      case DT_INT32:  // 24 stands for int24 (converts to INT32)
+        bytes_per_sample_ = 3;
+        break;
+      case DT_FLOAT:
+        bytes_per_sample_ = 4;
+        break;
+      default:
+        return errors::InvalidArgument("data type ", DataTypeString(dtype),
+                                       " not supported");
+    }
+    dtype_ = dtype;
+
+    string buffer(sizeof(struct WAVHeader) + sizeof(struct DataHeader), '\0');
+    struct WAVHeader* header = (struct WAVHeader*)&buffer[0];
+    struct DataHeader* data_header =
+        (struct DataHeader*)&buffer[sizeof(struct WAVHeader)];
+    memcpy(header->riff, "RIFF", 4);
+    header->riff_size = static_cast<int32>(0xFFFFFFFF);
+    memcpy(header->wave, "WAVE", 4);
+    memcpy(header->fmt, "fmt ", 4);
+    header->fmt_size = 16;
+    header->wFormatTag = (dtype == DT_FLOAT) ? (3) : (1);
+    header->nChannels = channels;
+    header->nSamplesPerSec = rate;
+    header->nAvgBytesPerSec = rate * channels * bytes_per_sample_;
+    header->nBlockAlign = channels * bytes_per_sample_;
+    header->wBitsPerSample = bytes_per_sample_ * 8;
+    memcpy(data_header->mark, "data", 4);
+    data_header->size = static_cast<int32>(0xFFFFFFFF);
+    return file_->Append(buffer);
+  }
+  Status Write(const Tensor& value) override {
+    const int64 elements = value.NumElements();
+    const char* input_base = value.tensor_data().data();
+    if (dtype_ != DT_INT32) {
+      return file_->Append(
+          StringPiece(input_base, elements * bytes_per_sample_));
+    }
+    buffer_.resize(elements * bytes_per_sample_);
+    for (int64 i = 0; i < elements; i++) {
+      const char* in_p = input_base + i * 4;
+      char* out_p = &buffer_[i * 3];
+      out_p[2] = in_p[3];
+      out_p[1] = in_p[2];
+      out_p[0] = in_p[1];
+    }
+    return file_->Append(buffer_);
+  }
+  Status Finish() override { return OkStatus(); }
+
+ private:
+  WritableFile* file_;
+  DataType dtype_;
+  int64 bytes_per_sample_;
+  string buffer_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeWAV").Device(DEVICE_CPU),
                         AudioDecodeWAVOp);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioEncodeWAV").Device(DEVICE_CPU),
@@ -494,5 +579,14 @@ Status WAVReadableResourceInit(
   return status;
 }
 
+Status WAVWritableEncoderInit(
+    WritableFile* file, const int64 rate, const int64 channels,
+    const DataType dtype, std::unique_ptr<AudioWritableEncoderBase>& encoder) {
+  std::unique_ptr<WAVWritableEncoder> wav(new WAVWritableEncoder(file));
+  TF_RETURN_IF_ERROR(wav->Init(rate, channels, dtype));
+  encoder = std::move(wav);
+  return OkStatus();
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -0,0 +1,442 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks of the ATDS decode path: the dense, sparse and varlen feature
+// decoders, the block reader per codec, and ShuffleHandler::SampleBlocks.
+// Items are records, bytes are the encoded bytes of the records. Run with
+//
+//   bazel run -c opt //tensorflow_io/core:avro_atds_benchmarks -- \
+//     --benchmark_filter=all
+
+#include <numeric>
+
+#include "absl/memory/memory.h"
+#include "api/DataFile.hh"
+#include "api/Generic.hh"
+#include "api/GenericDatum.hh"
+#include "api/Stream.hh"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow_io/core/kernels/avro/atds/atds_decoder.h"
+#include "tensorflow_io/core/kernels/avro/atds/avro_block_reader.h"
+#include "tensorflow_io/core/kernels/avro/atds/decoder_test_util.h"
+#include "tensorflow_io/core/kernels/avro/atds/decompression_handler.h"
+#include "tensorflow_io/core/kernels/avro/atds/shuffle_handler.h"
+
+namespace tensorflow {
+namespace atds {
+namespace {
+
+constexpr size_t kNumRecords = 1024;
+constexpr char kFeatureName[] = "feature";
+
+template <typename T>
+T MakeValue(size_t i) {
+  return static_cast<T>(i % 128);
+}
+
+template <>
+string MakeValue(size_t i) {
+  return strings::StrCat("value_", i % 128);
+}
+
+template <typename T>
+std::vector<T> MakeValues(size_t n, size_t seed) {
+  std::vector<T> values;
+  values.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    values.push_back(MakeValue<T>(seed + i));
+  }
+  return values;
+}
+
+// Decodes the kNumRecords records of `bytes` on every iteration of `state`.
+template <typename T>
+void DecodeRecords(::testing::benchmark::State& state, ATDSDecoder& decoder,
+                   const std::vector<uint8_t>& bytes,
+                   std::vector<Tensor>& dense_tensors) {
+  std::vector<avro::GenericDatum> skipped_data = decoder.GetSkippedData();
+  sparse::ValueBuffer buffer;
+  sparse::GetValuesBuffer<T>(buffer).resize(1);
+  buffer.indices.resize(1);
+  buffer.num_of_elements.resize(1);
+  for (auto s : state) {
+    sparse::ClearValueBuffer(buffer);
+    RawDecoder raw(bytes.data(), bytes.size());
+    RawDecoder* raw_decoder = &raw;
+    for (size_t i = 0; i < kNumRecords; i++) {
+      Status status = decoder.DecodeATDSDatum(raw_decoder, dense_tensors,
+                                              buffer, skipped_data, i);
+      if (!status.ok()) {
+        state.SkipWithError(status.ToString().c_str());
+        return;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRecords);
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+
+// Encodes kNumRecords records of `add_value(datum, record)` with `schema`.
+template <typename F>
+std::vector<uint8_t> EncodeRecords(const avro::ValidSchema& schema,
+                                   F add_value) {
+  std::vector<avro::GenericDatum> data;
+  data.reserve(kNumRecords);
+  for (size_t i = 0; i < kNumRecords; i++) {
+    data.emplace_back(schema);
+    add_value(data.back(), i);
+  }
+  avro::OutputStreamPtr out_stream = EncodeAvroGenericData(data);
+  return *avro::snapshot(*out_stream);
+}
+
+// Args: (number of values per record, rank). A rank 2 feature has
+// [values, 2] values per record.
+template <typename T>
+void BM_DenseDecoder(::testing::benchmark::State& state) {
+  const size_t size = state.range(0);
+  const size_t rank = state.range(1);
+  const DataType dtype = GetDataType<T>();
+  ATDSSchemaBuilder schema_builder;
+  schema_builder.AddDenseFeature(kFeatureName, dtype, rank);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+  std::vector<uint8_t> bytes =
+      EncodeRecords(schema, [&](avro::GenericDatum& datum, size_t i) {
+        if (rank == 1) {
+          AddDenseValue(datum, kFeatureName, MakeValues<T>(size, i));
+        } else {
+          std::vector<std::vector<T>> values;
+          for (size_t j = 0; j < size; j++) {
+            values.push_back(MakeValues<T>(2, i + j));
+          }
+          AddDenseValue(datum, kFeatureName, values);
+        }
+      });
+
+  std::vector<int64> shape = {static_cast<int64>(size)};
+  if (rank == 2) {
+    shape.push_back(2);
+  }
+  std::vector<dense::Metadata> dense_features;
+  std::vector<sparse::Metadata> sparse_features;
+  std::vector<varlen::Metadata> varlen_features;
+  dense_features.emplace_back(FeatureType::dense, kFeatureName, dtype,
+                              PartialTensorShape(shape), 0);
+  ATDSDecoder decoder(dense_features, sparse_features, varlen_features);
+  TF_CHECK_OK(decoder.Initialize(schema));
+
+  shape.insert(shape.begin(), kNumRecords);
+  std::vector<Tensor> dense_tensors;
+  dense_tensors.emplace_back(dtype, TensorShape(shape));
+  DecodeRecords<T>(state, decoder, bytes, dense_tensors);
+}
+
+// Args: (number of values per record, rank).
+template <typename T>
+void BM_SparseDecoder(::testing::benchmark::State& state) {
+  const size_t size = state.range(0);
+  const size_t rank = state.range(1);
+  const DataType dtype = GetDataType<T>();
+  std::vector<size_t> order(rank + 1);
+  std::iota(order.begin(), order.end(), 0);
+  ATDSSchemaBuilder schema_builder;
+  schema_builder.AddSparseFeature(kFeatureName, dtype, order);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+  std::vector<uint8_t> bytes =
+      EncodeRecords(schema, [&](avro::GenericDatum& datum, size_t i) {
+        std::vector<std::vector<long>> indices(rank);
+        for (auto& dim : indices) {
+          for (size_t j = 0; j < size; j++) {
+            dim.push_back(static_cast<long>(j));
+          }
+        }
+        AddSparseValue(datum, kFeatureName, indices, MakeValues<T>(size, i));
+      });
+
+  std::vector<int64> shape(rank, static_cast<int64>(size));
+  std::vector<dense::Metadata> dense_features;
+  std::vector<sparse::Metadata> sparse_features;
+  std::vector<varlen::Metadata> varlen_features;
+  sparse_features.emplace_back(FeatureType::sparse, kFeatureName, dtype,
+                               PartialTensorShape(shape), 0, 0);
+  ATDSDecoder decoder(dense_features, sparse_features, varlen_features);
+  TF_CHECK_OK(decoder.Initialize(schema));
+
+  std::vector<Tensor> dense_tensors;
+  DecodeRecords<T>(state, decoder, bytes, dense_tensors);
+}
+
+// Args: (number of values per record).
+template <typename T>
+void BM_VarlenDecoder(::testing::benchmark::State& state) {
+  const size_t size = state.range(0);
+  const DataType dtype = GetDataType<T>();
+  ATDSSchemaBuilder schema_builder;
+  schema_builder.AddDenseFeature(kFeatureName, dtype, 1);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+  std::vector<uint8_t> bytes =
+      EncodeRecords(schema, [&](avro::GenericDatum& datum, size_t i) {
+        // Records of 1 to `size` values.
+        AddDenseValue(datum, kFeatureName, MakeValues<T>(i % size + 1, i));
+      });
+
+  std::vector<dense::Metadata> dense_features;
+  std::vector<sparse::Metadata> sparse_features;
+  std::vector<varlen::Metadata> varlen_features;
+  varlen_features.emplace_back(FeatureType::varlen, kFeatureName, dtype,
+                               PartialTensorShape({-1}), 0, 0);
+  ATDSDecoder decoder(dense_features, sparse_features, varlen_features);
+  TF_CHECK_OK(decoder.Initialize(schema));
+
+  std::vector<Tensor> dense_tensors;
+  DecodeRecords<T>(state, decoder, bytes, dense_tensors);
+}
+
+#define BM_DECODER_TYPES(BM, ...)               \
+  BENCHMARK_TEMPLATE(BM, int)->__VA_ARGS__;     \
+  BENCHMARK_TEMPLATE(BM, int64_t)->__VA_ARGS__; \
+  BENCHMARK_TEMPLATE(BM, float)->__VA_ARGS__;   \
+  BENCHMARK_TEMPLATE(BM, double)->__VA_ARGS__;  \
+  BENCHMARK_TEMPLATE(BM, string)->__VA_ARGS__
+
+BM_DECODER_TYPES(BM_DenseDecoder, ArgsProduct({{1, 16, 256}, {1, 2}}));
+BM_DECODER_TYPES(BM_SparseDecoder, ArgsProduct({{1, 16, 256}, {1, 2}}));
+BM_DECODER_TYPES(BM_VarlenDecoder, Arg(1)->Arg(16)->Arg(256));
+
+#undef BM_DECODER_TYPES
+
+}  // namespace
+}  // namespace atds
+
+namespace data {
+namespace {
+
+// An avro::OutputStream into a string, so that the file written by an
+// avro::DataFileWriter outlives the writer.
+class StringOutputStream : public avro::OutputStream {
+ public:
+  explicit StringOutputStream(string* buffer) : buffer_(buffer) {}
+
+  bool next(uint8_t** data, size_t* len) override {
+    const size_t pos = buffer_->size();
+    buffer_->resize(pos + kChunkSize);
+    *data = reinterpret_cast<uint8_t*>(&(*buffer_)[pos]);
+    *len = kChunkSize;
+    return true;
+  }
+  void backup(size_t len) override { buffer_->resize(buffer_->size() - len); }
+  uint64_t byteCount() const override { return buffer_->size(); }
+  void flush() override {}
+
+ private:
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  string* buffer_;
+};
+
+class StringRandomAccessFile : public RandomAccessFile {
+ public:
+  explicit StringRandomAccessFile(const string& content) : content_(content) {}
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    if (offset >= content_.size()) {
+      *result = StringPiece();
+      return errors::OutOfRange("eof");
+    }
+    const size_t len = std::min(n, content_.size() - offset);
+    memcpy(scratch, content_.data() + offset, len);
+    *result = StringPiece(scratch, len);
+    return len < n ? errors::OutOfRange("eof") : OkStatus();
+  }
+
+ private:
+  const string& content_;
+};
+
+void Decompress(DecompressionHandler& handler, AvroBlock& block) {
+  switch (block.codec) {
+    case DEFLATE_CODEC:
+      handler.decompressDeflateCodec(block);
+      break;
+#ifdef SNAPPY_CODEC_AVAILABLE
+    case SNAPPY_CODEC:
+      handler.decompressSnappyCodec(block);
+      break;
+#endif
+    case ZSTANDARD_CODEC:
+      handler.decompressZstandardCodec(block);
+      break;
+    case LZ4_CODEC:
+      handler.decompressLz4Codec(block);
+      break;
+    default:
+      handler.decompressNullCodec(block);
+      break;
+  }
+}
+
+// Reads and decompresses the blocks of a file of kNumRecords records with
+// a dense float feature of 64 values, written with the avro::Codec of
+// Arg(0). The Avro C++ writer has no Zstandard or LZ4 codec, those are
+// covered by BM_Decompress.
+void BM_AvroBlockReader(::testing::benchmark::State& state) {
+  const avro::Codec codec = static_cast<avro::Codec>(state.range(0));
+  atds::ATDSSchemaBuilder schema_builder;
+  schema_builder.AddDenseFeature(atds::kFeatureName, DT_FLOAT, 1);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+  string content;
+  {
+    avro::DataFileWriter<avro::GenericDatum> writer(
+        absl::make_unique<StringOutputStream>(&content), schema, 16 * 1024,
+        codec);
+    for (size_t i = 0; i < atds::kNumRecords; i++) {
+      avro::GenericDatum datum(schema);
+      atds::AddDenseValue(datum, atds::kFeatureName,
+                          atds::MakeValues<float>(64, i));
+      writer.write(datum);
+    }
+    writer.close();
+  }
+
+  StringRandomAccessFile file(content);
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  int64 records = 0;
+  for (auto s : state) {
+    AvroBlockReader reader(&file, 256 * 1024);
+    while (true) {
+      AvroBlock block;
+      if (!reader.ReadBlock(block).ok()) {
+        break;
+      }
+      Decompress(handler, block);
+      records += block.object_count;
+      pool.Release(std::move(block.content));
+    }
+  }
+  state.SetItemsProcessed(records);
+  state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+BENCHMARK(BM_AvroBlockReader)
+    ->Arg(avro::NULL_CODEC)
+#ifdef SNAPPY_CODEC_AVAILABLE
+    ->Arg(avro::SNAPPY_CODEC)
+#endif
+    ->Arg(avro::DEFLATE_CODEC);
+
+string Compress(BlockCodec codec, const string& content) {
+  string compressed;
+  switch (codec) {
+    case DEFLATE_CODEC: {
+      z_stream zs;
+      memset(&zs, 0, sizeof(zs));
+      deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY);
+      compressed.resize(deflateBound(&zs, content.size()));
+      zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+      zs.avail_in = content.size();
+      zs.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+      zs.avail_out = compressed.size();
+      deflate(&zs, Z_FINISH);
+      compressed.resize(zs.total_out);
+      deflateEnd(&zs);
+      break;
+    }
+    case ZSTANDARD_CODEC:
+      compressed.resize(ZSTD_compressBound(content.size()));
+      compressed.resize(ZSTD_compress(&compressed[0], compressed.size(),
+                                      content.data(), content.size(), 1));
+      break;
+    case LZ4_CODEC:
+      compressed.resize(LZ4F_compressFrameBound(content.size(), nullptr));
+      compressed.resize(LZ4F_compressFrame(&compressed[0], compressed.size(),
+                                           content.data(), content.size(),
+                                           nullptr));
+      break;
+    default:
+      compressed = content;
+      break;
+  }
+  return compressed;
+}
+
+// Decompresses a block of Arg(1) bytes of encoded records with the
+// BlockCodec of Arg(0). Bytes are those of the decompressed block.
+void BM_Decompress(::testing::benchmark::State& state) {
+  const BlockCodec codec = static_cast<BlockCodec>(state.range(0));
+  const size_t size = state.range(1);
+  string content;
+  while (content.size() < size) {
+    strings::StrAppend(&content, "value_", content.size() % 1024, ",");
+  }
+  content.resize(size);
+  const string compressed = Compress(codec, content);
+
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  for (auto s : state) {
+    AvroBlock block;
+    block.object_count = 1;
+    block.num_to_decode = 0;
+    block.num_decoded = 0;
+    block.byte_count = compressed.size();
+    block.counts = 0;
+    block.content = tstring(compressed);
+    block.codec = codec;
+    block.read_offset = 0;
+    Decompress(handler, block);
+    pool.Release(std::move(block.content));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_Decompress)
+    ->ArgsProduct({{DEFLATE_CODEC, ZSTANDARD_CODEC, LZ4_CODEC},
+                   {64 * 1024, 1024 * 1024}});
+
+// Samples a batch of Arg(1) records from Arg(0) blocks of 1024 records,
+// shuffled if Arg(2) is 1.
+void BM_SampleBlocks(::testing::benchmark::State& state) {
+  const size_t num_blocks = state.range(0);
+  const size_t batch_size = state.range(1);
+  const bool shuffle = state.range(2) != 0;
+  std::vector<std::unique_ptr<AvroBlock>> blocks;
+  for (size_t i = 0; i < num_blocks; i++) {
+    blocks.emplace_back(absl::make_unique<AvroBlock>());
+    blocks.back()->object_count = 1024;
+  }
+  mutex mu;
+  ShuffleHandler handler(&mu, 0);
+  mutex_lock l(mu);
+  for (auto s : state) {
+    for (auto& block : blocks) {
+      block->num_decoded = 0;
+      block->num_to_decode = 0;
+    }
+    handler.SampleBlocks(batch_size, shuffle, blocks);
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+BENCHMARK(BM_SampleBlocks)->ArgsProduct({{4, 64}, {256, 4096}, {0, 1}});
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -56,10 +56,16 @@ Status ATDSDecoder::Initialize(const avro::ValidSchema& schema) {
   size_t opaque_contextual_index = 0;
   for (size_t i = 0; i < num_of_columns; i++) {
     if (decoder_types_[i] == FeatureType::opaque_contextual) {
-      decoders_[i] = std::unique_ptr<DecoderBase>(
-          new opaque_contextual::FeatureDecoder(opaque_contextual_index++));
-
       auto& opaque_contextual_node = root_node->leafAt(i);
+      decoders_[i] =
+          std::unique_ptr<DecoderBase>(new opaque_contextual::FeatureDecoder(
+              opaque_contextual_index++, opaque_contextual_node));
+      // Named type references can not be skipped without resolving them, so
+      // such schemas fall back to the avro decoder.
+      if (!RawDecoder::CanSkip(opaque_contextual_node)) {
+        raw_decoding_supported_ = false;
+      }
+
       skipped_data_.emplace_back(opaque_contextual_node);
       if (opaque_contextual_node->hasName()) {
         feature_names_[i] = root_node->leafAt(i)->name();
@@ -43,6 +43,22 @@ class NullableFeatureDecoder : public DecoderBase {
                     sparse::ValueBuffer& buffer,
                     std::vector<avro::GenericDatum>& skipped_data,
                     size_t offset) {
+    return Decode(decoder, dense_tensors, buffer, skipped_data, offset);
+  }
+
+  Status operator()(RawDecoder*& decoder, std::vector<Tensor>& dense_tensors,
+                    sparse::ValueBuffer& buffer,
+                    std::vector<avro::GenericDatum>& skipped_data,
+                    size_t offset) {
+    return Decode(decoder, dense_tensors, buffer, skipped_data, offset);
+  }
+
+ private:
+  template <typename Decoder>
+  inline Status Decode(Decoder& decoder, std::vector<Tensor>& dense_tensors,
+                       sparse::ValueBuffer& buffer,
+                       std::vector<avro::GenericDatum>& skipped_data,
+                       size_t offset) {
     auto index = decoder->decodeUnionIndex();
     if (index != non_null_index_) {
       return NullValueError();
@@ -51,7 +67,6 @@ class NullableFeatureDecoder : public DecoderBase {
                                 offset);
   }
 
- private:
   std::unique_ptr<DecoderBase> decoder_;
   const size_t non_null_index_;
 };
@@ -67,8 +82,10 @@ class ATDSDecoder {
 
   Status Initialize(const avro::ValidSchema&);
 
-  Status DecodeATDSDatum(avro::DecoderPtr& decoder,
-                         std::vector<Tensor>& dense_tensors,
+  // Decoder is either avro::DecoderPtr or RawDecoder*. RawDecoder can only be
+  // used when SupportsRawDecoding() returns true.
+  template <typename Decoder>
+  Status DecodeATDSDatum(Decoder& decoder, std::vector<Tensor>& dense_tensors,
                          sparse::ValueBuffer& buffer,
                          std::vector<avro::GenericDatum>& skipped_data,
                          size_t offset) {
@@ -81,9 +98,12 @@ class ATDSDecoder {
       }
     }
     // LOG(INFO) << "Decode atds from offset Done: " << offset;
-    return OkStatus();
+    return CheckDecoderState(decoder);
   }
 
+  // Returns true if every column of the schema can be decoded by RawDecoder.
+  bool SupportsRawDecoding() const { return raw_decoding_supported_; }
+
   const std::vector<avro::GenericDatum>& GetSkippedData() {
     return skipped_data_;
   }
@@ -91,6 +111,17 @@ class ATDSDecoder {
   const avro::ValidSchema& GetSchema() { return schema_; }
 
  private:
+  static Status CheckDecoderState(avro::DecoderPtr& decoder) {
+    return OkStatus();
+  }
+
+  static Status CheckDecoderState(RawDecoder*& decoder) {
+    if (TF_PREDICT_FALSE(!decoder->ok())) {
+      return TruncatedDatumError();
+    }
+    return OkStatus();
+  }
+
   template <typename Metadata>
   Status InitializeFeatureDecoder(const avro::ValidSchema& schema,
                                   const avro::NodePtr& root_node,
@@ -139,6 +170,7 @@ class ATDSDecoder {
   std::vector<string> feature_names_;
   std::vector<std::unique_ptr<DecoderBase>> decoders_;
   std::vector<FeatureType> decoder_types_;
+  bool raw_decoding_supported_ = true;
 
   std::vector<avro::GenericDatum> skipped_data_;
   avro::ValidSchema schema_;
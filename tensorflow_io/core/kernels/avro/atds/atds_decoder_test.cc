@@ -141,6 +141,65 @@ TEST(ATDSDecoder, TestMixedFeatures) {
                  varlen_bool_1d, {3});
   ValidateBuffer(buffer, varlen_features[1], {offset, 0, 0, offset, 2, 0},
                  expected_varlen_string_2d_values, {2});
+
+  // Unused columns are skipped by the raw decoder.
+  ASSERT_TRUE(atds_decoder.SupportsRawDecoding());
+  auto bytes = avro::snapshot(*out_stream);
+  RawDecoder raw(bytes->data(), bytes->size());
+  RawDecoder* raw_decoder = &raw;
+  std::vector<Tensor> raw_dense_tensors;
+  raw_dense_tensors.emplace_back(DT_FLOAT, TensorShape(feature_shapes[0]));
+  raw_dense_tensors.emplace_back(DT_INT64, TensorShape(feature_shapes[1]));
+
+  sparse::ValueBuffer raw_buffer;
+  raw_buffer.indices.resize(4);
+  raw_buffer.num_of_elements.resize(4);
+  raw_buffer.string_values.resize(2);
+  raw_buffer.int_values.resize(1);
+  raw_buffer.bool_values.resize(1);
+  decode_status = atds_decoder.DecodeATDSDatum(raw_decoder, raw_dense_tensors,
+                                               raw_buffer, skipped_data,
+                                               static_cast<size_t>(offset));
+  ASSERT_TRUE(decode_status.ok());
+  ASSERT_EQ(bytes->size(), raw.byteCount());
+  AssertTensorValues(raw_dense_tensors[0], dense_float_1d);
+  AssertTensorValues(raw_dense_tensors[1], dense_long_2d);
+  ValidateBuffer(raw_buffer, sparse_features[0], {offset, 100},
+                 sparse_int_1d_values, {1});
+  ValidateBuffer(raw_buffer, sparse_features[1], {offset, 5, 4, offset, 5, 8},
+                 sparse_string_2d_values, {2});
+  ValidateBuffer(raw_buffer, varlen_features[0],
+                 {offset, 0, offset, 1, offset, 2}, varlen_bool_1d, {3});
+  ValidateBuffer(raw_buffer, varlen_features[1], {offset, 0, 0, offset, 2, 0},
+                 expected_varlen_string_2d_values, {2});
+}
+
+TEST(ATDSDecoder, TestRawDecoderTruncatedDatum) {
+  string feature_name = "feature";
+  ATDSSchemaBuilder schema_builder = ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, DT_DOUBLE, 0);
+  avro::ValidSchema writer_schema = schema_builder.BuildVaildSchema();
+
+  std::vector<dense::Metadata> dense_features;
+  std::vector<sparse::Metadata> sparse_features;
+  std::vector<varlen::Metadata> varlen_features;
+  dense_features.emplace_back(FeatureType::dense, feature_name, DT_DOUBLE,
+                              PartialTensorShape({}), 0);
+  ATDSDecoder atds_decoder =
+      ATDSDecoder(dense_features, sparse_features, varlen_features);
+  ASSERT_TRUE(atds_decoder.Initialize(writer_schema).ok());
+
+  // A double needs 8 bytes.
+  std::vector<uint8_t> bytes = {0, 1, 2};
+  RawDecoder raw(bytes.data(), bytes.size());
+  RawDecoder* raw_decoder = &raw;
+  std::vector<Tensor> dense_tensors;
+  dense_tensors.emplace_back(DT_DOUBLE, TensorShape({}));
+  sparse::ValueBuffer buffer;
+  std::vector<avro::GenericDatum> skipped_data = atds_decoder.GetSkippedData();
+  Status decode_status = atds_decoder.DecodeATDSDatum(
+      raw_decoder, dense_tensors, buffer, skipped_data, 0);
+  ASSERT_EQ(absl::StatusCode::kDataLoss, decode_status.code());
 }
 
 }  // namespace atds
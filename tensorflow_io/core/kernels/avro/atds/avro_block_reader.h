@@ -16,8 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_AVRO_BLOCK_READER_H_
 #define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_AVRO_BLOCK_READER_H_
 
+#include <algorithm>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
+#include <deque>
+#include <limits>
+#include <memory>
 
 #include "api/Compiler.hh"
 #include "api/DataFile.hh"
@@ -25,11 +29,24 @@ limitations under the License.
 #include "api/Specific.hh"
 #include "api/Stream.hh"
 #include "api/ValidSchema.hh"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
+#include "tensorflow/core/platform/notification.h"
 
 namespace tensorflow {
 namespace data {
 
+// Compression codecs of the blocks in an Avro object container file. avro-c++
+// only defines null, deflate and snappy in avro::Codec, so ATDS keeps its own
+// enum that also covers zstandard and lz4.
+enum BlockCodec {
+  NULL_CODEC,
+  DEFLATE_CODEC,
+  SNAPPY_CODEC,
+  ZSTANDARD_CODEC,
+  LZ4_CODEC
+};
+
 struct AvroBlock {
   int64_t object_count;
   int64_t num_to_decode;
@@ -37,24 +54,71 @@ struct AvroBlock {
   int64_t byte_count;
   int64_t counts;
   tstring content;
-  avro::Codec codec;
+  BlockCodec codec;
   size_t read_offset;
+  // True if content is a buffer acquired from a BlockBufferPool.
+  bool pooled = false;
+  // Order in which the prefetch threads read the blocks of an epoch.
+  uint64 sequence = 0;
+  // File and offset the block was read from, saved with the iterator.
+  size_t file_index = 0;
+  uint64 file_offset = 0;
 };
 
+// Reads a file in buffers of `buffer_size` bytes. With a `read_pool` and a
+// `queue_depth` above 1, the reads of the `queue_depth` buffers that follow
+// the one being consumed are kept in flight on the pool, so that a local file
+// is read at that queue depth instead of one synchronous read at a time.
+//
+// A stream over `contents` held in memory instead serves it all as a single
+// buffer, without copying it.
+//
+// The stream ends at the first failed read of the file, which first_error
+// returns.
 class FileBufferInputStream : public avro::InputStream {
  public:
-  FileBufferInputStream(tensorflow::RandomAccessFile* file, int64 buffer_size)
+  explicit FileBufferInputStream(StringPiece contents)
+      : reader_(nullptr),
+        file_(nullptr),
+        read_pool_(nullptr),
+        memory_(contents.data()),
+        limit_(contents.size()),
+        pos_(0),
+        count_(0),
+        skip_(0),
+        buffer_size_(contents.size()),
+        queue_depth_(1) {}
+
+  FileBufferInputStream(tensorflow::RandomAccessFile* file, int64 buffer_size,
+                        int64 queue_depth = 1,
+                        thread::ThreadPool* read_pool = nullptr)
       : reader_(nullptr),
+        file_(file),
+        read_pool_(read_pool),
         limit_(0),
         pos_(0),
         count_(0),
         skip_(0),
-        buffer_size_(buffer_size) {
+        buffer_size_(buffer_size),
+        queue_depth_(read_pool == nullptr ? 1
+                                          : std::max<int64>(queue_depth, 1)) {
     reader_ = absl::make_unique<io::RandomAccessInputStream>(file);
   }
 
+  // The reads in flight write to buffers owned by the stream.
+  ~FileBufferInputStream() override { DrainReads(); }
+
   bool next(const uint8_t** data, size_t* len) override {
     while (pos_ == limit_) {
+      if (memory_ != nullptr || !first_error_.ok()) {
+        return false;
+      }
+      if (queue_depth_ > 1) {
+        if (!NextReadAhead()) {
+          return false;
+        }
+        continue;
+      }
       if (skip_ > 0) {
         reader_->SkipNBytes(static_cast<int64>(skip_));
         skip_ = 0;
@@ -62,6 +126,9 @@ class FileBufferInputStream : public avro::InputStream {
 
       buf_.clear();
       Status status = reader_->ReadNBytes(buffer_size_, &buf_);
+      if (!status.ok() && !errors::IsOutOfRange(status)) {
+        return Fail(status);
+      }
       pos_ = 0;
       limit_ = buf_.size();
       if (limit_ == 0 && errors::IsOutOfRange(status)) {
@@ -73,7 +140,8 @@ class FileBufferInputStream : public avro::InputStream {
       *len = limit_ - pos_;
     }
 
-    *data = reinterpret_cast<uint8_t*>(buf_.data()) + pos_;
+    const char* base = memory_ != nullptr ? memory_ : buf_.data();
+    *data = reinterpret_cast<const uint8_t*>(base) + pos_;
     pos_ += *len;
     count_ += *len;
 
@@ -98,11 +166,142 @@ class FileBufferInputStream : public avro::InputStream {
 
   size_t byteCount() const override { return count_; }
 
+  // Whether the stream serves contents held in memory.
+  bool in_memory() const { return memory_ != nullptr; }
+
+  // The error of the read that ended the stream, if any. The end of the file
+  // is not an error.
+  const Status& first_error() const { return first_error_; }
+
+  // Moves the stream to an absolute offset in the file and drops the buffered
+  // content.
+  Status Seek(uint64 offset) {
+    if (memory_ != nullptr) {
+      pos_ = std::min(static_cast<size_t>(offset), limit_);
+      skip_ = 0;
+      count_ = offset;
+      return OkStatus();
+    }
+    TF_RETURN_IF_ERROR(reader_->Seek(static_cast<int64>(offset)));
+    buf_.clear();
+    buf_offset_ = offset;
+    limit_ = 0;
+    pos_ = 0;
+    skip_ = 0;
+    count_ = offset;
+    return OkStatus();
+  }
+
  private:
+  // A read of the buffer at `offset`, run on the read pool.
+  struct PendingRead {
+    uint64 offset = 0;
+    tstring buf;
+    Status status;
+    Notification done;
+  };
+
+  // Moves buf_ to the buffer read at the stream position, issued ahead if it
+  // is the next one, and tops up the reads in flight. Returns false at the
+  // end of the file.
+  bool NextReadAhead() {
+    const uint64 offset = buf_offset_ + limit_ + skip_;
+    skip_ = 0;
+    // A Seek or skip out of the read ahead window drops the reads in flight.
+    if (!reads_.empty() &&
+        (offset < reads_.front()->offset ||
+         offset >= reads_.back()->offset + buffer_size_)) {
+      DrainReads();
+    }
+    while (!reads_.empty() &&
+           reads_.front()->offset + buffer_size_ <= offset) {
+      reads_.front()->done.WaitForNotification();
+      reads_.pop_front();
+    }
+    if (reads_.empty()) {
+      next_read_offset_ = offset;
+    }
+    IssueReads();
+    if (reads_.empty()) {
+      buf_offset_ = offset;
+      buf_.clear();
+      pos_ = limit_ = 0;
+      return false;
+    }
+
+    std::shared_ptr<PendingRead> read = std::move(reads_.front());
+    reads_.pop_front();
+    read->done.WaitForNotification();
+    if (!read->status.ok() && !errors::IsOutOfRange(read->status)) {
+      DrainReads();
+      buf_offset_ = read->offset;
+      return Fail(read->status);
+    }
+    buf_ = std::move(read->buf);
+    buf_offset_ = read->offset;
+    limit_ = buf_.size();
+    if (limit_ < static_cast<size_t>(buffer_size_)) {
+      // A short read ends the file, nothing is read past it.
+      eof_offset_ = std::min(eof_offset_, buf_offset_ + limit_);
+    }
+    IssueReads();
+    pos_ = std::min(static_cast<size_t>(offset - buf_offset_), limit_);
+    return pos_ < limit_;
+  }
+
+  // Schedules reads of the buffers after the last one in flight, up to
+  // queue_depth_ of them.
+  void IssueReads() {
+    while (reads_.size() < static_cast<size_t>(queue_depth_) &&
+           next_read_offset_ < eof_offset_) {
+      auto read = std::make_shared<PendingRead>();
+      read->offset = next_read_offset_;
+      next_read_offset_ += buffer_size_;
+      read_pool_->Schedule([file = file_, n = buffer_size_, read]() {
+        read->buf.resize_uninitialized(n);
+        StringPiece result;
+        read->status = file->Read(read->offset, n, &result, &read->buf[0]);
+        if (result.size() > 0 && result.data() != read->buf.data()) {
+          memmove(&read->buf[0], result.data(), result.size());
+        }
+        read->buf.resize(result.size());
+        read->done.Notify();
+      });
+      reads_.push_back(std::move(read));
+    }
+  }
+
+  void DrainReads() {
+    for (const std::shared_ptr<PendingRead>& read : reads_) {
+      read->done.WaitForNotification();
+    }
+    reads_.clear();
+  }
+
+  // Ends the stream at the failed read. Returns false for next.
+  bool Fail(const Status& status) {
+    first_error_ = status;
+    buf_.clear();
+    pos_ = limit_ = 0;
+    return false;
+  }
+
   std::unique_ptr<io::RandomAccessInputStream> reader_;
+  tensorflow::RandomAccessFile* const file_;
+  thread::ThreadPool* const read_pool_;
+  // The contents the stream serves, if held in memory.
+  const char* const memory_ = nullptr;
   size_t limit_, pos_, count_, skip_;
   const int64 buffer_size_;
+  const int64 queue_depth_;
   tstring buf_;
+  // File offset of buf_ and of the next read to issue, and the end of the
+  // file once a short read found it, with read ahead.
+  uint64 buf_offset_ = 0;
+  uint64 next_read_offset_ = 0;
+  uint64 eof_offset_ = std::numeric_limits<uint64>::max();
+  std::deque<std::shared_ptr<PendingRead>> reads_;
+  Status first_error_;
 };
 
 constexpr const char* const AVRO_SCHEMA_KEY = "avro.schema";
@@ -110,6 +309,8 @@ constexpr const char* const AVRO_CODEC_KEY = "avro.codec";
 constexpr const char* const AVRO_NULL_CODEC = "null";
 constexpr const char* const AVRO_DEFLATE_CODEC = "deflate";
 constexpr const char* const AVRO_SNAPPY_CODEC = "snappy";
+constexpr const char* const AVRO_ZSTANDARD_CODEC = "zstandard";
+constexpr const char* const AVRO_LZ4_CODEC = "lz4";
 
 using Magic = std::array<uint8_t, 4>;
 static const Magic magic = {{'O', 'b', 'j', '\x01'}};
@@ -118,21 +319,88 @@ using AvroMetadata = std::map<std::string, std::vector<uint8_t>>;
 
 class AvroBlockReader {
  public:
-  AvroBlockReader(tensorflow::RandomAccessFile* file, int64 buffer_size)
+  AvroBlockReader(tensorflow::RandomAccessFile* file, int64 buffer_size,
+                  int64 queue_depth = 1,
+                  thread::ThreadPool* read_pool = nullptr)
+      : stream_(nullptr), decoder_(nullptr) {
+    stream_ = std::make_unique<FileBufferInputStream>(file, buffer_size,
+                                                       queue_depth, read_pool);
+    decoder_ = avro::binaryDecoder();
+    ReadHeader();
+  }
+
+  // Reads Avro container `contents` held in memory, which must outlive the
+  // reader and the blocks read, as their content views the contents.
+  explicit AvroBlockReader(StringPiece contents)
       : stream_(nullptr), decoder_(nullptr) {
-    stream_ = std::make_unique<FileBufferInputStream>(file, buffer_size);
+    stream_ = std::make_unique<FileBufferInputStream>(contents);
     decoder_ = avro::binaryDecoder();
     ReadHeader();
   }
 
   const avro::ValidSchema& GetSchema() { return data_schema_; }
 
+  // Reads the next block. Returns OUT_OF_RANGE at the end of the file, and
+  // the error of the read if reading the file failed.
   Status ReadBlock(AvroBlock& block) {
+    try {
+      return ReadNextBlock(block);
+    } catch (avro::Exception&) {
+      // The decoder ran out of input because a read failed.
+      TF_RETURN_IF_ERROR(stream_->first_error());
+      throw;
+    }
+  }
+
+  // Returns the file offset of the next block.
+  uint64 Tell() {
+    // Hands the bytes buffered by the decoder back to the stream.
+    decoder_->init(*stream_);
+    return stream_->byteCount();
+  }
+
+  // Positions the reader at a block offset returned by Tell or
+  // ReadBlockOffsets.
+  Status SeekToBlock(uint64 offset) {
+    decoder_->init(*stream_);
+    return stream_->Seek(offset);
+  }
+
+  // Collects the offsets of the remaining blocks in the file by reading their
+  // headers and skipping over their content, then moves back to the first of
+  // them.
+  Status ReadBlockOffsets(std::vector<uint64>* offsets) {
+    uint64 start = Tell();
+    try {
+      while (true) {
+        uint64 offset = Tell();
+        Status status = SkipBlock();
+        if (errors::IsOutOfRange(status)) {
+          break;
+        }
+        TF_RETURN_IF_ERROR(status);
+        offsets->push_back(offset);
+      }
+    } catch (avro::Exception& e) {
+      TF_RETURN_IF_ERROR(stream_->first_error());
+      return errors::DataLoss("Truncated Avro block header: ", e.what());
+    }
+    return SeekToBlock(start);
+  }
+
+ private:
+  // The end of the file, or the error of the read that ended the stream.
+  Status EndOfStream() const {
+    TF_RETURN_IF_ERROR(stream_->first_error());
+    return errors::OutOfRange("eof");
+  }
+
+  Status ReadNextBlock(AvroBlock& block) {
     decoder_->init(*stream_);
     const uint8_t* p = 0;
     size_t n = 0;
     if (!stream_->next(&p, &n)) {
-      return errors::OutOfRange("eof");
+      return EndOfStream();
     }
     stream_->backup(n);
 
@@ -140,15 +408,26 @@ class AvroBlockReader {
     // LOG(INFO) << "block object counts = " << block.object_count;
     avro::decode(*decoder_, block.byte_count);
     // LOG(INFO) << "block bytes counts = " << block.byte_count;
-    block.content.reserve(block.byte_count);
 
     decoder_->init(*stream_);
     int64_t remaining_bytes = block.byte_count;
+    if (stream_->in_memory() && remaining_bytes > 0) {
+      const uint8_t* data;
+      size_t len = remaining_bytes;
+      if (!stream_->next(&data, &len) ||
+          len < static_cast<size_t>(remaining_bytes)) {
+        return EndOfStream();
+      }
+      block.content.assign_as_view(reinterpret_cast<const char*>(data), len);
+      remaining_bytes = 0;
+    } else {
+      block.content.reserve(block.byte_count);
+    }
     while (remaining_bytes > 0) {
       const uint8_t* data;
       size_t len = remaining_bytes;
       if (!stream_->next(&data, &len)) {
-        return errors::OutOfRange("eof");
+        return EndOfStream();
       }
       block.content.append(reinterpret_cast<const char*>(data), len);
       remaining_bytes -= len;
@@ -168,7 +447,31 @@ class AvroBlockReader {
     return OkStatus();
   }
 
- private:
+  Status SkipBlock() {
+    decoder_->init(*stream_);
+    const uint8_t* p = 0;
+    size_t n = 0;
+    if (!stream_->next(&p, &n)) {
+      return EndOfStream();
+    }
+    stream_->backup(n);
+
+    int64_t object_count, byte_count;
+    avro::decode(*decoder_, object_count);
+    avro::decode(*decoder_, byte_count);
+    if (byte_count < 0) {
+      return errors::DataLoss("Negative Avro block size ", byte_count, ".");
+    }
+    decoder_->init(*stream_);
+    stream_->skip(static_cast<size_t>(byte_count));
+    avro::DataFileSync sync_marker;
+    avro::decode(*decoder_, sync_marker);
+    if (sync_marker != sync_marker_) {
+      return errors::DataLoss("Avro sync marker mismatch.");
+    }
+    return OkStatus();
+  }
+
   void ReadHeader() {
     decoder_->init(*stream_);
     Magic m;
@@ -194,17 +497,21 @@ class AvroBlockReader {
       const char* codec = reinterpret_cast<const char*>(it->second.data());
       // LOG(INFO) << "Codec = " << std::string(codec, length);
       if (strncmp(codec, AVRO_DEFLATE_CODEC, length) == 0) {
-        codec_ = avro::DEFLATE_CODEC;
+        codec_ = DEFLATE_CODEC;
       } else if (strncmp(codec, AVRO_SNAPPY_CODEC, length) == 0) {
-        codec_ = avro::SNAPPY_CODEC;
+        codec_ = SNAPPY_CODEC;
+      } else if (strncmp(codec, AVRO_ZSTANDARD_CODEC, length) == 0) {
+        codec_ = ZSTANDARD_CODEC;
+      } else if (strncmp(codec, AVRO_LZ4_CODEC, length) == 0) {
+        codec_ = LZ4_CODEC;
       } else if (strncmp(codec, AVRO_NULL_CODEC, length) == 0) {
-        codec_ = avro::NULL_CODEC;
+        codec_ = NULL_CODEC;
       } else {
         throw avro::Exception("Unknown codec in data file: " +
                               std::string(codec, it->second.size()));
       }
     } else {
-      codec_ = avro::NULL_CODEC;
+      codec_ = NULL_CODEC;
     }
 
     avro::decode(*decoder_, sync_marker_);
@@ -212,7 +519,7 @@ class AvroBlockReader {
 
   AvroMetadata metadata_;
   avro::DataFileSync sync_marker_;
-  avro::Codec codec_;
+  BlockCodec codec_;
 
   std::unique_ptr<FileBufferInputStream> stream_;
   avro::DecoderPtr decoder_;
@@ -39,7 +39,8 @@ class MockRandomAccessFile : public RandomAccessFile {
 
   Status Read(uint64 offset, size_t n, StringPiece* result,
               char* scratch) const override {
-    size_t bytes_to_copy = std::min(n, len_ - static_cast<size_t>(offset));
+    size_t bytes_to_copy =
+        offset >= len_ ? 0 : std::min(n, len_ - static_cast<size_t>(offset));
     memcpy(scratch, content_ + offset, bytes_to_copy);
     *result = StringPiece(scratch, bytes_to_copy);
     if (bytes_to_copy == n) {
@@ -53,6 +54,25 @@ class MockRandomAccessFile : public RandomAccessFile {
   size_t len_;
 };
 
+// Fails the reads of a file that extend past `fail_offset`.
+class FailingRandomAccessFile : public MockRandomAccessFile {
+ public:
+  FailingRandomAccessFile(char* content, size_t len, uint64 fail_offset)
+      : MockRandomAccessFile(content, len), fail_offset_(fail_offset) {}
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    if (offset + n > fail_offset_) {
+      *result = StringPiece();
+      return errors::Unavailable("Read failed at offset ", offset);
+    }
+    return MockRandomAccessFile::Read(offset, n, result, scratch);
+  }
+
+ private:
+  const uint64 fail_offset_;
+};
+
 TEST(FileBufferInputStreamTest, SINGLE_BUFFER) {
   char content[8];
   for (size_t i = 0; i < 8; i++) {
@@ -139,6 +159,86 @@ TEST(FileBufferInputStreamTest, SKIP_PAST_BUFFER) {
   tensorflow::atds::AssertValueEqual("klmn", (char*)data, len);
 }
 
+TEST(FileBufferInputStreamTest, READ_AHEAD) {
+  char content[64];
+  for (size_t i = 0; i < 64; i++) {
+    content[i] = '0' + i;
+  }
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(content, 64);
+  thread::ThreadPool read_pool(Env::Default(), "read_ahead", 2);
+  FileBufferInputStream stream(raf.get(), 8, 3, &read_pool);
+  const uint8_t* data;
+  size_t len = 3;
+  ASSERT_TRUE(stream.next(&data, &len));
+  ASSERT_EQ(3, len);
+  tensorflow::atds::AssertValueEqual("012", (char*)data, len);
+
+  // Skips into a buffer read ahead.
+  stream.skip(14);
+  len = 4;
+  ASSERT_TRUE(stream.next(&data, &len));
+  ASSERT_EQ(4, len);
+  ASSERT_EQ(21, stream.byteCount());
+  tensorflow::atds::AssertValueEqual(string(content + 17, 4), (char*)data,
+                                     len);
+
+  // Skips past the buffers read ahead.
+  stream.skip(30);
+  len = 2;
+  ASSERT_TRUE(stream.next(&data, &len));
+  ASSERT_EQ(53, stream.byteCount());
+  tensorflow::atds::AssertValueEqual(string(content + 51, 2), (char*)data,
+                                     len);
+
+  // Seeks back to a buffer already consumed.
+  ASSERT_TRUE(stream.Seek(5).ok());
+  len = 6;
+  ASSERT_TRUE(stream.next(&data, &len));
+  ASSERT_EQ(6, len);
+  ASSERT_EQ(11, stream.byteCount());
+  tensorflow::atds::AssertValueEqual(string(content + 5, 6), (char*)data,
+                                     len);
+
+  // Reads the rest of the file, ended by a short read.
+  size_t total = 11;
+  len = 0;
+  while (stream.next(&data, &len)) {
+    total += len;
+    len = 0;
+  }
+  ASSERT_EQ(64, total);
+  ASSERT_EQ(64, stream.byteCount());
+  ASSERT_TRUE(stream.first_error().ok());
+}
+
+TEST(FileBufferInputStreamTest, READ_ERROR) {
+  char content[64];
+  for (size_t i = 0; i < 64; i++) {
+    content[i] = '0' + i;
+  }
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<FailingRandomAccessFile>(content, 64, 32);
+  thread::ThreadPool read_pool(Env::Default(), "read_ahead", 2);
+  for (int64 queue_depth : {1, 3}) {
+    FileBufferInputStream stream(raf.get(), 8, queue_depth, &read_pool);
+    const uint8_t* data;
+    size_t len = 0;
+    size_t total = 0;
+    while (stream.next(&data, &len)) {
+      tensorflow::atds::AssertValueEqual(string(content + total, len),
+                                         (char*)data, len);
+      total += len;
+      len = 0;
+    }
+    // The stream ends at the failed read instead of the end of the file.
+    ASSERT_EQ(32, total);
+    ASSERT_EQ(absl::StatusCode::kUnavailable, stream.first_error().code());
+    len = 0;
+    ASSERT_FALSE(stream.next(&data, &len));
+  }
+}
+
 static constexpr size_t OS_BUFFER_SIZE = 1024;
 
 class StringOutputStream : public avro::OutputStream {
@@ -203,7 +303,7 @@ void AvroBlockReaderTest(char* expected_content, int64_t object_count,
   AvroBlock blk;
   Status status = reader->ReadBlock(blk);
   ASSERT_TRUE(status.ok());
-  tensorflow::atds::AssertValueEqual(avro::NULL_CODEC, blk.codec);
+  tensorflow::atds::AssertValueEqual(NULL_CODEC, blk.codec);
   tensorflow::atds::AssertValueEqual(object_count, blk.object_count);
   tensorflow::atds::AssertValueEqual(expected_byte_count, blk.byte_count);
   tensorflow::atds::AssertValueEqual(expected_content, blk.content.c_str(),
@@ -621,5 +721,242 @@ TEST(AvroBlockReaderTest, SPARSE_2D) {
       (char*)expected_content, 2, expected_len, schema, {datum1, datum2});
 }
 
+TEST(AvroBlockReaderTest, BLOCK_OFFSETS) {
+  string feature_name = "dense_0d";
+  tensorflow::atds::ATDSSchemaBuilder schema_builder =
+      tensorflow::atds::ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, DT_INT64, 0);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+
+  string buf;
+  auto os = absl::make_unique<StringOutputStream>(&buf);
+  StringOutputStream* raw_os = os.get();
+  avro::DataFileWriter<avro::GenericDatum> writer(std::move(os), schema);
+  constexpr int64_t num_blocks = 5;
+  for (int64_t i = 0; i < num_blocks; i++) {
+    avro::GenericDatum datum(schema);
+    tensorflow::atds::AddDenseValue<int64_t>(datum, feature_name, i);
+    writer.write(datum);
+    // Every flush ends a block.
+    writer.flush();
+  }
+  size_t file_size = raw_os->byteCount();
+
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(const_cast<char*>(buf.c_str()),
+                                              file_size);
+  AvroBlockReader reader(raf.get(), BUFFER_SIZE);
+  std::vector<uint64> offsets;
+  ASSERT_TRUE(reader.ReadBlockOffsets(&offsets).ok());
+  ASSERT_EQ(num_blocks, offsets.size());
+  ASSERT_EQ(offsets[0], reader.Tell());
+
+  std::vector<string> contents;
+  for (int64_t i = 0; i < num_blocks; i++) {
+    ASSERT_EQ(offsets[i], reader.Tell());
+    AvroBlock block;
+    ASSERT_TRUE(reader.ReadBlock(block).ok());
+    ASSERT_EQ(1, block.object_count);
+    contents.emplace_back(block.content.data(), block.content.size());
+  }
+  AvroBlock eof_block;
+  ASSERT_EQ(absl::StatusCode::kOutOfRange, reader.ReadBlock(eof_block).code());
+
+  // Read the blocks in reverse order.
+  for (int64_t i = num_blocks - 1; i >= 0; i--) {
+    ASSERT_TRUE(reader.SeekToBlock(offsets[i]).ok());
+    AvroBlock block;
+    ASSERT_TRUE(reader.ReadBlock(block).ok());
+    ASSERT_EQ(contents[i], string(block.content.data(), block.content.size()));
+  }
+  writer.close();
+}
+
+TEST(AvroBlockReaderTest, READ_AHEAD) {
+  string feature_name = "dense_0d";
+  tensorflow::atds::ATDSSchemaBuilder schema_builder =
+      tensorflow::atds::ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, DT_INT64, 0);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+
+  string buf;
+  auto os = absl::make_unique<StringOutputStream>(&buf);
+  StringOutputStream* raw_os = os.get();
+  avro::DataFileWriter<avro::GenericDatum> writer(std::move(os), schema);
+  constexpr int64_t num_blocks = 20;
+  for (int64_t i = 0; i < num_blocks; i++) {
+    avro::GenericDatum datum(schema);
+    tensorflow::atds::AddDenseValue<int64_t>(datum, feature_name, i);
+    writer.write(datum);
+    writer.flush();
+  }
+  size_t file_size = raw_os->byteCount();
+
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(const_cast<char*>(buf.c_str()),
+                                              file_size);
+  // Buffers smaller than a block, so that blocks span reads in flight.
+  thread::ThreadPool read_pool(Env::Default(), "read_ahead", 4);
+  AvroBlockReader expected_reader(raf.get(), 16);
+  AvroBlockReader reader(raf.get(), 16, 4, &read_pool);
+  tensorflow::atds::AssertValueEqual(expected_reader.GetSchema(),
+                                     reader.GetSchema());
+  std::vector<uint64> offsets;
+  ASSERT_TRUE(reader.ReadBlockOffsets(&offsets).ok());
+  ASSERT_EQ(num_blocks, offsets.size());
+  for (int64_t i = 0; i < num_blocks; i++) {
+    ASSERT_EQ(offsets[i], reader.Tell());
+    AvroBlock expected, block;
+    ASSERT_TRUE(expected_reader.ReadBlock(expected).ok());
+    ASSERT_TRUE(reader.ReadBlock(block).ok());
+    ASSERT_EQ(expected.object_count, block.object_count);
+    ASSERT_EQ(string(expected.content.data(), expected.content.size()),
+              string(block.content.data(), block.content.size()));
+  }
+  AvroBlock eof_block;
+  ASSERT_EQ(absl::StatusCode::kOutOfRange, reader.ReadBlock(eof_block).code());
+
+  ASSERT_TRUE(reader.SeekToBlock(offsets[3]).ok());
+  ASSERT_TRUE(expected_reader.SeekToBlock(offsets[3]).ok());
+  AvroBlock expected, block;
+  ASSERT_TRUE(expected_reader.ReadBlock(expected).ok());
+  ASSERT_TRUE(reader.ReadBlock(block).ok());
+  ASSERT_EQ(string(expected.content.data(), expected.content.size()),
+            string(block.content.data(), block.content.size()));
+  writer.close();
+}
+
+TEST(AvroBlockReaderTest, READ_AHEAD_ERROR) {
+  string feature_name = "dense_0d";
+  tensorflow::atds::ATDSSchemaBuilder schema_builder =
+      tensorflow::atds::ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, DT_INT64, 0);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+
+  string buf;
+  auto os = absl::make_unique<StringOutputStream>(&buf);
+  StringOutputStream* raw_os = os.get();
+  avro::DataFileWriter<avro::GenericDatum> writer(std::move(os), schema);
+  constexpr int64_t num_blocks = 20;
+  for (int64_t i = 0; i < num_blocks; i++) {
+    avro::GenericDatum datum(schema);
+    tensorflow::atds::AddDenseValue<int64_t>(datum, feature_name, i);
+    writer.write(datum);
+    writer.flush();
+  }
+  size_t file_size = raw_os->byteCount();
+
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(const_cast<char*>(buf.c_str()),
+                                              file_size);
+  AvroBlockReader expected_reader(raf.get(), 16);
+  std::vector<uint64> offsets;
+  ASSERT_TRUE(expected_reader.ReadBlockOffsets(&offsets).ok());
+  ASSERT_EQ(num_blocks, offsets.size());
+
+  // Reads fail from the middle of the file on, while reads after them are
+  // in flight.
+  std::unique_ptr<tensorflow::RandomAccessFile> failing_raf =
+      absl::make_unique<FailingRandomAccessFile>(
+          const_cast<char*>(buf.c_str()), file_size, offsets[10]);
+  thread::ThreadPool read_pool(Env::Default(), "read_ahead", 4);
+  AvroBlockReader reader(failing_raf.get(), 16, 4, &read_pool);
+  Status status;
+  int64_t num_read = 0;
+  while (true) {
+    AvroBlock expected, block;
+    status = reader.ReadBlock(block);
+    if (!status.ok()) {
+      break;
+    }
+    ASSERT_TRUE(expected_reader.ReadBlock(expected).ok());
+    ASSERT_EQ(string(expected.content.data(), expected.content.size()),
+              string(block.content.data(), block.content.size()));
+    num_read++;
+  }
+  // The blocks before the failed read are read, then the error is returned
+  // instead of the end of the file.
+  ASSERT_GT(num_read, 0);
+  ASSERT_LE(num_read, 10);
+  ASSERT_EQ(absl::StatusCode::kUnavailable, status.code());
+  AvroBlock block;
+  ASSERT_EQ(absl::StatusCode::kUnavailable, reader.ReadBlock(block).code());
+
+  AvroBlockReader indexing_reader(failing_raf.get(), 16, 4, &read_pool);
+  offsets.clear();
+  ASSERT_EQ(absl::StatusCode::kUnavailable,
+            indexing_reader.ReadBlockOffsets(&offsets).code());
+  writer.close();
+}
+
+TEST(AvroBlockReaderTest, IN_MEMORY) {
+  string feature_name = "dense_0d";
+  tensorflow::atds::ATDSSchemaBuilder schema_builder =
+      tensorflow::atds::ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, DT_INT64, 0);
+  avro::ValidSchema schema = schema_builder.BuildVaildSchema();
+
+  string buf;
+  auto os = absl::make_unique<StringOutputStream>(&buf);
+  StringOutputStream* raw_os = os.get();
+  avro::DataFileWriter<avro::GenericDatum> writer(std::move(os), schema);
+  constexpr int64_t num_blocks = 5;
+  for (int64_t i = 0; i < num_blocks; i++) {
+    avro::GenericDatum datum(schema);
+    tensorflow::atds::AddDenseValue<int64_t>(datum, feature_name, i);
+    writer.write(datum);
+    writer.flush();
+  }
+  size_t file_size = raw_os->byteCount();
+
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(const_cast<char*>(buf.c_str()),
+                                              file_size);
+  AvroBlockReader expected_reader(raf.get(), BUFFER_SIZE);
+  AvroBlockReader reader(StringPiece(buf.data(), file_size));
+  tensorflow::atds::AssertValueEqual(expected_reader.GetSchema(),
+                                     reader.GetSchema());
+  std::vector<uint64> offsets;
+  ASSERT_TRUE(reader.ReadBlockOffsets(&offsets).ok());
+  ASSERT_EQ(num_blocks, offsets.size());
+  for (int64_t i = 0; i < num_blocks; i++) {
+    ASSERT_EQ(offsets[i], reader.Tell());
+    AvroBlock expected, block;
+    ASSERT_TRUE(expected_reader.ReadBlock(expected).ok());
+    ASSERT_TRUE(reader.ReadBlock(block).ok());
+    ASSERT_EQ(expected.object_count, block.object_count);
+    // The content views the contents. It is only read through const
+    // accessors, as the mutable ones copy a view.
+    const tstring& content = block.content;
+    ASSERT_EQ(tstring::VIEW, content.type());
+    ASSERT_GE(content.data(), buf.data());
+    ASSERT_LE(content.data() + content.size(), buf.data() + file_size);
+    ASSERT_EQ(string(expected.content.data(), expected.content.size()),
+              string(content.data(), content.size()));
+  }
+  AvroBlock eof_block;
+  ASSERT_EQ(absl::StatusCode::kOutOfRange, reader.ReadBlock(eof_block).code());
+
+  ASSERT_TRUE(reader.SeekToBlock(offsets[2]).ok());
+  AvroBlock block;
+  ASSERT_TRUE(reader.ReadBlock(block).ok());
+  ASSERT_EQ(1, block.object_count);
+  ASSERT_EQ(offsets[3], reader.Tell());
+  writer.close();
+}
+
+TEST(AvroBlockReaderTest, BLOCK_OFFSETS_SYNC_MARKER_MISMATCH) {
+  char sync_marker_mismatch[BYTEARRAY_SIZE];
+  memcpy(sync_marker_mismatch, WELLFORMED_CONTENT, BYTEARRAY_SIZE);
+  sync_marker_mismatch[218] = 0xe2;
+  std::unique_ptr<tensorflow::RandomAccessFile> raf =
+      absl::make_unique<MockRandomAccessFile>(sync_marker_mismatch,
+                                              BYTEARRAY_SIZE);
+  AvroBlockReader reader(raf.get(), BUFFER_SIZE);
+  std::vector<uint64> offsets;
+  Status status = reader.ReadBlockOffsets(&offsets);
+  ASSERT_EQ(absl::StatusCode::kDataLoss, status.code());
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -16,7 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_AVRO_DECODER_TEMPLATE_H_
 #define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_AVRO_DECODER_TEMPLATE_H_
 
+#include <algorithm>
+
 #include "api/Decoder.hh"
+#include "tensorflow_io/core/kernels/avro/atds/raw_decoder.h"
 
 namespace avro {
 namespace decoder_t {
@@ -55,6 +58,97 @@ inline bool Decode(avro::DecoderPtr& decoder) {
   return decoder->decodeBool();
 }
 
+// Overloads for RawDecoder. They are resolved at compile time so that the
+// primitive reads are inlined into the templated feature decoders.
+template <
+    typename T,
+    typename = typename std::enable_if<
+        std::is_same<int, T>::value || std::is_same<long, T>::value ||
+            std::is_same<float, T>::value || std::is_same<double, T>::value ||
+            std::is_same<bool, T>::value,
+        T>::type>
+inline T Decode(tensorflow::atds::RawDecoder*& decoder);
+
+template <>
+inline int Decode(tensorflow::atds::RawDecoder*& decoder) {
+  return decoder->decodeInt();
+}
+
+template <>
+inline long Decode(tensorflow::atds::RawDecoder*& decoder) {
+  return decoder->decodeLong();
+}
+
+template <>
+inline float Decode(tensorflow::atds::RawDecoder*& decoder) {
+  return decoder->decodeFloat();
+}
+
+template <>
+inline double Decode(tensorflow::atds::RawDecoder*& decoder) {
+  return decoder->decodeDouble();
+}
+
+template <>
+inline bool Decode(tensorflow::atds::RawDecoder*& decoder) {
+  return decoder->decodeBool();
+}
+
+// Decodes `n` consecutive items of an array block into `out`.
+template <typename T>
+inline void DecodeItems(avro::DecoderPtr& decoder, T* out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = Decode<T>(decoder);
+  }
+}
+
+template <typename T>
+inline void DecodeItems(tensorflow::atds::RawDecoder*& decoder, T* out,
+                        size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = Decode<T>(decoder);
+  }
+}
+
+// int and long items are varints which are bulk decoded with SIMD kernels.
+template <>
+inline void DecodeItems(tensorflow::atds::RawDecoder*& decoder, int* out,
+                        size_t n) {
+  decoder->decodeVarints(out, n);
+}
+
+template <>
+inline void DecodeItems(tensorflow::atds::RawDecoder*& decoder, long* out,
+                        size_t n) {
+  decoder->decodeVarints(out, n);
+}
+
+// Decodes `n` items of type T into every `stride`-th element of `out`.
+template <typename T>
+inline void DecodeStridedItems(avro::DecoderPtr& decoder, long* out, size_t n,
+                               size_t stride) {
+  for (size_t i = 0; i < n; i++) {
+    out[i * stride] = static_cast<long>(Decode<T>(decoder));
+  }
+}
+
+template <typename T>
+inline void DecodeStridedItems(tensorflow::atds::RawDecoder*& decoder,
+                               long* out, size_t n, size_t stride) {
+  // Items are bulk decoded into a small contiguous buffer and then scattered.
+  constexpr size_t kChunkSize = 256;
+  T chunk[kChunkSize];
+  while (n > 0) {
+    size_t k = std::min(n, kChunkSize);
+    DecodeItems(decoder, chunk, k);
+    for (size_t i = 0; i < k; i++) {
+      out[i * stride] = static_cast<long>(chunk[i]);
+    }
+    out += k * stride;
+    n -= k;
+  }
+}
+
 }  // namespace decoder_t
 }  // namespace avro
 
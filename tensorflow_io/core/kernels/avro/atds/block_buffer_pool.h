@@ -0,0 +1,116 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_BUFFER_POOL_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_BUFFER_POOL_H_
+
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+// A thread safe pool of block content buffers. Buffers are bucketed into power
+// of two size classes by their capacity so that a recycled buffer can be
+// handed out for any block of the same or a smaller size class without
+// reallocation.
+class BlockBufferPool {
+ public:
+  explicit BlockBufferPool(size_t max_buffers_per_class = 8)
+      : max_buffers_per_class_(max_buffers_per_class),
+        size_classes_(kNumSizeClasses) {}
+
+  // Returns a buffer whose size is `size`. The content of the buffer is
+  // uninitialized.
+  tstring Acquire(size_t size) TF_LOCKS_EXCLUDED(mu_) {
+    size_t size_class = CeilLog2(size);
+    {
+      mutex_lock l(mu_);
+      // Buffers in bucket k have a capacity of at least 2^k bytes.
+      for (size_t k = size_class; k < kNumSizeClasses; k++) {
+        auto& bucket = size_classes_[k];
+        if (!bucket.empty()) {
+          tstring buffer = std::move(bucket.back());
+          bucket.pop_back();
+          buffer.resize_uninitialized(size);
+          return buffer;
+        }
+      }
+    }
+    tstring buffer;
+    if (size_class < kNumSizeClasses) {
+      buffer.reserve(static_cast<size_t>(1) << size_class);
+    }
+    buffer.resize_uninitialized(size);
+    return buffer;
+  }
+
+  // Gives the buffer back to the pool. The buffer is dropped if its size class
+  // is already full.
+  void Release(tstring&& buffer) TF_LOCKS_EXCLUDED(mu_) {
+    size_t capacity = buffer.capacity();
+    if (capacity == 0) {
+      return;
+    }
+    size_t size_class = FloorLog2(capacity);
+    if (size_class >= kNumSizeClasses) {
+      return;
+    }
+    mutex_lock l(mu_);
+    auto& bucket = size_classes_[size_class];
+    if (bucket.size() < max_buffers_per_class_) {
+      bucket.emplace_back(std::move(buffer));
+    }
+  }
+
+  size_t NumPooledBuffers() TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    size_t total = 0;
+    for (auto& bucket : size_classes_) {
+      total += bucket.size();
+    }
+    return total;
+  }
+
+ private:
+  // Buffers larger than 2^kNumSizeClasses bytes are never pooled.
+  static constexpr size_t kNumSizeClasses = 32;
+
+  static size_t FloorLog2(size_t n) {
+    size_t log = 0;
+    while (n >>= 1) {
+      log++;
+    }
+    return log;
+  }
+
+  static size_t CeilLog2(size_t n) {
+    if (n <= 1) {
+      return 0;
+    }
+    return FloorLog2(n - 1) + 1;
+  }
+
+  const size_t max_buffers_per_class_;
+  mutex mu_;
+  std::vector<std::vector<tstring>> size_classes_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_BUFFER_POOL_H_
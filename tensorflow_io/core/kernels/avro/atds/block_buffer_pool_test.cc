@@ -0,0 +1,73 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/block_buffer_pool.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+TEST(BlockBufferPoolTest, AcquireReturnsRequestedSize) {
+  BlockBufferPool pool;
+  tstring buffer = pool.Acquire(1000);
+  EXPECT_EQ(1000, buffer.size());
+  EXPECT_GE(buffer.capacity(), 1024);
+}
+
+TEST(BlockBufferPoolTest, ReleasedBufferIsReused) {
+  BlockBufferPool pool;
+  tstring buffer = pool.Acquire(3000);
+  const char* data = buffer.data();
+  pool.Release(std::move(buffer));
+  EXPECT_EQ(1, pool.NumPooledBuffers());
+
+  // A smaller request in the same size class gets the recycled buffer.
+  tstring reused = pool.Acquire(2500);
+  EXPECT_EQ(2500, reused.size());
+  EXPECT_EQ(data, reused.data());
+  EXPECT_EQ(0, pool.NumPooledBuffers());
+}
+
+TEST(BlockBufferPoolTest, SmallBufferIsNotReusedForLargerRequest) {
+  BlockBufferPool pool;
+  pool.Release(pool.Acquire(100));
+  EXPECT_EQ(1, pool.NumPooledBuffers());
+
+  tstring buffer = pool.Acquire(10000);
+  EXPECT_EQ(10000, buffer.size());
+  EXPECT_EQ(1, pool.NumPooledBuffers());
+}
+
+TEST(BlockBufferPoolTest, SizeClassIsBounded) {
+  size_t max_buffers_per_class = 2;
+  BlockBufferPool pool(max_buffers_per_class);
+  for (size_t i = 0; i < 5; i++) {
+    pool.Release(pool.Acquire(4096));
+  }
+  EXPECT_EQ(1, pool.NumPooledBuffers());
+
+  std::vector<tstring> buffers;
+  for (size_t i = 0; i < 5; i++) {
+    buffers.emplace_back(pool.Acquire(4096));
+  }
+  for (auto& buffer : buffers) {
+    pool.Release(std::move(buffer));
+  }
+  EXPECT_EQ(max_buffers_per_class, pool.NumPooledBuffers());
+}
+
+}  // namespace data
+}  // namespace tensorflow
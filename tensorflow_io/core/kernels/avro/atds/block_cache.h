@@ -0,0 +1,273 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_CACHE_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "api/ValidSchema.hh"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+#include "tensorflow_io/core/kernels/avro/atds/avro_block_reader.h"
+
+namespace tensorflow {
+namespace data {
+
+// A cache of the Avro blocks of the files of an ATDSDataset as read, still
+// compressed, shared by the iterators of all its epochs. Blocks are held in
+// RAM up to `memory_bytes`, and within the process memory budget, then
+// spilled to a file in `spill_dir` if set, and are not cached otherwise.
+//
+// A file is read from the cache once the offsets of all its blocks are known
+// and all of them are cached, so that later epochs never open it again. As
+// these offsets are the ones ReadBlockOffsets returns, the blocks of a cached
+// file are shuffled the same way as those of a file read from storage.
+class BlockCache {
+ public:
+  BlockCache(Env* env, int64 memory_bytes, const string& spill_dir)
+      : env_(env), memory_bytes_(memory_bytes), spill_dir_(spill_dir) {}
+
+  ~BlockCache() {
+    mutex_lock l(mu_);
+    io::MemoryBudget::Global()->Release(kBudgetComponent, cached_bytes_);
+    if (spill_writer_ != nullptr) {
+      spill_writer_->Close().IgnoreError();
+      spill_reader_.reset();
+      env_->DeleteFile(spill_filename_).IgnoreError();
+    }
+  }
+
+  BlockCache(const BlockCache&) = delete;
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  // Caches `block`, read at `offset` of file `file_index`, and the offset of
+  // the block after it. Returns false if it fits neither in memory nor on
+  // disk.
+  bool Insert(size_t file_index, uint64 offset, uint64 next_offset,
+              const AvroBlock& block) TF_LOCKS_EXCLUDED(mu_) {
+    const size_t size = block.content.size();
+    mutex_lock l(mu_);
+    const Key key(file_index, offset);
+    if (entries_.count(key) > 0) {
+      return true;
+    }
+    Entry entry;
+    entry.object_count = block.object_count;
+    entry.byte_count = block.byte_count;
+    entry.codec = block.codec;
+    entry.next_offset = next_offset;
+    entry.size = size;
+    if (cached_bytes_ + static_cast<int64>(size) <= memory_bytes_ &&
+        io::MemoryBudget::Global()->TryReserve(kBudgetComponent, size)) {
+      entry.content = std::make_shared<tstring>(block.content);
+      cached_bytes_ += size;
+    } else {
+      if (!SpillLocked(block.content, &entry.spill_offset)) {
+        return false;
+      }
+      entry.spilled = true;
+      spilled_bytes_ += size;
+    }
+    entries_.emplace(key, std::move(entry));
+    return true;
+  }
+
+  // Records the offsets, in file order, of all the blocks of a file, and the
+  // schema of the file.
+  void SetFileBlocks(size_t file_index, const avro::ValidSchema& schema,
+                     std::vector<uint64> offsets) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    FileBlocks& file = files_[file_index];
+    file.schema = schema;
+    file.offsets = std::move(offsets);
+    file.complete = false;
+  }
+
+  // Returns whether all the blocks of a file are cached, with their offsets
+  // in file order and the schema of the file.
+  bool GetFileBlocks(size_t file_index, avro::ValidSchema* schema,
+                     std::vector<uint64>* offsets) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    auto it = files_.find(file_index);
+    if (it == files_.end()) {
+      return false;
+    }
+    FileBlocks& file = it->second;
+    if (!file.complete) {
+      for (uint64 offset : file.offsets) {
+        if (entries_.count(Key(file_index, offset)) == 0) {
+          return false;
+        }
+      }
+      file.complete = true;
+    }
+    *schema = file.schema;
+    *offsets = file.offsets;
+    return true;
+  }
+
+  // Reads the cached block at `offset` of file `file_index` to `block`, and
+  // the offset of the block after it to `next_offset`.
+  Status Lookup(size_t file_index, uint64 offset, AvroBlock* block,
+                uint64* next_offset) TF_LOCKS_EXCLUDED(mu_) {
+    std::shared_ptr<tstring> content;
+    uint64 spill_offset = 0;
+    size_t size = 0;
+    RandomAccessFile* spill_reader = nullptr;
+    {
+      mutex_lock l(mu_);
+      auto it = entries_.find(Key(file_index, offset));
+      if (it == entries_.end()) {
+        return errors::NotFound("Block at ", offset, " of file ", file_index,
+                                " is not cached.");
+      }
+      const Entry& entry = it->second;
+      block->object_count = entry.object_count;
+      block->byte_count = entry.byte_count;
+      block->codec = entry.codec;
+      *next_offset = entry.next_offset;
+      content = entry.content;
+      spill_offset = entry.spill_offset;
+      size = entry.size;
+      spill_reader = spill_reader_.get();
+    }
+    block->read_offset = 0;
+    block->num_decoded = 0;
+    block->num_to_decode = 0;
+    if (content != nullptr) {
+      block->content = *content;
+      return OkStatus();
+    }
+    // The spill file is only appended to, so the range of a spilled block is
+    // read without the lock.
+    block->content.resize_uninitialized(size);
+    StringPiece result;
+    TF_RETURN_IF_ERROR(spill_reader->Read(spill_offset, size, &result,
+                                          &block->content[0]));
+    if (result.size() != size) {
+      return errors::DataLoss("Short read of a spilled Avro block.");
+    }
+    if (result.data() != block->content.data()) {
+      memmove(&block->content[0], result.data(), size);
+    }
+    return OkStatus();
+  }
+
+  int64 cached_bytes() TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    return cached_bytes_;
+  }
+
+  int64 spilled_bytes() TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    return spilled_bytes_;
+  }
+
+ private:
+  // The component of the blocks cached in memory in the memory budget.
+  static constexpr char kBudgetComponent[] = "atds_block_cache";
+
+  using Key = std::pair<size_t, uint64>;
+
+  struct Entry {
+    int64_t object_count = 0;
+    int64_t byte_count = 0;
+    BlockCodec codec = NULL_CODEC;
+    uint64 next_offset = 0;
+    size_t size = 0;
+    // The content if held in memory, its offset in the spill file otherwise.
+    std::shared_ptr<tstring> content;
+    bool spilled = false;
+    uint64 spill_offset = 0;
+  };
+
+  struct FileBlocks {
+    avro::ValidSchema schema;
+    std::vector<uint64> offsets;
+    // Whether all the blocks at offsets were found cached.
+    bool complete = false;
+  };
+
+  // Appends `content` to the spill file, created on first use.
+  bool SpillLocked(const tstring& content, uint64* offset)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (spill_dir_.empty()) {
+      return false;
+    }
+    Status status;
+    if (spill_writer_ == nullptr) {
+      if (spill_failed_) {
+        return false;
+      }
+      spill_filename_ = io::JoinPath(
+          spill_dir_, strings::StrCat("atds_block_cache_", random::New64()));
+      status = env_->NewWritableFile(spill_filename_, &spill_writer_);
+      if (status.ok()) {
+        status = spill_writer_->Flush();
+      }
+      if (status.ok()) {
+        status = env_->NewRandomAccessFile(spill_filename_, &spill_reader_);
+      }
+      if (!status.ok()) {
+        LOG(WARNING) << "Unable to create the ATDS block cache spill file "
+                     << spill_filename_ << ": " << status;
+        spill_failed_ = true;
+        spill_reader_.reset();
+        spill_writer_.reset();
+        return false;
+      }
+    }
+    status = spill_writer_->Append(StringPiece(content.data(), content.size()));
+    if (status.ok()) {
+      status = spill_writer_->Flush();
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Unable to spill an Avro block to "
+                   << spill_filename_ << ": " << status;
+      return false;
+    }
+    *offset = spill_size_;
+    spill_size_ += content.size();
+    return true;
+  }
+
+  Env* const env_;
+  const int64 memory_bytes_;
+  const string spill_dir_;
+  mutex mu_;
+  std::map<Key, Entry> entries_ TF_GUARDED_BY(mu_);
+  std::unordered_map<size_t, FileBlocks> files_ TF_GUARDED_BY(mu_);
+  int64 cached_bytes_ TF_GUARDED_BY(mu_) = 0;
+  int64 spilled_bytes_ TF_GUARDED_BY(mu_) = 0;
+  string spill_filename_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> spill_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<RandomAccessFile> spill_reader_ TF_GUARDED_BY(mu_);
+  uint64 spill_size_ TF_GUARDED_BY(mu_) = 0;
+  bool spill_failed_ TF_GUARDED_BY(mu_) = false;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_BLOCK_CACHE_H_
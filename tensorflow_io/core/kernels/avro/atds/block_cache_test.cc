@@ -0,0 +1,102 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/block_cache.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+AvroBlock MakeBlock(int64_t object_count, const string& content) {
+  AvroBlock block;
+  block.object_count = object_count;
+  block.byte_count = content.size();
+  block.codec = DEFLATE_CODEC;
+  block.content = content;
+  return block;
+}
+
+void ExpectCached(BlockCache& cache, size_t file_index, uint64 offset,
+                  const AvroBlock& expected, uint64 expected_next_offset) {
+  AvroBlock block;
+  uint64 next_offset = 0;
+  TF_ASSERT_OK(cache.Lookup(file_index, offset, &block, &next_offset));
+  EXPECT_EQ(expected.object_count, block.object_count);
+  EXPECT_EQ(expected.byte_count, block.byte_count);
+  EXPECT_EQ(expected.codec, block.codec);
+  EXPECT_EQ(expected.content, block.content);
+  EXPECT_EQ(0, block.read_offset);
+  EXPECT_EQ(expected_next_offset, next_offset);
+}
+
+TEST(BlockCacheTest, BlocksAreHeldInMemory) {
+  BlockCache cache(Env::Default(), 1024, "");
+  AvroBlock first = MakeBlock(3, "first block");
+  AvroBlock second = MakeBlock(5, "second block");
+  EXPECT_TRUE(cache.Insert(0, 100, 120, first));
+  EXPECT_TRUE(cache.Insert(0, 120, 140, second));
+  EXPECT_EQ(first.content.size() + second.content.size(),
+            cache.cached_bytes());
+  EXPECT_EQ(0, cache.spilled_bytes());
+  ExpectCached(cache, 0, 100, first, 120);
+  ExpectCached(cache, 0, 120, second, 140);
+
+  AvroBlock block;
+  uint64 next_offset;
+  EXPECT_TRUE(errors::IsNotFound(cache.Lookup(1, 100, &block, &next_offset)));
+}
+
+TEST(BlockCacheTest, BlocksBeyondMemoryAreSpilled) {
+  BlockCache cache(Env::Default(), 16, testing::TmpDir());
+  AvroBlock first = MakeBlock(3, "0123456789");
+  AvroBlock second = MakeBlock(4, "abcdefghijklmnop");
+  AvroBlock third = MakeBlock(5, "qrstuvwxyz");
+  EXPECT_TRUE(cache.Insert(0, 10, 20, first));
+  EXPECT_TRUE(cache.Insert(0, 20, 30, second));
+  EXPECT_TRUE(cache.Insert(1, 10, 20, third));
+  EXPECT_EQ(first.content.size(), cache.cached_bytes());
+  EXPECT_EQ(second.content.size() + third.content.size(),
+            cache.spilled_bytes());
+  ExpectCached(cache, 0, 10, first, 20);
+  ExpectCached(cache, 0, 20, second, 30);
+  ExpectCached(cache, 1, 10, third, 20);
+}
+
+TEST(BlockCacheTest, BlocksBeyondMemoryAreDroppedWithoutSpillDir) {
+  BlockCache cache(Env::Default(), 16, "");
+  EXPECT_TRUE(cache.Insert(0, 10, 20, MakeBlock(3, "0123456789")));
+  EXPECT_FALSE(cache.Insert(0, 20, 30, MakeBlock(4, "abcdefghij")));
+  EXPECT_EQ(10, cache.cached_bytes());
+}
+
+TEST(BlockCacheTest, FileIsCompleteOnceAllBlocksAreCached) {
+  BlockCache cache(Env::Default(), 1024, "");
+  avro::ValidSchema schema;
+  std::vector<uint64> offsets;
+  EXPECT_FALSE(cache.GetFileBlocks(0, &schema, &offsets));
+
+  cache.SetFileBlocks(0, schema, {10, 20, 30});
+  EXPECT_TRUE(cache.Insert(0, 10, 20, MakeBlock(1, "a")));
+  EXPECT_TRUE(cache.Insert(0, 20, 30, MakeBlock(1, "b")));
+  EXPECT_FALSE(cache.GetFileBlocks(0, &schema, &offsets));
+
+  EXPECT_TRUE(cache.Insert(0, 30, 40, MakeBlock(1, "c")));
+  EXPECT_TRUE(cache.GetFileBlocks(0, &schema, &offsets));
+  EXPECT_EQ((std::vector<uint64>{10, 20, 30}), offsets);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include "api/Node.hh"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow_io/core/kernels/avro/atds/raw_decoder.h"
 #include "tensorflow_io/core/kernels/avro/atds/sparse_value_buffer.h"
 
 namespace tensorflow {
@@ -39,6 +40,8 @@ static const std::map<avro::Type, DataType> avro_to_tf_datatype = {
  * All decoder implementations must implement the operator overload '()'.
  * Decoders are invoked in a multithreaded context(controlled by
  * `num_parallel_calls`). Therefore the implementations must be threadsafe.
+ * The RawDecoder overload decodes straight from the decompressed block bytes
+ * and is used whenever the schema allows it.
  * TODO: Add static analysis to check thread-safety(BDP-7562)
  * */
 class DecoderBase {
@@ -48,6 +51,10 @@ class DecoderBase {
   virtual Status operator()(avro::DecoderPtr&, std::vector<Tensor>&,
                             sparse::ValueBuffer&,
                             std::vector<avro::GenericDatum>&, size_t) = 0;
+
+  virtual Status operator()(RawDecoder*&, std::vector<Tensor>&,
+                            sparse::ValueBuffer&,
+                            std::vector<avro::GenericDatum>&, size_t) = 0;
 };
 
 /*
@@ -16,11 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_DECOMPRESSION_HANDLER_H_
 #define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_DECOMPRESSION_HANDLER_H_
 
-#include <boost/crc.hpp>  // for boost::crc_32_type
+#include <algorithm>
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/random/mersenne_twister.hpp>
+#include <cstring>
 
 #include "api/Compiler.hh"
 #include "api/DataFile.hh"
@@ -31,15 +32,17 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow_io/core/kernels/avro/atds/avro_block_reader.h"
+#include "tensorflow_io/core/kernels/avro/atds/block_buffer_pool.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_codec.h"
 
-#ifdef SNAPPY_CODEC_AVAILABLE
-#include <snappy.h>
-#endif
 namespace tensorflow {
 namespace data {
 class DecompressionHandler {
  public:
-  DecompressionHandler() {}
+  // `pool` is not owned. If it is null, every decompressed block allocates a
+  // new buffer.
+  explicit DecompressionHandler(BlockBufferPool* pool = nullptr)
+      : pool_(pool) {}
 
   // Adapted from
   // https://github.com/apache/avro/blob/release-1.9.1/lang/c++/impl/DataFile.cc#L58
@@ -52,69 +55,117 @@ class DecompressionHandler {
 
 #ifdef SNAPPY_CODEC_AVAILABLE
   avro::InputStreamPtr decompressSnappyCodec(AvroBlock& block) {
-    boost::crc_32_type crc;
-    std::string uncompressed;
-    size_t len = block.content.size();
-    const auto& compressed = block.content;
-    int b1 = compressed[len - 4] & 0xFF;
-    int b2 = compressed[len - 3] & 0xFF;
-    int b3 = compressed[len - 2] & 0xFF;
-    int b4 = compressed[len - 1] & 0xFF;
-
-    uint32_t checksum = (b1 << 24) + (b2 << 16) + (b3 << 8) + (b4);
-    if (!snappy::Uncompress(compressed.data(), len - 4, &uncompressed)) {
-      throw avro::Exception(
-          "Snappy Compression reported an error when decompressing");
-    }
-    crc.process_bytes(uncompressed.data(), uncompressed.size());
-    uint32_t c = crc();
-    if (checksum != c) {
-      throw avro::Exception(
-          boost::format("Checksum did not match for Snappy compression: "
-                        "Expected: %1%, computed: %2%") %
-          checksum % c);
-    }
-    block.content = uncompressed;
-    block.byte_count = uncompressed.size();
-    block.codec = avro::NULL_CODEC;
-    uint8_t* dt =
-        reinterpret_cast<uint8_t*>(block.content.data() + block.read_offset);
-    return avro::memoryInputStream(dt,
-                                   block.content.size() - block.read_offset);
+    // The uncompressed length is read from the block.
+    tstring uncompressed = AcquireBuffer(0);
+    const tstring& compressed = block.content;
+    return ReplaceContent(block,
+                          DecompressSnappyBlock(compressed.data(),
+                                                compressed.size(),
+                                                &uncompressed),
+                          std::move(uncompressed));
   }
 #endif
 
   avro::InputStreamPtr decompressDeflateCodec(AvroBlock& block) {
-    boost::iostreams::filtering_istream stream;
-    stream.push(boost::iostreams::zlib_decompressor(get_zlib_params()));
-    stream.push(boost::iostreams::basic_array_source<char>(
-        block.content.data(), block.content.size()));
-    auto uncompressed = tstring();
-    auto reader = avro::nonSeekableIstreamInputStream(stream);
-    size_t n_data = 0;
-
-    const uint8_t* data = nullptr;
-    while (reader->next(&data, &n_data)) {
-      uncompressed.append((const char*)data, n_data);
+    size_t compressed_size = block.content.size();
+    tstring uncompressed =
+        AcquireBuffer(std::max(compressed_size * kDeflateRatioHint,
+                               static_cast<size_t>(kMinDeflateBufferSize)));
+    // The content is only read through const accessors, so that a view of
+    // in memory contents is not copied.
+    const tstring& compressed = block.content;
+    return ReplaceContent(
+        block,
+        DecompressDeflateBlock(compressed.data(), compressed_size,
+                               &uncompressed),
+        std::move(uncompressed));
+  }
+
+  avro::InputStreamPtr decompressZstandardCodec(AvroBlock& block) {
+    size_t compressed_size = block.content.size();
+    tstring uncompressed = AcquireBuffer(compressed_size * kZstandardRatioHint);
+    const tstring& compressed = block.content;
+    return ReplaceContent(
+        block,
+        DecompressZstandardBlock(compressed.data(), compressed_size,
+                                 &uncompressed),
+        std::move(uncompressed));
+  }
+
+  avro::InputStreamPtr decompressLz4Codec(AvroBlock& block) {
+    size_t compressed_size = block.content.size();
+    tstring uncompressed =
+        AcquireBuffer(std::max(compressed_size * kLz4RatioHint,
+                               static_cast<size_t>(kMinDeflateBufferSize)));
+    const tstring& compressed = block.content;
+    return ReplaceContent(
+        block,
+        DecompressLz4Block(compressed.data(), compressed_size, &uncompressed),
+        std::move(uncompressed));
+  }
+
+  avro::InputStreamPtr decompressNullCodec(AvroBlock& block) {
+    size_t offset = block.read_offset;
+    const tstring& content = block.content;
+    const uint8_t* data =
+        reinterpret_cast<const uint8_t*>(content.data() + offset);
+    size_t size = content.size() - offset;
+    return avro::memoryInputStream(data, size);
+  }
+
+  // Hands the content of a fully decoded block back to the pool.
+  void RecycleBlock(AvroBlock& block) {
+    if (block.pooled) {
+      ReleaseBuffer(std::move(block.content));
+      block.content = tstring();
+      block.pooled = false;
+    }
+  }
+
+ private:
+  static constexpr size_t kDeflateRatioHint = 4;
+  static constexpr size_t kMinDeflateBufferSize = 4096;
+  static constexpr size_t kZstandardRatioHint = 4;
+  static constexpr size_t kLz4RatioHint = 3;
+
+  tstring AcquireBuffer(size_t size) {
+    if (pool_ == nullptr) {
+      tstring buffer;
+      buffer.resize_uninitialized(size);
+      return buffer;
+    }
+    return pool_->Acquire(size);
+  }
+
+  void ReleaseBuffer(tstring&& buffer) {
+    if (pool_ != nullptr) {
+      pool_->Release(std::move(buffer));
+    }
+  }
+
+  // Swaps the decompressed content into the block and recycles the
+  // compressed content. Throws if the decompression failed.
+  avro::InputStreamPtr ReplaceContent(AvroBlock& block, const Status& status,
+                                      tstring&& content) {
+    if (!status.ok()) {
+      ReleaseBuffer(std::move(content));
+      throw avro::Exception(string(status.message()));
     }
-    block.content = uncompressed;
-    block.codec = avro::NULL_CODEC;
-    block.byte_count = uncompressed.size();
+    std::swap(block.content, content);
+    ReleaseBuffer(std::move(content));
+    block.pooled = pool_ != nullptr;
+    block.codec = NULL_CODEC;
+    block.byte_count = block.content.size();
     uint8_t* dt =
         reinterpret_cast<uint8_t*>(block.content.data() + block.read_offset);
     return avro::memoryInputStream(dt,
                                    block.content.size() - block.read_offset);
   }
 
-  avro::InputStreamPtr decompressNullCodec(AvroBlock& block) {
-    size_t offset = block.read_offset;
-    uint8_t* data = reinterpret_cast<uint8_t*>(block.content.data() + offset);
-    size_t size = block.content.size() - offset;
-    return avro::memoryInputStream(data, size);
-  }
+  BlockBufferPool* pool_;
 };
 
 }  // namespace data
 }  // namespace tensorflow
 
-#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_DECOMPRESSION_HANDLER_H_
\ No newline at end of file
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_DECOMPRESSION_HANDLER_H_
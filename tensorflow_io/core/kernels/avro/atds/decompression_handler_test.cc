@@ -0,0 +1,201 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/decompression_handler.h"
+
+#include "lz4frame.h"
+#include "tensorflow/core/platform/test.h"
+#include "zlib.h"
+#include "zstd.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+
+string MakeContent(size_t size) {
+  string content;
+  content.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    content.push_back('a' + static_cast<char>(i % 7));
+  }
+  return content;
+}
+
+AvroBlock MakeBlock(const string& compressed, BlockCodec codec) {
+  AvroBlock block;
+  block.object_count = 1;
+  block.num_to_decode = 0;
+  block.num_decoded = 0;
+  block.byte_count = compressed.size();
+  block.counts = 0;
+  block.content = tstring(compressed);
+  block.codec = codec;
+  block.read_offset = 0;
+  return block;
+}
+
+string DeflateCompress(const string& content) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+               Z_DEFAULT_STRATEGY);
+  string compressed(deflateBound(&zs, content.size()), '\0');
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+  zs.avail_in = content.size();
+  zs.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  zs.avail_out = compressed.size();
+  deflate(&zs, Z_FINISH);
+  compressed.resize(zs.total_out);
+  deflateEnd(&zs);
+  return compressed;
+}
+
+string ZstandardCompress(const string& content) {
+  string compressed(ZSTD_compressBound(content.size()), '\0');
+  size_t size = ZSTD_compress(&compressed[0], compressed.size(),
+                              content.data(), content.size(), 1);
+  compressed.resize(size);
+  return compressed;
+}
+
+// Compresses with the streaming API, which does not write the content size
+// to the frame header, as streaming writers do.
+string ZstandardCompressStream(const string& content) {
+  ZSTD_CStream* stream = ZSTD_createCStream();
+  ZSTD_initCStream(stream, 1);
+  string compressed(ZSTD_compressBound(content.size()), '\0');
+  ZSTD_inBuffer input = {content.data(), content.size(), 0};
+  ZSTD_outBuffer output = {&compressed[0], compressed.size(), 0};
+  ZSTD_compressStream(stream, &output, &input);
+  ZSTD_endStream(stream, &output);
+  ZSTD_freeCStream(stream);
+  compressed.resize(output.pos);
+  return compressed;
+}
+
+string Lz4Compress(const string& content) {
+  string compressed(LZ4F_compressFrameBound(content.size(), nullptr), '\0');
+  size_t size = LZ4F_compressFrame(&compressed[0], compressed.size(),
+                                   content.data(), content.size(), nullptr);
+  compressed.resize(size);
+  return compressed;
+}
+
+void AssertDecompressed(const string& expected, const AvroBlock& block) {
+  ASSERT_EQ(NULL_CODEC, block.codec);
+  ASSERT_EQ(expected.size(), block.byte_count);
+  ASSERT_EQ(expected, string(block.content.data(), block.content.size()));
+}
+
+}  // namespace
+
+TEST(DecompressionHandlerTest, DEFLATE) {
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  string content = MakeContent(100000);
+  AvroBlock block = MakeBlock(DeflateCompress(content), DEFLATE_CODEC);
+  handler.decompressDeflateCodec(block);
+  AssertDecompressed(content, block);
+  ASSERT_TRUE(block.pooled);
+}
+
+TEST(DecompressionHandlerTest, TRUNCATED_DEFLATE) {
+  DecompressionHandler handler;
+  string compressed = DeflateCompress(MakeContent(100000));
+  AvroBlock block =
+      MakeBlock(compressed.substr(0, compressed.size() / 2), DEFLATE_CODEC);
+  ASSERT_THROW(handler.decompressDeflateCodec(block), avro::Exception);
+}
+
+TEST(DecompressionHandlerTest, ZSTANDARD) {
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  string content = MakeContent(100000);
+  AvroBlock block = MakeBlock(ZstandardCompress(content), ZSTANDARD_CODEC);
+  handler.decompressZstandardCodec(block);
+  AssertDecompressed(content, block);
+}
+
+TEST(DecompressionHandlerTest, ZSTANDARD_STREAM) {
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  // Compresses far better than the ratio hint, so that the decoder holds
+  // output that does not fit the first buffer.
+  string content = MakeContent(1000000);
+  string compressed = ZstandardCompressStream(content);
+  ASSERT_EQ(ZSTD_CONTENTSIZE_UNKNOWN,
+            ZSTD_getFrameContentSize(compressed.data(), compressed.size()));
+  AvroBlock block = MakeBlock(compressed, ZSTANDARD_CODEC);
+  handler.decompressZstandardCodec(block);
+  AssertDecompressed(content, block);
+}
+
+TEST(DecompressionHandlerTest, TRUNCATED_ZSTANDARD_STREAM) {
+  DecompressionHandler handler;
+  string compressed = ZstandardCompressStream(MakeContent(100000));
+  AvroBlock block = MakeBlock(compressed.substr(0, compressed.size() - 4),
+                              ZSTANDARD_CODEC);
+  ASSERT_THROW(handler.decompressZstandardCodec(block), avro::Exception);
+}
+
+TEST(DecompressionHandlerTest, LZ4) {
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  string content = MakeContent(100000);
+  AvroBlock block = MakeBlock(Lz4Compress(content), LZ4_CODEC);
+  handler.decompressLz4Codec(block);
+  AssertDecompressed(content, block);
+}
+
+TEST(DecompressionHandlerTest, LZ4_WITHOUT_CONTENT_SIZE) {
+  DecompressionHandler handler;
+  // The frame has no content size and compresses far better than the
+  // ratio hint.
+  string content = MakeContent(1000000);
+  AvroBlock block = MakeBlock(Lz4Compress(content), LZ4_CODEC);
+  handler.decompressLz4Codec(block);
+  AssertDecompressed(content, block);
+}
+
+TEST(DecompressionHandlerTest, TRUNCATED_LZ4) {
+  DecompressionHandler handler;
+  string compressed = Lz4Compress(MakeContent(100000));
+  AvroBlock block =
+      MakeBlock(compressed.substr(0, compressed.size() / 2), LZ4_CODEC);
+  ASSERT_THROW(handler.decompressLz4Codec(block), avro::Exception);
+}
+
+TEST(DecompressionHandlerTest, RECYCLE_BLOCK) {
+  BlockBufferPool pool;
+  DecompressionHandler handler(&pool);
+  string content = MakeContent(4096);
+  AvroBlock block = MakeBlock(ZstandardCompress(content), ZSTANDARD_CODEC);
+  handler.decompressZstandardCodec(block);
+  // The compressed content was handed back to the pool.
+  size_t pooled = pool.NumPooledBuffers();
+  handler.RecycleBlock(block);
+  ASSERT_EQ(pooled + 1, pool.NumPooledBuffers());
+  ASSERT_FALSE(block.pooled);
+}
+
+TEST(DecompressionHandlerTest, CORRUPTED_ZSTANDARD) {
+  DecompressionHandler handler;
+  AvroBlock block = MakeBlock("not a zstandard frame", ZSTANDARD_CODEC);
+  ASSERT_THROW(handler.decompressZstandardCodec(block), avro::Exception);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -47,8 +47,8 @@ struct Metadata {
   size_t tensor_position;
 };
 
-template <typename T>
-inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, T** buf, int rank,
+template <typename T, typename Decoder>
+inline Status DecodeFixedLenArray(Decoder& decoder, T** buf, int rank,
                                   const PartialTensorShape& shape) {
   if (rank == 0) {
     *((*buf)++) = avro::decoder_t::Decode<T>(decoder);
@@ -64,9 +64,8 @@ inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, T** buf, int rank,
       if (TF_PREDICT_FALSE(number > size)) {
         return ShapeError(number, dim, shape);
       }
-      for (size_t i = 0; i < m; i++) {
-        *((*buf)++) = avro::decoder_t::Decode<T>(decoder);
-      }
+      avro::decoder_t::DecodeItems(decoder, *buf, m);
+      *buf += m;
     }
     if (TF_PREDICT_FALSE(number != size)) {
       return ShapeError(number, dim, shape);
@@ -80,7 +79,7 @@ inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, T** buf, int rank,
       return ShapeError(number, dim, shape);
     }
     for (size_t i = 0; i < m; i++) {
-      TF_RETURN_IF_ERROR(DecodeFixedLenArray<T>(decoder, buf, rank - 1, shape));
+      TF_RETURN_IF_ERROR(DecodeFixedLenArray(decoder, buf, rank - 1, shape));
     }
   }
   if (TF_PREDICT_FALSE(number != size)) {
@@ -89,15 +88,15 @@ inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, T** buf, int rank,
   return OkStatus();
 }
 
-// This template specification handles both byte and string.
+// This template overload handles both byte and string.
 // It assumes that avro decodeBytes and decodeString are both reading bytes into
 // uint8 arrays see:
 // https://github.com/apache/avro/blob/branch-1.9/lang/c%2B%2B/impl/BinaryDecoder.cc#L133
 // As long as that as that assumption holds a separate bytes implementation is
 // not required.
-template <>
-inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, tstring** buf,
-                                  int rank, const PartialTensorShape& shape) {
+template <typename Decoder>
+inline Status DecodeFixedLenArray(Decoder& decoder, tstring** buf, int rank,
+                                  const PartialTensorShape& shape) {
   std::string s;
   if (rank == 0) {
     decoder->decodeString(s);
@@ -131,8 +130,7 @@ inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, tstring** buf,
       return ShapeError(number, dim, shape);
     }
     for (size_t i = 0; i < m; i++) {
-      TF_RETURN_IF_ERROR(
-          DecodeFixedLenArray<tstring>(decoder, buf, rank - 1, shape));
+      TF_RETURN_IF_ERROR(DecodeFixedLenArray(decoder, buf, rank - 1, shape));
     }
   }
   if (TF_PREDICT_FALSE(number != size)) {
@@ -141,7 +139,12 @@ inline Status DecodeFixedLenArray(avro::DecoderPtr& decoder, tstring** buf,
   return OkStatus();
 }
 
-template <typename T>
+// Rank is known at schema initialization time. Scalar and 1D features, which
+// are the bulk of wide schemas, get a decoder with the rank fixed at compile
+// time so that the rank branches in DecodeFixedLenArray fold away.
+constexpr int kDynamicRank = -1;
+
+template <typename T, int Rank = kDynamicRank>
 class FeatureDecoder : public DecoderBase {
  public:
   explicit FeatureDecoder(const Metadata& metadata)
@@ -152,17 +155,47 @@ class FeatureDecoder : public DecoderBase {
                     sparse::ValueBuffer& buffer,
                     std::vector<avro::GenericDatum>& skipped_data,
                     size_t offset) {
+    return Decode(decoder, dense_tensors, offset);
+  }
+
+  Status operator()(RawDecoder*& decoder, std::vector<Tensor>& dense_tensors,
+                    sparse::ValueBuffer& buffer,
+                    std::vector<avro::GenericDatum>& skipped_data,
+                    size_t offset) {
+    return Decode(decoder, dense_tensors, offset);
+  }
+
+ private:
+  template <typename Decoder>
+  inline Status Decode(Decoder& decoder, std::vector<Tensor>& dense_tensors,
+                       size_t offset) {
     auto size = metadata_.shape.num_elements();
     auto& tensor = dense_tensors[metadata_.tensor_position];
     T* buf = reinterpret_cast<T*>(tensor.data()) + offset * size;
-    return DecodeFixedLenArray<T>(decoder, &buf, rank_, metadata_.shape);
+    int rank = Rank == kDynamicRank ? rank_ : Rank;
+    return DecodeFixedLenArray(decoder, &buf, rank, metadata_.shape);
   }
 
- private:
   const Metadata& metadata_;
   const int rank_;
 };
 
+template <typename T>
+inline std::unique_ptr<DecoderBase> CreateRankedFeatureDecoder(
+    const Metadata& metadata) {
+  switch (metadata.shape.dims()) {
+    case 0: {
+      return std::make_unique<FeatureDecoder<T, 0>>(metadata);
+    }
+    case 1: {
+      return std::make_unique<FeatureDecoder<T, 1>>(metadata);
+    }
+    default: {
+      return std::make_unique<FeatureDecoder<T>>(metadata);
+    }
+  }
+}
+
 }  // namespace dense
 
 template <>
@@ -170,25 +203,22 @@ inline std::unique_ptr<DecoderBase> CreateFeatureDecoder(
     const avro::NodePtr& node, const dense::Metadata& metadata) {
   switch (metadata.dtype) {
     case DT_INT32: {
-      return std::move(std::make_unique<dense::FeatureDecoder<int>>(metadata));
+      return dense::CreateRankedFeatureDecoder<int>(metadata);
     }
     case DT_INT64: {
-      return std::move(std::make_unique<dense::FeatureDecoder<long>>(metadata));
+      return dense::CreateRankedFeatureDecoder<long>(metadata);
     }
     case DT_FLOAT: {
-      return std::move(
-          std::make_unique<dense::FeatureDecoder<float>>(metadata));
+      return dense::CreateRankedFeatureDecoder<float>(metadata);
     }
     case DT_DOUBLE: {
-      return std::move(
-          std::make_unique<dense::FeatureDecoder<double>>(metadata));
+      return dense::CreateRankedFeatureDecoder<double>(metadata);
     }
     case DT_STRING: {
-      return std::move(
-          std::make_unique<dense::FeatureDecoder<tstring>>(metadata));
+      return dense::CreateRankedFeatureDecoder<tstring>(metadata);
     }
     case DT_BOOL: {
-      return std::move(std::make_unique<dense::FeatureDecoder<bool>>(metadata));
+      return dense::CreateRankedFeatureDecoder<bool>(metadata);
     }
     default: {
       TypeNotSupportedAbort(metadata.dtype);
@@ -64,6 +64,18 @@ void DenseDecoderTest(const T& values, DataType dtype,
   ASSERT_TRUE(decode_status.ok());
   const Tensor tensor = dense_tensors[pos];
   AssertTensorValues(tensor, values);
+
+  ASSERT_TRUE(atds_decoder.SupportsRawDecoding());
+  auto bytes = avro::snapshot(*out_stream);
+  RawDecoder raw(bytes->data(), bytes->size());
+  RawDecoder* raw_decoder = &raw;
+  std::vector<Tensor> raw_dense_tensors;
+  raw_dense_tensors.emplace_back(dtype, TensorShape(shape));
+  decode_status = atds_decoder.DecodeATDSDatum(
+      raw_decoder, raw_dense_tensors, buffer, skipped_data, offset);
+  ASSERT_TRUE(decode_status.ok());
+  ASSERT_EQ(bytes->size(), raw.byteCount());
+  AssertTensorValues(raw_dense_tensors[pos], values);
 }
 
 TEST(DenseDecoderTest, DT_INT32_scalar) {
@@ -194,5 +194,14 @@ Status VariedSchemaNotSupportedError(const string& expected_schema,
       next_filename, "\n", expected_schema, "\n != \n", varied_schema));
 }
 
+Status BlockDecompressionError(const string& reason) {
+  return errors::DataLoss(
+      strings::StrCat("Failed to decompress Avro block. Cause: ", reason));
+}
+
+Status TruncatedDatumError() {
+  return errors::DataLoss("Avro datum extends past the end of its block.");
+}
+
 }  // namespace atds
 }  // namespace tensorflow
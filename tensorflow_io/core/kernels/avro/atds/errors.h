@@ -74,6 +74,10 @@ Status VariedSchemaNotSupportedError(const string& expected_schema,
                                      const string& varied_schema,
                                      const string& next_filename);
 
+Status BlockDecompressionError(const string& reason);
+
+Status TruncatedDatumError();
+
 }  // namespace atds
 }  // namespace tensorflow
 
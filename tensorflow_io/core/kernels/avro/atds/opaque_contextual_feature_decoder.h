@@ -19,6 +19,7 @@ limitations under the License.
 #include "api/Decoder.hh"
 #include "api/Generic.hh"
 #include "api/Specific.hh"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow_io/core/kernels/avro/atds/decoder_base.h"
 
 namespace tensorflow {
@@ -27,7 +28,8 @@ namespace opaque_contextual {
 
 class FeatureDecoder : public DecoderBase {
  public:
-  explicit FeatureDecoder(size_t datum_index) : datum_index_(datum_index) {}
+  explicit FeatureDecoder(size_t datum_index, const avro::NodePtr& node)
+      : datum_index_(datum_index), node_(node) {}
 
   Status operator()(avro::DecoderPtr& decoder,
                     std::vector<Tensor>& dense_tensors,
@@ -38,8 +40,21 @@ class FeatureDecoder : public DecoderBase {
     return OkStatus();
   }
 
+  // The raw path skips over the column instead of materializing the datum.
+  Status operator()(RawDecoder*& decoder, std::vector<Tensor>& dense_tensors,
+                    sparse::ValueBuffer& buffer,
+                    std::vector<avro::GenericDatum>& skipped_data,
+                    size_t offset) {
+    if (TF_PREDICT_FALSE(!decoder->Skip(node_))) {
+      return errors::Unimplemented("Cannot skip Avro type ",
+                                   avro::toString(node_->type()));
+    }
+    return OkStatus();
+  }
+
  private:
   const size_t datum_index_;
+  const avro::NodePtr node_;
 };
 
 }  // namespace opaque_contextual
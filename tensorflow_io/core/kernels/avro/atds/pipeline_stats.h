@@ -0,0 +1,162 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_PIPELINE_STATS_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_PIPELINE_STATS_H_
+
+#include <atomic>
+#include <string>
+
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/strcat.h"
+
+namespace tensorflow {
+namespace data {
+
+// Process wide counters of all ATDSDataset iterators, labeled by the name of
+// the counter, e.g. /tensorflow/io/atds/stage_counts{name="bytes_read"}.
+inline monitoring::Counter<1>* AtdsStageCounts() {
+  static auto* counter = monitoring::Counter<1>::New(
+      "/tensorflow/io/atds/stage_counts",
+      "Bytes, blocks and records processed by the stages of ATDSDataset.",
+      "name");
+  return counter;
+}
+
+inline monitoring::Counter<1>* AtdsStageMicros() {
+  static auto* counter = monitoring::Counter<1>::New(
+      "/tensorflow/io/atds/stage_micros",
+      "Time in microseconds spent in the stages of ATDSDataset.", "stage");
+  return counter;
+}
+
+// Per-stage statistics of an ATDSDataset iterator. The reader, decompression
+// and decode threads record into it concurrently. Every record is forwarded
+// to the process wide monitoring counters as well.
+class PipelineStats {
+ public:
+  struct Snapshot {
+    uint64 bytes_read = 0;
+    uint64 blocks_read = 0;
+    uint64 blocks_decompressed = 0;
+    uint64 records_decoded = 0;
+    uint64 decompress_micros = 0;
+    uint64 decode_micros = 0;
+    uint64 wait_for_data_micros = 0;
+    uint64 fill_sparse_micros = 0;
+  };
+
+  PipelineStats()
+      : bytes_read_cell_(AtdsStageCounts()->GetCell("bytes_read")),
+        blocks_read_cell_(AtdsStageCounts()->GetCell("blocks_read")),
+        blocks_decompressed_cell_(
+            AtdsStageCounts()->GetCell("blocks_decompressed")),
+        records_decoded_cell_(AtdsStageCounts()->GetCell("records_decoded")),
+        decompress_micros_cell_(AtdsStageMicros()->GetCell("decompress")),
+        decode_micros_cell_(AtdsStageMicros()->GetCell("decode")),
+        wait_for_data_micros_cell_(
+            AtdsStageMicros()->GetCell("wait_for_data")),
+        fill_sparse_micros_cell_(AtdsStageMicros()->GetCell("fill_sparse")) {}
+
+  void RecordBlockRead(uint64 bytes) {
+    Add(bytes_read_, bytes_read_cell_, bytes);
+    Add(blocks_read_, blocks_read_cell_, 1);
+  }
+
+  void RecordBlockDecompressed(uint64 micros) {
+    Add(blocks_decompressed_, blocks_decompressed_cell_, 1);
+    Add(decompress_micros_, decompress_micros_cell_, micros);
+  }
+
+  void RecordRecordsDecoded(uint64 records, uint64 micros) {
+    Add(records_decoded_, records_decoded_cell_, records);
+    Add(decode_micros_, decode_micros_cell_, micros);
+  }
+
+  void RecordWaitForData(uint64 micros) {
+    Add(wait_for_data_micros_, wait_for_data_micros_cell_, micros);
+  }
+
+  void RecordFillSparse(uint64 micros) {
+    Add(fill_sparse_micros_, fill_sparse_micros_cell_, micros);
+  }
+
+  Snapshot GetSnapshot() const {
+    Snapshot snapshot;
+    snapshot.bytes_read = bytes_read_.load(std::memory_order_relaxed);
+    snapshot.blocks_read = blocks_read_.load(std::memory_order_relaxed);
+    snapshot.blocks_decompressed =
+        blocks_decompressed_.load(std::memory_order_relaxed);
+    snapshot.records_decoded =
+        records_decoded_.load(std::memory_order_relaxed);
+    snapshot.decompress_micros =
+        decompress_micros_.load(std::memory_order_relaxed);
+    snapshot.decode_micros = decode_micros_.load(std::memory_order_relaxed);
+    snapshot.wait_for_data_micros =
+        wait_for_data_micros_.load(std::memory_order_relaxed);
+    snapshot.fill_sparse_micros =
+        fill_sparse_micros_.load(std::memory_order_relaxed);
+    return snapshot;
+  }
+
+  // Average time of a stage per item, zero if nothing was recorded.
+  static double PerItem(uint64 micros, uint64 items) {
+    return items == 0 ? 0 : static_cast<double>(micros) / items;
+  }
+
+  std::string DebugString() const {
+    Snapshot s = GetSnapshot();
+    return strings::StrCat(
+        "bytes read: ", s.bytes_read, ", blocks read: ", s.blocks_read,
+        ", blocks decompressed: ", s.blocks_decompressed,
+        ", records decoded: ", s.records_decoded,
+        ", decompression time per block (us): ",
+        PerItem(s.decompress_micros, s.blocks_decompressed),
+        ", decode time per record (us): ",
+        PerItem(s.decode_micros, s.records_decoded),
+        ", wait for data time (us): ", s.wait_for_data_micros,
+        ", sparse fill time (us): ", s.fill_sparse_micros);
+  }
+
+ private:
+  static void Add(std::atomic<uint64>& value, monitoring::CounterCell* cell,
+                  uint64 delta) {
+    value.fetch_add(delta, std::memory_order_relaxed);
+    cell->IncrementBy(static_cast<int64>(delta));
+  }
+
+  std::atomic<uint64> bytes_read_{0};
+  std::atomic<uint64> blocks_read_{0};
+  std::atomic<uint64> blocks_decompressed_{0};
+  std::atomic<uint64> records_decoded_{0};
+  std::atomic<uint64> decompress_micros_{0};
+  std::atomic<uint64> decode_micros_{0};
+  std::atomic<uint64> wait_for_data_micros_{0};
+  std::atomic<uint64> fill_sparse_micros_{0};
+
+  monitoring::CounterCell* const bytes_read_cell_;
+  monitoring::CounterCell* const blocks_read_cell_;
+  monitoring::CounterCell* const blocks_decompressed_cell_;
+  monitoring::CounterCell* const records_decoded_cell_;
+  monitoring::CounterCell* const decompress_micros_cell_;
+  monitoring::CounterCell* const decode_micros_cell_;
+  monitoring::CounterCell* const wait_for_data_micros_cell_;
+  monitoring::CounterCell* const fill_sparse_micros_cell_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_PIPELINE_STATS_H_
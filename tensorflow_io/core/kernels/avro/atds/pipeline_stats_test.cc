@@ -0,0 +1,68 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/pipeline_stats.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+TEST(PipelineStatsTest, RecordStages) {
+  PipelineStats stats;
+  stats.RecordBlockRead(100);
+  stats.RecordBlockRead(50);
+  stats.RecordBlockDecompressed(30);
+  stats.RecordRecordsDecoded(10, 40);
+  stats.RecordRecordsDecoded(6, 8);
+  stats.RecordWaitForData(7);
+  stats.RecordFillSparse(3);
+
+  PipelineStats::Snapshot s = stats.GetSnapshot();
+  EXPECT_EQ(150, s.bytes_read);
+  EXPECT_EQ(2, s.blocks_read);
+  EXPECT_EQ(1, s.blocks_decompressed);
+  EXPECT_EQ(30, s.decompress_micros);
+  EXPECT_EQ(16, s.records_decoded);
+  EXPECT_EQ(48, s.decode_micros);
+  EXPECT_EQ(7, s.wait_for_data_micros);
+  EXPECT_EQ(3, s.fill_sparse_micros);
+  EXPECT_DOUBLE_EQ(3.0, PipelineStats::PerItem(s.decode_micros,
+                                               s.records_decoded));
+  EXPECT_DOUBLE_EQ(0.0, PipelineStats::PerItem(10, 0));
+}
+
+TEST(PipelineStatsTest, ExportToMonitoring) {
+  monitoring::CounterCell* bytes_read =
+      AtdsStageCounts()->GetCell("bytes_read");
+  monitoring::CounterCell* wait_for_data =
+      AtdsStageMicros()->GetCell("wait_for_data");
+  int64 bytes_read_before = bytes_read->value();
+  int64 wait_for_data_before = wait_for_data->value();
+
+  // Counters are shared by all iterators of the process.
+  PipelineStats first, second;
+  first.RecordBlockRead(10);
+  second.RecordBlockRead(20);
+  second.RecordWaitForData(5);
+
+  EXPECT_EQ(30, bytes_read->value() - bytes_read_before);
+  EXPECT_EQ(5, wait_for_data->value() - wait_for_data_before);
+  EXPECT_EQ(10, first.GetSnapshot().bytes_read);
+  EXPECT_EQ(20, second.GetSnapshot().bytes_read);
+}
+
+}  // namespace data
+}  // namespace tensorflow
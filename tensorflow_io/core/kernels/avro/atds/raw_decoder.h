@@ -0,0 +1,265 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_RAW_DECODER_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_RAW_DECODER_H_
+
+#include <cstring>
+#include <string>
+
+#include "api/Node.hh"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow_io/core/kernels/avro/atds/varint_decoder.h"
+
+namespace tensorflow {
+namespace atds {
+
+/*
+ * RawDecoder decodes Avro binary encoded values directly from a contiguous
+ * decompressed block. Unlike avro::Decoder, all reads are non-virtual and
+ * inlined into the feature decoders. Method names mirror avro::Decoder so that
+ * the templated decode functions can run on either decoder.
+ *
+ * Reads past the end of the buffer do not throw. They return zero values and
+ * mark the decoder as failed, which callers check with ok() once per record.
+ * */
+class RawDecoder {
+ public:
+  RawDecoder(const uint8_t* data, size_t size)
+      : begin_(data), pos_(data), end_(data + size), ok_(true) {}
+
+  int32_t decodeInt() { return static_cast<int32_t>(decodeLong()); }
+
+  int64_t decodeLong() {
+    uint64_t n = ReadVarint();
+    return static_cast<int64_t>((n >> 1) ^ -(n & 1));
+  }
+
+  float decodeFloat() {
+    float value = 0;
+    ReadFixed(&value, sizeof(value));
+    return value;
+  }
+
+  double decodeDouble() {
+    double value = 0;
+    ReadFixed(&value, sizeof(value));
+    return value;
+  }
+
+  bool decodeBool() {
+    if (TF_PREDICT_FALSE(pos_ >= end_)) {
+      ok_ = false;
+      return false;
+    }
+    return *pos_++ != 0;
+  }
+
+  void decodeString(std::string& value) {
+    size_t len = DecodeLength();
+    value.assign(reinterpret_cast<const char*>(pos_), len);
+    pos_ += len;
+  }
+
+  // Bulk decodes `n` int or long items of an array block.
+  template <typename T>
+  void decodeVarints(T* values, size_t n) {
+    const uint8_t* pos = DecodeZigZagVarints(pos_, end_, values, n);
+    if (TF_PREDICT_FALSE(pos == nullptr)) {
+      ok_ = false;
+      pos_ = end_;
+      return;
+    }
+    pos_ = pos;
+  }
+
+  size_t decodeUnionIndex() { return static_cast<size_t>(decodeLong()); }
+
+  size_t arrayStart() { return DecodeBlockCount(); }
+
+  size_t arrayNext() { return DecodeBlockCount(); }
+
+  // Skips a value of the given schema. Returns false for schemas that can not
+  // be skipped without resolving named types.
+  bool Skip(const avro::NodePtr& node) {
+    switch (node->type()) {
+      case avro::AVRO_NULL:
+        return true;
+      case avro::AVRO_BOOL:
+        SkipBytes(1);
+        return true;
+      case avro::AVRO_INT:
+      case avro::AVRO_LONG:
+      case avro::AVRO_ENUM:
+        ReadVarint();
+        return true;
+      case avro::AVRO_FLOAT:
+        SkipBytes(sizeof(float));
+        return true;
+      case avro::AVRO_DOUBLE:
+        SkipBytes(sizeof(double));
+        return true;
+      case avro::AVRO_STRING:
+      case avro::AVRO_BYTES:
+        SkipBytes(DecodeLength());
+        return true;
+      case avro::AVRO_FIXED:
+        SkipBytes(node->fixedSize());
+        return true;
+      case avro::AVRO_RECORD:
+        for (size_t i = 0; i < node->leaves(); i++) {
+          if (!Skip(node->leafAt(i))) {
+            return false;
+          }
+        }
+        return true;
+      case avro::AVRO_ARRAY:
+        return SkipBlocks(node->leafAt(0), nullptr);
+      case avro::AVRO_MAP:
+        return SkipBlocks(node->leafAt(1), node->leafAt(0));
+      case avro::AVRO_UNION: {
+        size_t index = decodeUnionIndex();
+        if (TF_PREDICT_FALSE(index >= node->leaves())) {
+          ok_ = false;
+          return true;
+        }
+        return Skip(node->leafAt(index));
+      }
+      default:
+        return false;
+    }
+  }
+
+  // Returns true if Skip can handle every value of the given schema.
+  static bool CanSkip(const avro::NodePtr& node) {
+    switch (node->type()) {
+      case avro::AVRO_SYMBOLIC:
+        return false;
+      case avro::AVRO_RECORD:
+      case avro::AVRO_ARRAY:
+      case avro::AVRO_MAP:
+      case avro::AVRO_UNION:
+        for (size_t i = 0; i < node->leaves(); i++) {
+          if (!CanSkip(node->leafAt(i))) {
+            return false;
+          }
+        }
+        return true;
+      default:
+        return true;
+    }
+  }
+
+  bool ok() const { return ok_; }
+
+  size_t byteCount() const { return static_cast<size_t>(pos_ - begin_); }
+
+ private:
+  uint64_t ReadVarint() {
+    uint64_t result = 0;
+    int shift = 0;
+    while (TF_PREDICT_TRUE(pos_ < end_) && shift < 64) {
+      uint8_t b = *pos_++;
+      result |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (TF_PREDICT_TRUE((b & 0x80) == 0)) {
+        return result;
+      }
+      shift += 7;
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  void ReadFixed(void* value, size_t size) {
+    if (TF_PREDICT_FALSE(static_cast<size_t>(end_ - pos_) < size)) {
+      ok_ = false;
+      pos_ = end_;
+      return;
+    }
+    std::memcpy(value, pos_, size);
+    pos_ += size;
+  }
+
+  void SkipBytes(size_t size) {
+    if (TF_PREDICT_FALSE(static_cast<size_t>(end_ - pos_) < size)) {
+      ok_ = false;
+      pos_ = end_;
+      return;
+    }
+    pos_ += size;
+  }
+
+  size_t DecodeLength() {
+    int64_t len = decodeLong();
+    if (TF_PREDICT_FALSE(len < 0 || static_cast<uint64_t>(len) >
+                                        static_cast<uint64_t>(end_ - pos_))) {
+      ok_ = false;
+      pos_ = end_;
+      return 0;
+    }
+    return static_cast<size_t>(len);
+  }
+
+  // Array and map blocks start with an item count. A negative count is
+  // followed by the block size in bytes.
+  size_t DecodeBlockCount() {
+    int64_t count = decodeLong();
+    if (count < 0) {
+      decodeLong();
+      count = -count;
+    }
+    // Every item takes at least one byte, so a larger count means the block
+    // is corrupted.
+    if (TF_PREDICT_FALSE(static_cast<uint64_t>(count) >
+                         static_cast<uint64_t>(end_ - pos_))) {
+      ok_ = false;
+      pos_ = end_;
+      return 0;
+    }
+    return static_cast<size_t>(count);
+  }
+
+  bool SkipBlocks(const avro::NodePtr& item, const avro::NodePtr& key) {
+    while (true) {
+      int64_t count = decodeLong();
+      if (count == 0 || !ok_) {
+        return true;
+      }
+      if (count < 0) {
+        // The block size is known, skip the whole block at once.
+        SkipBytes(static_cast<size_t>(decodeLong()));
+        continue;
+      }
+      for (int64_t i = 0; i < count && ok_; i++) {
+        if (key != nullptr && !Skip(key)) {
+          return false;
+        }
+        if (!Skip(item)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  const uint8_t* begin_;
+  const uint8_t* pos_;
+  const uint8_t* end_;
+  bool ok_;
+};
+
+}  // namespace atds
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_RAW_DECODER_H_
@@ -0,0 +1,155 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/raw_decoder.h"
+
+#include <functional>
+
+#include "api/Compiler.hh"
+#include "api/Encoder.hh"
+#include "api/Stream.hh"
+#include "api/ValidSchema.hh"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace atds {
+
+namespace {
+
+std::shared_ptr<std::vector<uint8_t>> Encode(
+    const std::function<void(avro::Encoder&)>& write) {
+  avro::EncoderPtr encoder = avro::binaryEncoder();
+  avro::OutputStreamPtr out_stream = avro::memoryOutputStream();
+  encoder->init(*out_stream);
+  write(*encoder);
+  encoder->flush();
+  return avro::snapshot(*out_stream);
+}
+
+}  // namespace
+
+TEST(RawDecoderTest, Primitives) {
+  std::vector<int64_t> longs = {0,   -1,         1,         -64,
+                                64,  1234567890, INT64_MIN, INT64_MAX};
+  auto bytes = Encode([&](avro::Encoder& e) {
+    for (int64_t v : longs) {
+      e.encodeLong(v);
+    }
+    e.encodeInt(-7);
+    e.encodeFloat(1.5f);
+    e.encodeDouble(-2.25);
+    e.encodeBool(true);
+    e.encodeString("LinkedIn");
+    e.encodeUnionIndex(1);
+  });
+
+  RawDecoder decoder(bytes->data(), bytes->size());
+  for (int64_t v : longs) {
+    EXPECT_EQ(v, decoder.decodeLong());
+  }
+  EXPECT_EQ(-7, decoder.decodeInt());
+  EXPECT_EQ(1.5f, decoder.decodeFloat());
+  EXPECT_EQ(-2.25, decoder.decodeDouble());
+  EXPECT_TRUE(decoder.decodeBool());
+  std::string s;
+  decoder.decodeString(s);
+  EXPECT_EQ("LinkedIn", s);
+  EXPECT_EQ(1, decoder.decodeUnionIndex());
+  EXPECT_TRUE(decoder.ok());
+  EXPECT_EQ(bytes->size(), decoder.byteCount());
+}
+
+TEST(RawDecoderTest, ArrayBlocks) {
+  auto bytes = Encode([](avro::Encoder& e) {
+    e.arrayStart();
+    e.setItemCount(2);
+    e.startItem();
+    e.encodeInt(1);
+    e.startItem();
+    e.encodeInt(2);
+    e.setItemCount(1);
+    e.startItem();
+    e.encodeInt(3);
+    e.arrayEnd();
+  });
+
+  RawDecoder decoder(bytes->data(), bytes->size());
+  std::vector<int> values;
+  for (size_t m = decoder.arrayStart(); m != 0; m = decoder.arrayNext()) {
+    for (size_t i = 0; i < m; i++) {
+      values.push_back(decoder.decodeInt());
+    }
+  }
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), values);
+  EXPECT_TRUE(decoder.ok());
+}
+
+TEST(RawDecoderTest, Truncated) {
+  auto bytes = Encode([](avro::Encoder& e) { e.encodeString("abcdef"); });
+
+  RawDecoder decoder(bytes->data(), bytes->size() - 1);
+  std::string s;
+  decoder.decodeString(s);
+  EXPECT_FALSE(decoder.ok());
+  EXPECT_EQ(0, decoder.decodeLong());
+}
+
+TEST(RawDecoderTest, Skip) {
+  avro::ValidSchema schema = avro::compileJsonSchemaFromString(
+      R"({"type": "record", "name": "r", "fields": [
+            {"name": "a", "type": "long"},
+            {"name": "b", "type": {"type": "array", "items": "string"}},
+            {"name": "c", "type": {"type": "map", "values": "float"}},
+            {"name": "d", "type": ["null", "double"]},
+            {"name": "e", "type": {"type": "fixed", "name": "f", "size": 3}}
+          ]})");
+  auto bytes = Encode([](avro::Encoder& e) {
+    e.encodeLong(300);
+    e.arrayStart();
+    e.setItemCount(1);
+    e.startItem();
+    e.encodeString("abc");
+    e.arrayEnd();
+    e.mapStart();
+    e.setItemCount(1);
+    e.startItem();
+    e.encodeString("key");
+    e.encodeFloat(0.5f);
+    e.mapEnd();
+    e.encodeUnionIndex(1);
+    e.encodeDouble(1.0);
+    std::vector<uint8_t> fixed = {1, 2, 3};
+    e.encodeFixed(fixed);
+    e.encodeLong(-9);
+  });
+
+  ASSERT_TRUE(RawDecoder::CanSkip(schema.root()));
+  RawDecoder decoder(bytes->data(), bytes->size());
+  ASSERT_TRUE(decoder.Skip(schema.root()));
+  EXPECT_EQ(-9, decoder.decodeLong());
+  EXPECT_TRUE(decoder.ok());
+  EXPECT_EQ(bytes->size(), decoder.byteCount());
+}
+
+TEST(RawDecoderTest, RecursiveSchemaCannotBeSkipped) {
+  avro::ValidSchema schema = avro::compileJsonSchemaFromString(
+      R"({"type": "record", "name": "node", "fields": [
+            {"name": "next", "type": ["null", "node"]}
+          ]})");
+  EXPECT_FALSE(RawDecoder::CanSkip(schema.root()));
+}
+
+}  // namespace atds
+}  // namespace tensorflow
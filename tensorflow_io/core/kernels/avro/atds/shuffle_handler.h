@@ -21,6 +21,8 @@ limitations under the License.
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow_io/core/kernels/avro/atds/avro_block_reader.h"
 
 namespace tensorflow {
@@ -28,10 +30,63 @@ namespace data {
 
 class ShuffleHandler {
  public:
-  ShuffleHandler(mutex* mu) {
+  // Generator streams derived from the epoch seed. Block order streams start at
+  // kBlockOrderStream plus the file index.
+  static constexpr uint64 kFileOrderStream = 0;
+  static constexpr uint64 kBlockOrderStream = 1;
+  static constexpr uint64 kSamplingStream = ~uint64{0};
+
+  // A negative `seed` draws fresh random seeds. Otherwise all generators are
+  // derived from `seed` and `epoch`, so that an epoch is shuffled identically
+  // across runs.
+  ShuffleHandler(mutex* mu, int64 seed = -1, int64 epoch = 0) {
     mu_ = mu;
+    deterministic_ = seed >= 0;
+    epoch_seed_ = deterministic_ ? Hash64Combine(seed, epoch) : random::New64();
     ResetRngs();
   }
+
+  bool deterministic() const { return deterministic_; }
+
+  // Seeds and position of the generators, saved with the iterator.
+  struct State {
+    bool deterministic;
+    uint64 epoch_seed;
+    int64 seed;
+    int64 seed2;
+    int64 num_random_samples;
+    int64 position;
+  };
+
+  State GetState() TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+    return State{deterministic_, epoch_seed_,         seed_,
+                 seed2_,         num_random_samples_, position_};
+  }
+
+  void SetState(const State& state) TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+    deterministic_ = state.deterministic;
+    epoch_seed_ = state.epoch_seed;
+    seed_ = state.seed;
+    seed2_ = state.seed2;
+    num_random_samples_ = state.num_random_samples;
+    position_ = state.position;
+    parent_generator_ = std::make_unique<random::PhiloxRandom>(seed_, seed2_);
+    generator_ =
+        std::make_unique<random::SingleSampleAdapter<random::PhiloxRandom>>(
+            parent_generator_.get());
+    generator_->Skip(position_);
+  }
+
+  // Shuffles `values` with the given generator stream of the epoch seed.
+  template <typename T>
+  void Permute(uint64 stream, std::vector<T>& values) const {
+    random::PhiloxRandom philox(epoch_seed_, stream);
+    random::SimplePhilox rng(&philox);
+    for (size_t i = values.size(); i > 1; i--) {
+      std::swap(values[i - 1], values[rng.Uniform64(i)]);
+    }
+  }
+
   void SampleBlocks(size_t batch_size, bool shuffle,
                     std::vector<std::unique_ptr<AvroBlock>>& blocks) {
     size_t i = 0;
@@ -90,25 +145,33 @@ class ShuffleHandler {
   random::SingleSampleAdapter<random::PhiloxRandom>::ResultType Random()
       TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
     num_random_samples_++;
+    position_++;
     return generator_->operator()();
   }
 
   void ResetRngs() TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
     // Reset the generators based on the current iterator seeds.
-    int64 seed_ = random::New64();
-    int64 seed2_ = random::New64();
+    seed_ = deterministic_ ? epoch_seed_ : random::New64();
+    seed2_ = deterministic_ ? kSamplingStream : random::New64();
     parent_generator_ = std::make_unique<random::PhiloxRandom>(seed_, seed2_);
     generator_ =
         std::make_unique<random::SingleSampleAdapter<random::PhiloxRandom>>(
             parent_generator_.get());
     generator_->Skip(num_random_samples_);
+    position_ = num_random_samples_;
     num_random_samples_ = 0;
   }
 
  private:
   // this is not owned by ShuffleHandler. This is owned by the calling class
   mutex* mu_;
+  bool deterministic_;
+  uint64 epoch_seed_;
+  int64 seed_ TF_GUARDED_BY(*mu_) = 0;
+  int64 seed2_ TF_GUARDED_BY(*mu_) = 0;
   int64 num_random_samples_ TF_GUARDED_BY(*mu_) = 0;
+  // Number of samples drawn from generator_ since it was seeded.
+  int64 position_ TF_GUARDED_BY(*mu_) = 0;
   std::unique_ptr<random::PhiloxRandom> parent_generator_ TF_GUARDED_BY(*mu_);
   std::unique_ptr<random::SingleSampleAdapter<random::PhiloxRandom>> generator_
       TF_GUARDED_BY(*mu_);
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/avro/atds/shuffle_handler.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -47,7 +50,7 @@ class ShuffleTest : public ::testing::Test {
           100000,            // int64_t byte_count;
           0,                 // int64_t counts;
           tstring("haha"),   // tstring content;
-          avro::NULL_CODEC,  // avro::Codec codec;
+          NULL_CODEC,  // BlockCodec codec;
           4888               // size_t read_offset;
       }));
     }
@@ -104,5 +107,70 @@ TEST_F(ShuffleTest, UniformDistributionTest) {
   }
 }
 
+TEST(ShuffleHandlerTest, SeededShuffleIsDeterministic) {
+  mutex mu;
+  ShuffleHandler first(&mu, 42, 3);
+  ShuffleHandler second(&mu, 42, 3);
+  ShuffleHandler next_epoch(&mu, 42, 4);
+  ASSERT_TRUE(first.deterministic());
+
+  mutex_lock l(mu);
+  bool epochs_differ = false;
+  for (size_t i = 0; i < 100; i++) {
+    auto r = first.Random();
+    EXPECT_EQ(r, second.Random());
+    epochs_differ |= r != next_epoch.Random();
+  }
+  EXPECT_TRUE(epochs_differ);
+}
+
+TEST(ShuffleHandlerTest, Permute) {
+  mutex mu;
+  ShuffleHandler first(&mu, 7, 0);
+  ShuffleHandler second(&mu, 7, 0);
+  std::vector<size_t> values(100), expected(100);
+  std::iota(values.begin(), values.end(), 0);
+  std::iota(expected.begin(), expected.end(), 0);
+  first.Permute(ShuffleHandler::kFileOrderStream, values);
+  second.Permute(ShuffleHandler::kFileOrderStream, expected);
+  EXPECT_EQ(expected, values);
+
+  std::vector<size_t> sorted(values);
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < sorted.size(); i++) {
+    EXPECT_EQ(i, sorted[i]);
+  }
+  // Another stream of the same seed gives another order.
+  std::vector<size_t> other(100);
+  std::iota(other.begin(), other.end(), 0);
+  first.Permute(ShuffleHandler::kBlockOrderStream, other);
+  EXPECT_NE(values, other);
+}
+
+TEST(ShuffleHandlerTest, RestoreState) {
+  mutex mu;
+  ShuffleHandler handler(&mu);
+  ShuffleHandler restored(&mu, 1, 0);
+  mutex_lock l(mu);
+  for (size_t i = 0; i < 10; i++) {
+    handler.Random();
+  }
+  handler.ResetRngs();
+  for (size_t i = 0; i < 10; i++) {
+    handler.Random();
+  }
+  restored.SetState(handler.GetState());
+  EXPECT_FALSE(restored.deterministic());
+  for (size_t i = 0; i < 100; i++) {
+    EXPECT_EQ(handler.Random(), restored.Random());
+  }
+}
+
+TEST(ShuffleHandlerTest, UnseededShuffleIsNotDeterministic) {
+  mutex mu;
+  ShuffleHandler handler(&mu);
+  EXPECT_FALSE(handler.deterministic());
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -85,6 +85,20 @@ class FeatureDecoder : public DecoderBase {
                     sparse::ValueBuffer& buffer,
                     std::vector<avro::GenericDatum>& skipped_data,
                     size_t offset) {
+    return Decode(decoder, buffer, offset);
+  }
+
+  Status operator()(RawDecoder*& decoder, std::vector<Tensor>& dense_tensors,
+                    sparse::ValueBuffer& buffer,
+                    std::vector<avro::GenericDatum>& skipped_data,
+                    size_t offset) {
+    return Decode(decoder, buffer, offset);
+  }
+
+ private:
+  template <typename Decoder>
+  inline Status Decode(Decoder& decoder, sparse::ValueBuffer& buffer,
+                       size_t offset) {
     size_t num_decoders = decoders_.size();
     std::vector<size_t> decoded_numbers(num_decoders, 0);
     size_t indices_index = metadata_.indices_index;
@@ -113,7 +127,6 @@ class FeatureDecoder : public DecoderBase {
     return OkStatus();
   }
 
- private:
   void FillBatchIndices(std::vector<long>& v, size_t indices_start,
                         long batch_offset, size_t rank_after_batch) {
     size_t end = v.size();
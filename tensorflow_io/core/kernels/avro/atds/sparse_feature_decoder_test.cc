@@ -83,6 +83,20 @@ void SparseDecoderTest(const Indices& indices, const std::vector<T>& values,
 
   ValidateBuffer(buffer, sparse_features[0], expected_indices, values,
                  expected_num_elements);
+
+  ASSERT_TRUE(atds_decoder.SupportsRawDecoding());
+  auto bytes = avro::snapshot(*out_stream);
+  RawDecoder raw(bytes->data(), bytes->size());
+  RawDecoder* raw_decoder = &raw;
+  ValueBuffer raw_buffer;
+  GetValuesBuffer<T>(raw_buffer).resize(1);
+  raw_buffer.indices.resize(1);
+  raw_buffer.num_of_elements.resize(1);
+  decode_status = atds_decoder.DecodeATDSDatum(
+      raw_decoder, dense_tensors, raw_buffer, skipped_data, offset);
+  ASSERT_TRUE(decode_status.ok());
+  ValidateBuffer(raw_buffer, sparse_features[0], expected_indices, values,
+                 expected_num_elements);
 }
 
 template <>
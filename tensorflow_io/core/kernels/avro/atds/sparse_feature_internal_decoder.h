@@ -24,8 +24,8 @@ namespace tensorflow {
 namespace atds {
 namespace sparse {
 
-template <typename T>
-inline size_t DecodeVarLenValues(avro::DecoderPtr& decoder, std::vector<T>& v) {
+template <typename T, typename Decoder>
+inline size_t DecodeVarLenValues(Decoder& decoder, std::vector<T>& v) {
   size_t count = 0;
   for (size_t m = decoder->arrayStart(); m != 0; m = decoder->arrayNext()) {
     count += m;
@@ -36,15 +36,14 @@ inline size_t DecodeVarLenValues(avro::DecoderPtr& decoder, std::vector<T>& v) {
   return count;
 }
 
-// This template specification handles both byte and string.
+// This template overload handles both byte and string.
 // It assumes that avro decodeBytes and decodeString are both reading bytes into
 // uint8 arrays see:
 // https://github.com/apache/avro/blob/branch-1.9/lang/c%2B%2B/impl/BinaryDecoder.cc#L133
 // As long as that as that assumption holds a separate bytes implementation is
 // not required.
-template <>
-inline size_t DecodeVarLenValues(avro::DecoderPtr& decoder,
-                                 std::vector<string>& v) {
+template <typename Decoder>
+inline size_t DecodeVarLenValues(Decoder& decoder, std::vector<string>& v) {
   size_t count = 0;
   for (size_t m = decoder->arrayStart(); m != 0; m = decoder->arrayNext()) {
     count += m;
@@ -62,6 +61,9 @@ class InternalDecoder {
 
   virtual size_t Decode(avro::DecoderPtr& decoder, ValueBuffer& buffer,
                         size_t dim, size_t indices_start) = 0;
+
+  virtual size_t Decode(RawDecoder*& decoder, ValueBuffer& buffer, size_t dim,
+                        size_t indices_start) = 0;
 };
 
 template <typename T>
@@ -72,8 +74,14 @@ class ValuesDecoder : public InternalDecoder {
   // Two size_t parameters are only used in IndicesDecoder.
   size_t Decode(avro::DecoderPtr& decoder, ValueBuffer& buffer,
                 size_t not_used_1, size_t not_used_2) {
-    return DecodeVarLenValues<T>(decoder,
-                                 GetValueVector<T>(buffer, values_index_));
+    return DecodeVarLenValues(decoder,
+                              GetValueVector<T>(buffer, values_index_));
+  }
+
+  size_t Decode(RawDecoder*& decoder, ValueBuffer& buffer, size_t not_used_1,
+                size_t not_used_2) {
+    return DecodeVarLenValues(decoder,
+                              GetValueVector<T>(buffer, values_index_));
   }
 
  private:
@@ -91,6 +99,18 @@ class IndicesDecoder : public InternalDecoder {
 
   size_t Decode(avro::DecoderPtr& decoder, ValueBuffer& buffer, size_t dim,
                 size_t indices_start) {
+    return DecodeIndices(decoder, buffer, dim, indices_start);
+  }
+
+  size_t Decode(RawDecoder*& decoder, ValueBuffer& buffer, size_t dim,
+                size_t indices_start) {
+    return DecodeIndices(decoder, buffer, dim, indices_start);
+  }
+
+ private:
+  template <typename Decoder>
+  inline size_t DecodeIndices(Decoder& decoder, ValueBuffer& buffer,
+                              size_t dim, size_t indices_start) {
     auto& v = buffer.indices[indices_index_];
     size_t count = 0;
     size_t start = indices_start;
@@ -104,45 +124,17 @@ class IndicesDecoder : public InternalDecoder {
       if (end > v.size()) {
         v.resize(end);
       }
-      for (size_t i = start + dim_after_batch; i < end;
-           i += rank_after_batch_) {
-        v[i] = static_cast<long>(avro::decoder_t::Decode<T>(decoder));
-      }
+      avro::decoder_t::DecodeStridedItems<T>(
+          decoder, v.data() + start + dim_after_batch, m, rank_after_batch_);
       start = end;
     }
     return count;
   }
 
- private:
   const size_t indices_index_;
   const size_t rank_after_batch_;
 };
 
-template <>
-inline size_t IndicesDecoder<long>::Decode(avro::DecoderPtr& decoder,
-                                           ValueBuffer& buffer, size_t dim,
-                                           size_t indices_start) {
-  auto& v = buffer.indices[indices_index_];
-  size_t count = 0;
-  size_t start = indices_start;
-  auto dim_after_batch = dim + 1;
-  for (size_t m = decoder->arrayStart(); m != 0; m = decoder->arrayNext()) {
-    count += m;
-    size_t end = start + m * rank_after_batch_;
-    if (end > v.capacity()) {
-      v.reserve(2 * v.capacity());
-    }
-    if (end > v.size()) {
-      v.resize(end);
-    }
-    for (size_t i = start + dim_after_batch; i < end; i += rank_after_batch_) {
-      v[i] = decoder->decodeLong();
-    }
-    start = end;
-  }
-  return count;
-}
-
 }  // namespace sparse
 }  // namespace atds
 }  // namespace tensorflow
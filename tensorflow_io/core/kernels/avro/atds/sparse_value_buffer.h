@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_SPARSE_VALUE_BUFFER_H_
 #define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_SPARSE_VALUE_BUFFER_H_
 
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow_io/core/kernels/avro/atds/errors.h"
 
@@ -38,6 +41,23 @@ struct ValueBuffer {
   vecvec<size_t> num_of_elements;
 };
 
+// Empties all vectors of the buffer but keeps their capacity.
+inline void ClearValueBuffer(ValueBuffer& buffer) {
+  auto clear = [](auto& vectors) {
+    for (auto& v : vectors) {
+      v.clear();
+    }
+  };
+  clear(buffer.int_values);
+  clear(buffer.long_values);
+  clear(buffer.float_values);
+  clear(buffer.double_values);
+  clear(buffer.bool_values);
+  clear(buffer.string_values);
+  clear(buffer.indices);
+  clear(buffer.num_of_elements);
+}
+
 template <typename T>
 std::vector<T>& GetValueVector(ValueBuffer& buffer, size_t index);
 
@@ -110,25 +130,36 @@ inline const std::vector<bool>& GetValueVector(const ValueBuffer& buffer,
   return buffer.bool_values[index];
 }
 
+// Copies the elements [begin, end) of `buffer`, of `width` values each, to
+// the element `offset` and the following ones of `tensor`.
 inline Status FillIndicesTensor(const std::vector<long>& buffer, Tensor& tensor,
+                                size_t width, size_t begin, size_t end,
                                 size_t offset) {
-  void* dest =
-      reinterpret_cast<void*>(reinterpret_cast<long*>(tensor.data()) + offset);
-  const void* src = reinterpret_cast<const void*>(buffer.data());
-  size_t len = buffer.size() * sizeof(long);
+  void* dest = reinterpret_cast<void*>(reinterpret_cast<long*>(tensor.data()) +
+                                       offset * width);
+  const void* src =
+      reinterpret_cast<const void*>(buffer.data() + begin * width);
+  size_t len = (end - begin) * width * sizeof(long);
   std::memcpy(dest, src, len);
   return OkStatus();
 }
 
+inline Status FillIndicesTensor(const std::vector<long>& buffer, Tensor& tensor,
+                                size_t offset) {
+  return FillIndicesTensor(buffer, tensor, 1, 0, buffer.size(), offset);
+}
+
+// Copies the values [begin, end) of the `values_index`-th vector of type T
+// of `buffer` to the value `offset` and the following ones of `tensor`.
 template <typename T>
 inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
                                Tensor& tensor, size_t values_index,
-                               size_t offset) {
+                               size_t begin, size_t end, size_t offset) {
   auto& values = GetValueVector<T>(buffer, values_index);
   void* dest =
       reinterpret_cast<void*>(reinterpret_cast<T*>(tensor.data()) + offset);
-  const void* src = reinterpret_cast<const void*>(values.data());
-  size_t len = values.size() * sizeof(T);
+  const void* src = reinterpret_cast<const void*>(values.data() + begin);
+  size_t len = (end - begin) * sizeof(T);
   std::memcpy(dest, src, len);
   return OkStatus();
 }
@@ -136,9 +167,10 @@ inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
 template <>
 inline Status FillValuesTensor<string>(const sparse::ValueBuffer& buffer,
                                        Tensor& tensor, size_t values_index,
+                                       size_t begin, size_t end,
                                        size_t offset) {
   auto& values = buffer.string_values[values_index];
-  for (size_t i = 0; i < values.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     tensor.flat<tstring>()(offset++) = std::move(values[i]);
   }
   return OkStatus();
@@ -147,14 +179,57 @@ inline Status FillValuesTensor<string>(const sparse::ValueBuffer& buffer,
 template <>
 inline Status FillValuesTensor<bool>(const sparse::ValueBuffer& buffer,
                                      Tensor& tensor, size_t values_index,
-                                     size_t offset) {
+                                     size_t begin, size_t end, size_t offset) {
   auto& values = buffer.bool_values[values_index];
-  for (size_t i = 0; i < values.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     tensor.flat<bool>()(offset++) = values[i];
   }
   return OkStatus();
 }
 
+template <typename T>
+inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
+                               Tensor& tensor, size_t values_index,
+                               size_t offset) {
+  size_t size = GetValueVector<T>(buffer, values_index).size();
+  return FillValuesTensor<T>(buffer, tensor, values_index, 0, size, offset);
+}
+
+inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
+                               Tensor& values_tensor, DataType dtype,
+                               size_t values_index, size_t begin, size_t end,
+                               size_t offset) {
+  switch (dtype) {
+    case DT_INT32: {
+      return FillValuesTensor<int>(buffer, values_tensor, values_index, begin,
+                                   end, offset);
+    }
+    case DT_INT64: {
+      return FillValuesTensor<long>(buffer, values_tensor, values_index, begin,
+                                    end, offset);
+    }
+    case DT_FLOAT: {
+      return FillValuesTensor<float>(buffer, values_tensor, values_index,
+                                     begin, end, offset);
+    }
+    case DT_DOUBLE: {
+      return FillValuesTensor<double>(buffer, values_tensor, values_index,
+                                      begin, end, offset);
+    }
+    case DT_STRING: {
+      return FillValuesTensor<string>(buffer, values_tensor, values_index,
+                                      begin, end, offset);
+    }
+    case DT_BOOL: {
+      return FillValuesTensor<bool>(buffer, values_tensor, values_index,
+                                    begin, end, offset);
+    }
+    default: {
+      return TypeNotSupportedError(dtype);
+    }
+  }
+}
+
 inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
                                Tensor& values_tensor, DataType dtype,
                                size_t values_index, size_t offset) {
@@ -188,6 +263,59 @@ inline Status FillValuesTensor(const sparse::ValueBuffer& buffer,
   }
 }
 
+// A copy of the elements [begin, end) that decode thread `thread` buffered
+// for sparse feature `feature`, to the element `offset` and the following
+// ones of the output tensors of the feature.
+struct FillRange {
+  size_t feature;
+  size_t thread;
+  size_t begin;
+  size_t end;
+  size_t offset;
+};
+
+// Splits the copies of the elements buffered by the decode threads into
+// their output tensors into at most `num_shards` shards of about as many
+// elements each, so that they are filled in parallel across both features
+// and threads. `num_of_elements[t][i]` is the number of elements of feature
+// i buffered by thread t; those of a feature are output in thread order,
+// at the offsets of the prefix sums of the numbers of the threads before.
+inline std::vector<std::vector<FillRange>> ShardFillRanges(
+    const std::vector<std::vector<size_t>>& num_of_elements,
+    size_t num_of_sparse, size_t num_shards) {
+  size_t total = 0;
+  for (auto& elements : num_of_elements) {
+    for (size_t i = 0; i < num_of_sparse; i++) {
+      total += elements[i];
+    }
+  }
+  std::vector<std::vector<FillRange>> shards(1);
+  if (total == 0 || num_shards == 0) {
+    return shards;
+  }
+  const size_t shard_size = (total + num_shards - 1) / num_shards;
+  size_t shard_filled = 0;
+  for (size_t i = 0; i < num_of_sparse; i++) {
+    size_t offset = 0;
+    for (size_t t = 0; t < num_of_elements.size(); t++) {
+      const size_t count = num_of_elements[t][i];
+      size_t begin = 0;
+      while (begin < count) {
+        if (shard_filled == shard_size) {
+          shards.emplace_back();
+          shard_filled = 0;
+        }
+        const size_t end = std::min(count, begin + shard_size - shard_filled);
+        shards.back().push_back({i, t, begin, end, offset});
+        shard_filled += end - begin;
+        offset += end - begin;
+        begin = end;
+      }
+    }
+  }
+  return shards;
+}
+
 }  // namespace sparse
 }  // namespace atds
 }  // namespace tensorflow
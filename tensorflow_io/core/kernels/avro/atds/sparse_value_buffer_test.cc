@@ -38,6 +38,54 @@ TEST_P(FillIndicesTensorTest, Offset) {
 INSTANTIATE_TEST_SUITE_P(offset_0_1_2, FillIndicesTensorTest,
                          ::testing::Values(0, 1, 2));
 
+TEST(FillIndicesTensorTest, Range) {
+  std::vector<long> buffer = {0, 1, 0, 2, 1, 0, 1, 1};
+  Tensor tensor(DT_INT64, {6});
+  Status status = FillIndicesTensor(buffer, tensor, 2, 1, 3, 1);
+  ASSERT_TRUE(status.ok());
+  AssertTensorRangeEqual(tensor, std::vector<long>{0, 2, 1, 0}, 2);
+}
+
+TEST(FillValuesTensorTest, Range) {
+  sparse::ValueBuffer buffer;
+  buffer.string_values.push_back({"A", "B", "C", "D"});
+  Tensor tensor(DT_STRING, {3});
+  Status status = FillValuesTensor(buffer, tensor, DT_STRING, 0, 1, 3, 1);
+  ASSERT_TRUE(status.ok());
+  AssertTensorRangeEqual(tensor, std::vector<string>{"B", "C"}, 1);
+}
+
+TEST(ShardFillRangesTest, Empty) {
+  std::vector<std::vector<size_t>> num_of_elements = {{0, 0}, {0, 0}};
+  auto shards = ShardFillRanges(num_of_elements, 2, 4);
+  ASSERT_EQ(shards.size(), 1);
+  ASSERT_TRUE(shards[0].empty());
+}
+
+TEST(ShardFillRangesTest, SplitsAcrossFeaturesAndThreads) {
+  // Thread 0 buffered 5 elements of feature 0 and 1 of feature 1, thread 1
+  // 1 of feature 0 and 1 of feature 1.
+  std::vector<std::vector<size_t>> num_of_elements = {{5, 1}, {1, 1}};
+  auto shards = ShardFillRanges(num_of_elements, 2, 2);
+  ASSERT_EQ(shards.size(), 2);
+
+  // Each shard copies 4 elements, and every element is copied once to the
+  // offset of the prefix sums over the threads.
+  std::vector<std::vector<size_t>> copied = {{0, 0}, {0, 0}};
+  for (auto& shard : shards) {
+    size_t elements = 0;
+    for (auto& range : shard) {
+      size_t prefix = range.thread == 0 ? 0 : num_of_elements[0][range.feature];
+      ASSERT_EQ(range.offset, prefix + range.begin);
+      ASSERT_EQ(range.begin, copied[range.thread][range.feature]);
+      copied[range.thread][range.feature] = range.end;
+      elements += range.end - range.begin;
+    }
+    ASSERT_EQ(elements, 4);
+  }
+  ASSERT_EQ(copied, num_of_elements);
+}
+
 template <typename T>
 void FillValuesTensorTest(const std::vector<T>& values, size_t values_index,
                           size_t offset) {
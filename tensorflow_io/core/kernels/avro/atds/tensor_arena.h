@@ -0,0 +1,110 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_TENSOR_ARENA_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_TENSOR_ARENA_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+
+namespace tensorflow {
+namespace data {
+
+// Recycles the output tensors of a dataset iterator across batches. The arena
+// keeps a reference to every tensor it hands out. Once the consumer has
+// dropped its references, the arena holds the only one and the buffer is
+// handed out again for the same output slot.
+//
+// Tensors are handed out as slices of their first dimension, so a buffer
+// serves any later request with the same dtype and inner dimensions and no
+// more rows. When a slot needs more rows than it has seen before, the new
+// buffer gets 25% spare rows so that slowly growing sparse outputs do not
+// reallocate on every batch. Not thread safe.
+class TensorArena {
+ public:
+  explicit TensorArena(size_t num_slots, size_t max_tensors_per_slot = 4)
+      : max_tensors_per_slot_(max_tensors_per_slot),
+        slots_(num_slots),
+        max_rows_(num_slots, 0) {}
+
+  // Returns a tensor of `shape` for output `slot`. The content of the tensor
+  // is uninitialized.
+  Tensor Acquire(size_t slot, Allocator* allocator, DataType dtype,
+                 const TensorShape& shape) {
+    if (shape.dims() == 0 || shape.num_elements() == 0) {
+      return Tensor(allocator, dtype, shape);
+    }
+    int64 rows = shape.dim_size(0);
+    auto& pool = slots_[slot];
+    Tensor* unused = nullptr;
+    for (Tensor& tensor : pool) {
+      if (!tensor.RefCountIsOne()) {
+        continue;
+      }
+      if (Fits(tensor, dtype, shape)) {
+        return tensor.Slice(0, rows);
+      }
+      unused = &tensor;
+    }
+
+    int64 capacity = rows;
+    if (max_rows_[slot] >= rows) {
+      capacity = max_rows_[slot];
+    } else if (max_rows_[slot] > 0) {
+      capacity = rows + rows / 4;
+    }
+    max_rows_[slot] = std::max(max_rows_[slot], capacity);
+    TensorShape capacity_shape(shape);
+    capacity_shape.set_dim(0, capacity);
+    Tensor tensor(allocator, dtype, capacity_shape);
+    if (unused != nullptr) {
+      *unused = tensor;
+    } else if (pool.size() < max_tensors_per_slot_) {
+      pool.push_back(tensor);
+    }
+    return tensor.Slice(0, rows);
+  }
+
+  size_t NumTensors(size_t slot) const { return slots_[slot].size(); }
+
+ private:
+  static bool Fits(const Tensor& tensor, DataType dtype,
+                   const TensorShape& shape) {
+    const TensorShape& capacity_shape = tensor.shape();
+    if (tensor.dtype() != dtype || capacity_shape.dims() != shape.dims() ||
+        capacity_shape.dim_size(0) < shape.dim_size(0)) {
+      return false;
+    }
+    for (int d = 1; d < shape.dims(); d++) {
+      if (capacity_shape.dim_size(d) != shape.dim_size(d)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const size_t max_tensors_per_slot_;
+  std::vector<std::vector<Tensor>> slots_;
+  std::vector<int64> max_rows_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_TENSOR_ARENA_H_
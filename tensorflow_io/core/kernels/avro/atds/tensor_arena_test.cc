@@ -0,0 +1,82 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/tensor_arena.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+TEST(TensorArenaTest, ReuseReleasedTensor) {
+  TensorArena arena(1);
+  Tensor first = arena.Acquire(0, cpu_allocator(), DT_INT64, {4, 2});
+  const void* data = first.data();
+  first = Tensor();
+
+  Tensor second = arena.Acquire(0, cpu_allocator(), DT_INT64, {4, 2});
+  EXPECT_EQ(data, second.data());
+  EXPECT_EQ(TensorShape({4, 2}), second.shape());
+  EXPECT_EQ(1, arena.NumTensors(0));
+}
+
+TEST(TensorArenaTest, NoReuseWhileReferenced) {
+  TensorArena arena(1);
+  Tensor first = arena.Acquire(0, cpu_allocator(), DT_FLOAT, {8});
+  Tensor second = arena.Acquire(0, cpu_allocator(), DT_FLOAT, {8});
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_EQ(2, arena.NumTensors(0));
+}
+
+TEST(TensorArenaTest, FewerRowsReuseLargerTensor) {
+  TensorArena arena(1);
+  Tensor full = arena.Acquire(0, cpu_allocator(), DT_INT32, {16, 3});
+  const void* data = full.data();
+  full = Tensor();
+
+  Tensor partial = arena.Acquire(0, cpu_allocator(), DT_INT32, {5, 3});
+  EXPECT_EQ(data, partial.data());
+  EXPECT_EQ(TensorShape({5, 3}), partial.shape());
+  partial = Tensor();
+
+  // Inner dimensions must match.
+  Tensor other = arena.Acquire(0, cpu_allocator(), DT_INT32, {5, 4});
+  EXPECT_NE(data, other.data());
+}
+
+TEST(TensorArenaTest, GrowWithSpareRows) {
+  TensorArena arena(1);
+  arena.Acquire(0, cpu_allocator(), DT_INT64, {100});
+  Tensor grown = arena.Acquire(0, cpu_allocator(), DT_INT64, {120});
+  const void* data = grown.data();
+  EXPECT_EQ(TensorShape({120}), grown.shape());
+  grown = Tensor();
+
+  // The grown buffer has room for 150 rows.
+  Tensor reused = arena.Acquire(0, cpu_allocator(), DT_INT64, {150});
+  EXPECT_EQ(data, reused.data());
+}
+
+TEST(TensorArenaTest, SlotsAreIndependent) {
+  TensorArena arena(2);
+  Tensor first = arena.Acquire(0, cpu_allocator(), DT_DOUBLE, {2});
+  const void* data = first.data();
+  first = Tensor();
+  Tensor second = arena.Acquire(1, cpu_allocator(), DT_DOUBLE, {2});
+  EXPECT_NE(data, second.data());
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,247 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_VARINT_DECODER_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_VARINT_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow_io/core/kernels/cpu_info.h"
+
+#if defined(TFIO_DISPATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ATDS_VARINT_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace tensorflow {
+namespace atds {
+namespace varint {
+
+// Arrays shorter than this are always decoded by the scalar kernel.
+constexpr size_t kMinBulkSize = 16;
+
+inline int64_t ZigZag(uint64_t n) {
+  return static_cast<int64_t>((n >> 1) ^ -(n & 1));
+}
+
+// Decodes one varint into `value`. Returns nullptr if the varint is longer
+// than 10 bytes or runs past `end`.
+inline const uint8_t* DecodeOne(const uint8_t* p, const uint8_t* end,
+                                uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    result |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if ((b & 0x80) == 0) {
+      *value = result;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// Each kernel decodes `n` zig-zag varints from [p, end) into `out` and returns
+// the position after the last varint, or nullptr on malformed input. int
+// outputs truncate the decoded value as avro::Decoder::decodeInt does.
+template <typename T>
+const uint8_t* DecodeScalar(const uint8_t* p, const uint8_t* end, T* out,
+                            size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    uint64_t value;
+    p = DecodeOne(p, end, &value);
+    if (TF_PREDICT_FALSE(p == nullptr)) {
+      return nullptr;
+    }
+    out[i] = static_cast<T>(ZigZag(value));
+  }
+  return p;
+}
+
+#ifdef ATDS_VARINT_SIMD
+
+static_assert(sizeof(long) == sizeof(int64_t), "long must be 64 bits.");
+
+// Masked varint decoding: the continuation bits of a whole window of bytes
+// are gathered into a bit mask. A zero mask means every byte in the window is
+// a complete single byte varint, which is the common case for small ids and
+// sparse indices, and the whole window is decoded with vector instructions.
+// Otherwise the single byte varints in front of the first continuation byte
+// are decoded without a per-byte branch and the multi-byte varint is decoded
+// by the scalar path.
+
+// Zig-zag decodes 16 single byte varints held in the int8 lanes of `bytes`.
+TFIO_TARGET("sse4.1")
+inline __m128i ZigZag16(__m128i bytes) {
+  __m128i half = _mm_and_si128(_mm_srli_epi16(bytes, 1), _mm_set1_epi8(0x7f));
+  __m128i sign =
+      _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(bytes, _mm_set1_epi8(1)));
+  return _mm_xor_si128(half, sign);
+}
+
+TFIO_TARGET("sse4.1")
+inline void Store16(__m128i values, int* out) {
+  __m128i* dst = reinterpret_cast<__m128i*>(out);
+  _mm_storeu_si128(dst, _mm_cvtepi8_epi32(values));
+  _mm_storeu_si128(dst + 1, _mm_cvtepi8_epi32(_mm_srli_si128(values, 4)));
+  _mm_storeu_si128(dst + 2, _mm_cvtepi8_epi32(_mm_srli_si128(values, 8)));
+  _mm_storeu_si128(dst + 3, _mm_cvtepi8_epi32(_mm_srli_si128(values, 12)));
+}
+
+TFIO_TARGET("sse4.1")
+inline void Store16(__m128i values, long* out) {
+  __m128i* dst = reinterpret_cast<__m128i*>(out);
+  _mm_storeu_si128(dst, _mm_cvtepi8_epi64(values));
+  _mm_storeu_si128(dst + 1, _mm_cvtepi8_epi64(_mm_srli_si128(values, 2)));
+  _mm_storeu_si128(dst + 2, _mm_cvtepi8_epi64(_mm_srli_si128(values, 4)));
+  _mm_storeu_si128(dst + 3, _mm_cvtepi8_epi64(_mm_srli_si128(values, 6)));
+  _mm_storeu_si128(dst + 4, _mm_cvtepi8_epi64(_mm_srli_si128(values, 8)));
+  _mm_storeu_si128(dst + 5, _mm_cvtepi8_epi64(_mm_srli_si128(values, 10)));
+  _mm_storeu_si128(dst + 6, _mm_cvtepi8_epi64(_mm_srli_si128(values, 12)));
+  _mm_storeu_si128(dst + 7, _mm_cvtepi8_epi64(_mm_srli_si128(values, 14)));
+}
+
+TFIO_TARGET("avx2")
+inline void Store16AVX2(__m128i values, int* out) {
+  __m256i* dst = reinterpret_cast<__m256i*>(out);
+  _mm256_storeu_si256(dst, _mm256_cvtepi8_epi32(values));
+  _mm256_storeu_si256(dst + 1,
+                      _mm256_cvtepi8_epi32(_mm_srli_si128(values, 8)));
+}
+
+TFIO_TARGET("avx2")
+inline void Store16AVX2(__m128i values, long* out) {
+  __m256i* dst = reinterpret_cast<__m256i*>(out);
+  _mm256_storeu_si256(dst, _mm256_cvtepi8_epi64(values));
+  _mm256_storeu_si256(dst + 1,
+                      _mm256_cvtepi8_epi64(_mm_srli_si128(values, 4)));
+  _mm256_storeu_si256(dst + 2,
+                      _mm256_cvtepi8_epi64(_mm_srli_si128(values, 8)));
+  _mm256_storeu_si256(dst + 3,
+                      _mm256_cvtepi8_epi64(_mm_srli_si128(values, 12)));
+}
+
+// Decodes the single byte varints in front of the first continuation byte
+// and the multi-byte varint after them. `mask` must be non zero.
+template <typename T>
+inline const uint8_t* DecodeMasked(const uint8_t* p, const uint8_t* end,
+                                   T* out, size_t* i, uint32_t mask) {
+  size_t leading = static_cast<size_t>(__builtin_ctz(mask));
+  for (size_t k = 0; k < leading; k++) {
+    out[*i + k] = static_cast<T>(ZigZag(p[k]));
+  }
+  p += leading;
+  *i += leading;
+  uint64_t value;
+  p = DecodeOne(p, end, &value);
+  if (TF_PREDICT_FALSE(p == nullptr)) {
+    return nullptr;
+  }
+  out[(*i)++] = static_cast<T>(ZigZag(value));
+  return p;
+}
+
+template <typename T>
+TFIO_TARGET("sse4.1")
+const uint8_t* DecodeSSE41(const uint8_t* p, const uint8_t* end, T* out,
+                           size_t n) {
+  size_t i = 0;
+  // At most 16 varints are consumed per iteration, so the window never decodes
+  // past the requested count.
+  while (n - i >= 16 && end - p >= 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+    if (mask == 0) {
+      Store16(ZigZag16(bytes), out + i);
+      p += 16;
+      i += 16;
+      continue;
+    }
+    p = DecodeMasked(p, end, out, &i, mask);
+    if (TF_PREDICT_FALSE(p == nullptr)) {
+      return nullptr;
+    }
+  }
+  return DecodeScalar(p, end, out + i, n - i);
+}
+
+template <typename T>
+TFIO_TARGET("avx2")
+const uint8_t* DecodeAVX2(const uint8_t* p, const uint8_t* end, T* out,
+                          size_t n) {
+  size_t i = 0;
+  while (n - i >= 32 && end - p >= 32) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+    if (mask == 0) {
+      __m128i low = ZigZag16(_mm256_castsi256_si128(bytes));
+      __m128i high = ZigZag16(_mm256_extracti128_si256(bytes, 1));
+      Store16AVX2(low, out + i);
+      Store16AVX2(high, out + i + 16);
+      p += 32;
+      i += 32;
+      continue;
+    }
+    p = DecodeMasked(p, end, out, &i, mask);
+    if (TF_PREDICT_FALSE(p == nullptr)) {
+      return nullptr;
+    }
+  }
+  return DecodeSSE41(p, end, out + i, n - i);
+}
+
+#endif  // ATDS_VARINT_SIMD
+
+template <typename T>
+using DecodeKernel = const uint8_t* (*)(const uint8_t*, const uint8_t*, T*,
+                                        size_t);
+
+// Picks the widest kernel supported by the CPU.
+template <typename T>
+DecodeKernel<T> SelectKernel() {
+#ifdef ATDS_VARINT_SIMD
+  if (io::CanDispatch(io::DispatchISA::kAVX2)) {
+    return &DecodeAVX2<T>;
+  }
+  if (io::CanDispatch(io::DispatchISA::kSSE4_2)) {
+    return &DecodeSSE41<T>;
+  }
+#endif
+  return &DecodeScalar<T>;
+}
+
+}  // namespace varint
+
+// Decodes `n` zig-zag encoded varints from [p, end) into `out`. T is int or
+// long. Returns the position after the last varint, or nullptr if the input
+// is malformed or truncated.
+template <typename T>
+inline const uint8_t* DecodeZigZagVarints(const uint8_t* p, const uint8_t* end,
+                                          T* out, size_t n) {
+  static_assert(std::is_same<int, T>::value || std::is_same<long, T>::value,
+                "Only int and long varints can be bulk decoded.");
+  if (n < varint::kMinBulkSize) {
+    return varint::DecodeScalar(p, end, out, n);
+  }
+  static const varint::DecodeKernel<T> kernel = varint::SelectKernel<T>();
+  return kernel(p, end, out, n);
+}
+
+}  // namespace atds
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_ATDS_VARINT_DECODER_H_
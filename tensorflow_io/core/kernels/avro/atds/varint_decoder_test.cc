@@ -0,0 +1,142 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/atds/varint_decoder.h"
+
+#include <random>
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace atds {
+
+namespace {
+
+void AppendZigZagVarint(int64_t value, std::vector<uint8_t>& bytes) {
+  uint64_t n = (static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63);
+  do {
+    uint8_t b = n & 0x7f;
+    n >>= 7;
+    if (n != 0) {
+      b |= 0x80;
+    }
+    bytes.push_back(b);
+  } while (n != 0);
+}
+
+// Mostly single byte varints with some multi-byte ones mixed in.
+template <typename T>
+std::vector<T> RandomValues(std::mt19937_64& rng, size_t n) {
+  std::vector<T> values(n);
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = rng();
+    switch (r % 10) {
+      case 0:
+        values[i] = static_cast<T>(rng());
+        break;
+      case 1:
+      case 2:
+        values[i] = static_cast<T>(static_cast<int64_t>(rng() % 100000) -
+                                   50000);
+        break;
+      default:
+        values[i] = static_cast<T>(static_cast<int64_t>(rng() % 128) - 64);
+    }
+  }
+  return values;
+}
+
+template <typename T>
+void VerifyKernel(varint::DecodeKernel<T> kernel) {
+  std::mt19937_64 rng(0);
+  for (size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+    std::vector<T> expected = RandomValues<T>(rng, n);
+    std::vector<uint8_t> bytes;
+    for (T v : expected) {
+      AppendZigZagVarint(v, bytes);
+    }
+    // Trailing byte that must not be consumed.
+    bytes.push_back(1);
+
+    const uint8_t* end = bytes.data() + bytes.size();
+    std::vector<T> actual(n);
+    const uint8_t* pos = kernel(bytes.data(), end, actual.data(), n);
+    ASSERT_EQ(end - 1, pos);
+    EXPECT_EQ(expected, actual);
+
+    if (n > 0) {
+      // The last varint is cut off.
+      pos = kernel(bytes.data(), end - 2, actual.data(), n);
+      EXPECT_EQ(nullptr, pos);
+    }
+  }
+}
+
+template <typename T>
+void VerifyAllSingleByte(varint::DecodeKernel<T> kernel) {
+  std::vector<uint8_t> bytes;
+  std::vector<T> expected;
+  for (int i = 0; i < 100; i++) {
+    T v = static_cast<T>(i % 128 - 64);
+    expected.push_back(v);
+    AppendZigZagVarint(v, bytes);
+  }
+  std::vector<T> actual(expected.size());
+  const uint8_t* end = bytes.data() + bytes.size();
+  ASSERT_EQ(end, kernel(bytes.data(), end, actual.data(), actual.size()));
+  EXPECT_EQ(expected, actual);
+}
+
+}  // namespace
+
+TEST(VarintDecoderTest, Scalar) {
+  VerifyKernel<int>(&varint::DecodeScalar<int>);
+  VerifyKernel<long>(&varint::DecodeScalar<long>);
+  VerifyAllSingleByte<long>(&varint::DecodeScalar<long>);
+}
+
+TEST(VarintDecoderTest, SelectedKernel) {
+  VerifyKernel<int>(varint::SelectKernel<int>());
+  VerifyKernel<long>(varint::SelectKernel<long>());
+  VerifyAllSingleByte<int>(varint::SelectKernel<int>());
+  VerifyAllSingleByte<long>(varint::SelectKernel<long>());
+}
+
+#ifdef ATDS_VARINT_SIMD
+TEST(VarintDecoderTest, SSE41) {
+  if (!io::TestCPUFeature(io::SSE4_1)) {
+    return;
+  }
+  VerifyKernel<int>(&varint::DecodeSSE41<int>);
+  VerifyKernel<long>(&varint::DecodeSSE41<long>);
+  VerifyAllSingleByte<int>(&varint::DecodeSSE41<int>);
+  VerifyAllSingleByte<long>(&varint::DecodeSSE41<long>);
+}
+
+TEST(VarintDecoderTest, AVX2) {
+  if (!io::TestCPUFeature(io::AVX2)) {
+    return;
+  }
+  VerifyKernel<int>(&varint::DecodeAVX2<int>);
+  VerifyKernel<long>(&varint::DecodeAVX2<long>);
+  VerifyAllSingleByte<int>(&varint::DecodeAVX2<int>);
+  VerifyAllSingleByte<long>(&varint::DecodeAVX2<long>);
+}
+#endif
+
+}  // namespace atds
+}  // namespace tensorflow
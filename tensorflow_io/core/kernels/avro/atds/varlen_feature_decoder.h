@@ -34,13 +34,14 @@ namespace varlen {
 struct Metadata {
   Metadata(FeatureType type, const string& name, DataType dtype,
            const PartialTensorShape& shape, size_t indices_index,
-           size_t values_index)
+           size_t values_index, bool ragged = false)
       : type(type),
         name(name),
         dtype(dtype),
         shape(shape),
         indices_index(indices_index),
-        values_index(values_index) {}
+        values_index(values_index),
+        ragged(ragged) {}
 
   FeatureType type;
   string name;
@@ -49,6 +50,9 @@ struct Metadata {
 
   size_t indices_index;
   size_t values_index;
+  // Ragged features of rank 1 only buffer their values, as the row splits
+  // of a batch are given by the number of elements of every record.
+  bool ragged;
 };
 
 inline void FillIndicesBuffer(std::vector<long>& indices_buf,
@@ -58,8 +62,8 @@ inline void FillIndicesBuffer(std::vector<long>& indices_buf,
   }
 }
 
-template <typename T>
-inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
+template <typename T, typename Decoder>
+inline Status DecodeVarlenArray(Decoder& decoder,
                                 std::vector<long>& indices_buf,
                                 std::vector<T>& values_buf,
                                 std::vector<long>& current_indice, int rank,
@@ -95,9 +99,9 @@ inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
           return ShapeError(number, dim, shape);
         }
         for (size_t i = 0; i < m; i++) {
-          TF_RETURN_IF_ERROR(DecodeVarlenArray<T>(decoder, indices_buf,
-                                                  values_buf, current_indice,
-                                                  rank - 1, shape));
+          TF_RETURN_IF_ERROR(DecodeVarlenArray(decoder, indices_buf, values_buf,
+                                               current_indice, rank - 1,
+                                               shape));
           current_indice.back()++;
         }
       }
@@ -119,9 +123,9 @@ inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
     } else {
       for (size_t m = decoder->arrayStart(); m != 0; m = decoder->arrayNext()) {
         for (size_t i = 0; i < m; i++) {
-          TF_RETURN_IF_ERROR(DecodeVarlenArray<T>(decoder, indices_buf,
-                                                  values_buf, current_indice,
-                                                  rank - 1, shape));
+          TF_RETURN_IF_ERROR(DecodeVarlenArray(decoder, indices_buf, values_buf,
+                                               current_indice, rank - 1,
+                                               shape));
           current_indice.back()++;
         }
       }
@@ -132,14 +136,14 @@ inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
   return OkStatus();
 }
 
-// This template specification handles both byte and string.
+// This template overload handles both byte and string.
 // It assumes that avro decodeBytes and decodeString are both reading bytes into
 // uint8 arrays see:
 // https://github.com/apache/avro/blob/branch-1.9/lang/c%2B%2B/impl/BinaryDecoder.cc#L133
 // As long as that as that assumption holds a separate bytes implementation is
 // not required.
-template <>
-inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
+template <typename Decoder>
+inline Status DecodeVarlenArray(Decoder& decoder,
                                 std::vector<long>& indices_buf,
                                 std::vector<string>& values_buf,
                                 std::vector<long>& current_indice, int rank,
@@ -215,6 +219,38 @@ inline Status DecodeVarlenArray(avro::DecoderPtr& decoder,
   return OkStatus();
 }
 
+template <typename T, typename Decoder>
+inline void DecodeValue(Decoder& decoder, std::vector<T>& values_buf) {
+  values_buf.emplace_back(avro::decoder_t::Decode<T>(decoder));
+}
+
+template <typename Decoder>
+inline void DecodeValue(Decoder& decoder, std::vector<string>& values_buf) {
+  values_buf.push_back("");
+  decoder->decodeString(values_buf.back());
+}
+
+// Decodes the values of an array of rank 1 without their indices.
+template <typename T, typename Decoder>
+inline Status DecodeRaggedArray(Decoder& decoder, std::vector<T>& values_buf,
+                                const PartialTensorShape& shape) {
+  int64 size = shape.dim_size(0);
+  int64 number = 0;
+  for (size_t m = decoder->arrayStart(); m != 0; m = decoder->arrayNext()) {
+    number += static_cast<int64>(m);
+    if (TF_PREDICT_FALSE(size > 0 && number > size)) {
+      return ShapeError(number, 0, shape);
+    }
+    for (size_t i = 0; i < m; i++) {
+      DecodeValue(decoder, values_buf);
+    }
+  }
+  if (TF_PREDICT_FALSE(size > 0 && number != size)) {
+    return ShapeError(number, 0, shape);
+  }
+  return OkStatus();
+}
+
 template <typename T>
 class FeatureDecoder : public DecoderBase {
  public:
@@ -226,20 +262,38 @@ class FeatureDecoder : public DecoderBase {
                     sparse::ValueBuffer& buffer,
                     std::vector<avro::GenericDatum>& skipped_data,
                     size_t offset) {
-    // declaring std::vector locally to make it thread safe
-    std::vector<long> current_indices;
-    current_indices.reserve(rank_ + 1);  // additional batch dim.
-    current_indices.resize(1);
-    current_indices[0] = offset;
-    size_t indices_index = metadata_.indices_index;
+    return Decode(decoder, buffer, offset);
+  }
+
+  Status operator()(RawDecoder*& decoder, std::vector<Tensor>& dense_tensors,
+                    sparse::ValueBuffer& buffer,
+                    std::vector<avro::GenericDatum>& skipped_data,
+                    size_t offset) {
+    return Decode(decoder, buffer, offset);
+  }
 
-    auto& indices_buf = buffer.indices[indices_index];
+ private:
+  template <typename Decoder>
+  inline Status Decode(Decoder& decoder, sparse::ValueBuffer& buffer,
+                       size_t offset) {
+    size_t indices_index = metadata_.indices_index;
     auto& values_buf =
         sparse::GetValueVector<T>(buffer, metadata_.values_index);
     size_t values_buf_size = values_buf.size();
-    TF_RETURN_IF_ERROR(DecodeVarlenArray<T>(decoder, indices_buf, values_buf,
-                                            current_indices, rank_,
-                                            metadata_.shape));
+    if (metadata_.ragged) {
+      TF_RETURN_IF_ERROR(
+          DecodeRaggedArray(decoder, values_buf, metadata_.shape));
+    } else {
+      // declaring std::vector locally to make it thread safe
+      std::vector<long> current_indices;
+      current_indices.reserve(rank_ + 1);  // additional batch dim.
+      current_indices.resize(1);
+      current_indices[0] = offset;
+      auto& indices_buf = buffer.indices[indices_index];
+      TF_RETURN_IF_ERROR(DecodeVarlenArray(decoder, indices_buf, values_buf,
+                                           current_indices, rank_,
+                                           metadata_.shape));
+    }
     size_t total_num_elements = values_buf.size() - values_buf_size;
     auto& num_of_elements = buffer.num_of_elements[indices_index];
     if (!num_of_elements.empty()) {
@@ -249,7 +303,6 @@ class FeatureDecoder : public DecoderBase {
     return OkStatus();
   }
 
- private:
   const Metadata& metadata_;
   const int rank_;
 };
@@ -73,6 +73,21 @@ void VarlenDecoderTest(const T& values, DataType dtype,
 
   ValidateBuffer(buffer, varlen_features[0], expected_indices, expected_values,
                  expected_num_elements);
+
+  ASSERT_TRUE(atds_decoder.SupportsRawDecoding());
+  auto bytes = avro::snapshot(*out_stream);
+  RawDecoder raw(bytes->data(), bytes->size());
+  RawDecoder* raw_decoder = &raw;
+  sparse::ValueBuffer raw_buffer;
+  sparse::GetValuesBuffer<Type>(raw_buffer).resize(1);
+  raw_buffer.indices.resize(1);
+  raw_buffer.num_of_elements.resize(1);
+  decode_status =
+      atds_decoder.DecodeATDSDatum(raw_decoder, dense_tensors, raw_buffer,
+                                   skipped_data, static_cast<size_t>(offset));
+  ASSERT_TRUE(decode_status.ok());
+  ValidateBuffer(raw_buffer, varlen_features[0], expected_indices,
+                 expected_values, expected_num_elements);
 }
 
 template <typename T>
@@ -125,6 +140,61 @@ inline void VarlenDecoderTest(const T& values, DataType dtype,
                  expected_num_elements);
 }
 
+template <typename T, typename Type>
+void RaggedDecoderTest(const T& values, DataType dtype,
+                       std::initializer_list<int64> shape,
+                       const std::vector<Type>& expected_values,
+                       const avro::Type avro_type = avro::AVRO_NULL) {
+  string feature_name = "feature";
+  ATDSSchemaBuilder schema_builder = ATDSSchemaBuilder();
+  schema_builder.AddDenseFeature(feature_name, dtype, shape.size(), avro_type);
+
+  avro::ValidSchema writer_schema = schema_builder.BuildVaildSchema();
+  avro::GenericDatum atds_datum(writer_schema);
+  AddDenseValue(atds_datum, feature_name, values);
+
+  avro::OutputStreamPtr out_stream = EncodeAvroGenericDatum(atds_datum);
+
+  std::vector<dense::Metadata> dense_features;
+  std::vector<sparse::Metadata> sparse_features;
+  std::vector<varlen::Metadata> varlen_features;
+  size_t indices_index = 0, values_index = 0;
+  PartialTensorShape tensor_shape(shape);
+  varlen_features.emplace_back(FeatureType::varlen, feature_name, dtype,
+                               tensor_shape, indices_index, values_index,
+                               /*ragged=*/true);
+
+  ATDSDecoder atds_decoder =
+      ATDSDecoder(dense_features, sparse_features, varlen_features);
+  Status init_status = atds_decoder.Initialize(writer_schema);
+  ASSERT_TRUE(init_status.ok());
+
+  std::vector<avro::GenericDatum> skipped_data = atds_decoder.GetSkippedData();
+  std::vector<Tensor> dense_tensors;
+  ASSERT_TRUE(atds_decoder.SupportsRawDecoding());
+  auto bytes = avro::snapshot(*out_stream);
+  sparse::ValueBuffer buffer;
+  sparse::GetValuesBuffer<Type>(buffer).resize(1);
+  buffer.indices.resize(1);
+  buffer.num_of_elements.resize(1);
+  // Decode the record twice to check the running element counts.
+  for (int i = 0; i < 2; i++) {
+    RawDecoder raw(bytes->data(), bytes->size());
+    RawDecoder* raw_decoder = &raw;
+    Status decode_status = atds_decoder.DecodeATDSDatum(
+        raw_decoder, dense_tensors, buffer, skipped_data, i);
+    ASSERT_TRUE(decode_status.ok());
+  }
+
+  std::vector<Type> expected_twice = expected_values;
+  expected_twice.insert(expected_twice.end(), expected_values.begin(),
+                        expected_values.end());
+  std::vector<size_t> expected_num_elements = {expected_values.size(),
+                                               2 * expected_values.size()};
+  ValidateBuffer(buffer, varlen_features[0], {}, expected_twice,
+                 expected_num_elements);
+}
+
 TEST(VarlenDecoderTest, DT_INT32_scalar) {
   int value = -7;
   long offset = 1;
@@ -328,6 +398,26 @@ TEST(VarlenDecoderTest, DT_BOOL_2D) {
                     offset);
 }
 
+TEST(VarlenDecoderTest, DT_INT64_ragged) {
+  std::vector<long> values = {4, 5, 6};
+  RaggedDecoderTest(values, DT_INT64, {-1}, values);
+}
+
+TEST(VarlenDecoderTest, DT_FLOAT_ragged_fixed_size) {
+  std::vector<float> values = {0.5f, -1.0f};
+  RaggedDecoderTest(values, DT_FLOAT, {2}, values);
+}
+
+TEST(VarlenDecoderTest, DT_STRING_ragged) {
+  std::vector<string> values = {"abc", "", "d"};
+  RaggedDecoderTest(values, DT_STRING, {-1}, values);
+}
+
+TEST(VarlenDecoderTest, DT_INT64_ragged_empty) {
+  std::vector<long> values;
+  RaggedDecoderTest(values, DT_INT64, {-1}, values);
+}
+
 }  // namespace varlen
 }  // namespace atds
 }  // namespace tensorflow
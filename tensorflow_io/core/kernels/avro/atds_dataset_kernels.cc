@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/avro/atds_dataset_kernels.h"
 
+#include <algorithm>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 #include <cstring>
+#include <map>
+#include <numeric>
 #include <vector>
 
 #include "api/Compiler.hh"
@@ -29,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_requires.h"
 #include "tensorflow/core/framework/shape_inference.h"
@@ -39,11 +43,18 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/strcat.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
 #include "tensorflow_io/core/kernels/avro/atds/atds_decoder.h"
 #include "tensorflow_io/core/kernels/avro/atds/avro_block_reader.h"
+#include "tensorflow_io/core/kernels/avro/atds/block_buffer_pool.h"
+#include "tensorflow_io/core/kernels/avro/atds/block_cache.h"
 #include "tensorflow_io/core/kernels/avro/atds/decompression_handler.h"
 #include "tensorflow_io/core/kernels/avro/atds/errors.h"
+#include "tensorflow_io/core/kernels/avro/atds/pipeline_stats.h"
+#include "tensorflow_io/core/kernels/avro/atds/raw_decoder.h"
 #include "tensorflow_io/core/kernels/avro/atds/shuffle_handler.h"
+#include "tensorflow_io/core/kernels/avro/atds/tensor_arena.h"
+#include "tensorflow_io/core/kernels/avro/utils/cpu_affinity.h"
 
 namespace tensorflow {
 namespace data {
@@ -75,6 +86,17 @@ void ParallelFor(const std::function<void(size_t)>& f, size_t n,
 /* static */ constexpr const char* const ATDSDatasetOp::kReaderBufferSize;
 /* static */ constexpr const char* const ATDSDatasetOp::kShuffleBufferSize;
 /* static */ constexpr const char* const ATDSDatasetOp::kNumParallelCalls;
+/* static */ constexpr const char* const ATDSDatasetOp::kNumParallelReads;
+/* static */ constexpr const char* const ATDSDatasetOp::kMaxInflightBytes;
+/* static */ constexpr const char* const ATDSDatasetOp::kShuffleMode;
+/* static */ constexpr const char* const ATDSDatasetOp::kShuffleSeed;
+/* static */ constexpr const char* const ATDSDatasetOp::kOutputArena;
+/* static */ constexpr const char* const ATDSDatasetOp::kNumaNode;
+/* static */ constexpr const char* const ATDSDatasetOp::kCPUAffinity;
+/* static */ constexpr const char* const ATDSDatasetOp::kBlockCacheBytes;
+/* static */ constexpr const char* const ATDSDatasetOp::kBlockCacheDir;
+/* static */ constexpr const char* const ATDSDatasetOp::kReaderQueueDepth;
+/* static */ constexpr const char* const ATDSDatasetOp::kFromMemory;
 /* static */ constexpr const char* const ATDSDatasetOp::kFeatureKeys;
 /* static */ constexpr const char* const ATDSDatasetOp::kFeatureTypes;
 /* static */ constexpr const char* const ATDSDatasetOp::kSparseDtypes;
@@ -84,13 +106,54 @@ void ParallelFor(const std::function<void(size_t)>& f, size_t n,
 /* static */ constexpr const char* const ATDSDatasetOp::kDenseType;
 /* static */ constexpr const char* const ATDSDatasetOp::kSparseType;
 /* static */ constexpr const char* const ATDSDatasetOp::kVarlenType;
+/* static */ constexpr const char* const ATDSDatasetOp::kRaggedType;
+/* static */ constexpr const char* const ATDSDatasetOp::kRecordShuffleMode;
+/* static */ constexpr const char* const ATDSDatasetOp::kBlockShuffleMode;
+
+// Keys of the saved iterator state.
+constexpr char kDeterministic[] = "deterministic";
+constexpr char kEpochSeed[] = "epoch_seed";
+constexpr char kSeed[] = "seed";
+constexpr char kSeed2[] = "seed2";
+constexpr char kNumRandomSamples[] = "num_random_samples";
+constexpr char kRandomPosition[] = "random_position";
+constexpr char kNextFileIndex[] = "next_file_index";
+constexpr char kNumBlocksRead[] = "num_blocks_read";
+constexpr char kNumReaders[] = "num_readers";
+constexpr char kReaderActive[] = "reader_active";
+constexpr char kReaderFileIndex[] = "reader_file_index";
+constexpr char kReaderOffset[] = "reader_offset";
+constexpr char kReaderNextBlock[] = "reader_next_block";
+constexpr char kNumBlocks[] = "num_blocks";
+constexpr char kBlockFileIndex[] = "block_file_index";
+constexpr char kBlockFileOffset[] = "block_file_offset";
+constexpr char kBlockSequence[] = "block_sequence";
+constexpr char kBlockNumDecoded[] = "block_num_decoded";
+constexpr char kBlockReadOffset[] = "block_read_offset";
+
+// The component of the blocks of the iterators in the memory budget.
+constexpr char kBudgetComponent[] = "atds";
+
+// The tunable number of blocks that the readers may read ahead of the
+// shuffle buffer, and its bounds when tuned by the tf.data model.
+constexpr char kPrefetchBlocks[] = "prefetch_blocks";
+constexpr int64 kMaxAutotunePrefetchBlocks = 64;
+// The decode parallelism that the tf.data model starts from, as its
+// parallel map does.
+constexpr int64 kAutotuneInitialParallelism = 16;
 
 class ATDSDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<tstring> filenames,
                    size_t batch_size, bool drop_remainder,
                    int64 reader_buffer_size, int64 shuffle_buffer_size,
-                   int64 num_parallel_calls,
+                   int64 num_parallel_calls, int64 num_parallel_reads,
+                   int64 max_inflight_bytes, const string& shuffle_mode,
+                   int64 shuffle_seed, bool output_arena, int64 numa_node,
+                   const string& cpu_affinity, const std::vector<int>& cpus,
+                   int64 block_cache_bytes, const string& block_cache_dir,
+                   int64 reader_queue_depth, bool from_memory,
+                   const Tensor& contents,
                    const std::vector<string>& feature_keys,
                    const std::vector<string>& feature_types,
                    const std::vector<DataType>& sparse_dtypes,
@@ -103,20 +166,40 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
         reader_buffer_size_(reader_buffer_size),
         shuffle_buffer_size_(shuffle_buffer_size),
         num_parallel_calls_(num_parallel_calls),
+        num_parallel_reads_(num_parallel_reads),
+        max_inflight_bytes_(max_inflight_bytes),
+        shuffle_seed_(shuffle_seed),
+        numa_node_(numa_node),
         drop_remainder_(drop_remainder),
+        output_arena_(output_arena),
+        shuffle_mode_(shuffle_mode),
+        cpu_affinity_(cpu_affinity),
+        cpus_(cpus),
+        block_cache_bytes_(block_cache_bytes),
+        block_cache_dir_(block_cache_dir),
+        reader_queue_depth_(reader_queue_depth),
+        from_memory_(from_memory),
+        contents_(contents),
         feature_keys_(feature_keys),
         feature_types_(feature_types),
         sparse_dtypes_(sparse_dtypes),
         sparse_shapes_(sparse_shapes),
         output_dtypes_(output_dtypes),
         output_shapes_(output_shapes) {
+    if (block_cache_bytes_ > 0 || !block_cache_dir_.empty()) {
+      block_cache_ = std::make_shared<BlockCache>(
+          Env::Default(), block_cache_bytes_, block_cache_dir_);
+    }
     size_t num_of_features = feature_keys_.size();
     output_tensor_types_.reserve(num_of_features);
     sparse_value_index_.reserve(sparse_dtypes.size());
+    // Ragged features have two output tensors, so the outputs of a feature
+    // are not at the index of the feature.
+    size_t output_index = 0;
     for (size_t i = 0; i < num_of_features; i++) {
       if (feature_types[i] == kDenseType) {
         output_tensor_types_.emplace_back(TensorType::dense);
-        auto dim_v = output_shapes[i].dim_sizes();
+        auto dim_v = output_shapes[output_index].dim_sizes();
         size_t rank = dim_v.size();
 
         TensorShapeProto proto;
@@ -129,17 +212,24 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
                         "dense features.";
         }
         dense_features_.emplace_back(atds::FeatureType::dense, feature_keys_[i],
-                                     output_dtypes[i], shape, num_of_dense_);
+                                     output_dtypes[output_index], shape,
+                                     num_of_dense_);
         num_of_dense_++;
+        output_index++;
       } else if (feature_types[i] == kSparseType ||
-                 feature_types[i] == kVarlenType) {
-        output_tensor_types_.emplace_back(TensorType::sparse);
+                 feature_types[i] == kVarlenType ||
+                 feature_types[i] == kRaggedType) {
+        bool ragged = feature_types[i] == kRaggedType;
+        output_tensor_types_.emplace_back(ragged ? TensorType::ragged
+                                                 : TensorType::sparse);
+        sparse_ragged_.push_back(ragged);
+        output_index += ragged ? 2 : 1;
 
         auto& shape = sparse_shapes[num_of_sparse_];
         // The estimated number of elements in this sparse tensor.
         // The estimated number is used to preallocate sparse value buffer.
         size_t estimated_elements = 1;
-        if (feature_types[i] == kVarlenType) {
+        if (feature_types[i] != kSparseType) {
           for (auto dim : shape) {
             // Assume unknown dim will only have 1 element. For example,
             // varlen tensor with shape [-1, 2, -1] is expected to have 2
@@ -149,7 +239,9 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
             }
           }
         }
-        size_t rank_after_batch = static_cast<size_t>(shape.dims() + 1);
+        // Ragged features buffer no indices.
+        size_t rank_after_batch =
+            ragged ? 0 : static_cast<size_t>(shape.dims() + 1);
         sparse_expected_elements_.indices.push_back(rank_after_batch *
                                                     estimated_elements);
 
@@ -181,11 +273,11 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
               atds::FeatureType::sparse, feature_keys_[i],
               sparse_dtypes[num_of_sparse_], sparse_shapes[num_of_sparse_],
               num_of_sparse_, values_index);
-        } else if (feature_types[i] == kVarlenType) {
+        } else {
           varlen_features_.emplace_back(
               atds::FeatureType::varlen, feature_keys_[i],
               sparse_dtypes[num_of_sparse_], sparse_shapes[num_of_sparse_],
-              num_of_sparse_, values_index);
+              num_of_sparse_, values_index, ragged);
         }
         num_of_sparse_++;
       } else {
@@ -239,7 +331,29 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
         b->AddScalar(shuffle_buffer_size_, &shuffle_buffer_size));
     Node* num_parallel_calls = nullptr;
     TF_RETURN_IF_ERROR(b->AddScalar(num_parallel_calls_, &num_parallel_calls));
-
+    Node* num_parallel_reads = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(num_parallel_reads_, &num_parallel_reads));
+    Node* max_inflight_bytes = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(max_inflight_bytes_, &max_inflight_bytes));
+
+    AttrValue shuffle_mode;
+    b->BuildAttrValue(shuffle_mode_, &shuffle_mode);
+    AttrValue shuffle_seed;
+    b->BuildAttrValue(shuffle_seed_, &shuffle_seed);
+    AttrValue output_arena;
+    b->BuildAttrValue(output_arena_, &output_arena);
+    AttrValue numa_node;
+    b->BuildAttrValue(numa_node_, &numa_node);
+    AttrValue cpu_affinity;
+    b->BuildAttrValue(cpu_affinity_, &cpu_affinity);
+    AttrValue block_cache_bytes;
+    b->BuildAttrValue(block_cache_bytes_, &block_cache_bytes);
+    AttrValue block_cache_dir;
+    b->BuildAttrValue(block_cache_dir_, &block_cache_dir);
+    AttrValue reader_queue_depth;
+    b->BuildAttrValue(reader_queue_depth_, &reader_queue_depth);
+    AttrValue from_memory;
+    b->BuildAttrValue(from_memory_, &from_memory);
     AttrValue feature_keys;
     b->BuildAttrValue(feature_keys_, &feature_keys);
     AttrValue feature_types;
@@ -256,8 +370,18 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     TF_RETURN_IF_ERROR(b->AddDataset(
         this,
         {filenames, batch_size, drop_remainder, reader_buffer_size,
-         shuffle_buffer_size, num_parallel_calls},
-        {{kFeatureKeys, feature_keys},
+         shuffle_buffer_size, num_parallel_calls, num_parallel_reads,
+         max_inflight_bytes},
+        {{kShuffleMode, shuffle_mode},
+         {kShuffleSeed, shuffle_seed},
+         {kOutputArena, output_arena},
+         {kNumaNode, numa_node},
+         {kCPUAffinity, cpu_affinity},
+         {kBlockCacheBytes, block_cache_bytes},
+         {kBlockCacheDir, block_cache_dir},
+         {kReaderQueueDepth, reader_queue_depth},
+         {kFromMemory, from_memory},
+         {kFeatureKeys, feature_keys},
          {kFeatureTypes, feature_types},
          {kSparseDtypes, sparse_dtypes},
          {kSparseShapes, sparse_shapes},
@@ -268,7 +392,7 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
   }
 
  private:
-  enum class TensorType { dense, sparse };
+  enum class TensorType { dense, sparse, ragged };
 
   /**
    * Utility struct to collect the number of sparse tensors for each DType.
@@ -307,6 +431,9 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
         "DeflateDecompression";
     static constexpr const char* const kSnappyDecompression =
         "SnappyDecompression";
+    static constexpr const char* const kZstandardDecompression =
+        "ZstandardDecompression";
+    static constexpr const char* const kLz4Decompression = "Lz4Decompression";
     static constexpr const char* const kFillingSparseValues =
         "FillingSparseValues";
 
@@ -316,12 +443,40 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
           cond_var_(std::make_shared<condition_variable>()),
           write_var_(std::make_shared<condition_variable>()),
           mu_(std::make_shared<mutex>()),
+          autotune_mu_(std::make_shared<mutex>()),
           count_(0) {
       batch_size_ = static_cast<size_t>(dataset()->batch_size_);
       shuffle_buffer_size_ =
           static_cast<size_t>(dataset()->shuffle_buffer_size_);
-      shuffle_handler_ = std::make_unique<ShuffleHandler>(mu_.get());
-      decompression_handler_ = std::make_unique<DecompressionHandler>();
+      block_shuffle_ = dataset()->shuffle_mode_ == kBlockShuffleMode;
+      shuffle_handler_ = std::make_unique<ShuffleHandler>(
+          mu_.get(), dataset()->shuffle_seed_, dataset()->NextEpoch());
+      // Reading ahead of the buffer would make the sampled blocks depend on
+      // timing, so a deterministic shuffle never reads ahead.
+      bool autotune = dataset()->num_parallel_calls_ == model::kAutotune;
+      parallelism_ = std::make_shared<model::SharedState>(
+          dataset()->num_parallel_calls_, autotune_mu_, write_var_);
+      prefetch_blocks_ = std::make_shared<model::SharedState>(
+          autotune && !shuffle_handler_->deterministic() ? model::kAutotune
+                                                         : 0,
+          autotune_mu_, write_var_);
+      file_order_.resize(dataset()->filenames_.size());
+      std::iota(file_order_.begin(), file_order_.end(), 0);
+      if (block_shuffle_) {
+        shuffle_handler_->Permute(ShuffleHandler::kFileOrderStream,
+                                  file_order_);
+      }
+      reader_cursors_.resize(NumReaders());
+      if (dataset()->output_arena_) {
+        // One slot per dense tensor and two per sparse tensor for its indices
+        // and values, or for its row splits and values if ragged.
+        tensor_arena_ = std::make_unique<TensorArena>(
+            dataset()->num_of_dense_ + 2 * dataset()->num_of_sparse_);
+      }
+      expected_elements_ = dataset()->sparse_expected_elements_;
+      block_buffer_pool_ = std::make_unique<BlockBufferPool>();
+      decompression_handler_ =
+          std::make_unique<DecompressionHandler>(block_buffer_pool_.get());
       auto& sparse_dtype_counts = dataset()->sparse_dtype_counts_;
       value_buffer_.int_values.resize(sparse_dtype_counts.int_counts);
       value_buffer_.long_values.resize(sparse_dtype_counts.long_counts);
@@ -336,12 +491,16 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     ~Iterator() override {
       // must ensure that the thread is cancelled.
       CancelThreads();
-      // LOG(INFO) << "Decompression time per record (us): "  <<
-      // (static_cast<double>(GetTotalStats(total_decompress_micros_)) /
-      // GetTotalStats(num_decompressed_objects_)); LOG(INFO) << "Decode time
-      // per record (us): " <<
-      // (static_cast<double>(GetTotalStats(total_decode_micros_)) /
-      // GetTotalStats(total_records_parsed_));
+      {
+        mutex_lock l(*mu_);
+        mutex_lock i(input_mu_);
+        io::MemoryBudget::Global()->Release(kBudgetComponent,
+                                            budgeted_bytes_ + inflight_bytes_);
+      }
+      VLOG(1) << "ATDSDataset iterator stats: " << stats_.DebugString()
+              << ", parsing thread start delay (us): "
+              << PipelineStats::PerItem(GetTotalStats(thread_delays),
+                                        GetTotalStats(thread_itrs));
     }
 
     void CancelThreads() TF_LOCKS_EXCLUDED(mu_) {
@@ -350,11 +509,9 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
       cancelled_ = true;
       cond_var_->notify_all();
       write_var_->notify_all();
-      // wait for thread to finish
-      if (prefetch_thread_) {
-        while (!prefetch_thread_finished_) {
-          write_var_->wait(i);
-        }
+      // wait for all reader threads and decompression tasks to finish
+      while (num_active_readers_ > 0 || num_pending_decompressions_ > 0) {
+        write_var_->wait(i);
       }
     }
 
@@ -371,10 +528,31 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
                   << " for this process.";
         num_threads = max_parallelism;
       }
+      const std::vector<int>& cpus = dataset()->cpus_;
+      if (!cpus.empty() && num_threads > static_cast<int64>(cpus.size())) {
+        // More decode threads than pinned CPUs would only contend.
+        num_threads = static_cast<int64>(cpus.size());
+      }
       thread_delays.resize(max_parallelism, 0);
       thread_itrs.resize(max_parallelism, 0);
       thread_pool_ =
           ctx->CreateThreadPool(std::string(kDatasetType), num_threads);
+      PinThreadPool(thread_pool_.get(), cpus);
+      if (dataset()->reader_queue_depth_ > 1) {
+        // The reads in flight of all reader threads. They mostly wait for
+        // storage, so they are not pinned nor bounded by the CPUs.
+        read_thread_pool_ = ctx->CreateThreadPool(
+            "ATDSRead", static_cast<int64>(NumReaders()) *
+                            dataset()->reader_queue_depth_);
+      }
+      mutex_lock l(*autotune_mu_);
+      if (parallelism_->value == model::kAutotune) {
+        parallelism_->value =
+            std::min(num_threads, kAutotuneInitialParallelism);
+      }
+      if (prefetch_blocks_->value == model::kAutotune) {
+        prefetch_blocks_->value = 1;
+      }
       return OkStatus();
     }
 
@@ -394,26 +572,47 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
           tensorflow::profiler::TraceMe trace(kWaitingForData);
 
           mutex_lock i(input_mu_);
-          while (!cancelled_ && !prefetch_thread_finished_ &&
-                 count_ < total_buffer) {
-            // LOG(INFO) << "waiting on block refill " << blocks_.size() << "
-            // count: " << count_;
+          while (true) {
+            while (!cancelled_ && !prefetch_thread_finished_ &&
+                   !BufferFilled(total_buffer) && !InflightBytesExceeded()) {
+              // LOG(INFO) << "waiting on block refill " << blocks_.size() << "
+              // count: " << count_;
+              write_var_->notify_all();
+              // Time spent waiting for the readers is not processing time of
+              // this iterator in the tf.data model.
+              uint64 wait_start_time = ctx->env()->NowMicros();
+              RecordStop(ctx);
+              cond_var_->wait(i);
+              RecordStart(ctx);
+              stats_.RecordWaitForData(ctx->env()->NowMicros() -
+                                       wait_start_time);
+            }
+            // LOG(INFO) << "done waiting on block refill " << blocks_.size()
+            // << " count: " << count_;
+            if (cancelled_) {
+              return OkStatus();
+            }
+
+            // merge write_blocks_ into blocks_
+            blocks_.reserve(blocks_.size() + write_blocks_.size());
+            blocks_.insert(blocks_.end(),
+                           std::make_move_iterator(write_blocks_.begin()),
+                           std::make_move_iterator(write_blocks_.end()));
+            write_blocks_.clear();  // size down the write_blocks
+            io::MemoryBudget::Global()->Release(kBudgetComponent,
+                                                inflight_bytes_);
+            inflight_bytes_ = 0;
+            read_ahead_blocks_ = 0;
+            max_read_ahead_blocks_ = TunedValue(*prefetch_blocks_);
+            if (prefetch_thread_finished_ || BufferFilled(total_buffer)) {
+              break;
+            }
+            // Woken up only to drain the in-flight bytes. Let the readers
+            // continue until the buffer holds enough records.
             write_var_->notify_all();
-            cond_var_->wait(i);
-          }
-          // LOG(INFO) << "done waiting on block refill " << blocks_.size() << "
-          // count: " << count_;
-          if (cancelled_) {
-            return OkStatus();
           }
 
           count_ = 0;
-          // merge write_blocks_ into blocks_
-          blocks_.reserve(blocks_.size() + write_blocks_.size());
-          blocks_.insert(blocks_.end(),
-                         std::make_move_iterator(write_blocks_.begin()),
-                         std::make_move_iterator(write_blocks_.end()));
-          write_blocks_.clear();  // size down the write_blocks
 
           size_t non_empty_idx = 0;
           for (size_t i = 0; i < blocks_.size(); i++) {
@@ -423,7 +622,11 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
               non_empty_idx++;
             }
           }
+          for (size_t i = non_empty_idx; i < blocks_.size(); i++) {
+            decompression_handler_->RecycleBlock(*blocks_[i]);
+          }
           blocks_.resize(non_empty_idx);
+          RecordBufferedBlocks(ctx);
 
           count = count_;
           prefetch_thread_finished = prefetch_thread_finished_;
@@ -454,8 +657,13 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
             auto& dense_feature = dense_features[i];
             TensorShape shape;
             batch_dim.Concatenate(dense_feature.shape).AsTensorShape(&shape);
-            dense_tensors.emplace_back(ctx->allocator({}), dense_feature.dtype,
-                                       shape);
+            if (tensor_arena_) {
+              dense_tensors.emplace_back(tensor_arena_->Acquire(
+                  i, ctx->allocator({}), dense_feature.dtype, shape));
+            } else {
+              dense_tensors.emplace_back(ctx->allocator({}),
+                                         dense_feature.dtype, shape);
+            }
           }
 
           size_t thread_pool_size =
@@ -471,16 +679,33 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
                 num_threads, static_cast<size_t>(user_defined_thread_num));
           } else if (user_defined_thread_num ==
                      tensorflow::data::model::kAutotune) {
-            num_threads = ComputeNumAutotuneThreads(num_threads);
+            if (ctx->model()) {
+              num_threads = std::min(
+                  num_threads,
+                  std::max(TunedValue(*parallelism_), static_cast<size_t>(1)));
+            } else {
+              num_threads = ComputeNumAutotuneThreads(num_threads);
+            }
           }
           total_records_parsed_.resize(num_threads, 0);
           total_decode_micros_.resize(num_threads, 0);
           num_decompressed_objects_.resize(num_threads, 0);
           total_decompress_micros_.resize(num_threads, 0);
-          shuffle_handler_->SampleBlocks(batch_size, shuffle_buffer_size_ > 0,
-                                         blocks_);
-          std::vector<atds::sparse::ValueBuffer> sparse_buffer(num_threads,
-                                                               value_buffer_);
+          // Block shuffle always interleaves the records of the resident
+          // blocks, even without a shuffle buffer.
+          shuffle_handler_->SampleBlocks(
+              batch_size, shuffle_buffer_size_ > 0 || block_shuffle_, blocks_);
+          // The arena keeps the sparse buffers and their capacity across
+          // batches.
+          std::vector<atds::sparse::ValueBuffer> batch_buffer;
+          std::vector<atds::sparse::ValueBuffer>& sparse_buffer =
+              tensor_arena_ ? sparse_buffer_ : batch_buffer;
+          if (sparse_buffer.size() < num_threads) {
+            sparse_buffer.resize(num_threads, value_buffer_);
+          }
+          for (size_t t = 0; t < num_threads; t++) {
+            atds::sparse::ClearValueBuffer(sparse_buffer[t]);
+          }
 
           std::vector<Status> status_of_threads(num_threads);
           auto process_block = [&](size_t i, size_t thread_idx,
@@ -499,32 +724,15 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
             //   << " num_to_decode: " << blocks_[i]->num_to_decode << "
             //   remaining: " << (blocks_[i]->object_count -
             //   blocks_[i]->num_decoded);
-            avro::Codec codec = blocks_[i]->codec;
-            avro::InputStreamPtr input_stream = nullptr;
+            BlockCodec codec = blocks_[i]->codec;
             uint64 decompress_start_time = ctx->env()->NowMicros();
-            if (codec == avro::NULL_CODEC) {
-              input_stream =
-                  decompression_handler_->decompressNullCodec(*(blocks_[i]));
-            } else if (codec == avro::DEFLATE_CODEC) {
-              tensorflow::profiler::TraceMe traceme(kDeflateDecompression);
-              input_stream =
-                  decompression_handler_->decompressDeflateCodec(*(blocks_[i]));
-            }
-#ifdef SNAPPY_CODEC_AVAILABLE
-            else if (codec == avro::SNAPPY_CODEC) {
-              tensorflow::profiler::TraceMe traceme(kSnappyDecompression);
-              input_stream =
-                  decompression_handler_->decompressSnappyCodec(*(blocks_[i]));
-            }
-#endif
-            else {
-              throw avro::Exception(
-                  "Unsupported Avro codec. Only null or deflate is supported. "
-                  "Got " +
-                  codec);
+            if (codec != NULL_CODEC) {
+              // Blocks are normally decompressed by the pipelined
+              // decompression stage already.
+              TF_RETURN_IF_ERROR(DecompressBlock(*(blocks_[i])));
             }
             uint64 decompress_end_time = ctx->env()->NowMicros();
-            if (codec != avro::NULL_CODEC) {
+            if (codec != NULL_CODEC) {
               total_decompress_micros_[thread_idx] +=
                   (decompress_end_time - decompress_start_time);
               num_decompressed_objects_[thread_idx] += blocks_[i]->object_count;
@@ -532,30 +740,53 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
               // (decompress_end_time - decompress_start_time)
               //     << ", num records: " << blocks_[i]->object_count;
             }
-            decoder->init(*input_stream);
+            auto decode_datums = [&](auto& datum_decoder) -> Status {
+              while (start < end) {
+                // LOG(INFO) << "Block: " << i << " start: " << start;
+                uint64 datum_parse_start = ctx->env()->NowMicros();
+                auto decoding_status = atds_decoder_->DecodeATDSDatum(
+                    datum_decoder, dense_tensors, buffer, skipped, start);
+                if (!decoding_status.ok()) {
+                  // The decoding of this block has failed,
+                  // setting the number of decoded objects to the total number
+                  // of objects in the block so the decoder will skip decoding
+                  // this block.
+                  blocks_[i]->num_decoded = blocks_[i]->object_count;
+                  return decoding_status;
+                }
+                uint64 datum_parse_end = ctx->env()->NowMicros();
+                total_decode_micros_[thread_idx] +=
+                    (datum_parse_end - datum_parse_start);
+                total_records_parsed_[thread_idx] += 1;
+                start++;
+                blocks_[i]->num_decoded++;
+                blocks_[i]->num_to_decode--;
+              }
+              return OkStatus();
+            };
 
-            while (start < end) {
-              // LOG(INFO) << "Block: " << i << " start: " << start;
-              uint64 datum_parse_start = ctx->env()->NowMicros();
-              auto decoding_status = atds_decoder_->DecodeATDSDatum(
-                  decoder, dense_tensors, buffer, skipped, start);
-              if (!decoding_status.ok()) {
-                // The decoding of this block has failed,
-                // setting the number of decoded objects to the total number of
-                // objects in the block so the decoder will skip decoding this
-                // block.
-                blocks_[i]->num_decoded = blocks_[i]->object_count;
-                return decoding_status;
+            if (atds_decoder_->SupportsRawDecoding()) {
+              // Decode straight from the block bytes with the inlined reads of
+              // RawDecoder instead of going through the avro input stream.
+              auto& block = *(blocks_[i]);
+              const tstring& content = block.content;
+              const uint8_t* data =
+                  reinterpret_cast<const uint8_t*>(content.data());
+              atds::RawDecoder raw(data + block.read_offset,
+                                   block.content.size() - block.read_offset);
+              atds::RawDecoder* raw_decoder = &raw;
+              TF_RETURN_IF_ERROR(decode_datums(raw_decoder));
+              if (block.object_count > block.num_decoded) {
+                block.read_offset += raw.byteCount();
               }
-              uint64 datum_parse_end = ctx->env()->NowMicros();
-              total_decode_micros_[thread_idx] +=
-                  (datum_parse_end - datum_parse_start);
-              total_records_parsed_[thread_idx] += 1;
-              start++;
-              blocks_[i]->num_decoded++;
-              blocks_[i]->num_to_decode--;
+              return OkStatus();
             }
 
+            avro::InputStreamPtr input_stream =
+                decompression_handler_->decompressNullCodec(*(blocks_[i]));
+            decoder->init(*input_stream);
+            TF_RETURN_IF_ERROR(decode_datums(decoder));
+
             if (blocks_[i]->object_count > blocks_[i]->num_decoded) {
               decoder->init(*input_stream);
               blocks_[i]->read_offset += input_stream->byteCount();
@@ -601,12 +832,17 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
             status_of_threads[index] = OkStatus();
             auto& status = status_of_threads[index];
 
+            uint64 records_parsed = total_records_parsed_[index];
+            uint64 decode_micros = total_decode_micros_[index];
             for (size_t i = block_start; i < block_end && status.ok(); i++) {
-              if (blocks_[i]->codec != avro::NULL_CODEC ||
+              if (blocks_[i]->codec != NULL_CODEC ||
                   blocks_[i]->num_to_decode > 0) {
                 status = process_block(i, index, decoder, buffer, skipped);
               }
             }
+            stats_.RecordRecordsDecoded(
+                total_records_parsed_[index] - records_parsed,
+                total_decode_micros_[index] - decode_micros);
             // LOG(INFO) << "Thread " << index << " process blocks from " <<
             // block_start << " to " << block_end << ". Done.";
           };
@@ -621,7 +857,20 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
             TF_RETURN_IF_ERROR(status);
           }
 
+          // The elements of each feature buffered by each decode thread.
+          std::vector<std::vector<size_t>> thread_elements(num_threads);
           std::vector<int64> num_of_elements(num_of_sparse, 0);
+          for (size_t t = 0; t < num_threads; t++) {
+            thread_elements[t].resize(num_of_sparse);
+            for (size_t i = 0; i < num_of_sparse; i++) {
+              // Check if vector is empty and move on to the next vector.
+              // If shuffle buffer and number of threads is large compared
+              // to the batch, this vector maybe empty for certain threads.
+              thread_elements[t][i] =
+                  GetLastElement(sparse_buffer[t].num_of_elements[i]);
+              num_of_elements[i] += static_cast<int64>(thread_elements[t][i]);
+            }
+          }
           std::vector<Tensor> indices_tensors;
           std::vector<Tensor> values_tensors;
           std::vector<Tensor> shape_tensors;
@@ -630,75 +879,122 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
           shape_tensors.reserve(num_of_sparse);
           auto& sparse_dtypes = dataset()->sparse_dtypes_;
           auto& sparse_shapes = dataset()->sparse_shapes_;
+          auto& sparse_ragged = dataset()->sparse_ragged_;
+          // The position of the dims of each feature in the dims of all.
+          std::vector<size_t> rank_offsets(num_of_sparse, 0);
+          size_t total_rank = 0;
           for (size_t i = 0; i < num_of_sparse; i++) {
-            for (size_t t = 0; t < num_threads; t++) {
-              // Check if vector is empty and move on to the next vector.
-              // If shuffle buffer and number of threads is large compared
-              // to the batch, this vector maybe empty for certain threads.
-              num_of_elements[i] += static_cast<int64>(
-                  GetLastElement(sparse_buffer[t].num_of_elements[i]));
-            }
             auto& sparse_shape = sparse_shapes[i];
+            rank_offsets[i] = total_rank;
+            total_rank += static_cast<size_t>(sparse_shape.dims() + 1);
 
             int64 rank = sparse_shape.dims() + 1;
-            TensorShape indices_shape({num_of_elements[i], rank});
+            // The indices of a ragged feature are its row splits instead.
+            TensorShape indices_shape =
+                sparse_ragged[i]
+                    ? TensorShape({static_cast<int64>(batch_size) + 1})
+                    : TensorShape({num_of_elements[i], rank});
             TensorShape values_shape({num_of_elements[i]});
             TensorShape shape_shape({rank});
-            indices_tensors.emplace_back(DT_INT64, indices_shape);
-            values_tensors.emplace_back(sparse_dtypes[i], values_shape);
+            if (tensor_arena_) {
+              size_t slot = num_of_dense + 2 * i;
+              indices_tensors.emplace_back(tensor_arena_->Acquire(
+                  slot, ctx->allocator({}), DT_INT64, indices_shape));
+              values_tensors.emplace_back(tensor_arena_->Acquire(
+                  slot + 1, ctx->allocator({}), sparse_dtypes[i],
+                  values_shape));
+            } else {
+              indices_tensors.emplace_back(DT_INT64, indices_shape);
+              values_tensors.emplace_back(sparse_dtypes[i], values_shape);
+            }
             shape_tensors.emplace_back(DT_INT64, shape_shape);
+          }
+
+          // The copies of the buffered elements are split across both the
+          // features and the decode threads, into shards of about as many
+          // elements each, so that a few large features do not hold up the
+          // rest. The shards also look for the largest index of each dim of
+          // unknown size, among the indices they copy.
+          std::vector<std::vector<atds::sparse::FillRange>> fill_shards =
+              atds::sparse::ShardFillRanges(thread_elements, num_of_sparse,
+                                            num_threads);
+          std::vector<std::vector<long>> max_dims(
+              fill_shards.size(), std::vector<long>(total_rank, -1));
+          auto& sparse_value_index = dataset()->sparse_value_index_;
+          auto fill_sparse_value = [&](size_t shard) {
+            auto& max_dim = max_dims[shard];
+            for (const atds::sparse::FillRange& range : fill_shards[shard]) {
+              const size_t i = range.feature;
+              auto& buffer = sparse_buffer[range.thread];
+              auto& indices = buffer.indices[i];
+              atds::sparse::FillValuesTensor(
+                  buffer, values_tensors[i], sparse_dtypes[i],
+                  sparse_value_index[i], range.begin, range.end, range.offset);
+              if (sparse_ragged[i]) {
+                continue;
+              }
+              auto& sparse_shape = sparse_shapes[i];
+              size_t rank = static_cast<size_t>(sparse_shape.dims() + 1);
+              for (size_t d = 1; d < rank; d++) {
+                if (sparse_shape.dim_size(d - 1) > 0) {
+                  continue;
+                }
+                long& max_index = max_dim[rank_offsets[i] + d];
+                for (size_t pos = range.begin * rank + d;
+                     pos < range.end * rank; pos += rank) {
+                  max_index = std::max(max_index, indices[pos]);
+                }
+              }
+              atds::sparse::FillIndicesTensor(indices, indices_tensors[i],
+                                              rank, range.begin, range.end,
+                                              range.offset);
+            }
+          };
 
-            auto& shape_tensor = shape_tensors.back();
+          {
+            tensorflow::profiler::TraceMe trace(kFillingSparseValues);
+            uint64 fill_start_time = ctx->env()->NowMicros();
+            ParallelFor(fill_sparse_value, fill_shards.size(),
+                        thread_pool_.get());
+            stats_.RecordFillSparse(ctx->env()->NowMicros() - fill_start_time);
+          }
+
+          for (size_t i = 0; i < num_of_sparse; i++) {
+            if (sparse_ragged[i]) {
+              // The records of each thread follow the records of the threads
+              // before it, so the row splits are the running element counts
+              // of the records, offset by the elements of the threads before.
+              auto row_splits = indices_tensors[i].vec<int64>();
+              size_t row = 0;
+              int64 thread_offset = 0;
+              row_splits(row++) = 0;
+              for (size_t t = 0; t < num_threads; t++) {
+                for (size_t count : sparse_buffer[t].num_of_elements[i]) {
+                  row_splits(row++) = thread_offset + static_cast<int64>(count);
+                }
+                thread_offset += static_cast<int64>(thread_elements[t][i]);
+              }
+              continue;
+            }
+            auto& shape_tensor = shape_tensors[i];
             size_t d = 0;
             shape_tensor.vec<long>()(d++) = batch_size;
-            for (auto dim : sparse_shape) {
+            for (auto dim : sparse_shapes[i]) {
               if (dim.size > 0) {
                 shape_tensor.vec<long>()(d++) = dim.size;
               } else {
-                // When dim size is unknown i.e. -1, scan indices array to find
-                // the largest dim value.
-                long max_dim = -1;
-                for (size_t t = 0; t < num_threads; t++) {
-                  auto& indices = sparse_buffer[t].indices[i];
-                  for (size_t pos = d; pos < indices.size(); pos += rank) {
-                    max_dim = std::max(max_dim, indices[pos]);
-                  }
+                // When dim size is unknown i.e. -1, the dim is one past the
+                // largest index that the shards found.
+                long max_index = -1;
+                for (auto& max_dim : max_dims) {
+                  max_index = std::max(max_index, max_dim[rank_offsets[i] + d]);
                 }
-                shape_tensor.vec<long>()(d++) = max_dim + 1;
+                shape_tensor.vec<long>()(d++) = max_index + 1;
               }
             }
           }
-
-          auto& sparse_value_index = dataset()->sparse_value_index_;
-          auto fill_sparse_value = [&](int64 thread_index) {
-            // LOG(INFO) << "Thread " << thread_index << " starts filling sparse
-            // value";
-            auto& buffer = sparse_buffer[thread_index];
-            for (size_t i = 0; i < num_of_sparse; i++) {
-              size_t offset = 0;
-              int64 index = thread_index;
-              while (index > 0) {
-                index--;
-                offset +=
-                    GetLastElement(sparse_buffer[index].num_of_elements[i]);
-              }
-
-              size_t rank_after_batch =
-                  static_cast<size_t>(sparse_shapes[i].dims() + 1);
-              atds::sparse::FillIndicesTensor(buffer.indices[i],
-                                              indices_tensors[i],
-                                              rank_after_batch * offset);
-              atds::sparse::FillValuesTensor(buffer, values_tensors[i],
-                                             sparse_dtypes[i],
-                                             sparse_value_index[i], offset);
-              // LOG(INFO) << "Thread " << thread_index << " filled sparse
-              // values.";
-            }
-          };
-
-          {
-            tensorflow::profiler::TraceMe trace(kFillingSparseValues);
-            ParallelFor(fill_sparse_value, num_threads, thread_pool_.get());
+          if (tensor_arena_) {
+            UpdateExpectedElements(num_of_elements, batch_size);
           }
 
           size_t feature_num = num_of_dense + num_of_sparse;
@@ -718,6 +1014,12 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
               serialized_sparse_t.vec<Variant>()(2) =
                   std::move(shape_tensors[sparse_index]);
               sparse_index++;
+            } else if (feature_types[i] == TensorType::ragged) {
+              out_tensors->emplace_back(
+                  std::move(values_tensors[sparse_index]));
+              out_tensors->emplace_back(
+                  std::move(indices_tensors[sparse_index]));
+              sparse_index++;
             }
           }
           // LOG(INFO) << "Done with batch " ;
@@ -731,20 +1033,236 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     }
 
    protected:
+    // The decode threads and the read ahead blocks work asynchronously to
+    // the consumer, and are tuned by the tf.data model if num_parallel_calls
+    // is AUTOTUNE.
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
-      return model::MakeSourceNode(std::move(args));
+      return model::MakeAsyncKnownRatioNode(
+          std::move(args), /*ratio=*/1,
+          {model::MakeParameter(model::kParallelism, parallelism_, /*min=*/1,
+                                /*max=*/port::MaxParallelism()),
+           model::MakeParameter(kPrefetchBlocks, prefetch_blocks_, /*min=*/0,
+                                /*max=*/kMaxAutotunePrefetchBlocks)});
+    }
+
+    // Shows the per-stage statistics in the tf.data profiler next to the
+    // iterator's processing time.
+    TraceMeMetadata GetTraceMeMetadata() const override {
+      PipelineStats::Snapshot s = stats_.GetSnapshot();
+      TraceMeMetadata result;
+      result.push_back(
+          std::make_pair("bytes_read", strings::StrCat(s.bytes_read)));
+      result.push_back(
+          std::make_pair("blocks_read", strings::StrCat(s.blocks_read)));
+      result.push_back(std::make_pair(
+          "blocks_decompressed", strings::StrCat(s.blocks_decompressed)));
+      result.push_back(std::make_pair("records_decoded",
+                                      strings::StrCat(s.records_decoded)));
+      result.push_back(std::make_pair(
+          "decompress_us_per_block",
+          strings::StrCat(PipelineStats::PerItem(s.decompress_micros,
+                                                 s.blocks_decompressed))));
+      result.push_back(std::make_pair(
+          "decode_us_per_record",
+          strings::StrCat(
+              PipelineStats::PerItem(s.decode_micros, s.records_decoded))));
+      result.push_back(std::make_pair(
+          "wait_for_data_us", strings::StrCat(s.wait_for_data_micros)));
+      result.push_back(std::make_pair("fill_sparse_us",
+                                      strings::StrCat(s.fill_sparse_micros)));
+      result.push_back(std::make_pair(
+          "parallelism", strings::StrCat(TunedValue(*parallelism_))));
+      result.push_back(std::make_pair(
+          "prefetch_blocks", strings::StrCat(TunedValue(*prefetch_blocks_))));
+      return result;
     }
 
+    // Saves the shuffle generators, the file and block positions of the
+    // readers, and the blocks that still hold undecoded records. Restore
+    // seeks to these blocks instead of reading the epoch from the start.
     Status SaveInternal(SerializationContext* ctx,
                         IteratorStateWriter* writer) override {
-      return errors::Unimplemented("SaveInternal");
+      mutex_lock l(*mu_);
+      mutex_lock i(input_mu_);
+      // Blocks being decompressed are saved once they reach write_blocks_.
+      while (!cancelled_ && num_pending_decompressions_ > 0) {
+        write_var_->wait(i);
+      }
+      TF_RETURN_IF_ERROR(prefetch_thread_status_);
+
+      ShuffleHandler::State state = shuffle_handler_->GetState();
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(full_name(kDeterministic),
+                              static_cast<int64>(state.deterministic)));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          full_name(kEpochSeed), static_cast<int64>(state.epoch_seed)));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kSeed), state.seed));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kSeed2), state.seed2));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kNumRandomSamples),
+                                             state.num_random_samples));
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(full_name(kRandomPosition), state.position));
+
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          full_name(kNextFileIndex), static_cast<int64>(next_file_index_)));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          full_name(kNumBlocksRead), static_cast<int64>(num_blocks_read_)));
+
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          full_name(kNumReaders), static_cast<int64>(reader_cursors_.size())));
+      for (size_t k = 0; k < reader_cursors_.size(); k++) {
+        const ReaderCursor& cursor = reader_cursors_[k];
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kReaderActive, k),
+                                static_cast<int64>(cursor.active)));
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kReaderFileIndex, k),
+                                static_cast<int64>(cursor.file_index)));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            IndexedName(kReaderOffset, k), static_cast<int64>(cursor.offset)));
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kReaderNextBlock, k),
+                                static_cast<int64>(cursor.next_block)));
+      }
+
+      std::vector<const AvroBlock*> blocks;
+      for (auto* resident : {&blocks_, &write_blocks_}) {
+        for (auto& block : *resident) {
+          if (block->num_decoded < block->object_count) {
+            blocks.push_back(block.get());
+          }
+        }
+      }
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          full_name(kNumBlocks), static_cast<int64>(blocks.size())));
+      for (size_t k = 0; k < blocks.size(); k++) {
+        const AvroBlock& block = *blocks[k];
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kBlockFileIndex, k),
+                                static_cast<int64>(block.file_index)));
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kBlockFileOffset, k),
+                                static_cast<int64>(block.file_offset)));
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kBlockSequence, k),
+                                static_cast<int64>(block.sequence)));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(IndexedName(kBlockNumDecoded, k),
+                                               block.num_decoded));
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(IndexedName(kBlockReadOffset, k),
+                                static_cast<int64>(block.read_offset)));
+      }
+      return OkStatus();
     }
 
     Status RestoreInternal(IteratorContext* ctx,
                            IteratorStateReader* reader) override {
-      return errors::Unimplemented(
-          "Iterator does not support 'RestoreInternal')");
+      mutex_lock l(*mu_);
+      mutex_lock i(input_mu_);
+      if (!prefetch_threads_.empty()) {
+        return errors::FailedPrecondition(
+            "ATDSDataset iterator can only be restored before it is used.");
+      }
+
+      ShuffleHandler::State state;
+      int64 value;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kDeterministic), &value));
+      state.deterministic = value != 0;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kEpochSeed), &value));
+      state.epoch_seed = static_cast<uint64>(value);
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kSeed), &state.seed));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kSeed2), &state.seed2));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kNumRandomSamples),
+                                            &state.num_random_samples));
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(full_name(kRandomPosition), &state.position));
+      shuffle_handler_->SetState(state);
+      // The file order only depends on the restored epoch seed.
+      std::iota(file_order_.begin(), file_order_.end(), 0);
+      if (block_shuffle_) {
+        shuffle_handler_->Permute(ShuffleHandler::kFileOrderStream,
+                                  file_order_);
+      }
+
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kNextFileIndex), &value));
+      next_file_index_ = static_cast<size_t>(value);
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kNumBlocksRead), &value));
+      num_blocks_read_ = static_cast<uint64>(value);
+      next_release_sequence_ = num_blocks_read_;
+
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kNumReaders), &value));
+      if (static_cast<size_t>(value) != reader_cursors_.size()) {
+        return errors::InvalidArgument("Checkpoint has ", value,
+                                       " ATDSDataset readers but the dataset "
+                                       "reads with ",
+                                       reader_cursors_.size(), ".");
+      }
+      for (size_t k = 0; k < reader_cursors_.size(); k++) {
+        ReaderCursor& cursor = reader_cursors_[k];
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kReaderActive, k), &value));
+        cursor.active = value != 0;
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kReaderFileIndex, k), &value));
+        cursor.file_index = static_cast<size_t>(value);
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kReaderOffset, k), &value));
+        cursor.offset = static_cast<uint64>(value);
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kReaderNextBlock, k), &value));
+        cursor.next_block = static_cast<size_t>(value);
+      }
+
+      int64 num_blocks;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(full_name(kNumBlocks), &num_blocks));
+      std::unique_ptr<tensorflow::RandomAccessFile> file;
+      std::unique_ptr<AvroBlockReader> block_reader;
+      size_t open_file_index = 0;
+      count_ = 0;
+      for (int64 k = 0; k < num_blocks; k++) {
+        int64 file_index, file_offset, sequence, num_decoded, read_offset;
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kBlockFileIndex, k), &file_index));
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kBlockFileOffset, k), &file_offset));
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kBlockSequence, k), &sequence));
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kBlockNumDecoded, k), &num_decoded));
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(IndexedName(kBlockReadOffset, k), &read_offset));
+
+        if (!block_reader ||
+            open_file_index != static_cast<size_t>(file_index)) {
+          open_file_index = static_cast<size_t>(file_index);
+          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env(), file, block_reader,
+                                                open_file_index));
+        }
+        auto block = std::make_unique<AvroBlock>();
+        TF_RETURN_IF_ERROR(
+            block_reader->SeekToBlock(static_cast<uint64>(file_offset)));
+        TF_RETURN_IF_ERROR(block_reader->ReadBlock(*block));
+        if (block->codec != NULL_CODEC) {
+          TF_RETURN_IF_ERROR(DecompressBlock(*block));
+        }
+        if (num_decoded > block->object_count ||
+            static_cast<size_t>(read_offset) > block->content.size()) {
+          return errors::DataLoss("Avro block at offset ", file_offset,
+                                  " of file ",
+                                  dataset()->FileName(open_file_index),
+                                  " does not match the checkpoint.");
+        }
+        block->file_index = open_file_index;
+        block->file_offset = static_cast<uint64>(file_offset);
+        block->sequence = static_cast<uint64>(sequence);
+        block->num_decoded = num_decoded;
+        block->read_offset = static_cast<size_t>(read_offset);
+        count_ += block->object_count - block->num_decoded;
+        blocks_.emplace_back(std::move(block));
+      }
+      return OkStatus();
     }
 
    private:
@@ -757,16 +1275,227 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
       return num_of_elements_at_i.back();
     }
 
-    void PrefetchThread(const std::shared_ptr<IteratorContext>& ctx) {
+    // Claims the next unread file for a reader thread. Returns false when all
+    // files of the epoch have been claimed or the iterator is shutting down.
+    bool ClaimNextFile(size_t reader_index, size_t* file_index)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      ReaderCursor& cursor = reader_cursors_[reader_index];
+      if (cancelled_ || prefetch_thread_finished_ ||
+          next_file_index_ >= dataset()->filenames_.size()) {
+        cursor = ReaderCursor();
+        return false;
+      }
+      *file_index = file_order_[next_file_index_++];
+      cursor = ReaderCursor{true, *file_index, 0, 0};
+      return true;
+    }
+
+    // True once the buffer holds enough records to sample a batch. A
+    // deterministic shuffle also waits for the pending decompressions, so
+    // that every batch is sampled from the same set of blocks across runs.
+    bool BufferFilled(size_t total_buffer)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      return count_ >= total_buffer && (!shuffle_handler_->deterministic() ||
+                                        num_pending_decompressions_ == 0);
+    }
+
+    // True once the blocks read or being decompressed hold enough records
+    // to fill the buffer. Further blocks are read ahead of the buffer.
+    bool BufferReserved(size_t total_buffer)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      return count_ + pending_decompression_records_ + reorder_records_ >=
+             total_buffer;
+    }
+
+    // Returns the current value of a parameter tuned by the tf.data model.
+    size_t TunedValue(const model::SharedState& state) const {
+      mutex_lock l(*state.mu);
+      return state.value > 0 ? static_cast<size_t>(state.value) : 0;
+    }
+
+    // Reports the bytes of the resident blocks to the process-wide memory
+    // budget and to the tf.data model, so that its RAM budget accounts for
+    // them.
+    void RecordBufferedBlocks(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      int64 bytes = 0;
+      for (auto& block : blocks_) {
+        bytes += static_cast<int64>(block->content.size());
+      }
+      io::MemoryBudget* budget = io::MemoryBudget::Global();
+      budget->Reserve(kBudgetComponent, bytes - budgeted_bytes_);
+      budget->Release(kBudgetComponent, budgeted_bytes_ - bytes);
+      budgeted_bytes_ = bytes;
+      std::shared_ptr<model::Node> node = model_node();
+      if (!ctx->model() || !node) {
+        return;
+      }
+      int64 num_blocks = static_cast<int64>(blocks_.size());
+      node->record_buffer_event(bytes - buffered_bytes_,
+                                num_blocks - buffered_blocks_);
+      buffered_bytes_ = bytes;
+      buffered_blocks_ = num_blocks;
+    }
+
+    // Called by a reader thread when it exits. The epoch is finished once the
+    // last reader has exited or as soon as any reader reports an error.
+    void FinishReader(const Status& status)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      if (!status.ok() && prefetch_thread_status_.ok()) {
+        prefetch_thread_status_ = status;
+        prefetch_thread_finished_ = true;
+      }
+      --num_active_readers_;
+      MaybeFinishEpoch();
+    }
+
+    // Records the result of a decompression task scheduled by a reader.
+    void FinishDecompression(const Status& status)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      if (!status.ok() && prefetch_thread_status_.ok()) {
+        prefetch_thread_status_ = status;
+        prefetch_thread_finished_ = true;
+      }
+      --num_pending_decompressions_;
+      MaybeFinishEpoch();
+    }
+
+    void MaybeFinishEpoch() TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      if (num_active_readers_ == 0 && num_pending_decompressions_ == 0) {
+        prefetch_thread_finished_ = true;
+      }
+      cond_var_->notify_all();
+      write_var_->notify_all();
+    }
+
+    Status DecompressBlock(AvroBlock& block) {
+      uint64 start_time = Env::Default()->NowMicros();
+      try {
+        if (block.codec == DEFLATE_CODEC) {
+          tensorflow::profiler::TraceMe traceme(kDeflateDecompression);
+          decompression_handler_->decompressDeflateCodec(block);
+        }
+#ifdef SNAPPY_CODEC_AVAILABLE
+        else if (block.codec == SNAPPY_CODEC) {
+          tensorflow::profiler::TraceMe traceme(kSnappyDecompression);
+          decompression_handler_->decompressSnappyCodec(block);
+        }
+#endif
+        else if (block.codec == ZSTANDARD_CODEC) {
+          tensorflow::profiler::TraceMe traceme(kZstandardDecompression);
+          decompression_handler_->decompressZstandardCodec(block);
+        } else if (block.codec == LZ4_CODEC) {
+          tensorflow::profiler::TraceMe traceme(kLz4Decompression);
+          decompression_handler_->decompressLz4Codec(block);
+        } else {
+          return atds::BlockDecompressionError(strings::StrCat(
+              "Unsupported Avro codec ", static_cast<int>(block.codec)));
+        }
+      } catch (avro::Exception& e) {
+        return atds::BlockDecompressionError(e.what());
+      }
+      stats_.RecordBlockDecompressed(Env::Default()->NowMicros() - start_time);
+      return OkStatus();
+    }
+
+    // Decompresses `block` on thread_pool_ and hands it over to write_blocks_
+    // when done. Decompression of newly read blocks thereby overlaps with the
+    // decoding of the blocks already in blocks_.
+    void ScheduleDecompression(std::unique_ptr<AvroBlock> block)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      ++num_pending_decompressions_;
+      pending_decompression_records_ += block->object_count;
+      // ThreadPool::Schedule requires a copyable closure.
+      AvroBlock* raw_block = block.release();
+      thread_pool_->Schedule([this, raw_block]() {
+        std::unique_ptr<AvroBlock> block(raw_block);
+        Status status = DecompressBlock(*block);
+        mutex_lock l(input_mu_);
+        pending_decompression_records_ -= block->object_count;
+        uint64 sequence = block->sequence;
+        if (!status.ok() || cancelled_) {
+          block.reset();
+        }
+        ReleaseBlock(sequence, std::move(block));
+        FinishDecompression(status);
+      });
+    }
+
+    // Hands `block` over to write_blocks_ once all blocks read before it
+    // are handed over. Blocks decompressed out of order wait in
+    // reorder_blocks_, so that blocks_ receives the blocks in the order
+    // they were read. A null `block` stands for a block of `sequence` that
+    // failed to decompress and only releases the blocks after it.
+    void ReleaseBlock(uint64 sequence, std::unique_ptr<AvroBlock> block)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      if (block) {
+        reorder_records_ += block->object_count;
+      }
+      reorder_blocks_.emplace(sequence, std::move(block));
+      while (!reorder_blocks_.empty() &&
+             reorder_blocks_.begin()->first == next_release_sequence_) {
+        std::unique_ptr<AvroBlock> next =
+            std::move(reorder_blocks_.begin()->second);
+        reorder_blocks_.erase(reorder_blocks_.begin());
+        ++next_release_sequence_;
+        if (!next) {
+          continue;
+        }
+        reorder_records_ -= next->object_count;
+        count_ += next->object_count;
+        inflight_bytes_ += next->content.size();
+        io::MemoryBudget::Global()->Reserve(kBudgetComponent,
+                                            next->content.size());
+        write_blocks_.emplace_back(std::move(next));
+      }
+    }
+
+    // Also true while the process-wide memory budget is exhausted, once
+    // some blocks are in flight, so that the readers pause until the
+    // consumer takes them.
+    bool InflightBytesExceeded() TF_EXCLUSIVE_LOCKS_REQUIRED(input_mu_) {
+      int64 max_inflight_bytes = dataset()->max_inflight_bytes_;
+      return (max_inflight_bytes > 0 &&
+              inflight_bytes_ >= static_cast<uint64>(max_inflight_bytes)) ||
+             (inflight_bytes_ > 0 && io::MemoryBudget::Global()->Exhausted());
+    }
+
+    // Reads Avro blocks into write_blocks_. With num_parallel_reads > 1,
+    // several reader threads run this loop concurrently and each one claims
+    // whole files from the shared next_file_index_ cursor.
+    void PrefetchThread(const std::shared_ptr<IteratorContext>& ctx,
+                        size_t reader_index) {
       size_t total_buffer = total_buffer_size();
       std::unique_ptr<AvroBlockReader> reader;
       std::unique_ptr<tensorflow::RandomAccessFile> file;
       size_t current_file_index = 0;
+      // Shuffled block offsets of the current file in block shuffle mode.
+      std::vector<uint64> block_offsets;
+      size_t next_block = 0;
+      // Set while the blocks of the current file are read from the block
+      // cache, at cached_offsets in the order they are read.
+      BlockCache* block_cache = dataset()->block_cache_.get();
+      bool from_cache = false;
+      std::vector<uint64> cached_offsets;
+      // The offsets of the blocks read so far from the current file, if it is
+      // read sequentially from its first block, cached at its end.
+      std::vector<uint64> read_offsets;
+      bool read_from_start = false;
+      // Set if the iterator was restored while this reader had a file open.
+      ReaderCursor resume;
+      {
+        mutex_lock l(input_mu_);
+        resume = reader_cursors_[reader_index];
+      }
+      current_file_index = resume.file_index;
       while (true) {
         // 1. wait for a slot in the buffer
         {
           mutex_lock l(input_mu_);
-          while (!cancelled_ && count_ >= total_buffer) {
+          while (!cancelled_ && !prefetch_thread_finished_ &&
+                 ((BufferReserved(total_buffer) &&
+                   read_ahead_blocks_ >= max_read_ahead_blocks_) ||
+                  InflightBytesExceeded())) {
             // LOG(INFO) << "prefetch waiting on block size " << blocks_.size()
             // << " count: " << count_;
             cond_var_->notify_one();
@@ -774,29 +1503,96 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
           }
           // LOG(INFO) << "prefetch done waiting on block size " <<
           // blocks_.size() << " count: " << count_;
-          if (cancelled_) {
-            prefetch_thread_finished_ = true;
-            prefetch_thread_status_ = OkStatus();
-            cond_var_->notify_all();
-            write_var_->notify_all();
+          if (cancelled_ || prefetch_thread_finished_) {
+            FinishReader(OkStatus());
+            return;
+          }
+          if (!reader && !from_cache && !resume.active &&
+              !ClaimNextFile(reader_index, &current_file_index)) {
+            FinishReader(OkStatus());
             return;
           }
+          if (BufferReserved(total_buffer)) {
+            read_ahead_blocks_++;
+          }
         }  // done with mutex_lock l
         // 2. read the next elements unil count hits max
         Status status = OkStatus();
-        if (!reader) {
+        if (!reader && !from_cache && block_cache != nullptr) {
+          avro::ValidSchema schema;
+          if (block_cache->GetFileBlocks(current_file_index, &schema,
+                                         &cached_offsets)) {
+            status = InitializeDecoder(schema, current_file_index);
+            if (!status.ok()) {
+              mutex_lock l(input_mu_);
+              LOG(ERROR) << "Error loading cached file: "
+                         << dataset()->FileName(current_file_index);
+              FinishReader(status);
+              return;
+            }
+            from_cache = true;
+            next_block = 0;
+            if (block_shuffle_) {
+              shuffle_handler_->Permute(
+                  ShuffleHandler::kBlockOrderStream + current_file_index,
+                  cached_offsets);
+            }
+            if (resume.active) {
+              resume.active = false;
+              next_block =
+                  block_shuffle_
+                      ? resume.next_block
+                      : std::lower_bound(cached_offsets.begin(),
+                                         cached_offsets.end(), resume.offset) -
+                            cached_offsets.begin();
+            }
+          }
+        }
+        if (!reader && !from_cache) {
           status =
               SetupStreamsLocked(ctx->env(), file, reader, current_file_index);
           if (!status.ok()) {
             mutex_lock l(input_mu_);
             LOG(ERROR) << "Error loading file: "
-                       << dataset()->filenames_[current_file_index];
-            prefetch_thread_finished_ = true;
-            prefetch_thread_status_ = status;
-            cond_var_->notify_all();
-            write_var_->notify_all();
+                       << dataset()->FileName(current_file_index);
+            FinishReader(status);
             return;
           }
+          if (block_shuffle_) {
+            block_offsets.clear();
+            next_block = 0;
+            status = reader->ReadBlockOffsets(&block_offsets);
+            if (!status.ok()) {
+              mutex_lock l(input_mu_);
+              LOG(ERROR) << "Error indexing blocks of file: "
+                         << dataset()->FileName(current_file_index);
+              FinishReader(status);
+              return;
+            }
+            if (block_cache != nullptr) {
+              block_cache->SetFileBlocks(current_file_index,
+                                         reader->GetSchema(), block_offsets);
+            }
+            shuffle_handler_->Permute(
+                ShuffleHandler::kBlockOrderStream + current_file_index,
+                block_offsets);
+          }
+          read_offsets.clear();
+          read_from_start = !resume.active || resume.offset == 0;
+          if (resume.active) {
+            resume.active = false;
+            next_block = resume.next_block;
+            if (!block_shuffle_ && resume.offset > 0) {
+              status = reader->SeekToBlock(resume.offset);
+            }
+            if (!status.ok()) {
+              mutex_lock l(input_mu_);
+              LOG(ERROR) << "Error resuming file: "
+                         << dataset()->FileName(current_file_index);
+              FinishReader(status);
+              return;
+            }
+          }
         }
 
         // LOG(INFO) << "Before processing " << count_ << " datum left in
@@ -804,7 +1600,39 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
         tensorflow::profiler::TraceMe trace(kBlockReading);
 
         auto block = std::make_unique<AvroBlock>();
-        status = reader->ReadBlock(*block);
+        uint64 next_offset = 0;
+        if (from_cache) {
+          status = next_block < cached_offsets.size()
+                       ? OkStatus()
+                       : errors::OutOfRange("eof");
+          if (status.ok()) {
+            block->file_index = current_file_index;
+            block->file_offset = cached_offsets[next_block++];
+            status = block_cache->Lookup(current_file_index,
+                                         block->file_offset, block.get(),
+                                         &next_offset);
+          }
+        } else {
+          if (block_shuffle_) {
+            status = next_block < block_offsets.size()
+                         ? reader->SeekToBlock(block_offsets[next_block++])
+                         : errors::OutOfRange("eof");
+          }
+          if (status.ok()) {
+            block->file_index = current_file_index;
+            block->file_offset = reader->Tell();
+            status = reader->ReadBlock(*block);
+            next_offset = reader->Tell();
+          }
+          if (status.ok()) {
+            stats_.RecordBlockRead(next_offset - block->file_offset);
+            if (block_cache != nullptr) {
+              block_cache->Insert(current_file_index, block->file_offset,
+                                  next_offset, *block);
+              read_offsets.push_back(block->file_offset);
+            }
+          }
+        }
         // LOG(INFO) << "Read block status: " << status.ToString();
         // done with mutex_lock input_l
         if (!status.ok()) {
@@ -814,38 +1642,71 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
           }
           // LOG(INFO) << "Resetting stream: " << status.ToString() << "b " <<
           // blocks_.size() << " c_: " << count_;
+          // Note: errors other than end of file are not propagated, the
+          // reader moves on to the next file.
+          if (errors::IsOutOfRange(status) && block_cache != nullptr &&
+              reader && !block_shuffle_ && read_from_start) {
+            block_cache->SetFileBlocks(current_file_index, reader->GetSchema(),
+                                       std::move(read_offsets));
+          }
+          read_offsets.clear();
+          from_cache = false;
           ResetStreamsLocked(file, reader);
-          ++current_file_index;
-          if (current_file_index >= dataset()->filenames_.size()) {
-            mutex_lock l(input_mu_);
-            prefetch_thread_finished_ = true;
-            // Note: this is overwriting any previous errors
-            prefetch_thread_status_ = OkStatus();
-            cond_var_->notify_all();
-            write_var_->notify_all();
-            return;
-          }  // done with mutex_lock l
+        } else if (block->codec != NULL_CODEC) {
+          mutex_lock n(input_mu_);
+          block->sequence = num_blocks_read_++;
+          reader_cursors_[reader_index].offset = next_offset;
+          reader_cursors_[reader_index].next_block = next_block;
+          ScheduleDecompression(std::move(block));
         } else {
           mutex_lock n(input_mu_);
-          count_ += block->object_count;
-          write_blocks_.emplace_back(std::move(block));
-          ++num_blocks_read_;
+          reader_cursors_[reader_index].offset = next_offset;
+          reader_cursors_[reader_index].next_block = next_block;
+          block->sequence = num_blocks_read_++;
+          // Uncompressed blocks still wait for the compressed blocks read
+          // before them by other readers.
+          ReleaseBlock(block->sequence, std::move(block));
+          if (InflightBytesExceeded()) {
+            cond_var_->notify_all();
+          }
         }
       }  // end while
     }
 
     Status EnsurePrefetchThreadStarted(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
-      if (!prefetch_thread_) {
+      if (prefetch_threads_.empty()) {
         std::shared_ptr<IteratorContext> new_ctx =
             std::make_shared<IteratorContext>(*ctx);
-        prefetch_thread_ =
-            ctx->StartThread("atds_data_prefetch",
-                             [this, new_ctx]() { PrefetchThread(new_ctx); });
+        size_t num_readers = NumReaders();
+        {
+          mutex_lock l(input_mu_);
+          num_active_readers_ = num_readers;
+        }
+        prefetch_threads_.reserve(num_readers);
+        for (size_t i = 0; i < num_readers; i++) {
+          prefetch_threads_.emplace_back(ctx->StartThread(
+              strings::StrCat("atds_data_prefetch_", i),
+              [this, new_ctx, i]() {
+                // The blocks are read into buffers first touched here.
+                PinCurrentThread(dataset()->cpus_);
+                PrefetchThread(new_ctx, i);
+              }));
+        }
       }
       return OkStatus();
     }
 
+    string IndexedName(const char* name, size_t index) {
+      return full_name(strings::StrCat(name, "_", index));
+    }
+
+    size_t NumReaders() const {
+      return std::min(
+          static_cast<size_t>(dataset()->num_parallel_reads_),
+          std::max(dataset()->filenames_.size(), static_cast<size_t>(1)));
+    }
+
     size_t total_buffer_size() { return batch_size_ + shuffle_buffer_size_; }
 
     // Sets up reader streams to read from the file at `current_file_index_`.
@@ -859,22 +1720,39 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
       }
 
       // Actually move on to next file.
-      const string& next_filename = dataset()->filenames_[current_file_index];
+      const tstring& next_filename = dataset()->filenames_[current_file_index];
+      if (dataset()->from_memory_) {
+        // The blocks view the contents, which the dataset holds.
+        file.reset();
+        reader = absl::make_unique<AvroBlockReader>(
+            StringPiece(next_filename.data(), next_filename.size()));
+        return InitializeDecoder(reader->GetSchema(), current_file_index);
+      }
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file));
       reader = absl::make_unique<AvroBlockReader>(
-          file.get(), dataset()->reader_buffer_size_);
+          file.get(), dataset()->reader_buffer_size_,
+          dataset()->reader_queue_depth_, read_thread_pool_.get());
+      return InitializeDecoder(reader->GetSchema(), current_file_index);
+    }
+
+    // Initializes the decoder with the schema of the file at `file_index`.
+    // Reader threads race to initialize the decoder with the first schema
+    // they see, all later files are validated against it.
+    Status InitializeDecoder(const avro::ValidSchema& schema,
+                             size_t file_index) {
+      mutex_lock l(schema_mu_);
       if (atds_decoder_ == nullptr) {
         atds_decoder_ = std::make_unique<atds::ATDSDecoder>(
             dataset()->dense_features_, dataset()->sparse_features_,
             dataset()->varlen_features_);
-        TF_RETURN_IF_ERROR(atds_decoder_->Initialize(reader->GetSchema()));
+        TF_RETURN_IF_ERROR(atds_decoder_->Initialize(schema));
         expected_schema_ = atds_decoder_->GetSchema().toJson(false);
-      } else if (expected_schema_ != reader->GetSchema().toJson(false)) {
+      } else if (expected_schema_ != schema.toJson(false)) {
         string expected_schema = atds_decoder_->GetSchema().toJson(true);
-        string varied_schema = reader->GetSchema().toJson(true);
-        string filename = dataset()->filenames_[0];
+        string varied_schema = schema.toJson(true);
         return atds::VariedSchemaNotSupportedError(
-            expected_schema, filename, varied_schema, next_filename);
+            expected_schema, dataset()->FileName(0), varied_schema,
+            dataset()->FileName(file_index));
       }
       return OkStatus();
     }
@@ -889,7 +1767,7 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     void InitSparseValueBuffer(atds::sparse::ValueBuffer& buffer,
                                size_t num_of_datum) {
       auto& sparse_dtype_counts = dataset()->sparse_dtype_counts_;
-      auto& sparse_expected_elements = dataset()->sparse_expected_elements_;
+      auto& sparse_expected_elements = expected_elements_;
       for (size_t i = 0; i < sparse_dtype_counts.int_counts; i++) {
         buffer.int_values[i].reserve(num_of_datum *
                                      sparse_expected_elements.int_values[i]);
@@ -955,7 +1833,7 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
         // order, and terminate when we encounter an already decompressed block
         // (null codec).
         for (size_t i = blocks_.size();
-             i > 0 && blocks_[i - 1]->codec != avro::NULL_CODEC; i--) {
+             i > 0 && blocks_[i - 1]->codec != NULL_CODEC; i--) {
           total_cost +=
               (decompress_cost_per_record * blocks_[i - 1]->object_count);
         }
@@ -977,7 +1855,7 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
       while (thread_idx < num_threads) {
         while (running_cost < cost_per_thread * (thread_idx + 1) &&
                block_idx < num_blocks) {
-          if (blocks_[block_idx]->codec != avro::NULL_CODEC) {
+          if (blocks_[block_idx]->codec != NULL_CODEC) {
             running_cost +=
                 decompress_cost_per_record * blocks_[block_idx]->object_count;
           }
@@ -1030,11 +1908,72 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
       return ideal_num_threads;
     }
 
+    // Replaces the estimated number of elements per record of every sparse
+    // tensor with the number observed in the last batch, so that the next
+    // batch reserves its buffers close to the actual size.
+    void UpdateExpectedElements(const std::vector<int64>& num_of_elements,
+                                size_t batch_size) {
+      auto& sparse_dtypes = dataset()->sparse_dtypes_;
+      auto& sparse_shapes = dataset()->sparse_shapes_;
+      auto& sparse_value_index = dataset()->sparse_value_index_;
+      for (size_t i = 0; i < num_of_elements.size(); i++) {
+        size_t per_record = std::max(
+            static_cast<size_t>(1),
+            (static_cast<size_t>(num_of_elements[i]) + batch_size - 1) /
+                batch_size);
+        size_t index = sparse_value_index[i];
+        switch (sparse_dtypes[i]) {
+          case DT_INT32:
+            expected_elements_.int_values[index] = per_record;
+            break;
+          case DT_INT64:
+            expected_elements_.long_values[index] = per_record;
+            break;
+          case DT_FLOAT:
+            expected_elements_.float_values[index] = per_record;
+            break;
+          case DT_DOUBLE:
+            expected_elements_.double_values[index] = per_record;
+            break;
+          case DT_STRING:
+            expected_elements_.string_values[index] = per_record;
+            break;
+          case DT_BOOL:
+            expected_elements_.bool_values[index] = per_record;
+            break;
+          default:
+            break;
+        }
+        size_t rank_after_batch =
+            dataset()->sparse_ragged_[i]
+                ? 0
+                : static_cast<size_t>(sparse_shapes[i].dims() + 1);
+        expected_elements_.indices[i] = rank_after_batch * per_record;
+      }
+    }
+
     uint64 GetTotalStats(std::vector<uint64>& vec) {
       return std::accumulate(vec.begin(), vec.end(), 0);
     }
 
     std::unique_ptr<ShuffleHandler> shuffle_handler_ = nullptr;
+    // Shuffles file and block order and samples records from the resident
+    // blocks instead of keeping a large shuffle buffer.
+    bool block_shuffle_ = false;
+    // Order in which the reader threads claim the files of the epoch.
+    std::vector<size_t> file_order_;
+
+    // Position of a reader thread in its current file. `offset` is the file
+    // offset of the next block and `next_block` the index into the shuffled
+    // block offsets in block shuffle mode.
+    struct ReaderCursor {
+      bool active = false;
+      size_t file_index = 0;
+      uint64 offset = 0;
+      size_t next_block = 0;
+    };
+    // Recycles decompressed block buffers across batches.
+    std::unique_ptr<BlockBufferPool> block_buffer_pool_ = nullptr;
     std::unique_ptr<DecompressionHandler> decompression_handler_ = nullptr;
     const std::shared_ptr<condition_variable> cond_var_ = nullptr;
     const std::shared_ptr<condition_variable> write_var_ = nullptr;
@@ -1043,9 +1982,25 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
 
     atds::sparse::ValueBuffer value_buffer_;
     std::unique_ptr<thread::ThreadPool> thread_pool_ = nullptr;
+    // Runs the reads that the readers keep in flight, if reader_queue_depth
+    // is above 1. Declared before prefetch_threads_ so that it outlives the
+    // readers waiting for its reads.
+    std::unique_ptr<thread::ThreadPool> read_thread_pool_ = nullptr;
 
     const std::shared_ptr<mutex> mu_;
-    std::unique_ptr<Thread> prefetch_thread_ TF_GUARDED_BY(*mu_);
+    // Guards the values of the tunable parameters, which the tf.data model
+    // updates from its own thread.
+    const std::shared_ptr<mutex> autotune_mu_;
+    // The decode threads per batch and the blocks that the readers may read
+    // ahead of the buffer.
+    std::shared_ptr<model::SharedState> parallelism_;
+    std::shared_ptr<model::SharedState> prefetch_blocks_;
+    // The bytes and number of blocks_ last reported to the tf.data model.
+    int64 buffered_bytes_ TF_GUARDED_BY(*mu_) = 0;
+    int64 buffered_blocks_ TF_GUARDED_BY(*mu_) = 0;
+    // The bytes of blocks_ accounted to the memory budget.
+    int64 budgeted_bytes_ TF_GUARDED_BY(*mu_) = 0;
+    std::vector<std::unique_ptr<Thread>> prefetch_threads_ TF_GUARDED_BY(*mu_);
     std::vector<std::unique_ptr<AvroBlock> > blocks_ TF_GUARDED_BY(*mu_);
 
     mutex input_mu_ TF_ACQUIRED_BEFORE(*mu_);
@@ -1054,9 +2009,41 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     bool prefetch_thread_finished_ TF_GUARDED_BY(input_mu_) = false;
     Status prefetch_thread_status_ TF_GUARDED_BY(input_mu_);
     uint64 num_blocks_read_ TF_GUARDED_BY(input_mu_) = 0;
+    // Bytes of blocks read by the prefetch threads that are not yet merged
+    // into blocks_. Bounded by the dataset's max_inflight_bytes if positive.
+    // The blocks resident in blocks_ are not counted, they are bounded by
+    // the records of the buffer instead.
+    uint64 inflight_bytes_ TF_GUARDED_BY(input_mu_) = 0;
+    // Blocks read ahead of the buffer since the last batch, and the bound
+    // of them taken from prefetch_blocks_ at every batch.
+    size_t read_ahead_blocks_ TF_GUARDED_BY(input_mu_) = 0;
+    size_t max_read_ahead_blocks_ TF_GUARDED_BY(input_mu_) = 0;
+    size_t next_file_index_ TF_GUARDED_BY(input_mu_) = 0;
+    std::vector<ReaderCursor> reader_cursors_ TF_GUARDED_BY(input_mu_);
+
+    // Recycles the output tensors and sparse buffers if the dataset enables
+    // the output arena.
+    std::unique_ptr<TensorArena> tensor_arena_ TF_GUARDED_BY(*mu_);
+    std::vector<atds::sparse::ValueBuffer> sparse_buffer_ TF_GUARDED_BY(*mu_);
+    // Estimated elements per record of the sparse tensors. Adapted to the
+    // observed counts in output arena mode.
+    SparseExpectedElements expected_elements_;
+    size_t num_active_readers_ TF_GUARDED_BY(input_mu_) = 0;
+    // Blocks read by the prefetch threads that are being decompressed on
+    // thread_pool_ and the number of records in them.
+    size_t num_pending_decompressions_ TF_GUARDED_BY(input_mu_) = 0;
+    size_t pending_decompression_records_ TF_GUARDED_BY(input_mu_) = 0;
+    // Blocks decompressed ahead of a block read before them, by sequence,
+    // the records in them and the sequence of the next block to hand over
+    // to write_blocks_.
+    std::map<uint64, std::unique_ptr<AvroBlock> > reorder_blocks_
+        TF_GUARDED_BY(input_mu_);
+    size_t reorder_records_ TF_GUARDED_BY(input_mu_) = 0;
+    uint64 next_release_sequence_ TF_GUARDED_BY(input_mu_) = 0;
     std::vector<std::unique_ptr<AvroBlock> > write_blocks_
         TF_GUARDED_BY(input_mu_);
 
+    mutex schema_mu_;
     std::unique_ptr<atds::ATDSDecoder> atds_decoder_ = nullptr;
     string expected_schema_ = "";
     std::vector<uint64> total_records_parsed_ TF_GUARDED_BY(*mu_);
@@ -1065,18 +2052,53 @@ class ATDSDatasetOp::Dataset : public DatasetBase {
     std::vector<uint64> total_decompress_micros_ TF_GUARDED_BY(*mu_);
     std::vector<uint64> thread_delays TF_GUARDED_BY(*mu_);
     std::vector<uint64> thread_itrs TF_GUARDED_BY(*mu_);
+    // Per-stage statistics, exported to TF monitoring and the tf.data
+    // profiler.
+    PipelineStats stats_;
   };
 
+  // Returns the name of file `file_index` in messages and logs, which for
+  // contents held in memory is their index.
+  string FileName(size_t file_index) const {
+    if (from_memory_) {
+      return strings::StrCat("<contents ", file_index, ">");
+    }
+    return filenames_[file_index];
+  }
+
+  // Numbers the iterators created from this dataset. Each iterator reads one
+  // epoch and derives its shuffle seeds from shuffle_seed_ and its epoch.
+  int64 NextEpoch() const TF_LOCKS_EXCLUDED(epoch_mu_) {
+    mutex_lock l(epoch_mu_);
+    return next_epoch_++;
+  }
+
   const std::vector<tstring> filenames_;
   const int64 batch_size_, reader_buffer_size_, shuffle_buffer_size_,
-      num_parallel_calls_;
-  const bool drop_remainder_;
+      num_parallel_calls_, num_parallel_reads_, max_inflight_bytes_,
+      shuffle_seed_, numa_node_;
+  const bool drop_remainder_, output_arena_;
+  const string shuffle_mode_, cpu_affinity_;
+  // The CPUs that the reader and decode threads are pinned to, if any.
+  const std::vector<int> cpus_;
+  const int64 block_cache_bytes_;
+  const string block_cache_dir_;
+  const int64 reader_queue_depth_;
+  const bool from_memory_;
+  // The tensor the filenames_ view the contents of, if from_memory_.
+  const Tensor contents_;
+  // The blocks read by the iterators of all epochs, if caching is enabled.
+  std::shared_ptr<BlockCache> block_cache_;
+  mutable mutex epoch_mu_;
+  mutable int64 next_epoch_ TF_GUARDED_BY(epoch_mu_) = 0;
   const std::vector<string> feature_keys_, feature_types_;
   const std::vector<DataType> sparse_dtypes_;
   const std::vector<PartialTensorShape> sparse_shapes_;
   const std::vector<DataType> output_dtypes_;
   const std::vector<PartialTensorShape> output_shapes_;
   std::vector<size_t> sparse_value_index_;
+  // Whether each sparse feature is output as its values and row splits.
+  std::vector<bool> sparse_ragged_;
   DataTypeVector output_dtype_vector_;
 
   std::vector<TensorType> output_tensor_types_;
@@ -1099,6 +2121,24 @@ ATDSDatasetOp::ATDSDatasetOp(OpKernelConstruction* ctx) : DatasetOpKernel(ctx) {
   OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputDtypes, &output_dtypes_));
   OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputShapes, &output_shapes_));
 
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kShuffleMode, &shuffle_mode_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kShuffleSeed, &shuffle_seed_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputArena, &output_arena_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kNumaNode, &numa_node_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kCPUAffinity, &cpu_affinity_));
+  OP_REQUIRES_OK(ctx, ResolveCPUAffinity(numa_node_, cpu_affinity_, &cpus_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kBlockCacheBytes, &block_cache_bytes_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kBlockCacheDir, &block_cache_dir_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kReaderQueueDepth, &reader_queue_depth_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kFromMemory, &from_memory_));
+  OP_REQUIRES(ctx,
+              shuffle_mode_ == kRecordShuffleMode ||
+                  shuffle_mode_ == kBlockShuffleMode,
+              errors::InvalidArgument(strings::StrCat(
+                  "Invalid shuffle_mode, '", shuffle_mode_, "'. Only ",
+                  kRecordShuffleMode, " and ", kBlockShuffleMode,
+                  " are supported.")));
+
   auto feature_num = feature_keys_.size();
   OP_REQUIRES(ctx, feature_num == feature_types_.size(),
               errors::InvalidArgument(strings::StrCat(
@@ -1106,30 +2146,42 @@ ATDSDatasetOp::ATDSDatasetOp(OpKernelConstruction* ctx) : DatasetOpKernel(ctx) {
                   "length of feature_types. [", feature_num,
                   " != ", feature_types_.size(), "]")));
 
-  OP_REQUIRES(ctx, feature_num == output_dtypes_.size(),
-              errors::InvalidArgument(strings::StrCat(
-                  "The length of feature_keys must equal to the ",
-                  "length of output_dtypes. [", feature_num,
-                  " != ", output_dtypes_.size(), "]")));
-
-  OP_REQUIRES(ctx, feature_num == output_shapes_.size(),
-              errors::InvalidArgument(strings::StrCat(
-                  "The length of feature_keys must equal to the ",
-                  "length of output_shapes. [", feature_num,
-                  " != ", output_shapes_.size(), "]")));
-
-  size_t num_sparse = 0;
+  size_t num_sparse = 0, num_ragged = 0;
   for (auto& type : feature_types_) {
-    OP_REQUIRES(
-        ctx, type == kDenseType || type == kSparseType || type == kVarlenType,
-        errors::InvalidArgument(strings::StrCat(
-            "Invalid feature_type, '", type, "'. Only ", kDenseType, ", ",
-            kSparseType, ", and ", kVarlenType, " are supported.")));
-    if (type == kSparseType || type == kVarlenType) {
+    OP_REQUIRES(ctx,
+                type == kDenseType || type == kSparseType ||
+                    type == kVarlenType || type == kRaggedType,
+                errors::InvalidArgument(strings::StrCat(
+                    "Invalid feature_type, '", type, "'. Only ", kDenseType,
+                    ", ", kSparseType, ", ", kVarlenType, ", and ",
+                    kRaggedType, " are supported.")));
+    if (type == kRaggedType) {
+      OP_REQUIRES(ctx,
+                  num_sparse < sparse_shapes_.size() &&
+                      sparse_shapes_[num_sparse].dims() == 1,
+                  errors::InvalidArgument(
+                      "Ragged features must have a shape of rank 1."));
+      num_ragged++;
+    }
+    if (type != kDenseType) {
       num_sparse++;
     }
   }
 
+  // Ragged features are output as their values and row splits.
+  size_t output_num = feature_num + num_ragged;
+  OP_REQUIRES(ctx, output_num == output_dtypes_.size(),
+              errors::InvalidArgument(strings::StrCat(
+                  "The length of feature_keys plus the number of ragged ",
+                  "features must equal to the length of output_dtypes. [",
+                  output_num, " != ", output_dtypes_.size(), "]")));
+
+  OP_REQUIRES(ctx, output_num == output_shapes_.size(),
+              errors::InvalidArgument(strings::StrCat(
+                  "The length of feature_keys plus the number of ragged ",
+                  "features must equal to the length of output_shapes. [",
+                  output_num, " != ", output_shapes_.size(), "]")));
+
   OP_REQUIRES(ctx, sparse_dtypes_.size() == num_sparse,
               errors::InvalidArgument(strings::StrCat(
                   "The length of sparse_dtypes must equal to the number of ",
@@ -1153,8 +2205,16 @@ void ATDSDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase** output) {
   std::vector<tstring> filenames;
   filenames.reserve(filenames_tensor->NumElements());
   for (int i = 0; i < filenames_tensor->NumElements(); ++i) {
-    VLOG(2) << "Reading file: " << filenames_tensor->flat<tstring>()(i);
-    filenames.push_back(filenames_tensor->flat<tstring>()(i));
+    const tstring& filename = filenames_tensor->flat<tstring>()(i);
+    if (from_memory_) {
+      // Views of the contents, which the dataset holds with the tensor.
+      tstring contents;
+      contents.assign_as_view(filename.data(), filename.size());
+      filenames.push_back(std::move(contents));
+      continue;
+    }
+    VLOG(2) << "Reading file: " << filename;
+    filenames.push_back(filename);
   }
 
   int64 batch_size = 0;
@@ -1195,10 +2255,34 @@ void ATDSDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase** output) {
                   strings::StrCat("`num_parallel_calls` must be a positive "
                                   "integer or tf.data.AUTOTUNE, got ",
                                   num_parallel_calls)));
-  *output = new Dataset(
-      ctx, std::move(filenames), batch_size, drop_remainder, reader_buffer_size,
-      shuffle_buffer_size, num_parallel_calls, feature_keys_, feature_types_,
-      sparse_dtypes_, sparse_shapes_, output_dtypes_, output_shapes_);
+
+  int64 num_parallel_reads = 0;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, kNumParallelReads,
+                                                 &num_parallel_reads));
+  OP_REQUIRES(ctx, num_parallel_reads > 0,
+              errors::InvalidArgument(strings::StrCat(
+                  "`num_parallel_reads` must be greater than 0 but found ",
+                  num_parallel_reads)));
+
+  int64 max_inflight_bytes = 0;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, kMaxInflightBytes,
+                                                 &max_inflight_bytes));
+  OP_REQUIRES(
+      ctx, max_inflight_bytes >= 0,
+      errors::InvalidArgument(strings::StrCat(
+          "`max_inflight_bytes` must be greater than or equal to 0 but found ",
+          max_inflight_bytes)));
+
+  *output = new Dataset(ctx, std::move(filenames), batch_size, drop_remainder,
+                        reader_buffer_size, shuffle_buffer_size,
+                        num_parallel_calls, num_parallel_reads,
+                        max_inflight_bytes, shuffle_mode_, shuffle_seed_,
+                        output_arena_, numa_node_, cpu_affinity_, cpus_,
+                        block_cache_bytes_, block_cache_dir_,
+                        reader_queue_depth_, from_memory_, *filenames_tensor,
+                        feature_keys_, feature_types_,
+                        sparse_dtypes_, sparse_shapes_, output_dtypes_,
+                        output_shapes_);
 }
 
 namespace {
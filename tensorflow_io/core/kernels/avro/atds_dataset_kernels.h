@@ -30,6 +30,17 @@ class ATDSDatasetOp : public DatasetOpKernel {
   static constexpr const char* const kReaderBufferSize = "reader_buffer_size";
   static constexpr const char* const kShuffleBufferSize = "shuffle_buffer_size";
   static constexpr const char* const kNumParallelCalls = "num_parallel_calls";
+  static constexpr const char* const kNumParallelReads = "num_parallel_reads";
+  static constexpr const char* const kMaxInflightBytes = "max_inflight_bytes";
+  static constexpr const char* const kShuffleMode = "shuffle_mode";
+  static constexpr const char* const kShuffleSeed = "shuffle_seed";
+  static constexpr const char* const kOutputArena = "output_arena";
+  static constexpr const char* const kNumaNode = "numa_node";
+  static constexpr const char* const kCPUAffinity = "cpu_affinity";
+  static constexpr const char* const kBlockCacheBytes = "block_cache_bytes";
+  static constexpr const char* const kBlockCacheDir = "block_cache_dir";
+  static constexpr const char* const kReaderQueueDepth = "reader_queue_depth";
+  static constexpr const char* const kFromMemory = "from_memory";
   static constexpr const char* const kFeatureKeys = "feature_keys";
   static constexpr const char* const kFeatureTypes = "feature_types";
   static constexpr const char* const kSparseDtypes = "sparse_dtypes";
@@ -40,6 +51,10 @@ class ATDSDatasetOp : public DatasetOpKernel {
   static constexpr const char* const kDenseType = "dense";
   static constexpr const char* const kSparseType = "sparse";
   static constexpr const char* const kVarlenType = "varlen";
+  static constexpr const char* const kRaggedType = "ragged";
+
+  static constexpr const char* const kRecordShuffleMode = "record";
+  static constexpr const char* const kBlockShuffleMode = "block";
 
   explicit ATDSDatasetOp(OpKernelConstruction* ctx);
 
@@ -50,6 +65,18 @@ class ATDSDatasetOp : public DatasetOpKernel {
   class Dataset;
 
   std::vector<string> feature_keys_, feature_types_;
+  string shuffle_mode_;
+  int64 shuffle_seed_;
+  bool output_arena_;
+  int64 numa_node_;
+  string cpu_affinity_;
+  // The CPUs of numa_node_ or cpu_affinity_ the threads are pinned to, if any.
+  std::vector<int> cpus_;
+  int64 block_cache_bytes_;
+  string block_cache_dir_;
+  int64 reader_queue_depth_;
+  // Whether the filenames input holds the contents of Avro container files.
+  bool from_memory_;
   std::vector<DataType> sparse_dtypes_, output_dtypes_;
   std::vector<PartialTensorShape> sparse_shapes_, output_shapes_;
 };
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_index.h"
 #include "tensorflow_io/core/kernels/avro/utils/avro_record_reader.h"
 // TODO(fraudies): Wait until TF tensorflow/core/kernels/data/name_utils.h is
 // visible
@@ -35,6 +36,10 @@ namespace data {
 /* static */ constexpr const char* const AvroRecordDatasetOp::kFileNames;
 /* static */ constexpr const char* const AvroRecordDatasetOp::kBufferSize;
 /* static */ constexpr const char* const AvroRecordDatasetOp::kReaderSchema;
+/* static */ constexpr const char* const AvroRecordDatasetOp::kByteStart;
+/* static */ constexpr const char* const AvroRecordDatasetOp::kByteEnd;
+/* static */ constexpr const char* const
+    AvroRecordDatasetOp::kBlockIndexSuffix;
 
 constexpr char kCurrentFileIndex[] = "current_file_index";
 constexpr char kOffset[] = "offset";
@@ -42,10 +47,15 @@ constexpr char kOffset[] = "offset";
 class AvroRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<tstring> filenames,
-                   int64 buffer_size, const tstring& reader_schema)
+                   int64 buffer_size, const tstring& reader_schema,
+                   int64 byte_start, int64 byte_end,
+                   const string& block_index_suffix)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
-        options_(AvroReaderOptions::CreateReaderOptions()) {
+        options_(AvroReaderOptions::CreateReaderOptions()),
+        byte_start_(byte_start),
+        byte_end_(byte_end),
+        block_index_suffix_(block_index_suffix) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
@@ -205,6 +215,21 @@ class AvroRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
       reader_ = absl::make_unique<SequentialAvroRecordReader>(
           file_.get(), dataset()->options_);
+      if (dataset()->byte_start_ > 0 || dataset()->byte_end_ >= 0) {
+        // Reads the blocks of the byte range only. The sidecar index is
+        // optional, without it the first block is found by scanning for the
+        // next sync marker.
+        std::unique_ptr<AvroBlockIndex> index;
+        const string& suffix = dataset()->block_index_suffix_;
+        if (!suffix.empty() &&
+            env->FileExists(strings::StrCat(next_filename, suffix)).ok()) {
+          index = absl::make_unique<AvroBlockIndex>();
+          TF_RETURN_IF_ERROR(AvroBlockIndex::Load(
+              env, strings::StrCat(next_filename, suffix), index.get()));
+        }
+        TF_RETURN_IF_ERROR(reader_->SetByteRange(
+            dataset()->byte_start_, dataset()->byte_end_, index.get()));
+      }
       return OkStatus();
     }
 
@@ -225,10 +250,24 @@ class AvroRecordDatasetOp::Dataset : public DatasetBase {
 
   const std::vector<tstring> filenames_;
   AvroReaderOptions options_;
+  const int64 byte_start_;
+  const int64 byte_end_;
+  const string block_index_suffix_;
 };
 
 AvroRecordDatasetOp::AvroRecordDatasetOp(OpKernelConstruction* ctx)
-    : DatasetOpKernel(ctx) {}
+    : DatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kByteStart, &byte_start_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kByteEnd, &byte_end_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kBlockIndexSuffix, &block_index_suffix_));
+  OP_REQUIRES(ctx, byte_start_ >= 0,
+              errors::InvalidArgument("`byte_start` must be >= 0 but found ",
+                                      byte_start_));
+  OP_REQUIRES(ctx, byte_end_ < 0 || byte_end_ >= byte_start_,
+              errors::InvalidArgument(
+                  "`byte_end` must be negative or >= `byte_start` but found ",
+                  byte_end_));
+}
 
 void AvroRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
                                       DatasetBase** output) {
@@ -255,12 +294,51 @@ void AvroRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
   OP_REQUIRES_OK(
       ctx, ParseScalarArgument<tstring>(ctx, kReaderSchema, &reader_schema));
 
-  *output = new Dataset(ctx, std::move(filenames), buffer_size, reader_schema);
+  *output = new Dataset(ctx, std::move(filenames), buffer_size, reader_schema,
+                        byte_start_, byte_end_, block_index_suffix_);
 }
 
 namespace {
+
+// Builds the block index of an Avro file and saves it to `index_filename`.
+class WriteAvroBlockIndexOp : public OpKernel {
+ public:
+  explicit WriteAvroBlockIndexOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx), env_(ctx->env()) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor* filename_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("filename", &filename_tensor));
+    const Tensor* index_filename_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("index_filename", &index_filename_tensor));
+    const string filename = filename_tensor->scalar<tstring>()();
+    const string index_filename = index_filename_tensor->scalar<tstring>()();
+
+    std::unique_ptr<RandomAccessFile> file;
+    OP_REQUIRES_OK(ctx, env_->NewRandomAccessFile(filename, &file));
+    AvroBlockIndex index;
+    OP_REQUIRES_OK(ctx,
+                   AvroBlockIndex::Build(
+                       file.get(),
+                       AvroReaderOptions::CreateReaderOptions().buffer_size,
+                       &index));
+    OP_REQUIRES_OK(ctx, index.Save(env_, index_filename));
+
+    Tensor* num_blocks_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({}),
+                                             &num_blocks_tensor));
+    num_blocks_tensor->scalar<int64>()() =
+        static_cast<int64>(index.blocks().size());
+  }
+
+ private:
+  Env* env_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>AvroRecordDataset").Device(DEVICE_CPU),
                         AvroRecordDatasetOp);
+REGISTER_KERNEL_BUILDER(Name("IO>WriteAvroBlockIndex").Device(DEVICE_CPU),
+                        WriteAvroBlockIndexOp);
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
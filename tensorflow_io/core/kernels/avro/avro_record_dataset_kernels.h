@@ -25,6 +25,9 @@ class AvroRecordDatasetOp : public DatasetOpKernel {
   static constexpr const char* const kFileNames = "filenames";
   static constexpr const char* const kBufferSize = "buffer_size";
   static constexpr const char* const kReaderSchema = "reader_schema";
+  static constexpr const char* const kByteStart = "byte_start";
+  static constexpr const char* const kByteEnd = "byte_end";
+  static constexpr const char* const kBlockIndexSuffix = "block_index_suffix";
 
   explicit AvroRecordDatasetOp(OpKernelConstruction* ctx);
 
@@ -33,6 +36,10 @@ class AvroRecordDatasetOp : public DatasetOpKernel {
 
  private:
   class Dataset;
+
+  int64 byte_start_;
+  int64 byte_end_;
+  string block_index_suffix_;
 };
 
 }  // namespace data
@@ -9,10 +9,12 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <atomic>
 #include <deque>
+#include <map>
 
-#include "api/Compiler.hh"
 #include "api/Decoder.hh"
+#include "api/Exception.hh"
 #include "api/Generic.hh"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -20,8 +22,14 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow_io/core/kernels/avro/utils/avro_parser_tree.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_projection.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_schema_cache.h"
+#include "tensorflow_io/core/kernels/avro/utils/cpu_affinity.h"
 
 namespace tensorflow {
 namespace data {
@@ -75,6 +83,10 @@ struct AvroParserConfig {
 
   // A vector of sparse configuration information
   std::vector<Sparse> sparse;
+
+  // The number of minibatches requested by the user, 0 to derive it from the
+  // byte size of the records
+  int64 num_minibatches = 0;
 };
 
 // Container for the
@@ -89,24 +101,37 @@ struct AvroResult {
   std::vector<Tensor> dense_values;
 };
 
+// Runs f for all n minibatches on the calling thread and the threads of the
+// pool. Minibatches are not assigned up front, every thread claims the next
+// unprocessed minibatch once it is done with its current one. Threads that
+// finish cheap minibatches early thereby take over the remaining work instead
+// of waiting on a straggler.
 void ParallelFor(const std::function<void(size_t)>& f, size_t n,
                  thread::ThreadPool* thread_pool) {
   if (n == 0) return;
-  if (thread_pool == nullptr) {
+  if (thread_pool == nullptr || n == 1) {
     for (size_t i = 0; i < n; ++i) {
       f(i);
     }
-  } else {
-    BlockingCounter counter(n - 1);
-    for (size_t i = 1; i < n; ++i) {
-      thread_pool->Schedule([i, &f, &counter] {
-        f(i);
-        counter.DecrementCount();
-      });
+    return;
+  }
+  std::atomic<size_t> next(0);
+  auto work = [&f, &next, n] {
+    for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+      f(i);
     }
-    f(0);
-    counter.Wait();
+  };
+  const size_t num_workers =
+      std::min<size_t>(n, static_cast<size_t>(thread_pool->NumThreads()) + 1);
+  BlockingCounter counter(num_workers - 1);
+  for (size_t i = 1; i < num_workers; ++i) {
+    thread_pool->Schedule([&work, &counter] {
+      work();
+      counter.DecrementCount();
+    });
   }
+  work();
+  counter.Wait();
 }
 
 int ResolveDefaultShape(TensorShape* resolved,
@@ -133,22 +158,63 @@ std::map<string, Tensor> CreateTensorDefaults(const AvroParserConfig& config) {
   return defaults;
 }
 
+// The Confluent wire format, as written by the schema registry serializers,
+// prefixes each record with a zero magic byte and the big-endian id of its
+// writer schema in the registry
+struct AvroWireFormat {
+  static constexpr size_t kConfluentHeaderSize = 5;
+
+  bool confluent = false;
+  // Writer schemas by registry id, null for the ids of the reader schema.
+  // Without any, all records are assumed to be written with the reader schema
+  std::map<int32, std::shared_ptr<const avro::ValidSchema>> writer_schemas;
+};
+
+// Reads the records of the range, only the fields of the projection are
+// decoded. Records of other writer schemas are resolved into the reader
+// schema, with a decoder compiled once per writer schema and range
 class StringDatumRangeReader {
  public:
   StringDatumRangeReader(const gtl::ArraySlice<tstring>& serialized,
-                         size_t start, size_t end)
+                         const avro::ValidSchema& reader_schema,
+                         const AvroProjection& projection,
+                         const AvroWireFormat& wire_format, size_t start,
+                         size_t end)
       : serialized_(serialized),
+        reader_schema_(reader_schema),
+        projection_(projection),
+        wire_format_(wire_format),
         current_(start),
         end_(end),
         decoder_(avro::binaryDecoder()) {}
 
   bool read(avro::GenericDatum& datum) {
     if (current_ < end_) {
+      // The record is decoded in place, past the header if there is one
+      const uint8_t* data = (const uint8_t*)serialized_[current_].data();
+      size_t length = serialized_[current_].length();
+      avro::Decoder* resolving_decoder = nullptr;
+      if (wire_format_.confluent) {
+        if (length < AvroWireFormat::kConfluentHeaderSize || data[0] != 0) {
+          throw avro::Exception(strings::StrCat(
+              "Record ", current_, " is not in the Confluent wire format"));
+        }
+        const int32 schema_id = static_cast<int32>(
+            (uint32(data[1]) << 24) | (uint32(data[2]) << 16) |
+            (uint32(data[3]) << 8) | uint32(data[4]));
+        resolving_decoder = ResolvingDecoder(schema_id);
+        data += AvroWireFormat::kConfluentHeaderSize;
+        length -= AvroWireFormat::kConfluentHeaderSize;
+      }
       std::unique_ptr<avro::InputStream> in =
-          avro::memoryInputStream((const uint8_t*)serialized_[current_].data(),
-                                  serialized_[current_].length());
-      decoder_->init(*in);
-      avro::GenericReader::read(*decoder_, datum);
+          avro::memoryInputStream(data, length);
+      if (resolving_decoder == nullptr) {
+        decoder_->init(*in);
+        projection_.Read(*decoder_, datum);
+      } else {
+        resolving_decoder->init(*in);
+        avro::GenericReader::read(*resolving_decoder, datum);
+      }
       current_++;
       return true;
     }
@@ -156,10 +222,74 @@ class StringDatumRangeReader {
   }
 
  private:
+  // Returns the decoder for records of the writer schema `schema_id`, or null
+  // if they are written with the reader schema
+  avro::Decoder* ResolvingDecoder(int32 schema_id) {
+    if (wire_format_.writer_schemas.empty()) {
+      return nullptr;
+    }
+    auto decoder = resolving_decoders_.find(schema_id);
+    if (decoder != resolving_decoders_.end()) {
+      return decoder->second.get();
+    }
+    auto writer_schema = wire_format_.writer_schemas.find(schema_id);
+    if (writer_schema == wire_format_.writer_schemas.end()) {
+      throw avro::Exception(strings::StrCat("Record ", current_,
+                                            " has unknown writer schema id ",
+                                            schema_id));
+    }
+    if (writer_schema->second == nullptr) {
+      return nullptr;
+    }
+    avro::DecoderPtr resolving_decoder = avro::resolvingDecoder(
+        *writer_schema->second, reader_schema_, avro::binaryDecoder());
+    resolving_decoders_[schema_id] = resolving_decoder;
+    return resolving_decoder.get();
+  }
+
   const gtl::ArraySlice<tstring>& serialized_;
+  const avro::ValidSchema& reader_schema_;
+  const AvroProjection& projection_;
+  const AvroWireFormat& wire_format_;
   size_t current_;
   const size_t end_;
   avro::DecoderPtr decoder_;
+  std::map<int32, avro::DecoderPtr> resolving_decoders_;
+};
+
+// Keeps the value stores of the minibatches across calls of a kernel, so that
+// a batch resets the stores of an earlier batch instead of allocating its own.
+// Stores that were merged into a feature are gone and allocated again.
+class ValueStoresPool {
+ public:
+  // Takes the stores of num minibatches, fresh ones if there are too few
+  std::vector<ValueStores> Acquire(size_t num) {
+    std::vector<ValueStores> stores(num);
+    mutex_lock l(mu_);
+    for (size_t i = 0; i < num && !free_.empty(); ++i) {
+      stores[i] = std::move(free_.back());
+      free_.pop_back();
+    }
+    return stores;
+  }
+
+  // Returns the stores for the next call, up to kMaxFree of them
+  void Release(std::vector<ValueStores>* stores) {
+    mutex_lock l(mu_);
+    for (ValueStores& store : *stores) {
+      if (free_.size() >= kMaxFree) {
+        break;
+      }
+      free_.push_back(std::move(store));
+    }
+  }
+
+ private:
+  // The stores of the largest number of minibatches of a batch
+  static constexpr size_t kMaxFree = 256;
+
+  mutex mu_;
+  std::vector<ValueStores> free_ TF_GUARDED_BY(mu_);
 };
 
 // Borrowed most code/concepts from
@@ -169,81 +299,75 @@ class StringDatumRangeReader {
 Status ParseAvro(const AvroParserConfig& config,
                  const AvroParserTree& parser_tree,
                  const avro::ValidSchema& reader_schema,
+                 const AvroProjection& projection,
+                 const AvroWireFormat& wire_format,
                  const gtl::ArraySlice<tstring>& serialized,
-                 thread::ThreadPool* thread_pool, AvroResult* result) {
+                 thread::ThreadPool* thread_pool, ValueStoresPool* pool,
+                 AvroResult* result) {
   DCHECK(result != nullptr);
   using clock = std::chrono::system_clock;
   using ms = std::chrono::duration<double, std::milli>;
   const auto before = clock::now();
-  // Allocate dense output for fixed length dense values
-  // (variable-length dense and sparse and ragged have to be buffered).
-  /*  std::vector<Tensor> fixed_len_dense_values(config.dense.size());
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      if (config.dense[d].variable_length) continue;
-      TensorShape out_shape;
-      out_shape.AddDim(serialized.size());
-      for (const int64 dim : config.dense[d].shape.dim_sizes()) {
-        out_shape.AddDim(dim);
-      }
-      fixed_len_dense_values[d] = Tensor(config.dense[d].dtype, out_shape);
-    }*/
-
-  // This parameter affects performance in a big and data-dependent way.
-  const size_t kMiniBatchSizeBytes = 50000;
-
-  // avro_num_minibatches_ is int64 in the op interface. If not set
-  // the default value is 0.
-  size_t avro_num_minibatches_;
-
-  // Calculate number of minibatches.
-  // In main regime make each minibatch around kMiniBatchSizeBytes bytes.
-  // Apply 'special logic' below for small and big regimes.
-  const size_t num_minibatches = [&] {
-    size_t result = 0;
+  // These parameters affect performance in a big and data-dependent way.
+  // A minibatch holds at least kMinMiniBatchSizeBytes bytes of records, below
+  // that the merge and scheduling overhead outweighs the parallelism.
+  const size_t kMinMiniBatchSizeBytes = 50000;
+  // Split the batch into more minibatches than threads, so that threads can
+  // take over minibatches from a straggler.
+  const size_t kMiniBatchesPerThread = 4;
+  const size_t kMaxMiniBatches = 256;
+
+  // Calculate the boundaries of the minibatches from the byte size of the
+  // records, records with long variable length arrays are more work than
+  // their count suggests. Every minibatch holds at least one record.
+  const std::vector<size_t> minibatch_starts = [&] {
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < serialized.size(); i++) {
+      total_bytes += serialized[i].size() + 1;
+    }
+    size_t minibatch_bytes_target;
+    if (config.num_minibatches > 0) {
+      VLOG(5) << "Overriding num_minibatches with " << config.num_minibatches;
+      const size_t num = static_cast<size_t>(config.num_minibatches);
+      minibatch_bytes_target = (total_bytes + num - 1) / num;
+    } else {
+      const size_t num_threads =
+          thread_pool == nullptr ? 1 : thread_pool->NumThreads() + 1;
+      minibatch_bytes_target = std::max<size_t>(
+          kMinMiniBatchSizeBytes,
+          total_bytes / std::min<size_t>(kMaxMiniBatches,
+                                         num_threads * kMiniBatchesPerThread));
+    }
+    std::vector<size_t> starts;
     size_t minibatch_bytes = 0;
     for (size_t i = 0; i < serialized.size(); i++) {
       if (minibatch_bytes == 0) {  // start minibatch
-        result++;
+        starts.push_back(i);
       }
       minibatch_bytes += serialized[i].size() + 1;
-      if (minibatch_bytes > kMiniBatchSizeBytes) {
+      if (minibatch_bytes >= minibatch_bytes_target) {
         minibatch_bytes = 0;
       }
     }
-    if (avro_num_minibatches_) {
-      VLOG(5) << "Overriding num_minibatches with " << avro_num_minibatches_;
-      result = avro_num_minibatches_;
-    }
-    // This is to ensure users can control the num minibatches all the way down
-    // to size of 1(no parallelism).
-    const size_t min_minibatches = std::min<size_t>(1, serialized.size());
-    const size_t max_minibatches = 64;
-    return std::max<size_t>(min_minibatches,
-                            std::min<size_t>(max_minibatches, result));
+    starts.push_back(serialized.size());
+    return starts;
   }();
+  const size_t num_minibatches = minibatch_starts.size() - 1;
 
   auto first_of_minibatch = [&](size_t minibatch) -> size_t {
-    return (serialized.size() * minibatch) / num_minibatches;
+    return minibatch_starts[minibatch];
   };
 
   VLOG(5) << "Computed " << num_minibatches << " minibatches";
 
-  // TODO(lew): A big performance low-hanging fruit here is to improve
-  //   num_minibatches calculation to take into account actual amount of work
-  //   needed, as the size in bytes is not perfect. Linear combination of
-  //   size in bytes and average number of features per example is promising.
-  //   Even better: measure time instead of estimating, but this is too costly
-  //   in small batches.
-  //   Maybe accept outside parameter #num_minibatches?
-
   // Do minibatches in parallel.
-  // TODO(fraudies): Convert dense tensor
-  // TODO(fraudies): Might be faster to reformat inside the process minibatch
-  // into vector
 
   // Note, using vector here is thread safe since all operations inside the
   // multi-threaded region for a vector are thread safe
-  std::vector<std::map<string, ValueStoreUniquePtr>> buffers(num_minibatches);
+  // Each minibatch holds its value stores in the slots of the parser tree,
+  // they are taken from and returned to the pool of the kernel
+  std::vector<ValueStores> buffers = pool->Acquire(num_minibatches);
+  auto release_buffers = gtl::MakeCleanup([&] { pool->Release(&buffers); });
 
   std::vector<Status> status_of_minibatch(num_minibatches);
 
@@ -252,7 +376,8 @@ Status ParseAvro(const AvroParserConfig& config,
   auto ProcessMiniBatch = [&](size_t minibatch) {
     size_t start = first_of_minibatch(minibatch);
     size_t end = first_of_minibatch(minibatch + 1);
-    StringDatumRangeReader range_reader(serialized, start, end);
+    StringDatumRangeReader range_reader(serialized, reader_schema, projection,
+                                        wire_format, start, end);
     auto read_value = [&](avro::GenericDatum& d) {
       return range_reader.read(d);
     };
@@ -270,18 +395,212 @@ Status ParseAvro(const AvroParserConfig& config,
     TF_RETURN_IF_ERROR(status);
   }
 
-  result->sparse_indices.reserve(config.sparse.size());
-  result->sparse_values.reserve(config.sparse.size());
-  result->sparse_shapes.reserve(config.sparse.size());
-  result->dense_values.reserve(config.dense.size());
+  const size_t batch_size = serialized.size();
+  result->sparse_indices.resize(config.sparse.size());
+  result->sparse_values.resize(config.sparse.size());
+  result->sparse_shapes.resize(config.sparse.size());
+  result->dense_values.resize(config.dense.size());
+
+  std::vector<size_t> sparse_slots(config.sparse.size());
+  for (size_t i_sparse = 0; i_sparse < config.sparse.size(); ++i_sparse) {
+    TF_RETURN_IF_ERROR(parser_tree.GetSlot(config.sparse[i_sparse].feature_name,
+                                           &sparse_slots[i_sparse]));
+  }
+  std::vector<size_t> dense_slots(config.dense.size());
+  for (size_t i_dense = 0; i_dense < config.dense.size(); ++i_dense) {
+    TF_RETURN_IF_ERROR(parser_tree.GetSlot(config.dense[i_dense].feature_name,
+                                           &dense_slots[i_dense]));
+  }
+
+  // If we can resolve the dense shape of a default add batch, otherwise keep
+  // things as they are
+  std::vector<Tensor> dense_default_values(config.dense.size());
+  std::vector<TensorShape> dense_default_shapes(config.dense.size());
+  for (size_t i_dense = 0; i_dense < config.dense.size(); ++i_dense) {
+    const AvroParserConfig::Dense& dense = config.dense[i_dense];
+    Tensor& default_value = dense_default_values[i_dense];
+    TensorShape& default_shape = dense_default_shapes[i_dense];
+    if (ResolveDefaultShape(&default_shape, dense.default_value.shape(),
+                            batch_size)) {
+      default_value = Tensor(dense.dtype, default_shape);
+      TF_RETURN_IF_ERROR(
+          tensor::Concat(std::vector<Tensor>(batch_size, dense.default_value),
+                         &default_value));
+    } else {
+      default_value = dense.default_value;
+      default_shape = default_value.shape();
+    }
+  }
+
+  // Combines the dense shapes of all minibatches with records into the dense
+  // shape of the batch. The rows add up and the inner dimensions are the
+  // maximum over all minibatches. Returns false if the minibatches do not
+  // agree on the number of dimensions.
+  auto GetBatchDenseShape = [&](TensorShape* shape, size_t slot) -> bool {
+    bool has_shape = false;
+    for (size_t minibatch = 0; minibatch < num_minibatches; ++minibatch) {
+      if (first_of_minibatch(minibatch) == first_of_minibatch(minibatch + 1)) {
+        continue;
+      }
+      TensorShape minibatch_shape;
+      (*buffers[minibatch][slot]).GetDenseShape(&minibatch_shape);
+      if (!has_shape) {
+        *shape = minibatch_shape;
+        has_shape = true;
+        continue;
+      }
+      if (minibatch_shape.dims() != (*shape).dims() || (*shape).dims() < 1) {
+        return false;
+      }
+      (*shape).set_dim(0, (*shape).dim_size(0) + minibatch_shape.dim_size(0));
+      for (int i_dim = 1; i_dim < (*shape).dims(); ++i_dim) {
+        (*shape).set_dim(i_dim, std::max((*shape).dim_size(i_dim),
+                                         minibatch_shape.dim_size(i_dim)));
+      }
+    }
+    return has_shape;
+  };
+
+  // Dense features with a fully defined shape and sparse features are
+  // allocated up front and every minibatch writes its rows directly into the
+  // output tensors. All other features are merged first, see below.
+  std::vector<bool> direct_dense(config.dense.size(), false);
+  std::vector<bool> direct_sparse(config.sparse.size(), false);
+  std::vector<std::vector<int64>> sparse_value_offsets(config.sparse.size());
+
+  auto AllocateDenseOutput = [&](size_t i_dense) -> Status {
+    const AvroParserConfig::Dense& dense = config.dense[i_dense];
+    if (!dense.shape.IsFullyDefined()) {
+      return OkStatus();
+    }
+    const TensorShape& default_shape = dense_default_shapes[i_dense];
+    TensorShape resolved_shape;
+    if (IsNonTrivialShape(default_shape)) {
+      // Note, data shape does not have to be compatible because we will pad
+      if (default_shape.dims() < 1 ||
+          default_shape.dim_size(0) != static_cast<int64>(batch_size)) {
+        return OkStatus();
+      }
+      resolved_shape = default_shape;
+    } else {
+      // Default is trivial, get shape from data and ensure it's consistent
+      // with users batched shape
+      TensorShape data_shape;
+      if (!GetBatchDenseShape(&data_shape, dense_slots[i_dense])) {
+        return OkStatus();
+      }
+      PartialTensorShape batched_user_shape(
+          PartialTensorShape({static_cast<long long>(batch_size)})
+              .Concatenate(dense.shape));
+      if (!batched_user_shape.IsCompatibleWith(data_shape)) {
+        return errors::InvalidArgument(
+            "Batched user shape", batched_user_shape,
+            " is incompatible with data shape: ", data_shape);
+      }
+      resolved_shape = data_shape;
+    }
+    VLOG(5) << "Allocate dense tensor for feature '" << dense.feature_name
+            << "' with shape " << resolved_shape;
+    result->dense_values[i_dense] = Tensor(dense.dtype, resolved_shape);
+    direct_dense[i_dense] = true;
+    return OkStatus();
+  };
+
+  // Counts the values of each minibatch to size the sparse output tensors and
+  // to find the offset of each minibatch in them
+  auto AllocateSparseOutput = [&](size_t i_sparse) -> Status {
+    const AvroParserConfig::Sparse& sparse = config.sparse[i_sparse];
+    const size_t slot = sparse_slots[i_sparse];
+    TensorShape dense_shape;
+    if (!GetBatchDenseShape(&dense_shape, slot) || dense_shape.dims() < 2) {
+      return OkStatus();
+    }
+    std::vector<int64>& offsets = sparse_value_offsets[i_sparse];
+    offsets.resize(num_minibatches);
+    int64 num_values = 0;
+    for (size_t minibatch = 0; minibatch < num_minibatches; ++minibatch) {
+      offsets[minibatch] = num_values;
+      if (first_of_minibatch(minibatch) == first_of_minibatch(minibatch + 1)) {
+        continue;
+      }
+      TensorShape value_shape;
+      TF_RETURN_IF_ERROR(
+          (*buffers[minibatch][slot]).GetSparseValueShape(&value_shape));
+      num_values += value_shape.dim_size(0);
+    }
+    const int64 rank = dense_shape.dims();
+    VLOG(5) << "Allocate sparse tensor for feature '" << sparse.feature_name
+            << "' with " << num_values << " values and dense shape "
+            << dense_shape;
+    result->sparse_values[i_sparse] =
+        Tensor(sparse.dtype, TensorShape({num_values}));
+    result->sparse_indices[i_sparse] =
+        Tensor(DT_INT64, TensorShape({num_values, rank}));
+    result->sparse_shapes[i_sparse] = Tensor(DT_INT64, TensorShape({rank}));
+    auto shape_flat = result->sparse_shapes[i_sparse].flat<int64>();
+    for (int64 i_dim = 0; i_dim < rank; ++i_dim) {
+      shape_flat(i_dim) = dense_shape.dim_size(i_dim);
+    }
+    direct_sparse[i_sparse] = true;
+    return OkStatus();
+  };
+
+  for (size_t i_dense = 0; i_dense < config.dense.size(); ++i_dense) {
+    TF_RETURN_IF_ERROR(AllocateDenseOutput(i_dense));
+  }
+  for (size_t i_sparse = 0; i_sparse < config.sparse.size(); ++i_sparse) {
+    TF_RETURN_IF_ERROR(AllocateSparseOutput(i_sparse));
+  }
+
+  auto FillMiniBatch = [&](size_t minibatch) {
+    const size_t start = first_of_minibatch(minibatch);
+    const size_t end = first_of_minibatch(minibatch + 1);
+    if (start == end) {
+      return;
+    }
+    Status& status = status_of_minibatch[minibatch];
+    for (size_t i_dense = 0; i_dense < config.dense.size() && status.ok();
+         ++i_dense) {
+      if (!direct_dense[i_dense]) {
+        continue;
+      }
+      Tensor* dense_tensor = &result->dense_values[i_dense];
+      TensorShape rows_shape((*dense_tensor).shape());
+      rows_shape.set_dim(0, end - start);
+      status = (*buffers[minibatch][dense_slots[i_dense]])
+                   .MakeDenseRows(dense_tensor, start, rows_shape,
+                                  dense_default_values[i_dense]);
+    }
+    for (size_t i_sparse = 0; i_sparse < config.sparse.size() && status.ok();
+         ++i_sparse) {
+      if (!direct_sparse[i_sparse]) {
+        continue;
+      }
+      status = (*buffers[minibatch][sparse_slots[i_sparse]])
+                   .MakeSparseAt(&result->sparse_values[i_sparse],
+                                 &result->sparse_indices[i_sparse],
+                                 sparse_value_offsets[i_sparse][minibatch],
+                                 start);
+    }
+  };
+  const auto before_fill = clock::now();
+  ParallelFor(FillMiniBatch, num_minibatches, thread_pool);
+  const auto after_fill = clock::now();
+  const ms fill_duration = after_fill - before_fill;
+  VLOG(5) << "PARSER_TIMING: Direct fill duration " << fill_duration.count()
+          << " ms ";
+  for (Status& status : status_of_minibatch) {
+    TF_RETURN_IF_ERROR(status);
+  }
 
   auto MergeSparseMinibatches = [&](size_t i_sparse) -> Status {
     const AvroParserConfig::Sparse& sparse = config.sparse[i_sparse];
     const string& feature_name = sparse.feature_name;
 
+    const size_t slot = sparse_slots[i_sparse];
     std::vector<ValueStoreUniquePtr> values(buffers.size());
     for (size_t i = 0; i < buffers.size(); ++i) {
-      values[i] = std::move(buffers[i][feature_name]);
+      values[i] = std::move(buffers[i][slot]);
     }
     ValueStoreUniquePtr value_store;
     TF_RETURN_IF_ERROR(MergeAs(value_store, values, sparse.dtype));
@@ -291,19 +610,19 @@ Status ParseAvro(const AvroParserConfig& config,
 
     TensorShape value_shape;
     TF_RETURN_IF_ERROR((*value_store).GetSparseValueShape(&value_shape));
-    result->sparse_values.emplace_back(sparse.dtype, value_shape);
-    Tensor* sparse_tensor_values = &result->sparse_values.back();
+    result->sparse_values[i_sparse] = Tensor(sparse.dtype, value_shape);
+    Tensor* sparse_tensor_values = &result->sparse_values[i_sparse];
     TensorShape index_shape;
     TF_RETURN_IF_ERROR((*value_store).GetSparseIndexShape(&index_shape));
-    result->sparse_indices.emplace_back(DT_INT64, index_shape);
-    Tensor* sparse_tensor_indices = &result->sparse_indices.back();
+    result->sparse_indices[i_sparse] = Tensor(DT_INT64, index_shape);
+    Tensor* sparse_tensor_indices = &result->sparse_indices[i_sparse];
     TF_RETURN_IF_ERROR(
         (*value_store).MakeSparse(sparse_tensor_values, sparse_tensor_indices));
 
     int64 rank = result->sparse_indices[i_sparse].dim_size(
         1);  // rank is the 2nd dimension of the index
-    result->sparse_shapes.emplace_back(DT_INT64, TensorShape({rank}));
-    Tensor* sparse_tensor_shapes = &result->sparse_shapes.back();
+    result->sparse_shapes[i_sparse] = Tensor(DT_INT64, TensorShape({rank}));
+    Tensor* sparse_tensor_shapes = &result->sparse_shapes[i_sparse];
     TF_RETURN_IF_ERROR(
         (*value_store).GetDenseShapeForSparse(sparse_tensor_shapes));
 
@@ -322,16 +641,15 @@ Status ParseAvro(const AvroParserConfig& config,
   };
 
   auto MergeDenseMinibatches = [&](size_t i_dense) -> Status {
-    // TODO(fraudies): Fixed allocation for fixed length
-    // if (!config.dense[d].variable_length) return;
     const AvroParserConfig::Dense& dense = config.dense[i_dense];
     const string& feature_name = dense.feature_name;
 
     VLOG(5) << "Working on feature: '" << feature_name << "'";
 
+    const size_t slot = dense_slots[i_dense];
     std::vector<ValueStoreUniquePtr> values(buffers.size());
     for (size_t i = 0; i < buffers.size(); ++i) {
-      values[i] = std::move(buffers[i][feature_name]);
+      values[i] = std::move(buffers[i][slot]);
       VLOG(5) << "Value " << i << ": " << (*values[i]).ToString(10);
     }
 
@@ -342,21 +660,8 @@ Status ParseAvro(const AvroParserConfig& config,
 
     VLOG(5) << "Merged value store: " << value_store->ToString(10);
 
-    size_t batch_size = serialized.size();
-    TensorShape default_shape;
-    Tensor default_value;
-    // If we can resolve the dense shape add batch, otherwise keep things as
-    // they are
-    if (ResolveDefaultShape(&default_shape, dense.default_value.shape(),
-                            batch_size)) {
-      default_value = Tensor(dense.dtype, default_shape);
-      TF_RETURN_IF_ERROR(
-          tensor::Concat(std::vector<Tensor>(batch_size, dense.default_value),
-                         &default_value));
-    } else {
-      default_value = dense.default_value;
-      default_shape = default_value.shape();
-    }
+    const TensorShape& default_shape = dense_default_shapes[i_dense];
+    const Tensor& default_value = dense_default_values[i_dense];
 
     VLOG(5) << "Dense shape is " << dense.shape;
     VLOG(5) << "Default shape is " << default_shape;
@@ -371,8 +676,8 @@ Status ParseAvro(const AvroParserConfig& config,
     VLOG(5) << "Creating dense tensor for resolved shape: " << resolved_shape
             << " given the user shape " << dense.shape;
 
-    result->dense_values.emplace_back(dense.dtype, resolved_shape);
-    Tensor* dense_tensor = &result->dense_values.back();
+    result->dense_values[i_dense] = Tensor(dense.dtype, resolved_shape);
+    Tensor* dense_tensor = &result->dense_values[i_dense];
 
     TF_RETURN_IF_ERROR(
         (*value_store).MakeDense(dense_tensor, resolved_shape, default_value));
@@ -383,12 +688,16 @@ Status ParseAvro(const AvroParserConfig& config,
   };
   const auto before_sparse_merge = clock::now();
   for (size_t d = 0; d < config.sparse.size(); ++d) {
-    TF_RETURN_IF_ERROR(MergeSparseMinibatches(d));
+    if (!direct_sparse[d]) {
+      TF_RETURN_IF_ERROR(MergeSparseMinibatches(d));
+    }
   }
   const auto after_sparse_merge = clock::now();
   const ms s_merge_duration = after_sparse_merge - before_sparse_merge;
   for (size_t d = 0; d < config.dense.size(); ++d) {
-    TF_RETURN_IF_ERROR(MergeDenseMinibatches(d));
+    if (!direct_dense[d]) {
+      TF_RETURN_IF_ERROR(MergeDenseMinibatches(d));
+    }
   }
   const auto after_dense_merge = clock::now();
   const ms d_merge_duration = after_dense_merge - after_sparse_merge;
@@ -432,15 +741,54 @@ class ParseAvroOp : public OpKernel {
     string reader_schema_str;
     OP_REQUIRES_OK(ctx, ctx->GetAttr("reader_schema", &reader_schema_str));
 
-    string error;
-    std::istringstream ss(reader_schema_str);
-    if (!avro::compileJsonSchema(ss, reader_schema_, error)) {
-      OP_REQUIRES_OK(ctx,
-                     errors::InvalidArgument("Avro schema error: ", error));
+    // Kernels with the same schema and features share the compiled schema and
+    // the parser tree
+    AvroSchemaCache* cache = AvroSchemaCache::Global();
+    OP_REQUIRES_OK(ctx, cache->GetSchema(reader_schema_str, &reader_schema_));
+    OP_REQUIRES_OK(ctx,
+                   cache->GetParserTree(CreateKeysAndTypes(), &parser_tree_));
+
+    // Decode only the fields that the features refer to
+    OP_REQUIRES_OK(ctx, AvroProjection::Build(&projection_, *parser_tree_,
+                                              *reader_schema_));
+
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("confluent_wire_format",
+                                     &wire_format_.confluent));
+    std::vector<int32> writer_schema_ids;
+    std::vector<string> writer_schemas;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("writer_schema_ids", &writer_schema_ids));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("writer_schemas", &writer_schemas));
+    OP_REQUIRES(ctx, writer_schema_ids.size() == writer_schemas.size(),
+                errors::InvalidArgument(
+                    "Expected len(writer_schema_ids) == len(writer_schemas) "
+                    "but got: ",
+                    writer_schema_ids.size(), " vs. ", writer_schemas.size()));
+    OP_REQUIRES(ctx, wire_format_.confluent || writer_schemas.empty(),
+                errors::InvalidArgument(
+                    "writer_schemas require the Confluent wire format"));
+    for (size_t i = 0; i < writer_schemas.size(); ++i) {
+      std::shared_ptr<const avro::ValidSchema> writer_schema;
+      OP_REQUIRES_OK(ctx, cache->GetSchema(writer_schemas[i], &writer_schema));
+      // The cache hands out the same schema for the same definition
+      if (writer_schema == reader_schema_) {
+        writer_schema = nullptr;
+      }
+      wire_format_.writer_schemas[writer_schema_ids[i]] = writer_schema;
     }
 
-    OP_REQUIRES_OK(ctx,
-                   AvroParserTree::Build(&parser_tree_, CreateKeysAndTypes()));
+    // With a NUMA node or CPU set to decode on, the minibatches are parsed
+    // on a pool of threads pinned there instead of the shared worker threads
+    int64 numa_node;
+    string cpu_affinity;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("numa_node", &numa_node));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("cpu_affinity", &cpu_affinity));
+    std::vector<int> cpus;
+    OP_REQUIRES_OK(ctx, ResolveCPUAffinity(numa_node, cpu_affinity, &cpus));
+    if (!cpus.empty()) {
+      thread_pool_.reset(new thread::ThreadPool(
+          ctx->env(), "parse_avro", static_cast<int>(cpus.size())));
+      PinThreadPool(thread_pool_.get(), cpus);
+    }
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -471,6 +819,7 @@ class ParseAvroOp : public OpKernel {
     }
 
     AvroParserConfig config;
+    config.num_minibatches = avro_num_minibatches_;
     for (size_t d = 0; d < num_dense_; ++d) {
       VLOG(7) << "Dense: Creating parser key " << dense_keys_[d]
               << " with type " << DataTypeString(dense_types_[d]);
@@ -490,9 +839,13 @@ class ParseAvroOp : public OpKernel {
 
     AvroResult result;
     OP_REQUIRES_OK(
-        ctx, ParseAvro(config, parser_tree_, reader_schema_, slice,
-                       ctx->device()->tensorflow_cpu_worker_threads()->workers,
-                       &result));
+        ctx, ParseAvro(config, *parser_tree_, *reader_schema_, projection_,
+                       wire_format_, slice,
+                       thread_pool_ != nullptr
+                           ? thread_pool_.get()
+                           : ctx->device()->tensorflow_cpu_worker_threads()
+                                 ->workers,
+                       &value_stores_pool_, &result));
 
     OpOutputList dense_values;
     OpOutputList sparse_indices;
@@ -513,17 +866,21 @@ class ParseAvroOp : public OpKernel {
   }
 
  protected:
-  AvroParserTree parser_tree_;
+  std::shared_ptr<const AvroParserTree> parser_tree_;
   std::vector<DataType> sparse_types_;
   std::vector<DataType> dense_types_;
   std::vector<string> sparse_keys_;
   std::vector<string> dense_keys_;
   std::vector<PartialTensorShape> dense_shapes_;
   std::vector<bool> variable_length_;
-  avro::ValidSchema reader_schema_;
+  std::shared_ptr<const avro::ValidSchema> reader_schema_;
+  AvroProjection projection_;
+  AvroWireFormat wire_format_;
   size_t num_dense_;
   size_t num_sparse_;
   int64 avro_num_minibatches_;
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+  ValueStoresPool value_stores_pool_;
 
  private:
   std::vector<std::pair<string, DataType>> CreateKeysAndTypes() {
@@ -0,0 +1,210 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_codec.h"
+
+#include <algorithm>
+#include <boost/crc.hpp>  // for boost::crc_32_type
+#include <cstring>
+
+#include "lz4frame.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "zlib.h"
+#include "zstd.h"
+
+#ifdef SNAPPY_CODEC_AVAILABLE
+#include <snappy.h>
+#endif
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+constexpr size_t kMinBufferSize = 4096;
+
+// Doubles the buffer once the output filled it.
+void GrowBuffer(tstring* buffer) {
+  buffer->resize_uninitialized(std::max(buffer->size() * 2, kMinBufferSize));
+}
+}  // namespace
+
+Status DecompressDeflateBlock(const char* compressed, size_t size,
+                              tstring* uncompressed) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  // Avro deflate blocks are raw deflate streams without zlib header.
+  if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+    return errors::Internal("Failed to initialize zlib for decompression.");
+  }
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed));
+  zs.avail_in = static_cast<uInt>(size);
+  size_t total_out = 0;
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END) {
+    if (total_out == uncompressed->size()) {
+      GrowBuffer(uncompressed);
+    }
+    zs.next_out = reinterpret_cast<Bytef*>(uncompressed->data() + total_out);
+    zs.avail_out = static_cast<uInt>(uncompressed->size() - total_out);
+    ret = inflate(&zs, Z_NO_FLUSH);
+    total_out = uncompressed->size() - zs.avail_out;
+    if ((ret == Z_OK || ret == Z_BUF_ERROR) && zs.avail_in == 0 &&
+        zs.avail_out > 0) {
+      // All input is consumed but the stream has no end marker.
+      inflateEnd(&zs);
+      return errors::DataLoss("Truncated deflate Avro block.");
+    }
+    if (ret != Z_OK && ret != Z_STREAM_END) {
+      inflateEnd(&zs);
+      return errors::DataLoss("Cannot decompress deflate Avro block.");
+    }
+  }
+  inflateEnd(&zs);
+  uncompressed->resize_uninitialized(total_out);
+  return OkStatus();
+}
+
+#ifdef SNAPPY_CODEC_AVAILABLE
+Status DecompressSnappyBlock(const char* compressed, size_t size,
+                             tstring* uncompressed) {
+  // Snappy blocks end with the big endian CRC32 of the uncompressed data.
+  if (size < 4) {
+    return errors::DataLoss("Truncated snappy Avro block.");
+  }
+  size_t len = size - 4;
+  size_t uncompressed_length = 0;
+  if (!snappy::GetUncompressedLength(compressed, len, &uncompressed_length)) {
+    return errors::DataLoss("Cannot decompress snappy Avro block.");
+  }
+  uncompressed->resize_uninitialized(uncompressed_length);
+  if (!snappy::RawUncompress(compressed, len, uncompressed->data())) {
+    return errors::DataLoss("Cannot decompress snappy Avro block.");
+  }
+  const uint8_t* crc_bytes = reinterpret_cast<const uint8_t*>(compressed + len);
+  uint32 checksum = (static_cast<uint32>(crc_bytes[0]) << 24) |
+                    (static_cast<uint32>(crc_bytes[1]) << 16) |
+                    (static_cast<uint32>(crc_bytes[2]) << 8) |
+                    static_cast<uint32>(crc_bytes[3]);
+  boost::crc_32_type crc;
+  crc.process_bytes(uncompressed->data(), uncompressed->size());
+  if (crc() != checksum) {
+    return errors::DataLoss("Checksum did not match for snappy Avro block.");
+  }
+  return OkStatus();
+}
+#endif
+
+Status DecompressZstandardBlock(const char* compressed, size_t size,
+                                tstring* uncompressed) {
+  unsigned long long content_size = ZSTD_getFrameContentSize(compressed, size);
+  if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+    return errors::DataLoss("Invalid Zstandard frame in Avro block.");
+  }
+  if (content_size != ZSTD_CONTENTSIZE_UNKNOWN) {
+    // The frame header has the uncompressed size, decompress in one shot.
+    uncompressed->resize_uninitialized(static_cast<size_t>(content_size));
+    size_t ret = ZSTD_decompress(uncompressed->data(), uncompressed->size(),
+                                 compressed, size);
+    if (ZSTD_isError(ret)) {
+      return errors::DataLoss("Cannot decompress Zstandard Avro block: ",
+                              ZSTD_getErrorName(ret));
+    }
+    uncompressed->resize_uninitialized(ret);
+    return OkStatus();
+  }
+
+  // Streaming writers may omit the content size from the frame header.
+  ZSTD_DStream* stream = ZSTD_createDStream();
+  ZSTD_initDStream(stream);
+  if (uncompressed->size() < ZSTD_DStreamOutSize()) {
+    uncompressed->resize_uninitialized(ZSTD_DStreamOutSize());
+  }
+  ZSTD_inBuffer input = {compressed, size, 0};
+  size_t total_out = 0;
+  // The decoder may hold output that did not fit, even once all input is
+  // consumed. It returns 0 once the frame is decoded and flushed.
+  size_t ret = 1;
+  while (ret != 0) {
+    if (total_out == uncompressed->size()) {
+      GrowBuffer(uncompressed);
+    }
+    ZSTD_outBuffer output = {uncompressed->data(), uncompressed->size(),
+                             total_out};
+    ret = ZSTD_decompressStream(stream, &output, &input);
+    total_out = output.pos;
+    if (ZSTD_isError(ret)) {
+      ZSTD_freeDStream(stream);
+      return errors::DataLoss("Cannot decompress Zstandard Avro block: ",
+                              ZSTD_getErrorName(ret));
+    }
+    if (ret != 0 && input.pos == input.size && output.pos < output.size) {
+      // The decoder has room for output but needs more input.
+      ZSTD_freeDStream(stream);
+      return errors::DataLoss("Truncated Zstandard frame in Avro block.");
+    }
+  }
+  ZSTD_freeDStream(stream);
+  uncompressed->resize_uninitialized(total_out);
+  return OkStatus();
+}
+
+Status DecompressLz4Block(const char* compressed, size_t size,
+                          tstring* uncompressed) {
+  LZ4F_dctx* dctx = nullptr;
+  if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+    return errors::Internal("Failed to initialize LZ4 for decompression.");
+  }
+  LZ4F_frameInfo_t frame_info;
+  size_t header_size = size;
+  size_t ret = LZ4F_getFrameInfo(dctx, &frame_info, compressed, &header_size);
+  if (LZ4F_isError(ret)) {
+    LZ4F_freeDecompressionContext(dctx);
+    return errors::DataLoss("Cannot decompress LZ4 Avro block: ",
+                            LZ4F_getErrorName(ret));
+  }
+  size_t total_in = header_size;
+  size_t total_out = 0;
+  if (frame_info.contentSize > 0) {
+    uncompressed->resize_uninitialized(
+        static_cast<size_t>(frame_info.contentSize));
+  }
+  // LZ4F_decompress keeps the output that did not fit in its internal
+  // buffer, and returns 0 once the frame is decoded and flushed.
+  while (ret != 0) {
+    if (total_out == uncompressed->size()) {
+      GrowBuffer(uncompressed);
+    }
+    size_t available = uncompressed->size() - total_out;
+    size_t dst_size = available;
+    size_t src_size = size - total_in;
+    ret = LZ4F_decompress(dctx, uncompressed->data() + total_out, &dst_size,
+                          compressed + total_in, &src_size, nullptr);
+    if (LZ4F_isError(ret)) {
+      LZ4F_freeDecompressionContext(dctx);
+      return errors::DataLoss("Cannot decompress LZ4 Avro block: ",
+                              LZ4F_getErrorName(ret));
+    }
+    total_in += src_size;
+    total_out += dst_size;
+    if (ret != 0 && total_in == size && dst_size < available) {
+      // The decoder has room for output but needs more input.
+      LZ4F_freeDecompressionContext(dctx);
+      return errors::DataLoss("Truncated LZ4 frame in Avro block.");
+    }
+  }
+  LZ4F_freeDecompressionContext(dctx);
+  uncompressed->resize_uninitialized(total_out);
+  return OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,47 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_CODEC_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_CODEC_H_
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+// Decompress the content of an Avro block, `size` bytes at `compressed`,
+// written with the codec of the function name. The size of `uncompressed`
+// on entry is the first guess of the uncompressed size, so that a pooled
+// buffer can be passed in. It is grown as needed and resized to the
+// uncompressed content. Corrupt and truncated blocks return DATA_LOSS.
+
+Status DecompressDeflateBlock(const char* compressed, size_t size,
+                              tstring* uncompressed);
+
+#ifdef SNAPPY_CODEC_AVAILABLE
+// Also verifies the CRC32 that ends a snappy block.
+Status DecompressSnappyBlock(const char* compressed, size_t size,
+                             tstring* uncompressed);
+#endif
+
+// Frames with and without the content size in their header are supported,
+// the latter as written by streaming writers.
+Status DecompressZstandardBlock(const char* compressed, size_t size,
+                                tstring* uncompressed);
+
+Status DecompressLz4Block(const char* compressed, size_t size,
+                          tstring* uncompressed);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_CODEC_H_
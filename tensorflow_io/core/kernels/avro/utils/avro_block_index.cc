@@ -0,0 +1,208 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_index.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_record_reader.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+// Format of a saved index: magic, sync marker of the file, number of blocks
+// and, per block, the varint encoded distance to the previous block and the
+// number of records.
+constexpr char kIndexMagic[] = "AVROIDX1";
+constexpr size_t kIndexMagicSize = sizeof(kIndexMagic) - 1;
+}  // namespace
+
+Status AvroBlockIndex::Build(RandomAccessFile* file, int64 buffer_size,
+                             AvroBlockIndex* index) {
+  AvroBlockRecordReader reader(file, buffer_size);
+  TF_RETURN_IF_ERROR(reader.Init());
+  index->sync_marker_ = reader.sync_marker();
+  index->blocks_.clear();
+  while (true) {
+    Block block;
+    block.offset = reader.Tell();
+    Status status = reader.SkipBlock(&block.num_records);
+    if (errors::IsOutOfRange(status)) {
+      break;
+    }
+    TF_RETURN_IF_ERROR(status);
+    index->blocks_.emplace_back(block);
+  }
+  return OkStatus();
+}
+
+namespace {
+// The blocks whose sync marker starts in a byte range of a file, and the
+// offsets at which the scan of the range started and stopped.
+struct RangeBlocks {
+  Status status;
+  avro::DataFileSync sync_marker;
+  int64 scan_start = 0;
+  int64 scan_end = 0;
+  std::vector<AvroBlockIndex::Block> blocks;
+};
+
+void ScanRange(RandomAccessFile* file, int64 buffer_size, int64 byte_start,
+               int64 byte_end, RangeBlocks* range) {
+  AvroBlockRecordReader reader(file, buffer_size);
+  range->status = reader.Init();
+  if (!range->status.ok()) {
+    return;
+  }
+  range->sync_marker = reader.sync_marker();
+  const int64 sync_size = static_cast<int64>(range->sync_marker.size());
+  // The first block follows the sync marker that ends the header.
+  const int64 header_end = reader.Tell();
+  if (byte_start <= header_end - sync_size) {
+    range->status = reader.SeekToBlock(header_end);
+  } else {
+    range->status = reader.Sync(byte_start);
+  }
+  if (!range->status.ok()) {
+    return;
+  }
+  range->scan_start = reader.Tell();
+  while (byte_end < 0 || reader.Tell() < byte_end + sync_size) {
+    AvroBlockIndex::Block block;
+    block.offset = reader.Tell();
+    Status status = reader.SkipBlock(&block.num_records);
+    if (errors::IsOutOfRange(status)) {
+      break;
+    }
+    if (!status.ok()) {
+      range->status = status;
+      return;
+    }
+    range->blocks.emplace_back(block);
+  }
+  range->scan_end = reader.Tell();
+}
+}  // namespace
+
+Status AvroBlockIndex::Build(RandomAccessFile* file, int64 file_size,
+                             int64 buffer_size, int max_ranges,
+                             int64 min_range_bytes,
+                             thread::ThreadPool* thread_pool,
+                             AvroBlockIndex* index) {
+  const int num_ranges = static_cast<int>(std::min<int64>(
+      max_ranges,
+      std::max<int64>(file_size / std::max<int64>(min_range_bytes, 1), 1)));
+  if (num_ranges <= 1 || thread_pool == nullptr) {
+    return Build(file, buffer_size, index);
+  }
+  const int64 range_size = (file_size + num_ranges - 1) / num_ranges;
+  std::vector<RangeBlocks> ranges(num_ranges);
+  BlockingCounter counter(num_ranges);
+  for (int i = 0; i < num_ranges; i++) {
+    thread_pool->Schedule([&, i] {
+      const int64 byte_start = i * range_size;
+      const int64 byte_end = i == num_ranges - 1 ? -1 : byte_start + range_size;
+      ScanRange(file, buffer_size, byte_start, byte_end, &ranges[i]);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  index->blocks_.clear();
+  int64 expected = -1;
+  for (RangeBlocks& range : ranges) {
+    // A range whose scan did not start where the previous one stopped found
+    // a sync marker within a block. Its scan may have failed on the content
+    // that follows, so this is checked before its status.
+    if (expected >= 0 && range.scan_start != expected) {
+      LOG(WARNING) << "Avro sync marker found within a block at "
+                   << range.scan_start << ", indexing the file sequentially.";
+      return Build(file, buffer_size, index);
+    }
+    TF_RETURN_IF_ERROR(range.status);
+    expected = range.scan_end;
+    index->blocks_.insert(index->blocks_.end(), range.blocks.begin(),
+                          range.blocks.end());
+  }
+  index->sync_marker_ = ranges[0].sync_marker;
+  return OkStatus();
+}
+
+Status AvroBlockIndex::Load(Env* env, const string& filename,
+                            AvroBlockIndex* index) {
+  string data;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, filename, &data));
+  StringPiece input(data);
+  if (input.size() < kIndexMagicSize + index->sync_marker_.size() ||
+      input.substr(0, kIndexMagicSize) != kIndexMagic) {
+    return errors::DataLoss("Invalid Avro block index: ", filename);
+  }
+  input.remove_prefix(kIndexMagicSize);
+  std::copy(input.begin(), input.begin() + index->sync_marker_.size(),
+            index->sync_marker_.begin());
+  input.remove_prefix(index->sync_marker_.size());
+  uint64 num_blocks = 0;
+  if (!core::GetVarint64(&input, &num_blocks)) {
+    return errors::DataLoss("Truncated Avro block index: ", filename);
+  }
+  index->blocks_.clear();
+  int64 offset = 0;
+  for (uint64 i = 0; i < num_blocks; i++) {
+    uint64 delta = 0, num_records = 0;
+    if (!core::GetVarint64(&input, &delta) ||
+        !core::GetVarint64(&input, &num_records)) {
+      return errors::DataLoss("Truncated Avro block index: ", filename);
+    }
+    offset += static_cast<int64>(delta);
+    index->blocks_.push_back({offset, static_cast<int64>(num_records)});
+  }
+  return OkStatus();
+}
+
+Status AvroBlockIndex::Save(Env* env, const string& filename) const {
+  string data(kIndexMagic, kIndexMagicSize);
+  data.append(reinterpret_cast<const char*>(sync_marker_.data()),
+              sync_marker_.size());
+  core::PutVarint64(&data, blocks_.size());
+  int64 offset = 0;
+  for (const Block& block : blocks_) {
+    core::PutVarint64(&data, static_cast<uint64>(block.offset - offset));
+    core::PutVarint64(&data, static_cast<uint64>(block.num_records));
+    offset = block.offset;
+  }
+  return WriteStringToFile(env, filename, data);
+}
+
+void AvroBlockIndex::BlocksInRange(int64 byte_start, int64 byte_end,
+                                   size_t* first, size_t* last) const {
+  // The sync marker of a block ends at the block offset.
+  const int64 sync_size = static_cast<int64>(sync_marker_.size());
+  auto compare = [](const Block& block, int64 offset) {
+    return block.offset < offset;
+  };
+  *first = std::lower_bound(blocks_.begin(), blocks_.end(),
+                            byte_start + sync_size, compare) -
+           blocks_.begin();
+  *last = blocks_.size();
+  if (byte_end >= 0) {
+    *last = std::lower_bound(blocks_.begin(), blocks_.end(),
+                             byte_end + sync_size, compare) -
+            blocks_.begin();
+  }
+  *last = std::max(*first, *last);
+}
+
+}  // namespace data
+}  // namespace tensorflow
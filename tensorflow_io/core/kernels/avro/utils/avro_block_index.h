@@ -0,0 +1,76 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_INDEX_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_INDEX_H_
+
+#include <vector>
+
+#include "api/DataFile.hh"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data {
+
+// Offsets and record counts of the blocks of an Avro object container file.
+// The index can be saved next to the file, so that a reader of a byte range
+// of a large file finds its first block without reading the prefix.
+class AvroBlockIndex {
+ public:
+  struct Block {
+    // File offset of the block, right after the sync marker of the previous
+    // block.
+    int64 offset;
+    int64 num_records;
+  };
+
+  // Builds the index of `file` by reading the block headers and skipping over
+  // the block content.
+  static Status Build(RandomAccessFile* file, int64 buffer_size,
+                      AvroBlockIndex* index);
+
+  // Builds the index of `file`, of `file_size` bytes, by reading the block
+  // headers of byte ranges of the file in parallel on `thread_pool`. The file
+  // is split into at most `max_ranges` ranges of at least `min_range_bytes`
+  // bytes. Each range is scanned from its first sync marker, the same rule
+  // as BlocksInRange, and the ranges are checked to chain into one another,
+  // so that a sync marker found in the content of a block falls back to a
+  // sequential Build.
+  static Status Build(RandomAccessFile* file, int64 file_size,
+                      int64 buffer_size, int max_ranges,
+                      int64 min_range_bytes, thread::ThreadPool* thread_pool,
+                      AvroBlockIndex* index);
+
+  static Status Load(Env* env, const string& filename, AvroBlockIndex* index);
+  Status Save(Env* env, const string& filename) const;
+
+  // Returns the blocks whose sync marker starts in [byte_start, byte_end) as
+  // the block indices [*first, *last). byte_end < 0 means the end of the
+  // file. Every block of the file belongs to exactly one of a set of ranges
+  // that partition the file.
+  void BlocksInRange(int64 byte_start, int64 byte_end, size_t* first,
+                     size_t* last) const;
+
+  const std::vector<Block>& blocks() const { return blocks_; }
+  const avro::DataFileSync& sync_marker() const { return sync_marker_; }
+
+ private:
+  avro::DataFileSync sync_marker_;
+  std::vector<Block> blocks_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_BLOCK_INDEX_H_
@@ -0,0 +1,152 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_index.h"
+
+#include "api/Compiler.hh"
+#include "api/DataFile.hh"
+#include "api/Generic.hh"
+#include "api/GenericDatum.hh"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+constexpr char kSchema[] =
+    R"({"type": "record", "name": "row", "fields": [)"
+    R"({"name": "id", "type": "long"}, {"name": "payload", "type": "bytes"}]})";
+// Written in a payload, then overwritten with the sync marker of the file.
+constexpr char kPlaceholder[] = "sync marker here";
+
+// Writes `num_blocks` blocks of `records_per_block` records to `filename`.
+// If `false_sync_marker` is set, the middle block holds a large record with
+// the sync marker of the file in its content.
+void WriteAvroFile(const string& filename, int num_blocks,
+                   int records_per_block, bool false_sync_marker) {
+  avro::ValidSchema schema = avro::compileJsonSchemaFromString(kSchema);
+  {
+    avro::DataFileWriter<avro::GenericDatum> writer(filename.c_str(), schema);
+    int64_t id = 0;
+    for (int block = 0; block < num_blocks; block++) {
+      for (int i = 0; i < records_per_block; i++) {
+        std::vector<uint8_t> payload(40, 'a' + block % 26);
+        if (false_sync_marker && block == num_blocks / 2 && i == 0) {
+          // Range scans may start in the block before the false marker.
+          payload.assign(2048, 'x');
+          std::copy(kPlaceholder, kPlaceholder + sizeof(kPlaceholder) - 1,
+                    payload.begin() + 1024);
+        }
+        avro::GenericDatum datum(schema);
+        avro::GenericRecord& record = datum.value<avro::GenericRecord>();
+        record.fieldAt(0) = avro::GenericDatum(id++);
+        record.fieldAt(1) = avro::GenericDatum(payload);
+        writer.write(datum);
+      }
+      writer.flush();
+    }
+    writer.close();
+  }
+  if (!false_sync_marker) {
+    return;
+  }
+  // The file ends with the sync marker of its last block.
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+  const string marker = contents.substr(contents.size() - 16);
+  const size_t pos = contents.find(kPlaceholder);
+  ASSERT_NE(string::npos, pos);
+  contents.replace(pos, marker.size(), marker);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, contents));
+}
+
+void ExpectSameIndex(const AvroBlockIndex& expected,
+                     const AvroBlockIndex& index) {
+  EXPECT_EQ(expected.sync_marker(), index.sync_marker());
+  ASSERT_EQ(expected.blocks().size(), index.blocks().size());
+  for (size_t i = 0; i < expected.blocks().size(); i++) {
+    EXPECT_EQ(expected.blocks()[i].offset, index.blocks()[i].offset);
+    EXPECT_EQ(expected.blocks()[i].num_records,
+              index.blocks()[i].num_records);
+  }
+}
+
+void ExpectParallelIndex(const string& filename, int num_blocks,
+                         int records_per_block) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  uint64 file_size = 0;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(filename, &file_size));
+
+  AvroBlockIndex expected;
+  TF_ASSERT_OK(AvroBlockIndex::Build(file.get(), 256, &expected));
+  ASSERT_EQ(num_blocks, expected.blocks().size());
+  for (const AvroBlockIndex::Block& block : expected.blocks()) {
+    EXPECT_EQ(records_per_block, block.num_records);
+  }
+
+  thread::ThreadPool thread_pool(Env::Default(), "avro_block_index", 4);
+  // From a single range to ranges smaller than a block.
+  for (int64 min_range_bytes : {int64{1} << 20, int64{1024}, int64{100}}) {
+    AvroBlockIndex index;
+    TF_ASSERT_OK(AvroBlockIndex::Build(file.get(), file_size, 256, 64,
+                                       min_range_bytes, &thread_pool,
+                                       &index));
+    ExpectSameIndex(expected, index);
+  }
+}
+}  // namespace
+
+TEST(AvroBlockIndexTest, PARALLEL_BUILD) {
+  const string filename =
+      io::JoinPath(testing::TmpDir(), "avro_block_index_parallel.avro");
+  WriteAvroFile(filename, 30, 4, false);
+  ExpectParallelIndex(filename, 30, 4);
+}
+
+TEST(AvroBlockIndexTest, PARALLEL_BUILD_FALSE_SYNC_MARKER) {
+  const string filename =
+      io::JoinPath(testing::TmpDir(), "avro_block_index_false_sync.avro");
+  WriteAvroFile(filename, 30, 4, true);
+  ExpectParallelIndex(filename, 30, 4);
+}
+
+TEST(AvroBlockIndexTest, SAVE_AND_LOAD) {
+  const string filename =
+      io::JoinPath(testing::TmpDir(), "avro_block_index_save.avro");
+  WriteAvroFile(filename, 10, 3, false);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  AvroBlockIndex expected;
+  TF_ASSERT_OK(AvroBlockIndex::Build(file.get(), 256, &expected));
+  const string index_filename = filename + ".idx";
+  TF_ASSERT_OK(expected.Save(Env::Default(), index_filename));
+  AvroBlockIndex index;
+  TF_ASSERT_OK(AvroBlockIndex::Load(Env::Default(), index_filename, &index));
+  ExpectSameIndex(expected, index);
+
+  // Every block belongs to exactly one range of a partition of the file.
+  size_t first = 0, last = 0, next = 0;
+  for (int64 byte_start = 0; byte_start < 2048; byte_start += 100) {
+    index.BlocksInRange(byte_start, byte_start + 100, &first, &last);
+    EXPECT_EQ(next, first);
+    next = last;
+  }
+  index.BlocksInRange(2048, -1, &first, &last);
+  EXPECT_EQ(next, first);
+  EXPECT_EQ(index.blocks().size(), last);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -20,9 +20,9 @@ namespace data {
 // ------------------------------------------------------------
 // AvroParser
 // ------------------------------------------------------------
-AvroParser::AvroParser(const string& key) : key_(key) {}
+AvroParser::AvroParser(const string& key) : key_(key), slot_(0) {}
 
-const std::vector<AvroParserSharedPtr> AvroParser::GetChildren() const {
+const std::vector<AvroParserSharedPtr>& AvroParser::GetChildren() const {
   return children_;
 }
 
@@ -47,7 +47,8 @@ void AvroParser::ComputeFinalDescendents() {
   }
 }
 
-const std::vector<AvroParserSharedPtr> AvroParser::GetFinalDescendents() const {
+const std::vector<AvroParserSharedPtr>& AvroParser::GetFinalDescendents()
+    const {
   // Return the final descendents
   return final_descendents_;
 }
@@ -111,7 +112,7 @@ string TypeErrorMessage(const std::set<avro::Type>& expected,
 }
 
 BoolValueParser::BoolValueParser(const string& key) : AvroParser(key) {}
-Status BoolValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status BoolValueParser::Parse(ValueStores* values,
                               const avro::GenericDatum& datum,
                               const std::map<string, Tensor>& defaults) const {
   bool value;
@@ -125,7 +126,7 @@ Status BoolValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
         TypeErrorMessage(GetSupportedTypes(), datum.type()));
   }
 
-  (*reinterpret_cast<BoolValueBuffer*>((*values).at(key_).get())).Add(value);
+  (*reinterpret_cast<BoolValueBuffer*>((*values)[slot_].get())).Add(value);
   return OkStatus();
 }
 string BoolValueParser::ToString(size_t level) const {
@@ -133,7 +134,7 @@ string BoolValueParser::ToString(size_t level) const {
 }
 
 LongValueParser::LongValueParser(const string& key) : AvroParser(key) {}
-Status LongValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status LongValueParser::Parse(ValueStores* values,
                               const avro::GenericDatum& datum,
                               const std::map<string, Tensor>& defaults) const {
   long value;
@@ -148,7 +149,7 @@ Status LongValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
   }
 
   // Assume the key exists and cast is possible
-  (*reinterpret_cast<LongValueBuffer*>((*values).at(key_).get())).Add(value);
+  (*reinterpret_cast<LongValueBuffer*>((*values)[slot_].get())).Add(value);
 
   return OkStatus();
 }
@@ -158,7 +159,7 @@ string LongValueParser::ToString(size_t level) const {
 }
 
 IntValueParser::IntValueParser(const string& key) : AvroParser(key) {}
-Status IntValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status IntValueParser::Parse(ValueStores* values,
                              const avro::GenericDatum& datum,
                              const std::map<string, Tensor>& defaults) const {
   int value;
@@ -172,7 +173,7 @@ Status IntValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
         TypeErrorMessage(GetSupportedTypes(), datum.type()));
   }
   // Assume the key exists and cast is possible
-  (*reinterpret_cast<IntValueBuffer*>((*values).at(key_).get())).Add(value);
+  (*reinterpret_cast<IntValueBuffer*>((*values)[slot_].get())).Add(value);
 
   return OkStatus();
 }
@@ -183,8 +184,7 @@ string IntValueParser::ToString(size_t level) const {
 
 DoubleValueParser::DoubleValueParser(const string& key) : AvroParser(key) {}
 Status DoubleValueParser::Parse(
-    std::map<string, ValueStoreUniquePtr>* values,
-    const avro::GenericDatum& datum,
+    ValueStores* values, const avro::GenericDatum& datum,
     const std::map<string, Tensor>& defaults) const {
   double value;
   if (datum.type() == avro::AVRO_DOUBLE) {
@@ -197,7 +197,7 @@ Status DoubleValueParser::Parse(
         TypeErrorMessage(GetSupportedTypes(), datum.type()));
   }
   // Assume the key exists and cast is possible
-  (*reinterpret_cast<DoubleValueBuffer*>((*values)[key_].get())).Add(value);
+  (*reinterpret_cast<DoubleValueBuffer*>((*values)[slot_].get())).Add(value);
 
   return OkStatus();
 }
@@ -207,7 +207,7 @@ string DoubleValueParser::ToString(size_t level) const {
 }
 
 FloatValueParser::FloatValueParser(const string& key) : AvroParser(key) {}
-Status FloatValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status FloatValueParser::Parse(ValueStores* values,
                                const avro::GenericDatum& datum,
                                const std::map<string, Tensor>& defaults) const {
   float value;
@@ -221,7 +221,7 @@ Status FloatValueParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
         TypeErrorMessage(GetSupportedTypes(), datum.type()));
   }
   // Assume the key exists and cast is possible
-  (*reinterpret_cast<FloatValueBuffer*>((*values)[key_].get())).Add(value);
+  (*reinterpret_cast<FloatValueBuffer*>((*values)[slot_].get())).Add(value);
 
   return OkStatus();
 }
@@ -234,42 +234,38 @@ StringBytesEnumFixedValueParser::StringBytesEnumFixedValueParser(
     const string& key)
     : AvroParser(key) {}
 Status StringBytesEnumFixedValueParser::Parse(
-    std::map<string, ValueStoreUniquePtr>* values,
-    const avro::GenericDatum& datum,
+    ValueStores* values, const avro::GenericDatum& datum,
     const std::map<string, Tensor>& defaults) const {
-  string value;
+  // Assume the key exists and cast is possible
+  // The bytes are appended to the buffer directly, without a temporary string
+  StringValueBuffer& buffer =
+      *reinterpret_cast<StringValueBuffer*>((*values)[slot_].get());
   switch (datum.type()) {
-    case avro::AVRO_STRING:
-      value = datum.value<string>();
-      break;
+    case avro::AVRO_STRING: {
+      const string& v = datum.value<string>();
+      buffer.AddBytes(v.data(), v.size());
+    } break;
     case avro::AVRO_BYTES: {
       const std::vector<uint8_t>& v = datum.value<std::vector<uint8_t>>();
-      if (v.size() > 0) {
-        value.resize(v.size());
-        memcpy(&value[0], &v[0], v.size());
-      }
+      buffer.AddBytes(reinterpret_cast<const char*>(v.data()), v.size());
+    } break;
+    case avro::AVRO_ENUM: {
+      const string& v = datum.value<avro::GenericEnum>().symbol();
+      buffer.AddBytes(v.data(), v.size());
     } break;
-    case avro::AVRO_ENUM:
-      value = datum.value<avro::GenericEnum>().symbol();
-      break;
     case avro::AVRO_FIXED: {
       const std::vector<uint8_t>& v = datum.value<avro::GenericFixed>().value();
-      if (v.size() > 0) {
-        value.resize(v.size());
-        memcpy(&value[0], &v[0], v.size());
-      }
+      buffer.AddBytes(reinterpret_cast<const char*>(v.data()), v.size());
     } break;
-    case avro::AVRO_NULL:
+    case avro::AVRO_NULL: {
       TF_RETURN_IF_ERROR(CheckValidDefault(key_, defaults, DT_STRING));
-      value = defaults.at(key_).flat<tstring>()(0);
-      break;
+      const tstring& v = defaults.at(key_).flat<tstring>()(0);
+      buffer.AddBytes(v.data(), v.size());
+    } break;
     default:
       return errors::InvalidArgument(
           TypeErrorMessage(GetSupportedTypes(), datum.type()));
   }
-  // Assume the key exists and cast is possible
-  (*reinterpret_cast<StringValueBuffer*>((*values)[key_].get()))
-      .AddByRef(value);
 
   return OkStatus();
 }
@@ -281,7 +277,7 @@ string StringBytesEnumFixedValueParser::ToString(size_t level) const {
 // Concrete implementations of value parsers
 // ------------------------------------------------------------
 ArrayAllParser::ArrayAllParser() : AvroParser("") {}
-Status ArrayAllParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status ArrayAllParser::Parse(ValueStores* values,
                              const avro::GenericDatum& datum,
                              const std::map<string, Tensor>& defaults) const {
   if (datum.type() != avro::AVRO_ARRAY) {
@@ -298,8 +294,8 @@ Status ArrayAllParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
 
   // Add a begin mark to all value buffers under this array
   for (const AvroParserSharedPtr& value_parser : final_descendents) {
-    // Assumes the key exists in the map
-    (*(*values)[(*value_parser).GetKey()]).BeginMark();
+    // Assumes a value store exists for the slot
+    (*(*values)[(*value_parser).GetSlot()]).BeginMark();
   }
 
   // Resolve all the values from the array
@@ -312,8 +308,8 @@ Status ArrayAllParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
 
   // Add a finish mark to all value buffers under this array
   for (const AvroParserSharedPtr& value_parser : final_descendents) {
-    // Assumes the key exists in the map
-    (*(*values)[(*value_parser).GetKey()]).FinishMark();
+    // Assumes a value store exists for the slot
+    (*(*values)[(*value_parser).GetSlot()]).FinishMark();
   }
 
   return OkStatus();
@@ -327,7 +323,7 @@ string ArrayAllParser::ToString(size_t level) const {
 
 ArrayIndexParser::ArrayIndexParser(size_t index)
     : AvroParser(""), index_(index) {}
-Status ArrayIndexParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status ArrayIndexParser::Parse(ValueStores* values,
                                const avro::GenericDatum& datum,
                                const std::map<string, Tensor>& defaults) const {
   if (datum.type() != avro::AVRO_ARRAY) {
@@ -368,7 +364,17 @@ string ArrayIndexParser::ToString(size_t level) const {
 
 ArrayFilterParser::ArrayFilterParser(const tstring& lhs, const tstring& rhs,
                                      ArrayFilterType type)
-    : AvroParser(""), lhs_(lhs), rhs_(rhs), type_(type) {}
+    : AvroParser(""),
+      lhs_(lhs),
+      rhs_(rhs),
+      type_(type),
+      lhs_slot_(0),
+      rhs_slot_(0) {}
+
+void ArrayFilterParser::SetSlots(size_t lhs_slot, size_t rhs_slot) {
+  lhs_slot_ = lhs_slot;
+  rhs_slot_ = rhs_slot;
+}
 
 ArrayFilterParser::ArrayFilterType ArrayFilterParser::ToArrayFilterType(
     bool lhs_is_constant, bool rhs_is_constant) {
@@ -384,8 +390,7 @@ ArrayFilterParser::ArrayFilterType ArrayFilterParser::ToArrayFilterType(
 }
 
 Status ArrayFilterParser::Parse(
-    std::map<string, ValueStoreUniquePtr>* values,
-    const avro::GenericDatum& datum,
+    ValueStores* values, const avro::GenericDatum& datum,
     const std::map<string, Tensor>& defaults) const {
   if (datum.type() != avro::AVRO_ARRAY) {
     return errors::InvalidArgument(
@@ -397,8 +402,8 @@ Status ArrayFilterParser::Parse(
 
   // Add a begin mark to all value buffers under this array
   for (const AvroParserSharedPtr& value_parser : final_descendents) {
-    // Assumes the key exists in the map
-    (*(*values)[(*value_parser).GetKey()]).BeginMark();
+    // Assumes a value store exists for the slot
+    (*(*values)[(*value_parser).GetSlot()]).BeginMark();
   }
 
   // Check for valid index
@@ -414,15 +419,15 @@ Status ArrayFilterParser::Parse(
     bool add_value = false;
 
     if (type_ == kRhsIsConstant) {
-      add_value =
-          (*(*values).at(lhs_)).ValueMatchesAtReverseIndex(rhs_, reverse_index);
+      add_value = (*(*values)[lhs_slot_])
+                      .ValueMatchesAtReverseIndex(rhs_, reverse_index);
     } else if (type_ == kLhsIsConstant) {
-      add_value =
-          (*(*values).at(rhs_)).ValueMatchesAtReverseIndex(lhs_, reverse_index);
+      add_value = (*(*values)[rhs_slot_])
+                      .ValueMatchesAtReverseIndex(lhs_, reverse_index);
     } else {
-      add_value =
-          (*(*values).at(lhs_))
-              .ValuesMatchAtReverseIndex(*(*values).at(rhs_), reverse_index);
+      add_value = (*(*values)[lhs_slot_])
+                      .ValuesMatchAtReverseIndex(*(*values)[rhs_slot_],
+                                                 reverse_index);
     }
 
     if (add_value) {
@@ -436,8 +441,8 @@ Status ArrayFilterParser::Parse(
 
   // Add a finish mark to all value buffers under this array
   for (const AvroParserSharedPtr& value_parser : final_descendents) {
-    // Assumes the key exists in the map
-    (*(*values)[(*value_parser).GetKey()]).FinishMark();
+    // Assumes a value store exists for the slot
+    (*(*values)[(*value_parser).GetSlot()]).FinishMark();
   }
 
   return OkStatus();
@@ -451,7 +456,7 @@ string ArrayFilterParser::ToString(size_t level) const {
 }
 
 MapKeyParser::MapKeyParser(const string& key) : AvroParser(""), key_(key) {}
-Status MapKeyParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status MapKeyParser::Parse(ValueStores* values,
                            const avro::GenericDatum& datum,
                            const std::map<string, Tensor>& defaults) const {
   if (datum.type() != avro::AVRO_MAP) {
@@ -491,7 +496,7 @@ string MapKeyParser::ToString(size_t level) const {
 }
 
 RecordParser::RecordParser(const string& name) : AvroParser(""), name_(name) {}
-Status RecordParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status RecordParser::Parse(ValueStores* values,
                            const avro::GenericDatum& datum,
                            const std::map<string, Tensor>& defaults) const {
   if (datum.type() != avro::AVRO_RECORD) {
@@ -528,7 +533,7 @@ string RecordParser::ToString(size_t level) const {
 
 UnionParser::UnionParser(const string& type_name)
     : AvroParser(""), type_name_(type_name) {}
-Status UnionParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status UnionParser::Parse(ValueStores* values,
                           const avro::GenericDatum& datum,
                           const std::map<string, Tensor>& defaults) const {
   // Note, in this case we don't know the type
@@ -565,7 +570,7 @@ string UnionParser::ToString(size_t level) const {
 }
 
 RootParser::RootParser() : AvroParser("") {}
-Status RootParser::Parse(std::map<string, ValueStoreUniquePtr>* values,
+Status RootParser::Parse(ValueStores* values,
                          const avro::GenericDatum& datum,
                          const std::map<string, Tensor>& defaults) const {
   const std::vector<AvroParserSharedPtr>& children(GetChildren());
@@ -30,6 +30,10 @@ class AvroParser;
 using AvroParserUniquePtr = std::unique_ptr<AvroParser>;
 using AvroParserSharedPtr = std::shared_ptr<AvroParser>;
 
+// Value stores indexed by the slot that the parser tree assigned to each
+// final value parser
+using ValueStores = std::vector<ValueStoreUniquePtr>;
+
 class AvroParser {
  public:
   // Constructor
@@ -44,8 +48,8 @@ class AvroParser {
   void ComputeFinalDescendents();
 
   // Parse will traverse the sub-tree of this value and fill all values into
-  // `parsed_values` may also read from parsed values if filtering
-  virtual Status Parse(std::map<string, ValueStoreUniquePtr>* parsed_values,
+  // the slots of `parsed_values` may also read from parsed values if filtering
+  virtual Status Parse(ValueStores* parsed_values,
                        const avro::GenericDatum& datum,
                        const std::map<string, Tensor>& defaults) const = 0;
 
@@ -55,7 +59,7 @@ class AvroParser {
   }
 
   // public for testing
-  const std::vector<AvroParserSharedPtr> GetChildren() const;
+  const std::vector<AvroParserSharedPtr>& GetChildren() const;
 
   // Convert the avro parser into a human readable string representation
   virtual string ToString(size_t level = 0) const = 0;
@@ -63,12 +67,19 @@ class AvroParser {
   // Get the key for this avro parser -- this key can be used to map to values
   inline const string GetKey() const { return key_; }
 
+  // Get the slot of the value store that this avro parser fills -- only
+  // assigned for final value parsers
+  inline size_t GetSlot() const { return slot_; }
+
+  // Set the slot of the value store that this avro parser fills
+  inline void SetSlot(size_t slot) { slot_ = slot; }
+
   // Get the supported avro types for this parser
   virtual std::set<avro::Type> GetSupportedTypes() const = 0;
 
  protected:
   // Get the final descendents for this avro parser
-  const std::vector<AvroParserSharedPtr> GetFinalDescendents() const;
+  const std::vector<AvroParserSharedPtr>& GetFinalDescendents() const;
 
   // Convert all children into a string representation
   string ChildrenToString(size_t level) const;
@@ -79,6 +90,9 @@ class AvroParser {
   // The key for this avro parser
   string key_;
 
+  // The slot of the value store for this avro parser
+  size_t slot_;
+
  private:
   // Is this a terminal parser node
   inline bool IsTerminal() const { return children_.size() == 0; }
@@ -96,8 +110,7 @@ class AvroParser {
 class BoolValueParser : public AvroParser {
  public:
   BoolValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -109,8 +122,7 @@ class BoolValueParser : public AvroParser {
 class LongValueParser : public AvroParser {
  public:
   LongValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -122,8 +134,7 @@ class LongValueParser : public AvroParser {
 class IntValueParser : public AvroParser {
  public:
   IntValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -135,8 +146,7 @@ class IntValueParser : public AvroParser {
 class DoubleValueParser : public AvroParser {
  public:
   DoubleValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -148,8 +158,7 @@ class DoubleValueParser : public AvroParser {
 class FloatValueParser : public AvroParser {
  public:
   FloatValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -163,8 +172,7 @@ class FloatValueParser : public AvroParser {
 class StringBytesEnumFixedValueParser : public AvroParser {
  public:
   StringBytesEnumFixedValueParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -177,8 +185,7 @@ class StringBytesEnumFixedValueParser : public AvroParser {
 class ArrayAllParser : public AvroParser {
  public:
   ArrayAllParser();
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -190,8 +197,7 @@ class ArrayAllParser : public AvroParser {
 class ArrayIndexParser : public AvroParser {
  public:
   ArrayIndexParser(size_t index);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -208,12 +214,14 @@ class ArrayFilterParser : public AvroParser {
   enum ArrayFilterType { kLhsIsConstant, kRhsIsConstant, kNoConstant };
   ArrayFilterParser(const tstring& lhs, const tstring& rhs,
                     ArrayFilterType type);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   static ArrayFilterType ToArrayFilterType(bool lhs_is_constant,
                                            bool rhs_is_constant);
+  // Set the slots of the value stores that hold the lhs and rhs values, the
+  // slot of a constant side is ignored
+  void SetSlots(size_t lhs_slot, size_t rhs_slot);
   inline std::set<avro::Type> GetSupportedTypes() const override {
     return {avro::AVRO_ARRAY};
   }
@@ -222,14 +230,15 @@ class ArrayFilterParser : public AvroParser {
   tstring lhs_;
   tstring rhs_;
   ArrayFilterType type_;
+  size_t lhs_slot_;
+  size_t rhs_slot_;
 };
 
 // Parser for a map -- parses one key
 class MapKeyParser : public AvroParser {
  public:
   MapKeyParser(const string& key);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -248,13 +257,14 @@ class RecordParser : public AvroParser {
   // check that an attribute with name exists
   // get the the attribute for the name and return it in the vector as single
   // element
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
     return {avro::AVRO_RECORD};
   }
+  // Get the name of the attribute that this parser reads
+  inline const string& GetName() const { return name_; }
 
  private:
   string name_;
@@ -264,8 +274,7 @@ class RecordParser : public AvroParser {
 class UnionParser : public AvroParser {
  public:
   UnionParser(const string& type_name);
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   inline std::set<avro::Type> GetSupportedTypes() const override {
@@ -280,8 +289,7 @@ class UnionParser : public AvroParser {
 class RootParser : public AvroParser {
  public:
   RootParser();
-  Status Parse(std::map<string, ValueStoreUniquePtr>* values,
-               const avro::GenericDatum& datum,
+  Status Parse(ValueStores* values, const avro::GenericDatum& datum,
                const std::map<string, Tensor>& defaults) const override;
   virtual string ToString(size_t level = 0) const;
   // Note, abuse of unknown symbol
@@ -26,7 +26,7 @@ namespace data {
 /* static */ constexpr const char* const AvroParserTree::kArrayAllElements;
 
 Status AvroParserTree::ParseValues(
-    std::map<string, ValueStoreUniquePtr>* key_to_value,
+    ValueStores* values,
     const std::function<bool(avro::GenericDatum&)> read_value,
     const avro::ValidSchema& reader_schema, uint64 values_to_parse,
     uint64* values_parsed, const std::map<string, Tensor>& defaults) const {
@@ -45,13 +45,13 @@ Status AvroParserTree::ParseValues(
   }
 
   // new assignment of all buffers
-  TF_RETURN_IF_ERROR(InitializeValueBuffers(key_to_value));
+  TF_RETURN_IF_ERROR(InitializeValueBuffers(values));
 
   // add being marks to all buffers for batch
-  TF_RETURN_IF_ERROR(AddBeginMarks(key_to_value));
+  TF_RETURN_IF_ERROR(AddBeginMarks(values));
 
   // Parse first value
-  TF_RETURN_IF_ERROR((*root_).Parse(key_to_value, datum, defaults));
+  TF_RETURN_IF_ERROR((*root_).Parse(values, datum, defaults));
   uint64 values_read = 1;
   // Increment before compare because we already read one value
   while (values_read < values_to_parse) {
@@ -61,7 +61,7 @@ Status AvroParserTree::ParseValues(
       return errors::InvalidArgument("Error reading value: ", e.what());
     }
     if (has_value) {
-      TF_RETURN_IF_ERROR((*root_).Parse(key_to_value, datum, defaults));
+      TF_RETURN_IF_ERROR((*root_).Parse(values, datum, defaults));
       values_read++;
     } else {
       break;
@@ -71,13 +71,13 @@ Status AvroParserTree::ParseValues(
   *values_parsed = values_read;
 
   // add end marks to all buffers for batch
-  TF_RETURN_IF_ERROR(AddFinishMarks(key_to_value));
+  TF_RETURN_IF_ERROR(AddFinishMarks(values));
 
   return OkStatus();
 }
 
 Status AvroParserTree::ParseValues(
-    std::map<string, ValueStoreUniquePtr>* key_to_value,
+    ValueStores* values,
     const std::function<bool(avro::GenericDatum&)> read_value,
     const avro::ValidSchema& reader_schema,
     const std::map<string, Tensor>& defaults) const {
@@ -85,10 +85,10 @@ Status AvroParserTree::ParseValues(
   using ms = std::chrono::duration<double, std::milli>;
 
   // new assignment of all buffers
-  TF_RETURN_IF_ERROR(InitializeValueBuffers(key_to_value));
+  TF_RETURN_IF_ERROR(InitializeValueBuffers(values));
 
   // add being marks to all buffers for batch
-  TF_RETURN_IF_ERROR(AddBeginMarks(key_to_value));
+  TF_RETURN_IF_ERROR(AddBeginMarks(values));
 
   avro::GenericDatum datum(reader_schema);
 
@@ -101,7 +101,7 @@ Status AvroParserTree::ParseValues(
       break;
     }
     const auto after_read = clock::now();
-    TF_RETURN_IF_ERROR((*root_).Parse(key_to_value, datum, defaults));
+    TF_RETURN_IF_ERROR((*root_).Parse(values, datum, defaults));
     const auto after_parse = clock::now();
     parse_duration += after_parse - after_read;
     read_duration += after_read - before_read;
@@ -112,11 +112,51 @@ Status AvroParserTree::ParseValues(
   VLOG(5) << "PARSER_TIMING: Avro Parse times " << parse_duration.count()
           << " ms ";
   // add end marks to all buffers for batch
-  TF_RETURN_IF_ERROR(AddFinishMarks(key_to_value));
+  TF_RETURN_IF_ERROR(AddFinishMarks(values));
+
+  return OkStatus();
+}
+
+Status AvroParserTree::ParseValues(
+    std::map<string, ValueStoreUniquePtr>* key_to_value,
+    const std::function<bool(avro::GenericDatum&)> read_value,
+    const avro::ValidSchema& reader_schema, uint64 values_to_parse,
+    uint64* values_parsed, const std::map<string, Tensor>& defaults) const {
+  ValueStores values;
+  TF_RETURN_IF_ERROR(ParseValues(&values, read_value, reader_schema,
+                                 values_to_parse, values_parsed, defaults));
+  MoveToKeys(&values, key_to_value);
+  return OkStatus();
+}
+
+Status AvroParserTree::ParseValues(
+    std::map<string, ValueStoreUniquePtr>* key_to_value,
+    const std::function<bool(avro::GenericDatum&)> read_value,
+    const avro::ValidSchema& reader_schema,
+    const std::map<string, Tensor>& defaults) const {
+  ValueStores values;
+  TF_RETURN_IF_ERROR(ParseValues(&values, read_value, reader_schema, defaults));
+  MoveToKeys(&values, key_to_value);
+  return OkStatus();
+}
 
+Status AvroParserTree::GetSlot(const string& key, size_t* slot) const {
+  auto key_and_slot = key_to_slot_.find(key);
+  if (key_and_slot == key_to_slot_.end()) {
+    return errors::NotFound("Unable to find key '", key, "'!");
+  }
+  *slot = (*key_and_slot).second;
   return OkStatus();
 }
 
+void AvroParserTree::MoveToKeys(
+    ValueStores* values,
+    std::map<string, ValueStoreUniquePtr>* key_to_value) const {
+  for (size_t slot = 0; slot < (*values).size(); ++slot) {
+    (*key_to_value)[keys_and_types_[slot].first] = std::move((*values)[slot]);
+  }
+}
+
 Status AvroParserTree::Build(AvroParserTree* parser_tree,
                              const std::vector<KeyWithType>& keys_and_types) {
   // Check unique keys
@@ -135,17 +175,19 @@ Status AvroParserTree::Build(AvroParserTree* parser_tree,
   std::vector<KeyWithType> ordered_keys_and_types =
       OrderAndResolveKeyTypes(keys_and_types);
 
-  // Parse keys into prefixes and build map from key to type
+  // Parse keys into prefixes and build map from key to slot
+  // The slot of a key is its position in the order
   std::vector<std::vector<string> > prefixes;
-  for (const KeyWithType& key_and_type : ordered_keys_and_types) {
+  for (size_t slot = 0; slot < ordered_keys_and_types.size(); ++slot) {
+    const KeyWithType& key_and_type = ordered_keys_and_types[slot];
     VLOG(7) << "Add key prefix: " << key_and_type.first;
 
     // Built prefixes
     std::vector<string> key_prefixes = GetParts(key_and_type.first);
     prefixes.push_back(key_prefixes);
 
-    // Built map from key to type
-    (*parser_tree).key_to_type_[key_and_type.first] = key_and_type.second;
+    // Built map from key to slot
+    (*parser_tree).key_to_slot_[key_and_type.first] = slot;
   }
 
   VLOG(7) << "Build prefix tree";
@@ -154,6 +196,9 @@ Status AvroParserTree::Build(AvroParserTree* parser_tree,
 
   VLOG(7) << "Prefix tree\n" << prefix_tree.ToString();
 
+  CompactPrefixTree compact_tree;
+  CompactPrefixTree::Build(&compact_tree, prefix_tree, kSeparator);
+
   (*parser_tree).keys_and_types_ = ordered_keys_and_types;
 
   // Use the expected type to decide which value parser node to add
@@ -161,8 +206,8 @@ Status AvroParserTree::Build(AvroParserTree* parser_tree,
 
   // Use the prefix tree to build the parser tree
   TF_RETURN_IF_ERROR((*parser_tree)
-                         .Build((*parser_tree).root_.get(),
-                                (*prefix_tree.GetRoot()).GetChildren()));
+                         .Build((*parser_tree).root_.get(), compact_tree,
+                                CompactPrefixTree::kRoot));
 
   // Note, we can initialize only after we built the entire parser tree
   // Why? Because this will determine the final descendents for each
@@ -174,37 +219,41 @@ Status AvroParserTree::Build(AvroParserTree* parser_tree,
   return OkStatus();
 }
 
-Status AvroParserTree::Build(
-    AvroParser* parent, const std::vector<PrefixTreeNodeSharedPtr>& children) {
-  for (PrefixTreeNodeSharedPtr child : children) {
-    VLOG(5) << "Creating parser for prefix " << (*child).GetPrefix();
+Status AvroParserTree::Build(AvroParser* parent,
+                             const CompactPrefixTree& prefix_tree,
+                             size_t parent_node) {
+  const CompactPrefixTree::Node& node = prefix_tree.GetNode(parent_node);
+  for (size_t child = node.first_child;
+       child < node.first_child + node.num_children; ++child) {
+    const CompactPrefixTree::Node& child_node = prefix_tree.GetNode(child);
+    VLOG(5) << "Creating parser for prefix " << child_node.prefix;
 
     AvroParserUniquePtr avro_parser(nullptr);
 
     // Create a parser and add it to the parent
-    const string& user_name(RemoveAddedDots((*child).GetName(kSeparator)));
+    const string& user_name(RemoveAddedDots(child_node.name));
 
     TF_RETURN_IF_ERROR(
-        CreateValueParser(avro_parser, (*child).GetPrefix(), user_name));
+        CreateValueParser(avro_parser, child_node.prefix, user_name));
 
     // Build a parser for the terminal node and attach it
-    if ((*child).IsTerminal()) {
+    if (prefix_tree.IsTerminal(child)) {
       AvroParserUniquePtr avro_value_parser(nullptr);
 
-      auto key_and_type = key_to_type_.find(user_name);
-      if (key_and_type == key_to_type_.end()) {
-        return errors::NotFound("Unable to find key '", user_name, "'!");
-      }
-      VLOG(5) << "Create value parser for " << user_name;
+      size_t slot;
+      TF_RETURN_IF_ERROR(GetSlot(user_name, &slot));
+      VLOG(5) << "Create value parser for " << user_name << " in slot "
+              << slot;
 
-      TF_RETURN_IF_ERROR(CreateFinalValueParser(avro_value_parser, user_name,
-                                                (*key_and_type).second));
+      TF_RETURN_IF_ERROR(CreateFinalValueParser(
+          avro_value_parser, user_name, keys_and_types_[slot].second));
+      (*avro_value_parser).SetSlot(slot);
       (*avro_parser).AddChild(std::move(avro_value_parser));
 
       // Build a parser for all children of this non-terminal node
     } else {
-      VLOG(5) << "Create parser for " << (*child).GetName(kSeparator);
-      TF_RETURN_IF_ERROR(Build(avro_parser.get(), (*child).GetChildren()));
+      VLOG(5) << "Create parser for " << child_node.name;
+      TF_RETURN_IF_ERROR(Build(avro_parser.get(), prefix_tree, child));
     }
 
     (*parent).AddChild(std::move(avro_parser));
@@ -358,8 +407,20 @@ Status AvroParserTree::CreateValueParser(AvroParserUniquePtr& avro_parser,
     ArrayFilterParser::ArrayFilterType array_filter_type =
         ArrayFilterParser::ToArrayFilterType(lhs_is_constant, rhs_is_constant);
 
-    avro_parser.reset(new ArrayFilterParser(
-        lhs_resolved_name, rhs_resolved_name, array_filter_type));
+    // Resolve the slots of the value stores the filter compares
+    size_t lhs_slot = 0;
+    size_t rhs_slot = 0;
+    if (!lhs_is_constant) {
+      TF_RETURN_IF_ERROR(GetSlot(lhs_resolved_name, &lhs_slot));
+    }
+    if (!rhs_is_constant) {
+      TF_RETURN_IF_ERROR(GetSlot(rhs_resolved_name, &rhs_slot));
+    }
+
+    ArrayFilterParser* filter_parser = new ArrayFilterParser(
+        lhs_resolved_name, rhs_resolved_name, array_filter_type);
+    (*filter_parser).SetSlots(lhs_slot, rhs_slot);
+    avro_parser.reset(filter_parser);
 
     return OkStatus();
   }
@@ -458,61 +519,53 @@ inline bool AvroParserTree::IsBranch(const string& infix) {
                         ":boolean|:int|:long|:float|:double|:bytes|:string");
 }
 
-Status AvroParserTree::AddBeginMarks(
-    std::map<string, ValueStoreUniquePtr>* key_to_value) {
-  for (auto const& key_value : *key_to_value) {
-    (*key_value.second).BeginMark();
+Status AvroParserTree::AddBeginMarks(ValueStores* values) {
+  for (auto const& value : *values) {
+    (*value).BeginMark();
   }
   return OkStatus();
 }
 
-Status AvroParserTree::AddFinishMarks(
-    std::map<string, ValueStoreUniquePtr>* key_to_value) {
-  for (auto const& key_value : *key_to_value) {
-    (*key_value.second).FinishMark();
+Status AvroParserTree::AddFinishMarks(ValueStores* values) {
+  for (auto const& value : *values) {
+    (*value).FinishMark();
   }
   return OkStatus();
 }
 
-Status AvroParserTree::InitializeValueBuffers(
-    std::map<string, ValueStoreUniquePtr>* key_to_value) const {
+Status AvroParserTree::InitializeValueBuffers(ValueStores* values) const {
   // For all keys -- that hold the user defined name -- and their data types add
-  // a buffer
-  for (const auto& key_and_type : keys_and_types_) {
-    const string& key = key_and_type.first;
-    DataType data_type = key_and_type.second;
+  // a buffer in the slot of the key. Buffers left from a previous parse with
+  // this tree are reset instead, which keeps their memory.
+  (*values).resize(keys_and_types_.size());
+  for (size_t slot = 0; slot < keys_and_types_.size(); ++slot) {
+    const string& key = keys_and_types_[slot].first;
+    DataType data_type = keys_and_types_[slot].second;
+
+    if ((*values)[slot] != nullptr) {
+      (*(*values)[slot]).Reset();
+      continue;
+    }
 
     switch (data_type) {
       // Fill in the ValueBuffer
       case DT_BOOL:
-        (*key_to_value)
-            .insert(std::make_pair(
-                key, std::unique_ptr<BoolValueBuffer>(new BoolValueBuffer())));
+        (*values)[slot].reset(new BoolValueBuffer());
         break;
       case DT_INT32:
-        (*key_to_value)
-            .insert(std::make_pair(
-                key, std::unique_ptr<IntValueBuffer>(new IntValueBuffer())));
+        (*values)[slot].reset(new IntValueBuffer());
         break;
       case DT_INT64:
-        (*key_to_value)
-            .insert(std::make_pair(
-                key, std::unique_ptr<LongValueBuffer>(new LongValueBuffer())));
+        (*values)[slot].reset(new LongValueBuffer());
         break;
       case DT_FLOAT:
-        (*key_to_value)
-            .insert(std::make_pair(key, std::unique_ptr<FloatValueBuffer>(
-                                            new FloatValueBuffer())));
+        (*values)[slot].reset(new FloatValueBuffer());
         break;
       case DT_DOUBLE:
-        (*key_to_value)
-            .insert(std::make_pair(key, std::unique_ptr<DoubleValueBuffer>(
-                                            new DoubleValueBuffer())));
+        (*values)[slot].reset(new DoubleValueBuffer());
         break;
       case DT_STRING:
-        (*key_to_value)
-            .insert(std::make_pair(key, std::unique_ptr<StringValueBuffer>(
-                                            new StringValueBuffer())));
+        (*values)[slot].reset(new StringValueBuffer());
         break;
       default:
         return Status(errors::Unimplemented(
@@ -63,6 +63,20 @@ class AvroParserTree {
   static Status Build(AvroParserTree* parser_tree,
                       const std::vector<KeyWithType>& keys_and_types);
 
+  // Parses all values in a batch into the value stores indexed by the slots
+  // that Build assigned to the user-defined keys. Value stores of a previous
+  // batch parsed with this tree are reset and reused.
+  Status ParseValues(ValueStores* values,
+                     const std::function<bool(avro::GenericDatum&)> read_value,
+                     const avro::ValidSchema& reader_schema,
+                     uint64 values_to_parse, uint64* values_parsed,
+                     const std::map<string, Tensor>& defaults) const;
+
+  Status ParseValues(ValueStores* values,
+                     const std::function<bool(avro::GenericDatum&)> read_value,
+                     const avro::ValidSchema& reader_schema,
+                     const std::map<string, Tensor>& defaults) const;
+
   // Parses all values in a batch into the map keyed by the user-defined keys
   // that map to value stores
   Status ParseValues(std::map<string, ValueStoreUniquePtr>* key_to_value,
@@ -76,6 +90,12 @@ class AvroParserTree {
                      const avro::ValidSchema& reader_schema,
                      const std::map<string, Tensor>& defaults) const;
 
+  // Returns the slot of the value store for the user-defined key
+  Status GetSlot(const string& key, size_t* slot) const;
+
+  // Returns the number of value stores, one for each key
+  inline size_t NumSlots() const { return keys_and_types_.size(); }
+
   // Returns the root of the parser tree -- exposed for testing
   inline AvroParserSharedPtr getRoot() const { return root_; }
 
@@ -91,10 +111,10 @@ class AvroParserTree {
   // The constant for all element keys
   static constexpr const char* const kArrayAllElements = "[*]";
 
-  // Build the avro parser tree for the parent for the given children from a
-  // prefix tree
-  Status Build(AvroParser* parent,
-               const std::vector<PrefixTreeNodeSharedPtr>& children);
+  // Build the avro parser tree for the parent from the children of the node
+  // in the prefix tree
+  Status Build(AvroParser* parent, const CompactPrefixTree& prefix_tree,
+               size_t parent_node);
 
   // Initialize will compute the final descendents for each node, called after
   // build
@@ -112,9 +132,12 @@ class AvroParserTree {
                                 const string& user_name,
                                 DataType data_type) const;
 
-  // Initializes value buffers for all keys
-  Status InitializeValueBuffers(
-      std::map<string, ValueStoreUniquePtr>* key_to_value) const;
+  // Initializes value buffers for all keys, resets the ones already there
+  Status InitializeValueBuffers(ValueStores* values) const;
+
+  // Moves the value stores into the map keyed by the user-defined keys
+  void MoveToKeys(ValueStores* values,
+                  std::map<string, ValueStoreUniquePtr>* key_to_value) const;
 
   // Orders and resolves key types
   // The ordering is necessary to process any depends for filters first before
@@ -130,14 +153,12 @@ class AvroParserTree {
   // Add a begin mark to all value stores
   // This is used to mark the outer-most dimension as begun -- before any
   // element is added
-  static Status AddBeginMarks(
-      std::map<string, ValueStoreUniquePtr>* key_to_value);
+  static Status AddBeginMarks(ValueStores* values);
 
   // Add a finish mark to all value stores
   // This is used to mark the outer-most dimension as finished -- before any
   // element is added
-  static Status AddFinishMarks(
-      std::map<string, ValueStoreUniquePtr>* key_to_value);
+  static Status AddFinishMarks(ValueStores* values);
 
   // Resolve a filter name
   // Handles the inplace notation where we need to add all parent names
@@ -191,11 +212,12 @@ class AvroParserTree {
 
   // used to preserve the order in the parse value method, InitValueBuffers
   // before each parse call
+  // The position of a key in this vector is the slot of its value store
   std::vector<std::pair<string, DataType> > keys_and_types_;
 
-  // This map is a helper for fast access of the data type that corresponds to
-  // the key
-  std::map<string, DataType> key_to_type_;
+  // This map is a helper for fast access of the slot that corresponds to the
+  // key
+  std::map<string, size_t> key_to_slot_;
 };
 
 }  // namespace data
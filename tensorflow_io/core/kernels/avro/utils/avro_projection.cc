@@ -0,0 +1,492 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_projection.h"
+
+#include <string>
+#include <utility>
+
+#include "api/NodeImpl.hh"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace data {
+
+struct AvroProjection::Node {
+  enum Kind { kAll, kRecord, kArray, kMap, kUnion };
+  enum StepKind { kReadField, kSkipField, kSkipBytes };
+
+  // One step per record field, consecutive fields of fixed size that are
+  // skipped share one step
+  struct Step {
+    StepKind kind;
+    size_t field;
+    size_t bytes;
+    avro::NodePtr schema;
+  };
+
+  // Nodes of kind kAll read the entire datum
+  Kind kind = kAll;
+
+  // The projection of the fields of a record, the items of an array, the
+  // values of a map, or the branches of a union; null for skipped fields
+  std::vector<std::unique_ptr<Node>> children;
+
+  std::vector<Step> steps;
+};
+
+namespace {
+
+using Parsers = std::vector<const AvroParser*>;
+
+// Adds the parser, union parsers and the root parser parse the datum that
+// they are given and are replaced by their children
+void AddParser(const AvroParser* parser, Parsers* parsers) {
+  if (dynamic_cast<const UnionParser*>(parser) != nullptr ||
+      dynamic_cast<const RootParser*>(parser) != nullptr) {
+    for (const AvroParserSharedPtr& child : (*parser).GetChildren()) {
+      AddParser(child.get(), parsers);
+    }
+  } else {
+    (*parsers).push_back(parser);
+  }
+}
+
+void AddChildren(const AvroParser* parser, Parsers* parsers) {
+  for (const AvroParserSharedPtr& child : (*parser).GetChildren()) {
+    AddParser(child.get(), parsers);
+  }
+}
+
+bool AreRecordParsers(const Parsers& parsers) {
+  for (const AvroParser* parser : parsers) {
+    if (dynamic_cast<const RecordParser*>(parser) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AreArrayParsers(const Parsers& parsers) {
+  for (const AvroParser* parser : parsers) {
+    if (dynamic_cast<const ArrayAllParser*>(parser) == nullptr &&
+        dynamic_cast<const ArrayIndexParser*>(parser) == nullptr &&
+        dynamic_cast<const ArrayFilterParser*>(parser) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AreMapParsers(const Parsers& parsers) {
+  for (const AvroParser* parser : parsers) {
+    if (dynamic_cast<const MapKeyParser*>(parser) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if every value of the schema is encoded with the same number
+// of bytes, e.g. float, double, fixed and records of those
+bool GetFixedSize(const avro::NodePtr& node, size_t* size) {
+  switch (node->type()) {
+    case avro::AVRO_NULL:
+      *size = 0;
+      return true;
+    case avro::AVRO_BOOL:
+      *size = 1;
+      return true;
+    case avro::AVRO_FLOAT:
+      *size = 4;
+      return true;
+    case avro::AVRO_DOUBLE:
+      *size = 8;
+      return true;
+    case avro::AVRO_FIXED:
+      *size = node->fixedSize();
+      return true;
+    case avro::AVRO_RECORD: {
+      size_t total = 0;
+      for (size_t i = 0; i < node->leaves(); i++) {
+        size_t field_size;
+        if (!GetFixedSize(node->leafAt(i), &field_size)) {
+          return false;
+        }
+        total += field_size;
+      }
+      *size = total;
+      return true;
+    }
+    case avro::AVRO_SYMBOLIC:
+      return GetFixedSize(avro::resolveSymbol(node), size);
+    default:
+      return false;
+  }
+}
+
+// Builds the projection of the schema for the parsers that parse its datum.
+// Parsers that do not match the schema type read the entire datum, so that
+// they report the type error when parsing.
+std::unique_ptr<AvroProjection::Node> BuildNode(const avro::NodePtr& node,
+                                                const Parsers& parsers,
+                                                size_t* num_skipped_fields) {
+  using Node = AvroProjection::Node;
+  std::unique_ptr<Node> projection(new Node());
+  const avro::NodePtr schema = node->type() == avro::AVRO_SYMBOLIC
+                                   ? avro::resolveSymbol(node)
+                                   : node;
+  bool read_all = true;
+  switch (schema->type()) {
+    case avro::AVRO_RECORD: {
+      if (!AreRecordParsers(parsers)) {
+        break;
+      }
+      (*projection).kind = Node::kRecord;
+      for (size_t i = 0; i < schema->leaves(); i++) {
+        Parsers field_parsers;
+        for (const AvroParser* parser : parsers) {
+          if (static_cast<const RecordParser*>(parser)->GetName() ==
+              schema->nameAt(i)) {
+            AddChildren(parser, &field_parsers);
+          }
+        }
+        std::vector<Node::Step>& steps = (*projection).steps;
+        if (field_parsers.empty()) {
+          (*projection).children.emplace_back(nullptr);
+          (*num_skipped_fields)++;
+          read_all = false;
+          size_t bytes;
+          if (!GetFixedSize(schema->leafAt(i), &bytes)) {
+            steps.push_back({Node::kSkipField, i, 0, schema->leafAt(i)});
+          } else if (!steps.empty() && steps.back().kind == Node::kSkipBytes) {
+            steps.back().bytes += bytes;
+          } else {
+            steps.push_back({Node::kSkipBytes, i, bytes, nullptr});
+          }
+        } else {
+          std::unique_ptr<Node> field =
+              BuildNode(schema->leafAt(i), field_parsers, num_skipped_fields);
+          read_all = read_all && (*field).kind == Node::kAll;
+          (*projection).children.push_back(std::move(field));
+          steps.push_back({Node::kReadField, i, 0, nullptr});
+        }
+      }
+      break;
+    }
+    case avro::AVRO_ARRAY:
+    case avro::AVRO_MAP: {
+      if (schema->type() == avro::AVRO_ARRAY ? !AreArrayParsers(parsers)
+                                             : !AreMapParsers(parsers)) {
+        break;
+      }
+      Parsers value_parsers;
+      for (const AvroParser* parser : parsers) {
+        AddChildren(parser, &value_parsers);
+      }
+      // Items of arrays are at leaf 0, values of maps at leaf 1
+      const size_t leaf = schema->type() == avro::AVRO_ARRAY ? 0 : 1;
+      std::unique_ptr<Node> value = BuildNode(
+          schema->leafAt(leaf), value_parsers, num_skipped_fields);
+      read_all = (*value).kind == Node::kAll;
+      (*projection).kind =
+          schema->type() == avro::AVRO_ARRAY ? Node::kArray : Node::kMap;
+      (*projection).children.push_back(std::move(value));
+      break;
+    }
+    case avro::AVRO_UNION: {
+      // The parsers see the datum of the branch
+      (*projection).kind = Node::kUnion;
+      for (size_t i = 0; i < schema->leaves(); i++) {
+        std::unique_ptr<Node> branch =
+            BuildNode(schema->leafAt(i), parsers, num_skipped_fields);
+        read_all = read_all && (*branch).kind == Node::kAll;
+        (*projection).children.push_back(std::move(branch));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  if (read_all) {
+    projection.reset(new Node());
+  }
+  return projection;
+}
+
+void ReadDatum(avro::Decoder& decoder, avro::GenericDatum& datum);
+
+// Reads the value of the datum, the branch of a union is already selected
+void ReadValue(avro::Decoder& decoder, avro::GenericDatum& datum) {
+  switch (datum.type()) {
+    case avro::AVRO_NULL:
+      decoder.decodeNull();
+      break;
+    case avro::AVRO_BOOL:
+      datum.value<bool>() = decoder.decodeBool();
+      break;
+    case avro::AVRO_INT:
+      datum.value<int32_t>() = decoder.decodeInt();
+      break;
+    case avro::AVRO_LONG:
+      datum.value<int64_t>() = decoder.decodeLong();
+      break;
+    case avro::AVRO_FLOAT:
+      datum.value<float>() = decoder.decodeFloat();
+      break;
+    case avro::AVRO_DOUBLE:
+      datum.value<double>() = decoder.decodeDouble();
+      break;
+    case avro::AVRO_STRING:
+      decoder.decodeString(datum.value<std::string>());
+      break;
+    case avro::AVRO_BYTES:
+      decoder.decodeBytes(datum.value<std::vector<uint8_t>>());
+      break;
+    case avro::AVRO_FIXED: {
+      avro::GenericFixed& fixed = datum.value<avro::GenericFixed>();
+      decoder.decodeFixed(fixed.schema()->fixedSize(), fixed.value());
+      break;
+    }
+    case avro::AVRO_ENUM:
+      datum.value<avro::GenericEnum>().set(decoder.decodeEnum());
+      break;
+    case avro::AVRO_RECORD: {
+      avro::GenericRecord& record = datum.value<avro::GenericRecord>();
+      for (size_t i = 0; i < record.fieldCount(); i++) {
+        ReadDatum(decoder, record.fieldAt(i));
+      }
+      break;
+    }
+    case avro::AVRO_ARRAY: {
+      avro::GenericArray& array = datum.value<avro::GenericArray>();
+      std::vector<avro::GenericDatum>& items = array.value();
+      const avro::GenericDatum item(array.schema()->leafAt(0));
+      items.clear();
+      for (size_t n = decoder.arrayStart(); n != 0; n = decoder.arrayNext()) {
+        size_t start = items.size();
+        items.resize(start + n, item);
+        for (size_t i = start; i < items.size(); i++) {
+          ReadDatum(decoder, items[i]);
+        }
+      }
+      break;
+    }
+    case avro::AVRO_MAP: {
+      avro::GenericMap& map = datum.value<avro::GenericMap>();
+      std::vector<std::pair<std::string, avro::GenericDatum>>& entries =
+          map.value();
+      const std::pair<std::string, avro::GenericDatum> entry(
+          std::string(), avro::GenericDatum(map.schema()->leafAt(1)));
+      entries.clear();
+      for (size_t n = decoder.mapStart(); n != 0; n = decoder.mapNext()) {
+        size_t start = entries.size();
+        entries.resize(start + n, entry);
+        for (size_t i = start; i < entries.size(); i++) {
+          decoder.decodeString(entries[i].first);
+          ReadDatum(decoder, entries[i].second);
+        }
+      }
+      break;
+    }
+    default:
+      throw avro::Exception("Unknown Avro type");
+  }
+}
+
+void ReadDatum(avro::Decoder& decoder, avro::GenericDatum& datum) {
+  if (datum.isUnion()) {
+    datum.selectBranch(decoder.decodeUnionIndex());
+  }
+  ReadValue(decoder, datum);
+}
+
+void ReadProjectedDatum(const AvroProjection::Node& node,
+                        avro::Decoder& decoder, avro::GenericDatum& datum);
+
+// Reads the projected value of the datum, the branch of a union is already
+// selected
+void ReadProjectedValue(const AvroProjection::Node& node,
+                        avro::Decoder& decoder, avro::GenericDatum& datum) {
+  using Node = AvroProjection::Node;
+  switch (node.kind) {
+    case Node::kAll:
+      ReadValue(decoder, datum);
+      break;
+    case Node::kRecord: {
+      avro::GenericRecord& record = datum.value<avro::GenericRecord>();
+      for (const Node::Step& step : node.steps) {
+        switch (step.kind) {
+          case Node::kReadField:
+            ReadProjectedDatum(*node.children[step.field], decoder,
+                               record.fieldAt(step.field));
+            break;
+          case Node::kSkipField:
+            SkipDatum(decoder, step.schema);
+            break;
+          case Node::kSkipBytes:
+            decoder.skipFixed(step.bytes);
+            break;
+        }
+      }
+      break;
+    }
+    case Node::kArray: {
+      avro::GenericArray& array = datum.value<avro::GenericArray>();
+      std::vector<avro::GenericDatum>& items = array.value();
+      const avro::GenericDatum item(array.schema()->leafAt(0));
+      items.clear();
+      for (size_t n = decoder.arrayStart(); n != 0; n = decoder.arrayNext()) {
+        size_t start = items.size();
+        items.resize(start + n, item);
+        for (size_t i = start; i < items.size(); i++) {
+          ReadProjectedDatum(*node.children[0], decoder, items[i]);
+        }
+      }
+      break;
+    }
+    case Node::kMap: {
+      avro::GenericMap& map = datum.value<avro::GenericMap>();
+      std::vector<std::pair<std::string, avro::GenericDatum>>& entries =
+          map.value();
+      const std::pair<std::string, avro::GenericDatum> entry(
+          std::string(), avro::GenericDatum(map.schema()->leafAt(1)));
+      entries.clear();
+      for (size_t n = decoder.mapStart(); n != 0; n = decoder.mapNext()) {
+        size_t start = entries.size();
+        entries.resize(start + n, entry);
+        for (size_t i = start; i < entries.size(); i++) {
+          decoder.decodeString(entries[i].first);
+          ReadProjectedDatum(*node.children[0], decoder, entries[i].second);
+        }
+      }
+      break;
+    }
+    case Node::kUnion:
+      // Unions can't contain unions directly
+      throw avro::Exception("Nested union");
+  }
+}
+
+void ReadProjectedDatum(const AvroProjection::Node& node,
+                        avro::Decoder& decoder, avro::GenericDatum& datum) {
+  using Node = AvroProjection::Node;
+  if (node.kind == Node::kAll) {
+    ReadDatum(decoder, datum);
+  } else if (node.kind == Node::kUnion) {
+    size_t index = decoder.decodeUnionIndex();
+    if (index >= node.children.size()) {
+      throw avro::Exception("Union index out of range");
+    }
+    datum.selectBranch(index);
+    ReadProjectedValue(*node.children[index], decoder, datum);
+  } else {
+    ReadProjectedValue(node, decoder, datum);
+  }
+}
+
+}  // namespace
+
+void SkipDatum(avro::Decoder& decoder, const avro::NodePtr& node) {
+  switch (node->type()) {
+    case avro::AVRO_NULL:
+      decoder.decodeNull();
+      break;
+    case avro::AVRO_BOOL:
+      decoder.decodeBool();
+      break;
+    case avro::AVRO_INT:
+      decoder.decodeInt();
+      break;
+    case avro::AVRO_LONG:
+      decoder.decodeLong();
+      break;
+    case avro::AVRO_FLOAT:
+      decoder.decodeFloat();
+      break;
+    case avro::AVRO_DOUBLE:
+      decoder.decodeDouble();
+      break;
+    case avro::AVRO_STRING:
+      decoder.skipString();
+      break;
+    case avro::AVRO_BYTES:
+      decoder.skipBytes();
+      break;
+    case avro::AVRO_FIXED:
+      decoder.skipFixed(node->fixedSize());
+      break;
+    case avro::AVRO_ENUM:
+      decoder.decodeEnum();
+      break;
+    case avro::AVRO_RECORD:
+      for (size_t i = 0; i < node->leaves(); i++) {
+        SkipDatum(decoder, node->leafAt(i));
+      }
+      break;
+    case avro::AVRO_ARRAY:
+      // Blocks with a known byte size are skipped at once, the items of the
+      // other blocks one by one.
+      for (size_t n = decoder.skipArray(); n != 0; n = decoder.arrayNext()) {
+        for (size_t i = 0; i < n; i++) {
+          SkipDatum(decoder, node->leafAt(0));
+        }
+      }
+      break;
+    case avro::AVRO_MAP:
+      for (size_t n = decoder.skipMap(); n != 0; n = decoder.mapNext()) {
+        for (size_t i = 0; i < n; i++) {
+          decoder.skipString();
+          SkipDatum(decoder, node->leafAt(1));
+        }
+      }
+      break;
+    case avro::AVRO_UNION: {
+      size_t index = decoder.decodeUnionIndex();
+      if (index >= node->leaves()) {
+        throw avro::Exception("Union index out of range");
+      }
+      SkipDatum(decoder, node->leafAt(index));
+      break;
+    }
+    case avro::AVRO_SYMBOLIC:
+      SkipDatum(decoder, avro::resolveSymbol(node));
+      break;
+    default:
+      throw avro::Exception("Unknown Avro type");
+  }
+}
+
+AvroProjection::AvroProjection() : num_skipped_fields_(0) {}
+
+AvroProjection::~AvroProjection() {}
+
+/* static */ Status AvroProjection::Build(AvroProjection* projection,
+                                          const AvroParserTree& parser_tree,
+                                          const avro::ValidSchema& schema) {
+  Parsers parsers;
+  AddParser(parser_tree.getRoot().get(), &parsers);
+  (*projection).num_skipped_fields_ = 0;
+  (*projection).root_ = BuildNode(schema.root(), parsers,
+                                  &(*projection).num_skipped_fields_);
+  VLOG(5) << "Projection skips " << (*projection).num_skipped_fields_
+          << " fields";
+  return OkStatus();
+}
+
+void AvroProjection::Read(avro::Decoder& decoder,
+                          avro::GenericDatum& datum) const {
+  ReadProjectedDatum(*root_, decoder, datum);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,65 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_PROJECTION_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_PROJECTION_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/Decoder.hh"
+#include "api/Generic.hh"
+#include "api/ValidSchema.hh"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_parser_tree.h"
+
+namespace tensorflow {
+namespace data {
+
+// Skips over a value of the given schema. Throws avro::Exception if the data
+// ends early.
+void SkipDatum(avro::Decoder& decoder, const avro::NodePtr& node);
+
+// Decodes only the parts of a datum that the parsers of a parser tree read.
+// Record fields that no key refers to are skipped in the binary data with the
+// skip primitives of the decoder, consecutive skipped fields of fixed size
+// (e.g. float, double, fixed) at once. The skipped fields of the datum are not
+// touched and must not be read.
+//
+// The projection is built from the reader schema, the data must have been
+// written with that schema.
+class AvroProjection {
+ public:
+  AvroProjection();
+  ~AvroProjection();
+
+  static Status Build(AvroProjection* projection,
+                      const AvroParserTree& parser_tree,
+                      const avro::ValidSchema& schema);
+
+  // Reads a datum of the schema from the decoder. Throws avro::Exception if
+  // the data is invalid.
+  void Read(avro::Decoder& decoder, avro::GenericDatum& datum) const;
+
+  // Returns the number of record fields that are skipped
+  inline size_t NumSkippedFields() const { return num_skipped_fields_; }
+
+  struct Node;
+
+ private:
+  std::unique_ptr<Node> root_;
+  size_t num_skipped_fields_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_PROJECTION_H_
@@ -14,12 +14,22 @@ limitations under the License.
 
 #include <limits.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+
 #include "api/Compiler.hh"
 #include "api/DataFile.hh"
 #include "api/Generic.hh"
+#include "api/NodeImpl.hh"
+#include "api/Specific.hh"
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_codec.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_index.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_projection.h"
 
 namespace {
-class AvroDataInputStream : public avro::InputStream {
+class AvroDataInputStream : public avro::SeekableInputStream {
  public:
   AvroDataInputStream(
       std::unique_ptr<tensorflow::io::BufferedInputStream> input_stream,
@@ -52,6 +62,10 @@ class AvroDataInputStream : public avro::InputStream {
     do_seek = true;
     pos_ += len;
   }
+  void seek(int64_t position) override {
+    do_seek = true;
+    pos_ = static_cast<size_t>(position);
+  }
   size_t byteCount() const override { return pos_; }
 
  private:
@@ -61,17 +75,237 @@ class AvroDataInputStream : public avro::InputStream {
   size_t pos_ = 0;
   bool do_seek = false;
 };
+
+constexpr char kAvroSchemaKey[] = "avro.schema";
+constexpr char kAvroCodecKey[] = "avro.codec";
+constexpr char kNullCodec[] = "null";
+constexpr char kDeflateCodec[] = "deflate";
+constexpr char kSnappyCodec[] = "snappy";
+
+const std::array<uint8_t, 4> kAvroMagic = {{'O', 'b', 'j', '\x01'}};
+
 }  // namespace
 
 namespace tensorflow {
 namespace data {
 
+AvroBlockRecordReader::AvroBlockRecordReader(RandomAccessFile* file,
+                                             int64 buffer_size)
+    : file_decoder_(avro::binaryDecoder()),
+      block_decoder_(avro::binaryDecoder()) {
+  std::unique_ptr<io::BufferedInputStream> buffered_input(
+      new io::BufferedInputStream(new io::RandomAccessInputStream(file),
+                                  buffer_size, true));
+  file_stream_.reset(
+      new AvroDataInputStream(std::move(buffered_input), buffer_size));
+}
+
+Status AvroBlockRecordReader::Init() {
+  try {
+    file_decoder_->init(*file_stream_);
+    std::array<uint8_t, 4> magic;
+    avro::decode(*file_decoder_, magic);
+    if (magic != kAvroMagic) {
+      return errors::DataLoss("Invalid Avro file. Magic does not match.");
+    }
+    std::map<string, std::vector<uint8_t> > metadata;
+    avro::decode(*file_decoder_, metadata);
+    auto it = metadata.find(kAvroSchemaKey);
+    if (it == metadata.end()) {
+      return errors::DataLoss("No schema in Avro file metadata.");
+    }
+    std::istringstream ss(string(it->second.begin(), it->second.end()));
+    avro::compileJsonSchema(ss, writer_schema_);
+    codec_ = kNullCodec;
+    it = metadata.find(kAvroCodecKey);
+    if (it != metadata.end()) {
+      codec_ = string(it->second.begin(), it->second.end());
+    }
+    avro::decode(*file_decoder_, sync_marker_);
+  } catch (avro::Exception& e) {
+    return errors::DataLoss("Cannot read Avro file header: ", e.what());
+  }
+  if (codec_ != kNullCodec && codec_ != kDeflateCodec
+#ifdef SNAPPY_CODEC_AVAILABLE
+      && codec_ != kSnappyCodec
+#endif
+  ) {
+    return errors::Unimplemented("Unsupported Avro codec: ", codec_);
+  }
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::ReadRecord(tstring* record) {
+  while (remaining_records_ == 0) {
+    if (block_end_ >= 0 &&
+        Tell() >= block_end_ + static_cast<int64>(sync_marker_.size())) {
+      return errors::OutOfRange("eof");
+    }
+    TF_RETURN_IF_ERROR(ReadBlock());
+  }
+  // Re-initializing the decoder hands its buffered bytes back to the block
+  // stream, so that the byte count is the offset of the record.
+  block_decoder_->init(*block_stream_);
+  size_t start = block_stream_->byteCount();
+  try {
+    SkipDatum(*block_decoder_, writer_schema_.root());
+  } catch (avro::Exception& e) {
+    return errors::DataLoss("Cannot read Avro record: ", e.what());
+  }
+  block_decoder_->init(*block_stream_);
+  size_t end = block_stream_->byteCount();
+  record->assign(content_.data() + start, end - start);
+  remaining_records_--;
+  return OkStatus();
+}
+
+int64 AvroBlockRecordReader::Tell() {
+  // Hands the bytes buffered by the decoder back to the stream.
+  file_decoder_->init(*file_stream_);
+  return static_cast<int64>(file_stream_->byteCount());
+}
+
+Status AvroBlockRecordReader::SeekToBlock(int64 offset) {
+  file_decoder_->init(*file_stream_);
+  file_stream_->seek(offset);
+  remaining_records_ = 0;
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::Sync(int64 position) {
+  TF_RETURN_IF_ERROR(SeekToBlock(position));
+  const string marker(reinterpret_cast<const char*>(sync_marker_.data()),
+                      sync_marker_.size());
+  // Keeps the end of the previous chunk to find markers that span chunks.
+  string window;
+  int64 window_offset = position;
+  const uint8_t* data = nullptr;
+  size_t len = 0;
+  while (file_stream_->next(&data, &len)) {
+    window.append(reinterpret_cast<const char*>(data), len);
+    size_t pos = window.find(marker);
+    if (pos != string::npos) {
+      return SeekToBlock(window_offset + static_cast<int64>(pos) +
+                         static_cast<int64>(marker.size()));
+    }
+    size_t keep = std::min(window.size(), marker.size() - 1);
+    window_offset += static_cast<int64>(window.size() - keep);
+    window.erase(0, window.size() - keep);
+    len = 0;
+  }
+  // No more blocks after `position`.
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::SkipBlock(int64* num_records) {
+  int64 num_bytes = 0;
+  TF_RETURN_IF_ERROR(ReadBlockHeader(num_records, &num_bytes));
+  file_decoder_->init(*file_stream_);
+  file_stream_->skip(static_cast<size_t>(num_bytes));
+  return ReadSyncMarker();
+}
+
+Status AvroBlockRecordReader::ReadBlockHeader(int64* num_records,
+                                              int64* num_bytes) {
+  // Check for the end of the file without consuming any bytes.
+  file_decoder_->init(*file_stream_);
+  const uint8_t* data = nullptr;
+  size_t len = 0;
+  if (!file_stream_->next(&data, &len)) {
+    return errors::OutOfRange("eof");
+  }
+  file_stream_->backup(len);
+  try {
+    int64_t object_count = 0, byte_count = 0;
+    avro::decode(*file_decoder_, object_count);
+    avro::decode(*file_decoder_, byte_count);
+    if (object_count < 0 || byte_count < 0) {
+      return errors::DataLoss("Invalid Avro block with ", object_count,
+                              " records and ", byte_count, " bytes.");
+    }
+    *num_records = object_count;
+    *num_bytes = byte_count;
+  } catch (avro::Exception& e) {
+    return errors::DataLoss("Truncated Avro block header: ", e.what());
+  }
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::ReadSyncMarker() {
+  try {
+    avro::DataFileSync sync_marker;
+    avro::decode(*file_decoder_, sync_marker);
+    if (sync_marker != sync_marker_) {
+      return errors::DataLoss("Avro sync marker mismatch.");
+    }
+  } catch (avro::Exception& e) {
+    return errors::DataLoss("Truncated Avro block: ", e.what());
+  }
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::ReadBlock() {
+  int64 num_records = 0, num_bytes = 0;
+  TF_RETURN_IF_ERROR(ReadBlockHeader(&num_records, &num_bytes));
+  try {
+    file_decoder_->decodeFixed(static_cast<size_t>(num_bytes), block_);
+  } catch (avro::Exception& e) {
+    return errors::DataLoss("Truncated Avro block: ", e.what());
+  }
+  TF_RETURN_IF_ERROR(ReadSyncMarker());
+  remaining_records_ = num_records;
+  TF_RETURN_IF_ERROR(DecompressBlock());
+  block_stream_ = avro::memoryInputStream(
+      reinterpret_cast<const uint8_t*>(content_.data()), content_.size());
+  return OkStatus();
+}
+
+Status AvroBlockRecordReader::DecompressBlock() {
+  const char* compressed = reinterpret_cast<const char*>(block_.data());
+  if (codec_ == kNullCodec) {
+    content_ = StringPiece(compressed, block_.size());
+    return OkStatus();
+  }
+  // Starts with the capacity kept from the previous blocks.
+  uncompressed_.resize_uninitialized(
+      std::max(uncompressed_.capacity(),
+               std::max(block_.size() * 4, static_cast<size_t>(1024))));
+  Status status = errors::Unimplemented("Unsupported Avro codec: ", codec_);
+  if (codec_ == kDeflateCodec) {
+    status = DecompressDeflateBlock(compressed, block_.size(), &uncompressed_);
+  }
+#ifdef SNAPPY_CODEC_AVAILABLE
+  if (codec_ == kSnappyCodec) {
+    status = DecompressSnappyBlock(compressed, block_.size(), &uncompressed_);
+  }
+#endif
+  content_ = StringPiece(uncompressed_.data(), uncompressed_.size());
+  return status;
+}
+
 AvroRecordReader::AvroRecordReader(RandomAccessFile* file,
                                    const AvroReaderOptions& options)
     : datum_(nullptr),
       options_(options),
       reader_(nullptr),
       encoder_(avro::binaryEncoder()) {
+  string error;
+  std::istringstream ss(options_.reader_schema);
+  bool has_reader_schema = avro::compileJsonSchema(ss, reader_schema_, error);
+  if (options_.raw_records) {
+    // Without schema resolution the records are handed out as written.
+    std::unique_ptr<AvroBlockRecordReader> block_reader(
+        new AvroBlockRecordReader(file, options_.buffer_size));
+    Status status = block_reader->Init();
+    if (status.ok() && (!has_reader_schema ||
+                        reader_schema_.toJson(false) ==
+                            block_reader->writer_schema().toJson(false))) {
+      block_reader_ = std::move(block_reader);
+      return;
+    }
+    VLOG(7) << "Decoding records with the generic reader: "
+            << status.ToString();
+  }
   // TODO: Handle buffer_size = 0 in 2.0 since InputStreamInterface has seek
   // method if (options.buffer_size > 0) {...}
   std::unique_ptr<io::BufferedInputStream> buffered_input(
@@ -80,9 +314,7 @@ AvroRecordReader::AvroRecordReader(RandomAccessFile* file,
   std::unique_ptr<AvroDataInputStream> avro_input(
       new AvroDataInputStream(std::move(buffered_input), options_.buffer_size));
   // Log a warning
-  string error;
-  std::istringstream ss(options_.reader_schema);
-  if (!avro::compileJsonSchema(ss, reader_schema_, error)) {
+  if (!has_reader_schema) {
     // TODO: Log warning here that the writer schema is used for reading
     // return errors::InvalidArgument("Avro schema error: ", error);
     VLOG(7) << "Cannot parse reader schema '" << options_.reader_schema << "'";
@@ -100,6 +332,12 @@ AvroRecordReader::AvroRecordReader(RandomAccessFile* file,
 Status AvroRecordReader::ReadRecord(uint64* offset, tstring* record) {
   // TODO: Wire up offset, setting, seeking etc.  note, may only be possible to
   // sync points
+  if (block_reader_) {
+    return block_reader_->ReadRecord(record);
+  }
+  if (byte_end_ >= 0 && reader_->pastSync(byte_end_)) {
+    return errors::OutOfRange("eof");
+  }
   if (!reader_->read(*datum_)) {
     VLOG(7) << "Could not read datum from file!";
     return errors::OutOfRange("eof");
@@ -120,6 +358,36 @@ Status AvroRecordReader::ReadRecord(uint64* offset, tstring* record) {
   return record->empty() ? errors::OutOfRange("eof") : OkStatus();
 }
 
+Status AvroRecordReader::SetByteRange(int64 byte_start, int64 byte_end,
+                                      const AvroBlockIndex* index) {
+  if (block_reader_ == nullptr) {
+    try {
+      reader_->sync(byte_start);
+    } catch (avro::Exception& e) {
+      return errors::DataLoss("Cannot find Avro block at ", byte_start, ": ",
+                              e.what());
+    }
+    byte_end_ = byte_end;
+    return OkStatus();
+  }
+  block_reader_->SetByteEnd(byte_end);
+  if (index == nullptr) {
+    return block_reader_->Sync(byte_start);
+  }
+  if (index->sync_marker() != block_reader_->sync_marker()) {
+    return errors::InvalidArgument(
+        "Avro block index does not belong to the file.");
+  }
+  size_t first, last;
+  index->BlocksInRange(byte_start, byte_end, &first, &last);
+  if (first == last) {
+    // Nothing to read in this range.
+    block_reader_->SetByteEnd(0);
+    return OkStatus();
+  }
+  return block_reader_->SeekToBlock(index->blocks()[first].offset);
+}
+
 SequentialAvroRecordReader::SequentialAvroRecordReader(
     RandomAccessFile* file, const AvroReaderOptions& options)
     : underlying_(file, options), offset_(0) {}
@@ -13,8 +13,10 @@ limitations under the License.
 #define TENSORFLOW_DATA_AVRO_FILE_STREAM_READER_H_
 
 #include <string>
+#include <vector>
 
 #include "api/DataFile.hh"
+#include "api/Decoder.hh"
 #include "api/Encoder.hh"
 #include "api/Stream.hh"
 #include "tensorflow/core/lib/core/errors.h"
@@ -31,6 +33,8 @@ limitations under the License.
 namespace tensorflow {
 namespace data {
 
+class AvroBlockIndex;
+
 class AvroReaderOptions {
  public:
   static AvroReaderOptions CreateReaderOptions() {
@@ -38,12 +42,77 @@ class AvroReaderOptions {
   }
   int64 buffer_size;
   string reader_schema;
+  // Slice the serialized records out of the decompressed blocks instead of
+  // decoding and re-encoding every record. Only used if the reader schema is
+  // empty or equal to the writer schema.
+  bool raw_records = true;
 
  private:
   AvroReaderOptions(int64 buffer_size, const string& reader_schema)
       : buffer_size(buffer_size), reader_schema(reader_schema) {}
 };
 
+// Reads the blocks of an Avro object container file and returns the bytes of
+// each record as they are stored in the decompressed block. Record boundaries
+// are found by skipping over the record with the writer schema, so no datum
+// is created.
+class AvroBlockRecordReader {
+ public:
+  AvroBlockRecordReader(RandomAccessFile* file, int64 buffer_size);
+
+  // Reads the file header. Must be called before ReadRecord.
+  Status Init();
+
+  const avro::ValidSchema& writer_schema() const { return writer_schema_; }
+
+  const avro::DataFileSync& sync_marker() const { return sync_marker_; }
+
+  // Reads the next record into *record. Returns OUT_OF_RANGE at the end of
+  // the file or of the byte range.
+  Status ReadRecord(tstring* record);
+
+  // Returns the file offset of the next block. Only valid after the records
+  // of the current block are read.
+  int64 Tell();
+
+  // Continues reading at the block that starts at `offset`.
+  Status SeekToBlock(int64 offset);
+
+  // Moves to the block after the first sync marker that starts at or after
+  // `position`, like avro::DataFileReader::sync.
+  Status Sync(int64 position);
+
+  // Reads the header of the next block and skips over its content.
+  Status SkipBlock(int64* num_records);
+
+  // Stops reading before the first block whose sync marker starts at or
+  // after `byte_end`, like avro::DataFileReader::pastSync.
+  void SetByteEnd(int64 byte_end) { block_end_ = byte_end; }
+
+ private:
+  Status ReadBlockHeader(int64* num_records, int64* num_bytes);
+  Status ReadSyncMarker();
+  Status ReadBlock();
+  Status DecompressBlock();
+
+  std::unique_ptr<avro::SeekableInputStream> file_stream_;
+  avro::DecoderPtr file_decoder_;
+  avro::ValidSchema writer_schema_;
+  string codec_;
+  avro::DataFileSync sync_marker_;
+
+  // Compressed content of the current block and its decompressed content if
+  // the codec is not null. Both keep their capacity across blocks.
+  std::vector<uint8_t> block_;
+  tstring uncompressed_;
+  StringPiece content_;
+  int64 remaining_records_ = 0;
+  // Offset of the first sync marker that is not part of the byte range.
+  int64 block_end_ = -1;
+  std::unique_ptr<avro::InputStream> block_stream_;
+  avro::DecoderPtr block_decoder_;
+};
+
 class AvroRecordReader {
  public:
   explicit AvroRecordReader(RandomAccessFile* file,
@@ -55,7 +124,18 @@ class AvroRecordReader {
   // OUT_OF_RANGE for end of file, or something else for an error.
   Status ReadRecord(uint64* offset, tstring* string);
 
+  // Limits the reader to the blocks whose sync marker starts in
+  // [byte_start, byte_end). byte_end < 0 reads to the end of the file. The
+  // blocks are looked up in `index` if not null and found by scanning for
+  // sync markers otherwise.
+  Status SetByteRange(int64 byte_start, int64 byte_end,
+                      const AvroBlockIndex* index);
+
  private:
+  // Set if the records are sliced out of the blocks, in which case the
+  // members below are unused.
+  std::unique_ptr<AvroBlockRecordReader> block_reader_;
+
   std::unique_ptr<avro::GenericDatum> datum_;
   const AvroReaderOptions options_;
 
@@ -63,6 +143,7 @@ class AvroRecordReader {
   std::unique_ptr<avro::DataFileReader<avro::GenericDatum> > reader_;
   avro::EncoderPtr encoder_;  // note shared ptr
   avro::ValidSchema reader_schema_;
+  int64 byte_end_ = -1;
 };
 
 class SequentialAvroRecordReader {
@@ -81,6 +162,11 @@ class SequentialAvroRecordReader {
     return underlying_.ReadRecord(&offset_, record);
   }
 
+  Status SetByteRange(int64 byte_start, int64 byte_end,
+                      const AvroBlockIndex* index) {
+    return underlying_.SetByteRange(byte_start, byte_end, index);
+  }
+
   // Returns the current offset in the file.
   uint64 TellOffset() { return offset_; }
 
@@ -0,0 +1,169 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_schema_cache.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "api/Compiler.hh"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/strcat.h"
+
+namespace tensorflow {
+namespace data {
+
+/* static */ AvroSchemaCache* AvroSchemaCache::Global() {
+  static AvroSchemaCache* cache = new AvroSchemaCache();
+  return cache;
+}
+
+Status AvroSchemaCache::GetSchema(
+    const string& json, std::shared_ptr<const avro::ValidSchema>* schema) {
+  const uint64 fingerprint = Fingerprint64(json);
+  {
+    mutex_lock l(mu_);
+    *schema = Find(schemas_, fingerprint, json);
+  }
+  if (*schema != nullptr) {
+    return OkStatus();
+  }
+
+  // Compile outside of the lock, other kernels may look up their schemas
+  // meanwhile
+  auto compiled = std::make_shared<avro::ValidSchema>();
+  std::istringstream ss(json);
+  string error;
+  if (!avro::compileJsonSchema(ss, *compiled, error)) {
+    return errors::InvalidArgument("Avro schema error: ", error);
+  }
+
+  mutex_lock l(mu_);
+  *schema = Insert<avro::ValidSchema>(&schemas_, fingerprint, json,
+                                      std::move(compiled));
+  return OkStatus();
+}
+
+Status AvroSchemaCache::GetParserTree(
+    const std::vector<KeyWithType>& keys_and_types,
+    std::shared_ptr<const AvroParserTree>* parser_tree) {
+  const string key = FeatureKey(keys_and_types);
+  const uint64 fingerprint = Fingerprint64(key);
+  {
+    mutex_lock l(mu_);
+    *parser_tree = Find(parser_trees_, fingerprint, key);
+  }
+  if (*parser_tree != nullptr) {
+    return OkStatus();
+  }
+
+  auto built = std::make_shared<AvroParserTree>();
+  TF_RETURN_IF_ERROR(AvroParserTree::Build(built.get(), keys_and_types));
+
+  mutex_lock l(mu_);
+  *parser_tree = Insert<AvroParserTree>(&parser_trees_, fingerprint, key,
+                                        std::move(built));
+  return OkStatus();
+}
+
+size_t AvroSchemaCache::NumSchemas() const {
+  mutex_lock l(mu_);
+  size_t num = 0;
+  for (const auto& entries : schemas_) {
+    for (const auto& entry : entries.second) {
+      num += !entry.value.expired();
+    }
+  }
+  return num;
+}
+
+size_t AvroSchemaCache::NumParserTrees() const {
+  mutex_lock l(mu_);
+  size_t num = 0;
+  for (const auto& entries : parser_trees_) {
+    for (const auto& entry : entries.second) {
+      num += !entry.value.expired();
+    }
+  }
+  return num;
+}
+
+template <typename T>
+/* static */ std::shared_ptr<const T> AvroSchemaCache::Find(
+    const Entries<T>& entries, uint64 fingerprint, const string& key) {
+  auto found = entries.find(fingerprint);
+  if (found == entries.end()) {
+    return nullptr;
+  }
+  // Compare the keys as well, different keys may have the same fingerprint
+  for (const Entry<T>& entry : found->second) {
+    if (entry.key == key) {
+      return entry.value.lock();
+    }
+  }
+  return nullptr;
+}
+
+template <typename T>
+/* static */ std::shared_ptr<const T> AvroSchemaCache::Insert(
+    Entries<T>* entries, uint64 fingerprint, const string& key,
+    std::shared_ptr<const T> value) {
+  std::vector<Entry<T>>& bucket = (*entries)[fingerprint];
+  for (Entry<T>& entry : bucket) {
+    if (entry.key == key) {
+      std::shared_ptr<const T> existing = entry.value.lock();
+      if (existing != nullptr) {
+        return existing;
+      }
+      entry.value = value;
+      return value;
+    }
+  }
+  bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                              [](const Entry<T>& entry) {
+                                return entry.value.expired();
+                              }),
+               bucket.end());
+  bucket.push_back({key, value});
+  return value;
+}
+
+Status CachedAvroSchema::Get(
+    const string& json, std::shared_ptr<const avro::ValidSchema>* schema) {
+  {
+    mutex_lock l(mu_);
+    if (schema_ != nullptr && json_ == json) {
+      *schema = schema_;
+      return OkStatus();
+    }
+  }
+  TF_RETURN_IF_ERROR(cache_->GetSchema(json, schema));
+  mutex_lock l(mu_);
+  json_ = json;
+  schema_ = *schema;
+  return OkStatus();
+}
+
+/* static */ string AvroSchemaCache::FeatureKey(
+    const std::vector<KeyWithType>& keys_and_types) {
+  string key;
+  for (const KeyWithType& key_and_type : keys_and_types) {
+    // Names cannot contain a line break, so the separator is unambiguous
+    strings::StrAppend(&key, key_and_type.first, "\n", key_and_type.second,
+                       "\n");
+  }
+  return key;
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,108 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_SCHEMA_CACHE_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_SCHEMA_CACHE_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "api/ValidSchema.hh"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_parser_tree.h"
+
+namespace tensorflow {
+namespace data {
+
+// Process wide cache of compiled avro schemas and built parser trees. Kernels
+// that use the same schema or the same features share one instance, which
+// makes kernel construction cheap and saves the memory of the copies.
+//
+// The cache only holds weak references, an entry is released once the last
+// kernel that uses it is gone. Cached values are immutable and safe to use
+// from several threads. Thread safe.
+class AvroSchemaCache {
+ public:
+  // The cache shared by all kernels of the process
+  static AvroSchemaCache* Global();
+
+  // Returns the schema compiled from the json string
+  Status GetSchema(const string& json,
+                   std::shared_ptr<const avro::ValidSchema>* schema);
+
+  // Returns the parser tree built for the keys with their types
+  // Note, the parser tree does not depend on the schema, so kernels with
+  // different schemas but the same features share their tree
+  Status GetParserTree(const std::vector<KeyWithType>& keys_and_types,
+                       std::shared_ptr<const AvroParserTree>* parser_tree);
+
+  // Number of live entries -- exposed for testing
+  size_t NumSchemas() const;
+  size_t NumParserTrees() const;
+
+ private:
+  template <typename T>
+  struct Entry {
+    string key;
+    std::weak_ptr<const T> value;
+  };
+  template <typename T>
+  using Entries = std::unordered_map<uint64, std::vector<Entry<T>>>;
+
+  // Looks up the value for the key with the given fingerprint
+  template <typename T>
+  static std::shared_ptr<const T> Find(const Entries<T>& entries,
+                                       uint64 fingerprint, const string& key);
+
+  // Inserts the value for the key unless another thread was first, in which
+  // case the value of the other thread is returned. Drops released entries
+  // under the same fingerprint.
+  template <typename T>
+  static std::shared_ptr<const T> Insert(Entries<T>* entries,
+                                         uint64 fingerprint, const string& key,
+                                         std::shared_ptr<const T> value);
+
+  // Serializes the keys with their types into one string
+  static string FeatureKey(const std::vector<KeyWithType>& keys_and_types);
+
+  mutable mutex mu_;
+  Entries<avro::ValidSchema> schemas_ TF_GUARDED_BY(mu_);
+  Entries<AvroParserTree> parser_trees_ TF_GUARDED_BY(mu_);
+};
+
+// Keeps the schema last looked up by a kernel that takes its schema as an
+// input, so that the compiled schema stays in the cache between the calls
+// of the kernel instead of being released at the end of every call. Thread
+// safe.
+class CachedAvroSchema {
+ public:
+  // `cache` is not owned.
+  explicit CachedAvroSchema(AvroSchemaCache* cache = AvroSchemaCache::Global())
+      : cache_(cache) {}
+
+  // Returns the schema compiled from the json string, looked up in the cache
+  // only if it differs from the last one
+  Status Get(const string& json,
+             std::shared_ptr<const avro::ValidSchema>* schema);
+
+ private:
+  AvroSchemaCache* const cache_;
+  mutex mu_;
+  string json_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const avro::ValidSchema> schema_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_AVRO_SCHEMA_CACHE_H_
@@ -0,0 +1,89 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/avro_schema_cache.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+constexpr char kSchema[] =
+    R"({"type": "record", "name": "row", "fields": [)"
+    R"({"name": "id", "type": "long"}]})";
+constexpr char kOtherSchema[] =
+    R"({"type": "record", "name": "row", "fields": [)"
+    R"({"name": "name", "type": "string"}]})";
+}  // namespace
+
+TEST(AvroSchemaCacheTest, SHARES_SCHEMAS) {
+  AvroSchemaCache cache;
+  std::shared_ptr<const avro::ValidSchema> first, second;
+  TF_ASSERT_OK(cache.GetSchema(kSchema, &first));
+  TF_ASSERT_OK(cache.GetSchema(kSchema, &second));
+  ASSERT_EQ(first.get(), second.get());
+  ASSERT_EQ(1, cache.NumSchemas());
+  // The cache only holds weak references.
+  first.reset();
+  second.reset();
+  ASSERT_EQ(0, cache.NumSchemas());
+}
+
+TEST(AvroSchemaCacheTest, INVALID_SCHEMA) {
+  AvroSchemaCache cache;
+  std::shared_ptr<const avro::ValidSchema> schema;
+  ASSERT_FALSE(cache.GetSchema("not a schema", &schema).ok());
+  ASSERT_EQ(0, cache.NumSchemas());
+}
+
+TEST(AvroSchemaCacheTest, SHARES_PARSER_TREES) {
+  AvroSchemaCache cache;
+  std::vector<KeyWithType> keys_and_types = {{"id", DT_INT64},
+                                             {"name", DT_STRING}};
+  std::shared_ptr<const AvroParserTree> first, second;
+  TF_ASSERT_OK(cache.GetParserTree(keys_and_types, &first));
+  TF_ASSERT_OK(cache.GetParserTree(keys_and_types, &second));
+  ASSERT_EQ(first.get(), second.get());
+  ASSERT_EQ(1, cache.NumParserTrees());
+  keys_and_types.pop_back();
+  TF_ASSERT_OK(cache.GetParserTree(keys_and_types, &second));
+  ASSERT_NE(first.get(), second.get());
+  ASSERT_EQ(2, cache.NumParserTrees());
+}
+
+TEST(CachedAvroSchemaTest, KEEPS_SCHEMA_ACROSS_CALLS) {
+  AvroSchemaCache cache;
+  CachedAvroSchema last_schema(&cache);
+  const avro::ValidSchema* compiled = nullptr;
+  for (int call = 0; call < 3; call++) {
+    // Like a kernel, the caller drops its reference after every call.
+    std::shared_ptr<const avro::ValidSchema> schema;
+    TF_ASSERT_OK(last_schema.Get(kSchema, &schema));
+    if (compiled == nullptr) {
+      compiled = schema.get();
+    }
+    ASSERT_EQ(compiled, schema.get());
+  }
+  ASSERT_EQ(1, cache.NumSchemas());
+
+  std::shared_ptr<const avro::ValidSchema> schema;
+  TF_ASSERT_OK(last_schema.Get(kOtherSchema, &schema));
+  ASSERT_NE(compiled, schema.get());
+  // The previous schema is released once no kernel holds it.
+  schema.reset();
+  ASSERT_EQ(1, cache.NumSchemas());
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,93 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_CPU_AFFINITY_H_
+#define TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_CPU_AFFINITY_H_
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow_io/core/kernels/cpu_info.h"
+
+namespace tensorflow {
+namespace data {
+
+// Resolves the CPUs that the decode threads are pinned to: those of
+// `cpu_affinity`, a list such as "0-7,16-23", if not empty, else those of
+// `numa_node` if not negative, else none, for threads that are not pinned.
+inline Status ResolveCPUAffinity(const int64 numa_node,
+                                 const string& cpu_affinity,
+                                 std::vector<int>* cpus) {
+  cpus->clear();
+  if (!cpu_affinity.empty()) {
+    if (!io::ParseCPUList(cpu_affinity, cpus) || cpus->empty()) {
+      return errors::InvalidArgument("Invalid cpu_affinity: '", cpu_affinity,
+                                     "'");
+    }
+    return OkStatus();
+  }
+  if (numa_node < 0) {
+    return OkStatus();
+  }
+  const int num_nodes = io::NumNUMANodes();
+  if (numa_node >= num_nodes) {
+    return errors::InvalidArgument("numa_node ", numa_node,
+                                   " is out of the ", num_nodes,
+                                   " NUMA nodes of the system");
+  }
+  *cpus = io::NUMANodeCPUs(numa_node);
+  if (cpus->empty()) {
+    LOG(WARNING) << "Cannot read the CPUs of NUMA node " << numa_node
+                 << ", threads are not pinned.";
+  }
+  return OkStatus();
+}
+
+// Pins the calling thread to `cpus`, unless `cpus` is empty.
+inline void PinCurrentThread(const std::vector<int>& cpus) {
+  if (!cpus.empty() && !io::SetCurrentThreadAffinity(cpus)) {
+    LOG(WARNING) << "Cannot pin thread to " << cpus.size() << " CPUs.";
+  }
+}
+
+// Pins all the threads of `thread_pool` to `cpus`. One task is run on each
+// thread at once, and each task waits for the others to start so that no
+// thread runs two of them. The buffers that the tasks later allocate and
+// first touch are thereby placed on the NUMA node of `cpus`.
+inline void PinThreadPool(thread::ThreadPool* thread_pool,
+                          const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+  const int num_threads = thread_pool->NumThreads();
+  BlockingCounter started(num_threads);
+  BlockingCounter pinned(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    thread_pool->Schedule([&cpus, &started, &pinned] {
+      PinCurrentThread(cpus);
+      started.DecrementCount();
+      started.Wait();
+      pinned.DecrementCount();
+    });
+  }
+  pinned.Wait();
+}
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_AVRO_UTILS_CPU_AFFINITY_H_
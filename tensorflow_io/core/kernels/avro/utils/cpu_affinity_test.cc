@@ -0,0 +1,98 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/cpu_affinity.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+// The CPUs first to last, both included.
+std::vector<int> Range(int first, int last) {
+  std::vector<int> cpus;
+  for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+  return cpus;
+}
+}  // namespace
+
+TEST(CPUAffinityTest, PARSE_CPU_LIST) {
+  std::vector<int> cpus;
+  ASSERT_TRUE(io::ParseCPUList("0-7,16-23", &cpus));
+  std::vector<int> expected = Range(0, 7);
+  for (int cpu : Range(16, 23)) expected.push_back(cpu);
+  ASSERT_EQ(expected, cpus);
+
+  ASSERT_TRUE(io::ParseCPUList("3", &cpus));
+  ASSERT_EQ(std::vector<int>({3}), cpus);
+
+  ASSERT_TRUE(io::ParseCPUList("2-2", &cpus));
+  ASSERT_EQ(std::vector<int>({2}), cpus);
+
+  // The sysfs files end with a newline.
+  ASSERT_TRUE(io::ParseCPUList("0-3,8\n", &cpus));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8}), cpus);
+
+  // The cpulist of a NUMA node without CPUs is an empty line.
+  cpus = {1};
+  ASSERT_TRUE(io::ParseCPUList("", &cpus));
+  ASSERT_TRUE(cpus.empty());
+  cpus = {1};
+  ASSERT_TRUE(io::ParseCPUList("\n", &cpus));
+  ASSERT_TRUE(cpus.empty());
+}
+
+TEST(CPUAffinityTest, PARSE_MALFORMED_CPU_LIST) {
+  for (const char* list : {"7-3", "a-b", "a", "3-b", "0-", "-3", "3-",
+                           "1,x", "+3", " 3", "3-+5", "1-2-3", "0x1"}) {
+    std::vector<int> cpus = {1};
+    ASSERT_FALSE(io::ParseCPUList(list, &cpus)) << "'" << list << "'";
+    ASSERT_TRUE(cpus.empty()) << "'" << list << "'";
+  }
+}
+
+TEST(CPUAffinityTest, RESOLVE_CPU_AFFINITY) {
+  std::vector<int> cpus;
+  TF_ASSERT_OK(ResolveCPUAffinity(-1, "0-1,4", &cpus));
+  ASSERT_EQ(std::vector<int>({0, 1, 4}), cpus);
+
+  // The list takes precedence over the NUMA node.
+  TF_ASSERT_OK(ResolveCPUAffinity(1 << 20, "3\n", &cpus));
+  ASSERT_EQ(std::vector<int>({3}), cpus);
+
+  // Neither pins the threads.
+  cpus = {1};
+  TF_ASSERT_OK(ResolveCPUAffinity(-1, "", &cpus));
+  ASSERT_TRUE(cpus.empty());
+
+  for (const char* list : {"7-3", "a-b", ",", "\n"}) {
+    Status status = ResolveCPUAffinity(-1, list, &cpus);
+    ASSERT_TRUE(errors::IsInvalidArgument(status)) << status;
+    ASSERT_TRUE(cpus.empty());
+  }
+
+  Status status = ResolveCPUAffinity(1 << 20, "", &cpus);
+  ASSERT_TRUE(errors::IsInvalidArgument(status)) << status;
+  ASSERT_TRUE(cpus.empty());
+
+  // Node 0 exists on every system, but its CPUs are not known when sysfs
+  // cannot be read, in which case the threads are not pinned.
+  TF_ASSERT_OK(ResolveCPUAffinity(0, "", &cpus));
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -127,5 +127,37 @@ std::string OrderedPrefixTree::ToString() const {
   return root_.get() != nullptr ? (*root_).ToString(0) : "empty tree";
 }
 
+// -------------------------------------------------------------------------------------------------
+// Compact prefix tree
+// -------------------------------------------------------------------------------------------------
+/* static */ constexpr size_t CompactPrefixTree::kRoot;
+/* static */ constexpr size_t CompactPrefixTree::kNotFound;
+
+void CompactPrefixTree::Build(CompactPrefixTree* tree,
+                              const OrderedPrefixTree& ordered,
+                              char separator) {
+  std::vector<Node>& nodes = (*tree).nodes_;
+  nodes.clear();
+  // The nodes of the ordered tree in the same order as the compact nodes
+  std::vector<const PrefixTreeNode*> sources;
+  sources.push_back(ordered.GetRoot().get());
+  nodes.push_back({(*sources[0]).GetPrefix(), "", kNotFound, 0, 0});
+
+  for (size_t index = 0; index < sources.size(); ++index) {
+    const std::vector<PrefixTreeNodeSharedPtr>& children =
+        (*sources[index]).GetChildren();
+    nodes[index].first_child = nodes.size();
+    nodes[index].num_children = children.size();
+    for (const PrefixTreeNodeSharedPtr& child : children) {
+      const std::string& prefix = (*child).GetPrefix();
+      // Exclude the root from the name
+      std::string name =
+          index == kRoot ? prefix : nodes[index].name + separator + prefix;
+      nodes.push_back({prefix, std::move(name), index, 0, 0});
+      sources.push_back(child.get());
+    }
+  }
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -12,6 +12,7 @@ limitations under the License.
 #ifndef TENSORFLOW_DATA_PREFIX_TREE_H_
 #define TENSORFLOW_DATA_PREFIX_TREE_H_
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,8 +31,7 @@ class PrefixTreeNode {
                  PrefixTreeNode* father = nullptr);
 
   // Get the children of this tree node
-  // TODO(fraudies): For better performance convert this into an iterator
-  inline std::vector<PrefixTreeNodeSharedPtr> GetChildren() const {
+  inline const std::vector<PrefixTreeNodeSharedPtr>& GetChildren() const {
     return children_;
   }
 
@@ -101,6 +101,52 @@ class OrderedPrefixTree {
   PrefixTreeNodeSharedPtr root_;
 };
 
+// A read-only copy of an ordered prefix tree in one contiguous array
+// The nodes are stored in breadth first order, which places the children of
+// a node next to each other in insertion order, and their full names are
+// computed once
+class CompactPrefixTree {
+ public:
+  struct Node {
+    // The prefix of this node
+    std::string prefix;
+    // The prefixes from the root to this node joined by the separator,
+    // excluding the root
+    std::string name;
+    // The index of the father, kNotFound for the root
+    size_t father;
+    // The children are the nodes [first_child, first_child + num_children)
+    size_t first_child;
+    size_t num_children;
+  };
+
+  // The index of the root node
+  static constexpr size_t kRoot = 0;
+
+  // The father of the root
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+  // Builds the compact tree for the ordered prefix tree, the names of nodes
+  // are joined with the separator
+  static void Build(CompactPrefixTree* tree, const OrderedPrefixTree& ordered,
+                    char separator);
+
+  // Get the number of nodes including the root
+  inline size_t NumNodes() const { return nodes_.size(); }
+
+  // Get the node for the index
+  inline const Node& GetNode(size_t index) const { return nodes_[index]; }
+
+  // Is terminal if this node has no children
+  inline bool IsTerminal(size_t index) const {
+    return nodes_[index].num_children == 0;
+  }
+
+ private:
+  // All nodes, the root first
+  std::vector<Node> nodes_;
+};
+
 }  // namespace data
 }  // namespace tensorflow
 
@@ -0,0 +1,76 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_io/core/kernels/avro/utils/prefix_tree.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+
+TEST(CompactPrefixTreeTest, BREADTH_FIRST_LAYOUT) {
+  OrderedPrefixTree ordered;
+  OrderedPrefixTree::Build(&ordered, {{"person", "name"},
+                                      {"person", "age"},
+                                      {"id"},
+                                      {"person", "address", "city"}});
+  CompactPrefixTree tree;
+  CompactPrefixTree::Build(&tree, ordered, '.');
+
+  // root, person, id, name, age, address, city
+  ASSERT_EQ(7, tree.NumNodes());
+  const CompactPrefixTree::Node& root = tree.GetNode(CompactPrefixTree::kRoot);
+  ASSERT_EQ(CompactPrefixTree::kNotFound, root.father);
+  ASSERT_EQ("", root.name);
+  ASSERT_EQ(1, root.first_child);
+  ASSERT_EQ(2, root.num_children);
+
+  // The children keep their insertion order.
+  const std::vector<std::pair<std::string, std::string>> expected = {
+      {"person", "person"},
+      {"id", "id"},
+      {"name", "person.name"},
+      {"age", "person.age"},
+      {"address", "person.address"},
+      {"city", "person.address.city"}};
+  for (size_t i = 0; i < expected.size(); i++) {
+    const CompactPrefixTree::Node& node = tree.GetNode(i + 1);
+    ASSERT_EQ(expected[i].first, node.prefix);
+    ASSERT_EQ(expected[i].second, node.name);
+  }
+
+  const CompactPrefixTree::Node& person = tree.GetNode(1);
+  ASSERT_EQ(CompactPrefixTree::kRoot, person.father);
+  ASSERT_EQ(3, person.first_child);
+  ASSERT_EQ(3, person.num_children);
+  ASSERT_FALSE(tree.IsTerminal(1));
+  ASSERT_TRUE(tree.IsTerminal(2));
+  ASSERT_TRUE(tree.IsTerminal(3));
+
+  const CompactPrefixTree::Node& address = tree.GetNode(5);
+  ASSERT_EQ(1, address.father);
+  ASSERT_EQ(6, address.first_child);
+  ASSERT_EQ(1, address.num_children);
+  ASSERT_EQ(5, tree.GetNode(6).father);
+  ASSERT_TRUE(tree.IsTerminal(6));
+}
+
+TEST(CompactPrefixTreeTest, EMPTY_TREE) {
+  OrderedPrefixTree ordered;
+  CompactPrefixTree tree;
+  CompactPrefixTree::Build(&tree, ordered, '.');
+  ASSERT_EQ(1, tree.NumNodes());
+  ASSERT_TRUE(tree.IsTerminal(CompactPrefixTree::kRoot));
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -35,6 +35,12 @@ void ShapeBuilder::FinishMark() {
 
 void ShapeBuilder::Increment() { element_counter_++; }
 
+void ShapeBuilder::Reset() {
+  element_info_.clear();
+  element_counter_ = 0;
+  has_begin_ = false;
+}
+
 // Assumes that the value buffer has correct markers
 size_t ShapeBuilder::GetNumberOfDimensions() const {
   size_t num = 0;
@@ -219,13 +225,16 @@ Status ShapeBuilder::GetFillInfo(
 }
 
 Status ShapeBuilder::GetIndices(Tensor* indices) const {
+  return GetIndices((*indices).flat<int64>().data(), 0);
+}
+
+Status ShapeBuilder::GetIndices(int64* indices_data, int64 row_offset) const {
   size_t i_dim = 0;
   size_t offset = 0;
   size_t n_dim(GetNumberOfDimensions());
   std::vector<int64> counts(
       n_dim + 1, -1);  // initialize -1, create +1 number of dimensions
   auto counts_data = counts.begin();
-  auto indices_data = (*indices).flat<int64>().data();
 
   for (size_t info : element_info_) {
     // Open a group
@@ -244,6 +253,7 @@ Status ShapeBuilder::GetIndices(Tensor* indices) const {
         counts[i_dim] = i_value;
         CopyOrMoveBlock(counts_data + 1, counts_data + n_dim + 1,
                         indices_data + offset);
+        indices_data[offset] += row_offset;
         offset += n_dim;
       }
     }
@@ -13,10 +13,13 @@ limitations under the License.
 #define TENSORFLOW_DATA_VALUE_BUFFER_H_
 
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -26,6 +29,19 @@ namespace data {
 static constexpr size_t kBeginMark = std::numeric_limits<size_t>::max() - 1;
 static constexpr size_t kFinishMark = std::numeric_limits<size_t>::max();
 
+// Is non trivial shape that has >= 1 dimension and any dimension > 1
+inline bool IsNonTrivialShape(const TensorShape& tensor_shape) {
+  VLOG(15) << "Checking if " << tensor_shape << " is non-trivial";
+  // Check that any of the dimensions is > 1
+  for (size_t i_dim = 0; i_dim < tensor_shape.dims(); ++i_dim) {
+    VLOG(15) << "Dimension " << i_dim << " is " << tensor_shape.dim_size(i_dim);
+    if (tensor_shape.dim_size(i_dim) > 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // An abstract representation of a store for values
 // This representation preserves the order in which elements have been added
 // Uses begin and finish marks around elements to infer the full shape of an N-D
@@ -43,10 +59,24 @@ class ValueStore {
   virtual Status MakeDense(Tensor* tensor, const TensorShape& resolved_shape,
                            const Tensor& defaults) const = 0;
 
+  // Make the rows [row_offset, row_offset + rows_shape.dim_size(0)) of a dense
+  // tensor from this value store, where rows_shape is the shape of these rows
+  // Defaults that are not a scalar have the shape of the entire tensor
+  // Assumes the tensor has been initialized and allocated!
+  virtual Status MakeDenseRows(Tensor* tensor, int64 row_offset,
+                               const TensorShape& rows_shape,
+                               const Tensor& defaults) const = 0;
+
   // Make a sparse tensor with values and indices from this value store
   // Assumes the tensor has been initialized and allocated!
   virtual Status MakeSparse(Tensor* values, Tensor* indices) const = 0;
 
+  // Make the values and indices of a sparse tensor from this value store
+  // starting at value_offset, the row of every index is shifted by row_offset
+  // Assumes the tensors have been initialized and allocated!
+  virtual Status MakeSparseAt(Tensor* values, Tensor* indices,
+                              int64 value_offset, int64 row_offset) const = 0;
+
   // Resolve a shape given a partial shape from the user and a shape from the
   // defaults
   // TODO(fraudies): Remove once avro dataset is gone
@@ -73,6 +103,12 @@ class ValueStore {
   // Get the maximum index for each dimension and assign it to the dense_shape
   virtual Status GetDenseShapeForSparse(Tensor* dense_shape) const = 0;
 
+  // Get the maximum index for each dimension as shape
+  virtual void GetDenseShape(TensorShape* shape) const = 0;
+
+  // Get the number of dimensions, including the outer-most batch dimension
+  virtual size_t GetNumberOfDimensions() const = 0;
+
   // Check if values match at the reverse index between this store and the
   // provided one
   virtual bool ValuesMatchAtReverseIndex(const ValueStore& store,
@@ -91,6 +127,10 @@ class ValueStore {
   // Place a finish mark
   virtual void FinishMark() = 0;
 
+  // Remove all values and marks but keep the allocated memory, so that the
+  // store can be reused for the next batch
+  virtual void Reset() = 0;
+
   // Output a human readable string representation with limit number of elements
   virtual string ToString(size_t limit = 10) const = 0;
 };
@@ -112,6 +152,9 @@ class ShapeBuilder {
   // Increment the counter for the elements
   void Increment();
 
+  // Remove all marks and counts but keep the allocated memory
+  void Reset();
+
   // Get the number of dimensions
   size_t GetNumberOfDimensions() const;
 
@@ -132,6 +175,10 @@ class ShapeBuilder {
   // Get the indices as tensor for this shape
   Status GetIndices(Tensor* indices) const;
 
+  // Write the indices for this shape to the given location, shifting the row
+  // of every index by row_offset
+  Status GetIndices(int64* indices, int64 row_offset) const;
+
   // Get a human readable string for this shape builder
   string ToString() const;
 
@@ -169,6 +216,87 @@ class ShapeBuilder {
   bool has_begin_;
 };
 
+// The values of a value buffer in the order they have been added. Clearing
+// keeps the allocated memory, so that a reused buffer does not allocate once
+// it has grown to the size of a batch.
+template <typename T>
+class ValueStorage {
+ public:
+  using Ref = T;
+
+  inline void push_back(T value) { values_.push_back(value); }
+
+  inline size_t size() const { return values_.size(); }
+
+  inline Ref operator[](size_t index) const { return values_[index]; }
+
+  inline void reserve(size_t n) { values_.reserve(n); }
+
+  inline void clear() { values_.clear(); }
+
+  // Append all values of other
+  inline void Append(const ValueStorage& other) {
+    values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+  }
+
+  // Copy the values [begin, end) to target
+  inline void CopyTo(size_t begin, size_t end, T* target) const {
+    std::copy(values_.begin() + begin, values_.begin() + end, target);
+  }
+
+ private:
+  std::vector<T> values_;
+};
+
+// Strings are stored back to back in one byte arena with the end offset of
+// each string, instead of one allocation per string. They are only copied
+// into tstrings when the output tensors are filled.
+template <>
+class ValueStorage<tstring> {
+ public:
+  using Ref = StringPiece;
+
+  inline void push_back(StringPiece value) {
+    bytes_.append(value.data(), value.size());
+    ends_.push_back(bytes_.size());
+  }
+
+  inline size_t size() const { return ends_.size(); }
+
+  inline Ref operator[](size_t index) const {
+    const size_t begin = index == 0 ? 0 : ends_[index - 1];
+    return StringPiece(bytes_.data() + begin, ends_[index] - begin);
+  }
+
+  inline void reserve(size_t n) { ends_.reserve(n); }
+
+  inline void clear() {
+    bytes_.clear();
+    ends_.clear();
+  }
+
+  // Append all values of other
+  inline void Append(const ValueStorage& other) {
+    const size_t offset = bytes_.size();
+    bytes_.append(other.bytes_);
+    for (size_t end : other.ends_) {
+      ends_.push_back(offset + end);
+    }
+  }
+
+  // Copy the values [begin, end) to target
+  inline void CopyTo(size_t begin, size_t end, tstring* target) const {
+    for (size_t index = begin; index < end; ++index) {
+      const StringPiece value = (*this)[index];
+      target[index - begin].assign(value.data(), value.size());
+    }
+  }
+
+ private:
+  std::string bytes_;
+  std::vector<size_t> ends_;
+};
+
 // The value buffer holds the actual values and implements a value store
 template <typename T>
 class ValueBuffer : public ValueStore {
@@ -182,6 +310,11 @@ class ValueBuffer : public ValueStore {
 
   inline void FinishMark() override { shape_builder_.FinishMark(); }
 
+  inline void Reset() override {
+    values_.clear();
+    shape_builder_.Reset();
+  }
+
   // Add a primitive value (e.g. bool, int) to the buffer by copy
   inline void Add(T value) {
     values_.push_back(value);
@@ -194,11 +327,19 @@ class ValueBuffer : public ValueStore {
     shape_builder_.Increment();
   }
 
+  // Add a string value from its bytes, without a temporary string
+  inline void AddBytes(const char* data, size_t size) {
+    values_.push_back(StringPiece(data, size));
+    shape_builder_.Increment();
+  }
+
   // Return the last item in the buffer
-  inline const T back() const { return values_.back(); }
+  inline typename ValueStorage<T>::Ref back() const {
+    return values_[values_.size() - 1];
+  }
 
   // Index in reverse order, index 1 indexes the last element
-  inline const T ReverseIndex(size_t index) const {
+  inline typename ValueStorage<T>::Ref ReverseIndex(size_t index) const {
     return values_[values_.size() - index];
   }
 
@@ -220,11 +361,26 @@ class ValueBuffer : public ValueStore {
 
   Status GetDenseShapeForSparse(Tensor* dense_shape) const override;
 
+  inline void GetDenseShape(TensorShape* shape) const override {
+    shape_builder_.GetDenseShape(shape);
+  }
+
+  inline size_t GetNumberOfDimensions() const override {
+    return shape_builder_.GetNumberOfDimensions();
+  }
+
   Status MakeDense(Tensor* tensor, const TensorShape& resolved_shape,
                    const Tensor& defaults) const override;
 
+  Status MakeDenseRows(Tensor* tensor, int64 row_offset,
+                       const TensorShape& rows_shape,
+                       const Tensor& defaults) const override;
+
   Status MakeSparse(Tensor* values, Tensor* indices) const override;
 
+  Status MakeSparseAt(Tensor* values, Tensor* indices, int64 value_offset,
+                      int64 row_offset) const override;
+
   virtual bool ValuesMatchAtReverseIndex(const ValueStore& store,
                                          size_t reverse_index) const override;
 
@@ -239,11 +395,15 @@ class ValueBuffer : public ValueStore {
   // Returns the number of elements
   inline size_t GetNumberOfElements() const { return values_.size(); }
 
-  // Fill in from the buffer Assumes tensor has been initialized
-  Status FillInFromBuffer(Tensor* tensor) const;
+  // Fill in from the buffer into the tensor data of the given shape
+  // Assumes tensor has been initialized
+  Status FillInFromBuffer(T* tensor_data, const TensorShape& shape) const;
 
+  // Fill in from the defaults into the tensor data of the given shape, where
+  // default_offset is the position of the tensor data in non-scalar defaults
   // Assumes tensor has been initialized
-  Status FillInFromDefault(Tensor* tensor, const Tensor& defaults) const;
+  Status FillInFromDefault(T* tensor_data, const TensorShape& shape,
+                           const Tensor& defaults, int64 default_offset) const;
 
   // Is empty shape for this partial shape
   inline static bool IsEmptyShape(const PartialTensorShape& partial_shape) {
@@ -258,20 +418,11 @@ class ValueBuffer : public ValueStore {
   // Is non trivial tensor that has >= 1 dimension and the dimension(0) > 1
   // value
   inline static bool IsNonTrivialTensor(const TensorShape& tensor_shape) {
-    VLOG(15) << "Checking if " << tensor_shape << " is non-trivial";
-    // Check that any of the dimensions is > 1
-    for (size_t i_dim = 0; i_dim < tensor_shape.dims(); ++i_dim) {
-      VLOG(15) << "Dimension " << i_dim << " is "
-               << tensor_shape.dim_size(i_dim);
-      if (tensor_shape.dim_size(i_dim) > 1) {
-        return true;
-      }
-    }
-    return false;
+    return IsNonTrivialShape(tensor_shape);
   }
 
-  // For up to 4 values use inline memory
-  gtl::InlinedVector<T, 4> values_;
+  // The values of this value buffer
+  ValueStorage<T> values_;
 
   // The shape builder for this value buffer
   ShapeBuilder shape_builder_;
@@ -316,17 +467,12 @@ ValueBuffer<T>::ValueBuffer(const std::vector<ValueStoreUniquePtr>& others) {
     ValueBuffer<T>* buffer = reinterpret_cast<ValueBuffer<T>*>(others[i].get());
     n_total += buffer->values_.size();
   }
-  values_.resize(n_total);
+  values_.reserve(n_total);
   VLOG(5) << "Allocate space for " << n_total << " elements in buffer";
 
-  // Get the target start location
-  auto target = values_.begin();
   for (size_t i = 0; i < others.size(); ++i) {
     ValueBuffer<T>* buffer = reinterpret_cast<ValueBuffer<T>*>(others[i].get());
-    auto begin = buffer->values_.begin();
-    size_t n_elements = buffer->values_.size();
-    CopyOrMoveBlock(begin, begin + n_elements, target);
-    target += n_elements;
+    values_.Append(buffer->values_);
     shape_builder_.Merge(buffer->shape_builder_);
   }
 }
@@ -455,17 +601,33 @@ template <typename T>
 Status ValueBuffer<T>::MakeDense(Tensor* tensor,
                                  const TensorShape& resolved_shape,
                                  const Tensor& defaults) const {
+  return MakeDenseRows(tensor, 0, resolved_shape, defaults);
+}
+
+template <typename T>
+Status ValueBuffer<T>::MakeDenseRows(Tensor* tensor, int64 row_offset,
+                                     const TensorShape& rows_shape,
+                                     const Tensor& defaults) const {
+  // The number of elements in one row of the tensor
+  int64 row_size = 1;
+  for (int i_dim = 1; i_dim < rows_shape.dims(); ++i_dim) {
+    row_size *= rows_shape.dim_size(i_dim);
+  }
+  int64 offset = row_offset * row_size;
+  T* tensor_data = (*tensor).flat<T>().data() + offset;
+
   // Get the dense shape
-  bool doFillFromDefault = !shape_builder_.HasAllElements(resolved_shape);
+  bool doFillFromDefault = !shape_builder_.HasAllElements(rows_shape);
 
   // Check that shape matches, with the dimensions
   if (doFillFromDefault) {
     // fill in the default -- note might fill all values
-    TF_RETURN_IF_ERROR(FillInFromDefault(tensor, defaults));
+    TF_RETURN_IF_ERROR(
+        FillInFromDefault(tensor_data, rows_shape, defaults, offset));
   }
 
   // Fill in the values into the tensor from the buffer
-  TF_RETURN_IF_ERROR(FillInFromBuffer(tensor));
+  TF_RETURN_IF_ERROR(FillInFromBuffer(tensor_data, rows_shape));
 
   return OkStatus();
 }
@@ -475,25 +637,28 @@ Status ValueBuffer<T>::MakeDense(Tensor* tensor,
 // Assumes that indices is pre-allocated with space for n_elements x n_dim
 template <typename T>
 Status ValueBuffer<T>::MakeSparse(Tensor* values, Tensor* indices) const {
+  return MakeSparseAt(values, indices, 0, 0);
+}
+
+template <typename T>
+Status ValueBuffer<T>::MakeSparseAt(Tensor* values, Tensor* indices,
+                                    int64 value_offset,
+                                    int64 row_offset) const {
   // Copy values
-  auto tensor_data = (*values).flat<T>().data();
-  auto buffer_data = values_.begin();
-  size_t n_elements(GetNumberOfElements());
-  CopyOrMoveBlock(buffer_data, buffer_data + n_elements, tensor_data);
+  auto tensor_data = (*values).flat<T>().data() + value_offset;
+  values_.CopyTo(0, GetNumberOfElements(), tensor_data);
 
   // Create indices
-  TF_RETURN_IF_ERROR(shape_builder_.GetIndices(indices));
+  size_t n_dim = shape_builder_.GetNumberOfDimensions();
+  TF_RETURN_IF_ERROR(shape_builder_.GetIndices(
+      (*indices).flat<int64>().data() + value_offset * n_dim, row_offset));
 
   return OkStatus();
 }
 
 template <typename T>
-Status ValueBuffer<T>::FillInFromBuffer(Tensor* tensor) const {
-  TensorShape shape = (*tensor).shape();
-  // shape_builder_.GetDenseShape(&shape); //(*tensor).shape();
-  auto tensor_data = (*tensor).flat<T>().data();
-  auto buffer_data = values_.begin();
-
+Status ValueBuffer<T>::FillInFromBuffer(T* tensor_data,
+                                        const TensorShape& shape) const {
   // These offsets are per fragment of data
   std::vector<std::pair<size_t, size_t> > copy_info;
   TF_RETURN_IF_ERROR(shape_builder_.GetCopyInfo(&copy_info, shape));
@@ -505,9 +670,8 @@ Status ValueBuffer<T>::FillInFromBuffer(Tensor* tensor) const {
     VLOG(3) << "Copy at offset " << source_offset << ": " << length
             << " values to offset " << target_offset;
 
-    CopyOrMoveBlock(buffer_data + source_offset,
-                    buffer_data + source_offset + length,
-                    tensor_data + target_offset);
+    values_.CopyTo(source_offset, source_offset + length,
+                   tensor_data + target_offset);
     source_offset += length;
   }
 
@@ -515,25 +679,22 @@ Status ValueBuffer<T>::FillInFromBuffer(Tensor* tensor) const {
 }
 
 template <typename T>
-Status ValueBuffer<T>::FillInFromDefault(Tensor* tensor,
-                                         const Tensor& defaults) const {
+Status ValueBuffer<T>::FillInFromDefault(T* tensor_data,
+                                         const TensorShape& shape,
+                                         const Tensor& defaults,
+                                         int64 default_offset) const {
   // Don't have any default values
   if (!defaults.IsInitialized()) {
     return errors::InvalidArgument(
         "Need to provide a 'defaults' tensor with values");
   }
 
-  TensorShape shape = (*tensor).shape();
-  // TensorShape shape;
-  // shape_builder_.GetDenseShape(&shape); //(*tensor).shape();
-  auto tensor_data = (*tensor).flat<T>().data();
-  auto buffer_data = defaults.flat<T>().data();
-
   // Defaults is a scalar or one element tensor that need to be initialized
   if (IsOneElementTensor(defaults.shape()) || IsEmptyShape(defaults.shape())) {
     std::fill(tensor_data, tensor_data + shape.num_elements(),
               defaults.flat<T>()(0));
   } else {
+    auto buffer_data = defaults.flat<T>().data() + default_offset;
     std::vector<std::pair<size_t, size_t> > fill_info;
     TF_RETURN_IF_ERROR(shape_builder_.GetFillInfo(&fill_info, shape));
     for (const auto& info : fill_info) {
@@ -575,7 +736,7 @@ inline bool ValueBuffer<tstring>::ValueMatchesAtReverseIndex(
   if (IsEmpty()) {
     return false;
   }
-  return ReverseIndex(reverse_index) == value;
+  return ReverseIndex(reverse_index) == StringPiece(value.data(), value.size());
 }
 
 template <typename T>
@@ -13,13 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
 #include "api/Compiler.hh"
 #include "api/DataFile.hh"
 #include "api/Generic.hh"
 #include "api/Stream.hh"
 #include "api/Validator.hh"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_block_index.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
+#include "tensorflow_io/core/kernels/io_readable_dataset.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
 namespace tensorflow {
@@ -29,12 +36,21 @@ namespace {
 static const size_t kAvroInputStreamBufferSize = 8192;
 class AvroInputStream : public avro::SeekableInputStream {
  public:
-  AvroInputStream(tensorflow::RandomAccessFile* file) : file_(file) {}
+  AvroInputStream(SizedRandomAccessFile* file) : file_(file) {}
   virtual ~AvroInputStream() {}
   bool next(const uint8_t** data, size_t* len) override {
     if (*len == 0) {
       *len = kAvroInputStreamBufferSize;
     }
+    // In memory data is handed to the decoder in place.
+    if (file_->SupportsZeroCopy()) {
+      StringPiece result;
+      file_->ReadZeroCopy(byte_count_, *len, &result).IgnoreError();
+      *data = reinterpret_cast<const uint8_t*>(result.data());
+      *len = result.size();
+      byte_count_ += *len;
+      return (*len != 0);
+    }
     if (buffer_.size() < *len) {
       buffer_.resize(*len);
     }
@@ -51,7 +67,7 @@ class AvroInputStream : public avro::SeekableInputStream {
   size_t byteCount() const override { return byte_count_; }
 
  private:
-  tensorflow::RandomAccessFile* file_;
+  SizedRandomAccessFile* file_;
   string buffer_;
   uint64 byte_count_ = 0;
 };
@@ -317,9 +333,12 @@ class AvroReadable : public IOReadableInterface {
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
 
     string schema;
+    string block_index;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("schema: ") == 0) {
         schema = metadata[i].substr(8);
+      } else if (metadata[i].find("block_index: ") == 0) {
+        block_index = metadata[i].substr(13);
       }
     }
 
@@ -379,28 +398,24 @@ class AvroReadable : public IOReadableInterface {
     reader_.reset(new avro::DataFileReader<avro::GenericDatum>(
         std::move(reader_stream_), reader_schema_));
 
-    avro::DecoderPtr decoder = avro::binaryDecoder();
+    // The block offsets come from the sidecar index if one is given and are
+    // read from the block headers otherwise, in parallel over byte ranges of
+    // large files, instead of decoding the whole file.
+    AvroBlockIndex index;
+    if (!block_index.empty()) {
+      TF_RETURN_IF_ERROR(AvroBlockIndex::Load(env_, block_index, &index));
+    } else {
+      TF_RETURN_IF_ERROR(AvroBlockIndex::Build(
+          file_.get(), static_cast<int64>(file_size_),
+          kAvroInputStreamBufferSize, port::MaxParallelism(),
+          kIndexRangeBytes, IndexThreads(), &index));
+    }
 
     int64 total = 0;
-
-    reader_->sync(0);
-    int64 offset = reader_->previousSync();
-    while (offset < file_size_) {
-      StringPiece result;
-      string buffer(16, 0x00);
-      TF_RETURN_IF_ERROR(
-          file_->Read(offset, buffer.size(), &result, &buffer[0]));
-      std::unique_ptr<avro::InputStream> in =
-          avro::memoryInputStream((const uint8_t*)result.data(), result.size());
-      decoder->init(*in);
-      long items = decoder->decodeLong();
-
-      total += static_cast<int64>(items);
+    for (const AvroBlockIndex::Block& block : index.blocks()) {
+      total += block.num_records;
       positions_.emplace_back(
-          std::pair<int64, int64>(static_cast<int64>(items), offset));
-
-      reader_->sync(offset);
-      offset = reader_->previousSync();
+          std::pair<int64, int64>(block.num_records, block.offset));
     }
 
     for (size_t i = 0; i < columns_.size(); i++) {
@@ -438,107 +453,52 @@ class AvroReadable : public IOReadableInterface {
 
   Status Read(const int64 start, const int64 stop, const string& component,
               int64* record_read, Tensor* value, Tensor* label) override {
-    if (columns_index_.find(component) == columns_index_.end()) {
-      return errors::InvalidArgument("component ", component, " is invalid");
-    }
-    int64 column_index = columns_index_[component];
+    return ReadComponents(start, stop, {component}, record_read, {value});
+  }
+
+  // Fills all the components from each record as it is visited, so that
+  // a block is looked up and walked once for all of them, rather than once
+  // per column, which would also decode it again for every column once the
+  // range spans more blocks than the cache holds.
+  Status ReadComponents(const int64 start, const int64 stop,
+                        const std::vector<string>& components,
+                        int64* record_read,
+                        const std::vector<Tensor*>& values) override {
     (*record_read) = 0;
-    if (start >= shapes_[column_index].dim_size(0)) {
-      return OkStatus();
-    }
-    const string& column = component;
-    int64 element_start = start < shapes_[column_index].dim_size(0)
-                              ? start
-                              : shapes_[column_index].dim_size(0);
-    int64 element_stop = stop < shapes_[column_index].dim_size(0)
-                             ? stop
-                             : shapes_[column_index].dim_size(0);
-
-    if (element_start > element_stop) {
-      return errors::InvalidArgument("dataset ", column,
-                                     " selection is out of boundary");
+    int64 element_stop = stop;
+    for (const string& component : components) {
+      if (columns_index_.find(component) == columns_index_.end()) {
+        return errors::InvalidArgument("component ", component, " is invalid");
+      }
+      int64 column_index = columns_index_[component];
+      element_stop = std::min(element_stop, shapes_[column_index].dim_size(0));
     }
-    if (element_start == element_stop) {
+    if (components.empty() || start >= element_stop) {
       return OkStatus();
     }
+    int64 element_start = start;
 
-    avro::GenericDatum datum(reader_schema_);
-
-    // Find the start sync point
+    mutex_lock l(mu_);
+    // Visit the blocks that overlap [element_start, element_stop).
     int64 item_index_sync = 0;
-    for (size_t i = 0; i < positions_.size();
-         i++, item_index_sync += positions_[i].first) {
-      if (item_index_sync >= element_stop) {
-        continue;
-      }
+    for (size_t i = 0; i < positions_.size() && item_index_sync < element_stop;
+         item_index_sync += positions_[i].first, i++) {
       if (item_index_sync + positions_[i].first <= element_start) {
         continue;
       }
-      // TODO: Avro is sync point partitioned and each block is very similiar to
-      // Row Group of parquet. Ideally each block should be cached with the hope
-      // that slicing and indexing will happend around the same block across
-      // multiple rows. Caching is not done yet.
-
-      // Seek to sync
-      reader_->seek(positions_[i].second);
-      for (int64 item_index = item_index_sync;
-           item_index < (item_index_sync + positions_[i].first) &&
-           item_index < element_stop;
+      std::shared_ptr<const std::vector<avro::GenericDatum>> records;
+      TF_RETURN_IF_ERROR(ReadBlock(i, &records));
+      int64 block_start = std::max(element_start, item_index_sync);
+      int64 block_stop =
+          std::min(element_stop, item_index_sync + positions_[i].first);
+      for (int64 item_index = block_start; item_index < block_stop;
            item_index++) {
-        // Read anyway
-        if (!reader_->read(datum)) {
-          return errors::Internal("unable to read record at: ", item_index);
-        }
-        // Assign only when in range
-        if (item_index >= element_start) {
-          const avro::GenericRecord& record =
-              datum.value<avro::GenericRecord>();
-          const avro::GenericDatum& field = record.field(column);
-          switch (field.type()) {
-            case avro::AVRO_BOOL:
-              value->flat<bool>()(item_index - element_start) =
-                  field.value<bool>();
-              break;
-            case avro::AVRO_INT:
-              value->flat<int32>()(item_index - element_start) =
-                  field.value<int32_t>();
-              break;
-            case avro::AVRO_LONG:
-              value->flat<int64>()(item_index - element_start) =
-                  field.value<int64_t>();
-              break;
-            case avro::AVRO_FLOAT:
-              value->flat<float>()(item_index - element_start) =
-                  field.value<float>();
-              break;
-            case avro::AVRO_DOUBLE:
-              value->flat<double>()(item_index - element_start) =
-                  field.value<double>();
-              break;
-            case avro::AVRO_STRING:
-              value->flat<tstring>()(item_index - element_start) =
-                  field.value<string>();
-              break;
-            case avro::AVRO_BYTES: {
-              const std::vector<uint8_t>& field_value =
-                  field.value<std::vector<uint8_t>>();
-              value->flat<tstring>()(item_index - element_start) =
-                  string((char*)&field_value[0], field_value.size());
-            } break;
-            case avro::AVRO_FIXED: {
-              const std::vector<uint8_t>& field_value =
-                  field.value<avro::GenericFixed>().value();
-              value->flat<tstring>()(item_index - element_start) =
-                  string((char*)&field_value[0], field_value.size());
-            } break;
-            case avro::AVRO_ENUM:
-              value->flat<tstring>()(item_index - element_start) =
-                  field.value<avro::GenericEnum>().symbol();
-              break;
-            default:
-              return errors::InvalidArgument("unsupported data type: ",
-                                             field.type());
-          }
+        const avro::GenericDatum& datum =
+            (*records)[item_index - item_index_sync];
+        const avro::GenericRecord& record = datum.value<avro::GenericRecord>();
+        for (size_t c = 0; c < components.size(); c++) {
+          TF_RETURN_IF_ERROR(FillField(record.field(components[c]),
+                                       item_index - element_start, values[c]));
         }
       }
     }
@@ -552,6 +512,98 @@ class AvroReadable : public IOReadableInterface {
   }
 
  private:
+  // The fewest bytes that a range of the parallel block index scan holds.
+  static constexpr int64 kIndexRangeBytes = 64 << 20;
+
+  static thread::ThreadPool* IndexThreads() {
+    static thread::ThreadPool* threads = new thread::ThreadPool(
+        Env::Default(), "avro_block_index", port::MaxParallelism());
+    return threads;
+  }
+
+  // Stores the value of a field into element `index` of `value`.
+  Status FillField(const avro::GenericDatum& field, const int64 index,
+                   Tensor* value) {
+    switch (field.type()) {
+      case avro::AVRO_BOOL:
+        value->flat<bool>()(index) = field.value<bool>();
+        break;
+      case avro::AVRO_INT:
+        value->flat<int32>()(index) = field.value<int32_t>();
+        break;
+      case avro::AVRO_LONG:
+        value->flat<int64>()(index) = field.value<int64_t>();
+        break;
+      case avro::AVRO_FLOAT:
+        value->flat<float>()(index) = field.value<float>();
+        break;
+      case avro::AVRO_DOUBLE:
+        value->flat<double>()(index) = field.value<double>();
+        break;
+      case avro::AVRO_STRING:
+        value->flat<tstring>()(index) = field.value<string>();
+        break;
+      case avro::AVRO_BYTES: {
+        const std::vector<uint8_t>& field_value =
+            field.value<std::vector<uint8_t>>();
+        value->flat<tstring>()(index) =
+            string((char*)&field_value[0], field_value.size());
+      } break;
+      case avro::AVRO_FIXED: {
+        const std::vector<uint8_t>& field_value =
+            field.value<avro::GenericFixed>().value();
+        value->flat<tstring>()(index) =
+            string((char*)&field_value[0], field_value.size());
+      } break;
+      case avro::AVRO_ENUM:
+        value->flat<tstring>()(index) =
+            field.value<avro::GenericEnum>().symbol();
+        break;
+      default:
+        return errors::InvalidArgument("unsupported data type: ",
+                                       field.type());
+    }
+    return OkStatus();
+  }
+
+  // Returns the decoded records of block `block`. Avro is sync point
+  // partitioned and each block is very similar to a row group of parquet.
+  // Reading the columns of an IOTensor, and slicing and indexing, hit the
+  // same blocks repeatedly, so the recently decoded blocks are kept in a
+  // LRU cache shared by all components.
+  Status ReadBlock(size_t block,
+                   std::shared_ptr<const std::vector<avro::GenericDatum>>*
+                       records) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto lookup = block_cache_.find(block);
+    if (lookup != block_cache_.end()) {
+      block_lru_.splice(block_lru_.begin(), block_lru_, lookup->second.second);
+      *records = lookup->second.first;
+      return OkStatus();
+    }
+
+    auto decoded = std::make_shared<std::vector<avro::GenericDatum>>();
+    decoded->reserve(positions_[block].first);
+    reader_->seek(positions_[block].second);
+    for (int64 i = 0; i < positions_[block].first; i++) {
+      decoded->emplace_back(reader_schema_);
+      if (!reader_->read(decoded->back())) {
+        return errors::Internal("unable to read record ", i, " of block ",
+                                block);
+      }
+    }
+
+    if (block_cache_.size() >= kMaxCachedBlocks) {
+      block_cache_.erase(block_lru_.back());
+      block_lru_.pop_back();
+    }
+    block_lru_.push_front(block);
+    block_cache_[block] = std::make_pair(decoded, block_lru_.begin());
+    *records = std::move(decoded);
+    return OkStatus();
+  }
+
+  static constexpr size_t kMaxCachedBlocks = 16;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -560,6 +612,12 @@ class AvroReadable : public IOReadableInterface {
   std::unique_ptr<avro::InputStream> reader_stream_;
   std::unique_ptr<avro::DataFileReader<avro::GenericDatum>> reader_;
   std::vector<std::pair<int64, int64>> positions_;  // <items/sync> pair
+  // Most recently used blocks first.
+  std::list<size_t> block_lru_ TF_GUARDED_BY(mu_);
+  std::unordered_map<
+      size_t, std::pair<std::shared_ptr<const std::vector<avro::GenericDatum>>,
+                        std::list<size_t>::iterator>>
+      block_cache_ TF_GUARDED_BY(mu_);
 
   std::vector<DataType> dtypes_;
   std::vector<TensorShape> shapes_;
@@ -568,13 +626,19 @@ class AvroReadable : public IOReadableInterface {
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>AvroReadableInit").Device(DEVICE_CPU),
-                        IOInterfaceInitOp<AvroReadable>);
+                        IOInterfaceInitOp<IOReadableReadAhead<AvroReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>AvroReadableSpec").Device(DEVICE_CPU),
-                        IOInterfaceSpecOp<AvroReadable>);
-REGISTER_KERNEL_BUILDER(Name("IO>AvroReadablePartitions").Device(DEVICE_CPU),
-                        IOReadablePartitionsOp<AvroReadable>);
+                        IOInterfaceSpecOp<IOReadableReadAhead<AvroReadable>>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>AvroReadablePartitions").Device(DEVICE_CPU),
+    IOReadablePartitionsOp<IOReadableReadAhead<AvroReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>AvroReadableRead").Device(DEVICE_CPU),
-                        IOReadableReadOp<AvroReadable>);
+                        IOReadableReadOp<IOReadableReadAhead<AvroReadable>>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>AvroReadableReadComponents").Device(DEVICE_CPU),
+    IOReadableReadComponentsOp<IOReadableReadAhead<AvroReadable>>);
+REGISTER_KERNEL_BUILDER(Name("IO>AvroReadableDataset").Device(DEVICE_CPU),
+                        IOReadableDatasetOp<IOReadableReadAhead<AvroReadable>>);
 
 }  // namespace data
 }  // namespace tensorflow
@@ -33,9 +33,15 @@ class BigQueryDatasetOp : public DatasetOpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &output_types_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("default_values", &default_values_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("offset", &offset_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("batch_size", &batch_size_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_parallel_streams",
+                                     &num_parallel_streams_));
     string data_format_str;
     OP_REQUIRES_OK(ctx, ctx->GetAttr("data_format", &data_format_str));
     OP_REQUIRES_OK(ctx, GetDataFormat(data_format_str, &data_format_));
+    string api_version;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("api_version", &api_version));
+    use_v1_ = api_version == "v1";
   }
   using DatasetOpKernel::DatasetOpKernel;
 
@@ -44,8 +50,20 @@ class BigQueryDatasetOp : public DatasetOpKernel {
   }
 
   void MakeDataset(OpKernelContext *ctx, DatasetBase **output) override {
-    tstring stream;
-    OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, "stream", &stream));
+    // Several streams are read concurrently by one iterator.
+    const Tensor *stream_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("stream", &stream_tensor));
+    OP_REQUIRES(ctx, stream_tensor->dims() <= 1,
+                errors::InvalidArgument("stream must be a scalar or a vector"));
+    std::vector<string> streams;
+    for (int64 i = 0; i < stream_tensor->NumElements(); i++) {
+      streams.push_back(stream_tensor->flat<tstring>()(i));
+    }
+    OP_REQUIRES(ctx, !streams.empty(),
+                errors::InvalidArgument("stream must be non-empty"));
+    OP_REQUIRES(ctx, streams.size() == 1 || offset_ == 0,
+                errors::InvalidArgument(
+                    "offset is only supported when reading one stream"));
     tstring schema;
     OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, "schema", &schema));
     OP_REQUIRES(ctx, !schema.empty(),
@@ -62,7 +80,9 @@ class BigQueryDatasetOp : public DatasetOpKernel {
     output_types_vector.reserve(num_outputs);
     typed_default_values_.reserve(num_outputs);
     for (uint64 i = 0; i < num_outputs; ++i) {
-      output_shapes.push_back({});
+      // Batches of rows are emitted as columns of up to batch_size_ rows.
+      output_shapes.push_back(batch_size_ > 0 ? PartialTensorShape({-1})
+                                              : PartialTensorShape({}));
       output_types_vector.push_back(output_types_[i]);
       const DataType &output_type = output_types_[i];
       const string &default_value = default_values_[i];
@@ -97,9 +117,10 @@ class BigQueryDatasetOp : public DatasetOpKernel {
     }
 
     *output = new Dataset(ctx, client_resource, output_types_vector,
-                          std::move(output_shapes), std::move(stream),
+                          std::move(output_shapes), std::move(streams),
                           std::move(schema), selected_fields_, output_types_,
-                          typed_default_values_, offset_, data_format_);
+                          typed_default_values_, offset_, batch_size_,
+                          num_parallel_streams_, data_format_, use_v1_);
   }
 
  private:
@@ -108,7 +129,10 @@ class BigQueryDatasetOp : public DatasetOpKernel {
   std::vector<string> default_values_;
   std::vector<absl::any> typed_default_values_;
   int64 offset_;
+  int64 batch_size_;
+  int64 num_parallel_streams_;
   apiv1beta1::DataFormat data_format_;
+  bool use_v1_;
 
   class Dataset : public DatasetBase {
    public:
@@ -116,22 +140,26 @@ class BigQueryDatasetOp : public DatasetOpKernel {
                      tensorflow::BigQueryClientResource *client_resource,
                      const DataTypeVector &output_types_vector,
                      std::vector<PartialTensorShape> output_shapes,
-                     string stream, string schema,
+                     std::vector<string> streams, string schema,
                      std::vector<string> selected_fields,
                      std::vector<DataType> output_types,
                      std::vector<absl::any> typed_default_values, int64 offset_,
-                     apiv1beta1::DataFormat data_format)
+                     int64 batch_size, int64 num_parallel_streams,
+                     apiv1beta1::DataFormat data_format, bool use_v1)
         : DatasetBase(DatasetContext(ctx)),
           client_resource_(client_resource),
           output_types_vector_(output_types_vector),
           output_shapes_(std::move(output_shapes)),
-          stream_(stream),
+          streams_(std::move(streams)),
           selected_fields_(selected_fields),
           output_types_(output_types),
           typed_default_values_(typed_default_values),
           offset_(offset_),
+          batch_size_(batch_size),
+          num_parallel_streams_(num_parallel_streams),
           avro_schema_(absl::make_unique<avro::ValidSchema>()),
-          data_format_(data_format) {
+          data_format_(data_format),
+          use_v1_(use_v1) {
       client_resource_->Ref();
 
       if (data_format == apiv1beta1::DataFormat::AVRO) {
@@ -180,7 +208,13 @@ class BigQueryDatasetOp : public DatasetOpKernel {
       return output_shapes_;
     }
 
-    const string &stream() const { return stream_; }
+    const string &stream() const { return streams_[0]; }
+
+    const std::vector<string> &streams() const { return streams_; }
+
+    // The number of streams read at a time when reading several, all of
+    // them if not positive.
+    const int64 num_parallel_streams() const { return num_parallel_streams_; }
 
     const std::vector<string> &selected_fields() const {
       return selected_fields_;
@@ -202,6 +236,14 @@ class BigQueryDatasetOp : public DatasetOpKernel {
 
     const int64 offset() const { return offset_; }
 
+    // Whether streams are read with the v1 Storage Read API rather than
+    // v1beta1.
+    bool use_v1() const { return use_v1_; }
+
+    // The maximum number of rows of an element, rows of different record
+    // batches are never combined. 0 emits one row per element.
+    const int64 batch_size() const { return batch_size_; }
+
     string DebugString() const override { return "BigQueryDatasetOp::Dataset"; }
 
     Status CheckExternalState() const override { return OkStatus(); }
@@ -222,14 +264,17 @@ class BigQueryDatasetOp : public DatasetOpKernel {
     tensorflow::BigQueryClientResource *client_resource_;
     const DataTypeVector output_types_vector_;
     const std::vector<PartialTensorShape> output_shapes_;
-    const string stream_;
+    const std::vector<string> streams_;
     const std::vector<string> selected_fields_;
     const std::vector<DataType> output_types_;
     const std::vector<absl::any> typed_default_values_;
     const std::unique_ptr<avro::ValidSchema> avro_schema_;
     const int64 offset_;
+    const int64 batch_size_;
+    const int64 num_parallel_streams_;
     std::shared_ptr<::arrow::Schema> arrow_schema_;
     const apiv1beta1::DataFormat data_format_;
+    const bool use_v1_;
   };
 };
 
@@ -20,6 +20,7 @@ namespace tensorflow {
 namespace {
 
 namespace apiv1beta1 = ::google::cloud::bigquery::storage::v1beta1;
+namespace apiv1 = ::google::cloud::bigquery::storage::v1;
 
 class BigQueryClientOp : public OpKernel {
  public:
@@ -93,6 +94,23 @@ class BigQueryReadSessionOp : public OpKernel {
     string data_format_str;
     OP_REQUIRES_OK(ctx, ctx->GetAttr("data_format", &data_format_str));
     OP_REQUIRES_OK(ctx, GetDataFormat(data_format_str, &data_format_));
+
+    string api_version;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("api_version", &api_version));
+    use_v1_ = api_version == "v1";
+    string arrow_compression_str;
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("arrow_compression", &arrow_compression_str));
+    OP_REQUIRES_OK(ctx, GetArrowCompression(arrow_compression_str,
+                                            &arrow_compression_));
+    OP_REQUIRES(ctx,
+                arrow_compression_str.empty() ||
+                    (use_v1_ && data_format_ == apiv1beta1::DataFormat::ARROW),
+                errors::InvalidArgument("arrow_compression requires the v1 "
+                                        "api_version and the ARROW format"));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("max_stream_count", &max_stream_count_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("preferred_min_stream_count",
+                                     &preferred_min_stream_count_));
   }
 
   void Compute(OpKernelContext* ctx) override TF_LOCKS_EXCLUDED(mu_) {
@@ -105,6 +123,11 @@ class BigQueryReadSessionOp : public OpKernel {
         ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &client_resource));
     core::ScopedUnref scoped_unref(client_resource);
 
+    if (use_v1_) {
+      ComputeV1(ctx, client_resource);
+      return;
+    }
+
     apiv1beta1::CreateReadSessionRequest createReadSessionRequest;
     createReadSessionRequest.mutable_table_reference()->set_project_id(
         project_id_);
@@ -143,37 +166,94 @@ class BigQueryReadSessionOp : public OpKernel {
       return;
     }
     VLOG(3) << "readSession response:" << readSessionResponse->DebugString();
+    OutputReadSession(ctx, *readSessionResponse);
+  }
+
+ private:
+  // Creates the session with the v1 Storage Read API, which, unlike
+  // v1beta1, can compress the buffers of Arrow record batches.
+  void ComputeV1(OpKernelContext* ctx, BigQueryClientResource* client_resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    apiv1::BigQueryRead::Stub* stub = client_resource->GetV1Stub("");
+    OP_REQUIRES(ctx, stub != nullptr,
+                errors::Unimplemented(
+                    "The BigQuery client does not support the v1 API"));
+    const string table =
+        strings::StrCat("projects/", project_id_, "/datasets/", dataset_id_,
+                        "/tables/", table_id_);
+    apiv1::CreateReadSessionRequest request;
+    request.set_parent(parent_);
+    apiv1::ReadSession* read_session = request.mutable_read_session();
+    read_session->set_table(table);
+    read_session->set_data_format(data_format_ ==
+                                          apiv1beta1::DataFormat::ARROW
+                                      ? apiv1::DataFormat::ARROW
+                                      : apiv1::DataFormat::AVRO);
+    apiv1::ReadSession::TableReadOptions* read_options =
+        read_session->mutable_read_options();
+    *read_options->mutable_selected_fields() = {selected_fields_.begin(),
+                                                selected_fields_.end()};
+    read_options->set_row_restriction(row_restriction_);
+    if (data_format_ == apiv1beta1::DataFormat::ARROW) {
+      read_options->mutable_arrow_serialization_options()
+          ->set_buffer_compression(arrow_compression_);
+    }
+    request.set_max_stream_count(
+        max_stream_count_ > 0 ? max_stream_count_ : requested_streams_);
+    request.set_preferred_min_stream_count(preferred_min_stream_count_);
+    VLOG(3) << "createReadSessionRequest: " << request.DebugString();
+    ::grpc::ClientContext context;
+    context.AddMetadata("x-goog-request-params",
+                        strings::StrCat("read_session.table=", table));
+    context.set_deadline(gpr_time_add(gpr_now(GPR_CLOCK_REALTIME),
+                                      gpr_time_from_seconds(60, GPR_TIMESPAN)));
+
+    apiv1::ReadSession response;
+    VLOG(3) << "calling readSession";
+    ::grpc::Status status =
+        stub->CreateReadSession(&context, request, &response);
+    if (!status.ok()) {
+      VLOG(3) << "readSession status:" << GrpcStatusToString(status);
+      ctx->CtxFailure(GrpcStatusToTfStatus(status));
+      return;
+    }
+    VLOG(3) << "readSession response:" << response.DebugString();
+    OutputReadSession(ctx, response);
+  }
 
+  // Outputs the stream names and the schema of a v1beta1 or v1 session.
+  template <typename Session>
+  void OutputReadSession(OpKernelContext* ctx,
+                         const Session& readSessionResponse) {
     Tensor* streams_t = nullptr;
     OP_REQUIRES_OK(
         ctx, ctx->allocate_output(
-                 "streams", {readSessionResponse->streams_size()}, &streams_t));
+                 "streams", {readSessionResponse.streams_size()}, &streams_t));
     auto streams_vec = streams_t->vec<tstring>();
-    for (int i = 0; i < readSessionResponse->streams_size(); i++) {
-      streams_vec(i) = readSessionResponse->streams(i).name();
+    for (int i = 0; i < readSessionResponse.streams_size(); i++) {
+      streams_vec(i) = readSessionResponse.streams(i).name();
     }
     Tensor* schema_t = nullptr;
     OP_REQUIRES_OK(ctx, ctx->allocate_output("schema", {}, &schema_t));
 
     if (data_format_ == apiv1beta1::DataFormat::AVRO) {
-      OP_REQUIRES(ctx, readSessionResponse->has_avro_schema(),
+      OP_REQUIRES(ctx, readSessionResponse.has_avro_schema(),
                   errors::InvalidArgument("AVRO schema is missing"));
-      VLOG(3) << "avro schema:" << readSessionResponse->avro_schema().schema();
+      VLOG(3) << "avro schema:" << readSessionResponse.avro_schema().schema();
       schema_t->scalar<tstring>()() =
-          readSessionResponse->avro_schema().schema();
+          readSessionResponse.avro_schema().schema();
     } else if (data_format_ == apiv1beta1::DataFormat::ARROW) {
-      OP_REQUIRES(ctx, readSessionResponse->has_arrow_schema(),
+      OP_REQUIRES(ctx, readSessionResponse.has_arrow_schema(),
                   errors::InvalidArgument("ARROW schema is missing"));
       VLOG(3) << "arrow schema:"
-              << readSessionResponse->arrow_schema().serialized_schema();
+              << readSessionResponse.arrow_schema().serialized_schema();
       schema_t->scalar<tstring>()() =
-          readSessionResponse->arrow_schema().serialized_schema();
+          readSessionResponse.arrow_schema().serialized_schema();
     } else {
       ctx->CtxFailure(errors::InvalidArgument("Invalid data_format"));
     }
   }
 
- private:
   // Note: these fields are const after construction.
   string parent_;
   string project_id_;
@@ -184,6 +264,10 @@ class BigQueryReadSessionOp : public OpKernel {
   string row_restriction_;
   int requested_streams_;
   apiv1beta1::DataFormat data_format_;
+  bool use_v1_;
+  apiv1::ArrowSerializationOptions::CompressionCodec arrow_compression_;
+  int max_stream_count_;
+  int preferred_min_stream_count_;
 
   mutex mu_;
   ContainerInfo cinfo_ TF_GUARDED_BY(mu_);
@@ -89,4 +89,560 @@ Status GetDataFormat(string data_format_str,
   return OkStatus();
 }
 
+Status GetArrowCompression(
+    const string& compression_str,
+    apiv1::ArrowSerializationOptions::CompressionCodec* compression) {
+  if (compression_str.empty()) {
+    *compression = apiv1::ArrowSerializationOptions::COMPRESSION_UNSPECIFIED;
+  } else if (compression_str == "LZ4_FRAME") {
+    *compression = apiv1::ArrowSerializationOptions::LZ4_FRAME;
+  } else if (compression_str == "ZSTD") {
+    *compression = apiv1::ArrowSerializationOptions::ZSTD;
+  } else {
+    return errors::InvalidArgument("Unsupported Arrow compression: ",
+                                   compression_str);
+  }
+  return OkStatus();
+}
+
+BigQueryRowsReader::BigQueryRowsReader(BigQueryClientResource* client_resource,
+                                       bool use_v1, const string& stream,
+                                       int64 offset) {
+  // The deadline is for the entire ReadRows (not a single message receipt),
+  // so for larger data sizes it could take many hours to complete.
+  context_.set_deadline(std::chrono::system_clock::now() +
+                        std::chrono::hours(24));
+  if (use_v1) {
+    apiv1::BigQueryRead::Stub* stub = client_resource->GetV1Stub(stream);
+    if (stub == nullptr) {
+      status_ = ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED,
+                               "The client does not support the v1 API");
+      return;
+    }
+    apiv1::ReadRowsRequest request;
+    request.set_read_stream(stream);
+    request.set_offset(offset);
+    context_.AddMetadata("x-goog-request-params",
+                         absl::StrCat("read_stream=", stream));
+    v1_reader_ = stub->ReadRows(&context_, request);
+  } else {
+    apiv1beta1::ReadRowsRequest request;
+    request.mutable_read_position()->mutable_stream()->set_name(stream);
+    request.mutable_read_position()->set_offset(offset);
+    context_.AddMetadata("x-goog-request-params",
+                         absl::StrCat("read_position.stream.name=", stream));
+    reader_ = client_resource->GetStub(stream)->ReadRows(&context_, request);
+  }
+}
+
+bool BigQueryRowsReader::Read(apiv1beta1::ReadRowsResponse* response) {
+  if (reader_) {
+    return reader_->Read(response);
+  }
+  if (!v1_reader_ || !v1_reader_->Read(&v1_response_)) {
+    return false;
+  }
+  response->Clear();
+  const int64 row_count = v1_response_.row_count();
+  if (v1_response_.has_arrow_record_batch()) {
+    auto* batch = response->mutable_arrow_record_batch();
+    batch->mutable_serialized_record_batch()->swap(
+        *v1_response_.mutable_arrow_record_batch()
+             ->mutable_serialized_record_batch());
+    batch->set_row_count(row_count);
+  } else if (v1_response_.has_avro_rows()) {
+    auto* rows = response->mutable_avro_rows();
+    rows->mutable_serialized_binary_rows()->swap(
+        *v1_response_.mutable_avro_rows()->mutable_serialized_binary_rows());
+    rows->set_row_count(row_count);
+  }
+  // Streams of the v1 API can be split at any point before their end.
+  response->mutable_status()->set_fraction_consumed(
+      v1_response_.stats().progress().at_response_end());
+  response->mutable_status()->set_is_splittable(true);
+  return true;
+}
+
+::grpc::Status BigQueryRowsReader::Finish() {
+  if (reader_) {
+    return reader_->Finish();
+  }
+  if (v1_reader_) {
+    return v1_reader_->Finish();
+  }
+  return status_;
+}
+
+Status DecodeArrowRecordBatch(const std::shared_ptr<arrow::Schema>& schema,
+                              apiv1beta1::ReadRowsResponse* response,
+                              std::shared_ptr<arrow::RecordBatch>* batch) {
+  auto buffer = arrow::Buffer::FromString(
+      std::move(*response->mutable_arrow_record_batch()
+                     ->mutable_serialized_record_batch()));
+  io::IOTrace trace("bigquery", io::IOTraceStage::kDecompress);
+  trace.AddBytes(buffer->size());
+  arrow::io::BufferReader buffer_reader(buffer);
+  arrow::ipc::DictionaryMemo dict_memo;
+  auto result = arrow::ipc::ReadRecordBatch(
+      schema, &dict_memo, arrow::ipc::IpcReadOptions::Defaults(),
+      &buffer_reader);
+  if (!result.ok()) {
+    return errors::Internal(result.status().ToString());
+  }
+  *batch = std::move(result).ValueUnsafe();
+  trace.AddRecords((*batch)->num_rows());
+  return OkStatus();
+}
+
+BigQueryStreamsReader::BigQueryStreamsReader(
+    Env* env, BigQueryClientResource* client_resource,
+    const std::vector<string>& streams, int64 num_parallel_streams,
+    bool use_v1, std::shared_ptr<arrow::Schema> arrow_schema)
+    : client_resource_(client_resource),
+      use_v1_(use_v1),
+      arrow_schema_(std::move(arrow_schema)) {
+  size_t num_threads = streams.size();
+  if (num_parallel_streams > 0) {
+    num_threads = std::min<size_t>(num_threads, num_parallel_streams);
+  }
+  capacity_ = kQueueCapacity * num_threads;
+  {
+    mutex_lock l(mu_);
+    for (const string& stream : streams) {
+      pending_streams_.emplace_back(stream, 0);
+    }
+    num_running_ = num_threads;
+  }
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(env->StartThread(ThreadOptions(),
+                                           "bigquery_streams_reader",
+                                           [this] { Run(); }));
+  }
+}
+
+BigQueryStreamsReader::~BigQueryStreamsReader() {
+  {
+    mutex_lock l(mu_);
+    stop_ = true;
+    for (::grpc::ClientContext* context : contexts_) {
+      context->TryCancel();
+    }
+    cv_.notify_all();
+  }
+  // Joins the reader threads.
+  threads_.clear();
+}
+
+Status BigQueryStreamsReader::Read(apiv1beta1::ReadRowsResponse* response,
+                                   std::shared_ptr<arrow::RecordBatch>* batch,
+                                   bool* end_of_sequence) {
+  mutex_lock l(mu_);
+  while (responses_.empty() && num_running_ > 0 && status_.ok()) {
+    cv_.wait(l);
+  }
+  TF_RETURN_IF_ERROR(status_);
+  if (responses_.empty()) {
+    *end_of_sequence = true;
+    return OkStatus();
+  }
+  *response = std::move(responses_.front().response);
+  *batch = std::move(responses_.front().batch);
+  responses_.pop_front();
+  cv_.notify_all();
+  return OkStatus();
+}
+
+void BigQueryStreamsReader::Run() {
+  Status status;
+  while (status.ok()) {
+    std::pair<string, int64> stream;
+    {
+      mutex_lock l(mu_);
+      while (!stop_ && pending_streams_.empty() && num_reading_ > 0) {
+        // Rebalance the rows left to the streams still being read.
+        split_requested_ = true;
+        cv_.wait(l);
+      }
+      if (stop_ || pending_streams_.empty()) break;
+      stream = std::move(pending_streams_.front());
+      pending_streams_.pop_front();
+      num_reading_++;
+    }
+    status = ReadStream(stream.first, stream.second);
+    mutex_lock l(mu_);
+    num_reading_--;
+    cv_.notify_all();
+  }
+  mutex_lock l(mu_);
+  if (status_.ok()) status_ = status;
+  if (!status.ok()) stop_ = true;
+  num_running_--;
+  cv_.notify_all();
+}
+
+Status BigQueryStreamsReader::ReadStream(string stream, int64 offset) {
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      if (stop_) return OkStatus();
+    }
+    BigQueryRowsReader reader(client_resource_, use_v1_, stream, offset);
+    ::grpc::ClientContext* context = reader.context();
+    {
+      mutex_lock l(mu_);
+      if (stop_) return OkStatus();
+      contexts_.insert(context);
+    }
+
+    bool split = false;
+    Response response;
+    while (!split && reader.Read(&response.response)) {
+      const int64 row_count =
+          response.response.has_arrow_record_batch()
+              ? response.response.arrow_record_batch().row_count()
+              : response.response.avro_rows().row_count();
+      offset += row_count;
+      const float fraction_consumed =
+          response.response.status().fraction_consumed();
+      const bool splittable = response.response.status().is_splittable();
+      // The record batch is decoded, and its buffers decompressed, on this
+      // thread rather than on the one of the iterator.
+      if (arrow_schema_ != nullptr && row_count > 0) {
+        Status status = DecodeArrowRecordBatch(
+            arrow_schema_, &response.response, &response.batch);
+        if (!status.ok()) {
+          mutex_lock l(mu_);
+          contexts_.erase(context);
+          context->TryCancel();
+          reader.Finish();
+          return status;
+        }
+      }
+      {
+        mutex_lock l(mu_);
+        while (!stop_ && responses_.size() >= capacity_) cv_.wait(l);
+        if (stop_) break;
+        if (row_count > 0) {
+          responses_.emplace_back(std::move(response));
+          response = Response();
+          cv_.notify_all();
+        }
+        // A remainder already queued satisfies the request.
+        split = split_requested_ && pending_streams_.empty() && splittable &&
+                fraction_consumed < kMaxSplitFraction;
+        if (split) split_requested_ = false;
+      }
+      if (split) split = SplitStream(fraction_consumed, &stream);
+    }
+    {
+      mutex_lock l(mu_);
+      contexts_.erase(context);
+    }
+    if (split) {
+      // The rows read so far are the start of the primary part, from which
+      // the read resumes.
+      context->TryCancel();
+      reader.Finish();
+      continue;
+    }
+    {
+      mutex_lock l(mu_);
+      if (stop_) return OkStatus();
+    }
+    return GrpcStatusToTfStatus(reader.Finish());
+  }
+}
+
+bool BigQueryStreamsReader::SplitStream(float fraction_consumed,
+                                        string* stream) {
+  const float fraction = fraction_consumed + (1 - fraction_consumed) / 2;
+  if (use_v1_) {
+    apiv1::BigQueryRead::Stub* stub = client_resource_->GetV1Stub(*stream);
+    if (stub == nullptr) {
+      return false;
+    }
+    apiv1::SplitReadStreamRequest request;
+    request.set_name(*stream);
+    request.set_fraction(fraction);
+    apiv1::SplitReadStreamResponse response;
+    ::grpc::ClientContext context;
+    context.AddMetadata("x-goog-request-params",
+                        absl::StrCat("name=", *stream));
+    ::grpc::Status status =
+        stub->SplitReadStream(&context, request, &response);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to split stream " << *stream << ": "
+                   << GrpcStatusToString(status);
+      return false;
+    }
+    return SplitInto(response.primary_stream().name(),
+                     response.remainder_stream().name(), fraction, stream);
+  }
+  apiv1beta1::SplitReadStreamRequest request;
+  request.mutable_original_stream()->set_name(*stream);
+  request.set_fraction(fraction);
+  apiv1beta1::SplitReadStreamResponse response;
+  ::grpc::ClientContext context;
+  context.AddMetadata("x-goog-request-params",
+                      absl::StrCat("original_stream.name=", *stream));
+  ::grpc::Status status = client_resource_->GetStub(*stream)->SplitReadStream(
+      &context, request, &response);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to split stream " << *stream << ": "
+                 << GrpcStatusToString(status);
+    return false;
+  }
+  return SplitInto(response.primary_stream().name(),
+                   response.remainder_stream().name(), fraction, stream);
+}
+
+bool BigQueryStreamsReader::SplitInto(const string& primary,
+                                      const string& remainder, float fraction,
+                                      string* stream) {
+  if (primary.empty() || remainder.empty()) {
+    return false;
+  }
+  VLOG(3) << "split stream " << *stream << " at " << fraction;
+  *stream = primary;
+  mutex_lock l(mu_);
+  pending_streams_.emplace_back(remainder, 0);
+  cv_.notify_all();
+  return true;
+}
+
+namespace {
+// The TensorFlow type of the values of a node, of its items for arrays.
+Status GetAvroValueType(const avro::NodePtr& node, DataType* dtype) {
+  avro::Type type = node->type();
+  if (type == avro::AVRO_ARRAY) {
+    type = node->leafAt(0)->type();
+  }
+  switch (type) {
+    case avro::AVRO_BOOL:
+      *dtype = DT_BOOL;
+      break;
+    case avro::AVRO_INT:
+      *dtype = DT_INT32;
+      break;
+    case avro::AVRO_LONG:
+      *dtype = DT_INT64;
+      break;
+    case avro::AVRO_FLOAT:
+      *dtype = DT_FLOAT;
+      break;
+    case avro::AVRO_DOUBLE:
+      *dtype = DT_DOUBLE;
+      break;
+    case avro::AVRO_STRING:
+    case avro::AVRO_BYTES:
+    case avro::AVRO_FIXED:
+    case avro::AVRO_ENUM:
+      *dtype = DT_STRING;
+      break;
+    default:
+      return errors::InvalidArgument("unsupported data type: ", type);
+  }
+  return OkStatus();
+}
+
+Status AssignDefaultValue(const absl::any& default_value, int64 row,
+                          Tensor* tensor) {
+  switch (tensor->dtype()) {
+    case DT_BOOL:
+      tensor->flat<bool>()(row) = absl::any_cast<bool>(default_value);
+      break;
+    case DT_INT32:
+      tensor->flat<int32>()(row) = absl::any_cast<int32_t>(default_value);
+      break;
+    case DT_INT64:
+      tensor->flat<int64>()(row) = absl::any_cast<int64_t>(default_value);
+      break;
+    case DT_FLOAT:
+      tensor->flat<float>()(row) = absl::any_cast<float>(default_value);
+      break;
+    case DT_DOUBLE:
+      tensor->flat<double>()(row) = absl::any_cast<double>(default_value);
+      break;
+    case DT_STRING:
+      tensor->flat<tstring>()(row) = absl::any_cast<string>(default_value);
+      break;
+    default:
+      return errors::InvalidArgument(
+          "unsupported data type against AVRO_NULL: ", tensor->dtype());
+  }
+  return OkStatus();
+}
+
+// Decodes the items of an array to a vector tensor.
+template <typename T, typename DecodeItem>
+Tensor DecodeArray(avro::Decoder& decoder, Allocator* allocator,
+                   DataType dtype, DecodeItem decode_item) {
+  std::vector<T> values;
+  for (size_t n = decoder.arrayStart(); n != 0; n = decoder.arrayNext()) {
+    for (size_t i = 0; i < n; i++) {
+      values.emplace_back(decode_item());
+    }
+  }
+  Tensor tensor(allocator, dtype, {static_cast<int64>(values.size())});
+  auto tensor_flat = tensor.flat<T>();
+  for (size_t i = 0; i < values.size(); i++) {
+    tensor_flat(i) = std::move(values[i]);
+  }
+  return tensor;
+}
+}  // namespace
+
+Status BigQueryAvroRowDecoder::Initialize(
+    const avro::ValidSchema& schema, const std::vector<string>& columns,
+    const std::vector<DataType>& output_types) {
+  const avro::NodePtr& root = schema.root();
+  if (root->type() != avro::AVRO_RECORD) {
+    return errors::Unknown("record is not of AVRO_RECORD type");
+  }
+  fields_.clear();
+  fields_.resize(root->leaves());
+  for (size_t i = 0; i < root->leaves(); i++) {
+    Field& field = fields_[i];
+    field.node = root->leafAt(i);
+    field.value_node = field.node;
+    // Nullable fields are unions of null and of their type.
+    if (field.node->type() == avro::AVRO_UNION && field.node->leaves() == 2) {
+      for (size_t branch = 0; branch < 2; branch++) {
+        if (field.node->leafAt(1 - branch)->type() == avro::AVRO_NULL) {
+          field.value_branch = branch;
+          field.value_node = field.node->leafAt(branch);
+        }
+      }
+    }
+  }
+
+  has_repeated_columns_ = false;
+  for (size_t i = 0; i < columns.size(); i++) {
+    size_t pos;
+    if (!root->nameIndex(columns[i], pos)) {
+      return errors::InvalidArgument("can't find column ", columns[i],
+                                     " in the Avro schema");
+    }
+    Field& field = fields_[pos];
+    field.column = i;
+    DataType dtype = output_types[i];
+    if (field.value_node->type() != avro::AVRO_NULL) {
+      TF_RETURN_IF_ERROR(GetAvroValueType(field.value_node, &dtype));
+    }
+    if (dtype != output_types[i]) {
+      return errors::InvalidArgument(
+          "output type mismatch for column: ", columns[i],
+          " expected type: ", DataType_Name(dtype),
+          " actual type: ", DataType_Name(output_types[i]));
+    }
+    if (field.value_node->type() == avro::AVRO_ARRAY) {
+      has_repeated_columns_ = true;
+    }
+  }
+  return OkStatus();
+}
+
+Status BigQueryAvroRowDecoder::Decode(
+    avro::Decoder& decoder, Allocator* allocator,
+    const std::vector<absl::any>& typed_default_values, int64 row,
+    std::vector<Tensor>* tensors) {
+  for (const Field& field : fields_) {
+    if (field.column < 0) {
+      avro::GenericDatum datum(field.node);
+      avro::decode(decoder, datum);
+      continue;
+    }
+    Tensor* tensor = &(*tensors)[field.column];
+    if (field.value_node->type() == avro::AVRO_NULL ||
+        (field.value_branch >= 0 &&
+         decoder.decodeUnionIndex() != field.value_branch)) {
+      TF_RETURN_IF_ERROR(AssignDefaultValue(typed_default_values[field.column],
+                                            row, tensor));
+      continue;
+    }
+    TF_RETURN_IF_ERROR(DecodeValue(decoder, field, allocator, row, tensor));
+  }
+  return OkStatus();
+}
+
+Status BigQueryAvroRowDecoder::DecodeValue(avro::Decoder& decoder,
+                                           const Field& field,
+                                           Allocator* allocator, int64 row,
+                                           Tensor* tensor) {
+  const avro::NodePtr& node = field.value_node;
+  switch (node->type()) {
+    case avro::AVRO_BOOL:
+      tensor->flat<bool>()(row) = decoder.decodeBool();
+      break;
+    case avro::AVRO_INT:
+      tensor->flat<int32>()(row) = decoder.decodeInt();
+      break;
+    case avro::AVRO_LONG:
+      tensor->flat<int64>()(row) = decoder.decodeLong();
+      break;
+    case avro::AVRO_FLOAT:
+      tensor->flat<float>()(row) = decoder.decodeFloat();
+      break;
+    case avro::AVRO_DOUBLE:
+      tensor->flat<double>()(row) = decoder.decodeDouble();
+      break;
+    case avro::AVRO_STRING:
+      tensor->flat<tstring>()(row) = decoder.decodeString();
+      break;
+    case avro::AVRO_BYTES: {
+      std::vector<uint8_t> value;
+      decoder.decodeBytes(value);
+      tensor->flat<tstring>()(row).assign(
+          reinterpret_cast<const char*>(value.data()), value.size());
+    } break;
+    case avro::AVRO_FIXED: {
+      std::vector<uint8_t> value;
+      decoder.decodeFixed(node->fixedSize(), value);
+      tensor->flat<tstring>()(row).assign(
+          reinterpret_cast<const char*>(value.data()), value.size());
+    } break;
+    case avro::AVRO_ENUM:
+      tensor->flat<tstring>()(row) = node->nameAt(decoder.decodeEnum());
+      break;
+    case avro::AVRO_ARRAY: {
+      const DataType dtype = tensor->dtype();
+      switch (node->leafAt(0)->type()) {
+        case avro::AVRO_BOOL:
+          *tensor = DecodeArray<bool>(decoder, allocator, dtype,
+                                      [&] { return decoder.decodeBool(); });
+          break;
+        case avro::AVRO_INT:
+          *tensor = DecodeArray<int32>(decoder, allocator, dtype,
+                                       [&] { return decoder.decodeInt(); });
+          break;
+        case avro::AVRO_LONG:
+          *tensor = DecodeArray<int64>(decoder, allocator, dtype,
+                                       [&] { return decoder.decodeLong(); });
+          break;
+        case avro::AVRO_FLOAT:
+          *tensor = DecodeArray<float>(decoder, allocator, dtype,
+                                       [&] { return decoder.decodeFloat(); });
+          break;
+        case avro::AVRO_DOUBLE:
+          *tensor = DecodeArray<double>(decoder, allocator, dtype, [&] {
+            return decoder.decodeDouble();
+          });
+          break;
+        case avro::AVRO_STRING:
+          *tensor = DecodeArray<tstring>(decoder, allocator, dtype, [&] {
+            return decoder.decodeString();
+          });
+          break;
+        default:
+          return errors::InvalidArgument(
+              "unsupported data type within AVRO_ARRAY ",
+              node->leafAt(0)->type());
+      }
+    } break;
+    default:
+      return errors::InvalidArgument("unsupported data type: ", node->type());
+  }
+  return OkStatus();
+}
+
 }  // namespace tensorflow
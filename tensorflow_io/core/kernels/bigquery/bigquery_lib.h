@@ -18,7 +18,10 @@ limitations under the License.
 
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <set>
 // Inclusion of googleapi related grpc headers, e.g., storage.grpc.pb.h
 // will cause Windows build failures due to the conflict of `OPTIONAL`
 // definition. The following is needed for Windows.
@@ -38,53 +41,58 @@ limitations under the License.
 #include "arrow/buffer.h"
 #include "arrow/io/memory.h"
 #include "arrow/ipc/api.h"
+#include "google/cloud/bigquery/storage/v1/storage.grpc.pb.h"
 #include "google/cloud/bigquery/storage/v1beta1/storage.grpc.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_util.h"
 
 namespace tensorflow {
 
 namespace apiv1beta1 = ::google::cloud::bigquery::storage::v1beta1;
+namespace apiv1 = ::google::cloud::bigquery::storage::v1;
 static constexpr int kMaxReceiveMessageSize = -1;  // Disabled
 
 Status GrpcStatusToTfStatus(const ::grpc::Status &status);
 string GrpcStatusToString(const ::grpc::Status &status);
 Status GetDataFormat(string data_format_str,
                      apiv1beta1::DataFormat *data_format);
+// Parses the Arrow buffer compression of a v1 read session, '' for none.
+Status GetArrowCompression(
+    const string &compression_str,
+    apiv1::ArrowSerializationOptions::CompressionCodec *compression);
 
 class BigQueryClientResource : public ResourceBase {
  public:
   explicit BigQueryClientResource(
       std::function<std::unique_ptr<apiv1beta1::BigQueryStorage::Stub>(
           const string &read_stream)>
-          stub_factory)
-      : stub_factory_(stub_factory) {}
+          stub_factory,
+      std::function<std::unique_ptr<apiv1::BigQueryRead::Stub>(
+          const string &read_stream)>
+          v1_stub_factory = nullptr)
+      : stub_factory_(stub_factory), v1_stub_factory_(v1_stub_factory) {}
 
   explicit BigQueryClientResource()
-      : BigQueryClientResource([](const string &read_stream) {
-          string server_name = "dns:///bigquerystorage.googleapis.com";
-          auto creds = ::grpc::GoogleDefaultCredentials();
-          grpc::ChannelArguments args;
-          args.SetMaxReceiveMessageSize(kMaxReceiveMessageSize);
-          args.SetUserAgentPrefix(
-              strings::StrCat("tensorflow-", TF_VERSION_STRING));
-          args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 0);
-          args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, 60 * 1000);
-          // To prevent gRPC from reusing channel
-          args.SetString("read_stream", read_stream);
-          auto channel = ::grpc::CreateCustomChannel(server_name, creds, args);
-          VLOG(3) << "Creating GRPC channel";
-          return absl::make_unique<apiv1beta1::BigQueryStorage::Stub>(channel);
-        }) {}
-
-  apiv1beta1::BigQueryStorage::Stub *GetStub(const string &read_stream)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      : BigQueryClientResource(
+            [](const string &read_stream) {
+              return absl::make_unique<apiv1beta1::BigQueryStorage::Stub>(
+                  CreateChannel(read_stream));
+            },
+            [](const string &read_stream) {
+              return absl::make_unique<apiv1::BigQueryRead::Stub>(
+                  CreateChannel(read_stream));
+            }) {}
+
+  apiv1beta1::BigQueryStorage::Stub *GetStub(const string &read_stream) {
+    mutex_lock l(mu_);
     if (stubs_.find(read_stream) == stubs_.end()) {
       auto stub = stub_factory_(read_stream);
       stubs_.emplace(read_stream, std::move(stub));
@@ -92,15 +100,181 @@ class BigQueryClientResource : public ResourceBase {
     return stubs_[read_stream].get();
   }
 
+  // Returns the stub of the v1 API, or nullptr if the client only has the
+  // v1beta1 one.
+  apiv1::BigQueryRead::Stub *GetV1Stub(const string &read_stream) {
+    mutex_lock l(mu_);
+    if (v1_stub_factory_ == nullptr) {
+      return nullptr;
+    }
+    if (v1_stubs_.find(read_stream) == v1_stubs_.end()) {
+      v1_stubs_.emplace(read_stream, v1_stub_factory_(read_stream));
+    }
+    return v1_stubs_[read_stream].get();
+  }
+
   string DebugString() const override { return "BigQueryClientResource"; }
 
  private:
+  static std::shared_ptr<::grpc::Channel> CreateChannel(
+      const string &read_stream) {
+    string server_name = "dns:///bigquerystorage.googleapis.com";
+    auto creds = ::grpc::GoogleDefaultCredentials();
+    grpc::ChannelArguments args;
+    args.SetMaxReceiveMessageSize(kMaxReceiveMessageSize);
+    args.SetUserAgentPrefix(strings::StrCat("tensorflow-", TF_VERSION_STRING));
+    args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 0);
+    args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, 60 * 1000);
+    // To prevent gRPC from reusing channel
+    args.SetString("read_stream", read_stream);
+    VLOG(3) << "Creating GRPC channel";
+    return ::grpc::CreateCustomChannel(server_name, creds, args);
+  }
+
   std::function<std::unique_ptr<apiv1beta1::BigQueryStorage::Stub>(
       const string &)>
       stub_factory_;
+  std::function<std::unique_ptr<apiv1::BigQueryRead::Stub>(const string &)>
+      v1_stub_factory_;
   mutex mu_;
   std::unordered_map<string, std::unique_ptr<apiv1beta1::BigQueryStorage::Stub>>
       stubs_ TF_GUARDED_BY(mu_);
+  std::unordered_map<string, std::unique_ptr<apiv1::BigQueryRead::Stub>>
+      v1_stubs_ TF_GUARDED_BY(mu_);
+};
+
+// Reads the rows of one stream from an offset with the v1beta1 or the v1
+// API. The responses of the v1 API are returned as v1beta1 ones, their rows
+// moved rather than copied, so that the readers handle both the same way.
+class BigQueryRowsReader {
+ public:
+  BigQueryRowsReader(BigQueryClientResource *client_resource, bool use_v1,
+                     const string &stream, int64 offset);
+
+  // The context of the call, to cancel it from another thread.
+  ::grpc::ClientContext *context() { return &context_; }
+
+  // Reads the next response, returns false at the end of the stream or on
+  // error, which Finish returns.
+  bool Read(apiv1beta1::ReadRowsResponse *response);
+  ::grpc::Status Finish();
+
+ private:
+  ::grpc::ClientContext context_;
+  std::unique_ptr<::grpc::ClientReader<apiv1beta1::ReadRowsResponse>> reader_;
+  std::unique_ptr<::grpc::ClientReader<apiv1::ReadRowsResponse>> v1_reader_;
+  apiv1::ReadRowsResponse v1_response_;
+  ::grpc::Status status_;
+};
+
+// Decodes the serialized Arrow record batch of `response`, decompressing its
+// buffers if the session was created with an Arrow buffer compression. The
+// batch takes over the serialized data, so that tensors aliasing its columns
+// do not outlive it.
+Status DecodeArrowRecordBatch(const std::shared_ptr<arrow::Schema> &schema,
+                              apiv1beta1::ReadRowsResponse *response,
+                              std::shared_ptr<arrow::RecordBatch> *batch);
+
+// Reads several streams of a read session concurrently, each on a thread of
+// its own and up to `num_parallel_streams` at a time, into one bounded queue
+// of responses. A thread that runs out of streams while others are still
+// reading has the next of them to receive a response split its stream with
+// SplitReadStream and read its remainder, so that no stream straggles.
+// With an `arrow_schema`, the threads also decode, and decompress, the
+// record batches of the responses.
+class BigQueryStreamsReader {
+ public:
+  BigQueryStreamsReader(Env *env, BigQueryClientResource *client_resource,
+                        const std::vector<string> &streams,
+                        int64 num_parallel_streams, bool use_v1,
+                        std::shared_ptr<arrow::Schema> arrow_schema);
+  ~BigQueryStreamsReader();
+
+  // Moves the next response of any stream with rows to `response`, and its
+  // decoded record batch if any to `batch`. `end_of_sequence` is set once
+  // all streams have been read.
+  Status Read(apiv1beta1::ReadRowsResponse *response,
+              std::shared_ptr<arrow::RecordBatch> *batch,
+              bool *end_of_sequence);
+
+ private:
+  void Run();
+  // Reads `stream` from `offset` to its end, or to the end of its primary
+  // part once it is split.
+  Status ReadStream(string stream, int64 offset);
+  // Splits `stream` at the middle of its unread rows, replacing it with its
+  // primary part and queueing the remainder. Returns false, leaving `stream`
+  // untouched, if it can not be split.
+  bool SplitStream(float fraction_consumed, string *stream);
+  // Replaces `stream` with its `primary` part and queues its `remainder`.
+  bool SplitInto(const string &primary, const string &remainder,
+                 float fraction, string *stream);
+
+  // The number of responses queued ahead of Read per stream read.
+  static const size_t kQueueCapacity = 2;
+  // Streams consumed beyond this fraction are left to finish rather than
+  // split.
+  static constexpr float kMaxSplitFraction = 0.9;
+
+  struct Response {
+    apiv1beta1::ReadRowsResponse response;
+    std::shared_ptr<arrow::RecordBatch> batch;
+  };
+
+  BigQueryClientResource *client_resource_;
+  const bool use_v1_;
+  const std::shared_ptr<arrow::Schema> arrow_schema_;
+  mutex mu_;
+  condition_variable cv_;
+  std::deque<std::pair<string, int64>> pending_streams_ TF_GUARDED_BY(mu_);
+  std::deque<Response> responses_ TF_GUARDED_BY(mu_);
+  std::set<::grpc::ClientContext *> contexts_ TF_GUARDED_BY(mu_);
+  size_t capacity_;
+  size_t num_reading_ TF_GUARDED_BY(mu_) = 0;
+  size_t num_running_ TF_GUARDED_BY(mu_) = 0;
+  bool split_requested_ TF_GUARDED_BY(mu_) = false;
+  bool stop_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
+// Decodes the rows of a block of Avro rows field by field, with a decoder
+// per field compiled from the schema, straight to the output tensors rather
+// than to a GenericDatum per row. Fields that are not selected are skipped.
+class BigQueryAvroRowDecoder {
+ public:
+  Status Initialize(const avro::ValidSchema &schema,
+                    const std::vector<string> &columns,
+                    const std::vector<DataType> &output_types);
+
+  // Whether any of the columns is an array, whose tensors are only known
+  // once a row is decoded.
+  bool has_repeated_columns() const { return has_repeated_columns_; }
+
+  // Decodes the next row to element `row` of `tensors`, which hold one
+  // element per row of a batch or are scalars for row 0. The tensors of
+  // repeated columns are allocated for the row.
+  Status Decode(avro::Decoder &decoder, Allocator *allocator,
+                const std::vector<absl::any> &typed_default_values, int64 row,
+                std::vector<Tensor> *tensors);
+
+ private:
+  struct Field {
+    avro::NodePtr node;
+    // The node of the values, the non-null branch of a nullable union.
+    avro::NodePtr value_node;
+    // The output column of the field, or -1 if it is skipped.
+    int64 column = -1;
+    // The branch of a nullable union which holds the value, or -1 if the
+    // field can not be null.
+    int64 value_branch = -1;
+  };
+
+  Status DecodeValue(avro::Decoder &decoder, const Field &field,
+                     Allocator *allocator, int64 row, Tensor *tensor);
+
+  std::vector<Field> fields_;
+  bool has_repeated_columns_ = false;
 };
 
 namespace data {
@@ -126,11 +300,14 @@ class BigQueryReaderDatasetIteratorBase : public DatasetIterator<Dataset> {
       return OkStatus();
     }
 
+    int64 num_rows = 1;
+    io::IOTrace trace("bigquery", io::IOTraceStage::kDecode);
     auto status =
         ReadRecord(ctx, out_tensors, this->dataset()->selected_fields(),
                    this->dataset()->output_types(),
-                   this->dataset()->typed_default_values());
-    current_row_index_++;
+                   this->dataset()->typed_default_values(), &num_rows);
+    trace.AddRecords(num_rows);
+    current_row_index_ += num_rows;
     return status;
   }
 
@@ -152,48 +329,59 @@ class BigQueryReaderDatasetIteratorBase : public DatasetIterator<Dataset> {
         "Iterator does not support 'RestoreInternal')");
   }
   virtual Status EnsureReaderInitialized() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    if (reader_) {
+    if (reader_ || streams_reader_) {
+      return OkStatus();
+    }
+    if (this->dataset()->streams().size() > 1) {
+      streams_reader_ = absl::make_unique<BigQueryStreamsReader>(
+          Env::Default(), this->dataset()->client_resource(),
+          this->dataset()->streams(), this->dataset()->num_parallel_streams(),
+          this->dataset()->use_v1(), this->dataset()->arrow_schema());
       return OkStatus();
     }
 
-    apiv1beta1::ReadRowsRequest readRowsRequest;
-    readRowsRequest.mutable_read_position()->mutable_stream()->set_name(
-        this->dataset()->stream());
-    readRowsRequest.mutable_read_position()->set_offset(
-        this->dataset()->offset());
-
-    read_rows_context_ = absl::make_unique<::grpc::ClientContext>();
-    // The deadline is for the entire ReadRows (not a single message receipt),
-    // so for larger data sizes it could take many hours to complete.
-    read_rows_context_->set_deadline(std::chrono::system_clock::now() +
-                                     std::chrono::hours(24));
-    read_rows_context_->AddMetadata(
-        "x-goog-request-params",
-        absl::StrCat("read_position.stream.name=",
-                     readRowsRequest.read_position().stream().name()));
-
-    VLOG(3) << "getting reader, stream: "
-            << readRowsRequest.read_position().stream().DebugString();
-    reader_ = this->dataset()
-                  ->client_resource()
-                  ->GetStub(readRowsRequest.read_position().stream().name())
-                  ->ReadRows(read_rows_context_.get(), readRowsRequest);
+    VLOG(3) << "getting reader, stream: " << this->dataset()->stream();
+    reader_ = absl::make_unique<BigQueryRowsReader>(
+        this->dataset()->client_resource(), this->dataset()->use_v1(),
+        this->dataset()->stream(), this->dataset()->offset());
+
+    return OkStatus();
+  }
 
+  // Reads the next response to response_, from the stream or from any of the
+  // streams read concurrently, in which case its record batch, if any, is
+  // decoded to batch_.
+  Status ReadResponse(bool *end_of_sequence) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    response_ = absl::make_unique<apiv1beta1::ReadRowsResponse>();
+    batch_.reset();
+    io::IOTrace trace("bigquery", io::IOTraceStage::kIOWait, "read_rows");
+    if (streams_reader_) {
+      TF_RETURN_IF_ERROR(
+          streams_reader_->Read(response_.get(), &batch_, end_of_sequence));
+    } else if (!reader_->Read(response_.get())) {
+      *end_of_sequence = true;
+      return GrpcStatusToTfStatus(reader_->Finish());
+    }
+    trace.AddBytes(response_->ByteSizeLong());
+    trace.AddRecords(response_->row_count());
     return OkStatus();
   }
 
   virtual Status EnsureHasRow(bool *end_of_sequence) = 0;
-  virtual Status ReadRecord(
-      IteratorContext *ctx, std::vector<Tensor> *out_tensors,
-      const std::vector<string> &columns,
-      const std::vector<DataType> &output_types,
-      const std::vector<absl::any> &typed_default_values) = 0;
+  // Reads the next element to `out_tensors`, `num_rows` is the number of
+  // rows it is made of and is 1 unless set otherwise.
+  virtual Status ReadRecord(IteratorContext *ctx,
+                            std::vector<Tensor> *out_tensors,
+                            const std::vector<string> &columns,
+                            const std::vector<DataType> &output_types,
+                            const std::vector<absl::any> &typed_default_values,
+                            int64 *num_rows) = 0;
   int current_row_index_ = 0;
   mutex mu_;
-  std::unique_ptr<::grpc::ClientContext> read_rows_context_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<::grpc::ClientReader<apiv1beta1::ReadRowsResponse>> reader_
-      TF_GUARDED_BY(mu_);
+  std::unique_ptr<BigQueryRowsReader> reader_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<BigQueryStreamsReader> streams_reader_ TF_GUARDED_BY(mu_);
   std::unique_ptr<apiv1beta1::ReadRowsResponse> response_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<arrow::RecordBatch> batch_ TF_GUARDED_BY(mu_);
 };
 
 // BigQuery reader for Arrow serialized data.
@@ -217,29 +405,21 @@ class BigQueryReaderArrowDatasetIterator
       return OkStatus();
     }
 
-    this->response_ = absl::make_unique<apiv1beta1::ReadRowsResponse>();
-    if (!this->reader_->Read(this->response_.get())) {
-      *end_of_sequence = true;
-      return GrpcStatusToTfStatus(this->reader_->Finish());
+    TF_RETURN_IF_ERROR(this->ReadResponse(end_of_sequence));
+    if (*end_of_sequence) {
+      return OkStatus();
     }
 
     this->current_row_index_ = 0;
 
-    auto buffer_ = std::make_shared<arrow::Buffer>(
-        reinterpret_cast<const uint8_t *>(&this->response_->arrow_record_batch()
-                                               .serialized_record_batch()[0]),
-        this->response_->arrow_record_batch().serialized_record_batch().size());
-
-    arrow::io::BufferReader buffer_reader_(buffer_);
-    arrow::ipc::DictionaryMemo dict_memo;
-
-    auto result = arrow::ipc::ReadRecordBatch(
-        this->dataset()->arrow_schema(), &dict_memo,
-        arrow::ipc::IpcReadOptions::Defaults(), &buffer_reader_);
-    if (!result.ok()) {
-      return errors::Internal(result.status().ToString());
+    // Batches of concurrently read streams are decoded by the reader threads.
+    if (this->batch_) {
+      this->record_batch_ = std::move(this->batch_);
+    } else {
+      TF_RETURN_IF_ERROR(DecodeArrowRecordBatch(this->dataset()->arrow_schema(),
+                                                this->response_.get(),
+                                                &this->record_batch_));
     }
-    this->record_batch_ = std::move(result).ValueUnsafe();
 
     VLOG(3) << "got record batch, rows:" << record_batch_->num_rows();
 
@@ -249,7 +429,8 @@ class BigQueryReaderArrowDatasetIterator
   Status ReadRecord(IteratorContext *ctx, std::vector<Tensor> *out_tensors,
                     const std::vector<string> &columns,
                     const std::vector<DataType> &output_types,
-                    const std::vector<absl::any> &typed_default_values)
+                    const std::vector<absl::any> &typed_default_values,
+                    int64 *num_rows)
       TF_EXCLUSIVE_LOCKS_REQUIRED(this->mu_) override {
     out_tensors->clear();
     out_tensors->reserve(columns.size());
@@ -278,6 +459,14 @@ class BigQueryReaderArrowDatasetIterator
       }
     }
 
+    const int64 batch_size = this->dataset()->batch_size();
+    if (batch_size > 0) {
+      *num_rows = std::min<int64>(
+          batch_size,
+          this->record_batch_->num_rows() - this->current_row_index_);
+      return ReadBatch(ctx, out_tensors, columns, output_types, *num_rows);
+    }
+
     for (size_t i = 0; i < columns.size(); ++i) {
       DataType output_type = output_types[i];
       size_t arrow_column_index = this->column_indices_[i];
@@ -295,6 +484,35 @@ class BigQueryReaderArrowDatasetIterator
     return OkStatus();
   }
 
+  // Converts `num_rows` rows of each column of the record batch to a tensor
+  // in one step, aliasing the Arrow buffers where the layout allows it.
+  Status ReadBatch(IteratorContext *ctx, std::vector<Tensor> *out_tensors,
+                   const std::vector<string> &columns,
+                   const std::vector<DataType> &output_types, int64 num_rows)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(this->mu_) {
+    const int64 row_index = this->current_row_index_;
+    for (size_t i = 0; i < columns.size(); ++i) {
+      DataType output_type = output_types[i];
+      size_t arrow_column_index = this->column_indices_[i];
+      std::shared_ptr<arrow::Array> arr =
+          this->record_batch_->column(arrow_column_index);
+
+      TensorShape output_shape;
+      TF_RETURN_IF_ERROR(
+          ArrowUtil::AssignShape(arr, row_index, num_rows, &output_shape));
+      Tensor tensor;
+      bool aliased = false;
+      TF_RETURN_IF_ERROR(ArrowUtil::AliasTensor(
+          arr, row_index, output_type, output_shape, &tensor, &aliased));
+      if (!aliased) {
+        tensor = Tensor(ctx->allocator({}), output_type, output_shape);
+        TF_RETURN_IF_ERROR(ArrowUtil::AssignTensor(arr, row_index, &tensor));
+      }
+      out_tensors->emplace_back(std::move(tensor));
+    }
+    return OkStatus();
+  }
+
  private:
   std::shared_ptr<arrow::RecordBatch> record_batch_ TF_GUARDED_BY(this->mu_);
   std::vector<size_t> column_indices_ TF_GUARDED_BY(this->mu_);
@@ -319,12 +537,11 @@ class BigQueryReaderAvroDatasetIterator
       return OkStatus();
     }
 
-    this->response_ = absl::make_unique<apiv1beta1::ReadRowsResponse>();
     VLOG(3) << "calling read";
-    if (!this->reader_->Read(this->response_.get())) {
+    TF_RETURN_IF_ERROR(this->ReadResponse(end_of_sequence));
+    if (*end_of_sequence) {
       VLOG(3) << "no data";
-      *end_of_sequence = true;
-      return GrpcStatusToTfStatus(this->reader_->Finish());
+      return OkStatus();
     }
     this->current_row_index_ = 0;
     this->decoder_ = avro::binaryDecoder();
@@ -333,230 +550,44 @@ class BigQueryReaderAvroDatasetIterator
             &this->response_->avro_rows().serialized_binary_rows()[0]),
         this->response_->avro_rows().serialized_binary_rows().size());
     this->decoder_->init(*memory_input_stream_);
-    this->datum_ =
-        absl::make_unique<avro::GenericDatum>(*this->dataset()->avro_schema());
     return OkStatus();
   }
 
   Status ReadRecord(IteratorContext *ctx, std::vector<Tensor> *out_tensors,
                     const std::vector<string> &columns,
                     const std::vector<DataType> &output_types,
-                    const std::vector<absl::any> &typed_default_values)
+                    const std::vector<absl::any> &typed_default_values,
+                    int64 *num_rows)
       TF_EXCLUSIVE_LOCKS_REQUIRED(this->mu_) override {
-    avro::decode(*this->decoder_, *this->datum_);
-    if (this->datum_->type() != avro::AVRO_RECORD) {
-      return errors::Unknown("record is not of AVRO_RECORD type");
+    if (!this->row_decoder_initialized_) {
+      TF_RETURN_IF_ERROR(this->row_decoder_.Initialize(
+          *this->dataset()->avro_schema(), columns, output_types));
+      this->row_decoder_initialized_ = true;
     }
-    const avro::GenericRecord &record =
-        this->datum_->template value<avro::GenericRecord>();
-
-    if (this->column_indices_.size() == 0) {
-      this->column_indices_.reserve(columns.size());
-      std::vector<DataType> expected_output_types;
-      expected_output_types.reserve(output_types.size());
-      for (size_t i = 0; i < columns.size(); i++) {
-        const string &column = columns[i];
-        size_t column_index = record.fieldIndex(column);
-        this->column_indices_.emplace_back(column_index);
-
-        const avro::GenericDatum &field = record.fieldAt(column_index);
-        DataType dtype;
-        switch (field.type()) {
-          case avro::AVRO_BOOL:
-            dtype = DT_BOOL;
-            break;
-          case avro::AVRO_INT:
-            dtype = DT_INT32;
-            break;
-          case avro::AVRO_LONG:
-            dtype = DT_INT64;
-            break;
-          case avro::AVRO_FLOAT:
-            dtype = DT_FLOAT;
-            break;
-          case avro::AVRO_DOUBLE:
-            dtype = DT_DOUBLE;
-            break;
-          case avro::AVRO_STRING:
-            dtype = DT_STRING;
-            break;
-          case avro::AVRO_BYTES:
-            dtype = DT_STRING;
-            break;
-          case avro::AVRO_FIXED:
-            dtype = DT_STRING;
-            break;
-          case avro::AVRO_ENUM:
-            dtype = DT_STRING;
-            break;
-          case avro::AVRO_ARRAY: {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            if (values_vector.empty())
-              dtype = output_types[i];
-            else {
-              auto value_type = values_vector[0].type();
-              if (value_type == avro::AVRO_BOOL)
-                dtype = DT_BOOL;
-              else if (value_type == avro::AVRO_INT)
-                dtype = DT_INT32;
-              else if (value_type == avro::AVRO_LONG)
-                dtype = DT_INT64;
-              else if (value_type == avro::AVRO_FLOAT)
-                dtype = DT_FLOAT;
-              else if (value_type == avro::AVRO_DOUBLE)
-                dtype = DT_DOUBLE;
-              else if (value_type == avro::AVRO_STRING)
-                dtype = DT_STRING;
-              else
-                return errors::InvalidArgument(
-                    "unsupported data type within AVRO_ARRAY ", value_type);
-            }
-          } break;
-          case avro::AVRO_NULL:
-            dtype = output_types[i];
-            break;
-          default:
-            return errors::InvalidArgument("unsupported data type: ",
-                                           field.type());
-        }
-        if (dtype != output_types[i]) {
-          return errors::InvalidArgument(
-              "output type mismatch for column: ", columns[i],
-              " expected type: ", DataType_Name(dtype),
-              " actual type: ", DataType_Name(output_types[i]));
-        }
-        expected_output_types.emplace_back(dtype);
+
+    // Rows of a batch are decoded straight to the rows of its tensors.
+    const int64 batch_size = this->dataset()->batch_size();
+    TensorShape shape;
+    if (batch_size > 0) {
+      if (this->row_decoder_.has_repeated_columns()) {
+        return errors::InvalidArgument(
+            "batch_size is not supported for repeated fields in AVRO");
       }
+      *num_rows = std::min<int64>(batch_size,
+                                  this->response_->avro_rows().row_count() -
+                                      this->current_row_index_);
+      shape.AddDim(*num_rows);
     }
 
     out_tensors->clear();
     out_tensors->reserve(columns.size());
     for (size_t i = 0; i < columns.size(); i++) {
-      Tensor tensor(ctx->allocator({}), output_types[i], {});
-      out_tensors->emplace_back(std::move(tensor));
-      const avro::GenericDatum &field =
-          record.fieldAt(this->column_indices_[i]);
-      switch (field.type()) {
-        case avro::AVRO_BOOL:
-          ((*out_tensors)[i]).scalar<bool>()() = field.value<bool>();
-          break;
-        case avro::AVRO_INT:
-          ((*out_tensors)[i]).scalar<int32>()() = field.value<int32_t>();
-          break;
-        case avro::AVRO_LONG:
-          ((*out_tensors)[i]).scalar<int64>()() = field.value<int64_t>();
-          break;
-        case avro::AVRO_FLOAT:
-          ((*out_tensors)[i]).scalar<float>()() = field.value<float>();
-          break;
-        case avro::AVRO_DOUBLE:
-          ((*out_tensors)[i]).scalar<double>()() = field.value<double>();
-          break;
-        case avro::AVRO_STRING:
-          ((*out_tensors)[i]).scalar<tstring>()() = field.value<string>();
-          break;
-        case avro::AVRO_ENUM:
-          ((*out_tensors)[i]).scalar<tstring>()() =
-              field.value<avro::GenericEnum>().symbol();
-          break;
-        case avro::AVRO_BYTES: {
-          const std::vector<uint8_t> &field_value =
-              field.value<std::vector<uint8_t>>();
-          ((*out_tensors)[i]).scalar<tstring>()() =
-              string((char *)&field_value[0], field_value.size());
-        } break;
-        case avro::AVRO_ARRAY: {
-          if (output_types[i] == DT_BOOL) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_BOOL, {size});
-            auto output_flat = output_tensor.flat<bool>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<bool>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          } else if (output_types[i] == DT_INT32) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_INT32, {size});
-            auto output_flat = output_tensor.flat<int32>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<int32_t>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          } else if (output_types[i] == DT_INT64) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_INT64, {size});
-            auto output_flat = output_tensor.flat<int64>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<int64_t>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          } else if (output_types[i] == DT_FLOAT) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_FLOAT, {size});
-            auto output_flat = output_tensor.flat<float>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<float>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          } else if (output_types[i] == DT_DOUBLE) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_DOUBLE, {size});
-            auto output_flat = output_tensor.flat<double>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<double>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          } else if (output_types[i] == DT_STRING) {
-            auto values_vector = field.value<avro::GenericArray>().value();
-            unsigned int size = values_vector.size();
-            Tensor output_tensor(ctx->allocator({}), DT_STRING, {size});
-            auto output_flat = output_tensor.flat<tstring>();
-            for (unsigned int idx = 0; idx < size; idx++) {
-              output_flat(idx) = values_vector[idx].value<string>();
-            }
-            (*out_tensors)[i] = output_tensor;
-          }
-        } break;
-        case avro::AVRO_NULL:
-          switch (output_types[i]) {
-            case DT_BOOL:
-              ((*out_tensors)[i]).scalar<bool>()() =
-                  absl::any_cast<bool>(typed_default_values[i]);
-              break;
-            case DT_INT32:
-              ((*out_tensors)[i]).scalar<int32>()() =
-                  absl::any_cast<int32_t>(typed_default_values[i]);
-              break;
-            case DT_INT64:
-              ((*out_tensors)[i]).scalar<int64>()() =
-                  absl::any_cast<int64_t>(typed_default_values[i]);
-              break;
-            case DT_FLOAT:
-              ((*out_tensors)[i]).scalar<float>()() =
-                  absl::any_cast<float>(typed_default_values[i]);
-              break;
-            case DT_DOUBLE:
-              ((*out_tensors)[i]).scalar<double>()() =
-                  absl::any_cast<double>(typed_default_values[i]);
-              break;
-            case DT_STRING:
-              ((*out_tensors)[i]).scalar<tstring>()() =
-                  absl::any_cast<string>(typed_default_values[i]);
-              break;
-            default:
-              return errors::InvalidArgument(
-                  "unsupported data type against AVRO_NULL: ", output_types[i]);
-          }
-          break;
-        default:
-          return errors::InvalidArgument("unsupported data type: ",
-                                         field.type());
-      }
+      out_tensors->emplace_back(ctx->allocator({}), output_types[i], shape);
+    }
+    for (int64 row = 0; row < *num_rows; row++) {
+      TF_RETURN_IF_ERROR(this->row_decoder_.Decode(
+          *this->decoder_, ctx->allocator({}), typed_default_values,
+          batch_size > 0 ? row : 0, out_tensors));
     }
 
     return OkStatus();
@@ -565,9 +596,9 @@ class BigQueryReaderAvroDatasetIterator
  private:
   std::unique_ptr<avro::InputStream> memory_input_stream_
       TF_GUARDED_BY(this->mu_);
-  std::unique_ptr<avro::GenericDatum> datum_ TF_GUARDED_BY(this->mu_);
   avro::DecoderPtr decoder_ TF_GUARDED_BY(this->mu_);
-  std::vector<size_t> column_indices_ TF_GUARDED_BY(this->mu_);
+  BigQueryAvroRowDecoder row_decoder_ TF_GUARDED_BY(this->mu_);
+  bool row_decoder_initialized_ TF_GUARDED_BY(this->mu_) = false;
 };
 
 }  // namespace data
@@ -12,6 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <deque>
+
 #include "absl/memory/memory.h"
 #include "google/cloud/bigtable/row_set.h"
 #include "google/cloud/bigtable/table.h"
@@ -22,9 +24,11 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow_io/core/kernels/bigtable/bigtable_row_set.h"
 #include "tensorflow_io/core/kernels/bigtable/bigtable_version_filters.h"
 #include "tensorflow_io/core/kernels/bigtable/serialization.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
 
 namespace cbt = ::google::cloud::bigtable;
 
@@ -99,11 +103,22 @@ class BigtableClientResource : public ResourceBase {
   string DebugString() const override { return "BigtableClientResource"; }
 
  private:
+  // The data client, and so its channels, of an instance is shared by the
+  // resources of the process.
   std::shared_ptr<cbt::DataClient> CreateDataClient(
       const std::string& project_id, const std::string& instance_id) {
-    VLOG(1) << "CreateDataClient";
-    return cbt::CreateDefaultDataClient(project_id, instance_id,
-                                        cbt::ClientOptions());
+    std::shared_ptr<cbt::DataClient> data_client;
+    ConnectionPool<cbt::DataClient>::Default()
+        ->Share(strings::StrCat(project_id, "/", instance_id),
+                [&](std::shared_ptr<cbt::DataClient>* client) -> Status {
+                  VLOG(1) << "CreateDataClient";
+                  *client = cbt::CreateDefaultDataClient(
+                      project_id, instance_id, cbt::ClientOptions());
+                  return OkStatus();
+                },
+                &data_client)
+        .IgnoreError();
+    return data_client;
   }
   std::shared_ptr<cbt::DataClient> data_client_;
 };
@@ -141,6 +156,81 @@ class BigtableClientOp : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("BigtableClient").Device(DEVICE_CPU),
                         BigtableClientOp);
 
+// we're using a map with const refs to avoid copying strings when searching
+// for a value.
+using ColumnToIdxMap =
+    absl::flat_hash_map<std::pair<const std::string&, const std::string&>,
+                        size_t>;
+
+// Splits the row set into up to `num_splits` row sets of consecutive tablets
+// of the table, based on SampleRows.
+Status SplitRowSetEvenly(cbt::Table& table, const cbt::RowSet& row_set,
+                         size_t num_splits, std::vector<cbt::RowSet>* splits);
+
+// Reads the rows of a row set, a number of them at a time, to a tensor with
+// a row of cells per row.
+class RowsReader {
+ public:
+  RowsReader(cbt::Table table, const cbt::RowSet& row_set,
+             const cbt::Filter& filter, const ColumnToIdxMap& column_to_idx,
+             DataType dtype)
+      : reader_(table.ReadRows(row_set, filter)),
+        it_(reader_.begin()),
+        column_to_idx_(column_to_idx),
+        dtype_(dtype) {}
+
+  // Reads up to `max_rows` rows to `rows`, of shape [num_rows, num_columns].
+  // `done` is set once the last row has been read. The cells of the rows are
+  // gathered by column and every column is decoded at once.
+  Status Read(Allocator* allocator, int64 max_rows, Tensor* rows,
+              bool* done) {
+    const int64 num_columns = column_to_idx_.size();
+    Tensor res(allocator, dtype_, {max_rows, num_columns});
+    // The rows keep the cells alive until the columns are decoded.
+    std::deque<cbt::Row> batch;
+    std::vector<std::vector<size_t>> column_indices(num_columns);
+    std::vector<std::vector<cbt::Cell const*>> column_cells(num_columns);
+    int64 num_rows = 0;
+    for (; num_rows < max_rows && it_ != reader_.end(); num_rows++) {
+      auto& row = *it_;
+      if (!row.ok()) {
+        LOG(ERROR) << row.status().message();
+        return GoogleCloudStatusToTfStatus(row.status());
+      }
+      batch.push_back(std::move(row).value());
+      for (const auto& cell : batch.back().cells()) {
+        std::pair<const std::string&, const std::string&> key(
+            cell.family_name(), cell.column_qualifier());
+        const auto column_idx = column_to_idx_.find(key);
+        if (column_idx != column_to_idx_.end()) {
+          VLOG(1) << "getting column:" << column_idx->second;
+          column_indices[column_idx->second].push_back(
+              num_rows * num_columns + column_idx->second);
+          column_cells[column_idx->second].push_back(&cell);
+        } else {
+          LOG(ERROR) << "column " << cell.family_name() << ":"
+                     << cell.column_qualifier()
+                     << " was unexpectedly read from bigtable";
+        }
+      }
+      it_ = std::next(it_);
+    }
+    for (int64 column = 0; column < num_columns; column++) {
+      TF_RETURN_IF_ERROR(io::PutCellValuesInTensor(
+          res, dtype_, column_indices[column], column_cells[column]));
+    }
+    *done = (it_ == reader_.end());
+    *rows = (num_rows < max_rows) ? res.Slice(0, num_rows) : std::move(res);
+    return OkStatus();
+  }
+
+ private:
+  cbt::RowReader reader_;
+  cbt::v1::internal::RowReaderIterator it_;
+  const ColumnToIdxMap& column_to_idx_;
+  const DataType dtype_;
+};
+
 template <typename Dataset>
 class Iterator : public DatasetIterator<Dataset> {
  public:
@@ -148,58 +238,68 @@ class Iterator : public DatasetIterator<Dataset> {
                     const std::vector<std::string>& columns)
       : DatasetIterator<Dataset>(params),
         columns_(ColumnsToFamiliesAndQualifiers(columns)),
-        reader_(this->dataset()->CreateTable().ReadRows(
-            this->dataset()->row_set(),
-            cbt::Filter::Chain(CreateColumnsFilter(columns_),
-                               this->dataset()->filter(),
-                               cbt::Filter::Latest(1)))),
-        it_(this->reader_.begin()),
         column_to_idx_(CreateColumnToIdxMap(columns_)) {
     VLOG(1) << "DatasetIterator ctor";
   }
 
+  ~Iterator() override {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = true;
+      queue_cv_.notify_all();
+    }
+    // Joins the reader threads before the readers are destroyed.
+    threads_.clear();
+  }
+
   Status GetNextInternal(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
                          bool* end_of_sequence) override {
     VLOG(1) << "GetNextInternal";
     mutex_lock l(mu_);
-    if (it_ == reader_.end()) {
+    TF_RETURN_IF_ERROR(EnsureReadersInitialized());
+
+    // Without a batch size each element is one row, which the parallel
+    // readers still read in chunks.
+    const int64 batch_size = this->dataset()->batch_size();
+    if (batch_size <= 0 && current_row_ < current_rows_.dim_size(0)) {
+      out_tensors->emplace_back(
+          tensor::DeepCopy(current_rows_.SubSlice(current_row_++)));
+      *end_of_sequence = false;
+      return OkStatus();
+    }
+
+    Tensor rows;
+    if (threads_.empty()) {
+      if (done_) {
+        VLOG(1) << "End of sequence";
+        *end_of_sequence = true;
+        return OkStatus();
+      }
+      TF_RETURN_IF_ERROR(readers_[0]->Read(ctx->allocator({}),
+                                           std::max<int64>(batch_size, 1),
+                                           &rows, &done_));
+    } else {
+      TF_RETURN_IF_ERROR(Pop(&rows));
+    }
+    if (rows.dim_size(0) == 0) {
       VLOG(1) << "End of sequence";
       *end_of_sequence = true;
       return OkStatus();
     }
     *end_of_sequence = false;
 
-    VLOG(1) << "alocating tensor";
-    const std::size_t kNumCols = column_to_idx_.size();
-    const DataType dtype = this->dataset()->output_type();
-    Tensor res(ctx->allocator({}), dtype, {(long)kNumCols});
-
-    VLOG(1) << "getting row";
-    const auto& row = *it_;
-    if (!row.ok()) {
-      LOG(ERROR) << row.status().message();
-      return GoogleCloudStatusToTfStatus(row.status());
-    }
-    for (const auto& cell : row.value().cells()) {
-      std::pair<const std::string&, const std::string&> key(
-          cell.family_name(), cell.column_qualifier());
-      const auto column_idx = column_to_idx_.find(key);
-      if (column_idx != column_to_idx_.end()) {
-        VLOG(1) << "getting column:" << column_idx->second;
-        TF_RETURN_IF_ERROR(
-            io::PutCellValueInTensor(res, column_idx->second, dtype, cell));
-      } else {
-        LOG(ERROR) << "column " << cell.family_name() << ":"
-                   << cell.column_qualifier()
-                   << " was unexpectedly read from bigtable";
-      }
+    if (batch_size > 0) {
+      out_tensors->emplace_back(std::move(rows));
+    } else if (threads_.empty()) {
+      // A single row, of the shape of the element.
+      Tensor row;
+      CHECK(row.CopyFrom(rows, {rows.dim_size(1)}));
+      out_tensors->emplace_back(std::move(row));
+    } else {
+      current_rows_ = std::move(rows);
+      current_row_ = 1;
+      out_tensors->emplace_back(tensor::DeepCopy(current_rows_.SubSlice(0)));
     }
-    VLOG(1) << "returning value";
-    out_tensors->emplace_back(std::move(res));
-
-    VLOG(1) << "incrementing iterator";
-    it_ = std::next(it_);
-
     return OkStatus();
   }
 
@@ -216,6 +316,91 @@ class Iterator : public DatasetIterator<Dataset> {
   }
 
  private:
+  // Starts reading the row set, split into ranges of tablets that are read
+  // concurrently if num_parallel_reads is more than one.
+  Status EnsureReadersInitialized() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (!readers_.empty()) return OkStatus();
+    cbt::Table table = this->dataset()->CreateTable();
+    cbt::Filter filter =
+        cbt::Filter::Chain(CreateColumnsFilter(columns_),
+                           this->dataset()->filter(), cbt::Filter::Latest(1));
+    const DataType dtype = this->dataset()->output_type();
+    std::vector<cbt::RowSet> row_sets;
+    if (this->dataset()->num_parallel_reads() > 1) {
+      TF_RETURN_IF_ERROR(SplitRowSetEvenly(
+          table, this->dataset()->row_set(),
+          this->dataset()->num_parallel_reads(), &row_sets));
+    }
+    if (row_sets.size() <= 1) {
+      readers_.emplace_back(new RowsReader(table, this->dataset()->row_set(),
+                                           filter, column_to_idx_, dtype));
+      return OkStatus();
+    }
+
+    VLOG(1) << "reading " << row_sets.size() << " row sets in parallel";
+    for (const cbt::RowSet& row_set : row_sets) {
+      readers_.emplace_back(
+          new RowsReader(table, row_set, filter, column_to_idx_, dtype));
+    }
+    const int64 batch_size = this->dataset()->batch_size();
+    const int64 chunk_size = batch_size > 0 ? batch_size : kRowsPerChunk;
+    const size_t capacity = kQueueCapacity * readers_.size();
+    {
+      mutex_lock l(queue_mu_);
+      num_running_ = readers_.size();
+    }
+    for (auto& reader : readers_) {
+      RowsReader* rows_reader = reader.get();
+      threads_.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "bigtable_rows_reader",
+          [this, rows_reader, chunk_size, capacity] {
+            RunReader(rows_reader, chunk_size, capacity);
+          }));
+    }
+    return OkStatus();
+  }
+
+  // Moves the next chunk of rows read by the parallel readers to `rows`,
+  // which is empty once all of them have read their rows.
+  Status Pop(Tensor* rows) {
+    mutex_lock l(queue_mu_);
+    while (queue_.empty() && num_running_ > 0 && status_.ok()) {
+      queue_cv_.wait(l);
+    }
+    TF_RETURN_IF_ERROR(status_);
+    if (queue_.empty()) {
+      *rows = Tensor(this->dataset()->output_type(),
+                     {0, static_cast<int64>(columns_.size())});
+      return OkStatus();
+    }
+    *rows = std::move(queue_.front());
+    queue_.pop_front();
+    queue_cv_.notify_all();
+    return OkStatus();
+  }
+
+  void RunReader(RowsReader* reader, int64 chunk_size, size_t capacity) {
+    Status status;
+    bool done = false;
+    while (!done && status.ok()) {
+      Tensor rows;
+      status = reader->Read(cpu_allocator(), chunk_size, &rows, &done);
+      mutex_lock l(queue_mu_);
+      while (!stop_ && queue_.size() >= capacity) {
+        queue_cv_.wait(l);
+      }
+      if (stop_) return;
+      if (status.ok() && rows.dim_size(0) > 0) {
+        queue_.emplace_back(std::move(rows));
+        queue_cv_.notify_all();
+      }
+    }
+    mutex_lock l(queue_mu_);
+    if (status_.ok()) status_ = status;
+    num_running_--;
+    queue_cv_.notify_all();
+  }
+
   cbt::Filter CreateColumnsFilter(
       const std::vector<std::pair<std::string, std::string>>& columns) {
     VLOG(1) << "CreateColumnsFilter";
@@ -252,14 +437,10 @@ class Iterator : public DatasetIterator<Dataset> {
     return columnPairs;
   }
 
-  static absl::flat_hash_map<std::pair<const std::string&, const std::string&>,
-                             size_t>
-  CreateColumnToIdxMap(
+  static ColumnToIdxMap CreateColumnToIdxMap(
       const std::vector<std::pair<std::string, std::string>>& columns) {
     VLOG(1) << "CreateColumnToIdxMap";
-    absl::flat_hash_map<std::pair<const std::string&, const std::string&>,
-                        size_t>
-        column_map;
+    ColumnToIdxMap column_map;
     std::size_t index = 0;
     for (const auto& column : columns) {
       std::pair<const std::string&, const std::string&> key(column.first,
@@ -269,15 +450,27 @@ class Iterator : public DatasetIterator<Dataset> {
     return column_map;
   }
 
+  // The number of rows the parallel readers read at a time when each
+  // element is one row.
+  static constexpr int64 kRowsPerChunk = 64;
+  // The number of chunks of rows queued per parallel reader.
+  static constexpr size_t kQueueCapacity = 4;
+
   mutex mu_;
   const std::vector<std::pair<std::string, std::string>> columns_;
-  cbt::RowReader reader_ TF_GUARDED_BY(mu_);
-  cbt::v1::internal::RowReaderIterator it_ TF_GUARDED_BY(mu_);
-  // we're using a map with const refs to avoid copying strings when searching
-  // for a value.
-  const absl::flat_hash_map<std::pair<const std::string&, const std::string&>,
-                            size_t>
-      column_to_idx_;
+  const ColumnToIdxMap column_to_idx_;
+  std::vector<std::unique_ptr<RowsReader>> readers_ TF_GUARDED_BY(mu_);
+  bool done_ TF_GUARDED_BY(mu_) = false;
+  // The chunk of rows read in parallel the next rows are emitted from.
+  Tensor current_rows_ TF_GUARDED_BY(mu_);
+  int64 current_row_ TF_GUARDED_BY(mu_) = 0;
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  std::deque<Tensor> queue_ TF_GUARDED_BY(queue_mu_);
+  size_t num_running_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool stop_ TF_GUARDED_BY(queue_mu_) = false;
+  Status status_ TF_GUARDED_BY(queue_mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
 };
 
 class Dataset : public DatasetBase {
@@ -285,16 +478,24 @@ class Dataset : public DatasetBase {
   Dataset(OpKernelContext* ctx,
           const std::shared_ptr<cbt::DataClient>& data_client,
           cbt::RowSet row_set, cbt::Filter filter, std::string table_id,
-          std::vector<std::string> columns, DataType output_type)
+          std::vector<std::string> columns, DataType output_type,
+          int64 batch_size, int64 num_parallel_reads)
       : DatasetBase(DatasetContext(ctx)),
         data_client_(data_client),
         row_set_(std::move(row_set)),
         filter_(std::move(filter)),
         output_type_(std::move(output_type)),
         table_id_(table_id),
-        columns_(columns) {
+        columns_(columns),
+        batch_size_(batch_size),
+        num_parallel_reads_(num_parallel_reads) {
     dtypes_.push_back({output_type_});
-    output_shapes_.push_back({});
+    if (batch_size_ > 0) {
+      output_shapes_.push_back(
+          PartialTensorShape({-1, static_cast<int64>(columns_.size())}));
+    } else {
+      output_shapes_.push_back({});
+    }
   }
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
@@ -332,6 +533,10 @@ class Dataset : public DatasetBase {
 
   const cbt::Filter& filter() const { return filter_; }
 
+  int64 batch_size() const { return batch_size_; }
+
+  int64 num_parallel_reads() const { return num_parallel_reads_; }
+
  protected:
   Status AsGraphDefInternal(SerializationContext* ctx,
                             DatasetGraphDefBuilder* b,
@@ -349,6 +554,8 @@ class Dataset : public DatasetBase {
   DataType output_type_;
   const std::string table_id_;
   const std::vector<std::string> columns_;
+  const int64 batch_size_;
+  const int64 num_parallel_reads_;
   DataTypeVector dtypes_;
   std::vector<PartialTensorShape> output_shapes_;
 };
@@ -359,6 +566,9 @@ class BigtableDatasetOp : public DatasetOpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("table_id", &table_id_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("columns", &columns_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_type", &output_type_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("batch_size", &batch_size_));
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("num_parallel_reads", &num_parallel_reads_));
   }
 
   void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
@@ -380,13 +590,16 @@ class BigtableDatasetOp : public DatasetOpKernel {
 
     *output = new Dataset(
         ctx, client_resource->data_client(), row_set_resource->row_set(),
-        filter_resource->filter(), table_id_, columns_, output_type_);
+        filter_resource->filter(), table_id_, columns_, output_type_,
+        batch_size_, num_parallel_reads_);
   }
 
  private:
   std::string table_id_;
   std::vector<std::string> columns_;
   DataType output_type_;
+  int64 batch_size_;
+  int64 num_parallel_reads_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("BigtableDataset").Device(DEVICE_CPU),
@@ -420,6 +633,48 @@ bool RowSetIntersectsRange(cbt::RowSet const& row_set,
   return !row_set.Intersect(range).IsEmpty();
 }
 
+Status SplitRowSetEvenly(cbt::Table& table, const cbt::RowSet& row_set,
+                         size_t num_splits, std::vector<cbt::RowSet>* splits) {
+  auto maybe_sample_row_keys = table.SampleRows();
+  TF_RETURN_IF_ERROR(
+      GoogleCloudStatusToTfStatus(maybe_sample_row_keys.status()));
+
+  auto& sample_row_keys = maybe_sample_row_keys.value();
+
+  std::vector<std::pair<std::string, std::string>> tablets;
+
+  std::string start_key;
+  for (auto& sample_row_key : sample_row_keys) {
+    auto& end_key = sample_row_key.row_key;
+    tablets.emplace_back(start_key, end_key);
+    start_key = std::move(end_key);
+  }
+  if (!start_key.empty() || tablets.size() == 0) {
+    tablets.emplace_back(start_key, "");
+  }
+  tablets.erase(
+      std::remove_if(tablets.begin(), tablets.end(),
+                     [&row_set](std::pair<std::string, std::string> const& p) {
+                       return !RowSetIntersectsRange(row_set, p.first,
+                                                     p.second);
+                     }),
+      tablets.end());
+
+  VLOG(1) << "got array of tablets of size:" << tablets.size();
+
+  size_t output_size = std::min<std::size_t>(tablets.size(), num_splits);
+  splits->clear();
+  for (size_t i = 0; i < output_size; i++) {
+    size_t start_idx = GetWorkerStartIndex(tablets.size(), output_size, i);
+    size_t next_worker_start_idx =
+        GetWorkerStartIndex(tablets.size(), output_size, i + 1);
+    size_t end_idx = next_worker_start_idx - 1;
+    splits->emplace_back(row_set.Intersect(cbt::RowRange::RightOpen(
+        tablets.at(start_idx).first, tablets.at(end_idx).second)));
+  }
+  return OkStatus();
+}
+
 class BigtableSplitRowSetEvenlyOp : public OpKernel {
  public:
   explicit BigtableSplitRowSetEvenlyOp(OpKernelConstruction* ctx)
@@ -454,35 +709,11 @@ class BigtableSplitRowSetEvenlyOp : public OpKernel {
     }
 
     auto table = cbt::Table(client_resource->data_client(), table_id_);
-    auto maybe_sample_row_keys = table.SampleRows();
+    std::vector<cbt::RowSet> splits;
     OP_REQUIRES_OK(context,
-                   GoogleCloudStatusToTfStatus(maybe_sample_row_keys.status()));
-
-    auto& sample_row_keys = maybe_sample_row_keys.value();
-
-    std::vector<std::pair<std::string, std::string>> tablets;
-
-    std::string start_key;
-    for (auto& sample_row_key : sample_row_keys) {
-      auto& end_key = sample_row_key.row_key;
-      tablets.emplace_back(start_key, end_key);
-      start_key = std::move(end_key);
-    }
-    if (!start_key.empty() || tablets.size() == 0) {
-      tablets.emplace_back(start_key, "");
-    }
-    tablets.erase(
-        std::remove_if(
-            tablets.begin(), tablets.end(),
-            [row_set_resource](std::pair<std::string, std::string> const& p) {
-              return !RowSetIntersectsRange(row_set_resource->row_set(),
-                                            p.first, p.second);
-            }),
-        tablets.end());
-
-    VLOG(1) << "got array of tablets of size:" << tablets.size();
-
-    size_t output_size = std::min<std::size_t>(tablets.size(), num_splits_);
+                   SplitRowSetEvenly(table, row_set_resource->row_set(),
+                                     num_splits_, &splits));
+    size_t output_size = splits.size();
 
     Tensor* output_tensor = NULL;
     OP_REQUIRES_OK(context,
@@ -491,15 +722,8 @@ class BigtableSplitRowSetEvenlyOp : public OpKernel {
     auto output_v = output_tensor->tensor<ResourceHandle, 1>();
 
     for (size_t i = 0; i < output_size; i++) {
-      size_t start_idx = GetWorkerStartIndex(tablets.size(), output_size, i);
-      size_t next_worker_start_idx =
-          GetWorkerStartIndex(tablets.size(), output_size, i + 1);
-      size_t end_idx = next_worker_start_idx - 1;
-      start_key = tablets.at(start_idx).first;
-      std::string end_key = tablets.at(end_idx).second;
       io::BigtableRowSetResource* work_chunk_row_set =
-          new io::BigtableRowSetResource(row_set_resource->Intersect(
-              cbt::RowRange::RightOpen(start_key, end_key)));
+          new io::BigtableRowSetResource(std::move(splits[i]));
 
       std::string container_name = cinfo.name() + std::to_string(i);
 
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/bigtable/serialization.h"
 
+#include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/statusor.h"
 
@@ -135,17 +136,62 @@ inline StatusOr<bool> BytesToBool(const cbt::Cell& cell) {
   return (*bytes.data()) != 0;
 }
 
+// Loads the big-endian unsigned integer at bytes, independent of the byte
+// order of the host. Compilers turn this into a load and a byte swap.
+template <typename Bits>
+inline Bits LoadBigEndian(const char* bytes) {
+  Bits bits = 0;
+  for (size_t i = 0; i < sizeof(Bits); ++i) {
+    bits = static_cast<Bits>(bits << 8) | static_cast<uint8_t>(bytes[i]);
+  }
+  return bits;
+}
+
+// Decodes a column of cells of type T, stored as big-endian Bits. The values
+// of the right size are copied back to back into one block, decoded in a
+// loop without branches that the compiler vectorizes, and then scattered to
+// the tensor.
+template <typename T, typename Bits>
+Status PutNumericCellValuesInTensor(
+    Tensor& tensor, DataType cell_type, const std::vector<size_t>& indices,
+    const std::vector<cbt::Cell const*>& cells) {
+  static_assert(sizeof(T) == sizeof(Bits), "T and Bits differ in size");
+  std::vector<char> bytes(cells.size() * sizeof(T));
+  std::vector<size_t> targets;
+  targets.reserve(cells.size());
+  for (size_t i = 0; i < cells.size(); ++i) {
+    std::string const& value = cells[i]->value();
+    if (value.size() != sizeof(T)) {
+      TF_RETURN_IF_ERROR(
+          PutCellValueInTensor(tensor, indices[i], cell_type, *cells[i]));
+      continue;
+    }
+    memcpy(bytes.data() + targets.size() * sizeof(T), value.data(), sizeof(T));
+    targets.push_back(indices[i]);
+  }
+  std::vector<T> values(targets.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const Bits bits = LoadBigEndian<Bits>(bytes.data() + i * sizeof(T));
+    memcpy(&values[i], &bits, sizeof(T));
+  }
+  auto tensor_data = tensor.flat<T>();
+  for (size_t i = 0; i < values.size(); ++i) {
+    tensor_data(targets[i]) = values[i];
+  }
+  return OkStatus();
+}
+
 }  // namespace
 
 Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
                             google::cloud::bigtable::Cell const& cell) {
   switch (cell_type) {
     case DT_STRING: {
-      auto tensor_data = tensor.tensor<tstring, 1>();
+      auto tensor_data = tensor.flat<tstring>();
       tensor_data(index) = std::string(cell.value());
     } break;
     case DT_BOOL: {
-      auto tensor_data = tensor.tensor<bool, 1>();
+      auto tensor_data = tensor.flat<bool>();
       auto maybe_parsed_data = BytesToBool(cell);
       if (!maybe_parsed_data.ok()) {
         return maybe_parsed_data.status();
@@ -153,7 +199,7 @@ Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
       tensor_data(index) = maybe_parsed_data.value();
     } break;
     case DT_INT32: {
-      auto tensor_data = tensor.tensor<int32_t, 1>();
+      auto tensor_data = tensor.flat<int32_t>();
       auto maybe_parsed_data = BytesToInt32(cell);
       if (!maybe_parsed_data.ok()) {
         return maybe_parsed_data.status();
@@ -161,7 +207,7 @@ Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
       tensor_data(index) = maybe_parsed_data.value();
     } break;
     case DT_INT64: {
-      auto tensor_data = tensor.tensor<int64_t, 1>();
+      auto tensor_data = tensor.flat<int64_t>();
       auto maybe_parsed_data = BytesToInt64(cell);
       if (!maybe_parsed_data.ok()) {
         return maybe_parsed_data.status();
@@ -169,7 +215,7 @@ Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
       tensor_data(index) = maybe_parsed_data.value();
     } break;
     case DT_FLOAT: {
-      auto tensor_data = tensor.tensor<float, 1>();
+      auto tensor_data = tensor.flat<float>();
       auto maybe_parsed_data = BytesToFloat(cell);
       if (!maybe_parsed_data.ok()) {
         return maybe_parsed_data.status();
@@ -177,7 +223,7 @@ Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
       tensor_data(index) = maybe_parsed_data.value();
     } break;
     case DT_DOUBLE: {
-      auto tensor_data = tensor.tensor<double, 1>();
+      auto tensor_data = tensor.flat<double>();
       auto maybe_parsed_data = BytesToDouble(cell);
       if (!maybe_parsed_data.ok()) {
         return maybe_parsed_data.status();
@@ -190,5 +236,48 @@ Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
   return OkStatus();
 }
 
+Status PutCellValuesInTensor(Tensor& tensor, DataType cell_type,
+                             const std::vector<size_t>& indices,
+                             const std::vector<cbt::Cell const*>& cells) {
+  // The block decode assumes that floats have the byte order of integers,
+  // which holds on little-endian hosts.
+  if ((cell_type == DT_FLOAT || cell_type == DT_DOUBLE) &&
+      !port::kLittleEndian) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+      TF_RETURN_IF_ERROR(
+          PutCellValueInTensor(tensor, indices[i], cell_type, *cells[i]));
+    }
+    return OkStatus();
+  }
+  switch (cell_type) {
+    case DT_STRING: {
+      auto tensor_data = tensor.flat<tstring>();
+      for (size_t i = 0; i < cells.size(); ++i) {
+        std::string const& value = cells[i]->value();
+        tensor_data(indices[i]).assign(value.data(), value.size());
+      }
+    } break;
+    case DT_INT32:
+      return PutNumericCellValuesInTensor<int32_t, uint32_t>(
+          tensor, cell_type, indices, cells);
+    case DT_INT64:
+      return PutNumericCellValuesInTensor<int64_t, uint64_t>(
+          tensor, cell_type, indices, cells);
+    case DT_FLOAT:
+      return PutNumericCellValuesInTensor<float, uint32_t>(
+          tensor, cell_type, indices, cells);
+    case DT_DOUBLE:
+      return PutNumericCellValuesInTensor<double, uint64_t>(
+          tensor, cell_type, indices, cells);
+    default:
+      // Bools are a byte each, there is nothing to swap
+      for (size_t i = 0; i < cells.size(); ++i) {
+        TF_RETURN_IF_ERROR(
+            PutCellValueInTensor(tensor, indices[i], cell_type, *cells[i]));
+      }
+  }
+  return OkStatus();
+}
+
 }  // namespace io
 }  // namespace tensorflow
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef SERIALIZATION_H
 #define SERIALIZATION_H
 
+#include <vector>
+
 #include "google/cloud/bigtable/table.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -39,6 +41,15 @@ namespace io {
 Status PutCellValueInTensor(Tensor& tensor, size_t index, DataType cell_type,
                             google::cloud::bigtable::Cell const& cell);
 
+// Puts the cells of one column of a batch of rows at the given indices of the
+// tensor. Numeric cells are gathered into one block, which is decoded in a
+// single pass rather than cell by cell, and strings are copied once into the
+// tensor. Cells that do not have the size of the type go through
+// PutCellValueInTensor, and so do floats on big-endian hosts.
+Status PutCellValuesInTensor(
+    Tensor& tensor, DataType cell_type, const std::vector<size_t>& indices,
+    const std::vector<google::cloud::bigtable::Cell const*>& cells);
+
 }  // namespace io
 }  // namespace tensorflow
 
@@ -0,0 +1,173 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_CONNECTION_POOL_H_
+#define TENSORFLOW_IO_CORE_KERNELS_CONNECTION_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+namespace data {
+
+// A process-wide pool of connections or clients, keyed by endpoint, so that
+// the resources and iterators of a connector reuse them instead of each
+// opening and tearing down connections of their own.
+//
+// Acquire() leases a connection exclusively, which goes back to the pool
+// once the lease is released, and reused connections are health checked
+// first. Share() hands out one client per key to all its users, for clients
+// that are thread safe. Connections and clients left idle for longer than
+// kIdleTimeoutMicros are closed.
+template <typename T, typename Deleter = std::default_delete<T>>
+class ConnectionPool {
+ public:
+  using Connection = std::unique_ptr<T, Deleter>;
+  using CreateFunc = std::function<Status(Connection* connection)>;
+  using SharedCreateFunc = std::function<Status(std::shared_ptr<T>* client)>;
+  using CheckFunc = std::function<bool(T* connection)>;
+
+  explicit ConnectionPool(Env* env) : env_(env) {}
+
+  // The pool of the process, which is never destroyed so that leases may
+  // outlive any of the resources. Leases of other pools must not outlive
+  // their pool.
+  static ConnectionPool* Default() {
+    static ConnectionPool* pool = new ConnectionPool(Env::Default());
+    return pool;
+  }
+
+  // Leases an idle connection of `key` that passes `check`, when given, or
+  // else one made by `create`.
+  Status Acquire(const string& key, const CreateFunc& create,
+                 const CheckFunc& check, std::shared_ptr<T>* connection) {
+    std::vector<Connection> closed;
+    Connection idle;
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        Evict(env_->NowMicros(), &closed);
+        auto it = idle_.find(key);
+        if (it != idle_.end() && !it->second.empty()) {
+          idle = std::move(it->second.back().connection);
+          it->second.pop_back();
+        }
+      }
+      // The check may take a round trip, so it is made without the lock.
+      if (idle == nullptr || !check || check(idle.get())) {
+        break;
+      }
+      closed.push_back(std::move(idle));
+    }
+    closed.clear();
+    if (idle == nullptr) {
+      TF_RETURN_IF_ERROR(create(&idle));
+      if (idle == nullptr) {
+        return errors::Internal("failed to create connection to ", key);
+      }
+    }
+    connection->reset(idle.release(),
+                      [this, key](T* p) { Release(key, Connection(p)); });
+    return OkStatus();
+  }
+
+  // Returns the client of `key`, made by `create` if there is none.
+  Status Share(const string& key, const SharedCreateFunc& create,
+               std::shared_ptr<T>* client) {
+    std::vector<std::shared_ptr<T>> closed;
+    mutex_lock l(mu_);
+    const uint64 now = env_->NowMicros();
+    for (auto it = shared_.begin(); it != shared_.end();) {
+      if (it->second.client.use_count() == 1 &&
+          now - it->second.used_micros > kIdleTimeoutMicros) {
+        closed.push_back(std::move(it->second.client));
+        it = shared_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto it = shared_.find(key);
+    if (it == shared_.end()) {
+      std::shared_ptr<T> created;
+      TF_RETURN_IF_ERROR(create(&created));
+      it = shared_.emplace(key, SharedClient{std::move(created), now}).first;
+    }
+    it->second.used_micros = now;
+    *client = it->second.client;
+    return OkStatus();
+  }
+
+ private:
+  struct IdleConnection {
+    Connection connection;
+    uint64 idle_micros;
+  };
+  struct SharedClient {
+    std::shared_ptr<T> client;
+    uint64 used_micros;
+  };
+
+  void Release(const string& key, Connection connection) {
+    std::vector<Connection> closed;
+    mutex_lock l(mu_);
+    const uint64 now = env_->NowMicros();
+    Evict(now, &closed);
+    std::vector<IdleConnection>& idle = idle_[key];
+    if (idle.size() < kMaxIdlePerKey) {
+      idle.push_back(IdleConnection{std::move(connection), now});
+    } else {
+      closed.push_back(std::move(connection));
+    }
+  }
+
+  // Moves the connections idle for too long to `closed`, to be closed once
+  // the lock is released.
+  void Evict(const uint64 now, std::vector<Connection>* closed)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    for (auto it = idle_.begin(); it != idle_.end();) {
+      // The most recently released connections are at the back.
+      std::vector<IdleConnection>& idle = it->second;
+      size_t expired = 0;
+      while (expired < idle.size() &&
+             now - idle[expired].idle_micros > kIdleTimeoutMicros) {
+        closed->push_back(std::move(idle[expired].connection));
+        expired++;
+      }
+      idle.erase(idle.begin(), idle.begin() + expired);
+      it = idle.empty() ? idle_.erase(it) : std::next(it);
+    }
+  }
+
+  static constexpr uint64 kIdleTimeoutMicros = 60 * 1000 * 1000;
+  static constexpr size_t kMaxIdlePerKey = 64;
+
+  Env* const env_;
+  mutex mu_;
+  std::unordered_map<string, std::vector<IdleConnection>> idle_
+      TF_GUARDED_BY(mu_);
+  std::unordered_map<string, SharedClient> shared_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_CONNECTION_POOL_H_
@@ -126,7 +126,10 @@ class CPUFeatureCheck {
 #endif  // __FMA__
     if (!missing_instructions.empty()) {
       LOG(INFO) << "Your CPU supports instructions that this TensorFlow IO "
-                << "binary was not compiled to use:" << missing_instructions;
+                << "binary was not compiled to use:" << missing_instructions
+                << ". Its hot kernels still use the instruction set "
+                << DispatchISAName(MaxDispatchISA())
+                << " through runtime dispatch.";
     }
   }
 };
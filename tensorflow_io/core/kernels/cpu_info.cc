@@ -21,6 +21,16 @@ limitations under the License.
 #if defined(PLATFORM_IS_X86)
 #include <mutex>  // NOLINT
 #endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 // SIMD extension querying is only available on x86.
 #ifdef PLATFORM_IS_X86
@@ -318,6 +328,65 @@ bool TestCPUFeature(CPUFeature feature) {
 #endif
 }
 
+namespace {
+
+DispatchISA SupportedDispatchISA() {
+  if (!TestCPUFeature(SSSE3) || !TestCPUFeature(SSE4_1) ||
+      !TestCPUFeature(SSE4_2) || !TestCPUFeature(POPCNT)) {
+    return DispatchISA::kBaseline;
+  }
+  if (!TestCPUFeature(AVX)) {
+    return DispatchISA::kSSE4_2;
+  }
+  if (!TestCPUFeature(AVX2) || !TestCPUFeature(FMA)) {
+    return DispatchISA::kAVX;
+  }
+  if (!TestCPUFeature(AVX512F) || !TestCPUFeature(AVX512BW) ||
+      !TestCPUFeature(AVX512DQ) || !TestCPUFeature(AVX512VL)) {
+    return DispatchISA::kAVX2;
+  }
+  return DispatchISA::kAVX512;
+}
+
+}  // namespace
+
+DispatchISA MaxDispatchISA() {
+  static const DispatchISA isa = [] {
+    DispatchISA supported = SupportedDispatchISA();
+    const char* cap = getenv("TFIO_CPU_ISA");
+    if (cap == nullptr || *cap == '\0') {
+      return supported;
+    }
+    for (DispatchISA level :
+         {DispatchISA::kBaseline, DispatchISA::kSSE4_2, DispatchISA::kAVX,
+          DispatchISA::kAVX2, DispatchISA::kAVX512}) {
+      if (strcmp(cap, DispatchISAName(level)) == 0) {
+        return std::min(supported, level);
+      }
+    }
+    LOG(WARNING) << "Ignoring TFIO_CPU_ISA=" << cap << ", which is none of "
+                 << "baseline, sse4.2, avx, avx2 and avx512.";
+    return supported;
+  }();
+  return isa;
+}
+
+const char* DispatchISAName(DispatchISA isa) {
+  switch (isa) {
+    case DispatchISA::kBaseline:
+      return "baseline";
+    case DispatchISA::kSSE4_2:
+      return "sse4.2";
+    case DispatchISA::kAVX:
+      return "avx";
+    case DispatchISA::kAVX2:
+      return "avx2";
+    case DispatchISA::kAVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
 std::string CPUVendorIDString() {
 #ifdef PLATFORM_IS_X86
   InitCPUIDInfo();
@@ -368,5 +437,77 @@ int CPUIDNumSMT() {
   return 0;
 }
 
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus) {
+  cpus->clear();
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    // Tolerates the trailing newline of the sysfs files.
+    while (!range.empty() && isspace(range.back())) {
+      range.pop_back();
+    }
+    if (range.empty()) {
+      continue;
+    }
+    // strtol also takes signs and spaces, and reads no digits at all as 0, so
+    // both ends must start with a digit.
+    char* end = nullptr;
+    bool valid = isdigit(static_cast<unsigned char>(range[0]));
+    const long first = strtol(range.c_str(), &end, 10);
+    long last = first;
+    if (*end == '-') {
+      valid = valid && isdigit(static_cast<unsigned char>(end[1]));
+      last = strtol(end + 1, &end, 10);
+    }
+    if (!valid || *end != '\0' || last < first) {
+      cpus->clear();
+      return false;
+    }
+    for (long cpu = first; cpu <= last; cpu++) {
+      cpus->push_back(static_cast<int>(cpu));
+    }
+  }
+  return true;
+}
+
+int NumNUMANodes() {
+  std::ifstream file("/sys/devices/system/node/online");
+  std::string list;
+  std::vector<int> nodes;
+  if (!std::getline(file, list) || !ParseCPUList(list, &nodes) ||
+      nodes.empty()) {
+    return 1;
+  }
+  return nodes.back() + 1;
+}
+
+std::vector<int> NUMANodeCPUs(int numa_node) {
+  std::ifstream file("/sys/devices/system/node/node" +
+                     std::to_string(numa_node) + "/cpulist");
+  std::string list;
+  std::vector<int> cpus;
+  if (!std::getline(file, list) || !ParseCPUList(list, &cpus)) {
+    return {};
+  }
+  return cpus;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  // A pid of 0 is the calling thread.
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace io
 }  // namespace tensorflow
@@ -19,6 +19,7 @@ limitations under the License.
 // NOTE: This file is from tensorflow repo. We make a copy here.
 
 #include <string>
+#include <vector>
 
 // TODO(ahentz): This is not strictly required here but, for historical
 // reasons, many people depend on cpu_info.h in order to use kLittleEndian.
@@ -29,6 +30,20 @@ limitations under the License.
 #include <intrin.h>
 #endif
 
+// Hot kernels are compiled once for the baseline of the library and once
+// more, with TFIO_TARGET, for each instruction set in DispatchISA, and the
+// widest variant the CPU supports is picked at runtime with CanDispatch, so
+// that one build runs on any x86-64 CPU and still uses AVX2 or AVX-512 where
+// they are available. On aarch64 NEON is part of the baseline.
+#if defined(__x86_64__) || defined(_M_X64)
+#define TFIO_DISPATCH_X86
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TFIO_TARGET(isa)
+#else
+#define TFIO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
 namespace tensorflow {
 namespace io {
 
@@ -130,6 +145,32 @@ enum CPUFeature {
 // Checks CPU registers to return hardware capabilities.
 bool TestCPUFeature(CPUFeature feature);
 
+// Instruction sets that hot kernels are compiled for besides the baseline,
+// from the narrowest to the widest. Each level requires the features of the
+// ones below it:
+//   kSSE4_2: SSSE3, SSE4.1, SSE4.2 and POPCNT,
+//   kAVX: AVX,
+//   kAVX2: AVX2 and FMA,
+//   kAVX512: AVX-512 F, BW, DQ and VL.
+enum class DispatchISA {
+  kBaseline = 0,
+  kSSE4_2 = 1,
+  kAVX = 2,
+  kAVX2 = 3,
+  kAVX512 = 4,
+};
+
+// Returns the widest level supported by the CPU, capped by the TFIO_CPU_ISA
+// environment variable if it is set to "baseline", "sse4.2", "avx", "avx2"
+// or "avx512", e.g. to benchmark a narrower variant. Computed once.
+DispatchISA MaxDispatchISA();
+
+// Whether the kernels compiled for `isa` may run on this CPU.
+inline bool CanDispatch(DispatchISA isa) { return isa <= MaxDispatchISA(); }
+
+// Returns the TFIO_CPU_ISA name of `isa`.
+const char* DispatchISAName(DispatchISA isa);
+
 // Returns CPU Vendor string (i.e. 'GenuineIntel', 'AuthenticAMD', etc.)
 std::string CPUVendorIDString();
 
@@ -145,6 +186,22 @@ double NominalCPUFrequency();
 // Returns num of hyperthreads per physical core
 int CPUIDNumSMT();
 
+// Parses a list of CPUs such as "0-3,8,10-11", the format of
+// /sys/devices/system/node/node*/cpulist, into `cpus`. Returns false if
+// the list is malformed.
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus);
+
+// Returns the number of NUMA nodes of the system, or 1 if the topology
+// cannot be read.
+int NumNUMANodes();
+
+// Returns the CPUs of `numa_node`, or none if the topology cannot be read.
+std::vector<int> NUMANodeCPUs(int numa_node);
+
+// Restricts the calling thread to run on `cpus`. Returns false if thread
+// affinity is not supported on the platform or cannot be set.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
 }  // namespace io
 }  // namespace tensorflow
 
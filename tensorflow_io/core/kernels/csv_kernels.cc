@@ -13,13 +13,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <deque>
+
 #include "arrow/array.h"
 #include "arrow/csv/reader.h"
 #include "arrow/memory_pool.h"
+#include "arrow/record_batch.h"
 #include "arrow/table.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_kernels.h"
+#include "tensorflow_io/core/kernels/arrow/arrow_util.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
@@ -44,29 +49,65 @@ class CSVReadable : public IOReadableInterface {
 
     csv_file_.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
 
-    auto result = ::arrow::csv::TableReader::Make(
-        ::arrow::default_memory_pool(), ::arrow::io::default_io_context(),
-        csv_file_, ::arrow::csv::ReadOptions::Defaults(),
-        ::arrow::csv::ParseOptions::Defaults(),
-        ::arrow::csv::ConvertOptions::Defaults());
-    if (!result.status().ok()) {
-      return errors::InvalidArgument("unable to make a TableReader: ",
-                                     result.status());
+    ::arrow::csv::ReadOptions read_options =
+        ::arrow::csv::ReadOptions::Defaults();
+    ::arrow::csv::ParseOptions parse_options =
+        ::arrow::csv::ParseOptions::Defaults();
+    ::arrow::csv::ConvertOptions convert_options =
+        ::arrow::csv::ConvertOptions::Defaults();
+    // In streaming mode, only the bytes [offset, offset + length) of the
+    // file are read, from the line starting at or after offset to the line
+    // starting at or after offset + length, so that splits of a file can be
+    // read by different workers.
+    int64 offset = 0;
+    int64 length = -1;
+    for (size_t i = 0; i < metadata.size(); i++) {
+      TF_RETURN_IF_ERROR(ParseOption(metadata[i], &read_options,
+                                     &parse_options, &convert_options));
+      if (metadata[i].find("stream: ") == 0) {
+        stream_ = (metadata[i].substr(8) == "true");
+      } else if (metadata[i].find("offset: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &offset) ||
+            offset < 0) {
+          return errors::InvalidArgument("invalid offset: ", metadata[i]);
+        }
+      } else if (metadata[i].find("length: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &length)) {
+          return errors::InvalidArgument("invalid length: ", metadata[i]);
+        }
+      }
     }
-    reader_ = std::move(result).ValueUnsafe();
 
-    {
-      auto result = reader_->Read();
+    std::shared_ptr<::arrow::Schema> schema;
+    if (stream_) {
+      TF_RETURN_IF_ERROR(InitStream(offset, length, read_options,
+                                    parse_options, convert_options, &schema));
+    } else {
+      auto result = ::arrow::csv::TableReader::Make(
+          ::arrow::io::default_io_context(), csv_file_, read_options,
+          parse_options, convert_options);
       if (!result.status().ok()) {
-        return errors::InvalidArgument("unable to read table: ",
+        return errors::InvalidArgument("unable to make a TableReader: ",
                                        result.status());
       }
-      table_ = std::move(result).ValueUnsafe();
+      reader_ = std::move(result).ValueUnsafe();
+
+      {
+        io::IOTrace trace("csv", io::IOTraceStage::kDecode);
+        auto result = reader_->Read();
+        if (!result.status().ok()) {
+          return errors::InvalidArgument("unable to read table: ",
+                                         result.status());
+        }
+        table_ = std::move(result).ValueUnsafe();
+        trace.AddRecords(table_->num_rows());
+      }
+      schema = table_->schema();
     }
 
-    for (int i = 0; i < table_->num_columns(); i++) {
+    for (int i = 0; i < schema->num_fields(); i++) {
       ::tensorflow::DataType dtype;
-      switch (table_->column(i)->type()->id()) {
+      switch (schema->field(i)->type()->id()) {
         case ::arrow::Type::BOOL:
           dtype = ::tensorflow::DT_BOOL;
           break;
@@ -119,13 +160,16 @@ class CSVReadable : public IOReadableInterface {
         case ::arrow::Type::DICTIONARY:
         case ::arrow::Type::MAP:
         default:
-          return errors::InvalidArgument("arrow data type is not supported: ",
-                                         table_->column(i)->type()->ToString());
+          return errors::InvalidArgument(
+              "arrow data type is not supported: ",
+              schema->field(i)->type()->ToString());
       }
-      shapes_.push_back(TensorShape({static_cast<int64>(table_->num_rows())}));
+      // The number of rows of a stream is not known until it is read.
+      shapes_.push_back(stream_ ? PartialTensorShape({-1})
+                                : PartialTensorShape({table_->num_rows()}));
       dtypes_.push_back(dtype);
-      columns_.push_back(table_->ColumnNames()[i]);
-      columns_index_[table_->ColumnNames()[i]] = i;
+      columns_.push_back(schema->field(i)->name());
+      columns_index_[schema->field(i)->name()] = i;
     }
 
     return OkStatus();
@@ -160,6 +204,9 @@ class CSVReadable : public IOReadableInterface {
     int64 column_index = columns_index_[component];
 
     (*record_read) = 0;
+    if (stream_) {
+      return ReadStream(start, stop, column_index, record_read, value, label);
+    }
     if (start >= shapes_[column_index].dim_size(0)) {
       return OkStatus();
     }
@@ -181,11 +228,255 @@ class CSVReadable : public IOReadableInterface {
 
     std::shared_ptr<::arrow::ChunkedArray> slice =
         table_->column(column_index)->Slice(element_start, element_stop);
+    TF_RETURN_IF_ERROR(FillColumn(*slice, value, label));
+    (*record_read) = element_stop - element_start;
+
+    return OkStatus();
+  }
+
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return strings::StrCat("CSVReadable");
+  }
+
+ private:
+  // Applies an option of the reader, given in the init metadata:
+  //   include_column: <name>, the only columns to convert, in order of
+  //     appearance, other columns are skipped without being converted.
+  //   column_type: <dtype enum> <name>, the type of a column, which is
+  //     then not inferred.
+  //   delimiter: <char>, quote_char: <char>, empty to disable quoting,
+  //     escape_char: <char>, double_quote: true|false.
+  //   use_threads: true|false, block_size: <bytes>.
+  Status ParseOption(const string& option,
+                     ::arrow::csv::ReadOptions* read_options,
+                     ::arrow::csv::ParseOptions* parse_options,
+                     ::arrow::csv::ConvertOptions* convert_options) {
+    auto parse_char = [&option](const string& value, char* c) -> Status {
+      if (value.size() != 1) {
+        return errors::InvalidArgument("invalid character option: ", option);
+      }
+      *c = value[0];
+      return OkStatus();
+    };
+    if (option.find("include_column: ") == 0) {
+      convert_options->include_columns.push_back(option.substr(16));
+    } else if (option.find("column_type: ") == 0) {
+      const string value = option.substr(13);
+      const size_t separator = value.find(' ');
+      int32 dtype;
+      if (separator == string::npos ||
+          !strings::safe_strto32(value.substr(0, separator), &dtype)) {
+        return errors::InvalidArgument("invalid column type: ", option);
+      }
+      std::shared_ptr<::arrow::DataType> type;
+      TF_RETURN_IF_ERROR(ArrowUtil::GetArrowType(
+          static_cast<::tensorflow::DataType>(dtype), &type));
+      convert_options->column_types[value.substr(separator + 1)] = type;
+    } else if (option.find("delimiter: ") == 0) {
+      TF_RETURN_IF_ERROR(
+          parse_char(option.substr(11), &parse_options->delimiter));
+    } else if (option.find("quote_char: ") == 0) {
+      const string value = option.substr(12);
+      parse_options->quoting = !value.empty();
+      if (parse_options->quoting) {
+        TF_RETURN_IF_ERROR(parse_char(value, &parse_options->quote_char));
+      }
+    } else if (option.find("escape_char: ") == 0) {
+      parse_options->escaping = true;
+      TF_RETURN_IF_ERROR(
+          parse_char(option.substr(13), &parse_options->escape_char));
+    } else if (option.find("double_quote: ") == 0) {
+      parse_options->double_quote = (option.substr(14) == "true");
+    } else if (option.find("use_threads: ") == 0) {
+      read_options->use_threads = (option.substr(13) == "true");
+    } else if (option.find("block_size: ") == 0) {
+      int32 block_size;
+      if (!strings::safe_strto32(option.substr(12), &block_size) ||
+          block_size <= 0) {
+        return errors::InvalidArgument("invalid block size: ", option);
+      }
+      read_options->block_size = block_size;
+    }
+    return OkStatus();
+  }
+
+  // Finds the first line that starts at or after `offset`.
+  Status FindLineStart(const int64 offset, int64* line_start) {
+    if (offset <= 0 || offset >= static_cast<int64>(file_size_)) {
+      *line_start = std::min<int64>(std::max<int64>(offset, 0), file_size_);
+      return OkStatus();
+    }
+    string buffer(kLineScanBytes, '\0');
+    for (int64 position = offset - 1;
+         position < static_cast<int64>(file_size_);) {
+      StringPiece result;
+      Status status =
+          file_->Read(position, kLineScanBytes, &result, &buffer[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      if (result.empty()) {
+        break;
+      }
+      size_t newline = result.find('\n');
+      if (newline != StringPiece::npos) {
+        *line_start = position + newline + 1;
+        return OkStatus();
+      }
+      position += result.size();
+    }
+    *line_start = file_size_;
+    return OkStatus();
+  }
+
+  // Opens a streaming reader over the split that starts at or after
+  // `offset`. The column types are those inferred from the head of the
+  // file, so that every split converts its columns alike.
+  Status InitStream(const int64 offset, const int64 length,
+                    ::arrow::csv::ReadOptions read_options,
+                    const ::arrow::csv::ParseOptions& parse_options,
+                    ::arrow::csv::ConvertOptions convert_options,
+                    std::shared_ptr<::arrow::Schema>* schema) {
+    // The head is read with all the columns, for the names of the header.
+    std::shared_ptr<::arrow::Schema> head;
+    {
+      ::arrow::csv::ConvertOptions head_options = convert_options;
+      head_options.include_columns.clear();
+      auto result = ::arrow::csv::StreamingReader::Make(
+          ::arrow::io::default_io_context(), csv_file_, read_options,
+          parse_options, head_options);
+      if (!result.status().ok()) {
+        return errors::InvalidArgument("unable to make a StreamingReader: ",
+                                       result.status());
+      }
+      head = std::move(result).ValueUnsafe()->schema();
+    }
+    if (convert_options.include_columns.empty()) {
+      *schema = head;
+    } else {
+      ::arrow::FieldVector fields;
+      for (const std::string& name : convert_options.include_columns) {
+        std::shared_ptr<::arrow::Field> field = head->GetFieldByName(name);
+        if (field == nullptr) {
+          return errors::InvalidArgument("column ", name, " is not found");
+        }
+        fields.push_back(field);
+      }
+      *schema = ::arrow::schema(fields);
+    }
+
+    int64 split_start, split_stop;
+    TF_RETURN_IF_ERROR(FindLineStart(offset, &split_start));
+    if (length < 0) {
+      split_stop = file_size_;
+    } else {
+      TF_RETURN_IF_ERROR(FindLineStart(offset + length, &split_stop));
+    }
+    if (split_start > 0) {
+      // Splits past the head have no header line.
+      read_options.column_names = head->field_names();
+    }
+    for (const auto& field : head->fields()) {
+      convert_options.column_types[field->name()] = field->type();
+    }
+    if (split_start >= split_stop) {
+      stream_eof_ = true;
+      return OkStatus();
+    }
+    auto stream = ::arrow::io::RandomAccessFile::GetStream(
+        csv_file_, split_start, split_stop - split_start);
+    if (!stream.status().ok()) {
+      return errors::InvalidArgument("unable to read split: ",
+                                     stream.status());
+    }
+    auto result = ::arrow::csv::StreamingReader::Make(
+        ::arrow::io::default_io_context(), std::move(stream).ValueUnsafe(),
+        read_options, parse_options, convert_options);
+    if (!result.status().ok()) {
+      return errors::InvalidArgument("unable to make a StreamingReader: ",
+                                     result.status());
+    }
+    stream_reader_ = std::move(result).ValueUnsafe();
+    return OkStatus();
+  }
+
+  // Reads the rows [start, stop) of a column from the record batches of the
+  // stream, parsing the next batches as needed. Batches are dropped once all
+  // the columns read have been read past them, so that columns must be read
+  // in order and about in lockstep.
+  Status ReadStream(const int64 start, const int64 stop,
+                    const int64 column_index, int64* record_read,
+                    Tensor* value, Tensor* label) {
+    mutex_lock l(mu_);
+    while (!stream_eof_ && stream_rows_ < stop) {
+      std::shared_ptr<::arrow::RecordBatch> batch;
+      io::IOTrace trace("csv", io::IOTraceStage::kDecode);
+      ::arrow::Status status = stream_reader_->ReadNext(&batch);
+      if (!status.ok()) {
+        return errors::InvalidArgument("unable to read record batch: ",
+                                       status);
+      }
+      if (batch == nullptr) {
+        stream_eof_ = true;
+        break;
+      }
+      trace.AddRecords(batch->num_rows());
+      batches_.emplace_back(stream_rows_, batch);
+      stream_rows_ += batch->num_rows();
+    }
+    const int64 element_stop = std::min(stop, stream_rows_);
+    if (start >= element_stop) {
+      return OkStatus();
+    }
+    const int64 first_row =
+        batches_.empty() ? stream_rows_ : batches_.front().first;
+    if (start < first_row) {
+      return errors::OutOfRange("rows before ", first_row,
+                                " have been streamed past");
+    }
+
+    ::arrow::ArrayVector arrays;
+    for (const auto& entry : batches_) {
+      const int64 batch_start = entry.first;
+      const int64 batch_stop = batch_start + entry.second->num_rows();
+      if (batch_stop <= start || element_stop <= batch_start) {
+        continue;
+      }
+      const int64 slice_start = std::max(start, batch_start);
+      const int64 slice_stop = std::min(element_stop, batch_stop);
+      arrays.push_back(entry.second->column(column_index)
+                           ->Slice(slice_start - batch_start,
+                                   slice_stop - slice_start));
+    }
+    TF_RETURN_IF_ERROR(FillColumn(::arrow::ChunkedArray(arrays), value, label));
+    (*record_read) = element_stop - start;
+
+    progress_[column_index] = element_stop;
+    int64 read = element_stop;
+    for (const auto& entry : progress_) {
+      read = std::min(read, entry.second);
+    }
+    while (!batches_.empty() &&
+           batches_.front().first + batches_.front().second->num_rows() <=
+               read) {
+      batches_.pop_front();
+    }
+    return OkStatus();
+  }
 
+  // Copies the values of `slice`, and whether each is null, to the tensors.
+  Status FillColumn(const ::arrow::ChunkedArray& slice, Tensor* value,
+                    Tensor* label) {
+    io::IOTrace trace("csv", io::IOTraceStage::kFill);
+    trace.AddRecords(slice.length());
+    if (value != nullptr && value->dtype() != DT_STRING) {
+      trace.AddBytes(value->TotalBytes());
+    }
 #define PROCESS_TYPE(TTYPE, ATYPE)                             \
   {                                                            \
     int64 curr_index = 0;                                      \
-    for (auto chunk : slice->chunks()) {                       \
+    for (auto chunk : slice.chunks()) {                        \
       for (int64_t item = 0; item < chunk->length(); item++) { \
         value->flat<TTYPE>()(curr_index) =                     \
             (dynamic_cast<ATYPE*>(chunk.get()))->Value(item);  \
@@ -197,7 +488,7 @@ class CSVReadable : public IOReadableInterface {
 #define PROCESS_STRING_TYPE(ATYPE)                                \
   {                                                               \
     int64 curr_index = 0;                                         \
-    for (auto chunk : slice->chunks()) {                          \
+    for (auto chunk : slice.chunks()) {                           \
       for (int64_t item = 0; item < chunk->length(); item++) {    \
         value->flat<tstring>()(curr_index) =                      \
             (dynamic_cast<ATYPE*>(chunk.get()))->GetString(item); \
@@ -252,24 +543,21 @@ class CSVReadable : public IOReadableInterface {
 
     if (label != nullptr) {
       int64 curr_index = 0;
-      for (auto chunk : slice->chunks()) {
+      for (auto chunk : slice.chunks()) {
         for (int64_t item = 0; item < chunk->length(); item++) {
           label->flat<bool>()(curr_index) = chunk->IsNull(item);
           curr_index++;
         }
       }
     }
-    (*record_read) = element_stop - element_start;
-
+#undef PROCESS_TYPE
+#undef PROCESS_STRING_TYPE
     return OkStatus();
   }
 
-  string DebugString() const override {
-    mutex_lock l(mu_);
-    return strings::StrCat("CSVReadable");
-  }
+  // The bytes read at a time looking for the start of a line.
+  static constexpr int64 kLineScanBytes = 64 << 10;
 
- private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -278,18 +566,30 @@ class CSVReadable : public IOReadableInterface {
   std::shared_ptr<::arrow::csv::TableReader> reader_;
   std::shared_ptr<::arrow::Table> table_;
 
+  bool stream_ = false;
+  std::shared_ptr<::arrow::csv::StreamingReader> stream_reader_
+      TF_GUARDED_BY(mu_);
+  bool stream_eof_ TF_GUARDED_BY(mu_) = false;
+  // The rows parsed so far, and the record batches not read past yet with
+  // their first row.
+  int64 stream_rows_ TF_GUARDED_BY(mu_) = 0;
+  std::deque<std::pair<int64, std::shared_ptr<::arrow::RecordBatch>>> batches_
+      TF_GUARDED_BY(mu_);
+  // The row each column has been read up to.
+  std::unordered_map<int64, int64> progress_ TF_GUARDED_BY(mu_);
+
   std::vector<DataType> dtypes_;
-  std::vector<TensorShape> shapes_;
+  std::vector<PartialTensorShape> shapes_;
   std::vector<string> columns_;
   std::unordered_map<string, int64> columns_index_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>CSVReadableInit").Device(DEVICE_CPU),
-                        IOInterfaceInitOp<CSVReadable>);
+                        IOInterfaceInitOp<IOReadableReadAhead<CSVReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>CSVReadableSpec").Device(DEVICE_CPU),
-                        IOInterfaceSpecOp<CSVReadable>);
+                        IOInterfaceSpecOp<IOReadableReadAhead<CSVReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>CSVReadableRead").Device(DEVICE_CPU),
-                        IOReadableReadOp<CSVReadable>);
+                        IOReadableReadOp<IOReadableReadAhead<CSVReadable>>);
 
 }  // namespace data
 }  // namespace tensorflow
@@ -13,110 +13,408 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
-#include "tensorflow/tsl/platform/cloud/curl_http_request.h"
-
-using namespace tsl;
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
+#include "tensorflow_io/core/kernels/io_interface.h"
 
 namespace tensorflow {
 namespace io {
 namespace {
 
+// The time the scroll and point in time search contexts are kept alive for
+// between two requests.
+static const char kKeepAlive[] = "1m";
+
+// Returns the scheme and authority of `url`, e.g. "http://localhost:9200".
+std::string BaseUrl(const std::string& url) {
+  size_t start = url.find("://");
+  start = (start == std::string::npos) ? 0 : start + 3;
+  return url.substr(0, url.find('/', start));
+}
+
+struct CurlDeleter {
+  void operator()(CURL* curl) const { curl_easy_cleanup(curl); }
+};
+using ElasticsearchConnectionPool = data::ConnectionPool<CURL, CurlDeleter>;
+
+// Sends requests to a node through one curl handle, leased from the handles
+// pooled across the resources of the process on the first request. The
+// handle keeps its connection alive between requests, and between resources,
+// rather than connecting for each one.
+class ElasticsearchConnection {
+ public:
+  ElasticsearchConnection() {}
+
+  // Sends a request with `body`, if not empty, and parses the JSON response.
+  Status Request(const std::string& method, const std::string& url,
+                 const std::string& body, const std::vector<string>& headers,
+                 rapidjson::Document* response_json) {
+    if (curl_ == nullptr) {
+      TF_RETURN_IF_ERROR(ElasticsearchConnectionPool::Default()->Acquire(
+          BaseUrl(url),
+          [](ElasticsearchConnectionPool::Connection* connection) -> Status {
+            connection->reset(curl_easy_init());
+            if (*connection == nullptr) {
+              return errors::Internal("Failed to initialize curl");
+            }
+            return OkStatus();
+          },
+          nullptr, &curl_));
+    }
+    CURL* curl = curl_.get();
+    struct curl_slist* header_list = nullptr;
+    for (const string& header : headers) {
+      std::vector<string> parts = str_util::Split(header, "=");
+      if (parts.size() != 2) {
+        curl_slist_free_all(header_list);
+        return errors::InvalidArgument("invalid header configuration: ",
+                                       header);
+      }
+      header_list = curl_slist_append(
+          header_list, strings::StrCat(parts[0], ": ", parts[1]).c_str());
+    }
+
+    // Resetting the options keeps the connection of the handle alive.
+    curl_easy_reset(curl);
+    std::string response;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    if (!body.empty()) {
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
+                       static_cast<long>(body.size()));
+    }
+    const char* ca_bundle = std::getenv("CURL_CA_BUNDLE");
+    if (ca_bundle != nullptr) {
+      curl_easy_setopt(curl, CURLOPT_CAINFO, ca_bundle);
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    CURLcode code = curl_easy_perform(curl);
+    curl_slist_free_all(header_list);
+    if (code != CURLE_OK) {
+      return errors::Unavailable("Failed to send the request to ", url, ": ",
+                                 curl_easy_strerror(code));
+    }
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code < 200 || response_code >= 300) {
+      return errors::FailedPrecondition("Request to ", url,
+                                        " failed with status ", response_code,
+                                        ": ", response);
+    }
+
+    if (response_json->Parse(response.c_str()).HasParseError()) {
+      LOG(ERROR) << "Error while parsing json at offset: "
+                 << response_json->GetErrorOffset() << " : "
+                 << GetParseError_En(response_json->GetParseError());
+      return errors::InvalidArgument(
+          "Unable to convert the response body to JSON");
+    }
+
+    if (!response_json->IsObject()) {
+      return errors::InvalidArgument(
+          "Invalid JSON response. The response should be an object");
+    }
+    return OkStatus();
+  }
+
+ private:
+  static size_t WriteCallback(const void* ptr, size_t size, size_t nmemb,
+                              void* userdata) {
+    static_cast<std::string*>(userdata)->append(static_cast<const char*>(ptr),
+                                                size * nmemb);
+    return size * nmemb;
+  }
+
+  std::shared_ptr<CURL> curl_;
+};
+
+// The search shared by the slice readers of a resource.
+struct ElasticsearchSearch {
+  std::string request_url;
+  std::string scroll_request_url;
+  std::vector<string> headers;
+  // The fields of `_source` to return, all of them if empty.
+  std::vector<string> columns;
+  // The number of hits per page, the cluster default if not positive.
+  int64 page_size = 0;
+  int64 num_slices = 1;
+  // The point in time searched with search_after instead of scrolling, if
+  // not empty.
+  std::string pit_id;
+};
+
+// Reads the hits of one slice of a search a page at a time, through a
+// scroll context or through a point in time with search_after, and over a
+// connection of its own.
+class ElasticsearchSliceReader {
+ public:
+  ElasticsearchSliceReader(const ElasticsearchSearch* search, int64 slice_id)
+      : search_(search), slice_id_(slice_id), pit_id_(search->pit_id) {}
+  ~ElasticsearchSliceReader() { ClearScroll(); }
+
+  // Appends the `_source` of the hits of the next page to `items`, `done` is
+  // set by the first empty page, after which the next read starts over.
+  Status Read(std::vector<std::string>* items, bool* done) {
+    rapidjson::Document response_json;
+    if (scroll_id_.empty()) {
+      TF_RETURN_IF_ERROR(connection_.Request("POST", search_->request_url,
+                                             SearchBody(), search_->headers,
+                                             &response_json));
+    } else {
+      TF_RETURN_IF_ERROR(connection_.Request(
+          "POST", search_->scroll_request_url, ScrollBody(), search_->headers,
+          &response_json));
+    }
+
+    if (!response_json.HasMember("hits") ||
+        !response_json["hits"].HasMember("hits")) {
+      rapidjson::StringBuffer error_buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> error_writer(error_buffer);
+      response_json.Accept(error_writer);
+      return errors::FailedPrecondition("Corrupted response from the server ",
+                                        error_buffer.GetString());
+    }
+    if (response_json.HasMember("_scroll_id")) {
+      scroll_id_ = response_json["_scroll_id"].GetString();
+    }
+    if (response_json.HasMember("pit_id")) {
+      pit_id_ = response_json["pit_id"].GetString();
+    }
+
+    const rapidjson::Value& hits = response_json["hits"]["hits"];
+    *done = hits.Empty();
+    if (*done) {
+      ClearScroll();
+      search_after_.clear();
+      return OkStatus();
+    }
+    for (const rapidjson::Value& hit : hits.GetArray()) {
+      rapidjson::StringBuffer item_buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> item_writer(item_buffer);
+      hit["_source"].Accept(item_writer);
+      items->emplace_back(item_buffer.GetString(), item_buffer.GetSize());
+    }
+    // The sort values of the last hit are where the next page starts.
+    const rapidjson::Value& last_hit = hits[hits.Size() - 1];
+    if (!pit_id_.empty() && last_hit.HasMember("sort")) {
+      rapidjson::StringBuffer sort_buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> sort_writer(sort_buffer);
+      last_hit["sort"].Accept(sort_writer);
+      search_after_ = sort_buffer.GetString();
+    }
+    return OkStatus();
+  }
+
+ private:
+  std::string SearchBody() {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    if (search_->page_size > 0) {
+      writer.Key("size");
+      writer.Int64(search_->page_size);
+    }
+    if (!search_->columns.empty()) {
+      writer.Key("_source");
+      writer.StartArray();
+      for (const string& column : search_->columns) {
+        writer.String(column.c_str(), column.size());
+      }
+      writer.EndArray();
+    }
+    if (search_->num_slices > 1) {
+      writer.Key("slice");
+      writer.StartObject();
+      writer.Key("id");
+      writer.Int64(slice_id_);
+      writer.Key("max");
+      writer.Int64(search_->num_slices);
+      writer.EndObject();
+    }
+    if (!pit_id_.empty()) {
+      writer.Key("pit");
+      writer.StartObject();
+      writer.Key("id");
+      writer.String(pit_id_.c_str(), pit_id_.size());
+      writer.Key("keep_alive");
+      writer.String(kKeepAlive);
+      writer.EndObject();
+      // The shard and doc id order is the cheapest total order of the hits.
+      writer.Key("sort");
+      writer.StartArray();
+      writer.StartObject();
+      writer.Key("_shard_doc");
+      writer.String("asc");
+      writer.EndObject();
+      writer.EndArray();
+      if (!search_after_.empty()) {
+        writer.Key("search_after");
+        writer.RawValue(search_after_.c_str(), search_after_.size(),
+                        rapidjson::kArrayType);
+      }
+    }
+    writer.EndObject();
+    return buffer.GetString();
+  }
+
+  std::string ScrollBody() {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("scroll");
+    writer.String(kKeepAlive);
+    writer.Key("scroll_id");
+    writer.String(scroll_id_.c_str(), scroll_id_.size());
+    writer.EndObject();
+    return buffer.GetString();
+  }
+
+  // Frees the scroll context rather than leaving it to expire.
+  void ClearScroll() {
+    if (scroll_id_.empty()) return;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("scroll_id");
+    writer.String(scroll_id_.c_str(), scroll_id_.size());
+    writer.EndObject();
+    rapidjson::Document response_json;
+    Status status =
+        connection_.Request("DELETE", search_->scroll_request_url,
+                            buffer.GetString(), search_->headers,
+                            &response_json);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to clear the scroll context: " << status;
+    }
+    scroll_id_.clear();
+  }
+
+  const ElasticsearchSearch* search_;
+  const int64 slice_id_;
+  ElasticsearchConnection connection_;
+  std::string scroll_id_;
+  std::string pit_id_;
+  // The sort values of the last hit read, as a JSON array.
+  std::string search_after_;
+};
+
 class ElasticsearchReadableResource : public ResourceBase {
  public:
   ElasticsearchReadableResource(Env* env) : env_(env) {}
-  ~ElasticsearchReadableResource() {}
+  ~ElasticsearchReadableResource() {
+    StopReaders();
+    readers_.clear();
+    ClosePointInTime();
+  }
 
   Status Init(const std::string& healthcheck_url,
               const std::string& healthcheck_field,
               const std::string& request_url,
               const std::vector<string>& headers,
+              const std::vector<string>& columns, int64 num_slices,
+              int64 page_size, const std::string& pit_url,
               std::function<Status(const TensorShape& columns_shape,
                                    Tensor** columns, Tensor** dtypes)>
                   allocate_func) {
+    mutex_lock l(mu_);
     // Perform healthcheck before proceeding
-    Healthcheck(healthcheck_url, healthcheck_field, headers);
+    TF_RETURN_IF_ERROR(
+        Healthcheck(healthcheck_url, healthcheck_field, headers));
+
+    search_.request_url = request_url;
+    search_.scroll_request_url = BaseUrl(request_url) + "/_search/scroll";
+    search_.headers = headers;
+    search_.columns = columns;
+    search_.page_size = page_size;
+    search_.num_slices = std::max<int64>(num_slices, 1);
+    if (!pit_url.empty()) {
+      TF_RETURN_IF_ERROR(OpenPointInTime(pit_url));
+    }
 
-    // Make the request API call and set the metadata based on a sample of
-    // data returned. The request_url will have the "scroll" param set with
-    // a very small value (approx. 1ms) so that the response is immediate
-    // and the metadata can be retrieved quickly.
+    // Make a search for a single hit and set the metadata based on it.
     base_dtypes_.clear();
     base_columns_.clear();
-    rapidjson::Document response_json;
-    MakeAPICall(request_url, &response_json, headers);
-
-    // Validate the presence of the _scroll_id in the response.
-    // The _scroll_id keeps might change in subsequent calls, thus not
-    // setting it as a resource attribute.
-
-    if (!response_json.HasMember("_scroll_id")) {
-      return errors::FailedPrecondition(
-          "Failed to start the scrolling search context.");
+    ElasticsearchSearch sample_search = search_;
+    sample_search.page_size = 1;
+    sample_search.num_slices = 1;
+    std::vector<std::string> items;
+    {
+      ElasticsearchSliceReader sample_reader(&sample_search, 0);
+      bool done;
+      TF_RETURN_IF_ERROR(sample_reader.Read(&items, &done));
+    }
+    // Throw an error if empty list is returned by the cluster.
+    if (items.empty()) {
+      return errors::OutOfRange("Empty hits returned by cluster");
     }
 
-    if (response_json.HasMember("hits")) {
-      const rapidjson::Value& hits = response_json["hits"]["hits"].GetArray();
-      // Throw an error if empty list is returned by the cluster.
-      if (hits.MemberCount() < 1) {
-        return errors::OutOfRange("Empty hits returned by cluster");
+    // Capture and validate dtype and column/field information by
+    // evaluating the first item in the returned hits.
+    rapidjson::Document first_item;
+    if (first_item.Parse(items[0].c_str()).HasParseError() ||
+        !first_item.IsObject()) {
+      return errors::FailedPrecondition("Corrupted response from the server");
+    }
+    for (rapidjson::Value::ConstMemberIterator itr = first_item.MemberBegin();
+         itr != first_item.MemberEnd(); ++itr) {
+      DataType dtype;
+      if (itr->value.IsInt64()) {
+        dtype = DT_INT64;
+      } else if (itr->value.IsInt()) {
+        dtype = DT_INT32;
+      } else if (itr->value.IsDouble()) {
+        dtype = DT_DOUBLE;
+      } else if (itr->value.IsString()) {
+        dtype = DT_STRING;
+      } else if (itr->value.IsBool()) {
+        dtype = DT_BOOL;
+      } else {
+        return errors::InvalidArgument(
+            "field: ", itr->name.GetString(),
+            "has unsupported data type: ", itr->value.GetType());
       }
 
-      // Capture and validate dtype and column/field information by
-      // evaluating the first item in the returned hits.
-      const rapidjson::Value& last_item = hits[0]["_source"];
-
-      for (rapidjson::Value::ConstMemberIterator itr = last_item.MemberBegin();
-           itr != last_item.MemberEnd(); ++itr) {
-        DataType dtype;
-        if (itr->value.IsInt64()) {
-          dtype = DT_INT64;
-        } else if (itr->value.IsInt()) {
-          dtype = DT_INT32;
-        } else if (itr->value.IsDouble()) {
-          dtype = DT_DOUBLE;
-        } else if (itr->value.IsString()) {
-          dtype = DT_STRING;
-        } else if (itr->value.IsBool()) {
-          dtype = DT_BOOL;
-        } else {
-          return errors::InvalidArgument(
-              "field: ", itr->name.GetString(),
-              "has unsupported data type: ", itr->value.GetType());
-        }
-
-        base_dtypes_.push_back(dtype);
-        base_columns_.push_back(itr->name.GetString());
-      }
+      base_dtypes_.push_back(dtype);
+      base_columns_.push_back(itr->name.GetString());
+    }
 
-      TensorShape columns_shape({static_cast<int64>(base_columns_.size())});
-      Tensor* columns_tensor;
-      Tensor* dtypes_tensor;
-      TF_RETURN_IF_ERROR(
-          allocate_func(columns_shape, &columns_tensor, &dtypes_tensor));
-      for (int column_idx = 0; column_idx < base_columns_.size();
-           ++column_idx) {
-        columns_tensor->flat<tstring>()(column_idx) = base_columns_[column_idx];
-        if (base_dtypes_[column_idx] == DT_INT64) {
-          dtypes_tensor->flat<tstring>()(column_idx) = "DT_INT64";
-        } else if (base_dtypes_[column_idx] == DT_INT32) {
-          dtypes_tensor->flat<tstring>()(column_idx) = "DT_INT32";
-        } else if (base_dtypes_[column_idx] == DT_DOUBLE) {
-          dtypes_tensor->flat<tstring>()(column_idx) = "DT_DOUBLE";
-        } else if (base_dtypes_[column_idx] == DT_STRING) {
-          dtypes_tensor->flat<tstring>()(column_idx) = "DT_STRING";
-        } else if (base_dtypes_[column_idx] == DT_BOOL) {
-          dtypes_tensor->flat<tstring>()(column_idx) = "DT_BOOL";
-        }
+    TensorShape columns_shape({static_cast<int64>(base_columns_.size())});
+    Tensor* columns_tensor;
+    Tensor* dtypes_tensor;
+    TF_RETURN_IF_ERROR(
+        allocate_func(columns_shape, &columns_tensor, &dtypes_tensor));
+    for (int column_idx = 0; column_idx < base_columns_.size(); ++column_idx) {
+      columns_tensor->flat<tstring>()(column_idx) = base_columns_[column_idx];
+      if (base_dtypes_[column_idx] == DT_INT64) {
+        dtypes_tensor->flat<tstring>()(column_idx) = "DT_INT64";
+      } else if (base_dtypes_[column_idx] == DT_INT32) {
+        dtypes_tensor->flat<tstring>()(column_idx) = "DT_INT32";
+      } else if (base_dtypes_[column_idx] == DT_DOUBLE) {
+        dtypes_tensor->flat<tstring>()(column_idx) = "DT_DOUBLE";
+      } else if (base_dtypes_[column_idx] == DT_STRING) {
+        dtypes_tensor->flat<tstring>()(column_idx) = "DT_STRING";
+      } else if (base_dtypes_[column_idx] == DT_BOOL) {
+        dtypes_tensor->flat<tstring>()(column_idx) = "DT_BOOL";
       }
-
-    } else {
-      return errors::FailedPrecondition("Corrupted response from the server");
     }
 
     return OkStatus();
@@ -126,50 +424,28 @@ class ElasticsearchReadableResource : public ResourceBase {
       const std::string& request_url, const std::string& scroll_request_url,
       std::function<Status(const TensorShape& tensor_shape, Tensor** items)>
           data_allocate_func) {
-    rapidjson::Document response_json;
-    if (scroll_id == "") {
-      MakeAPICall(request_url, &response_json, headers_);
-    } else {
-      MakeAPICall(scroll_request_url, &response_json, headers_);
+    mutex_lock l(mu_);
+    if (readers_.empty()) {
+      search_.request_url = request_url;
+      search_.scroll_request_url = scroll_request_url;
+      for (int64 i = 0; i < search_.num_slices; i++) {
+        readers_.emplace_back(new ElasticsearchSliceReader(&search_, i));
+      }
     }
 
-    if (response_json.HasMember("_scroll_id")) {
-      scroll_id = response_json["_scroll_id"].GetString();
+    std::vector<std::string> items;
+    if (readers_.size() == 1) {
+      bool done;
+      TF_RETURN_IF_ERROR(readers_[0]->Read(&items, &done));
     } else {
-      scroll_id = "";
-    }
-
-    if (response_json.HasMember("hits")) {
-      const rapidjson::Value& hits = response_json["hits"]["hits"].GetArray();
-      // LOG(INFO) << "Response has hits= " << hits.MemberCount();
-      if (hits.MemberCount() > 0) {
-        TensorShape tensor_shape({static_cast<int64>(hits.MemberCount())});
-        Tensor* items;
-        TF_RETURN_IF_ERROR(data_allocate_func(tensor_shape, &items));
-
-        for (size_t item_idx = 0; item_idx < hits.MemberCount(); ++item_idx) {
-          const rapidjson::Value& value = hits[item_idx]["_source"];
-          rapidjson::StringBuffer item_buffer;
-          item_buffer.Clear();
-          rapidjson::Writer<rapidjson::StringBuffer> item_writer(item_buffer);
-          value.Accept(item_writer);
-          items->flat<tstring>()(item_idx) = item_buffer.GetString();
-        }
+      TF_RETURN_IF_ERROR(Pop(&items));
+    }
 
-      } else {
-        scroll_id = "";
-        TensorShape tensor_shape({static_cast<int64>(hits.MemberCount())});
-        Tensor* items;
-        TF_RETURN_IF_ERROR(data_allocate_func(tensor_shape, &items));
-      }
-    } else {
-      rapidjson::StringBuffer error_buffer;
-      error_buffer.Clear();
-      rapidjson::Writer<rapidjson::StringBuffer> error_writer(error_buffer);
-      response_json.Accept(error_writer);
-      std::string error_response = error_buffer.GetString();
-      return errors::FailedPrecondition("Corrupted response from the server " +
-                                        error_response);
+    TensorShape tensor_shape({static_cast<int64>(items.size())});
+    Tensor* items_tensor;
+    TF_RETURN_IF_ERROR(data_allocate_func(tensor_shape, &items_tensor));
+    for (size_t i = 0; i < items.size(); i++) {
+      items_tensor->flat<tstring>()(i) = std::move(items[i]);
     }
 
     return OkStatus();
@@ -183,86 +459,139 @@ class ElasticsearchReadableResource : public ResourceBase {
                      const std::vector<string>& headers) {
     // Make the healthcheck API call and get the response json
     rapidjson::Document response_json;
-    MakeAPICall(healthcheck_url, &response_json, headers);
+    TF_RETURN_IF_ERROR(connection_.Request("GET", healthcheck_url, "", headers,
+                                           &response_json));
 
-    if (response_json.HasMember(healthcheck_field.c_str())) {
-      // LOG(INFO) << "cluster health: "
-      //           << response_json[healthcheck_field.c_str()].GetString();
-    } else
+    if (!response_json.HasMember(healthcheck_field.c_str())) {
       return errors::FailedPrecondition("healthcheck failed");
+    }
 
     return OkStatus();
   }
 
-  Status MakeAPICall(const std::string& url, rapidjson::Document* response_json,
-                     const std::vector<string>& headers) {
-    HttpRequest* request = http_request_factory_.Create();
-
-    if (scroll_id != "") {
-      std::string scroll_url = url + "?scroll=1ms&scroll_id=" + scroll_id;
-      // LOG(INFO) << "Setting the url" << scroll_url;
-      request->SetUri(scroll_url);
-    } else {
-      // LOG(INFO) << "Setting the url" << url;
-      request->SetUri(url);
+  // Opens the point in time the slice readers search with search_after,
+  // which unlike a scroll context is shared by all of them.
+  Status OpenPointInTime(const std::string& pit_url) {
+    rapidjson::Document response_json;
+    TF_RETURN_IF_ERROR(connection_.Request("POST", pit_url, "",
+                                           search_.headers, &response_json));
+    if (!response_json.HasMember("id") || !response_json["id"].IsString()) {
+      return errors::FailedPrecondition("Failed to open the point in time");
     }
+    search_.pit_id = response_json["id"].GetString();
+    pit_close_url_ = BaseUrl(pit_url) + "/_pit";
+    return OkStatus();
+  }
 
-    // LOG(INFO) << "Setting the headers";
-    for (size_t i = 0; i < headers.size(); ++i) {
-      std::string header = headers[i];
-      std::vector<string> parts = str_util::Split(header, "=");
-      if (parts.size() != 2) {
-        return errors::InvalidArgument("invalid header configuration: ",
-                                       header);
-      }
-      request->AddHeader(parts[0], parts[1]);
+  void ClosePointInTime() {
+    if (search_.pit_id.empty()) return;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("id");
+    writer.String(search_.pit_id.c_str(), search_.pit_id.size());
+    writer.EndObject();
+    rapidjson::Document response_json;
+    Status status =
+        connection_.Request("DELETE", pit_close_url_, buffer.GetString(),
+                            search_.headers, &response_json);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to close the point in time: " << status;
     }
+    search_.pit_id.clear();
+  }
 
-    // LOG(INFO) << "Setting the response buffer";
-    std::vector<char> response;
-    request->SetResultBuffer(&response);
-
-    // LOG(INFO) << "Sending the request";
-    TF_RETURN_IF_ERROR(request->Send());
-
-    // LOG(INFO) << "Response code" << request->GetResponseCode();
-
-    // LOG(INFO) << "Getting the length of content";
-    string length_string = request->GetResponseHeader("content-length");
-    // LOG(INFO) << "response length: " << length_string;
+  size_t max_num_items() const {
+    return search_.page_size > 0 ? search_.page_size : kDefaultPageSize;
+  }
 
-    std::string response_str(response.begin(), response.end());
-    // LOG(INFO) << "response " << response_str;
+  // Moves up to a page of hits read by the slice readers to `items`, waiting
+  // for the readers unless all have reached their end. An empty result ends
+  // the pass, the next one searches the index again.
+  Status Pop(std::vector<std::string>* items) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (threads_.empty()) StartReaders();
+    mutex_lock l(queue_mu_);
+    while (queue_.empty() && num_running_ > 0) queue_cv_.wait(l);
+    size_t count = std::min(max_num_items(), queue_.size());
+    std::move(queue_.begin(), queue_.begin() + count,
+              std::back_inserter(*items));
+    queue_.erase(queue_.begin(), queue_.begin() + count);
+    queue_cv_.notify_all();
+    if (!items->empty()) return OkStatus();
+    Status status = status_;
+    status_ = OkStatus();
+    l.unlock();
+    StopReaders();
+    return status;
+  }
 
-    if (response_json->Parse(response_str.c_str()).HasParseError()) {
-      LOG(ERROR) << "Error while parsing json at offset: "
-                 << response_json->GetErrorOffset() << " : "
-                 << GetParseError_En(response_json->GetParseError());
-      return errors::InvalidArgument(
-          "Unable to convert the response body to JSON");
+  void StartReaders() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = false;
+      num_running_ = readers_.size();
     }
-
-    if (!response_json->IsObject()) {
-      return errors::InvalidArgument(
-          "Invalid JSON response. The response should be an object");
+    for (auto& reader : readers_) {
+      ElasticsearchSliceReader* slice_reader = reader.get();
+      threads_.emplace_back(env_->StartThread(
+          ThreadOptions(), "elasticsearch_slice_reader",
+          [this, slice_reader] { RunReader(slice_reader); }));
     }
+  }
 
-    // Store the default headers if the response is valid
-    headers_ = headers;
+  void StopReaders() {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = true;
+      queue_.clear();
+      queue_cv_.notify_all();
+    }
+    // Joins the reader threads.
+    threads_.clear();
+  }
 
-    return OkStatus();
+  void RunReader(ElasticsearchSliceReader* reader) {
+    std::vector<std::string> items;
+    bool done = false;
+    Status status;
+    while (!done && status.ok()) {
+      items.clear();
+      status = reader->Read(&items, &done);
+      mutex_lock l(queue_mu_);
+      while (!stop_ && queue_.size() >= kQueueCapacity * max_num_items()) {
+        queue_cv_.wait(l);
+      }
+      if (stop_) return;
+      std::move(items.begin(), items.end(), std::back_inserter(queue_));
+      queue_cv_.notify_all();
+    }
+    mutex_lock l(queue_mu_);
+    if (status_.ok()) status_ = status;
+    num_running_--;
+    queue_cv_.notify_all();
   }
 
+  // The number of hits per page of the cluster unless set otherwise.
+  static const size_t kDefaultPageSize = 10;
+  // The number of pages the slice readers queue ahead of Next.
+  static const size_t kQueueCapacity = 4;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
-  string url_;
-  tsl::CurlHttpRequest::Factory http_request_factory_ =
-      tsl::CurlHttpRequest::Factory();
+  ElasticsearchConnection connection_;
+  ElasticsearchSearch search_;
+  std::string pit_close_url_;
 
   std::vector<DataType> base_dtypes_;
   std::vector<string> base_columns_;
-  std::string scroll_id = "";
-  std::vector<string> headers_;
+  std::vector<std::unique_ptr<ElasticsearchSliceReader>> readers_;
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  std::deque<std::string> queue_ TF_GUARDED_BY(queue_mu_);
+  size_t num_running_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool stop_ TF_GUARDED_BY(queue_mu_) = false;
+  Status status_ TF_GUARDED_BY(queue_mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
 };
 
 class ElasticsearchReadableInitOp
@@ -299,9 +628,29 @@ class ElasticsearchReadableInitOp
       headers.push_back(headers_tensor->flat<tstring>()(i));
     }
 
+    const Tensor* columns_tensor;
+    OP_REQUIRES_OK(context, context->input("columns", &columns_tensor));
+    std::vector<string> columns;
+    for (int64 i = 0; i < columns_tensor->NumElements(); i++) {
+      columns.push_back(columns_tensor->flat<tstring>()(i));
+    }
+
+    const Tensor* num_slices_tensor;
+    OP_REQUIRES_OK(context, context->input("num_slices", &num_slices_tensor));
+    const int64 num_slices = num_slices_tensor->scalar<int64>()();
+
+    const Tensor* page_size_tensor;
+    OP_REQUIRES_OK(context, context->input("page_size", &page_size_tensor));
+    const int64 page_size = page_size_tensor->scalar<int64>()();
+
+    const Tensor* pit_url_tensor;
+    OP_REQUIRES_OK(context, context->input("pit_url", &pit_url_tensor));
+    const string& pit_url = pit_url_tensor->scalar<tstring>()();
+
     OP_REQUIRES_OK(
         context, resource_->Init(
                      healthcheck_url, healthcheck_field, request_url, headers,
+                     columns, num_slices, page_size, pit_url,
                      [&](const TensorShape& columns_shape, Tensor** columns,
                          Tensor** dtypes) -> Status {
                        TF_RETURN_IF_ERROR(
@@ -363,8 +712,10 @@ class ElasticsearchReadableNextOp : public OpKernel {
 
 REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchReadableInit").Device(DEVICE_CPU),
                         ElasticsearchReadableInitOp);
+// Each batch is an HTTP round trip, made on the IO executor rather than on
+// an inter-op thread.
 REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchReadableNext").Device(DEVICE_CPU),
-                        ElasticsearchReadableNextOp);
+                        data::IOAsyncOpKernel<ElasticsearchReadableNextOp>);
 
 }  // namespace
 }  // namespace io
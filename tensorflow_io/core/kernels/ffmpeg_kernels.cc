@@ -13,11 +13,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <deque>
+#include <limits>
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
+#include "tensorflow_io/core/kernels/shard_cost.h"
 
 extern "C" {
 
@@ -27,6 +33,9 @@ extern "C" {
 #include "libavformat/avformat.h"
 #include "libavutil/imgutils.h"
 #include "libswscale/swscale.h"
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+#include "libavutil/hwcontext.h"
+#endif
 }
 
 namespace tensorflow {
@@ -74,6 +83,61 @@ void FFmpegInit() {
 
 namespace {
 
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+struct FFmpegHWDevice {
+  AVHWDeviceType type;
+  AVBufferRef* device;
+};
+
+// The hardware device video is decoded on, opted in with FFMPEG_HWACCEL set
+// to a device type such as vaapi, cuda or qsv, and optionally
+// FFMPEG_HWACCEL_DEVICE to pick the device. It is created once and shared
+// by the codecs, which decode in software when there is none.
+const FFmpegHWDevice& GetFFmpegHWDevice() {
+  static const FFmpegHWDevice hw = [] {
+    FFmpegHWDevice hw{AV_HWDEVICE_TYPE_NONE, nullptr};
+    const char* name = getenv("FFMPEG_HWACCEL");
+    if (name == nullptr || *name == '\0') {
+      return hw;
+    }
+    AVHWDeviceType type = av_hwdevice_find_type_by_name(name);
+    if (type == AV_HWDEVICE_TYPE_NONE) {
+      LOG(WARNING) << "FFmpeg hardware device type " << name
+                   << " is not available, decoding in software";
+      return hw;
+    }
+    int ret = av_hwdevice_ctx_create(&hw.device, type,
+                                     getenv("FFMPEG_HWACCEL_DEVICE"), NULL, 0);
+    if (ret < 0) {
+      char error_message[AV_ERROR_MAX_STRING_SIZE];
+      av_strerror(ret, error_message, sizeof(error_message));
+      LOG(WARNING) << "unable to create FFmpeg hardware device " << name
+                   << ": " << error_message << ", decoding in software";
+      hw.device = nullptr;
+      return hw;
+    }
+    LOG(INFO) << "FFmpeg hardware device: " << name;
+    hw.type = type;
+    return hw;
+  }();
+  return hw;
+}
+#endif
+
+// The timestamps of the frames of a stream in presentation order and of its
+// keyframes, kept by a resource for the streams it opens on its file.
+struct FFmpegStreamIndex {
+  bool indexable = false;
+  std::vector<int64> timestamps;
+  std::vector<int64> keyframes;
+};
+
+struct SwsContextDeleter {
+  void operator()(SwsContext* p) const { sws_freeContext(p); }
+};
+// Contexts converting frames to RGB, keyed by dimensions and pixel format.
+using FFmpegSwsPool = ConnectionPool<SwsContext, SwsContextDeleter>;
+
 class FFmpegStream {
  public:
   FFmpegStream(const string& filename, SizedRandomAccessFile* file,
@@ -180,7 +244,10 @@ class FFmpegStream {
     }
     return OkStatus();
   }
-  Status OpenCodec(int64 thread_count, int64 thread_type) {
+  // Opens the decoder of the stream, on the hardware device when `hwaccel`
+  // and there is one the codec supports.
+  Status OpenCodec(int64 thread_count, int64 thread_type,
+                   bool hwaccel = false) {
     int64 stream_index = stream_index_;
 
 #if LIBAVCODEC_VERSION_MAJOR > 56
@@ -213,6 +280,30 @@ class FFmpegStream {
 #endif
     codec_context_->thread_count = (int)thread_count;
     codec_context_->thread_type = (int)thread_type;
+    // Decoded frames are kept across packets until they are read.
+    codec_context_->refcounted_frames = 1;
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+    if (hwaccel) {
+      const FFmpegHWDevice& hw = GetFFmpegHWDevice();
+      for (int i = 0; hw.device != nullptr; i++) {
+        const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+        if (config == nullptr) {
+          LOG(WARNING) << "codec " << codec_
+                       << " does not support the hardware device, decoding "
+                          "in software";
+          break;
+        }
+        if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+            config->device_type == hw.type) {
+          hw_pix_fmt_ = config->pix_fmt;
+          codec_context_->hw_device_ctx = av_buffer_ref(hw.device);
+          codec_context_->opaque = this;
+          codec_context_->get_format = FFmpegStream::GetFormat;
+          break;
+        }
+      }
+    }
+#endif
     {
       // avcodec_open2 is not thread-safe
       mutex_lock lock(mu);
@@ -227,6 +318,89 @@ class FFmpegStream {
     return OkStatus();
   }
 
+  // Demuxes the packets of the stream once into `index`, without decoding
+  // them, unless there is an index already. Streams with packets that have no
+  // timestamps can not be indexed, and are left at the end either way.
+  Status BuildIndex(std::shared_ptr<FFmpegStreamIndex>* index) {
+    if (*index == nullptr) {
+      std::shared_ptr<FFmpegStreamIndex> built(new FFmpegStreamIndex());
+      // Demuxing starts over from the start of the stream.
+      AVStream* stream = format_context_->streams[stream_index_];
+      const int64 start =
+          (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+      built->indexable =
+          (avformat_seek_file(format_context_.get(), stream_index_,
+                              std::numeric_limits<int64>::min(), start, start,
+                              0) >= 0);
+      AVPacket packet;
+      av_init_packet(&packet);
+      packet.data = NULL;
+      packet.size = 0;
+      while (built->indexable &&
+             av_read_frame(format_context_.get(), &packet) >= 0) {
+        if (packet.stream_index == stream_index_) {
+          int64 timestamp =
+              (packet.pts != AV_NOPTS_VALUE) ? packet.pts : packet.dts;
+          if (timestamp == AV_NOPTS_VALUE) {
+            built->indexable = false;
+          } else {
+            built->timestamps.push_back(timestamp);
+            if (packet.flags & AV_PKT_FLAG_KEY) {
+              built->keyframes.push_back(timestamp);
+            }
+          }
+        }
+        av_packet_unref(&packet);
+      }
+      std::sort(built->timestamps.begin(), built->timestamps.end());
+      std::sort(built->keyframes.begin(), built->keyframes.end());
+      if (built->keyframes.empty()) {
+        built->indexable = false;
+      }
+      *index = std::move(built);
+    }
+    index_ = *index;
+    if (!index_->indexable) {
+      return errors::Unimplemented("unable to index stream of ", filename_);
+    }
+    return OkStatus();
+  }
+
+  // Seeks to the last keyframe at or before `timestamp`, and resets the
+  // decoder, the packet and the frames decoded so far.
+  Status SeekKeyframe(const int64 timestamp) {
+    const std::vector<int64>& keyframes = index_->keyframes;
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), timestamp);
+    const int64 keyframe = (it == keyframes.begin()) ? *it : *(it - 1);
+    int ret = av_seek_frame(format_context_.get(), stream_index_, keyframe,
+                            AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+      char error_message[AV_ERROR_MAX_STRING_SIZE];
+      av_strerror(ret, error_message, sizeof(error_message));
+      return errors::Unimplemented("unable to seek: ", error_message);
+    }
+    avcodec_flush_buffers(codec_context_);
+    av_packet_unref(&packet_);
+    packet_scope_.reset(&packet_);
+    frames_.clear();
+    return OkStatus();
+  }
+
+  // Picks the hardware format when the decoder offers it, and otherwise
+  // falls back to software.
+  static enum AVPixelFormat GetFormat(AVCodecContext* context,
+                                      const enum AVPixelFormat* formats) {
+    FFmpegStream* r = (FFmpegStream*)context->opaque;
+    for (const enum AVPixelFormat* p = formats; *p != AV_PIX_FMT_NONE; p++) {
+      if (*p == r->hw_pix_fmt_) {
+        return *p;
+      }
+    }
+    LOG(WARNING) << "hardware format is not available for " << r->codec_
+                 << ", decoding in software";
+    return avcodec_default_get_format(context, formats);
+  }
+
   static int ReadPacket(void* opaque, uint8_t* buf, int buf_size) {
     FFmpegStream* r = (FFmpegStream*)opaque;
     StringPiece result;
@@ -285,9 +459,12 @@ class FFmpegStream {
   std::unique_ptr<AVCodecContext, void (*)(AVCodecContext*)>
       codec_context_scope_;
   int64 nb_frames_;
+  // The format of frames decoded on the hardware device, if any.
+  enum AVPixelFormat hw_pix_fmt_ = AV_PIX_FMT_NONE;
   AVPacket packet_;
   std::unique_ptr<AVPacket, void (*)(AVPacket*)> packet_scope_;
   std::deque<std::unique_ptr<AVFrame, void (*)(AVFrame*)>> frames_;
+  std::shared_ptr<FFmpegStreamIndex> index_;
 };
 
 class FFmpegAudioStream : public FFmpegStream {
@@ -375,13 +552,50 @@ class FFmpegAudioStream : public FFmpegStream {
   }
   Status Peek(int64* samples) {
     *samples = 0;
-    TF_RETURN_IF_ERROR(DecodePacket());
+    // The packets decoded into frames before the sample sought are dropped.
+    do {
+      TF_RETURN_IF_ERROR(DecodePacket());
+    } while (frames_.empty() && skip_samples_ >= 0);
     for (size_t i = 0; i < frames_.size(); i++) {
       (*samples) += frames_[i]->nb_samples;
     }
+    (*samples) -= trim_;
     return OkStatus();
   }
+  // Positions the stream at `sample`, from the closest keyframe at or before
+  // it, dropping what is decoded before it.
+  Status SeekSample(const int64 sample,
+                    std::shared_ptr<FFmpegStreamIndex>* index) {
+    TF_RETURN_IF_ERROR(BuildIndex(index));
+    AVStream* stream = format_context_->streams[stream_index_];
+    const int64 start =
+        (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    TF_RETURN_IF_ERROR(SeekKeyframe(
+        start + av_rescale_q(sample, AVRational{1, static_cast<int>(rate_)},
+                             stream->time_base)));
+    skip_samples_ = sample;
+    position_ = -1;
+    trim_ = 0;
+    return OkStatus();
+  }
+  // Drops the next `samples` samples of a stream just opened, those decoded
+  // already included.
+  void SkipSamples(const int64 samples) {
+    skip_samples_ = samples;
+    position_ = 0;
+    trim_ = 0;
+    std::deque<std::unique_ptr<AVFrame, void (*)(AVFrame*)>> frames;
+    frames.swap(frames_);
+    for (auto& frame : frames) {
+      if (Keep(frame.get())) {
+        frames_.push_back(std::move(frame));
+      }
+    }
+  }
   Status Read(Tensor* value) {
+    io::IOTrace trace("ffmpeg", io::IOTraceStage::kFill, "audio");
+    trace.AddBytes(value->TotalBytes());
+    trace.AddRecords(value->dims() > 0 ? value->dim_size(0) : 0);
     int64 datasize = DataTypeSize(dtype_);
 
     char* base;
@@ -393,13 +607,17 @@ class FFmpegAudioStream : public FFmpegStream {
         return errors::InvalidArgument("data type not supported: ",
                                        DataTypeString(dtype_));
     }
-    // Note: only one channel supported so far
+    // Note: only packed samples supported so far
+    int64 trim = trim_;
     for (size_t i = 0; i < frames_.size(); i++) {
-      memcpy(base, (char*)(frames_[i]->extended_data[0]),
-             datasize * frames_[i]->nb_samples);
-      base += datasize * frames_[i]->nb_samples;
+      const int64 size = datasize * channels_ * frames_[i]->nb_samples;
+      const int64 skip = datasize * channels_ * trim;
+      memcpy(base, (char*)(frames_[i]->extended_data[0]) + skip, size - skip);
+      base += size - skip;
+      trim = 0;
     }
     frames_.clear();
+    trim_ = 0;
     return OkStatus();
   }
 
@@ -408,13 +626,19 @@ class FFmpegAudioStream : public FFmpegStream {
       return errors::OutOfRange("EOF reached");
     }
     int ret;
-    do {
-      av_packet_unref(&packet_);
-      ret = av_read_frame(format_context_.get(), &packet_);
-      if (ret < 0) {
-        break;
+    {
+      io::IOTrace trace("ffmpeg", io::IOTraceStage::kIOWait, "audio");
+      do {
+        av_packet_unref(&packet_);
+        ret = av_read_frame(format_context_.get(), &packet_);
+        if (ret < 0) {
+          break;
+        }
+      } while (packet_.stream_index != stream_index_);
+      if (ret >= 0) {
+        trace.AddBytes(packet_.size);
       }
-    } while (packet_.stream_index != stream_index_);
+    }
     int got_frame;
     // decode
     if (ret >= 0) {
@@ -439,6 +663,7 @@ class FFmpegAudioStream : public FFmpegStream {
                                                            av_frame_free(&p);
                                                          }
                                                        });
+    io::IOTrace trace("ffmpeg", io::IOTraceStage::kDecode, "audio");
     int decoded =
         avcodec_decode_audio4(codec_context_, frame.get(), got_frame, &packet_);
     if (decoded < 0) {
@@ -446,9 +671,11 @@ class FFmpegAudioStream : public FFmpegStream {
                                      ")");
     }
     decoded = FFMIN(decoded, packet_.size);
+    trace.AddBytes(decoded);
+    trace.AddRecords(*got_frame ? frame->nb_samples : 0);
     packet_.data += decoded;
     packet_.size -= decoded;
-    if (*got_frame) {
+    if (*got_frame && Keep(frame.get())) {
       frames_.push_back(std::move(frame));
     }
     return OkStatus();
@@ -458,9 +685,42 @@ class FFmpegAudioStream : public FFmpegStream {
   int64 rate() { return rate_; }
 
  private:
+  // Whether a decoded frame reaches the sample sought, if any, counting the
+  // samples from the timestamp of the first frame after a seek. The kept
+  // frame that starts before the sample is trimmed when read.
+  bool Keep(const AVFrame* frame) {
+    if (skip_samples_ < 0) {
+      return true;
+    }
+    if (position_ < 0) {
+      AVStream* stream = format_context_->streams[stream_index_];
+      const int64 start =
+          (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+      const int64 timestamp = frame->best_effort_timestamp;
+      position_ =
+          (timestamp == AV_NOPTS_VALUE)
+              ? skip_samples_
+              : av_rescale_q(timestamp - start, stream->time_base,
+                             AVRational{1, static_cast<int>(rate_)});
+    }
+    const int64 end = position_ + frame->nb_samples;
+    if (end <= skip_samples_) {
+      position_ = end;
+      return false;
+    }
+    trim_ = std::max<int64>(0, skip_samples_ - position_);
+    skip_samples_ = -1;
+    return true;
+  }
+
   DataType dtype_;
   int64 channels_;
   int64 rate_;
+  // The sample sought, or -1 once reached, with the position counted so far
+  // and the samples to drop from the first frame.
+  int64 skip_samples_ = -1;
+  int64 position_ = -1;
+  int64 trim_ = 0;
 };
 
 class FFmpegAudioReadableResource : public ResourceBase {
@@ -484,15 +744,30 @@ class FFmpegAudioReadableResource : public ResourceBase {
 
     return OkStatus();
   }
+  // Seeks to sample `index`, through the index of the keyframes of the file
+  // when the stream has one, and otherwise by decoding from the start.
   Status Seek(const int64 index) {
-    if (index != 0) {
-      return errors::InvalidArgument("seek only support 0");
+    if (index < 0) {
+      return errors::InvalidArgument("invalid seek to ", index);
+    }
+    if (index > 0) {
+      Status status = ffmpeg_audio_stream_->SeekSample(index, &index_);
+      if (status.ok()) {
+        sample_index_ = index;
+        return OkStatus();
+      }
+      if (!errors::IsUnimplemented(status)) {
+        return status;
+      }
     }
     ffmpeg_audio_stream_.reset(
         new FFmpegAudioStream(filename_, file_.get(), file_size_));
 
     TF_RETURN_IF_ERROR(ffmpeg_audio_stream_->OpenAudio(audio_index_));
-    sample_index_ = 0;
+    if (index > 0) {
+      ffmpeg_audio_stream_->SkipSamples(index);
+    }
+    sample_index_ = index;
     return OkStatus();
   }
   Status Peek(TensorShape* shape) {
@@ -512,6 +787,7 @@ class FFmpegAudioReadableResource : public ResourceBase {
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
   uint64 file_size_ TF_GUARDED_BY(mu_);
   std::unique_ptr<FFmpegAudioStream> ffmpeg_audio_stream_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<FFmpegStreamIndex> index_ TF_GUARDED_BY(mu_);
   int64 sample_index_ TF_GUARDED_BY(mu_);
 };
 
@@ -552,6 +828,7 @@ class FFmpegAudioReadableNextOp : public OpKernel {
   explicit FFmpegAudioReadableNextOp(OpKernelConstruction* context)
       : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("start", &start_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -564,7 +841,7 @@ class FFmpegAudioReadableNextOp : public OpKernel {
     OP_REQUIRES_OK(context, context->input("reset", &reset_tensor));
     bool reset = reset_tensor->scalar<bool>()();
     if (reset) {
-      OP_REQUIRES_OK(context, resource->Seek(0));
+      OP_REQUIRES_OK(context, resource->Seek(start_));
     }
 
     TensorShape value_shape;
@@ -580,6 +857,7 @@ class FFmpegAudioReadableNextOp : public OpKernel {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  int64 start_;
 };
 
 class FFmpegVideoStream : public FFmpegStream {
@@ -590,18 +868,13 @@ class FFmpegVideoStream : public FFmpegStream {
         dtype_(DT_INVALID),
         height_(-1),
         width_(-1),
-        channels_(-1),
-        sws_context_(nullptr, [](SwsContext* p) {
-          if (p != nullptr) {
-            sws_freeContext(p);
-          }
-        }) {}
+        channels_(-1) {}
   virtual ~FFmpegVideoStream() {}
 
   Status OpenVideo(int64 index) {
     TF_RETURN_IF_ERROR(Open(AVMEDIA_TYPE_VIDEO, index));
     // FF_THREAD_SLICE=2, see libavcodec/avcodec.h
-    TF_RETURN_IF_ERROR(OpenCodec(FF_THREAD_SLICE, 1));
+    TF_RETURN_IF_ERROR(OpenCodec(FF_THREAD_SLICE, 1, true));
 
     dtype_ = DT_UINT8;
     height_ = codec_context_->height;
@@ -614,15 +887,6 @@ class FFmpegVideoStream : public FFmpegStream {
       return errors::InvalidArgument("failed to calculate data size");
     }
 
-    SwsContext* sws_context = sws_getContext(
-        codec_context_->width, codec_context_->height, codec_context_->pix_fmt,
-        codec_context_->width, codec_context_->height, AV_PIX_FMT_RGB24, 0,
-        NULL, NULL, NULL);
-    if (!sws_context) {
-      return errors::Internal("could not allocate sws context");
-    }
-    sws_context_.reset(sws_context);
-
     // Initialize the decoders
     // Read first packet if possible
     av_init_packet(&packet_);
@@ -649,13 +913,19 @@ class FFmpegVideoStream : public FFmpegStream {
 
     return OkStatus();
   }
-  Status Peek(int64* frames) {
-    *frames = 0;
-    while (*frames == 0) {
-      TF_RETURN_IF_ERROR(DecodePacket());
-      (*frames) = frames_.size();
+  // Decodes until `count` frames, or any when `count` is 0, are ready to be
+  // read, or the stream ends.
+  Status Peek(const int64 count, int64* frames) {
+    const size_t ready = std::max<int64>(count, 1);
+    Status status;
+    while (frames_.size() < ready && status.ok()) {
+      status = DecodePacket();
     }
-    return OkStatus();
+    (*frames) = frames_.size();
+    if (count > 0) {
+      (*frames) = std::min<int64>(count, *frames);
+    }
+    return frames_.empty() ? status : OkStatus();
   }
   Status PeekAll(int64* frames) {
     Status status;
@@ -665,30 +935,94 @@ class FFmpegVideoStream : public FFmpegStream {
     (*frames) = frames_.size();
     return OkStatus();
   }
-  Status Read(Tensor* value) {
-    char* base = ((char*)(value->flat<uint8>().data()));
-    int64 datasize = height_ * width_ * channels_;
-    for (size_t i = 0; i < frames_.size(); i++) {
-      memcpy(base, reinterpret_cast<char*>(frames_buffer_[i].get()), datasize);
-      base += datasize;
-    }
+  // Positions the stream at `frame` in presentation order, from the closest
+  // keyframe at or before it, dropping the frames decoded before it without
+  // converting them.
+  Status SeekFrame(const int64 frame,
+                   std::shared_ptr<FFmpegStreamIndex>* index) {
+    TF_RETURN_IF_ERROR(BuildIndex(index));
+    const std::vector<int64>& timestamps = index_->timestamps;
     frames_.clear();
-    frames_buffer_.clear();
+    skip_frames_ = 0;
+    if (frame >= static_cast<int64>(timestamps.size())) {
+      TF_RETURN_IF_ERROR(SeekKeyframe(timestamps.back()));
+      skip_timestamp_ = std::numeric_limits<int64>::max();
+      return OkStatus();
+    }
+    TF_RETURN_IF_ERROR(SeekKeyframe(timestamps[frame]));
+    skip_timestamp_ = timestamps[frame];
     return OkStatus();
   }
+  // Drops the next `frames` frames of a stream just opened, those decoded
+  // already included.
+  void SkipFrames(int64 frames) {
+    while (frames > 0 && !frames_.empty()) {
+      frames_.pop_front();
+      frames--;
+    }
+    skip_frames_ = frames;
+  }
+  // Converts the first frames decoded to RGB, as many as `value` holds,
+  // across the worker threads.
+  Status Read(Tensor* value, const DeviceBase::CpuWorkerThreads* workers) {
+    uint8_t* base = value->flat<uint8>().data();
+    const int64 datasize = height_ * width_ * channels_;
+    const int64 count =
+        std::min<int64>(value->dim_size(0), static_cast<int64>(frames_.size()));
+    io::IOTrace trace("ffmpeg", io::IOTraceStage::kFill, "video");
+    trace.AddBytes(count * datasize);
+    trace.AddRecords(count);
+    mutex status_mu;
+    Status status;
+    auto convert = [&](int64 start, int64 limit) {
+      std::shared_ptr<SwsContext> sws_context;
+      int format = AV_PIX_FMT_NONE;
+      for (int64 i = start; i < limit; i++) {
+        const AVFrame* frame = frames_[i].get();
+        if (frame->format != format || sws_context == nullptr) {
+          Status s =
+              AcquireSwsContext((AVPixelFormat)frame->format, &sws_context);
+          if (!s.ok()) {
+            mutex_lock l(status_mu);
+            status.Update(s);
+            return;
+          }
+          format = frame->format;
+        }
+        uint8_t* data[4];
+        int linesize[4];
+        av_image_fill_arrays(data, linesize, base + i * datasize,
+                             AV_PIX_FMT_RGB24, width_, height_, 1);
+        sws_scale(sws_context.get(), frame->data, frame->linesize, 0, height_,
+                  data, linesize);
+      }
+    };
+    // The frames were decoded already, so a unit of work is only the
+    // conversion of one frame to RGB.
+    Shard(workers->num_threads, workers->workers, count,
+          height_ * width_ * io::kCostPerConvertedPixel, convert);
+    frames_.erase(frames_.begin(), frames_.begin() + count);
+    return status;
+  }
 
   Status DecodePacket() {
     if (packet_scope_.get() == nullptr) {
       return errors::OutOfRange("EOF reached");
     }
     int ret;
-    do {
-      av_packet_unref(&packet_);
-      ret = av_read_frame(format_context_.get(), &packet_);
-      if (ret < 0) {
-        break;
+    {
+      io::IOTrace trace("ffmpeg", io::IOTraceStage::kIOWait, "video");
+      do {
+        av_packet_unref(&packet_);
+        ret = av_read_frame(format_context_.get(), &packet_);
+        if (ret < 0) {
+          break;
+        }
+      } while (packet_.stream_index != stream_index_);
+      if (ret >= 0) {
+        trace.AddBytes(packet_.size);
       }
-    } while (packet_.stream_index != stream_index_);
+    }
     int got_frame;
     // decode
     if (ret >= 0) {
@@ -713,6 +1047,7 @@ class FFmpegVideoStream : public FFmpegStream {
                                                            av_frame_free(&p);
                                                          }
                                                        });
+    io::IOTrace trace("ffmpeg", io::IOTraceStage::kDecode, "video");
     int decoded =
         avcodec_decode_video2(codec_context_, frame.get(), got_frame, &packet_);
     if (decoded < 0) {
@@ -720,31 +1055,33 @@ class FFmpegVideoStream : public FFmpegStream {
                                      ")");
     }
     decoded = FFMIN(decoded, packet_.size);
+    trace.AddBytes(decoded);
+    trace.AddRecords(*got_frame ? 1 : 0);
     packet_.data += decoded;
     packet_.size -= decoded;
-    if (*got_frame) {
-      int64 datasize = height_ * width_ * channels_;
-
-      std::unique_ptr<AVFrame, void (*)(AVFrame*)> frame_rgb(
-          av_frame_alloc(), [](AVFrame* p) {
-            if (p != nullptr) {
-              av_frame_free(&p);
-            }
-          });
-      std::unique_ptr<uint8_t, void (*)(uint8_t*)> buffer_rgb(
-          (uint8_t*)av_malloc(datasize), [](uint8_t* p) {
-            if (p != nullptr) {
-              av_free(p);
-            }
-          });
-      avpicture_fill((AVPicture*)frame_rgb.get(), buffer_rgb.get(),
-                     AV_PIX_FMT_RGB24, codec_context_->width,
-                     codec_context_->height);
-      sws_scale(sws_context_.get(), frame->data, frame->linesize, 0,
-                codec_context_->height, frame_rgb->data, frame_rgb->linesize);
-
-      frames_.push_back(std::move(frame_rgb));
-      frames_buffer_.push_back(std::move(buffer_rgb));
+    if (*got_frame && Keep(frame.get())) {
+#if LIBAVCODEC_VERSION_MAJOR >= 58
+      // Frames are downloaded from the device as they come, so that the
+      // surfaces of the decoder are not held until the frames are read.
+      if (hw_pix_fmt_ != AV_PIX_FMT_NONE && frame->format == hw_pix_fmt_) {
+        std::unique_ptr<AVFrame, void (*)(AVFrame*)> downloaded(
+            av_frame_alloc(), [](AVFrame* p) {
+              if (p != nullptr) {
+                av_frame_free(&p);
+              }
+            });
+        if (!downloaded) {
+          return errors::ResourceExhausted("unable to allocate frame");
+        }
+        int ret = av_hwframe_transfer_data(downloaded.get(), frame.get(), 0);
+        if (ret < 0) {
+          return errors::Internal("unable to download video frame (", ret,
+                                  ")");
+        }
+        frame = std::move(downloaded);
+      }
+#endif
+      frames_.push_back(std::move(frame));
     }
     return OkStatus();
   }
@@ -754,13 +1091,52 @@ class FFmpegVideoStream : public FFmpegStream {
   int64 width() { return width_; }
 
  private:
+  // Whether a decoded frame is past the frames to skip and at or after the
+  // timestamp sought, if any.
+  bool Keep(const AVFrame* frame) {
+    if (skip_frames_ > 0) {
+      skip_frames_--;
+      return false;
+    }
+    if (skip_timestamp_ == AV_NOPTS_VALUE) {
+      return true;
+    }
+    const int64 timestamp = frame->best_effort_timestamp;
+    if (timestamp != AV_NOPTS_VALUE && timestamp < skip_timestamp_) {
+      return false;
+    }
+    skip_timestamp_ = AV_NOPTS_VALUE;
+    return true;
+  }
+
+  // Leases a context converting frames of `format` to RGB from the pool
+  // of the process, so that the decodes of clips of the same dimensions
+  // share them.
+  Status AcquireSwsContext(AVPixelFormat format,
+                           std::shared_ptr<SwsContext>* sws_context) {
+    const int width = width_;
+    const int height = height_;
+    return FFmpegSwsPool::Default()->Acquire(
+        strings::StrCat(width, "x", height, ":", format),
+        [&](FFmpegSwsPool::Connection* connection) {
+          connection->reset(sws_getContext(width, height, format, width,
+                                           height, AV_PIX_FMT_RGB24, 0, NULL,
+                                           NULL, NULL));
+          if (*connection == nullptr) {
+            return errors::Internal("could not allocate sws context");
+          }
+          return OkStatus();
+        },
+        nullptr, sws_context);
+  }
+
   DataType dtype_;
 
   int64 channels_;
   int64 height_;
   int64 width_;
-  std::deque<std::unique_ptr<uint8_t, void (*)(uint8_t*)>> frames_buffer_;
-  std::unique_ptr<SwsContext, void (*)(SwsContext*)> sws_context_;
+  int64 skip_frames_ = 0;
+  int64 skip_timestamp_ = AV_NOPTS_VALUE;
 };
 
 class FFmpegVideoReadableResource : public ResourceBase {
@@ -784,26 +1160,45 @@ class FFmpegVideoReadableResource : public ResourceBase {
 
     return OkStatus();
   }
+  // Seeks to frame `index`, through the index of the keyframes of the file
+  // when the stream has one, and otherwise by decoding from the start.
   Status Seek(const int64 index) {
-    if (index != 0) {
-      return errors::InvalidArgument("seek only support 0");
+    if (index < 0) {
+      return errors::InvalidArgument("invalid seek to ", index);
+    }
+    if (index > 0) {
+      Status status = ffmpeg_video_stream_->SeekFrame(index, &index_);
+      if (status.ok()) {
+        frame_index_ = index;
+        return OkStatus();
+      }
+      if (!errors::IsUnimplemented(status)) {
+        return status;
+      }
     }
     ffmpeg_video_stream_.reset(
         new FFmpegVideoStream(filename_, file_.get(), file_size_));
 
     TF_RETURN_IF_ERROR(ffmpeg_video_stream_->OpenVideo(video_index_));
-    frame_index_ = 0;
+    if (index > 0) {
+      ffmpeg_video_stream_->SkipFrames(index);
+    }
+    frame_index_ = index;
     return OkStatus();
   }
-  Status Peek(TensorShape* shape) {
+  // The shape of the next `batch` frames, or of those of the next packet
+  // when `batch` is 0.
+  Status Peek(const int64 batch, TensorShape* shape) {
     int64 frames = 0;
-    Status status = ffmpeg_video_stream_->Peek(&frames);
+    Status status = ffmpeg_video_stream_->Peek(batch, &frames);
     *shape = TensorShape({frames, ffmpeg_video_stream_->height(),
                           ffmpeg_video_stream_->width(),
                           ffmpeg_video_stream_->channels()});
     return OkStatus();
   }
-  Status Read(Tensor* value) { return ffmpeg_video_stream_->Read(value); }
+  Status Read(Tensor* value, const DeviceBase::CpuWorkerThreads* workers) {
+    return ffmpeg_video_stream_->Read(value, workers);
+  }
   string DebugString() const override { return "FFmpegVideoReadableResource"; }
 
  private:
@@ -814,6 +1209,7 @@ class FFmpegVideoReadableResource : public ResourceBase {
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
   uint64 file_size_ TF_GUARDED_BY(mu_);
   std::unique_ptr<FFmpegVideoStream> ffmpeg_video_stream_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<FFmpegStreamIndex> index_ TF_GUARDED_BY(mu_);
   int64 frame_index_ TF_GUARDED_BY(mu_);
 };
 
@@ -854,6 +1250,8 @@ class FFmpegVideoReadableNextOp : public OpKernel {
   explicit FFmpegVideoReadableNextOp(OpKernelConstruction* context)
       : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("start", &start_));
+    OP_REQUIRES_OK(context, context->GetAttr("batch", &batch_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -866,22 +1264,27 @@ class FFmpegVideoReadableNextOp : public OpKernel {
     OP_REQUIRES_OK(context, context->input("reset", &reset_tensor));
     bool reset = reset_tensor->scalar<bool>()();
     if (reset) {
-      OP_REQUIRES_OK(context, resource->Seek(0));
+      OP_REQUIRES_OK(context, resource->Seek(start_));
     }
 
     TensorShape value_shape;
-    OP_REQUIRES_OK(context, resource->Peek(&value_shape));
+    OP_REQUIRES_OK(context, resource->Peek(batch_, &value_shape));
     Tensor* value_tensor = nullptr;
     OP_REQUIRES_OK(context,
                    context->allocate_output(0, value_shape, &value_tensor));
     if (value_shape.dim_size(0) > 0) {
-      OP_REQUIRES_OK(context, resource->Read(value_tensor));
+      OP_REQUIRES_OK(context,
+                     resource->Read(value_tensor,
+                                    context->device()
+                                        ->tensorflow_cpu_worker_threads()));
     }
   }
 
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  int64 start_;
+  int64 batch_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>FfmpegAudioReadableInit").Device(DEVICE_CPU),
@@ -926,7 +1329,10 @@ class FFmpegDecodeVideoOp : public OpKernel {
                                     stream.channels()}),
                        &video_tensor));
 
-    OP_REQUIRES_OK(context, stream.Read(video_tensor));
+    OP_REQUIRES_OK(
+        context,
+        stream.Read(video_tensor,
+                    context->device()->tensorflow_cpu_worker_threads()));
   }
 
  private:
@@ -17,6 +17,8 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_op_kernel.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
 namespace tensorflow {
@@ -71,10 +73,34 @@ class FileInfoOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+Status ReadFile(Env* env, const string& filename, const int64 offset,
+                const int64 length, const string& compression,
+                tstring* value) {
+  std::unique_ptr<tensorflow::RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+
+  std::unique_ptr<tensorflow::io::RandomAccessInputStream> input_stream(
+      new tensorflow::io::RandomAccessInputStream(file.get()));
+
+  tensorflow::io::InputStreamInterface* stream = input_stream.get();
+
+  std::unique_ptr<tensorflow::io::ZlibInputStream> zlib_stream;
+  if (compression == "GZIP") {
+    zlib_stream.reset(new tensorflow::io::ZlibInputStream(
+        input_stream.get(), 256 * 1024, 256 * 1024,
+        tensorflow::io::ZlibCompressionOptions::GZIP()));
+    stream = zlib_stream.get();
+  }
+
+  TF_RETURN_IF_ERROR(stream->SkipNBytes(offset));
+  return stream->ReadNBytes(length, value);
+}
+
 class FileReadOp : public OpKernel {
  public:
   explicit FileReadOp(OpKernelConstruction* context) : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("prefetch", &prefetch_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -94,72 +120,209 @@ class FileReadOp : public OpKernel {
     OP_REQUIRES_OK(context, context->input("compression", &compression_tensor));
     const string& compression = compression_tensor->scalar<tstring>()();
 
-    std::unique_ptr<tensorflow::RandomAccessFile> file;
-    OP_REQUIRES_OK(context, env_->NewRandomAccessFile(input, &file));
-
-    std::unique_ptr<tensorflow::io::RandomAccessInputStream> input_stream(
-        new tensorflow::io::RandomAccessInputStream(file.get()));
-
-    tensorflow::io::InputStreamInterface* stream = input_stream.get();
-
-    std::unique_ptr<tensorflow::io::ZlibInputStream> zlib_stream;
-    if (compression == "GZIP") {
-      zlib_stream.reset(new tensorflow::io::ZlibInputStream(
-          input_stream.get(), 256 * 1024, 256 * 1024,
-          tensorflow::io::ZlibCompressionOptions::GZIP()));
-      stream = zlib_stream.get();
+    std::shared_ptr<Prefetch> prefetched;
+    if (prefetch_) {
+      mutex_lock l(mu_);
+      if (prefetched_ != nullptr && prefetched_->filename == input &&
+          prefetched_->offset == offset && prefetched_->length == length &&
+          prefetched_->compression == compression) {
+        prefetched = prefetched_;
+      }
+      prefetched_.reset();
+      // Once a read starts where the previous one stopped, the chunk that
+      // follows is read in the background while this one is served.
+      if (input == filename_ && offset == stop_ && length > 0) {
+        prefetched_.reset(new Prefetch{input, offset + length, length,
+                                       compression});
+        std::shared_ptr<Prefetch> next = prefetched_;
+        Env* env = env_;
+        context->device()->tensorflow_cpu_worker_threads()->workers->Schedule(
+            [env, next]() {
+              next->status = ReadFile(env, next->filename, next->offset,
+                                      next->length, next->compression,
+                                      &next->value);
+              next->done.Notify();
+            });
+      }
+      filename_ = input;
+      stop_ = offset + length;
     }
 
-    OP_REQUIRES_OK(context, stream->SkipNBytes(offset));
-
     tstring value;
-    OP_REQUIRES_OK(context, stream->ReadNBytes(length, &value));
+    if (prefetched != nullptr) {
+      prefetched->done.WaitForNotification();
+      OP_REQUIRES_OK(context, prefetched->status);
+      value = std::move(prefetched->value);
+    } else {
+      OP_REQUIRES_OK(context, ReadFile(env_, input, offset, length,
+                                       compression, &value));
+    }
 
     Tensor* value_tensor = nullptr;
     OP_REQUIRES_OK(context,
                    context->allocate_output(0, TensorShape({}), &value_tensor));
-    value_tensor->scalar<tstring>()() = value;
+    value_tensor->scalar<tstring>()() = std::move(value);
   }
 
  private:
+  struct Prefetch {
+    string filename;
+    int64 offset;
+    int64 length;
+    string compression;
+    Notification done;
+    Status status;
+    tstring value;
+  };
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  bool prefetch_ = false;
+  string filename_ TF_GUARDED_BY(mu_);
+  int64 stop_ TF_GUARDED_BY(mu_) = -1;
+  std::shared_ptr<Prefetch> prefetched_ TF_GUARDED_BY(mu_);
 };
 
 class FileResource : public ResourceBase {
  public:
+  using DoneCallback = std::function<void(const Status&)>;
+
   FileResource(Env* env) : env_(env) {}
-  ~FileResource() {
-    if (file_.get() != nullptr) {
-      file_->Close();
-    }
-  }
+  ~FileResource() { Stop(); }
 
-  Status Init(const string& filename) {
+  // With a positive `buffer_size` the writes are appended to a buffer in
+  // memory, which a background thread appends to the file once it holds
+  // `buffer_size` bytes while the writes fill a second buffer.
+  Status Init(const string& filename, const int64 buffer_size) {
+    Stop();
+    mutex_lock l(mu_);
+    closed_ = false;
+    stop_ = false;
+    status_ = OkStatus();
+    buffer_.clear();
     TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file_));
+    buffer_size_ = buffer_size > 0 ? buffer_size : 0;
+    if (buffer_size_ > 0) {
+      thread_.reset(env_->StartThread(ThreadOptions(), "file_resource_writer",
+                                      [this] { Run(); }));
+    }
     return OkStatus();
   }
   Status Write(const Tensor& content) {
     mutex_lock l(mu_);
+    if (file_ == nullptr || closed_) {
+      return errors::FailedPrecondition("file is closed");
+    }
+    if (buffer_size_ == 0) {
+      for (int64 i = 0; i < content.NumElements(); i++) {
+        TF_RETURN_IF_ERROR(file_->Append(content.flat<tstring>()(i)));
+      }
+      return OkStatus();
+    }
+    // Only waits when both buffers are full, that is when the writes are
+    // faster than the file.
+    while (status_.ok() && buffer_.size() >= buffer_size_) cv_.wait(l);
+    TF_RETURN_IF_ERROR(status_);
     for (int64 i = 0; i < content.NumElements(); i++) {
-      TF_RETURN_IF_ERROR(file_->Append(content.flat<tstring>()(i)));
+      const tstring& entry = content.flat<tstring>()(i);
+      buffer_.append(entry.data(), entry.size());
     }
+    if (buffer_.size() >= buffer_size_) cv_.notify_all();
     return OkStatus();
   }
-  Status Sync() {
-    file_->Flush();
-    return OkStatus();
-  }
-  Status Close() {
-    file_.reset(nullptr);
-    return OkStatus();
+  // Flushes the file, or closes it with `close`, once everything written
+  // before has been appended, and then calls `done` with the first error
+  // of the writes, if any.
+  void Sync(const bool close, DoneCallback done) {
+    Status status;
+    {
+      mutex_lock l(mu_);
+      if (file_ != nullptr && !closed_) {
+        closed_ = close;
+        if (buffer_size_ > 0) {
+          requests_.push_back(SyncRequest{close, std::move(done)});
+          cv_.notify_all();
+          return;
+        }
+        status = close ? file_->Close() : file_->Flush();
+      }
+    }
+    done(status);
   }
   string DebugString() const override { return "FileResource"; }
 
  private:
+  struct SyncRequest {
+    bool close;
+    DoneCallback done;
+  };
+
+  void Run() {
+    string data;
+    while (true) {
+      std::vector<SyncRequest> requests;
+      {
+        mutex_lock l(mu_);
+        while (!stop_ && buffer_.size() < buffer_size_ && requests_.empty()) {
+          cv_.wait(l);
+        }
+        if (buffer_.empty() && requests_.empty()) return;
+        // Swaps the buffers so that the writes carry on into the drained
+        // one while this one is appended.
+        data.clear();
+        data.swap(buffer_);
+        requests.swap(requests_);
+        cv_.notify_all();
+      }
+      Status status;
+      if (!data.empty()) status = file_->Append(data);
+      bool close = false;
+      for (const SyncRequest& request : requests) close |= request.close;
+      if (!requests.empty()) {
+        status.Update(close ? file_->Close() : file_->Flush());
+      }
+      {
+        mutex_lock l(mu_);
+        status_.Update(status);
+        status = status_;
+        cv_.notify_all();
+      }
+      if (requests.empty()) continue;
+      // The callbacks are called off this thread, as releasing the last
+      // reference to the resource in one would join this thread.
+      env_->SchedClosure([requests, status]() {
+        for (const SyncRequest& request : requests) request.done(status);
+      });
+      if (close) return;
+    }
+  }
+  // Drains the buffers and closes the file, when not closed yet.
+  void Stop() {
+    {
+      mutex_lock l(mu_);
+      stop_ = true;
+      cv_.notify_all();
+    }
+    // Joins the write thread.
+    thread_.reset();
+    mutex_lock l(mu_);
+    if (file_ != nullptr && !closed_) {
+      file_->Close().IgnoreError();
+    }
+    file_.reset(nullptr);
+  }
+
   mutable mutex mu_;
-  Env* env_ TF_GUARDED_BY(mu_);
+  condition_variable cv_;
+  Env* env_;
   std::unique_ptr<WritableFile> file_;
+  size_t buffer_size_ TF_GUARDED_BY(mu_) = 0;
+  string buffer_ TF_GUARDED_BY(mu_);
+  std::vector<SyncRequest> requests_ TF_GUARDED_BY(mu_);
+  bool closed_ TF_GUARDED_BY(mu_) = false;
+  bool stop_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_;
 };
 
 class FileInitOp : public ResourceOpKernel<FileResource> {
@@ -167,6 +330,7 @@ class FileInitOp : public ResourceOpKernel<FileResource> {
   explicit FileInitOp(OpKernelConstruction* context)
       : ResourceOpKernel<FileResource>(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("buffer_size", &buffer_size_));
   }
 
  private:
@@ -176,7 +340,8 @@ class FileInitOp : public ResourceOpKernel<FileResource> {
     const Tensor* input_tensor;
     OP_REQUIRES_OK(context, context->input("input", &input_tensor));
 
-    OP_REQUIRES_OK(context, resource_->Init(input_tensor->scalar<tstring>()()));
+    OP_REQUIRES_OK(context, resource_->Init(input_tensor->scalar<tstring>()(),
+                                            buffer_size_));
   }
   Status CreateResource(FileResource** resource)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
@@ -187,15 +352,18 @@ class FileInitOp : public ResourceOpKernel<FileResource> {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  int64 buffer_size_ = 0;
 };
 
-class FileCallOp : public OpKernel {
+// The closing of the file, as well as the syncs, are asynchronous, so that
+// with a buffered resource they wait on the file without holding a thread.
+class FileCallOp : public AsyncOpKernel {
  public:
-  explicit FileCallOp(OpKernelConstruction* context) : OpKernel(context) {
+  explicit FileCallOp(OpKernelConstruction* context) : AsyncOpKernel(context) {
     env_ = context->env();
   }
 
-  void Compute(OpKernelContext* context) override {
+  void ComputeAsync(OpKernelContext* context, DoneCallback done) override {
     if (IsRefType(context->input_dtype(0))) {
       context->forward_ref_input_to_ref_output(0, 0);
     } else {
@@ -203,21 +371,29 @@ class FileCallOp : public OpKernel {
     }
 
     const Tensor* input_tensor;
-    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES_OK_ASYNC(context, context->input("input", &input_tensor),
+                         done);
 
     const Tensor* final_tensor;
-    OP_REQUIRES_OK(context, context->input("final", &final_tensor));
+    OP_REQUIRES_OK_ASYNC(context, context->input("final", &final_tensor),
+                         done);
 
     FileResource* resource;
-    OP_REQUIRES_OK(context,
-                   GetResourceFromContext(context, "resource", &resource));
-    core::ScopedUnref unref(resource);
-
-    OP_REQUIRES_OK(context, resource->Write(*input_tensor));
-
-    if (final_tensor->scalar<bool>()()) {
-      OP_REQUIRES_OK(context, resource->Close());
+    OP_REQUIRES_OK_ASYNC(
+        context, GetResourceFromContext(context, "resource", &resource), done);
+
+    Status status = resource->Write(*input_tensor);
+    if (!status.ok() || !final_tensor->scalar<bool>()()) {
+      resource->Unref();
+      OP_REQUIRES_OK_ASYNC(context, status, done);
+      done();
+      return;
     }
+    resource->Sync(true, [context, resource, done](const Status& status) {
+      resource->Unref();
+      OP_REQUIRES_OK_ASYNC(context, status, done);
+      done();
+    });
   }
 
  private:
@@ -225,18 +401,21 @@ class FileCallOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
-class FileSyncOp : public OpKernel {
+class FileSyncOp : public AsyncOpKernel {
  public:
-  explicit FileSyncOp(OpKernelConstruction* context) : OpKernel(context) {
+  explicit FileSyncOp(OpKernelConstruction* context) : AsyncOpKernel(context) {
     env_ = context->env();
   }
 
-  void Compute(OpKernelContext* context) override {
+  void ComputeAsync(OpKernelContext* context, DoneCallback done) override {
     FileResource* resource;
-    OP_REQUIRES_OK(context,
-                   GetResourceFromContext(context, "resource", &resource));
-    core::ScopedUnref unref(resource);
-    OP_REQUIRES_OK(context, resource->Sync());
+    OP_REQUIRES_OK_ASYNC(
+        context, GetResourceFromContext(context, "resource", &resource), done);
+    resource->Sync(false, [context, resource, done](const Status& status) {
+      resource->Unref();
+      OP_REQUIRES_OK_ASYNC(context, status, done);
+      done();
+    });
   }
 
  private:
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
 
 namespace tensorflow {
 namespace io {
@@ -61,6 +62,40 @@ REGISTER_KERNEL_BUILDER(
     Name("IO>FileSystemSetConfiguration").Device(DEVICE_CPU),
     FileSystemSetConfigurationOp);
 
+class MemoryBudgetUsageOp : public OpKernel {
+ public:
+  explicit MemoryBudgetUsageOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    MemoryBudget* budget = MemoryBudget::Global();
+    const std::map<std::string, MemoryBudget::Usage> usage = budget->usage();
+    const int64 size = static_cast<int64>(usage.size());
+    Tensor* component_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(0, TensorShape({size}),
+                                                     &component_tensor));
+    Tensor* bytes_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(1, TensorShape({size}),
+                                                     &bytes_tensor));
+    Tensor* peak_bytes_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(2, TensorShape({size}),
+                                                     &peak_bytes_tensor));
+    Tensor* limit_bytes_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(3, TensorShape({}),
+                                                     &limit_bytes_tensor));
+    int64 i = 0;
+    for (const auto& entry : usage) {
+      component_tensor->flat<tstring>()(i) = entry.first;
+      bytes_tensor->flat<int64>()(i) = entry.second.bytes;
+      peak_bytes_tensor->flat<int64>()(i) = entry.second.peak_bytes;
+      i++;
+    }
+    limit_bytes_tensor->scalar<int64>()() = budget->limit_bytes();
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("IO>MemoryBudgetUsage").Device(DEVICE_CPU),
+                        MemoryBudgetUsageOp);
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
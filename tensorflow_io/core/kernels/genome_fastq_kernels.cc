@@ -13,54 +13,747 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "nucleus/io/fastq_reader.h"
-#include "nucleus/platform/types.h"
-#include "nucleus/protos/fastq.pb.h"
-#include "nucleus/util/utils.h"
-#include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
-#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow_io/core/kernels/io_interface.h"
+#include "tensorflow_io/core/kernels/io_stream.h"
+#include "zlib.h"
 
 namespace tensorflow {
-
+namespace data {
 namespace {
-using nucleus::FastqReader;
-using nucleus::genomics::v1::FastqRecord;
-}  // namespace
+
+// A FASTQ read, with its sequence and quality lines.
+struct FastqRecord {
+  string sequence;
+  string quality;
+};
+
+// Reads a split of a FASTQ file block by block, along with how many leading
+// bytes of each block belong to the split. A record belongs to the split
+// that owns the newline before it, and the first record of the file to the
+// split starting at 0, so that each record is read by exactly one split.
+//
+// BGZF files, the blocked gzip written by bgzip and samtools, are inflated
+// one block at a time. A split of them starts at the first block starting
+// at or after its offset, and owns the whole of the blocks starting in it.
+class FastqBlockReader {
+ public:
+  FastqBlockReader(SizedRandomAccessFile* file, const uint64 file_size,
+                   const int64 block_size)
+      : file_(file), file_size_(file_size), block_size_(block_size) {}
+
+  Status Init(const int64 offset, const int64 length) {
+    char header[kBgzfHeaderBytes];
+    uint64 block_bytes = 0;
+    if (file_size_ >= 2) {
+      const size_t n = std::min<uint64>(kBgzfHeaderBytes, file_size_);
+      TF_RETURN_IF_ERROR(ReadFully(0, n, header));
+      compressed_ = (header[0] == '\x1f' && header[1] == '\x8b');
+      if (compressed_ &&
+          (n < kBgzfHeaderBytes || !ParseBgzfHeader(header, &block_bytes))) {
+        return errors::InvalidArgument(
+            "gzip compressed FASTQ must be BGZF compressed to be read");
+      }
+    }
+    split_start_ = std::min<uint64>(offset, file_size_);
+    split_stop_ = length < 0 ? file_size_
+                             : std::min<uint64>(file_size_,
+                                                split_start_ + length);
+    owns_first_ = (split_start_ == 0 && split_stop_ > 0);
+    if (compressed_ && split_start_ > 0) {
+      TF_RETURN_IF_ERROR(FindBlock(&split_start_));
+    }
+    Reset();
+    return OkStatus();
+  }
+
+  void Reset() { position_ = split_start_; }
+
+  // Whether the first record of the file belongs to the split.
+  bool owns_first() const { return owns_first_; }
+
+  // Reads the next block into `block`, and how many of its leading bytes
+  // the split owns into `owned`, or sets `eof` at the end of the file.
+  Status Next(string* block, size_t* owned, bool* eof) {
+    *eof = (position_ >= file_size_);
+    if (*eof) {
+      return OkStatus();
+    }
+    if (!compressed_) {
+      const size_t n = std::min<uint64>(block_size_, file_size_ - position_);
+      block->resize(n);
+      TF_RETURN_IF_ERROR(ReadFully(position_, n, &(*block)[0]));
+      *owned = position_ < split_stop_
+                   ? std::min<uint64>(n, split_stop_ - position_)
+                   : 0;
+      position_ += n;
+      return OkStatus();
+    }
+    char header[kBgzfHeaderBytes];
+    uint64 block_bytes = 0;
+    if (file_size_ - position_ < kBgzfHeaderBytes) {
+      return errors::DataLoss("truncated BGZF block at ", position_);
+    }
+    TF_RETURN_IF_ERROR(ReadFully(position_, kBgzfHeaderBytes, header));
+    if (!ParseBgzfHeader(header, &block_bytes) ||
+        block_bytes < kBgzfHeaderBytes + kBgzfTrailerBytes ||
+        block_bytes > file_size_ - position_) {
+      return errors::DataLoss("invalid BGZF block at ", position_);
+    }
+    compressed_block_.resize(block_bytes);
+    TF_RETURN_IF_ERROR(
+        ReadFully(position_, block_bytes, &compressed_block_[0]));
+    TF_RETURN_IF_ERROR(Inflate(block));
+    *owned = position_ < split_stop_ ? block->size() : 0;
+    position_ += block_bytes;
+    return OkStatus();
+  }
+
+ private:
+  // Parses the header of a BGZF block, which is a gzip member with a 'BC'
+  // extra field holding the size of the block less one.
+  static bool ParseBgzfHeader(const char* p, uint64* block_bytes) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    if (u[0] != 0x1f || u[1] != 0x8b || u[2] != 8 || (u[3] & 4) == 0 ||
+        u[10] != 6 || u[11] != 0 || u[12] != 'B' || u[13] != 'C' ||
+        u[14] != 2 || u[15] != 0) {
+      return false;
+    }
+    *block_bytes = (static_cast<uint64>(u[16]) | (u[17] << 8)) + 1;
+    return true;
+  }
+
+  Status ReadFully(const uint64 offset, const size_t n, char* buffer) {
+    StringPiece result;
+    Status status = file_->Read(offset, n, &result, buffer);
+    if (!status.ok() && !errors::IsOutOfRange(status)) {
+      return status;
+    }
+    if (result.size() != n) {
+      return errors::DataLoss("unexpected end of file at ",
+                              offset + result.size());
+    }
+    if (result.data() != buffer) {
+      memcpy(buffer, result.data(), n);
+    }
+    return OkStatus();
+  }
+
+  // Moves `position` to the first block header at or after it, taking a
+  // match as a header only when another header or the end of the file
+  // follows the block it describes.
+  Status FindBlock(uint64* position) {
+    string buffer;
+    uint64 scan = *position;
+    while (file_size_ - scan >= kBgzfHeaderBytes) {
+      const size_t n = std::min<uint64>(kScanBytes + kBgzfHeaderBytes - 1,
+                                        file_size_ - scan);
+      buffer.resize(n);
+      TF_RETURN_IF_ERROR(ReadFully(scan, n, &buffer[0]));
+      for (size_t i = 0; i + kBgzfHeaderBytes <= n; i++) {
+        uint64 block_bytes = 0;
+        if (buffer[i] != '\x1f' ||
+            !ParseBgzfHeader(&buffer[i], &block_bytes)) {
+          continue;
+        }
+        const uint64 next = scan + i + block_bytes;
+        bool valid = (next == file_size_);
+        if (!valid && next < file_size_ &&
+            file_size_ - next >= kBgzfHeaderBytes) {
+          char header[kBgzfHeaderBytes];
+          TF_RETURN_IF_ERROR(ReadFully(next, kBgzfHeaderBytes, header));
+          valid = ParseBgzfHeader(header, &block_bytes);
+        }
+        if (valid) {
+          *position = scan + i;
+          return OkStatus();
+        }
+      }
+      scan += n - kBgzfHeaderBytes + 1;
+    }
+    *position = file_size_;
+    return OkStatus();
+  }
+
+  Status Inflate(string* block) {
+    const unsigned char* trailer = reinterpret_cast<const unsigned char*>(
+        compressed_block_.data() + compressed_block_.size() - 4);
+    const uint32 size = static_cast<uint32>(trailer[0]) |
+                        (static_cast<uint32>(trailer[1]) << 8) |
+                        (static_cast<uint32>(trailer[2]) << 16) |
+                        (static_cast<uint32>(trailer[3]) << 24);
+    block->resize(size);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+      return errors::Internal("failed to initialize inflate");
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(&compressed_block_[0]) +
+                     kBgzfHeaderBytes;
+    stream.avail_in =
+        compressed_block_.size() - kBgzfHeaderBytes - kBgzfTrailerBytes;
+    stream.next_out = reinterpret_cast<Bytef*>(&(*block)[0]);
+    stream.avail_out = size;
+    const int code = inflate(&stream, Z_FINISH);
+    const uint64 produced = stream.total_out;
+    inflateEnd(&stream);
+    if (code != Z_STREAM_END || produced != size) {
+      return errors::DataLoss("failed to inflate BGZF block at ", position_);
+    }
+    return OkStatus();
+  }
+
+  static constexpr size_t kBgzfHeaderBytes = 18;
+  static constexpr size_t kBgzfTrailerBytes = 8;
+  // The bytes read at a time looking for the first block of a split.
+  static constexpr size_t kScanBytes = 64 << 10;
+
+  SizedRandomAccessFile* file_;
+  const uint64 file_size_;
+  const int64 block_size_;
+  bool compressed_ = false;
+  bool owns_first_ = false;
+  uint64 split_start_ = 0;
+  uint64 split_stop_ = 0;
+  uint64 position_ = 0;
+  string compressed_block_;
+};
+
+// Splits the blocks of a split of a FASTQ file into its 4-line records.
+// Records of other splits are skipped by looking for a newline followed by
+// a line starting with '@' and, two lines later, a line starting with '+',
+// which quality lines starting with '@' do not match.
+class FastqRecordReader {
+ public:
+  explicit FastqRecordReader(FastqBlockReader* blocks) : blocks_(blocks) {}
+
+  void Reset() {
+    blocks_->Reset();
+    buffer_.clear();
+    position_ = 0;
+    owned_ = 0;
+    owning_ = true;
+    eof_ = false;
+    synced_ = false;
+    done_ = false;
+  }
+
+  // Reads the next record of the split into `record`, or sets `eof` when
+  // the split has no more records.
+  Status Next(FastqRecord* record, bool* eof) {
+    *eof = done_;
+    if (done_) {
+      return OkStatus();
+    }
+    // The newline before the next record is kept, as it tells whether the
+    // record belongs to the split.
+    if (position_ > 1 && position_ * 2 >= buffer_.size()) {
+      const size_t consumed = position_ - 1;
+      buffer_.erase(0, consumed);
+      owned_ -= std::min(owned_, consumed);
+      position_ -= consumed;
+    }
+    if (!synced_) {
+      bool found = false;
+      TF_RETURN_IF_ERROR(Sync(&found));
+      synced_ = true;
+      if (!found) {
+        done_ = *eof = true;
+        return OkStatus();
+      }
+    } else {
+      bool owned = false;
+      TF_RETURN_IF_ERROR(Owned(position_ - 1, &owned));
+      if (!owned) {
+        done_ = *eof = true;
+        return OkStatus();
+      }
+    }
+    size_t ends[4];
+    bool complete = false;
+    TF_RETURN_IF_ERROR(Lines(position_, ends, &complete));
+    if (!complete) {
+      for (size_t i = position_; i < buffer_.size(); i++) {
+        if (!isspace(static_cast<unsigned char>(buffer_[i]))) {
+          return errors::DataLoss("truncated FASTQ record: ",
+                                  Header(position_));
+        }
+      }
+      done_ = *eof = true;
+      return OkStatus();
+    }
+    if (!IsRecord(position_, ends)) {
+      return errors::DataLoss("invalid FASTQ record: ", Header(position_));
+    }
+    const size_t sequence = ends[0] + 1;
+    const size_t quality = ends[2] + 1;
+    record->sequence.assign(&buffer_[sequence],
+                            LineEnd(sequence, ends[1]) - sequence);
+    record->quality.assign(&buffer_[quality],
+                           LineEnd(quality, ends[3]) - quality);
+    position_ = std::min(ends[3] + 1, buffer_.size());
+    return OkStatus();
+  }
+
+ private:
+  // Appends the next block to the buffer, or sets `filled` false at the end
+  // of the file.
+  Status Fill(bool* filled) {
+    *filled = false;
+    if (eof_) {
+      return OkStatus();
+    }
+    size_t owned = 0;
+    TF_RETURN_IF_ERROR(blocks_->Next(&block_, &owned, &eof_));
+    if (eof_) {
+      return OkStatus();
+    }
+    if (owned > 0) {
+      owned_ = buffer_.size() + owned;
+    }
+    if (owned < block_.size()) {
+      owning_ = false;
+    }
+    buffer_.append(block_);
+    *filled = true;
+    return OkStatus();
+  }
+
+  // Whether the split owns the byte at `index` of the buffer.
+  Status Owned(const size_t index, bool* owned) {
+    while (index >= owned_ && owning_) {
+      bool filled = false;
+      TF_RETURN_IF_ERROR(Fill(&filled));
+      if (!filled) {
+        break;
+      }
+    }
+    *owned = (index < owned_);
+    return OkStatus();
+  }
+
+  // Finds the newline ending the line starting at `start` into `end`, or
+  // the end of the file when the last line has none. Sets `found` false
+  // when the file ends at `start`.
+  Status NextLine(const size_t start, size_t* end, bool* found) {
+    size_t scanned = start;
+    while (true) {
+      if (scanned < buffer_.size()) {
+        const void* p = memchr(&buffer_[scanned], '\n',
+                               buffer_.size() - scanned);
+        if (p != nullptr) {
+          *end = static_cast<const char*>(p) - buffer_.data();
+          *found = true;
+          return OkStatus();
+        }
+        scanned = buffer_.size();
+      }
+      bool filled = false;
+      TF_RETURN_IF_ERROR(Fill(&filled));
+      if (!filled) {
+        *end = buffer_.size();
+        *found = (start < buffer_.size());
+        return OkStatus();
+      }
+    }
+  }
+
+  // Finds the ends of the 4 lines of the record starting at `start`.
+  Status Lines(const size_t start, size_t* ends, bool* complete) {
+    *complete = false;
+    size_t line = start;
+    for (int i = 0; i < 4; i++) {
+      bool found = false;
+      TF_RETURN_IF_ERROR(NextLine(line, &ends[i], &found));
+      if (!found) {
+        return OkStatus();
+      }
+      line = ends[i] + 1;
+    }
+    *complete = true;
+    return OkStatus();
+  }
+
+  // The end of the line [start, end) less a trailing carriage return.
+  size_t LineEnd(const size_t start, const size_t end) const {
+    return (end > start && buffer_[end - 1] == '\r') ? end - 1 : end;
+  }
+
+  bool IsRecord(const size_t start, const size_t* ends) const {
+    const size_t sequence = ends[0] + 1;
+    const size_t separator = ends[1] + 1;
+    const size_t quality = ends[2] + 1;
+    return buffer_[start] == '@' && separator < buffer_.size() &&
+           buffer_[separator] == '+' &&
+           LineEnd(sequence, ends[1]) - sequence ==
+               LineEnd(quality, ends[3]) - quality;
+  }
+
+  string Header(const size_t start) const {
+    const size_t end = std::min(buffer_.size(), start + 64);
+    const void* p = memchr(&buffer_[start], '\n', end - start);
+    return buffer_.substr(
+        start, p == nullptr ? end - start
+                            : static_cast<const char*>(p) - &buffer_[start]);
+  }
+
+  // Moves to the first record of the split, setting `found` false when it
+  // has none.
+  Status Sync(bool* found) {
+    *found = false;
+    if (blocks_->owns_first()) {
+      position_ = 0;
+      *found = true;
+      return OkStatus();
+    }
+    size_t index = 0;
+    while (true) {
+      size_t end = 0;
+      bool line = false;
+      TF_RETURN_IF_ERROR(NextLine(index, &end, &line));
+      if (!line || end >= buffer_.size()) {
+        return OkStatus();
+      }
+      bool owned = false;
+      TF_RETURN_IF_ERROR(Owned(end, &owned));
+      if (!owned) {
+        return OkStatus();
+      }
+      size_t ends[4];
+      bool complete = false;
+      TF_RETURN_IF_ERROR(Lines(end + 1, ends, &complete));
+      if (!complete) {
+        return OkStatus();
+      }
+      if (IsRecord(end + 1, ends)) {
+        position_ = end + 1;
+        *found = true;
+        return OkStatus();
+      }
+      index = end + 1;
+    }
+  }
+
+  FastqBlockReader* blocks_;
+  string block_;
+  // The bytes read and not consumed yet, of which the first `owned_` are
+  // owned by the split, and the start of the next record.
+  string buffer_;
+  size_t owned_ = 0;
+  size_t position_ = 0;
+  // Whether the blocks read so far have all been owned by the split.
+  bool owning_ = true;
+  bool eof_ = false;
+  bool synced_ = false;
+  bool done_ = false;
+};
+
+// Packs a base into 2 bits, or returns 4 for bases other than A, C, G, T.
+inline uint8 FastqBaseCode(const char base) {
+  switch (base) {
+    case 'A':
+    case 'a':
+      return 0;
+    case 'C':
+    case 'c':
+      return 1;
+    case 'G':
+    case 'g':
+      return 2;
+    case 'T':
+    case 't':
+      return 3;
+    default:
+      return 4;
+  }
+}
+
+class FastqReadable : public IOReadableInterface {
+ public:
+  FastqReadable(Env* env) : env_(env) {}
+
+  ~FastqReadable() {}
+  Status Init(const std::vector<string>& input,
+              const std::vector<string>& metadata, const void* memory_data,
+              const int64 memory_size) override {
+    if (input.size() > 1) {
+      return errors::InvalidArgument("more than 1 filename is not supported");
+    }
+    const string& filename = input[0];
+    file_.reset(
+        new SizedRandomAccessFile(env_, filename, memory_data, memory_size));
+    TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
+
+    // Only the records starting in the bytes [offset, offset + length) of
+    // the file are read, or with BGZF, in the blocks starting there.
+    int64 offset = 0;
+    int64 length = -1;
+    int64 block_size = kDefaultBlockSize;
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("offset: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &offset) ||
+            offset < 0) {
+          return errors::InvalidArgument("invalid offset: ", metadata[i]);
+        }
+      } else if (metadata[i].find("length: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &length)) {
+          return errors::InvalidArgument("invalid length: ", metadata[i]);
+        }
+      } else if (metadata[i].find("block_size: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(12), &block_size) ||
+            block_size <= 0) {
+          return errors::InvalidArgument("invalid block size: ", metadata[i]);
+        }
+      }
+    }
+    blocks_.reset(new FastqBlockReader(file_.get(), file_size_, block_size));
+    TF_RETURN_IF_ERROR(blocks_->Init(offset, length));
+    reader_.reset(new FastqRecordReader(blocks_.get()));
+    reader_->Reset();
+    return OkStatus();
+  }
+  Status Components(std::vector<string>* components) override {
+    components->clear();
+    components->push_back("sequences");
+    components->push_back("qualities");
+    return OkStatus();
+  }
+  Status Spec(const string& component, PartialTensorShape* shape,
+              DataType* dtype, bool label) override {
+    if (component != "sequences" && component != "qualities") {
+      return errors::InvalidArgument("component ", component, " is invalid");
+    }
+    *shape = PartialTensorShape({-1});
+    *dtype = DT_STRING;
+    return OkStatus();
+  }
+
+  Status Read(const int64 start, const int64 stop, const string& component,
+              int64* record_read, Tensor* value, Tensor* label) override {
+    if (component != "sequences" && component != "qualities") {
+      return errors::InvalidArgument("component ", component, " is invalid");
+    }
+    const int64 index = (component == "sequences") ? 0 : 1;
+    mutex_lock l(mu_);
+    (*record_read) = 0;
+    TF_RETURN_IF_ERROR(Fetch(start, stop));
+    const int64 element_stop = std::min<int64>(stop, records_stop());
+    if (start >= element_stop) {
+      return OkStatus();
+    }
+    for (int64 i = start; i < element_stop; i++) {
+      const FastqRecord& record = records_[i - records_start_];
+      value->flat<tstring>()(i - start) =
+          index == 0 ? record.sequence : record.quality;
+    }
+    (*record_read) = element_stop - start;
+    progress_[index] = element_stop;
+    Evict();
+    return OkStatus();
+  }
+
+  // Reads the records [start, stop) with the bases packed 4 to a byte,
+  // the first base of a byte in its 2 high bits as A = 0, C = 1, G = 2 and
+  // T = 3, and the phred quality scores as bytes. Bases other than A, C, G
+  // and T are packed as A with a quality of 0. The bases of each record
+  // start on a new byte.
+  Status ReadPacked(
+      const int64 start, const int64 stop,
+      std::function<Status(const int64 records, const int64 bytes,
+                           const int64 bases, Tensor** base_splits,
+                           Tensor** packed, Tensor** quality_splits,
+                           Tensor** qualities)>
+          allocate_func) {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(Fetch(start, stop));
+    const int64 element_start = std::max<int64>(start, records_start_);
+    const int64 element_stop =
+        std::max<int64>(element_start, std::min<int64>(stop, records_stop()));
+    int64 bytes = 0;
+    int64 bases = 0;
+    for (int64 i = element_start; i < element_stop; i++) {
+      const int64 n = records_[i - records_start_].sequence.size();
+      bytes += (n + 3) / 4;
+      bases += n;
+    }
+    Tensor* base_splits;
+    Tensor* packed;
+    Tensor* quality_splits;
+    Tensor* qualities;
+    TF_RETURN_IF_ERROR(allocate_func(element_stop - element_start, bytes,
+                                     bases, &base_splits, &packed,
+                                     &quality_splits, &qualities));
+    int64* base_split = base_splits->flat<int64>().data();
+    int64* quality_split = quality_splits->flat<int64>().data();
+    uint8* byte = packed->flat<uint8>().data();
+    uint8* score = qualities->flat<uint8>().data();
+    base_split[0] = 0;
+    quality_split[0] = 0;
+    for (int64 i = element_start; i < element_stop; i++) {
+      const FastqRecord& record = records_[i - records_start_];
+      const int64 n = record.sequence.size();
+      memset(byte, 0, (n + 3) / 4);
+      for (int64 j = 0; j < n; j++) {
+        const uint8 code = FastqBaseCode(record.sequence[j]);
+        const uint8 quality = static_cast<uint8>(record.quality[j]);
+        if (code < 4) {
+          byte[j / 4] |= code << (6 - 2 * (j % 4));
+          score[j] = quality > 33 ? quality - 33 : 0;
+        } else {
+          score[j] = 0;
+        }
+      }
+      byte += (n + 3) / 4;
+      score += n;
+      base_split[i - element_start + 1] = base_split[i - element_start] +
+                                          (n + 3) / 4;
+      quality_split[i - element_start + 1] =
+          quality_split[i - element_start] + n;
+    }
+    progress_[0] = std::max(progress_[0], element_stop);
+    progress_[1] = std::max(progress_[1], element_stop);
+    Evict();
+    return OkStatus();
+  }
+
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return strings::StrCat("FastqReadable");
+  }
+
+ private:
+  int64 records_stop() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return records_start_ + static_cast<int64>(records_.size());
+  }
+
+  // Parses the records up to `stop`. Records are dropped once both
+  // components have been read past them, so that reading from an earlier
+  // record restarts from the beginning of the split.
+  Status Fetch(const int64 start, const int64 stop)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (start < records_start_) {
+      reader_->Reset();
+      records_.clear();
+      records_start_ = 0;
+      eof_ = false;
+      progress_[0] = start;
+      progress_[1] = start;
+    }
+    while (!eof_ && records_stop() < stop) {
+      FastqRecord record;
+      TF_RETURN_IF_ERROR(reader_->Next(&record, &eof_));
+      if (eof_) {
+        break;
+      }
+      records_.push_back(std::move(record));
+      Evict();
+    }
+    return OkStatus();
+  }
+
+  void Evict() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const int64 read = std::min(progress_[0], progress_[1]);
+    while (!records_.empty() && records_start_ < read) {
+      records_.pop_front();
+      records_start_++;
+    }
+  }
+
+  static constexpr int64 kDefaultBlockSize = 1 << 20;
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
+  uint64 file_size_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<FastqBlockReader> blocks_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<FastqRecordReader> reader_ TF_GUARDED_BY(mu_);
+  // The records parsed and not read past yet, the first of which is the
+  // record `records_start_` of the split.
+  std::deque<FastqRecord> records_ TF_GUARDED_BY(mu_);
+  int64 records_start_ TF_GUARDED_BY(mu_) = 0;
+  bool eof_ TF_GUARDED_BY(mu_) = false;
+  // The record the sequences and the qualities have been read up to.
+  int64 progress_[2] TF_GUARDED_BY(mu_) = {0, 0};
+};
+
+class FastqReadableReadPackedOp : public OpKernel {
+ public:
+  explicit FastqReadableReadPackedOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    FastqReadable* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    const int64 start = start_tensor->scalar<int64>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    const int64 stop = stop_tensor->scalar<int64>()();
+
+    OP_REQUIRES_OK(
+        context,
+        resource->ReadPacked(
+            start, stop,
+            [&](const int64 records, const int64 bytes, const int64 bases,
+                Tensor** base_splits, Tensor** packed,
+                Tensor** quality_splits, Tensor** qualities) -> Status {
+              TF_RETURN_IF_ERROR(context->allocate_output(
+                  0, TensorShape({records + 1}), base_splits));
+              TF_RETURN_IF_ERROR(
+                  context->allocate_output(1, TensorShape({bytes}), packed));
+              TF_RETURN_IF_ERROR(context->allocate_output(
+                  2, TensorShape({records + 1}), quality_splits));
+              TF_RETURN_IF_ERROR(context->allocate_output(
+                  3, TensorShape({bases}), qualities));
+              return OkStatus();
+            }));
+  }
+};
 
 class FastqOp : public OpKernel {
  public:
-  explicit FastqOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit FastqOp(OpKernelConstruction* context)
+      : OpKernel(context), env_(context->env()) {}
   ~FastqOp() {}
 
   void Compute(OpKernelContext* context) override {
     const Tensor& filename_tensor = context->input(0);
     const std::string& filename = filename_tensor.scalar<tstring>()();
 
-    std::unique_ptr<FastqReader> reader =
-        std::move(FastqReader::FromFile(
-                      filename, nucleus::genomics::v1::FastqReaderOptions())
-                      .ValueOrDie());
-
-    std::vector<std::string> sequences;
-    std::vector<std::string> quality;
+    SizedRandomAccessFile file(env_, filename, nullptr, 0);
+    uint64 file_size = 0;
+    OP_REQUIRES_OK(context, file.GetFileSize(&file_size));
+    FastqBlockReader blocks(&file, file_size, kBlockSize);
+    OP_REQUIRES_OK(context, blocks.Init(0, -1));
+    FastqRecordReader reader(&blocks);
+    reader.Reset();
 
-    std::shared_ptr<nucleus::FastqIterable> fastq_iterable =
-        reader->Iterate().ValueOrDie();
-    for (const nucleus::StatusOr<FastqRecord*> maybe_sequence :
-         fastq_iterable) {
-      OP_REQUIRES(
-          context, maybe_sequence.ok(),
-          errors::Internal("internal error: ", maybe_sequence.error_message()));
-      sequences.push_back(maybe_sequence.ValueOrDie()->sequence());
-      quality.push_back(maybe_sequence.ValueOrDie()->quality());
+    std::vector<FastqRecord> records;
+    while (true) {
+      FastqRecord record;
+      bool eof = false;
+      OP_REQUIRES_OK(context, reader.Next(&record, &eof));
+      if (eof) {
+        break;
+      }
+      records.push_back(std::move(record));
     }
 
-    TensorShape output_shape({static_cast<int64>(sequences.size())});
+    TensorShape output_shape({static_cast<int64>(records.size())});
     Tensor* output_tensor;
     Tensor* quality_tensor;
     OP_REQUIRES_OK(context,
@@ -68,13 +761,28 @@ class FastqOp : public OpKernel {
     OP_REQUIRES_OK(context,
                    context->allocate_output(1, output_shape, &quality_tensor));
 
-    for (size_t i = 0; i < sequences.size(); i++) {
-      output_tensor->flat<tstring>()(i) = std::move(sequences[i]);
-      quality_tensor->flat<tstring>()(i) = std::move(quality[i]);
+    for (size_t i = 0; i < records.size(); i++) {
+      output_tensor->flat<tstring>()(i) = std::move(records[i].sequence);
+      quality_tensor->flat<tstring>()(i) = std::move(records[i].quality);
     }
   }
+
+ private:
+  static constexpr int64 kBlockSize = 1 << 20;
+
+  Env* env_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>ReadFastq").Device(DEVICE_CPU), FastqOp);
+REGISTER_KERNEL_BUILDER(Name("IO>FastqReadableInit").Device(DEVICE_CPU),
+                        IOInterfaceInitOp<FastqReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>FastqReadableSpec").Device(DEVICE_CPU),
+                        IOInterfaceSpecOp<FastqReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>FastqReadableRead").Device(DEVICE_CPU),
+                        IOReadableReadOp<FastqReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>FastqReadableReadPacked").Device(DEVICE_CPU),
+                        FastqReadableReadPackedOp);
 
+}  // namespace
+}  // namespace data
 }  // namespace tensorflow
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include <grpc++/grpc++.h>
 
+#include <deque>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/util/batch_util.h"
 #include "tensorflow_io/core/grpc/endpoint.grpc.pb.h"
 
 namespace tensorflow {
@@ -26,11 +29,32 @@ namespace {
 class GRPCReadableResource : public ResourceBase {
  public:
   GRPCReadableResource(Env* env) : env_(env) {}
-  ~GRPCReadableResource() {}
+  ~GRPCReadableResource() {
+    StopStream();
+    // Pending calls have to complete before the completion queue goes away.
+    for (auto& call : calls_) {
+      call->context.TryCancel();
+      cancelled_.push_back(std::move(call));
+    }
+    calls_.clear();
+    for (auto& call : cancelled_) {
+      WaitCall(call.get()).IgnoreError();
+    }
+    cq_.Shutdown();
+    void* tag;
+    bool ok;
+    while (cq_.Next(&tag, &ok)) {
+    }
+  }
 
-  Status Init(const string& input) {
+  // In stream mode the records are pushed by the server through StreamRecord,
+  // otherwise up to `in_flight` ReadRecord calls of the following ranges are
+  // kept pending, so that the next range arrives while one is consumed.
+  Status Init(const string& input, const bool stream, const int64 in_flight) {
     mutex_lock l(mu_);
     endpoint_ = input;
+    stream_ = stream;
+    in_flight_ = std::max<int64>(in_flight, 1);
     stub_ = GRPCEndpoint::NewStub(
         grpc::CreateChannel(endpoint_, grpc::InsecureChannelCredentials()));
     return OkStatus();
@@ -45,20 +69,43 @@ class GRPCReadableResource : public ResourceBase {
     if (shape.dim_size(0) == 0) {
       return OkStatus();
     }
+    if (stream_) {
+      return ReadStream(start, value);
+    }
 
-    Request request;
-    request.set_offset(start);
-    request.set_length(shape.dim_size(0));
-    Response response;
-    grpc::ClientContext context;
-    grpc::Status status = stub_->ReadRecord(&context, request, &response);
-    if (!status.ok()) {
+    const int64 length = shape.dim_size(0);
+    // Calls of other ranges, e.g., prefetched before a rewind, are dropped.
+    if (!calls_.empty() &&
+        (calls_.front()->offset != start || calls_.front()->length != length)) {
+      for (auto& call : calls_) {
+        call->context.TryCancel();
+        cancelled_.push_back(std::move(call));
+      }
+      calls_.clear();
+    }
+    int64 offset = start;
+    if (!calls_.empty()) {
+      offset = calls_.back()->offset + calls_.back()->length;
+    }
+    while (calls_.size() < in_flight_) {
+      StartCall(offset, length);
+      offset += length;
+    }
+
+    std::unique_ptr<AsyncCall> call = std::move(calls_.front());
+    calls_.pop_front();
+    TF_RETURN_IF_ERROR(WaitCall(call.get()));
+    auto it = std::remove_if(
+        cancelled_.begin(), cancelled_.end(),
+        [](const std::unique_ptr<AsyncCall>& c) { return c->done; });
+    cancelled_.erase(it, cancelled_.end());
+    if (!call->status.ok()) {
       return errors::InvalidArgument("unable to fetch data from grpc (",
-                                     status.error_code(),
-                                     "): ", status.error_message());
+                                     call->status.error_code(),
+                                     "): ", call->status.error_message());
     }
     TensorProto record;
-    response.record().UnpackTo(&record);
+    call->response.record().UnpackTo(&record);
 
     if (!value->FromProto(record)) {
       return errors::InvalidArgument("unable to fill tensor");
@@ -72,10 +119,186 @@ class GRPCReadableResource : public ResourceBase {
   }
 
  protected:
+  struct AsyncCall {
+    int64 offset;
+    int64 length;
+    grpc::ClientContext context;
+    Response response;
+    grpc::Status status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<Response>> reader;
+    bool done = false;
+  };
+
+  void StartCall(const int64 offset, const int64 length)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::unique_ptr<AsyncCall> call(new AsyncCall());
+    call->offset = offset;
+    call->length = length;
+    Request request;
+    request.set_offset(offset);
+    request.set_length(length);
+    call->reader = stub_->AsyncReadRecord(&call->context, request, &cq_);
+    call->reader->Finish(&call->response, &call->status, call.get());
+    calls_.push_back(std::move(call));
+  }
+
+  // Waits on the completion queue until `call` is done, marking the other
+  // calls that complete in the meantime.
+  Status WaitCall(AsyncCall* call) {
+    while (!call->done) {
+      void* tag;
+      bool ok;
+      if (!cq_.Next(&tag, &ok)) {
+        return errors::Internal("grpc completion queue is shut down");
+      }
+      static_cast<AsyncCall*>(tag)->done = true;
+    }
+    return OkStatus();
+  }
+
+  Status ReadStream(const int64 start, Tensor* value)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (stream_thread_ == nullptr || start != stream_offset_) {
+      StopStream();
+      StartStream(start);
+    }
+    const int64 length = value->dim_size(0);
+    int64 filled = 0;
+    mutex_lock l(queue_mu_);
+    while (filled < length) {
+      while (queue_.empty() && !stream_done_) {
+        queue_cv_.wait(l);
+      }
+      if (queue_.empty()) {
+        TF_RETURN_IF_ERROR(stream_status_);
+        return errors::InvalidArgument("grpc stream ended at ",
+                                       start + filled, " before ",
+                                       start + length);
+      }
+      const Tensor& front = queue_.front();
+      if (front.dtype() != value->dtype()) {
+        return errors::InvalidArgument("grpc stream dtype ",
+                                       DataTypeString(front.dtype()),
+                                       " does not match ",
+                                       DataTypeString(value->dtype()));
+      }
+      const int64 count =
+          std::min(length - filled, front.dim_size(0) - front_offset_);
+      TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+          front, front_offset_, filled, count, value));
+      filled += count;
+      front_offset_ += count;
+      if (front_offset_ == front.dim_size(0)) {
+        queue_.pop_front();
+        front_offset_ = 0;
+        queue_cv_.notify_all();
+      }
+    }
+    stream_offset_ += length;
+    return OkStatus();
+  }
+
+  void StartStream(const int64 start) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    {
+      mutex_lock l(queue_mu_);
+      queue_.clear();
+      front_offset_ = 0;
+      stream_done_ = false;
+      stream_stop_ = false;
+      stream_status_ = OkStatus();
+    }
+    stream_offset_ = start;
+    stream_context_.reset(new grpc::ClientContext());
+    GRPCEndpoint::Stub* stub = stub_.get();
+    grpc::ClientContext* context = stream_context_.get();
+    stream_thread_.reset(env_->StartThread(
+        ThreadOptions(), "grpc_stream",
+        [this, stub, context, start] { RunStream(stub, context, start); }));
+  }
+
+  void StopStream() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (stream_thread_ == nullptr) {
+      return;
+    }
+    {
+      mutex_lock l(queue_mu_);
+      stream_stop_ = true;
+      queue_cv_.notify_all();
+    }
+    stream_context_->TryCancel();
+    // Joins the stream thread.
+    stream_thread_.reset();
+    stream_context_.reset();
+  }
+
+  // Pushes the records streamed from `start` to the end into the bounded
+  // queue, decoding them on this thread.
+  void RunStream(GRPCEndpoint::Stub* stub, grpc::ClientContext* context,
+                 const int64 start) {
+    Request request;
+    request.set_offset(start);
+    request.set_length(0);
+    std::unique_ptr<grpc::ClientReader<Response>> reader =
+        stub->StreamRecord(context, request);
+    Status status;
+    Response response;
+    while (reader->Read(&response)) {
+      TensorProto record;
+      Tensor tensor;
+      if (!response.record().UnpackTo(&record) || !tensor.FromProto(record) ||
+          tensor.dims() == 0) {
+        status = errors::InvalidArgument("unable to fill tensor");
+        context->TryCancel();
+        break;
+      }
+      mutex_lock l(queue_mu_);
+      while (!stream_stop_ && queue_.size() >= kQueueCapacity) {
+        queue_cv_.wait(l);
+      }
+      if (stream_stop_) {
+        context->TryCancel();
+        break;
+      }
+      queue_.push_back(std::move(tensor));
+      queue_cv_.notify_all();
+    }
+    grpc::Status grpc_status = reader->Finish();
+    mutex_lock l(queue_mu_);
+    if (status.ok() && !grpc_status.ok() && !stream_stop_) {
+      status = errors::InvalidArgument("unable to fetch data from grpc (",
+                                       grpc_status.error_code(),
+                                       "): ", grpc_status.error_message());
+    }
+    stream_status_ = status;
+    stream_done_ = true;
+    queue_cv_.notify_all();
+  }
+
+  // The number of streamed responses buffered ahead of Read.
+  static constexpr size_t kQueueCapacity = 16;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   string endpoint_ TF_GUARDED_BY(mu_);
+  bool stream_ TF_GUARDED_BY(mu_) = false;
+  size_t in_flight_ TF_GUARDED_BY(mu_) = 1;
   std::unique_ptr<GRPCEndpoint::Stub> stub_ TF_GUARDED_BY(mu_);
+
+  grpc::CompletionQueue cq_;
+  std::deque<std::unique_ptr<AsyncCall>> calls_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<AsyncCall>> cancelled_ TF_GUARDED_BY(mu_);
+
+  int64 stream_offset_ TF_GUARDED_BY(mu_) = 0;
+  std::unique_ptr<grpc::ClientContext> stream_context_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> stream_thread_ TF_GUARDED_BY(mu_);
+
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  std::deque<Tensor> queue_ TF_GUARDED_BY(queue_mu_);
+  int64 front_offset_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool stream_done_ TF_GUARDED_BY(queue_mu_) = false;
+  bool stream_stop_ TF_GUARDED_BY(queue_mu_) = false;
+  Status stream_status_ TF_GUARDED_BY(queue_mu_);
 };
 
 class GRPCReadableInitOp : public ResourceOpKernel<GRPCReadableResource> {
@@ -83,6 +306,8 @@ class GRPCReadableInitOp : public ResourceOpKernel<GRPCReadableResource> {
   explicit GRPCReadableInitOp(OpKernelConstruction* context)
       : ResourceOpKernel<GRPCReadableResource>(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("stream", &stream_));
+    OP_REQUIRES_OK(context, context->GetAttr("in_flight", &in_flight_));
   }
 
  private:
@@ -93,7 +318,7 @@ class GRPCReadableInitOp : public ResourceOpKernel<GRPCReadableResource> {
     OP_REQUIRES_OK(context, context->input("input", &input_tensor));
     string input = input_tensor->scalar<tstring>()();
 
-    OP_REQUIRES_OK(context, resource_->Init(input));
+    OP_REQUIRES_OK(context, resource_->Init(input, stream_, in_flight_));
   }
   Status CreateResource(GRPCReadableResource** resource)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
@@ -104,8 +329,9 @@ class GRPCReadableInitOp : public ResourceOpKernel<GRPCReadableResource> {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  bool stream_;
+  int64 in_flight_;
 };
-
 class GRPCReadableReadOp : public OpKernel {
  public:
   explicit GRPCReadableReadOp(OpKernelConstruction* context)
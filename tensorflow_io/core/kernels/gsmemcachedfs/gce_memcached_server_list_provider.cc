@@ -15,11 +15,28 @@ GceMemcachedServerListProvider::GceMemcachedServerListProvider(
 
 Status GceMemcachedServerListProvider::GetServerList(
     std::vector<string>* server_list) {
-  if (!cached_list_.empty()) {
-    *server_list = cached_list_;
-    return OkStatus();
+  {
+    mutex_lock lock(mu_);
+    if (!cached_list_.empty()) {
+      *server_list = cached_list_;
+      return OkStatus();
+    }
   }
+  return RefreshServerList(server_list);
+}
 
+Status GceMemcachedServerListProvider::RefreshServerList(
+    std::vector<string>* server_list) {
+  std::vector<string> fetched;
+  TF_RETURN_IF_ERROR(FetchServerList(&fetched));
+  mutex_lock lock(mu_);
+  cached_list_ = fetched;
+  *server_list = std::move(fetched);
+  return OkStatus();
+}
+
+Status GceMemcachedServerListProvider::FetchServerList(
+    std::vector<string>* server_list) {
   std::vector<char> response_buffer;
   TF_RETURN_IF_ERROR(google_metadata_client_->GetMetadata(
       kGceMetadataWorkerNetworkEndpointsPath, &response_buffer));
@@ -37,9 +54,7 @@ Status GceMemcachedServerListProvider::GetServerList(
       success = false;
       break;
     }
-    string worker_ip = sub_elems[2];
-    server_list->push_back(worker_ip);
-    cached_list_.push_back(worker_ip);
+    server_list->push_back(sub_elems[2]);
   }
 
   if (success) {
@@ -7,6 +7,7 @@
 
 #include "absl/memory/memory.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/tsl/platform/cloud/compute_engine_metadata_client.h"
 
 namespace tensorflow {
@@ -19,12 +20,20 @@ class GceMemcachedServerListProvider {
 
   Status GetServerList(std::vector<string>* server_list);
 
+  // Looks up the server list again instead of returning the cached one, and
+  // caches it if the lookup succeeds.
+  Status RefreshServerList(std::vector<string>* server_list);
+
   void SetMetadataClient(
       std::shared_ptr<tsl::ComputeEngineMetadataClient> metadata_client);
 
  private:
+  // Reads the server list from the GCE metadata server.
+  Status FetchServerList(std::vector<string>* server_list);
+
   std::shared_ptr<tsl::ComputeEngineMetadataClient> google_metadata_client_;
-  std::vector<string> cached_list_;
+  mutex mu_;
+  std::vector<string> cached_list_ TF_GUARDED_BY(mu_);
   TF_DISALLOW_COPY_AND_ASSIGN(GceMemcachedServerListProvider);
 };
 
@@ -24,6 +24,8 @@ class MemcachedDaoInterface {
   virtual memcached_return_t MemcachedServerPush(
       const memcached_server_list_st list) = 0;
 
+  virtual void MemcachedServersReset() = 0;
+
   virtual memcached_return_t MemcachedSet(const char* key, size_t key_length,
                                           const char* value,
                                           size_t value_length,
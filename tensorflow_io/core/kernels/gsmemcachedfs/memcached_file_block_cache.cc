@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/gsmemcachedfs/memcached_file_block_cache.h"
 
+#include <algorithm>
 #include <random>
 
+#include "absl/strings/match.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/numbers.h"
 
 namespace tensorflow {
 
@@ -28,6 +32,10 @@ namespace tensorflow {
 // though the queue will be almost empty if the setter thread is doing its job.
 const int64 kMaxMemcachedSetBufferSize = 13421772800;  // 12 GB
 
+// The maximum number of blocks of one read that are fetched from GCS at the
+// same time.
+const size_t kMaxParallelBlockFetches = 8;
+
 namespace block_cache_util {
 
 double GenerateUniformRandomNumber() {
@@ -350,14 +358,17 @@ MemcachedFileBlockCache::MemcachedFileBlockCache(
     const std::vector<MemcachedDaoInterface*>& memcached_daos,
     size_t block_size, size_t max_bytes, uint64 max_staleness,
     size_t local_cache_size, const std::vector<string>& servers,
-    const std::vector<string>& options, BlockFetcher block_fetcher, Env* env)
+    const std::vector<string>& options, BlockFetcher block_fetcher, Env* env,
+    ServerListFetcher server_list_fetcher, uint64 server_list_refresh_secs)
     : block_size_(block_size),
       max_bytes_(max_bytes),
       use_multi_get_(false),
       block_fetcher_(std::move(block_fetcher)),
       env_(env),
+      options_(options),
       servers_(servers),
-      options_(options) {
+      server_list_fetcher_(std::move(server_list_fetcher)),
+      server_list_refresh_secs_(server_list_refresh_secs) {
   VLOG(1) << "Entering MemcachedFileBlockCache::MemcachedFileBlockCache";
 
   if (memcached_daos.size() < 2) {
@@ -383,6 +394,14 @@ MemcachedFileBlockCache::MemcachedFileBlockCache(
   VLOG(1) << "GCS memcached file block cache is "
           << (IsCacheEnabled() ? "enabled" : "disabled");
 
+  {
+    mutex_lock lock(servers_mu_);
+    client_generations_.assign(memcached_daos.size(), servers_generation_);
+    if (server_list_refresh_secs_ > 0) {
+      next_server_list_refresh_ =
+          env_->NowSeconds() + server_list_refresh_secs_;
+    }
+  }
   {
     mutex_lock lock(get_mu_);
     for (int64 i = 0; i < memcached_daos.size(); ++i) {
@@ -406,6 +425,12 @@ MemcachedFileBlockCache::MemcachedFileBlockCache(
 }
 
 MemcachedFileBlockCache::~MemcachedFileBlockCache() {
+  {
+    mutex_lock lock(prefetch_mu_);
+    while (pending_prefetches_ > 0) {
+      prefetch_cv_.wait(lock);
+    }
+  }
   {
     mutex_lock lock(throttler_mu_);
     stop_setter_thread_ = true;
@@ -414,6 +439,11 @@ MemcachedFileBlockCache::~MemcachedFileBlockCache() {
 }
 
 bool MemcachedFileBlockCache::ConfigureMemcachedDao() {
+  std::vector<string> servers;
+  {
+    mutex_lock lock(servers_mu_);
+    servers = servers_;
+  }
   for (int64 i = 0; i < memcached_clients_.size(); ++i) {
     // First get this threads's handle to a memcached client
     memcached_st* tsd =
@@ -422,7 +452,7 @@ bool MemcachedFileBlockCache::ConfigureMemcachedDao() {
       VLOG(1) << "Creating specific memcached handle for " << pthread_self();
       memcached_st* handle = memcached_clients_[i]->MemcachedCreate();
       Status status =
-          ConfigureMemcachedServers(memcached_clients_[i], servers_, options_);
+          ConfigureMemcachedServers(memcached_clients_[i], servers, options_);
       if (!status.ok()) {
         LOG(ERROR) << "Could not configure new memcached handle. status="
                    << status;
@@ -507,10 +537,62 @@ Status MemcachedFileBlockCache::ConfigureMemcachedServers(
     VLOG(1) << "Turned on IO_KEY_PREFETCH.";
   }
 
+  // Keys are placed on the servers by consistent hashing (ketama, with 160
+  // points per server on the continuum), so that a change of the server list
+  // only moves the keys of the servers that were added or removed. MODULA
+  // restores the previous placement, which moves almost all of them.
+  opt = unused_opts.find("MODULA");
+  const bool modula = opt != unused_opts.end();
+  if (modula) {
+    unused_opts.erase(opt);
+    VLOG(1) << "Turned on modula distribution.";
+  }
+  rc = memcached_dao->MemcachedBehaviorSet(
+      MEMCACHED_BEHAVIOR_DISTRIBUTION,
+      modula ? MEMCACHED_DISTRIBUTION_MODULA
+             : MEMCACHED_DISTRIBUTION_CONSISTENT_KETAMA);
+  if (rc != MEMCACHED_SUCCESS) {
+    return errors::Internal("Couldn't configure DISTRIBUTION for memcache: ",
+                            memcached_dao->MemcachedStrError(rc));
+  }
+
+  // REPLICAS=<n> stores every block on n more servers, the next ones on the
+  // continuum, and spreads the reads of a block over all its copies. Hot
+  // blocks are then served by several servers and survive the loss of one.
+  // Replication requires the binary protocol.
+  for (auto it = unused_opts.begin(); it != unused_opts.end(); ++it) {
+    uint64 replicas;
+    if (!absl::StartsWith(*it, "REPLICAS=") ||
+        !strings::safe_strtou64(it->substr(strlen("REPLICAS=")), &replicas)) {
+      continue;
+    }
+    unused_opts.erase(it);
+    rc = memcached_dao->MemcachedBehaviorSet(
+        MEMCACHED_BEHAVIOR_NUMBER_OF_REPLICAS, replicas);
+    if (rc == MEMCACHED_SUCCESS && replicas > 0) {
+      rc = memcached_dao->MemcachedBehaviorSet(
+          MEMCACHED_BEHAVIOR_RANDOMIZE_REPLICA_READ, 1);
+    }
+    if (rc != MEMCACHED_SUCCESS) {
+      return errors::Internal("Couldn't configure REPLICAS for memcache: ",
+                              memcached_dao->MemcachedStrError(rc));
+    }
+    VLOG(1) << "Turned on " << replicas << " replicas.";
+    break;
+  }
+
   for (const auto& v : unused_opts) {
     VLOG(1) << "Ignoring unknown option " << v;
   }
 
+  return PushMemcachedServers(memcached_dao, server_names);
+}
+
+Status MemcachedFileBlockCache::PushMemcachedServers(
+    MemcachedDaoInterface* memcached_dao,
+    const std::vector<string>& server_names) {
+  memcached_server_st* servers = nullptr;
+  memcached_return rc;
   for (const string& name : server_names) {
     servers = memcached_dao->MemcachedServerListAppend(servers, name.c_str(),
                                                        11211, &rc);
@@ -558,6 +640,12 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   string mini_read_key = keys[0];
   bool mini_read = n < block_size_;
 
+  if (local_cache_->max_size() > 0 &&
+      UpdateSequentialRead(filename, offset, n)) {
+    // Fetch the block after this read while the reader consumes it.
+    Prefetch(filename, collator.positions().back() + block_size_);
+  }
+
   if (mini_read) {
     // Small reads get cached locally since we need to fetch an entire block
     // remotely from either GCS or the distributed cache.
@@ -575,7 +663,28 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   }
 
   size_t total_bytes_transferred = 0;
-  bool multi_get = use_multi_get_ && !mini_read;
+
+  if (!mini_read && local_cache_->max_size() > 0) {
+    // Blocks prefetched into the local cache need no remote request.
+    for (auto claim = claim_checks.begin(); claim != claim_checks.end();) {
+      std::vector<char> data;
+      if (!local_cache_->GetBlock(claim->first, &data)) {
+        ++claim;
+        continue;
+      }
+      collator.splice_buffer(data.begin(), data.end(), claim->second.second,
+                             &total_bytes_transferred);
+      claim = claim_checks.erase(claim);
+    }
+    if (claim_checks.empty()) {
+      *bytes_transferred = total_bytes_transferred;
+      return OkStatus();
+    }
+  }
+
+  // Reads of more than one block always resolve them with one multi-get
+  // round trip instead of one get per block.
+  bool multi_get = (use_multi_get_ || claim_checks.size() > 1) && !mini_read;
 
   if (multi_get) {
     int64 client_index = 0;
@@ -592,6 +701,7 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
     }
 
     if (client_index > 0) {
+      UpdateClientServers(client_index);
       auto before = absl::Now();
       Status mget_status = read_with_multi_get(
           collator, memcached_clients_[client_index], keys, &claim_checks,
@@ -617,9 +727,35 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   for (auto ci = claim_checks.begin(); ci != claim_checks.end(); ++ci) {
     sorted_claims.insert(std::make_pair(ci->second.second, ci->second));
   }
-  for (auto sc = sorted_claims.begin(); sc != sorted_claims.end(); ++sc) {
-    size_t pos = sc->first;
-    std::vector<char> data;
+  std::vector<std::pair<size_t, Key>> misses(sorted_claims.begin(),
+                                             sorted_claims.end());
+  std::vector<std::vector<char>> blocks(misses.size());
+  std::vector<Status> fetch_statuses;
+  if (multi_get && misses.size() > 1) {
+    // The multi-get already missed these blocks in memcached, so they are
+    // fetched from GCS concurrently, a batch at a time.
+    fetch_statuses.resize(misses.size());
+    for (size_t begin = 0; begin < misses.size();
+         begin += kMaxParallelBlockFetches) {
+      size_t end = std::min(misses.size(), begin + kMaxParallelBlockFetches);
+      BlockingCounter counter(end - begin);
+      for (size_t i = begin; i < end; ++i) {
+        env_->SchedClosure(
+            [this, &misses, &blocks, &fetch_statuses, &counter, i] {
+              fetch_statuses[i] = MaybeFetch(0, misses[i].second, &blocks[i]);
+              counter.DecrementCount();
+            });
+      }
+      counter.Wait();
+    }
+  }
+  for (size_t i = 0; i < misses.size(); ++i) {
+    size_t pos = misses[i].first;
+    std::vector<char>& data = blocks[i];
+
+    if (!fetch_statuses.empty()) {
+      TF_RETURN_IF_ERROR(fetch_statuses[i]);
+    }
 
     int64 client_index = 0;
     if (!multi_get) {
@@ -634,7 +770,12 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
       }
     }
 
-    TF_RETURN_IF_ERROR(MaybeFetch(client_index, sc->second, &data));
+    if (fetch_statuses.empty()) {
+      if (client_index > 0) {
+        UpdateClientServers(client_index);
+      }
+      TF_RETURN_IF_ERROR(MaybeFetch(client_index, misses[i].second, &data));
+    }
 
     if (client_index > 0) {
       mutex_lock lock(get_mu_);
@@ -675,6 +816,68 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   return OkStatus();
 }
 
+bool MemcachedFileBlockCache::UpdateSequentialRead(const string& filename,
+                                                   size_t offset, size_t n) {
+  mutex_lock lock(mu_);
+  auto& sequential_read = sequential_reads_[filename];
+  const bool sequential = offset == sequential_read.first;
+  sequential_read.first = offset + n;
+  return sequential;
+}
+
+void MemcachedFileBlockCache::Prefetch(const string& filename, size_t pos) {
+  {
+    mutex_lock lock(mu_);
+    // Each block is prefetched once in a run of sequential reads, which also
+    // stops repeated prefetches past the end of the file.
+    auto& sequential_read = sequential_reads_[filename];
+    if (sequential_read.second == pos) {
+      return;
+    }
+    sequential_read.second = pos;
+  }
+  const Key key = std::make_pair(filename, pos);
+  const string memc_key = MakeMemcachedKey(key);
+  if (local_cache_->Peek(memc_key)) {
+    return;
+  }
+  int64 client_index = 0;
+  {
+    mutex_lock lock(get_mu_);
+    // Prefetches only use idle clients, and are dropped otherwise.
+    if (client_queue_.empty()) {
+      return;
+    }
+    client_index = client_queue_.front();
+    client_queue_.pop_front();
+  }
+  {
+    mutex_lock lock(prefetch_mu_);
+    ++pending_prefetches_;
+  }
+  env_->SchedClosure([this, key, memc_key, client_index] {
+    local_cache_->Fetching(memc_key);
+    if (!local_cache_->Peek(memc_key)) {
+      UpdateClientServers(client_index);
+      std::vector<char> data;
+      Status status = MaybeFetch(client_index, key, &data);
+      VLOG(2) << "prefetch: " << memc_key << ", status " << status;
+      if (status.ok() && !data.empty()) {
+        local_cache_->Add(memc_key, data.size(), data.data());
+      }
+    }
+    local_cache_->Fetched(memc_key);
+    {
+      mutex_lock lock(get_mu_);
+      client_queue_.push_back(client_index);
+    }
+    mutex_lock lock(prefetch_mu_);
+    if (--pending_prefetches_ == 0) {
+      prefetch_cv_.notify_all();
+    }
+  });
+}
+
 string MemcachedFileBlockCache::MakeMemcachedKey(const Key& key) {
   // Determine hash key usable by memcached.  This will need to be a
   // string <= 250 characters.  Using a key which is the offset, a slash,
@@ -764,7 +967,62 @@ int64 MemcachedFileBlockCache::AddToCacheBuffer(const string& memc_key,
   return cache_buffer_keys_.size();
 }
 
+void MemcachedFileBlockCache::MaybeRefreshServerList() {
+  if (server_list_fetcher_ == nullptr || server_list_refresh_secs_ == 0) {
+    return;
+  }
+  const uint64 now = env_->NowSeconds();
+  if (now < next_server_list_refresh_) {
+    return;
+  }
+  next_server_list_refresh_ = now + server_list_refresh_secs_;
+  std::vector<string> servers;
+  Status status = server_list_fetcher_(&servers);
+  if (!status.ok() || servers.empty()) {
+    // Keep the servers we have rather than dropping the distributed cache.
+    LOG(WARNING) << "Could not refresh the memcached server list, keeping "
+                    "the current one. status="
+                 << status;
+    return;
+  }
+  std::sort(servers.begin(), servers.end());
+  mutex_lock lock(servers_mu_);
+  std::vector<string> current = servers_;
+  std::sort(current.begin(), current.end());
+  if (servers == current) {
+    return;
+  }
+  LOG(INFO) << "Memcached server list changed from " << servers_.size()
+            << " to " << servers.size() << " servers";
+  servers_ = std::move(servers);
+  ++servers_generation_;
+}
+
+void MemcachedFileBlockCache::UpdateClientServers(int64 client_index) {
+  std::vector<string> servers;
+  {
+    mutex_lock lock(servers_mu_);
+    if (client_generations_[client_index] == servers_generation_) {
+      return;
+    }
+    client_generations_[client_index] = servers_generation_;
+    servers = servers_;
+  }
+  // The behaviors of the client, the distribution among them, are kept.
+  MemcachedDaoInterface* memcached_dao = memcached_clients_[client_index];
+  memcached_dao->MemcachedServersReset();
+  Status status = PushMemcachedServers(memcached_dao, servers);
+  if (!status.ok()) {
+    LOG(ERROR) << "Could not update the servers of memcached client "
+               << client_index << ". status=" << status;
+  }
+}
+
 bool MemcachedFileBlockCache::ProcessCacheBuffer() {
+  if (configured_) {
+    MaybeRefreshServerList();
+    UpdateClientServers(0);
+  }
   mutex_lock lock(throttler_mu_);
   if (stop_setter_thread_) {
     return false;
@@ -28,15 +28,22 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/tsl/platform/cloud/ram_file_block_cache.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
 #include "tensorflow_io/core/kernels/gsmemcachedfs/memcached_dao_interface.h"
 
 namespace tensorflow {
 
+// A FIFO cache of memcached blocks in the memory of the client. Its bytes
+// are accounted to the process-wide MemoryBudget, and blocks are evicted
+// while the budget is exhausted.
 class MiniBlockCache {
  public:
   explicit MiniBlockCache(size_t max_size) : max_size_(max_size) {
     VLOG(1) << "MiniBlockCache max_size = " << max_size_;
   }
+  ~MiniBlockCache() {
+    io::MemoryBudget::Global()->Release(kBudgetComponent, size_);
+  }
 
   // Add block to the cache.
   void Add(std::string key, size_t block_size, char* data)
@@ -48,19 +55,45 @@ class MiniBlockCache {
     VLOG(3) << "MiniBlockCache Add: key = " << key
             << ", block_size = " << block_size
             << ", to current_size = " << keys_fifo_.size();
+    io::MemoryBudget* budget = io::MemoryBudget::Global();
     if (!map_.contains(key)) {
-      if (max_size_ < (size_ + block_size) && !keys_fifo_.empty()) {
+      while (!keys_fifo_.empty() &&
+             (max_size_ < (size_ + block_size) || budget->Exhausted())) {
         string pop_key = keys_fifo_.front();
         VLOG(3) << "MiniBlockCache pop key = " << pop_key;
-        size_ -= map_[pop_key]->size();
+        size_t pop_size = map_[pop_key]->size();
+        size_ -= pop_size;
+        budget->Release(kBudgetComponent, pop_size);
         map_.erase(pop_key);
         keys_fifo_.pop();
       }
       keys_fifo_.push(key);
       map_[key] = absl::make_unique<std::vector<char>>();
     }
+    // A block added again replaces its previous content.
+    size_t old_size = map_[key]->size();
+    size_ -= old_size;
+    budget->Release(kBudgetComponent, old_size);
     map_[key]->assign(data, data + block_size);
     size_ += map_[key]->size();
+    budget->Reserve(kBudgetComponent, map_[key]->size());
+  }
+
+  size_t max_size() const { return max_size_; }
+
+  // Copy the whole block into `data` if it exists.
+  bool GetBlock(std::string key, std::vector<char>* data)
+      ABSL_LOCKS_EXCLUDED(mu_) {
+    if (max_size_ == 0) {
+      return false;
+    }
+    mutex_lock lock(mu_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+    data->assign(it->second->begin(), it->second->end());
+    return true;
   }
 
   // Peek map to check if the key is contained in it.
@@ -120,6 +153,8 @@ class MiniBlockCache {
   }
 
  private:
+  static constexpr char kBudgetComponent[] = "memcached_mini_block_cache";
+
   const size_t max_size_;
   mutable mutex mu_;
   size_t size_ ABSL_GUARDED_BY(mu_) = 0;
@@ -140,6 +175,10 @@ using BlockFetcher = std::function<Status(const string& filename, size_t offset,
                                           size_t buffer_size, char* buffer,
                                           size_t* bytes_transferred)>;
 
+// The callback executed to look up the current memcached servers, which the
+// cache calls periodically to follow a memcached fleet that is resized.
+using ServerListFetcher = std::function<Status(std::vector<string>* servers)>;
+
 // Memcached Data Access Object class that wraps memcached. We should use this
 // class for any access or configuration of memcached within the memcached file
 // block cache. This construct is useful for testing, since it allows us to
@@ -177,6 +216,10 @@ class MemcachedDao : public MemcachedDaoInterface {
     return memcached_server_push(memcached_handle_, list);
   }
 
+  void MemcachedServersReset() override {
+    memcached_servers_reset(memcached_handle_);
+  }
+
   memcached_return_t MemcachedSet(const char* key, size_t key_length,
                                   const char* value, size_t value_length,
                                   time_t expiration, uint32_t flags) override {
@@ -241,7 +284,9 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
       size_t block_size, size_t max_bytes, uint64 max_staleness,
       const size_t local_cache_size, const std::vector<string>& servers,
       const std::vector<string>& options, BlockFetcher block_fetcher,
-      Env* env = Env::Default());
+      Env* env = Env::Default(),
+      ServerListFetcher server_list_fetcher = nullptr,
+      uint64 server_list_refresh_secs = 0);
 
   ~MemcachedFileBlockCache() override;
 
@@ -309,11 +354,33 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
   // requests.
   int64 AddToCacheBuffer(const string& memc_key, std::vector<char>* data);
 
+  // Records a read of [offset, offset + n) of `filename` and returns true if
+  // it starts where the previous read of the file ended.
+  bool UpdateSequentialRead(const string& filename, size_t offset, size_t n)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Fetches the block of `filename` at `pos` into the local cache in the
+  // background, from memcached or else from GCS, unless it is already there.
+  void Prefetch(const string& filename, size_t pos);
+
   // Configures memcached server list and optional behaviors.
   Status ConfigureMemcachedServers(MemcachedDaoInterface* memcached_dao,
                                    const std::vector<string>& server_names,
                                    const std::vector<string>& options);
 
+  // Adds the servers to the server list of a memcached client.
+  Status PushMemcachedServers(MemcachedDaoInterface* memcached_dao,
+                              const std::vector<string>& server_names);
+
+  // Looks up the memcached servers again once server_list_refresh_secs_ have
+  // passed since the last lookup. Called by the setter thread.
+  void MaybeRefreshServerList() ABSL_LOCKS_EXCLUDED(servers_mu_);
+
+  // Replaces the server list of the client with the current one if the list
+  // changed since the client was configured. Only the thread holding the
+  // client may call this.
+  void UpdateClientServers(int64 client_index) ABSL_LOCKS_EXCLUDED(servers_mu_);
+
   // Constructs a memcached key, a single string from the information in Key.
   string MakeMemcachedKey(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
 
@@ -338,10 +405,37 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ ABSL_GUARDED_BY(mu_);
 
+  // The end of the last read of each file, and the last block prefetched for
+  // it.
+  std::map<string, std::pair<size_t, size_t>> sequential_reads_
+      ABSL_GUARDED_BY(mu_);
+
+  // The number of prefetches in flight, which the destructor waits for.
+  mutable mutex prefetch_mu_;
+  condition_variable prefetch_cv_;
+  int64 pending_prefetches_ ABSL_GUARDED_BY(prefetch_mu_) = 0;
+
   // Configuration data for new memcached handles.
-  const std::vector<string> servers_;
   const std::vector<string> options_;
 
+  // The current memcached servers, which the clients switch to as they are
+  // taken from the pool. Keys are distributed over the servers by consistent
+  // hashing, so a change of the list only moves the keys of the servers that
+  // were added or removed.
+  mutable mutex servers_mu_;
+  std::vector<string> servers_ ABSL_GUARDED_BY(servers_mu_);
+  // Incremented whenever servers_ changes.
+  int64 servers_generation_ ABSL_GUARDED_BY(servers_mu_) = 0;
+  // The generation of the server list of each client.
+  std::vector<int64> client_generations_ ABSL_GUARDED_BY(servers_mu_);
+
+  // Looks up the memcached servers, every server_list_refresh_secs_ if that
+  // is not 0.
+  const ServerListFetcher server_list_fetcher_;
+  const uint64 server_list_refresh_secs_;
+  // The time of the next lookup, only used by the setter thread.
+  uint64 next_server_list_refresh_ = 0;
+
   // Thread-specific key for managing clients.
   std::vector<pthread_key_t> cache_keys_;
 
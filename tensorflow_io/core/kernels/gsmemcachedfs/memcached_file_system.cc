@@ -62,6 +62,11 @@ constexpr char kMaxGrpcAttempts[] = "GCS_BLOCK_FETCHER_GRPC_MAX_ATTEMPTS";
 // to serve subsequent small reads from that block locally.
 // 4GB local cache has shown very good hit-ratio and performance.
 constexpr char kMemcachedLocalCachesize[] = "MEMCACHED_LOCAL_CACHE_SIZE_GB";
+// How often the memcached server list is looked up again, in seconds, so that
+// the cache follows a memcached fleet that is resized. 0 disables it.
+constexpr char kMemcachedServerListRefreshSecs[] =
+    "GCS_MEMCACHED_SERVER_LIST_REFRESH_SECS";
+constexpr uint64 kDefaultMemcachedServerListRefreshSecs = 60;
 
 // How much time to initially wait before retrying a failed grpc.
 constexpr absl::Duration kInitialGrpcRetry = absl::Seconds(1);
@@ -108,7 +113,7 @@ MemcachedGcsFileSystem::MemcachedGcsFileSystem() : GcsFileSystem() {
       max_staleness = value;
     }
 
-    server_list_provider_ = absl::make_unique<GceMemcachedServerListProvider>(
+    server_list_provider_ = std::make_shared<GceMemcachedServerListProvider>(
         compute_engine_metadata_client_);
 
     VLOG(1) << "Reseting MEMCACHED-GCS cache with params: max_bytes = "
@@ -172,10 +177,24 @@ std::unique_ptr<FileBlockCache> MemcachedGcsFileSystem::MakeFileBlockCache(
               << local_cache_size;
     }
 
+    uint64 refresh_secs = kDefaultMemcachedServerListRefreshSecs;
+    if (GetEnvVar(kMemcachedServerListRefreshSecs, strings::safe_strtou64,
+                  &value)) {
+      refresh_secs = value;
+    }
+    // The cache outlives the members of this file system, it holds on to the
+    // provider itself.
+    std::shared_ptr<GceMemcachedServerListProvider> provider =
+        server_list_provider_;
+    auto server_list_fetcher = [provider](std::vector<string>* servers) {
+      return provider->RefreshServerList(servers);
+    };
+
     std::unique_ptr<FileBlockCache> file_block_cache(
         new MemcachedFileBlockCache(*memcached_clients_, block_size, max_bytes,
                                     max_staleness, local_cache_size, servers,
-                                    options, block_fetcher));
+                                    options, block_fetcher, Env::Default(),
+                                    server_list_fetcher, refresh_secs));
     return file_block_cache;
   }
 
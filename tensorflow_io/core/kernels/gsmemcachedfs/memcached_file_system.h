@@ -57,7 +57,7 @@ class MemcachedGcsFileSystem : public tsl::GcsFileSystem {
   std::unique_ptr<std::vector<MemcachedDaoInterface*>> memcached_clients_;
 
  private:
-  std::unique_ptr<GceMemcachedServerListProvider> server_list_provider_;
+  std::shared_ptr<GceMemcachedServerListProvider> server_list_provider_;
   TF_DISALLOW_COPY_AND_ASSIGN(MemcachedGcsFileSystem);
 
   // Owner of the Memcached DAO objects.
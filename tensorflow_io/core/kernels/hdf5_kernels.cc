@@ -17,6 +17,9 @@ limitations under the License.
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
+#include <cstring>
+#include <limits>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow_io/core/kernels/io_kernel.h"
 
@@ -24,6 +27,163 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// A read only HDF5 virtual file driver on top of a RandomAccessFile, so that
+// the metadata and the hyperslabs of a remote file are fetched as the byte
+// ranges HDF5 asks for, instead of reading the whole file into memory first.
+class HDF5RandomAccessFileDriver {
+ public:
+  // The file access property passed through H5Pset_driver.
+  struct Info {
+    tensorflow::RandomAccessFile* file;
+    uint64 size;
+  };
+
+  // Opens `filename` through the driver. The file must outlive the returned
+  // HDF5 file id and all the objects opened from it.
+  static hid_t Open(const string& filename, tensorflow::RandomAccessFile* file,
+                    const uint64 size) {
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if (fapl < 0) {
+      return -1;
+    }
+    Info info{file, size};
+    hid_t id = -1;
+    if (H5Pset_driver(fapl, DriverId(), &info) >= 0) {
+      id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, fapl);
+    }
+    H5Pclose(fapl);
+    return id;
+  }
+
+ private:
+  // The H5FD_t header has to come first, as HDF5 casts between the two.
+  struct File {
+    H5FD_t pub;
+    Info info;
+    haddr_t eoa;
+  };
+
+  static hid_t DriverId() {
+    static hid_t id = [] {
+      static H5FD_class_t cls;
+      cls.name = "tensorflow_io_random_access_file";
+      cls.maxaddr = static_cast<haddr_t>(std::numeric_limits<int64>::max());
+      cls.fc_degree = H5F_CLOSE_WEAK;
+      cls.fapl_size = sizeof(Info);
+      cls.fapl_get = FaplGet;
+      cls.fapl_copy = FaplCopy;
+      cls.fapl_free = FaplFree;
+      cls.open = OpenFile;
+      cls.close = CloseFile;
+      cls.cmp = Compare;
+      cls.query = Query;
+      cls.get_eoa = GetEoa;
+      cls.set_eoa = SetEoa;
+      cls.get_eof = GetEof;
+      cls.get_handle = GetHandle;
+      cls.read = ReadFile;
+      cls.write = WriteFile;
+      for (int i = 0; i < H5FD_MEM_NTYPES; i++) {
+        cls.fl_map[i] = H5FD_MEM_DEFAULT;
+      }
+      return H5FDregister(&cls);
+    }();
+    return id;
+  }
+
+  static void* FaplCopy(const void* info) {
+    Info* copy = static_cast<Info*>(malloc(sizeof(Info)));
+    if (copy != nullptr) {
+      memcpy(copy, info, sizeof(Info));
+    }
+    return copy;
+  }
+  static void* FaplGet(H5FD_t* file) {
+    return FaplCopy(&reinterpret_cast<File*>(file)->info);
+  }
+  static herr_t FaplFree(void* info) {
+    free(info);
+    return 0;
+  }
+
+  static H5FD_t* OpenFile(const char* name, unsigned flags, hid_t fapl,
+                          haddr_t maxaddr) {
+    if ((flags & (H5F_ACC_RDWR | H5F_ACC_TRUNC | H5F_ACC_CREAT)) != 0) {
+      return nullptr;
+    }
+    const Info* info = static_cast<const Info*>(H5Pget_driver_info(fapl));
+    if (info == nullptr || info->file == nullptr) {
+      return nullptr;
+    }
+    File* file = static_cast<File*>(calloc(1, sizeof(File)));
+    if (file == nullptr) {
+      return nullptr;
+    }
+    file->info = *info;
+    return &file->pub;
+  }
+  static herr_t CloseFile(H5FD_t* file) {
+    free(file);
+    return 0;
+  }
+  static int Compare(const H5FD_t* f1, const H5FD_t* f2) {
+    const tensorflow::RandomAccessFile* a =
+        reinterpret_cast<const File*>(f1)->info.file;
+    const tensorflow::RandomAccessFile* b =
+        reinterpret_cast<const File*>(f2)->info.file;
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+  static herr_t Query(const H5FD_t* file, unsigned long* flags) {
+    // Data sieving and the metadata accumulator coalesce the small reads
+    // HDF5 makes into fewer and larger ranges of the file.
+    *flags = H5FD_FEAT_DATA_SIEVE | H5FD_FEAT_ACCUMULATE_METADATA |
+             H5FD_FEAT_AGGREGATE_METADATA | H5FD_FEAT_AGGREGATE_SMALLDATA;
+    return 0;
+  }
+  static haddr_t GetEoa(const H5FD_t* file, H5FD_mem_t type) {
+    return reinterpret_cast<const File*>(file)->eoa;
+  }
+  static herr_t SetEoa(H5FD_t* file, H5FD_mem_t type, haddr_t addr) {
+    reinterpret_cast<File*>(file)->eoa = addr;
+    return 0;
+  }
+  static haddr_t GetEof(const H5FD_t* file, H5FD_mem_t type) {
+    return reinterpret_cast<const File*>(file)->info.size;
+  }
+  static herr_t GetHandle(H5FD_t* file, hid_t fapl, void** handle) {
+    *handle = reinterpret_cast<File*>(file)->info.file;
+    return 0;
+  }
+  static herr_t ReadFile(H5FD_t* file, H5FD_mem_t type, hid_t dxpl,
+                         haddr_t addr, size_t size, void* buffer) {
+    const Info& info = reinterpret_cast<File*>(file)->info;
+    char* p = static_cast<char*>(buffer);
+    // Reading past the end of the file yields zeros, as with other drivers.
+    size_t available = 0;
+    if (addr < info.size) {
+      available = std::min<uint64>(size, info.size - addr);
+    }
+    if (available > 0) {
+      StringPiece result;
+      Status status = info.file->Read(addr, available, &result, p);
+      if (!(status.ok() || errors::IsOutOfRange(status)) ||
+          result.size() != available) {
+        LOG(ERROR) << "unable to read hdf5 file at " << addr << ": " << status;
+        return -1;
+      }
+      if (result.data() != p) {
+        memmove(p, result.data(), result.size());
+      }
+    }
+    memset(p + available, 0, size - available);
+    return 0;
+  }
+  static herr_t WriteFile(H5FD_t* file, H5FD_mem_t type, hid_t dxpl,
+                          haddr_t addr, size_t size, const void* buffer) {
+    return -1;
+  }
+};
+
 class HDF5FileImage {
  public:
   HDF5FileImage(Env* env, const string& filename, const string& optional_memory)
@@ -40,16 +200,12 @@ class HDF5FileImage {
       uint64 size = 0;
       Status status = env->GetFileSize(filename, &size);
       if (status.ok()) {
-        std::unique_ptr<tensorflow::RandomAccessFile> file;
-        status = env->NewRandomAccessFile(filename, &file);
+        status = env->NewRandomAccessFile(filename, &random_access_file_);
         if (status.ok()) {
-          StringPiece result;
-          buffer_memory_.resize(size);
-          status = file->Read(0, size, &result, &buffer_memory_[0]);
-          if (status.ok()) {
-            file_image_ = H5LTopen_file_image(
-                (void*)buffer_memory_.data(), buffer_memory_.size(),
-                H5LT_FILE_IMAGE_DONT_COPY | H5LT_FILE_IMAGE_DONT_RELEASE);
+          hid_t id = HDF5RandomAccessFileDriver::Open(
+              filename, random_access_file_.get(), size);
+          if (id >= 0) {
+            file_image_ = id;
             file_.reset(new H5::H5File());
             file_.get()->setId(file_image_);
           }
@@ -70,7 +226,7 @@ class HDF5FileImage {
  private:
   string filename_;
   const string& optional_memory_;
-  string buffer_memory_;
+  std::unique_ptr<tensorflow::RandomAccessFile> random_access_file_;
   std::unique_ptr<H5::H5File> file_;
   hid_t file_image_ = 0;
 };
@@ -116,12 +272,31 @@ class HDF5Iterate {
   haddr_t parent_;
 };
 
+// The options of the dataset handles opened by HDF5ReadableResource::Read.
+// Negative chunk cache values keep the defaults of the file.
+struct HDF5DatasetOptions {
+  bool cache_dataset = true;
+  int64 chunk_cache_bytes = -1;
+  int64 chunk_cache_slots = -1;
+  float chunk_cache_preemption = -1;
+
+  bool operator==(const HDF5DatasetOptions& other) const {
+    return cache_dataset == other.cache_dataset &&
+           chunk_cache_bytes == other.chunk_cache_bytes &&
+           chunk_cache_slots == other.chunk_cache_slots &&
+           chunk_cache_preemption == other.chunk_cache_preemption;
+  }
+};
+
 class HDF5ReadableResource : public ResourceBase {
  public:
   HDF5ReadableResource(Env* env)
       : env_(env), complex_names_(std::pair<string, string>("r", "i")) {}
 
-  virtual ~HDF5ReadableResource() {}
+  virtual ~HDF5ReadableResource() {
+    // The dataset handles have to be closed before the file.
+    datasets_.clear();
+  }
   Status Init(const string& input) {
     mutex_lock l(mu_);
 
@@ -338,7 +513,7 @@ class HDF5ReadableResource : public ResourceBase {
 
   Status Read(const string& component,
               const absl::InlinedVector<int64, 4>& start,
-              const TensorShape& shape,
+              const TensorShape& shape, const HDF5DatasetOptions& options,
               std::function<Status(const TensorShape& shape, Tensor** value)>
                   allocate_func) {
     mutex_lock l(mu_);
@@ -353,11 +528,15 @@ class HDF5ReadableResource : public ResourceBase {
     Tensor* value;
     TF_RETURN_IF_ERROR(allocate_func(shape, &value));
 
-    H5::H5File* file = file_image_->GetFile();
     try {
-      H5::DataSet data_set = file->openDataSet(component);
-      H5::DataType data_type = data_set.getDataType();
-      H5::DataSpace data_space = data_set.getSpace();
+      std::shared_ptr<Dataset> dataset;
+      TF_RETURN_IF_ERROR(OpenDataset(component, options, &dataset));
+      const H5::DataSet& data_set = dataset->data_set;
+      H5::DataType& data_type = dataset->data_type;
+      // The selection of a hyperslab changes the data space, so each read
+      // selects on a copy of the one of the handle.
+      H5::DataSpace data_space;
+      data_space.copy(dataset->data_space);
 
       H5::DataSpace memory_space = H5::DataSpace::ALL;
 
@@ -578,6 +757,62 @@ class HDF5ReadableResource : public ResourceBase {
   string DebugString() const override { return "HDF5ReadableResource"; }
 
  protected:
+  // An open dataset, with its data type and data space.
+  struct Dataset {
+    H5::DataSet data_set;
+    H5::DataType data_type;
+    H5::DataSpace data_space;
+    HDF5DatasetOptions options;
+  };
+
+  // Returns the handle of `component` opened with `options`, which is
+  // reused by the reads that follow when the options cache it.
+  Status OpenDataset(const string& component,
+                     const HDF5DatasetOptions& options,
+                     std::shared_ptr<Dataset>* dataset)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto lookup = datasets_.find(component);
+    if (lookup != datasets_.end() && lookup->second->options == options) {
+      *dataset = lookup->second;
+      return OkStatus();
+    }
+    datasets_.erase(component);
+
+    H5::DSetAccPropList access;
+    if (options.chunk_cache_bytes >= 0 || options.chunk_cache_slots >= 0 ||
+        options.chunk_cache_preemption >= 0) {
+      size_t slots = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
+      size_t bytes = H5D_CHUNK_CACHE_NBYTES_DEFAULT;
+      double preemption = H5D_CHUNK_CACHE_W0_DEFAULT;
+      if (options.chunk_cache_slots >= 0) {
+        slots = options.chunk_cache_slots;
+      }
+      if (options.chunk_cache_bytes >= 0) {
+        bytes = options.chunk_cache_bytes;
+      }
+      if (options.chunk_cache_preemption >= 0) {
+        if (options.chunk_cache_preemption > 1) {
+          return errors::InvalidArgument(
+              "chunk cache preemption must be within [0, 1]: ",
+              options.chunk_cache_preemption);
+        }
+        preemption = options.chunk_cache_preemption;
+      }
+      access.setChunkCache(slots, bytes, preemption);
+    }
+
+    H5::H5File* file = file_image_->GetFile();
+    dataset->reset(new Dataset());
+    (*dataset)->data_set = file->openDataSet(component, access);
+    (*dataset)->data_type = (*dataset)->data_set.getDataType();
+    (*dataset)->data_space = (*dataset)->data_set.getSpace();
+    (*dataset)->options = options;
+    if (options.cache_dataset) {
+      datasets_[component] = *dataset;
+    }
+    return OkStatus();
+  }
+
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   string filename_ TF_GUARDED_BY(mu_);
@@ -588,6 +823,9 @@ class HDF5ReadableResource : public ResourceBase {
   std::unordered_map<string, int64> columns_index_ TF_GUARDED_BY(mu_);
 
   std::pair<string, string> complex_names_ TF_GUARDED_BY(mu_);
+
+  std::unordered_map<string, std::shared_ptr<Dataset>> datasets_
+      TF_GUARDED_BY(mu_);
 };
 
 static mutex mu(LINKER_INITIALIZED);
@@ -654,7 +892,22 @@ class HDF5ReadableInfoOp : public IOResourceOpKernel<HDF5ReadableResource> {
 class HDF5ReadableReadOp : public IOResourceOpKernel<HDF5ReadableResource> {
  public:
   explicit HDF5ReadableReadOp(OpKernelConstruction* context)
-      : IOResourceOpKernel<HDF5ReadableResource>(context) {}
+      : IOResourceOpKernel<HDF5ReadableResource>(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("cache_dataset",
+                                             &options_.cache_dataset));
+    OP_REQUIRES_OK(context, context->GetAttr("chunk_cache_bytes",
+                                             &options_.chunk_cache_bytes));
+    OP_REQUIRES_OK(context, context->GetAttr("chunk_cache_slots",
+                                             &options_.chunk_cache_slots));
+    OP_REQUIRES_OK(context, context->GetAttr("chunk_cache_preemption",
+                                             &options_.chunk_cache_preemption));
+    // Datasets fed to a GPU may be read into pinned host memory, from which
+    // they are copied to the device without a staging copy.
+    bool gpu_compatible = false;
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("gpu_compatible", &gpu_compatible));
+    output_attr_.set_gpu_compatible(gpu_compatible);
+  }
 
   virtual ~HDF5ReadableReadOp() {}
 
@@ -701,9 +954,10 @@ class HDF5ReadableReadOp : public IOResourceOpKernel<HDF5ReadableResource> {
     }
 
     TF_RETURN_IF_ERROR(resource->Read(
-        component, start, shape,
+        component, start, shape, options_,
         [&](const TensorShape& shape, Tensor** value) -> Status {
-          TF_RETURN_IF_ERROR(context->allocate_output(0, shape, value));
+          TF_RETURN_IF_ERROR(
+              context->allocate_output(0, shape, value, output_attr_));
           return OkStatus();
         }));
     return OkStatus();
@@ -714,6 +968,10 @@ class HDF5ReadableReadOp : public IOResourceOpKernel<HDF5ReadableResource> {
     mutex_lock l(mu);
     IOResourceOpKernel<HDF5ReadableResource>::Compute(context);
   }
+
+ private:
+  HDF5DatasetOptions options_;
+  AllocatorAttributes output_attr_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>HDF5ReadableInfo").Device(DEVICE_CPU),
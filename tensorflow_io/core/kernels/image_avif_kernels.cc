@@ -22,7 +22,21 @@ namespace {
 
 class DecodeAVIFOp : public OpKernel {
  public:
-  explicit DecodeAVIFOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit DecodeAVIFOp(OpKernelConstruction* context) : OpKernel(context) {
+    string codec;
+    OP_REQUIRES_OK(context, context->GetAttr("codec", &codec));
+    if (codec == "dav1d") {
+      codec_choice_ = AVIF_CODEC_CHOICE_DAV1D;
+    } else if (codec == "libgav1") {
+      codec_choice_ = AVIF_CODEC_CHOICE_LIBGAV1;
+    } else {
+      codec_choice_ = AVIF_CODEC_CHOICE_AUTO;
+    }
+    OP_REQUIRES_OK(context, context->GetAttr("threads", &threads_));
+    OP_REQUIRES(context, threads_ > 0,
+                errors::InvalidArgument("threads must be positive, got ",
+                                        threads_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& contents_tensor = context->input(0);
@@ -48,6 +62,11 @@ class DecodeAVIFOp : public OpKernel {
           }
         });
 
+    decoder->codecChoice = codec_choice_;
+#if AVIF_VERSION >= 90000
+    decoder->maxThreads = threads_;
+#endif
+
     avifResult decodeResult = avifDecoderRead(decoder.get(), image.get(), &raw);
     OP_REQUIRES(context, (decodeResult == AVIF_RESULT_OK),
                 errors::InvalidArgument("unable to decode avif: ",
@@ -77,6 +96,11 @@ class DecodeAVIFOp : public OpKernel {
                 errors::InvalidArgument("unable to convert avif to rgb: ",
                                         avifResultToString(rgbResult)));
   }
+
+ private:
+  avifCodecChoice codec_choice_;
+  // Only libavif 0.9.0 and later decode on more than one thread.
+  int threads_;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeAVIF").Device(DEVICE_CPU), DecodeAVIFOp);
 
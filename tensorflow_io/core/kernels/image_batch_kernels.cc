@@ -0,0 +1,245 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "avif/avif.h"
+#include "libyuv/convert_from_argb.h"
+#include "libyuv/scale_argb.h"
+#include "stb_image.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
+#include "webp/decode.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// The decoder state of one thread, kept across images and calls so that
+// the AVIF decoder and the scratch buffers are not recreated per image.
+struct ImageDecoderContext {
+  ImageDecoderContext()
+      : avif_decoder(avifDecoderCreate()), avif_image(avifImageCreateEmpty()) {}
+  ~ImageDecoderContext() {
+    if (avif_image != nullptr) {
+      avifImageDestroy(avif_image);
+    }
+    if (avif_decoder != nullptr) {
+      avifDecoderDestroy(avif_decoder);
+    }
+  }
+
+  avifDecoder* avif_decoder;
+  avifImage* avif_image;
+  // The RGBA pixels of an image before and after it is resized.
+  std::vector<uint8> decoded;
+  std::vector<uint8> resized;
+};
+using ImageDecoderPool = data::ConnectionPool<ImageDecoderContext>;
+
+// Decodes a batch of images of any of the formats below, told apart by
+// their magic bytes, into one [N, height, width, channels] tensor. Each
+// image is resized to `size` with a bilinear filter, unless it is WebP, which
+// is scaled by the decoder itself. Images are decoded in parallel, each
+// thread with a decoder context of its own leased from a pool.
+class DecodeImageBatchOp : public OpKernel {
+ public:
+  explicit DecodeImageBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, (channels_ == 3 || channels_ == 4),
+                errors::InvalidArgument("channels must be 3 or 4, got ",
+                                        channels_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_tensor->shape()),
+                errors::InvalidArgument("input must be 1-D, got shape ",
+                                        input_tensor->shape().DebugString()));
+
+    const Tensor* size_tensor;
+    OP_REQUIRES_OK(context, context->input("size", &size_tensor));
+    OP_REQUIRES(context, (size_tensor->NumElements() == 2),
+                errors::InvalidArgument("size must be [height, width], got ",
+                                        size_tensor->shape().DebugString()));
+    const int64 height = size_tensor->flat<int32>()(0);
+    const int64 width = size_tensor->flat<int32>()(1);
+    OP_REQUIRES(context, (height > 0 && width > 0),
+                errors::InvalidArgument("size must be positive, got ", height,
+                                        "x", width));
+
+    const int64 count = input_tensor->NumElements();
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({count, height, width, channels_}),
+                       &output_tensor));
+    const int64 image_size = height * width * channels_;
+
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    mutex status_mu;
+    Status status;
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerImage, [&](int64 start, int64 limit) {
+            std::shared_ptr<ImageDecoderContext> decoder;
+            Status s = ImageDecoderPool::Default()->Acquire(
+                "image",
+                [](ImageDecoderPool::Connection* connection) {
+                  connection->reset(new ImageDecoderContext());
+                  if ((*connection)->avif_decoder == nullptr ||
+                      (*connection)->avif_image == nullptr) {
+                    return errors::Internal("could not allocate avif decoder");
+                  }
+                  return OkStatus();
+                },
+                nullptr, &decoder);
+            for (int64 i = start; s.ok() && i < limit; i++) {
+              s = DecodeImage(decoder.get(), input_tensor->flat<tstring>()(i),
+                              height, width,
+                              output_tensor->flat<uint8>().data() +
+                                  i * image_size);
+              if (!s.ok()) {
+                s = errors::InvalidArgument("image ", i, ": ", s.message());
+              }
+            }
+            if (!s.ok()) {
+              mutex_lock l(status_mu);
+              status.Update(s);
+            }
+          });
+    OP_REQUIRES_OK(context, status);
+  }
+
+ private:
+  Status DecodeImage(ImageDecoderContext* decoder, const tstring& contents,
+                     const int64 height, const int64 width, uint8* output) {
+    const uint8* data = reinterpret_cast<const uint8*>(contents.data());
+    const size_t size = contents.size();
+    if (size >= 12 && memcmp(data, "RIFF", 4) == 0 &&
+        memcmp(data + 8, "WEBP", 4) == 0) {
+      return DecodeWebP(data, size, height, width, output);
+    }
+    int64 decoded_height, decoded_width;
+    if (size >= 12 && memcmp(data + 4, "ftypavif", 8) == 0) {
+      TF_RETURN_IF_ERROR(
+          DecodeAVIF(decoder, data, size, &decoded_height, &decoded_width));
+    } else {
+      int x, y, n;
+      std::unique_ptr<stbi_uc, void (*)(void*)> pixels(
+          stbi_load_from_memory(data, size, &x, &y, &n, 4), stbi_image_free);
+      if (pixels == nullptr) {
+        return errors::InvalidArgument("unable to decode image: ",
+                                       stbi_failure_reason());
+      }
+      decoded_height = y;
+      decoded_width = x;
+      decoder->decoded.assign(pixels.get(), pixels.get() + x * y * 4);
+    }
+    return Resize(decoder, decoded_height, decoded_width, height, width,
+                  output);
+  }
+
+  Status DecodeWebP(const uint8* data, size_t size, const int64 height,
+                    const int64 width, uint8* output) {
+    WebPDecoderConfig config;
+    WebPInitDecoderConfig(&config);
+    int returned = WebPGetFeatures(data, size, &config.input);
+    if (returned != VP8_STATUS_OK) {
+      return errors::InvalidArgument("unable to decode webp: ", returned);
+    }
+    config.options.use_scaling = 1;
+    config.options.scaled_height = height;
+    config.options.scaled_width = width;
+    config.output.colorspace = (channels_ == 4) ? MODE_RGBA : MODE_RGB;
+    config.output.u.RGBA.rgba = output;
+    config.output.u.RGBA.stride = width * channels_;
+    config.output.u.RGBA.size = height * width * channels_;
+    config.output.is_external_memory = 1;
+    returned = WebPDecode(data, size, &config);
+    if (returned != VP8_STATUS_OK) {
+      return errors::InvalidArgument("unable to decode webp: ", returned);
+    }
+    return OkStatus();
+  }
+
+  Status DecodeAVIF(ImageDecoderContext* decoder, const uint8* data,
+                    size_t size, int64* height, int64* width) {
+    avifROData raw;
+    raw.data = data;
+    raw.size = size;
+    avifResult result =
+        avifDecoderRead(decoder->avif_decoder, decoder->avif_image, &raw);
+    if (result != AVIF_RESULT_OK) {
+      return errors::InvalidArgument("unable to decode avif: ",
+                                     avifResultToString(result));
+    }
+    avifImage* image = decoder->avif_image;
+    if (image->depth != 8) {
+      return errors::InvalidArgument("only 8-bit avif images are supported");
+    }
+    *height = image->height;
+    *width = image->width;
+    decoder->decoded.resize(image->height * image->width * 4);
+
+    avifRGBImage rgb;
+    avifRGBImageSetDefaults(&rgb, image);
+    rgb.format = AVIF_RGB_FORMAT_RGBA;
+    rgb.depth = 8;
+    rgb.pixels = decoder->decoded.data();
+    rgb.rowBytes = image->width * 4;
+    result = avifImageYUVToRGB(image, &rgb);
+    if (result != AVIF_RESULT_OK) {
+      return errors::InvalidArgument("unable to convert avif to rgb: ",
+                                     avifResultToString(result));
+    }
+    return OkStatus();
+  }
+
+  // Resizes the RGBA pixels decoded into `decoder`. ARGBScale only moves
+  // whole 4 byte pixels around, so it works with any channel order.
+  Status Resize(ImageDecoderContext* decoder, const int64 decoded_height,
+                const int64 decoded_width, const int64 height,
+                const int64 width, uint8* output) {
+    uint8* resized = output;
+    if (channels_ == 3) {
+      decoder->resized.resize(height * width * 4);
+      resized = decoder->resized.data();
+    }
+    if (libyuv::ARGBScale(decoder->decoded.data(), decoded_width * 4,
+                          decoded_width, decoded_height, resized, width * 4,
+                          width, height, libyuv::kFilterBilinear) != 0) {
+      return errors::InvalidArgument("unable to resize image of ",
+                                     decoded_height, "x", decoded_width);
+    }
+    if (channels_ == 3) {
+      libyuv::ARGBToRGB24(resized, width * 4, output, width * 3, width,
+                          height);
+    }
+    return OkStatus();
+  }
+
+  // Each unit of work is one image, so the cost keeps them on their own
+  // threads.
+  static constexpr int64 kCostPerImage = 1 << 20;
+
+  int64 channels_;
+};
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeImageBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp);
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow_io/core/kernels/image_raster_kernels.h"
 
 namespace tensorflow {
 namespace io {
@@ -108,6 +109,146 @@ class EncodeBmpOp : public OpKernel {
 };
 REGISTER_KERNEL_BUILDER(Name("IO>EncodeBmp").Device(DEVICE_CPU), EncodeBmpOp);
 
+uint32 GetLE16(const uint8* const src) { return src[0] | (src[1] << 8); }
+
+uint32 GetLE32(const uint8* const src) {
+  return GetLE16(src) | (GetLE16(src + 2) << 16);
+}
+
+// Reads the rows of an uncompressed (BI_RGB) 24 or 32 bit BMP file as RGB or
+// RGBA. The rows are stored bottom up unless the height is negative, and a
+// band of rows is read from the file at once either way.
+class BMPRasterReadableResource : public RasterReadableResourceBase {
+ public:
+  BMPRasterReadableResource(Env* env) : env_(env) {}
+  ~BMPRasterReadableResource() {}
+
+  Status Init(const string& filename, const void* optional_memory,
+              const size_t optional_length) override {
+    mutex_lock l(mu_);
+    file_.reset(new data::SizedRandomAccessFile(
+        env_, filename, optional_memory, optional_length));
+    TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
+
+    // bitmap file header and the start of the info header
+    uint8 header[bmp_header_size];
+    StringPiece result;
+    Status status = file_->Read(0, sizeof(header), &result,
+                                reinterpret_cast<char*>(header));
+    if (!(status.ok() || errors::IsOutOfRange(status))) {
+      return status;
+    }
+    if (result.size() != sizeof(header) || GetLE16(header) != 0x4d42) {
+      return errors::InvalidArgument("not a bmp file");
+    }
+    const int64 offset = GetLE32(header + 10);
+    const int64 info_size = GetLE32(header + 14);
+    const int64 width = static_cast<int32>(GetLE32(header + 18));
+    const int64 height = static_cast<int32>(GetLE32(header + 22));
+    const int64 bits_per_pixel = GetLE16(header + 28);
+    const int64 compression = GetLE32(header + 30);
+    if (info_size < 40) {
+      return errors::InvalidArgument("unsupported info header size: ",
+                                     info_size);
+    }
+    if (compression != 0) {
+      return errors::InvalidArgument("unsupported compression: ",
+                                     compression);
+    }
+    if (bits_per_pixel != 24 && bits_per_pixel != 32) {
+      return errors::InvalidArgument("unsupported bits per pixel: ",
+                                     bits_per_pixel);
+    }
+    if (width <= 0 || height == 0) {
+      return errors::InvalidArgument("invalid shape: (", height, ", ", width,
+                                     ")");
+    }
+    top_down_ = (height < 0);
+    offset_ = offset;
+    stride_ = ((width * bits_per_pixel + 31) / 32) * 4;  // pad to 4
+    shape_ = TensorShape({std::abs(height), width, bits_per_pixel / 8});
+    if (offset_ + stride_ * shape_.dim_size(0) >
+        static_cast<int64>(file_size_)) {
+      return errors::InvalidArgument("not enough data");
+    }
+    return OkStatus();
+  }
+  Status Spec(TensorShape* shape, DataType* dtype) override {
+    mutex_lock l(mu_);
+    *shape = shape_;
+    *dtype = DT_UINT8;
+    return OkStatus();
+  }
+  Status Read(const int64 start, const int64 stop,
+              std::function<Status(const TensorShape& shape, Tensor** value)>
+                  allocate_func) override {
+    mutex_lock l(mu_);
+    const int64 height = shape_.dim_size(0);
+    const int64 width = shape_.dim_size(1);
+    const int64 channels = shape_.dim_size(2);
+    int64 row_start, row_stop;
+    RasterRowsLookup(height, start, stop, &row_start, &row_stop);
+    Tensor* value;
+    TF_RETURN_IF_ERROR(allocate_func(
+        TensorShape({row_stop - row_start, width, channels}), &value));
+    if (row_start == row_stop) {
+      return OkStatus();
+    }
+
+    const int64 rows = row_stop - row_start;
+    const int64 first = top_down_ ? row_start : (height - row_stop);
+    string band(rows * stride_, '\0');
+    StringPiece result;
+    TF_RETURN_IF_ERROR(
+        file_->Read(offset_ + first * stride_, band.size(), &result, &band[0]));
+    if (result.size() != band.size()) {
+      return errors::InvalidArgument("not enough data");
+    }
+    const uint8* data = reinterpret_cast<const uint8*>(result.data());
+    for (int64 i = 0; i < rows; i++) {
+      const uint8* line = data + (top_down_ ? i : (rows - 1 - i)) * stride_;
+      uint8* output = value->flat<uint8>().data() + i * width * channels;
+      for (int64 j = 0; j < width; j++) {
+        // BGR(A) => RGB(A)
+        const uint8* pixel = line + j * channels;
+        output[j * channels] = pixel[2];
+        output[j * channels + 1] = pixel[1];
+        output[j * channels + 2] = pixel[0];
+        if (channels == 4) {
+          output[j * channels + 3] = pixel[3];
+        }
+      }
+    }
+    return OkStatus();
+  }
+  string DebugString() const override { return "BMPRasterReadableResource"; }
+
+ private:
+  static const size_t bmp_header_size = 54;
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<data::SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
+  uint64 file_size_ TF_GUARDED_BY(mu_);
+  TensorShape shape_;
+  bool top_down_;
+  int64 offset_;
+  int64 stride_;
+};
+
 }  // namespace
+
+Status BMPRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource) {
+  resource.reset(new BMPRasterReadableResource(env));
+  Status status = resource->Init(filename, optional_memory, optional_length);
+  if (!status.ok()) {
+    resource.reset(nullptr);
+  }
+  return status;
+}
+
 }  // namespace io
 }  // namespace tensorflow
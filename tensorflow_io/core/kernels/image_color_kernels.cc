@@ -0,0 +1,347 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/kernels/cpu_info.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TFIO_COLOR_INLINE __forceinline
+#else
+#define TFIO_COLOR_INLINE inline __attribute__((always_inline))
+#endif
+
+#ifdef TFIO_DISPATCH_X86
+// The conversion loops are compiled once more for each of the extensions
+// below, and the version the CPU supports is picked at runtime. Other
+// platforms, such as aarch64 with NEON, vectorize them for their baseline.
+#define TFIO_COLOR_X86
+#endif
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// A conversion between color spaces, made of the steps below applied in
+// order to the three channels of each pixel. Only `matrix` and `offset`
+// apply to all conversions, the others are for the nonlinear spaces.
+struct ColorConversion {
+  // From CIE LAB to the nonlinear XYZ, relative to the white point.
+  bool from_lab = false;
+  // From sRGB to linear RGB.
+  bool to_linear = false;
+  float matrix[9];
+  float offset[3] = {0.0f, 0.0f, 0.0f};
+  // From linear RGB to sRGB.
+  bool from_linear = false;
+  // From XYZ, relative to the white point, to CIE LAB.
+  bool to_lab = false;
+  // Clips the output to [0, 1]. The uint8 outputs are always clipped to
+  // [0, 255].
+  bool clip = false;
+};
+
+// Pixels are converted in blocks split into one plane per channel, so that
+// each step is a loop over contiguous floats the compiler vectorizes. The
+// whole block is read before any of it is written, so that the output may be
+// the input.
+static constexpr int64 kBlockPixels = 256;
+
+template <typename T>
+TFIO_COLOR_INLINE void Load(const T* in, const int64 count, float* c0,
+                            float* c1, float* c2) {
+  for (int64 i = 0; i < count; i++) {
+    c0[i] = in[i * 3];
+    c1[i] = in[i * 3 + 1];
+    c2[i] = in[i * 3 + 2];
+  }
+}
+
+// Truncates as a cast of the clipped values to uint8 does.
+TFIO_COLOR_INLINE void Store(const float* c0, const float* c1,
+                             const float* c2, const int64 count, uint8* out) {
+  for (int64 i = 0; i < count; i++) {
+    out[i * 3] = static_cast<uint8>(std::min(std::max(c0[i], 0.0f), 255.0f));
+    out[i * 3 + 1] =
+        static_cast<uint8>(std::min(std::max(c1[i], 0.0f), 255.0f));
+    out[i * 3 + 2] =
+        static_cast<uint8>(std::min(std::max(c2[i], 0.0f), 255.0f));
+  }
+}
+
+TFIO_COLOR_INLINE void Store(const float* c0, const float* c1,
+                             const float* c2, const int64 count, float* out) {
+  for (int64 i = 0; i < count; i++) {
+    out[i * 3] = c0[i];
+    out[i * 3 + 1] = c1[i];
+    out[i * 3 + 2] = c2[i];
+  }
+}
+
+TFIO_COLOR_INLINE float ToLinear(const float v) {
+  return v > 0.04045f ? std::pow((v + 0.055f) / 1.055f, 2.4f) : v / 12.92f;
+}
+
+TFIO_COLOR_INLINE float FromLinear(const float v) {
+  return v > 0.0031308f ? std::pow(v, 1.0f / 2.4f) * 1.055f - 0.055f
+                        : v * 12.92f;
+}
+
+TFIO_COLOR_INLINE float ToLab(const float v) {
+  return v > 0.008856f ? std::cbrt(v) : v * 7.787f + 16.0f / 116.0f;
+}
+
+TFIO_COLOR_INLINE float FromLab(const float v) {
+  return v > 0.2068966f ? v * v * v : (v - 16.0f / 116.0f) / 7.787f;
+}
+
+template <typename T>
+TFIO_COLOR_INLINE void ConvertBlock(const ColorConversion& conversion,
+                                    const T* in, const int64 count, T* out) {
+  float c0[kBlockPixels], c1[kBlockPixels], c2[kBlockPixels];
+  Load(in, count, c0, c1, c2);
+  if (conversion.from_lab) {
+    for (int64 i = 0; i < count; i++) {
+      const float y = (c0[i] + 16.0f) / 116.0f;
+      const float x = c1[i] / 500.0f + y;
+      const float z = std::max(y - c2[i] / 200.0f, 0.0f);
+      c0[i] = FromLab(x);
+      c1[i] = FromLab(y);
+      c2[i] = FromLab(z);
+    }
+  }
+  if (conversion.to_linear) {
+    for (int64 i = 0; i < count; i++) {
+      c0[i] = ToLinear(c0[i]);
+      c1[i] = ToLinear(c1[i]);
+      c2[i] = ToLinear(c2[i]);
+    }
+  }
+  const float* m = conversion.matrix;
+  const float* o = conversion.offset;
+  for (int64 i = 0; i < count; i++) {
+    const float x = c0[i], y = c1[i], z = c2[i];
+    c0[i] = m[0] * x + m[1] * y + m[2] * z + o[0];
+    c1[i] = m[3] * x + m[4] * y + m[5] * z + o[1];
+    c2[i] = m[6] * x + m[7] * y + m[8] * z + o[2];
+  }
+  if (conversion.from_linear) {
+    for (int64 i = 0; i < count; i++) {
+      c0[i] = FromLinear(c0[i]);
+      c1[i] = FromLinear(c1[i]);
+      c2[i] = FromLinear(c2[i]);
+    }
+  }
+  if (conversion.to_lab) {
+    for (int64 i = 0; i < count; i++) {
+      const float x = ToLab(c0[i]), y = ToLab(c1[i]), z = ToLab(c2[i]);
+      c0[i] = y * 116.0f - 16.0f;
+      c1[i] = (x - y) * 500.0f;
+      c2[i] = (y - z) * 200.0f;
+    }
+  }
+  if (conversion.clip) {
+    for (int64 i = 0; i < count; i++) {
+      c0[i] = std::min(std::max(c0[i], 0.0f), 1.0f);
+      c1[i] = std::min(std::max(c1[i], 0.0f), 1.0f);
+      c2[i] = std::min(std::max(c2[i], 0.0f), 1.0f);
+    }
+  }
+  Store(c0, c1, c2, count, out);
+}
+
+template <typename T>
+TFIO_COLOR_INLINE void ConvertPixels(const ColorConversion& conversion,
+                                     const T* in, const int64 count, T* out) {
+  for (int64 i = 0; i < count; i += kBlockPixels) {
+    ConvertBlock(conversion, in + i * 3, std::min(kBlockPixels, count - i),
+                 out + i * 3);
+  }
+}
+
+template <typename T>
+void ConvertPixelsDefault(const ColorConversion& conversion, const T* in,
+                          const int64 count, T* out) {
+  ConvertPixels(conversion, in, count, out);
+}
+
+#ifdef TFIO_COLOR_X86
+template <typename T>
+TFIO_TARGET("avx2,fma")
+void ConvertPixelsAVX2(const ColorConversion& conversion, const T* in,
+                       const int64 count, T* out) {
+  ConvertPixels(conversion, in, count, out);
+}
+
+template <typename T>
+TFIO_TARGET("avx512f")
+void ConvertPixelsAVX512(const ColorConversion& conversion, const T* in,
+                         const int64 count, T* out) {
+  ConvertPixels(conversion, in, count, out);
+}
+#endif  // TFIO_COLOR_X86
+
+template <typename T>
+using ConvertFunc = void (*)(const ColorConversion& conversion, const T* in,
+                             const int64 count, T* out);
+
+template <typename T>
+ConvertFunc<T> SelectConvert() {
+#ifdef TFIO_COLOR_X86
+  if (CanDispatch(DispatchISA::kAVX512)) {
+    return ConvertPixelsAVX512<T>;
+  }
+  if (CanDispatch(DispatchISA::kAVX2)) {
+    return ConvertPixelsAVX2<T>;
+  }
+#endif
+  return ConvertPixelsDefault<T>;
+}
+
+void SetMatrix(ColorConversion* conversion, std::initializer_list<float> m) {
+  std::copy(m.begin(), m.end(), conversion->matrix);
+}
+
+void SetOffset(ColorConversion* conversion, std::initializer_list<float> o) {
+  std::copy(o.begin(), o.end(), conversion->offset);
+}
+
+// The constants are those of tfio.experimental.color, which follow
+// skimage.color.
+Status MakeColorConversion(const string& name, const std::vector<float>& white,
+                           ColorConversion* conversion) {
+  if (name == "rgb_to_ycbcr") {
+    // The uint8 input is scaled by 1/256 first.
+    SetMatrix(conversion, {65.783f, 129.057f, 25.064f, -37.945f, -74.494f,
+                           112.439f, 112.439f, -94.154f, -18.285f});
+    for (float& v : conversion->matrix) v /= 256.0f;
+    SetOffset(conversion, {16.0f, 128.0f, 128.0f});
+  } else if (name == "ycbcr_to_rgb") {
+    SetMatrix(conversion, {298.082f, 0.0f, 408.583f, 298.082f, -100.291f,
+                           -208.120f, 298.082f, 516.412f, 0.0f});
+    for (float& v : conversion->matrix) v /= 256.0f;
+    SetOffset(conversion, {-222.921f, 135.576f, -276.836f});
+  } else if (name == "rgb_to_ypbpr") {
+    SetMatrix(conversion, {0.299f, 0.587f, 0.114f, -0.168736f, -0.331264f,
+                           0.5f, 0.5f, -0.418688f, -0.081312f});
+  } else if (name == "ypbpr_to_rgb") {
+    SetMatrix(conversion,
+              {1.00000000e00f, -1.21889419e-06f, 1.40199959e00f,
+               1.00000000e00f, -3.44135678e-01f, -7.14136156e-01f,
+               1.00000000e00f, 1.77200007e00f, 4.06298063e-07f});
+  } else if (name == "rgb_to_ydbdr") {
+    SetMatrix(conversion, {0.299f, 0.587f, 0.114f, -0.45f, -0.883f, 1.333f,
+                           -1.333f, 1.116f, 0.217f});
+  } else if (name == "ydbdr_to_rgb") {
+    SetMatrix(conversion,
+              {1.00000000e00f, 9.23037161e-05f, -5.25912631e-01f,
+               1.00000000e00f, -1.29132899e-01f, 2.67899328e-01f,
+               1.00000000e00f, 6.64679060e-01f, -7.92025435e-05f});
+  } else if (name == "rgb_to_xyz" || name == "rgb_to_lab") {
+    SetMatrix(conversion, {0.412453f, 0.357580f, 0.180423f, 0.212671f,
+                           0.715160f, 0.072169f, 0.019334f, 0.119193f,
+                           0.950227f});
+    conversion->to_linear = true;
+    if (name == "rgb_to_lab") {
+      // Folds the division by the white point into the rows.
+      for (int64 i = 0; i < 9; i++) conversion->matrix[i] /= white[i / 3];
+      conversion->to_lab = true;
+    }
+  } else if (name == "xyz_to_rgb" || name == "lab_to_rgb") {
+    SetMatrix(conversion, {3.24048134f, -1.53715152f, -0.49853633f,
+                           -0.96925495f, 1.87599f, 0.04155593f, 0.05564664f,
+                           -0.20404134f, 1.05731107f});
+    conversion->from_linear = true;
+    conversion->clip = true;
+    if (name == "lab_to_rgb") {
+      // Folds the multiplication by the white point into the columns.
+      for (int64 i = 0; i < 9; i++) conversion->matrix[i] *= white[i % 3];
+      conversion->from_lab = true;
+    }
+  } else {
+    return errors::InvalidArgument("unsupported conversion: ", name);
+  }
+  return OkStatus();
+}
+
+// Converts the colors of images with the channels in the last dimension,
+// in place when the input is not used elsewhere. Pixels are converted in
+// parallel, with the loops compiled for the vector extensions of the CPU.
+template <typename T>
+class ConvertColorOp : public OpKernel {
+ public:
+  explicit ConvertColorOp(OpKernelConstruction* context) : OpKernel(context) {
+    string conversion;
+    OP_REQUIRES_OK(context, context->GetAttr("conversion", &conversion));
+    std::vector<float> white;
+    OP_REQUIRES_OK(context, context->GetAttr("white", &white));
+    OP_REQUIRES(context, (white.size() == 3),
+                errors::InvalidArgument("white must have 3 elements, got ",
+                                        white.size()));
+    const bool integer =
+        (conversion == "rgb_to_ycbcr" || conversion == "ycbcr_to_rgb");
+    OP_REQUIRES(context, (integer == std::is_same<T, uint8>::value),
+                errors::InvalidArgument(
+                    conversion, " is not supported for ",
+                    DataTypeString(DataTypeToEnum<T>::v())));
+    OP_REQUIRES_OK(context,
+                   MakeColorConversion(conversion, white, &conversion_));
+    convert_ = SelectConvert<T>();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input_tensor = context->input(0);
+    OP_REQUIRES(context,
+                (input_tensor.dims() >= 1 &&
+                 input_tensor.dim_size(input_tensor.dims() - 1) == 3),
+                errors::InvalidArgument(
+                    "input must have 3 channels in the last dimension, got ",
+                    input_tensor.shape().DebugString()));
+
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, input_tensor.shape(), &output_tensor));
+
+    const T* input = input_tensor.flat<T>().data();
+    T* output = output_tensor->flat<T>().data();
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          input_tensor.NumElements() / 3, kCostPerPixel,
+          [&](int64 start, int64 limit) {
+            convert_(conversion_, input + start * 3, limit - start,
+                     output + start * 3);
+          });
+  }
+
+ private:
+  static constexpr int64 kCostPerPixel = 64;
+
+  ColorConversion conversion_;
+  ConvertFunc<T> convert_;
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("IO>ConvertColor").Device(DEVICE_CPU).TypeConstraint<uint8>("dtype"),
+    ConvertColorOp<uint8>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>ConvertColor").Device(DEVICE_CPU).TypeConstraint<float>("dtype"),
+    ConvertColorOp<float>);
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -47,8 +47,11 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/strip.h"
+#include "tensorflow_io/core/kernels/shard_cost.h"
 
 // clang-format on
 
@@ -99,6 +102,40 @@ class DecoderRegistration {
   bool initialized_ TF_GUARDED_BY(mu_);
 };
 
+// Parses the DICOM file in `contents`, up to `stop` when given so that the
+// elements after it, such as the pixel data, are skipped.
+void ReadDICOMFile(const tstring &contents, DcmFileFormat *file,
+                   const DcmTagKey &stop = DCM_UndefinedTagKey) {
+  DcmInputBufferStream data_buf;
+  data_buf.setBuffer(contents.data(), contents.length());
+  data_buf.setEos();
+
+  file->transferInit();
+  file->readUntilTag(data_buf, EXS_Unknown, EGL_noChange, DCM_MaxReadLength,
+                     stop);
+  file->transferEnd();
+}
+
+// Opens `fcount` frames of the image of `file` from frame `fstart`. With
+// partial access only those frames are decompressed, and only when their
+// output data is requested. Returns nullptr if the image cannot be opened.
+std::unique_ptr<DicomImage> OpenDICOMImage(DcmFileFormat *file,
+                                           unsigned long fstart,
+                                           unsigned long fcount) {
+  std::unique_ptr<DicomImage> image;
+  try {
+    image.reset(new DicomImage(file, EXS_Unknown,
+                               CIF_UsePartialAccessToPixelData, fstart,
+                               fcount));
+  } catch (...) {
+    image.reset();
+  }
+  if (image != nullptr && image->getStatus() != EIS_Normal) {
+    image.reset();
+  }
+  return image;
+}
+
 template <typename dtype>
 class DecodeDICOMImageOp : public OpKernel {
  public:
@@ -113,6 +150,17 @@ class DecodeDICOMImageOp : public OpKernel {
     // Get the color_dim
     OP_REQUIRES_OK(context, context->GetAttr("color_dim", &color_dim_));
 
+    // Get the frame range
+    OP_REQUIRES_OK(context, context->GetAttr("start", &start_));
+    OP_REQUIRES_OK(context, context->GetAttr("count", &count_));
+    OP_REQUIRES(context, start_ >= 0,
+                errors::InvalidArgument("start must be non-negative, got ",
+                                        start_));
+    OP_REQUIRES(context, count_ >= -1,
+                errors::InvalidArgument(
+                    "count must be non-negative or -1 for all frames, got ",
+                    count_));
+
     DecoderRegistration::registerCodecs();
   }
 
@@ -129,32 +177,21 @@ class DecodeDICOMImageOp : public OpKernel {
 
     const auto in_contents_scalar = in_contents.scalar<tstring>()();
 
-    // Load Dicom Image
-    DcmInputBufferStream data_buf;
-    data_buf.setBuffer(in_contents_scalar.data(), in_contents_scalar.length());
-    data_buf.setEos();
-
+    // Load Dicom Image, opened on its first selected frame only for the
+    // image information.
     DcmFileFormat dicom_file;
-    dicom_file.transferInit();
-    OFCondition cond = dicom_file.read(data_buf);
-    dicom_file.transferEnd();
-
-    DicomImage *image = NULL;
-    try {
-      image = new DicomImage(&dicom_file, EXS_Unknown,
-                             CIF_DecompressCompletePixelData);
-    } catch (...) {
-      image = NULL;
-    }
+    ReadDICOMFile(in_contents_scalar, &dicom_file);
+
+    std::unique_ptr<DicomImage> image =
+        OpenDICOMImage(&dicom_file, static_cast<unsigned long>(start_), 1);
 
     unsigned long frameWidth = 0;
     unsigned long frameHeight = 0;
     unsigned int pixelDepth = 0;
-    unsigned long dataSize = 0;
     unsigned long frameCount = 0;
     unsigned int samples_per_pixel = 0;
 
-    if ((image == NULL) || (image->getStatus() != EIS_Normal)) {
+    if (image == nullptr) {
       if (on_error_ == "strict") {
         OP_REQUIRES(context, false,
                     errors::InvalidArgument("Error loading image"));
@@ -168,8 +205,14 @@ class DecodeDICOMImageOp : public OpKernel {
     }
 
     // Get image information
-    frameCount = image->getFrameCount();  // getNumberOfFrames(); starts at
-                                          // version DCMTK-3.6.1_20140617
+    const int64 number_of_frames = image->getNumberOfFrames();
+    OP_REQUIRES(context, start_ < number_of_frames,
+                errors::InvalidArgument("start ", start_,
+                                        " is out of range for ",
+                                        number_of_frames, " frames"));
+    frameCount = (count_ < 0 || start_ + count_ > number_of_frames)
+                     ? number_of_frames - start_
+                     : count_;
     frameWidth = image->getWidth();
     frameHeight = image->getHeight();
     pixelDepth = image->getDepth();
@@ -206,18 +249,42 @@ class DecodeDICOMImageOp : public OpKernel {
 
     auto output_flat = output_tensor->template flat<dtype>();
 
-    unsigned long frame_pixel_count =
+    const int64 frame_pixel_count =
         frameHeight * frameWidth * samples_per_pixel;
-
-    for (Uint64 f = 0; f < frameCount; f++) {
-      const void *image_frame = image->getOutputData(pixelDepth, f);
-
-      for (Uint64 p = 0; p < frame_pixel_count; p++) {
-        output_flat(f * frame_pixel_count + p) =
-            convert_uintn_to_t(image_frame, pixelDepth, p);
-      }
-    }
-    delete image;
+    image.reset();
+
+    // Frames are decoded in parallel. DCMTK images are not safe to share
+    // between threads, so each shard parses the file and opens its own
+    // frames. Decompressing and rendering a frame takes milliseconds, well
+    // above the parse a shard adds, so every frame may have a thread.
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    mutex status_mu;
+    Status status;
+    Shard(worker_threads->num_threads, worker_threads->workers, frameCount,
+          kCostPerExpensiveUnit, [&](int64 begin, int64 limit) {
+            DcmFileFormat shard_file;
+            ReadDICOMFile(in_contents_scalar, &shard_file);
+            std::unique_ptr<DicomImage> frames = OpenDICOMImage(
+                &shard_file, static_cast<unsigned long>(start_ + begin),
+                static_cast<unsigned long>(limit - begin));
+            for (int64 f = begin; f < limit; f++) {
+              const void *image_frame =
+                  frames != nullptr
+                      ? frames->getOutputData(pixelDepth, f - begin)
+                      : nullptr;
+              if (image_frame == nullptr) {
+                mutex_lock l(status_mu);
+                status.Update(errors::InvalidArgument(
+                    "Error decoding frame ", start_ + f));
+                return;
+              }
+              for (int64 p = 0; p < frame_pixel_count; p++) {
+                output_flat(f * frame_pixel_count + p) =
+                    convert_uintn_to_t(image_frame, pixelDepth, p);
+              }
+            }
+          });
+    OP_REQUIRES_OK(context, status);
   }
 
   dtype convert_uintn_to_t(const void *buff, unsigned int n_bits,
@@ -300,6 +367,8 @@ class DecodeDICOMImageOp : public OpKernel {
   string on_error_;
   string scale_;
   bool color_dim_;
+  int64 start_;
+  int64 count_;
 };
 
 class DecodeDICOMDataOp : public OpKernel {
@@ -329,14 +398,27 @@ class DecodeDICOMDataOp : public OpKernel {
 
     auto out_tag_values_flat = out_tag_values->flat<tstring>();
 
-    DcmInputBufferStream dataBuf;
-    dataBuf.setBuffer(in_contents_scalar.data(), in_contents_scalar.length());
-    dataBuf.setEos();
+    // The pixel data is only parsed when one of the tags follows it.
+    bool after_pixel_data = false;
+    for (int64 tag_i = 0; tag_i < in_tags->NumElements(); ++tag_i) {
+      DcmTag tag;
+      if (in_tags->dtype() == DT_STRING) {
+        absl::string_view tag_sequence(in_tags->flat<tstring>()(tag_i));
+        if (absl::ConsumePrefix(&tag_sequence, "[")) {
+          tag_sequence = tag_sequence.substr(0, tag_sequence.find(']'));
+        }
+        if (!GetDcmTag(tag_sequence, &tag).ok()) continue;
+      } else {
+        GetDcmTag(in_tags->flat<uint32>()(tag_i), &tag).IgnoreError();
+      }
+      if (!(tag < DCM_PixelData)) {
+        after_pixel_data = true;
+      }
+    }
 
     DcmFileFormat dfile;
-    dfile.transferInit();
-    OFCondition cond = dfile.read(dataBuf);
-    dfile.transferEnd();
+    ReadDICOMFile(in_contents_scalar, &dfile,
+                  after_pixel_data ? DCM_UndefinedTagKey : DCM_PixelData);
 
     DcmItem *item = static_cast<DcmItem *>(dfile.getDataset());
     DcmMetaInfo *meta = dfile.getMetaInfo();
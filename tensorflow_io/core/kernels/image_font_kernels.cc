@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 // OpenSans Regular font, Apache License 2.0
 // Generated through xxd -i.
@@ -61,15 +62,6 @@ std::vector<std::vector<float>> DefaultColorTable(int depth) {
   return color_table;
 }
 
-bool GlyphBit(const FT_Face& face, int64 x, int64 y) {
-  int pitch = abs(face->glyph->bitmap.pitch);
-
-  unsigned char* row = &face->glyph->bitmap.buffer[pitch * y];
-  unsigned char byte = row[x >> 3];
-
-  return (byte & (128 >> (x & 7))) != 0;
-}
-
 static FT_Library library;
 Status InitializeFreeTypeLibrary() {
   static mutex init_lock(LINKER_INITIALIZED);
@@ -86,6 +78,89 @@ Status InitializeFreeTypeLibrary() {
   return OkStatus();
 }
 
+// A glyph rasterized to 8-bit coverage, with its metrics in pixels.
+struct Glyph {
+  int64 rows;
+  int64 width;
+  int64 left;
+  int64 advance;
+  std::vector<uint8> coverage;
+};
+
+// The glyphs of the font at one pixel size, rasterized the first time they
+// are drawn and reused by all the later calls. Glyphs are never removed, so
+// the pointers handed out stay valid for the life of the atlas.
+class GlyphAtlas {
+ public:
+  GlyphAtlas() : face_(nullptr) {}
+  ~GlyphAtlas() {
+    if (face_ != nullptr) {
+      FT_Done_Face(face_);
+    }
+  }
+
+  Status Init(int64 font_size) {
+    mutex_lock l(mu_);
+    if (face_ != nullptr) {
+      return OkStatus();
+    }
+    TF_RETURN_IF_ERROR(InitializeFreeTypeLibrary());
+    FT_Face face;
+    if (FT_New_Memory_Face(library, OpenSans_Regular_ttf,
+                           OpenSans_Regular_ttf_len, 0, &face) != 0) {
+      return errors::Internal("could not init FreeType Face");
+    }
+    if (FT_Set_Pixel_Sizes(face, 0, font_size) != 0) {
+      FT_Done_Face(face);
+      return errors::Internal("could not set pixel size");
+    }
+    face_ = face;
+    return OkStatus();
+  }
+
+  // Looks up the glyphs of the bytes of `text`, rasterizing those that are
+  // not in the atlas yet.
+  Status Lookup(const string& text, std::vector<const Glyph*>* glyphs) {
+    mutex_lock l(mu_);
+    glyphs->clear();
+    for (unsigned char c : text) {
+      FT_ULong byte = c;
+      auto it = glyphs_.find(byte);
+      if (it == glyphs_.end()) {
+        FT_UInt glyph_index = FT_Get_Char_Index(face_, byte);
+        if (FT_Load_Glyph(face_, glyph_index, FT_LOAD_RENDER) != 0) {
+          return errors::InvalidArgument("could not load glyph for byte: ",
+                                         byte);
+        }
+        if (FT_Render_Glyph(face_->glyph, FT_RENDER_MODE_NORMAL) != 0) {
+          return errors::InvalidArgument("could not render glyph for byte: ",
+                                         byte);
+        }
+        const FT_Bitmap& bitmap = face_->glyph->bitmap;
+        Glyph glyph;
+        glyph.rows = bitmap.rows;
+        glyph.width = bitmap.width;
+        glyph.left = face_->glyph->bitmap_left;
+        glyph.advance = face_->glyph->advance.x >> 6;
+        glyph.coverage.resize(glyph.rows * glyph.width);
+        const int pitch = abs(bitmap.pitch);
+        for (int64 i = 0; i < glyph.rows; i++) {
+          memcpy(&glyph.coverage[i * glyph.width], &bitmap.buffer[pitch * i],
+                 glyph.width);
+        }
+        it = glyphs_.emplace(byte, std::move(glyph)).first;
+      }
+      glyphs->push_back(&it->second);
+    }
+    return OkStatus();
+  }
+
+ private:
+  mutex mu_;
+  FT_Face face_ TF_GUARDED_BY(mu_);
+  std::unordered_map<FT_ULong, Glyph> glyphs_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 template <class T>
@@ -145,8 +220,7 @@ class DrawBoundingBoxesV3Op : public OpKernel {
       color_table = DefaultColorTable(depth);
     }
 
-    FT_Face face;
-    std::vector<string> texts;
+    std::vector<std::vector<const Glyph*>> texts;
     int64 font_size = font_size_ > 0 ? font_size_ : 32;
     if (context->num_inputs() >= 4) {
       const Tensor& texts_tensor = context->input(3);
@@ -158,43 +232,12 @@ class DrawBoundingBoxesV3Op : public OpKernel {
             context, images.dim_size(0) == texts_tensor.dim_size(0),
             errors::InvalidArgument("The batch sizes should be the same"));
 
-        texts.reserve(texts_tensor.NumElements());
+        OP_REQUIRES_OK(context, atlas_.Init(font_size));
+        texts.resize(texts_tensor.NumElements());
         for (int64 i = 0; i < texts_tensor.NumElements(); ++i) {
-          texts.emplace_back(texts_tensor.flat<tstring>()(i));
-        }
-        OP_REQUIRES_OK(context, InitializeFreeTypeLibrary());
-        OP_REQUIRES(context,
-                    FT_New_Memory_Face(library, OpenSans_Regular_ttf,
-                                       OpenSans_Regular_ttf_len, 0, &face) == 0,
-                    errors::Internal("could not init FreeType Face"));
-        OP_REQUIRES(context, FT_Set_Pixel_Sizes(face, 0, font_size) == 0,
-                    errors::Internal("could not set pixel size"));
-
-        std::unordered_set<FT_ULong> bytes;
-        for (int64 box_index = 0; box_index < texts.size(); box_index++) {
-          for (int64 byte_index = 0; byte_index < texts[box_index].size();
-               byte_index++) {
-            FT_ULong byte = texts[box_index][byte_index];
-            bytes.insert(byte);
-          }
-        }
-        int64 face_max_rows = 0;
-        for (FT_ULong byte : bytes) {
-          FT_UInt glyph_index = FT_Get_Char_Index(face, byte);
-          OP_REQUIRES(
-              context,
-              FT_Load_Glyph(face, glyph_index,
-                            FT_LOAD_RENDER | FT_LOAD_MONOCHROME |
-                                FT_LOAD_TARGET_MONO) == 0,
-              errors::InvalidArgument("could not load glyph for byte: ", byte));
-          OP_REQUIRES(context,
-                      FT_Render_Glyph(face->glyph, FT_RENDER_MODE_MONO) == 0,
-                      errors::InvalidArgument(
-                          "could not render glyph for byte: ", byte));
-
-          face_max_rows = face_max_rows > face->glyph->bitmap.rows
-                              ? face_max_rows
-                              : face->glyph->bitmap.rows;
+          OP_REQUIRES_OK(context,
+                         atlas_.Lookup(texts_tensor.flat<tstring>()(i),
+                                       &texts[i]));
         }
       }
     }
@@ -208,128 +251,138 @@ class DrawBoundingBoxesV3Op : public OpKernel {
     output->tensor<T, 4>() = images.tensor<T, 4>();
     auto canvas = output->tensor<T, 4>();
 
-    for (int64 b = 0; b < batch_size; ++b) {
-      const int64 num_boxes = boxes.dim_size(1);
-      const auto tboxes = boxes.tensor<T, 3>();
-      for (int64 bb = 0; bb < num_boxes; ++bb) {
-        int64 color_index = bb % color_table.size();
-        const int64 min_box_row =
-            static_cast<float>(tboxes(b, bb, 0)) * (height - 1);
-        const int64 min_box_row_clamp = std::max<int64>(min_box_row, int64{0});
-        const int64 max_box_row =
-            static_cast<float>(tboxes(b, bb, 2)) * (height - 1);
-        const int64 max_box_row_clamp =
-            std::min<int64>(max_box_row, height - 1);
-        const int64 min_box_col =
-            static_cast<float>(tboxes(b, bb, 1)) * (width - 1);
-        const int64 min_box_col_clamp = std::max<int64>(min_box_col, int64{0});
-        const int64 max_box_col =
-            static_cast<float>(tboxes(b, bb, 3)) * (width - 1);
-        const int64 max_box_col_clamp = std::min<int64>(max_box_col, width - 1);
-
-        if (min_box_row > max_box_row || min_box_col > max_box_col) {
-          LOG(WARNING) << "Bounding box (" << min_box_row << "," << min_box_col
-                       << "," << max_box_row << "," << max_box_col
-                       << ") is inverted and will not be drawn.";
-          continue;
-        }
-        if (min_box_row >= height || max_box_row < 0 || min_box_col >= width ||
-            max_box_col < 0) {
-          LOG(WARNING) << "Bounding box (" << min_box_row << "," << min_box_col
-                       << "," << max_box_row << "," << max_box_col
-                       << ") is completely outside the image"
-                       << " and will not be drawn.";
-          continue;
-        }
+    // Images are drawn in parallel.
+    const int64 num_boxes = boxes.dim_size(1);
+    const auto tboxes = boxes.tensor<T, 3>();
+    auto draw = [&](int64 start, int64 limit) {
+      for (int64 b = start; b < limit; ++b) {
+        for (int64 bb = 0; bb < num_boxes; ++bb) {
+          int64 color_index = bb % color_table.size();
+          const int64 min_box_row =
+              static_cast<float>(tboxes(b, bb, 0)) * (height - 1);
+          const int64 min_box_row_clamp =
+              std::max<int64>(min_box_row, int64{0});
+          const int64 max_box_row =
+              static_cast<float>(tboxes(b, bb, 2)) * (height - 1);
+          const int64 max_box_row_clamp =
+              std::min<int64>(max_box_row, height - 1);
+          const int64 min_box_col =
+              static_cast<float>(tboxes(b, bb, 1)) * (width - 1);
+          const int64 min_box_col_clamp =
+              std::max<int64>(min_box_col, int64{0});
+          const int64 max_box_col =
+              static_cast<float>(tboxes(b, bb, 3)) * (width - 1);
+          const int64 max_box_col_clamp =
+              std::min<int64>(max_box_col, width - 1);
+
+          if (min_box_row > max_box_row || min_box_col > max_box_col) {
+            LOG(WARNING) << "Bounding box (" << min_box_row << ","
+                         << min_box_col << "," << max_box_row << ","
+                         << max_box_col
+                         << ") is inverted and will not be drawn.";
+            continue;
+          }
+          if (min_box_row >= height || max_box_row < 0 ||
+              min_box_col >= width || max_box_col < 0) {
+            LOG(WARNING) << "Bounding box (" << min_box_row << ","
+                         << min_box_col << "," << max_box_row << ","
+                         << max_box_col << ") is completely outside the image"
+                         << " and will not be drawn.";
+            continue;
+          }
 
-        // At this point, {min,max}_box_{row,col}_clamp are inside the
-        // image.
-        CHECK_GE(min_box_row_clamp, 0);
-        CHECK_GE(max_box_row_clamp, 0);
-        CHECK_LT(min_box_row_clamp, height);
-        CHECK_LT(max_box_row_clamp, height);
-        CHECK_GE(min_box_col_clamp, 0);
-        CHECK_GE(max_box_col_clamp, 0);
-        CHECK_LT(min_box_col_clamp, width);
-        CHECK_LT(max_box_col_clamp, width);
-
-        // At this point, the min_box_row and min_box_col are either
-        // in the image or above/left of it, and max_box_row and
-        // max_box_col are either in the image or below/right or it.
-        CHECK_LT(min_box_row, height);
-        CHECK_GE(max_box_row, 0);
-        CHECK_LT(min_box_col, width);
-        CHECK_GE(max_box_col, 0);
-
-        // Draw top line.
-        if (min_box_row >= 0) {
-          for (int64 j = min_box_col_clamp; j <= max_box_col_clamp; ++j)
-            for (int64 c = 0; c < depth; c++) {
-              canvas(b, min_box_row, j, c) =
-                  static_cast<T>(color_table[color_index][c]);
-            }
-        }
-        // Draw bottom line.
-        if (max_box_row < height) {
-          for (int64 j = min_box_col_clamp; j <= max_box_col_clamp; ++j)
-            for (int64 c = 0; c < depth; c++) {
-              canvas(b, max_box_row, j, c) =
-                  static_cast<T>(color_table[color_index][c]);
-            }
-        }
-        // Draw left line.
-        if (min_box_col >= 0) {
-          for (int64 i = min_box_row_clamp; i <= max_box_row_clamp; ++i)
-            for (int64 c = 0; c < depth; c++) {
-              canvas(b, i, min_box_col, c) =
-                  static_cast<T>(color_table[color_index][c]);
-            }
-        }
-        // Draw right line.
-        if (max_box_col < width) {
-          for (int64 i = min_box_row_clamp; i <= max_box_row_clamp; ++i)
-            for (int64 c = 0; c < depth; c++) {
-              canvas(b, i, max_box_col, c) =
-                  static_cast<T>(color_table[color_index][c]);
-            }
-        }
+          // At this point, {min,max}_box_{row,col}_clamp are inside the
+          // image.
+          CHECK_GE(min_box_row_clamp, 0);
+          CHECK_GE(max_box_row_clamp, 0);
+          CHECK_LT(min_box_row_clamp, height);
+          CHECK_LT(max_box_row_clamp, height);
+          CHECK_GE(min_box_col_clamp, 0);
+          CHECK_GE(max_box_col_clamp, 0);
+          CHECK_LT(min_box_col_clamp, width);
+          CHECK_LT(max_box_col_clamp, width);
+
+          // At this point, the min_box_row and min_box_col are either
+          // in the image or above/left of it, and max_box_row and
+          // max_box_col are either in the image or below/right or it.
+          CHECK_LT(min_box_row, height);
+          CHECK_GE(max_box_row, 0);
+          CHECK_LT(min_box_col, width);
+          CHECK_GE(max_box_col, 0);
+
+          // Draw top line.
+          if (min_box_row >= 0) {
+            for (int64 j = min_box_col_clamp; j <= max_box_col_clamp; ++j)
+              for (int64 c = 0; c < depth; c++) {
+                canvas(b, min_box_row, j, c) =
+                    static_cast<T>(color_table[color_index][c]);
+              }
+          }
+          // Draw bottom line.
+          if (max_box_row < height) {
+            for (int64 j = min_box_col_clamp; j <= max_box_col_clamp; ++j)
+              for (int64 c = 0; c < depth; c++) {
+                canvas(b, max_box_row, j, c) =
+                    static_cast<T>(color_table[color_index][c]);
+              }
+          }
+          // Draw left line.
+          if (min_box_col >= 0) {
+            for (int64 i = min_box_row_clamp; i <= max_box_row_clamp; ++i)
+              for (int64 c = 0; c < depth; c++) {
+                canvas(b, i, min_box_col, c) =
+                    static_cast<T>(color_table[color_index][c]);
+              }
+          }
+          // Draw right line.
+          if (max_box_col < width) {
+            for (int64 i = min_box_row_clamp; i <= max_box_row_clamp; ++i)
+              for (int64 c = 0; c < depth; c++) {
+                canvas(b, i, max_box_col, c) =
+                    static_cast<T>(color_table[color_index][c]);
+              }
+          }
 
-        // Draw text
-        for (int64 box_index = 0; box_index < texts.size(); box_index++) {
-          int64 box_col_offset = 0;
-          for (int64 byte_index = 0; byte_index < texts[box_index].size();
-               byte_index++) {
-            FT_ULong byte = texts[box_index][byte_index];
-            FT_UInt glyph_index = FT_Get_Char_Index(face, byte);
-            FT_Load_Glyph(
-                face, glyph_index,
-                FT_LOAD_RENDER | FT_LOAD_MONOCHROME | FT_LOAD_TARGET_MONO);
-            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_MONO);
-            for (int64 i = 0; i < face->glyph->bitmap.rows; i++) {
-              for (int64 j = 0; j < face->glyph->bitmap.width; j++) {
-                int64 x = j;
-                int64 y = i;
-                if (GlyphBit(face, x, y)) {
-                  int64 col = face->glyph->bitmap_left + box_col_offset + j +
-                              min_box_col;
-                  int64 row =
-                      i + min_box_row + font_size - face->glyph->bitmap.rows;
+          // Draw text, blending the color over the image by the coverage of
+          // the glyphs.
+          for (int64 box_index = 0; box_index < texts.size(); box_index++) {
+            int64 box_col_offset = 0;
+            for (const Glyph* glyph : texts[box_index]) {
+              for (int64 i = 0; i < glyph->rows; i++) {
+                int64 row = i + min_box_row + font_size - glyph->rows;
+                if (row < 0 || row >= height) continue;
+                for (int64 j = 0; j < glyph->width; j++) {
+                  int64 col = glyph->left + box_col_offset + j + min_box_col;
+                  if (col < 0 || col >= width) continue;
+                  const float alpha = glyph->coverage[i * glyph->width + j] /
+                                      255.0f;
+                  if (alpha == 0) continue;
                   for (int64 c = 0; c < depth; c++) {
-                    canvas(b, row, col, c) =
-                        static_cast<T>(color_table[color_index][c]);
+                    canvas(b, row, col, c) = static_cast<T>(
+                        static_cast<float>(canvas(b, row, col, c)) *
+                            (1 - alpha) +
+                        color_table[color_index][c] * alpha);
                   }
                 }
               }
+              box_col_offset += glyph->advance;
             }
-            box_col_offset += (face->glyph->advance.x >> 6);
           }
         }
       }
-    }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, batch_size,
+          kCostPerImage, draw);
   }
 
  private:
+  // Each unit of work is one image, so the cost keeps them on their own
+  // threads.
+  static constexpr int64 kCostPerImage = 1 << 20;
+
   int64 font_size_;
+  GlyphAtlas atlas_;
 };
 
 #define REGISTER_CPU_KERNEL(T)                           \
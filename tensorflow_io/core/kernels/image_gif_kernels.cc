@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "gif_lib.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/kernels/shard_cost.h"
 
 namespace tensorflow {
 namespace io {
@@ -27,9 +29,30 @@ int GifQuantizeBuffer(unsigned int Width, unsigned int Height,
                       GifByteType* OutputBuffer, GifColorType* OutputColorMap);
 }
 
+using GifColorMap = std::unique_ptr<ColorMapObject, void (*)(ColorMapObject*)>;
+
+GifColorMap MakeGifColorMap(int color_size) {
+  return GifColorMap(GifMakeMapObject(color_size, NULL),
+                     [](ColorMapObject* p) {
+                       if (p != nullptr) {
+                         GifFreeMapObject(p);
+                       }
+                     });
+}
+
+// Encodes frames into an animated GIF. With a global palette, one palette is
+// quantized over all the frames, and with a local one each frame gets its
+// own, which are quantized in parallel. With delta, frames after the first
+// only store the rectangle that changed from the frame before, which is
+// left in place by the decoder.
 class EncodeGifOp : public OpKernel {
  public:
-  explicit EncodeGifOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit EncodeGifOp(OpKernelConstruction* context) : OpKernel(context) {
+    string palette;
+    OP_REQUIRES_OK(context, context->GetAttr("palette", &palette));
+    local_palette_ = (palette == "local");
+    OP_REQUIRES_OK(context, context->GetAttr("delta", &delta_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor* input_tensor;
@@ -46,47 +69,101 @@ class EncodeGifOp : public OpKernel {
         context, (channels == 3),
         errors::InvalidArgument(
             "only rgb (channel=3) mode encoding supported: ", channels));
+    const auto input = input_tensor->tensor<uint8, 4>();
+
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+
+    // The rectangle of each frame that is stored.
+    std::vector<Rect> rects(count, Rect{0, 0, height, width});
+    if (delta_) {
+      // Comparing a pixel with the previous frame costs about as much as
+      // converting it.
+      Shard(worker_threads->num_threads, worker_threads->workers, count,
+            height * width * kCostPerConvertedPixel,
+            [&](int64 start, int64 limit) {
+              for (int64 i = std::max<int64>(start, 1); i < limit; i++) {
+                rects[i] = ChangedRect(input, i, height, width);
+              }
+            });
+    }
+
+    std::vector<unsigned char> q_data(count * height * width);
+    unsigned char* q_ptr = &q_data[0];
 
     // create a GIF color map object
 
     int color_size = 256;
-    std::unique_ptr<ColorMapObject, void (*)(ColorMapObject*)> color(
-        GifMakeMapObject(color_size, NULL), [](ColorMapObject* p) {
-          if (p != nullptr) {
-            GifFreeMapObject(p);
-          }
-        });
+    GifColorMap color = MakeGifColorMap(color_size);
     OP_REQUIRES(context, (color.get() != nullptr),
                 errors::InvalidArgument("unable to create color map"));
+    std::vector<GifColorMap> colors;
 
-    std::vector<unsigned char> r_data(count * height * width);
-    unsigned char* r_ptr = &r_data[0];
-    std::vector<unsigned char> g_data(count * height * width);
-    unsigned char* g_ptr = &g_data[0];
-    std::vector<unsigned char> b_data(count * height * width);
-    unsigned char* b_ptr = &b_data[0];
-    std::vector<unsigned char> q_data(count * height * width);
-    unsigned char* q_ptr = &q_data[0];
+    int status;
 
-    for (int64 i = 0; i < count; i++) {
-      for (int64 h = 0; h < height; h++) {
-        for (int64 w = 0; w < width; w++) {
-          r_ptr[i * height * width + h * width + w] =
-              input_tensor->tensor<uint8, 4>()(i, h, w, 0);
-          g_ptr[i * height * width + h * width + w] =
-              input_tensor->tensor<uint8, 4>()(i, h, w, 1);
-          b_ptr[i * height * width + h * width + w] =
-              input_tensor->tensor<uint8, 4>()(i, h, w, 2);
+    if (!local_palette_) {
+      std::vector<unsigned char> r_data(count * height * width);
+      unsigned char* r_ptr = &r_data[0];
+      std::vector<unsigned char> g_data(count * height * width);
+      unsigned char* g_ptr = &g_data[0];
+      std::vector<unsigned char> b_data(count * height * width);
+      unsigned char* b_ptr = &b_data[0];
+
+      for (int64 i = 0; i < count; i++) {
+        for (int64 h = 0; h < height; h++) {
+          for (int64 w = 0; w < width; w++) {
+            r_ptr[i * height * width + h * width + w] = input(i, h, w, 0);
+            g_ptr[i * height * width + h * width + w] = input(i, h, w, 1);
+            b_ptr[i * height * width + h * width + w] = input(i, h, w, 2);
+          }
         }
       }
-    }
-
-    int status;
 
-    status = GifQuantizeBuffer(count * width, height, &color_size, r_ptr, g_ptr,
-                               b_ptr, q_ptr, color->Colors);
-    OP_REQUIRES(context, (status == GIF_OK),
-                errors::InvalidArgument("unable to quantize buffer"));
+      status = GifQuantizeBuffer(count * width, height, &color_size, r_ptr,
+                                 g_ptr, b_ptr, q_ptr, color->Colors);
+      OP_REQUIRES(context, (status == GIF_OK),
+                  errors::InvalidArgument("unable to quantize buffer"));
+    } else {
+      // Only the stored rectangle of a frame is quantized, packed at the
+      // start of the frame in q_data.
+      for (int64 i = 0; i < count; i++) {
+        colors.emplace_back(MakeGifColorMap(256));
+        OP_REQUIRES(context, (colors.back().get() != nullptr),
+                    errors::InvalidArgument("unable to create color map"));
+      }
+      mutex status_mu;
+      Status quantize_status;
+      // Quantizing a frame fills and splits a histogram of all 15-bit colors
+      // whatever its size, so every frame is worth a thread.
+      Shard(worker_threads->num_threads, worker_threads->workers, count,
+            kCostPerExpensiveUnit, [&](int64 start, int64 limit) {
+              for (int64 i = start; i < limit; i++) {
+                const Rect& rect = rects[i];
+                std::vector<unsigned char> r(rect.height * rect.width);
+                std::vector<unsigned char> g(rect.height * rect.width);
+                std::vector<unsigned char> b(rect.height * rect.width);
+                for (int64 h = 0; h < rect.height; h++) {
+                  for (int64 w = 0; w < rect.width; w++) {
+                    r[h * rect.width + w] =
+                        input(i, rect.top + h, rect.left + w, 0);
+                    g[h * rect.width + w] =
+                        input(i, rect.top + h, rect.left + w, 1);
+                    b[h * rect.width + w] =
+                        input(i, rect.top + h, rect.left + w, 2);
+                  }
+                }
+                int size = 256;
+                if (GifQuantizeBuffer(rect.width, rect.height, &size, &r[0],
+                                      &g[0], &b[0],
+                                      q_ptr + i * height * width,
+                                      colors[i]->Colors) != GIF_OK) {
+                  mutex_lock l(status_mu);
+                  quantize_status.Update(errors::InvalidArgument(
+                      "unable to quantize frame ", i));
+                }
+              }
+            });
+      OP_REQUIRES_OK(context, quantize_status);
+    }
     int error_code;
 
     // allocate 64k + num_pixels (1 byte/pixel)
@@ -107,21 +184,28 @@ class EncodeGifOp : public OpKernel {
 
     EGifSetGifVersion(file.get(), true);
 
-    status = EGifPutScreenDesc(file.get(), width, height, 8, 0, color.get());
+    status = EGifPutScreenDesc(file.get(), width, height, 8, 0,
+                               local_palette_ ? NULL : color.get());
     OP_REQUIRES(context, (status == GIF_OK),
                 errors::InvalidArgument("unable to put screen desc: ",
                                         GifErrorString(file->Error)));
 
     for (int64 i = 0; i < count; i++) {
-      status = EGifPutImageDesc(file.get(), 0, 0, width, height, false, NULL);
+      const Rect& rect = rects[i];
+      status = EGifPutImageDesc(file.get(), rect.left, rect.top, rect.width,
+                                rect.height, false,
+                                local_palette_ ? colors[i].get() : NULL);
       OP_REQUIRES(context, (status == GIF_OK),
                   errors::InvalidArgument("unable to put image desc: ",
                                           GifErrorString(file->Error)));
 
-      for (int64 h = 0; h < height; h++) {
-        int64 offset = i * height * width + h * width;
+      for (int64 h = 0; h < rect.height; h++) {
+        int64 offset =
+            local_palette_
+                ? i * height * width + h * rect.width
+                : i * height * width + (rect.top + h) * width + rect.left;
         GifPixelType* p = q_ptr + offset;
-        status = EGifPutLine(file.get(), p, width);
+        status = EGifPutLine(file.get(), p, rect.width);
         OP_REQUIRES(context, (status == GIF_OK),
                     errors::InvalidArgument("unable to write line: ",
                                             GifErrorString(file->Error)));
@@ -130,6 +214,7 @@ class EncodeGifOp : public OpKernel {
 
     file.reset(nullptr);
     color.reset(nullptr);
+    colors.clear();
 
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(
@@ -147,6 +232,41 @@ class EncodeGifOp : public OpKernel {
     }
     return size;
   }
+
+ private:
+  struct Rect {
+    int64 top;
+    int64 left;
+    int64 height;
+    int64 width;
+  };
+
+  // Returns the smallest rectangle holding the pixels of frame i that differ
+  // from frame i - 1, which is a single pixel if none do, as a GIF image
+  // can not be empty.
+  static Rect ChangedRect(TTypes<uint8, 4>::ConstTensor input, int64 i,
+                          int64 height, int64 width) {
+    int64 top = height, bottom = -1, left = width, right = -1;
+    for (int64 h = 0; h < height; h++) {
+      for (int64 w = 0; w < width; w++) {
+        if (input(i, h, w, 0) != input(i - 1, h, w, 0) ||
+            input(i, h, w, 1) != input(i - 1, h, w, 1) ||
+            input(i, h, w, 2) != input(i - 1, h, w, 2)) {
+          top = std::min(top, h);
+          bottom = std::max(bottom, h);
+          left = std::min(left, w);
+          right = std::max(right, w);
+        }
+      }
+    }
+    if (bottom < 0) {
+      return Rect{0, 0, 1, 1};
+    }
+    return Rect{top, left, bottom - top + 1, right - left + 1};
+  }
+
+  bool local_palette_;
+  bool delta_;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>EncodeGif").Device(DEVICE_CPU), EncodeGifOp);
 
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
+#include "tensorflow/core/platform/str_util.h"
+#include "tensorflow_io/core/kernels/image_raster_kernels.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -78,6 +80,241 @@ class DecodeHDROp : public OpKernel {
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeHdr").Device(DEVICE_CPU), DecodeHDROp);
 
+// Reads the scanlines of a Radiance RGBE file as float RGB, as stb_image
+// decodes them. Scanlines are either run length encoded, each with a length
+// only known once it is decoded, or flat from the first one that is not to
+// the end. The offsets of the encoded scanlines are kept as they are found,
+// so that no scanline is decoded twice to be reached.
+class HDRRasterReadableResource : public RasterReadableResourceBase {
+ public:
+  HDRRasterReadableResource(Env* env) : env_(env) {}
+  ~HDRRasterReadableResource() {}
+
+  Status Init(const string& filename, const void* optional_memory,
+              const size_t optional_length) override {
+    mutex_lock l(mu_);
+    file_.reset(new data::SizedRandomAccessFile(
+        env_, filename, optional_memory, optional_length));
+    TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
+
+    // The header is lines of text up to an empty line, followed by the
+    // resolution line.
+    string header;
+    size_t blank, eol;
+    for (size_t size = 4096;; size *= 2) {
+      string scratch(size, '\0');
+      StringPiece result;
+      Status status = file_->Read(0, size, &result, &scratch[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      header.assign(result.data(), result.size());
+      blank = header.find("\n\n");
+      eol = (blank == string::npos) ? blank : header.find('\n', blank + 2);
+      if (eol != string::npos) {
+        break;
+      }
+      if (result.size() < size) {
+        return errors::InvalidArgument("invalid hdr header");
+      }
+    }
+    std::vector<string> lines = str_util::Split(header.substr(0, blank), '\n');
+    if (lines.empty() || !str_util::StartsWith(lines[0], "#?")) {
+      return errors::InvalidArgument("not a hdr file");
+    }
+    for (const string& line : lines) {
+      if (str_util::StartsWith(line, "FORMAT=") &&
+          line != "FORMAT=32-bit_rle_rgbe") {
+        return errors::InvalidArgument("unsupported format: ", line);
+      }
+    }
+    const string resolution = header.substr(blank + 2, eol - blank - 2);
+    std::vector<string> tokens =
+        str_util::Split(resolution, ' ', str_util::SkipEmpty());
+    int64 height, width;
+    if (tokens.size() != 4 || tokens[0] != "-Y" || tokens[2] != "+X" ||
+        !strings::safe_strto64(tokens[1], &height) ||
+        !strings::safe_strto64(tokens[3], &width)) {
+      return errors::InvalidArgument("unsupported resolution: ", resolution);
+    }
+    if (height <= 0 || width <= 0) {
+      return errors::InvalidArgument("invalid shape: (", height, ", ", width,
+                                     ")");
+    }
+    shape_ = TensorShape({height, width, 3});
+    row_offsets_ = {static_cast<int64>(eol + 1)};
+    // Narrow and wide scanlines are never run length encoded.
+    flat_row_ = (width < 8 || width >= 32768) ? 0 : -1;
+    return OkStatus();
+  }
+  Status Spec(TensorShape* shape, DataType* dtype) override {
+    mutex_lock l(mu_);
+    *shape = shape_;
+    *dtype = DT_FLOAT;
+    return OkStatus();
+  }
+  Status Read(const int64 start, const int64 stop,
+              std::function<Status(const TensorShape& shape, Tensor** value)>
+                  allocate_func) override {
+    mutex_lock l(mu_);
+    const int64 width = shape_.dim_size(1);
+    int64 row_start, row_stop;
+    RasterRowsLookup(shape_.dim_size(0), start, stop, &row_start, &row_stop);
+    Tensor* value;
+    TF_RETURN_IF_ERROR(allocate_func(
+        TensorShape({row_stop - row_start, width, 3}), &value));
+    if (row_start == row_stop) {
+      return OkStatus();
+    }
+
+    int64 row, offset;
+    if (flat_row_ >= 0 && row_start >= flat_row_) {
+      row = row_start;
+      offset = row_offsets_[flat_row_] + (row - flat_row_) * width * 4;
+    } else {
+      row = std::min<int64>(row_start,
+                            static_cast<int64>(row_offsets_.size()) - 1);
+      offset = row_offsets_[row];
+    }
+    Chunk chunk;
+    std::vector<uint8> rgbe(width * 4);
+    for (; row < row_stop; row++) {
+      bool flat = (flat_row_ >= 0 && row >= flat_row_);
+      TF_RETURN_IF_ERROR(DecodeRow(&offset, &chunk, &flat, rgbe.data()));
+      if (flat) {
+        if (flat_row_ < 0) {
+          flat_row_ = row;
+        }
+        offset += width * 4;
+      }
+      if (flat_row_ < 0 && row + 1 == static_cast<int64>(row_offsets_.size())) {
+        row_offsets_.push_back(offset);
+      }
+      if (row < row_start) {
+        continue;
+      }
+      float* output =
+          value->flat<float>().data() + (row - row_start) * width * 3;
+      for (int64 i = 0; i < width; i++) {
+        const uint8* pixel = &rgbe[i * 4];
+        if (pixel[3] != 0) {
+          const float f = std::ldexp(1.0f, pixel[3] - (128 + 8));
+          output[i * 3] = pixel[0] * f;
+          output[i * 3 + 1] = pixel[1] * f;
+          output[i * 3 + 2] = pixel[2] * f;
+        } else {
+          output[i * 3] = output[i * 3 + 1] = output[i * 3 + 2] = 0.0f;
+        }
+      }
+    }
+    return OkStatus();
+  }
+  string DebugString() const override { return "HDRRasterReadableResource"; }
+
+ private:
+  // A part of the file read at once, so that a band of scanlines is read
+  // with few reads.
+  struct Chunk {
+    int64 offset = 0;
+    string data;
+  };
+
+  // Makes [offset, offset + length) available in `chunk`, or as much of it
+  // as the file has.
+  Status Load(const int64 offset, const int64 length, Chunk* chunk)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (offset >= chunk->offset &&
+        offset + length <=
+            chunk->offset + static_cast<int64>(chunk->data.size())) {
+      return OkStatus();
+    }
+    const int64 size = std::max(length, kChunkSize);
+    string scratch(size, '\0');
+    StringPiece result;
+    Status status = file_->Read(offset, size, &result, &scratch[0]);
+    if (!(status.ok() || errors::IsOutOfRange(status))) {
+      return status;
+    }
+    chunk->offset = offset;
+    chunk->data.assign(result.data(), result.size());
+    return OkStatus();
+  }
+
+  // Decodes the scanline at `offset` into `rgbe`, and moves `offset` past
+  // it if it is run length encoded. Otherwise `flat` is set, as it is for
+  // all the scanlines that follow.
+  Status DecodeRow(int64* offset, Chunk* chunk, bool* flat, uint8* rgbe)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const int64 width = shape_.dim_size(1);
+    // Each value takes at most 2 bytes when encoded.
+    TF_RETURN_IF_ERROR(Load(*offset, width * 8 + 4, chunk));
+    const uint8* data = reinterpret_cast<const uint8*>(chunk->data.data()) +
+                        (*offset - chunk->offset);
+    const int64 size =
+        chunk->offset + static_cast<int64>(chunk->data.size()) - *offset;
+    if (!*flat) {
+      *flat = (size < 4 || data[0] != 2 || data[1] != 2 || (data[2] & 0x80));
+    }
+    if (*flat) {
+      if (size < width * 4) {
+        return errors::InvalidArgument("not enough data");
+      }
+      memcpy(rgbe, data, width * 4);
+      return OkStatus();
+    }
+    if (((data[2] << 8) | data[3]) != width) {
+      return errors::InvalidArgument("invalid decoded scanline length");
+    }
+    int64 pos = 4;
+    for (int64 k = 0; k < 4; k++) {
+      for (int64 i = 0; i < width;) {
+        if (pos >= size) {
+          return errors::InvalidArgument("not enough data");
+        }
+        int64 count = data[pos++];
+        const bool run = (count > 128);
+        if (run) {
+          count -= 128;
+        }
+        if (count == 0 || i + count > width || pos + (run ? 1 : count) > size) {
+          return errors::InvalidArgument("corrupt scanline");
+        }
+        for (int64 j = 0; j < count; j++, i++) {
+          rgbe[i * 4 + k] = data[run ? pos : pos + j];
+        }
+        pos += run ? 1 : count;
+      }
+    }
+    *offset += pos;
+    return OkStatus();
+  }
+
+  static constexpr int64 kChunkSize = 1024 * 1024;
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<data::SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
+  uint64 file_size_ TF_GUARDED_BY(mu_);
+  TensorShape shape_;
+  // The offsets of the scanlines 0, 1, 2, ... of those found so far, up to
+  // `flat_row_`, the first flat scanline, which is -1 until one is found.
+  std::vector<int64> row_offsets_ TF_GUARDED_BY(mu_);
+  int64 flat_row_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
+
+Status HDRRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource) {
+  resource.reset(new HDRRasterReadableResource(env));
+  Status status = resource->Init(filename, optional_memory, optional_length);
+  if (!status.ok()) {
+    resource.reset(nullptr);
+  }
+  return status;
+}
+
 }  // namespace io
 }  // namespace tensorflow
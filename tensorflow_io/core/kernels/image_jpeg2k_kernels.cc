@@ -57,7 +57,8 @@ class OpjStreamCallback {
                                 ? (p_nb_bytes)
                                 : (p->length_ - p->offset_);
     if (l_nb_bytes > 0) {
-      memcpy(p_buffer, p->buffer_, l_nb_bytes);
+      memcpy(p_buffer, static_cast<char*>(p->buffer_) + p->offset_,
+             l_nb_bytes);
     }
     p->offset_ += l_nb_bytes;
 
@@ -87,9 +88,24 @@ class OpjStreamCallback {
   static void OpjStreamFreeUserDataFn(void* p_user_data) {}
 };
 
+// Decodes a JPEG2000 image, optionally at a reduced resolution and only
+// within a region, in which case only the code blocks the region covers
+// are decoded, on `threads` threads of OpenJPEG.
 class DecodeJPEG2K : public OpKernel {
  public:
-  explicit DecodeJPEG2K(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit DecodeJPEG2K(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("reduce", &reduce_));
+    OP_REQUIRES(
+        context, reduce_ >= 0,
+        errors::InvalidArgument("reduce must be non-negative, got ", reduce_));
+    OP_REQUIRES_OK(context, context->GetAttr("threads", &threads_));
+    OP_REQUIRES(context, threads_ >= 0,
+                errors::InvalidArgument("threads must be non-negative, got ",
+                                        threads_));
+    if (threads_ == 0) {
+      threads_ = opj_get_num_cpus();
+    }
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& contents_tensor = context->input(0);
@@ -98,6 +114,14 @@ class DecodeJPEG2K : public OpKernel {
                                         contents_tensor.shape().DebugString()));
     auto contents = contents_tensor.scalar<tstring>()();
 
+    const Tensor& region_tensor = context->input(1);
+    OP_REQUIRES(context,
+                (region_tensor.NumElements() == 0 ||
+                 region_tensor.NumElements() == 4),
+                errors::InvalidArgument(
+                    "region must be empty or [y, x, height, width], received: ",
+                    region_tensor.shape().DebugString()));
+
     OPJ_CODEC_FORMAT format = OPJ_CODEC_JP2;
 
     std::unique_ptr<opj_image_t, void (*)(opj_image_t*)> l_image(
@@ -140,18 +164,20 @@ class DecodeJPEG2K : public OpKernel {
     opj_dparameters_t l_param;
     opj_set_default_decoder_parameters(&l_param);
 
-    // TODO: adjust additional parameter with:
-    // do not use layer decoding limitations
-    // l_param.cp_layer = 0;
-    // do not use resolutions reductions
-    // l_param.cp_reduce = 0;
-
     OPJ_BOOL status;
     status = opj_setup_decoder(l_codec.get(), &l_param);
     OP_REQUIRES(
         context, (status),
         errors::InvalidArgument("unable to setup decoder: ", msg.error_));
 
+    if (threads_ > 1) {
+      status = opj_codec_set_threads(l_codec.get(),
+                                   static_cast<int>(threads_));
+      OP_REQUIRES(context, (status),
+                  errors::InvalidArgument("unable to set ", threads_,
+                                          " threads: ", msg.error_));
+    }
+
     opj_image_t* p_image = nullptr;
     status = opj_read_header(l_stream.get(), l_codec.get(), &p_image);
     OP_REQUIRES(context, (status),
@@ -211,8 +237,6 @@ class DecodeJPEG2K : public OpKernel {
                                   p_image->comps[i].h, "x", p_image->comps[i].w,
                                   " vs. ", p_image->y1, "x", p_image->x1));
     }
-    int64 width = p_image->x1;
-    int64 height = p_image->y1;
     int64 channels = p_image->numcomps;
 
     long signed_offsets[4] = {0, 0, 0, 0};
@@ -222,11 +246,58 @@ class DecodeJPEG2K : public OpKernel {
       }
     }
 
+    if (reduce_ > 0) {
+      status = opj_set_decoded_resolution_factor(
+          l_codec.get(), static_cast<OPJ_UINT32>(reduce_));
+      OP_REQUIRES(context, (status),
+                  errors::InvalidArgument("unable to reduce resolution by ",
+                                          reduce_, ": ", msg.error_));
+    }
+
+    // The region is on the reference grid, at the full resolution.
+    if (region_tensor.NumElements() == 4) {
+      const int64 region_y = region_tensor.flat<int64>()(0);
+      const int64 region_x = region_tensor.flat<int64>()(1);
+      const int64 region_height = region_tensor.flat<int64>()(2);
+      const int64 region_width = region_tensor.flat<int64>()(3);
+      const int64 image_height = p_image->y1 - p_image->y0;
+      const int64 image_width = p_image->x1 - p_image->x0;
+      OP_REQUIRES(
+          context,
+          (region_y >= 0 && region_x >= 0 && region_height > 0 &&
+           region_width > 0 && region_y + region_height <= image_height &&
+           region_x + region_width <= image_width),
+          errors::InvalidArgument("region [", region_y, ", ", region_x, ", ",
+                                  region_height, ", ", region_width,
+                                  "] is out of range for image of ",
+                                  image_height, "x", image_width));
+      status = opj_set_decode_area(
+          l_codec.get(), p_image, p_image->x0 + region_x,
+          p_image->y0 + region_y, p_image->x0 + region_x + region_width,
+          p_image->y0 + region_y + region_height);
+      OP_REQUIRES(
+          context, (status),
+          errors::InvalidArgument("unable to set decode area: ", msg.error_));
+    }
+
     status = opj_decode(l_codec.get(), l_stream.get(), p_image);
     OP_REQUIRES(
         context, (status),
         errors::InvalidArgument("unable to decode_image: ", msg.error_));
 
+    // The components are reduced and cropped by the decode.
+    int64 width = p_image->comps[0].w;
+    int64 height = p_image->comps[0].h;
+    for (int i = 1; i < p_image->numcomps; i++) {
+      OP_REQUIRES(context,
+                  (p_image->comps[i].w == width) &&
+                      (p_image->comps[i].h == height),
+                  errors::InvalidArgument(
+                      "decoded channel (", i, ") does not match image: ",
+                      p_image->comps[i].h, "x", p_image->comps[i].w, " vs. ",
+                      height, "x", width));
+    }
+
     Tensor* image_tensor = nullptr;
     OP_REQUIRES_OK(
         context, context->allocate_output(
@@ -259,6 +330,9 @@ class DecodeJPEG2K : public OpKernel {
       }
     }
   }
+
+  int64 reduce_;
+  int64 threads_;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeJPEG2K").Device(DEVICE_CPU),
                         DecodeJPEG2K);
@@ -13,9 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "libyuv/convert.h"
 #include "libyuv/convert_argb.h"
+#include "libyuv/convert_from.h"
+#include "libyuv/scale.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
+#include "tensorflow_io/core/kernels/shard_cost.h"
 
 namespace tensorflow {
 namespace io {
@@ -64,6 +69,129 @@ class DecodeNV12Op : public OpKernel {
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeNV12").Device(DEVICE_CPU), DecodeNV12Op);
 
+// Decodes a batch of NV12 frames across the worker threads. Frames that are
+// resized are scaled in I420 before the conversion to RGB, so that no RGB
+// image of the full size is made.
+class DecodeNV12BatchOp : public OpKernel {
+ public:
+  explicit DecodeNV12BatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+
+    const Tensor* size_tensor;
+    OP_REQUIRES_OK(context, context->input("size", &size_tensor));
+
+    const Tensor* resize_tensor;
+    OP_REQUIRES_OK(context, context->input("resize", &resize_tensor));
+
+    int64 channels = 3;
+    int64 height = size_tensor->flat<int32>()(0);
+    int64 width = size_tensor->flat<int32>()(1);
+    int64 resize_height = resize_tensor->flat<int32>()(0);
+    int64 resize_width = resize_tensor->flat<int32>()(1);
+    OP_REQUIRES(context,
+                (height > 0 && width > 0 && resize_height > 0 &&
+                 resize_width > 0),
+                errors::InvalidArgument("invalid size [", height, ", ", width,
+                                        "] or resize [", resize_height, ", ",
+                                        resize_width, "]"));
+
+    const auto& input = input_tensor->flat<tstring>();
+    const int64 count = input.size();
+    const int64 uv_height = (height + 1) / 2;
+    for (int64 i = 0; i < count; i++) {
+      OP_REQUIRES(
+          context, (input(i).size() >= width * (height + uv_height)),
+          errors::InvalidArgument("nv12 frame ", i, " has ", input(i).size(),
+                                  " bytes, less than its size"));
+    }
+
+    Tensor* image_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0,
+                                TensorShape({count, resize_height,
+                                             resize_width, channels}),
+                                &image_tensor));
+    uint8* base = image_tensor->flat<uint8>().data();
+    const int64 datasize = resize_height * resize_width * channels;
+    const bool resize = (resize_height != height || resize_width != width);
+
+    mutex status_mu;
+    Status status;
+    auto decode = [&](int64 start, int64 limit) {
+      // Planes of the frame and of the resized frame, reused across frames.
+      const int64 half_width = (width + 1) / 2;
+      const int64 resize_half_width = (resize_width + 1) / 2;
+      const int64 resize_half_height = (resize_height + 1) / 2;
+      std::vector<uint8> planes;
+      uint8 *u = nullptr, *v = nullptr;
+      uint8 *resize_y = nullptr, *resize_u = nullptr, *resize_v = nullptr;
+      if (resize) {
+        planes.resize(width * height + 2 * half_width * uv_height +
+                      resize_width * resize_height +
+                      2 * resize_half_width * resize_half_height);
+        u = planes.data() + width * height;
+        v = u + half_width * uv_height;
+        resize_y = v + half_width * uv_height;
+        resize_u = resize_y + resize_width * resize_height;
+        resize_v = resize_u + resize_half_width * resize_half_height;
+      }
+      for (int64 i = start; i < limit; i++) {
+        const uint8* y = (const uint8*)input(i).data();
+        const uint8* uv = y + width * height;
+        uint8* rgb = base + i * datasize;
+        int ret;
+        if (!resize) {
+          ret = libyuv::NV12ToRAW(y, width, uv, width, rgb, width * 3, width,
+                                  height);
+        } else {
+          ret = libyuv::NV12ToI420(y, width, uv, width, planes.data(), width,
+                                   u, half_width, v, half_width, width, height);
+          if (ret == 0) {
+            ret = libyuv::I420Scale(planes.data(), width, u, half_width, v,
+                                    half_width, width, height, resize_y,
+                                    resize_width, resize_u, resize_half_width,
+                                    resize_v, resize_half_width, resize_width,
+                                    resize_height, libyuv::kFilterBilinear);
+          }
+          if (ret == 0) {
+            ret = libyuv::I420ToRAW(resize_y, resize_width, resize_u,
+                                    resize_half_width, resize_v,
+                                    resize_half_width, rgb, resize_width * 3,
+                                    resize_width, resize_height);
+          }
+        }
+        if (ret != 0) {
+          mutex_lock l(status_mu);
+          status.Update(errors::InvalidArgument(
+              "unable to convert nv12 frame ", i, " to rgb: ", ret));
+          return;
+        }
+      }
+    };
+    // A frame is converted in a single pass over its pixels, or resized with
+    // one more conversion and the scale over the resized pixels.
+    const int64 cost =
+        (width * height + (resize ? 2 * resize_width * resize_height : 0)) *
+        kCostPerConvertedPixel;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, count, cost,
+          decode);
+    OP_REQUIRES_OK(context, status);
+  }
+
+ private:
+  mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeNV12Batch").Device(DEVICE_CPU),
+                        DecodeNV12BatchOp);
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
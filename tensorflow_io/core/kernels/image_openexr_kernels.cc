@@ -16,6 +16,7 @@ limitations under the License.
 #include <ImfChannelList.h>
 #include <ImfInputPart.h>
 #include <ImfMultiPartInputFile.h>
+#include <ImfThreading.h>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
@@ -155,10 +156,32 @@ class DecodeEXRInfoOp : public OpKernel {
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
 };
+// Decodes channels of a part of an EXR image, for the rows in
+// [start, start + count) of its data window. The channels are converted to
+// dtype by OpenEXR while the lines are decompressed, and the line buffers
+// are decompressed in parallel on at most `threads` threads.
 class DecodeEXROp : public OpKernel {
  public:
   explicit DecodeEXROp(OpKernelConstruction* context) : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+    OP_REQUIRES_OK(context, context->GetAttr("start", &start_));
+    OP_REQUIRES_OK(context, context->GetAttr("count", &count_));
+    OP_REQUIRES_OK(context, context->GetAttr("threads", &threads_));
+    OP_REQUIRES(context, (start_ >= 0 && count_ >= -1 && threads_ >= 0),
+                errors::InvalidArgument(
+                    "start and threads must be non-negative and count must be "
+                    "non-negative or -1, got ",
+                    start_, ", ", threads_, " and ", count_));
+    // The line buffers of all files are decompressed by the global thread
+    // pool of OpenEXR, which is grown to the largest count asked for.
+    if (threads_ > 0) {
+      static mutex* mu = new mutex();
+      mutex_lock l(*mu);
+      if (Imf::globalThreadCount() < threads_) {
+        Imf::setGlobalThreadCount(threads_);
+      }
+    }
   }
 
   void Compute(OpKernelContext* context) override {
@@ -170,6 +193,10 @@ class DecodeEXROp : public OpKernel {
 
     const Tensor* channel_tensor;
     OP_REQUIRES_OK(context, context->input("channel", &channel_tensor));
+    OP_REQUIRES(context, (channel_tensor->dims() <= 1),
+                errors::InvalidArgument(
+                    "channel must be a scalar or a list of channels, got ",
+                    channel_tensor->shape().DebugString()));
 
     const string filename = "memory";
     string memory = input_tensor->scalar<tstring>()();
@@ -179,10 +206,9 @@ class DecodeEXROp : public OpKernel {
     OP_REQUIRES_OK(context, file->GetFileSize(&size));
 
     OpenEXRIStream stream(filename, file.get(), size);
-    Imf::MultiPartInputFile input_file(stream);
+    Imf::MultiPartInputFile input_file(stream, static_cast<int>(threads_));
 
     const int64 index = index_tensor->scalar<int64>()();
-    string channel = channel_tensor->scalar<tstring>()();
 
     Imf::InputPart input_part(input_file, index);
 
@@ -191,72 +217,83 @@ class DecodeEXROp : public OpKernel {
     int64 height = dw.max.y - dw.min.y + 1;
     int64 width = dw.max.x - dw.min.x + 1;
 
-    DataType dtype = DT_INVALID;
-    Imf::PixelType pixel_type = Imf::UINT;
-    int x_sampling, y_sampling;
-    for (Imf::ChannelList::ConstIterator c =
-             input_part.header().channels().begin();
-         c != input_part.header().channels().end(); c++) {
-      if (channel == c.name()) {
-        pixel_type = c.channel().type;
-        x_sampling = c.channel().xSampling;
-        y_sampling = c.channel().ySampling;
-        switch (pixel_type) {
-          case Imf::UINT:
-            dtype = DT_UINT32;
-            break;
-          case Imf::HALF:
-            dtype = DT_HALF;
-            break;
-          case Imf::FLOAT:
-            dtype = DT_FLOAT;
-            break;
-          default:
-            OP_REQUIRES(
-                context, false,
-                errors::InvalidArgument("invalid pixel type: ", pixel_type));
-        }
-      }
-    }
-    OP_REQUIRES(context, (dtype != DT_INVALID),
-                errors::InvalidArgument("unable to find channel: ", channel));
-
-    Tensor* output_tensor = nullptr;
-    OP_REQUIRES_OK(context,
-                   context->allocate_output(0, TensorShape({height, width}),
-                                            &output_tensor));
+    OP_REQUIRES(context, (start_ <= height),
+                errors::InvalidArgument("start ", start_,
+                                        " is out of range for ", height,
+                                        " rows"));
+    const int64 rows = (count_ < 0 || start_ + count_ > height)
+                           ? height - start_
+                           : count_;
 
-    char* base;
+    Imf::PixelType pixel_type = Imf::UINT;
     size_t byte;
-    switch (dtype) {
+    switch (dtype_) {
       case DT_UINT32:
-        base = (char*)output_tensor->flat<uint32>().data();
+        pixel_type = Imf::UINT;
         byte = sizeof(uint32);
         break;
       case DT_HALF:
-        base = (char*)output_tensor->flat<Eigen::half>().data();
+        pixel_type = Imf::HALF;
         byte = sizeof(Eigen::half);
         break;
       case DT_FLOAT:
-        base = (char*)output_tensor->flat<float>().data();
+        pixel_type = Imf::FLOAT;
         byte = sizeof(float);
         break;
       default:
         OP_REQUIRES(context, false,
-                    errors::InvalidArgument("invalid data type: ", dtype));
+                    errors::InvalidArgument("invalid data type: ", dtype_));
     }
 
+    const int64 channels = channel_tensor->NumElements();
+    TensorShape shape({rows, width});
+    if (channel_tensor->dims() == 1) {
+      shape.AddDim(channels);
+    }
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, shape, &output_tensor));
+    if (rows == 0 || channels == 0) {
+      return;
+    }
+
+    // The channels are interleaved in the output, which holds the rows of
+    // the window only.
+    char* base = static_cast<char*>(output_tensor->data());
+    Imath::Box2i window(
+        Imath::V2i(dw.min.x, dw.min.y + static_cast<int>(start_)),
+        Imath::V2i(dw.max.x, dw.min.y + static_cast<int>(start_ + rows - 1)));
+    const size_t x_stride = byte * channels;
+    const size_t y_stride = x_stride * width;
+
     Imf::FrameBuffer frame_buffer;
-    frame_buffer.insert(channel, Imf::Slice::Make(pixel_type, base, dw, 0, 0,
-                                                  x_sampling, y_sampling));
+    for (int64 i = 0; i < channels; i++) {
+      const string channel = channel_tensor->flat<tstring>()(i);
+      const Imf::Channel* c =
+          input_part.header().channels().findChannel(channel);
+      OP_REQUIRES(context, (c != nullptr),
+                  errors::InvalidArgument("unable to find channel: ", channel));
+      OP_REQUIRES(
+          context, (channels == 1 || (c->xSampling == 1 && c->ySampling == 1)),
+          errors::InvalidArgument(
+              "channel ", channel,
+              " is subsampled and can only be decoded on its own"));
+      frame_buffer.insert(
+          channel, Imf::Slice::Make(pixel_type, base + i * byte, window,
+                                    x_stride, y_stride, c->xSampling,
+                                    c->ySampling));
+    }
 
     input_part.setFrameBuffer(frame_buffer);
-    input_part.readPixels(dw.min.y, dw.max.y);
+    input_part.readPixels(window.min.y, window.max.y);
   }
 
  private:
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  DataType dtype_;
+  int64 start_;
+  int64 count_;
+  int64 threads_;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeExrInfo").Device(DEVICE_CPU),
                         DecodeEXRInfoOp);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow_io/core/kernels/image_raster_kernels.h"
 
 namespace tensorflow {
 namespace io {
@@ -154,6 +155,236 @@ class DecodePNMOp : public OpKernel {
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodePnm").Device(DEVICE_CPU), DecodePNMOp);
 
+// Reads the whitespace separated tokens of a PNM file from an offset, one
+// chunk of the file at a time, skipping the comments.
+class PNMTokenReader {
+ public:
+  PNMTokenReader(data::SizedRandomAccessFile* file, const int64 offset)
+      : file_(file), offset_(offset) {}
+
+  // The offset just past the last token read.
+  int64 Tell() const { return offset_ + pos_; }
+
+  Status Next(string* token) {
+    token->clear();
+    bool comment = false;
+    char c;
+    while (true) {
+      Status status = Peek(&c);
+      if (errors::IsOutOfRange(status)) {
+        return errors::InvalidArgument("not enough value");
+      }
+      TF_RETURN_IF_ERROR(status);
+      if (comment) {
+        comment = (c != '\n');
+      } else if (c == '#') {
+        comment = true;
+      } else if (!isspace(c)) {
+        break;
+      }
+      pos_++;
+    }
+    while (true) {
+      Status status = Peek(&c);
+      if (errors::IsOutOfRange(status)) {
+        break;
+      }
+      TF_RETURN_IF_ERROR(status);
+      if (isspace(c) || c == '#') {
+        break;
+      }
+      token->push_back(c);
+      pos_++;
+    }
+    return OkStatus();
+  }
+
+ private:
+  Status Peek(char* c) {
+    if (pos_ == chunk_.size()) {
+      offset_ += chunk_.size();
+      pos_ = 0;
+      string scratch(kChunkSize, '\0');
+      StringPiece result;
+      Status status = file_->Read(offset_, kChunkSize, &result, &scratch[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      chunk_.assign(result.data(), result.size());
+      if (chunk_.empty()) {
+        return errors::OutOfRange("EOF reached");
+      }
+    }
+    *c = chunk_[pos_];
+    return OkStatus();
+  }
+
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  data::SizedRandomAccessFile* file_;
+  int64 offset_;
+  string chunk_;
+  size_t pos_ = 0;
+};
+
+// Reads the rows of a PNM file, as uint8 with a max value up to 255 and as
+// uint16 otherwise. The rows of binary files are at fixed offsets, while
+// those of ASCII files are found by parsing the rows before them, and the
+// offsets found are kept so that no row is parsed twice to be reached.
+class PNMRasterReadableResource : public RasterReadableResourceBase {
+ public:
+  PNMRasterReadableResource(Env* env) : env_(env) {}
+  ~PNMRasterReadableResource() {}
+
+  Status Init(const string& filename, const void* optional_memory,
+              const size_t optional_length) override {
+    mutex_lock l(mu_);
+    file_.reset(new data::SizedRandomAccessFile(
+        env_, filename, optional_memory, optional_length));
+    TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
+
+    PNMTokenReader reader(file_.get(), 0);
+    string magic;
+    TF_RETURN_IF_ERROR(reader.Next(&magic));
+    if (!(magic == "P2" || magic == "P3" || magic == "P5" || magic == "P6")) {
+      return errors::InvalidArgument("invalid format: ", magic);
+    }
+    ascii_ = (magic == "P2" || magic == "P3");
+    const int64 channels = (magic == "P2" || magic == "P5") ? 1 : 3;
+
+    // width, height, max
+    const char* names[] = {"width", "height", "max"};
+    int64 values[3];
+    for (int64 i = 0; i < 3; i++) {
+      string token;
+      TF_RETURN_IF_ERROR(reader.Next(&token));
+      if (!strings::safe_strto64(token, &values[i])) {
+        return errors::InvalidArgument("unable to parse ", names[i], ": ",
+                                       token);
+      }
+    }
+    if (values[0] <= 0 || values[1] <= 0) {
+      return errors::InvalidArgument("invalid shape: (", values[1], ", ",
+                                     values[0], ")");
+    }
+    if (values[2] <= 0 || values[2] > 65535) {
+      return errors::InvalidArgument("invalid max value: ", values[2]);
+    }
+    dtype_ = (values[2] > 255) ? DT_UINT16 : DT_UINT8;
+    shape_ = TensorShape({values[1], values[0], channels});
+
+    // A single whitespace separates the header from the rows of binary
+    // files.
+    row_offsets_ = {reader.Tell() + (ascii_ ? 0 : 1)};
+    if (!ascii_) {
+      const int64 row_size = values[0] * channels * DataTypeSize(dtype_);
+      if (row_offsets_[0] + row_size * values[1] >
+          static_cast<int64>(file_size_)) {
+        return errors::InvalidArgument("not enough data");
+      }
+    }
+    return OkStatus();
+  }
+  Status Spec(TensorShape* shape, DataType* dtype) override {
+    mutex_lock l(mu_);
+    *shape = shape_;
+    *dtype = dtype_;
+    return OkStatus();
+  }
+  Status Read(const int64 start, const int64 stop,
+              std::function<Status(const TensorShape& shape, Tensor** value)>
+                  allocate_func) override {
+    mutex_lock l(mu_);
+    int64 row_start, row_stop;
+    RasterRowsLookup(shape_.dim_size(0), start, stop, &row_start, &row_stop);
+    Tensor* value;
+    TF_RETURN_IF_ERROR(allocate_func(
+        TensorShape({row_stop - row_start, shape_.dim_size(1),
+                     shape_.dim_size(2)}),
+        &value));
+    if (row_start == row_stop) {
+      return OkStatus();
+    }
+    const int64 row_values = shape_.dim_size(1) * shape_.dim_size(2);
+
+    if (!ascii_) {
+      const int64 row_size = row_values * DataTypeSize(dtype_);
+      char* data = (dtype_ == DT_UINT8)
+                       ? reinterpret_cast<char*>(value->flat<uint8>().data())
+                       : reinterpret_cast<char*>(value->flat<uint16>().data());
+      const int64 length = (row_stop - row_start) * row_size;
+      StringPiece result;
+      TF_RETURN_IF_ERROR(file_->Read(row_offsets_[0] + row_start * row_size,
+                                     length, &result, data));
+      if (static_cast<int64>(result.size()) != length) {
+        return errors::InvalidArgument("not enough data");
+      }
+      if (dtype_ == DT_UINT16) {
+        // network order so switch
+        const uint8* bytes = reinterpret_cast<const uint8*>(data);
+        uint16* samples = value->flat<uint16>().data();
+        for (int64 i = 0; i < value->NumElements(); i++) {
+          samples[i] = static_cast<uint16>((bytes[i * 2] << 8) |
+                                           bytes[i * 2 + 1]);
+        }
+      }
+      return OkStatus();
+    }
+
+    int64 row =
+        std::min<int64>(row_start, static_cast<int64>(row_offsets_.size()) - 1);
+    PNMTokenReader reader(file_.get(), row_offsets_[row]);
+    string token;
+    for (; row < row_stop; row++) {
+      for (int64 i = 0; i < row_values; i++) {
+        TF_RETURN_IF_ERROR(reader.Next(&token));
+        int32 v;
+        if (!strings::safe_strto32(token, &v)) {
+          return errors::InvalidArgument("unable to parse value: ", token);
+        }
+        if (row < row_start) {
+          continue;
+        }
+        const int64 index = (row - row_start) * row_values + i;
+        if (dtype_ == DT_UINT8) {
+          value->flat<uint8>()(index) = static_cast<uint8>(v);
+        } else {
+          value->flat<uint16>()(index) = static_cast<uint16>(v);
+        }
+      }
+      if (row + 1 == static_cast<int64>(row_offsets_.size())) {
+        row_offsets_.push_back(reader.Tell());
+      }
+    }
+    return OkStatus();
+  }
+  string DebugString() const override { return "PNMRasterReadableResource"; }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<data::SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
+  uint64 file_size_ TF_GUARDED_BY(mu_);
+  DataType dtype_;
+  TensorShape shape_;
+  bool ascii_;
+  // The offsets of the rows 0, 1, 2, ... of those found so far.
+  std::vector<int64> row_offsets_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
+
+Status PNMRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource) {
+  resource.reset(new PNMRasterReadableResource(env));
+  Status status = resource->Init(filename, optional_memory, optional_length);
+  if (!status.ok()) {
+    resource.reset(nullptr);
+  }
+  return status;
+}
+
 }  // namespace io
 }  // namespace tensorflow
@@ -0,0 +1,183 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow_io/core/kernels/image_raster_kernels.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+class RasterReadableResource : public RasterReadableResourceBase {
+ public:
+  RasterReadableResource(Env* env) : env_(env), resource_(nullptr) {}
+  ~RasterReadableResource() {}
+
+  Status Init(const string& filename, const void* optional_memory,
+              const size_t optional_length) override {
+    mutex_lock l(mu_);
+    std::unique_ptr<data::SizedRandomAccessFile> file(
+        new data::SizedRandomAccessFile(env_, filename, optional_memory,
+                                        optional_length));
+    uint64 file_size;
+    TF_RETURN_IF_ERROR(file->GetFileSize(&file_size));
+    char header[10] = {0};
+    StringPiece result;
+    Status status = file->Read(0, sizeof(header), &result, header);
+    if (!(status.ok() || errors::IsOutOfRange(status))) {
+      return status;
+    }
+    if (result.size() >= 2 && header[0] == 'P' &&
+        (header[1] == '2' || header[1] == '3' || header[1] == '5' ||
+         header[1] == '6')) {
+      return PNMRasterReadableResourceInit(env_, filename, optional_memory,
+                                           optional_length, resource_);
+    } else if (result.size() >= 2 && memcmp(header, "BM", 2) == 0) {
+      return BMPRasterReadableResourceInit(env_, filename, optional_memory,
+                                           optional_length, resource_);
+    } else if ((result.size() >= 10 && memcmp(header, "#?RADIANCE", 10) == 0) ||
+               (result.size() >= 6 && memcmp(header, "#?RGBE", 6) == 0)) {
+      return HDRRasterReadableResourceInit(env_, filename, optional_memory,
+                                           optional_length, resource_);
+    }
+    return errors::InvalidArgument("unknown file type: ", filename);
+  }
+  Status Spec(TensorShape* shape, DataType* dtype) override {
+    mutex_lock l(mu_);
+    return resource_->Spec(shape, dtype);
+  }
+  Status Read(const int64 start, const int64 stop,
+              std::function<Status(const TensorShape& shape, Tensor** value)>
+                  allocate_func) override {
+    mutex_lock l(mu_);
+    return resource_->Read(start, stop, allocate_func);
+  }
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return resource_->DebugString();
+  }
+
+ protected:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<RasterReadableResourceBase> resource_ TF_GUARDED_BY(mu_);
+};
+
+class RasterReadableInitOp : public ResourceOpKernel<RasterReadableResource> {
+ public:
+  explicit RasterReadableInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<RasterReadableResource>(context) {
+    env_ = context->env();
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<RasterReadableResource>::Compute(context);
+
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+
+    OP_REQUIRES_OK(context, resource_->Init(input_tensor->scalar<tstring>()(),
+                                            nullptr, 0));
+  }
+  Status CreateResource(RasterReadableResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new RasterReadableResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class RasterReadableSpecOp : public OpKernel {
+ public:
+  explicit RasterReadableSpecOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    RasterReadableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    TensorShape shape;
+    DataType dtype;
+    OP_REQUIRES_OK(context, resource->Spec(&shape, &dtype));
+
+    Tensor* shape_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context, context->allocate_output(0, TensorShape({3}), &shape_tensor));
+    for (int64 i = 0; i < 3; i++) {
+      shape_tensor->flat<int64>()(i) = shape.dim_size(i);
+    }
+
+    Tensor* dtype_tensor = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, TensorShape({}), &dtype_tensor));
+    dtype_tensor->scalar<int64>()() = dtype;
+  }
+};
+
+class RasterReadableReadOp : public OpKernel {
+ public:
+  explicit RasterReadableReadOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    RasterReadableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    const int64 start = start_tensor->scalar<int64>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    const int64 stop = stop_tensor->scalar<int64>()();
+
+    TensorShape shape;
+    DataType dtype;
+    OP_REQUIRES_OK(context, resource->Spec(&shape, &dtype));
+    OP_REQUIRES(context, (dtype == context->expected_output_dtype(0)),
+                errors::InvalidArgument(
+                    "dtype mismatch: ", DataTypeString(dtype), " vs. ",
+                    DataTypeString(context->expected_output_dtype(0))));
+
+    OP_REQUIRES_OK(
+        context,
+        resource->Read(start, stop,
+                       [&](const TensorShape& shape, Tensor** value) -> Status {
+                         TF_RETURN_IF_ERROR(
+                             context->allocate_output(0, shape, value));
+                         return OkStatus();
+                       }));
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("IO>RasterReadableInit").Device(DEVICE_CPU),
+                        RasterReadableInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>RasterReadableSpec").Device(DEVICE_CPU),
+                        RasterReadableSpecOp);
+REGISTER_KERNEL_BUILDER(Name("IO>RasterReadableRead").Device(DEVICE_CPU),
+                        RasterReadableReadOp);
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,66 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_IMAGE_RASTER_KERNELS_H_
+#define TENSORFLOW_IO_CORE_KERNELS_IMAGE_RASTER_KERNELS_H_
+
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow_io/core/kernels/io_stream.h"
+
+namespace tensorflow {
+namespace io {
+
+// An uncompressed or scanline compressed image of [height, width, channels],
+// read in bands of rows straight from its file, so that the memory used is
+// that of the band and not of the whole image.
+class RasterReadableResourceBase : public ResourceBase {
+ public:
+  virtual Status Init(const string& filename,
+                      const void* optional_memory = nullptr,
+                      size_t optional_length = 0) = 0;
+  // Reads the rows [start, stop), with stop < 0 for the rows to the end.
+  virtual Status Read(
+      const int64 start, const int64 stop,
+      std::function<Status(const TensorShape& shape, Tensor** value)>
+          allocate_func) = 0;
+  virtual Status Spec(TensorShape* shape, DataType* dtype) = 0;
+};
+
+// Clips the rows [start, stop) to those of an image of `height` rows.
+inline void RasterRowsLookup(const int64 height, const int64 start,
+                             const int64 stop, int64* row_start,
+                             int64* row_stop) {
+  *row_stop = (stop < 0 || stop > height) ? height : stop;
+  *row_start = std::min(std::max<int64>(start, 0), *row_stop);
+}
+
+Status PNMRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource);
+Status BMPRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource);
+Status HDRRasterReadableResourceInit(
+    Env* env, const string& filename, const void* optional_memory,
+    const size_t optional_length,
+    std::unique_ptr<RasterReadableResourceBase>& resource);
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_IMAGE_RASTER_KERNELS_H_
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "geotiff.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 // Repackge XTIFFStreamOpen from TIFFStreamOpen in libtiff/tif_stream.cxx
 extern "C" {
@@ -444,9 +445,220 @@ class DecodeTIFFOp : public OpKernel {
   // TODO (yongtang): Set channels_ = 4 for now.
   static const int channels_ = 4;
 };
+// A TIFF read through a RandomAccessFile, so that only the directories and
+// the tiles or strips decoded are read instead of the whole file.
+struct TIFFFile {
+  RandomAccessFile* file;
+  uint64 size;
+  uint64 offset;
+};
+
+tmsize_t TIFFFileReadProc(thandle_t fd, void* buf, tmsize_t size) {
+  TIFFFile* p = reinterpret_cast<TIFFFile*>(fd);
+  StringPiece result;
+  Status status = p->file->Read(p->offset, size, &result, (char*)buf);
+  if (!status.ok() && !errors::IsOutOfRange(status)) {
+    return static_cast<tmsize_t>(-1);
+  }
+  if (result.data() != buf) {
+    memmove(buf, result.data(), result.size());
+  }
+  p->offset += result.size();
+  return static_cast<tmsize_t>(result.size());
+}
+tmsize_t TIFFFileWriteProc(thandle_t, void*, tmsize_t) { return 0; }
+uint64 TIFFFileSeekProc(thandle_t fd, uint64 off, int whence) {
+  TIFFFile* p = reinterpret_cast<TIFFFile*>(fd);
+  switch (whence) {
+    case SEEK_SET:
+      p->offset = off;
+      break;
+    case SEEK_CUR:
+      p->offset += off;
+      break;
+    case SEEK_END:
+      p->offset = p->size + off;
+      break;
+  }
+  return p->offset;
+}
+int TIFFFileCloseProc(thandle_t) { return 0; }
+uint64 TIFFFileSizeProc(thandle_t fd) {
+  return reinterpret_cast<TIFFFile*>(fd)->size;
+}
+
+// Opens directory `index` of `tiff_file`, which must outlive `tiff`.
+Status OpenTIFFDirectory(TIFFFile* tiff_file, const int64 index,
+                         std::unique_ptr<TIFF, void (*)(TIFF*)>* tiff) {
+  tiff->reset(XTIFFClientOpen(
+      "file", "rm", reinterpret_cast<thandle_t>(tiff_file), TIFFFileReadProc,
+      TIFFFileWriteProc, TIFFFileSeekProc, TIFFFileCloseProc,
+      TIFFFileSizeProc, _tiffDummyMapProc, _tiffDummyUnmapProc));
+  if (tiff->get() == nullptr) {
+    return errors::InvalidArgument("unable to open TIFF file");
+  }
+  if (!TIFFSetDirectory(tiff->get(), index)) {
+    return errors::InvalidArgument("unable to set TIFF directory to ", index);
+  }
+  return OkStatus();
+}
+
+// Decodes the region of a directory of a TIFF file, such as one level of the
+// pyramid of a whole slide image, reading and decoding only the tiles or
+// strips the region intersects, in parallel.
+class DecodeTIFFRegionOp : public OpKernel {
+ public:
+  explicit DecodeTIFFRegionOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* filename_tensor;
+    OP_REQUIRES_OK(context, context->input("filename", &filename_tensor));
+    const string& filename = filename_tensor->scalar<tstring>()();
+
+    const Tensor* index_tensor;
+    OP_REQUIRES_OK(context, context->input("index", &index_tensor));
+    const int64 index = index_tensor->scalar<int64>()();
+
+    const Tensor* region_tensor;
+    OP_REQUIRES_OK(context, context->input("region", &region_tensor));
+    OP_REQUIRES(context, (region_tensor->NumElements() == 4),
+                errors::InvalidArgument(
+                    "region must be [y, x, height, width], received: ",
+                    region_tensor->shape().DebugString()));
+    const int64 region_y = region_tensor->flat<int64>()(0);
+    const int64 region_x = region_tensor->flat<int64>()(1);
+    const int64 region_height = region_tensor->flat<int64>()(2);
+    const int64 region_width = region_tensor->flat<int64>()(3);
+
+    std::unique_ptr<RandomAccessFile> file;
+    OP_REQUIRES_OK(context, env_->NewRandomAccessFile(filename, &file));
+    uint64 size;
+    OP_REQUIRES_OK(context, env_->GetFileSize(filename, &size));
+
+    TIFFFile tiff_file{file.get(), size, 0};
+    std::unique_ptr<TIFF, void (*)(TIFF*)> tiff(nullptr, [](TIFF* p) {
+      if (p != nullptr) {
+        XTIFFClose(p);
+      }
+    });
+    OP_REQUIRES_OK(context, OpenTIFFDirectory(&tiff_file, index, &tiff));
+
+    uint32 height, width;
+    TIFFGetField(tiff.get(), TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetField(tiff.get(), TIFFTAG_IMAGEWIDTH, &width);
+    OP_REQUIRES(
+        context,
+        (region_y >= 0 && region_x >= 0 && region_height >= 0 &&
+         region_width >= 0 && region_y + region_height <= height &&
+         region_x + region_width <= width),
+        errors::InvalidArgument("region [", region_y, ", ", region_x, ", ",
+                                region_height, ", ", region_width,
+                                "] is out of the image of ", height, "x",
+                                width));
+
+    // Strips are taken as tiles of the width of the image.
+    const bool tiled = TIFFIsTiled(tiff.get());
+    uint32 tile_height = height, tile_width = width;
+    if (tiled) {
+      TIFFGetField(tiff.get(), TIFFTAG_TILELENGTH, &tile_height);
+      TIFFGetField(tiff.get(), TIFFTAG_TILEWIDTH, &tile_width);
+    } else {
+      TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_ROWSPERSTRIP, &tile_height);
+      tile_height = std::min(tile_height, height);
+    }
+    OP_REQUIRES(context, (tile_height > 0 && tile_width > 0),
+                errors::InvalidArgument("invalid tile size ", tile_height,
+                                        "x", tile_width));
+
+    Tensor* image_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0,
+                                TensorShape({region_height, region_width,
+                                             channels_}),
+                                &image_tensor));
+    if (region_height == 0 || region_width == 0) {
+      return;
+    }
+    uint32* image =
+        reinterpret_cast<uint32*>(image_tensor->flat<uint8>().data());
+
+    std::vector<std::pair<uint32, uint32>> tiles;
+    for (int64 y = region_y / tile_height * tile_height;
+         y < region_y + region_height; y += tile_height) {
+      for (int64 x = region_x / tile_width * tile_width;
+           x < region_x + region_width; x += tile_width) {
+        tiles.emplace_back(y, x);
+      }
+    }
+
+    mutex status_mu;
+    Status status;
+    auto decode = [&](int64 start, int64 limit) {
+      // TIFF handles are not thread safe, so each shard opens its own.
+      TIFFFile shard_file{file.get(), size, 0};
+      std::unique_ptr<TIFF, void (*)(TIFF*)> shard(nullptr, [](TIFF* p) {
+        if (p != nullptr) {
+          XTIFFClose(p);
+        }
+      });
+      Status s = OpenTIFFDirectory(&shard_file, index, &shard);
+      std::vector<uint32> raster(static_cast<size_t>(tile_width) *
+                                 tile_height);
+      for (int64 i = start; i < limit && s.ok(); i++) {
+        const uint32 y = tiles[i].first;
+        const uint32 x = tiles[i].second;
+        int ok = tiled ? TIFFReadRGBATile(shard.get(), x, y, raster.data())
+                       : TIFFReadRGBAStrip(shard.get(), y, raster.data());
+        if (!ok) {
+          s = errors::InvalidArgument("unable to read tile at ", y, ", ", x);
+          break;
+        }
+        // The raster is bottom up, of the rows read: all of a tile, however
+        // many are in the image, or only those of a strip.
+        const int64 rows = tiled ? tile_height
+                                 : std::min<int64>(tile_height, height - y);
+        const int64 row_start = std::max<int64>(y, region_y);
+        const int64 row_stop = std::min<int64>(
+            {y + static_cast<int64>(tile_height), region_y + region_height,
+             static_cast<int64>(height)});
+        const int64 col_start = std::max<int64>(x, region_x);
+        const int64 col_stop = std::min<int64>(
+            x + static_cast<int64>(tile_width), region_x + region_width);
+        for (int64 row = row_start; row < row_stop; row++) {
+          memcpy(image + (row - region_y) * region_width +
+                     (col_start - region_x),
+                 raster.data() + (rows - 1 - (row - y)) * tile_width +
+                     (col_start - x),
+                 (col_stop - col_start) * sizeof(uint32));
+        }
+      }
+      if (!s.ok()) {
+        mutex_lock l(status_mu);
+        status.Update(s);
+      }
+    };
+    // Each unit of work is one tile, so the cost keeps them on their own
+    // threads.
+    static constexpr int64 kCostPerTile = 1 << 20;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, tiles.size(),
+          kCostPerTile, decode);
+    OP_REQUIRES_OK(context, status);
+  }
+
+ private:
+  static const int channels_ = 4;
+  Env* env_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiffInfo").Device(DEVICE_CPU),
                         DecodeTIFFInfoOp);
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiff").Device(DEVICE_CPU), DecodeTIFFOp);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiffRegion").Device(DEVICE_CPU),
+                        DecodeTIFFRegionOp);
 
 }  // namespace
 }  // namespace data
@@ -24,9 +24,26 @@ namespace tensorflow {
 namespace io {
 namespace {
 
+// Decodes a WebP image, cropped to `crop` ([y, x, height, width]) and then
+// scaled to `size` ([height, width]) by the decoder itself when given, so
+// that the full image is never produced.
 class DecodeWebPOp : public OpKernel {
  public:
-  explicit DecodeWebPOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit DecodeWebPOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("size", &size_));
+    OP_REQUIRES(context,
+                (size_.empty() ||
+                 (size_.size() == 2 && size_[0] > 0 && size_[1] > 0)),
+                errors::InvalidArgument(
+                    "size must be empty or a positive [height, width]"));
+    OP_REQUIRES_OK(context, context->GetAttr("crop", &crop_));
+    OP_REQUIRES(context,
+                (crop_.empty() ||
+                 (crop_.size() == 4 && crop_[0] >= 0 && crop_[1] >= 0 &&
+                  crop_[2] > 0 && crop_[3] > 0)),
+                errors::InvalidArgument(
+                    "crop must be empty or [y, x, height, width]"));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& contents_tensor = context->input(0);
@@ -47,6 +64,30 @@ class DecodeWebPOp : public OpKernel {
     int height = config.input.height;
     int width = config.input.width;
 
+    if (!crop_.empty()) {
+      OP_REQUIRES(context,
+                  (crop_[0] + crop_[2] <= height &&
+                   crop_[1] + crop_[3] <= width),
+                  errors::InvalidArgument(
+                      "crop [", crop_[0], ", ", crop_[1], ", ", crop_[2], ", ",
+                      crop_[3], "] is out of range for image of ", height, "x",
+                      width));
+      config.options.use_cropping = 1;
+      config.options.crop_top = crop_[0];
+      config.options.crop_left = crop_[1];
+      config.options.crop_height = crop_[2];
+      config.options.crop_width = crop_[3];
+      height = crop_[2];
+      width = crop_[3];
+    }
+    if (!size_.empty()) {
+      config.options.use_scaling = 1;
+      config.options.scaled_height = size_[0];
+      config.options.scaled_width = size_[1];
+      height = size_[0];
+      width = size_[1];
+    }
+
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(
                                 0, TensorShape({height, width, channels_}),
@@ -68,6 +109,9 @@ class DecodeWebPOp : public OpKernel {
  private:
   // TODO (yongtang): Set channels_ = 4 for now.
   static const int channels_ = 4;
+
+  std::vector<int32> size_;
+  std::vector<int32> crop_;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeWebP").Device(DEVICE_CPU), DecodeWebPOp);
 
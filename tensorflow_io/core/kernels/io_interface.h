@@ -13,9 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#ifndef TENSORFLOW_IO_CORE_KERNELS_IO_INTERFACE_H_
+#define TENSORFLOW_IO_CORE_KERNELS_IO_INTERFACE_H_
+
+#include <deque>
+#include <unordered_map>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/util/batch_util.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow_io/core/kernels/io_shared_memory.h"
 
 namespace tensorflow {
 namespace data {
@@ -48,12 +59,249 @@ class IOInterface : public ResourceBase {
   }
 };
 
+// Returns the shape of the value or label tensor to read the records
+// [start, stop) of a component of `shape` into. The first dimension of
+// `shape`, once known, is the number of records, which bounds the records
+// that can be read.
+inline TensorShape IOReadableReadShape(const PartialTensorShape& shape,
+                                       const int64 start, const int64 stop) {
+  gtl::InlinedVector<int64, 4> dims = shape.dim_sizes();
+  int64 records = stop - start;
+  if (dims[0] >= 0) {
+    records = std::min(stop, dims[0]) - start;
+  }
+  dims[0] = std::max<int64>(records, 0);
+  return TensorShape(dims);
+}
+
 class IOReadableInterface : public IOInterface {
  public:
   // Check value==nullptr or label==nullptr to see which field is needed.
   virtual Status Read(const int64 start, const int64 stop,
                       const string& component, int64* record_read,
                       Tensor* value, Tensor* label) = 0;
+  // Reads the values of several components over the same [start, stop),
+  // into value tensors allocated for stop - start records. Formats that
+  // decode whole records override this to fill every component in one pass
+  // over the records; by default each component is read on its own.
+  virtual Status ReadComponents(const int64 start, const int64 stop,
+                                const std::vector<string>& components,
+                                int64* record_read,
+                                const std::vector<Tensor*>& values) {
+    *record_read = stop - start;
+    for (size_t i = 0; i < components.size(); i++) {
+      int64 component_read = 0;
+      TF_RETURN_IF_ERROR(Read(start, stop, components[i], &component_read,
+                              values[i], nullptr));
+      *record_read = std::min(*record_read, component_read);
+    }
+    return OkStatus();
+  }
+};
+
+// Wraps an IOReadableInterface with a cache of the recent reads of each
+// component. Once a component is read in consecutive slices, the slice that
+// follows, of the same size, is read ahead on a background thread, so that
+// the datasets slicing the readable overlap its reads with their consumers.
+// The wrapper is registered in place of `Type` for all the ops of a format.
+// Reads of a file are also shared with the other processes of the host
+// through IOSharedMemoryCache, when it is enabled.
+template <typename Type>
+class IOReadableReadAhead : public Type {
+ public:
+  explicit IOReadableReadAhead(Env* env) : Type(env), env_(env) {}
+  ~IOReadableReadAhead() {
+    {
+      mutex_lock l(cache_mu_);
+      stop_ = true;
+      cache_cv_.notify_all();
+    }
+    // Joins the read thread, which may still be in Type::Read.
+    thread_.reset();
+  }
+
+  Status Init(const std::vector<string>& input,
+              const std::vector<string>& metadata, const void* memory_data,
+              const int64 memory_size) override {
+    {
+      mutex_lock l(cache_mu_);
+      caches_.clear();
+    }
+    shared_ = false;
+    FileStatistics stat;
+    if (IOSharedMemoryCache::Enabled() && memory_data == nullptr &&
+        input.size() == 1 && env_->Stat(input[0], &stat).ok()) {
+      shared_ = true;
+      shared_filename_ = input[0];
+      shared_mtime_nsec_ = stat.mtime_nsec;
+    }
+    return Type::Init(input, metadata, memory_data, memory_size);
+  }
+
+  Status Read(const int64 start, const int64 stop, const string& component,
+              int64* record_read, Tensor* value, Tensor* label) override {
+    std::shared_ptr<Entry> entry;
+    {
+      mutex_lock l(cache_mu_);
+      for (const std::shared_ptr<Entry>& e : caches_[component].entries) {
+        if (e->Matches(start, stop, value != nullptr, label != nullptr)) {
+          entry = e;
+        }
+      }
+    }
+    if (entry != nullptr) {
+      entry->done.WaitForNotification();
+      // A failed read ahead is retried, as the error may not be one of this
+      // read, such as one for a slice past the end of the data.
+      if (!entry->status.ok()) entry.reset();
+    }
+    if (entry == nullptr) {
+      entry.reset(new Entry{start, stop, value != nullptr, label != nullptr});
+      entry->status = ReadShared(start, stop, component, &entry->record_read,
+                                 value, label);
+      if (value != nullptr) entry->value = *value;
+      if (label != nullptr) entry->label = *label;
+      entry->done.Notify();
+    }
+    TF_RETURN_IF_ERROR(entry->status);
+    *record_read = entry->record_read;
+    // The cached tensors share their buffers with the outputs, which keeps
+    // those from being forwarded and written to in place.
+    if (value != nullptr) *value = entry->value;
+    if (label != nullptr) *label = entry->label;
+
+    mutex_lock l(cache_mu_);
+    Cache& cache = caches_[component];
+    Insert(&cache, entry);
+    const bool sequential = (start == cache.stop);
+    cache.stop = stop;
+    if (!sequential || *record_read < stop - start || stop <= start) {
+      return OkStatus();
+    }
+    std::shared_ptr<Entry> next(new Entry{stop, 2 * stop - start,
+                                          value != nullptr, label != nullptr});
+    for (const std::shared_ptr<Entry>& e : cache.entries) {
+      if (e->Matches(next->start, next->stop, next->has_value,
+                     next->has_label)) {
+        return OkStatus();
+      }
+    }
+    next->component = component;
+    Insert(&cache, next);
+    pending_.push_back(next);
+    if (thread_ == nullptr) {
+      thread_.reset(env_->StartThread(ThreadOptions(), "io_readable_read_ahead",
+                                      [this] { Run(); }));
+    }
+    cache_cv_.notify_all();
+    return OkStatus();
+  }
+
+ private:
+  struct Entry {
+    int64 start;
+    int64 stop;
+    bool has_value;
+    bool has_label;
+    string component;
+    Notification done;
+    Status status;
+    int64 record_read = 0;
+    Tensor value;
+    Tensor label;
+
+    bool Matches(const int64 start, const int64 stop, const bool has_value,
+                 const bool has_label) const {
+      return this->start == start && this->stop == stop &&
+             this->has_value == has_value && this->has_label == has_label;
+    }
+  };
+  struct Cache {
+    std::deque<std::shared_ptr<Entry>> entries;
+    int64 stop = -1;
+  };
+
+  void Insert(Cache* cache, const std::shared_ptr<Entry>& entry)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(cache_mu_) {
+    for (const std::shared_ptr<Entry>& e : cache->entries) {
+      if (e == entry) return;
+    }
+    if (cache->entries.size() >= kCacheSize) cache->entries.pop_front();
+    cache->entries.push_back(entry);
+  }
+
+  void Run() {
+    while (true) {
+      std::shared_ptr<Entry> entry;
+      {
+        mutex_lock l(cache_mu_);
+        while (!stop_ && pending_.empty()) cache_cv_.wait(l);
+        if (stop_) return;
+        entry = pending_.front();
+        pending_.pop_front();
+      }
+      entry->status = Fill(entry.get());
+      entry->done.Notify();
+    }
+  }
+
+  // Reads an entry into tensors allocated as IOReadableReadOp does.
+  Status Fill(Entry* entry) {
+    Tensor* value = nullptr;
+    Tensor* label = nullptr;
+    if (entry->has_value) {
+      TF_RETURN_IF_ERROR(Allocate(entry, false, &entry->value));
+      value = &entry->value;
+    }
+    if (entry->has_label) {
+      TF_RETURN_IF_ERROR(Allocate(entry, true, &entry->label));
+      label = &entry->label;
+    }
+    return ReadShared(entry->start, entry->stop, entry->component,
+                      &entry->record_read, value, label);
+  }
+
+  // Reads the values of a component from the shared memory of the host, or
+  // reads and publishes them there.
+  Status ReadShared(const int64 start, const int64 stop,
+                    const string& component, int64* record_read, Tensor* value,
+                    Tensor* label) {
+    if (!shared_ || value == nullptr || label != nullptr ||
+        !IOSharedMemoryCache::Cacheable(value->dtype(), value->TotalBytes())) {
+      return Type::Read(start, stop, component, record_read, value, label);
+    }
+    const string key = IOSharedMemoryCache::Key(
+        shared_filename_, shared_mtime_nsec_, component, start, stop);
+    if (IOSharedMemoryCache::Lookup(key, record_read, value)) {
+      return OkStatus();
+    }
+    TF_RETURN_IF_ERROR(
+        Type::Read(start, stop, component, record_read, value, label));
+    IOSharedMemoryCache::Publish(key, *record_read, *value);
+    return OkStatus();
+  }
+  Status Allocate(const Entry* entry, const bool label, Tensor* tensor) {
+    PartialTensorShape shape;
+    DataType dtype;
+    TF_RETURN_IF_ERROR(this->Spec(entry->component, &shape, &dtype, label));
+    *tensor =
+        Tensor(dtype, IOReadableReadShape(shape, entry->start, entry->stop));
+    return OkStatus();
+  }
+
+  static constexpr size_t kCacheSize = 4;
+
+  Env* const env_;
+  mutex cache_mu_;
+  condition_variable cache_cv_;
+  std::unordered_map<string, Cache> caches_ TF_GUARDED_BY(cache_mu_);
+  std::deque<std::shared_ptr<Entry>> pending_ TF_GUARDED_BY(cache_mu_);
+  bool stop_ TF_GUARDED_BY(cache_mu_) = false;
+  std::unique_ptr<Thread> thread_;
+  // Set by Init, before any read
+  bool shared_ = false;
+  string shared_filename_;
+  int64 shared_mtime_nsec_ = 0;
 };
 
 class IOMappingInterface : public IOInterface {
@@ -202,6 +450,13 @@ class IOReadableReadOp : public OpKernel {
     if (status.ok()) {
       component_ = component;
     }
+    // Outputs of reads fed to a GPU may be allocated in pinned host memory,
+    // which saves the staging copy before the transfer.
+    bool gpu_compatible = false;
+    status = ctx->GetAttr("gpu_compatible", &gpu_compatible);
+    if (status.ok()) {
+      attr_.set_gpu_compatible(gpu_compatible);
+    }
   }
   virtual ~IOReadableReadOp<Type>() {}
 
@@ -228,10 +483,10 @@ class IOReadableReadOp : public OpKernel {
       DataType dtype;
       OP_REQUIRES_OK(context,
                      resource->Spec(component_, &shape, &dtype, false));
-      gtl::InlinedVector<int64, 4> dims = shape.dim_sizes();
-      dims[0] = stop - start;
-      TensorShape value_shape(dims);
-      value = Tensor(dtype, value_shape);
+      OP_REQUIRES_OK(context,
+                     context->allocate_temp(
+                         dtype, IOReadableReadShape(shape, start, stop),
+                         &value, attr_));
       value_tensor = &value;
     }
     Tensor* label_tensor = nullptr;
@@ -240,35 +495,30 @@ class IOReadableReadOp : public OpKernel {
       PartialTensorShape shape;
       DataType dtype;
       OP_REQUIRES_OK(context, resource->Spec(component_, &shape, &dtype, true));
-      gtl::InlinedVector<int64, 4> dims = shape.dim_sizes();
-      dims[0] = stop - start;
-      TensorShape label_shape(dims);
-      label = Tensor(dtype, label_shape);
+      OP_REQUIRES_OK(context,
+                     context->allocate_temp(
+                         dtype, IOReadableReadShape(shape, start, stop),
+                         &label, attr_));
       label_tensor = &label;
     }
     int64 record_read = 0;
     OP_REQUIRES_OK(context,
                    resource->Read(start, stop, component_, &record_read,
                                   value_tensor, label_tensor));
+    // The outputs are only sliced when the first dimension of the component
+    // is not known, or the read stops short of it.
     int64 output_index = 0;
-    if (record_read < stop - start) {
-      if (value_output_) {
-        context->set_output(output_index, value.Slice(0, record_read));
-        output_index++;
-      }
-      if (label_output_) {
-        context->set_output(output_index, label.Slice(0, record_read));
-        output_index++;
-      }
-    } else {
-      if (value_output_) {
-        context->set_output(output_index, value);
-        output_index++;
-      }
-      if (label_output_) {
-        context->set_output(output_index, label);
-        output_index++;
-      }
+    if (value_output_) {
+      context->set_output(output_index, record_read < value.dim_size(0)
+                                            ? value.Slice(0, record_read)
+                                            : value);
+      output_index++;
+    }
+    if (label_output_) {
+      context->set_output(output_index, record_read < label.dim_size(0)
+                                            ? label.Slice(0, record_read)
+                                            : label);
+      output_index++;
     }
   }
 
@@ -276,6 +526,78 @@ class IOReadableReadOp : public OpKernel {
   string component_;
   bool value_output_;
   bool label_output_;
+  AllocatorAttributes attr_;
+};
+// Reads the values of the components in the `components` attr over the
+// same [start, stop), one output of `dtypes` each, through ReadComponents.
+// All outputs are sliced to the fewest records read by any component.
+template <typename Type>
+class IOReadableReadComponentsOp : public OpKernel {
+ public:
+  explicit IOReadableReadComponentsOp<Type>(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("components", &components_));
+    DataTypeVector dtypes;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dtypes", &dtypes));
+    OP_REQUIRES(ctx, (components_.size() == dtypes.size()),
+                errors::InvalidArgument("components and dtypes mismatch: ",
+                                        components_.size(), " vs. ",
+                                        dtypes.size()));
+    bool gpu_compatible = false;
+    if (ctx->GetAttr("gpu_compatible", &gpu_compatible).ok()) {
+      attr_.set_gpu_compatible(gpu_compatible);
+    }
+  }
+  virtual ~IOReadableReadComponentsOp<Type>() {}
+
+  void Compute(OpKernelContext* context) override {
+    Type* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    int64 start = start_tensor->scalar<int64>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    int64 stop = stop_tensor->scalar<int64>()();
+
+    std::vector<Tensor> values(components_.size());
+    std::vector<Tensor*> value_tensors(components_.size());
+    for (size_t i = 0; i < components_.size(); i++) {
+      PartialTensorShape shape;
+      DataType dtype;
+      OP_REQUIRES_OK(context,
+                     resource->Spec(components_[i], &shape, &dtype, false));
+      OP_REQUIRES(context, (dtype == context->expected_output_dtype(i)),
+                  errors::InvalidArgument(
+                      "dtype mismatch of ", components_[i], ": ",
+                      DataTypeString(dtype), " vs. ",
+                      DataTypeString(context->expected_output_dtype(i))));
+      OP_REQUIRES_OK(context,
+                     context->allocate_temp(
+                         dtype, IOReadableReadShape(shape, start, stop),
+                         &values[i], attr_));
+      value_tensors[i] = &values[i];
+    }
+    int64 record_read = 0;
+    OP_REQUIRES_OK(context,
+                   resource->ReadComponents(start, stop, components_,
+                                            &record_read, value_tensors));
+    for (size_t i = 0; i < components_.size(); i++) {
+      if (record_read < values[i].dim_size(0)) {
+        context->set_output(i, values[i].Slice(0, record_read));
+      } else {
+        context->set_output(i, values[i]);
+      }
+    }
+  }
+
+ private:
+  std::vector<string> components_;
+  AllocatorAttributes attr_;
 };
 template <typename Type>
 class IOMappingReadOp : public OpKernel {
@@ -323,5 +645,46 @@ class IOReadablePartitionsOp : public OpKernel {
   }
 };
 
+// Returns the threads that the asynchronous IO ops block on, shared by all
+// the ops of the process. The threads are bounded, TFIO_IO_THREADS of them
+// or 64 by default, so that many parallel readers waiting on remote reads
+// neither hold inter-op threads nor start a thread each; reads beyond that
+// queue up.
+inline thread::ThreadPool* IOExecutor() {
+  static thread::ThreadPool* executor = [] {
+    int64 threads = 64;
+    Status status = ReadInt64FromEnvVar("TFIO_IO_THREADS", 64, &threads);
+    if (!status.ok() || threads <= 0) {
+      LOG(WARNING) << "invalid TFIO_IO_THREADS, using 64 threads: " << status;
+      threads = 64;
+    }
+    return new thread::ThreadPool(Env::Default(), "tfio_io", threads);
+  }();
+  return executor;
+}
+
+// Runs the synchronous kernel `Kernel` as an asynchronous one on the IO
+// executor, in the manner of DatasetOutputOp, for the read ops that block
+// on remote services for as long as a read takes.
+template <typename Kernel>
+class IOAsyncOpKernel : public AsyncOpKernel {
+ public:
+  explicit IOAsyncOpKernel<Kernel>(OpKernelConstruction* ctx)
+      : AsyncOpKernel(ctx), kernel_(ctx) {}
+  virtual ~IOAsyncOpKernel<Kernel>() {}
+
+  void ComputeAsync(OpKernelContext* context, DoneCallback done) override {
+    IOExecutor()->Schedule([this, context, done]() {
+      kernel_.Compute(context);
+      done();
+    });
+  }
+
+ private:
+  Kernel kernel_;
+};
+
 }  // namespace data
 }  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_IO_INTERFACE_H_
@@ -13,12 +13,24 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <map>
+#include <tuple>
+
 #include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace io {
 namespace {
 
+// Rewrites the graph before placement, unless TFIO_GRAPH_REWRITE is false:
+//   Reads of different components of an Avro readable over the same
+//     [start, stop), as built by the Avro IOTensor and IODataset, are fused
+//     into one IO>AvroReadableReadComponents, which walks the records once
+//     for all of them. Each fused read is replaced by an Identity of the
+//     same name, so that fetches and feeds by name keep working.
+// With TFIO_GRAPH_DEBUG set, the graph is also logged before the rewrites.
 class IOGraphOptimizationPass : public GraphOptimizationPass {
  public:
   IOGraphOptimizationPass() {
@@ -26,6 +38,10 @@ class IOGraphOptimizationPass : public GraphOptimizationPass {
     if (enable_) {
       LOG(INFO) << "TFIO_GRAPH_DEBUG: [init]";
     }
+    Status status = ReadBoolFromEnvVar("TFIO_GRAPH_REWRITE", true, &rewrite_);
+    if (!status.ok()) {
+      LOG(WARNING) << "invalid TFIO_GRAPH_REWRITE: " << status;
+    }
   }
   virtual ~IOGraphOptimizationPass() {
     if (enable_) {
@@ -33,16 +49,132 @@ class IOGraphOptimizationPass : public GraphOptimizationPass {
     }
   }
   Status Run(const GraphOptimizationPassOptions& options) override {
+    if (options.graph == nullptr) {
+      return OkStatus();
+    }
+    Graph* graph = options.graph->get();
     if (enable_) {
-      Graph* graph = options.graph->get();
       LOG(INFO) << "TFIO_GRAPH_DEBUG: [run]:"
                 << graph->ToGraphDefDebug().DebugString();
     }
+    if (rewrite_) {
+      TF_RETURN_IF_ERROR(FuseAvroReads(graph));
+    }
     return OkStatus();
   }
 
  private:
+  // The resource, start and stop inputs, the device and the allocation of
+  // a read; reads with the same key are fused.
+  using ReadKey = std::tuple<const Node*, int, const Node*, int, const Node*,
+                             int, string, bool>;
+
+  Status FuseAvroReads(Graph* graph) {
+    std::map<ReadKey, std::vector<Node*>> reads;
+    for (Node* node : graph->op_nodes()) {
+      if (node->type_string() != "IO>AvroReadableRead") {
+        continue;
+      }
+      // Control inputs could depend on another of the reads, which would
+      // then make a cycle through the fused read.
+      bool control = false;
+      for (const Edge* edge : node->in_edges()) {
+        control = control || edge->IsControlEdge();
+      }
+      if (control) {
+        continue;
+      }
+      const Edge* input[3];
+      for (int i = 0; i < 3; i++) {
+        TF_RETURN_IF_ERROR(node->input_edge(i, &input[i]));
+      }
+      bool gpu_compatible = false;
+      TF_RETURN_IF_ERROR(
+          GetNodeAttr(node->attrs(), "gpu_compatible", &gpu_compatible));
+      reads[ReadKey(input[0]->src(), input[0]->src_output(), input[1]->src(),
+                    input[1]->src_output(), input[2]->src(),
+                    input[2]->src_output(), node->requested_device(),
+                    gpu_compatible)]
+          .push_back(node);
+    }
+    for (const auto& entry : reads) {
+      if (entry.second.size() > 1) {
+        TF_RETURN_IF_ERROR(FuseAvroRead(graph, entry.second));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status FuseAvroRead(Graph* graph, const std::vector<Node*>& nodes) {
+    std::vector<string> components;
+    std::vector<PartialTensorShape> shapes;
+    DataTypeVector dtypes;
+    for (const Node* node : nodes) {
+      string component;
+      PartialTensorShape shape;
+      DataType dtype;
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "component", &component));
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "shape", &shape));
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "dtype", &dtype));
+      components.push_back(component);
+      shapes.push_back(shape);
+      dtypes.push_back(dtype);
+    }
+    const Node* node = nodes[0];
+    const Edge* input[3];
+    for (int i = 0; i < 3; i++) {
+      TF_RETURN_IF_ERROR(node->input_edge(i, &input[i]));
+    }
+    bool gpu_compatible = false;
+    TF_RETURN_IF_ERROR(
+        GetNodeAttr(node->attrs(), "gpu_compatible", &gpu_compatible));
+
+    Node* fused;
+    TF_RETURN_IF_ERROR(
+        NodeBuilder(graph->NewName(node->name() + "/Components"),
+                    "IO>AvroReadableReadComponents")
+            .Input(input[0]->src(), input[0]->src_output())
+            .Input(input[1]->src(), input[1]->src_output())
+            .Input(input[2]->src(), input[2]->src_output())
+            .Attr("components", components)
+            .Attr("shapes", shapes)
+            .Attr("dtypes", dtypes)
+            .Attr("gpu_compatible", gpu_compatible)
+            .Device(node->requested_device())
+            .Finalize(graph, &fused));
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const string name = nodes[i]->name();
+      std::vector<const Edge*> edges(nodes[i]->out_edges().begin(),
+                                     nodes[i]->out_edges().end());
+      std::vector<std::pair<Node*, int>> outputs;
+      for (const Edge* edge : edges) {
+        outputs.emplace_back(edge->dst(), edge->dst_input());
+      }
+      graph->RemoveNode(nodes[i]);
+
+      Node* identity;
+      TF_RETURN_IF_ERROR(NodeBuilder(name, "Identity")
+                             .Input(fused, i)
+                             .Device(fused->requested_device())
+                             .Finalize(graph, &identity));
+      for (const std::pair<Node*, int>& output : outputs) {
+        if (output.second == Graph::kControlSlot) {
+          graph->AddControlEdge(identity, output.first);
+        } else {
+          graph->AddEdge(identity, 0, output.first, output.second);
+        }
+      }
+    }
+    if (enable_) {
+      LOG(INFO) << "TFIO_GRAPH_DEBUG: [fuse]: " << nodes.size()
+                << " reads into " << fused->name();
+    }
+    return OkStatus();
+  }
+
   bool enable_ = false;
+  bool rewrite_ = true;
 };
 
 REGISTER_OPTIMIZATION(OptimizationPassRegistry::PRE_PLACEMENT, 15,
@@ -0,0 +1,312 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_IO_READABLE_DATASET_H_
+#define TENSORFLOW_IO_CORE_KERNELS_IO_READABLE_DATASET_H_
+
+#include <deque>
+
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow_io/core/kernels/io_interface.h"
+
+namespace tensorflow {
+namespace data {
+
+// A dataset of the records of the `components` of an IOReadableInterface,
+// in batches of the partitions of the readable, or else of `capacity`
+// records each. Up to `window` batches are read ahead, `num_parallel_reads`
+// at a time, and produced in order, so that any readable format is read in
+// parallel with its consumer and, as far as the format allows, with itself.
+//
+// Without partitions, a readable of a known number of records is read up to
+// that number, and one of an unknown number until a read of no records.
+template <typename Type>
+class IOReadableDatasetOp : public DatasetOpKernel {
+ public:
+  explicit IOReadableDatasetOp<Type>(OpKernelConstruction* ctx)
+      : DatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("components", &components_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("shapes", &shapes_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dtypes", &dtypes_));
+    OP_REQUIRES(ctx,
+                (components_.size() == shapes_.size() &&
+                 components_.size() == dtypes_.size()),
+                errors::InvalidArgument(
+                    "components, shapes and dtypes mismatch: ",
+                    components_.size(), " vs. ", shapes_.size(), " vs. ",
+                    dtypes_.size()));
+  }
+
+ protected:
+  void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
+    int64 capacity = 0;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, "capacity", &capacity));
+    OP_REQUIRES(ctx, (capacity > 0),
+                errors::InvalidArgument("capacity must be positive, got ",
+                                        capacity));
+    int64 num_parallel_reads = 0;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, "num_parallel_reads",
+                                                   &num_parallel_reads));
+    OP_REQUIRES(ctx, (num_parallel_reads > 0),
+                errors::InvalidArgument(
+                    "num_parallel_reads must be positive, got ",
+                    num_parallel_reads));
+    int64 window = 0;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, "window", &window));
+    OP_REQUIRES(ctx, (window >= num_parallel_reads),
+                errors::InvalidArgument(
+                    "window must be at least num_parallel_reads, got ", window,
+                    " vs. ", num_parallel_reads));
+
+    Type* resource;
+    OP_REQUIRES_OK(ctx, GetResourceFromContext(ctx, "input", &resource));
+    *output = new Dataset(ctx, resource, components_, shapes_, dtypes_,
+                          capacity, num_parallel_reads, window);
+  }
+
+ private:
+  class Dataset : public DatasetBase {
+   public:
+    // Takes over the reference of `resource`.
+    Dataset(OpKernelContext* ctx, Type* resource,
+            const std::vector<string>& components,
+            const std::vector<PartialTensorShape>& shapes,
+            const DataTypeVector& dtypes, const int64 capacity,
+            const int64 num_parallel_reads, const int64 window)
+        : DatasetBase(DatasetContext(ctx)),
+          resource_(resource),
+          components_(components),
+          shapes_(shapes),
+          dtypes_(dtypes),
+          capacity_(capacity),
+          num_parallel_reads_(num_parallel_reads),
+          window_(window) {}
+    ~Dataset() override { resource_->Unref(); }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return absl::make_unique<Iterator>(typename Iterator::Params{
+          this, name_utils::IteratorPrefix("IOReadable", prefix)});
+    }
+
+    const DataTypeVector& output_dtypes() const override { return dtypes_; }
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      return shapes_;
+    }
+
+    string DebugString() const override {
+      return name_utils::DatasetDebugString("IOReadable");
+    }
+
+    Status InputDatasets(
+        std::vector<const DatasetBase*>* inputs) const override {
+      return OkStatus();
+    }
+    Status CheckExternalState() const override { return OkStatus(); }
+
+   protected:
+    Status AsGraphDefInternal(SerializationContext* ctx,
+                              DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      return errors::Unimplemented(DebugString(),
+                                   " does not support serialization");
+    }
+
+   private:
+    class Iterator : public DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const typename DatasetIterator<Dataset>::Params& params)
+          : DatasetIterator<Dataset>(params) {}
+      ~Iterator() override {
+        // Waits for the reads in flight, which fill entries they share.
+        pool_.reset();
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        if (pool_ == nullptr) {
+          TF_RETURN_IF_ERROR(Start());
+        }
+        while (true) {
+          Schedule();
+          if (end_ || reads_.empty()) {
+            *end_of_sequence = true;
+            return OkStatus();
+          }
+          std::shared_ptr<Read> read = reads_.front();
+          reads_.pop_front();
+          read->done.WaitForNotification();
+          TF_RETURN_IF_ERROR(read->status);
+          if (read->record_read == 0) {
+            // Past the end of a readable of an unknown number of records,
+            // or an empty partition.
+            end_ = unbounded_;
+            continue;
+          }
+          *out_tensors = std::move(read->values);
+          *end_of_sequence = false;
+          return OkStatus();
+        }
+      }
+
+     protected:
+      std::shared_ptr<model::Node> CreateNode(
+          IteratorContext* ctx, model::Node::Args args) const override {
+        return model::MakeSourceNode(std::move(args));
+      }
+
+      Status SaveInternal(SerializationContext* ctx,
+                          IteratorStateWriter* writer) override {
+        return errors::Unimplemented("SaveInternal");
+      }
+
+      Status RestoreInternal(IteratorContext* ctx,
+                             IteratorStateReader* reader) override {
+        return errors::Unimplemented(
+            "Iterator does not support 'RestoreInternal')");
+      }
+
+     private:
+      struct Read {
+        int64 start;
+        int64 stop;
+        Notification done;
+        Status status;
+        int64 record_read = 0;
+        std::vector<Tensor> values;
+      };
+
+      // Splits the records into the ranges to read.
+      Status Start() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const Dataset* dataset = this->dataset();
+        std::vector<int64> partitions;
+        Status status = dataset->resource_->Partitions(&partitions);
+        if (!status.ok() && !errors::IsUnimplemented(status)) {
+          return status;
+        }
+        if (status.ok() && !partitions.empty()) {
+          int64 start = 0;
+          for (const int64 partition : partitions) {
+            ranges_.emplace_back(start, start + partition);
+            start += partition;
+          }
+        } else {
+          int64 records = -1;
+          for (const string& component : dataset->components_) {
+            PartialTensorShape shape;
+            DataType dtype;
+            TF_RETURN_IF_ERROR(
+                dataset->resource_->Spec(component, &shape, &dtype, false));
+            if (shape.dims() == 0 || shape.dim_size(0) < 0) {
+              records = -1;
+              break;
+            }
+            records = (records < 0) ? shape.dim_size(0)
+                                    : std::min(records, shape.dim_size(0));
+          }
+          unbounded_ = (records < 0);
+          for (int64 start = 0; start < records; start += dataset->capacity_) {
+            ranges_.emplace_back(start,
+                                 std::min(start + dataset->capacity_, records));
+          }
+        }
+        pool_.reset(new thread::ThreadPool(Env::Default(),
+                                           "io_readable_dataset",
+                                           dataset->num_parallel_reads_));
+        return OkStatus();
+      }
+
+      // Starts reading the ranges that follow, up to the window.
+      void Schedule() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const Dataset* dataset = this->dataset();
+        while (!end_ && static_cast<int64>(reads_.size()) < dataset->window_ &&
+               (unbounded_ || next_ < ranges_.size())) {
+          std::shared_ptr<Read> read(new Read());
+          if (unbounded_) {
+            read->start = static_cast<int64>(next_) * dataset->capacity_;
+            read->stop = read->start + dataset->capacity_;
+          } else {
+            read->start = ranges_[next_].first;
+            read->stop = ranges_[next_].second;
+          }
+          next_++;
+          reads_.push_back(read);
+          pool_->Schedule([dataset, read]() {
+            read->status = Fill(dataset, read.get());
+            read->done.Notify();
+          });
+        }
+      }
+
+      static Status Fill(const Dataset* dataset, Read* read) {
+        const std::vector<string>& components = dataset->components_;
+        read->values.resize(components.size());
+        std::vector<Tensor*> values(components.size());
+        for (size_t i = 0; i < components.size(); i++) {
+          PartialTensorShape shape;
+          DataType dtype;
+          TF_RETURN_IF_ERROR(
+              dataset->resource_->Spec(components[i], &shape, &dtype, false));
+          if (dtype != dataset->dtypes_[i]) {
+            return errors::InvalidArgument(
+                "dtype mismatch of ", components[i], ": ",
+                DataTypeString(dtype), " vs. ",
+                DataTypeString(dataset->dtypes_[i]));
+          }
+          read->values[i] = Tensor(
+              dtype, IOReadableReadShape(shape, read->start, read->stop));
+          values[i] = &read->values[i];
+        }
+        TF_RETURN_IF_ERROR(dataset->resource_->ReadComponents(
+            read->start, read->stop, components, &read->record_read, values));
+        for (Tensor& value : read->values) {
+          if (read->record_read < value.dim_size(0)) {
+            value = value.Slice(0, read->record_read);
+          }
+        }
+        return OkStatus();
+      }
+
+      mutex mu_;
+      std::vector<std::pair<int64, int64>> ranges_ TF_GUARDED_BY(mu_);
+      bool unbounded_ TF_GUARDED_BY(mu_) = false;
+      bool end_ TF_GUARDED_BY(mu_) = false;
+      size_t next_ TF_GUARDED_BY(mu_) = 0;
+      std::deque<std::shared_ptr<Read>> reads_ TF_GUARDED_BY(mu_);
+      std::unique_ptr<thread::ThreadPool> pool_;
+    };
+
+    Type* const resource_;
+    const std::vector<string> components_;
+    const std::vector<PartialTensorShape> shapes_;
+    const DataTypeVector dtypes_;
+    const int64 capacity_;
+    const int64 num_parallel_reads_;
+    const int64 window_;
+  };
+
+  std::vector<string> components_;
+  std::vector<PartialTensorShape> shapes_;
+  DataTypeVector dtypes_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_IO_READABLE_DATASET_H_
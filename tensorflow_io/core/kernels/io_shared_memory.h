@@ -0,0 +1,215 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_IO_SHARED_MEMORY_H_
+#define TENSORFLOW_IO_CORE_KERNELS_IO_SHARED_MEMORY_H_
+
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace data {
+
+// A cache of the tensors read from files, shared by the processes of a host
+// through named POSIX shared memory. The first process to read a tensor
+// publishes it under a name derived from its key, and the processes that
+// read the same key later map it instead and alias it without a copy.
+//
+// The cache is opt-in through TFIO_SHARED_MEMORY_CACHE, and only holds
+// tensors of at least TFIO_SHARED_MEMORY_CACHE_MIN_BYTES bytes (1MB by
+// default) of types that can be copied as bytes. Entries are named
+// /tfio_<hash> and live until they are removed from /dev/shm or the host
+// restarts. A key includes the modification time of its file, so an entry is
+// never read for a file that changed.
+class IOSharedMemoryCache {
+ public:
+  static bool Enabled() {
+    static const bool enabled = [] {
+      bool enabled = false;
+      ReadBoolFromEnvVar("TFIO_SHARED_MEMORY_CACHE", false, &enabled)
+          .IgnoreError();
+      return enabled;
+    }();
+    return enabled;
+  }
+
+  // Returns whether a tensor of `bytes` bytes of dtype is worth caching.
+  static bool Cacheable(const DataType dtype, const int64 bytes) {
+    static const int64 min_bytes = [] {
+      int64 min_bytes = 1 << 20;
+      ReadInt64FromEnvVar("TFIO_SHARED_MEMORY_CACHE_MIN_BYTES", 1 << 20,
+                          &min_bytes)
+          .IgnoreError();
+      return min_bytes;
+    }();
+    return DataTypeCanUseMemcpy(dtype) && bytes >= min_bytes;
+  }
+
+  static string Key(const string& filename, const int64 mtime_nsec,
+                    const string& component, const int64 start,
+                    const int64 stop) {
+    return strings::StrCat(filename, "\n", mtime_nsec, "\n", component, "\n",
+                           start, "\n", stop);
+  }
+
+  // Replaces value, allocated for the read of key, with the published tensor
+  // of key, if any.
+  static bool Lookup(const string& key, int64* record_read, Tensor* value) {
+#if defined(_MSC_VER)
+    return false;
+#else
+    const string name = Name(key);
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+      close(fd);
+      return false;
+    }
+    const size_t size = st.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    const Header* header = static_cast<const Header*>(data);
+    const char* p = static_cast<const char*>(data);
+    // Entries that are still written, or were left half written by a process
+    // that died, are not read.
+    if (header->magic != kMagic ||
+        header->ready.load(std::memory_order_acquire) != 1 ||
+        header->data_offset + header->data_size > size ||
+        sizeof(Header) + header->key_size > header->data_offset ||
+        StringPiece(p + sizeof(Header), header->key_size) != key ||
+        header->dtype != value->dtype() ||
+        header->data_size != value->TotalBytes()) {
+      munmap(data, size);
+      return false;
+    }
+    *record_read = header->record_read;
+    Buffer* buffer = new Buffer(data, size, header->data_offset,
+                                header->data_size);
+    *value = Tensor(value->dtype(), value->shape(), buffer);
+    buffer->Unref();
+    return true;
+#endif
+  }
+
+  // Publishes the tensor read for key, unless another process already does.
+  static void Publish(const string& key, const int64 record_read,
+                      const Tensor& value) {
+#if !defined(_MSC_VER)
+    const string name = Name(key);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return;
+    const uint64 data_offset =
+        Align(sizeof(Header) + key.size(), EIGEN_MAX_ALIGN_BYTES);
+    const uint64 data_size = value.TotalBytes();
+    const size_t size = data_offset + data_size;
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+      data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      return;
+    }
+    // The mapping is zero filled, so the entry is not ready until the end
+    Header* header = static_cast<Header*>(data);
+    char* p = static_cast<char*>(data);
+    header->magic = kMagic;
+    header->dtype = value.dtype();
+    header->record_read = record_read;
+    header->key_size = key.size();
+    header->data_offset = data_offset;
+    header->data_size = data_size;
+    memcpy(p + sizeof(Header), key.data(), key.size());
+    memcpy(p + data_offset, value.tensor_data().data(), data_size);
+    header->ready.store(1, std::memory_order_release);
+    munmap(data, size);
+#endif
+  }
+
+ private:
+  static constexpr uint64 kMagic = 0x6d68737466696f31ULL;
+
+  struct Header {
+    uint64 magic;
+    std::atomic<uint32> ready;
+    int32 dtype;
+    int64 record_read;
+    uint64 key_size;
+    uint64 data_offset;
+    uint64 data_size;
+  };
+
+  static uint64 Align(const uint64 n, const uint64 alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  static string Name(const string& key) {
+    return strings::StrCat("/tfio_", strings::Hex(Hash64(key),
+                                                  strings::kZeroPad16));
+  }
+
+#if !defined(_MSC_VER)
+  // TensorBuffer over a mapped entry, which is unmapped once the last tensor
+  // aliasing it is released.
+  class Buffer : public TensorBuffer {
+   public:
+    Buffer(void* base, size_t size, size_t offset, size_t data_size)
+        : TensorBuffer(static_cast<char*>(base) + offset),
+          base_(base),
+          size_(size),
+          data_size_(data_size) {}
+    ~Buffer() override { munmap(base_, size_); }
+
+    size_t size() const override { return data_size_; }
+
+    TensorBuffer* root_buffer() override { return this; }
+
+    void FillAllocationDescription(
+        AllocationDescription* proto) const override {
+      proto->set_requested_bytes(data_size_);
+      proto->set_allocator_name("io_shared_memory");
+    }
+
+    // Prevents kernels from forwarding the buffer and writing into the
+    // mapping
+    bool OwnsMemory() const override { return false; }
+
+   private:
+    void* const base_;
+    const size_t size_;
+    const size_t data_size_;
+  };
+#endif
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_IO_SHARED_MEMORY_H_
@@ -47,14 +47,32 @@ class SizedRandomAccessFile : public tensorflow::RandomAccessFile {
     if (file_.get() != nullptr) {
       return file_.get()->Read(offset, n, result, scratch);
     }
+    StringPiece data;
+    Status status = ReadZeroCopy(offset, n, &data);
+    if (data.size() > 0) {
+      memcpy(scratch, data.data(), data.size());
+    }
+    *result = StringPiece(scratch, data.size());
+    return status;
+  }
+  // Whether the file is backed by memory, which ReadZeroCopy returns
+  // without copying.
+  bool SupportsZeroCopy() const {
+    return file_.get() == nullptr && buff_ != nullptr;
+  }
+  // Reads as Read does, but sets `*result` to point into the memory backing
+  // the file, which stays valid as long as the memory does, instead of
+  // copying to a scratch. Requires SupportsZeroCopy().
+  Status ReadZeroCopy(uint64 offset, size_t n, StringPiece* result) const {
+    if (!SupportsZeroCopy()) {
+      return errors::Unimplemented("zero copy read of ", size_, " bytes");
+    }
     size_t bytes_to_read = 0;
     if (offset < size_) {
       bytes_to_read = (offset + n < size_) ? n : (size_ - offset);
     }
-    if (bytes_to_read > 0) {
-      memcpy(scratch, &buff_[offset], bytes_to_read);
-    }
-    *result = StringPiece(scratch, bytes_to_read);
+    *result = StringPiece(bytes_to_read > 0 ? &buff_[offset] : buff_,
+                          bytes_to_read);
     if (bytes_to_read < n) {
       return errors::OutOfRange("EOF reached");
     }
@@ -13,17 +13,22 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <deque>
 #include <fstream>
 #include <iostream>
 
+#include "absl/strings/ascii.h"
+
 #include "arrow/array.h"
 #include "arrow/json/reader.h"
 #include "arrow/memory_pool.h"
 #include "arrow/table.h"
 #include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/batch_util.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_kernels.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_util.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
@@ -50,10 +55,40 @@ class JSONReadable : public IOReadableInterface {
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
 
     mode_ = "ndjson";
+    // In streaming mode, only the columns given are decoded, from the lines
+    // starting in the bytes [offset, offset + length) of the file.
+    std::vector<string> include;
+    int64 offset = 0;
+    int64 length = -1;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("mode: ") == 0) {
         mode_ = metadata[i].substr(6);
+      } else if (metadata[i].find("stream: ") == 0) {
+        stream_ = (metadata[i].substr(8) == "true");
+      } else if (metadata[i].find("column: ") == 0) {
+        include.push_back(metadata[i].substr(8));
+      } else if (metadata[i].find("offset: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &offset) ||
+            offset < 0) {
+          return errors::InvalidArgument("invalid offset: ", metadata[i]);
+        }
+      } else if (metadata[i].find("length: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(8), &length)) {
+          return errors::InvalidArgument("invalid length: ", metadata[i]);
+        }
+      } else if (metadata[i].find("block_size: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(12), &block_size_) ||
+            block_size_ <= 0) {
+          return errors::InvalidArgument("invalid block size: ", metadata[i]);
+        }
+      }
+    }
+    if (stream_) {
+      if (mode_ != "ndjson") {
+        return errors::InvalidArgument("mode ", mode_,
+                                       " can not be streamed");
       }
+      return InitStream(include, offset, length);
     }
 
     if (mode_ == "records") {
@@ -78,7 +113,8 @@ class JSONReadable : public IOReadableInterface {
           return errors::InvalidArgument("invalid data type: ",
                                          oi->name.GetString());
         }
-        shapes_.push_back(TensorShape({static_cast<int64>(a.MemberCount())}));
+        shapes_.push_back(
+            PartialTensorShape({static_cast<int64>(a.MemberCount())}));
         dtypes_.push_back(dtype);
         columns_.push_back(oi->name.GetString());
         columns_index_[oi->name.GetString()] =
@@ -127,7 +163,8 @@ class JSONReadable : public IOReadableInterface {
     dtypes_.clear();
     columns_.clear();
     for (int i = 0; i < table_->num_columns(); i++) {
-      shapes_.push_back(TensorShape({static_cast<int64>(table_->num_rows())}));
+      shapes_.push_back(
+          PartialTensorShape({static_cast<int64>(table_->num_rows())}));
       ::tensorflow::DataType dtype;
       TF_RETURN_IF_ERROR(
           ArrowUtil::GetTensorFlowType(table_->column(i)->type(), &dtype));
@@ -164,6 +201,9 @@ class JSONReadable : public IOReadableInterface {
     int64 column_index = columns_index_[component];
 
     (*record_read) = 0;
+    if (stream_) {
+      return ReadStream(start, stop, column_index, record_read, value);
+    }
     if (start >= shapes_[column_index].dim_size(0)) {
       return OkStatus();
     }
@@ -263,6 +303,267 @@ class JSONReadable : public IOReadableInterface {
   }
 
  private:
+  // The decoded columns of the records of a block of lines.
+  struct Chunk {
+    int64 start;
+    int64 rows;
+    std::vector<Tensor> values;
+  };
+
+  // Opens the split that starts at or after `offset` for streaming. The
+  // columns and their types are those of the first record of the file.
+  Status InitStream(const std::vector<string>& include, const int64 offset,
+                    const int64 length) {
+    string line;
+    for (int64 position = 0;
+         line.empty() && position < static_cast<int64>(file_size_);) {
+      int64 line_stop;
+      TF_RETURN_IF_ERROR(FindLineStart(position + 1, &line_stop));
+      line.resize(line_stop - position);
+      StringPiece result;
+      Status status = file_->Read(position, line.size(), &result, &line[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      line = string(absl::StripAsciiWhitespace(result));
+      position = line_stop;
+    }
+    rapidjson::Document d;
+    d.Parse(line.data(), line.size());
+    if (d.HasParseError() || !d.IsObject()) {
+      return errors::InvalidArgument("unable to parse the first record: ",
+                                     rapidjson::GetParseError_En(
+                                         d.GetParseError()));
+    }
+    auto add_column = [&](const string& name,
+                          const rapidjson::Value& v) -> Status {
+      DataType dtype;
+      if (v.IsBool()) {
+        dtype = DT_BOOL;
+      } else if (v.IsInt64()) {
+        dtype = DT_INT64;
+      } else if (v.IsNumber()) {
+        dtype = DT_DOUBLE;
+      } else if (v.IsString()) {
+        dtype = DT_STRING;
+      } else {
+        return errors::InvalidArgument("invalid data type: ", name);
+      }
+      shapes_.push_back(PartialTensorShape({-1}));
+      dtypes_.push_back(dtype);
+      columns_.push_back(name);
+      columns_index_[name] = static_cast<int64>(columns_.size() - 1);
+      return OkStatus();
+    };
+    if (include.empty()) {
+      for (auto oi = d.MemberBegin(); oi != d.MemberEnd(); ++oi) {
+        TF_RETURN_IF_ERROR(add_column(
+            string(oi->name.GetString(), oi->name.GetStringLength()),
+            oi->value));
+      }
+    } else {
+      for (const string& name : include) {
+        auto oi = d.FindMember(rapidjson::StringRef(name.data(), name.size()));
+        if (oi == d.MemberEnd()) {
+          return errors::InvalidArgument("column ", name,
+                                         " is not in the first record");
+        }
+        TF_RETURN_IF_ERROR(add_column(name, oi->value));
+      }
+    }
+
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(FindLineStart(offset, &position_));
+    if (length < 0) {
+      split_stop_ = file_size_;
+    } else {
+      TF_RETURN_IF_ERROR(FindLineStart(offset + length, &split_stop_));
+    }
+    return OkStatus();
+  }
+
+  // Finds the first line that starts at or after `offset`.
+  Status FindLineStart(const int64 offset, int64* line_start) {
+    if (offset <= 0 || offset >= static_cast<int64>(file_size_)) {
+      *line_start = std::min<int64>(std::max<int64>(offset, 0), file_size_);
+      return OkStatus();
+    }
+    string buffer(kLineScanBytes, '\0');
+    for (int64 position = offset - 1;
+         position < static_cast<int64>(file_size_);) {
+      StringPiece result;
+      Status status =
+          file_->Read(position, kLineScanBytes, &result, &buffer[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      if (result.empty()) {
+        break;
+      }
+      size_t newline = result.find('\n');
+      if (newline != StringPiece::npos) {
+        *line_start = position + newline + 1;
+        return OkStatus();
+      }
+      position += result.size();
+    }
+    *line_start = file_size_;
+    return OkStatus();
+  }
+
+  // Parses the records of the next block of whole lines of the split, in
+  // place, decoding only the columns read.
+  Status ReadChunk(std::unique_ptr<Chunk>* chunk)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    string buffer;
+    for (int64 size = block_size_;; size *= 2) {
+      buffer.resize(std::min<int64>(size, split_stop_ - position_));
+      StringPiece result;
+      Status status =
+          file_->Read(position_, buffer.size(), &result, &buffer[0]);
+      if (!(status.ok() || errors::IsOutOfRange(status))) {
+        return status;
+      }
+      buffer.resize(result.size());
+      if (position_ + static_cast<int64>(buffer.size()) >= split_stop_) {
+        break;
+      }
+      size_t newline = buffer.rfind('\n');
+      if (newline != string::npos) {
+        buffer.resize(newline + 1);
+        break;
+      }
+    }
+    if (buffer.empty()) {
+      return errors::DataLoss("unable to read at ", position_);
+    }
+    position_ += buffer.size();
+
+    // Each line is terminated in place, to be parsed in situ.
+    std::vector<char*> lines;
+    buffer.push_back('\n');
+    for (size_t line = 0, end; line < buffer.size(); line = end + 1) {
+      end = buffer.find('\n', line);
+      buffer[end] = '\0';
+      if (!absl::StripAsciiWhitespace(
+               absl::string_view(&buffer[line], end - line))
+               .empty()) {
+        lines.push_back(&buffer[line]);
+      }
+    }
+
+    chunk->reset(new Chunk());
+    const int64 rows = lines.size();
+    (*chunk)->start = stream_rows_;
+    (*chunk)->rows = rows;
+    for (size_t i = 0; i < columns_.size(); i++) {
+      (*chunk)->values.emplace_back(dtypes_[i], TensorShape({rows}));
+    }
+    for (int64 row = 0; row < rows; row++) {
+      // The arena is reused from record to record.
+      allocator_.Clear();
+      rapidjson::Document d(&allocator_);
+      d.ParseInsitu(lines[row]);
+      if (d.HasParseError() || !d.IsObject()) {
+        return errors::InvalidArgument(
+            "unable to parse record ", stream_rows_ + row, ": ",
+            rapidjson::GetParseError_En(d.GetParseError()));
+      }
+      for (size_t column_index = 0; column_index < columns_.size();
+           column_index++) {
+        const string& name = columns_[column_index];
+        auto oi = d.FindMember(rapidjson::StringRef(name.data(), name.size()));
+        TF_RETURN_IF_ERROR(SetValue(
+            oi == d.MemberEnd() ? nullptr : &oi->value, column_index, row,
+            &(*chunk)->values[column_index]));
+      }
+    }
+    return OkStatus();
+  }
+
+  // Sets a row of a column, to the default value if `v` is null or absent.
+  Status SetValue(const rapidjson::Value* v, const int64 column_index,
+                  const int64 row, Tensor* tensor) {
+    const bool null = (v == nullptr || v->IsNull());
+    switch (dtypes_[column_index]) {
+      case DT_BOOL:
+        if (!(null || v->IsBool())) break;
+        tensor->flat<bool>()(row) = null ? false : v->GetBool();
+        return OkStatus();
+      case DT_INT64:
+        if (!(null || v->IsInt64())) break;
+        tensor->flat<int64>()(row) = null ? 0 : v->GetInt64();
+        return OkStatus();
+      case DT_DOUBLE:
+        if (!(null || v->IsNumber())) break;
+        tensor->flat<double>()(row) = null ? 0.0 : v->GetDouble();
+        return OkStatus();
+      case DT_STRING:
+        if (!(null || v->IsString())) break;
+        tensor->flat<tstring>()(row) =
+            null ? tstring() : tstring(v->GetString(), v->GetStringLength());
+        return OkStatus();
+      default:
+        break;
+    }
+    return errors::InvalidArgument("invalid data type of column ",
+                                   columns_[column_index], " at record ",
+                                   stream_rows_ + row);
+  }
+
+  // Reads the rows [start, stop) of a column from the chunks of the stream,
+  // parsing the next chunks as needed. Chunks are dropped once all the
+  // columns read have been read past them, so that columns must be read in
+  // order and about in lockstep.
+  Status ReadStream(const int64 start, const int64 stop,
+                    const int64 column_index, int64* record_read,
+                    Tensor* value) {
+    mutex_lock l(mu_);
+    while (position_ < split_stop_ && stream_rows_ < stop) {
+      std::unique_ptr<Chunk> chunk;
+      TF_RETURN_IF_ERROR(ReadChunk(&chunk));
+      stream_rows_ += chunk->rows;
+      chunks_.push_back(std::move(chunk));
+    }
+    const int64 element_stop = std::min(stop, stream_rows_);
+    if (start >= element_stop) {
+      return OkStatus();
+    }
+    const int64 first_row = chunks_.empty() ? stream_rows_ : chunks_[0]->start;
+    if (start < first_row) {
+      return errors::OutOfRange("rows before ", first_row,
+                                " have been streamed past");
+    }
+    for (const auto& chunk : chunks_) {
+      const Tensor& values = chunk->values[column_index];
+      const int64 chunk_stop = chunk->start + chunk->rows;
+      if (chunk_stop <= start || element_stop <= chunk->start) {
+        continue;
+      }
+      const int64 slice_start = std::max(start, chunk->start);
+      const int64 slice_stop = std::min(element_stop, chunk_stop);
+      TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+          values, slice_start - chunk->start, slice_start - start,
+          slice_stop - slice_start, value));
+    }
+    (*record_read) = element_stop - start;
+
+    progress_[column_index] = element_stop;
+    int64 read = element_stop;
+    for (const auto& entry : progress_) {
+      read = std::min(read, entry.second);
+    }
+    while (!chunks_.empty() &&
+           chunks_[0]->start + chunks_[0]->rows <= read) {
+      chunks_.pop_front();
+    }
+    return OkStatus();
+  }
+
+  // The bytes read at a time looking for the start of a line.
+  static constexpr int64 kLineScanBytes = 64 << 10;
+  static constexpr int64 kDefaultBlockSize = 1 << 20;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -274,18 +575,30 @@ class JSONReadable : public IOReadableInterface {
   std::vector<Tensor> tensors_;
   string mode_;
 
+  bool stream_ = false;
+  int64 block_size_ = kDefaultBlockSize;
+  // The next byte of the split to parse, and the end of the split.
+  int64 position_ TF_GUARDED_BY(mu_) = 0;
+  int64 split_stop_ = 0;
+  rapidjson::MemoryPoolAllocator<> allocator_ TF_GUARDED_BY(mu_);
+  // The rows parsed so far, and the chunks not read past yet.
+  int64 stream_rows_ TF_GUARDED_BY(mu_) = 0;
+  std::deque<std::unique_ptr<Chunk>> chunks_ TF_GUARDED_BY(mu_);
+  // The row each column has been read up to.
+  std::unordered_map<int64, int64> progress_ TF_GUARDED_BY(mu_);
+
   std::vector<DataType> dtypes_;
-  std::vector<TensorShape> shapes_;
+  std::vector<PartialTensorShape> shapes_;
   std::vector<string> columns_;
   std::unordered_map<string, int64> columns_index_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>JSONReadableInit").Device(DEVICE_CPU),
-                        IOInterfaceInitOp<JSONReadable>);
+                        IOInterfaceInitOp<IOReadableReadAhead<JSONReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>JSONReadableSpec").Device(DEVICE_CPU),
-                        IOInterfaceSpecOp<JSONReadable>);
+                        IOInterfaceSpecOp<IOReadableReadAhead<JSONReadable>>);
 REGISTER_KERNEL_BUILDER(Name("IO>JSONReadableRead").Device(DEVICE_CPU),
-                        IOReadableReadOp<JSONReadable>);
+                        IOReadableReadOp<IOReadableReadAhead<JSONReadable>>);
 
 }  // namespace
 }  // namespace data
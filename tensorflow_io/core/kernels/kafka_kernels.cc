@@ -13,9 +13,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <map>
+
+#include "rdkafka.h"
 #include "rdkafkacpp.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
+#include "tensorflow_io/core/filesystems/memory_budget.h"
+#include "tensorflow_io/core/kernels/io_interface.h"
 
 namespace tensorflow {
 namespace io {
@@ -57,10 +67,99 @@ class KafkaEventCb : public RdKafka::EventCb {
   bool run_ TF_GUARDED_BY(mu_) = true;
 };
 
+// The maximum number of messages consumed by a single batch request.
+constexpr size_t kMaxBatchMessages = 1024;
+
+// Messages consumed in batches from the queue of a consumer, which holds on
+// to them until destroyed, so that once the output tensors are sized each
+// payload is copied exactly once, from the librdkafka buffer into its tstring.
+class KafkaMessageBatch {
+ public:
+  explicit KafkaMessageBatch(RdKafka::KafkaConsumer* consumer)
+      : queue_(rd_kafka_queue_get_consumer(consumer->c_ptr())) {}
+  ~KafkaMessageBatch() {
+    for (rd_kafka_message_t* message : consumed_) {
+      rd_kafka_message_destroy(message);
+    }
+    if (queue_ != nullptr) rd_kafka_queue_destroy(queue_);
+  }
+
+  KafkaMessageBatch(const KafkaMessageBatch&) = delete;
+  KafkaMessageBatch& operator=(const KafkaMessageBatch&) = delete;
+
+  // Consumes up to `max_messages` messages, waiting at most `timeout` ms, and
+  // returns them in `messages`. Those are either records or events such as
+  // the end of a partition, and remain owned by the batch. Nothing is
+  // returned on timeout.
+  Status Consume(const int64 timeout, const size_t max_messages,
+                 std::vector<const rd_kafka_message_t*>* messages) {
+    messages->clear();
+    if (queue_ == nullptr) {
+      return errors::Internal("failed to get the consumer queue");
+    }
+    buffer_.resize(max_messages);
+    io::IOTrace trace("kafka", io::IOTraceStage::kIOWait, "consume");
+    ssize_t count = rd_kafka_consume_batch_queue(
+        queue_, static_cast<int>(timeout), buffer_.data(), max_messages);
+    if (count < 0) {
+      return errors::Internal("Failed to consume: ",
+                              rd_kafka_err2str(rd_kafka_last_error()));
+    }
+    trace.AddRecords(count);
+    consumed_.insert(consumed_.end(), buffer_.begin(), buffer_.begin() + count);
+    messages->assign(buffer_.begin(), buffer_.begin() + count);
+    return OkStatus();
+  }
+
+  // Takes ownership of a message consumed elsewhere, e.g. by a fetcher.
+  void Adopt(rd_kafka_message_t* message) { consumed_.push_back(message); }
+
+  // Adds a record returned by Consume or adopted to the output.
+  void Add(const rd_kafka_message_t* message) { output_.push_back(message); }
+
+  size_t size() const { return output_.size(); }
+
+  // Copies the payloads and keys of the output records into `message` and
+  // `key`, which must have size() elements.
+  void Fill(Tensor* message, Tensor* key) const {
+    io::IOTrace trace("kafka", io::IOTraceStage::kFill);
+    trace.AddRecords(output_.size());
+    auto message_flat = message->flat<tstring>();
+    auto key_flat = key->flat<tstring>();
+    for (size_t i = 0; i < output_.size(); i++) {
+      const rd_kafka_message_t* record = output_[i];
+      message_flat(i).assign(static_cast<const char*>(record->payload),
+                             record->len);
+      trace.AddBytes(record->len + record->key_len);
+      if (record->key != nullptr) {
+        key_flat(i).assign(static_cast<const char*>(record->key),
+                           record->key_len);
+      }
+    }
+  }
+
+  static RdKafka::ErrorCode err(const rd_kafka_message_t* message) {
+    return static_cast<RdKafka::ErrorCode>(message->err);
+  }
+  static const char* errstr(const rd_kafka_message_t* message) {
+    return rd_kafka_message_errstr(message);
+  }
+
+ private:
+  rd_kafka_queue_t* const queue_;
+  std::vector<rd_kafka_message_t*> buffer_;
+  std::vector<rd_kafka_message_t*> consumed_;
+  std::vector<const rd_kafka_message_t*> output_;
+};
+
 class KafkaReadableResource : public ResourceBase {
  public:
   KafkaReadableResource(Env* env) : env_(env) {}
   virtual ~KafkaReadableResource() {
+    for (auto& reader : readers_) {
+      reader->unassign();
+      reader->close();
+    }
     if (consumer_.get()) {
       consumer_->unassign();
       consumer_->close();
@@ -161,6 +260,7 @@ class KafkaReadableResource : public ResourceBase {
       return errors::Internal("failed to assign partition: ",
                               RdKafka::err2str(err));
     }
+    conf_ = std::move(conf);
 
     return OkStatus();
   }
@@ -169,119 +269,93 @@ class KafkaReadableResource : public ResourceBase {
                                    Tensor** key)>
                   allocate_func) {
     mutex_lock l(mu_);
-    int64 total = 1024;
-    std::vector<string> message_value, key_value;
-    message_value.reserve(total);
-    key_value.reserve(total);
+    const size_t total = kMaxBatchMessages;
 
     LOG(INFO) << "Kafka stream starts with current offset: "
               << subscription_->offset();
-    std::unique_ptr<RdKafka::Message> message;
-    int64 count = 0;
-    while (consumer_.get() != nullptr && count < total) {
-      if (!kafka_event_cb_.run()) {
-        return errors::Internal("failed to consume due to all brokers down");
-      }
-      message.reset(consumer_->consume(timeout_));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
-        // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
-        count++;
-        continue;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
-        // Not return error here because consumer will try re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
-        LOG(ERROR) << "EOF Message: " << message->errstr();
-        consumer_.reset(nullptr);
-        break;
-      } else if (message->err() != RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << "Failed to consume: " << message->errstr();
-        return errors::Internal("Failed to consume: ", message->errstr());
-      }
+    if (consumer_.get() == nullptr) {
+      Tensor* message_tensor;
+      Tensor* key_tensor;
+      return allocate_func(TensorShape({0}), &message_tensor, &key_tensor);
     }
-    TensorShape shape({static_cast<int64>(message_value.size())});
-    Tensor* message_tensor;
-    Tensor* key_tensor;
-    TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
+    bool eof = false;
+    {
+      KafkaMessageBatch batch(consumer_.get());
+      std::vector<const rd_kafka_message_t*> messages;
+      while (!eof && batch.size() < total) {
+        if (!kafka_event_cb_.run()) {
+          return errors::Internal("failed to consume due to all brokers down");
+        }
+        TF_RETURN_IF_ERROR(
+            batch.Consume(timeout_, total - batch.size(), &messages));
+        for (const rd_kafka_message_t* message : messages) {
+          RdKafka::ErrorCode code = KafkaMessageBatch::err(message);
+          if (code == RdKafka::ERR_NO_ERROR) {
+            // Produce the line as output.
+            batch.Add(message);
+          } else if (code == RdKafka::ERR__TRANSPORT) {
+            // Not return error here because consumer will try re-connect.
+            LOG(ERROR) << "Broker transport failure: "
+                       << KafkaMessageBatch::errstr(message);
+          } else if (code == RdKafka::ERR__PARTITION_EOF) {
+            LOG(ERROR) << "EOF Message: " << KafkaMessageBatch::errstr(message);
+            eof = true;
+          } else if (code != RdKafka::ERR__TIMED_OUT) {
+            LOG(ERROR) << "Failed to consume: "
+                       << KafkaMessageBatch::errstr(message);
+            return errors::Internal("Failed to consume: ",
+                                    KafkaMessageBatch::errstr(message));
+          }
+        }
+      }
+      TensorShape shape({static_cast<int64>(batch.size())});
+      Tensor* message_tensor;
+      Tensor* key_tensor;
+      TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
+      batch.Fill(message_tensor, key_tensor);
     }
+    // The consumer queue held by the batch is released before the consumer.
+    if (eof) consumer_.reset(nullptr);
     return OkStatus();
   }
   Status Read(const int64 start, const int64 stop,
               std::function<Status(const TensorShape& shape, Tensor** message,
                                    Tensor** key)>
                   allocate_func) {
-    mutex_lock l(mu_);
-
     int64 stop_offset;
-    if (stop >= 0) {
-      stop_offset = stop;
-    } else if (stop == RdKafka::Topic::OFFSET_END) {
-      stop_offset = RdKafka::Consumer::OffsetTail(0);
-    } else if (stop <= RdKafka::Consumer::OffsetTail(0)) {
-      stop_offset = stop;
-    } else {
-      return errors::InvalidArgument("stop offset ", stop, " not supported");
-    }
-    if (stop_offset <= RdKafka::Consumer::OffsetTail(0)) {
-      int64 tail_offset = 0;
-      TF_RETURN_IF_ERROR(Tail(&tail_offset));
-
-      stop_offset =
-          tail_offset + stop_offset - RdKafka::Consumer::OffsetTail(0);
-    }
-
-    std::vector<string> message_value, key_value;
-
-    subscription_->set_offset(start);
-    RdKafka::ErrorCode err = consumer_->seek((*subscription_), timeout_);
-    if (err != RdKafka::ERR_NO_ERROR) {
-      return errors::Internal("failed to seek partition: ",
-                              RdKafka::err2str(err));
-    }
-    LOG(INFO) << "Kafka stream starts with current offset: "
-              << subscription_->offset();
-    int64 index = start;
-    std::unique_ptr<RdKafka::Message> message;
-    while (consumer_.get() != nullptr && index + 1 < stop_offset) {
-      if (!kafka_event_cb_.run()) {
-        return errors::Internal("failed to consume due to all brokers down");
+    {
+      mutex_lock l(mu_);
+      if (stop >= 0) {
+        stop_offset = stop;
+      } else if (stop == RdKafka::Topic::OFFSET_END) {
+        stop_offset = RdKafka::Consumer::OffsetTail(0);
+      } else if (stop <= RdKafka::Consumer::OffsetTail(0)) {
+        stop_offset = stop;
+      } else {
+        return errors::InvalidArgument("stop offset ", stop, " not supported");
       }
-      message.reset(consumer_->consume(timeout_));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
-        // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
-        index = message->offset();
-        continue;
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
-        LOG(ERROR) << "EOF Message: " << message->errstr();
-        break;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
-        // Not return error here because consumer will try re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
-      } else if (message->err() != RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << "Failed to consume: " << message->errstr();
-        return errors::Internal("Failed to consume: ", message->errstr());
+      if (stop_offset <= RdKafka::Consumer::OffsetTail(0)) {
+        int64 tail_offset = 0;
+        TF_RETURN_IF_ERROR(Tail(&tail_offset));
+
+        stop_offset =
+            tail_offset + stop_offset - RdKafka::Consumer::OffsetTail(0);
       }
     }
-    TensorShape shape({static_cast<int64>(message_value.size())});
-    Tensor* message_tensor;
-    Tensor* key_tensor;
-    TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
+
+    // Each read uses a consumer of its own, so that the ranges of a
+    // partition, e.g. of a dataset map with num_parallel_calls, are read in
+    // parallel.
+    std::unique_ptr<RdKafka::KafkaConsumer> reader;
+    TF_RETURN_IF_ERROR(AcquireReader(start, &reader));
+    Status status = ReadRange(reader.get(), start, stop_offset, allocate_func);
+    if (status.ok()) {
+      mutex_lock l(mu_);
+      readers_.emplace_back(std::move(reader));
+    } else {
+      reader->close();
     }
-    return OkStatus();
+    return status;
   }
   Status Spec(const int64 start, const int64 stop, int64* start_offset,
               int64* stop_offset) {
@@ -327,6 +401,88 @@ class KafkaReadableResource : public ResourceBase {
   string DebugString() const override { return "KafkaBaseResource"; }
 
  protected:
+  // Reads the messages in [start, stop_offset) with `reader`, which has
+  // been assigned the partition at `start`.
+  Status ReadRange(RdKafka::KafkaConsumer* reader, const int64 start,
+                   const int64 stop_offset,
+                   const std::function<Status(const TensorShape& shape,
+                                              Tensor** message, Tensor** key)>&
+                       allocate_func) {
+    LOG(INFO) << "Kafka stream starts with current offset: " << start;
+    int64 index = start;
+    KafkaMessageBatch batch(reader);
+    std::vector<const rd_kafka_message_t*> messages;
+    bool eof = false;
+    while (!eof && index + 1 < stop_offset) {
+      if (!kafka_event_cb_.run()) {
+        return errors::Internal("failed to consume due to all brokers down");
+      }
+      const size_t max_messages =
+          std::min<int64>(stop_offset - index - 1, kMaxBatchMessages);
+      TF_RETURN_IF_ERROR(batch.Consume(timeout_, max_messages, &messages));
+      for (const rd_kafka_message_t* message : messages) {
+        RdKafka::ErrorCode code = KafkaMessageBatch::err(message);
+        if (code == RdKafka::ERR_NO_ERROR) {
+          // Produce the line as output.
+          if (index + 1 < stop_offset) batch.Add(message);
+          index = message->offset;
+        } else if (code == RdKafka::ERR__PARTITION_EOF) {
+          LOG(ERROR) << "EOF Message: " << KafkaMessageBatch::errstr(message);
+          eof = true;
+          break;
+        } else if (code == RdKafka::ERR__TRANSPORT) {
+          // Not return error here because consumer will try re-connect.
+          LOG(ERROR) << "Broker transport failure: "
+                     << KafkaMessageBatch::errstr(message);
+        } else if (code != RdKafka::ERR__TIMED_OUT) {
+          LOG(ERROR) << "Failed to consume: "
+                     << KafkaMessageBatch::errstr(message);
+          return errors::Internal("Failed to consume: ",
+                                  KafkaMessageBatch::errstr(message));
+        }
+      }
+    }
+    TensorShape shape({static_cast<int64>(batch.size())});
+    Tensor* message_tensor;
+    Tensor* key_tensor;
+    TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
+    batch.Fill(message_tensor, key_tensor);
+    return OkStatus();
+  }
+
+  // Takes an idle reader, or creates one from the configuration of the
+  // resource, and assigns it the partition at `offset`.
+  Status AcquireReader(const int64 offset,
+                       std::unique_ptr<RdKafka::KafkaConsumer>* reader) {
+    string topic;
+    int32 partition;
+    {
+      mutex_lock l(mu_);
+      if (!readers_.empty()) {
+        *reader = std::move(readers_.back());
+        readers_.pop_back();
+      } else {
+        string errstr;
+        reader->reset(RdKafka::KafkaConsumer::create(conf_.get(), errstr));
+        if (!reader->get()) {
+          return errors::Internal("failed to create consumer:", errstr);
+        }
+      }
+      topic = subscription_->topic();
+      partition = subscription_->partition();
+    }
+    std::unique_ptr<RdKafka::TopicPartition> assignment(
+        RdKafka::TopicPartition::create(topic, partition, offset));
+    std::vector<RdKafka::TopicPartition*> partitions = {assignment.get()};
+    RdKafka::ErrorCode err = (*reader)->assign(partitions);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      (*reader)->close();
+      return errors::Internal("failed to assign partition: ",
+                              RdKafka::err2str(err));
+    }
+    return OkStatus();
+  }
+
   Status Tail(int64* tail_offset) {
     // Resolve tail message
     int64 saved = subscription_->offset();
@@ -361,6 +517,11 @@ class KafkaReadableResource : public ResourceBase {
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::TopicPartition> subscription_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::KafkaConsumer> consumer_ TF_GUARDED_BY(mu_);
+  // The configuration of consumer_, from which the readers of Read are
+  // created, and the idle ones.
+  std::unique_ptr<RdKafka::Conf> conf_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<RdKafka::KafkaConsumer>> readers_
+      TF_GUARDED_BY(mu_);
   KafkaEventCb kafka_event_cb_ = KafkaEventCb();
   static const int timeout_ = 5000;
 };
@@ -566,10 +727,75 @@ class KafkaIterableInitOp : public ResourceOpKernel<KafkaIterableResource> {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 */
+// The content tensor of a LayerKafkaResource::Write, whose elements are the
+// payloads of the messages produced from it, so that they are not copied.
+// It is released once librdkafka is done with every one of them.
+class KafkaProducedContent {
+ public:
+  explicit KafkaProducedContent(const Tensor& content)
+      : content_(content), references_(1) {}
+
+  const Tensor& content() const { return content_; }
+
+  void Ref() { references_.fetch_add(1, std::memory_order_relaxed); }
+  void Unref() {
+    if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+  }
+
+ private:
+  ~KafkaProducedContent() = default;
+
+  const Tensor content_;
+  std::atomic<int64> references_;
+};
+
+// Releases the content of each produced message and records the delivery
+// failures, which are reported by the next Write or Sync of the resource.
+class KafkaDeliveryReportCb : public RdKafka::DeliveryReportCb {
+ public:
+  void dr_cb(RdKafka::Message& message) override {
+    if (message.err() != RdKafka::ERR_NO_ERROR) {
+      mutex_lock l(mu_);
+      if (failures_++ == 0) {
+        error_ = errors::Internal("Failed to deliver message: ",
+                                  RdKafka::err2str(message.err()));
+      }
+    }
+    if (message.msg_opaque() != nullptr) {
+      static_cast<KafkaProducedContent*>(message.msg_opaque())->Unref();
+    }
+  }
+
+  // Returns and clears the first delivery failure since the last call.
+  Status TakeError() {
+    mutex_lock l(mu_);
+    Status error = error_;
+    if (failures_ > 1) {
+      LOG(ERROR) << failures_ << " Kafka messages failed to be delivered";
+    }
+    error_ = OkStatus();
+    failures_ = 0;
+    return error;
+  }
+
+ private:
+  mutex mu_;
+  Status error_ TF_GUARDED_BY(mu_);
+  int64 failures_ TF_GUARDED_BY(mu_) = 0;
+};
+
 class LayerKafkaResource : public ResourceBase {
  public:
   LayerKafkaResource(Env* env) : env_(env) {}
-  ~LayerKafkaResource() { Sync(); }
+  ~LayerKafkaResource() {
+    Sync().IgnoreError();
+    if (producer_.get() != nullptr) {
+      // Release the content of the messages that could not be delivered.
+      producer_->purge(RdKafka::Producer::PURGE_QUEUE |
+                       RdKafka::Producer::PURGE_INFLIGHT);
+      producer_->flush(0);
+    }
+  }
 
   Status Init(const string& topic, const int32 partition,
               const std::vector<string>& metadata) {
@@ -625,6 +851,11 @@ class LayerKafkaResource : public ResourceBase {
       LOG(INFO) << "Kafka default bootstrap server: " << bootstrap_servers;
     }
 
+    if ((result = conf->set("dr_cb", &delivery_report_cb_, errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("failed to set dr_cb:", errstr);
+    }
+
     producer_.reset(RdKafka::Producer::create(conf.get(), errstr));
     if (!(producer_.get() != nullptr)) {
       return errors::Internal("Failed to create producer:", errstr);
@@ -639,20 +870,41 @@ class LayerKafkaResource : public ResourceBase {
     partition_ = partition;
     return OkStatus();
   }
+  // Enqueues a message for every element of `content` without waiting for
+  // delivery. The payloads reference `content`, which is held until all of
+  // them are delivered, and batching follows the producer configuration,
+  // e.g. linger.ms, batch.size and compression.codec. A delivery failure is
+  // returned by the next Write or Sync.
   Status Write(const Tensor& content) {
     mutex_lock l(mu_);
+    // Serve the delivery reports of earlier writes.
+    producer_->poll(0);
+    TF_RETURN_IF_ERROR(delivery_report_cb_.TakeError());
+    KafkaProducedContent* produced = new KafkaProducedContent(content);
+    const auto flat = produced->content().flat<tstring>();
+    Status status;
     for (int64 i = 0; i < content.NumElements(); i++) {
-      RdKafka::ErrorCode err = producer_->produce(
-          topic_.get(), partition_, RdKafka::Producer::RK_MSG_COPY,
-          (void*)content.flat<tstring>()(i).data(),
-          content.flat<tstring>()(i).size(), NULL, NULL);
+      produced->Ref();
+      RdKafka::ErrorCode err;
+      while ((err = producer_->produce(topic_.get(), partition_, 0,
+                                       const_cast<char*>(flat(i).data()),
+                                       flat(i).size(), NULL, produced)) ==
+             RdKafka::ERR__QUEUE_FULL) {
+        // Wait for the delivery of queued messages to make room.
+        producer_->poll(queue_full_timeout_);
+      }
       if (!(err == RdKafka::ERR_NO_ERROR)) {
-        return errors::Internal("Failed to produce message:",
-                                RdKafka::err2str(err));
+        produced->Unref();
+        status = errors::Internal("Failed to produce message:",
+                                  RdKafka::err2str(err));
+        break;
       }
     }
-    return OkStatus();
+    produced->Unref();
+    return status;
   }
+  // Waits for the delivery of all written messages, e.g. at the end of a
+  // step or of training.
   Status Sync() {
     if (producer_.get() != nullptr) {
       RdKafka::ErrorCode err = producer_->flush(timeout_);
@@ -660,6 +912,7 @@ class LayerKafkaResource : public ResourceBase {
         return errors::Internal("Failed to flush message:",
                                 RdKafka::err2str(err));
       }
+      TF_RETURN_IF_ERROR(delivery_report_cb_.TakeError());
     }
     return OkStatus();
   }
@@ -668,10 +921,13 @@ class LayerKafkaResource : public ResourceBase {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  // Declared before the producer, which calls it until destroyed.
+  KafkaDeliveryReportCb delivery_report_cb_;
   std::unique_ptr<RdKafka::Producer> producer_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::Topic> topic_ TF_GUARDED_BY(mu_);
   int32 partition_ TF_GUARDED_BY(mu_);
   static const int timeout_ = 5000;
+  static const int queue_full_timeout_ = 100;
 };
 
 class LayerKafkaInitOp : public ResourceOpKernel<LayerKafkaResource> {
@@ -808,11 +1064,135 @@ class KafkaRebalanceCb : public RdKafka::RebalanceCb {
       partition_count = 0;
     }
     eof_count = 0;
+    if (listener_) listener_(err, partitions);
   }
 
+  typedef std::function<void(RdKafka::ErrorCode err,
+                             const std::vector<RdKafka::TopicPartition*>&)>
+      Listener;
+  // Sets a callback run after every assignment or revocation, e.g. to
+  // rebuild per-partition state. Must be set before the consumer is created.
+  void set_listener(Listener listener) { listener_ = std::move(listener); }
+
  private:
   mutable mutex mu_;
   bool run_ TF_GUARDED_BY(mu_) = true;
+  Listener listener_;
+};
+
+// Consumes one assigned partition on a background thread into a bounded
+// queue of its own, from which KafkaGroupReadableResource::Next merges the
+// assigned partitions. The partition queue is detached from the consumer
+// queue, so that partitions are fetched in parallel rather than one message
+// at a time through the consumer. The bytes of the queued messages are
+// accounted to the process-wide MemoryBudget, and fetching pauses while the
+// budget is exhausted.
+class KafkaPartitionFetcher {
+ public:
+  KafkaPartitionFetcher(Env* env, rd_kafka_t* rk, const string& topic,
+                        const int32 partition, const size_t capacity,
+                        std::function<void()> notify_func)
+      : queue_(rd_kafka_queue_get_partition(rk, topic.c_str(), partition)),
+        capacity_(capacity),
+        notify_func_(std::move(notify_func)) {
+    if (queue_ != nullptr) {
+      rd_kafka_queue_forward(queue_, nullptr);
+      thread_.reset(env->StartThread(ThreadOptions(), "kafka_partition_fetcher",
+                                     [this] { Run(); }));
+    }
+  }
+  ~KafkaPartitionFetcher() {
+    Stop();
+    for (rd_kafka_message_t* message : messages_) {
+      MemoryBudget::Global()->Release(kBudgetComponent, MessageBytes(message));
+      rd_kafka_message_destroy(message);
+    }
+    if (queue_ != nullptr) rd_kafka_queue_destroy(queue_);
+  }
+
+  // Stops fetching and waits for the fetch thread to finish.
+  void Stop() {
+    {
+      mutex_lock l(mu_);
+      stop_ = true;
+      not_full_.notify_all();
+    }
+    if (queue_ != nullptr) rd_kafka_queue_yield(queue_);
+    thread_.reset();
+  }
+
+  // Moves up to `max_messages` fetched messages, records or events such as
+  // the end of the partition, to `messages`. Returns how many were moved.
+  size_t Pop(const size_t max_messages,
+             std::vector<rd_kafka_message_t*>* messages) {
+    mutex_lock l(mu_);
+    size_t count = std::min(max_messages, messages_.size());
+    int64 bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+      bytes += MessageBytes(messages_[i]);
+    }
+    MemoryBudget::Global()->Release(kBudgetComponent, bytes);
+    messages->insert(messages->end(), messages_.begin(),
+                     messages_.begin() + count);
+    messages_.erase(messages_.begin(), messages_.begin() + count);
+    if (count > 0) not_full_.notify_all();
+    return count;
+  }
+
+ private:
+  void Run() {
+    std::vector<rd_kafka_message_t*> buffer(capacity_);
+    while (true) {
+      size_t space;
+      {
+        mutex_lock l(mu_);
+        while (!stop_ && (messages_.size() >= capacity_ ||
+                          (!messages_.empty() &&
+                           MemoryBudget::Global()->Exhausted()))) {
+          not_full_.wait(l);
+        }
+        if (stop_) return;
+        space = capacity_ - messages_.size();
+      }
+      ssize_t count = rd_kafka_consume_batch_queue(queue_, kFetchTimeout,
+                                                   buffer.data(), space);
+      if (count < 0) {
+        LOG(ERROR) << "Failed to fetch partition: "
+                   << rd_kafka_err2str(rd_kafka_last_error());
+        count = 0;
+      }
+      if (count == 0) continue;
+      int64 bytes = 0;
+      for (ssize_t i = 0; i < count; i++) {
+        bytes += MessageBytes(buffer[i]);
+      }
+      MemoryBudget::Global()->Reserve(kBudgetComponent, bytes);
+      {
+        mutex_lock l(mu_);
+        messages_.insert(messages_.end(), buffer.begin(),
+                         buffer.begin() + count);
+      }
+      notify_func_();
+    }
+  }
+
+  // The time in milliseconds a fetch waits for messages, which bounds how
+  // long it takes to notice a stop that races with the queue yield.
+  static const int kFetchTimeout = 100;
+  static constexpr char kBudgetComponent[] = "kafka_fetch_queue";
+
+  static int64 MessageBytes(const rd_kafka_message_t* message) {
+    return static_cast<int64>(message->len + message->key_len);
+  }
+
+  rd_kafka_queue_t* const queue_;
+  const size_t capacity_;
+  const std::function<void()> notify_func_;
+  mutex mu_;
+  condition_variable not_full_;
+  std::deque<rd_kafka_message_t*> messages_ TF_GUARDED_BY(mu_);
+  bool stop_ TF_GUARDED_BY(mu_) = false;
+  std::unique_ptr<Thread> thread_;
 };
 
 class KafkaGroupReadableResource : public ResourceBase {
@@ -820,8 +1200,16 @@ class KafkaGroupReadableResource : public ResourceBase {
   KafkaGroupReadableResource(Env* env) : env_(env) {}
   virtual ~KafkaGroupReadableResource() {
     if (consumer_.get()) {
+      // The records of the last batch may not have been taken downstream, so
+      // only the earlier batches are committed.
+      if (commit_interval_ms_ >= 0) CommitOffsets(true);
+      OnRebalance(RdKafka::ERR__REVOKE_PARTITIONS, {});
       consumer_->unassign();
       consumer_->close();
+      for (rd_kafka_message_t* message : revoked_messages_) {
+        rd_kafka_message_destroy(message);
+      }
+      revoked_messages_.clear();
       consumer_.reset(nullptr);
     }
   }
@@ -918,6 +1306,47 @@ class KafkaGroupReadableResource : public ResourceBase {
     sscanf(batch_num_messages.c_str(), "%d", &batch_num_messages_);
     LOG(INFO) << "max num of messages per batch: " << batch_num_messages_;
 
+    // With conf.partition.fetch.queue.max.messages=<n> each assigned
+    // partition is fetched by a background thread into a queue of up to n
+    // messages, instead of all partitions being consumed by Next.
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("conf.partition.fetch.queue.max.messages=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            sscanf(parts[1].c_str(), "%zu", &fetch_queue_max_messages_) != 1) {
+          return errors::InvalidArgument("invalid fetch configuration: ",
+                                         metadata[i]);
+        }
+        LOG(INFO) << "Kafka configuration: " << metadata[i];
+      }
+    }
+    // With conf.commit.interval.ms=<n> the offsets of the records of a batch
+    // are committed explicitly, in place of the auto commit.
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("conf.commit.interval.ms=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &commit_interval_ms_) ||
+            commit_interval_ms_ < 0) {
+          return errors::InvalidArgument("invalid commit configuration: ",
+                                         metadata[i]);
+        }
+        LOG(INFO) << "Kafka configuration: " << metadata[i];
+        if ((result = conf->set("enable.auto.commit", "false", errstr)) !=
+            RdKafka::Conf::CONF_OK) {
+          return errors::Internal("failed to set enable.auto.commit=false :",
+                                  errstr);
+        }
+      }
+    }
+    if (fetch_queue_max_messages_ > 0 || commit_interval_ms_ >= 0) {
+      kafka_rebalance_cb_.set_listener(
+          [this](RdKafka::ErrorCode err,
+                 const std::vector<RdKafka::TopicPartition*>& partitions) {
+            OnRebalance(err, partitions);
+          });
+    }
+
     // Always set enable.partition.eof=true
     if ((result = conf->set("enable.partition.eof", "true", errstr)) !=
         RdKafka::Conf::CONF_OK) {
@@ -959,53 +1388,100 @@ class KafkaGroupReadableResource : public ResourceBase {
                   allocate_func) {
     mutex_lock l(mu_);
 
+    // The batch before this one has been taken downstream once this one is
+    // requested, as the dataset stops at a batch that does not continue.
+    if (commit_interval_ms_ >= 0) {
+      for (const auto& offset : emitted_offsets_) {
+        pending_offsets_[offset.first] = offset.second;
+      }
+      emitted_offsets_.clear();
+      if (!pending_offsets_.empty() &&
+          env_->NowMicros() - last_commit_micros_ >=
+              static_cast<uint64>(commit_interval_ms_) * 1000) {
+        CommitOffsets(false);
+      }
+    }
+
     // Initialize necessary variables
-    int64 num_messages = 0;
     max_stream_timeout_polls_ = stream_timeout / message_poll_timeout;
 
-    // Allocate memory for message_value and key_value vectors
-    std::vector<string> message_value, key_value;
-    message_value.reserve(batch_num_messages_);
-    key_value.reserve(batch_num_messages_);
-
-    std::unique_ptr<RdKafka::Message> message;
-    while (consumer_.get() != nullptr && num_messages < batch_num_messages_) {
-      if (!kafka_event_cb_.run()) {
-        return errors::Internal(
-            "failed to consume messages due to broker issue");
-      }
-      message.reset(consumer_->consume(message_poll_timeout));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
+    // Consume the messages in batches, so that each payload is copied once.
+    // With partition fetchers only rebalances and the records delivered
+    // before a partition was detached arrive in the consumer queue, which is
+    // then polled without waiting.
+    KafkaMessageBatch batch(consumer_.get());
+    const size_t max_messages = static_cast<size_t>(batch_num_messages_);
+    bool done = false;
+    auto handle = [&](const rd_kafka_message_t* message) {
+      RdKafka::ErrorCode code = KafkaMessageBatch::err(message);
+      if (code == RdKafka::ERR_NO_ERROR) {
         // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
-        num_messages++;
+        batch.Add(message);
+        if (commit_interval_ms_ >= 0) {
+          emitted_offsets_[std::make_pair(
+              string(rd_kafka_topic_name(message->rkt)), message->partition)] =
+              message->offset;
+        }
         // Once a message has been successfully retrieved, the
         // `stream_timeout_polls_` is reset to 0. This allows the dataset
         // to wait for the entire `stream_timeout` duration when a data
         // slump occurs in the future.
         stream_timeout_polls_ = 0;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
+      } else if (code == RdKafka::ERR__TRANSPORT) {
         // Not returning an error here as the consumer will try to re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
+        LOG(ERROR) << "Broker transport failure: "
+                   << KafkaMessageBatch::errstr(message);
 
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
+      } else if (code == RdKafka::ERR__PARTITION_EOF) {
         if (++eof_count == partition_count) {
           LOG(INFO) << "EOF reached for all " << partition_count
                     << " partition(s)";
-          break;
+          done = true;
         }
-      } else if (message->err() == RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << message->errstr();
+      } else if (code == RdKafka::ERR__TIMED_OUT) {
+        LOG(ERROR) << KafkaMessageBatch::errstr(message);
         stream_timeout_polls_++;
-        break;
+        done = true;
+      }
+    };
+    std::vector<const rd_kafka_message_t*> messages;
+    std::vector<rd_kafka_message_t*> fetched;
+    while (!done && batch.size() < max_messages) {
+      if (!kafka_event_cb_.run()) {
+        return errors::Internal(
+            "failed to consume messages due to broker issue");
+      }
+      const int64 timeout = fetchers_.empty() ? message_poll_timeout : 0;
+      TF_RETURN_IF_ERROR(
+          batch.Consume(timeout, max_messages - batch.size(), &messages));
+      for (const rd_kafka_message_t* message : messages) handle(message);
+      // Records left by fetchers of revoked partitions, as well as those of
+      // the fetchers, taken round robin so that no partition starves.
+      fetched.swap(revoked_messages_);
+      for (size_t i = 0;
+           i < fetchers_.size() && fetched.size() + batch.size() < max_messages;
+           i++) {
+        next_fetcher_ = (next_fetcher_ + 1) % fetchers_.size();
+        fetchers_[next_fetcher_]->Pop(
+            max_messages - batch.size() - fetched.size(), &fetched);
+      }
+      for (rd_kafka_message_t* message : fetched) {
+        batch.Adopt(message);
+        handle(message);
       }
+      const bool received = !messages.empty() || !fetched.empty();
+      fetched.clear();
+      if (received || done) continue;
+      if (!fetchers_.empty() && WaitForFetchers(message_poll_timeout)) {
+        continue;
+      }
+      LOG(ERROR) << "Local: Timed out";
+      stream_timeout_polls_++;
+      break;
     }
 
     // Prepare the outputs
-    TensorShape shape({static_cast<int64>(message_value.size())});
+    TensorShape shape({static_cast<int64>(batch.size())});
     Tensor* message_tensor;
     Tensor* key_tensor;
     Tensor* continue_fetch_tensor;
@@ -1017,16 +1493,78 @@ class KafkaGroupReadableResource : public ResourceBase {
     } else {
       continue_fetch_tensor->scalar<int64>()() = 0;
     }
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
-    }
+    batch.Fill(message_tensor, key_tensor);
 
     return OkStatus();
   }
 
   string DebugString() const override { return "KafkaBaseResource"; }
 
+  // Commits the pending offsets, the offsets of the last records of the
+  // partitions in the batches taken downstream.
+  void CommitOffsets(const bool sync) {
+    last_commit_micros_ = env_->NowMicros();
+    if (pending_offsets_.empty()) return;
+    std::vector<RdKafka::TopicPartition*> partitions;
+    for (const auto& offset : pending_offsets_) {
+      partitions.push_back(RdKafka::TopicPartition::create(
+          offset.first.first, offset.first.second, offset.second + 1));
+    }
+    pending_offsets_.clear();
+    RdKafka::ErrorCode err = sync ? consumer_->commitSync(partitions)
+                                  : consumer_->commitAsync(partitions);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      LOG(WARNING) << "failed to commit offsets: " << RdKafka::err2str(err);
+    }
+    RdKafka::TopicPartition::destroy(partitions);
+  }
+
+  // Rebuilds the partition fetchers after a rebalance. Runs with `mu_` held,
+  // from a consume in Next or from the destructor. The records already
+  // fetched for revoked partitions are still returned by Next. Explicit
+  // commits are flushed on a revoke, and the offsets of the batch still
+  // downstream are dropped, as the partitions may now be committed by
+  // another consumer.
+  void OnRebalance(RdKafka::ErrorCode err,
+                   const std::vector<RdKafka::TopicPartition*>& partitions) {
+    if (commit_interval_ms_ >= 0 && err != RdKafka::ERR__ASSIGN_PARTITIONS &&
+        consumer_.get()) {
+      CommitOffsets(true);
+      emitted_offsets_.clear();
+    }
+    for (auto& fetcher : fetchers_) {
+      fetcher->Stop();
+      fetcher->Pop(std::numeric_limits<size_t>::max(), &revoked_messages_);
+    }
+    fetchers_.clear();
+    next_fetcher_ = 0;
+    if (err != RdKafka::ERR__ASSIGN_PARTITIONS) return;
+    if (fetch_queue_max_messages_ == 0) return;
+    for (const RdKafka::TopicPartition* partition : partitions) {
+      fetchers_.emplace_back(new KafkaPartitionFetcher(
+          env_, consumer_->c_ptr(), partition->topic(), partition->partition(),
+          fetch_queue_max_messages_, [this] { NotifyFetched(); }));
+    }
+    LOG(INFO) << "Started " << fetchers_.size() << " partition fetcher(s)";
+  }
+
+  void NotifyFetched() {
+    mutex_lock l(fetch_mu_);
+    fetch_count_++;
+    fetch_cv_.notify_all();
+  }
+
+  // Waits up to `timeout` ms for records fetched since the last wait.
+  bool WaitForFetchers(const int64 timeout) {
+    mutex_lock l(fetch_mu_);
+    if (fetch_count_ == fetch_count_seen_) {
+      fetch_cv_.wait_for(l, std::chrono::milliseconds(timeout));
+    }
+    const bool fetched = fetch_count_ != fetch_count_seen_;
+    fetch_count_seen_ = fetch_count_;
+    return fetched;
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   // std::unique_ptr<RdKafka::TopicPartition> subscription_ TF_GUARDED_BY(mu_);
@@ -1036,6 +1574,20 @@ class KafkaGroupReadableResource : public ResourceBase {
   int max_stream_timeout_polls_ = -1;
   int stream_timeout_polls_ = -1;
   int batch_num_messages_ = 1024;
+  size_t fetch_queue_max_messages_ = 0;
+  std::vector<std::unique_ptr<KafkaPartitionFetcher>> fetchers_;
+  size_t next_fetcher_ = 0;
+  std::vector<rd_kafka_message_t*> revoked_messages_;
+  mutex fetch_mu_;
+  condition_variable fetch_cv_;
+  uint64 fetch_count_ TF_GUARDED_BY(fetch_mu_) = 0;
+  uint64 fetch_count_seen_ TF_GUARDED_BY(fetch_mu_) = 0;
+  // The interval of explicit commits, -1 for the auto commit. The offsets
+  // are keyed by topic and partition.
+  int64 commit_interval_ms_ = -1;
+  std::map<std::pair<string, int32>, int64> emitted_offsets_;
+  std::map<std::pair<string, int32>, int64> pending_offsets_;
+  uint64 last_commit_micros_ = 0;
 };
 
 class KafkaGroupReadableInitOp
@@ -1126,10 +1678,12 @@ class KafkaGroupReadableNextOp : public OpKernel {
 
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableInit").Device(DEVICE_CPU),
                         KafkaReadableInitOp);
+// The reads wait on the brokers for up to their timeouts, so they are made
+// on the IO executor rather than on inter-op threads.
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableNext").Device(DEVICE_CPU),
-                        KafkaReadableNextOp);
+                        data::IOAsyncOpKernel<KafkaReadableNextOp>);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableRead").Device(DEVICE_CPU),
-                        KafkaReadableReadOp);
+                        data::IOAsyncOpKernel<KafkaReadableReadOp>);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableSpec").Device(DEVICE_CPU),
                         KafkaReadableSpecOp);
 REGISTER_KERNEL_BUILDER(Name("IO>LayerKafkaInit").Device(DEVICE_CPU),
@@ -1141,7 +1695,7 @@ REGISTER_KERNEL_BUILDER(Name("IO>LayerKafkaSync").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaGroupReadableInit").Device(DEVICE_CPU),
                         KafkaGroupReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaGroupReadableNext").Device(DEVICE_CPU),
-                        KafkaGroupReadableNextOp);
+                        data::IOAsyncOpKernel<KafkaGroupReadableNextOp>);
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -638,20 +638,16 @@ class KafkaOutputSequence : public OutputSequence {
     return OkStatus();
   }
   virtual Status Output() override {
-    if (fifo_.front().get() != nullptr) {
-      while (fifo_.size() != 0 && fifo_.front().get() != nullptr) {
-        RdKafka::ErrorCode err = producer_->produce(
-            topic_.get(), partition_, RdKafka::Producer::RK_MSG_COPY,
-            const_cast<char*>(fifo_.front().get()->c_str()),
-            fifo_.front().get()->size(), NULL, NULL);
-        if (!(err == RdKafka::ERR_NO_ERROR)) {
-          return errors::Internal("Failed to produce message:",
-                                  RdKafka::err2str(err));
-        }
-
-        fifo_.pop_front();
-        base_++;
+    while (HasFront()) {
+      RdKafka::ErrorCode err = producer_->produce(
+          topic_.get(), partition_, RdKafka::Producer::RK_MSG_COPY,
+          const_cast<char*>(Front().data()), Front().size(), NULL, NULL);
+      if (!(err == RdKafka::ERR_NO_ERROR)) {
+        return errors::Internal("Failed to produce message:",
+                                RdKafka::err2str(err));
       }
+
+      PopFront();
     }
     return OkStatus();
   }
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <deque>
+#include <iterator>
+
 #include <aws/core/Aws.h>
 #include <aws/core/config/AWSProfileConfigLoader.h>
 #include <aws/core/utils/Outcome.h>
@@ -21,11 +24,15 @@ limitations under the License.
 #include <aws/core/utils/crypto/Hash.h>
 #include <aws/core/utils/crypto/HashResult.h>
 #include <aws/kinesis/KinesisClient.h>
-#include <aws/kinesis/model/DescribeStreamRequest.h>
+#include <aws/kinesis/KinesisErrors.h>
 #include <aws/kinesis/model/GetRecordsRequest.h>
 #include <aws/kinesis/model/GetShardIteratorRequest.h>
+#include <aws/kinesis/model/ListShardsRequest.h>
 #include <aws/kinesis/model/PutRecordsRequest.h>
 #include <aws/kinesis/model/ShardIteratorType.h>
+#include <aws/kinesis/model/StartingPosition.h>
+#include <aws/kinesis/model/SubscribeToShardHandler.h>
+#include <aws/kinesis/model/SubscribeToShardRequest.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
 
@@ -253,10 +260,227 @@ void ShutdownClient(Aws::Kinesis::KinesisClient* client) {
   }
 }
 
+// Fetches the records of one shard on a background thread into a bounded
+// queue, from which KinesisReadableResource::Read merges the shards. Records
+// are polled with GetRecords in batches of up to `limit` records or, given the
+// ARN of a registered consumer, pushed by the service through an enhanced
+// fan-out SubscribeToShard subscription.
+class KinesisShardFetcher {
+ public:
+  KinesisShardFetcher(Env* env, Aws::Kinesis::KinesisClient* client,
+                      const string& stream, const Aws::String& shard,
+                      const Aws::String& sequence, const string& consumer,
+                      const int64 limit, const int64 interval,
+                      std::function<void()> notify_func)
+      : env_(env),
+        client_(client),
+        stream_(stream),
+        shard_(shard),
+        consumer_(consumer),
+        limit_(limit),
+        interval_(interval),
+        notify_func_(std::move(notify_func)),
+        position_(Aws::Kinesis::Model::ShardIteratorType::AT_SEQUENCE_NUMBER),
+        sequence_(sequence) {
+    thread_.reset(env->StartThread(ThreadOptions(), "kinesis_shard_fetcher",
+                                   [this] { Run(); }));
+  }
+  ~KinesisShardFetcher() {
+    {
+      mutex_lock l(mu_);
+      stop_ = true;
+      not_full_.notify_all();
+    }
+    // Joins the fetch thread.
+    thread_.reset();
+  }
+
+  // Moves up to `max_records` fetched records to `records`. Once all records
+  // are moved, `done` is set if the fetch has ended, with the error that ended
+  // it returned.
+  Status Pop(const size_t max_records,
+             std::vector<Aws::Kinesis::Model::Record>* records, bool* done) {
+    mutex_lock l(mu_);
+    size_t count = std::min(max_records, records_.size());
+    std::move(records_.begin(), records_.begin() + count,
+              std::back_inserter(*records));
+    records_.erase(records_.begin(), records_.begin() + count);
+    if (count > 0) not_full_.notify_all();
+    *done = finished_ && records_.empty();
+    return *done ? status_ : OkStatus();
+  }
+
+ private:
+  void Run() {
+    Status status = consumer_.empty() ? Poll() : Subscribe();
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to fetch shard " << shard_ << ": " << status;
+    }
+    {
+      mutex_lock l(mu_);
+      finished_ = true;
+      status_ = status;
+    }
+    notify_func_();
+  }
+
+  bool Stopped() {
+    mutex_lock l(mu_);
+    return stop_;
+  }
+
+  // Queues the records, waiting while the queue is full. Returns false once
+  // the fetcher is stopped.
+  bool Push(const Aws::Vector<Aws::Kinesis::Model::Record>& records) {
+    if (records.empty()) return true;
+    {
+      mutex_lock l(mu_);
+      while (!stop_ && records_.size() >= static_cast<size_t>(limit_)) {
+        not_full_.wait(l);
+      }
+      if (stop_) return false;
+      records_.insert(records_.end(), records.begin(), records.end());
+    }
+    // Fetches resume after the last queued record.
+    position_ = Aws::Kinesis::Model::ShardIteratorType::AFTER_SEQUENCE_NUMBER;
+    sequence_ = records.back().GetSequenceNumber();
+    notify_func_();
+    return true;
+  }
+
+  Status Poll() {
+    Aws::String iterator;
+    while (!Stopped()) {
+      if (iterator.empty()) {
+        Aws::Kinesis::Model::GetShardIteratorRequest request;
+        auto outcome = client_->GetShardIterator(
+            request.WithStreamName(stream_.c_str())
+                .WithShardId(shard_)
+                .WithShardIteratorType(position_)
+                .WithStartingSequenceNumber(sequence_));
+        if (!outcome.IsSuccess()) {
+          return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
+                                 outcome.GetError().GetMessage());
+        }
+        iterator = outcome.GetResult().GetShardIterator();
+      }
+      Aws::Kinesis::Model::GetRecordsRequest request;
+      auto outcome = client_->GetRecords(
+          request.WithShardIterator(iterator).WithLimit(limit_));
+      if (!outcome.IsSuccess()) {
+        const auto& error = outcome.GetError();
+        if (error.GetErrorType() ==
+            Aws::Kinesis::KinesisErrors::EXPIRED_ITERATOR) {
+          iterator.clear();
+          continue;
+        }
+        if (error.ShouldRetry()) {
+          // E.g. the read throughput of the shard is exceeded.
+          env_->SleepForMicroseconds(interval_);
+          continue;
+        }
+        return errors::Unknown(error.GetExceptionName(), ": ",
+                               error.GetMessage());
+      }
+      const auto& result = outcome.GetResult();
+      if (!Push(result.GetRecords())) break;
+      iterator = result.GetNextShardIterator();
+      if (iterator.empty()) {
+        LOG(INFO) << "Shard " << shard_ << " is closed";
+        break;
+      }
+      if (result.GetRecords().empty()) {
+        // No records are available at the moment, continue the loop after a
+        // period of time.
+        env_->SleepForMicroseconds(interval_);
+      }
+    }
+    return OkStatus();
+  }
+
+  Status Subscribe() {
+    while (!Stopped()) {
+      bool stopped = false;
+      bool closed = false;
+      Aws::Kinesis::Model::SubscribeToShardHandler handler;
+      handler.SetSubscribeToShardEventCallback(
+          [&](const Aws::Kinesis::Model::SubscribeToShardEvent& event) {
+            if (!Push(event.GetRecords())) {
+              stopped = true;
+              return;
+            }
+            // A closed shard has no continuation once all records are read.
+            closed = event.GetContinuationSequenceNumber().empty();
+            if (!closed) {
+              position_ = Aws::Kinesis::Model::ShardIteratorType::
+                  AFTER_SEQUENCE_NUMBER;
+              sequence_ = event.GetContinuationSequenceNumber();
+            }
+          });
+      handler.SetOnErrorCallback(
+          [&](const Aws::Client::AWSError<Aws::Kinesis::KinesisErrors>&
+                  error) {
+            LOG(ERROR) << "Subscription to shard " << shard_
+                       << " failed: " << error.GetExceptionName() << ": "
+                       << error.GetMessage();
+          });
+      Aws::Kinesis::Model::SubscribeToShardRequest request;
+      request.WithConsumerARN(consumer_.c_str())
+          .WithShardId(shard_)
+          .WithStartingPosition(Aws::Kinesis::Model::StartingPosition()
+                                    .WithType(position_)
+                                    .WithSequenceNumber(sequence_));
+      request.SetEventStreamHandler(handler);
+      // Aborts the subscription once the fetcher is stopped.
+      request.SetContinueRequestHandler(
+          [this](const Aws::Http::HttpRequest*) { return !Stopped(); });
+      // A subscription lasts up to five minutes, after which it is renewed
+      // from the continuation sequence number.
+      auto outcome = client_->SubscribeToShard(request);
+      if (stopped) break;
+      if (closed) {
+        LOG(INFO) << "Shard " << shard_ << " is closed";
+        break;
+      }
+      if (!outcome.IsSuccess()) {
+        const auto& error = outcome.GetError();
+        if (!error.ShouldRetry()) {
+          return errors::Unknown(error.GetExceptionName(), ": ",
+                                 error.GetMessage());
+        }
+        env_->SleepForMicroseconds(interval_);
+      }
+    }
+    return OkStatus();
+  }
+
+  Env* const env_;
+  Aws::Kinesis::KinesisClient* const client_;
+  const string stream_;
+  const Aws::String shard_;
+  const string consumer_;
+  const int64 limit_;
+  const int64 interval_;
+  const std::function<void()> notify_func_;
+  // Where fetches resume, only used by the fetch thread.
+  Aws::Kinesis::Model::ShardIteratorType position_;
+  Aws::String sequence_;
+  mutex mu_;
+  condition_variable not_full_;
+  std::deque<Aws::Kinesis::Model::Record> records_ TF_GUARDED_BY(mu_);
+  bool stop_ TF_GUARDED_BY(mu_) = false;
+  bool finished_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_;
+};
+
 class KinesisReadableResource : public ResourceBase {
  public:
   KinesisReadableResource(Env* env)
-      : env_(env), client_(nullptr, ShutdownClient), interval_(100000) {}
+      : env_(env),
+        client_(nullptr, ShutdownClient),
+        interval_(100000),
+        limit_(kMaxRecordsPerRead) {}
   virtual ~KinesisReadableResource() {}
 
   Status Init(const string& input, const std::vector<string>& metadata) {
@@ -264,6 +488,7 @@ class KinesisReadableResource : public ResourceBase {
 
     stream_ = input;
     shard_ = "";
+    string consumer;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("shard=") == 0) {
         std::vector<string> parts = str_util::Split(metadata[i], "=");
@@ -272,65 +497,57 @@ class KinesisReadableResource : public ResourceBase {
                                          metadata[i]);
         }
         shard_ = parts[1];
+      } else if (metadata[i].find("limit=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 || !strings::safe_strto64(parts[1], &limit_) ||
+            limit_ <= 0 || limit_ > kMaxRecordsPerRead) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+      } else if (metadata[i].find("consumer=") == 0) {
+        // The ARN of a consumer registered for enhanced fan-out.
+        consumer = metadata[i].substr(strlen("consumer="));
       }
     }
 
     AwsInitAPI();
     client_.reset(new Aws::Kinesis::KinesisClient(GetDefaultClientConfig()));
 
-    Aws::Kinesis::Model::DescribeStreamRequest request;
-    auto outcome =
-        client_->DescribeStream(request.WithStreamName(stream_.c_str()));
-    if (!outcome.IsSuccess()) {
-      return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
-                             outcome.GetError().GetMessage());
-    }
-    Aws::String shard;
-    Aws::String sequence;
-    if (shard_ == "") {
-      if (outcome.GetResult().GetStreamDescription().GetShards().size() != 1) {
-        return errors::InvalidArgument(
-            "shard has to be provided unless the stream only have one "
-            "shard, there are ",
-            outcome.GetResult().GetStreamDescription().GetShards().size(),
-            " shards in stream ", stream_);
+    // Shards are listed in pages, the stream name is only given for the first.
+    std::vector<Aws::Kinesis::Model::Shard> shards;
+    Aws::String next_token;
+    do {
+      Aws::Kinesis::Model::ListShardsRequest request;
+      if (next_token.empty()) {
+        request.SetStreamName(stream_.c_str());
+      } else {
+        request.SetNextToken(next_token);
       }
-      shard = outcome.GetResult()
-                  .GetStreamDescription()
-                  .GetShards()[0]
-                  .GetShardId();
-      sequence = outcome.GetResult()
-                     .GetStreamDescription()
-                     .GetShards()[0]
-                     .GetSequenceNumberRange()
-                     .GetStartingSequenceNumber();
-    } else {
-      for (const auto& entry :
-           outcome.GetResult().GetStreamDescription().GetShards()) {
-        if (entry.GetShardId() == shard_.c_str()) {
-          shard = entry.GetShardId();
-          sequence = entry.GetSequenceNumberRange().GetStartingSequenceNumber();
-          break;
-        }
+      auto outcome = client_->ListShards(request);
+      if (!outcome.IsSuccess()) {
+        return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
+                               outcome.GetError().GetMessage());
       }
-      if (shard == "") {
-        return errors::InvalidArgument("no shard ", shard_, " in stream ",
-                                       stream_);
+      for (const auto& entry : outcome.GetResult().GetShards()) {
+        if (shard_ == "" || entry.GetShardId() == shard_.c_str()) {
+          shards.push_back(entry);
+        }
       }
+      next_token = outcome.GetResult().GetNextToken();
+    } while (!next_token.empty());
+    if (shards.empty()) {
+      return errors::InvalidArgument("no shard ", shard_, " in stream ",
+                                     stream_);
     }
 
-    Aws::Kinesis::Model::GetShardIteratorRequest iterator_request;
-    auto iterator_outcome = client_->GetShardIterator(
-        iterator_request.WithStreamName(stream_.c_str())
-            .WithShardId(shard)
-            .WithShardIteratorType(
-                Aws::Kinesis::Model::ShardIteratorType::AT_SEQUENCE_NUMBER)
-            .WithStartingSequenceNumber(sequence));
-    if (!iterator_outcome.IsSuccess()) {
-      return errors::Unknown(iterator_outcome.GetError().GetExceptionName(),
-                             ": ", iterator_outcome.GetError().GetMessage());
+    // Every shard is fetched by a thread of its own, each shard allows up to
+    // five GetRecords calls per second.
+    for (const auto& entry : shards) {
+      fetchers_.emplace_back(new KinesisShardFetcher(
+          env_, client_.get(), stream_, entry.GetShardId(),
+          entry.GetSequenceNumberRange().GetStartingSequenceNumber(), consumer,
+          limit_, interval_, [this] { NotifyFetched(); }));
     }
-    iterator_ = iterator_outcome.GetResult().GetShardIterator();
     return OkStatus();
   }
   Status Read(
@@ -339,53 +556,50 @@ class KinesisReadableResource : public ResourceBase {
                            Tensor** sequence_tensor)>
           allocate_func) {
     mutex_lock l(mu_);
-    do {
-      Aws::Kinesis::Model::GetRecordsRequest request;
-      auto outcome = client_->GetRecords(
-          request.WithShardIterator(iterator_).WithLimit(1));
-      if (!outcome.IsSuccess()) {
-        return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
-                               outcome.GetError().GetMessage());
+    // Takes the fetched records of the shards round robin, so that no shard
+    // starves, and waits for records unless all shards are closed.
+    std::vector<Aws::Kinesis::Model::Record> records;
+    Status status;
+    while (status.ok()) {
+      const int64 fetch_count = FetchCount();
+      bool done = true;
+      for (size_t i = 0; i < fetchers_.size() &&
+                         records.size() < static_cast<size_t>(limit_) &&
+                         status.ok();
+           i++) {
+        next_fetcher_ = (next_fetcher_ + 1) % fetchers_.size();
+        bool fetcher_done;
+        status = fetchers_[next_fetcher_]->Pop(limit_ - records.size(),
+                                               &records, &fetcher_done);
+        done = done && fetcher_done;
       }
-      if (outcome.GetResult().GetRecords().size() == 0) {
-        // TODO: break if option provided, as no records were returned then
-        // nothing is available at the moment.
-
-        // Otherwise continue the loop after a period of time.
-        env_->SleepForMicroseconds(interval_);
-        continue;
-      }
-      if (outcome.GetResult().GetRecords().size() != 1) {
-        return errors::Unknown("invalid number of records ",
-                               outcome.GetResult().GetRecords().size(),
-                               " returned");
-      }
-      iterator_ = outcome.GetResult().GetNextShardIterator();
-
-      Tensor* timestamp_tensor;
-      Tensor* data_tensor;
-      Tensor* partition_tensor;
-      Tensor* sequence_tensor;
-      TF_RETURN_IF_ERROR(allocate_func(TensorShape({1}), &timestamp_tensor,
-                                       &data_tensor, &partition_tensor,
-                                       &sequence_tensor));
-      const auto& timestamp =
-          outcome.GetResult().GetRecords()[0].GetApproximateArrivalTimestamp();
-      const auto& data = outcome.GetResult().GetRecords()[0].GetData();
-      const auto& partition =
-          outcome.GetResult().GetRecords()[0].GetPartitionKey();
-      const auto& sequence =
-          outcome.GetResult().GetRecords()[0].GetSequenceNumber();
-      timestamp_tensor->flat<int64>()(0) = timestamp.Millis();
-      data_tensor->flat<tstring>()(0) =
-          string(reinterpret_cast<const char*>(data.GetUnderlyingData()),
-                 data.GetLength());
-      partition_tensor->flat<tstring>()(0) =
-          string(partition.c_str(), partition.size());
-      sequence_tensor->flat<tstring>()(0) =
-          string(sequence.c_str(), sequence.size());
-      return OkStatus();
-    } while (true);
+      if (!records.empty() || done) break;
+      if (status.ok()) WaitForFetchers(fetch_count);
+    }
+    // The records taken before a shard failed are returned first.
+    if (records.empty()) TF_RETURN_IF_ERROR(status);
+
+    Tensor* timestamp_tensor;
+    Tensor* data_tensor;
+    Tensor* partition_tensor;
+    Tensor* sequence_tensor;
+    TF_RETURN_IF_ERROR(allocate_func(
+        TensorShape({static_cast<int64>(records.size())}), &timestamp_tensor,
+        &data_tensor, &partition_tensor, &sequence_tensor));
+    for (size_t i = 0; i < records.size(); i++) {
+      const auto& timestamp = records[i].GetApproximateArrivalTimestamp();
+      const auto& data = records[i].GetData();
+      const auto& partition = records[i].GetPartitionKey();
+      const auto& sequence = records[i].GetSequenceNumber();
+      timestamp_tensor->flat<int64>()(i) = timestamp.Millis();
+      data_tensor->flat<tstring>()(i).assign(
+          reinterpret_cast<const char*>(data.GetUnderlyingData()),
+          data.GetLength());
+      partition_tensor->flat<tstring>()(i).assign(partition.c_str(),
+                                                  partition.size());
+      sequence_tensor->flat<tstring>()(i).assign(sequence.c_str(),
+                                                 sequence.size());
+    }
     return OkStatus();
   }
   string DebugString() const override {
@@ -394,14 +608,40 @@ class KinesisReadableResource : public ResourceBase {
   }
 
  protected:
+  // The most records a GetRecords call returns.
+  static const int64 kMaxRecordsPerRead = 10000;
+
+  void NotifyFetched() {
+    mutex_lock l(fetch_mu_);
+    fetch_count_++;
+    fetch_cv_.notify_all();
+  }
+  int64 FetchCount() {
+    mutex_lock l(fetch_mu_);
+    return fetch_count_;
+  }
+  // Waits until a fetcher has queued records, or ended, since `fetch_count`.
+  void WaitForFetchers(const int64 fetch_count) {
+    mutex_lock l(fetch_mu_);
+    while (fetch_count_ == fetch_count) fetch_cv_.wait(l);
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   string stream_ TF_GUARDED_BY(mu_);
   string shard_ TF_GUARDED_BY(mu_);
-  Aws::String iterator_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Aws::Kinesis::KinesisClient, decltype(&ShutdownClient)>
       client_ TF_GUARDED_BY(mu_);
   int64 interval_ TF_GUARDED_BY(mu_);
+  int64 limit_ TF_GUARDED_BY(mu_);
+  mutex fetch_mu_;
+  condition_variable fetch_cv_;
+  int64 fetch_count_ TF_GUARDED_BY(fetch_mu_) = 0;
+  // Declared last, so that the fetchers are stopped before the client is shut
+  // down.
+  std::vector<std::unique_ptr<KinesisShardFetcher>> fetchers_
+      TF_GUARDED_BY(mu_);
+  size_t next_fetcher_ TF_GUARDED_BY(mu_) = 0;
 };
 
 class KinesisReadableInitOp : public ResourceOpKernel<KinesisReadableResource> {
@@ -13,15 +13,188 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <type_traits>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/charconv.h"
+#include "absl/strings/numbers.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
-#include "tensorflow/core/lib/strings/numbers.h"
-#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
+namespace {
+
+// Parses a number of a LibSVM line in place, with a leading '+' allowed as
+// labels are often written as "+1".
+template <typename N>
+typename std::enable_if<std::is_floating_point<N>::value, bool>::type
+ParseLibsvmNumber(StringPiece s, N* value) {
+  if (!s.empty() && s[0] == '+') {
+    s.remove_prefix(1);
+  }
+  if (s.empty()) {
+    return false;
+  }
+  absl::from_chars_result result =
+      absl::from_chars(s.data(), s.data() + s.size(), *value);
+  return result.ptr == s.data() + s.size() &&
+         result.ec != std::errc::invalid_argument;
+}
+
+template <typename N>
+typename std::enable_if<std::is_integral<N>::value, bool>::type
+ParseLibsvmNumber(StringPiece s, N* value) {
+  return absl::SimpleAtoi(s, value);
+}
+
+// Moves `line` past leading whitespace, then consumes the token up to the
+// next whitespace into `token`. Returns false if there is none.
+bool ConsumeLibsvmToken(StringPiece* line, StringPiece* token) {
+  const char* p = line->data();
+  const char* end = p + line->size();
+  while (p < end && absl::ascii_isspace(*p)) {
+    p++;
+  }
+  const char* start = p;
+  while (p < end && !absl::ascii_isspace(*p)) {
+    p++;
+  }
+  *token = StringPiece(start, p - start);
+  *line = StringPiece(p, end - p);
+  return !token->empty();
+}
+
+// The features of a block of consecutive rows, parsed by one worker.
+template <typename T>
+struct LibsvmBlock {
+  int64 begin = 0;
+  int64 end = 0;
+  std::vector<T> values;
+  std::vector<int64> features;
+  // The number of features of each row of the block.
+  std::vector<int64> lengths;
+  Status status;
+};
+
+// Parses the rows of `input` into blocks, split across the CPU worker
+// threads, and sets the labels. The features of the blocks are in row order.
+template <typename T, typename Tlabel>
+Status ParseLibsvm(OpKernelContext* ctx,
+                   const typename TTypes<tstring>::ConstFlat& input,
+                   typename TTypes<Tlabel>::Flat label,
+                   std::vector<LibsvmBlock<T>>* blocks) {
+  static constexpr int64 kMinBlockRows = 1024;
+  const DeviceBase::CpuWorkerThreads* worker_threads =
+      ctx->device()->tensorflow_cpu_worker_threads();
+  const int64 rows = input.size();
+  const int64 count = std::max<int64>(
+      1, std::min<int64>(worker_threads->num_threads, rows / kMinBlockRows));
+  blocks->resize(count);
+  for (int64 b = 0; b < count; b++) {
+    (*blocks)[b].begin = rows * b / count;
+    (*blocks)[b].end = rows * (b + 1) / count;
+  }
+
+  auto parse = [&](LibsvmBlock<T>* block) -> Status {
+    block->lengths.reserve(block->end - block->begin);
+    for (int64 i = block->begin; i < block->end; ++i) {
+      StringPiece line(input(i));
+      StringPiece piece;
+      if (!ConsumeLibsvmToken(&line, &piece)) {
+        return errors::InvalidArgument("No label found for input[", i, "]: \"",
+                                       input(i), "\"");
+      }
+      Tlabel label_value;
+      if (!ParseLibsvmNumber<Tlabel>(piece, &label_value)) {
+        return errors::InvalidArgument("Label format incorrect: ", piece);
+      }
+      label(i) = label_value;
+
+      int64 length = 0;
+      while (ConsumeLibsvmToken(&line, &piece)) {
+        size_t p = piece.find(':');
+        if (p == StringPiece::npos) {
+          return errors::InvalidArgument("Invalid feature \"", piece, "\"");
+        }
+        int64 feature_index;
+        if (!ParseLibsvmNumber<int64>(piece.substr(0, p), &feature_index)) {
+          return errors::InvalidArgument("Feature format incorrect: ", piece);
+        }
+        if (feature_index < 0) {
+          return errors::InvalidArgument("Feature index should be >= 0, got ",
+                                         feature_index);
+        }
+        T feature_value;
+        if (!ParseLibsvmNumber<T>(piece.substr(p + 1), &feature_value)) {
+          return errors::InvalidArgument("Feature format incorrect: ", piece);
+        }
+        block->values.push_back(feature_value);
+        block->features.push_back(feature_index);
+        length++;
+      }
+      block->lengths.push_back(length);
+    }
+    return OkStatus();
+  };
+
+  // Each unit of work is one block, so the cost keeps them on their own
+  // threads.
+  Shard(worker_threads->num_threads, worker_threads->workers, count,
+        kMinBlockRows * 1000, [&](int64 begin, int64 end) {
+          for (int64 b = begin; b < end; b++) {
+            (*blocks)[b].status = parse(&(*blocks)[b]);
+          }
+        });
+  // The error of the first row that fails, as a sequential parse reports.
+  for (const LibsvmBlock<T>& block : *blocks) {
+    TF_RETURN_IF_ERROR(block.status);
+  }
+  return OkStatus();
+}
+
+// Copies the features of the blocks to `values` and `features`, calling
+// `copy_row(row, offset, length)` for each row, in parallel by block.
+template <typename T>
+void WriteLibsvmBlocks(OpKernelContext* ctx,
+                       const std::vector<LibsvmBlock<T>>& blocks,
+                       const std::vector<int64>& offsets, T* values,
+                       const std::function<void(int64, int64, int64)>& copy_row,
+                       const std::function<void(int64, int64)>& copy_feature) {
+  const DeviceBase::CpuWorkerThreads* worker_threads =
+      ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, blocks.size(),
+        1 << 20, [&](int64 begin, int64 end) {
+          for (int64 b = begin; b < end; b++) {
+            const LibsvmBlock<T>& block = blocks[b];
+            std::copy(block.values.begin(), block.values.end(),
+                      values + offsets[b]);
+            int64 offset = offsets[b];
+            for (size_t r = 0; r < block.lengths.size(); r++) {
+              copy_row(block.begin + r, offset, block.lengths[r]);
+              offset += block.lengths[r];
+            }
+            for (size_t k = 0; k < block.features.size(); k++) {
+              copy_feature(offsets[b] + k, block.features[k]);
+            }
+          }
+        });
+}
+
+template <typename T>
+std::vector<int64> LibsvmBlockOffsets(
+    const std::vector<LibsvmBlock<T>>& blocks) {
+  std::vector<int64> offsets(blocks.size() + 1, 0);
+  for (size_t b = 0; b < blocks.size(); b++) {
+    offsets[b + 1] = offsets[b] + blocks[b].values.size();
+  }
+  return offsets;
+}
+
+}  // namespace
 
 template <typename T, typename Tlabel>
 class DecodeLibsvmOp : public OpKernel {
@@ -43,94 +216,111 @@ class DecodeLibsvmOp : public OpKernel {
         ctx, ctx->allocate_output(0, input_tensor->shape(), &label_tensor));
     auto label = label_tensor->flat<Tlabel>();
 
-    std::vector<T> out_values;
-    std::vector<std::pair<int64, int64>> out_indices;
-    for (int i = 0; i < input_flat.size(); ++i) {
-      StringPiece line(input_flat(i));
-      str_util::RemoveWhitespaceContext(&line);
-
-      StringPiece piece;
-      OP_REQUIRES(ctx, str_util::ConsumeNonWhitespace(&line, &piece),
-                  errors::InvalidArgument("No label found for input[", i,
-                                          "]: \"", input_flat(i), "\""));
-
-      Tlabel label_value;
-      OP_REQUIRES(ctx,
-                  strings::SafeStringToNumeric<Tlabel>(piece, &label_value),
-                  errors::InvalidArgument("Label format incorrect: ", piece));
-
-      label(i) = label_value;
-
-      str_util::RemoveLeadingWhitespace(&line);
-      while (str_util::ConsumeNonWhitespace(&line, &piece)) {
-        size_t p = piece.find(':');
-        OP_REQUIRES(ctx, (p != StringPiece::npos),
-                    errors::InvalidArgument("Invalid feature \"", piece, "\""));
-
-        int64 feature_index;
-        OP_REQUIRES(
-            ctx, strings::safe_strto64(piece.substr(0, p), &feature_index),
-            errors::InvalidArgument("Feature format incorrect: ", piece));
-        OP_REQUIRES(ctx, (feature_index >= 0),
-                    errors::InvalidArgument(
-                        "Feature index should be >= 0, got ", feature_index));
-
-        T feature_value;
-        OP_REQUIRES(
-
-            ctx,
-            strings::SafeStringToNumeric<T>(piece.substr(p + 1),
-                                            &feature_value),
-            errors::InvalidArgument("Feature format incorrect: ", piece));
-
-        out_values.emplace_back(feature_value);
-        out_indices.emplace_back(std::pair<int64, int64>(i, feature_index));
-
-        str_util::RemoveLeadingWhitespace(&line);
-      }
-    }
+    std::vector<LibsvmBlock<T>> blocks;
+    OP_REQUIRES_OK(ctx, (ParseLibsvm<T, Tlabel>(ctx, input_flat, label,
+                                                &blocks)));
+    const std::vector<int64> offsets = LibsvmBlockOffsets(blocks);
+    const int64 total = offsets.back();
 
+    const int dims = input_tensor->shape().dims();
     Tensor* indices_tensor;
-    OP_REQUIRES_OK(ctx, ctx->allocate_output(
-                            1,
-                            TensorShape({static_cast<int64>(out_indices.size()),
-                                         input_tensor->shape().dims() + 1}),
-                            &indices_tensor));
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(1, TensorShape({total, dims + 1}),
+                                             &indices_tensor));
     auto indices = indices_tensor->matrix<int64>();
     // Translate flat index to shaped index like np.unravel_index
     // Calculate factors for each dimension
-    std::vector<int64> factors(input_tensor->shape().dims());
-    factors[input_tensor->shape().dims() - 1] = 1;
-    for (int j = input_tensor->shape().dims() - 2; j >= 0; j--) {
-      factors[j] = factors[j + 1] * input_tensor->shape().dim_size(j + 1);
+    std::vector<int64> factors(dims);
+    if (dims > 0) {
+      factors[dims - 1] = 1;
     }
-    for (int i = 0; i < out_indices.size(); i++) {
-      indices(i, 0) = out_indices[i].first;
-      int64 value = out_indices[i].first;
-      for (int j = 0; j < input_tensor->shape().dims(); j++) {
-        indices(i, j) = value / factors[j];
-        value = value % factors[j];
-      }
-      indices(i, input_tensor->shape().dims()) = out_indices[i].second;
+    for (int j = dims - 2; j >= 0; j--) {
+      factors[j] = factors[j + 1] * input_tensor->shape().dim_size(j + 1);
     }
 
     Tensor* values_tensor;
-    OP_REQUIRES_OK(ctx,
-                   ctx->allocate_output(
-                       2, TensorShape({static_cast<int64>(out_values.size())}),
-                       &values_tensor));
-    auto values = values_tensor->vec<T>();
-    std::copy_n(out_values.begin(), out_values.size(), &values(0));
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(2, TensorShape({total}), &values_tensor));
+
+    WriteLibsvmBlocks<T>(
+        ctx, blocks, offsets, values_tensor->flat<T>().data(),
+        [&](int64 row, int64 offset, int64 length) {
+          for (int64 k = offset; k < offset + length; k++) {
+            int64 value = row;
+            for (int j = 0; j < dims; j++) {
+              indices(k, j) = value / factors[j];
+              value = value % factors[j];
+            }
+          }
+        },
+        [&](int64 k, int64 feature) { indices(k, dims) = feature; });
 
     Tensor* shape_tensor;
-    OP_REQUIRES_OK(ctx, ctx->allocate_output(
-                            3, TensorShape({input_tensor->shape().dims() + 1}),
-                            &shape_tensor));
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(3, TensorShape({dims + 1}), &shape_tensor));
     auto shape = shape_tensor->flat<int64>();
-    for (int i = 0; i < input_tensor->shape().dims(); i++) {
+    for (int i = 0; i < dims; i++) {
       shape(i) = input_tensor->shape().dim_size(i);
     }
-    shape(input_tensor->shape().dims()) = num_features_;
+    shape(dims) = num_features_;
+  }
+
+ private:
+  int64 num_features_;
+};
+
+// Decodes LibSVM rows into the CSR layout of row_splits, feature indices and
+// feature values, which are the row partition and values of a RaggedTensor.
+template <typename T, typename Tlabel>
+class DecodeLibsvmCSROp : public OpKernel {
+ public:
+  explicit DecodeLibsvmCSROp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_features", &num_features_));
+    OP_REQUIRES(ctx, (num_features_ >= 1),
+                errors::InvalidArgument("Invalid number of features \"",
+                                        num_features_, "\""));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("input", &input_tensor));
+    OP_REQUIRES(ctx, input_tensor->dims() == 1,
+                errors::InvalidArgument("input must be a vector, got shape ",
+                                        input_tensor->shape().DebugString()));
+    const auto& input_flat = input_tensor->flat<tstring>();
+
+    Tensor* label_tensor;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(0, input_tensor->shape(), &label_tensor));
+    auto label = label_tensor->flat<Tlabel>();
+
+    std::vector<LibsvmBlock<T>> blocks;
+    OP_REQUIRES_OK(ctx, (ParseLibsvm<T, Tlabel>(ctx, input_flat, label,
+                                                &blocks)));
+    const std::vector<int64> offsets = LibsvmBlockOffsets(blocks);
+    const int64 total = offsets.back();
+    const int64 rows = input_flat.size();
+
+    Tensor* row_splits_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(1, TensorShape({rows + 1}),
+                                             &row_splits_tensor));
+    auto row_splits = row_splits_tensor->flat<int64>();
+    row_splits(0) = 0;
+
+    Tensor* indices_tensor;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(2, TensorShape({total}), &indices_tensor));
+    auto indices = indices_tensor->flat<int64>();
+
+    Tensor* values_tensor;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(3, TensorShape({total}), &values_tensor));
+
+    WriteLibsvmBlocks<T>(
+        ctx, blocks, offsets, values_tensor->flat<T>().data(),
+        [&](int64 row, int64 offset, int64 length) {
+          row_splits(row + 1) = offset + length;
+        },
+        [&](int64 k, int64 feature) { indices(k) = feature; });
   }
 
  private:
@@ -157,7 +347,27 @@ class DecodeLibsvmOp : public OpKernel {
                               .Device(DEVICE_CPU)                     \
                               .TypeConstraint<type>("dtype")          \
                               .TypeConstraint<double>("label_dtype"), \
-                          DecodeLibsvmOp<type, double>);
+                          DecodeLibsvmOp<type, double>);              \
+  REGISTER_KERNEL_BUILDER(Name("IO>DecodeLibsvmCSR")                  \
+                              .Device(DEVICE_CPU)                     \
+                              .TypeConstraint<type>("dtype")          \
+                              .TypeConstraint<int32>("label_dtype"),  \
+                          DecodeLibsvmCSROp<type, int32>);            \
+  REGISTER_KERNEL_BUILDER(Name("IO>DecodeLibsvmCSR")                  \
+                              .Device(DEVICE_CPU)                     \
+                              .TypeConstraint<type>("dtype")          \
+                              .TypeConstraint<int64>("label_dtype"),  \
+                          DecodeLibsvmCSROp<type, int64>);            \
+  REGISTER_KERNEL_BUILDER(Name("IO>DecodeLibsvmCSR")                  \
+                              .Device(DEVICE_CPU)                     \
+                              .TypeConstraint<type>("dtype")          \
+                              .TypeConstraint<float>("label_dtype"),  \
+                          DecodeLibsvmCSROp<type, float>);            \
+  REGISTER_KERNEL_BUILDER(Name("IO>DecodeLibsvmCSR")                  \
+                              .Device(DEVICE_CPU)                     \
+                              .TypeConstraint<type>("dtype")          \
+                              .TypeConstraint<double>("label_dtype"), \
+                          DecodeLibsvmCSROp<type, double>);
 
 REGISTER_KERNEL(float);
 REGISTER_KERNEL(double);
@@ -16,6 +16,10 @@ limitations under the License.
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+
 #include "lmdb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
@@ -29,6 +33,7 @@ class LMDBReadable : public IOReadableInterface {
   LMDBReadable(Env* env) : env_(env) {}
 
   ~LMDBReadable() {
+    StopReaders();
     if (mdb_env_ != nullptr) {
       if (mdb_cursor_) {
         mdb_cursor_close(mdb_cursor_);
@@ -50,6 +55,14 @@ class LMDBReadable : public IOReadableInterface {
     }
     const string& filename = input[0];
 
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("num_parallel_reads: ") == 0) {
+        if (!absl::SimpleAtoi(metadata[i].substr(20), &num_parallel_reads_)) {
+          return errors::InvalidArgument("invalid ", metadata[i]);
+        }
+      }
+    }
+
     int status = mdb_env_create(&mdb_env_);
     if (status != MDB_SUCCESS) {
       return errors::InvalidArgument("error on mdb_env_create: ", status);
@@ -80,18 +93,59 @@ class LMDBReadable : public IOReadableInterface {
     }
     return OkStatus();
   }
+  // Reads the keys to `value` and the values to `label`, whichever is needed.
+  // Reading from 0 again restarts from the first key. With more than one
+  // parallel read the records are not read in key order.
   Status Read(const int64 start, const int64 stop, const string& component,
               int64* record_read, Tensor* value, Tensor* label) override {
+    mutex_lock l(mu_);
     *record_read = 0;
+    if (num_parallel_reads_ > 1) {
+      if (start == 0 && !threads_.empty()) {
+        StopReaders();
+      }
+      if (threads_.empty()) {
+        TF_RETURN_IF_ERROR(StartReaders());
+      }
+      mutex_lock queue_lock(queue_mu_);
+      while (queue_.empty() && num_running_ > 0 && status_.ok()) {
+        queue_cv_.wait(queue_lock);
+      }
+      TF_RETURN_IF_ERROR(status_);
+      while (start + (*record_read) < stop && !queue_.empty()) {
+        if (value != nullptr) {
+          value->flat<tstring>()((*record_read)) =
+              std::move(queue_.front().first);
+        }
+        if (label != nullptr) {
+          label->flat<tstring>()((*record_read)) =
+              std::move(queue_.front().second);
+        }
+        queue_.pop_front();
+        (*record_read)++;
+      }
+      queue_cv_.notify_all();
+      return OkStatus();
+    }
+    MDB_cursor_op op = (start == 0) ? MDB_FIRST : MDB_NEXT;
     while (start + (*record_read) < stop) {
       MDB_val mdb_key;
       MDB_val mdb_data;
-      int status = mdb_cursor_get(mdb_cursor_, &mdb_key, &mdb_data, MDB_NEXT);
+      int status = mdb_cursor_get(mdb_cursor_, &mdb_key, &mdb_data, op);
       if (status != MDB_SUCCESS) {
         break;
       }
-      value->flat<tstring>()((*record_read)) = std::move(
-          string(static_cast<const char*>(mdb_key.mv_data), mdb_key.mv_size));
+      op = MDB_NEXT;
+      if (value != nullptr) {
+        value->flat<tstring>()((*record_read))
+            .assign(static_cast<const char*>(mdb_key.mv_data),
+                    mdb_key.mv_size);
+      }
+      if (label != nullptr) {
+        label->flat<tstring>()((*record_read))
+            .assign(static_cast<const char*>(mdb_data.mv_data),
+                    mdb_data.mv_size);
+      }
       (*record_read)++;
     }
     return OkStatus();
@@ -109,6 +163,136 @@ class LMDBReadable : public IOReadableInterface {
   }
 
  private:
+  // Splits the keys into ranges of about the same number of records, walking
+  // the keys once, and starts reading each range on a thread of its own.
+  Status StartReaders() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    MDB_stat stat;
+    int status = mdb_stat(mdb_txn_, mdb_dbi_, &stat);
+    if (status != MDB_SUCCESS) {
+      return errors::InvalidArgument("error on mdb_stat: ", status);
+    }
+    const size_t entries = stat.ms_entries;
+    const size_t num_ranges =
+        std::max<size_t>(1, std::min<size_t>(num_parallel_reads_, entries));
+    // The first key of each range but the first one.
+    std::vector<string> bounds;
+    MDB_val mdb_key;
+    MDB_val mdb_data;
+    MDB_cursor_op op = MDB_FIRST;
+    for (size_t i = 0; bounds.size() + 1 < num_ranges; i++) {
+      status = mdb_cursor_get(mdb_cursor_, &mdb_key, &mdb_data, op);
+      if (status != MDB_SUCCESS) {
+        break;
+      }
+      op = MDB_NEXT;
+      if (i == (bounds.size() + 1) * entries / num_ranges) {
+        bounds.emplace_back(static_cast<const char*>(mdb_key.mv_data),
+                            mdb_key.mv_size);
+      }
+    }
+
+    mutex_lock l(queue_mu_);
+    ranges_.clear();
+    for (size_t i = 0; i <= bounds.size(); i++) {
+      ranges_.emplace_back(i == 0 ? "" : bounds[i - 1],
+                           i < bounds.size() ? bounds[i] : "");
+    }
+    queue_.clear();
+    stop_ = false;
+    status_ = OkStatus();
+    num_running_ = ranges_.size();
+    const size_t capacity = kQueueCapacity * ranges_.size();
+    for (size_t i = 0; i < ranges_.size(); i++) {
+      threads_.emplace_back(
+          env_->StartThread(ThreadOptions(), "lmdb_range_reader",
+                            [this, i, capacity] { RunReader(i, capacity); }));
+    }
+    return OkStatus();
+  }
+  void StopReaders() {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = true;
+      queue_cv_.notify_all();
+    }
+    // Joins the reader threads.
+    threads_.clear();
+  }
+  // Reads the range `index` with a transaction and a cursor of its own, as
+  // transactions are not to be shared between threads.
+  void RunReader(size_t index, size_t capacity) {
+    Status status = ReadRange(index, capacity);
+    mutex_lock l(queue_mu_);
+    if (status_.ok()) status_ = status;
+    num_running_--;
+    queue_cv_.notify_all();
+  }
+  Status ReadRange(size_t index, size_t capacity) {
+    string start_key, end_key;
+    {
+      mutex_lock l(queue_mu_);
+      start_key = ranges_[index].first;
+      end_key = ranges_[index].second;
+    }
+    MDB_txn* txn = nullptr;
+    int status = mdb_txn_begin(mdb_env_, nullptr, MDB_RDONLY, &txn);
+    if (status != MDB_SUCCESS) {
+      return errors::InvalidArgument("error on mdb_txn_begin: ", status);
+    }
+    std::unique_ptr<MDB_txn, void (*)(MDB_txn*)> txn_scope(txn,
+                                                           mdb_txn_abort);
+    MDB_cursor* cursor = nullptr;
+    status = mdb_cursor_open(txn, mdb_dbi_, &cursor);
+    if (status != MDB_SUCCESS) {
+      return errors::InvalidArgument("error on mdb_cursor_open: ", status);
+    }
+    std::unique_ptr<MDB_cursor, void (*)(MDB_cursor*)> cursor_scope(
+        cursor, mdb_cursor_close);
+
+    MDB_val mdb_key{start_key.size(), const_cast<char*>(start_key.data())};
+    MDB_val mdb_end{end_key.size(), const_cast<char*>(end_key.data())};
+    MDB_val mdb_data;
+    MDB_cursor_op op = start_key.empty() ? MDB_FIRST : MDB_SET_RANGE;
+    std::vector<std::pair<tstring, tstring>> records;
+    bool done = false;
+    while (!done) {
+      records.clear();
+      while (records.size() < kRecordsPerChunk) {
+        status = mdb_cursor_get(cursor, &mdb_key, &mdb_data, op);
+        op = MDB_NEXT;
+        if (status == MDB_NOTFOUND ||
+            (status == MDB_SUCCESS && !end_key.empty() &&
+             mdb_cmp(txn, mdb_dbi_, &mdb_key, &mdb_end) >= 0)) {
+          done = true;
+          break;
+        }
+        if (status != MDB_SUCCESS) {
+          return errors::InvalidArgument("error on mdb_cursor_get: ", status);
+        }
+        records.emplace_back();
+        records.back().first.assign(static_cast<const char*>(mdb_key.mv_data),
+                                    mdb_key.mv_size);
+        records.back().second.assign(
+            static_cast<const char*>(mdb_data.mv_data), mdb_data.mv_size);
+      }
+      mutex_lock l(queue_mu_);
+      while (!stop_ && queue_.size() >= capacity) {
+        queue_cv_.wait(l);
+      }
+      if (stop_) {
+        return OkStatus();
+      }
+      std::move(records.begin(), records.end(), std::back_inserter(queue_));
+      queue_cv_.notify_all();
+    }
+    return OkStatus();
+  }
+
+  // The number of records a range reader reads at a time.
+  static constexpr size_t kRecordsPerChunk = 64;
+  // The number of records queued per range reader.
+  static constexpr size_t kQueueCapacity = 4 * kRecordsPerChunk;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
 
@@ -117,6 +301,17 @@ class LMDBReadable : public IOReadableInterface {
   MDB_dbi mdb_dbi_ TF_GUARDED_BY(mu_) = 0;
 
   MDB_cursor* mdb_cursor_ TF_GUARDED_BY(mu_) = nullptr;
+
+  int64 num_parallel_reads_ TF_GUARDED_BY(mu_) = 1;
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  // The start and end keys of the ranges, empty for the first and the last.
+  std::vector<std::pair<string, string>> ranges_ TF_GUARDED_BY(queue_mu_);
+  std::deque<std::pair<tstring, tstring>> queue_ TF_GUARDED_BY(queue_mu_);
+  size_t num_running_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool stop_ TF_GUARDED_BY(queue_mu_) = false;
+  Status status_ TF_GUARDED_BY(queue_mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
 };
 
 class LMDBMapping : public IOMappingInterface {
@@ -176,19 +371,28 @@ class LMDBMapping : public IOMappingInterface {
     return OkStatus();
   }
 
+  // Looks up all the keys within one read-only transaction of the call, so
+  // that concurrent lookups do not share a transaction.
   Status Read(const Tensor& key, Tensor* value) override {
+    MDB_txn* txn = nullptr;
+    int status = mdb_txn_begin(mdb_env_, nullptr, MDB_RDONLY, &txn);
+    if (status != MDB_SUCCESS) {
+      return errors::InvalidArgument("error on mdb_txn_begin: ", status);
+    }
+    std::unique_ptr<MDB_txn, void (*)(MDB_txn*)> txn_scope(txn,
+                                                           mdb_txn_abort);
     for (int64 i = 0; i < key.NumElements(); i++) {
       MDB_val mdb_key;
       MDB_val mdb_data;
       mdb_key.mv_data = (void*)key.flat<tstring>()(i).data();
       mdb_key.mv_size = key.flat<tstring>()(i).size();
-      int status = mdb_get(mdb_txn_, mdb_dbi_, &mdb_key, &mdb_data);
+      status = mdb_get(txn, mdb_dbi_, &mdb_key, &mdb_data);
       if (status != MDB_SUCCESS) {
         return errors::InvalidArgument("unable to get value from key(",
                                        key.flat<tstring>()(i), "): ", status);
       }
-      value->flat<tstring>()(i) = std::move(
-          string(static_cast<const char*>(mdb_data.mv_data), mdb_data.mv_size));
+      value->flat<tstring>()(i).assign(
+          static_cast<const char*>(mdb_data.mv_data), mdb_data.mv_size);
     }
     return OkStatus();
   }
@@ -211,6 +415,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>LMDBReadableInit").Device(DEVICE_CPU),
                         IOInterfaceInitOp<LMDBReadable>);
 REGISTER_KERNEL_BUILDER(Name("IO>LMDBReadableRead").Device(DEVICE_CPU),
                         IOReadableReadOp<LMDBReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>LMDBReadableReadItems").Device(DEVICE_CPU),
+                        IOReadableReadOp<LMDBReadable>);
 REGISTER_KERNEL_BUILDER(Name("IO>LMDBMappingInit").Device(DEVICE_CPU),
                         IOInterfaceInitOp<LMDBMapping>);
 REGISTER_KERNEL_BUILDER(Name("IO>LMDBMappingRead").Device(DEVICE_CPU),
@@ -16,26 +16,147 @@ limitations under the License.
 #include <bson/bson.h>
 #include <mongoc/mongoc.h>
 
+#include <deque>
+#include <iterator>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
 
 namespace tensorflow {
 namespace io {
 namespace {
 
+struct MongoDBClientDeleter {
+  void operator()(mongoc_client_t* client) const {
+    mongoc_client_destroy(client);
+  }
+};
+using MongoDBClientPool =
+    data::ConnectionPool<mongoc_client_t, MongoDBClientDeleter>;
+
+// Leases a client of `uri` from the clients pooled across the resources of
+// the process, so that their connections to the servers are kept open.
+Status AcquireClient(const mongoc_uri_t* uri,
+                     std::shared_ptr<mongoc_client_t>* client) {
+  return MongoDBClientPool::Default()->Acquire(
+      mongoc_uri_get_string(uri),
+      [uri](MongoDBClientPool::Connection* connection) -> Status {
+        connection->reset(mongoc_client_new_from_uri(uri));
+        if (*connection == nullptr) {
+          return errors::FailedPrecondition("Failed to initialize the client");
+        }
+        return OkStatus();
+      },
+      [](mongoc_client_t* connection) {
+        // A server is selected from the topology the client monitors.
+        bson_error_t error;
+        mongoc_server_description_t* server =
+            mongoc_client_select_server(connection, false, nullptr, &error);
+        if (server == nullptr) {
+          return false;
+        }
+        mongoc_server_description_destroy(server);
+        return true;
+      },
+      client);
+}
+
+// Reads the documents of a collection that match a filter through one cursor
+// of a client of its own, each document as relaxed extended JSON or as raw
+// BSON.
+class MongoDBRangeReader {
+ public:
+  MongoDBRangeReader(mongoc_uri_t* uri, const std::string& database,
+                     const std::string& collection, bson_t* filter,
+                     bson_t* opts, bool raw_bson)
+      : status_(AcquireClient(uri, &client_)),
+        collection_obj_(nullptr),
+        cursor_obj_(nullptr),
+        filter_(filter),
+        opts_(opts),
+        raw_bson_(raw_bson) {
+    if (status_.ok()) {
+      collection_obj_ = mongoc_client_get_collection(
+          client_.get(), database.c_str(), collection.c_str());
+    }
+  }
+  ~MongoDBRangeReader() {
+    if (cursor_obj_ != nullptr) mongoc_cursor_destroy(cursor_obj_);
+    if (collection_obj_ != nullptr) mongoc_collection_destroy(collection_obj_);
+    bson_destroy(filter_);
+  }
+
+  // Appends up to `max_num_records` documents to `records`, `done` is set
+  // by the first read past the end of the cursor, which appends nothing and
+  // after which the next read starts over.
+  Status Read(size_t max_num_records, std::vector<std::string>* records,
+              bool* done) {
+    TF_RETURN_IF_ERROR(status_);
+    if (cursor_obj_ == nullptr) {
+      cursor_obj_ = mongoc_collection_find_with_opts(collection_obj_, filter_,
+                                                     opts_, NULL);
+    }
+    const bson_t* doc;
+    *done = false;
+    for (size_t i = 0; i < max_num_records; i++) {
+      if (!mongoc_cursor_next(cursor_obj_, &doc)) {
+        *done = (i == 0);
+        break;
+      }
+      if (raw_bson_) {
+        records->emplace_back(reinterpret_cast<const char*>(bson_get_data(doc)),
+                              doc->len);
+      } else {
+        // Reference for BSON to JSON conversion:
+        // https://github.com/mongodb/specifications/blob/master/source/extended-json.rst#conversion-table
+        char* record = bson_as_relaxed_extended_json(doc, NULL);
+        records->emplace_back(record);
+        bson_free(record);
+      }
+    }
+    if (*done) {
+      bson_error_t error;
+      bool failed = mongoc_cursor_error(cursor_obj_, &error);
+      // resetting the cursor after reaching the end of the collection.
+      mongoc_cursor_destroy(cursor_obj_);
+      cursor_obj_ = nullptr;
+      if (failed) {
+        return errors::Internal("Failed to read documents due to: ",
+                                error.message);
+      }
+    }
+    return OkStatus();
+  }
+
+ private:
+  std::shared_ptr<mongoc_client_t> client_;
+  const Status status_;
+  mongoc_collection_t* collection_obj_;
+  mongoc_cursor_t* cursor_obj_;
+  bson_t* filter_;
+  const bson_t* opts_;
+  const bool raw_bson_;
+};
+
 class MongoDBReadableResource : public ResourceBase {
  public:
   MongoDBReadableResource(Env* env) : env_(env) {}
   ~MongoDBReadableResource() {
+    StopReaders();
+    readers_.clear();
+    bson_destroy(opts_);
+    bson_destroy(query_);
     mongoc_collection_destroy(collection_obj_);
     mongoc_database_destroy(database_obj_);
     mongoc_uri_destroy(uri_obj_);
-    mongoc_client_destroy(client_obj_);
-    mongoc_cleanup();
+    // libmongoc is not cleaned up, the pooled clients outlive the resource.
   }
 
   Status Init(const std::string& uri, const std::string& database,
-              const std::string& collection) {
+              const std::string& collection, const std::string& filter,
+              const std::string& projection, int64 batch_size,
+              int64 num_parallel_reads, bool raw_bson) {
     //   Required to initialize libmongoc's internals
     mongoc_init();
 
@@ -49,22 +170,58 @@ class MongoDBReadableResource : public ResourceBase {
 
     // Initialize the MongoDB client
 
-    client_obj_ = mongoc_client_new_from_uri(uri_obj_);
-    if (!client_obj_) {
-      return errors::FailedPrecondition("Failed to initialize the client");
-    }
+    TF_RETURN_IF_ERROR(AcquireClient(uri_obj_, &client_));
 
     //  Get a handle on the database "db_name" and collection "coll_name"
 
-    database_obj_ = mongoc_client_get_database(client_obj_, database.c_str());
+    database_obj_ = mongoc_client_get_database(client_.get(), database.c_str());
     collection_obj_ = mongoc_client_get_collection(
-        client_obj_, database.c_str(), collection.c_str());
-
-    cursor_obj_ =
-        mongoc_collection_find_with_opts(collection_obj_, query_, NULL, NULL);
+        client_.get(), database.c_str(), collection.c_str());
+
+    // The filter and the projection are pushed down to the server along with
+    // the number of documents per batch of the cursor.
+    if (!filter.empty()) {
+      bson_destroy(query_);
+      query_ = bson_new_from_json((const uint8_t*)filter.c_str(), -1, &error_);
+      if (!query_) {
+        query_ = bson_new();
+        return errors::InvalidArgument("Failed to parse filter due to: ",
+                                       error_.message);
+      }
+    }
+    if (!projection.empty()) {
+      bson_t* projection_doc = bson_new_from_json(
+          (const uint8_t*)projection.c_str(), -1, &error_);
+      if (!projection_doc) {
+        return errors::InvalidArgument("Failed to parse projection due to: ",
+                                       error_.message);
+      }
+      BSON_APPEND_DOCUMENT(opts_, "projection", projection_doc);
+      bson_destroy(projection_doc);
+    }
+    if (batch_size > 0) {
+      BSON_APPEND_INT32(opts_, "batchSize", batch_size);
+      max_num_records_ = batch_size;
+    }
 
     // Perform healthcheck before proceeding
-    Healthcheck();
+    TF_RETURN_IF_ERROR(Healthcheck());
+
+    std::vector<bson_value_t> bounds;
+    if (num_parallel_reads > 1) {
+      TF_RETURN_IF_ERROR(SplitCollection(num_parallel_reads, &bounds));
+    }
+    // Every range between the bounds is read by a cursor of its own.
+    for (size_t i = 0; i <= bounds.size(); i++) {
+      bson_t* range_filter = RangeFilter(i > 0 ? &bounds[i - 1] : nullptr,
+                                         i < bounds.size() ? &bounds[i]
+                                                           : nullptr);
+      readers_.emplace_back(new MongoDBRangeReader(
+          uri_obj_, database, collection, range_filter, opts_, raw_bson));
+    }
+    for (bson_value_t& bound : bounds) {
+      bson_value_destroy(&bound);
+    }
     return OkStatus();
   }
 
@@ -72,39 +229,22 @@ class MongoDBReadableResource : public ResourceBase {
                   allocate_func) {
     mutex_lock l(mu_);
 
-    constexpr size_t max_num_records = 1024;
     std::vector<std::string> records;
-    records.reserve(max_num_records);
+    records.reserve(max_num_records_);
 
-    const bson_t* doc;
-
-    int num_records = 0;
-    while (num_records < max_num_records) {
-      if (mongoc_cursor_next(cursor_obj_, &doc)) {
-        // Reference for BSON to JSON conversion:
-        // https://github.com/mongodb/specifications/blob/master/source/extended-json.rst#conversion-table
-        char* record = bson_as_relaxed_extended_json(doc, NULL);
-        records.emplace_back(record);
-        num_records++;
-        bson_free(record);
-      } else {
-        break;
-      }
+    if (readers_.size() == 1) {
+      bool done;
+      TF_RETURN_IF_ERROR(readers_[0]->Read(max_num_records_, &records, &done));
+    } else {
+      TF_RETURN_IF_ERROR(Pop(&records));
     }
 
-    if (records.size() == 0) {
-      // resetting the cursor after reaching the end of the collection.
-      cursor_obj_ =
-          mongoc_collection_find_with_opts(collection_obj_, query_, NULL, NULL);
-    }
     TensorShape shape({static_cast<int32>(records.size())});
     Tensor* records_tensor;
     TF_RETURN_IF_ERROR(allocate_func(shape, &records_tensor));
 
-    // If no messages were received when timeout exceeded, we treat it as a
-    // failure and don't continue receiving messages.
     for (size_t i = 0; i < records.size(); i++) {
-      records_tensor->flat<tstring>()(i) = records[i];
+      records_tensor->flat<tstring>()(i) = std::move(records[i]);
     }
 
     return OkStatus();
@@ -118,7 +258,7 @@ class MongoDBReadableResource : public ResourceBase {
 
     cmd_ = BCON_NEW("ping", BCON_INT32(1));
 
-    retval_ = mongoc_client_command_simple(client_obj_, "admin", cmd_, NULL,
+    retval_ = mongoc_client_command_simple(client_.get(), "admin", cmd_, NULL,
                                            &reply_, &error_);
 
     if (!retval_) {
@@ -130,18 +270,160 @@ class MongoDBReadableResource : public ResourceBase {
     return OkStatus();
   }
 
+  // Splits the collection into up to `num_ranges` ranges of `_id`, at the
+  // bounds taken from a sorted `$sample` of the ids. The ranges are only
+  // disjoint and complete if all ids are of one type, e.g. ObjectIds.
+  Status SplitCollection(int64 num_ranges, std::vector<bson_value_t>* bounds) {
+    const int64 num_samples = num_ranges * kSamplesPerRange;
+    bson_t* pipeline = BCON_NEW(
+        "pipeline", "[", "{", "$sample", "{", "size", BCON_INT64(num_samples),
+        "}", "}", "{", "$project", "{", "_id", BCON_INT32(1), "}", "}", "{",
+        "$sort", "{", "_id", BCON_INT32(1), "}", "}", "]");
+    mongoc_cursor_t* cursor = mongoc_collection_aggregate(
+        collection_obj_, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+    std::vector<bson_value_t> samples;
+    const bson_t* doc;
+    bson_iter_t iter;
+    while (mongoc_cursor_next(cursor, &doc)) {
+      if (bson_iter_init_find(&iter, doc, "_id")) {
+        samples.emplace_back();
+        bson_value_copy(bson_iter_value(&iter), &samples.back());
+      }
+    }
+    bool failed = mongoc_cursor_error(cursor, &error_);
+    mongoc_cursor_destroy(cursor);
+    bson_destroy(pipeline);
+    for (int64 i = 1; i < num_ranges && !failed; i++) {
+      const size_t index = i * samples.size() / num_ranges;
+      if (index == 0 || index >= samples.size()) continue;
+      bounds->emplace_back();
+      bson_value_copy(&samples[index], &bounds->back());
+    }
+    for (bson_value_t& sample : samples) {
+      bson_value_destroy(&sample);
+    }
+    if (failed) {
+      return errors::Internal("Failed to sample the collection due to: ",
+                              error_.message);
+    }
+    LOG(INFO) << "MongoDB collection split into " << bounds->size() + 1
+              << " ranges";
+    return OkStatus();
+  }
+
+  // Returns the filter restricted to the ids in [lower, upper), unbounded
+  // where a bound is null.
+  bson_t* RangeFilter(const bson_value_t* lower, const bson_value_t* upper) {
+    if (lower == nullptr && upper == nullptr) {
+      return bson_copy(query_);
+    }
+    bson_t* filter = bson_new();
+    bson_t and_array, range, id;
+    BSON_APPEND_ARRAY_BEGIN(filter, "$and", &and_array);
+    BSON_APPEND_DOCUMENT(&and_array, "0", query_);
+    BSON_APPEND_DOCUMENT_BEGIN(&and_array, "1", &range);
+    BSON_APPEND_DOCUMENT_BEGIN(&range, "_id", &id);
+    if (lower != nullptr) BSON_APPEND_VALUE(&id, "$gte", lower);
+    if (upper != nullptr) BSON_APPEND_VALUE(&id, "$lt", upper);
+    bson_append_document_end(&range, &id);
+    bson_append_document_end(&and_array, &range);
+    bson_append_array_end(filter, &and_array);
+    return filter;
+  }
+
+  // Moves up to max_num_records_ documents read by the range readers to
+  // `records`, waiting for the readers unless all have reached their end.
+  // An empty result ends the pass, the next one reads the collection again.
+  Status Pop(std::vector<std::string>* records)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (threads_.empty()) StartReaders();
+    mutex_lock l(queue_mu_);
+    while (queue_.empty() && num_running_ > 0) queue_cv_.wait(l);
+    size_t count = std::min(max_num_records_, queue_.size());
+    std::move(queue_.begin(), queue_.begin() + count,
+              std::back_inserter(*records));
+    queue_.erase(queue_.begin(), queue_.begin() + count);
+    queue_cv_.notify_all();
+    if (!records->empty()) return OkStatus();
+    Status status = status_;
+    status_ = OkStatus();
+    l.unlock();
+    StopReaders();
+    return status;
+  }
+
+  void StartReaders() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = false;
+      num_running_ = readers_.size();
+    }
+    for (auto& reader : readers_) {
+      MongoDBRangeReader* range_reader = reader.get();
+      threads_.emplace_back(env_->StartThread(
+          ThreadOptions(), "mongodb_range_reader",
+          [this, range_reader] { RunReader(range_reader); }));
+    }
+  }
+
+  void StopReaders() {
+    {
+      mutex_lock l(queue_mu_);
+      stop_ = true;
+      queue_.clear();
+      queue_cv_.notify_all();
+    }
+    // Joins the reader threads.
+    threads_.clear();
+  }
+
+  void RunReader(MongoDBRangeReader* reader) {
+    std::vector<std::string> records;
+    bool done = false;
+    Status status;
+    while (!done && status.ok()) {
+      records.clear();
+      status = reader->Read(max_num_records_, &records, &done);
+      mutex_lock l(queue_mu_);
+      while (!stop_ && queue_.size() >= kQueueCapacity * max_num_records_) {
+        queue_cv_.wait(l);
+      }
+      if (stop_) return;
+      std::move(records.begin(), records.end(), std::back_inserter(queue_));
+      queue_cv_.notify_all();
+    }
+    mutex_lock l(queue_mu_);
+    if (status_.ok()) status_ = status;
+    num_running_--;
+    queue_cv_.notify_all();
+  }
+
+  // The number of sampled ids per range the collection is split into.
+  static const int64 kSamplesPerRange = 32;
+  // The number of batches the range readers queue ahead of Next.
+  static const size_t kQueueCapacity = 4;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   mongoc_uri_t* uri_obj_;
-  mongoc_client_t* client_obj_;
+  std::shared_ptr<mongoc_client_t> client_;
   mongoc_database_t* database_obj_;
   mongoc_collection_t* collection_obj_;
-  mongoc_cursor_t* cursor_obj_;
   bson_t* query_ = bson_new();
+  bson_t* opts_ = bson_new();
   bson_t *cmd_, reply_;
   bson_error_t error_;
   char* str;
   bool retval_;
+  size_t max_num_records_ = 1024;
+  std::vector<std::unique_ptr<MongoDBRangeReader>> readers_;
+  mutex queue_mu_;
+  condition_variable queue_cv_;
+  std::deque<std::string> queue_ TF_GUARDED_BY(queue_mu_);
+  size_t num_running_ TF_GUARDED_BY(queue_mu_) = 0;
+  bool stop_ TF_GUARDED_BY(queue_mu_) = false;
+  Status status_ TF_GUARDED_BY(queue_mu_);
+  std::vector<std::unique_ptr<Thread>> threads_;
 };
 
 class MongoDBReadableInitOp : public ResourceOpKernel<MongoDBReadableResource> {
@@ -167,7 +449,31 @@ class MongoDBReadableInitOp : public ResourceOpKernel<MongoDBReadableResource> {
     OP_REQUIRES_OK(context, context->input("collection", &collection_tensor));
     const string& collection = collection_tensor->scalar<tstring>()();
 
-    OP_REQUIRES_OK(context, resource_->Init(uri, database, collection));
+    const Tensor* filter_tensor;
+    OP_REQUIRES_OK(context, context->input("filter", &filter_tensor));
+    const string& filter = filter_tensor->scalar<tstring>()();
+
+    const Tensor* projection_tensor;
+    OP_REQUIRES_OK(context, context->input("projection", &projection_tensor));
+    const string& projection = projection_tensor->scalar<tstring>()();
+
+    const Tensor* batch_size_tensor;
+    OP_REQUIRES_OK(context, context->input("batch_size", &batch_size_tensor));
+    const int64 batch_size = batch_size_tensor->scalar<int64>()();
+
+    const Tensor* num_parallel_reads_tensor;
+    OP_REQUIRES_OK(context, context->input("num_parallel_reads",
+                                           &num_parallel_reads_tensor));
+    const int64 num_parallel_reads =
+        num_parallel_reads_tensor->scalar<int64>()();
+
+    const Tensor* raw_bson_tensor;
+    OP_REQUIRES_OK(context, context->input("raw_bson", &raw_bson_tensor));
+    const bool raw_bson = raw_bson_tensor->scalar<bool>()();
+
+    OP_REQUIRES_OK(context, resource_->Init(uri, database, collection, filter,
+                                            projection, batch_size,
+                                            num_parallel_reads, raw_bson));
   }
 
   Status CreateResource(MongoDBReadableResource** resource)
@@ -210,8 +516,7 @@ class MongoDBWritableResource : public ResourceBase {
     mongoc_collection_destroy(collection_obj_);
     mongoc_database_destroy(database_obj_);
     mongoc_uri_destroy(uri_obj_);
-    mongoc_client_destroy(client_obj_);
-    mongoc_cleanup();
+    // libmongoc is not cleaned up, the pooled clients outlive the resource.
   }
 
   Status Init(const std::string& uri, const std::string& database,
@@ -229,41 +534,105 @@ class MongoDBWritableResource : public ResourceBase {
 
     // Initialize the MongoDB client
 
-    client_obj_ = mongoc_client_new_from_uri(uri_obj_);
-    if (!client_obj_) {
-      return errors::FailedPrecondition("Failed to initialize the client");
-    }
+    TF_RETURN_IF_ERROR(AcquireClient(uri_obj_, &client_));
 
     //  Get a handle on the database "db_name" and collection "coll_name"
 
-    database_obj_ = mongoc_client_get_database(client_obj_, database.c_str());
+    database_obj_ = mongoc_client_get_database(client_.get(), database.c_str());
     collection_obj_ = mongoc_client_get_collection(
-        client_obj_, database.c_str(), collection.c_str());
+        client_.get(), database.c_str(), collection.c_str());
 
     // Perform healthcheck before proceeding
     Healthcheck();
     return OkStatus();
   }
 
-  Status Write(const std::string& record) {
-    const char* json_record = record.c_str();
-    bson_t* bson_record =
-        bson_new_from_json((const uint8_t*)json_record, -1, &error_);
+  // Inserts the JSON documents of `records` in unordered bulk writes of up
+  // to `batch_size` documents, each of which takes one round trip.
+  Status Write(const Tensor& records, const int64 batch_size) {
+    mutex_lock l(mu_);
+    return BulkInsert(
+        records.NumElements(), batch_size,
+        [&](int64 i, bson_t** document) -> Status {
+          const tstring& record = records.flat<tstring>()(i);
+          *document = bson_new_from_json((const uint8_t*)record.data(),
+                                         record.size(), &error_);
+          if (!*document) {
+            return errors::FailedPrecondition("Failed to parse json due to: ",
+                                              error_.message);
+          }
+          return OkStatus();
+        });
+  }
 
-    if (!bson_record) {
-      return errors::FailedPrecondition("Failed to parse json due to: ",
-                                        error_.message);
+  // Inserts a document per row of the `columns`, with a field per column.
+  Status WriteColumns(const Tensor& names, const OpInputList& columns,
+                      const int64 batch_size) {
+    mutex_lock l(mu_);
+    if (names.NumElements() != columns.size()) {
+      return errors::InvalidArgument("got ", names.NumElements(),
+                                     " names for ", columns.size(),
+                                     " columns");
     }
-
-    if (!mongoc_collection_insert_one(collection_obj_, bson_record, NULL, NULL,
-                                      &error_)) {
-      return errors::FailedPrecondition("Failed to insert document due to: ",
-                                        error_.message);
+    const int64 num_rows = columns.size() > 0 ? columns[0].NumElements() : 0;
+    for (int i = 0; i < columns.size(); i++) {
+      if (columns[i].NumElements() != num_rows) {
+        return errors::InvalidArgument("column ", names.flat<tstring>()(i),
+                                       " has ", columns[i].NumElements(),
+                                       " rows, expected ", num_rows);
+      }
     }
-
-    bson_destroy(bson_record);
-
-    return OkStatus();
+    return BulkInsert(
+        num_rows, batch_size, [&](int64 row, bson_t** document) -> Status {
+          *document = bson_new();
+          for (int i = 0; i < columns.size(); i++) {
+            const tstring& name = names.flat<tstring>()(i);
+            const Tensor& column = columns[i];
+            bool appended;
+            switch (column.dtype()) {
+              case DT_BOOL:
+                appended = bson_append_bool(*document, name.data(),
+                                            name.size(),
+                                            column.flat<bool>()(row));
+                break;
+              case DT_INT32:
+                appended = bson_append_int32(*document, name.data(),
+                                             name.size(),
+                                             column.flat<int32>()(row));
+                break;
+              case DT_INT64:
+                appended = bson_append_int64(*document, name.data(),
+                                             name.size(),
+                                             column.flat<int64>()(row));
+                break;
+              case DT_FLOAT:
+                appended = bson_append_double(*document, name.data(),
+                                              name.size(),
+                                              column.flat<float>()(row));
+                break;
+              case DT_DOUBLE:
+                appended = bson_append_double(*document, name.data(),
+                                              name.size(),
+                                              column.flat<double>()(row));
+                break;
+              case DT_STRING: {
+                const tstring& value = column.flat<tstring>()(row);
+                appended =
+                    bson_append_utf8(*document, name.data(), name.size(),
+                                     value.data(), value.size());
+              } break;
+              default:
+                return errors::InvalidArgument(
+                    "data type ", DataTypeString(column.dtype()),
+                    " of column ", name, " is not supported");
+            }
+            if (!appended) {
+              return errors::InvalidArgument("Failed to append column ", name,
+                                             " to the document");
+            }
+          }
+          return OkStatus();
+        });
   }
 
   Status DeleteMany(const std::string& record) {
@@ -295,7 +664,7 @@ class MongoDBWritableResource : public ResourceBase {
 
     cmd_ = BCON_NEW("ping", BCON_INT32(1));
 
-    retval_ = mongoc_client_command_simple(client_obj_, "admin", cmd_, NULL,
+    retval_ = mongoc_client_command_simple(client_.get(), "admin", cmd_, NULL,
                                            &reply_, &error_);
 
     if (!retval_) {
@@ -307,10 +676,55 @@ class MongoDBWritableResource : public ResourceBase {
     return OkStatus();
   }
 
+  // Inserts the documents built by `document_func` in unordered bulk writes
+  // of up to `batch_size` documents.
+  Status BulkInsert(
+      const int64 num_documents, const int64 batch_size,
+      const std::function<Status(int64 index, bson_t** document)>&
+          document_func) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    bson_t* opts = BCON_NEW("ordered", BCON_BOOL(false));
+    mongoc_bulk_operation_t* bulk = nullptr;
+    Status status;
+    int64 pending = 0;
+    for (int64 i = 0; i < num_documents && status.ok(); i++) {
+      if (bulk == nullptr) {
+        bulk = mongoc_collection_create_bulk_operation_with_opts(
+            collection_obj_, opts);
+      }
+      bson_t* document = nullptr;
+      status = document_func(i, &document);
+      if (status.ok() &&
+          !mongoc_bulk_operation_insert_with_opts(bulk, document, NULL,
+                                                  &error_)) {
+        status = errors::FailedPrecondition(
+            "Failed to insert document due to: ", error_.message);
+      }
+      if (document != nullptr) {
+        bson_destroy(document);
+      }
+      if (status.ok() && (++pending == batch_size || i + 1 == num_documents)) {
+        bson_t reply;
+        if (!mongoc_bulk_operation_execute(bulk, &reply, &error_)) {
+          status = errors::FailedPrecondition(
+              "Failed to insert documents due to: ", error_.message);
+        }
+        bson_destroy(&reply);
+        mongoc_bulk_operation_destroy(bulk);
+        bulk = nullptr;
+        pending = 0;
+      }
+    }
+    if (bulk != nullptr) {
+      mongoc_bulk_operation_destroy(bulk);
+    }
+    bson_destroy(opts);
+    return status;
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   mongoc_uri_t* uri_obj_;
-  mongoc_client_t* client_obj_;
+  std::shared_ptr<mongoc_client_t> client_;
   mongoc_database_t* database_obj_;
   mongoc_collection_t* collection_obj_;
   bson_t *cmd_, reply_;
@@ -359,7 +773,9 @@ class MongoDBWritableInitOp : public ResourceOpKernel<MongoDBWritableResource> {
 class MongoDBWritableWriteOp : public OpKernel {
  public:
   explicit MongoDBWritableWriteOp(OpKernelConstruction* context)
-      : OpKernel(context) {}
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("batch_size", &batch_size_));
+  }
 
   void Compute(OpKernelContext* context) override {
     MongoDBWritableResource* resource;
@@ -369,13 +785,41 @@ class MongoDBWritableWriteOp : public OpKernel {
 
     const Tensor* record_tensor;
     OP_REQUIRES_OK(context, context->input("record", &record_tensor));
-    const string& record = record_tensor->scalar<tstring>()();
 
-    OP_REQUIRES_OK(context, resource->Write(record));
+    OP_REQUIRES_OK(context, resource->Write(*record_tensor, batch_size_));
+  }
+
+ private:
+  mutable mutex mu_;
+  int64 batch_size_;
+};
+
+class MongoDBWritableWriteColumnsOp : public OpKernel {
+ public:
+  explicit MongoDBWritableWriteColumnsOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("batch_size", &batch_size_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    MongoDBWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "resource", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* names_tensor;
+    OP_REQUIRES_OK(context, context->input("names", &names_tensor));
+
+    OpInputList columns;
+    OP_REQUIRES_OK(context, context->input_list("columns", &columns));
+
+    OP_REQUIRES_OK(context, resource->WriteColumns(*names_tensor, columns,
+                                                   batch_size_));
   }
 
  private:
   mutable mutex mu_;
+  int64 batch_size_;
 };
 
 class MongoDBWritableDeleteManyOp : public OpKernel {
@@ -408,6 +852,9 @@ REGISTER_KERNEL_BUILDER(Name("IO>MongoDBWritableInit").Device(DEVICE_CPU),
                         MongoDBWritableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>MongoDBWritableWrite").Device(DEVICE_CPU),
                         MongoDBWritableWriteOp);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>MongoDBWritableWriteColumns").Device(DEVICE_CPU),
+    MongoDBWritableWriteColumnsOp);
 REGISTER_KERNEL_BUILDER(Name("IO>MongoDBWritableDeleteMany").Device(DEVICE_CPU),
                         MongoDBWritableDeleteManyOp);
 }  // namespace
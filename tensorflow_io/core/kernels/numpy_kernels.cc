@@ -13,9 +13,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <limits>
+#include <map>
+
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 #include "unzip.h"
+#include "zlib.h"
 
 namespace tensorflow {
 namespace data {
@@ -280,95 +288,357 @@ class ZipObjectInputStream : public io::InputStreamInterface {
   bool final_ = false;
 };
 
-Status NumpyInfo(const string& filename, const int64 size,
-                 std::unique_ptr<tensorflow::RandomAccessFile>& file,
-                 std::vector<string>* arrays,
-                 std::vector<std::vector<int64>>* shapes,
-                 std::vector<int64>* dtypes) {
-  struct zlib_fileopaque64_def fileopaque;
-  fileopaque.offset = 0;
-  fileopaque.length = size;
-  fileopaque.file = file.get();
+// Sets up filefunc to read a zip archive of `size` bytes from file.
+void InitZipFileFunc(tensorflow::RandomAccessFile* file, const uint64 size,
+                     struct zlib_fileopaque64_def* fileopaque,
+                     zlib_filefunc64_def* filefunc) {
+  fileopaque->offset = 0;
+  fileopaque->length = size;
+  fileopaque->file = file;
+
+  memset(filefunc, 0x00, sizeof(zlib_filefunc64_def));
+  filefunc->zopen64_file = filefunc_open64;
+  filefunc->zread_file = filefunc_read;
+  filefunc->zwrite_file = filefunc_write;
+  filefunc->ztell64_file = filefunc_tell64;
+  filefunc->zseek64_file = filefunc_seek64;
+  filefunc->zclose_file = filefunc_close;
+  filefunc->zerror_file = filefunc_error;
+  filefunc->opaque = (voidpf)fileopaque;
+}
+
+// Compressed arrays get an inflate checkpoint about every kInflateSpan bytes,
+// each of which holds the last window of kInflateWindowSize bytes that the
+// data after it may refer back to.
+constexpr uint64 kInflateSpan = 1 << 20;
+constexpr size_t kInflateWindowSize = 32768;
+constexpr size_t kInflateChunkSize = 1 << 16;
+
+// A position in a deflate stream where inflating can resume: its offsets in
+// the uncompressed and the compressed data, the number of bits of the byte
+// before `in` that belong to it, and the uncompressed window before it.
+struct InflatePoint {
+  uint64 out;
+  uint64 in;
+  int bits;
+  string window;
+};
+
+// An array of a .npy file or of an entry of a .npz file.
+struct NumpyArray {
+  string name;
+  ::tensorflow::DataType dtype;
+  std::vector<int64> shape;
+  // The size of the numpy header before the data of the array
+  uint64 header_size = 0;
+  // The position of the entry in the zip directory
+  unz64_file_pos pos;
+  // How the entry is compressed, 0 if stored or not in a zip archive
+  int compression_method = 0;
+  bool encrypted = false;
+  // The file offset and size of the (compressed) data of the entry
+  uint64 data_offset = 0;
+  uint64 compressed_size = 0;
+
+  // The inflate checkpoints of a compressed entry, built by the first read
+  // that does not start at the beginning of the array
+  mutex mu;
+  std::vector<InflatePoint> points TF_GUARDED_BY(mu);
+};
 
+// The arrays of a .npy or .npz file of a size and modification time.
+struct NumpyArchive {
+  uint64 size;
+  int64 mtime_nsec;
+  bool zip = false;
+  std::vector<std::unique_ptr<NumpyArray>> arrays;
+
+  NumpyArray* Find(const string& name) const {
+    for (const auto& array : arrays) {
+      if (array->name == name) {
+        return array.get();
+      }
+    }
+    return nullptr;
+  }
+};
+
+Status BuildNumpyArchive(const string& filename, const uint64 size,
+                         tensorflow::RandomAccessFile* file,
+                         NumpyArchive* archive) {
+  struct zlib_fileopaque64_def fileopaque;
   zlib_filefunc64_def filefunc;
-  memset(&filefunc, 0x00, sizeof(zlib_filefunc64_def));
-  filefunc.zopen64_file = filefunc_open64;
-  filefunc.zread_file = filefunc_read;
-  filefunc.zwrite_file = filefunc_write;
-  filefunc.ztell64_file = filefunc_tell64;
-  filefunc.zseek64_file = filefunc_seek64;
-  filefunc.zclose_file = filefunc_close;
-  filefunc.zerror_file = filefunc_error;
-  filefunc.opaque = (voidpf)&fileopaque;
+  InitZipFileFunc(file, size, &fileopaque, &filefunc);
 
   unzFile uf = unzOpen2_64(filename.c_str(), &filefunc);
   if (uf == NULL) {
     // Not a zip file, try normal file
-    io::RandomAccessInputStream stream(file.get());
-    ::tensorflow::DataType dtype;
-    std::vector<int64> shape;
-    TF_RETURN_IF_ERROR(ParseNumpyHeader(&stream, &dtype, &shape));
-    arrays->push_back("");
-    shapes->push_back(shape);
-    dtypes->push_back(dtype);
-  } else {
-    std::unique_ptr<unzFile, void (*)(unzFile*)> unzFile_scope_(
-        &uf, [](unzFile* p) {
-          if (p != nullptr) {
-            unzClose(*p);
-          }
-        });
-    unz_global_info64 gi;
-    int err = unzGetGlobalInfo64(uf, &gi);
+    io::RandomAccessInputStream stream(file);
+    std::unique_ptr<NumpyArray> array(new NumpyArray());
+    TF_RETURN_IF_ERROR(ParseNumpyHeader(&stream, &array->dtype, &array->shape));
+    array->header_size = stream.Tell();
+    archive->arrays.push_back(std::move(array));
+    return OkStatus();
+  }
+  archive->zip = true;
+  std::unique_ptr<unzFile, void (*)(unzFile*)> unzFile_scope_(
+      &uf, [](unzFile* p) {
+        if (p != nullptr) {
+          unzClose(*p);
+        }
+      });
+  unz_global_info64 gi;
+  int err = unzGetGlobalInfo64(uf, &gi);
+  if (err != UNZ_OK) {
+    return errors::InvalidArgument("error with zipfile in unzGetGlobalInfo: ",
+                                   err);
+  }
+  for (uLong i = 0; i < gi.number_entry; i++) {
+    char filename_inzip[256];
+    unz_file_info64 file_info;
+
+    err = unzGetCurrentFileInfo64(uf, &file_info, filename_inzip,
+                                  sizeof(filename_inzip), NULL, 0, NULL, 0);
+    if (err != UNZ_OK) {
+      return errors::InvalidArgument(
+          "error with zipfile in unzGetCurrentFileInfo: ", err);
+    }
+
+    size_t filename_inzip_len = strlen(filename_inzip);
+    if (filename_inzip_len <= 4 ||
+        memcmp(&filename_inzip[filename_inzip_len - 4], ".npy", 4)) {
+      return errors::InvalidArgument("invalid name in zipfile: ",
+                                     filename_inzip);
+    }
+    filename_inzip[filename_inzip_len - 4] = 0x00;
+
+    std::unique_ptr<NumpyArray> array(new NumpyArray());
+    array->name = filename_inzip;
+    array->compression_method = file_info.compression_method;
+    array->encrypted = (file_info.flag & 1) != 0;
+    array->compressed_size = file_info.compressed_size;
+    err = unzGetFilePos64(uf, &array->pos);
     if (err != UNZ_OK) {
-      return errors::InvalidArgument("error with zipfile in unzGetGlobalInfo: ",
+      return errors::InvalidArgument("error with zipfile in unzGetFilePos: ",
                                      err);
     }
-    for (uLong i = 0; i < gi.number_entry; i++) {
-      char filename_inzip[256];
-      unz_file_info64 file_info;
 
-      err = unzGetCurrentFileInfo64(uf, &file_info, filename_inzip,
-                                    sizeof(filename_inzip), NULL, 0, NULL, 0);
-      if (err != UNZ_OK) {
-        errors::InvalidArgument("error with zipfile in unzGetCurrentFileInfo: ",
-                                err);
-      }
+    err = unzOpenCurrentFile(uf);
+    if (err != UNZ_OK) {
+      return errors::InvalidArgument(
+          "error with zipfile in unzOpenCurrentFile: ", err);
+    }
+    // The position moves once the entry is read, so it is taken first.
+    array->data_offset = unzGetCurrentFileZStreamPos64(uf);
 
-      size_t filename_inzip_len = strlen(filename_inzip);
-      if (filename_inzip_len <= 4 ||
-          memcmp(&filename_inzip[filename_inzip_len - 4], ".npy", 4)) {
-        return errors::InvalidArgument("invalid name in zipfile: ",
-                                       filename_inzip);
-      }
-      filename_inzip[filename_inzip_len - 4] = 0x00;
+    ZipObjectInputStream stream(uf);
+    TF_RETURN_IF_ERROR(ParseNumpyHeader(&stream, &array->dtype, &array->shape));
+    array->header_size = stream.Tell();
+    archive->arrays.push_back(std::move(array));
 
-      err = unzOpenCurrentFile(uf);
+    if ((i + 1) < gi.number_entry) {
+      err = unzGoToNextFile(uf);
       if (err != UNZ_OK) {
         return errors::InvalidArgument(
-            "error with zipfile in unzOpenCurrentFile: ", err);
+            "error with zipfile in unzGoToNextFile: ", err);
       }
+    }
+  }
 
-      ZipObjectInputStream stream(uf);
-
-      ::tensorflow::DataType dtype;
-      std::vector<int64> shape;
+  return OkStatus();
+}
 
-      TF_RETURN_IF_ERROR(ParseNumpyHeader(&stream, &dtype, &shape));
-      arrays->push_back(filename_inzip);
-      shapes->push_back(shape);
-      dtypes->push_back(dtype);
+// Shares the arrays of a file between kernels and calls, so that reading an
+// array of a .npz file neither walks the zip directory nor parses the numpy
+// headers again. The arrays of a file are looked up again once its size or
+// modification time changes.
+class NumpyArchiveCache {
+ public:
+  static NumpyArchiveCache* Global() {
+    static NumpyArchiveCache* cache = new NumpyArchiveCache();
+    return cache;
+  }
 
-      if ((i + 1) < gi.number_entry) {
-        err = unzGoToNextFile(uf);
-        if (err != UNZ_OK) {
-          return errors::InvalidArgument(
-              "error with zipfile in unzGoToNextFile: ", err);
-        }
+  Status Get(Env* env, const string& filename,
+             std::shared_ptr<NumpyArchive>* archive) {
+    FileStatistics stat;
+    TF_RETURN_IF_ERROR(env->Stat(filename, &stat));
+    {
+      mutex_lock l(mu_);
+      auto it = archives_.find(filename);
+      if (it != archives_.end() && it->second->size == stat.length &&
+          it->second->mtime_nsec == stat.mtime_nsec) {
+        *archive = it->second;
+        return OkStatus();
       }
     }
+
+    std::unique_ptr<tensorflow::RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+    std::shared_ptr<NumpyArchive> built = std::make_shared<NumpyArchive>();
+    built->size = stat.length;
+    built->mtime_nsec = stat.mtime_nsec;
+    TF_RETURN_IF_ERROR(
+        BuildNumpyArchive(filename, stat.length, file.get(), built.get()));
+
+    mutex_lock l(mu_);
+    if (archives_.size() >= kMaxArchives && !archives_.count(filename)) {
+      archives_.erase(archives_.begin());
+    }
+    archives_[filename] = built;
+    *archive = std::move(built);
+    return OkStatus();
+  }
+
+ private:
+  static constexpr size_t kMaxArchives = 64;
+
+  mutex mu_;
+  std::map<string, std::shared_ptr<NumpyArchive>> archives_ TF_GUARDED_BY(mu_);
+};
+
+// Reads exactly n bytes at offset of file.
+Status ReadFully(tensorflow::RandomAccessFile* file, const uint64 offset,
+                 const size_t n, char* scratch, StringPiece* result) {
+  Status status = file->Read(offset, n, result, scratch);
+  if (result->size() == n) {
+    return OkStatus();
+  }
+  if (status.ok() || errors::IsOutOfRange(status)) {
+    return errors::DataLoss("numpy array is truncated at ", offset);
+  }
+  return status;
+}
+
+// Feeds the next chunk of the compressed data at data_offset into strm, where
+// read is the number of compressed bytes fed so far.
+Status FeedInflate(tensorflow::RandomAccessFile* file, const uint64 data_offset,
+                   const uint64 compressed_size, std::vector<char>* input,
+                   uint64* read, z_stream* strm) {
+  const size_t n = std::min<uint64>(input->size(), compressed_size - *read);
+  if (n == 0) {
+    return errors::DataLoss("compressed numpy array is truncated");
+  }
+  StringPiece result;
+  TF_RETURN_IF_ERROR(
+      ReadFully(file, data_offset + *read, n, input->data(), &result));
+  *read += n;
+  strm->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(result.data()));
+  strm->avail_in = n;
+  return OkStatus();
+}
+
+// Inflates the raw deflate data of an entry once and records a checkpoint
+// at the first block boundary after every kInflateSpan uncompressed bytes.
+Status BuildInflatePoints(tensorflow::RandomAccessFile* file,
+                          const uint64 data_offset,
+                          const uint64 compressed_size,
+                          std::vector<InflatePoint>* points) {
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+    return errors::Internal("unable to initialize inflate");
+  }
+  auto cleanup = gtl::MakeCleanup([&strm] { inflateEnd(&strm); });
+
+  std::vector<InflatePoint> built;
+  built.push_back(InflatePoint{0, 0, 0, ""});
+  std::vector<char> input(kInflateChunkSize);
+  // The window is circular, the oldest byte is the next one written
+  std::vector<char> window(kInflateWindowSize);
+  uint64 read = 0;
+  uint64 total_in = 0;
+  uint64 total_out = 0;
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END) {
+    if (strm.avail_in == 0) {
+      TF_RETURN_IF_ERROR(FeedInflate(file, data_offset, compressed_size,
+                                     &input, &read, &strm));
+    }
+    if (strm.avail_out == 0) {
+      strm.next_out = reinterpret_cast<Bytef*>(window.data());
+      strm.avail_out = window.size();
+    }
+    const uInt avail_in = strm.avail_in;
+    const uInt avail_out = strm.avail_out;
+    ret = inflate(&strm, Z_BLOCK);
+    if (ret != Z_OK && ret != Z_STREAM_END) {
+      return errors::DataLoss("error inflating numpy array: ", ret);
+    }
+    total_in += avail_in - strm.avail_in;
+    total_out += avail_out - strm.avail_out;
+    // Inflating can resume at the end of a block that is not the last one
+    if ((strm.data_type & 128) && !(strm.data_type & 64) &&
+        total_out - built.back().out > kInflateSpan) {
+      InflatePoint point{total_out, total_in, strm.data_type & 7, ""};
+      const size_t left = strm.avail_out;
+      point.window.reserve(window.size());
+      point.window.append(window.data() + window.size() - left, left);
+      point.window.append(window.data(), window.size() - left);
+      built.push_back(std::move(point));
+    }
+  }
+  *points = std::move(built);
+  return OkStatus();
+}
+
+// Inflates `length` bytes at `offset` of the uncompressed data of an entry
+// into output, resuming at point.
+Status InflateRange(tensorflow::RandomAccessFile* file,
+                    const uint64 data_offset, const uint64 compressed_size,
+                    const InflatePoint& point, const uint64 offset,
+                    uint64 length, char* output) {
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+    return errors::Internal("unable to initialize inflate");
+  }
+  auto cleanup = gtl::MakeCleanup([&strm] { inflateEnd(&strm); });
+
+  if (point.bits != 0) {
+    char byte;
+    StringPiece result;
+    TF_RETURN_IF_ERROR(
+        ReadFully(file, data_offset + point.in - 1, 1, &byte, &result));
+    inflatePrime(&strm, point.bits,
+                 static_cast<uint8>(result[0]) >> (8 - point.bits));
+  }
+  if (!point.window.empty()) {
+    inflateSetDictionary(&strm,
+                         reinterpret_cast<const Bytef*>(point.window.data()),
+                         point.window.size());
   }
 
+  std::vector<char> input(kInflateChunkSize);
+  std::vector<char> discard(kInflateWindowSize);
+  uint64 read = point.in;
+  uint64 skip = offset - point.out;
+  while (length > 0) {
+    if (strm.avail_in == 0) {
+      TF_RETURN_IF_ERROR(FeedInflate(file, data_offset, compressed_size,
+                                     &input, &read, &strm));
+    }
+    const uInt avail_out =
+        skip > 0 ? std::min<uint64>(skip, discard.size())
+                 : std::min<uint64>(length, std::numeric_limits<uInt>::max());
+    strm.next_out =
+        reinterpret_cast<Bytef*>(skip > 0 ? discard.data() : output);
+    strm.avail_out = avail_out;
+    const int ret = inflate(&strm, Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END) {
+      return errors::DataLoss("error inflating numpy array: ", ret);
+    }
+    const uint64 produced = avail_out - strm.avail_out;
+    if (skip > 0) {
+      skip -= produced;
+    } else {
+      output += produced;
+      length -= produced;
+    }
+    if (ret == Z_STREAM_END && length > 0) {
+      return errors::DataLoss("compressed numpy array is truncated");
+    }
+  }
   return OkStatus();
 }
 
@@ -382,18 +652,18 @@ class NumpyInfoOp : public OpKernel {
     const Tensor& filename_tensor = context->input(0);
     string filename = filename_tensor.scalar<tstring>()();
 
-    uint64 size;
-    OP_REQUIRES_OK(context, env_->GetFileSize(filename, &size));
-
-    std::unique_ptr<tensorflow::RandomAccessFile> file;
-    OP_REQUIRES_OK(context, env_->NewRandomAccessFile(filename, &file));
+    std::shared_ptr<NumpyArchive> archive;
+    OP_REQUIRES_OK(context,
+                   NumpyArchiveCache::Global()->Get(env_, filename, &archive));
 
     std::vector<string> arrays;
     std::vector<std::vector<int64>> shapes;
     std::vector<int64> dtypes;
-
-    OP_REQUIRES_OK(context,
-                   NumpyInfo(filename, size, file, &arrays, &shapes, &dtypes));
+    for (const auto& array : archive->arrays) {
+      arrays.push_back(array->name);
+      shapes.push_back(array->shape);
+      dtypes.push_back(array->dtype);
+    }
 
     TensorShape output_shape = filename_tensor.shape();
     output_shape.AddDim(arrays.size());
@@ -446,31 +716,16 @@ class NumpySpecOp : public OpKernel {
     const Tensor& array_tensor = context->input(1);
     string array = array_tensor.scalar<tstring>()();
 
-    uint64 size;
-    OP_REQUIRES_OK(context, env_->GetFileSize(filename, &size));
-
-    std::unique_ptr<tensorflow::RandomAccessFile> file;
-    OP_REQUIRES_OK(context, env_->NewRandomAccessFile(filename, &file));
-
-    std::vector<string> arrays;
-    std::vector<std::vector<int64>> shapes;
-    std::vector<int64> dtypes;
-
+    std::shared_ptr<NumpyArchive> archive;
     OP_REQUIRES_OK(context,
-                   NumpyInfo(filename, size, file, &arrays, &shapes, &dtypes));
+                   NumpyArchiveCache::Global()->Get(env_, filename, &archive));
 
-    std::vector<int64> shape;
-    int64 dtype = DT_INVALID;
-    for (size_t i = 0; i < arrays.size(); i++) {
-      if (arrays[i] == array) {
-        shape = shapes[i];
-        dtype = dtypes[i];
-        break;
-      }
-    }
-    OP_REQUIRES(context, (dtype != DT_INVALID),
+    const NumpyArray* entry = archive->Find(array);
+    OP_REQUIRES(context, (entry != nullptr),
                 errors::InvalidArgument("unable to find array ", array, " in ",
                                         filename));
+    const std::vector<int64>& shape = entry->shape;
+    const int64 dtype = entry->dtype;
 
     TensorShape dtype_shape = filename_tensor.shape();
     TensorShape shape_shape = dtype_shape;
@@ -495,11 +750,44 @@ class NumpySpecOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// TensorBuffer over a memory mapped file, holds a reference to the mapped
+// region which is unmapped once the last tensor aliasing it is released
+class NumpyMemoryRegionBuffer : public TensorBuffer {
+ public:
+  NumpyMemoryRegionBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                          const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("numpy_memory_region");
+  }
+
+  // Prevents kernels from forwarding the buffer and writing into the mapping
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 class NumpyReadOp : public OpKernel {
  public:
   explicit NumpyReadOp(OpKernelConstruction* context) : OpKernel(context) {
     env_ = context->env();
     OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+    // Arrays fed to a GPU may be read into pinned host memory, from which
+    // they are copied to the device without a staging copy.
+    bool gpu_compatible = false;
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("gpu_compatible", &gpu_compatible));
+    output_attr_.set_gpu_compatible(gpu_compatible);
   }
 
   void Compute(OpKernelContext* context) override {
@@ -535,76 +823,63 @@ class NumpyReadOp : public OpKernel {
       return;
     }
 
-    uint64 size;
-    OP_REQUIRES_OK(context, env_->GetFileSize(filename, &size));
+    std::shared_ptr<NumpyArchive> archive;
+    OP_REQUIRES_OK(context,
+                   NumpyArchiveCache::Global()->Get(env_, filename, &archive));
+    // A .npy file holds a single array whatever its name
+    NumpyArray* entry =
+        archive->zip ? archive->Find(array) : archive->arrays[0].get();
+    OP_REQUIRES(context, (entry != nullptr),
+                errors::InvalidArgument("unable to find array ", array, " in ",
+                                        filename));
 
     std::unique_ptr<tensorflow::RandomAccessFile> file;
     OP_REQUIRES_OK(context, env_->NewRandomAccessFile(filename, &file));
 
-    struct zlib_fileopaque64_def fileopaque;
-    fileopaque.offset = 0;
-    fileopaque.length = size;
-    fileopaque.file = file.get();
-
-    zlib_filefunc64_def filefunc;
-    memset(&filefunc, 0x00, sizeof(zlib_filefunc64_def));
-    filefunc.zopen64_file = filefunc_open64;
-    filefunc.zread_file = filefunc_read;
-    filefunc.zwrite_file = filefunc_write;
-    filefunc.ztell64_file = filefunc_tell64;
-    filefunc.zseek64_file = filefunc_seek64;
-    filefunc.zclose_file = filefunc_close;
-    filefunc.zerror_file = filefunc_error;
-    filefunc.opaque = (voidpf)&fileopaque;
-
-    unzFile uf = unzOpen2_64(filename.c_str(), &filefunc);
-    if (uf == NULL) {
-      // Not a zip file, try normal file
-      io::RandomAccessInputStream stream(file.get());
-      ::tensorflow::DataType dtype;
-      std::vector<int64> shape;
-      OP_REQUIRES_OK(context, ParseNumpyHeader(&stream, &dtype, &shape));
-      OP_REQUIRES_OK(context, CopyNumpyToOutput(context, &stream, dtype, shape,
-                                                start, stop));
+    // Entries that are stored, as written by numpy.savez, are read in place
+    // like a .npy file, and entries that are deflated, as written by
+    // numpy.savez_compressed, are inflated straight from the file. Neither
+    // goes through a zip handle, so reads of an archive run concurrently.
+    if (entry->compression_method == 0 && !entry->encrypted &&
+        (!archive->zip || entry->data_offset != 0)) {
+      OP_REQUIRES_OK(context,
+                     ReadNumpyPayload(context, filename, file.get(),
+                                      archive->size,
+                                      entry->data_offset + entry->header_size,
+                                      entry->dtype, entry->shape, start, stop));
+    } else if (entry->compression_method == Z_DEFLATED && !entry->encrypted &&
+               entry->data_offset != 0) {
+      OP_REQUIRES_OK(context, ReadDeflatedPayload(context, file.get(), entry,
+                                                  start, stop));
     } else {
-      string entry = array + ".npy";
-      int err = unzLocateFile(uf, entry.c_str(), 0);
-      OP_REQUIRES(context, (err == UNZ_OK),
-                  errors::InvalidArgument(
-                      "error with zipfile in unzLocateFile: ", err));
-
-      char filename_inzip[256];
-      unz_file_info64 file_info;
-
-      err = unzGetCurrentFileInfo64(uf, &file_info, filename_inzip,
-                                    sizeof(filename_inzip), NULL, 0, NULL, 0);
-      OP_REQUIRES(context, (err == UNZ_OK),
-                  errors::InvalidArgument(
-                      "error with zipfile in unzGetCurrentFileInfo: ", err));
-
-      err = unzOpenCurrentFile(uf);
-      OP_REQUIRES(context, (err == UNZ_OK),
-                  errors::InvalidArgument(
-                      "error with zipfile in unzOpenCurrentFile: ", err));
-
-      ZipObjectInputStream stream(uf);
-
-      ::tensorflow::DataType dtype;
-      std::vector<int64> shape;
-      OP_REQUIRES_OK(context, ParseNumpyHeader(&stream, &dtype, &shape));
-      OP_REQUIRES_OK(context, CopyNumpyToOutput(context, &stream, dtype, shape,
-                                                start, stop));
-
-      unzClose(uf);
+      OP_REQUIRES_OK(context, ReadZipEntry(context, filename, file.get(),
+                                           archive->size, *entry, start, stop));
     }
   }
 
  protected:
-  Status CopyNumpyToOutput(OpKernelContext* context,
-                           io::InputStreamInterface* stream,
-                           const ::tensorflow::DataType dtype,
+  // Returns the output shape of rows [start, stop) of an array of `shape`,
+  // with the byte range of those rows in the payload of the array.
+  static Status NumpySlice(const ::tensorflow::DataType dtype,
                            const std::vector<int64>& shape, const int64 start,
-                           const int64 stop) {
+                           const int64 stop, TensorShape* output_shape,
+                           int64* bytes_start, int64* bytes_stop) {
+    switch (dtype) {
+      case ::tensorflow::DT_INT8:
+      case ::tensorflow::DT_INT16:
+      case ::tensorflow::DT_INT32:
+      case ::tensorflow::DT_INT64:
+      case ::tensorflow::DT_UINT8:
+      case ::tensorflow::DT_UINT16:
+      case ::tensorflow::DT_UINT32:
+      case ::tensorflow::DT_UINT64:
+      case ::tensorflow::DT_FLOAT:
+      case ::tensorflow::DT_DOUBLE:
+        break;
+      default:
+        return errors::InvalidArgument("unsupported type: ", dtype);
+    }
+
     int64 data_start = start;
     int64 data_stop = stop;
     if (data_start > shape[0]) {
@@ -617,70 +892,184 @@ class NumpyReadOp : public OpKernel {
       data_stop = data_start;
     }
 
-    TensorShape output_shape;
-
     int64 slice = 1;
 
-    output_shape.AddDim(data_stop - data_start);
+    output_shape->Clear();
+    output_shape->AddDim(data_stop - data_start);
     for (size_t i = 1; i < shape.size(); i++) {
       slice = slice * shape[i];
 
-      output_shape.AddDim(shape[i]);
+      output_shape->AddDim(shape[i]);
+    }
+    *bytes_start = data_start * slice * ::tensorflow::DataTypeSize(dtype);
+    *bytes_stop = data_stop * slice * ::tensorflow::DataTypeSize(dtype);
+    return OkStatus();
+  }
+
+  // Reads the rows of an uncompressed array whose payload starts at
+  // `payload_offset` of the file. Local files are memory mapped, and the
+  // output aliases the mapping when the rows are aligned and the output is
+  // not to be pinned, while other files are read straight into the output.
+  Status ReadNumpyPayload(OpKernelContext* context, const string& filename,
+                          tensorflow::RandomAccessFile* file,
+                          const uint64 file_size, const uint64 payload_offset,
+                          const ::tensorflow::DataType dtype,
+                          const std::vector<int64>& shape, const int64 start,
+                          const int64 stop) {
+    TensorShape output_shape;
+    int64 bytes_start, bytes_stop;
+    TF_RETURN_IF_ERROR(NumpySlice(dtype, shape, start, stop, &output_shape,
+                                  &bytes_start, &bytes_stop));
+    const uint64 offset = payload_offset + bytes_start;
+    const uint64 length = bytes_stop - bytes_start;
+    if (offset + length > file_size) {
+      return errors::InvalidArgument("numpy array of ", filename,
+                                     " is truncated: ", offset + length,
+                                     " bytes expected but ", file_size,
+                                     " available");
+    }
+
+    StringPiece scheme, host, path;
+    io::ParseURI(filename, &scheme, &host, &path);
+    if (length > 0 && (scheme.empty() || scheme == "file")) {
+      std::unique_ptr<ReadOnlyMemoryRegion> region;
+      if (env_->NewReadOnlyMemoryRegionFromFile(filename, &region).ok() &&
+          region->length() >= offset + length) {
+        const char* data = static_cast<const char*>(region->data()) + offset;
+        if (!output_attr_.gpu_compatible() &&
+            reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+          NumpyMemoryRegionBuffer* buffer = new NumpyMemoryRegionBuffer(
+              std::shared_ptr<ReadOnlyMemoryRegion>(std::move(region)), data,
+              length);
+          Tensor output_tensor(dtype, output_shape, buffer);
+          buffer->Unref();
+          context->set_output(0, output_tensor);
+          return OkStatus();
+        }
+        Tensor* output_tensor;
+        TF_RETURN_IF_ERROR(
+            context->allocate_output(0, output_shape, &output_tensor,
+                                 output_attr_));
+        memcpy(output_tensor->data(), data, length);
+        return OkStatus();
+      }
+    }
+
+    Tensor* output_tensor;
+    TF_RETURN_IF_ERROR(
+        context->allocate_output(0, output_shape, &output_tensor,
+                                 output_attr_));
+    if (length > 0) {
+      char* p = static_cast<char*>(output_tensor->data());
+      StringPiece result;
+      TF_RETURN_IF_ERROR(file->Read(offset, length, &result, p));
+      if (result.size() != length) {
+        return errors::DataLoss("numpy array of ", filename, " is truncated");
+      }
+      if (result.data() != p) {
+        memcpy(p, result.data(), length);
+      }
     }
+    return OkStatus();
+  }
 
-#define PROCESS_TYPE(TYPE)                                                    \
-  {                                                                           \
-    int64 bytes_start =                                                       \
-        data_start * slice * ::tensorflow::DataTypeSize(dtype);               \
-    int64 bytes_stop = data_stop * slice * ::tensorflow::DataTypeSize(dtype); \
-    TF_RETURN_IF_ERROR(stream->SkipNBytes(bytes_start));                      \
-    Tensor* output_tensor;                                                    \
-    TF_RETURN_IF_ERROR(                                                       \
-        context->allocate_output(0, output_shape, &output_tensor));           \
-    void* p = output_tensor->flat<TYPE>().data();                             \
-    if (bytes_stop > bytes_start) {                                           \
-      tstring buffer;                                                         \
-      TF_RETURN_IF_ERROR(                                                     \
-          stream->ReadNBytes(bytes_stop - bytes_start, &buffer));             \
-      memcpy(p, buffer.data(), bytes_stop - bytes_start);                     \
-    }                                                                         \
+  // Inflates the rows of a deflated entry. A read that starts past the
+  // beginning of the array builds the inflate checkpoints of the entry once,
+  // so that each later read only inflates from the checkpoint before it.
+  Status ReadDeflatedPayload(OpKernelContext* context,
+                             tensorflow::RandomAccessFile* file,
+                             NumpyArray* entry, const int64 start,
+                             const int64 stop) {
+    TensorShape output_shape;
+    int64 bytes_start, bytes_stop;
+    TF_RETURN_IF_ERROR(NumpySlice(entry->dtype, entry->shape, start, stop,
+                                  &output_shape, &bytes_start, &bytes_stop));
+    Tensor* output_tensor;
+    TF_RETURN_IF_ERROR(
+        context->allocate_output(0, output_shape, &output_tensor,
+                                 output_attr_));
+    if (bytes_stop <= bytes_start) {
+      return OkStatus();
+    }
+    const uint64 offset = entry->header_size + bytes_start;
+
+    InflatePoint point{0, 0, 0, ""};
+    {
+      mutex_lock l(entry->mu);
+      if (entry->points.empty() && bytes_start > 0) {
+        TF_RETURN_IF_ERROR(BuildInflatePoints(file, entry->data_offset,
+                                              entry->compressed_size,
+                                              &entry->points));
+      }
+      // The point is copied so that the inflate runs without the lock
+      for (const InflatePoint& p : entry->points) {
+        if (p.out > offset) {
+          break;
+        }
+        point = p;
+      }
+    }
+    return InflateRange(file, entry->data_offset, entry->compressed_size,
+                        point, offset, bytes_stop - bytes_start,
+                        static_cast<char*>(output_tensor->data()));
   }
 
-    switch (dtype) {
-      case ::tensorflow::DT_INT8:
-        PROCESS_TYPE(int8);
-        break;
-      case ::tensorflow::DT_INT16:
-        PROCESS_TYPE(int16);
-        break;
-      case ::tensorflow::DT_INT32:
-        PROCESS_TYPE(int32);
-        break;
-      case ::tensorflow::DT_INT64:
-        PROCESS_TYPE(int64);
-        break;
-      case ::tensorflow::DT_UINT8:
-        PROCESS_TYPE(uint8);
-        break;
-      case ::tensorflow::DT_UINT16:
-        PROCESS_TYPE(uint16);
-        break;
-      case ::tensorflow::DT_UINT32:
-        PROCESS_TYPE(uint32);
-        break;
-      case ::tensorflow::DT_UINT64:
-        PROCESS_TYPE(uint64);
-        break;
-      case ::tensorflow::DT_FLOAT:
-        PROCESS_TYPE(float);
-        break;
-      case ::tensorflow::DT_DOUBLE:
-        PROCESS_TYPE(double);
-        break;
-      default:
-        return errors::InvalidArgument("unsupported type: ", dtype);
+  // Reads the rows of an entry through minizip, for entries that are neither
+  // stored nor deflated, or are encrypted.
+  Status ReadZipEntry(OpKernelContext* context, const string& filename,
+                      tensorflow::RandomAccessFile* file, const uint64 size,
+                      const NumpyArray& entry, const int64 start,
+                      const int64 stop) {
+    struct zlib_fileopaque64_def fileopaque;
+    zlib_filefunc64_def filefunc;
+    InitZipFileFunc(file, size, &fileopaque, &filefunc);
+
+    unzFile uf = unzOpen2_64(filename.c_str(), &filefunc);
+    if (uf == NULL) {
+      return errors::InvalidArgument("unable to open zipfile ", filename);
     }
+    std::unique_ptr<unzFile, void (*)(unzFile*)> unzFile_scope_(
+        &uf, [](unzFile* p) {
+          if (p != nullptr) {
+            unzClose(*p);
+          }
+        });
+    unz64_file_pos pos = entry.pos;
+    int err = unzGoToFilePos64(uf, &pos);
+    if (err != UNZ_OK) {
+      return errors::InvalidArgument("error with zipfile in unzGoToFilePos: ",
+                                     err);
+    }
+    err = unzOpenCurrentFile(uf);
+    if (err != UNZ_OK) {
+      return errors::InvalidArgument(
+          "error with zipfile in unzOpenCurrentFile: ", err);
+    }
+    ZipObjectInputStream stream(uf);
+    TF_RETURN_IF_ERROR(stream.SkipNBytes(entry.header_size));
+    return CopyNumpyToOutput(context, &stream, entry.dtype, entry.shape, start,
+                             stop);
+  }
 
+  Status CopyNumpyToOutput(OpKernelContext* context,
+                           io::InputStreamInterface* stream,
+                           const ::tensorflow::DataType dtype,
+                           const std::vector<int64>& shape, const int64 start,
+                           const int64 stop) {
+    TensorShape output_shape;
+    int64 bytes_start, bytes_stop;
+    TF_RETURN_IF_ERROR(NumpySlice(dtype, shape, start, stop, &output_shape,
+                                  &bytes_start, &bytes_stop));
+    TF_RETURN_IF_ERROR(stream->SkipNBytes(bytes_start));
+    Tensor* output_tensor;
+    TF_RETURN_IF_ERROR(
+        context->allocate_output(0, output_shape, &output_tensor,
+                                 output_attr_));
+    if (bytes_stop > bytes_start) {
+      tstring buffer;
+      TF_RETURN_IF_ERROR(stream->ReadNBytes(bytes_stop - bytes_start, &buffer));
+      memcpy(output_tensor->data(), buffer.data(), bytes_stop - bytes_start);
+    }
     return OkStatus();
   }
 
@@ -688,6 +1077,7 @@ class NumpyReadOp : public OpKernel {
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   ::tensorflow::DataType dtype_ TF_GUARDED_BY(mu_);
+  AllocatorAttributes output_attr_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>NumpyInfo").Device(DEVICE_CPU), NumpyInfoOp);
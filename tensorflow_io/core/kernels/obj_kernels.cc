@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tiny_obj_loader.h"
 
 namespace tensorflow {
@@ -52,18 +53,143 @@ class DecodeObjOp : public OpKernel {
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(0, TensorShape({count, 3}),
                                                      &output_tensor));
-    // Loop over attrib.vertices:
+    std::copy(attrib.vertices.begin(), attrib.vertices.begin() + count * 3,
+              output_tensor->flat<float>().data());
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeObj").Device(DEVICE_CPU), DecodeObjOp);
+
+// Decodes a batch of meshes in parallel, with one mesh per unit of work of
+// the CPU worker threads. The vertices, normals and texture coordinates of
+// all meshes, and the (vertex, normal, texcoord) indices of the corners of
+// their triangles, are concatenated along the first dimension with row
+// splits. Indices are local to their mesh, and -1 where a corner has no
+// normal or texture coordinate.
+class DecodeObjBatchOp : public OpKernel {
+ public:
+  explicit DecodeObjBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const int64 count = input_tensor->NumElements();
+
+    // Meshes are small and parse in microseconds, so several of them share a
+    // unit of work.
+    static constexpr int64 kCostPerMesh = 1 << 14;
+    const DeviceBase::CpuWorkerThreads* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+
+    std::vector<Mesh> meshes(count);
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerMesh, [&](int64 begin, int64 end) {
+            for (int64 i = begin; i < end; i++) {
+              meshes[i].status =
+                  Decode(input_tensor->flat<tstring>()(i), &meshes[i]);
+            }
+          });
     for (int64 i = 0; i < count; i++) {
-      tinyobj::real_t x = attrib.vertices[i * 3 + 0];
-      tinyobj::real_t y = attrib.vertices[i * 3 + 1];
-      tinyobj::real_t z = attrib.vertices[i * 3 + 2];
-      output_tensor->tensor<float, 2>()(i, 0) = x;
-      output_tensor->tensor<float, 2>()(i, 1) = y;
-      output_tensor->tensor<float, 2>()(i, 2) = z;
+      OP_REQUIRES(context, meshes[i].status.ok(),
+                  errors::InvalidArgument("mesh ", i, ": ",
+                                          meshes[i].status.error_message()));
+    }
+
+    // Each output is a float or int32 buffer with its row splits.
+    static constexpr int kComponents = 4;
+    const int64 widths[kComponents] = {3, 3, 2, 3};
+    Tensor* splits[kComponents];
+    for (int c = 0; c < kComponents; c++) {
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(2 * c + 1,
+                                              TensorShape({count + 1}),
+                                              &splits[c]));
+      auto row_splits = splits[c]->flat<int64>();
+      row_splits(0) = 0;
+      for (int64 i = 0; i < count; i++) {
+        row_splits(i + 1) = row_splits(i) + meshes[i].Size(c) / widths[c];
+      }
     }
+    Tensor* values[kComponents];
+    for (int c = 0; c < kComponents; c++) {
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(
+                         2 * c,
+                         TensorShape({splits[c]->flat<int64>()(count),
+                                      widths[c]}),
+                         &values[c]));
+    }
+
+    Shard(worker_threads->num_threads, worker_threads->workers, count,
+          kCostPerMesh, [&](int64 begin, int64 end) {
+            for (int64 i = begin; i < end; i++) {
+              const Mesh& mesh = meshes[i];
+              const tinyobj::attrib_t& attrib = mesh.reader.GetAttrib();
+              std::copy(attrib.vertices.begin(), attrib.vertices.end(),
+                        values[0]->flat<float>().data() +
+                            splits[0]->flat<int64>()(i) * widths[0]);
+              std::copy(attrib.normals.begin(), attrib.normals.end(),
+                        values[1]->flat<float>().data() +
+                            splits[1]->flat<int64>()(i) * widths[1]);
+              std::copy(attrib.texcoords.begin(), attrib.texcoords.end(),
+                        values[2]->flat<float>().data() +
+                            splits[2]->flat<int64>()(i) * widths[2]);
+              std::copy(mesh.indices.begin(), mesh.indices.end(),
+                        values[3]->flat<int32>().data() +
+                            splits[3]->flat<int64>()(i) * widths[3]);
+            }
+          });
+  }
+
+ private:
+  struct Mesh {
+    Status status;
+    tinyobj::ObjReader reader;
+    std::vector<int32> indices;
+
+    size_t Size(const int component) const {
+      const tinyobj::attrib_t& attrib = reader.GetAttrib();
+      switch (component) {
+        case 0:
+          return attrib.vertices.size();
+        case 1:
+          return attrib.normals.size();
+        case 2:
+          return attrib.texcoords.size();
+        default:
+          return indices.size();
+      }
+    }
+  };
+
+  static Status Decode(const tstring& input, Mesh* mesh) {
+    tinyobj::ObjReader& reader = mesh->reader;
+    if (!reader.ParseFromString(string(input), "")) {
+      return errors::InvalidArgument("unable to read obj file: ",
+                                     reader.Error());
+    }
+    const tinyobj::attrib_t& attrib = reader.GetAttrib();
+    if (attrib.vertices.size() % 3 != 0 || attrib.normals.size() % 3 != 0 ||
+        attrib.texcoords.size() % 2 != 0) {
+      return errors::InvalidArgument("obj file has partial attributes");
+    }
+    size_t corners = 0;
+    for (const tinyobj::shape_t& shape : reader.GetShapes()) {
+      corners += shape.mesh.indices.size();
+    }
+    mesh->indices.reserve(corners * 3);
+    for (const tinyobj::shape_t& shape : reader.GetShapes()) {
+      for (const tinyobj::index_t& index : shape.mesh.indices) {
+        mesh->indices.push_back(index.vertex_index);
+        mesh->indices.push_back(index.normal_index);
+        mesh->indices.push_back(index.texcoord_index);
+      }
+    }
+    return OkStatus();
   }
 };
-REGISTER_KERNEL_BUILDER(Name("IO>DecodeObj").Device(DEVICE_CPU), DecodeObjOp);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeObjBatch").Device(DEVICE_CPU),
+                        DecodeObjBatchOp);
 
 }  // namespace
 }  // namespace io
@@ -13,22 +13,53 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/overflow.h"
 
 namespace tensorflow {
 namespace io {
 namespace {
 
-struct VectorHasher {
-  int operator()(const absl::InlinedVector<int64, 4>& v) const {
-    int hash = v.size();
-    for (auto& i : v) {
-      hash ^= i + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+// Sorts the rows by their keys, less than 2^bits, keeping the order of
+// the rows with the same key, with a least significant digit radix sort.
+void RadixSortRows(const int bits, std::vector<int64>* keys,
+                   std::vector<int64>* rows) {
+  static constexpr int kDigitBits = 11;
+  static constexpr int64 kDigits = 1 << kDigitBits;
+  const size_t n = keys->size();
+  std::vector<int64> sorted_keys(n);
+  std::vector<int64> sorted_rows(n);
+  std::vector<int64> counts(kDigits);
+  for (int shift = 0; shift < bits; shift += kDigitBits) {
+    std::fill(counts.begin(), counts.end(), 0);
+    for (size_t i = 0; i < n; i++) {
+      counts[((*keys)[i] >> shift) & (kDigits - 1)]++;
+    }
+    int64 total = 0;
+    for (int64 d = 0; d < kDigits; d++) {
+      const int64 count = counts[d];
+      counts[d] = total;
+      total += count;
+    }
+    for (size_t i = 0; i < n; i++) {
+      const int64 p = counts[((*keys)[i] >> shift) & (kDigits - 1)]++;
+      sorted_keys[p] = (*keys)[i];
+      sorted_rows[p] = (*rows)[i];
     }
-    return hash;
+    keys->swap(sorted_keys);
+    rows->swap(sorted_rows);
   }
-};
+}
 
+// Groups the indices by all of their coordinates but the one of `axis`,
+// and lays out the coordinates of `axis` of each group, in the order of the
+// input, along `axis` of the output. The coordinates are first linearized
+// into int64 keys, which are then ranked by counting when there are few
+// enough possible keys, or by a radix sort otherwise.
 class OrderIndicesOp : public OpKernel {
  public:
   explicit OrderIndicesOp(OpKernelConstruction* context) : OpKernel(context) {}
@@ -46,67 +77,100 @@ class OrderIndicesOp : public OpKernel {
 
     const Tensor& axis_tensor = context->input(2);
     const int64 axis = axis_tensor.scalar<int64>()();
-    OP_REQUIRES(context, axis < shape_tensor.NumElements(),
+    OP_REQUIRES(context, axis >= 0 && axis < shape_tensor.NumElements(),
                 errors::InvalidArgument("axis must be within [0, ",
                                         shape_tensor.NumElements(), ")"));
     OP_REQUIRES(context, shape_tensor.NumElements() == input_tensor.dim_size(1),
                 errors::InvalidArgument("shape size must equal to ",
                                         input_tensor.dim_size(1), ")"));
-    std::unordered_map<absl::InlinedVector<int64, 4>,
-                       absl::InlinedVector<int64, 4>, VectorHasher>
-        entries;
-    for (int64 i = 0; i < input_tensor.dim_size(0); i++) {
-      absl::InlinedVector<int64, 4> k;
-      k.reserve(input_tensor.dim_size(1));
-      for (int64 j = 0; j < input_tensor.dim_size(1); j++) {
-        k.push_back(input_tensor.matrix<int64>()(i, j));
+
+    const int64 rank = shape_tensor.NumElements();
+    const auto shape = shape_tensor.flat<int64>();
+    // The keys are the coordinates but `axis` in row-major order, split
+    // around `axis` as key = outer * inner + remainder.
+    int64 inner = 1;
+    int64 keys_count = 1;
+    for (int64 j = rank - 1; j >= 0; j--) {
+      if (j == axis) {
+        inner = keys_count;
+        continue;
       }
-      k[axis] = 0;
+      OP_REQUIRES(context, shape(j) >= 0,
+                  errors::InvalidArgument("invalid shape: ", shape(j)));
+      keys_count = MultiplyWithoutOverflow(keys_count, shape(j));
+      OP_REQUIRES(context, keys_count >= 0,
+                  errors::InvalidArgument("shape is too large"));
+    }
 
-      const auto& lookup = entries.find(k);
-      if (lookup == entries.end()) {
-        entries[k] = absl::InlinedVector<int64, 4>();
+    const auto input = input_tensor.matrix<int64>();
+    const int64 n = input_tensor.dim_size(0);
+    std::vector<int64> keys(n);
+    for (int64 i = 0; i < n; i++) {
+      int64 key = 0;
+      for (int64 j = 0; j < rank; j++) {
+        if (j == axis) {
+          continue;
+        }
+        OP_REQUIRES(context, input(i, j) >= 0 && input(i, j) < shape(j),
+                    errors::InvalidArgument("index ", input(i, j),
+                                            " is out of bounds [0, ",
+                                            shape(j), ") of dimension ", j));
+        key = key * shape(j) + input(i, j);
       }
-      entries[k].push_back(input_tensor.matrix<int64>()(i, axis));
+      keys[i] = key;
     }
 
+    // The position in its group of each row.
+    std::vector<int64> ranks(n);
     int64 max_size = 0;
-    for (const auto& lookup : entries) {
-      max_size =
-          (max_size > lookup.second.size()) ? max_size : lookup.second.size();
+    if (keys_count <= std::max<int64>(n, kMinCountingKeys) * 2) {
+      std::vector<int64> counts(keys_count, 0);
+      for (int64 i = 0; i < n; i++) {
+        ranks[i] = counts[keys[i]]++;
+        max_size = std::max(max_size, ranks[i] + 1);
+      }
+    } else {
+      std::vector<int64> sorted_keys(keys);
+      std::vector<int64> rows(n);
+      std::iota(rows.begin(), rows.end(), 0);
+      int bits = 0;
+      while (bits < 63 && (keys_count - 1) >> bits != 0) {
+        bits++;
+      }
+      RadixSortRows(bits, &sorted_keys, &rows);
+      for (int64 i = 0; i < n; i++) {
+        ranks[rows[i]] =
+            (i > 0 && sorted_keys[i] == sorted_keys[i - 1])
+                ? ranks[rows[i - 1]] + 1
+                : 0;
+        max_size = std::max(max_size, ranks[rows[i]] + 1);
+      }
     }
 
     absl::InlinedVector<int64, 4> dims;
-    dims.reserve(shape_tensor.NumElements());
-    for (int64 i = 0; i < shape_tensor.NumElements(); i++) {
-      dims.push_back(shape_tensor.flat<int64>()(i));
+    dims.reserve(rank);
+    for (int64 i = 0; i < rank; i++) {
+      dims.push_back(shape(i));
     }
     dims[axis] = max_size;
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(0, TensorShape(dims),
                                                      &output_tensor));
-    for (int64 i = 0; i < output_tensor->NumElements(); i++) {
-      output_tensor->flat<int64>()(i) = -1;
-    }
-
-    absl::InlinedVector<int64, 4> multiplier(dims.size(), 1);
-    for (int64 i = multiplier.size() - 2; i >= 0; i--) {
-      multiplier[i] = multiplier[i + 1] * dims[i + 1];
-    }
-
-    for (const auto& lookup : entries) {
-      absl::InlinedVector<int64, 4> index(lookup.first.begin(),
-                                          lookup.first.end());
-      for (int64 e = 0; e < lookup.second.size(); e++) {
-        index[axis] = e;
-        int64 offset = 0;
-        for (int64 ii = 0; ii < index.size(); ii++) {
-          offset += index[ii] * multiplier[ii];
-        }
-        output_tensor->flat<int64>()(offset) = lookup.second[e];
-      }
+    auto output = output_tensor->flat<int64>();
+    std::fill(output.data(), output.data() + output.size(), -1);
+
+    for (int64 i = 0; i < n; i++) {
+      const int64 outer = keys[i] / inner;
+      const int64 remainder = keys[i] % inner;
+      output((outer * max_size + ranks[i]) * inner + remainder) =
+          input(i, axis);
     }
   }
+
+ private:
+  // Counting is used for up to twice as many possible keys as rows, or
+  // this many.
+  static constexpr int64 kMinCountingKeys = 1 << 16;
 };
 REGISTER_KERNEL_BUILDER(Name("IO>OrderIndices").Device(DEVICE_CPU),
                         OrderIndicesOp);
@@ -13,15 +13,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <ctime>
 #include <iostream>
+#include <list>
 #include <orc/Exceptions.hh>
 #include <orc/OrcFile.hh>
 #include <orc/Reader.hh>
 #include <orc/Type.hh>
 
 #include "orc/orc-config.hh"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
+#include "tensorflow/core/util/batch_util.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
@@ -31,28 +35,61 @@ namespace data {
 class ORCReadable : public IOReadableInterface {
  public:
   ORCReadable(Env* env) : env_(env) {}
-  ~ORCReadable() {}
+  ~ORCReadable() {
+    // Joins the stripe decodes in flight.
+    thread_pool_.reset();
+  }
   Status Init(const std::vector<string>& input,
               const std::vector<string>& metadata, const void* memory_data,
               const int64 memory_size) override {
     if (input.size() > 1) {
       return errors::InvalidArgument("more than 1 filename is not supported");
     }
-    const string& filename = input[0];
-    // read packet data
-    orc::RowReaderOptions row_reader_opts;
-    orc::ReaderOptions reader_opts;
-    std::unique_ptr<orc::Reader> reader =
-        orc::createReader(orc::readFile(filename), reader_opts);
+    filename_ = input[0];
+    // Only the columns given are decoded, or all of them if none is given.
+    std::list<std::string> include;
+    int64 num_parallel_reads = kDefaultParallelReads;
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("column: ") == 0) {
+        include.push_back(metadata[i].substr(8));
+      } else if (metadata[i].find("stream: ") == 0) {
+        stream_ = (metadata[i].substr(8) == "true");
+      } else if (metadata[i].find("batch_size: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(12), &batch_size_) ||
+            batch_size_ <= 0) {
+          return errors::InvalidArgument("invalid batch size: ", metadata[i]);
+        }
+      } else if (metadata[i].find("num_parallel_reads: ") == 0) {
+        if (!strings::safe_strto64(metadata[i].substr(20),
+                                   &num_parallel_reads) ||
+            num_parallel_reads <= 0) {
+          return errors::InvalidArgument("invalid number of parallel reads: ",
+                                         metadata[i]);
+        }
+      }
+    }
+    if (!include.empty()) {
+      row_reader_opts_.include(include);
+    }
 
-    row_reader_ = reader->createRowReader(row_reader_opts);
+    std::unique_ptr<orc::Reader> reader;
+    std::unique_ptr<orc::RowReader> row_reader;
+    try {
+      orc::ReaderOptions reader_opts;
+      reader = orc::createReader(orc::readFile(filename_), reader_opts);
+      row_reader = reader->createRowReader(row_reader_opts_);
+    } catch (const std::exception& e) {
+      return errors::InvalidArgument("unable to open ORC file ", filename_,
+                                     ": ", e.what());
+    }
     LOG(INFO) << "ORC file schema:" << reader->getType().toString();
 
     // Parse columns. We assume the orc record file is a flat array
     auto row_count = reader->getNumberOfRows();
-    for (uint64_t i = 0; i < reader->getType().getSubtypeCount(); ++i) {
-      auto field_name = reader->getType().getFieldName(i);
-      auto subtype = reader->getType().getSubtype(i);
+    const orc::Type& type = row_reader->getSelectedType();
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+      auto field_name = type.getFieldName(i);
+      auto subtype = type.getSubtype(i);
       DataType dtype;
       switch (static_cast<int64_t>(subtype->getKind())) {
         case orc::SHORT:
@@ -81,60 +118,35 @@ class ORCReadable : public IOReadableInterface {
       shapes_.push_back(TensorShape({static_cast<int64>(row_count)}));
       dtypes_.push_back(dtype);
       columns_index_[field_name] = i;
-      tensors_.emplace_back(
-          Tensor(dtype, TensorShape({static_cast<int64>(row_count)})));
     }
-    // Fill in the values
-    std::unique_ptr<orc::ColumnVectorBatch> batch =
-        row_reader_->createRowBatch(10);
-    auto* fields = dynamic_cast<orc::StructVectorBatch*>(batch.get());
-    int64_t record_index = 0;
-// Template type conversions between ORC and TensorFlow DT
-#define PROCESS_TYPE(VTYPE, VDTYPE, TDTYPE)                                   \
-  {                                                                           \
-    auto* col = dynamic_cast<VTYPE>(fields->fields[column_index]);            \
-    VDTYPE* buffer1 = col->data.data();                                       \
-    tensors_[column_index].flat<TDTYPE>()(record_index) = (TDTYPE)buffer1[r]; \
-  }
-    while (row_reader_->next(*batch)) {
-      for (uint32_t r = 0; r < batch->numElements; ++r) {
-        for (size_t column_index = 0; column_index < columns_.size();
-             column_index++) {
-          switch (dtypes_[column_index]) {
-            case DT_DOUBLE:
-              PROCESS_TYPE(orc::DoubleVectorBatch*, double, double);
-              break;
-            case DT_FLOAT:
-              PROCESS_TYPE(orc::DoubleVectorBatch*, double, float);
-              break;
-            case DT_INT16:
-              PROCESS_TYPE(orc::LongVectorBatch*, int64, int16);
-              break;
-            case DT_INT32:
-              PROCESS_TYPE(orc::LongVectorBatch*, int64, int32);
-              break;
-            case DT_INT64:
-              PROCESS_TYPE(orc::LongVectorBatch*, int64, int64);
-              break;
-            case DT_STRING: {
-              auto* string_col = dynamic_cast<orc::StringVectorBatch*>(
-                  fields->fields[column_index]);
-              char** buffer = string_col->data.data();
-              int64_t* lengths = string_col->length.data();
-              tensors_[column_index].flat<tstring>()(record_index) =
-                  std::string(buffer[r], lengths[r]);
-              break;
-            }
-            default:
-              return errors::InvalidArgument(
-                  "data type is not supported: ",
-                  DataTypeString(dtypes_[column_index]));
-          }
-        }
-        record_index++;
+
+    if (!stream_) {
+      for (size_t i = 0; i < columns_.size(); i++) {
+        tensors_.emplace_back(
+            Tensor(dtypes_[i], TensorShape({static_cast<int64>(row_count)})));
+        masks_.emplace_back(
+            Tensor(DT_BOOL, TensorShape({static_cast<int64>(row_count)})));
+      }
+      try {
+        return DecodeRows(row_reader.get(), &tensors_, &masks_);
+      } catch (const std::exception& e) {
+        return errors::InvalidArgument("unable to read ORC file ", filename_,
+                                       ": ", e.what());
       }
     }
 
+    // In streaming mode the stripes are decoded when read, in parallel
+    // with the reads of the stripes before them.
+    stripe_offsets_.push_back(0);
+    for (uint64_t i = 0; i < reader->getNumberOfStripes(); i++) {
+      std::unique_ptr<orc::StripeInformation> stripe = reader->getStripe(i);
+      stripe_ranges_.emplace_back(stripe->getOffset(), stripe->getLength());
+      stripe_offsets_.push_back(stripe_offsets_.back() +
+                                stripe->getNumberOfRows());
+    }
+    num_parallel_reads_ = num_parallel_reads;
+    thread_pool_.reset(new thread::ThreadPool(
+        env_, "orc_stripe_reader", static_cast<int>(num_parallel_reads_)));
     return OkStatus();
   }
 
@@ -164,36 +176,29 @@ class ORCReadable : public IOReadableInterface {
       return OkStatus();
     }
 
-#define PROCESS_VALUE(VTYPE)                            \
-  {                                                     \
-    value->flat<VTYPE>().data()[i] =                    \
-        tensors_[column_index].flat<VTYPE>().data()[i]; \
-  }
-    for (int i = element_start; i < element_stop; i++) {
-      switch (dtypes_[column_index]) {
-        case DT_DOUBLE:
-          PROCESS_VALUE(double);
-          break;
-        case DT_FLOAT:
-          PROCESS_VALUE(float);
-          break;
-        case DT_INT16:
-          PROCESS_VALUE(int16);
-          break;
-        case DT_INT32:
-          PROCESS_VALUE(int32);
-          break;
-        case DT_INT64:
-          PROCESS_VALUE(int64);
-          break;
-        case DT_STRING: {
-          PROCESS_VALUE(tstring);
-          break;
-        }
-        default:
-          return errors::InvalidArgument("data type is not supported: ",
-                                         DataTypeString(dtypes_[column_index]));
-      }
+    if (!stream_) {
+      TF_RETURN_IF_ERROR(CopyRows(tensors_[column_index], masks_[column_index],
+                                  element_start, 0,
+                                  element_stop - element_start, value, label));
+      (*record_read) = element_stop - element_start;
+      return OkStatus();
+    }
+
+    // The first stripe that ends past `element_start`.
+    int64 index = std::upper_bound(stripe_offsets_.begin() + 1,
+                                   stripe_offsets_.end(), element_start) -
+                  (stripe_offsets_.begin() + 1);
+    for (; index < static_cast<int64>(stripe_ranges_.size()) &&
+           stripe_offsets_[index] < element_stop;
+         index++) {
+      std::shared_ptr<Stripe> stripe;
+      TF_RETURN_IF_ERROR(GetStripe(index, &stripe));
+      const int64 row_start = std::max(stripe_offsets_[index], element_start);
+      const int64 row_stop = std::min(stripe_offsets_[index + 1], element_stop);
+      TF_RETURN_IF_ERROR(CopyRows(
+          stripe->values[column_index], stripe->masks[column_index],
+          row_start - stripe_offsets_[index], row_start - element_start,
+          row_stop - row_start, value, label));
     }
     (*record_read) = element_stop - element_start;
 
@@ -215,7 +220,8 @@ class ORCReadable : public IOReadableInterface {
     }
     int64 column_index = columns_index_[component];
     *shape = shapes_[column_index];
-    *dtype = dtypes_[column_index];
+    // The label of a column is whether each row is not null.
+    *dtype = label ? DT_BOOL : dtypes_[column_index];
     return OkStatus();
   }
 
@@ -225,11 +231,192 @@ class ORCReadable : public IOReadableInterface {
   }
 
  private:
+  // The decoded columns of a stripe, shared by the reads of all columns.
+  struct Stripe {
+    mutex mu;
+    condition_variable cv;
+    bool done TF_GUARDED_BY(mu) = false;
+    Status status TF_GUARDED_BY(mu);
+    std::vector<Tensor> values;
+    std::vector<Tensor> masks;
+    // When the stripe was last read, to evict the least recently read,
+    // guarded by the mutex of the reader.
+    int64 used = 0;
+  };
+
+  // Copies `count` rows of a column from `src_offset` on to `dst_offset`.
+  Status CopyRows(const Tensor& values, const Tensor& masks,
+                  const int64 src_offset, const int64 dst_offset,
+                  const int64 count, Tensor* value, Tensor* label) {
+    if (value != nullptr) {
+      TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+          values, src_offset, dst_offset, count, value));
+    }
+    if (label != nullptr) {
+      TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+          masks, src_offset, dst_offset, count, label));
+    }
+    return OkStatus();
+  }
+
+  // Returns the stripe `index`, once decoded, and schedules the decodes of
+  // the stripes after it that are not decoded yet.
+  Status GetStripe(const int64 index, std::shared_ptr<Stripe>* stripe) {
+    {
+      mutex_lock l(mu_);
+      used_++;
+      const int64 stop = std::min<int64>(index + num_parallel_reads_,
+                                         stripe_ranges_.size());
+      for (int64 i = index; i < stop; i++) {
+        auto& entry = stripes_[i];
+        if (entry == nullptr) {
+          entry = std::make_shared<Stripe>();
+          std::shared_ptr<Stripe> scheduled = entry;
+          thread_pool_->Schedule([this, i, scheduled]() {
+            Status status = DecodeStripe(i, scheduled.get());
+            mutex_lock l(scheduled->mu);
+            scheduled->status = status;
+            scheduled->done = true;
+            scheduled->cv.notify_all();
+          });
+        }
+        entry->used = (i == index) ? used_ : std::max(entry->used, used_ - 1);
+      }
+      *stripe = stripes_[index];
+      // Keep twice the stripes being decoded, so that the reads of columns
+      // lagging behind the others still find theirs.
+      while (stripes_.size() > 2 * static_cast<size_t>(num_parallel_reads_)) {
+        auto lru = stripes_.begin();
+        for (auto it = stripes_.begin(); it != stripes_.end(); ++it) {
+          if (it->second->used < lru->second->used) {
+            lru = it;
+          }
+        }
+        stripes_.erase(lru);
+      }
+    }
+    mutex_lock l((*stripe)->mu);
+    while (!(*stripe)->done) {
+      (*stripe)->cv.wait(l);
+    }
+    return (*stripe)->status;
+  }
+
+  // Decodes stripe `index` with a reader of its own, so that stripes are
+  // decoded in parallel.
+  Status DecodeStripe(const int64 index, Stripe* stripe) {
+    const int64 row_count = stripe_offsets_[index + 1] - stripe_offsets_[index];
+    for (size_t i = 0; i < columns_.size(); i++) {
+      stripe->values.emplace_back(
+          Tensor(dtypes_[i], TensorShape({row_count})));
+      stripe->masks.emplace_back(Tensor(DT_BOOL, TensorShape({row_count})));
+    }
+    try {
+      orc::RowReaderOptions row_reader_opts = row_reader_opts_;
+      row_reader_opts.range(stripe_ranges_[index].first,
+                            stripe_ranges_[index].second);
+      orc::ReaderOptions reader_opts;
+      std::unique_ptr<orc::Reader> reader =
+          orc::createReader(orc::readFile(filename_), reader_opts);
+      std::unique_ptr<orc::RowReader> row_reader =
+          reader->createRowReader(row_reader_opts);
+      return DecodeRows(row_reader.get(), &stripe->values, &stripe->masks);
+    } catch (const std::exception& e) {
+      return errors::Internal("unable to read stripe ", index, " of ",
+                              filename_, ": ", e.what());
+    }
+  }
+
+  // Decodes the rows of `row_reader`, in batches of `batch_size_` rows, into
+  // the tensors of the selected columns and whether each row is not null.
+  Status DecodeRows(orc::RowReader* row_reader, std::vector<Tensor>* values,
+                    std::vector<Tensor>* masks) {
+    if (columns_.empty()) {
+      return OkStatus();
+    }
+    std::unique_ptr<orc::ColumnVectorBatch> batch =
+        row_reader->createRowBatch(batch_size_);
+    auto* fields = dynamic_cast<orc::StructVectorBatch*>(batch.get());
+    int64_t record_index = 0;
+// Template type conversions between ORC and TensorFlow DT
+#define PROCESS_TYPE(VTYPE, VDTYPE, TDTYPE)                        \
+  {                                                                \
+    auto* col = dynamic_cast<VTYPE>(fields->fields[column_index]); \
+    VDTYPE* buffer1 = col->data.data();                            \
+    (*values)[column_index].flat<TDTYPE>()(record_index) =         \
+        valid ? (TDTYPE)buffer1[r] : TDTYPE();                     \
+  }
+    while (row_reader->next(*batch)) {
+      if (record_index + static_cast<int64>(batch->numElements) >
+          (*values)[0].dim_size(0)) {
+        return errors::DataLoss("more rows than expected in ", filename_);
+      }
+      for (uint32_t r = 0; r < batch->numElements; ++r) {
+        for (size_t column_index = 0; column_index < columns_.size();
+             column_index++) {
+          // Null rows are left to the default value and masked out.
+          const orc::ColumnVectorBatch* field = fields->fields[column_index];
+          const bool valid = !field->hasNulls || field->notNull[r];
+          (*masks)[column_index].flat<bool>()(record_index) = valid;
+          switch (dtypes_[column_index]) {
+            case DT_DOUBLE:
+              PROCESS_TYPE(orc::DoubleVectorBatch*, double, double);
+              break;
+            case DT_FLOAT:
+              PROCESS_TYPE(orc::DoubleVectorBatch*, double, float);
+              break;
+            case DT_INT16:
+              PROCESS_TYPE(orc::LongVectorBatch*, int64, int16);
+              break;
+            case DT_INT32:
+              PROCESS_TYPE(orc::LongVectorBatch*, int64, int32);
+              break;
+            case DT_INT64:
+              PROCESS_TYPE(orc::LongVectorBatch*, int64, int64);
+              break;
+            case DT_STRING: {
+              auto* string_col = dynamic_cast<orc::StringVectorBatch*>(
+                  fields->fields[column_index]);
+              char** buffer = string_col->data.data();
+              int64_t* lengths = string_col->length.data();
+              (*values)[column_index].flat<tstring>()(record_index) =
+                  valid ? std::string(buffer[r], lengths[r]) : std::string();
+              break;
+            }
+            default:
+              return errors::InvalidArgument(
+                  "data type is not supported: ",
+                  DataTypeString(dtypes_[column_index]));
+          }
+        }
+        record_index++;
+      }
+    }
+#undef PROCESS_TYPE
+    return OkStatus();
+  }
+
+  static constexpr int64 kDefaultBatchSize = 1024;
+  static constexpr int64 kDefaultParallelReads = 4;
+
   mutable mutex mu_;
-  Env* env_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<orc::RowReader> row_reader_ TF_GUARDED_BY(mu_);
+  Env* env_;
+  string filename_;
+  orc::RowReaderOptions row_reader_opts_;
+  int64 batch_size_ = kDefaultBatchSize;
+  bool stream_ = false;
   std::vector<Tensor> tensors_;
+  std::vector<Tensor> masks_;
+
+  // The first row of each stripe, followed by the number of rows.
+  std::vector<int64> stripe_offsets_;
+  // The byte offset and length of each stripe.
+  std::vector<std::pair<uint64_t, uint64_t>> stripe_ranges_;
+  int64 num_parallel_reads_ = 0;
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+  std::unordered_map<int64, std::shared_ptr<Stripe>> stripes_
+      TF_GUARDED_BY(mu_);
+  int64 used_ TF_GUARDED_BY(mu_) = 0;
 
   std::vector<DataType> dtypes_;
   std::vector<TensorShape> shapes_;
@@ -242,5 +429,7 @@ REGISTER_KERNEL_BUILDER(Name("IO>ORCReadableSpec").Device(DEVICE_CPU),
                         IOInterfaceSpecOp<ORCReadable>);
 REGISTER_KERNEL_BUILDER(Name("IO>ORCReadableRead").Device(DEVICE_CPU),
                         IOReadableReadOp<ORCReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>ORCReadableReadMasked").Device(DEVICE_CPU),
+                        IOReadableReadOp<ORCReadable>);
 }  // namespace data
 }  // namespace tensorflow
\ No newline at end of file
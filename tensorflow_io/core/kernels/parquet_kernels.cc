@@ -13,9 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <list>
+#include <unordered_map>
+
 #include "parquet/api/reader.h"
 #include "parquet/windows_compatibility.h"
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/util/batch_util.h"
+#include "tensorflow_io/core/filesystems/io_trace.h"
 #include "tensorflow_io/core/kernels/arrow/arrow_kernels.h"
 #include "tensorflow_io/core/kernels/io_kernel.h"
 
@@ -23,6 +28,9 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// The outputs of a read of a column, see ParquetReadableResource::Read.
+enum ParquetReadMode { kValues, kMaskedValues, kDictionary };
+
 class ParquetReadableResource : public ResourceBase {
  public:
   ParquetReadableResource(Env* env) : env_(env) {}
@@ -41,12 +49,16 @@ class ParquetReadableResource : public ResourceBase {
     file_.reset(new SizedRandomAccessFile(env_, input, nullptr, 0));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
 
-    parquet_file_.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
-
     parquet_file_.reset(new ArrowRandomAccessFile(file_.get(), file_size_));
     parquet_reader_ = parquet::ParquetFileReader::Open(parquet_file_);
     parquet_metadata_ = parquet_reader_->metadata();
 
+    row_group_offsets_.assign(1, 0);
+    for (int i = 0; i < parquet_metadata_->num_row_groups(); i++) {
+      row_group_offsets_.push_back(row_group_offsets_.back() +
+                                   parquet_metadata_->RowGroup(i)->num_rows());
+    }
+
     shapes_.clear();
     dtypes_.clear();
     columns_.clear();
@@ -120,183 +132,422 @@ class ParquetReadableResource : public ResourceBase {
     return OkStatus();
   }
 
+  // Reads the rows [start, start + shape[0]) of a column out of its decoded
+  // column chunks, which are cached so that slicing a row group in windows
+  // decodes its pages once. Only the cache is locked, so that columns and
+  // row groups may be read concurrently.
+  //
+  // The outputs of `allocate_func` are, by `mode`:
+  //   kValues: the values, a null among them is an error.
+  //   kMaskedValues: the values, with nulls left to the default value, and
+  //     whether each row is not null.
+  //   kDictionary: for a string column, the int64 indices of the values in
+  //     the dictionary, -1 for nulls, the dictionary, and whether each row
+  //     is not null. The dictionary is the concatenation of those of the row
+  //     groups read, each decoded once.
   Status Read(const string& component,
               const absl::InlinedVector<int64, 4>& start,
-              const TensorShape& shape,
-              std::function<Status(const TensorShape& shape, Tensor** value)>
+              const TensorShape& shape, const ParquetReadMode mode,
+              std::function<Status(int64 index, const TensorShape& shape,
+                                   Tensor** value)>
                   allocate_func) {
-    mutex_lock l(mu_);
-
     if (columns_index_.find(component) == columns_index_.end()) {
       return errors::InvalidArgument("component ", component, " is invalid");
     }
-    const int64 column_index = columns_index_[component];
+    const int64 column_index = columns_index_.at(component);
+    if (mode == kDictionary && dtypes_[column_index] != DT_STRING) {
+      return errors::InvalidArgument("column ", component,
+                                     " is not a string column");
+    }
 
     Tensor* value;
-    TF_RETURN_IF_ERROR(allocate_func(shape, &value));
+    TF_RETURN_IF_ERROR(allocate_func(0, shape, &value));
+    io::IOTrace trace("parquet", io::IOTraceStage::kFill);
+    trace.AddBytes(value->TotalBytes());
+    trace.AddRecords(shape.dim_size(0));
+    Tensor* mask = nullptr;
+    if (mode != kValues) {
+      TF_RETURN_IF_ERROR(
+          allocate_func(mode == kDictionary ? 2 : 1, shape, &mask));
+      mask->flat<bool>().setConstant(true);
+    }
 
-    const string& column = component;
     int64 element_start = start[0];
     int64 element_stop = start[0] + shape.dim_size(0);
 
-    int64 row_group_offset = 0;
+    std::vector<Tensor> dictionaries;
+    int64 dictionary_size = 0;
     for (int row_group = 0; row_group < parquet_metadata_->num_row_groups();
          row_group++) {
-      std::shared_ptr<parquet::RowGroupReader> row_group_reader =
-          parquet_reader_->RowGroup(row_group);
+      const int64 row_group_offset = row_group_offsets_[row_group];
+      const int64 row_group_stop = row_group_offsets_[row_group + 1];
       // Skip if row group is not within [start..stop]
-      if ((row_group_offset + row_group_reader->metadata()->num_rows() <
-           element_start) ||
-          (element_stop <= row_group_offset)) {
-        row_group_offset += row_group_reader->metadata()->num_rows();
+      if (row_group_stop <= element_start || element_stop <= row_group_offset) {
         continue;
       }
       // Find row_to_read range
-      int64 row_to_read_start =
-          row_group_offset > element_start ? row_group_offset : element_start;
-      int64 row_to_read_final =
-          (row_group_offset + row_group_reader->metadata()->num_rows()) <
-                  (element_stop)
-              ? (row_group_offset + row_group_reader->metadata()->num_rows())
-              : (element_stop);
+      int64 row_to_read_start = std::max(row_group_offset, element_start);
+      int64 row_to_read_final = std::min(row_group_stop, element_stop);
       int64 row_to_read_count = row_to_read_final - row_to_read_start;
+      const int64 chunk_start = row_to_read_start - row_group_offset;
+      const int64 value_start = row_to_read_start - element_start;
+
+      std::shared_ptr<const ColumnChunk> chunk;
+      TF_RETURN_IF_ERROR(
+          GetColumnChunk(row_group, column_index, mode == kDictionary, &chunk));
+      if (chunk->mask.NumElements() > 0) {
+        if (mode == kValues) {
+          auto valid = chunk->mask.flat<bool>();
+          for (int64 i = 0; i < row_to_read_count; i++) {
+            if (!valid(chunk_start + i)) {
+              return errors::InvalidArgument("null value in column: ",
+                                             component);
+            }
+          }
+        } else {
+          TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+              chunk->mask, chunk_start, value_start, row_to_read_count, mask));
+        }
+      }
+      if (mode == kDictionary) {
+        auto indices = chunk->values.flat<int64>();
+        for (int64 i = 0; i < row_to_read_count; i++) {
+          const int64 index = indices(chunk_start + i);
+          value->flat<int64>()(value_start + i) =
+              index < 0 ? -1 : index + dictionary_size;
+        }
+        dictionary_size += chunk->dictionary.NumElements();
+        dictionaries.push_back(chunk->dictionary);
+        continue;
+      }
+      TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+          chunk->values, chunk_start, value_start, row_to_read_count, value));
+    }
+    if (mode == kDictionary) {
+      Tensor* dictionary;
+      TF_RETURN_IF_ERROR(
+          allocate_func(1, TensorShape({dictionary_size}), &dictionary));
+      int64 offset = 0;
+      for (const Tensor& chunk_dictionary : dictionaries) {
+        const int64 count = chunk_dictionary.NumElements();
+        if (count > 0) {
+          TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+              chunk_dictionary, 0, offset, count, dictionary));
+        }
+        offset += count;
+      }
+    }
+    return OkStatus();
+  }
+  string DebugString() const override { return "ParquetReadableResource"; }
 
-      // TODO: parquet is RowGroup based so ideally the RowGroup should be
-      // cached with the hope of indexing and slicing happens on each row. For
-      // now no caching is done yet.
-      std::shared_ptr<parquet::ColumnReader> column_reader =
-          row_group_reader->Column(column_index);
+ protected:
+  // The decoded rows of a column in a row group.
+  struct ColumnChunk {
+    // The values, with nulls left to the default value, or the indices of
+    // the values in `dictionary` and -1 for nulls.
+    Tensor values;
+    // Whether each row is not null, empty if there are no nulls.
+    Tensor mask;
+    Tensor dictionary;
+
+    size_t TotalBytes() const {
+      return values.TotalBytes() + mask.TotalBytes() + dictionary.TotalBytes();
+    }
+  };
+
+  // Returns the decoded rows of `column_index` in `row_group`, from the cache
+  // if they are in it. Chunks decoded concurrently are cached once.
+  Status GetColumnChunk(const int row_group, const int64 column_index,
+                        const bool dictionary,
+                        std::shared_ptr<const ColumnChunk>* chunk) {
+    const int64 key =
+        (row_group * parquet_metadata_->num_columns() + column_index) * 2 +
+        (dictionary ? 1 : 0);
+    {
+      mutex_lock l(cache_mu_);
+      auto it = cache_.find(key);
+      if (it != cache_.end()) {
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second.lru);
+        *chunk = it->second.chunk;
+        return OkStatus();
+      }
+    }
+    io::IOTrace trace("parquet", io::IOTraceStage::kDecode);
+    trace.AddRecords(parquet_metadata_->RowGroup(row_group)->num_rows());
+    std::shared_ptr<ColumnChunk> decoded(new ColumnChunk());
+    if (dictionary) {
+      TF_RETURN_IF_ERROR(
+          ReadDictionaryChunk(row_group, column_index, decoded.get()));
+    } else {
+      TF_RETURN_IF_ERROR(
+          ReadColumnChunk(row_group, column_index, decoded.get()));
+    }
+    *chunk = decoded;
 
-      // buffer to fill location is value.data()[row_to_read_start - start]
-      // Note: ReadBatch may not be able to read the elements requested
-      // (row_to_read_count) in one shot, as such we use while loop of
-      // `while (row_left > 0) {...}` to read until complete.
+    const size_t bytes = decoded->TotalBytes();
+    trace.AddBytes(bytes);
+    if (bytes > kCacheCapacity) {
+      return OkStatus();
+    }
+    mutex_lock l(cache_mu_);
+    if (cache_.find(key) != cache_.end()) {
+      return OkStatus();
+    }
+    while (cache_bytes_ + bytes > kCacheCapacity) {
+      auto it = cache_.find(cache_lru_.back());
+      cache_bytes_ -= it->second.chunk->TotalBytes();
+      cache_.erase(it);
+      cache_lru_.pop_back();
+    }
+    cache_lru_.push_front(key);
+    cache_.emplace(key, CachedChunk{*chunk, cache_lru_.begin()});
+    cache_bytes_ += bytes;
+    return OkStatus();
+  }
 
-#define PARQUET_PROCESS_TYPE(ptype, type)                                     \
-  {                                                                           \
-    parquet::TypedColumnReader<ptype>* reader =                               \
-        static_cast<parquet::TypedColumnReader<ptype>*>(column_reader.get()); \
-    if (row_to_read_start > row_group_offset) {                               \
-      reader->Skip(row_to_read_start - row_group_offset);                     \
-    }                                                                         \
-    ptype::c_type* value_p = (ptype::c_type*)(void*)(&(                       \
-        value->flat<type>().data()[row_to_read_start - element_start]));      \
-    int64_t row_left = row_to_read_count;                                     \
-    while (row_left > 0) {                                                    \
-      int64_t values_read;                                                    \
-      int64_t levels_read = reader->ReadBatch(                                \
-          row_left, nullptr, nullptr, &value_p[row_to_read_count - row_left], \
-          &values_read);                                                      \
-      if (!(levels_read == values_read && levels_read > 0)) {                 \
-        return errors::InvalidArgument("null value in column: ", column);     \
-      }                                                                       \
-      row_left -= levels_read;                                                \
-    }                                                                         \
+  // Reads the `num_rows` rows of a flat column, the values of the rows that
+  // are not null into `values` and, if the column is optional, their
+  // definition levels into `def_levels`. Sets the number of values read.
+  // Note: ReadBatch may not be able to read the elements requested in one
+  // shot, as such we use while loop to read until complete.
+  template <typename ParquetType>
+  Status ReadBatches(parquet::ColumnReader* column_reader, const int64 num_rows,
+                     const int16_t max_def_level,
+                     typename ParquetType::c_type* values, int16_t* def_levels,
+                     int64* values_count) {
+    parquet::TypedColumnReader<ParquetType>* reader =
+        static_cast<parquet::TypedColumnReader<ParquetType>*>(column_reader);
+    int64 rows_read = 0;
+    *values_count = 0;
+    while (rows_read < num_rows) {
+      int64_t values_read;
+      int64_t levels_read = reader->ReadBatch(
+          num_rows - rows_read,
+          max_def_level > 0 ? &def_levels[rows_read] : nullptr, nullptr,
+          &values[*values_count], &values_read);
+      if (levels_read <= 0) {
+        return errors::InvalidArgument("unable to read column: ",
+                                       column_reader->descr()->name());
+      }
+      rows_read += levels_read;
+      *values_count += values_read;
+    }
+    return OkStatus();
   }
 
-#define PARQUET_PROCESS_BYTE_ARRAY(ptype)                                     \
-  {                                                                           \
-    parquet::TypedColumnReader<ptype>* reader =                               \
-        static_cast<parquet::TypedColumnReader<ptype>*>(column_reader.get()); \
-    if (row_to_read_start > row_group_offset) {                               \
-      reader->Skip(row_to_read_start - row_group_offset);                     \
-    }                                                                         \
-    std::unique_ptr<ptype::c_type[]> value_p(                                 \
-        new ptype::c_type[row_to_read_count]);                                \
-    int64_t row_left = row_to_read_count;                                     \
-    while (row_left > 0) {                                                    \
-      int64_t values_read;                                                    \
-      int64_t levels_read = reader->ReadBatch(                                \
-          row_left, nullptr, nullptr,                                         \
-          &value_p.get()[row_to_read_count - row_left], &values_read);        \
-      if (!(levels_read == values_read && levels_read > 0)) {                 \
-        return errors::InvalidArgument("null value in column: ", column);     \
-      }                                                                       \
-      row_left -= levels_read;                                                \
-    }                                                                         \
-    for (int64_t index = 0; index < row_to_read_count; index++) {             \
-      value->flat<tstring>()(row_to_read_start - element_start + index) =     \
-          ByteArrayToString(value_p[index]);                                  \
-    }                                                                         \
+  // Decodes all the rows of `column_index` in `row_group` into `chunk`, the
+  // values being converted to the element type with `convert`.
+  template <typename ParquetType, typename T, typename Convert>
+  Status ReadTypedChunk(parquet::ColumnReader* column_reader,
+                        const int64 num_rows, Convert convert,
+                        ColumnChunk* chunk) {
+    const int16_t max_def_level =
+        column_reader->descr()->max_definition_level();
+    std::unique_ptr<typename ParquetType::c_type[]> values(
+        new typename ParquetType::c_type[num_rows]);
+    std::unique_ptr<int16_t[]> def_levels(
+        new int16_t[max_def_level > 0 ? num_rows : 0]);
+    int64 values_count;
+    TF_RETURN_IF_ERROR(ReadBatches<ParquetType>(
+        column_reader, num_rows, max_def_level, values.get(), def_levels.get(),
+        &values_count));
+    auto flat = chunk->values.flat<T>();
+    if (values_count == num_rows) {
+      for (int64 i = 0; i < num_rows; i++) {
+        flat(i) = convert(values[i]);
+      }
+      return OkStatus();
+    }
+    chunk->mask = Tensor(DT_BOOL, TensorShape({num_rows}));
+    auto valid = chunk->mask.flat<bool>();
+    for (int64 i = 0, v = 0; i < num_rows; i++) {
+      valid(i) = (def_levels[i] == max_def_level);
+      flat(i) = valid(i) ? convert(values[v++]) : T();
+    }
+    return OkStatus();
   }
 
-#define PARQUET_PROCESS_FIXED_LEN_BYTE_ARRAY(ptype, len)                      \
-  {                                                                           \
-    parquet::TypedColumnReader<ptype>* reader =                               \
-        static_cast<parquet::TypedColumnReader<ptype>*>(column_reader.get()); \
-    if (row_to_read_start > row_group_offset) {                               \
-      reader->Skip(row_to_read_start - row_group_offset);                     \
-    }                                                                         \
-    std::unique_ptr<ptype::c_type[]> value_p(                                 \
-        new ptype::c_type[row_to_read_count]);                                \
-    int64_t row_left = row_to_read_count;                                     \
-    while (row_left > 0) {                                                    \
-      int64_t values_read;                                                    \
-      int64_t levels_read = reader->ReadBatch(                                \
-          row_left, nullptr, nullptr,                                         \
-          &value_p.get()[row_to_read_count - row_left], &values_read);        \
-      if (!(levels_read == values_read && levels_read > 0)) {                 \
-        return errors::InvalidArgument("null value in column: ", column);     \
-      }                                                                       \
-      row_left -= levels_read;                                                \
-    }                                                                         \
-    for (int64_t index = 0; index < row_to_read_count; index++) {             \
-      value->flat<tstring>()(row_to_read_start - element_start + index) =     \
-          string((const char*)value_p[index].ptr, len);                       \
-    }                                                                         \
+  // Decodes all the rows of `column_index` in `row_group` into `chunk`.
+  Status ReadColumnChunk(const int row_group, const int64 column_index,
+                         ColumnChunk* chunk) {
+    const int64 num_rows =
+        row_group_offsets_[row_group + 1] - row_group_offsets_[row_group];
+    chunk->values = Tensor(dtypes_[column_index], TensorShape({num_rows}));
+
+    std::shared_ptr<parquet::RowGroupReader> row_group_reader =
+        parquet_reader_->RowGroup(row_group);
+    std::shared_ptr<parquet::ColumnReader> column_reader =
+        row_group_reader->Column(column_index);
+
+#define PARQUET_PROCESS_TYPE(ptype, type)                                     \
+  return ReadTypedChunk<ptype, type>(                                         \
+      column_reader.get(), num_rows,                                          \
+      [](const ptype::c_type& value) { return static_cast<type>(value); },   \
+      chunk);
+
+    const parquet::ColumnDescriptor* descr =
+        parquet_metadata_->schema()->Column(column_index);
+    switch (descr->physical_type()) {
+      case parquet::Type::BOOLEAN:
+        PARQUET_PROCESS_TYPE(parquet::BooleanType, bool);
+      case parquet::Type::INT32:
+        PARQUET_PROCESS_TYPE(parquet::Int32Type, int32);
+      case parquet::Type::INT64:
+        PARQUET_PROCESS_TYPE(parquet::Int64Type, int64);
+      case parquet::Type::FLOAT:
+        PARQUET_PROCESS_TYPE(parquet::FloatType, float);
+      case parquet::Type::DOUBLE:
+        PARQUET_PROCESS_TYPE(parquet::DoubleType, double);
+      case parquet::Type::BYTE_ARRAY:
+        return ReadTypedChunk<parquet::ByteArrayType, tstring>(
+            column_reader.get(), num_rows,
+            [](const parquet::ByteArray& value) {
+              return tstring(ByteArrayToString(value));
+            },
+            chunk);
+      case parquet::Type::FIXED_LEN_BYTE_ARRAY: {
+        const int len = descr->type_length();
+        return ReadTypedChunk<parquet::FLBAType, tstring>(
+            column_reader.get(), num_rows,
+            [len](const parquet::FixedLenByteArray& value) {
+              return tstring((const char*)value.ptr, len);
+            },
+            chunk);
+      }
+      default:
+        return errors::InvalidArgument("invalid data type: ",
+                                       descr->physical_type());
+    }
+#undef PARQUET_PROCESS_TYPE
   }
 
-      switch (
-          parquet_metadata_->schema()->Column(column_index)->physical_type()) {
-        case parquet::Type::BOOLEAN:
-          PARQUET_PROCESS_TYPE(parquet::BooleanType, bool);
-          break;
-        case parquet::Type::INT32:
-          PARQUET_PROCESS_TYPE(parquet::Int32Type, int32);
-          break;
-        case parquet::Type::INT64:
-          PARQUET_PROCESS_TYPE(parquet::Int64Type, int64);
-          break;
-        case parquet::Type::FLOAT:
-          PARQUET_PROCESS_TYPE(parquet::FloatType, float);
-          break;
-        case parquet::Type::DOUBLE:
-          PARQUET_PROCESS_TYPE(parquet::DoubleType, double);
-          break;
-        case parquet::Type::BYTE_ARRAY:
-          PARQUET_PROCESS_BYTE_ARRAY(parquet::ByteArrayType);
-          break;
-        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
-          PARQUET_PROCESS_FIXED_LEN_BYTE_ARRAY(
-              parquet::FLBAType,
-              parquet_metadata_->schema()->Column(column_index)->type_length());
-          break;
-        default:
-          return errors::InvalidArgument("invalid data type: ",
-                                         parquet_metadata_->schema()
-                                             ->Column(column_index)
-                                             ->physical_type());
+  // Decodes all the rows of the string column `column_index` in `row_group`
+  // into dictionary indices and the dictionary of `chunk`. The dictionary
+  // pages are used as they are if all the data pages are dictionary encoded,
+  // otherwise the dictionary is made of the distinct values.
+  Status ReadDictionaryChunk(const int row_group, const int64 column_index,
+                             ColumnChunk* chunk) {
+    const int64 num_rows =
+        row_group_offsets_[row_group + 1] - row_group_offsets_[row_group];
+    const parquet::ColumnDescriptor* descr =
+        parquet_metadata_->schema()->Column(column_index);
+    if (descr->physical_type() != parquet::Type::BYTE_ARRAY) {
+      return errors::InvalidArgument("column ", columns_[column_index],
+                                     " is not a BYTE_ARRAY column");
+    }
+    const int16_t max_def_level = descr->max_definition_level();
+    std::unique_ptr<int16_t[]> def_levels(
+        new int16_t[max_def_level > 0 ? num_rows : 0]);
+    std::vector<int32_t> indices(num_rows);
+    int64 values_count = 0;
+
+    std::shared_ptr<parquet::RowGroupReader> row_group_reader =
+        parquet_reader_->RowGroup(row_group);
+    std::shared_ptr<parquet::ColumnReader> column_reader =
+        row_group_reader->ColumnWithExposeEncoding(
+            column_index, parquet::ExposedEncoding::DICTIONARY);
+    if (column_reader->GetExposedEncoding() ==
+        parquet::ExposedEncoding::DICTIONARY) {
+      parquet::ByteArrayReader* reader =
+          static_cast<parquet::ByteArrayReader*>(column_reader.get());
+      const parquet::ByteArray* dict = nullptr;
+      int32_t dict_len = 0;
+      int64 rows_read = 0;
+      while (rows_read < num_rows) {
+        const parquet::ByteArray* batch_dict = nullptr;
+        int32_t batch_dict_len = 0;
+        int64_t indices_read;
+        int64_t levels_read = reader->ReadBatchWithDictionary(
+            num_rows - rows_read,
+            max_def_level > 0 ? &def_levels[rows_read] : nullptr, nullptr,
+            &indices[values_count], &indices_read, &batch_dict,
+            &batch_dict_len);
+        if (levels_read <= 0) {
+          return errors::InvalidArgument("unable to read column: ",
+                                         columns_[column_index]);
+        }
+        if (batch_dict != nullptr) {
+          dict = batch_dict;
+          dict_len = batch_dict_len;
+        }
+        rows_read += levels_read;
+        values_count += indices_read;
+      }
+      chunk->dictionary = Tensor(DT_STRING, TensorShape({dict_len}));
+      for (int32_t i = 0; i < dict_len; i++) {
+        chunk->dictionary.flat<tstring>()(i) = ByteArrayToString(dict[i]);
+      }
+    } else {
+      std::unique_ptr<parquet::ByteArray[]> values(
+          new parquet::ByteArray[num_rows]);
+      TF_RETURN_IF_ERROR(ReadBatches<parquet::ByteArrayType>(
+          column_reader.get(), num_rows, max_def_level, values.get(),
+          def_levels.get(), &values_count));
+      std::unordered_map<absl::string_view, int32_t> distinct;
+      std::vector<absl::string_view> dict;
+      for (int64 i = 0; i < values_count; i++) {
+        absl::string_view value(reinterpret_cast<const char*>(values[i].ptr),
+                                values[i].len);
+        auto it = distinct.emplace(value, dict.size()).first;
+        if (static_cast<size_t>(it->second) == dict.size()) {
+          dict.push_back(value);
+        }
+        indices[i] = it->second;
+      }
+      chunk->dictionary =
+          Tensor(DT_STRING, TensorShape({static_cast<int64>(dict.size())}));
+      for (size_t i = 0; i < dict.size(); i++) {
+        chunk->dictionary.flat<tstring>()(i) = string(dict[i]);
       }
-      row_group_offset += row_group_reader->metadata()->num_rows();
+    }
+
+    chunk->values = Tensor(DT_INT64, TensorShape({num_rows}));
+    auto flat = chunk->values.flat<int64>();
+    if (values_count == num_rows) {
+      for (int64 i = 0; i < num_rows; i++) {
+        flat(i) = indices[i];
+      }
+      return OkStatus();
+    }
+    chunk->mask = Tensor(DT_BOOL, TensorShape({num_rows}));
+    auto valid = chunk->mask.flat<bool>();
+    for (int64 i = 0, v = 0; i < num_rows; i++) {
+      valid(i) = (def_levels[i] == max_def_level);
+      flat(i) = valid(i) ? indices[v++] : -1;
     }
     return OkStatus();
   }
-  string DebugString() const override { return "ParquetReadableResource"; }
 
- protected:
+  struct CachedChunk {
+    std::shared_ptr<const ColumnChunk> chunk;
+    std::list<int64>::iterator lru;
+  };
+
+  // The bytes of decoded column chunks that are cached.
+  static constexpr size_t kCacheCapacity = 256 << 20;
+
+  // Everything but the cache is only written by Init.
   mutex mu_;
-  Env* env_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
-  uint64 file_size_ TF_GUARDED_BY(mu_);
-  std::shared_ptr<ArrowRandomAccessFile> parquet_file_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<::parquet::ParquetFileReader> parquet_reader_
-      TF_GUARDED_BY(mu_);
-  std::shared_ptr<::parquet::FileMetaData> parquet_metadata_ TF_GUARDED_BY(mu_);
-
-  std::vector<DataType> dtypes_ TF_GUARDED_BY(mu_);
-  std::vector<TensorShape> shapes_ TF_GUARDED_BY(mu_);
-  std::vector<string> columns_ TF_GUARDED_BY(mu_);
-  std::unordered_map<string, int64> columns_index_ TF_GUARDED_BY(mu_);
+  Env* env_;
+  std::unique_ptr<SizedRandomAccessFile> file_;
+  uint64 file_size_;
+  std::shared_ptr<ArrowRandomAccessFile> parquet_file_;
+  std::unique_ptr<::parquet::ParquetFileReader> parquet_reader_;
+  std::shared_ptr<::parquet::FileMetaData> parquet_metadata_;
+  // The first row of each row group, followed by the number of rows.
+  std::vector<int64> row_group_offsets_;
+
+  std::vector<DataType> dtypes_;
+  std::vector<TensorShape> shapes_;
+  std::vector<string> columns_;
+  std::unordered_map<string, int64> columns_index_;
+
+  mutex cache_mu_;
+  std::unordered_map<int64, CachedChunk> cache_ TF_GUARDED_BY(cache_mu_);
+  // The keys of the cached chunks, the most recently used first.
+  std::list<int64> cache_lru_ TF_GUARDED_BY(cache_mu_);
+  size_t cache_bytes_ TF_GUARDED_BY(cache_mu_) = 0;
 };
 
 class ParquetReadableInfoOp
@@ -353,6 +604,8 @@ class ParquetReadableInfoOp
   }
 };
 
+// Reads a column, in the outputs of `Mode`, see ParquetReadableResource::Read.
+template <ParquetReadMode Mode>
 class ParquetReadableReadOp
     : public IOResourceOpKernel<ParquetReadableResource> {
  public:
@@ -403,9 +656,10 @@ class ParquetReadableReadOp
       shape.set_dim(i, stop[i] - start[i]);
     }
     TF_RETURN_IF_ERROR(resource->Read(
-        component, start, shape,
-        [&](const TensorShape& shape, Tensor** value) -> Status {
-          TF_RETURN_IF_ERROR(context->allocate_output(0, shape, value));
+        component, start, shape, Mode,
+        [&](const int64 index, const TensorShape& shape,
+            Tensor** value) -> Status {
+          TF_RETURN_IF_ERROR(context->allocate_output(index, shape, value));
           return OkStatus();
         }));
     return OkStatus();
@@ -415,7 +669,13 @@ class ParquetReadableReadOp
 REGISTER_KERNEL_BUILDER(Name("IO>ParquetReadableInfo").Device(DEVICE_CPU),
                         ParquetReadableInfoOp);
 REGISTER_KERNEL_BUILDER(Name("IO>ParquetReadableRead").Device(DEVICE_CPU),
-                        ParquetReadableReadOp);
+                        ParquetReadableReadOp<kValues>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>ParquetReadableReadMasked").Device(DEVICE_CPU),
+    ParquetReadableReadOp<kMaskedValues>);
+REGISTER_KERNEL_BUILDER(
+    Name("IO>ParquetReadableReadDictionary").Device(DEVICE_CPU),
+    ParquetReadableReadOp<kDictionary>);
 
 }  // namespace
 }  // namespace data
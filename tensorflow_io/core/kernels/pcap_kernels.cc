@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <functional>
+
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
@@ -66,6 +68,19 @@ class PcapInputStream : public io::BufferedInputStream {
     return OkStatus();
   }
 
+  // Moves past the next record without copying its packet data.
+  Status SkipRecord(int64& record_read) {
+    tstring buffer;
+    TF_RETURN_IF_ERROR(ReadNBytes(sizeof(struct PacketHeader), &buffer));
+    struct PacketHeader* header = (struct PacketHeader*)buffer.data();
+    if (reverse_header_byte_order) {
+      EndianSwap(header->caplen);
+    }
+    TF_RETURN_IF_ERROR(SkipNBytes(header->caplen));
+    record_read = 1;
+    return OkStatus();
+  }
+
   Status ReadHeader() {
     tstring buffer;
     // read file header
@@ -195,8 +210,10 @@ class PcapReadable : public IOReadableInterface {
     stream_.reset(new PcapInputStream(file_.get()));
     TF_RETURN_IF_ERROR(stream_->ReadHeader());
 
+    index_.clear();
+    index_.push_back(stream_->Tell());
     record_index_ = 0;
-    record_final_ = false;
+    record_count_ = -1;
     return OkStatus();
   }
   Status Spec(const string& component, PartialTensorShape* shape,
@@ -208,38 +225,66 @@ class PcapReadable : public IOReadableInterface {
 
   Status Read(const int64 start, const int64 stop, const string& component,
               int64* record_read, Tensor* value, Tensor* label) override {
+    mutex_lock l(mu_);
     (*record_read) = 0;
-    if (record_final_) {
-      return OkStatus();
-    }
-    if (start != record_index_) {
-      return errors::InvalidArgument(
-          "random access of pcap file is not supported: ");
-    }
-    int64 record_to_read = stop - start;
+    TF_RETURN_IF_ERROR(Seek(start));
     // read packets from the file up to record_to_read or end of file
+    int64 record_to_read = stop - start;
     while ((*record_read) < record_to_read) {
-      int64 record_count = 0;
       double packet_timestamp;
       tstring packet_data_buffer;
-      Status status = stream_->ReadRecord(packet_timestamp, &packet_data_buffer,
-                                          record_count);
-      if (!(status.ok() || errors::IsOutOfRange(status))) {
-        return status;
+      bool eof = false;
+      TF_RETURN_IF_ERROR(Next(&packet_timestamp, &packet_data_buffer, &eof));
+      if (eof) {
+        break;
+      }
+      if (value != nullptr) {
+        value->flat<tstring>()(*record_read) = std::move(packet_data_buffer);
       }
-      if (record_count > 0) {
-        value->flat<tstring>()(*record_read) = packet_data_buffer;
+      if (label != nullptr) {
         label->flat<double>()(*record_read) = packet_timestamp;
-        (*record_read) += record_count;
-      } else {
-        // no more records available to read
-        // record_count == 0
-        record_final_ = true;
-        break;
       }
+      (*record_read)++;
     }
-    record_index_ += (*record_read);
+    return OkStatus();
+  }
 
+  // Reads the packets [start, stop) as their timestamps, and their data
+  // concatenated with the offsets of each packet in `row_splits`.
+  Status ReadRagged(
+      const int64 start, const int64 stop,
+      std::function<Status(const int64 records, const int64 bytes,
+                           Tensor** label, Tensor** row_splits,
+                           Tensor** value)>
+          allocate_func) {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(Seek(start));
+    std::vector<double> timestamps;
+    std::vector<int64> splits = {0};
+    string data;
+    tstring packet;
+    while (static_cast<int64>(timestamps.size()) < stop - start) {
+      double timestamp;
+      bool eof = false;
+      TF_RETURN_IF_ERROR(Next(&timestamp, &packet, &eof));
+      if (eof) {
+        break;
+      }
+      timestamps.push_back(timestamp);
+      data.append(packet.data(), packet.size());
+      splits.push_back(data.size());
+    }
+    Tensor* label;
+    Tensor* row_splits;
+    Tensor* value;
+    TF_RETURN_IF_ERROR(allocate_func(timestamps.size(), data.size(), &label,
+                                     &row_splits, &value));
+    std::copy(timestamps.begin(), timestamps.end(),
+              label->flat<double>().data());
+    std::copy(splits.begin(), splits.end(), row_splits->flat<int64>().data());
+    if (!data.empty()) {
+      memcpy(value->flat<uint8>().data(), data.data(), data.size());
+    }
     return OkStatus();
   }
 
@@ -249,21 +294,120 @@ class PcapReadable : public IOReadableInterface {
   }
 
  private:
+  // Moves the stream to the packet `index`, or to the end of the file when
+  // there are fewer packets, starting from the nearest indexed packet before
+  // it unless the stream is already between the two.
+  Status Seek(const int64 index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (index == record_index_) {
+      return OkStatus();
+    }
+    const int64 entry = std::min<int64>(index / kIndexInterval,
+                                        static_cast<int64>(index_.size()) - 1);
+    if (record_index_ > index || record_index_ < entry * kIndexInterval) {
+      TF_RETURN_IF_ERROR(stream_->Seek(index_[entry]));
+      record_index_ = entry * kIndexInterval;
+    }
+    while (record_index_ < index) {
+      bool eof = false;
+      TF_RETURN_IF_ERROR(Next(nullptr, nullptr, &eof));
+      if (eof) {
+        break;
+      }
+    }
+    return OkStatus();
+  }
+
+  // Reads the next packet, or only moves past it without `packet_data`,
+  // recording the offset of every kIndexInterval-th packet on the way.
+  Status Next(double* timestamp, tstring* packet_data, bool* eof)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    *eof = (record_count_ >= 0 && record_index_ >= record_count_);
+    if (*eof) {
+      return OkStatus();
+    }
+    if (record_index_ % kIndexInterval == 0 &&
+        record_index_ / kIndexInterval == static_cast<int64>(index_.size())) {
+      index_.push_back(stream_->Tell());
+    }
+    int64 record_count = 0;
+    Status status =
+        packet_data == nullptr
+            ? stream_->SkipRecord(record_count)
+            : stream_->ReadRecord(*timestamp, packet_data, record_count);
+    if (!(status.ok() || errors::IsOutOfRange(status))) {
+      return status;
+    }
+    if (record_count == 0) {
+      // no more records available to read
+      record_count_ = record_index_;
+      *eof = true;
+      return OkStatus();
+    }
+    record_index_ += record_count;
+    return OkStatus();
+  }
+
+  // The packets between two entries of the index.
+  static constexpr int64 kIndexInterval = 1024;
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
   uint64 file_size_ TF_GUARDED_BY(mu_);
 
+  // The packet the stream is at, and the number of packets once the end of
+  // the file has been reached, or -1.
   int64 record_index_ TF_GUARDED_BY(mu_);
-  bool record_final_ TF_GUARDED_BY(mu_);
+  int64 record_count_ TF_GUARDED_BY(mu_);
+  // The offsets of the packets 0, kIndexInterval, 2 * kIndexInterval, ...
+  // of those read or skipped so far.
+  std::vector<int64> index_ TF_GUARDED_BY(mu_);
 
   std::unique_ptr<PcapInputStream> stream_ TF_GUARDED_BY(mu_);
 };
 
+class PcapReadableReadRaggedOp : public OpKernel {
+ public:
+  explicit PcapReadableReadRaggedOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    PcapReadable* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    const int64 start = start_tensor->scalar<int64>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    const int64 stop = stop_tensor->scalar<int64>()();
+
+    OP_REQUIRES_OK(
+        context,
+        resource->ReadRagged(
+            start, stop,
+            [&](const int64 records, const int64 bytes, Tensor** label,
+                Tensor** row_splits, Tensor** value) -> Status {
+              TF_RETURN_IF_ERROR(
+                  context->allocate_output(0, TensorShape({records}), label));
+              TF_RETURN_IF_ERROR(context->allocate_output(
+                  1, TensorShape({records + 1}), row_splits));
+              TF_RETURN_IF_ERROR(
+                  context->allocate_output(2, TensorShape({bytes}), value));
+              return OkStatus();
+            }));
+  }
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>PcapReadableInit").Device(DEVICE_CPU),
                         IOInterfaceInitOp<PcapReadable>);
 REGISTER_KERNEL_BUILDER(Name("IO>PcapReadableRead").Device(DEVICE_CPU),
                         IOReadableReadOp<PcapReadable>);
+REGISTER_KERNEL_BUILDER(Name("IO>PcapReadableReadRagged").Device(DEVICE_CPU),
+                        PcapReadableReadRaggedOp);
 
 }  // namespace data
 }  // namespace tensorflow
@@ -139,13 +139,21 @@ class PrometheusReadableResource : public ResourceBase {
     *stop = stop_;
     return OkStatus();
   }
+  // Reads the points of the series each second of [start, stop) with one
+  // query for all of them, NaN where a series has no point. The lock is not
+  // held while querying so that windows can be read concurrently.
   Status Read(const int64 start, const int64 stop, std::vector<string>& jobs,
               std::vector<string>& instances, std::vector<string>& names,
               std::function<Status(const TensorShape& timestamp_shape,
                                    const TensorShape& value_shape,
                                    Tensor** timestamp, Tensor** value)>
                   allocate_func) {
-    mutex_lock l(mu_);
+    string endpoint, query;
+    {
+      mutex_lock l(mu_);
+      endpoint = endpoint_;
+      query = query_;
+    }
     int64 interval = (stop - start) / 1000;
 
     if (jobs.size() != instances.size() || jobs.size() != names.size()) {
@@ -161,29 +169,33 @@ class PrometheusReadableResource : public ResourceBase {
                       TensorShape({static_cast<int64>(names.size()), interval}),
                       &timestamp, &value));
 
-    GoString endpoint_go = {endpoint_.c_str(),
-                            static_cast<int64>(endpoint_.size())};
-    GoString query_go = {query_.c_str(), static_cast<int64>(query_.size())};
+    GoString endpoint_go = {endpoint.c_str(),
+                            static_cast<int64>(endpoint.size())};
+    GoString query_go = {query.c_str(), static_cast<int64>(query.size())};
 
+    std::vector<GoString> jobs_v, instances_v, names_v;
     for (size_t index = 0; index < jobs.size(); index++) {
-      GoString job_go = {jobs[index].data(),
-                         static_cast<ptrdiff_t>(jobs[index].size())};
-      GoString instance_go = {instances[index].data(),
-                              static_cast<ptrdiff_t>(instances[index].size())};
-      GoString name_go = {names[index].data(),
-                          static_cast<ptrdiff_t>(names[index].size())};
-      GoSlice timestamp_go = {timestamp->flat<int64>().data(),
-                              timestamp->NumElements(),
-                              timestamp->NumElements()};
-      double* value_p = (double*)(value->flat<double>().data()) +
-                        index * timestamp->NumElements();
-      GoSlice value_go = {value_p, timestamp->NumElements(),
-                          timestamp->NumElements()};
-      GoInt returned = QueryRange(endpoint_go, query_go, start, stop, job_go,
-                                  instance_go, name_go, timestamp_go, value_go);
-      if (returned < 0) {
-        return errors::InvalidArgument("unable to query prometheus");
-      }
+      jobs_v.push_back(GoString{jobs[index].data(),
+                                static_cast<ptrdiff_t>(jobs[index].size())});
+      instances_v.push_back(
+          GoString{instances[index].data(),
+                   static_cast<ptrdiff_t>(instances[index].size())});
+      names_v.push_back(GoString{names[index].data(),
+                                 static_cast<ptrdiff_t>(names[index].size())});
+    }
+    const GoInt count = jobs.size();
+    GoSlice jobs_go = {jobs_v.data(), count, count};
+    GoSlice instances_go = {instances_v.data(), count, count};
+    GoSlice names_go = {names_v.data(), count, count};
+    GoSlice timestamp_go = {timestamp->flat<int64>().data(),
+                            timestamp->NumElements(), timestamp->NumElements()};
+    GoSlice value_go = {value->flat<double>().data(), value->NumElements(),
+                        value->NumElements()};
+    GoInt returned = QueryRangeSeries(endpoint_go, query_go, start, jobs_go,
+                                      instances_go, names_go, timestamp_go,
+                                      value_go);
+    if (returned < 0) {
+      return errors::InvalidArgument("unable to query prometheus");
     }
 
     return OkStatus();
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <deque>
+#include <iterator>
+
 #include <grpc++/grpc++.h>
 // Inclusion of googleapi related grpc headers, e.g., pubsub.grpc.pb.h
 // will cause Windows build failures due to the conflict of `OPTIONAL`
@@ -33,13 +36,144 @@ namespace {
 using google::pubsub::v1::AcknowledgeRequest;
 using google::pubsub::v1::PullRequest;
 using google::pubsub::v1::PullResponse;
+using google::pubsub::v1::ReceivedMessage;
+using google::pubsub::v1::StreamingPullRequest;
+using google::pubsub::v1::StreamingPullResponse;
 using google::pubsub::v1::Subscriber;
 using grpc::ClientContext;
 
+// The most messages a Pull returns, and the most ack ids sent per Acknowledge.
+static const int64 kMaxMessagesPerPull = 1000;
+
+// Receives the messages of a subscription through a StreamingPull stream on a
+// background thread. The server stops delivering messages once
+// `max_outstanding_messages` or `max_outstanding_bytes` are delivered but not
+// acknowledged, which bounds the messages queued here. The stream is reopened
+// when it is closed by the server.
+class PubSubStreamingPull {
+ public:
+  PubSubStreamingPull(Env* env, Subscriber::Stub* stub,
+                      const string& subscription,
+                      const int64 max_outstanding_messages,
+                      const int64 max_outstanding_bytes)
+      : env_(env),
+        stub_(stub),
+        subscription_(subscription),
+        max_outstanding_messages_(max_outstanding_messages),
+        max_outstanding_bytes_(max_outstanding_bytes) {
+    thread_.reset(env->StartThread(ThreadOptions(), "pubsub_streaming_pull",
+                                   [this] { Run(); }));
+  }
+  ~PubSubStreamingPull() {
+    {
+      mutex_lock l(mu_);
+      stop_ = true;
+      if (context_ != nullptr) context_->TryCancel();
+    }
+    // Joins the receive thread.
+    thread_.reset();
+  }
+
+  // Moves up to `max_messages` received messages to `messages`, waiting up to
+  // `timeout` milliseconds for the first one, or indefinitely if `timeout` is
+  // not positive.
+  Status Pop(const int64 timeout, const size_t max_messages,
+             std::vector<ReceivedMessage>* messages) {
+    mutex_lock l(mu_);
+    const uint64 deadline = env_->NowMicros() + timeout * 1000;
+    while (messages_.empty() && status_.ok()) {
+      if (timeout <= 0) {
+        received_.wait(l);
+      } else {
+        const uint64 now = env_->NowMicros();
+        if (now >= deadline) break;
+        received_.wait_for(l, std::chrono::microseconds(deadline - now));
+      }
+    }
+    if (messages_.empty()) return status_;
+    size_t count = std::min(max_messages, messages_.size());
+    std::move(messages_.begin(), messages_.begin() + count,
+              std::back_inserter(*messages));
+    messages_.erase(messages_.begin(), messages_.begin() + count);
+    return OkStatus();
+  }
+
+ private:
+  void Run() {
+    for (int64 attempt = 0;; attempt++) {
+      if (attempt > 0) env_->SleepForMicroseconds(kReopenInterval);
+      std::unique_ptr<ClientContext> context(new ClientContext());
+      {
+        mutex_lock l(mu_);
+        if (stop_) return;
+        context_ = context.get();
+      }
+      auto stream = stub_->StreamingPull(context.get());
+      StreamingPullRequest request;
+      request.set_subscription(subscription_);
+      request.set_stream_ack_deadline_seconds(kStreamAckDeadlineSeconds);
+      request.set_max_outstanding_messages(max_outstanding_messages_);
+      request.set_max_outstanding_bytes(max_outstanding_bytes_);
+      StreamingPullResponse response;
+      if (stream->Write(request)) {
+        while (stream->Read(&response)) {
+          mutex_lock l(mu_);
+          for (auto& message : *response.mutable_received_messages()) {
+            messages_.push_back(std::move(message));
+          }
+          received_.notify_all();
+        }
+      }
+      grpc::Status status = stream->Finish();
+      mutex_lock l(mu_);
+      context_ = nullptr;
+      if (stop_) return;
+      if (status.error_code() != grpc::StatusCode::UNAVAILABLE &&
+          status.error_code() != grpc::StatusCode::DEADLINE_EXCEEDED &&
+          status.error_code() != grpc::StatusCode::OK) {
+        status_ = errors::Internal("Failed to receive message: ",
+                                   status.error_message());
+        received_.notify_all();
+        return;
+      }
+      LOG(INFO) << "Reopening the streaming pull of " << subscription_
+                << " after: " << status.error_message();
+    }
+  }
+
+  // Messages are acknowledged once the following batch is read, within the
+  // deadline in seconds.
+  static const int kStreamAckDeadlineSeconds = 60;
+  // The time in microseconds before a closed stream is reopened.
+  static const int64 kReopenInterval = 1000000;
+
+  Env* const env_;
+  Subscriber::Stub* const stub_;
+  const string subscription_;
+  const int64 max_outstanding_messages_;
+  const int64 max_outstanding_bytes_;
+  mutex mu_;
+  condition_variable received_;
+  std::deque<ReceivedMessage> messages_ TF_GUARDED_BY(mu_);
+  ClientContext* context_ TF_GUARDED_BY(mu_) = nullptr;
+  bool stop_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_;
+};
+
 class PubSubReadableResource : public ResourceBase {
  public:
   PubSubReadableResource(Env* env) : env_(env) {}
-  ~PubSubReadableResource() {}
+  ~PubSubReadableResource() {
+    mutex_lock l(mu_);
+    streaming_pull_.reset(nullptr);
+    if (stub_.get() != nullptr) {
+      Status status = Acknowledge();
+      if (!status.ok()) {
+        LOG(WARNING) << status;
+      }
+    }
+  }
 
   Status Init(const string& input, const std::vector<string>& metadata) {
     mutex_lock l(mu_);
@@ -47,6 +181,10 @@ class PubSubReadableResource : public ResourceBase {
     endpoint_ = "";
     subscription_ = input;
     timeout_ = 10 * 1000;
+    max_messages_ = kMaxMessagesPerPull;
+    bool streaming = false;
+    int64 max_outstanding_messages = 10 * kMaxMessagesPerPull;
+    int64 max_outstanding_bytes = 100 * 1024 * 1024;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("endpoint=") == 0) {
         std::vector<string> parts = str_util::Split(metadata[i], "=");
@@ -61,6 +199,35 @@ class PubSubReadableResource : public ResourceBase {
           return errors::InvalidArgument("invalid configuration: ",
                                          metadata[i]);
         }
+      } else if (metadata[i].find("max_messages=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &max_messages_) ||
+            max_messages_ <= 0 || max_messages_ > kMaxMessagesPerPull) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+      } else if (metadata[i].find("streaming=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 || (parts[1] != "true" && parts[1] != "false")) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+        streaming = (parts[1] == "true");
+      } else if (metadata[i].find("max_outstanding_messages=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &max_outstanding_messages)) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+      } else if (metadata[i].find("max_outstanding_bytes=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &max_outstanding_bytes)) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
       }
     }
     string endpoint = endpoint_;
@@ -73,6 +240,11 @@ class PubSubReadableResource : public ResourceBase {
       endpoint = endpoint_.substr(8);
     }
     stub_ = Subscriber::NewStub(grpc::CreateChannel(endpoint, creds));
+    if (streaming) {
+      streaming_pull_.reset(new PubSubStreamingPull(
+          env_, stub_.get(), subscription_, max_outstanding_messages,
+          max_outstanding_bytes));
+    }
 
     return OkStatus();
   }
@@ -83,56 +255,60 @@ class PubSubReadableResource : public ResourceBase {
     if (stub_.get() == nullptr) {
       return errors::OutOfRange("EOF reached");
     }
-    ClientContext context;
-    if (timeout_ > 0) {
-      std::chrono::system_clock::time_point deadline =
-          std::chrono::system_clock::now() +
-          std::chrono::milliseconds(timeout_);
-      context.set_deadline(deadline);
+    // The consumer has taken the previous batch by now, so its messages are
+    // acknowledged.
+    TF_RETURN_IF_ERROR(Acknowledge());
+
+    std::vector<ReceivedMessage> messages;
+    if (streaming_pull_ != nullptr) {
+      TF_RETURN_IF_ERROR(
+          streaming_pull_->Pop(timeout_, max_messages_, &messages));
+    } else {
+      do {
+        ClientContext context;
+        if (timeout_ > 0) {
+          std::chrono::system_clock::time_point deadline =
+              std::chrono::system_clock::now() +
+              std::chrono::milliseconds(timeout_);
+          context.set_deadline(deadline);
+        }
+        PullRequest request;
+        request.set_subscription(subscription_);
+        request.set_max_messages(max_messages_);
+        PullResponse response;
+        auto status = stub_->Pull(&context, request, &response);
+        if (!status.ok() &&
+            status.error_code() != grpc::StatusCode::DEADLINE_EXCEEDED) {
+          return errors::Internal("Failed to receive message: ",
+                                  status.error_message());
+        }
+        for (auto& message : *response.mutable_received_messages()) {
+          messages.push_back(std::move(message));
+        }
+      } while (messages.empty() && timeout_ <= 0);
     }
+
     Tensor* id_tensor;
     Tensor* data_tensor;
     Tensor* time_tensor;
-    while (true) {
-      PullRequest request;
-      request.set_subscription(subscription_);
-      request.set_max_messages(1);
-      PullResponse response;
-      auto status = stub_->Pull(&context, request, &response);
-      if (!status.ok()) {
-        return errors::Internal("Failed to receive message: ",
-                                status.error_message());
-      }
-      if (response.received_messages().size() == 0 && timeout_ > 0) {
-        // break subscription if there is a timeout, and no message.
-        TF_RETURN_IF_ERROR(allocate_func(TensorShape({0}), &id_tensor,
-                                         &data_tensor, &time_tensor));
-        stub_.reset(nullptr);
-        return OkStatus();
-      }
-      if (response.received_messages().size() != 0) {
-        TF_RETURN_IF_ERROR(allocate_func(TensorShape({1}), &id_tensor,
-                                         &data_tensor, &time_tensor));
-        id_tensor->scalar<tstring>()() =
-            std::string((response.received_messages(0).message().message_id()));
-        data_tensor->scalar<tstring>()() =
-            std::string((response.received_messages(0).message().data()));
-        time_tensor->scalar<int64>()() =
-            response.received_messages(0).message().publish_time().seconds() *
-                1000 +
-            response.received_messages(0).message().publish_time().nanos() /
-                1000000;
-
-        // Acknowledge
-        AcknowledgeRequest acknowledge;
-        acknowledge.add_ack_ids(response.received_messages(0).ack_id());
-        acknowledge.set_subscription(subscription_);
-        google::protobuf::Empty empty;
-        ClientContext ack_context;
-        status = stub_->Acknowledge(&ack_context, acknowledge, &empty);
-
-        return OkStatus();
-      }
+    if (messages.empty()) {
+      // break subscription if there is a timeout, and no message.
+      TF_RETURN_IF_ERROR(allocate_func(TensorShape({0}), &id_tensor,
+                                       &data_tensor, &time_tensor));
+      streaming_pull_.reset(nullptr);
+      stub_.reset(nullptr);
+      return OkStatus();
+    }
+    TF_RETURN_IF_ERROR(
+        allocate_func(TensorShape({static_cast<int64>(messages.size())}),
+                      &id_tensor, &data_tensor, &time_tensor));
+    for (size_t i = 0; i < messages.size(); i++) {
+      const auto& message = messages[i].message();
+      id_tensor->flat<tstring>()(i) = message.message_id();
+      data_tensor->flat<tstring>()(i) = message.data();
+      time_tensor->flat<int64>()(i) = message.publish_time().seconds() * 1000 +
+                                      message.publish_time().nanos() / 1000000;
+      pending_ack_ids_.push_back(messages[i].ack_id());
     }
     return OkStatus();
   }
@@ -142,15 +318,42 @@ class PubSubReadableResource : public ResourceBase {
   }
 
  protected:
+  // Acknowledges the messages of the batches read so far, with up to
+  // kMaxMessagesPerPull ack ids per request.
+  Status Acknowledge() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    for (size_t i = 0; i < pending_ack_ids_.size();
+         i += kMaxMessagesPerPull) {
+      AcknowledgeRequest acknowledge;
+      acknowledge.set_subscription(subscription_);
+      for (size_t j = i; j < std::min<size_t>(pending_ack_ids_.size(),
+                                              i + kMaxMessagesPerPull);
+           j++) {
+        acknowledge.add_ack_ids(pending_ack_ids_[j]);
+      }
+      google::protobuf::Empty empty;
+      ClientContext ack_context;
+      auto status = stub_->Acknowledge(&ack_context, acknowledge, &empty);
+      if (!status.ok()) {
+        // Messages that are not acknowledged are redelivered.
+        pending_ack_ids_.clear();
+        return errors::Internal("Failed to acknowledge messages: ",
+                                status.error_message());
+      }
+    }
+    pending_ack_ids_.clear();
+    return OkStatus();
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   string subscription_ TF_GUARDED_BY(mu_);
   string endpoint_ TF_GUARDED_BY(mu_);
   int64 timeout_ TF_GUARDED_BY(mu_);
+  int64 max_messages_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Subscriber::Stub> stub_ TF_GUARDED_BY(mu_);
-  string message_id_ TF_GUARDED_BY(mu_);
-  string message_data_ TF_GUARDED_BY(mu_);
-  int64 message_time_ TF_GUARDED_BY(mu_);
+  // Declared after the stub, which the streaming pull uses.
+  std::unique_ptr<PubSubStreamingPull> streaming_pull_ TF_GUARDED_BY(mu_);
+  std::vector<string> pending_ack_ids_ TF_GUARDED_BY(mu_);
 };
 
 class PubSubReadableInitOp : public ResourceOpKernel<PubSubReadableResource> {
@@ -44,7 +44,9 @@ class PulsarResourceBase : public ResourceBase {
 class PulsarReadableResource final : public PulsarResourceBase {
  public:
   Status Init(const std::string& service_url, const std::string& topic,
-              const std::string& subscription, int64 ack_grouping_time) {
+              const std::string& subscription, int64 ack_grouping_time,
+              int64 batch_receive_max_messages, int64 batch_receive_max_bytes,
+              int64 batch_receive_timeout) {
     mutex_lock l(mu_);
     PulsarResourceBase::Init(service_url);
 
@@ -52,6 +54,16 @@ class PulsarReadableResource final : public PulsarResourceBase {
     conf.setConsumerType(pulsar::ConsumerFailover);
     conf.setSubscriptionInitialPosition(pulsar::InitialPositionEarliest);
     conf.setAckGroupingTimeMs(ack_grouping_time);
+    // Messages are received in batches if a batch receive timeout is given, a
+    // non-positive limit of messages or bytes leaves that limit unset.
+    batch_receive_ = batch_receive_timeout > 0;
+    batch_receive_timeout_ = batch_receive_timeout;
+    if (batch_receive_) {
+      conf.setBatchReceivePolicy(pulsar::BatchReceivePolicy(
+          batch_receive_max_messages > 0 ? batch_receive_max_messages : -1,
+          batch_receive_max_bytes > 0 ? batch_receive_max_bytes : -1,
+          batch_receive_timeout));
+    }
 
     auto result = client_->subscribe(topic, subscription, conf, consumer_);
     if (result != pulsar::ResultOk) {
@@ -80,21 +92,35 @@ class PulsarReadableResource final : public PulsarResourceBase {
     int32 elapsed_time = 0;
     int num_messages = 0;
     while (elapsed_time < timeout && num_messages < max_num_messages) {
-      pulsar::Message message;
-      auto result = consumer_.receive(message, poll_timeout);
-      if (result == pulsar::ResultOk) {
-        keys.emplace_back(message.hasPartitionKey() ? message.getPartitionKey()
-                                                    : "");
-        values.emplace_back(message.getDataAsString());
-        num_messages++;
+      pulsar::Messages messages;
+      pulsar::Result result;
+      if (batch_receive_) {
+        // Waits up to the timeout of the batch receive policy.
+        result = consumer_.batchReceive(messages);
+      } else {
+        messages.resize(1);
+        result = consumer_.receive(messages[0], poll_timeout);
+      }
+      if (result == pulsar::ResultOk && !messages.empty()) {
+        pulsar::MessageIdList ids;
+        ids.reserve(messages.size());
+        for (const pulsar::Message& message : messages) {
+          keys.emplace_back(
+              message.hasPartitionKey() ? message.getPartitionKey() : "");
+          values.emplace_back(message.getDataAsString());
+          ids.push_back(message.getMessageId());
+        }
+        num_messages += messages.size();
         elapsed_time = 0;  // reset the current timeout
-        consumer_.acknowledgeAsync(message, [&](pulsar::Result result) {
+        consumer_.acknowledgeAsync(ids, [](pulsar::Result result) {
           if (result != pulsar::ResultOk) {
-            LOG(ERROR) << "Failed to acknowledge " << message.getMessageId();
+            LOG(ERROR) << "Failed to acknowledge messages: "
+                       << pulsar::strResult(result);
           }
         });
-      } else if (result == pulsar::ResultTimeout) {
-        elapsed_time += poll_timeout;
+      } else if (result == pulsar::ResultOk ||
+                 result == pulsar::ResultTimeout) {
+        elapsed_time += batch_receive_ ? batch_receive_timeout_ : poll_timeout;
       } else {
         return errors::Internal("failed to receive messages, error: ",
                                 pulsar::strResult(result));
@@ -123,6 +149,8 @@ class PulsarReadableResource final : public PulsarResourceBase {
 
  private:
   pulsar::Consumer consumer_;
+  bool batch_receive_ = false;
+  int64 batch_receive_timeout_ = 0;
 };
 
 class PulsarReadableInitOp : public ResourceOpKernel<PulsarReadableResource> {
@@ -153,8 +181,29 @@ class PulsarReadableInitOp : public ResourceOpKernel<PulsarReadableResource> {
                                            &ack_grouping_time_tensor));
     const int64 ack_grouping_time = ack_grouping_time_tensor->scalar<int64>()();
 
-    OP_REQUIRES_OK(context, resource_->Init(service_url, topic, subscription,
-                                            ack_grouping_time));
+    const Tensor* batch_receive_max_messages_tensor;
+    OP_REQUIRES_OK(context, context->input("batch_receive_max_messages",
+                                           &batch_receive_max_messages_tensor));
+    const int64 batch_receive_max_messages =
+        batch_receive_max_messages_tensor->scalar<int64>()();
+
+    const Tensor* batch_receive_max_bytes_tensor;
+    OP_REQUIRES_OK(context, context->input("batch_receive_max_bytes",
+                                           &batch_receive_max_bytes_tensor));
+    const int64 batch_receive_max_bytes =
+        batch_receive_max_bytes_tensor->scalar<int64>()();
+
+    const Tensor* batch_receive_timeout_tensor;
+    OP_REQUIRES_OK(context, context->input("batch_receive_timeout",
+                                           &batch_receive_timeout_tensor));
+    const int64 batch_receive_timeout =
+        batch_receive_timeout_tensor->scalar<int64>()();
+
+    OP_REQUIRES_OK(
+        context, resource_->Init(service_url, topic, subscription,
+                                 ack_grouping_time, batch_receive_max_messages,
+                                 batch_receive_max_bytes,
+                                 batch_receive_timeout));
   }
 
   Status CreateResource(PulsarReadableResource** resource)
@@ -207,7 +256,10 @@ class PulsarReadableNextOp : public OpKernel {
 
 class PulsarWritableResource final : public PulsarResourceBase {
  public:
-  Status Init(const std::string& service_url, const std::string& topic) {
+  Status Init(const std::string& service_url, const std::string& topic,
+              int64 batching_max_messages, int64 batching_max_bytes,
+              int64 batching_max_publish_delay, const std::string& compression,
+              int64 max_pending_messages) {
     mutex_lock l(mu_);
     PulsarResourceBase::Init(service_url);
     index_ = 0;
@@ -215,6 +267,35 @@ class PulsarWritableResource final : public PulsarResourceBase {
     pulsar::ProducerConfiguration conf;
     conf.setPartitionsRoutingMode(
         pulsar::ProducerConfiguration::RoundRobinDistribution);
+    // Messages are batched unless the most messages per batch is 0, the other
+    // settings keep the defaults of the client if they are not positive.
+    conf.setBatchingEnabled(batching_max_messages != 0);
+    if (batching_max_messages > 0) {
+      conf.setBatchingMaxMessagesPerBatch(batching_max_messages);
+    }
+    if (batching_max_bytes > 0) {
+      conf.setBatchingMaxAllowedSizeInBytes(batching_max_bytes);
+    }
+    if (batching_max_publish_delay > 0) {
+      conf.setBatchingMaxPublishDelayMs(batching_max_publish_delay);
+    }
+    if (max_pending_messages > 0) {
+      conf.setMaxPendingMessages(max_pending_messages);
+    }
+    // Sends wait for room in the queue of pending messages rather than fail,
+    // as a batched write submits a whole tensor of messages at once.
+    conf.setBlockIfQueueFull(true);
+    if (compression == "lz4") {
+      conf.setCompressionType(pulsar::CompressionLZ4);
+    } else if (compression == "zlib") {
+      conf.setCompressionType(pulsar::CompressionZLib);
+    } else if (compression == "zstd") {
+      conf.setCompressionType(pulsar::CompressionZSTD);
+    } else if (compression == "snappy") {
+      conf.setCompressionType(pulsar::CompressionSNAPPY);
+    } else if (compression != "" && compression != "none") {
+      return errors::InvalidArgument("unsupported compression: ", compression);
+    }
 
     auto result = client_->createProducer(topic, conf, producer_);
     if (result != pulsar::ResultOk) {
@@ -228,27 +309,19 @@ class PulsarWritableResource final : public PulsarResourceBase {
 
   Status WriteAsync(const std::string& value, const std::string& key) {
     mutex_lock l(mu_);
-    pulsar::MessageBuilder builder;
-    if (!key.empty()) {
-      builder.setPartitionKey(key);
-    }
-    auto send_async_result = pulsar::ResultOk;
-    producer_.sendAsync(
-        builder.setContent(value).build(),
-        [index = index_, &send_async_result](pulsar::Result result,
-                                             const pulsar::MessageId& id) {
-          if (result != pulsar::ResultOk) {
-            LOG(ERROR) << "failed to send message-" << index << ": " << result;
-          }
-          send_async_result = result;
-        });
-    // sendAsync may fail immediately caused by queue is full
-    if (send_async_result != pulsar::ResultOk) {
-      return errors::Internal("sendAsync failed for index: ", index_,
-                              " error: ", pulsar::strResult(send_async_result));
+    SendAsync(value, key);
+    // sendAsync may fail immediately, e.g. if the producer is closed
+    return send_state_->TakeError();
+  }
+
+  // Submits all messages without waiting for them to be sent, failures are
+  // returned by the following writes or the flush.
+  Status WriteBatchAsync(const Tensor& values, const Tensor& keys) {
+    mutex_lock l(mu_);
+    for (int64 i = 0; i < values.NumElements(); i++) {
+      SendAsync(values.flat<tstring>()(i), keys.flat<tstring>()(i));
     }
-    index_++;
-    return OkStatus();
+    return send_state_->TakeError();
   }
 
   Status Flush() {
@@ -257,14 +330,58 @@ class PulsarWritableResource final : public PulsarResourceBase {
     if (result != pulsar::ResultOk) {
       return errors::Internal("failed to flush: ", pulsar::strResult(result));
     }
-    return OkStatus();
+    return send_state_->TakeError();
   }
 
   std::string DebugString() const override { return "PulsarWritableResource"; }
 
  private:
+  // The first failure of the sends, shared with their callbacks as these may
+  // run after the resource is gone.
+  class SendState {
+   public:
+    void RecordError(unsigned long index, pulsar::Result result) {
+      mutex_lock l(mu_);
+      if (status_.ok()) {
+        status_ = errors::Internal("sendAsync failed for index: ", index,
+                                   " error: ", pulsar::strResult(result));
+      }
+    }
+    Status TakeError() {
+      mutex_lock l(mu_);
+      Status status = status_;
+      status_ = OkStatus();
+      return status;
+    }
+
+   private:
+    mutex mu_;
+    Status status_ TF_GUARDED_BY(mu_);
+  };
+
+  void SendAsync(const tstring& value, const tstring& key)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    pulsar::MessageBuilder builder;
+    if (!key.empty()) {
+      builder.setPartitionKey(std::string(key));
+    }
+    builder.setContent(value.data(), value.size());
+    producer_.sendAsync(
+        builder.build(),
+        [index = index_, state = send_state_](pulsar::Result result,
+                                              const pulsar::MessageId& id) {
+          if (result != pulsar::ResultOk) {
+            LOG(ERROR) << "failed to send message-" << index << ": " << result;
+            state->RecordError(index, result);
+          }
+        });
+    index_++;
+  }
+
   pulsar::Producer producer_;
   unsigned long index_;
+  const std::shared_ptr<SendState> send_state_ =
+      std::make_shared<SendState>();
 };
 
 class PulsarWritableInitOp : public ResourceOpKernel<PulsarWritableResource> {
@@ -284,7 +401,38 @@ class PulsarWritableInitOp : public ResourceOpKernel<PulsarWritableResource> {
     OP_REQUIRES_OK(context, context->input("topic", &topic_tensor));
     const std::string topic = topic_tensor->flat<tstring>()(0);
 
-    OP_REQUIRES_OK(context, resource_->Init(service_url, topic));
+    const Tensor* batching_max_messages_tensor;
+    OP_REQUIRES_OK(context, context->input("batching_max_messages",
+                                           &batching_max_messages_tensor));
+    const int64 batching_max_messages =
+        batching_max_messages_tensor->scalar<int64>()();
+
+    const Tensor* batching_max_bytes_tensor;
+    OP_REQUIRES_OK(context, context->input("batching_max_bytes",
+                                           &batching_max_bytes_tensor));
+    const int64 batching_max_bytes =
+        batching_max_bytes_tensor->scalar<int64>()();
+
+    const Tensor* batching_max_publish_delay_tensor;
+    OP_REQUIRES_OK(context, context->input("batching_max_publish_delay",
+                                           &batching_max_publish_delay_tensor));
+    const int64 batching_max_publish_delay =
+        batching_max_publish_delay_tensor->scalar<int64>()();
+
+    const Tensor* compression_tensor;
+    OP_REQUIRES_OK(context, context->input("compression", &compression_tensor));
+    const std::string compression = compression_tensor->flat<tstring>()(0);
+
+    const Tensor* max_pending_messages_tensor;
+    OP_REQUIRES_OK(context, context->input("max_pending_messages",
+                                           &max_pending_messages_tensor));
+    const int64 max_pending_messages =
+        max_pending_messages_tensor->scalar<int64>()();
+
+    OP_REQUIRES_OK(
+        context, resource_->Init(service_url, topic, batching_max_messages,
+                                 batching_max_bytes, batching_max_publish_delay,
+                                 compression, max_pending_messages));
   }
 
   Status CreateResource(PulsarWritableResource** resource)
@@ -322,6 +470,35 @@ class PulsarWritableWriteOp : public OpKernel {
   }
 };
 
+class PulsarWritableWriteBatchOp : public OpKernel {
+ public:
+  explicit PulsarWritableWriteBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    PulsarWritableResource* resource;
+
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* value_tensor;
+    OP_REQUIRES_OK(context, context->input("value", &value_tensor));
+
+    const Tensor* key_tensor;
+    OP_REQUIRES_OK(context, context->input("key", &key_tensor));
+    OP_REQUIRES(context, value_tensor->shape() == key_tensor->shape(),
+                errors::InvalidArgument(
+                    "value and key must have the same shape, got ",
+                    value_tensor->shape().DebugString(), " vs. ",
+                    key_tensor->shape().DebugString()));
+
+    OP_REQUIRES_OK(context,
+                   resource->WriteBatchAsync(*value_tensor, *key_tensor));
+  }
+};
+
 class PulsarWritableFlushOp : public OpKernel {
  public:
   explicit PulsarWritableFlushOp(OpKernelConstruction* context)
@@ -347,6 +524,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>PulsarWritableInit").Device(DEVICE_CPU),
                         PulsarWritableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>PulsarWritableWrite").Device(DEVICE_CPU),
                         PulsarWritableWriteOp);
+REGISTER_KERNEL_BUILDER(Name("IO>PulsarWritableWriteBatch").Device(DEVICE_CPU),
+                        PulsarWritableWriteBatchOp);
 REGISTER_KERNEL_BUILDER(Name("IO>PulsarWritableFlush").Device(DEVICE_CPU),
                         PulsarWritableFlushOp);
 
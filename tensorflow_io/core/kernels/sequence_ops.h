@@ -12,13 +12,17 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
-#include <deque>
+#include <vector>
 
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
 
 namespace tensorflow {
 
+// Items may be set out of order, and are output in order of their index once
+// all the items before them are set. The pending items are kept in a ring
+// buffer of slots whose strings are reused, so that setting an item does not
+// allocate once the slots have grown to the size of the items.
 class OutputSequence : public ResourceBase {
  public:
   OutputSequence(Env* env) : env_(env) {}
@@ -28,26 +32,22 @@ class OutputSequence : public ResourceBase {
     return errors::Unimplemented("flush is not implemented");
   }
   virtual Status Output() = 0;
-  virtual Status SetItem(int64 index, const void* item) {
+  virtual Status SetItem(int64 index, StringPiece item) {
     mutex_lock l(mu_);
-    int64 size = fifo_.size();
     if (index < base_) {
       return errors::InvalidArgument("the item has already been add: ", index);
     }
-    if (base_ <= index && index < base_ + size) {
-      if (fifo_[index - base_].get() != nullptr) {
-        return errors::InvalidArgument("the item has already been add before: ",
-                                       index);
-      }
-      fifo_[index - base_].reset(new string((const char*)item));
+    if (index - base_ >= static_cast<int64>(slots_.size())) {
+      Grow(index - base_ + 1);
     }
-    if (base_ + size <= index) {
-      for (int64 i = base_ + size; i < index; i++) {
-        fifo_.push_back(nullptr);
-      }
-      fifo_.push_back(std::unique_ptr<string>(new string((const char*)item)));
+    Slot& slot = slots_[(head_ + index - base_) % slots_.size()];
+    if (slot.set) {
+      return errors::InvalidArgument("the item has already been add before: ",
+                                     index);
     }
-    if (fifo_.front().get() != nullptr) {
+    slot.item.assign(item.data(), item.size());
+    slot.set = true;
+    if (HasFront()) {
       TF_RETURN_IF_ERROR(Output());
     }
     return OkStatus();
@@ -57,10 +57,50 @@ class OutputSequence : public ResourceBase {
   }
 
  protected:
+  // Whether the item at base_ is set, so that it is the next to output.
+  bool HasFront() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return !slots_.empty() && slots_[head_].set;
+  }
+  const string& Front() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return slots_[head_].item;
+  }
+  // Releases the item at base_, keeping the memory of its slot.
+  void PopFront() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    slots_[head_].item.clear();
+    slots_[head_].set = false;
+    head_ = (head_ + 1) % slots_.size();
+    base_++;
+  }
+
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   int64 base_ TF_GUARDED_BY(mu_) = 0;
-  std::deque<std::unique_ptr<string>> fifo_ TF_GUARDED_BY(mu_);
+
+ private:
+  struct Slot {
+    string item;
+    bool set = false;
+  };
+
+  // Grows the ring buffer to at least `size` slots, with the slot of base_
+  // moved to the front.
+  void Grow(const int64 size) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    size_t capacity = std::max<size_t>(slots_.size() * 2, kMinSlots);
+    while (capacity < static_cast<size_t>(size)) {
+      capacity *= 2;
+    }
+    std::vector<Slot> slots(capacity);
+    for (size_t i = 0; i < slots_.size(); i++) {
+      slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+    }
+    slots_.swap(slots);
+    head_ = 0;
+  }
+
+  static constexpr size_t kMinSlots = 64;
+
+  std::vector<Slot> slots_ TF_GUARDED_BY(mu_);
+  size_t head_ TF_GUARDED_BY(mu_) = 0;
 };
 
 template <typename T>
@@ -105,8 +145,8 @@ class OutputSequenceSetItemOp : public OpKernel {
         errors::InvalidArgument("Item tensor must be scalar, but had shape: ",
                                 item_tensor->shape().DebugString()));
     const int64 index = index_tensor->scalar<int64>()();
-    const string& item = item_tensor->scalar<tstring>()();
-    OP_REQUIRES_OK(ctx, sequence->SetItem(index, item.c_str()));
+    const tstring& item = item_tensor->scalar<tstring>()();
+    OP_REQUIRES_OK(ctx, sequence->SetItem(index, item));
   }
 
  private:
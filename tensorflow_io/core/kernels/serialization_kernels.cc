@@ -13,7 +13,6 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include "api/Compiler.hh"
 #include "api/DataFile.hh"
 #include "api/Generic.hh"
 #include "api/Stream.hh"
@@ -21,11 +20,59 @@ limitations under the License.
 #include "rapidjson/document.h"
 #include "rapidjson/pointer.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow_io/core/kernels/avro/utils/avro_schema_cache.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Single Entry Tensor Writes
+
+void writeInt32(rapidjson::Value* entry, Tensor* value_tensor,
+                int64& flat_index) {
+  value_tensor->flat<int32>()(flat_index) = (*entry).GetInt();
+}
+
+void writeInt64(rapidjson::Value* entry, Tensor* value_tensor,
+                int64& flat_index) {
+  value_tensor->flat<int64>()(flat_index) = (*entry).GetInt64();
+}
+
+void writeFloat(rapidjson::Value* entry, Tensor* value_tensor,
+                int64& flat_index) {
+  value_tensor->flat<float>()(flat_index) = (*entry).GetDouble();
+}
+
+void writeDouble(rapidjson::Value* entry, Tensor* value_tensor,
+                 int64& flat_index) {
+  value_tensor->flat<double>()(flat_index) = (*entry).GetDouble();
+}
+
+void writeString(rapidjson::Value* entry, Tensor* value_tensor,
+                 int64& flat_index) {
+  value_tensor->flat<tstring>()(flat_index) = (*entry).GetString();
+}
+
+void writeBool(rapidjson::Value* entry, Tensor* value_tensor,
+               int64& flat_index) {
+  value_tensor->flat<bool>()(flat_index) = (*entry).GetBool();
+}
+
+// Full Tensor Write
+
+template <class T>
+void writeToTensor(rapidjson::Value* entry, Tensor* value_tensor,
+                   int64& flat_index, T write_func) {
+  if (entry->IsArray()) {
+    for (int64 i = 0; i < entry->Size(); i++) {
+      writeToTensor(&(*entry)[i], value_tensor, flat_index, write_func);
+    }
+  } else {
+    write_func(entry, value_tensor, flat_index);
+    flat_index++;
+  }
+}
+
 class DecodeJSONOp : public OpKernel {
  public:
   explicit DecodeJSONOp(OpKernelConstruction* context) : OpKernel(context) {
@@ -112,52 +159,124 @@ class DecodeJSONOp : public OpKernel {
       }
     }
   }
+};
 
-  // Single Entry Tensor Writes
-
-  static void writeInt32(rapidjson::Value* entry, Tensor* value_tensor,
-                         int64& flat_index) {
-    value_tensor->flat<int32>()(flat_index) = (*entry).GetInt();
-  }
-
-  static void writeInt64(rapidjson::Value* entry, Tensor* value_tensor,
-                         int64& flat_index) {
-    value_tensor->flat<int64>()(flat_index) = (*entry).GetInt64();
-  }
-
-  static void writeFloat(rapidjson::Value* entry, Tensor* value_tensor,
-                         int64& flat_index) {
-    value_tensor->flat<float>()(flat_index) = (*entry).GetDouble();
+// Decodes a batch of JSON strings at once into tensors of the batch, with
+// the JSON Pointers of the names compiled once per kernel. The batch is
+// copied to one buffer and its strings are parsed in place, with an arena
+// that is reused from element to element.
+class DecodeJSONBatchOp : public OpKernel {
+ public:
+  explicit DecodeJSONBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<string> names;
+    OP_REQUIRES_OK(context, context->GetAttr("names", &names));
+    OP_REQUIRES_OK(context, context->GetAttr("shapes", &shapes_));
+    OP_REQUIRES(context, (names.size() == shapes_.size()),
+                errors::InvalidArgument(
+                    "shapes and names should have same number: ",
+                    shapes_.size(), " vs. ", names.size()));
+    for (const string& name : names) {
+      rapidjson::Pointer pointer(name.data(), name.size());
+      OP_REQUIRES(context, pointer.IsValid(),
+                  errors::InvalidArgument("invalid JSON Pointer: ", name));
+      pointers_.emplace_back(std::move(pointer));
+    }
+    names_ = std::move(names);
   }
 
-  static void writeDouble(rapidjson::Value* entry, Tensor* value_tensor,
-                          int64& flat_index) {
-    value_tensor->flat<double>()(flat_index) = (*entry).GetDouble();
-  }
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const int64 batch = input_tensor->NumElements();
+
+    std::vector<Tensor*> value_tensors(names_.size());
+    for (size_t i = 0; i < names_.size(); i++) {
+      TensorShape shape({batch});
+      shape.AppendShape(shapes_[i]);
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(i, shape, &value_tensors[i]));
+    }
 
-  static void writeString(rapidjson::Value* entry, Tensor* value_tensor,
-                          int64& flat_index) {
-    value_tensor->flat<tstring>()(flat_index) = (*entry).GetString();
-  }
+    std::vector<size_t> offsets(batch + 1, 0);
+    for (int64 b = 0; b < batch; b++) {
+      offsets[b + 1] = offsets[b] + input_tensor->flat<tstring>()(b).size() + 1;
+    }
+    string buffer(offsets[batch], '\0');
+    for (int64 b = 0; b < batch; b++) {
+      const tstring& input = input_tensor->flat<tstring>()(b);
+      memcpy(&buffer[offsets[b]], input.data(), input.size());
+    }
 
-  static void writeBool(rapidjson::Value* entry, Tensor* value_tensor,
-                        int64& flat_index) {
-    value_tensor->flat<bool>()(flat_index) = (*entry).GetBool();
+    char arena[kArenaBytes];
+    rapidjson::MemoryPoolAllocator<> allocator(arena, sizeof(arena));
+    for (int64 b = 0; b < batch; b++) {
+      allocator.Clear();
+      rapidjson::Document d(&allocator);
+      d.ParseInsitu(&buffer[offsets[b]]);
+      OP_REQUIRES(context, !d.HasParseError() && d.IsObject(),
+                  errors::InvalidArgument("not a valid JSON object at ", b));
+      for (size_t i = 0; i < pointers_.size(); i++) {
+        rapidjson::Value* entry = pointers_[i].Get(d);
+        OP_REQUIRES(context, (entry != nullptr),
+                    errors::InvalidArgument("no value for ", names_[i],
+                                            " at ", b));
+        const int64 count = shapes_[i].num_elements();
+        OP_REQUIRES(context, (countValues(entry) == count),
+                    errors::InvalidArgument("value for ", names_[i], " at ",
+                                            b, " does not have shape ",
+                                            shapes_[i].DebugString()));
+        Tensor* value_tensor = value_tensors[i];
+        int64 flat_index = b * count;
+        switch (value_tensor->dtype()) {
+          case DT_INT32:
+            writeToTensor(entry, value_tensor, flat_index, writeInt32);
+            break;
+          case DT_INT64:
+            writeToTensor(entry, value_tensor, flat_index, writeInt64);
+            break;
+          case DT_FLOAT:
+            writeToTensor(entry, value_tensor, flat_index, writeFloat);
+            break;
+          case DT_DOUBLE:
+            writeToTensor(entry, value_tensor, flat_index, writeDouble);
+            break;
+          case DT_STRING:
+            writeToTensor(entry, value_tensor, flat_index, writeString);
+            break;
+          case DT_BOOL:
+            writeToTensor(entry, value_tensor, flat_index, writeBool);
+            break;
+          default:
+            OP_REQUIRES(
+                context, false,
+                errors::InvalidArgument("data type not supported: ",
+                                        DataTypeString(value_tensor->dtype())));
+            break;
+        }
+      }
+    }
   }
 
-  // Full Tensor Write
-
-  template <class T>
-  static void writeToTensor(rapidjson::Value* entry, Tensor* value_tensor,
-                            int64& flat_index, T write_func) {
-    if (entry->IsArray()) {
-      for (int64 i = 0; i < entry->Size(); i++) {
-        writeToTensor(&(*entry)[i], value_tensor, flat_index, write_func);
-      }
-    } else {
-      write_func(entry, value_tensor, flat_index);
-      flat_index++;
+ private:
+  // The bytes of the arena on the stack, enough for most JSON events to be
+  // parsed without a heap allocation.
+  static constexpr size_t kArenaBytes = 16 << 10;
+
+  std::vector<string> names_;
+  std::vector<rapidjson::Pointer> pointers_;
+  std::vector<TensorShape> shapes_;
+
+  // The number of scalars of a value, arrays being flattened.
+  static int64 countValues(const rapidjson::Value* entry) {
+    if (!entry->IsArray()) {
+      return 1;
+    }
+    int64 count = 0;
+    for (rapidjson::SizeType i = 0; i < entry->Size(); i++) {
+      count += countValues(&(*entry)[i]);
     }
+    return count;
   }
 };
 
@@ -193,11 +312,11 @@ class DecodeAvroOp : public OpKernel {
                                                        &value_tensor));
       values[names_tensor->flat<tstring>()(i)] = value_tensor;
     }
-    avro::ValidSchema avro_schema;
-    std::istringstream ss(schema);
-    string error;
-    OP_REQUIRES(context, (avro::compileJsonSchema(ss, avro_schema, error)),
-                errors::Unimplemented("Avro schema error: ", error));
+    std::shared_ptr<const avro::ValidSchema> cached_schema;
+    Status status = last_schema_.Get(schema, &cached_schema);
+    OP_REQUIRES(context, status.ok(),
+                errors::Unimplemented(status.error_message()));
+    const avro::ValidSchema& avro_schema = *cached_schema;
 
     for (int64 entry_index = 0; entry_index < context->input(0).NumElements();
          entry_index++) {
@@ -351,12 +470,16 @@ class DecodeAvroOp : public OpKernel {
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::vector<TensorShape> shapes_ TF_GUARDED_BY(mu_);
+  // Keeps the compiled schema cached across calls with the same schema
+  CachedAvroSchema last_schema_;
 };
 
 class EncodeAvroOp : public OpKernel {
  public:
   explicit EncodeAvroOp(OpKernelConstruction* context) : OpKernel(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("container_block", &container_block_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -390,28 +513,80 @@ class EncodeAvroOp : public OpKernel {
     OP_REQUIRES_OK(context, context->input("schema", &schema_tensor));
     const string& schema = schema_tensor->scalar<tstring>()();
 
-    avro::ValidSchema avro_schema;
-    std::istringstream ss(schema);
-    string error;
-    OP_REQUIRES(context, (avro::compileJsonSchema(ss, avro_schema, error)),
-                errors::Unimplemented("Avro schema error: ", error));
+    std::shared_ptr<const avro::ValidSchema> cached_schema;
+    Status status = last_schema_.Get(schema, &cached_schema);
+    OP_REQUIRES(context, status.ok(),
+                errors::Unimplemented(status.error_message()));
+    const avro::ValidSchema& avro_schema = *cached_schema;
+
+    // All entries are encoded back to back into one arena, with one encoder
+    // and one datum reused for every entry. The end offsets of the entries
+    // size the outputs exactly.
+    const int64 num_entries = context->input(0).NumElements();
+    std::unique_ptr<avro::OutputStream> arena = avro::memoryOutputStream();
+    avro::EncoderPtr e = avro::binaryEncoder();
+    e->init(*arena);
+    avro::GenericDatum datum(avro_schema);
+    std::vector<size_t> ends(num_entries);
+    for (int64 entry_index = 0; entry_index < num_entries; entry_index++) {
+      OP_REQUIRES_OK(context, ProcessEntry(entry_index, values, "", datum));
+      avro::encode(*e, datum);
+      e->flush();
+      ends[entry_index] = arena->byteCount();
+    }
+
+    std::unique_ptr<avro::InputStream> in = avro::memoryInputStream(*arena);
+    if (container_block_) {
+      // A block of an avro container file without the file header and
+      // without the sync marker that follows the block
+      const size_t size = num_entries > 0 ? ends[num_entries - 1] : 0;
+      std::unique_ptr<avro::OutputStream> block_header =
+          avro::memoryOutputStream();
+      avro::EncoderPtr header_encoder = avro::binaryEncoder();
+      header_encoder->init(*block_header);
+      header_encoder->encodeLong(num_entries);
+      header_encoder->encodeLong(static_cast<int64_t>(size));
+      header_encoder->flush();
+      std::unique_ptr<avro::InputStream> header_in =
+          avro::memoryInputStream(*block_header);
+      const size_t header_size = block_header->byteCount();
+
+      Tensor* value_tensor = nullptr;
+      OP_REQUIRES_OK(context, context->allocate_output(0, TensorShape({}),
+                                                       &value_tensor));
+      tstring& value = value_tensor->scalar<tstring>()();
+      value.resize_uninitialized(header_size + size);
+      CopyFromStream(*header_in, header_size, &value[0]);
+      CopyFromStream(*in, size, &value[header_size]);
+      return;
+    }
 
     Tensor* value_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(
                                 0, context->input(0).shape(), &value_tensor));
-    for (int64 entry_index = 0; entry_index < context->input(0).NumElements();
-         entry_index++) {
-      std::ostringstream ss;
-      std::unique_ptr<avro::OutputStream> o = avro::ostreamOutputStream(ss);
-
-      avro::GenericDatum datum(avro_schema);
-      OP_REQUIRES_OK(context, ProcessEntry(entry_index, values, "", datum));
+    auto value_flat = value_tensor->flat<tstring>();
+    size_t begin = 0;
+    for (int64 entry_index = 0; entry_index < num_entries; entry_index++) {
+      const size_t size = ends[entry_index] - begin;
+      tstring& value = value_flat(entry_index);
+      value.resize_uninitialized(size);
+      CopyFromStream(*in, size, &value[0]);
+      begin = ends[entry_index];
+    }
+  }
 
-      avro::EncoderPtr e = avro::binaryEncoder();
-      e->init(*o);
-      avro::encode(*e, datum);
-      o->flush();
-      value_tensor->flat<tstring>()(entry_index) = ss.str();
+  // Copies the next size bytes of the stream to the destination
+  static void CopyFromStream(avro::InputStream& in, size_t size, char* dest) {
+    const uint8_t* data;
+    size_t len;
+    while (size > 0 && in.next(&data, &len)) {
+      if (len > size) {
+        in.backup(len - size);
+        len = size;
+      }
+      memcpy(dest, data, len);
+      dest += len;
+      size -= len;
     }
   }
 
@@ -517,9 +692,14 @@ class EncodeAvroOp : public OpKernel {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  bool container_block_;
+  // Keeps the compiled schema cached across calls with the same schema
+  CachedAvroSchema last_schema_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeJSON").Device(DEVICE_CPU), DecodeJSONOp);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeJSONBatch").Device(DEVICE_CPU),
+                        DecodeJSONBatchOp);
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeAvro").Device(DEVICE_CPU), DecodeAvroOp);
 REGISTER_KERNEL_BUILDER(Name("IO>EncodeAvro").Device(DEVICE_CPU), EncodeAvroOp);
 
@@ -0,0 +1,40 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_IO_CORE_KERNELS_SHARD_COST_H_
+#define TENSORFLOW_IO_CORE_KERNELS_SHARD_COST_H_
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// Costs of units of work given to `Shard`, roughly in cycles. Shard runs the
+// work on the calling thread if it costs less than 10000 in total, and
+// otherwise splits it into blocks of at least that cost, one per worker
+// thread at most.
+
+// The cost of a unit of work in the order of a millisecond, e.g. the decode
+// of an image, so that every unit is a block of its own.
+constexpr int64 kCostPerExpensiveUnit = 1 << 20;
+
+// The cost of converting one pixel between formats with libyuv or swscale,
+// which convert with SIMD in a few cycles per pixel. Small frames are then
+// converted several to a block.
+constexpr int64 kCostPerConvertedPixel = 8;
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_SHARD_COST_H_
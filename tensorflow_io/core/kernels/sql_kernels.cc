@@ -16,8 +16,13 @@ limitations under the License.
 #include <libpq-fe.h>
 #include <pg_config_types.h>
 
+#include <cctype>
+#include <cstring>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow_io/core/kernels/connection_pool.h"
 
 namespace tensorflow {
 namespace io {
@@ -37,65 +42,138 @@ DataType SqlDataType(int oid) {
   return DT_INVALID;
 };
 
-Status SqlDataCopy(int oid, char* data, Tensor* value) {
-  bool result = false;
+// Copies a value in the binary format, which is in network byte order, to
+// the element `index` of `value`.
+Status SqlDataCopy(int oid, const char* data, int length, int64 index,
+                   Tensor* value) {
+  int size;
   switch (oid) {
     case INT4OID:
-      result = absl::SimpleAtoi<int32>(data, &value->flat<int32>()(0));
-      break;
-    case INT8OID:
-      result = absl::SimpleAtoi<int64>(data, &value->flat<int64>()(0));
-      break;
     case FLOAT4OID:
-      result = absl::SimpleAtof(data, &value->flat<float>()(0));
+      size = 4;
       break;
+    case INT8OID:
     case FLOAT8OID:
-      result = absl::SimpleAtod(data, &value->flat<double>()(0));
+      size = 8;
       break;
     default:
       return errors::InvalidArgument("sql data type ", oid, " not supported");
   }
-  if (!result) {
+  // A null value has no data.
+  if (length != size) {
     return errors::InvalidArgument("unable to convert data");
   }
+  uint64 bits = 0;
+  for (int i = 0; i < size; i++) {
+    bits = (bits << 8) | static_cast<uint8>(data[i]);
+  }
+  switch (oid) {
+    case INT4OID:
+      value->flat<int32>()(index) =
+          static_cast<int32>(static_cast<uint32>(bits));
+      break;
+    case INT8OID:
+      value->flat<int64>()(index) = static_cast<int64>(bits);
+      break;
+    case FLOAT4OID: {
+      const uint32 float_bits = static_cast<uint32>(bits);
+      std::memcpy(&value->flat<float>()(index), &float_bits, size);
+    } break;
+    case FLOAT8OID:
+      std::memcpy(&value->flat<double>()(index), &bits, size);
+      break;
+  }
   return OkStatus();
 };
 
+struct PGconnDeleter {
+  void operator()(PGconn* conn) const { PQfinish(conn); }
+};
+using SqlConnectionPool = data::ConnectionPool<PGconn, PGconnDeleter>;
+
+// Leases a connection to `endpoint` from the connections pooled across the
+// resources of the process. Only connections that are outside of any
+// transaction are reused.
+Status SqlAcquireConnection(const string& endpoint,
+                            std::shared_ptr<PGconn>* conn) {
+  return SqlConnectionPool::Default()->Acquire(
+      endpoint,
+      [&endpoint](SqlConnectionPool::Connection* connection) -> Status {
+        connection->reset(PQconnectdb(endpoint.c_str()));
+        if (PQstatus(connection->get()) != CONNECTION_OK) {
+          return errors::InvalidArgument("Connection to database failed: ",
+                                         PQerrorMessage(connection->get()));
+        }
+        LOG(INFO) << "Connection to database succeed.";
+        return OkStatus();
+      },
+      [](PGconn* connection) {
+        return PQstatus(connection) == CONNECTION_OK &&
+               PQtransactionStatus(connection) == PQTRANS_IDLE;
+      },
+      conn);
+}
+
+// The name of the server-side cursor the rows are fetched from when
+// streaming.
+static const char kCursorName[] = "tfio_cursor";
+
 class SqlIterableResource : public ResourceBase {
  public:
   SqlIterableResource(Env* env)
-      : env_(env),
-        conn_(nullptr,
-              [](PGconn* p) {
-                if (p != nullptr) {
-                  PQfinish(p);
-                }
-              }),
-        result_(nullptr, [](PGresult* p) {
+      : env_(env), result_(nullptr, [](PGresult* p) {
           if (p != nullptr) {
             PQclear(p);
           }
         }) {}
-  ~SqlIterableResource() {}
+  ~SqlIterableResource() {
+    // The transaction of a cursor is rolled back before the connection goes
+    // back to the pool.
+    result_.reset();
+    if (conn_ != nullptr && PQtransactionStatus(conn_.get()) != PQTRANS_IDLE) {
+      PQclear(PQexec(conn_.get(), "ROLLBACK"));
+    }
+  }
 
-  Status Init(const string& query, const string& endpoint, int64* count,
+  // With a positive `batch_size` the rows are streamed from a server-side
+  // cursor, `batch_size` at a time, rather than held in client memory. The
+  // `count` of rows is then unknown, and -1.
+  Status Init(const string& query, const string& endpoint,
+              const int64 batch_size, int64* count,
               std::vector<string>* fields, std::vector<DataType>* dtypes) {
     mutex_lock l(mu_);
-    conn_.reset(PQconnectdb(endpoint.c_str()));
-    if (PQstatus(conn_.get()) != CONNECTION_OK) {
-      return errors::InvalidArgument("Connection to database failed: ",
-                                     PQerrorMessage(conn_.get()));
-    }
-    LOG(INFO) << "Connection to database succeed.";
+    TF_RETURN_IF_ERROR(SqlAcquireConnection(endpoint, &conn_));
 
-    result_.reset(PQexec(conn_.get(), query.c_str()));
-    if (PQresultStatus(result_.get()) != PGRES_TUPLES_OK) {
-      return errors::InvalidArgument("Exec of query failed: ",
-                                     PQerrorMessage(conn_.get()));
+    batch_size_ = batch_size;
+    if (batch_size_ > 0) {
+      // The cursor is declared for the query without its terminating
+      // semicolon.
+      query_ = query;
+      while (!query_.empty() &&
+             (query_.back() == ';' || isspace(query_.back()))) {
+        query_.pop_back();
+      }
+      TF_RETURN_IF_ERROR(Exec("BEGIN"));
+      TF_RETURN_IF_ERROR(DeclareCursor());
+      result_.reset(PQdescribePortal(conn_.get(), kCursorName));
+      if (PQresultStatus(result_.get()) != PGRES_COMMAND_OK) {
+        return errors::InvalidArgument("Describe of cursor failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
+      count_ = -1;
+    } else {
+      // The values are fetched in the binary format so that numerics are not
+      // parsed from text.
+      result_.reset(PQexecParams(conn_.get(), query.c_str(), 0, nullptr,
+                                 nullptr, nullptr, nullptr, 1));
+      if (PQresultStatus(result_.get()) != PGRES_TUPLES_OK) {
+        return errors::InvalidArgument("Exec of query failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
+      count_ = PQntuples(result_.get());
     }
     LOG(INFO) << "Exec of query succeed.";
 
-    count_ = PQntuples(result_.get());
     fields_.clear();
     dtypes_.clear();
     int field_count = PQnfields(result_.get());
@@ -125,31 +203,248 @@ class SqlIterableResource : public ResourceBase {
 
     return OkStatus();
   }
+  // Reads the row `index`, or when streaming the batch of rows `index`. The
+  // batches are fetched in order, and reading the batch 0 again restarts the
+  // query.
   Status Read(const int64 index, const Tensor* field_tensor,
-              std::function<Status(const int64 field_index, Tensor** value)>
+              std::function<Status(const int64 field_index,
+                                   const TensorShape& shape, Tensor** value)>
                   allocate_func) {
     mutex_lock l(mu_);
+    int64 start = index;
+    int64 rows = 1;
+    if (batch_size_ > 0) {
+      if (index == 0 && next_batch_ != 0) {
+        TF_RETURN_IF_ERROR(Exec(strings::StrCat("CLOSE ", kCursorName)));
+        TF_RETURN_IF_ERROR(DeclareCursor());
+        next_batch_ = 0;
+      }
+      if (index != next_batch_) {
+        return errors::InvalidArgument("batch ", index,
+                                       " is read out of order, expected ",
+                                       next_batch_);
+      }
+      const string fetch = strings::StrCat("FETCH FORWARD ", batch_size_,
+                                           " FROM ", kCursorName);
+      result_.reset(PQexecParams(conn_.get(), fetch.c_str(), 0, nullptr,
+                                 nullptr, nullptr, nullptr, 1));
+      if (PQresultStatus(result_.get()) != PGRES_TUPLES_OK) {
+        return errors::InvalidArgument("Fetch of cursor failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
+      next_batch_++;
+      start = 0;
+      rows = PQntuples(result_.get());
+    }
     for (int64 i = 0; i < field_tensor->NumElements(); i++) {
       Tensor* value;
-      TF_RETURN_IF_ERROR(allocate_func(i, &value));
+      TF_RETURN_IF_ERROR(allocate_func(i, TensorShape({rows}), &value));
       char* field_name = (char*)(field_tensor->flat<tstring>()(i).c_str());
       int field_number = PQfnumber(result_.get(), field_name);
       int field_type = PQftype(result_.get(), field_number);
-      char* data = PQgetvalue(result_.get(), index, field_number);
-      TF_RETURN_IF_ERROR(SqlDataCopy(field_type, data, value));
+      for (int64 row = 0; row < rows; row++) {
+        const char* data = PQgetvalue(result_.get(), start + row, field_number);
+        const int length =
+            PQgetlength(result_.get(), start + row, field_number);
+        TF_RETURN_IF_ERROR(SqlDataCopy(field_type, data, length, row, value));
+      }
     }
     return OkStatus();
   }
   string DebugString() const override { return "SqlIterableResource"; }
 
  private:
+  Status Exec(const string& command) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::unique_ptr<PGresult, void (*)(PGresult*)> result(
+        PQexec(conn_.get(), command.c_str()), PQclear);
+    if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+      return errors::InvalidArgument("Exec of ", command, " failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+    return OkStatus();
+  }
+  Status DeclareCursor() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return Exec(strings::StrCat("DECLARE ", kCursorName,
+                                " NO SCROLL CURSOR FOR ", query_));
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<PGconn, void (*)(PGconn*)> conn_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<PGconn> conn_ TF_GUARDED_BY(mu_);
   std::unique_ptr<PGresult, void (*)(PGresult*)> result_ TF_GUARDED_BY(mu_);
   int64 count_ TF_GUARDED_BY(mu_);
   std::vector<string> fields_ TF_GUARDED_BY(mu_);
   std::vector<DataType> dtypes_ TF_GUARDED_BY(mu_);
+  int64 batch_size_ TF_GUARDED_BY(mu_) = 0;
+  string query_ TF_GUARDED_BY(mu_);
+  int64 next_batch_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// Appends `length` bytes of `value` in network byte order to `buffer`.
+void SqlAppendNetwork(uint64 value, int length, string* buffer) {
+  for (int i = length - 1; i >= 0; i--) {
+    buffer->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// Appends the element `index` of `column` to a binary COPY tuple, as the
+// length of its binary format followed by its data.
+Status SqlAppendField(const Tensor& column, int64 index, string* buffer) {
+  switch (column.dtype()) {
+    case DT_BOOL:
+      SqlAppendNetwork(1, 4, buffer);
+      buffer->push_back(column.flat<bool>()(index) ? 1 : 0);
+      break;
+    case DT_INT32:
+      SqlAppendNetwork(4, 4, buffer);
+      SqlAppendNetwork(static_cast<uint32>(column.flat<int32>()(index)), 4,
+                       buffer);
+      break;
+    case DT_INT64:
+      SqlAppendNetwork(8, 4, buffer);
+      SqlAppendNetwork(static_cast<uint64>(column.flat<int64>()(index)), 8,
+                       buffer);
+      break;
+    case DT_FLOAT: {
+      uint32 bits;
+      std::memcpy(&bits, &column.flat<float>()(index), sizeof(bits));
+      SqlAppendNetwork(4, 4, buffer);
+      SqlAppendNetwork(bits, 4, buffer);
+    } break;
+    case DT_DOUBLE: {
+      uint64 bits;
+      std::memcpy(&bits, &column.flat<double>()(index), sizeof(bits));
+      SqlAppendNetwork(8, 4, buffer);
+      SqlAppendNetwork(bits, 8, buffer);
+    } break;
+    case DT_STRING: {
+      // The binary format of text is its bytes.
+      const tstring& value = column.flat<tstring>()(index);
+      SqlAppendNetwork(value.size(), 4, buffer);
+      buffer->append(value.data(), value.size());
+    } break;
+    default:
+      return errors::InvalidArgument("data type ",
+                                     DataTypeString(column.dtype()),
+                                     " not supported");
+  }
+  return OkStatus();
+}
+
+// Writes rows to a table with COPY FROM STDIN in the binary format, so that
+// a batch of rows is streamed in one statement without any text formatting.
+// The columns of the table have to be of the binary formats of the data
+// types, i.e. bool, int, bigint, real, double precision and text.
+class SqlWritableResource : public ResourceBase {
+ public:
+  SqlWritableResource(Env* env)
+      : env_(env) {}
+  ~SqlWritableResource() {}
+
+  Status Init(const string& endpoint, const string& table) {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(SqlAcquireConnection(endpoint, &conn_));
+    table_ = table;
+    return OkStatus();
+  }
+
+  Status Write(const Tensor& names, const OpInputList& columns) {
+    mutex_lock l(mu_);
+    if (names.NumElements() != columns.size() || columns.size() == 0) {
+      return errors::InvalidArgument("got ", names.NumElements(),
+                                     " names for ", columns.size(),
+                                     " columns");
+    }
+    const int64 num_rows = columns[0].NumElements();
+    for (int i = 0; i < columns.size(); i++) {
+      if (columns[i].NumElements() != num_rows) {
+        return errors::InvalidArgument("column ", names.flat<tstring>()(i),
+                                       " has ", columns[i].NumElements(),
+                                       " rows, expected ", num_rows);
+      }
+    }
+
+    string command = strings::StrCat("COPY ", table_, " (");
+    for (int64 i = 0; i < names.NumElements(); i++) {
+      const tstring& name = names.flat<tstring>()(i);
+      char* identifier =
+          PQescapeIdentifier(conn_.get(), name.data(), name.size());
+      if (identifier == nullptr) {
+        return errors::InvalidArgument("Invalid column name ", name, ": ",
+                                       PQerrorMessage(conn_.get()));
+      }
+      strings::StrAppend(&command, (i == 0 ? "" : ", "), identifier);
+      PQfreemem(identifier);
+    }
+    strings::StrAppend(&command, ") FROM STDIN (FORMAT binary)");
+
+    std::unique_ptr<PGresult, void (*)(PGresult*)> result(
+        PQexec(conn_.get(), command.c_str()), PQclear);
+    if (PQresultStatus(result.get()) != PGRES_COPY_IN) {
+      return errors::InvalidArgument("Exec of ", command, " failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+
+    // The header is the signature, the flags and the length of the header
+    // extension, and the trailer a field count of -1.
+    string buffer("PGCOPY\n\377\r\n\0", 11);
+    SqlAppendNetwork(0, 4, &buffer);
+    SqlAppendNetwork(0, 4, &buffer);
+    Status status;
+    for (int64 row = 0; row < num_rows && status.ok(); row++) {
+      SqlAppendNetwork(columns.size(), 2, &buffer);
+      for (int i = 0; i < columns.size() && status.ok(); i++) {
+        status = SqlAppendField(columns[i], row, &buffer);
+      }
+      if (status.ok() &&
+          (buffer.size() >= kCopyBufferSize || row + 1 == num_rows)) {
+        status = PutCopyData(&buffer);
+      }
+    }
+    if (status.ok()) {
+      SqlAppendNetwork(0xFFFF, 2, &buffer);
+      status = PutCopyData(&buffer);
+    }
+    // A failed copy is ended with an error message, so that nothing of it is
+    // written.
+    const string error = status.ToString();
+    if (PQputCopyEnd(conn_.get(), status.ok() ? nullptr : error.c_str()) !=
+        1) {
+      return errors::InvalidArgument("End of copy failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+    while (true) {
+      result.reset(PQgetResult(conn_.get()));
+      if (result == nullptr) {
+        break;
+      }
+      if (status.ok() && PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+        status = errors::InvalidArgument("Copy failed: ",
+                                         PQerrorMessage(conn_.get()));
+      }
+    }
+    return status;
+  }
+
+  string DebugString() const override { return "SqlWritableResource"; }
+
+ private:
+  Status PutCopyData(string* buffer) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (PQputCopyData(conn_.get(), buffer->data(), buffer->size()) != 1) {
+      return errors::InvalidArgument("Copy of data failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+    buffer->clear();
+    return OkStatus();
+  }
+
+  // The number of bytes of rows that are sent in one message.
+  static constexpr size_t kCopyBufferSize = 1 << 20;
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<PGconn> conn_ TF_GUARDED_BY(mu_);
+  string table_ TF_GUARDED_BY(mu_);
 };
 
 class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
@@ -157,6 +452,7 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
   explicit SqlIterableInitOp(OpKernelConstruction* context)
       : ResourceOpKernel<SqlIterableResource>(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("batch_size", &batch_size_));
   }
 
  private:
@@ -174,8 +470,8 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
     int64 count;
     std::vector<string> fields;
     std::vector<DataType> dtypes;
-    OP_REQUIRES_OK(context,
-                   resource_->Init(input, endpoint, &count, &fields, &dtypes));
+    OP_REQUIRES_OK(context, resource_->Init(input, endpoint, batch_size_,
+                                            &count, &fields, &dtypes));
 
     Tensor* count_tensor;
     OP_REQUIRES_OK(context,
@@ -208,6 +504,7 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  int64 batch_size_;
 };
 
 class SqlIterableReadOp : public OpKernel {
@@ -233,10 +530,10 @@ class SqlIterableReadOp : public OpKernel {
     OP_REQUIRES_OK(
         context,
         resource->Read(index, field_tensor,
-                       [&](const int64 field_index, Tensor** value) -> Status {
-                         TF_RETURN_IF_ERROR(context->allocate_output(
-                             field_index, TensorShape({1}), value));
-                         return OkStatus();
+                       [&](const int64 field_index, const TensorShape& shape,
+                           Tensor** value) -> Status {
+                         return context->allocate_output(field_index, shape,
+                                                         value);
                        }));
   }
 
@@ -245,10 +542,67 @@ class SqlIterableReadOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+class SqlWritableInitOp : public ResourceOpKernel<SqlWritableResource> {
+ public:
+  explicit SqlWritableInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<SqlWritableResource>(context) {
+    env_ = context->env();
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<SqlWritableResource>::Compute(context);
+
+    const Tensor* endpoint_tensor;
+    OP_REQUIRES_OK(context, context->input("endpoint", &endpoint_tensor));
+    const string& endpoint = endpoint_tensor->scalar<tstring>()();
+
+    const Tensor* table_tensor;
+    OP_REQUIRES_OK(context, context->input("table", &table_tensor));
+    const string& table = table_tensor->scalar<tstring>()();
+
+    OP_REQUIRES_OK(context, resource_->Init(endpoint, table));
+  }
+  Status CreateResource(SqlWritableResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new SqlWritableResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class SqlWritableWriteOp : public OpKernel {
+ public:
+  explicit SqlWritableWriteOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    SqlWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "resource", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* names_tensor;
+    OP_REQUIRES_OK(context, context->input("names", &names_tensor));
+
+    OpInputList columns;
+    OP_REQUIRES_OK(context, context->input_list("columns", &columns));
+
+    OP_REQUIRES_OK(context, resource->Write(*names_tensor, columns));
+  }
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>SqlIterableInit").Device(DEVICE_CPU),
                         SqlIterableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>SqlIterableRead").Device(DEVICE_CPU),
                         SqlIterableReadOp);
+REGISTER_KERNEL_BUILDER(Name("IO>SqlWritableInit").Device(DEVICE_CPU),
+                        SqlWritableInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>SqlWritableWrite").Device(DEVICE_CPU),
+                        SqlWritableWriteOp);
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -14,7 +14,8 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/op_kernel.h"
-#include "tensorflow/core/lib/io/buffered_inputstream.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 #if defined(_MSC_VER)
 #include <io.h>
@@ -78,6 +79,79 @@ class FilenoInputStream : public io::InputStreamInterface {
   bool final_ = false;
 };
 
+// Returns the position of the first '\n' in [begin, end) of `data`, or `end`
+// if there is none. memchr is vectorized by the C library.
+size_t FindNewline(const char* data, size_t begin, size_t end) {
+  if (begin >= end) {
+    return end;
+  }
+  const void* p = memchr(data + begin, '\n', end - begin);
+  return p == nullptr ? end : static_cast<const char*>(p) - data;
+}
+
+// Writes the lines of `text`, which starts at the start of a line and ends at
+// the end of a line, to the output. The text is split at line boundaries
+// across the worker threads, which find the lines of their part and then
+// write them into the output.
+Status WriteLines(OpKernelContext* context, StringPiece text) {
+  static constexpr int64 kMinShardBytes = 1 << 20;
+  const DeviceBase::CpuWorkerThreads* worker_threads =
+      context->device()->tensorflow_cpu_worker_threads();
+  const int64 shards = std::max<int64>(
+      1, std::min<int64>(worker_threads->num_threads,
+                         text.size() / kMinShardBytes));
+
+  const char* data = text.data();
+  const size_t size = text.size();
+  std::vector<size_t> boundaries(shards + 1, size);
+  boundaries[0] = 0;
+  for (int64 i = 1; i < shards; i++) {
+    const size_t p = std::max(boundaries[i - 1], size * i / shards);
+    // The line boundary at or after p.
+    const size_t newline = FindNewline(data, p - 1, size);
+    boundaries[i] = newline < size ? newline + 1 : size;
+  }
+
+  // Each unit of work is one shard, so the cost keeps them on their own
+  // threads.
+  const int64 cost = kMinShardBytes;
+  std::vector<std::vector<StringPiece>> lines(shards);
+  Shard(worker_threads->num_threads, worker_threads->workers, shards, cost,
+        [&](int64 begin, int64 end) {
+          for (int64 i = begin; i < end; i++) {
+            size_t p = boundaries[i];
+            while (p < boundaries[i + 1]) {
+              const size_t newline = FindNewline(data, p, boundaries[i + 1]);
+              size_t length = newline - p;
+              if (length > 0 && data[newline - 1] == '\r') {
+                length--;
+              }
+              lines[i].emplace_back(data + p, length);
+              p = newline + 1;
+            }
+          }
+        });
+
+  std::vector<int64> starts(shards + 1, 0);
+  for (int64 i = 0; i < shards; i++) {
+    starts[i + 1] = starts[i] + lines[i].size();
+  }
+  Tensor* output_tensor;
+  TF_RETURN_IF_ERROR(context->allocate_output(0, TensorShape({starts[shards]}),
+                                              &output_tensor));
+  auto output = output_tensor->flat<tstring>();
+  Shard(worker_threads->num_threads, worker_threads->workers, shards, cost,
+        [&](int64 begin, int64 end) {
+          for (int64 i = begin; i < end; i++) {
+            for (size_t k = 0; k < lines[i].size(); k++) {
+              output(starts[i] + k).assign(lines[i][k].data(),
+                                           lines[i][k].size());
+            }
+          }
+        });
+  return OkStatus();
+}
+
 class ReadTextOp : public OpKernel {
  public:
   explicit ReadTextOp(OpKernelConstruction* context) : OpKernel(context) {
@@ -97,82 +171,120 @@ class ReadTextOp : public OpKernel {
     const Tensor& length_tensor = context->input(3);
     int64 length = length_tensor.scalar<int64>()();
 
-    std::vector<string> lines;
-
     if (filename == "file://-" || filename == "file://0") {
-      // If we read from stdin then let's read until EOF is reached
-      // Note: It is possible to read data in large slices. However,
-      // BufferedInputStream takes a cached buffer which complicates
-      // the data read from stream. Will need to implement a no-cache
-      // version of ReadLine() in order to read chunks.
-      std::unique_ptr<FilenoInputStream> input_stream(
-          new FilenoInputStream(STDIN_FILENO));
-      std::unique_ptr<tensorflow::io::BufferedInputStream> stream(
-          new tensorflow::io::BufferedInputStream(input_stream.get(), 4096));
-
+      // If we read from stdin then let's read until EOF is reached, in large
+      // blocks as the lines are only split once all of the input is read.
+      FilenoInputStream stream(STDIN_FILENO);
+      string data;
       Status status = OkStatus();
       while (status.ok()) {
-        string line;
-        status = stream->ReadLine(&line);
+        tstring block;
+        status = stream.ReadNBytes(kBlockBytes, &block);
         OP_REQUIRES(context, (status.ok() || errors::IsOutOfRange(status)),
                     status);
-        if (!status.ok()) {
-          break;
-        }
-        lines.emplace_back(line);
-      }
-    } else {
-      std::unique_ptr<SizedRandomAccessFile> file(new SizedRandomAccessFile(
-          env_, filename, memory.data(), memory.size()));
-      uint64 size;
-      OP_REQUIRES_OK(context, file->GetFileSize(&size));
-      if (length < 0) {
-        length = size;
+        data.append(block.data(), block.size());
       }
+      OP_REQUIRES_OK(context, WriteLines(context, data));
+      return;
+    }
 
-      // This ReadText is a splittable version so that it is possible to read
-      // Text from a chunk of a file, much like Hadoop. We use the following
-      // method to decide if a line belongs to the chunk or not: 1) offset = 0:
-      // read lines and stop after length is reached. 2) offset > 0: back off 1
-      // and skip one line to start with the next line, stop after length is
-      // reached.
-      //
-      // Note: We use BufferedInputStream which is only able to process
-      // separator of "\n", though it could be expanded to more than "\n" in the
-      // future.
-
-      std::unique_ptr<tensorflow::io::BufferedInputStream> stream(
-          new tensorflow::io::BufferedInputStream(file.get(), 65536));
-      if (offset > 0) {
-        OP_REQUIRES_OK(context, stream->SkipNBytes(offset - 1));
-        string line;
-        OP_REQUIRES_OK(context, stream->ReadLine(&line));
+    // This ReadText is a splittable version so that it is possible to read
+    // Text from a chunk of a file, much like Hadoop. A line belongs to the
+    // chunk if it starts within [offset, offset + length), that is, with
+    // offset > 0 the line that contains offset - 1 is skipped.
+    //
+    // Note: Only the separator of "\n" is processed, with an optional "\r"
+    // before it, though it could be expanded in the future.
+    StringPiece data;
+    uint64 base = 0;
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    string buffer;
+    uint64 size;
+    if (!memory.empty()) {
+      data = memory;
+      size = memory.size();
+    } else {
+      OP_REQUIRES_OK(context, env_->GetFileSize(filename, &size));
+      // Local files are memory mapped rather than read.
+      StringPiece scheme, host, path;
+      io::ParseURI(filename, &scheme, &host, &path);
+      if ((scheme.empty() || scheme == "file") && size > 0 &&
+          env_->NewReadOnlyMemoryRegionFromFile(filename, &region).ok()) {
+        data = StringPiece(static_cast<const char*>(region->data()),
+                           region->length());
+        size = region->length();
       }
+    }
+    if (length < 0 || offset + length > size) {
+      length = size > offset ? size - offset : 0;
+    }
+    const uint64 limit = offset + length;
+    if (length == 0) {
+      OP_REQUIRES_OK(context, WriteLines(context, StringPiece()));
+      return;
+    }
 
-      while (stream->Tell() < offset + length) {
-        string line;
-        Status status = stream->ReadLine(&line);
-        OP_REQUIRES(context, (status.ok() || errors::IsOutOfRange(status)),
-                    status);
-        if (!status.ok()) {
-          break;
-        }
-        lines.emplace_back(line);
+    if (data.data() == nullptr) {
+      // Read the chunk in one block, then in smaller blocks until the end of
+      // the last line of the chunk.
+      std::unique_ptr<tensorflow::RandomAccessFile> file;
+      OP_REQUIRES_OK(context, env_->NewRandomAccessFile(filename, &file));
+      base = offset > 0 ? offset - 1 : 0;
+      uint64 end = limit;
+      buffer.resize(end - base);
+      OP_REQUIRES_OK(context,
+                     ReadRange(file.get(), base, end - base, &buffer[0]));
+      size_t newline = buffer.find('\n', limit - 1 - base);
+      while (newline == string::npos && end < size) {
+        const uint64 n = std::min<uint64>(kLineScanBytes, size - end);
+        buffer.resize(end - base + n);
+        OP_REQUIRES_OK(context,
+                       ReadRange(file.get(), end, n, &buffer[end - base]));
+        newline = buffer.find('\n', end - base);
+        end += n;
       }
+      data = buffer;
     }
 
-    TensorShape output_shape({static_cast<int64>(lines.size())});
-
-    Tensor* output_tensor;
+    // Positions relative to data, which starts at base of the file.
+    const char* p = data.data();
+    const size_t count = data.size();
+    size_t begin = 0;
+    if (offset > 0) {
+      begin = FindNewline(p, offset - 1 - base, count);
+      begin = begin < count ? begin + 1 : count;
+    }
+    if (begin >= limit - base) {
+      OP_REQUIRES_OK(context, WriteLines(context, StringPiece()));
+      return;
+    }
+    size_t end = FindNewline(p, limit - 1 - base, count);
+    end = end < count ? end + 1 : count;
     OP_REQUIRES_OK(context,
-                   context->allocate_output(0, output_shape, &output_tensor));
+                   WriteLines(context, StringPiece(p + begin, end - begin)));
+  }
 
-    for (size_t i = 0; i < lines.size(); i++) {
-      output_tensor->flat<tstring>()(i) = std::move(lines[i]);
+ private:
+  // Reads n bytes at offset of the file into scratch.
+  static Status ReadRange(tensorflow::RandomAccessFile* file, uint64 offset,
+                          size_t n, char* scratch) {
+    StringPiece result;
+    Status status = file->Read(offset, n, &result, scratch);
+    if (!(status.ok() || errors::IsOutOfRange(status))) {
+      return status;
+    }
+    if (result.size() != n) {
+      return errors::DataLoss("unable to read ", n, " bytes at ", offset);
+    }
+    if (result.data() != scratch) {
+      memcpy(scratch, result.data(), n);
     }
+    return OkStatus();
   }
 
- private:
+  static constexpr int64 kBlockBytes = 4 << 20;
+  static constexpr int64 kLineScanBytes = 65536;
+
   mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
 };
@@ -12,24 +12,39 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// The estimated cost of matching one element, so that small inputs are
+// matched on the calling thread.
+static constexpr int64 kCostPerElement = 1000;
+
 class RE2FullMatchOp : public OpKernel {
  public:
   explicit RE2FullMatchOp(OpKernelConstruction* context) : OpKernel(context) {
     OP_REQUIRES_OK(context, context->GetAttr("pattern", &pattern_));
+    // RE2 objects are thread-safe once compiled, so the pattern is compiled
+    // once for all the invocations and the threads matching.
+    re_.reset(new RE2(pattern_, RE2::Quiet));
+    OP_REQUIRES(context, re_->ok(),
+                errors::InvalidArgument("unable to compile pattern '", pattern_,
+                                        "': ", re_->error()));
   }
 
   void Compute(OpKernelContext* context) override {
-    RE2 re(pattern_, RE2::Quiet);
-    OP_REQUIRES(context, re.ok(),
-                errors::InvalidArgument("unable to compile pattern '", pattern_,
-                                        "': ", re.error()));
+    const RE2& re = *re_;
+    const int num_groups = re.NumberOfCapturingGroups();
 
     const Tensor& input_tensor = context->input(0);
     TensorShape shape = input_tensor.shape();
@@ -37,36 +52,120 @@ class RE2FullMatchOp : public OpKernel {
     Tensor* output_tensor;
     OP_REQUIRES_OK(context, context->allocate_output(0, shape, &output_tensor));
 
-    shape.AddDim(re.NumberOfCapturingGroups());
+    shape.AddDim(num_groups);
     Tensor* groups_tensor;
     OP_REQUIRES_OK(context, context->allocate_output(1, shape, &groups_tensor));
 
-    for (int64 i = 0; i < input_tensor.NumElements(); i++) {
-      std::vector<RE2::Arg> args(re.NumberOfCapturingGroups());
-      std::vector<RE2::Arg*> argv(re.NumberOfCapturingGroups());
-      std::vector<string> results(re.NumberOfCapturingGroups());
-      for (int j = 0; j < re.NumberOfCapturingGroups(); j++) {
+    auto input = input_tensor.flat<tstring>();
+    auto output = output_tensor->flat<bool>();
+    auto groups = groups_tensor->flat<tstring>();
+    auto match = [&](int64 begin, int64 end) {
+      std::vector<re2::StringPiece> results(num_groups);
+      std::vector<RE2::Arg> args(num_groups);
+      std::vector<RE2::Arg*> argv(num_groups);
+      for (int j = 0; j < num_groups; j++) {
         args[j] = &results[j];
         argv[j] = &args[j];
       }
-      string input_string = input_tensor.flat<tstring>()(i);
-      output_tensor->flat<bool>()(i) = RE2::FullMatchN(
-          input_string, re, argv.data(), re.NumberOfCapturingGroups());
-      if (output_tensor->flat<bool>()(i)) {
-        for (int j = 0; j < re.NumberOfCapturingGroups(); j++) {
-          groups_tensor->flat<tstring>()(i * re.NumberOfCapturingGroups() + j) =
-              std::move(results[j]);
+      for (int64 i = begin; i < end; i++) {
+        re2::StringPiece input_string(input(i).data(), input(i).size());
+        output(i) = RE2::FullMatchN(input_string, re, argv.data(), num_groups);
+        if (output(i)) {
+          for (int j = 0; j < num_groups; j++) {
+            groups(i * num_groups + j).assign(results[j].data(),
+                                              results[j].size());
+          }
         }
       }
-    }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          input_tensor.NumElements(), kCostPerElement, match);
   }
 
  private:
   string pattern_;
+  std::unique_ptr<RE2> re_;
+};
+
+// Matches every element against all the patterns in one scan, and returns
+// the ids, in increasing order, of the patterns that fully match each of
+// them as the values and row splits of a ragged tensor.
+class RE2FullMatchSetOp : public OpKernel {
+ public:
+  explicit RE2FullMatchSetOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<string> patterns;
+    OP_REQUIRES_OK(context, context->GetAttr("patterns", &patterns));
+    RE2::Options options;
+    options.set_log_errors(false);
+    set_.reset(new RE2::Set(options, RE2::ANCHOR_BOTH));
+    for (const string& pattern : patterns) {
+      string error;
+      OP_REQUIRES(context, set_->Add(pattern, &error) >= 0,
+                  errors::InvalidArgument("unable to compile pattern '",
+                                          pattern, "': ", error));
+    }
+    OP_REQUIRES(context, set_->Compile(),
+                errors::ResourceExhausted(
+                    "unable to compile ", patterns.size(),
+                    " patterns within the memory budget of RE2"));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input_tensor = context->input(0);
+    auto input = input_tensor.flat<tstring>();
+    const int64 num_elements = input.size();
+
+    // The ids matched are gathered per element, so that the threads only
+    // write their own elements, then laid out once their counts are known.
+    std::vector<std::vector<int>> matches(num_elements);
+    std::atomic<bool> failed(false);
+    auto match = [&](int64 begin, int64 end) {
+      for (int64 i = begin; i < end; i++) {
+        re2::StringPiece input_string(input(i).data(), input(i).size());
+        RE2::Set::ErrorInfo error;
+        if (!set_->Match(input_string, &matches[i], &error) &&
+            error.kind != RE2::Set::kNoError) {
+          failed = true;
+          return;
+        }
+        std::sort(matches[i].begin(), matches[i].end());
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_elements,
+          kCostPerElement, match);
+    OP_REQUIRES(context, !failed,
+                errors::ResourceExhausted(
+                    "RE2 ran out of memory matching the patterns"));
+
+    Tensor* splits_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(1, {num_elements + 1},
+                                                     &splits_tensor));
+    auto splits = splits_tensor->flat<int64>();
+    splits(0) = 0;
+    for (int64 i = 0; i < num_elements; i++) {
+      splits(i + 1) = splits(i) + matches[i].size();
+    }
+    Tensor* ids_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, {splits(num_elements)}, &ids_tensor));
+    auto ids = ids_tensor->flat<int32>();
+    for (int64 i = 0; i < num_elements; i++) {
+      std::copy(matches[i].begin(), matches[i].end(),
+                ids.data() + splits(i));
+    }
+  }
+
+ private:
+  std::unique_ptr<RE2::Set> set_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>RE2FullMatch").Device(DEVICE_CPU),
                         RE2FullMatchOp);
+REGISTER_KERNEL_BUILDER(Name("IO>RE2FullMatchSet").Device(DEVICE_CPU),
+                        RE2FullMatchSetOp);
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
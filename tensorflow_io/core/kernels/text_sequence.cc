@@ -13,8 +13,6 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include <deque>
-
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
 #include "tensorflow/core/public/version.h"
@@ -22,22 +20,35 @@ limitations under the License.
 
 namespace tensorflow {
 
+// Keeps the destination open for as long as the sequence lives, and writes
+// the lines through a buffer that is appended to the file once it reaches
+// kBufferBytes, or on Flush.
 class TextOutputSequence : public OutputSequence {
  public:
   TextOutputSequence(Env* env) : OutputSequence(env) {}
 
-  virtual ~TextOutputSequence() override {}
+  virtual ~TextOutputSequence() override {
+    Status status = Close();
+    if (!status.ok()) {
+      LOG(ERROR) << "unable to close " << DebugString() << ": " << status;
+    }
+  }
+  virtual Status Flush() override {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(Write());
+    if (file_.get() != nullptr) {
+      TF_RETURN_IF_ERROR(file_->Flush());
+    }
+    return OkStatus();
+  }
   virtual Status Output() override {
-    if (fifo_.front().get() != nullptr) {
-      std::unique_ptr<WritableFile> file;
-      TF_RETURN_IF_ERROR(env_->NewAppendableFile(destination_[0], &file));
-      while (fifo_.size() != 0 && fifo_.front().get() != nullptr) {
-        TF_RETURN_IF_ERROR(
-            file->Append(strings::StrCat(fifo_.front().get()->c_str(), "\n")));
-        fifo_.pop_front();
-        base_++;
-      }
-      TF_RETURN_IF_ERROR(file->Close());
+    while (HasFront()) {
+      buffer_.append(Front());
+      buffer_.push_back('\n');
+      PopFront();
+    }
+    if (buffer_.size() >= kBufferBytes) {
+      TF_RETURN_IF_ERROR(Write());
     }
     return OkStatus();
   }
@@ -54,11 +65,38 @@ class TextOutputSequence : public OutputSequence {
       return errors::Unimplemented("only one file is supported: ",
                                    destination_.size());
     }
+    buffer_.reserve(kBufferBytes);
     return OkStatus();
   }
 
  private:
+  // Appends the buffered lines to the file, which is opened on first use.
+  Status Write() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (buffer_.empty()) {
+      return OkStatus();
+    }
+    if (file_.get() == nullptr) {
+      TF_RETURN_IF_ERROR(env_->NewAppendableFile(destination_[0], &file_));
+    }
+    TF_RETURN_IF_ERROR(file_->Append(buffer_));
+    buffer_.clear();
+    return OkStatus();
+  }
+  Status Close() {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(Write());
+    if (file_.get() != nullptr) {
+      TF_RETURN_IF_ERROR(file_->Close());
+      file_.reset(nullptr);
+    }
+    return OkStatus();
+  }
+
+  static constexpr size_t kBufferBytes = 4 << 20;
+
   std::vector<string> destination_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> file_ TF_GUARDED_BY(mu_);
+  string buffer_ TF_GUARDED_BY(mu_);
 };
 
 class TextOutputSequenceOp : public OutputSequenceOp<TextOutputSequence> {
@@ -91,5 +129,7 @@ REGISTER_KERNEL_BUILDER(Name("IO>TextOutputSequence").Device(DEVICE_CPU),
 
 REGISTER_KERNEL_BUILDER(Name("IO>TextOutputSequenceSetItem").Device(DEVICE_CPU),
                         OutputSequenceSetItemOp<TextOutputSequence>);
+REGISTER_KERNEL_BUILDER(Name("IO>TextOutputSequenceFlush").Device(DEVICE_CPU),
+                        OutputSequenceFlushOp<TextOutputSequence>);
 
 }  // namespace tensorflow
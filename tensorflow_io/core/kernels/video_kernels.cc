@@ -98,11 +98,11 @@ class VideoCaptureReadableResource : public ResourceBase {
     Tensor* value_tensor;
     TF_RETURN_IF_ERROR(allocate_func(TensorShape({1}), &value_tensor));
 
-    string buffer;
-    buffer.resize(bytes_);
-    VideoCaptureNextFunction(context_.get(), (void*)&buffer[0],
+    // The frame is captured straight into the output.
+    tstring& value = value_tensor->flat<tstring>()(0);
+    value.resize_uninitialized(bytes_);
+    VideoCaptureNextFunction(context_.get(), value.mdata(),
                              static_cast<int64_t>(bytes_));
-    value_tensor->flat<tstring>()(0) = buffer;
 
     return OkStatus();
   }
@@ -21,6 +21,7 @@ limitations under the License.
 #include <fcntl.h>
 #include <linux/videodev2.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -51,7 +52,15 @@ class VideoCaptureContext {
             close(*p);
           }
         }) {}
-  ~VideoCaptureContext() {}
+  ~VideoCaptureContext() {
+    if (streaming_) {
+      enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      xioctl(fd_, VIDIOC_STREAMOFF, &type);
+    }
+    for (size_t i = 0; i < buffers_.size(); i++) {
+      munmap(buffers_[i].first, buffers_[i].second);
+    }
+  }
 
   Status Init(const string& device, int64_t* bytes, int64_t* width,
               int64_t* height) {
@@ -89,8 +98,10 @@ class VideoCaptureContext {
       return errors::InvalidArgument(devname, " is no video capture device");
     }
 
-    if (!(cap.capabilities & V4L2_CAP_READWRITE)) {
-      return errors::InvalidArgument(devname, " does not support read i/o");
+    if (!(cap.capabilities & V4L2_CAP_STREAMING) &&
+        !(cap.capabilities & V4L2_CAP_READWRITE)) {
+      return errors::InvalidArgument(devname,
+                                     " does not support streaming or read i/o");
     }
 
     struct v4l2_format fmt;
@@ -120,6 +131,14 @@ class VideoCaptureContext {
           fmt.fmt.pix.pixelformat);
     }
 
+    if (cap.capabilities & V4L2_CAP_STREAMING) {
+      TF_RETURN_IF_ERROR(InitStreaming());
+    }
+    if (!streaming_ && !(cap.capabilities & V4L2_CAP_READWRITE)) {
+      return errors::InvalidArgument(devname,
+                                     " does not support mmap or read i/o");
+    }
+
     *bytes = fmt.fmt.pix.sizeimage;
     *width = fmt.fmt.pix.width;
     *height = fmt.fmt.pix.height;
@@ -151,6 +170,15 @@ class VideoCaptureContext {
         return errors::InvalidArgument("select timeout");
       }
 
+      if (streaming_) {
+        bool dequeued = false;
+        TF_RETURN_IF_ERROR(Dequeue(data, size, &dequeued));
+        if (!dequeued) {
+          continue;
+        }
+        break;
+      }
+
       if (-1 == read(fd_, data, size)) {
         if (EAGAIN == errno) {
           /* EAGAIN - continue select loop. */
@@ -170,12 +198,99 @@ class VideoCaptureContext {
   }
 
  protected:
+  // Maps a ring of driver buffers and starts streaming into them, so that
+  // reads take filled buffers instead of a read() call copying the frame
+  // through the kernel. Leaves the device in read i/o when the driver has
+  // no mmap buffers.
+  Status InitStreaming() {
+    struct v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = kBufferCount;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (-1 == xioctl(fd_, VIDIOC_REQBUFS, &req)) {
+      if (EINVAL == errno) {
+        return OkStatus();
+      }
+      return errors::InvalidArgument("cannot VIDIOC_REQBUFS '", device_,
+                                     "': ", errno, ", ", strerror(errno));
+    }
+    if (req.count < 2) {
+      return errors::InvalidArgument("insufficient buffer memory on '",
+                                     device_, "'");
+    }
+    for (unsigned int i = 0; i < req.count; i++) {
+      struct v4l2_buffer buf;
+      memset(&buf, 0, sizeof(buf));
+      buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      buf.memory = V4L2_MEMORY_MMAP;
+      buf.index = i;
+      if (-1 == xioctl(fd_, VIDIOC_QUERYBUF, &buf)) {
+        return errors::InvalidArgument("cannot VIDIOC_QUERYBUF '", device_,
+                                       "': ", errno, ", ", strerror(errno));
+      }
+      void* start = mmap(NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd_, buf.m.offset);
+      if (MAP_FAILED == start) {
+        return errors::InvalidArgument("cannot mmap '", device_, "': ", errno,
+                                       ", ", strerror(errno));
+      }
+      buffers_.emplace_back(start, buf.length);
+      if (-1 == xioctl(fd_, VIDIOC_QBUF, &buf)) {
+        return errors::InvalidArgument("cannot VIDIOC_QBUF '", device_,
+                                       "': ", errno, ", ", strerror(errno));
+      }
+    }
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (-1 == xioctl(fd_, VIDIOC_STREAMON, &type)) {
+      return errors::InvalidArgument("cannot VIDIOC_STREAMON '", device_,
+                                     "': ", errno, ", ", strerror(errno));
+    }
+    streaming_ = true;
+    return OkStatus();
+  }
+  // Copies the oldest filled buffer to `data` and hands it back to the
+  // driver right away, so that the ring keeps filling while the frame is
+  // processed.
+  Status Dequeue(void* data, size_t size, bool* dequeued) {
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (-1 == xioctl(fd_, VIDIOC_DQBUF, &buf)) {
+      if (EAGAIN == errno) {
+        *dequeued = false;
+        return OkStatus();
+      }
+      return errors::InvalidArgument("cannot VIDIOC_DQBUF: ", errno, ", ",
+                                     strerror(errno));
+    }
+    if (buf.index >= buffers_.size()) {
+      return errors::Internal("invalid buffer index ", buf.index);
+    }
+    size_t copied = std::min<size_t>(size, buf.bytesused);
+    memcpy(data, buffers_[buf.index].first, copied);
+    if (copied < size) {
+      memset(static_cast<char*>(data) + copied, 0, size - copied);
+    }
+    if (-1 == xioctl(fd_, VIDIOC_QBUF, &buf)) {
+      return errors::InvalidArgument("cannot VIDIOC_QBUF: ", errno, ", ",
+                                     strerror(errno));
+    }
+    *dequeued = true;
+    return OkStatus();
+  }
+
+  static constexpr unsigned int kBufferCount = 4;
+
   mutable mutex mu_;
 
   std::unique_ptr<void, void (*)(void*)> context_;
   std::unique_ptr<int, void (*)(int*)> fd_scope_;
   string device_;
   int fd_;
+  bool streaming_ = false;
+  std::vector<std::pair<void*, size_t>> buffers_;
 };
 
 }  // namespace data
@@ -28,6 +28,12 @@ REGISTER_OP("IO>ArrowZeroCopyDataset")
     .Output("handle: variant")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("read_ahead_batches: int = 0")
+    .Attr("read_ahead_bytes: int = 0")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape)
     .Doc(R"doc(
@@ -46,6 +52,12 @@ REGISTER_OP("IO>ArrowSerializedDataset")
     .Output("handle: variant")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("read_ahead_batches: int = 0")
+    .Attr("read_ahead_bytes: int = 0")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape)
     .Doc(R"doc(
@@ -62,6 +74,11 @@ REGISTER_OP("IO>ArrowFeatherDataset")
     .Output("handle: variant")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("memory_map: bool = false")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape)
     .Doc(R"doc(
@@ -78,6 +95,12 @@ REGISTER_OP("IO>ArrowStreamDataset")
     .Output("handle: variant")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("read_ahead_batches: int = 0")
+    .Attr("read_ahead_bytes: int = 0")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape)
     .Doc(R"doc(
@@ -86,6 +109,116 @@ Creates a dataset that connects to a host serving Arrow RecordBatches in stream
 endpoints: One or more host addresses that are serving an Arrow stream.
 )doc");
 
+REGISTER_OP("IO>ArrowFlightDataset")
+    .Input("location: string")
+    .Input("descriptor: string")
+    .Input("descriptor_type: string")
+    .Input("columns: int32")
+    .Input("batch_size: int64")
+    .Input("batch_mode: string")
+    .Output("handle: variant")
+    .Attr("output_types: list(type) >= 1")
+    .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("num_parallel_endpoints: int = 1")
+    .Attr("num_shards: int = 1")
+    .Attr("shard_index: int = 0")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape)
+    .Doc(R"doc(
+Creates a dataset that reads the endpoints of an Arrow Flight.
+
+location: URI of the Flight service to get the FlightInfo from.
+descriptor: Command, or path components of the Flight descriptor.
+descriptor_type: Type of the descriptor, either "cmd" or "path".
+)doc");
+
+REGISTER_OP("IO>ArrowScannerDataset")
+    .Input("path: string")
+    .Input("format: string")
+    .Input("partitioning: string")
+    .Input("column_names: string")
+    .Input("filter_fields: string")
+    .Input("filter_ops: string")
+    .Input("filter_values: string")
+    .Input("columns: int32")
+    .Input("batch_size: int64")
+    .Input("batch_mode: string")
+    .Output("handle: variant")
+    .Attr("output_types: list(type) >= 1")
+    .Attr("output_shapes: list(shape) >= 1")
+    .Attr("parallel_columns: int = 0")
+    .Attr("parallel_columns_min_bytes: int = 0")
+    .Attr("ragged_columns: list(int) = []")
+    .Attr("dictionary_columns: list(int) = []")
+    .Attr("split_row_groups: bool = false")
+    .Attr("pre_buffer: bool = false")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape)
+    .Doc(R"doc(
+Creates a dataset that scans the fragments of a directory with arrow::dataset.
+
+path: Local path or filesystem URI of the directory of fragments.
+format: Format of the fragments, "parquet", "feather" or "ipc".
+partitioning: "hive" to parse key=value directories to columns, or "".
+column_names: Names of the columns to project, in output order.
+filter_fields: Fields of the comparisons of the filter, all must hold.
+filter_ops: Operators of the comparisons, one of ==, !=, <, <=, > and >=.
+filter_values: Values of the comparisons, parsed to the type of the field.
+split_row_groups: Whether to scan each Parquet row group as a fragment.
+pre_buffer: Whether to pre-buffer Parquet column chunks with coalesced reads.
+)doc");
+
+REGISTER_OP("IO>ArrowWriterInit")
+    .Input("filename: string")
+    .Input("column_names: string")
+    .Output("writer: resource")
+    .Attr("format: string = 'file'")
+    .Attr("compression: string = ''")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("IO>ArrowWriterWrite")
+    .Input("writer: resource")
+    .Input("values: dtypes")
+    .Attr("dtypes: list(type) >= 1")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+REGISTER_OP("IO>ArrowWriterClose")
+    .Input("writer: resource")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+REGISTER_OP("IO>ParquetWriterInit")
+    .Input("filename: string")
+    .Input("column_names: string")
+    .Output("writer: resource")
+    .Attr("compression: string = 'snappy'")
+    .Attr("row_group_size: int = 131072")
+    .Attr("dictionary: bool = true")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("IO>ParquetWriterWrite")
+    .Input("writer: resource")
+    .Input("values: dtypes")
+    .Attr("dtypes: list(type) >= 1")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+REGISTER_OP("IO>ParquetWriterClose")
+    .Input("writer: resource")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
 REGISTER_OP("IO>ListFeatherColumns")
     .Input("filename: string")
     .Input("memory: string")
@@ -130,6 +263,7 @@ REGISTER_OP("IO>FeatherReadableRead")
     .Attr("component: string")
     .Attr("shape: shape")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       PartialTensorShape shape;
       TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
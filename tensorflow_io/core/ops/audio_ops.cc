@@ -54,6 +54,32 @@ REGISTER_OP("IO>AudioReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>AudioWritableInit")
+    .Input("filename: string")
+    .Input("rate: int64")
+    .Output("resource: resource")
+    .Attr("format: string = ''")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioWritableWrite")
+    .Input("input: resource")
+    .Input("value: dtype")
+    .Attr("dtype: {uint8, int16, int32, float32}")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &unused));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioWritableClose")
+    .Input("input: resource")
+    .SetShapeFn(shape_inference::NoOutputs);
+
 REGISTER_OP("IO>AudioResample")
     .Input("input: T")
     .Input("rate_in: int64")
@@ -65,6 +91,62 @@ REGISTER_OP("IO>AudioResample")
       return OkStatus();
     });
 
+REGISTER_OP("IO>AudioDecodeBatch")
+    .Input("input: string")
+    .Output("value: dtype")
+    .Output("row_splits: int64")
+    .Output("rate: int32")
+    .Attr("dtype: {uint8, int16, int32, float32}")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim()}));
+      c->set_output(1, c->MakeShape({c->UnknownDim()}));
+      c->set_output(2, c->MakeShape({c->UnknownDim()}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioDecodeResample")
+    .Input("input: string")
+    .Input("rate_out: int64")
+    .Output("value: float32")
+    .Attr("mono: bool = true")
+    .Attr("quality: int = 4")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      bool mono;
+      TF_RETURN_IF_ERROR(c->GetAttr("mono", &mono));
+      c->set_output(0, c->MakeShape({c->UnknownDim(),
+                                     mono ? c->MakeDim(1) : c->UnknownDim()}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioMelSpectrogram")
+    .Input("input: float32")
+    .Input("rate: int64")
+    .Output("value: dtype")
+    .Attr("nfft: int")
+    .Attr("window: int")
+    .Attr("stride: int")
+    .Attr("mels: int")
+    .Attr("fmin: float")
+    .Attr("fmax: float")
+    .Attr("power: float = 1.0")
+    .Attr("log: bool = false")
+    .Attr("mfcc: int = 0")
+    .Attr("dtype: {float32, float16} = DT_FLOAT")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+      int64 stride, mels, mfcc;
+      TF_RETURN_IF_ERROR(c->GetAttr("stride", &stride));
+      TF_RETURN_IF_ERROR(c->GetAttr("mels", &mels));
+      TF_RETURN_IF_ERROR(c->GetAttr("mfcc", &mfcc));
+      shape_inference::DimensionHandle frames = c->UnknownDim();
+      if (c->ValueKnown(c->Dim(input, 0)) && stride > 0) {
+        frames = c->MakeDim((c->Value(c->Dim(input, 0)) + stride - 1) / stride);
+      }
+      c->set_output(0, c->MakeShape({frames, mfcc > 0 ? mfcc : mels}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>AudioDecodeWAV")
     .Input("input: string")
     .Input("shape: int64")
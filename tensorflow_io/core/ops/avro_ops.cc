@@ -92,6 +92,11 @@ REGISTER_OP("IO>ParseAvro")
     .Attr("sparse_types: list({float,double,int64,int32,string,bool}) >= 0")
     .Attr("dense_types: list({float,double,int64,int32,string,bool}) >= 0")
     .Attr("dense_shapes: list(shape) >= 0")
+    .Attr("confluent_wire_format: bool = false")
+    .Attr("writer_schema_ids: list(int) = []")
+    .Attr("writer_schemas: list(string) = []")
+    .Attr("numa_node: int = -1")
+    .Attr("cpu_affinity: string = ''")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       size_t num_dense;
       size_t num_sparse;
@@ -174,6 +179,9 @@ REGISTER_OP("IO>AvroRecordDataset")
     .Input("buffer_size: int64")
     .Input("reader_schema: string")
     .Output("handle: variant")
+    .Attr("byte_start: int = 0")
+    .Attr("byte_end: int = -1")
+    .Attr("block_index_suffix: string = ''")
     .SetIsStateful()  // TODO(b/123753214): Source dataset ops must be marked
                       // stateful to inhibit constant folding.
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -188,6 +196,19 @@ REGISTER_OP("IO>AvroRecordDataset")
       return shape_inference::ScalarShape(c);
     });
 
+REGISTER_OP("IO>WriteAvroBlockIndex")
+    .Input("filename: string")
+    .Input("index_filename: string")
+    .Output("num_blocks: int64")
+    .SetIsStateful()
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      c->set_output(0, c->Scalar());
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>AvroDataset")
     .Input("filenames: string")
     .Input("batch_size: int64")
@@ -305,6 +326,7 @@ REGISTER_OP("IO>AvroReadableRead")
     .Attr("filter: list(string) = []")
     .Attr("shape: shape")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       PartialTensorShape shape;
       TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
@@ -314,6 +336,44 @@ REGISTER_OP("IO>AvroReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>AvroReadableReadComponents")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("value: dtypes")
+    .Attr("components: list(string) >= 1")
+    .Attr("shapes: list(shape)")
+    .Attr("dtypes: list(type) >= 1")
+    .Attr("gpu_compatible: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      std::vector<PartialTensorShape> shapes;
+      TF_RETURN_IF_ERROR(c->GetAttr("shapes", &shapes));
+      if (static_cast<int>(shapes.size()) != c->num_outputs()) {
+        return errors::InvalidArgument("shapes and dtypes mismatch: ",
+                                       shapes.size(), " vs. ",
+                                       c->num_outputs());
+      }
+      for (size_t i = 0; i < shapes.size(); i++) {
+        shape_inference::ShapeHandle entry;
+        TF_RETURN_IF_ERROR(
+            c->MakeShapeFromPartialTensorShape(shapes[i], &entry));
+        c->set_output(i, entry);
+      }
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AvroReadableDataset")
+    .Input("input: resource")
+    .Input("capacity: int64")
+    .Input("num_parallel_reads: int64")
+    .Input("window: int64")
+    .Output("handle: variant")
+    .Attr("components: list(string) >= 1")
+    .Attr("shapes: list(shape)")
+    .Attr("dtypes: list(type) >= 1")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
 REGISTER_OP("IO>AvroReadablePartitions")
     .Input("input: resource")
     .Output("partitions: int64")
@@ -329,7 +389,18 @@ REGISTER_OP("IO>ATDSDataset")
     .Input("reader_buffer_size: int64")
     .Input("shuffle_buffer_size: int64")
     .Input("num_parallel_calls: int64")
+    .Input("num_parallel_reads: int64")
+    .Input("max_inflight_bytes: int64")
     .Output("handle: variant")
+    .Attr("shuffle_mode: {'record', 'block'} = 'record'")
+    .Attr("shuffle_seed: int = -1")
+    .Attr("output_arena: bool = false")
+    .Attr("numa_node: int = -1")
+    .Attr("cpu_affinity: string = ''")
+    .Attr("block_cache_bytes: int >= 0 = 0")
+    .Attr("block_cache_dir: string = ''")
+    .Attr("reader_queue_depth: int >= 1 = 1")
+    .Attr("from_memory: bool = false")
     .Attr("feature_keys: list(string) >= 0")
     .Attr("feature_types: list(string) >= 0")
     .Attr("sparse_dtypes: list({float,double,int64,int32,string,bool}) >= 0")
@@ -353,6 +424,10 @@ REGISTER_OP("IO>ATDSDataset")
       TF_RETURN_IF_ERROR(c->WithRank(c->input(4), 0, &unused));
       // `num_parallel_calls` must be a scalar
       TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 0, &unused));
+      // `num_parallel_reads` must be a scalar
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(6), 0, &unused));
+      // `max_inflight_bytes` must be a scalar
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(7), 0, &unused));
       return shape_inference::ScalarShape(c);
     });
 
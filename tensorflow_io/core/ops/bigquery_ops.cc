@@ -36,6 +36,10 @@ REGISTER_OP("IO>BigQueryReadSession")
     .Attr("requested_streams: int")
     .Attr("data_format: string")
     .Attr("row_restriction: string = ''")
+    .Attr("api_version: {'v1beta1', 'v1'} = 'v1beta1'")
+    .Attr("arrow_compression: string = ''")
+    .Attr("max_stream_count: int = 0")
+    .Attr("preferred_min_stream_count: int = 0")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .Output("streams: string")
@@ -51,7 +55,10 @@ REGISTER_OP("IO>BigQueryDataset")
     .Input("stream: string")
     .Input("schema: string")
     .Attr("offset: int")
+    .Attr("batch_size: int = 0")
+    .Attr("num_parallel_streams: int = 0")
     .Attr("data_format: string")
+    .Attr("api_version: {'v1beta1', 'v1'} = 'v1beta1'")
     .Attr("selected_fields: list(string) >= 1")
     .Attr("output_types: list(type) >= 1")
     .Attr("default_values: list(string) >= 1")
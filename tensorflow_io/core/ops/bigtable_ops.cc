@@ -35,6 +35,8 @@ REGISTER_OP("BigtableDataset")
     .Attr("table_id: string")
     .Attr("columns: list(string) >= 1")
     .Attr("output_type: type")
+    .Attr("batch_size: int = 0")
+    .Attr("num_parallel_reads: int = 1")
     .Output("handle: variant")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape)
@@ -47,6 +49,10 @@ retrieve.
 table_id: ID of the table user wants to read from.
 columns: List of names of the columns user wants to retrieve in format 
 'column_family:column_name'
+batch_size: If positive, the number of rows in each element, read to a tensor
+of shape [num_rows, num_columns].
+num_parallel_reads: The number of ranges of tablets of the row set that are read
+concurrently.
 )doc");
 
 REGISTER_OP("BigtableEmptyRowSet")
@@ -25,6 +25,7 @@ REGISTER_OP("IO>ListArchiveEntries")
     .Output("format: string")
     .Output("entries: string")
     .Attr("filters: list(string) = []")
+    .Attr("seek_index: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->Scalar());
       c->set_output(1, c->MakeShape({c->UnknownDim()}));
@@ -37,6 +38,7 @@ REGISTER_OP("IO>ReadArchive")
     .Input("entries: string")
     .Input("memory: string")
     .Output("output: string")
+    .Attr("seek_index: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->MakeShape({c->UnknownDim()}));
       return OkStatus();
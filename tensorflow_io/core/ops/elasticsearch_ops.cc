@@ -26,6 +26,10 @@ REGISTER_OP("IO>ElasticsearchReadableInit")
     .Input("healthcheck_field: string")
     .Input("request_url: string")
     .Input("headers: string")
+    .Input("columns: string")
+    .Input("num_slices: int64")
+    .Input("page_size: int64")
+    .Input("pit_url: string")
     .Output("resource: resource")
     .Output("columns: string")
     .Output("dtypes: string")
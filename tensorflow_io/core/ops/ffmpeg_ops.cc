@@ -87,6 +87,7 @@ REGISTER_OP("IO>FfmpegAudioReadableNext")
     .Input("reset: bool")
     .Output("value: dtype")
     .Attr("dtype: type")
+    .Attr("start: int = 0")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim()}));
       return OkStatus();
@@ -108,6 +109,8 @@ REGISTER_OP("IO>FfmpegVideoReadableNext")
     .Input("reset: bool")
     .Output("value: dtype")
     .Attr("dtype: type")
+    .Attr("start: int = 0")
+    .Attr("batch: int = 0")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim(),
                                      c->UnknownDim(), c->UnknownDim()}));
@@ -37,6 +37,7 @@ REGISTER_OP("IO>FileRead")
     .Input("length: int64")
     .Input("compression: string")
     .Output("value: string")
+    .Attr("prefetch: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->Scalar());
       return OkStatus();
@@ -46,6 +47,7 @@ REGISTER_OP("IO>FileInit")
     .SetIsStateful()
     .Input("input: string")
     .Output("resource: resource")
+    .Attr("buffer_size: int = 0")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .SetShapeFn(shape_inference::ScalarShape);
@@ -28,6 +28,20 @@ REGISTER_OP("IO>FileSystemSetConfiguration")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("IO>MemoryBudgetUsage")
+    .Output("component: string")
+    .Output("bytes: int64")
+    .Output("peak_bytes: int64")
+    .Output("limit_bytes: int64")
+    .SetIsStateful()
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Vector(c->UnknownDim()));
+      c->set_output(1, c->output(0));
+      c->set_output(2, c->output(0));
+      c->set_output(3, c->Scalar());
+      return OkStatus();
+    });
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
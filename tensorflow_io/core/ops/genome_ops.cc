@@ -29,4 +29,60 @@ REGISTER_OP("IO>ReadFastq")
       return OkStatus();
     });
 
+REGISTER_OP("IO>FastqReadableInit")
+    .Input("input: string")
+    .Input("metadata: string")
+    .Output("resource: resource")
+    .Output("components: string")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn([](::tensorflow::shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      c->set_output(1, c->MakeShape({}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>FastqReadableSpec")
+    .Input("input: resource")
+    .Output("shape: int64")
+    .Output("dtype: int64")
+    .Attr("component: string")
+    .SetShapeFn([](::tensorflow::shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim()}));
+      c->set_output(1, c->MakeShape({}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>FastqReadableRead")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("value: dtype")
+    .Attr("component: string")
+    .Attr("shape: shape")
+    .Attr("dtype: type")
+    .SetShapeFn([](::tensorflow::shape_inference::InferenceContext* c) {
+      PartialTensorShape shape;
+      TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
+      shape_inference::ShapeHandle entry;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromPartialTensorShape(shape, &entry));
+      c->set_output(0, entry);
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>FastqReadableReadPacked")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("base_splits: int64")
+    .Output("bases: uint8")
+    .Output("quality_splits: int64")
+    .Output("qualities: uint8")
+    .SetShapeFn([](::tensorflow::shape_inference::InferenceContext* c) {
+      for (int i = 0; i < 4; i++) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 }  // namespace tensorflow
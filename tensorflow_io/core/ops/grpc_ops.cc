@@ -25,6 +25,8 @@ REGISTER_OP("IO>GRPCReadableInit")
     .SetIsStateful()
     .Input("input: string")
     .Output("resource: resource")
+    .Attr("stream: bool = false")
+    .Attr("in_flight: int = 1")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
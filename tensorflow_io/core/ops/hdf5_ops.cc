@@ -43,6 +43,11 @@ REGISTER_OP("IO>HDF5ReadableRead")
     .Input("start: int64")
     .Input("stop: int64")
     .Attr("dtype: type")
+    .Attr("cache_dataset: bool = true")
+    .Attr("chunk_cache_bytes: int = -1")
+    .Attr("chunk_cache_slots: int = -1")
+    .Attr("chunk_cache_preemption: float = -1")
+    .Attr("gpu_compatible: bool = false")
     .Attr("container: string = ''")
     .Output("value: dtype")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -46,6 +46,20 @@ REGISTER_OP("IO>DecodeTiff")
       return OkStatus();
     });
 
+REGISTER_OP("IO>DecodeTiffRegion")
+    .Input("filename: string")
+    .Input("index: int64")
+    .Input("region: int64")
+    .Output("image: uint8")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim(), 4}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>EncodeBmp")
     .Input("input: uint8")
     .Output("output: string")
@@ -59,12 +73,24 @@ REGISTER_OP("IO>EncodeBmp")
 REGISTER_OP("IO>DecodeWebP")
     .Input("contents: string")
     .Output("image: uint8")
+    .Attr("size: list(int) = []")
+    .Attr("crop: list(int) = []")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
-      c->set_output(
-          0, c->MakeShape({shape_inference::InferenceContext::kUnknownDim,
-                           shape_inference::InferenceContext::kUnknownDim, 4}));
+      std::vector<int32> size, crop;
+      TF_RETURN_IF_ERROR(c->GetAttr("size", &size));
+      TF_RETURN_IF_ERROR(c->GetAttr("crop", &crop));
+      if (size.size() == 2) {
+        c->set_output(0, c->MakeShape({size[0], size[1], 4}));
+      } else if (crop.size() == 4) {
+        c->set_output(0, c->MakeShape({crop[2], crop[3], 4}));
+      } else {
+        c->set_output(
+            0,
+            c->MakeShape({shape_inference::InferenceContext::kUnknownDim,
+                          shape_inference::InferenceContext::kUnknownDim, 4}));
+      }
       return OkStatus();
     });
 
@@ -122,13 +148,23 @@ REGISTER_OP("IO>DecodeExr")
     .Input("channel: string")
     .Output("image: dtype")
     .Attr("dtype: {uint32, half, float}")
+    .Attr("start: int = 0")
+    .Attr("count: int = -1")
+    .Attr("threads: int = 0")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
       TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 0, &unused));
-      c->set_output(
-          0, c->MakeShape({c->UnknownDim(), c->UnknownDim(), c->UnknownDim()}));
+      shape_inference::ShapeHandle channel;
+      TF_RETURN_IF_ERROR(c->WithRankAtMost(c->input(2), 1, &channel));
+      if (!c->RankKnown(channel)) {
+        c->set_output(0, c->UnknownShape());
+      } else if (c->Rank(channel) == 0) {
+        c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim()}));
+      } else {
+        c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim(),
+                                       c->Dim(channel, 0)}));
+      }
       return OkStatus();
     });
 
@@ -151,6 +187,8 @@ REGISTER_OP("IO>DecodeDICOMImage")
     .Attr("color_dim: bool = true")
     .Attr("on_error: {'strict', 'skip', 'lossy'} = 'skip'")
     .Attr("scale: {'auto', 'preserve'} = 'preserve'")
+    .Attr("start: int = 0")
+    .Attr("count: int = -1")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim(),
                                      c->UnknownDim(), c->UnknownDim()}));
@@ -195,9 +233,100 @@ REGISTER_OP("IO>DecodeYUY2")
       return OkStatus();
     });
 
+REGISTER_OP("IO>RasterReadableInit")
+    .Input("input: string")
+    .Output("resource: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>RasterReadableSpec")
+    .Input("input: resource")
+    .Output("shape: int64")
+    .Output("dtype: int64")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({3}));
+      c->set_output(1, c->MakeShape({}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>RasterReadableRead")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("value: dtype")
+    .Attr("dtype: type")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim(),
+                                     c->UnknownDim()}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>ConvertColor")
+    .Input("input: dtype")
+    .Output("output: dtype")
+    .Attr(
+        "conversion: {'rgb_to_ycbcr', 'ycbcr_to_rgb', 'rgb_to_ypbpr', "
+        "'ypbpr_to_rgb', 'rgb_to_ydbdr', 'ydbdr_to_rgb', 'rgb_to_xyz', "
+        "'xyz_to_rgb', 'rgb_to_lab', 'lab_to_rgb'}")
+    .Attr("white: list(float) = [0.95047, 1.0, 1.08883]")
+    .Attr("dtype: {uint8, float}")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 1, &unused));
+      c->set_output(0, c->input(0));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>DecodeImageBatch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Output("image: uint8")
+    .Attr("channels: int = 3")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      int64 channels;
+      TF_RETURN_IF_ERROR(c->GetAttr("channels", &channels));
+      c->set_output(0, c->MakeShape({c->Dim(c->input(0), 0), c->UnknownDim(),
+                                     c->UnknownDim(), channels}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>DecodeNV12Batch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Input("resize: int32")
+    .Output("image: uint8")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      c->set_output(0, c->MakeShape({c->Dim(c->input(0), 0), c->UnknownDim(),
+                                     c->UnknownDim(), 3}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>DecodeYUY2Batch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Input("resize: int32")
+    .Output("image: uint8")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      c->set_output(0, c->MakeShape({c->Dim(c->input(0), 0), c->UnknownDim(),
+                                     c->UnknownDim(), 3}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>DecodeAVIF")
     .Input("contents: string")
     .Output("image: uint8")
+    .Attr("codec: {'auto', 'dav1d', 'libgav1'} = 'auto'")
+    .Attr("threads: int = 1")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
@@ -209,11 +338,15 @@ REGISTER_OP("IO>DecodeAVIF")
 
 REGISTER_OP("IO>DecodeJPEG2K")
     .Input("contents: string")
+    .Input("region: int64")
     .Output("image: dtype")
     .Attr("dtype: {uint8, uint16}")
+    .Attr("reduce: int = 0")
+    .Attr("threads: int = 1")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
       c->set_output(
           0, c->MakeShape({shape_inference::InferenceContext::kUnknownDim,
                            shape_inference::InferenceContext::kUnknownDim,
@@ -224,6 +357,8 @@ REGISTER_OP("IO>DecodeJPEG2K")
 REGISTER_OP("IO>EncodeGif")
     .Input("input: uint8")
     .Output("output: string")
+    .Attr("palette: {'global', 'local'} = 'global'")
+    .Attr("delta: bool = true")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle unused;
       TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 4, &unused));
@@ -53,6 +53,7 @@ REGISTER_OP("IO>JSONReadableRead")
     .Attr("component: string")
     .Attr("shape: shape")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       PartialTensorShape shape;
       TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
@@ -55,4 +55,39 @@ feature_shape: A 1-D int64 tensor of dense_shape [ndims].
 num_features: The number of features.
 )doc");
 
+REGISTER_OP("IO>DecodeLibsvmCSR")
+    .Input("input: string")
+    .Output("label: label_dtype")
+    .Output("row_splits: int64")
+    .Output("feature_indices: int64")
+    .Output("feature_values: dtype")
+    .Attr("dtype: {float, double, int32, int64} = DT_FLOAT")
+    .Attr("label_dtype: {float, double, int32, int64} = DT_INT64")
+    .Attr("num_features: int >= 1")
+    .SetShapeFn([](InferenceContext* c) {
+      shape_inference::ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+      c->set_output(0, input);
+
+      shape_inference::DimensionHandle splits;
+      TF_RETURN_IF_ERROR(c->Add(c->Dim(input, 0), 1, &splits));
+      c->set_output(1, c->Vector(splits));
+      c->set_output(2, c->Vector(InferenceContext::kUnknownDim));
+      c->set_output(3, c->Vector(InferenceContext::kUnknownDim));
+
+      return OkStatus();
+    })
+
+    .Doc(R"doc(
+Convert LibSVM input to the CSR layout of its features, which is the row
+partition and values of a RaggedTensor of shape `[input_shape, None]`.
+
+input: Each string is a record in the LibSVM, a 1-D tensor.
+label: A tensor of the same shape as input.
+row_splits: A 1-D int64 tensor of the offsets of each row, of size N + 1.
+feature_indices: A 1-D int64 tensor of the feature index of each value.
+feature_values: A 1-D tensor of any type of the feature values.
+num_features: The number of features.
+)doc");
+
 }  // namespace tensorflow
@@ -45,6 +45,7 @@ REGISTER_OP("IO>LMDBDatasetV2")
 
 REGISTER_OP("IO>LMDBReadableInit")
     .Input("input: string")
+    .Input("metadata: string")
     .Output("resource: resource")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
@@ -69,6 +70,19 @@ REGISTER_OP("IO>LMDBReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>LMDBReadableReadItems")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("key: string")
+    .Output("value: string")
+    .Attr("filter: list(string) = ['value', 'label']")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim()}));
+      c->set_output(1, c->MakeShape({c->UnknownDim()}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>LMDBMappingInit")
     .Input("input: string")
     .Output("resource: resource")
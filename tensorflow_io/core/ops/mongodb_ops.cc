@@ -25,6 +25,11 @@ REGISTER_OP("IO>MongoDBReadableInit")
     .Input("uri: string")
     .Input("database: string")
     .Input("collection: string")
+    .Input("filter: string")
+    .Input("projection: string")
+    .Input("batch_size: int64")
+    .Input("num_parallel_reads: int64")
+    .Input("raw_bson: bool")
     .Output("resource: resource")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''");
@@ -47,7 +52,15 @@ REGISTER_OP("IO>MongoDBWritableInit")
 
 REGISTER_OP("IO>MongoDBWritableWrite")
     .Input("resource: resource")
-    .Input("record: string");
+    .Input("record: string")
+    .Attr("batch_size: int = 1000");
+
+REGISTER_OP("IO>MongoDBWritableWriteColumns")
+    .Input("resource: resource")
+    .Input("names: string")
+    .Input("columns: dtypes")
+    .Attr("dtypes: list({bool, int32, int64, float, double, string}) >= 1")
+    .Attr("batch_size: int = 1000");
 
 REGISTER_OP("IO>MongoDBWritableDeleteMany")
     .Input("resource: resource")
@@ -52,6 +52,7 @@ REGISTER_OP("IO>NumpyRead")
     .Input("start: int64")
     .Input("stop: int64")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .Output("output: dtype")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       shape_inference::ShapeHandle full;
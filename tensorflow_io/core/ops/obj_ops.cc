@@ -31,6 +31,29 @@ REGISTER_OP("IO>DecodeObj")
       return OkStatus();
     });
 
+REGISTER_OP("IO>DecodeObjBatch")
+    .Input("input: string")
+    .Output("vertices: float32")
+    .Output("vertex_splits: int64")
+    .Output("normals: float32")
+    .Output("normal_splits: int64")
+    .Output("texcoords: float32")
+    .Output("texcoord_splits: int64")
+    .Output("indices: int32")
+    .Output("index_splits: int64")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      shape_inference::DimensionHandle splits;
+      TF_RETURN_IF_ERROR(c->Add(c->Dim(c->input(0), 0), 1, &splits));
+      const int64 widths[] = {3, 3, 2, 3};
+      for (int i = 0; i < 4; i++) {
+        c->set_output(2 * i, c->MakeShape({c->UnknownDim(), widths[i]}));
+        c->set_output(2 * i + 1, c->MakeShape({splits}));
+      }
+      return OkStatus();
+    });
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -20,6 +20,7 @@ limitations under the License.
 namespace tensorflow {
 REGISTER_OP("IO>ORCReadableInit")
     .Input("input: string")
+    .Input("metadata: string")
     .Output("resource: resource")
     .Output("components: string")
     .Attr("container: string = ''")
@@ -49,6 +50,7 @@ REGISTER_OP("IO>ORCReadableRead")
     .Attr("component: string")
     .Attr("shape: shape")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       PartialTensorShape shape;
       TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
@@ -57,4 +59,25 @@ REGISTER_OP("IO>ORCReadableRead")
       c->set_output(0, entry);
       return OkStatus();
     });
+
+REGISTER_OP("IO>ORCReadableReadMasked")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("value: dtype")
+    .Output("mask: bool")
+    .Attr("filter: list(string) = ['value', 'label']")
+    .Attr("component: string")
+    .Attr("shape: shape")
+    .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      PartialTensorShape shape;
+      TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
+      shape_inference::ShapeHandle entry;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromPartialTensorShape(shape, &entry));
+      c->set_output(0, entry);
+      c->set_output(1, entry);
+      return OkStatus();
+    });
 }  // namespace tensorflow
\ No newline at end of file
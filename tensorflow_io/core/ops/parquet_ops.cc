@@ -59,6 +59,53 @@ REGISTER_OP("IO>ParquetReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>ParquetReadableReadMasked")
+    .Input("input: string")
+    .Input("shared: string")
+    .Input("component: string")
+    .Input("shape: int64")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Attr("dtype: type")
+    .Attr("container: string = ''")
+    .Output("value: dtype")
+    .Output("mask: bool")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle full;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromShapeTensor(3, &full));
+      shape_inference::ShapeHandle shape = full;
+      if (c->RankKnown(full) && c->Rank(full) > 0) {
+        TF_RETURN_IF_ERROR(c->ReplaceDim(full, 0, c->UnknownDim(), &shape));
+      }
+      c->set_output(0, shape);
+      c->set_output(1, shape);
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>ParquetReadableReadDictionary")
+    .Input("input: string")
+    .Input("shared: string")
+    .Input("component: string")
+    .Input("shape: int64")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Attr("container: string = ''")
+    .Output("indices: int64")
+    .Output("dictionary: string")
+    .Output("mask: bool")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle full;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromShapeTensor(3, &full));
+      shape_inference::ShapeHandle shape = full;
+      if (c->RankKnown(full) && c->Rank(full) > 0) {
+        TF_RETURN_IF_ERROR(c->ReplaceDim(full, 0, c->UnknownDim(), &shape));
+      }
+      c->set_output(0, shape);
+      c->set_output(1, c->MakeShape({c->UnknownDim()}));
+      c->set_output(2, shape);
+      return OkStatus();
+    });
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -42,4 +42,18 @@ REGISTER_OP("IO>PcapReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>PcapReadableReadRagged")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("label: double")
+    .Output("row_splits: int64")
+    .Output("value: uint8")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim()}));
+      c->set_output(1, c->MakeShape({c->UnknownDim()}));
+      c->set_output(2, c->MakeShape({c->UnknownDim()}));
+      return OkStatus();
+    });
+
 }  // namespace tensorflow
@@ -26,6 +26,9 @@ REGISTER_OP("IO>PulsarReadableInit")
     .Input("topic: string")
     .Input("subscription: string")
     .Input("ack_grouping_time: int64")
+    .Input("batch_receive_max_messages: int64")
+    .Input("batch_receive_max_bytes: int64")
+    .Input("batch_receive_timeout: int64")
     .Output("resource: resource")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
@@ -51,6 +54,11 @@ REGISTER_OP("IO>PulsarReadableNext")
 REGISTER_OP("IO>PulsarWritableInit")
     .Input("service_url: string")
     .Input("topic: string")
+    .Input("batching_max_messages: int64")
+    .Input("batching_max_bytes: int64")
+    .Input("batching_max_publish_delay: int64")
+    .Input("compression: string")
+    .Input("max_pending_messages: int64")
     .Output("resource: resource")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
@@ -64,6 +72,11 @@ REGISTER_OP("IO>PulsarWritableWrite")
     .Input("value: string")
     .Input("key: string");
 
+REGISTER_OP("IO>PulsarWritableWriteBatch")
+    .Input("input: resource")
+    .Input("value: string")
+    .Input("key: string");
+
 REGISTER_OP("IO>PulsarWritableFlush").Input("input: resource");
 
 }  // namespace
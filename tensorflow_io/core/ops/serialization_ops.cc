@@ -36,6 +36,27 @@ REGISTER_OP("IO>DecodeJSON")
       return OkStatus();
     });
 
+REGISTER_OP("IO>DecodeJSONBatch")
+    .Input("input: string")
+    .Output("value: dtypes")
+    .Attr("names: list(string)")
+    .Attr("shapes: list(shape)")
+    .Attr("dtypes: list(type)")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+      std::vector<PartialTensorShape> shapes;
+      TF_RETURN_IF_ERROR(c->GetAttr("shapes", &shapes));
+      for (size_t i = 0; i < c->num_outputs(); ++i) {
+        shape_inference::ShapeHandle shape;
+        TF_RETURN_IF_ERROR(
+            c->MakeShapeFromPartialTensorShape(shapes[i], &shape));
+        TF_RETURN_IF_ERROR(c->Concatenate(input, shape, &shape));
+        c->set_output(static_cast<int64>(i), shape);
+      }
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>DecodeAvro")
     .Input("input: string")
     .Input("names: string")
@@ -69,7 +90,14 @@ REGISTER_OP("IO>EncodeAvro")
     .Input("schema: string")
     .Output("value: string")
     .Attr("dtype: list({bool,int32,int64,float,double,string})")
+    .Attr("container_block: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
+      bool container_block;
+      TF_RETURN_IF_ERROR(c->GetAttr("container_block", &container_block));
+      if (container_block) {
+        c->set_output(0, c->Scalar());
+        return OkStatus();
+      }
       c->set_output(0, c->input(0));
       return OkStatus();
     });
@@ -31,6 +31,7 @@ REGISTER_OP("IO>SqlIterableInit")
     .Output("dtype: int64")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
+    .Attr("batch_size: int = 0")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->Scalar());
       c->set_output(1, c->Scalar());
@@ -53,6 +54,26 @@ REGISTER_OP("IO>SqlIterableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>SqlWritableInit")
+    .SetIsStateful()
+    .Input("endpoint: string")
+    .Input("table: string")
+    .Output("resource: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>SqlWritableWrite")
+    .SetIsStateful()
+    .Input("resource: resource")
+    .Input("names: string")
+    .Input("columns: dtypes")
+    .Attr("dtypes: list({bool, int32, int64, float, double, string}) >= 1")
+    .SetShapeFn(shape_inference::NoOutputs);
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -48,6 +48,17 @@ REGISTER_OP("IO>RE2FullMatch")
       return OkStatus();
     });
 
+REGISTER_OP("IO>RE2FullMatchSet")
+    .Input("input: string")
+    .Output("ids: int32")
+    .Output("row_splits: int64")
+    .Attr("patterns: list(string) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->MakeShape({c->UnknownDim()}));
+      c->set_output(1, c->MakeShape({c->UnknownDim()}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>ReadText")
     .Input("filename: string")
     .Input("memory: string")
@@ -74,8 +85,14 @@ REGISTER_OP("IO>TextOutputSequenceSetItem")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("IO>TextOutputSequenceFlush")
+    .Input("sequence: resource")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
 REGISTER_OP("IO>CSVReadableInit")
     .Input("input: string")
+    .Input("metadata: string")
     .Output("resource: resource")
     .Output("components: string")
     .Attr("container: string = ''")
@@ -106,6 +123,7 @@ REGISTER_OP("IO>CSVReadableRead")
     .Attr("component: string")
     .Attr("shape: shape")
     .Attr("dtype: type")
+    .Attr("gpu_compatible: bool = false")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       PartialTensorShape shape;
       TF_RETURN_IF_ERROR(c->GetAttr("shape", &shape));
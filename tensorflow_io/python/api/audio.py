@@ -18,6 +18,7 @@ from tensorflow_io.python.ops.audio_ops import (  # pylint: disable=unused-impor
     spectrogram,
     inverse_spectrogram,
     melscale,
+    mel_spectrogram,
     dbscale,
     remix,
     split,
@@ -26,6 +27,8 @@ from tensorflow_io.python.ops.audio_ops import (  # pylint: disable=unused-impor
     time_mask,
     fade,
     resample,
+    decode_batch,
+    decode_resample,
     decode_wav,
     encode_wav,
     decode_flac,
@@ -38,4 +41,5 @@ from tensorflow_io.python.ops.audio_ops import (  # pylint: disable=unused-impor
     encode_aac,
     AudioIOTensor,
     AudioIODataset,
+    AudioWriter,
 )
@@ -16,6 +16,7 @@
 
 from tensorflow_io.python.experimental.avro_record_dataset_ops import (  # pylint: disable=unused-import
     AvroRecordDataset,
+    write_avro_block_index,
 )
 
 from tensorflow_io.python.experimental.make_avro_record_dataset import (  # pylint: disable=unused-import
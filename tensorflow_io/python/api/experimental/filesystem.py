@@ -16,4 +16,5 @@
 
 from tensorflow_io.python.experimental.filesystem_ops import (  # pylint: disable=unused-import
     set_configuration,
+    memory_budget_usage,
 )
@@ -17,6 +17,7 @@
 from tensorflow_io.python.experimental.text_ops import (  # pylint: disable=unused-import
     decode_libsvm,
     re2_full_match,
+    re2_full_match_set,
     read_text,
     TextOutputSequence,
 )
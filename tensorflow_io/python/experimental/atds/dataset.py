@@ -29,6 +29,7 @@ from tensorflow_io.python.experimental.atds.features import (
     DenseFeature,
     SparseFeature,
     VarlenFeature,
+    RaggedFeature,
 )
 
 # Argument default values used in ATDS Dataset.
@@ -36,23 +37,51 @@ _DEFAULT_DROP_REMAINDER = False  # Do not drop last batch.
 _DEFAULT_READER_BUFFER_SIZE_BYTES = 128 * 1024  # 128 KB
 _DEFAULT_SHUFFLE_BUFFER_SIZE_EXAMPLES = 0  # shuffle is disabled.
 _DEFAULT_NUM_PARALLEL_CALLS = 1  # process sequentially.
+_DEFAULT_NUM_PARALLEL_READS = 1  # read files sequentially.
+_DEFAULT_MAX_INFLIGHT_BYTES = 0  # bounded by shuffle buffer + batch only.
+_DEFAULT_SHUFFLE_MODE = "record"  # sample records from the shuffle buffer.
+_DEFAULT_SHUFFLE_SEED = -1  # nondeterministic shuffle.
+_DEFAULT_OUTPUT_ARENA = False  # allocate output tensors for every batch.
+_DEFAULT_NUMA_NODE = -1  # threads are not pinned to a NUMA node.
+_DEFAULT_CPU_AFFINITY = ""  # threads are not pinned to CPUs.
+_DEFAULT_BLOCK_CACHE_BYTES = 0  # blocks are not cached in memory.
+_DEFAULT_BLOCK_CACHE_DIR = ""  # blocks are not spilled to disk.
+_DEFAULT_READER_QUEUE_DEPTH = 1  # one synchronous read at a time.
+_DEFAULT_FROM_MEMORY = False  # filenames are names of files.
+
+_SUPPORTED_SHUFFLE_MODES = ("record", "block")
 
 # Feature type name used in ATDS Dataset Op.
 _DENSE_FEATURE_TYPE = "dense"
 _SPARSE_FEATURE_TYPE = "sparse"
 _VARLEN_FEATURE_TYPE = "varlen"
+_RAGGED_FEATURE_TYPE = "ragged"
 
 # Supported feature configs
-_SUPPORTED_FEATURE_CONFIG = (DenseFeature, SparseFeature, VarlenFeature)
+_SUPPORTED_FEATURE_CONFIG = (DenseFeature, SparseFeature, VarlenFeature, RaggedFeature)
+
+
+class _ATDSComponentsDataset(dataset_ops.DatasetSource):
+    """The batches of an ATDSDataset with ragged features, where each ragged
+    feature is a tuple of its flat values and row splits.
+    """
+
+    def __init__(self, variant_tensor, element_spec):
+        self._components_spec = element_spec
+        super().__init__(variant_tensor)
+
+    @property
+    def element_spec(self):
+        return self._components_spec
 
 
 class ATDSDataset(dataset_ops.DatasetSource):
     """A `Dataset` comprising records from one or more Avro files.
 
     This dataset load Avro records from the files into a dict of tensors.
-    The output dict has feature name as key and tf.Tensor or tf.SparseTensor
-    as value. The output tensor values are batched with the user defined
-    batch size.
+    The output dict has feature name as key and tf.Tensor, tf.SparseTensor
+    or tf.RaggedTensor as value. The output tensor values are batched with the
+    user defined batch size.
 
     Shuffle can be enabled before batch by configuring shuffle buffer size.
     The shuffle buffer size dictates the elements *in addition* to the batch size
@@ -114,6 +143,30 @@ class ATDSDataset(dataset_ops.DatasetSource):
     Shuffle buffer size is 0
     Tensorflow and ATDS both will just directly read to create a batch of size 64
 
+    Setting shuffle_mode to "block" shuffles the order of the files and the
+    order of the Avro blocks within each file. The block offsets are collected
+    from the sync markers when a file is opened, so only the blocks needed for
+    the batch and the shuffle buffer are kept in memory. Records of these
+    blocks are interleaved randomly even when the shuffle buffer size is 0.
+    This gives a good shuffle with a small shuffle buffer when the files
+    contain many blocks.
+
+    Setting shuffle_seed to a non-negative value makes the shuffle
+    reproducible. Every iterator created from the dataset reads one epoch,
+    and the shuffle of the n-th epoch is derived from the seed and n. The
+    order is reproducible only when num_parallel_reads is 1.
+
+    Iterators of this dataset can be saved with `tf.train.Checkpoint`. A
+    restored iterator seeks to the saved Avro blocks and continues the epoch
+    instead of reading the files from the start.
+
+    The bytes, blocks and records processed by the reading, decompression
+    and decoding stages, and the time spent in them, are exported to the
+    `/tensorflow/io/atds/stage_counts` and `/tensorflow/io/atds/stage_micros`
+    monitoring counters and shown in the tf.data profiler. Compare the
+    wait_for_data time with the decode time to choose reader_buffer_size and
+    num_parallel_calls.
+
 
     A minimal example is given below:
 
@@ -166,6 +219,17 @@ class ATDSDataset(dataset_ops.DatasetSource):
         reader_buffer_size=None,
         shuffle_buffer_size=None,
         num_parallel_calls=None,
+        num_parallel_reads=None,
+        max_inflight_bytes=None,
+        shuffle_mode=None,
+        shuffle_seed=None,
+        output_arena=None,
+        numa_node=None,
+        cpu_affinity=None,
+        block_cache_bytes=None,
+        block_cache_dir=None,
+        reader_queue_depth=None,
+        from_memory=None,
     ):
         """Creates a `ATDSDataset` to read one or more Avro files encoded with
            ATDS Schema.
@@ -179,7 +243,11 @@ class ATDSDataset(dataset_ops.DatasetSource):
             read and parse per iteration.
           features: A feature configuration dict with feature name as key and
             ATDS feature as value. ATDS features can be one of the DenseFeature,
-            SparseFeature, or VarlenFeature. See
+            SparseFeature, VarlenFeature, or RaggedFeature. RaggedFeature reads
+            the schema of a VarlenFeature of rank 1 into a tf.RaggedTensor
+            built from the values and row splits output by the kernel, which
+            is several times smaller than the indices of a tf.SparseTensor
+            for long sequences. See
             tensorflow_io.python.experimental.atds.features for more details.
           drop_remainder: (Optional.) A `tf.bool` scalar tf.Tensor, representing
             whether the last batch should be dropped in the case it has fewer
@@ -195,8 +263,67 @@ class ATDSDataset(dataset_ops.DatasetSource):
             records in files are processed in parallel with deterministic order.
             The number will be truncated when it is greater than the maximum
             available parallelism number on the host. If set to `tf.data.AUTOTUNE`,
-            number of threads will be adjusted dynamically based on workload and
-            available resources. If not specified, records will be processed sequentially.
+            the number of decode threads and the number of Avro blocks read
+            ahead of the shuffle buffer are tuned by the tf.data model, whose
+            RAM budget accounts for the buffered blocks. If not specified,
+            records will be processed sequentially.
+          num_parallel_reads: (Optional.) A `tf.int64` scalar representing the
+            number of files to read concurrently. Each reader thread reads
+            Avro blocks from a different file. If greater than one, the order
+            of records across files is no longer deterministic. If not
+            specified, files are read sequentially.
+          max_inflight_bytes: (Optional.) A `tf.int64` scalar representing the
+            maximum number of bytes of Avro blocks that the reader threads may
+            hold before the blocks are handed over for decoding. It bounds
+            only the blocks read ahead and not yet handed over; the blocks
+            handed over are bounded by the shuffle buffer size plus the batch
+            size, as they are without the limit. If not specified or 0,
+            reading is bounded only by the shuffle buffer size plus the batch
+            size.
+          shuffle_mode: (Optional.) A python string, either "record" or
+            "block". "record" samples records from the shuffle buffer. "block"
+            additionally shuffles the order of files and Avro blocks. If not
+            specified, "record" is used.
+          shuffle_seed: (Optional.) A python integer used to derive the
+            shuffle seed of every epoch. If not specified or negative, the
+            shuffle is not deterministic.
+          output_arena: (Optional.) A python boolean. If True, the buffers of
+            output tensors are reused for later batches once all references
+            to them are released, and the sparse value buffers are kept
+            across batches with sizes adapted to the observed number of
+            elements. This avoids large allocations per batch at the cost of
+            holding a few batches worth of memory. If not specified, output
+            tensors are allocated for every batch.
+          numa_node: (Optional.) A python integer. If not negative, the reader
+            and decode threads are pinned to the CPUs of this NUMA node, so
+            that the block buffers they allocate are local to it. It should
+            be the node of the device that consumes the dataset. Ignored if
+            `cpu_affinity` is given. If not specified, threads are not pinned.
+          cpu_affinity: (Optional.) A python string listing the CPUs that the
+            reader and decode threads are pinned to, e.g. "0-7,16-23". The
+            number of decode threads is truncated to the number of CPUs. If
+            not specified, threads are not pinned.
+          block_cache_bytes: (Optional.) A python integer. If positive, the
+            blocks read from the files are kept compressed in memory up to
+            this many bytes, so that later epochs of the dataset read them
+            from memory instead of storage. They are still decompressed and
+            shuffled in every epoch. If not specified, blocks are not cached.
+          block_cache_dir: (Optional.) A python string. If set, the blocks
+            beyond `block_cache_bytes` are spilled to a file in this local
+            directory, removed when the dataset is destroyed. If not
+            specified, blocks beyond `block_cache_bytes` are not cached.
+          reader_queue_depth: (Optional.) A python integer. If greater than
+            1, each reader keeps this many reads of `reader_buffer_size`
+            bytes in flight ahead of the block it reads, which local NVMe
+            storage needs to reach its bandwidth. If not specified, each
+            reader issues one read at a time.
+          from_memory: (Optional.) A python boolean. If True, `filenames`
+            holds the bytes of Avro container files instead of their names,
+            e.g. messages received from Kafka or an RPC. They are decoded in
+            place, without being copied or written to a file. A dataset of
+            such messages can be read with
+            `messages.batch(n).flat_map(lambda m: ATDSDataset(m, ...,
+            from_memory=True))`. If not specified, `filenames` holds names.
 
         Raises:
           TypeError: If any argument does not have the expected type.
@@ -226,6 +353,61 @@ class ATDSDataset(dataset_ops.DatasetSource):
             num_parallel_calls,
             argument_default=_DEFAULT_NUM_PARALLEL_CALLS,
         )
+        self._num_parallel_reads = convert.optional_param_to_tensor(
+            "num_parallel_reads",
+            num_parallel_reads,
+            argument_default=_DEFAULT_NUM_PARALLEL_READS,
+        )
+        self._max_inflight_bytes = convert.optional_param_to_tensor(
+            "max_inflight_bytes",
+            max_inflight_bytes,
+            argument_default=_DEFAULT_MAX_INFLIGHT_BYTES,
+        )
+        self._shuffle_mode = (
+            _DEFAULT_SHUFFLE_MODE if shuffle_mode is None else shuffle_mode
+        )
+        if self._shuffle_mode not in _SUPPORTED_SHUFFLE_MODES:
+            raise ValueError(
+                f"Unknown shuffle_mode {shuffle_mode}. "
+                f"Only {_SUPPORTED_SHUFFLE_MODES} are supported."
+            )
+        self._shuffle_seed = (
+            _DEFAULT_SHUFFLE_SEED if shuffle_seed is None else int(shuffle_seed)
+        )
+        self._output_arena = (
+            _DEFAULT_OUTPUT_ARENA if output_arena is None else bool(output_arena)
+        )
+        self._numa_node = _DEFAULT_NUMA_NODE if numa_node is None else int(numa_node)
+        self._cpu_affinity = (
+            _DEFAULT_CPU_AFFINITY if cpu_affinity is None else str(cpu_affinity)
+        )
+        self._block_cache_bytes = (
+            _DEFAULT_BLOCK_CACHE_BYTES
+            if block_cache_bytes is None
+            else int(block_cache_bytes)
+        )
+        if self._block_cache_bytes < 0:
+            raise ValueError(
+                f"`block_cache_bytes` must be non-negative, got {block_cache_bytes}."
+            )
+        self._block_cache_dir = (
+            _DEFAULT_BLOCK_CACHE_DIR
+            if block_cache_dir is None
+            else str(block_cache_dir)
+        )
+        self._reader_queue_depth = (
+            _DEFAULT_READER_QUEUE_DEPTH
+            if reader_queue_depth is None
+            else int(reader_queue_depth)
+        )
+        if self._reader_queue_depth < 1:
+            raise ValueError(
+                "`reader_queue_depth` must be at least 1,"
+                f" got {reader_queue_depth}."
+            )
+        self._from_memory = (
+            _DEFAULT_FROM_MEMORY if from_memory is None else bool(from_memory)
+        )
 
         if features is None or not isinstance(features, dict):
             raise ValueError(
@@ -244,6 +426,7 @@ class ATDSDataset(dataset_ops.DatasetSource):
         sparse_shapes = []
 
         element_spec = {}
+        ragged_features = {}
         for key in sorted(features):
             feature = features[key]
             if not isinstance(feature, _SUPPORTED_FEATURE_CONFIG):
@@ -267,6 +450,11 @@ class ATDSDataset(dataset_ops.DatasetSource):
                 sparse_dtypes.append(feature.dtype)
                 sparse_shapes.append(shape)
                 element_spec[key] = tf.SparseTensorSpec(shape, feature.dtype)
+            elif isinstance(feature, RaggedFeature):
+                feature_types.append(_RAGGED_FEATURE_TYPE)
+                sparse_dtypes.append(feature.dtype)
+                sparse_shapes.append(shape)
+                ragged_features[key] = feature.dtype
 
         constant_drop_remainder = tensor_util.constant_value(self._drop_remainder)
         if constant_drop_remainder:
@@ -278,6 +466,18 @@ class ATDSDataset(dataset_ops.DatasetSource):
             self._element_spec = nest.map_structure(
                 lambda spec: spec._batch(None), element_spec
             )
+        # Ragged features are output as two flat tensors, the values and the
+        # row splits, that are combined to a tf.RaggedTensor below.
+        num_row_splits = None
+        if constant_drop_remainder:
+            constant_batch_size = tensor_util.constant_value(self._batch_size)
+            if constant_batch_size is not None:
+                num_row_splits = constant_batch_size + 1
+        for key, dtype in ragged_features.items():
+            self._element_spec[key] = (
+                tf.TensorSpec([None], dtype),
+                tf.TensorSpec([num_row_splits], tf.int64),
+            )
 
         variant_tensor = core_ops.io_atds_dataset(
             filenames=self._filenames,
@@ -286,6 +486,17 @@ class ATDSDataset(dataset_ops.DatasetSource):
             reader_buffer_size=self._reader_buffer_size,
             shuffle_buffer_size=self._shuffle_buffer_size,
             num_parallel_calls=self._num_parallel_calls,
+            num_parallel_reads=self._num_parallel_reads,
+            max_inflight_bytes=self._max_inflight_bytes,
+            shuffle_mode=self._shuffle_mode,
+            shuffle_seed=self._shuffle_seed,
+            output_arena=self._output_arena,
+            numa_node=self._numa_node,
+            cpu_affinity=self._cpu_affinity,
+            block_cache_bytes=self._block_cache_bytes,
+            block_cache_dir=self._block_cache_dir,
+            reader_queue_depth=self._reader_queue_depth,
+            from_memory=self._from_memory,
             feature_keys=feature_keys,
             feature_types=feature_types,
             sparse_dtypes=sparse_dtypes,
@@ -293,7 +504,24 @@ class ATDSDataset(dataset_ops.DatasetSource):
             output_dtypes=structure.get_flat_tensor_types(self._element_spec),
             output_shapes=structure.get_flat_tensor_shapes(self._element_spec),
         )
-        super().__init__(variant_tensor)
+        if not ragged_features:
+            super().__init__(variant_tensor)
+            return
+
+        components = _ATDSComponentsDataset(variant_tensor, self._element_spec)
+
+        def combine(batch):
+            batch = dict(batch)
+            for key in ragged_features:
+                values, row_splits = batch[key]
+                batch[key] = tf.RaggedTensor.from_row_splits(
+                    values, row_splits, validate=False
+                )
+            return batch
+
+        combined = components.map(combine)
+        self._element_spec = combined.element_spec
+        super().__init__(combined._variant_tensor)  # pylint: disable=protected-access
 
     @property
     def element_spec(self):
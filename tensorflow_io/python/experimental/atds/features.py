@@ -113,3 +113,29 @@ class VarlenFeature(collections.namedtuple("VarlenFeature", ["shape", "dtype"]))
                 )
 
         return super().__new__(cls, shape, dtype)
+
+
+class RaggedFeature(collections.namedtuple("RaggedFeature", ["shape", "dtype"])):
+    """
+    Configuration for reading and parsing a tf.RaggedTensor encoded with
+    ATDS ragged feature schema, the same schema as VarlenFeature of rank 1.
+
+    The values and row splits of the batch are output by the decoder
+    directly, without the SparseTensor indices of VarlenFeature.
+
+    Fields:
+      shape: Shape of input data of rank 1. Use -1 as unknown dimension.
+      dtype: Data type of input.
+    """
+
+    def __new__(cls, shape: List[int], dtype: tf.dtypes.DType):
+        _validate_shape_and_dtype(shape, dtype)
+        if len(shape) != 1:
+            raise ValueError(f"RaggedFeature must be of rank 1 but found {shape}.")
+        if shape[0] <= 0 and shape[0] != -1:
+            raise ValueError(
+                f"The dimension should be greater than 0 or "
+                f"-1 in RaggedFeature but found {shape}."
+            )
+
+        return super().__new__(cls, shape, dtype)
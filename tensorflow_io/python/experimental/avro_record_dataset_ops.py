@@ -19,6 +19,9 @@ from tensorflow_io.python.ops import core_ops
 
 _DEFAULT_READER_BUFFER_SIZE_BYTES = 256 * 1024  # 256 KB
 _DEFAULT_READER_SCHEMA = ""
+_DEFAULT_BYTE_START = 0
+_DEFAULT_BYTE_END = -1
+_DEFAULT_BLOCK_INDEX_SUFFIX = ""
 # From https://github.com/tensorflow/tensorflow/blob/v2.0.0/tensorflow/python/data/ops/readers.py
 
 
@@ -132,7 +135,15 @@ def _create_dataset_reader(
 class _AvroRecordDataset(tf.data.Dataset):
     """A `Dataset` comprising records from one or more AvroRecord files."""
 
-    def __init__(self, filenames, buffer_size=None, reader_schema=None):
+    def __init__(
+        self,
+        filenames,
+        buffer_size=None,
+        reader_schema=None,
+        byte_start=None,
+        byte_end=None,
+        block_index_suffix=None,
+    ):
         """Creates a `AvroRecordDataset`.
 
         Args:
@@ -141,6 +152,13 @@ class _AvroRecordDataset(tf.data.Dataset):
             bytes in the read buffer. 0 means no buffering.
           reader_schema: (Optional.) A `tf.string` scalar
           representing the reader schema or None
+          byte_start: (Optional.) A python integer. Only the blocks whose sync
+            marker starts in [byte_start, byte_end) of each file are read.
+          byte_end: (Optional.) A python integer. A negative value reads to the
+            end of the file.
+          block_index_suffix: (Optional.) A python string. If set, the block
+            index written by `write_avro_block_index` to the filename plus this
+            suffix is used to find the first block of the byte range.
         """
         self._filenames = filenames
         self._buffer_size = _AvroRecordDataset.__optional_param_to_tensor(
@@ -155,7 +173,16 @@ class _AvroRecordDataset(tf.data.Dataset):
             argument_dtype=tf.dtypes.string,
         )
         variant_tensor = core_ops.io_avro_record_dataset(
-            self._filenames, self._buffer_size, self._reader_schema
+            self._filenames,
+            self._buffer_size,
+            self._reader_schema,
+            byte_start=_DEFAULT_BYTE_START if byte_start is None else byte_start,
+            byte_end=_DEFAULT_BYTE_END if byte_end is None else byte_end,
+            block_index_suffix=(
+                _DEFAULT_BLOCK_INDEX_SUFFIX
+                if block_index_suffix is None
+                else block_index_suffix
+            ),
         )
         super().__init__(variant_tensor)
 
@@ -195,6 +222,9 @@ class AvroRecordDataset(tf.data.Dataset):
         reader_schema=None,
         deterministic=True,
         block_length=1,
+        byte_start=None,
+        byte_end=None,
+        block_index_suffix=None,
     ):
         """Creates a `AvroRecordDataset` to read one or more AvroRecord files.
         Args:
@@ -222,6 +252,16 @@ class AvroRecordDataset(tf.data.Dataset):
           deterministic: (Optional.) A boolean controlling whether determinism should be traded for performance by
           allowing elements to be produced out of order. Defaults to `True`
           block_length: Sets the number of output on the output tensor. Defaults to 1
+          byte_start: (Optional.) A python integer. Only the blocks whose sync marker
+            starts in [byte_start, byte_end) of each file are read, so that the
+            byte ranges of a large file can be read by different workers. Every
+            block belongs to exactly one range of a partition of the file.
+          byte_end: (Optional.) A python integer. A negative value or `None` reads
+            to the end of the file.
+          block_index_suffix: (Optional.) A python string. If set and the file
+            named filename + block_index_suffix exists, the block index written
+            by `write_avro_block_index` is used to find the first block of the
+            byte range instead of scanning for the next sync marker.
         Raises:
           TypeError: If any argument does not have the expected type.
           ValueError: If any argument does not have the expected shape.
@@ -254,7 +294,14 @@ class AvroRecordDataset(tf.data.Dataset):
         self._block_length = block_length
 
         def read_multiple_files(filenames):
-            return _AvroRecordDataset(filenames, buffer_size, reader_schema)
+            return _AvroRecordDataset(
+                filenames,
+                buffer_size,
+                reader_schema,
+                byte_start=byte_start,
+                byte_end=byte_end,
+                block_index_suffix=block_index_suffix,
+            )
 
         self._impl = _create_dataset_reader(
             read_multiple_files,
@@ -291,3 +338,20 @@ class AvroRecordDataset(tf.data.Dataset):
     @property
     def element_spec(self):
         return tf.TensorSpec([], tf.dtypes.string)
+
+
+def write_avro_block_index(filename, index_filename):
+    """Writes the block index of an Avro file.
+
+    The index holds the offset and the number of records of every block of the
+    file. `AvroRecordDataset` uses it with `block_index_suffix` to open a byte
+    range of the file without reading the prefix.
+
+    Args:
+      filename: A `tf.string` scalar, the Avro file.
+      index_filename: A `tf.string` scalar, the file the index is written to.
+
+    Returns:
+      A `tf.int64` scalar with the number of blocks in the file.
+    """
+    return core_ops.io_write_avro_block_index(filename, index_filename)
@@ -16,6 +16,34 @@
 
 import tensorflow as tf
 
+from tensorflow_io.python.ops import core_ops
+
+
+# The XYZ white points of the illuminants, by aperture angle of the observer.
+_ILLUMINANTS = {
+    "A": {
+        "2": (1.098466069456375, 1, 0.3558228003436005),
+        "10": (1.111420406956693, 1, 0.3519978321919493),
+    },
+    "D50": {
+        "2": (0.9642119944211994, 1, 0.8251882845188288),
+        "10": (0.9672062750333777, 1, 0.8142801513128616),
+    },
+    "D55": {
+        "2": (0.956797052643698, 1, 0.9214805860173273),
+        "10": (0.9579665682254781, 1, 0.9092525159847462),
+    },
+    "D65": {
+        "2": (0.95047, 1.0, 1.08883),
+        "10": (0.94809667673716, 1, 1.0730513595166162),
+    },
+    "D75": {
+        "2": (0.9497220898840717, 1, 1.226393520724154),
+        "10": (0.9441713925645873, 1, 1.2064272211720228),
+    },
+    "E": {"2": (1.0, 1.0, 1.0), "10": (1.0, 1.0, 1.0)},
+}
+
 
 def rgb_to_bgr(input, name=None):
     """
@@ -93,24 +121,10 @@ def rgb_to_ycbcr(input, name=None):
     Returns:
       A 3-D (`[H, W, 3]`) or 4-D (`[N, H, W, 3]`) Tensor.
     """
-    kernel = tf.constant(
-        [
-            [65.783, 129.057, 25.064],
-            [-37.945, -74.494, 112.439],
-            [112.439, -94.154, -18.285],
-        ],
-        tf.float32,
-    )
-
     input = tf.convert_to_tensor(input)
     assert input.dtype == tf.uint8
 
-    value = tf.cast(input, tf.float32)
-    value = value / 256.0
-    value = tf.tensordot(value, tf.transpose(kernel), axes=((-1,), (0,)))
-    value = value + tf.constant([16, 128, 128], tf.float32)
-    value = tf.clip_by_value(value, 0, 255)
-    return tf.cast(value, input.dtype)
+    return core_ops.io_convert_color(input, conversion="rgb_to_ycbcr", name=name)
 
 
 def ycbcr_to_rgb(input, name=None):
@@ -124,24 +138,10 @@ def ycbcr_to_rgb(input, name=None):
     Returns:
       A 3-D (`[H, W, 3]`) or 4-D (`[N, H, W, 3]`) Tensor.
     """
-    kernel = tf.constant(
-        [
-            [298.082, 0, 408.583],
-            [298.082, -100.291, -208.120],
-            [298.082, 516.412, 0],
-        ],
-        tf.float32,
-    )
-
     input = tf.convert_to_tensor(input)
     assert input.dtype == tf.uint8
 
-    value = tf.cast(input, tf.float32)
-    value = value / 256.0
-    value = tf.tensordot(value, tf.transpose(kernel), axes=((-1,), (0,)))
-    value = value + tf.constant([-222.921, 135.576, -276.836], tf.float32)
-    value = tf.clip_by_value(value, 0, 255)
-    return tf.cast(value, input.dtype)
+    return core_ops.io_convert_color(input, conversion="ycbcr_to_rgb", name=name)
 
 
 def rgb_to_ypbpr(input, name=None):
@@ -157,6 +157,8 @@ def rgb_to_ypbpr(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="rgb_to_ypbpr", name=name)
 
     kernel = tf.constant(
         [
@@ -183,6 +185,8 @@ def ypbpr_to_rgb(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="ypbpr_to_rgb", name=name)
 
     # inv of:
     # [[ 0.299   , 0.587   , 0.114   ],
@@ -213,6 +217,8 @@ def rgb_to_ydbdr(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="rgb_to_ydbdr", name=name)
 
     kernel = tf.constant(
         [[0.299, 0.587, 0.114], [-0.45, -0.883, 1.333], [-1.333, 1.116, 0.217]],
@@ -235,6 +241,8 @@ def ydbdr_to_rgb(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="ydbdr_to_rgb", name=name)
 
     # inv of:
     # [[    0.299,   0.587,    0.114],
@@ -361,6 +369,8 @@ def rgb_to_xyz(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="rgb_to_xyz", name=name)
 
     kernel = tf.constant(
         [
@@ -391,6 +401,8 @@ def xyz_to_rgb(input, name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(input, conversion="xyz_to_rgb", name=name)
 
     # inv of:
     # [[0.412453, 0.35758 , 0.180423],
@@ -431,30 +443,12 @@ def rgb_to_lab(input, illuminant="D65", observer="2", name=None):
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
 
-    illuminants = {
-        "A": {
-            "2": (1.098466069456375, 1, 0.3558228003436005),
-            "10": (1.111420406956693, 1, 0.3519978321919493),
-        },
-        "D50": {
-            "2": (0.9642119944211994, 1, 0.8251882845188288),
-            "10": (0.9672062750333777, 1, 0.8142801513128616),
-        },
-        "D55": {
-            "2": (0.956797052643698, 1, 0.9214805860173273),
-            "10": (0.9579665682254781, 1, 0.9092525159847462),
-        },
-        "D65": {
-            "2": (0.95047, 1.0, 1.08883),
-            "10": (0.94809667673716, 1, 1.0730513595166162),
-        },
-        "D75": {
-            "2": (0.9497220898840717, 1, 1.226393520724154),
-            "10": (0.9441713925645873, 1, 1.2064272211720228),
-        },
-        "E": {"2": (1.0, 1.0, 1.0), "10": (1.0, 1.0, 1.0)},
-    }
-    coords = tf.constant(illuminants[illuminant.upper()][observer], input.dtype)
+    white = _ILLUMINANTS[illuminant.upper()][observer]
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(
+            input, conversion="rgb_to_lab", white=white, name=name
+        )
+    coords = tf.constant(white, input.dtype)
 
     xyz = rgb_to_xyz(input)
 
@@ -494,6 +488,11 @@ def lab_to_rgb(input, illuminant="D65", observer="2", name=None):
     """
     input = tf.convert_to_tensor(input)
     assert input.dtype in (tf.float16, tf.float32, tf.float64)
+    white = _ILLUMINANTS[illuminant.upper()][observer]
+    if input.dtype == tf.float32:
+        return core_ops.io_convert_color(
+            input, conversion="lab_to_rgb", white=white, name=name
+        )
 
     lab = input
     lab = tf.unstack(lab, axis=-1)
@@ -513,30 +512,7 @@ def lab_to_rgb(input, illuminant="D65", observer="2", name=None):
         (xyz - 16.0 / 116.0) / 7.787,
     )
 
-    illuminants = {
-        "A": {
-            "2": (1.098466069456375, 1, 0.3558228003436005),
-            "10": (1.111420406956693, 1, 0.3519978321919493),
-        },
-        "D50": {
-            "2": (0.9642119944211994, 1, 0.8251882845188288),
-            "10": (0.9672062750333777, 1, 0.8142801513128616),
-        },
-        "D55": {
-            "2": (0.956797052643698, 1, 0.9214805860173273),
-            "10": (0.9579665682254781, 1, 0.9092525159847462),
-        },
-        "D65": {
-            "2": (0.95047, 1.0, 1.08883),
-            "10": (0.94809667673716, 1, 1.0730513595166162),
-        },
-        "D75": {
-            "2": (0.9497220898840717, 1, 1.226393520724154),
-            "10": (0.9441713925645873, 1, 1.2064272211720228),
-        },
-        "E": {"2": (1.0, 1.0, 1.0), "10": (1.0, 1.0, 1.0)},
-    }
-    coords = tf.constant(illuminants[illuminant.upper()][observer], input.dtype)
+    coords = tf.constant(white, input.dtype)
 
     xyz = xyz * coords
 
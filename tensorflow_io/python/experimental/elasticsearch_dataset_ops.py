@@ -25,11 +25,25 @@ class _ElasticsearchHandler:
     session data.
     """
 
-    def __init__(self, nodes, index, doc_type, headers_dict):
+    def __init__(
+        self,
+        nodes,
+        index,
+        doc_type,
+        headers_dict,
+        columns=None,
+        num_slices=None,
+        page_size=None,
+        point_in_time=False,
+    ):
         self.nodes = nodes
         self.index = index
         self.doc_type = doc_type
         self.headers_dict = headers_dict
+        self.columns = [] if columns is None else list(columns)
+        self.num_slices = 1 if num_slices is None else num_slices
+        self.page_size = 0 if page_size is None else page_size
+        self.point_in_time = point_in_time
         self.prepare_base_urls()
         self.prepare_connection_data()
 
@@ -67,14 +81,23 @@ class _ElasticsearchHandler:
             f"{base_url}/_cluster/health" for base_url in self.base_urls
         ]
         self.request_urls = []
+        self.pit_urls = []
+        if self.point_in_time and self.doc_type is not None:
+            raise ValueError("A point in time can not be searched by doc_type")
         for base_url in self.base_urls:
-            if self.doc_type is None:
+            if self.point_in_time:
+                # The point in time, rather than the url, names the index.
+                request_url = f"{base_url}/_search"
+                self.pit_urls.append(f"{base_url}/{self.index}/_pit?keep_alive=1m")
+            elif self.doc_type is None:
                 request_url = f"{base_url}/{self.index}/_search?scroll=1m"
             else:
                 request_url = "{}/{}/{}/_search?scroll=1m".format(
                     base_url, self.index, self.doc_type
                 )
             self.request_urls.append(request_url)
+            if not self.point_in_time:
+                self.pit_urls.append("")
 
         self.headers = ["Content-Type=application/json"]
         if self.headers_dict is not None:
@@ -91,8 +114,8 @@ class _ElasticsearchHandler:
     def get_healthy_resource(self):
         """Retrieve the resource which is connected to a healthy node"""
 
-        for healthcheck_url, request_url in zip(
-            self.healthcheck_urls, self.request_urls
+        for healthcheck_url, request_url, pit_url in zip(
+            self.healthcheck_urls, self.request_urls, self.pit_urls
         ):
             try:
                 resource, columns, raw_dtypes = core_ops.io_elasticsearch_readable_init(
@@ -100,6 +123,10 @@ class _ElasticsearchHandler:
                     healthcheck_field="status",
                     request_url=request_url,
                     headers=self.headers,
+                    columns=self.columns,
+                    num_slices=self.num_slices,
+                    page_size=self.page_size,
+                    pit_url=pit_url,
                 )
                 print(f"Connection successful: {healthcheck_url}")
                 dtypes = []
@@ -223,9 +250,31 @@ class ElasticsearchIODataset(tf.compat.v2.data.Dataset):
                     index="people",
                     doc_type="survivors",
                     headers=HEADERS)
+
+    Large indices are read faster by restricting the documents to the
+    `columns` needed, returning more of them per request with `page_size`
+    and searching `num_slices` slices of the index in parallel:
+
+    >>> dataset = tfio.experimental.elasticsearch.ElasticsearchIODataset(
+                    nodes=["localhost:9092"],
+                    index="people",
+                    columns=["fare", "age", "survived"],
+                    num_slices=4,
+                    page_size=1000)
     """
 
-    def __init__(self, nodes, index, doc_type=None, headers=None, internal=True):
+    def __init__(
+        self,
+        nodes,
+        index,
+        doc_type=None,
+        headers=None,
+        columns=None,
+        num_slices=None,
+        page_size=None,
+        point_in_time=False,
+        internal=True,
+    ):
         """Prepare the ElasticsearchIODataset.
 
         Args:
@@ -237,12 +286,30 @@ class ElasticsearchIODataset(tf.compat.v2.data.Dataset):
                 in the index to query.
             headers: (Optional) A dict of headers. For example:
                 {'Content-Type': 'application/json'}
+            columns: (Optional) A list of the fields of the documents to
+                return, all of them by default.
+            num_slices: (Optional) The number of slices of the index which are
+                searched in parallel, each over a connection of its own. The
+                order of the documents is then not deterministic.
+            page_size: (Optional) The number of documents per request, the
+                cluster default (10) by default.
+            point_in_time: (Optional) Whether to page through a point in time
+                of the index with `search_after` rather than through a scroll
+                context. Requires Elasticsearch 7.12 or later and can not be
+                combined with `doc_type`. Defaults to False.
         """
         with tf.name_scope("ElasticsearchIODataset"):
             assert internal
 
             handler = _ElasticsearchHandler(
-                nodes=nodes, index=index, doc_type=doc_type, headers_dict=headers
+                nodes=nodes,
+                index=index,
+                doc_type=doc_type,
+                headers_dict=headers,
+                columns=columns,
+                num_slices=num_slices,
+                page_size=page_size,
+                point_in_time=point_in_time,
             )
             resource, columns, dtypes, request_url = handler.get_healthy_resource()
 
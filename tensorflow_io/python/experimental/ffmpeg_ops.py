@@ -18,6 +18,11 @@
 def decode_video(content, index=0, name=None):
     """Decode video stream from a video file.
 
+    Video is decoded on a hardware device when the environment variable
+    `FFMPEG_HWACCEL` is set to its type, e.g. `vaapi`, `cuda` or `qsv`, with
+    `FFMPEG_HWACCEL_DEVICE` optionally picking the device. Decoding falls back
+    to software when the device or the codec does not support it.
+
     Args:
       content: A `Tensor` of type `string`.
       index: The stream index.
@@ -19,9 +19,9 @@ from tensorflow_io.python.ops import core_ops
 
 
 @tf.function
-def to_file(dataset, filename):
+def to_file(dataset, filename, buffer_size=0):
     """to_file"""
-    resource = core_ops.io_file_init(filename)
+    resource = core_ops.io_file_init(filename, buffer_size=buffer_size)
 
     dataset = dataset.map(lambda e: (e, tf.constant(False)))
     dataset = dataset.concatenate(
@@ -34,3 +34,26 @@ def set_configuration(scheme, key, value, name=None):
     return core_ops.io_file_system_set_configuration(
         scheme, key=key, value=value, name=name
     )
+
+
+def memory_budget_usage(name=None):
+    """
+    Report the memory held by the readers, prefetchers and caches of
+    tensorflow-io, which share the process-wide budget of
+    `TFIO_MEMORY_BUDGET_MB` megabytes (unlimited if unset).
+
+    Args:
+      name: A name for the operation (optional).
+
+    Returns:
+      A dict of the bytes and peak bytes held by each component, e.g.
+      `{"atds": {"bytes": ..., "peak_bytes": ...}}`, and the limit in bytes,
+      0 if unlimited.
+    """
+
+    component, size, peak, limit = core_ops.io_memory_budget_usage(name=name)
+    usage = {
+        c.decode(): {"bytes": int(b), "peak_bytes": int(p)}
+        for c, b, p in zip(component.numpy(), size.numpy(), peak.numpy())
+    }
+    return usage, int(limit.numpy())
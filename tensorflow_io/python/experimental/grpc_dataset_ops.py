@@ -21,16 +21,22 @@ from tensorflow_io.python.ops import core_ops
 class GRPCStreamIODataset(tf.data.Dataset):
     """GRPCStreamIODataset"""
 
-    def __init__(self, endpoint, shape, dtype):
+    def __init__(self, endpoint, shape, dtype, stream=False, in_flight=None):
         """Create a GRPC Reader.
 
         Args:
             endpoint: A `tf.string` tensor containing one or more endpoints.
+            stream: If True, the records are pushed by the server through a
+              streaming call instead of being requested range by range.
+            in_flight: The number of range requests kept pending, so that the
+              next ranges are fetched while one is consumed (default 1).
         """
         with tf.name_scope("GRPCStreamIODataset"):
             shape = tf.cast(shape, tf.int64)
 
-            resource = core_ops.io_grpc_readable_init(endpoint)
+            resource = core_ops.io_grpc_readable_init(
+                endpoint, stream=stream, in_flight=in_flight or 1
+            )
 
             self._resource = resource
             self._shape = tf.cast(shape, tf.int64)
@@ -61,7 +67,7 @@ class GRPCStreamIODataset(tf.data.Dataset):
             )  # pylint: disable=protected-access
 
     @staticmethod
-    def from_numpy(a, internal=False):
+    def from_numpy(a, stream=False, in_flight=None, internal=False):
         """from_numpy"""
         assert internal
 
@@ -75,7 +81,9 @@ class GRPCStreamIODataset(tf.data.Dataset):
         print("ENDPOINT: ", endpoint)
         dtype = a.dtype
         shape = list(a.shape)
-        dataset = GRPCStreamIODataset(endpoint, shape, dtype)
+        dataset = GRPCStreamIODataset(
+            endpoint, shape, dtype, stream=stream, in_flight=in_flight
+        )
         dataset._grpc_server = grpc_server  # pylint: disable=protected-access
         return dataset
 
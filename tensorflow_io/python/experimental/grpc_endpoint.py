@@ -36,13 +36,14 @@ import endpoint_pb2_grpc  # pylint: disable=wrong-import-position
 class GRPCEndpoint(endpoint_pb2_grpc.GRPCEndpointServicer):
     """GRPCEndpoint"""
 
-    def __init__(self, data):
+    def __init__(self, data, chunk_size=1024):
         self._grpc_server = grpc.server(
             concurrent.futures.ThreadPoolExecutor(max_workers=4)
         )
         port = self._grpc_server.add_insecure_port("localhost:0")
         self._endpoint = "localhost:" + str(port)
         self._data = data
+        self._chunk_size = chunk_size
         super().__init__()
         endpoint_pb2_grpc.add_GRPCEndpointServicer_to_server(self, self._grpc_server)
 
@@ -68,3 +69,16 @@ class GRPCEndpoint(endpoint_pb2_grpc.GRPCEndpointServicer):
         record = google.protobuf.any_pb2.Any()
         record.Pack(tensor)
         return endpoint_pb2.Response(record=record)
+
+    def StreamRecord(self, request, context):  # pylint: disable=unused-argument
+        """StreamRecord"""
+        stop = len(self._data)
+        if request.length > 0:
+            stop = min(stop, request.offset + request.length)
+        for offset in range(request.offset, stop, self._chunk_size):
+            tensor = tf.compat.v1.make_tensor_proto(
+                self._data[offset : min(offset + self._chunk_size, stop)]
+            )
+            record = google.protobuf.any_pb2.Any()
+            record.Pack(tensor)
+            yield endpoint_pb2.Response(record=record)
@@ -87,6 +87,30 @@ def decode_tiff(contents, index=0, name=None):
     return core_ops.io_decode_tiff(contents, index, name=name)
 
 
+def decode_tiff_region(filename, region, index=0, name=None):
+    """
+    Decode a region of a TIFF file to a uint8 tensor.
+
+    Only the tiles or strips the region intersects are read from the file
+    and decoded, in parallel, which suits images too large to be decoded
+    whole, such as whole slide images.
+
+    Args:
+      filename: A `Tensor` of type `string`. 0-D. The TIFF file.
+      region: A 1-D int64 `Tensor` of 4 elements: y, x, height, width of
+        the region.
+      index: A `Tensor` of type int64. 0-D. The 0-based index of the frame
+        inside TIFF file, such as the level of a pyramid.
+      name: A name for the operation (optional).
+
+    Returns:
+      A `Tensor` of type `uint8` and shape of `[height, width, 4]` (RGBA).
+    """
+    return core_ops.io_decode_tiff_region(
+        filename, index, tf.cast(region, tf.int64), name=name
+    )
+
+
 def decode_exr_info(contents, name=None):
     """
     Decode a EXR-encoded image meta data.
@@ -102,22 +126,43 @@ def decode_exr_info(contents, name=None):
     return shape, dtype, channel
 
 
-def decode_exr(contents, index, channel, dtype, name=None):
+def decode_exr(
+    contents, index, channel, dtype, start=0, count=-1, threads=0, name=None
+):
     """
     Decode a EXR-encoded image to a uint8 tensor.
 
+    Only the channels and rows asked for are decoded, in one pass over the
+    image.
+
     Args:
       contents: A `Tensor` of type `string`. 0-D.  The EXR-encoded image.
       index: A `Tensor` of type int64. 0-D. The 0-based index of the frame
         inside EXR-encoded image.
-      channel: A `Tensor` of type string. 0-D. The channel inside the image.
+      channel: A `Tensor` of type string. 0-D or 1-D. The channel, or the
+        channels, inside the image.
+      dtype: The data type the channels are decoded to, such as `tf.float16`
+        for half channels.
+      start: The first row of the data window to decode. Default `0`.
+      count: The number of rows to decode from `start`, or `-1` for all the
+        remaining rows. Default `-1`.
+      threads: The number of threads to decode with, or `0` to decode on
+        the calling thread. Default `0`.
       name: A name for the operation (optional).
 
     Returns:
-      A `Tensor` of type `uint8` and shape of `[height, width, 4]` (RGBA).
+      A `Tensor` of type `dtype` and shape of `[height, width]`, or of
+      `[height, width, channels]` if `channel` is 1-D.
     """
     return core_ops.io_decode_exr(
-        contents, index=index, channel=channel, dtype=dtype, name=name
+        contents,
+        index=index,
+        channel=channel,
+        dtype=dtype,
+        start=start,
+        count=count,
+        threads=threads,
+        name=name,
     )
 
 
@@ -149,65 +194,146 @@ def decode_hdr(contents, name=None):
     return core_ops.io_decode_hdr(contents, name=name)
 
 
-def decode_nv12(contents, size, name=None):
+def decode_nv12(contents, size, resize=None, name=None):
     """
-    Decode a NV12-encoded image to a uint8 tensor.
+    Decode a NV12-encoded image, or a batch of them, to a uint8 tensor.
+
+    A batch is decoded in parallel. With `resize`, the frames are scaled
+    before the conversion to RGB, which is faster than resizing the RGB
+    images afterwards.
 
     Args:
-      contents: A `Tensor` of type `string`. 0-D.  The NV12-encoded image.
+      contents: A `Tensor` of type `string`. 0-D or 1-D.  The NV12-encoded
+        image, or a batch of them.
       size: A 1-D int32 Tensor of 2 elements: height, width. The size
         for the images.
+      resize: An optional 1-D int32 Tensor of 2 elements: height, width.
+        The size to resize the images to.
       name: A name for the operation (optional).
 
     Returns:
-      A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB).
+      A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB),
+      or `[N, height, width, 3]` for a batch.
     """
-    return core_ops.io_decode_nv12(contents, size=size, name=name)
-
-
-def decode_yuy2(contents, size, name=None):
+    contents = tf.convert_to_tensor(contents)
+    if resize is None and contents.shape.rank == 0:
+        return core_ops.io_decode_nv12(contents, size=size, name=name)
+    resize = size if resize is None else resize
+    if contents.shape.rank == 0:
+        return core_ops.io_decode_nv12_batch(
+            tf.expand_dims(contents, 0), size=size, resize=resize, name=name
+        )[0]
+    return core_ops.io_decode_nv12_batch(contents, size=size, resize=resize, name=name)
+
+
+def decode_yuy2(contents, size, resize=None, name=None):
     """
-    Decode a YUY2-encoded image to a uint8 tensor.
+    Decode a YUY2-encoded image, or a batch of them, to a uint8 tensor.
+
+    A batch is decoded in parallel. With `resize`, the frames are scaled
+    before the conversion to RGB, which is faster than resizing the RGB
+    images afterwards.
 
     Args:
-      contents: A `Tensor` of type `string`. 0-D.  The YUY2-encoded image.
+      contents: A `Tensor` of type `string`. 0-D or 1-D.  The YUY2-encoded
+        image, or a batch of them.
       size: A 1-D int32 Tensor of 2 elements: height, width. The size
         for the images.
+      resize: An optional 1-D int32 Tensor of 2 elements: height, width.
+        The size to resize the images to.
       name: A name for the operation (optional).
 
     Returns:
-      A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB).
+      A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB),
+      or `[N, height, width, 3]` for a batch.
     """
-    return core_ops.io_decode_yuy2(contents, size=size, name=name)
-
-
-def decode_avif(contents, name=None):
+    contents = tf.convert_to_tensor(contents)
+    if resize is None and contents.shape.rank == 0:
+        return core_ops.io_decode_yuy2(contents, size=size, name=name)
+    resize = size if resize is None else resize
+    if contents.shape.rank == 0:
+        return core_ops.io_decode_yuy2_batch(
+            tf.expand_dims(contents, 0), size=size, resize=resize, name=name
+        )[0]
+    return core_ops.io_decode_yuy2_batch(contents, size=size, resize=resize, name=name)
+
+
+def decode_avif(contents, codec="auto", threads=1, name=None):
     """
     Decode a AVIF-encoded image to a uint8 tensor.
 
     Args:
       contents: A `Tensor` of type `string`. 0-D.  The AVIF-encoded image.
+      codec: The AV1 decoder to use, one of `auto`, `dav1d` and `libgav1`.
+        Default `auto`.
+      threads: The maximum number of threads the AV1 decoder may use.
+        Default `1`.
       name: A name for the operation (optional).
 
     Returns:
       A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB).
     """
-    return core_ops.io_decode_avif(contents, name=name)
+    return core_ops.io_decode_avif(contents, codec=codec, threads=threads, name=name)
 
 
-def decode_jp2(contents, dtype=tf.uint8, name=None):
+def decode_jp2(
+    contents, dtype=tf.uint8, region=None, reduce=0, threads=1, name=None
+):
     """
     Decode a JPEG2000-encoded image to a uint8 tensor.
 
+    Only the code blocks of the region and of the resolution levels kept are
+    decoded, so that crops and thumbnails cost a fraction of a full decode.
+
     Args:
       contents: A `Tensor` of type `string`. 0-D.  The JPEG200-encoded image.
       dtype: Data type of the decoded image. Default `tf.uint8`.
+      region: An optional 1-D int64 `Tensor` of 4 elements: y, x, height,
+        width of the region to decode, at the full resolution. Default is
+        the whole image.
+      reduce: The number of resolution levels to discard, each of which
+        halves the height and width of the image. Default `0`.
+      threads: The number of threads to decode with, or `0` for one per
+        CPU. Default `1`.
       name: A name for the operation (optional).
 
     Returns:
       A `Tensor` of type `uint8` and shape of `[height, width, 3]` (RGB).
     """
-    return core_ops.io_decode_jpeg2k(contents, dtype=dtype, name=name)
+    if region is None:
+        region = tf.zeros([0], tf.int64)
+    return core_ops.io_decode_jpeg2k(
+        contents,
+        tf.cast(region, tf.int64),
+        dtype=dtype,
+        reduce=reduce,
+        threads=threads,
+        name=name,
+    )
+
+
+def decode_image_batch(contents, size, channels=3, name=None):
+    """
+    Decode a batch of images of mixed formats to a uint8 tensor.
+
+    The format of each image is detected from its magic bytes, among WebP,
+    AVIF, JPEG, PNG, BMP, GIF (first frame), HDR and PNM. The images are
+    decoded in parallel and resized to `size`, which WebP images are scaled
+    to by the decoder itself.
+
+    Args:
+      contents: A `Tensor` of type `string`. 1-D. The encoded images.
+      size: A 1-D int32 Tensor of 2 elements: height, width. The size to
+        resize the images to.
+      channels: The number of channels of the output, 3 (RGB) or 4 (RGBA).
+      name: A name for the operation (optional).
+
+    Returns:
+      A `Tensor` of type `uint8` and shape of `[N, height, width, channels]`.
+    """
+    return core_ops.io_decode_image_batch(
+        contents, size=size, channels=channels, name=name
+    )
 
 
 def decode_obj(contents, name=None):
@@ -223,3 +349,48 @@ def decode_obj(contents, name=None):
       A `Tensor` of type `float32` and shape of `[n, 3]` for vertices.
     """
     return core_ops.io_decode_obj(contents, name=name)
+
+
+def decode_obj_batch(contents, name=None):
+    """
+    Decode a batch of Wavefront (obj) files.
+
+    The meshes are decoded in parallel in one op. Faces are triangulated,
+    and each corner of a triangle has the indices of its vertex, normal and
+    texture coordinate in its mesh, or -1 if it has none.
+
+    Args:
+      contents: A `Tensor` of type `string`. The contents of the Wavefront
+        (.obj) files.
+      name: A name for the operation (optional).
+
+    Returns:
+      A dict of `RaggedTensor`s: `vertices` of `[batch, (n), 3]` float32,
+      `normals` of `[batch, (n), 3]` float32, `texcoords` of
+      `[batch, (n), 2]` float32 and `indices` of `[batch, (n), 3]` int32,
+      with 3 corners per triangle.
+    """
+    (
+        vertices,
+        vertex_splits,
+        normals,
+        normal_splits,
+        texcoords,
+        texcoord_splits,
+        indices,
+        index_splits,
+    ) = core_ops.io_decode_obj_batch(tf.reshape(contents, [-1]), name=name)
+    return {
+        "vertices": tf.RaggedTensor.from_row_splits(
+            vertices, vertex_splits, validate=False
+        ),
+        "normals": tf.RaggedTensor.from_row_splits(
+            normals, normal_splits, validate=False
+        ),
+        "texcoords": tf.RaggedTensor.from_row_splits(
+            texcoords, texcoord_splits, validate=False
+        ),
+        "indices": tf.RaggedTensor.from_row_splits(
+            indices, index_splits, validate=False
+        ),
+    }
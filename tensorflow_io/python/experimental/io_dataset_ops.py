@@ -100,19 +100,25 @@ class IODataset(io_dataset.IODataset):
             return image_dataset_ops.TIFFIODataset(filename, internal=True)
 
     @classmethod
-    def from_kinesis(cls, stream, shard="", **kwargs):
+    def from_kinesis(cls, stream, shard="", limit=None, consumer=None, **kwargs):
         """Creates an `IODataset` from a Kinesis stream.
 
         Args:
           stream: A string, the stream name.
-          shard: A string, the shard of kinesis.
+          shard: A string, the shard of kinesis, all shards if empty.
+          limit: The maximum number of records per `GetRecords` call
+            (optional).
+          consumer: The ARN of a consumer registered for enhanced fan-out
+            (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
           A `IODataset`.
         """
         with tf.name_scope(kwargs.get("name", "IOFromKinesis")):
-            return kinesis_dataset_ops.KinesisIODataset(stream, shard, internal=True)
+            return kinesis_dataset_ops.KinesisIODataset(
+                stream, shard, limit=limit, consumer=consumer, internal=True
+            )
 
     @classmethod
     def from_numpy(cls, a, **kwargs):
@@ -147,6 +153,9 @@ class IODataset(io_dataset.IODataset):
           a: dict, tuple, or array_like
             numpy array if the input type is array_like;
             dict or tuple of numpy arrays if the input type is dict or tuple.
+          gpu_compatible: Whether the arrays are copied into host memory
+            that is fast to copy to a GPU, e.g. pinned memory, for a
+            dataset fed to one (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -155,7 +164,9 @@ class IODataset(io_dataset.IODataset):
 
         """
         with tf.name_scope(kwargs.get("name", "IOFromNumpy")):
-            return numpy_dataset_ops.NumpyIODataset(a, internal=True)
+            return numpy_dataset_ops.NumpyIODataset(
+                a, gpu_compatible=kwargs.get("gpu_compatible", False), internal=True
+            )
 
     @classmethod
     def from_numpy_file(cls, filename, spec=None, **kwargs):
@@ -181,6 +192,10 @@ class IODataset(io_dataset.IODataset):
             spec then it is assumed that numpy file consists of `arr_0`, `arr_2`...
             If a dict is provided then numpy file should consists of named
             elements.
+          gpu_compatible: Whether the arrays are read into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, instead of being
+            mapped from the file, for a dataset fed to one (optional,
+            default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -189,11 +204,16 @@ class IODataset(io_dataset.IODataset):
         """
         with tf.name_scope(kwargs.get("name", "IOFromNumpyFile")):
             return numpy_dataset_ops.NumpyFileIODataset(
-                filename, spec=spec, internal=True
+                filename,
+                spec=spec,
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
             )
 
     @classmethod
-    def from_prometheus(cls, query, length, offset=None, endpoint=None, spec=None):
+    def from_prometheus(
+        cls, query, length, offset=None, endpoint=None, spec=None, window=None
+    ):
         """Creates an `GraphIODataset` from a prometheus endpoint.
 
         Args:
@@ -207,6 +227,9 @@ class IODataset(io_dataset.IODataset):
             The format should be {"job": {"instance": {"name": tf.TensorSpec}}}.
             In graph mode, spec is needed. In eager mode,
             spec is probed automatically.
+          window: An integer, the length (in seconds) of the windows that are
+            queried at once for all the series, and concurrently, by default
+            3600.
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -217,11 +240,11 @@ class IODataset(io_dataset.IODataset):
         )
 
         return prometheus_dataset_ops.PrometheusIODataset(
-            query, length, offset=offset, endpoint=endpoint, spec=spec
+            query, length, offset=offset, endpoint=endpoint, spec=spec, window=window
         )
 
     @classmethod
-    def from_sql(cls, query, endpoint=None, spec=None):
+    def from_sql(cls, query, endpoint=None, spec=None, batch_size=None):
         """Creates an `GraphIODataset` from a postgresql server endpoint.
 
         Args:
@@ -230,12 +253,17 @@ class IODataset(io_dataset.IODataset):
           spec: A structured (tuple) tf.TensorSpec of the dataset.
             In graph mode, spec is needed. In eager mode,
             spec is probed automatically.
+          batch_size: (Optional.) An integer, if set the rows are streamed
+            from a server-side cursor, `batch_size` rows at a time, instead
+            of holding the whole result set in memory.
           name: A name prefix for the IODataset (optional).
 
         Returns:
           A `IODataset`.
         """
-        return sql_dataset_ops.SQLIODataset(query, endpoint=endpoint, spec=spec)
+        return sql_dataset_ops.SQLIODataset(
+            query, endpoint=endpoint, spec=spec, batch_size=batch_size
+        )
 
     @classmethod
     def from_video(cls, filename):
@@ -257,13 +285,18 @@ class IODataset(io_dataset.IODataset):
         Args:
           dataset: A dataset whose content will be written to.
           filename: A string, the filename of the file to write to.
+          buffer_size: When positive, the records are buffered and appended
+            to the file in the background every `buffer_size` bytes
+            (optional, default 0 which writes each record as it comes).
           name: A name prefix for the IODataset (optional).
 
         Returns:
           The number of records written.
         """
         with tf.name_scope(kwargs.get("name", "IOToText")):
-            return file_dataset_ops.to_file(dataset, filename)
+            return file_dataset_ops.to_file(
+                dataset, filename, buffer_size=kwargs.get("buffer_size", 0)
+            )
 
 
 class StreamIODataset(tf.data.Dataset):
@@ -306,13 +339,31 @@ class StreamIODataset(tf.data.Dataset):
             )
 
     @classmethod
-    def from_pubsub(cls, subscription, endpoint=None, timeout=10000, **kwargs):
+    def from_pubsub(
+        cls,
+        subscription,
+        endpoint=None,
+        timeout=10000,
+        max_messages=None,
+        streaming=False,
+        max_outstanding_messages=None,
+        max_outstanding_bytes=None,
+        **kwargs
+    ):
         """Creates an `StreamIODataset` from a pubsub endpoint.
 
         Args:
           subscription: A string, the subscription of the pubsub messages.
           endpoint: A string, the address of pubsub endpoint.
           timeout: An integer, the timeout of the pubsub pull.
+          max_messages: An integer, the most messages per pull, up to 1000
+            (default).
+          streaming: A boolean, whether to receive the messages through a
+            StreamingPull stream.
+          max_outstanding_messages: An integer, the flow control limit of
+            unacknowledged messages of the stream (optional).
+          max_outstanding_bytes: An integer, the flow control limit of
+            unacknowledged bytes of the stream (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -320,7 +371,14 @@ class StreamIODataset(tf.data.Dataset):
         """
         with tf.name_scope(kwargs.get("name", "IOFromPubSub")):
             return pubsub_dataset_ops.PubSubStreamIODataset(
-                subscription, endpoint=endpoint, timeout=timeout, internal=True
+                subscription,
+                endpoint=endpoint,
+                timeout=timeout,
+                max_messages=max_messages,
+                streaming=streaming,
+                max_outstanding_messages=max_outstanding_messages,
+                max_outstanding_bytes=max_outstanding_bytes,
+                internal=True,
             )
 
     @classmethod
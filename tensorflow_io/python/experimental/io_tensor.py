@@ -17,6 +17,7 @@
 import tensorflow as tf
 from tensorflow_io.python.ops import io_tensor
 from tensorflow_io.python.experimental import openexr_io_tensor_ops
+from tensorflow_io.python.experimental import raster_io_tensor_ops
 
 
 class IOTensor(io_tensor.IOTensor):
@@ -40,3 +41,21 @@ class IOTensor(io_tensor.IOTensor):
         """
         with tf.name_scope(kwargs.get("name", "IOFromOpenEXR")):
             return openexr_io_tensor_ops.EXRIOTensor(filename, internal=True)
+
+    @classmethod
+    def from_raster(cls, filename, **kwargs):
+        """Creates an `IOTensor` from a PNM, BMP or HDR file.
+
+        The rows of the image are read from the file as the `IOTensor` is
+        sliced, instead of decoding the whole image at once.
+
+        Args:
+          filename: A string, the filename of a PNM, BMP or HDR file.
+          name: A name prefix for the IOTensor (optional).
+
+        Returns:
+          A `IOTensor`.
+
+        """
+        with tf.name_scope(kwargs.get("name", "IOFromRaster")):
+            return raster_io_tensor_ops.RasterIOTensor(filename, internal=True)
@@ -145,6 +145,17 @@ class KafkaGroupIODataset(tf.data.Dataset):
               prefixed with `conf.topic.`. Examples include
               ["conf.topic.auto.offset.reset=earliest"]
             Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+            Partition fetchers: with
+              "conf.partition.fetch.queue.max.messages=<n>" each assigned
+              partition is fetched by a background thread into a queue of up
+              to n messages, so that ingestion scales with the partitions.
+              The fetchers are rebuilt on every rebalance.
+            Explicit commits: with "conf.commit.interval.ms=<n>" the auto
+              commit is disabled, and the offsets of the messages of a batch
+              are committed with commitAsync once the next batch is
+              requested, coalesced across batches to one commit every n ms.
+              Pending offsets are committed synchronously on a rebalance and
+              when the dataset is released.
           internal: Whether the dataset is being created from within the named scope.
             Default: True
         """
@@ -25,7 +25,14 @@ class KafkaIOLayer(tf.keras.layers.Layer):
     # KafkaIOLayer
     # =============================================================================
     def __init__(self, topic, partition, servers, configurations):
-        """Obtain a Kafka IO layer to be used with tf.keras."""
+        """Obtain a Kafka IO layer to be used with tf.keras.
+
+        Messages are produced asynchronously and batched per the producer
+        configurations, e.g. `linger.ms`, `batch.size` and `compression.codec`.
+        A delivery failure is raised by a later call or by `sync`, which waits
+        for all messages to be delivered and is only needed at the end of a
+        step or of training.
+        """
         metadata = list(configurations or [])
         if servers is not None:
             metadata.append("bootstrap.servers=%s" % servers)
@@ -45,20 +45,34 @@ class KinesisIODataset(tf.data.Dataset):
     is `True`, then `KinesisIODataset` will keep retrying to retrieve data
     from the stream. If `read_indefinitely` is `False`, an `OutOfRangeError`
     is returned immediately instead.
+
+    Unless a shard is given, all shards of the stream are read, each of them
+    fetched in parallel by a thread of its own, with up to `limit` records per
+    `GetRecords` call. Given the ARN of a consumer registered with
+    `RegisterStreamConsumer`, the shards are read through enhanced fan-out
+    `SubscribeToShard` subscriptions instead, with records pushed by Kinesis.
     """
 
-    def __init__(self, stream, shard="", internal=False):
+    def __init__(self, stream, shard="", limit=None, consumer=None, internal=False):
         """Create a KinesisIODataset.
 
         Args:
           stream: A `tf.string` tensor containing the name of the stream.
-          shard: A `tf.string` tensor containing the id of the shard.
+          shard: A `tf.string` tensor containing the id of the shard, all shards
+            are read if empty.
+          limit: The maximum number of records per `GetRecords` call, and per
+            read, up to 10000 (default).
+          consumer: The ARN of a consumer registered for enhanced fan-out.
         """
         with tf.name_scope("KinesisIODataset"):
             assert internal
 
             metadata = []
             metadata.append("shard=%s" % shard)
+            if limit is not None:
+                metadata.append("limit=%d" % limit)
+            if consumer is not None:
+                metadata.append("consumer=%s" % consumer)
             resource = core_ops.io_kinesis_readable_init(stream, metadata)
 
             self._resource = resource
@@ -14,6 +14,7 @@
 # ==============================================================================
 """MongoDBIODatasets"""
 
+import json
 from urllib.parse import urlparse
 import tensorflow as tf
 from tensorflow_io.python.ops import core_ops
@@ -25,18 +26,43 @@ class _MongoDBHandler:
     session data.
     """
 
-    def __init__(self, uri, database, collection):
+    def __init__(
+        self,
+        uri,
+        database,
+        collection,
+        filter=None,
+        projection=None,
+        batch_size=None,
+        num_parallel_reads=None,
+        raw_bson=False,
+    ):
         self.uri = uri
         self.database = database
         self.collection = collection
+        self.filter = filter
+        self.projection = projection
+        self.batch_size = batch_size
+        self.num_parallel_reads = num_parallel_reads
+        self.raw_bson = raw_bson
 
     def get_healthy_resource(self):
         """Retrieve the resource which is connected to a healthy node"""
 
+        def to_json(value):
+            if value is None:
+                return ""
+            return value if isinstance(value, str) else json.dumps(value)
+
         resource = core_ops.io_mongo_db_readable_init(
             uri=self.uri,
             database=self.database,
             collection=self.collection,
+            filter=to_json(self.filter),
+            projection=to_json(self.projection),
+            batch_size=self.batch_size or 0,
+            num_parallel_reads=self.num_parallel_reads or 0,
+            raw_bson=self.raw_bson,
         )
         print(f"Connection successful: {self.uri}")
         return resource
@@ -48,7 +74,7 @@ class _MongoDBHandler:
         Args:
             resource: the init op resource.
         Returns:
-            A Tensor containing serialized JSON records.
+            A Tensor containing serialized JSON, or raw BSON, records.
         """
 
         return core_ops.io_mongo_db_readable_next(resource=resource)
@@ -82,7 +108,17 @@ class MongoDBIODataset(tf.data.Dataset):
 
     """
 
-    def __init__(self, uri, database, collection):
+    def __init__(
+        self,
+        uri,
+        database,
+        collection,
+        filter=None,
+        projection=None,
+        batch_size=None,
+        num_parallel_reads=None,
+        raw_bson=False,
+    ):
         """Initialize the dataset with the following parameters
 
         Args:
@@ -107,8 +143,30 @@ class MongoDBIODataset(tf.data.Dataset):
                 server or a replica set to connect to.
             collection: A string, representing the collection from which the documents
                 have to be retrieved.
+            filter: (Optional.) A dict or a JSON string, the query filter of the
+                documents to retrieve, evaluated by the server.
+            projection: (Optional.) A dict or a JSON string, the projection of the
+                fields to retrieve, evaluated by the server.
+            batch_size: (Optional.) An integer, the number of documents per batch of
+                the cursor, also the most records fetched per step.
+            num_parallel_reads: (Optional.) An integer, if greater than 1 the
+                collection is split into as many `_id` ranges, at bounds sampled
+                with `$sample`, and the ranges are read in parallel by cursors of
+                their own. The documents are then not in the collection order. The
+                split requires all `_id`s to be of one type, e.g. ObjectIds.
+            raw_bson: (Optional.) A boolean, whether the records are the raw BSON
+                documents instead of relaxed extended JSON.
         """
-        handler = _MongoDBHandler(uri=uri, database=database, collection=collection)
+        handler = _MongoDBHandler(
+            uri=uri,
+            database=database,
+            collection=collection,
+            filter=filter,
+            projection=projection,
+            batch_size=batch_size,
+            num_parallel_reads=num_parallel_reads,
+            raw_bson=raw_bson,
+        )
         resource = handler.get_healthy_resource()
         dataset = tf.data.experimental.Counter()
         dataset = dataset.map(lambda i: handler.get_next_batch(resource=resource))
@@ -46,9 +46,15 @@ class MongoDBWriter:
     ...    data = {"key{}".format(i): "value{}".format(i)}
     ...    writer.write(data)
 
+    Batches of documents, such as the outputs of inference over a batch of
+    examples, are better written with `write_batch`, which inserts them with
+    unordered bulk writes rather than with a round trip per document:
+
+    >>> writer.write_batch({"id": ids, "score": scores})
+
     """
 
-    def __init__(self, uri, database, collection):
+    def __init__(self, uri, database, collection, batch_size=None):
         """Initialize the dataset with the following parameters
 
         Args:
@@ -73,10 +79,13 @@ class MongoDBWriter:
                 server or a replica set to connect to.
             collection: A string, representing the collection from which the documents
                 have to be retrieved.
+            batch_size: (Optional.) An integer, the most documents `write_batch`
+                inserts with one bulk write. Defaults to 1000.
         """
         self.uri = uri
         self.database = database
         self.collection = collection
+        self.batch_size = batch_size or 1000
         self.resource = core_ops.io_mongo_db_writable_init(
             uri=self.uri,
             database=self.database,
@@ -90,6 +99,31 @@ class MongoDBWriter:
             resource=self.resource, record=json.dumps(doc)
         )
 
+    def write_batch(self, docs):
+        """Insert a batch of documents with unordered bulk writes.
+
+        Args:
+            docs: Either a dict of column tensors, all with the same number of
+                elements, written as a document per row with a field per column.
+                Or a list of json documents, or a string tensor of json
+                documents.
+        """
+
+        if isinstance(docs, dict):
+            names = list(docs.keys())
+            core_ops.io_mongo_db_writable_write_columns(
+                resource=self.resource,
+                names=names,
+                columns=[tf.reshape(docs[name], [-1]) for name in names],
+                batch_size=self.batch_size,
+            )
+            return
+        if not tf.is_tensor(docs):
+            docs = tf.constant([json.dumps(doc) for doc in docs], tf.string)
+        core_ops.io_mongo_db_writable_write(
+            resource=self.resource, record=docs, batch_size=self.batch_size
+        )
+
     def _delete_many(self, doc):
         """Delete all matching documents"""
 
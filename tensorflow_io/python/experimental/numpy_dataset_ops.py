@@ -23,7 +23,7 @@ from tensorflow_io.python.ops import core_ops
 class NumpyIODataset(tf.data.Dataset):
     """NumpyIODataset"""
 
-    def __init__(self, a, internal=True):
+    def __init__(self, a, gpu_compatible=False, internal=True):
         """NumpyIODataset."""
         with tf.name_scope("NumpyIODataset"):
             assert internal
@@ -53,6 +53,7 @@ class NumpyIODataset(tf.data.Dataset):
                             start=start,
                             stop=stop,
                             dtype=dtype,
+                            gpu_compatible=gpu_compatible,
                         )
                         for address, filename, array, shape, dtype in params
                     ],
@@ -85,7 +86,7 @@ class NumpyIODataset(tf.data.Dataset):
 class NumpyFileIODataset(tf.data.Dataset):
     """NumpyFileIODataset"""
 
-    def __init__(self, filename, spec=None, internal=True):
+    def __init__(self, filename, spec=None, gpu_compatible=False, internal=True):
         """NumpyFileIODataset."""
         with tf.name_scope("NumpyFileIODataset"):
             assert internal
@@ -171,6 +172,7 @@ class NumpyFileIODataset(tf.data.Dataset):
                             start=start,
                             stop=stop,
                             dtype=dtype,
+                            gpu_compatible=gpu_compatible,
                         )
                         for address, filename, array, shape, dtype in params
                     ],
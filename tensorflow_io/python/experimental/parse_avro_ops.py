@@ -27,7 +27,17 @@ from tensorflow_io.python.ops import core_ops
 # Only copied parts from `parse_example_v2` and `_parse_example_raw`
 
 
-def parse_avro(serialized, reader_schema, features, avro_names=None, name=None):
+def parse_avro(
+    serialized,
+    reader_schema,
+    features,
+    avro_names=None,
+    name=None,
+    confluent_wire_format=False,
+    writer_schemas=None,
+    numa_node=-1,
+    cpu_affinity="",
+):
     """
     Parses `avro` records into a `dict` of tensors.
 
@@ -64,6 +74,10 @@ def parse_avro(serialized, reader_schema, features, avro_names=None, name=None):
 
     Only works for batched serialized input!
 
+    Records produced by the Confluent schema registry serializers, e.g. the
+    messages of a `KafkaBatchIODataset`, are parsed in place with
+    `confluent_wire_format=True`, which skips the header of each record.
+
     Args:
         serialized: The batched, serialized string tensors.
 
@@ -79,6 +93,22 @@ def parse_avro(serialized, reader_schema, features, avro_names=None, name=None):
 
         name: The name of the op.
 
+        confluent_wire_format: (Optional.) Whether each record starts with the
+        Confluent wire format header, a zero magic byte followed by the
+        big-endian id of its writer schema in the schema registry.
+
+        writer_schemas: (Optional.) A dict from schema registry ids to writer
+        schemas, records of writer schemas that differ from the reader schema
+        are resolved into it. Without it, records are assumed to be written
+        with the reader schema. Requires `confluent_wire_format`.
+
+        numa_node: (Optional.) If not negative, the records are parsed on a
+        pool of threads pinned to the CPUs of this NUMA node instead of the
+        shared worker threads. Ignored if `cpu_affinity` is given.
+
+        cpu_affinity: (Optional.) A list of CPUs such as "0-7,16-23" to parse
+        the records on a pool of threads pinned to them.
+
     Returns:
         A map of feature names to tensors.
     """
@@ -114,6 +144,10 @@ def parse_avro(serialized, reader_schema, features, avro_names=None, name=None):
         dense_defaults,
         dense_shapes,
         name,
+        confluent_wire_format=confluent_wire_format,
+        writer_schemas=writer_schemas,
+        numa_node=numa_node,
+        cpu_affinity=cpu_affinity,
     )
     return construct_tensors_for_composite_features(features, outputs)
 
@@ -131,6 +165,10 @@ def _parse_avro(
     dense_shapes=None,
     name=None,
     avro_num_minibatches=0,
+    confluent_wire_format=False,
+    writer_schemas=None,
+    numa_node=-1,
+    cpu_affinity="",
 ):
     """Parses Avro records.
 
@@ -163,6 +201,11 @@ def _parse_avro(
         minibatch elements smaller than the maximum number of blocks for the
         given feature along this dimension.
         name: A name for this operation (optional).
+        confluent_wire_format: Whether the records start with the Confluent
+        wire format header.
+        writer_schemas: A dict from schema registry ids to writer schemas.
+        numa_node: The NUMA node to pin the parsing threads to, or -1.
+        cpu_affinity: The list of CPUs to pin the parsing threads to, or "".
     Returns:
         A `dict` mapping keys to `Tensor`s and `SparseTensor`s.
     """
@@ -198,6 +241,11 @@ def _parse_avro(
             dense_shapes=dense_shapes,
             name=name,
             avro_num_minibatches=avro_num_minibatches,
+            confluent_wire_format=confluent_wire_format,
+            writer_schema_ids=list(writer_schemas.keys()) if writer_schemas else [],
+            writer_schemas=list(writer_schemas.values()) if writer_schemas else [],
+            numa_node=numa_node,
+            cpu_affinity=cpu_affinity,
         )
 
         (sparse_indices, sparse_values, sparse_shapes, dense_values) = outputs
@@ -19,9 +19,26 @@ from tensorflow_io.python.ops import core_ops
 
 
 class PubSubStreamIODataset(tf.data.Dataset):
-    """PubSubStreamGraphIODataset"""
+    """PubSubStreamGraphIODataset
 
-    def __init__(self, subscription, endpoint=None, timeout=10000, internal=True):
+    Messages are pulled in batches of up to `max_messages` and acknowledged
+    once the following batch is read. With `streaming=True` they are received
+    through a `StreamingPull` stream instead, where the server stops delivering
+    once `max_outstanding_messages` or `max_outstanding_bytes` are delivered
+    but not yet acknowledged.
+    """
+
+    def __init__(
+        self,
+        subscription,
+        endpoint=None,
+        timeout=10000,
+        max_messages=None,
+        streaming=False,
+        max_outstanding_messages=None,
+        max_outstanding_bytes=None,
+        internal=True,
+    ):
         """PubSubStreamIODataset."""
         with tf.name_scope("PubSubStreamIODataset"):
             assert internal
@@ -30,6 +47,15 @@ class PubSubStreamIODataset(tf.data.Dataset):
             if endpoint is not None:
                 metadata.append("endpoint=%s" % endpoint)
             metadata.append("timeout=%d" % timeout)
+            if max_messages is not None:
+                metadata.append("max_messages=%d" % max_messages)
+            metadata.append("streaming=%s" % ("true" if streaming else "false"))
+            if max_outstanding_messages is not None:
+                metadata.append(
+                    "max_outstanding_messages=%d" % max_outstanding_messages
+                )
+            if max_outstanding_bytes is not None:
+                metadata.append("max_outstanding_bytes=%d" % max_outstanding_bytes)
             resource = core_ops.io_pub_sub_readable_init(subscription, metadata)
 
             self._resource = resource
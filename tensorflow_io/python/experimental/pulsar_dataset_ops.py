@@ -29,6 +29,9 @@ class PulsarIODataset(tf.data.Dataset):
         timeout,
         ack_grouping_time=-1,
         poll_timeout=100,
+        batch_receive_max_messages=-1,
+        batch_receive_max_bytes=10 * 1024 * 1024,
+        batch_receive_timeout=0,
     ):
         """Creates a `PulsarIODataset` from pulsar server with a subscription
 
@@ -51,6 +54,16 @@ class PulsarIODataset(tf.data.Dataset):
             message was received, it would try again until `timeout` exceeds.
             `poll_timeout` must be positive and not larger than `timeout`.
             Default: 100
+          batch_receive_max_messages: The most messages of a batch receive, unlimited
+            if it's non-positive.
+            Default: -1
+          batch_receive_max_bytes: The most bytes of a batch receive, unlimited if it's
+            non-positive.
+            Default: 10485760
+          batch_receive_timeout: If it's positive, messages are received in batches,
+            each waiting up to `batch_receive_timeout` milliseconds for the batch to
+            fill, instead of one at a time with `poll_timeout`.
+            Default: 0
         """
         with tf.name_scope("PulsarIODataset"):
             if timeout <= 0:
@@ -69,7 +82,13 @@ class PulsarIODataset(tf.data.Dataset):
                 )
 
             resource = core_ops.io_pulsar_readable_init(
-                service_url, topic, subscription, ack_grouping_time
+                service_url,
+                topic,
+                subscription,
+                ack_grouping_time,
+                batch_receive_max_messages,
+                batch_receive_max_bytes,
+                batch_receive_timeout,
             )
             self._resource = resource
             dataset = tf.data.experimental.Counter()
@@ -21,16 +21,50 @@ from tensorflow_io.python.ops import core_ops
 class PulsarWriter:
     """PulsarWriter"""
 
-    def __init__(self, service_url, topic):
+    def __init__(
+        self,
+        service_url,
+        topic,
+        batching_max_messages=-1,
+        batching_max_bytes=-1,
+        batching_max_publish_delay=-1,
+        compression="none",
+        max_pending_messages=-1,
+    ):
         """Creates a `PulsarWriter` for writing messages to a pulsar topic
 
         Args:
           service_url: A `tf.string` tensor containing the service url of pulsar broker.
             For example: "pulsar://localhost:6650".
           topic: A `tf.string` tensor containing the topic name.
+          batching_max_messages: The most messages per batch of the producer, batching
+            is disabled if it's 0 and the default of the client is used if it's
+            negative.
+            Default: -1
+          batching_max_bytes: The most bytes per batch, the default of the client is
+            used if it's non-positive.
+            Default: -1
+          batching_max_publish_delay: The time in milliseconds a batch waits to fill
+            before it's sent, the default of the client is used if it's non-positive.
+            Default: -1
+          compression: The compression of the messages, one of "none", "lz4", "zlib",
+            "zstd" and "snappy".
+            Default: "none"
+          max_pending_messages: The most messages waiting for the broker's
+            acknowledgement, writes wait once it's reached. The default of the client
+            is used if it's non-positive.
+            Default: -1
         """
         with tf.name_scope("PulsarWriter"):
-            resource = core_ops.io_pulsar_writable_init(service_url, topic)
+            resource = core_ops.io_pulsar_writable_init(
+                service_url,
+                topic,
+                batching_max_messages,
+                batching_max_bytes,
+                batching_max_publish_delay,
+                compression,
+                max_pending_messages,
+            )
             self._resource = resource
 
     def write(self, value, key=""):
@@ -43,6 +77,23 @@ class PulsarWriter:
         """
         return core_ops.io_pulsar_writable_write(self._resource, value, key)
 
+    def write_batch(self, values, keys=None):
+        """Write a batch of messages to pulsar topic asynchronously
+
+        The messages are submitted without waiting for them to be sent, `flush`
+        waits for them and returns any failure.
+
+        Args:
+          values: A `tf.string` tensor containing the values of the messages
+          keys: A `tf.string` tensor of the same shape containing the keys of the
+            messages, an empty string means no key.
+            Default: None, all messages have no key.
+        """
+        values = tf.convert_to_tensor(values, tf.string)
+        if keys is None:
+            keys = tf.fill(tf.shape(values), "")
+        return core_ops.io_pulsar_writable_write_batch(self._resource, values, keys)
+
     def flush(self):
         """Flush the queued messages, it will wait async write operations completed."""
         return core_ops.io_pulsar_writable_flush(self._resource)
@@ -0,0 +1,50 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""RasterIOTensor"""
+
+import tensorflow as tf
+from tensorflow_io.python.ops import io_tensor_ops
+from tensorflow_io.python.ops import core_ops
+
+
+class RasterIOTensor(io_tensor_ops.BaseIOTensor):
+    """RasterIOTensor
+
+    A `RasterIOTensor` is a PNM, BMP or HDR image of `[height, width, channels]`
+    whose slices of rows are read from the file as they are needed, so that
+    images too large for memory can be processed band by band.
+    """
+
+    # =============================================================================
+    # Constructor (private)
+    # =============================================================================
+    def __init__(self, filename, internal=False):
+        with tf.name_scope("RasterIOTensor"):
+            resource = core_ops.io_raster_readable_init(filename)
+            shape, dtype = core_ops.io_raster_readable_spec(resource)
+            shape = tf.TensorShape(shape.numpy())
+            dtype = tf.as_dtype(dtype.numpy())
+            spec = tf.TensorSpec(shape, dtype)
+
+            def f(resource, start, stop, component, shape, dtype):
+                return core_ops.io_raster_readable_read(
+                    resource, start=start, stop=stop, dtype=dtype
+                )
+
+            # pylint: disable=protected-access
+            function = io_tensor_ops._IOTensorComponentFunction(
+                f, resource, None, shape, dtype
+            )
+            super().__init__(spec, function, internal=internal)
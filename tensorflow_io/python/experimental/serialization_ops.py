@@ -53,20 +53,36 @@ def decode_json(data, specs, name=None):
     Decode JSON string into Tensors.
 
     Args:
-        data: A String Tensor. The JSON strings to decode.
+        data: A String Tensor. The JSON strings to decode, either one JSON
+        string or a batch of them.
         specs: A structured TensorSpecs describing the signature
         of the JSON elements.
         name: A name for the operation (optional).
 
     Returns:
-        A structured Tensors.
+        A structured Tensors, with a leading batch dimension for a batch.
     """
-    # TODO: support batch (1-D) input
     # Make a copy of specs to keep the original specs
     named = tf.nest.map_structure(lambda e: _NamedTensorSpec(e.shape, e.dtype), specs)
     named_spec(named)
     named = tf.nest.flatten(named)
     names = [e.named() for e in named]
+
+    # A batch is decoded at once into preallocated tensors, which needs the
+    # shapes of the elements.
+    data = tf.convert_to_tensor(data, tf.string)
+    if data.shape.rank == 1:
+        if not all(e.shape.is_fully_defined() for e in named):
+            raise ValueError("a batch needs fully defined shapes in specs")
+        values = core_ops.io_decode_json_batch(
+            data,
+            names=names,
+            shapes=[e.shape for e in named],
+            dtypes=[e.dtype for e in named],
+            name=name,
+        )
+        return tf.nest.pack_sequence_as(specs, values)
+
     shapes = [
         tf.constant([-1 if d is None else d for d in e.shape.as_list()], tf.int32)
         for e in named
@@ -152,7 +168,7 @@ def decode_avro(data, schema, name=None):
     return tf.nest.pack_sequence_as(specs, values)
 
 
-def encode_avro(data, schema, name=None):
+def encode_avro(data, schema, name=None, container_block=False):
     """
     Encode Tensors into Avro string.
 
@@ -160,9 +176,14 @@ def encode_avro(data, schema, name=None):
         data: A list of Tensors to encode.
         schema: A string of the Avro schema.
         name: A name for the operation (optional).
+        container_block: If True, encode all records into one block of an
+          Avro container file instead, i.e. the record count, the byte size
+          and the records. The file header and the sync marker that follows
+          every block are not included.
 
     Returns:
-        An Avro-encoded string Tensor.
+        An Avro-encoded string Tensor, a scalar with the block if
+        `container_block` is True.
     """
     # TODO: Use resource to reuse schema initialization
     specs = process_entry(
@@ -174,5 +195,7 @@ def encode_avro(data, schema, name=None):
 
     data = tf.nest.flatten(data)
 
-    values = core_ops.io_encode_avro(data, names, schema, name=name)
+    values = core_ops.io_encode_avro(
+        data, names, schema, container_block=container_block, name=name
+    )
     return values
@@ -21,13 +21,13 @@ from tensorflow_io.python.ops import core_ops
 class SQLIODataset(tf.data.Dataset):
     """SQLIODataset"""
 
-    def __init__(self, query, endpoint=None, spec=None, internal=True):
+    def __init__(self, query, endpoint=None, spec=None, batch_size=None, internal=True):
         """SQLIODataset."""
         with tf.name_scope("SQLIODataset"):
             assert internal
             endpoint = endpoint or ""
             resource, count, fields, dtypes = core_ops.io_sql_iterable_init(
-                query, endpoint
+                query, endpoint, batch_size=batch_size or 0
             )
             if spec is None:
                 fields = tf.unstack(fields)
@@ -47,14 +47,24 @@ class SQLIODataset(tf.data.Dataset):
             dtypes = [e.dtype for e in flatten]
 
             self._resource = resource
-            dataset = tf.data.Dataset.range(0, count)
 
             def f(index):
                 return tf.nest.pack_sequence_as(
                     spec, core_ops.io_sql_iterable_read(resource, index, fields, dtypes)
                 )
 
-            dataset = dataset.map(f)
+            if batch_size:
+                # The rows are streamed a batch at a time, until an empty one.
+                dataset = tf.data.experimental.Counter()
+                dataset = dataset.map(f)
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(tf.nest.flatten(v)[0])[0], 0)
+                    )
+                )
+            else:
+                dataset = tf.data.Dataset.range(0, count)
+                dataset = dataset.map(f)
             dataset = dataset.unbatch()
             self._dataset = dataset
             super().__init__(
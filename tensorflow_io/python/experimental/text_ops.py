@@ -14,11 +14,13 @@
 # ==============================================================================
 """LibSVM"""
 
+import tensorflow as tf
+from tensorflow import RaggedTensor
 from tensorflow import sparse
 from tensorflow_io.python.ops import core_ops
 
 
-def decode_libsvm(content, num_features, dtype=None, label_dtype=None):
+def decode_libsvm(content, num_features, dtype=None, label_dtype=None, layout=None):
     """Convert Libsvm records to a tensor of label and a tensor of feature.
 
     Args:
@@ -27,15 +29,30 @@ def decode_libsvm(content, num_features, dtype=None, label_dtype=None):
       num_features: The number of features.
       dtype: The type of the output feature tensor. Default to tf.float32.
       label_dtype: The type of the output label tensor. Default to tf.int64.
+      layout: The layout of the features, "sparse" (default) or "csr". The
+        "csr" layout needs a 1-D content and keeps the features in the
+        order of the records.
 
     Returns:
-      features: A `SparseTensor` of the shape `[input_shape, num_features]`.
+      features: A `SparseTensor` of the shape `[input_shape, num_features]`,
+        or with the "csr" layout a tuple of two `RaggedTensor`s of the
+        shape `[input_shape, None]`, of the feature indices and the feature
+        values, which share their row splits.
       labels: A `Tensor` of the same shape as content.
     """
-    labels, indices, values, shape = core_ops.io_decode_libsvm(
+    if layout is None or layout == "sparse":
+        labels, indices, values, shape = core_ops.io_decode_libsvm(
+            content, num_features, dtype=dtype, label_dtype=label_dtype
+        )
+        return sparse.SparseTensor(indices, values, shape), labels
+    if layout != "csr":
+        raise ValueError(f"layout must be 'sparse' or 'csr', got {layout}")
+    labels, row_splits, indices, values = core_ops.io_decode_libsvm_csr(
         content, num_features, dtype=dtype, label_dtype=label_dtype
     )
-    return sparse.SparseTensor(indices, values, shape), labels
+    indices = RaggedTensor.from_row_splits(indices, row_splits, validate=False)
+    values = RaggedTensor.from_row_splits(values, row_splits, validate=False)
+    return (indices, values), labels
 
 
 def re2_full_match(input, pattern):  # pylint: disable=redefined-builtin
@@ -48,6 +65,39 @@ def re2_full_match(input, pattern):  # pylint: disable=redefined-builtin
     return core_ops.io_re2_full_match(input, pattern)
 
 
+def re2_full_match_set(input, patterns):  # pylint: disable=redefined-builtin
+    """Match against several regex patterns in one scan
+
+    Each element is matched once against all the patterns, compiled
+    together into one automaton, rather than once per pattern.
+
+    Args:
+      input: A `tf.string` tensor.
+      patterns: A list of pattern strings.
+
+    Returns:
+      A `tf.RaggedTensor` of `tf.int32` of shape `input.shape + [None]`
+      with, for each element, the indices in `patterns` of the patterns that
+      fully match it, in increasing order.
+    """
+    input = tf.convert_to_tensor(input, tf.string)
+    if input.shape.rank is None:
+        raise ValueError("input must have a known rank")
+    ids, row_splits = core_ops.io_re2_full_match_set(
+        tf.reshape(input, [-1]), patterns
+    )
+    result = RaggedTensor.from_row_splits(ids, row_splits, validate=False)
+    if input.shape.rank != 1:
+        shape = tf.shape(input, out_type=tf.int64)
+        for i in reversed(range(1, input.shape.rank)):
+            result = RaggedTensor.from_uniform_row_length(
+                result, shape[i], validate=False
+            )
+        if input.shape.rank == 0:
+            result = result[0]
+    return result
+
+
 def read_text(filename, **kwargs):
     """read_text"""
     memory = kwargs.get("memory", "")
@@ -66,3 +116,7 @@ class TextOutputSequence:
 
     def setitem(self, index, item):
         core_ops.io_text_output_sequence_set_item(self._resource, index, item)
+
+    def flush(self):
+        """Writes the buffered items to the files."""
+        core_ops.io_text_output_sequence_flush(self._resource)
@@ -23,6 +23,8 @@ import types
 
 import tensorflow as tf
 
+from tensorflow_io.python.ops.op_libraries import DEFAULT_LIBRARY, LIBRARY_OF_OP
+
 
 def _load_library(filename, lib="op"):
     """_load_library"""
@@ -73,32 +75,38 @@ def _load_library(filename, lib="op"):
 
 
 class LazyLoader(types.ModuleType):
-    def __init__(self, name, library):
-        self._mod = None
+    def __init__(self, name, library, libraries=None):
+        self._mods = {}
         self._module_name = name
         self._library = library
+        # The library of each op that is not in `library`, by op name.
+        self._libraries = libraries or {}
         super().__init__(self._module_name)
 
-    def _load(self):
-        if self._mod is None:
-            self._mod = _load_library(self._library)
-        return self._mod
+    def _load(self, library=None):
+        library = library or self._library
+        if library not in self._mods:
+            self._mods[library] = _load_library(library)
+        return self._mods[library]
 
     def __getattr__(self, attrb):
-        return getattr(self._load(), attrb)
+        return getattr(self._load(self._libraries.get(attrb)), attrb)
 
     def __dir__(self):
-        return dir(self._load())
+        names = set(dir(self._load()))
+        for library in set(self._libraries.values()):
+            names.update(dir(self._load(library)))
+        return sorted(names)
 
 
-core_ops = LazyLoader("core_ops", "libtensorflow_io.so")
+core_ops = LazyLoader("core_ops", DEFAULT_LIBRARY, LIBRARY_OF_OP)
 try:
     plugin_ops = _load_library("libtensorflow_io_plugins.so", "fs")
 except NotImplementedError as e:
     warnings.warn(f"unable to load libtensorflow_io_plugins.so: {e}")
     # Note: load libtensorflow_io.so imperatively in case of statically linking
     try:
-        core_ops = _load_library("libtensorflow_io.so")
+        core_ops._load()  # pylint: disable=protected-access
         plugin_ops = _load_library("libtensorflow_io.so", "fs")
     except NotImplementedError as e:
         warnings.warn(f"file system plugins are not loaded: {e}")
@@ -18,16 +18,31 @@ from tensorflow_io.python.ops import core_ops
 
 
 def list_archive_entries(filename, filters, **kwargs):
-    """list_archive_entries"""
+    """list_archive_entries
+
+    An uncompressed tar, filter "tar", is indexed once, so that its entries
+    are then read directly from their offsets. With `seek_index`, a gzip
+    compressed tar is indexed too, with points to inflate its entries from.
+    """
     memory = kwargs.get("memory", "")
+    seek_index = kwargs.get("seek_index", False)
     if not isinstance(filters, list):
         filters = [filters]
-    return core_ops.io_list_archive_entries(filename, filters=filters, memory=memory)
+    return core_ops.io_list_archive_entries(
+        filename, filters=filters, memory=memory, seek_index=seek_index
+    )
 
 
 def read_archive(
     filename, format, entries, **kwargs
 ):  # pylint: disable=redefined-builtin
-    """read_archive"""
+    """read_archive
+
+    The entries of a tar, or of a tar.gz with `seek_index`, are read in
+    parallel through the index of the archive.
+    """
     memory = kwargs.get("memory", "")
-    return core_ops.io_read_archive(filename, format, entries, memory=memory)
+    seek_index = kwargs.get("seek_index", False)
+    return core_ops.io_read_archive(
+        filename, format, entries, memory=memory, seek_index=seek_index
+    )
@@ -19,8 +19,10 @@ import io
 from itertools import chain
 import os
 import socket
+import struct
 import threading
 import tempfile
+import time
 
 import tensorflow as tf
 from tensorflow import dtypes
@@ -87,6 +89,20 @@ def arrow_schema_to_tensor_types(schema):
     return tensor_types, tensor_shapes
 
 
+class _ArrowComponentsDataset(dataset_ops.DatasetSource):
+    """The flat component tensors of an Arrow dataset with ragged or dictionary
+    columns, before they are combined to the column values.
+    """
+
+    def __init__(self, variant_tensor, element_spec):
+        self._components_spec = element_spec
+        super().__init__(variant_tensor)
+
+    @property
+    def element_spec(self):
+        return self._components_spec
+
+
 class ArrowBaseDataset(dataset_ops.DatasetV2):
     """Base class for Arrow Datasets to provide columns used in record batches
     and corresponding output tensor types, shapes and classes.
@@ -102,6 +118,10 @@ class ArrowBaseDataset(dataset_ops.DatasetV2):
         output_shapes=None,
         batch_size=None,
         batch_mode="keep_remainder",
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
     ):
         self._columns = columns
         self._structure = structure_lib.convert_legacy_structure(
@@ -129,13 +149,69 @@ class ArrowBaseDataset(dataset_ops.DatasetV2):
                 lambda component_spec: component_spec._batch(spec_batch_size),
                 self._structure,
             )
+        ragged_columns = list(ragged_columns or [])
+        dictionary_columns = list(dictionary_columns or [])
+        if ragged_columns and batch_size is None and batch_mode != "auto":
+            raise ValueError("ragged_columns require a batch_size or batch_mode='auto'")
+        if not (ragged_columns or dictionary_columns):
+            variant_tensor = make_variant_fn(
+                columns=self._columns,
+                batch_size=self._batch_size,
+                batch_mode=self._batch_mode,
+                parallel_columns=parallel_columns,
+                parallel_columns_min_bytes=parallel_columns_min_bytes,
+                **self._flat_structure,
+            )
+            super().__init__(variant_tensor)
+            return
+
+        # Ragged and dictionary columns are output by the kernel as two flat
+        # component tensors each, that are combined here to a RaggedTensor,
+        # or to a tuple of the indices and the dictionary
+        column_specs = nest.flatten(self._structure)
+        component_specs = []
+        for i, spec in enumerate(column_specs):
+            if i in ragged_columns:
+                component_specs.append(tf.TensorSpec([None], spec.dtype))
+                component_specs.append(tf.TensorSpec([None], dtypes.int32))
+            elif i in dictionary_columns:
+                component_specs.append(tf.TensorSpec(spec.shape, dtypes.int64))
+                component_specs.append(tf.TensorSpec([None], spec.dtype))
+            else:
+                component_specs.append(spec)
+        component_specs = tuple(component_specs)
         variant_tensor = make_variant_fn(
             columns=self._columns,
             batch_size=self._batch_size,
             batch_mode=self._batch_mode,
-            **self._flat_structure,
+            parallel_columns=parallel_columns,
+            parallel_columns_min_bytes=parallel_columns_min_bytes,
+            ragged_columns=ragged_columns,
+            dictionary_columns=dictionary_columns,
+            output_types=structure_lib.get_flat_tensor_types(component_specs),
+            output_shapes=structure_lib.get_flat_tensor_shapes(component_specs),
         )
-        super().__init__(variant_tensor)
+        components = _ArrowComponentsDataset(variant_tensor, component_specs)
+
+        def combine(*tensors):
+            values = []
+            tensors = iter(tensors)
+            for i in range(len(column_specs)):
+                if i in ragged_columns:
+                    values.append(
+                        tf.RaggedTensor.from_row_splits(
+                            next(tensors), next(tensors), validate=False
+                        )
+                    )
+                elif i in dictionary_columns:
+                    values.append((next(tensors), next(tensors)))
+                else:
+                    values.append(next(tensors))
+            return nest.pack_sequence_as(output_types, values)
+
+        combined = components.map(combine)
+        self._structure = combined.element_spec
+        super().__init__(combined._variant_tensor)  # pylint: disable=protected-access
 
     def _inputs(self):
         return []
@@ -169,6 +245,12 @@ class ArrowDataset(ArrowBaseDataset):
         batch_size=None,
         batch_mode="keep_remainder",
         arrow_buffer=None,
+        read_ahead_batches=0,
+        read_ahead_bytes=0,
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
     ):
         """Create an ArrowDataset from a Tensor of serialized batches.
         This constructor requires pyarrow to be installed.
@@ -193,10 +275,29 @@ class ArrowDataset(ArrowBaseDataset):
                         the C++ kernel by address for zero-copy. Only supported if
                         the kernel process is local, with TensorFlow in eager mode.
                         If this is used, set `serialized_batches` to `None`.
+            read_ahead_batches: Number of record batches to read ahead on a
+                        background thread, 0 (default) disables read-ahead
+            read_ahead_bytes: Optional limit of the total size in bytes of the
+                        record batches read ahead, 0 (default) for no limit
+            parallel_columns: Minimum number of columns of a batch to convert
+                        the columns in parallel on the inter-op thread pool, 0
+                        (default) converts them one after another
+            parallel_columns_min_bytes: Minimum estimated size in bytes of a
+                        batch to convert its columns in parallel
+            ragged_columns: Optional list of positions in `columns` of list
+                        columns of variable length, that are output as
+                        tf.RaggedTensor. Requires batching
+            dictionary_columns: Optional list of positions in `columns` of
+                        dictionary-encoded columns, that are output as a tuple
+                        of the int64 indices and the dictionary values, with
+                        the output type of the dictionary values
         """
         if serialized_batches is not None:
             make_variant_fn = partial(
-                core_ops.io_arrow_serialized_dataset, serialized_batches
+                core_ops.io_arrow_serialized_dataset,
+                serialized_batches,
+                read_ahead_batches=read_ahead_batches,
+                read_ahead_bytes=read_ahead_bytes,
             )
         elif arrow_buffer is None:
             raise ValueError("Must set either serialzied_batches or arrow_buffer")
@@ -214,7 +315,11 @@ class ArrowDataset(ArrowBaseDataset):
                 arrow_buffer.size, dtype=dtypes.int64, name="buffer_size"
             )
             make_variant_fn = partial(
-                core_ops.io_arrow_zero_copy_dataset, buffer_address, buffer_size
+                core_ops.io_arrow_zero_copy_dataset,
+                buffer_address,
+                buffer_size,
+                read_ahead_batches=read_ahead_batches,
+                read_ahead_bytes=read_ahead_bytes,
             )
             # Keep a reference to the arrow buffers used
             self._arrow_buffer_refs = [arrow_buffer]
@@ -225,6 +330,10 @@ class ArrowDataset(ArrowBaseDataset):
             output_shapes,
             batch_size,
             batch_mode,
+            parallel_columns,
+            parallel_columns_min_bytes,
+            ragged_columns,
+            dictionary_columns,
         )
 
     @classmethod
@@ -349,6 +458,11 @@ class ArrowFeatherDataset(ArrowBaseDataset):
         output_shapes=None,
         batch_size=None,
         batch_mode="keep_remainder",
+        memory_map=False,
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
     ):
         """Create an ArrowDataset from one or more Feather file names.
 
@@ -367,17 +481,38 @@ class ArrowFeatherDataset(ArrowBaseDataset):
                         "keep_remainder" (default, keeps partial batch data),
                         "drop_remainder" (discard partial batch data),
                         "auto" (size to number of records in Arrow record batch)
+            memory_map: Memory map local files, so that the record batches
+                        reference the pages of the file instead of copies. The
+                        files must not be modified while the dataset is in use
+            parallel_columns: Minimum number of columns of a batch to convert
+                        the columns in parallel on the inter-op thread pool, 0
+                        (default) converts them one after another
+            parallel_columns_min_bytes: Minimum estimated size in bytes of a
+                        batch to convert its columns in parallel
+            ragged_columns: Optional list of positions in `columns` of list
+                        columns of variable length, that are output as
+                        tf.RaggedTensor. Requires batching
+            dictionary_columns: Optional list of positions in `columns` of
+                        dictionary-encoded columns, that are output as a tuple
+                        of the int64 indices and the dictionary values, with
+                        the output type of the dictionary values
         """
         filenames = tf.convert_to_tensor(
             filenames, dtype=dtypes.string, name="filenames"
         )
         super().__init__(
-            partial(core_ops.io_arrow_feather_dataset, filenames),
+            partial(
+                core_ops.io_arrow_feather_dataset, filenames, memory_map=memory_map
+            ),
             columns,
             output_types,
             output_shapes,
             batch_size,
             batch_mode,
+            parallel_columns,
+            parallel_columns_min_bytes,
+            ragged_columns,
+            dictionary_columns,
         )
 
     @classmethod
@@ -417,7 +552,8 @@ class ArrowFeatherDataset(ArrowBaseDataset):
 
 class ArrowStreamDataset(ArrowBaseDataset):
     """An Arrow Dataset for reading record batches from an input stream.
-    Currently supported input streams are a socket client or stdin.
+    Currently supported input streams are a socket client, a shared memory
+    ring or stdin.
     """
 
     def __init__(
@@ -428,6 +564,12 @@ class ArrowStreamDataset(ArrowBaseDataset):
         output_shapes=None,
         batch_size=None,
         batch_mode="keep_remainder",
+        read_ahead_batches=0,
+        read_ahead_bytes=0,
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
     ):
         """Create an ArrowDataset from an input stream.
 
@@ -438,6 +580,8 @@ class ArrowStreamDataset(ArrowBaseDataset):
                         - "host:port": IPv4 address (default)
                         - "tcp://<host:port>": IPv4 address,
                         - "unix://<path>": local path as unix socket address,
+                        - "shm://<name>": shared memory ring of an
+                            ArrowShmStreamWriter on the same host,
                         - "fd://<number>": STDIN or file descriptor number. For
                             STDIN, use "fd://0" or "fd://-".
             columns: A list of column indices to be used in the Dataset
@@ -452,17 +596,42 @@ class ArrowStreamDataset(ArrowBaseDataset):
                         "keep_remainder" (default, keeps partial batch data),
                         "drop_remainder" (discard partial batch data),
                         "auto" (size to number of records in Arrow record batch)
+            read_ahead_batches: Number of record batches to read ahead on a
+                        background thread, 0 (default) disables read-ahead
+            read_ahead_bytes: Optional limit of the total size in bytes of the
+                        record batches read ahead, 0 (default) for no limit
+            parallel_columns: Minimum number of columns of a batch to convert
+                        the columns in parallel on the inter-op thread pool, 0
+                        (default) converts them one after another
+            parallel_columns_min_bytes: Minimum estimated size in bytes of a
+                        batch to convert its columns in parallel
+            ragged_columns: Optional list of positions in `columns` of list
+                        columns of variable length, that are output as
+                        tf.RaggedTensor. Requires batching
+            dictionary_columns: Optional list of positions in `columns` of
+                        dictionary-encoded columns, that are output as a tuple
+                        of the int64 indices and the dictionary values, with
+                        the output type of the dictionary values
         """
         endpoints = tf.convert_to_tensor(
             endpoints, dtype=dtypes.string, name="endpoints"
         )
         super().__init__(
-            partial(core_ops.io_arrow_stream_dataset, endpoints),
+            partial(
+                core_ops.io_arrow_stream_dataset,
+                endpoints,
+                read_ahead_batches=read_ahead_batches,
+                read_ahead_bytes=read_ahead_bytes,
+            ),
             columns,
             output_types,
             output_shapes,
             batch_size,
             batch_mode,
+            parallel_columns,
+            parallel_columns_min_bytes,
+            ragged_columns,
+            dictionary_columns,
         )
 
     @classmethod
@@ -485,6 +654,8 @@ class ArrowStreamDataset(ArrowBaseDataset):
                         - "host:port": IPv4 address (default)
                         - "tcp://<host:port>": IPv4 address,
                         - "unix://<path>": local path as unix socket address,
+                        - "shm://<name>": shared memory ring of an
+                            ArrowShmStreamWriter on the same host,
                         - "fd://<number>": STDIN or file descriptor number. For
                             STDIN, use "fd://0" or "fd://-".
             schema: Arrow schema defining the record batch data in the stream
@@ -651,6 +822,499 @@ class ArrowStreamDataset(ArrowBaseDataset):
         )
 
 
+class ArrowFlightDataset(ArrowBaseDataset):
+    """An Arrow Dataset that reads the endpoints of an Arrow Flight. The
+    FlightInfo of the descriptor is fetched from the given location, and the
+    endpoints are streamed concurrently.
+    """
+
+    def __init__(
+        self,
+        location,
+        descriptor,
+        columns,
+        output_types,
+        output_shapes=None,
+        batch_size=None,
+        batch_mode="keep_remainder",
+        descriptor_type="cmd",
+        num_parallel_endpoints=1,
+        num_shards=1,
+        shard_index=0,
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
+    ):
+        """Create an ArrowFlightDataset from a Flight descriptor.
+
+        Args:
+            location: URI of the Flight service, e.g. "grpc://host:port"
+            descriptor: The command as a string, or a list of path components
+                        if `descriptor_type` is "path"
+            columns: A list of column indices to be used in the Dataset
+            output_types: Tensor dtypes of the output tensors
+            output_shapes: TensorShapes of the output tensors or None to
+                            infer partial
+            batch_size: Batch size of output tensors, setting a batch size here
+                        will create batched tensors from Arrow memory and can be more
+                        efficient than using tf.data.Dataset.batch().
+                        NOTE: batch_size does not need to be set if batch_mode='auto'
+            batch_mode: Mode of batching, supported strings:
+                        "keep_remainder" (default, keeps partial batch data),
+                        "drop_remainder" (discard partial batch data),
+                        "auto" (size to number of records in Arrow record batch)
+            descriptor_type: Type of the Flight descriptor, "cmd" (default) or
+                        "path"
+            num_parallel_endpoints: Number of endpoints to stream concurrently,
+                        record batches of different endpoints are interleaved if
+                        this is greater than 1 (default)
+            num_shards: Number of shards the endpoints are divided into, e.g.
+                        the number of workers
+            shard_index: Index of the shard to read, endpoint i is read by the
+                        shard i % num_shards
+            parallel_columns: Minimum number of columns of a batch to convert
+                        the columns in parallel on the inter-op thread pool, 0
+                        (default) converts them one after another
+            parallel_columns_min_bytes: Minimum estimated size in bytes of a
+                        batch to convert its columns in parallel
+            ragged_columns: Optional list of positions in `columns` of list
+                        columns of variable length, that are output as
+                        tf.RaggedTensor. Requires batching
+            dictionary_columns: Optional list of positions in `columns` of
+                        dictionary-encoded columns, that are output as a tuple
+                        of the int64 indices and the dictionary values, with
+                        the output type of the dictionary values
+        """
+        location = tf.convert_to_tensor(location, dtype=dtypes.string, name="location")
+        descriptor = tf.convert_to_tensor(
+            descriptor, dtype=dtypes.string, name="descriptor"
+        )
+        descriptor_type = tf.convert_to_tensor(
+            descriptor_type, dtype=dtypes.string, name="descriptor_type"
+        )
+        super().__init__(
+            partial(
+                core_ops.io_arrow_flight_dataset,
+                location,
+                descriptor,
+                descriptor_type,
+                num_parallel_endpoints=num_parallel_endpoints,
+                num_shards=num_shards,
+                shard_index=shard_index,
+            ),
+            columns,
+            output_types,
+            output_shapes,
+            batch_size,
+            batch_mode,
+            parallel_columns,
+            parallel_columns_min_bytes,
+            ragged_columns,
+            dictionary_columns,
+        )
+
+    @classmethod
+    def from_schema(cls, location, descriptor, schema, columns=None, **kwargs):
+        """Create an ArrowFlightDataset, inferring output types and shapes from
+        the given Arrow schema.
+        This method requires pyarrow to be installed.
+
+        Args:
+            location: URI of the Flight service, e.g. "grpc://host:port"
+            descriptor: The command or path components of the Flight descriptor
+            schema: Arrow schema defining the record batch data of the Flight
+            columns: A list of column indicies to use from the schema, None for all
+            kwargs: Other arguments of the ArrowFlightDataset constructor
+        """
+        if columns is None:
+            columns = list(range(len(schema)))
+        output_types, output_shapes = arrow_schema_to_tensor_types(schema)
+        return cls(location, descriptor, columns, output_types, output_shapes, **kwargs)
+
+
+class ArrowScannerDataset(ArrowBaseDataset):
+    """An Arrow Dataset that scans a directory of Parquet, Feather or Arrow IPC
+    files with the Arrow Dataset API. Only the named columns are read, and
+    the filters are pushed down to skip hive partitions and Parquet row groups
+    by their statistics before the remaining rows are filtered. Parquet row
+    groups can be scanned in parallel, with their column chunks pre-buffered
+    in coalesced reads.
+    """
+
+    def __init__(
+        self,
+        path,
+        columns,
+        output_types,
+        output_shapes=None,
+        file_format="parquet",
+        partitioning="hive",
+        filters=None,
+        batch_size=None,
+        batch_mode="keep_remainder",
+        parallel_columns=0,
+        parallel_columns_min_bytes=0,
+        ragged_columns=None,
+        dictionary_columns=None,
+        split_row_groups=False,
+        pre_buffer=None,
+    ):
+        """Create an ArrowScannerDataset from a directory of files.
+
+        Args:
+            path: Local path or filesystem URI of the directory, files in sub
+                        directories are scanned as well
+            columns: A list of column names to be used in the Dataset, the
+                        partition keys of hive partitioning are columns too
+            output_types: Tensor dtypes of the output tensors
+            output_shapes: TensorShapes of the output tensors or None to
+                            infer partial
+            file_format: Format of the files, "parquet" (default), "feather" or
+                        "ipc"
+            partitioning: "hive" (default) to read the values of key=value
+                        directory names as columns, or None
+            filters: Optional list of (column name, op, value) comparisons that
+                        all must hold for a row, op is one of "==", "!=", "<",
+                        "<=", ">" and ">="
+            batch_size: Batch size of output tensors, setting a batch size here
+                        will create batched tensors from Arrow memory and can be more
+                        efficient than using tf.data.Dataset.batch().
+                        NOTE: batch_size does not need to be set if batch_mode='auto'
+            batch_mode: Mode of batching, supported strings:
+                        "keep_remainder" (default, keeps partial batch data),
+                        "drop_remainder" (discard partial batch data),
+                        "auto" (size to number of records in Arrow record batch)
+            parallel_columns: Minimum number of columns of a batch to convert
+                        the columns in parallel on the inter-op thread pool, 0
+                        (default) converts them one after another
+            parallel_columns_min_bytes: Minimum estimated size in bytes of a
+                        batch to convert its columns in parallel
+            ragged_columns: Optional list of positions in `columns` of list
+                        columns of variable length, that are output as
+                        tf.RaggedTensor. Requires batching
+            dictionary_columns: Optional list of positions in `columns` of
+                        dictionary-encoded columns, that are output as a tuple
+                        of the int64 indices and the dictionary values, with
+                        the output type of the dictionary values
+            split_row_groups: Whether to scan every Parquet row group as a
+                        fragment of its own, so that the row groups of a file
+                        are read in parallel. The output order is kept
+            pre_buffer: Whether to fetch the column chunks of Parquet row
+                        groups ahead in coalesced range reads, None (default)
+                        to do so for filesystem URIs other than file://
+        """
+
+        def filter_value(value):
+            if isinstance(value, bool):
+                return "true" if value else "false"
+            return str(value)
+
+        filters = list(filters or [])
+        if pre_buffer is None:
+            pre_buffer = (
+                isinstance(path, str)
+                and "://" in path
+                and not path.startswith("file://")
+            )
+        path = tf.convert_to_tensor(path, dtype=dtypes.string, name="path")
+        file_format = tf.convert_to_tensor(
+            file_format, dtype=dtypes.string, name="format"
+        )
+        partitioning = tf.convert_to_tensor(
+            partitioning or "", dtype=dtypes.string, name="partitioning"
+        )
+        column_names = tf.convert_to_tensor(
+            list(columns), dtype=dtypes.string, name="column_names"
+        )
+        filter_fields, filter_ops, filter_values = (
+            tf.convert_to_tensor(values, dtype=dtypes.string, name=name)
+            for values, name in [
+                ([f[0] for f in filters], "filter_fields"),
+                ([f[1] for f in filters], "filter_ops"),
+                ([filter_value(f[2]) for f in filters], "filter_values"),
+            ]
+        )
+        self._column_names = list(columns)
+        super().__init__(
+            partial(
+                core_ops.io_arrow_scanner_dataset,
+                path,
+                file_format,
+                partitioning,
+                column_names,
+                filter_fields,
+                filter_ops,
+                filter_values,
+                split_row_groups=split_row_groups,
+                pre_buffer=pre_buffer,
+            ),
+            list(range(len(self._column_names))),
+            output_types,
+            output_shapes,
+            batch_size,
+            batch_mode,
+            parallel_columns,
+            parallel_columns_min_bytes,
+            ragged_columns,
+            dictionary_columns,
+        )
+
+    @property
+    def column_names(self):
+        return self._column_names
+
+    @classmethod
+    def from_path(
+        cls, path, columns=None, file_format="parquet", partitioning="hive", **kwargs
+    ):
+        """Create an ArrowScannerDataset, inferring output types and shapes
+        from the schema that pyarrow discovers for the directory.
+        This method requires pyarrow to be installed.
+
+        Args:
+            path: Local path or filesystem URI of the directory
+            columns: A list of column names to use, None for all
+            file_format: Format of the files, "parquet" (default), "feather" or
+                        "ipc"
+            partitioning: "hive" (default) or None
+            kwargs: Other arguments of the ArrowScannerDataset constructor
+        """
+        import pyarrow as pa  # pylint: disable=import-outside-toplevel
+        import pyarrow.dataset as ds  # pylint: disable=import-outside-toplevel
+
+        schema = ds.dataset(
+            path,
+            format="ipc" if file_format == "feather" else file_format,
+            partitioning=partitioning,
+        ).schema
+        if columns is None:
+            columns = schema.names
+        schema = pa.schema([schema.field(name) for name in columns])
+        output_types, output_shapes = arrow_schema_to_tensor_types(schema)
+        return cls(
+            path,
+            columns,
+            output_types,
+            output_shapes,
+            file_format=file_format,
+            partitioning=partitioning,
+            **kwargs,
+        )
+
+
+class ArrowShmStreamWriter(io.RawIOBase):
+    """A writable stream that delivers an Arrow IPC stream to an
+    ArrowStreamDataset on the same host through shared memory, instead of a
+    socket. The dataset reads it with the endpoint given by `endpoint`, e.g.
+
+        writer = ArrowShmStreamWriter("features")
+        with pa.RecordBatchStreamWriter(writer, schema) as stream:
+            stream.write_batch(batch)
+        writer.close()
+
+    Writes block while the ring is full. `close` marks the end of the stream,
+    `unlink` removes the shared memory once the dataset has connected.
+    """
+
+    _HEADER_SIZE = 128
+    _MAGIC = 0x314D48534F494654
+    _WRITE_POS, _WRITE_SEQ, _CLOSED, _READ_POS = 16, 24, 28, 64
+    # SYS_futex, the doorbell is optional since the reader also polls
+    _FUTEX_SYSCALLS = {"x86_64": 202, "aarch64": 98}
+
+    def __init__(self, name, capacity=64 * 1024 * 1024):
+        """Create the shared memory ring.
+
+        Args:
+            name: Name of the POSIX shared memory object
+            capacity: Size in bytes of the ring of the stream
+        """
+        from multiprocessing import (  # pylint: disable=import-outside-toplevel
+            shared_memory,
+        )
+
+        super().__init__()
+        self._shm = shared_memory.SharedMemory(
+            name=name, create=True, size=self._HEADER_SIZE + capacity
+        )
+        self._capacity = capacity
+        self._write_pos = 0
+        buf = self._shm.buf
+        buf[: self._HEADER_SIZE] = bytes(self._HEADER_SIZE)
+        struct.pack_into("<Q", buf, 8, capacity)
+        struct.pack_into("<Q", buf, 0, self._MAGIC)
+        self._futex_wake = self._make_futex_wake()
+
+    def _make_futex_wake(self):
+        """Make a function that wakes the reader, None if unavailable"""
+        import ctypes  # pylint: disable=import-outside-toplevel
+
+        syscall_number = self._FUTEX_SYSCALLS.get(os.uname().machine)
+        if syscall_number is None or os.uname().sysname != "Linux":
+            return None
+        syscall = ctypes.CDLL(None, use_errno=True).syscall
+        futex_wake = 1
+        word = ctypes.c_uint32.from_buffer(self._shm.buf, self._WRITE_SEQ)
+        address = ctypes.addressof(word)
+        del word
+
+        def wake():
+            syscall(syscall_number, ctypes.c_void_p(address), futex_wake, 1, 0, 0, 0)
+
+        return wake
+
+    @property
+    def endpoint(self):
+        return "shm://" + self._shm.name.lstrip("/")
+
+    def writable(self):
+        return True
+
+    def _ring(self):
+        buf = self._shm.buf
+        (seq,) = struct.unpack_from("<I", buf, self._WRITE_SEQ)
+        struct.pack_into("<I", buf, self._WRITE_SEQ, (seq + 1) & 0xFFFFFFFF)
+        if self._futex_wake is not None:
+            self._futex_wake()
+
+    def write(self, b):
+        data = memoryview(b).cast("B")
+        buf = self._shm.buf
+        written = 0
+        while written < len(data):
+            (read_pos,) = struct.unpack_from("<Q", buf, self._READ_POS)
+            space = self._capacity - (self._write_pos - read_pos)
+            if space == 0:
+                time.sleep(0.0005)
+                continue
+            offset = self._write_pos % self._capacity
+            length = min(space, len(data) - written, self._capacity - offset)
+            start = self._HEADER_SIZE + offset
+            buf[start : start + length] = data[written : written + length]
+            written += length
+            self._write_pos += length
+            # Publish the bytes after they are copied to the ring
+            struct.pack_into("<Q", buf, self._WRITE_POS, self._write_pos)
+            self._ring()
+        return written
+
+    def close(self):
+        if not self.closed:
+            struct.pack_into("<I", self._shm.buf, self._CLOSED, 1)
+            self._ring()
+            self._futex_wake = None
+            self._shm.close()
+        super().close()
+
+    def unlink(self):
+        self._shm.unlink()
+
+
+class ArrowWriter:
+    """Writes batches of tensors to an Arrow IPC file, a Feather V2 file or
+    an Arrow IPC stream, e.g. to log features or predictions for a later
+    ArrowFeatherDataset or ArrowStreamDataset. The schema is taken from the
+    first batch: a tensor of shape [rows] is a column of its dtype, and a
+    tensor of shape [rows, n] a list column. Numeric tensors are written
+    without a copy to an Arrow buffer.
+    """
+
+    def __init__(self, filename, column_names, file_format="file", compression=None):
+        """Create an ArrowWriter.
+
+        Args:
+            filename: Name of the file to write, on any file system supported
+                        by TensorFlow
+            column_names: Names of the columns, one per tensor of a batch
+            file_format: "file" (default) or "feather" for the Arrow IPC file
+                        format, or "stream" for the Arrow IPC stream format
+            compression: Optional compression of the record batch bodies,
+                        "lz4" or "zstd"
+        """
+        self._resource = core_ops.io_arrow_writer_init(
+            filename,
+            column_names,
+            format=file_format,
+            compression=compression or "",
+        )
+
+    def write(self, values):
+        """Append a batch of tensors as one record batch.
+
+        Args:
+            values: A tensor or a list of tensors with the same number of rows
+        """
+        values = [tf.convert_to_tensor(v) for v in nest.flatten(values)]
+        core_ops.io_arrow_writer_write(self._resource, values)
+
+    def close(self):
+        """Write the footer of a file, or the end of a stream, and close it"""
+        core_ops.io_arrow_writer_close(self._resource)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+
+class ParquetWriter:
+    """Writes batches of tensors to a Parquet file, e.g. to write predictions
+    of an offline inference directly in a columnar format. Batches are
+    buffered and written in row groups of `row_group_size` rows, so only one
+    row group is held in memory while the file is written to its file
+    system. The schema is taken from the first batch as in ArrowWriter.
+    """
+
+    def __init__(
+        self,
+        filename,
+        column_names,
+        compression="snappy",
+        row_group_size=131072,
+        dictionary=True,
+    ):
+        """Create a ParquetWriter.
+
+        Args:
+            filename: Name of the file to write, on any file system supported
+                        by TensorFlow
+            column_names: Names of the columns, one per tensor of a batch
+            compression: Compression of the column chunks, "snappy"
+                        (default), "zstd" or None
+            row_group_size: Number of rows of each row group, the last row
+                        group may be smaller
+            dictionary: Whether to dictionary encode the columns (default)
+        """
+        self._resource = core_ops.io_parquet_writer_init(
+            filename,
+            column_names,
+            compression=compression or "",
+            row_group_size=row_group_size,
+            dictionary=dictionary,
+        )
+
+    def write(self, values):
+        """Append a batch of tensors, written once a row group is full.
+
+        Args:
+            values: A tensor or a list of tensors with the same number of rows
+        """
+        values = [tf.convert_to_tensor(v) for v in nest.flatten(values)]
+        core_ops.io_parquet_writer_write(self._resource, values)
+
+    def close(self):
+        """Write the remaining rows and the footer of the file, and close it"""
+        core_ops.io_parquet_writer_close(self._resource)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+
 def list_feather_columns(filename, **kwargs):
     """list_feather_columns"""
     if not tf.executing_eagerly():
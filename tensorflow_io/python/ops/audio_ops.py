@@ -131,6 +131,67 @@ def melscale(input, rate, mels, fmin, fmax, name=None):
     return tf.tensordot(input, matrix, 1)
 
 
+def mel_spectrogram(
+    input,
+    rate,
+    nfft,
+    window,
+    stride,
+    mels,
+    fmin,
+    fmax,
+    power=1.0,
+    log=False,
+    mfcc=0,
+    dtype=tf.float32,
+    name=None,
+):  # pylint: disable=redefined-builtin
+    """
+    Create mel spectrogram from audio in one op.
+
+    The result is that of `spectrogram` followed by `melscale`, optionally
+    followed by the log and the MFCCs of
+    `tf.signal.mfccs_from_log_mel_spectrograms`, without the intermediate
+    tensors.
+
+    Args:
+      input: An 1-D float audio signal Tensor.
+      rate: Sample rate of the audio.
+      nfft: Size of FFT.
+      window: Size of window.
+      stride: Size of hops between windows.
+      mels: Number of mel filterbanks.
+      fmin: Minimum frequency.
+      fmax: Maximum frequency.
+      power: The exponent of the magnitude of the spectrogram, 1.0 for
+        magnitude and 2.0 for power.
+      log: Whether to take the log of the mel spectrogram plus 1e-6.
+      mfcc: The number of MFCCs of the log of the mel spectrogram to return
+        instead, if positive.
+      dtype: The data type of the output, tf.float32 or tf.float16.
+      name: A name for the operation (optional).
+
+    Returns:
+      A tensor of mel spectrogram with shape [frames, mels], or [frames, mfcc]
+      of MFCCs.
+    """
+    return core_ops.io_audio_mel_spectrogram(
+        input,
+        rate=tf.cast(rate, tf.int64),
+        nfft=nfft,
+        window=window,
+        stride=stride,
+        mels=mels,
+        fmin=fmin,
+        fmax=fmax,
+        power=power,
+        log=log,
+        mfcc=mfcc,
+        dtype=dtype,
+        name=name,
+    )
+
+
 def dbscale(input, top_db, ref=1.0, amin=1e-10, name=None):
     """
     Turn spectrogram into db scale
@@ -482,6 +543,56 @@ def resample(input, rate_in, rate_out, name=None):
     )
 
 
+def decode_batch(
+    input, dtype=tf.float32, name=None
+):  # pylint: disable=redefined-builtin
+    """Decode a batch of audio clips in WAV, Flac, Ogg(Vorbis) or MP3.
+
+    The clips are decoded in parallel in one op, and must have the same
+    number of channels.
+
+    Args:
+      input: A string `Tensor` of the audio clips.
+      dtype: The data type of the audio, tf.uint8, tf.int16, tf.int32 or
+        tf.float32. Integer samples are scaled to [-1.0, 1.0) for tf.float32,
+        otherwise it must match the samples of the clips.
+      name: A name for the operation (optional).
+
+    Returns:
+      value: A `RaggedTensor` of the decoded audio in
+        `[batch, (samples), channels]`.
+      rate: A `Tensor` of the sample rates of the clips.
+    """
+    value, row_splits, rate = core_ops.io_audio_decode_batch(
+        tf.reshape(input, [-1]), dtype=dtype, name=name
+    )
+    return tf.RaggedTensor.from_row_splits(value, row_splits, validate=False), rate
+
+
+def decode_resample(
+    input, rate, mono=True, name=None
+):  # pylint: disable=redefined-builtin
+    """Decode an audio clip in WAV, Flac, Ogg(Vorbis) or MP3 and resample it.
+
+    The clip is decoded, mixed down and resampled in chunks within one op,
+    which is equivalent to but cheaper than `decode_wav` and the others
+    followed by `resample`.
+
+    Args:
+      input: A string `Tensor` of the audio clip.
+      rate: The rate of the audio output.
+      mono: Whether to mix the channels down to one by averaging them.
+      name: A name for the operation (optional).
+
+    Returns:
+      output: A float `Tensor` of the resampled audio in
+        `[samples, channels]`, scaled to [-1.0, 1.0).
+    """
+    return core_ops.io_audio_decode_resample(
+        input, rate_out=rate, mono=mono, name=name
+    )
+
+
 def decode_wav(
     input, shape=None, dtype=None, name=None
 ):  # pylint: disable=redefined-builtin
@@ -658,6 +769,55 @@ def encode_aac(input, rate, name=None):  # pylint: disable=redefined-builtin
     return core_ops.io_audio_encode_aac(input, rate, name=name)
 
 
+class AudioWriter:
+    """AudioWriter
+
+    Encodes a waveform written in successive chunks to a file, keeping the
+    encoder between the chunks so that the encoded bytes reach the file as
+    the chunks come, instead of the whole waveform being encoded at once.
+
+    Example:
+
+    >>> with tfio.audio.AudioWriter("speech.flac", rate=16000) as writer:
+    ...   for chunk in chunks:
+    ...     writer.write(chunk)
+
+    The chunks are `[samples, channels]` tensors, all of the channels and
+    dtype of the first. WAV takes `uint8`, `int16`, `int32` (24 bit) and
+    `float32`, FLAC takes `uint8`, `int16` and `int32` (24 bit), and MP3
+    takes `float32`.
+    """
+
+    def __init__(
+        self, filename, rate, format=None
+    ):  # pylint: disable=redefined-builtin
+        """Create an `AudioWriter`.
+
+        Args:
+          filename: A string, the file to write to.
+          rate: The sample rate of the audio.
+          format: The format to encode, one of `wav`, `flac` or `mp3`. By
+            default the extension of `filename`.
+        """
+        self._resource = core_ops.io_audio_writable_init(
+            filename, rate, format=format or ""
+        )
+
+    def write(self, input):  # pylint: disable=redefined-builtin
+        """Encodes a chunk of the waveform to the file."""
+        core_ops.io_audio_writable_write(self._resource, input)
+
+    def close(self):
+        """Encodes what the encoder holds back and closes the file."""
+        core_ops.io_audio_writable_close(self._resource)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+
 class AudioIOTensor:
     """AudioIOTensor"""
 
@@ -22,12 +22,15 @@ from tensorflow_io.python.ops import core_ops
 
 
 class _AvroIODatasetFunction:
-    def __init__(self, function, resource, component, shape, dtype):
+    def __init__(
+        self, function, resource, component, shape, dtype, gpu_compatible=False
+    ):
         self._function = function
         self._resource = resource
         self._component = component
         self._shape = tf.TensorShape([None]).concatenate(shape[1:])
         self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
 
     def __call__(self, start, stop):
         return self._function(
@@ -37,14 +40,80 @@ class _AvroIODatasetFunction:
             component=self._component,
             shape=self._shape,
             dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
 
+class _AvroIODatasetComponentsFunction:
+    def __init__(
+        self, function, resource, components, shapes, dtypes, gpu_compatible=False
+    ):
+        self._function = function
+        self._resource = resource
+        self._components = components
+        self._shapes = [tf.TensorShape([None]).concatenate(e[1:]) for e in shapes]
+        self._dtypes = dtypes
+        self._gpu_compatible = gpu_compatible
+
+    def __call__(self, start, stop):
+        return tuple(
+            self._function(
+                self._resource,
+                start=start,
+                stop=stop,
+                components=self._components,
+                shapes=self._shapes,
+                dtypes=self._dtypes,
+                gpu_compatible=self._gpu_compatible,
+            )
+        )
+
+
+class _AvroReadableDataset(tf.data.Dataset):
+    """Batches of the records of an Avro readable, one per block, read ahead
+    `num_parallel_reads` at a time."""
+
+    def __init__(self, resource, components, shapes, dtypes, num_parallel_reads):
+        shapes = [tf.TensorShape([None]).concatenate(e[1:]) for e in shapes]
+        self._element_spec = tuple(
+            tf.TensorSpec(shape, dtype) for shape, dtype in zip(shapes, dtypes)
+        )
+        variant_tensor = core_ops.io_avro_readable_dataset(
+            resource,
+            capacity=4096,
+            num_parallel_reads=num_parallel_reads,
+            window=2 * num_parallel_reads,
+            components=components,
+            shapes=shapes,
+            dtypes=dtypes,
+        )
+        super().__init__(variant_tensor)
+
+    def _inputs(self):
+        return []
+
+    @property
+    def element_spec(self):
+        return self._element_spec
+
+
 class AvroIODataset(tf.compat.v2.data.Dataset):
     """AvroIODataset"""
 
-    def __init__(self, filename, schema, columns=None, internal=True):
-        """AvroIODataset."""
+    def __init__(
+        self,
+        filename,
+        schema,
+        columns=None,
+        num_parallel_reads=None,
+        gpu_compatible=False,
+        internal=True,
+    ):
+        """AvroIODataset.
+
+        The batches read ahead with `num_parallel_reads` are read without an
+        op context, so `gpu_compatible` only applies to the reads without.
+        """
         if not internal:
             raise ValueError(
                 "AvroIODataset constructor is private; please use one "
@@ -63,35 +132,57 @@ class AvroIODataset(tf.compat.v2.data.Dataset):
             )
             columns = columns if columns is not None else columns_v.numpy()
 
-            columns_dataset = []
-
             columns_function = []
+            columns_shape = []
+            columns_dtype = []
             for column in columns:
                 shape, dtype = core_ops.io_avro_readable_spec(resource, column)
                 shape = tf.TensorShape([None if e < 0 else e for e in shape.numpy()])
                 dtype = tf.as_dtype(dtype.numpy())
                 function = _AvroIODatasetFunction(
-                    core_ops.io_avro_readable_read, resource, column, shape, dtype
+                    core_ops.io_avro_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 columns_function.append(function)
+                columns_shape.append(shape)
+                columns_dtype.append(dtype)
 
-            for column, function in zip(columns, columns_function):
-                column_dataset = tf.compat.v2.data.Dataset.range(
-                    0, sys.maxsize, capacity
-                )
-                column_dataset = column_dataset.map(
-                    lambda index: function(index, index + capacity)
+            if num_parallel_reads:
+                # The blocks are read ahead, and in parallel, in C++.
+                dataset = _AvroReadableDataset(
+                    resource,
+                    list(columns),
+                    columns_shape,
+                    columns_dtype,
+                    num_parallel_reads,
                 )
-                column_dataset = column_dataset.apply(
+                if len(columns_function) == 1:
+                    dataset = dataset.map(lambda v: v)
+            else:
+                if len(columns_function) == 1:
+                    function = columns_function[0]
+                else:
+                    # All columns are read together, in one pass over the
+                    # records.
+                    function = _AvroIODatasetComponentsFunction(
+                        core_ops.io_avro_readable_read_components,
+                        resource,
+                        list(columns),
+                        columns_shape,
+                        columns_dtype,
+                        gpu_compatible=gpu_compatible,
+                    )
+                dataset = tf.compat.v2.data.Dataset.range(0, sys.maxsize, capacity)
+                dataset = dataset.map(lambda index: function(index, index + capacity))
+                dataset = dataset.apply(
                     tf.data.experimental.take_while(
-                        lambda v: tf.greater(tf.shape(v)[0], 0)
+                        lambda *v: tf.greater(tf.shape(v[0])[0], 0)
                     )
                 )
-                columns_dataset.append(column_dataset)
-            if len(columns_dataset) == 1:
-                dataset = columns_dataset[0]
-            else:
-                dataset = tf.compat.v2.data.Dataset.zip(tuple(columns_dataset))
             dataset = dataset.unbatch()
 
             self._function = columns_function
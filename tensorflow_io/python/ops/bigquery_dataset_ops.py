@@ -72,6 +72,10 @@ class BigQueryClient:
         row_restriction="",
         requested_streams=1,
         data_format: DataFormat = DataFormat.AVRO,
+        api_version="v1beta1",
+        arrow_compression=None,
+        max_stream_count=None,
+        preferred_min_stream_count=None,
     ):
         """Opens a session and returns a `BigQueryReadSession` object.
 
@@ -111,6 +115,19 @@ class BigQueryClient:
                 depending on the amount parallelism that is reasonable
                 for the table and the maximum amount of parallelism allowed by the
                 system.
+            data_format: The format of the rows, AVRO or ARROW.
+            api_version: (Optional.) The version of the BigQuery Storage Read
+                API of the session and its streams, "v1beta1" or "v1".
+            arrow_compression: (Optional.) The codec of the buffers of the
+                Arrow record batches, "LZ4_FRAME" or "ZSTD", which cuts the
+                bytes transferred for wide tables at the cost of decompressing
+                them on the reader threads. Requires the "v1" api_version and
+                the ARROW data format.
+            max_stream_count: (Optional.) The maximum number of streams of a
+                "v1" session, `requested_streams` by default.
+            preferred_min_stream_count: (Optional.) The number of streams a
+                "v1" session should have at least, e.g. the number of
+                readers, which BigQuery treats as a hint.
 
         Returns:
             A `BigQueryReadSession` Python object representing the
@@ -139,6 +156,16 @@ class BigQueryClient:
         if requested_streams is None or requested_streams <= 0:
             raise ValueError("`requested_streams` must be a positive number")
 
+        if api_version not in ("v1beta1", "v1"):
+            raise ValueError("`api_version` must be 'v1beta1' or 'v1'")
+        if arrow_compression is not None and (
+            api_version != "v1" or data_format != self.DataFormat.ARROW
+        ):
+            raise ValueError(
+                "`arrow_compression` requires the 'v1' `api_version` and the "
+                "ARROW `data_format`"
+            )
+
         if isinstance(selected_fields, list):
             if output_types is None:
                 if not isinstance(output_types, list):
@@ -210,6 +237,10 @@ class BigQueryClient:
             output_types=output_types,
             default_values=default_values,
             row_restriction=row_restriction,
+            api_version=api_version,
+            arrow_compression=arrow_compression or "",
+            max_stream_count=max_stream_count or 0,
+            preferred_min_stream_count=preferred_min_stream_count or 0,
         )
         return BigQueryReadSession(
             parent,
@@ -226,6 +257,7 @@ class BigQueryClient:
             streams,
             schema,
             self._client_resource,
+            api_version,
         )
 
     def _get_default_value_for_type(self, output_type):
@@ -254,6 +286,7 @@ class BigQueryReadSession:
         streams,
         schema,
         client_resource,
+        api_version="v1beta1",
     ):
         self._parent = parent
         self._project_id = project_id
@@ -269,6 +302,7 @@ class BigQueryReadSession:
         self._streams = streams
         self._schema = schema
         self._client_resource = client_resource
+        self._api_version = api_version
 
     def get_streams(self):
         """Returns Tensor with stream names for reading data from BigQuery.
@@ -278,12 +312,18 @@ class BigQueryReadSession:
         """
         return self._streams
 
-    def read_rows(self, stream, offset=0):
+    def read_rows(self, stream, offset=0, batch_size=None):
         """Retrieves rows (including values) from the BigQuery service.
 
         Args:
             stream: name of the stream to read from.
             offset: Position in the stream.
+            batch_size: (Optional.) If set, each element holds the columns of
+                up to `batch_size` rows of one Arrow record batch, which are
+                converted in one step rather than row by row. Rows of
+                different record batches are not combined, so elements may
+                be smaller. Repeated fields are only supported for the ARROW
+                data format, and if all their rows have the same length.
 
         Returns:
             A `tf.data.Dataset` returning the row keys and the cell contents.
@@ -301,6 +341,8 @@ class BigQueryReadSession:
             self._data_format,
             stream,
             offset,
+            batch_size,
+            api_version=self._api_version,
         )
 
     def parallel_read_rows(
@@ -309,6 +351,7 @@ class BigQueryReadSession:
         sloppy=False,
         block_length=1,
         num_parallel_calls=None,
+        batch_size=None,
     ):
         """Retrieves rows from the BigQuery service in parallel streams.
 
@@ -331,6 +374,8 @@ class BigQueryReadSession:
                 If the value `tf.data.experimental.AUTOTUNE` is used, then the number of
                 parallel calls is set dynamically based on available CPU.
                 Defaulted to the number of streams in the read session.
+            batch_size: (Optional.) If set, each element holds the columns of
+                up to `batch_size` rows, see `read_rows`.
 
         Returns:
             A `tf.data.Dataset` returning the row keys and the cell contents.
@@ -346,13 +391,46 @@ class BigQueryReadSession:
             num_parallel_calls = streams_count
 
         return streams_ds.interleave(
-            map_func=self.read_rows,
+            map_func=lambda stream: self.read_rows(stream, batch_size=batch_size),
             cycle_length=cycle_length,
             block_length=block_length,
             num_parallel_calls=num_parallel_calls,
             deterministic=not (sloppy),
         )
 
+    def concurrent_read_rows(self, num_parallel_streams=None, batch_size=None):
+        """Retrieves the rows of all streams of the session within one dataset.
+
+        Unlike `parallel_read_rows`, the streams are read by a single
+        iterator, up to `num_parallel_streams` of them at a time on background
+        threads. Once no stream is left to start, the streams still being
+        read are split, so that the rows at the end of the session are read
+        in parallel as well. The order of the rows is not deterministic.
+
+        Args:
+            num_parallel_streams: (Optional.) The number of streams read at
+                a time, all streams of the session by default.
+            batch_size: (Optional.) If set, each element holds the columns of
+                up to `batch_size` rows, see `read_rows`.
+
+        Returns:
+            A `tf.data.Dataset` returning the row keys and the cell contents.
+        """
+        return _BigQueryDataset(
+            self._client_resource,
+            self._selected_fields,
+            self._selected_fields_repeated,
+            self._output_types,
+            self._default_values,
+            self._schema,
+            self._data_format,
+            self._streams,
+            0,
+            batch_size,
+            num_parallel_streams,
+            api_version=self._api_version,
+        )
+
 
 class _BigQueryDataset(dataset_ops.DatasetSource):
     """_BigQueryDataset represents a dataset that retrieves keys and values."""
@@ -368,6 +446,9 @@ class _BigQueryDataset(dataset_ops.DatasetSource):
         data_format,
         stream,
         offset,
+        batch_size=None,
+        num_parallel_streams=None,
+        api_version="v1beta1",
     ):
         # selected_fields and corresponding output_types have to be sorted because
         # of b/141251314
@@ -393,6 +474,8 @@ class _BigQueryDataset(dataset_ops.DatasetSource):
             else []
             for repeated in selected_fields_repeated
         )
+        if batch_size is not None:
+            tensor_shapes = [[None] + shape for shape in tensor_shapes]
 
         self._element_spec = collections.OrderedDict(
             zip(
@@ -411,8 +494,13 @@ class _BigQueryDataset(dataset_ops.DatasetSource):
             default_values=default_values,
             schema=schema,
             data_format=data_format.value,
+            api_version=api_version,
             stream=stream,
             offset=offset,
+            batch_size=0 if batch_size is None else batch_size,
+            num_parallel_streams=(
+                0 if num_parallel_streams is None else num_parallel_streams
+            ),
         )
         super().__init__(variant_tensor)
 
@@ -59,12 +59,20 @@ class BigtableTable:
         row_set: bigtable_row_set.RowSet,
         filter: filters.BigtableFilter = None,
         output_type=tf.string,
+        batch_size=None,
+        num_parallel_reads=None,
     ):
         """Retrieves values from Google Bigtable sorted by RowKeys.
         Args:
             columns (List[str]): the list of columns to read from; the order on
                 this list will determine the order in the output tensors
             row_set (RowSet): set of rows to read.
+            batch_size (int): if set, each element holds up to `batch_size`
+                rows, as a tensor of shape `[num_rows, len(columns)]`.
+            num_parallel_reads (int): if set, the row set is split based on
+                SampleRowKeys into up to `num_parallel_reads` ranges of tablets
+                that are read concurrently within the dataset. The rows are then
+                not read in any particular order.
 
         Returns:
             A `tf.data.Dataset` returning the cell contents.
@@ -78,7 +86,14 @@ class BigtableTable:
         if filter is None:
             filter = filters.latest()
         return _BigtableDataset(
-            self._client_resource, self._table_id, columns, row_set, filter, output_type
+            self._client_resource,
+            self._table_id,
+            columns,
+            row_set,
+            filter,
+            output_type,
+            batch_size,
+            num_parallel_reads,
         )
 
     def parallel_read_rows(
@@ -144,14 +159,26 @@ class _BigtableDataset(dataset_ops.DatasetSource):
         row_set: bigtable_row_set.RowSet,
         filter,
         output_type,
+        batch_size=None,
+        num_parallel_reads=None,
     ):
         self._table_id = table_id
         self._columns = columns
         self._filter = filter
-        self._element_spec = tf.TensorSpec(shape=[len(columns)], dtype=output_type)
+        shape = [len(columns)]
+        if batch_size:
+            shape = [None] + shape
+        self._element_spec = tf.TensorSpec(shape=shape, dtype=output_type)
 
         variant_tensor = core_ops.bigtable_dataset(
-            client_resource, row_set._impl, filter._impl, table_id, columns, output_type
+            client_resource,
+            row_set._impl,
+            filter._impl,
+            table_id,
+            columns,
+            output_type,
+            batch_size=batch_size or 0,
+            num_parallel_reads=num_parallel_reads or 1,
         )
         super().__init__(variant_tensor)
 
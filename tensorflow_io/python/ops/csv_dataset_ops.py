@@ -0,0 +1,132 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""CSVDataset"""
+
+import sys
+import uuid
+
+import tensorflow as tf
+from tensorflow_io.python.ops import core_ops
+from tensorflow_io.python.ops import csv_io_tensor_ops
+
+
+class _CSVIODatasetFunction:
+    def __init__(self, function, resource, component, dtype, gpu_compatible=False):
+        self._function = function
+        self._resource = resource
+        self._component = component
+        self._shape = tf.TensorShape([None])
+        self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
+
+    def __call__(self, start, stop):
+        return self._function(
+            self._resource,
+            start=start,
+            stop=stop,
+            component=self._component,
+            shape=self._shape,
+            dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
+        )
+
+
+class CSVIODataset(tf.data.Dataset):
+    """CSVIODataset
+
+    Streams the record batches of a CSV file as they are parsed, instead of
+    loading the whole table first. With `offset` and `length`, only the lines
+    starting in the bytes [offset, offset + length) of the file are read, so
+    that workers may each read a split of the same file.
+    """
+
+    def __init__(
+        self,
+        filename,
+        columns=None,
+        offset=None,
+        length=None,
+        capacity=4096,
+        gpu_compatible=False,
+        internal=True,
+        **kwargs,
+    ):
+        if not internal:
+            raise ValueError(
+                "CSVIODataset constructor is private; please use one "
+                "of the factory methods instead (e.g., "
+                "IODataset.from_csv())"
+            )
+        with tf.name_scope("CSVIODataset") as scope:
+            metadata = ["stream: true"]
+            metadata.extend(
+                csv_io_tensor_ops.csv_options_metadata(columns=columns, **kwargs)
+            )
+            if offset is not None:
+                metadata.append(f"offset: {offset}")
+            if length is not None:
+                metadata.append(f"length: {length}")
+            resource, columns_v = core_ops.io_csv_readable_init(
+                filename,
+                metadata=metadata,
+                container=scope,
+                shared_name=f"{filename}/{uuid.uuid4().hex}",
+            )
+            columns = columns if columns is not None else columns_v.numpy()
+            columns_dataset = []
+            columns_function = []
+            for column in columns:
+                _, dtype = core_ops.io_csv_readable_spec(resource, column)
+                dtype = tf.as_dtype(dtype.numpy())
+                function = _CSVIODatasetFunction(
+                    core_ops.io_csv_readable_read,
+                    resource,
+                    column,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
+                )
+                columns_function.append(function)
+
+            for column, function in zip(columns, columns_function):
+                column_dataset = tf.compat.v2.data.Dataset.range(
+                    0, sys.maxsize, capacity
+                )
+                column_dataset = column_dataset.map(
+                    lambda index: function(index, index + capacity)
+                )
+                column_dataset = column_dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(v)[0], 0)
+                    )
+                )
+                columns_dataset.append(column_dataset)
+            if len(columns_dataset) == 1:
+                dataset = columns_dataset[0]
+            else:
+                dataset = tf.compat.v2.data.Dataset.zip(tuple(columns_dataset))
+            dataset = dataset.unbatch()
+
+            self._function = columns_function
+            self._dataset = dataset
+            super().__init__(
+                self._dataset._variant_tensor
+            )  # pylint: disable=protected-access
+
+    def _inputs(self):
+        return []
+
+    @property
+    def element_spec(self):
+        return self._dataset.element_spec
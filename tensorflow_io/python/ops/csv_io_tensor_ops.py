@@ -21,16 +21,60 @@ from tensorflow_io.python.ops import io_tensor_ops
 from tensorflow_io.python.ops import core_ops
 
 
+def csv_options_metadata(
+    columns=None,
+    column_types=None,
+    delimiter=None,
+    quote_char=None,
+    escape_char=None,
+    double_quote=None,
+    use_threads=None,
+    block_size=None,
+    **kwargs,
+):  # pylint: disable=unused-argument
+    """Returns the init metadata of the CSV reader options.
+
+    Only the `columns` given are converted, and the columns in `column_types`,
+    a dict of column name to `tf.DType`, are converted to that type instead of
+    having their types inferred. A `quote_char` of "" disables quoting. Other
+    arguments are not reader options and are ignored.
+    """
+    metadata = []
+    if columns is not None:
+        metadata.extend(f"include_column: {column}" for column in columns)
+    if column_types is not None:
+        metadata.extend(
+            f"column_type: {tf.as_dtype(dtype).as_datatype_enum} {column}"
+            for column, dtype in column_types.items()
+        )
+    if delimiter is not None:
+        metadata.append(f"delimiter: {delimiter}")
+    if quote_char is not None:
+        metadata.append(f"quote_char: {quote_char}")
+    if escape_char is not None:
+        metadata.append(f"escape_char: {escape_char}")
+    if double_quote is not None:
+        metadata.append(f"double_quote: {str(bool(double_quote)).lower()}")
+    if use_threads is not None:
+        metadata.append(f"use_threads: {str(bool(use_threads)).lower()}")
+    if block_size is not None:
+        metadata.append(f"block_size: {block_size}")
+    return metadata
+
+
 class _IOTensorComponentLabelFunction:
     """_IOTensorComponentLabelFunction"""
 
-    def __init__(self, function, resource, component, shape, dtype):
+    def __init__(
+        self, function, resource, component, shape, dtype, gpu_compatible=False
+    ):
         self._function = function
         self._resource = resource
         self._component = component
         self._length = shape[0]
         self._shape = tf.TensorShape([None]).concatenate(shape[1:])
         self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
 
     def __call__(self, start, stop):
         start, stop, _ = slice(start, stop).indices(self._length)
@@ -42,6 +86,7 @@ class _IOTensorComponentLabelFunction:
             filter=["label"],
             shape=self._shape,
             dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
     @property
@@ -55,10 +100,11 @@ class CSVIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-ac
     # =============================================================================
     # Constructor (private)
     # =============================================================================
-    def __init__(self, filename, internal=False):
+    def __init__(self, filename, gpu_compatible=False, internal=False, **kwargs):
         with tf.name_scope("CSVIOTensor") as scope:
             resource, columns = core_ops.io_csv_readable_init(
                 filename,
+                metadata=csv_options_metadata(**kwargs),
                 container=scope,
                 shared_name=f"{filename}/{uuid.uuid4().hex}",
             )
@@ -70,7 +116,12 @@ class CSVIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-ac
                 dtype = tf.as_dtype(dtype.numpy())
                 spec = tf.TensorSpec(shape, dtype, column)
                 function = io_tensor_ops._IOTensorComponentFunction(  # pylint: disable=protected-access
-                    core_ops.io_csv_readable_read, resource, column, shape, dtype
+                    core_ops.io_csv_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 elements.append(
                     io_tensor_ops.BaseIOTensor(spec, function, internal=internal)
@@ -78,6 +129,7 @@ class CSVIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-ac
             spec = tuple(e.spec for e in elements)
 
             self._resource = resource
+            self._gpu_compatible = gpu_compatible
             super().__init__(spec, columns, elements, internal=internal)
 
     # =============================================================================
@@ -95,6 +147,7 @@ class CSVIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-ac
             column,
             spec.shape,
             spec.dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
         return io_tensor_ops.BaseIOTensor(spec, function, internal=True)
@@ -28,6 +28,8 @@ def decode_dicom_image(
     on_error="skip",
     scale="preserve",
     dtype=tf.uint16,
+    start=0,
+    count=-1,
     name=None,
 ):
     """Getting DICOM Image Data.
@@ -76,6 +78,10 @@ def decode_dicom_image(
         dtype: An optional `tf.DType` from: `tf.uint8`, `tf.uint16`, `tf.uint32`,
         `tf.uint64`, `tf.float16`, `tf.float32`, `tf.float64`. Defaults to
         `tf.uint16`.
+        start: An optional `int`. Defaults to `0`. The first frame to decode.
+        count: An optional `int`. Defaults to `-1`. The number of frames to
+        decode from `start`, or `-1` for all the remaining frames. Only the
+        selected frames are decompressed, in parallel.
         name: A name for the operation (optional).
 
     Returns:
@@ -87,6 +93,8 @@ def decode_dicom_image(
         on_error=on_error,
         scale=scale,
         dtype=dtype,
+        start=start,
+        count=count,
         name=name,
     )
 
@@ -119,7 +127,8 @@ def decode_dicom_data(contents, tags=None, name=None):
     Args:
         contents: A Tensor of type string. 0-D. The byte string encoded DICOM file.
         tags: A Tensor of type `tf.uint32` of any dimension.
-        These `uint32` numbers map directly to DICOM tags.
+        These `uint32` numbers map directly to DICOM tags. The pixel data is
+        not parsed unless a tag follows it.
         name: A name for the operation (optional).
 
     Returns:
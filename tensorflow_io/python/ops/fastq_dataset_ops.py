@@ -0,0 +1,151 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""FastqDataset"""
+
+import sys
+import uuid
+
+import tensorflow as tf
+from tensorflow_io.python.ops import core_ops
+
+
+class _FastqIODatasetFunction:
+    def __init__(self, function, resource, component, shape, dtype):
+        self._function = function
+        self._resource = resource
+        self._component = component
+        self._shape = tf.TensorShape([None]).concatenate(shape[1:])
+        self._dtype = dtype
+
+    def __call__(self, start, stop):
+        return self._function(
+            self._resource,
+            start=start,
+            stop=stop,
+            component=self._component,
+            shape=self._shape,
+            dtype=self._dtype,
+        )
+
+
+class FastqIODataset(tf.compat.v2.data.Dataset):
+    """FastqIODataset"""
+
+    def __init__(
+        self,
+        filename,
+        batch_size=None,
+        packed=False,
+        offset=None,
+        length=None,
+        block_size=None,
+        internal=True,
+    ):
+        """FastqIODataset.
+
+        The records are parsed block by block as they are read, and emitted
+        in batches of `batch_size`. With `offset` and `length`, only the
+        records starting in the bytes [offset, offset + length) of the file,
+        or in the BGZF blocks starting there, are read, so that workers may
+        each read a split of the same file.
+        """
+        if not internal:
+            raise ValueError(
+                "FastqIODataset constructor is private; please use one "
+                "of the factory methods instead (e.g., "
+                "IODataset.from_fastq())"
+            )
+        with tf.name_scope("FastqIODataset") as scope:
+            capacity = batch_size if batch_size is not None else 4096
+
+            metadata = []
+            if offset is not None:
+                metadata.append(f"offset: {offset}")
+            if length is not None:
+                metadata.append(f"length: {length}")
+            if block_size is not None:
+                metadata.append(f"block_size: {block_size}")
+            resource, components = core_ops.io_fastq_readable_init(
+                filename,
+                metadata=metadata,
+                container=scope,
+                shared_name=f"{filename}/{uuid.uuid4().hex}",
+            )
+
+            dataset = tf.compat.v2.data.Dataset.range(0, sys.maxsize, capacity)
+            if packed:
+                dataset = dataset.map(
+                    lambda index: core_ops.io_fastq_readable_read_packed(
+                        resource, start=index, stop=index + capacity
+                    )
+                )
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda base_splits, *_: tf.greater(tf.shape(base_splits)[0], 1)
+                    )
+                )
+                dataset = dataset.map(
+                    lambda base_splits, bases, quality_splits, qualities: (
+                        tf.RaggedTensor.from_row_splits(
+                            bases, base_splits, validate=False
+                        ),
+                        tf.RaggedTensor.from_row_splits(
+                            qualities, quality_splits, validate=False
+                        ),
+                    )
+                )
+            else:
+                components_dataset = []
+                for component in components.numpy():
+                    shape, dtype = core_ops.io_fastq_readable_spec(
+                        resource, component
+                    )
+                    shape = tf.TensorShape(
+                        [None if e < 0 else e for e in shape.numpy()]
+                    )
+                    dtype = tf.as_dtype(dtype.numpy())
+                    function = _FastqIODatasetFunction(
+                        core_ops.io_fastq_readable_read,
+                        resource,
+                        component,
+                        shape,
+                        dtype,
+                    )
+                    component_dataset = dataset.map(
+                        lambda index, function=function: function(
+                            index, index + capacity
+                        )
+                    )
+                    component_dataset = component_dataset.apply(
+                        tf.data.experimental.take_while(
+                            lambda v: tf.greater(tf.shape(v)[0], 0)
+                        )
+                    )
+                    components_dataset.append(component_dataset)
+                dataset = tf.compat.v2.data.Dataset.zip(tuple(components_dataset))
+            if batch_size is None:
+                dataset = dataset.unbatch()
+
+            self._dataset = dataset
+            super().__init__(
+                self._dataset._variant_tensor
+            )  # pylint: disable=protected-access
+
+    def _inputs(self):
+        return []
+
+    @property
+    def element_spec(self):
+        return self._dataset.element_spec
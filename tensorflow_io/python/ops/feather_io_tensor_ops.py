@@ -27,7 +27,7 @@ class FeatherIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protecte
     # =============================================================================
     # Constructor (private)
     # =============================================================================
-    def __init__(self, filename, internal=False):
+    def __init__(self, filename, gpu_compatible=False, internal=False):
         with tf.name_scope("FeatherIOTensor") as scope:
             resource, columns = core_ops.io_feather_readable_init(
                 filename,
@@ -42,7 +42,12 @@ class FeatherIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protecte
                 dtype = tf.as_dtype(dtype.numpy())
                 spec = tf.TensorSpec(shape, dtype, column)
                 function = io_tensor_ops._IOTensorComponentFunction(  # pylint: disable=protected-access
-                    core_ops.io_feather_readable_read, resource, column, shape, dtype
+                    core_ops.io_feather_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 elements.append(
                     io_tensor_ops.BaseIOTensor(spec, function, internal=internal)
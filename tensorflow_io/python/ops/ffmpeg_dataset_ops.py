@@ -24,7 +24,7 @@ from tensorflow_io.python.ops import io_dataset_ops
 class FFmpegAudioGraphIODataset(tf.data.Dataset):
     """FFmpegAudioGraphIODataset"""
 
-    def __init__(self, resource, dtype, internal=True):
+    def __init__(self, resource, dtype, start=0, internal=True):
         """FFmpegAudioGraphIODataset."""
         with tf.name_scope("FFmpegAudioGraphIODataset"):
             from tensorflow_io.python.ops import (  # pylint: disable=import-outside-toplevel
@@ -38,7 +38,7 @@ class FFmpegAudioGraphIODataset(tf.data.Dataset):
             dataset = dataset.map(lambda e: e == 0)
             dataset = dataset.map(
                 lambda reset: ffmpeg_ops.io_ffmpeg_audio_readable_next(
-                    resource, reset, dtype=dtype
+                    resource, reset, dtype=dtype, start=start
                 )
             )
             dataset = dataset.apply(
@@ -61,7 +61,7 @@ class FFmpegAudioGraphIODataset(tf.data.Dataset):
 class FFmpegVideoGraphIODataset(tf.data.Dataset):
     """FFmpegVideoGraphIODataset"""
 
-    def __init__(self, resource, dtype, internal=True):
+    def __init__(self, resource, dtype, start=0, internal=True):
         """FFmpegVideoGraphIODataset."""
         with tf.name_scope("FFmpegVideoGraphIODataset"):
             from tensorflow_io.python.ops import (  # pylint: disable=import-outside-toplevel
@@ -75,7 +75,7 @@ class FFmpegVideoGraphIODataset(tf.data.Dataset):
             dataset = dataset.map(lambda e: e == 0)
             dataset = dataset.map(
                 lambda reset: ffmpeg_ops.io_ffmpeg_video_readable_next(
-                    resource, reset, dtype=dtype
+                    resource, reset, dtype=dtype, start=start, batch=16
                 )
             )
             dataset = dataset.apply(
@@ -16,16 +16,19 @@
 
 import tensorflow as tf
 from tensorflow_io.python.ops import core_ops
+from tensorflow_io.python.ops import hdf5_io_tensor_ops
 
 
 class HDF5IODataset(tf.data.Dataset):
     """HDF5IODataset"""
 
-    def __init__(self, filename, dataset, spec=None, internal=True):
+    def __init__(self, filename, dataset, spec=None, internal=True, **kwargs):
         """HDF5IODataset."""
         with tf.name_scope("HDF5IODataset"):
             assert internal
 
+            options = hdf5_io_tensor_ops.hdf5_dataset_options(**kwargs)
+
             components, shapes, dtypes = core_ops.io_hdf5_readable_info(
                 filename, shared=filename, container="HDF5IODataset"
             )
@@ -61,6 +64,7 @@ class HDF5IODataset(tf.data.Dataset):
                     stop=stop,
                     dtype=self._dtype,
                     container="HDF5IODataset",
+                    **options,
                 )
 
             dataset = dataset.map(f)
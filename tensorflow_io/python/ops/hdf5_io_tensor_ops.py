@@ -19,19 +19,51 @@ from tensorflow_io.python.ops import core_ops
 from tensorflow_io.python.ops import io_tensor_ops
 
 
+def hdf5_dataset_options(
+    cache_dataset=True,
+    chunk_cache_bytes=None,
+    chunk_cache_slots=None,
+    chunk_cache_preemption=None,
+    gpu_compatible=False,
+    **kwargs,
+):  # pylint: disable=unused-argument
+    """Returns the attrs of the HDF5 dataset handles opened to read.
+
+    With `cache_dataset` the handle of a dataset is opened once and reused
+    by the reads that follow. The chunk cache of the handle holds up to
+    `chunk_cache_bytes` in `chunk_cache_slots` hash slots, and evicts fully
+    read chunks first with a `chunk_cache_preemption` in [0, 1]; the file
+    defaults are used for those not given. With `gpu_compatible` the reads
+    are made into host memory that is fast to copy to a GPU, e.g. pinned
+    memory. Other arguments are ignored.
+    """
+    return {
+        "cache_dataset": bool(cache_dataset),
+        "chunk_cache_bytes": -1 if chunk_cache_bytes is None else chunk_cache_bytes,
+        "chunk_cache_slots": -1 if chunk_cache_slots is None else chunk_cache_slots,
+        "chunk_cache_preemption": (
+            -1.0 if chunk_cache_preemption is None else chunk_cache_preemption
+        ),
+        "gpu_compatible": bool(gpu_compatible),
+    }
+
+
 class BaseHDF5GraphIOTensor:
     """BaseHDF5GraphIOTensor"""
 
     # =============================================================================
     # Constructor (private)
     # =============================================================================
-    def __init__(self, filename, component, shape, dtype, internal=False):
+    def __init__(
+        self, filename, component, shape, dtype, options=None, internal=False
+    ):
         with tf.name_scope("BaseHDF5GraphIOTensor"):
             assert internal
             self._filename = filename
             self._component = component
             self._shape = shape
             self._dtype = dtype
+            self._options = options or {}
             super().__init__()
 
     # =============================================================================
@@ -78,6 +110,7 @@ class BaseHDF5GraphIOTensor:
             stop=-1,
             dtype=self._dtype,
             container="HDF5IOTensor",
+            **self._options,
         )
 
     # =============================================================================
@@ -106,6 +139,7 @@ class BaseHDF5GraphIOTensor:
             stop=stop,
             dtype=self._dtype,
             container="HDF5IOTensor",
+            **self._options,
         )
 
         # in case certain dimension is not slice, then this dimension will need to
@@ -127,8 +161,9 @@ class HDF5IOTensor(
     # =============================================================================
     # Constructor (private)
     # =============================================================================
-    def __init__(self, filename, spec=None, internal=False):
+    def __init__(self, filename, spec=None, internal=False, **kwargs):
         with tf.name_scope("HDF5IOTensor"):
+            options = hdf5_dataset_options(**kwargs)
             columns, shapes, dtypes = core_ops.io_hdf5_readable_info(
                 filename, shared=filename, container="HDF5IOTensor"
             )
@@ -167,7 +202,12 @@ class HDF5IOTensor(
 
             def g(entry, shape):
                 return BaseHDF5GraphIOTensor(
-                    filename, entry.name, shape, entry.dtype, internal=True
+                    filename,
+                    entry.name,
+                    shape,
+                    entry.dtype,
+                    options=options,
+                    internal=True,
                 )
 
             elements = [g(entry, shape) for (entry, shape) in zip(entries, shapes)]
@@ -17,18 +17,28 @@
 from tensorflow_io.python.ops import core_ops
 
 
-def decode_webp(contents, name=None):
+def decode_webp(contents, size=None, crop=None, name=None):
     """
     Decode a WebP-encoded image to a uint8 tensor.
 
+    The crop and the scaling are done by the decoder, which then only
+    produces the pixels of the output.
+
     Args:
       contents: A `Tensor` of type `string`. 0-D.  The WebP-encoded image.
+      size: An optional list of 2 ints, the height and width to scale the
+        image to, after the crop if any.
+      crop: An optional list of 4 ints, the y, x, height and width of the
+        region to crop the image to. For lossy images, y and x are rounded
+        down to even numbers.
       name: A name for the operation (optional).
 
     Returns:
       A `Tensor` of type `uint8` and shape of `[height, width, 4]` (RGBA).
     """
-    return core_ops.io_decode_web_p(contents, name=name)
+    return core_ops.io_decode_web_p(
+        contents, size=size or [], crop=crop or [], name=name
+    )
 
 
 def encode_bmp(image, name=None):
@@ -45,15 +55,19 @@ def encode_bmp(image, name=None):
     return core_ops.io_encode_bmp(image, name=name)
 
 
-def encode_gif(image, name=None):
+def encode_gif(image, palette="global", delta=True, name=None):
     """
     Encode a uint8 tensor to gif image.
 
     Args:
       image: A Tensor. 3-D uint8 with shape [N, H, W, C].
+      palette: `global` for one palette shared by all the frames, or `local`
+        for a palette per frame, which are quantized in parallel.
+      delta: If `True`, frames after the first only store the rectangle that
+        changed from the previous frame.
       name: A name for the operation (optional).
 
     Returns:
       A `Tensor` of type `string`.
     """
-    return core_ops.io_encode_gif(image, name=name)
+    return core_ops.io_encode_gif(image, palette=palette, delta=delta, name=name)
@@ -23,10 +23,12 @@ from tensorflow_io.python.ops import lmdb_dataset_ops
 from tensorflow_io.python.ops import kafka_dataset_ops
 from tensorflow_io.python.ops import ffmpeg_dataset_ops
 from tensorflow_io.python.ops import json_dataset_ops
+from tensorflow_io.python.ops import fastq_dataset_ops
 from tensorflow_io.python.ops import parquet_dataset_ops
 from tensorflow_io.python.ops import pcap_dataset_ops
 from tensorflow_io.python.ops import mnist_dataset_ops
 from tensorflow_io.python.ops import orc_dataset_ops
+from tensorflow_io.python.ops import csv_dataset_ops
 
 
 class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
@@ -126,6 +128,7 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         stop=-1,
         servers=None,
         configuration=None,
+        num_parallel_reads=None,
         **kwargs
     ):
         """Creates an `IODataset` from kafka server with an offset range.
@@ -148,6 +151,9 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
               prefixed with `conf.topic.`. Examples include
               ["conf.topic.auto.offset.reset=earliest"]
             Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          num_parallel_reads: An optional number of sub-ranges of the offset
+            range read in parallel, each by a consumer of its own, e.g. for
+            backfills. By default the range is read sequentially.
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -162,6 +168,7 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
                 stop=stop,
                 servers=servers,
                 configuration=configuration,
+                num_parallel_reads=num_parallel_reads,
                 internal=True,
             )
 
@@ -193,6 +200,17 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
             dataset. In graph mode, spec is needed. In eager mode,
             spec is probed automatically.
           name: A name prefix for the IOTensor (optional).
+          cache_dataset: Reuse the handle of a dataset across reads
+            (optional, default True).
+          chunk_cache_bytes: The size in bytes of the chunk cache of a
+            dataset (optional).
+          chunk_cache_slots: The number of hash slots of the chunk cache of
+            a dataset (optional).
+          chunk_cache_preemption: A float in [0, 1], how strongly fully read
+            chunks are evicted first from the chunk cache (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
 
         Returns:
           A `IODataset`.
@@ -200,7 +218,7 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         """
         with tf.name_scope(kwargs.get("name", "IOFromHDF5")):
             return hdf5_dataset_ops.HDF5IODataset(
-                filename, dataset, spec=spec, internal=True
+                filename, dataset, spec=spec, internal=True, **kwargs
             )
 
     @classmethod
@@ -211,6 +229,12 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
           filename: A string, the filename of a avro file.
           schema: A string, the schema of a avro file.
           columns: A list of column names within avro file.
+          num_parallel_reads: An integer, if set the blocks of the file are
+            read ahead in C++, as many at a time, and still produced in order
+            (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -219,7 +243,12 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         """
         with tf.name_scope(kwargs.get("name", "IOFromAvro")):
             return avro_dataset_ops.AvroIODataset(
-                filename, schema, columns=columns, internal=True
+                filename,
+                schema,
+                columns=columns,
+                num_parallel_reads=kwargs.get("num_parallel_reads", None),
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
             )
 
     @classmethod
@@ -228,6 +257,10 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of a lmdb file.
+          num_parallel_reads: An integer, if greater than 1 the keys are split
+            into as many ranges that are read in parallel, each in a
+            transaction of its own. The records are then not in key order
+            (optional).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -235,7 +268,12 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
 
         """
         with tf.name_scope(kwargs.get("name", "IOFromLMDB")):
-            return lmdb_dataset_ops.LMDBIODataset(filename, internal=True)
+            return lmdb_dataset_ops.LMDBIODataset(
+                filename,
+                num_parallel_reads=kwargs.get("num_parallel_reads", None),
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
+            )
 
     @classmethod
     def from_json(cls, filename, columns=None, mode=None, **kwargs):
@@ -246,6 +284,17 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
           columns: A list of column names. By default (None)
             all columns will be read.
           mode: A string, the mode (records or None) to open json file.
+          stream: Whether to parse the newline-delimited records as they are
+            read, decoding only `columns`. Defaults to False.
+          offset: The byte offset of the split to read, which starts at the
+            first line starting at or after it (optional).
+          length: The number of bytes of the split to read, which stops at
+            the first line starting at or after offset + length (optional).
+          block_size: The number of bytes parsed at a time when streaming
+            (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -254,7 +303,56 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         """
         with tf.name_scope(kwargs.get("name", "IOFromJSON")):
             return json_dataset_ops.JSONIODataset(
-                filename, columns=columns, mode=mode, internal=True
+                filename,
+                columns=columns,
+                mode=mode,
+                stream=kwargs.get("stream", False),
+                offset=kwargs.get("offset", None),
+                length=kwargs.get("length", None),
+                block_size=kwargs.get("block_size", None),
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
+            )
+
+    @classmethod
+    def from_fastq(cls, filename, **kwargs):
+        """Creates an `IODataset` from a FASTQ file.
+
+        The records are streamed from the file, plain or BGZF compressed, as
+        (sequence, quality) pairs. With `packed`, the bases are packed 4 to a
+        byte, the first base of a byte in its 2 high bits as A = 0, C = 1,
+        G = 2 and T = 3, and the phred quality scores are decoded into bytes,
+        as uint8 `RaggedTensor`s. Bases other than A, C, G and T are packed
+        as A with a quality of 0.
+
+        Args:
+          filename: A string, the filename of a FASTQ file.
+          batch_size: The number of records of each element, which are then
+            batches of records (optional).
+          packed: Whether to pack the bases and decode the qualities.
+            Defaults to False.
+          offset: The byte offset of the split to read, which starts at the
+            first record starting at or after it (optional).
+          length: The number of bytes of the split to read, which stops at
+            the first record starting at or after offset + length (optional).
+          block_size: The number of bytes read at a time from a file that is
+            not compressed (optional).
+          name: A name prefix for the IOTensor (optional).
+
+        Returns:
+          A `IODataset`.
+
+        """
+        with tf.name_scope(kwargs.get("name", "IOFromFastq")):
+            return fastq_dataset_ops.FastqIODataset(
+                filename,
+                batch_size=kwargs.get("batch_size", None),
+                packed=kwargs.get("packed", False),
+                offset=kwargs.get("offset", None),
+                length=kwargs.get("length", None),
+                block_size=kwargs.get("block_size", None),
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
             )
 
     @classmethod
@@ -265,6 +363,9 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
           filename: A string, the filename of a Parquet file.
           columns: A list of column names. By default (None)
             all columns will be read.
+          masked: Whether each column is a tuple of its value and whether
+            the row is not null, so that nullable columns can be read.
+            Defaults to False.
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -273,7 +374,10 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         """
         with tf.name_scope(kwargs.get("name", "IOFromParquet")):
             return parquet_dataset_ops.ParquetIODataset(
-                filename, columns=columns, internal=True
+                filename,
+                columns=columns,
+                masked=kwargs.get("masked", False),
+                internal=True,
             )
 
     @classmethod
@@ -300,6 +404,10 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of a pcap file.
+          capacity: The number of packets read at a time (optional).
+          ragged: Whether each element is a batch of `capacity` packets, as
+            their timestamps and a uint8 `RaggedTensor` of their data, rather
+            than one packet as a string. Defaults to False.
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -315,6 +423,18 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of an ORC file.
+          columns: A list of column names, the only columns to decode.
+            By default (None) all columns will be read.
+          masked: Whether each column is a tuple of its value and whether
+            the row is not null. Defaults to False.
+          stream: Whether to read the file stripe by stripe instead of
+            loading it when opened. Defaults to False.
+          batch_size: The number of rows decoded at a time (optional).
+          num_parallel_reads: The number of stripes decoded in parallel in
+            streaming mode (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -324,6 +444,41 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
         with tf.name_scope(kwargs.get("name", "IOFromORC")):
             return orc_dataset_ops.ORCIODataset(filename, internal=True, **kwargs)
 
+    @classmethod
+    def from_csv(cls, filename, **kwargs):
+        """Creates an `IODataset` from a CSV file, parsed as it is read.
+
+        Args:
+          filename: A string, the filename of a CSV file.
+          columns: A list of column names, the only columns converted.
+            By default (None) all columns will be read.
+          column_types: A dict of column name to `tf.DType`, for the columns
+            whose types are not to be inferred (optional).
+          delimiter: The field delimiter character (optional).
+          quote_char: The quoting character, or "" to disable quoting
+            (optional).
+          escape_char: The escaping character (optional).
+          double_quote: Whether two quote characters in a quoted field are
+            one quote character (optional).
+          use_threads: Whether to parse and convert blocks in parallel
+            (optional).
+          block_size: The number of bytes parsed at a time (optional).
+          offset: The byte offset of the split to read, which starts at the
+            first line starting at or after it (optional).
+          length: The number of bytes of the split to read, which stops at
+            the first line starting at or after offset + length (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
+          name: A name prefix for the IODataset (optional).
+
+        Returns:
+          A `IODataset`.
+
+        """
+        with tf.name_scope(kwargs.get("name", "IOFromCSV")):
+            return csv_dataset_ops.CSVIODataset(filename, internal=True, **kwargs)
+
 
 class StreamIODataset(
     io_dataset_ops._StreamIODataset
@@ -432,6 +587,8 @@ class GraphIODataset(tf.data.Dataset):
 
         Args:
           filename: A string, the filename of a media file.
+          start: The sample of audio or the frame of video to start from,
+            seeked to through the keyframes of the file (optional).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -443,13 +600,15 @@ class GraphIODataset(tf.data.Dataset):
                 ffmpeg_ops,
             )
 
+            start = kwargs.get("start", 0)
+
             if stream.startswith("a:"):
                 resource = ffmpeg_ops.io_ffmpeg_audio_readable_init(
                     filename, int(stream[2:])
                 )
                 dtype = cls._dtype
                 return ffmpeg_dataset_ops.FFmpegAudioGraphIODataset(
-                    resource, dtype, internal=True
+                    resource, dtype, start=start, internal=True
                 )
 
             if stream.startswith("v:"):
@@ -458,7 +617,7 @@ class GraphIODataset(tf.data.Dataset):
                 )
                 dtype = cls._dtype
                 return ffmpeg_dataset_ops.FFmpegVideoGraphIODataset(
-                    resource, dtype, internal=True
+                    resource, dtype, start=start, internal=True
                 )
 
             return None
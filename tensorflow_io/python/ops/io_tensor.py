@@ -263,6 +263,9 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of an json file.
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -271,7 +274,10 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
         """
         with tf.name_scope(kwargs.get("name", "IOFromJSON")):
             return json_io_tensor_ops.JSONIOTensor(
-                filename, mode=kwargs.get("mode", None), internal=True
+                filename,
+                mode=kwargs.get("mode", None),
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
             )
 
     @classmethod
@@ -314,6 +320,9 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of an feather file.
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -321,7 +330,11 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
 
         """
         with tf.name_scope(kwargs.get("name", "IOFromFeather")):
-            return feather_io_tensor_ops.FeatherIOTensor(filename, internal=True)
+            return feather_io_tensor_ops.FeatherIOTensor(
+                filename,
+                gpu_compatible=kwargs.get("gpu_compatible", False),
+                internal=True,
+            )
 
     @classmethod
     def from_arrow(cls, table, spec=None, **kwargs):
@@ -369,13 +382,26 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
             or dtype of the dataset. In eager mode the spec is probed
             automatically. In graph mode spec has to be specified.
           name: A name prefix for the IOTensor (optional).
+          cache_dataset: Reuse the handle of a dataset across reads
+            (optional, default True).
+          chunk_cache_bytes: The size in bytes of the chunk cache of a
+            dataset (optional).
+          chunk_cache_slots: The number of hash slots of the chunk cache of
+            a dataset (optional).
+          chunk_cache_preemption: A float in [0, 1], how strongly fully read
+            chunks are evicted first from the chunk cache (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
 
         Returns:
           A `IOTensor`.
 
         """
         with tf.name_scope(kwargs.get("name", "IOFromHDF5")):
-            return hdf5_io_tensor_ops.HDF5IOTensor(filename, spec=spec, internal=True)
+            return hdf5_io_tensor_ops.HDF5IOTensor(
+                filename, spec=spec, internal=True, **kwargs
+            )
 
     @classmethod
     def from_csv(cls, filename, **kwargs):
@@ -383,6 +409,22 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
 
         Args:
           filename: A string, the filename of an csv file.
+          columns: A list of column names, the only columns converted.
+            By default (None) all columns will be read.
+          column_types: A dict of column name to `tf.DType`, for the columns
+            whose types are not to be inferred (optional).
+          delimiter: The field delimiter character (optional).
+          quote_char: The quoting character, or "" to disable quoting
+            (optional).
+          escape_char: The escaping character (optional).
+          double_quote: Whether two quote characters in a quoted field are
+            one quote character (optional).
+          use_threads: Whether to parse and convert blocks in parallel
+            (optional).
+          block_size: The number of bytes parsed at a time (optional).
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -390,7 +432,7 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
 
         """
         with tf.name_scope(kwargs.get("name", "IOFromCSV")):
-            return csv_io_tensor_ops.CSVIOTensor(filename, internal=True)
+            return csv_io_tensor_ops.CSVIOTensor(filename, internal=True, **kwargs)
 
     @classmethod
     def from_avro(cls, filename, schema, **kwargs):
@@ -399,6 +441,9 @@ class IOTensor(io_tensor_ops._IOTensor):  # pylint: disable=protected-access
         Args:
           filename: A string, the filename of an avro file.
           schema: A string, the schema of an avro file.
+          gpu_compatible: Whether the reads are made into host memory that
+            is fast to copy to a GPU, e.g. pinned memory, for data fed to one
+            (optional, default False).
           name: A name prefix for the IOTensor (optional).
 
         Returns:
@@ -24,13 +24,16 @@ class _IOTensorMeta(property):
 class _IOTensorComponentFunction:
     """_IOTensorComponentFunction will translate call"""
 
-    def __init__(self, function, resource, component, shape, dtype):
+    def __init__(
+        self, function, resource, component, shape, dtype, gpu_compatible=False
+    ):
         self._function = function
         self._resource = resource
         self._component = component
         self._length = shape[0]
         self._shape = tf.TensorShape([None]).concatenate(shape[1:])
         self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
 
     def __call__(self, start, stop):
         start, stop, _ = slice(start, stop).indices(self._length)
@@ -41,6 +44,7 @@ class _IOTensorComponentFunction:
             component=self._component,
             shape=self._shape,
             dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
     @property
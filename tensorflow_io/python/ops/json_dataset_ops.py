@@ -22,12 +22,15 @@ from tensorflow_io.python.ops import core_ops
 
 
 class _JSONIODatasetFunction:
-    def __init__(self, function, resource, component, shape, dtype):
+    def __init__(
+        self, function, resource, component, shape, dtype, gpu_compatible=False
+    ):
         self._function = function
         self._resource = resource
         self._component = component
         self._shape = tf.TensorShape([None]).concatenate(shape[1:])
         self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
 
     def __call__(self, start, stop):
         return self._function(
@@ -37,14 +40,33 @@ class _JSONIODatasetFunction:
             component=self._component,
             shape=self._shape,
             dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
 
 class JSONIODataset(tf.compat.v2.data.Dataset):
     """JSONIODataset"""
 
-    def __init__(self, filename, columns=None, mode=None, internal=True):
-        """JSONIODataset."""
+    def __init__(
+        self,
+        filename,
+        columns=None,
+        mode=None,
+        stream=False,
+        offset=None,
+        length=None,
+        block_size=None,
+        gpu_compatible=False,
+        internal=True,
+    ):
+        """JSONIODataset.
+
+        With `stream`, the newline-delimited records are parsed block by block
+        as they are read, decoding only the `columns` given, instead of being
+        loaded when opened. With `offset` and `length`, only the lines starting
+        in the bytes [offset, offset + length) of the file are read, so that
+        workers may each read a split of the same file.
+        """
         if not internal:
             raise ValueError(
                 "JSONIODataset constructor is private; please use one "
@@ -55,6 +77,16 @@ class JSONIODataset(tf.compat.v2.data.Dataset):
             capacity = 4096
 
             metadata = [] if mode is None else ["mode: %s" % mode]
+            if stream:
+                metadata.append("stream: true")
+                if columns is not None:
+                    metadata.extend(f"column: {column}" for column in columns)
+            if offset is not None:
+                metadata.append(f"offset: {offset}")
+            if length is not None:
+                metadata.append(f"length: {length}")
+            if block_size is not None:
+                metadata.append(f"block_size: {block_size}")
             resource, columns_v = core_ops.io_json_readable_init(
                 filename,
                 metadata=metadata,
@@ -71,7 +103,12 @@ class JSONIODataset(tf.compat.v2.data.Dataset):
                 shape = tf.TensorShape([None if e < 0 else e for e in shape.numpy()])
                 dtype = tf.as_dtype(dtype.numpy())
                 function = _JSONIODatasetFunction(
-                    core_ops.io_json_readable_read, resource, column, shape, dtype
+                    core_ops.io_json_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 columns_function.append(function)
 
@@ -27,7 +27,7 @@ class JSONIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-a
     # =============================================================================
     # Constructor (private)
     # =============================================================================
-    def __init__(self, filename, mode=None, internal=False):
+    def __init__(self, filename, mode=None, gpu_compatible=False, internal=False):
         with tf.name_scope("JSONIOTensor") as scope:
             metadata = [] if mode is None else ["mode: %s" % mode]
             resource, columns = core_ops.io_json_readable_init(
@@ -44,7 +44,12 @@ class JSONIOTensor(io_tensor_ops._TableIOTensor):  # pylint: disable=protected-a
                 dtype = tf.as_dtype(dtype.numpy())
                 spec = tf.TensorSpec(shape, dtype, column)
                 function = io_tensor_ops._IOTensorComponentFunction(  # pylint: disable=protected-access
-                    core_ops.io_json_readable_read, resource, column, shape, dtype
+                    core_ops.io_json_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 elements.append(
                     io_tensor_ops.BaseIOTensor(spec, function, internal=internal)
@@ -22,7 +22,15 @@ class KafkaIODataset(tf.data.Dataset):
     """KafkaIODataset"""
 
     def __init__(
-        self, topic, partition, start, stop, servers, configuration, internal=True
+        self,
+        topic,
+        partition,
+        start,
+        stop,
+        servers,
+        configuration,
+        num_parallel_reads=None,
+        internal=True,
     ):
         """Creates a `KafkaIODataset` from kafka server with an offset range.
 
@@ -43,6 +51,9 @@ class KafkaIODataset(tf.data.Dataset):
               prefixed with `conf.topic.`. Examples include
               ["conf.topic.auto.offset.reset=earliest"]
             Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          num_parallel_reads: An optional number of sub-ranges of 1024
+            messages read in parallel, each by a consumer of its own, by
+            default 1. The messages are still returned in offset order.
           internal: Whether the dataset is being created from within the named scope.
             Default: True
         """
@@ -61,7 +72,7 @@ class KafkaIODataset(tf.data.Dataset):
             self._start, self._stop = start, stop
 
             step = 1024
-            indices_start = tf.data.Dataset.range(0, stop, step)
+            indices_start = tf.data.Dataset.range(start, stop, step)
             indices_stop = indices_start.skip(1).concatenate(
                 tf.data.Dataset.from_tensor_slices([stop])
             )
@@ -72,7 +83,9 @@ class KafkaIODataset(tf.data.Dataset):
                     self._resource, start=start, stop=stop
                 )
 
-            dataset = dataset.map(f)
+            dataset = dataset.map(
+                f, num_parallel_calls=num_parallel_reads, deterministic=True
+            )
             dataset = dataset.unbatch()
 
             self._dataset = dataset
@@ -40,36 +40,30 @@ class LMDBIODataset(tf.compat.v2.data.Dataset):
 
     def __init__(self, filename, **kwargs):
         with tf.name_scope("LMDBIODataset") as scope:
-            mapping = core_ops.io_lmdb_mapping_init(
-                filename,
-                container=scope,
-                shared_name=f"{filename}/{uuid.uuid4().hex}",
-            )
+            metadata = []
+            num_parallel_reads = kwargs.get("num_parallel_reads", None)
+            if num_parallel_reads:
+                metadata.append(f"num_parallel_reads: {num_parallel_reads}")
             resource = core_ops.io_lmdb_readable_init(
                 filename,
+                metadata,
                 container=scope,
                 shared_name=f"{filename}/{uuid.uuid4().hex}",
             )
             capacity = kwargs.get("capacity", 4096)
             dataset = tf.compat.v2.data.Dataset.range(0, sys.maxsize, capacity)
             dataset = dataset.map(
-                lambda index: core_ops.io_lmdb_readable_read(
-                    resource,
-                    start=index,
-                    stop=index + capacity,
-                    shape=tf.TensorShape([None]),
-                    dtype=tf.string,
+                lambda index: core_ops.io_lmdb_readable_read_items(
+                    resource, start=index, stop=index + capacity
                 )
             )
             dataset = dataset.apply(
-                tf.data.experimental.take_while(lambda v: tf.greater(tf.shape(v)[0], 0))
-            )
-            dataset = dataset.map(
-                lambda key: (key, core_ops.io_lmdb_mapping_read(mapping, key))
+                tf.data.experimental.take_while(
+                    lambda key, value: tf.greater(tf.shape(key)[0], 0)
+                )
             )
             dataset = dataset.unbatch()
 
-            self._mapping = mapping
             self._resource = resource
             self._capacity = capacity
             self._dataset = dataset
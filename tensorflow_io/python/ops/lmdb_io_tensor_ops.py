@@ -57,6 +57,7 @@ class LMDBIOTensor(io_tensor_ops._KeyValueIOTensor):  # pylint: disable=protecte
                     with tf.name_scope("IterableInit") as scope:
                         return self._func(
                             self._filename,
+                            [],
                             container=scope,
                             shared_name="{}/{}".format(
                                 self._filename, uuid.uuid4().hex
@@ -0,0 +1,181 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""The op libraries split out of libtensorflow_io.so.
+
+Each library of a subsystem with heavy dependencies is only loaded once one
+of its ops is used. The ops of each library are listed by their Python
+names, and all the ops not listed here are in libtensorflow_io.so. The
+libraries match the `python/ops/libtensorflow_io_*.so` targets of
+tensorflow_io/BUILD, and their ops the REGISTER_OP of their `ops/*.cc`.
+"""
+
+DEFAULT_LIBRARY = "libtensorflow_io.so"
+
+OP_LIBRARIES = {
+    "libtensorflow_io_arrow.so": [
+        "io_arrow_zero_copy_dataset",
+        "io_arrow_serialized_dataset",
+        "io_arrow_feather_dataset",
+        "io_arrow_stream_dataset",
+        "io_arrow_flight_dataset",
+        "io_arrow_scanner_dataset",
+        "io_arrow_writer_init",
+        "io_arrow_writer_write",
+        "io_arrow_writer_close",
+        "io_parquet_writer_init",
+        "io_parquet_writer_write",
+        "io_parquet_writer_close",
+        "io_list_feather_columns",
+        "io_feather_readable_init",
+        "io_feather_readable_spec",
+        "io_feather_readable_read",
+        "io_arrow_readable_from_memory_init",
+        "io_arrow_readable_spec",
+        "io_arrow_readable_read",
+        "io_json_readable_init",
+        "io_json_readable_spec",
+        "io_json_readable_read",
+        "io_decode_libsvm",
+        "io_decode_libsvm_csr",
+        "io_parquet_readable_info",
+        "io_parquet_readable_read",
+        "io_parquet_readable_read_masked",
+        "io_parquet_readable_read_dictionary",
+        "io_re2_full_match",
+        "io_re2_full_match_set",
+        "io_read_text",
+        "io_text_output_sequence",
+        "io_text_output_sequence_set_item",
+        "io_text_output_sequence_flush",
+        "io_csv_readable_init",
+        "io_csv_readable_spec",
+        "io_csv_readable_read",
+    ],
+    "libtensorflow_io_avro.so": [
+        "io_parse_avro",
+        "io_avro_record_dataset",
+        "io_write_avro_block_index",
+        "io_avro_dataset",
+        "io_list_avro_columns",
+        "io_read_avro",
+        "io_avro_readable_init",
+        "io_avro_readable_spec",
+        "io_avro_readable_read",
+        "io_avro_readable_read_components",
+        "io_avro_readable_dataset",
+        "io_avro_readable_partitions",
+        "io_atds_dataset",
+    ],
+    "libtensorflow_io_bigquery.so": [
+        "io_big_query_client",
+        "io_big_query_read_session",
+        "io_big_query_dataset",
+        "io_big_query_test_client",
+    ],
+    "libtensorflow_io_bigtable.so": [
+        "bigtable_client",
+        "bigtable_dataset",
+        "bigtable_empty_row_set",
+        "bigtable_empty_row_range",
+        "bigtable_prefix_row_range",
+        "bigtable_row_range",
+        "bigtable_print_row_range",
+        "bigtable_print_row_set",
+        "bigtable_row_set_append_row",
+        "bigtable_row_set_append_row_range",
+        "bigtable_row_set_intersect",
+        "bigtable_split_row_set_evenly",
+        "bigtable_latest_filter",
+        "bigtable_timestamp_range_filter",
+        "bigtable_print_filter",
+    ],
+    "libtensorflow_io_hdf5.so": [
+        "io_hdf5_readable_info",
+        "io_hdf5_readable_read",
+    ],
+    "libtensorflow_io_image.so": [
+        "io_decode_tiff_info",
+        "io_decode_tiff",
+        "io_decode_tiff_region",
+        "io_encode_bmp",
+        "io_decode_web_p",
+        "io_decode_pnm",
+        "io_draw_bounding_boxes_v3",
+        "io_decode_jpeg_exif",
+        "io_decode_exr_info",
+        "io_decode_exr",
+        "io_decode_hdr",
+        "io_decode_dicom_image",
+        "io_decode_dicom_data",
+        "io_decode_nv12",
+        "io_decode_yuy2",
+        "io_raster_readable_init",
+        "io_raster_readable_spec",
+        "io_raster_readable_read",
+        "io_convert_color",
+        "io_decode_image_batch",
+        "io_decode_nv12_batch",
+        "io_decode_yuy2_batch",
+        "io_decode_avif",
+        "io_decode_jpeg2k",
+        "io_encode_gif",
+    ],
+    "libtensorflow_io_kafka.so": [
+        "io_kafka_readable_init",
+        "io_kafka_readable_next",
+        "io_kafka_readable_read",
+        "io_kafka_readable_spec",
+        "io_kafka_iterable_init",
+        "io_layer_kafka_call",
+        "io_layer_kafka_init",
+        "io_layer_kafka_sync",
+        "io_kafka_group_readable_init",
+        "io_kafka_group_readable_next",
+        "io_kafka_dataset",
+        "io_write_kafka",
+        "io_kafka_encode_avro",
+        "io_kafka_decode_avro_init",
+        "io_kafka_decode_avro",
+        "io_kafka_output_sequence",
+        "io_kafka_output_sequence_set_item",
+        "io_kafka_output_sequence_flush",
+    ],
+    "libtensorflow_io_kinesis.so": [
+        "io_kinesis_readable_init",
+        "io_kinesis_readable_read",
+    ],
+    "libtensorflow_io_mongodb.so": [
+        "io_mongo_db_readable_init",
+        "io_mongo_db_readable_next",
+        "io_mongo_db_writable_init",
+        "io_mongo_db_writable_write",
+        "io_mongo_db_writable_write_columns",
+        "io_mongo_db_writable_delete_many",
+    ],
+    "libtensorflow_io_pubsub.so": [
+        "io_pub_sub_readable_init",
+        "io_pub_sub_readable_read",
+    ],
+    "libtensorflow_io_pulsar.so": [
+        "io_pulsar_readable_init",
+        "io_pulsar_readable_next",
+        "io_pulsar_writable_init",
+        "io_pulsar_writable_write",
+        "io_pulsar_writable_write_batch",
+        "io_pulsar_writable_flush",
+    ],
+}
+
+LIBRARY_OF_OP = {op: library for library, ops in OP_LIBRARIES.items() for op in ops}
@@ -22,12 +22,15 @@ from tensorflow_io.python.ops import core_ops
 
 
 class _ORCIODatasetFunction:
-    def __init__(self, function, resource, component, shape, dtype):
+    def __init__(
+        self, function, resource, component, shape, dtype, gpu_compatible=False
+    ):
         self._function = function
         self._resource = resource
         self._component = component
         self._shape = tf.TensorShape([None]).concatenate(shape[1:])
         self._dtype = dtype
+        self._gpu_compatible = gpu_compatible
 
     def __call__(self, start, stop):
         return self._function(
@@ -37,13 +40,34 @@ class _ORCIODatasetFunction:
             component=self._component,
             shape=self._shape,
             dtype=self._dtype,
+            gpu_compatible=self._gpu_compatible,
         )
 
 
 class ORCIODataset(tf.data.Dataset):
     """ORCIODataset"""
 
-    def __init__(self, filename, columns=None, internal=True, **kwargs):
+    def __init__(
+        self,
+        filename,
+        columns=None,
+        masked=False,
+        stream=False,
+        batch_size=None,
+        num_parallel_reads=None,
+        gpu_compatible=False,
+        internal=True,
+        **kwargs,
+    ):
+        """ORCIODataset.
+
+        With `masked`, each column is a tuple of its value, with the default
+        value for null rows, and whether the row is not null.
+
+        Only the `columns` given are decoded. With `stream`, the file is not
+        loaded when opened, but read stripe by stripe, `num_parallel_reads`
+        stripes being decoded in parallel, in batches of `batch_size` rows.
+        """
         if not internal:
             raise ValueError(
                 "ORCIODataset constructor is private; please use one "
@@ -51,9 +75,17 @@ class ORCIODataset(tf.data.Dataset):
                 "IODataset.from_orc())"
             )
         with tf.name_scope("ORCIODataset") as scope:
-            capacity = 4096
+            capacity = kwargs.get("capacity", 4096)
+            metadata = [] if columns is None else [f"column: {e}" for e in columns]
+            if stream:
+                metadata.append("stream: true")
+            if batch_size is not None:
+                metadata.append(f"batch_size: {batch_size}")
+            if num_parallel_reads is not None:
+                metadata.append(f"num_parallel_reads: {num_parallel_reads}")
             resource, columns_v = core_ops.io_orc_readable_init(
                 filename,
+                metadata=metadata,
                 container=scope,
                 shared_name=f"{filename}/{uuid.uuid4().hex}",
             )
@@ -65,7 +97,14 @@ class ORCIODataset(tf.data.Dataset):
                 shape = tf.TensorShape([None if e < 0 else e for e in shape.numpy()])
                 dtype = tf.as_dtype(dtype.numpy())
                 function = _ORCIODatasetFunction(
-                    core_ops.io_orc_readable_read, resource, column, shape, dtype
+                    core_ops.io_orc_readable_read_masked
+                    if masked
+                    else core_ops.io_orc_readable_read,
+                    resource,
+                    column,
+                    shape,
+                    dtype,
+                    gpu_compatible=gpu_compatible,
                 )
                 columns_function.append(function)
 
@@ -78,7 +117,7 @@ class ORCIODataset(tf.data.Dataset):
                 )
                 column_dataset = column_dataset.apply(
                     tf.data.experimental.take_while(
-                        lambda v: tf.greater(tf.shape(v)[0], 0)
+                        lambda v, *mask: tf.greater(tf.shape(v)[0], 0)
                     )
                 )
                 columns_dataset.append(column_dataset)
@@ -23,8 +23,12 @@ from tensorflow_io.python.ops import core_ops
 class ParquetIODataset(tf.data.Dataset):
     """ParquetIODataset"""
 
-    def __init__(self, filename, columns=None, internal=True):
-        """ParquetIODataset."""
+    def __init__(self, filename, columns=None, masked=False, internal=True):
+        """ParquetIODataset.
+
+        With `masked`, each column is a tuple of its value, with the default
+        value for null rows, and whether the row is not null.
+        """
         assert internal
         with tf.name_scope("ParquetIODataset"):
             components, shapes, dtypes = core_ops.io_parquet_readable_info(
@@ -90,6 +94,17 @@ class ParquetIODataset(tf.data.Dataset):
                 dataset = tf.data.Dataset.zip((indices_start, indices_stop))
 
                 def f(start, stop):
+                    if masked:
+                        return core_ops.io_parquet_readable_read_masked(
+                            input=self._filename,
+                            shared=self._filename,
+                            component=component,
+                            shape=shape,
+                            start=start,
+                            stop=stop,
+                            dtype=dtype,
+                            container="ParquetIODataset",
+                        )
                     return core_ops.io_parquet_readable_read(
                         input=self._filename,
                         shared=self._filename,
@@ -118,7 +133,14 @@ class ParquetIODataset(tf.data.Dataset):
             if isinstance(columns, dict) and all(
                 isinstance(val, tf.TensorSpec) for val in columns.values()
             ):
-                self._element_spec = collections.OrderedDict(columns)
+                self._element_spec = collections.OrderedDict(
+                    [
+                        (column, (spec, tf.TensorSpec(spec.shape, tf.bool)))
+                        if masked
+                        else (column, spec)
+                        for column, spec in columns.items()
+                    ]
+                )
             else:
                 self._element_spec = None
 
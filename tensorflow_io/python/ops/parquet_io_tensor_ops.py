@@ -79,6 +79,50 @@ class BaseParquetGraphIOTensor:
             container="ParquetIOTensor",
         )
 
+    def to_masked_tensor(self, start=0, stop=-1):
+        """Converts the rows [start, stop) of this `IOTensor` into a `tf.Tensor`
+        and a mask telling whether each row is not null.
+
+        Args:
+            start: The first row to read.
+            stop: The row to stop reading at, or -1 for all the rows.
+        Returns:
+            A tuple of a `Tensor`, with the default value for null rows, and
+            its `bool` mask.
+        """
+        return core_ops.io_parquet_readable_read_masked(
+            input=self._filename,
+            shared=self._filename,
+            component=self._component,
+            shape=self._shape,
+            start=start,
+            stop=stop,
+            dtype=self._dtype,
+            container="ParquetIOTensor",
+        )
+
+    def to_dictionary_tensor(self, start=0, stop=-1):
+        """Converts the rows [start, stop) of this string `IOTensor` into the
+        indices of their values in a dictionary, without materializing the
+        repeated strings.
+
+        Args:
+            start: The first row to read.
+            stop: The row to stop reading at, or -1 for all the rows.
+        Returns:
+            A tuple of the `int64` indices, -1 for null rows, the `string`
+            dictionary, and the `bool` mask of the rows that are not null.
+        """
+        return core_ops.io_parquet_readable_read_dictionary(
+            input=self._filename,
+            shared=self._filename,
+            component=self._component,
+            shape=self._shape,
+            start=start,
+            stop=stop,
+            container="ParquetIOTensor",
+        )
+
     # =============================================================================
     # Indexing and slicing
     # =============================================================================
@@ -40,18 +40,40 @@ class PcapIODataset(tf.data.Dataset):
             )
 
             dataset = tf.data.Dataset.range(0, sys.maxsize, capacity)
-            dataset = dataset.map(
-                lambda index: core_ops.io_pcap_readable_read(
-                    resource, start=index, stop=index + capacity
+            if kwargs.get("ragged", False):
+                # Batches of packets, with the data of each batch in one
+                # tensor instead of a string per packet.
+                dataset = dataset.map(
+                    lambda index: core_ops.io_pcap_readable_read_ragged(
+                        resource, start=index, stop=index + capacity
+                    )
                 )
-            )
-            dataset = dataset.apply(
-                tf.data.experimental.take_while(
-                    lambda v: tf.greater(tf.shape(v.value)[0], 0)
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(v.label)[0], 0)
+                    )
                 )
-            )
-            dataset = dataset.map(lambda v: (v.label, v.value))
-            dataset = dataset.unbatch()
+                dataset = dataset.map(
+                    lambda v: (
+                        v.label,
+                        tf.RaggedTensor.from_row_splits(
+                            v.value, v.row_splits, validate=False
+                        ),
+                    )
+                )
+            else:
+                dataset = dataset.map(
+                    lambda index: core_ops.io_pcap_readable_read(
+                        resource, start=index, stop=index + capacity
+                    )
+                )
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(v.value)[0], 0)
+                    )
+                )
+                dataset = dataset.map(lambda v: (v.label, v.value))
+                dataset = dataset.unbatch()
 
             self._capacity = capacity
             self._resource = resource
@@ -23,7 +23,14 @@ class PrometheusIODataset(tf.data.Dataset):
     """PrometheusIODataset"""
 
     def __init__(
-        self, query, length, offset=None, endpoint=None, spec=None, internal=True
+        self,
+        query,
+        length,
+        offset=None,
+        endpoint=None,
+        spec=None,
+        window=None,
+        internal=True,
     ):
         """PrometheusIODataset."""
         with tf.name_scope("PrometheusIODataset"):
@@ -84,7 +91,9 @@ class PrometheusIODataset(tf.data.Dataset):
                 value = tf.unstack(value, num=len(flatten))
                 return timestamp, tf.nest.pack_sequence_as(entries, value)
 
-            step = 1 * 1000  # 1 second
+            # All the series are read a window of seconds at a time, and the
+            # windows are queried concurrently.
+            step = (window or 3600) * 1000
 
             self._resource = resource
             start, stop = golang_ops.io_prometheus_readable_spec(resource)
@@ -93,7 +102,7 @@ class PrometheusIODataset(tf.data.Dataset):
                 tf.data.Dataset.from_tensor_slices([stop])
             )
             dataset = tf.data.Dataset.zip((indices_start, indices_stop))
-            dataset = dataset.map(f)
+            dataset = dataset.map(f, num_parallel_calls=tf.data.AUTOTUNE)
             dataset = dataset.unbatch()
             self._dataset = dataset
             super().__init__(
@@ -16,16 +16,26 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/variant.h"
 #include "google/cloud/storage/client.h"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
-#include "tensorflow_io_gcs_filesystem/core/expiring_lru_cache.h"
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
+#include "tensorflow_io/core/filesystems/filesystem_metrics.h"
+#include "tensorflow_io/core/filesystems/glob_match.h"
+#include "tensorflow_io/core/filesystems/ram_file_block_cache.h"
 #include "tensorflow_io_gcs_filesystem/core/file_system_plugin_gs.h"
 #include "tensorflow_io_gcs_filesystem/core/gcs_helper.h"
-#include "tensorflow_io_gcs_filesystem/core/ram_file_block_cache.h"
 
 namespace tensorflow {
 namespace io {
@@ -48,6 +58,10 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64_t kDefaultMaxStaleness = 0;
+// The environment variable that overrides the number of shards of the block
+// cache. Each shard has its own lock and an equal share of the cache size.
+constexpr char kCacheShards[] = "GCS_READ_CACHE_SHARDS";
+constexpr size_t kDefaultCacheShards = 1;
 
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
 constexpr uint64_t kStatCacheDefaultMaxAge = 5;
@@ -55,6 +69,29 @@ constexpr uint64_t kStatCacheDefaultMaxAge = 5;
 // Stat cache.
 constexpr char kStatCacheMaxEntries[] = "GCS_STAT_CACHE_MAX_ENTRIES";
 constexpr size_t kStatCacheDefaultMaxEntries = 1024;
+// The environment variable that overrides the maximum age (seconds) of the
+// Stat cache entries of paths found not to exist. 0 disables them. They are
+// dropped when this process creates the path or a file under it.
+constexpr char kStatCacheNegativeMaxAge[] = "GCS_STAT_CACHE_NEGATIVE_MAX_AGE";
+constexpr uint64_t kStatCacheDefaultNegativeMaxAge = 5;
+// The environment variable that overrides the number of shards of the Stat
+// cache. Each shard has its own lock and an equal share of the entries.
+constexpr char kStatCacheShards[] = "GCS_STAT_CACHE_SHARDS";
+constexpr size_t kStatCacheDefaultShards = 1;
+// The object metadata requested by listings, enough to fill the Stat cache.
+constexpr char kListFields[] =
+    "items(name,size,generation,timeStorageClassUpdated),prefixes";
+// The maximum number of requests GetMatchingPaths and RenameFile send
+// concurrently, listings and object renames respectively.
+constexpr size_t kMaxConcurrentRequests = 16;
+// The environment variables that override the size (MB) of the slices of a
+// sliced download, and how many of them are downloaded at once. Reads, and
+// block cache fills, of more than one slice are split into ranged reads on
+// connections of their own. A concurrency of 1 disables sliced downloads.
+constexpr char kReadSliceSize[] = "GCS_READ_SLICE_SIZE_MB";
+constexpr size_t kDefaultReadSliceSize = 32 * 1024 * 1024;
+constexpr char kReadSliceConcurrency[] = "GCS_READ_SLICE_CONCURRENCY";
+constexpr size_t kDefaultReadSliceConcurrency = 8;
 
 // How to upload new data when Flush() is called multiple times.
 // By default the entire file is reuploaded.
@@ -64,6 +101,12 @@ constexpr char kAppendMode[] = "GCS_APPEND_MODE";
 // default as the multiple API calls required add a risk of stranding temporary
 // objects.
 constexpr char kComposeAppend[] = "compose";
+// If GCS_APPEND_MODE=stream then writable files do not use a temporary file.
+// Data is sent through a resumable upload session as the upload buffer of the
+// client (8 MiB by default) fills, and the object is finalized on Close, so
+// Flush() never uploads data again. The object is not visible until Close.
+// Appendable files always use the modes above.
+constexpr char kStreamAppend[] = "stream";
 
 // We can cast `google::cloud::StatusCode` to `TF_Code` because they have the
 // same integer values. See
@@ -111,6 +154,19 @@ static void MaybeAppendSlash(std::string* name) {
   else if (name->back() != '/')
     name->push_back('/');
 }
+
+namespace {
+
+// The metrics of this plugin, kept apart from those of the tensorflow-io
+// filesystem plugins, which may be loaded into the same process.
+FilesystemMetrics* Metrics() {
+  static FilesystemMetrics* metrics = new FilesystemMetrics(
+      "gcs_filesystem", "the GCS filesystem plugin of tensorflow-io");
+  return metrics;
+}
+
+}  // namespace
+
 // SECTION 1. Implementation for `TF_RandomAccessFile`
 // ----------------------------------------------------------------------------
 namespace tf_random_access_file {
@@ -149,8 +205,10 @@ void Cleanup(TF_RandomAccessFile* file) {
 int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
              char* buffer, TF_Status* status) {
   auto gcs_file = static_cast<GCSRandomAccessFile*>(file->plugin_file);
+  FilesystemRequest request("gs", "read", status, Metrics());
   if (gcs_file->is_cache_enable || n > gcs_file->buffer_size) {
-    return gcs_file->read_fn(gcs_file->path, offset, n, buffer, status);
+    return request.Bytes(
+        gcs_file->read_fn(gcs_file->path, offset, n, buffer, status));
   } else {
     absl::MutexLock l(&gcs_file->buffer_mutex);
     size_t buffer_end = gcs_file->buffer_start + gcs_file->buffer.size();
@@ -188,10 +246,10 @@ int64_t Read(const TF_RandomAccessFile* file, uint64_t offset, size_t n,
       // same file.
       gcs_file->buffer_end_is_past_eof = false;
       TF_SetStatus(status, TF_OUT_OF_RANGE, "Read less bytes than requested");
-      return copy_size;
+      return request.Bytes(copy_size);
     }
     TF_SetStatus(status, TF_OK, "");
-    return copy_size;
+    return request.Bytes(copy_size);
   }
 }
 
@@ -208,7 +266,14 @@ typedef struct GCSWritableFile {
   bool sync_need;
   // `offset` tells us how many bytes of this file are already uploaded to
   // server. If `offset == -1`, we always upload the entire temporary file.
+  // For streaming files it is the number of bytes appended.
   int64_t offset;
+  // The resumable upload session of a streaming file, in which case `outfile`
+  // is not backed by any file.
+  std::unique_ptr<gcs::ObjectWriteStream> stream;
+  // Run after every upload of the file, e.g. to drop the cached stats of the
+  // path.
+  std::function<void()> on_upload;
 } GCSWritableFile;
 
 static void SyncImpl(const std::string& bucket, const std::string& object,
@@ -274,12 +339,41 @@ static void SyncImpl(const std::string& bucket, const std::string& object,
 
 void Cleanup(TF_WritableFile* file) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
+  if (gcs_file->stream && gcs_file->stream->IsOpen()) {
+    // Destroying an open stream finalizes the object. Like a temporary file
+    // that is never synced, a file that is not closed is not uploaded.
+    std::move(*gcs_file->stream).Suspend();
+  }
   delete gcs_file;
 }
 
+static void AppendStream(GCSWritableFile* gcs_file, const char* buffer,
+                         size_t n, TF_Status* status) {
+  if (!gcs_file->stream->IsOpen()) {
+    TF_SetStatus(status, TF_FAILED_PRECONDITION,
+                 "The upload session is closed.");
+    return;
+  }
+  // The stream uploads a chunk whenever its buffer fills.
+  gcs_file->stream->write(buffer, n);
+  if (gcs_file->stream->bad()) {
+    TF_SetStatusFromGCSStatus(gcs_file->stream->last_status(), status);
+    return;
+  }
+  gcs_file->offset += n;
+  TF_SetStatus(status, TF_OK, "");
+}
+
 void Append(const TF_WritableFile* file, const char* buffer, size_t n,
             TF_Status* status) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
+  FilesystemRequest request("gs", "write", status, Metrics());
+  request.Bytes(n);
+  if (gcs_file->stream) {
+    TF_VLog(3, "Append: gs://%s/%s size %u", gcs_file->bucket.c_str(),
+            gcs_file->object.c_str(), n);
+    return AppendStream(gcs_file, buffer, n, status);
+  }
   if (!gcs_file->outfile.is_open()) {
     TF_SetStatus(status, TF_FAILED_PRECONDITION,
                  "The internal temporary file is not writable.");
@@ -298,6 +392,10 @@ void Append(const TF_WritableFile* file, const char* buffer, size_t n,
 
 int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
+  if (gcs_file->stream) {
+    TF_SetStatus(status, TF_OK, "");
+    return gcs_file->offset;
+  }
   int64_t position = int64_t(gcs_file->outfile.tellp());
   if (position == -1)
     TF_SetStatus(status, TF_INTERNAL,
@@ -311,6 +409,17 @@ int64_t Tell(const TF_WritableFile* file, TF_Status* status) {
 
 void Flush(const TF_WritableFile* file, TF_Status* status) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
+  if (gcs_file->stream) {
+    // Only whole chunks can be sent before the upload is finalized, the rest
+    // stays buffered until Close.
+    if (gcs_file->stream->IsOpen()) gcs_file->stream->flush();
+    if (gcs_file->stream->bad()) {
+      TF_SetStatusFromGCSStatus(gcs_file->stream->last_status(), status);
+      return;
+    }
+    TF_SetStatus(status, TF_OK, "");
+    return;
+  }
   if (gcs_file->sync_need) {
     TF_VLog(3, "Flush started: gs://%s/%s", gcs_file->bucket.c_str(),
             gcs_file->object.c_str());
@@ -325,6 +434,7 @@ void Flush(const TF_WritableFile* file, TF_Status* status) {
             gcs_file->object.c_str());
     if (TF_GetCode(status) != TF_OK) return;
     gcs_file->sync_need = false;
+    if (gcs_file->on_upload) gcs_file->on_upload();
   } else {
     TF_SetStatus(status, TF_OK, "");
   }
@@ -334,6 +444,7 @@ void Sync(const TF_WritableFile* file, TF_Status* status) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
   TF_VLog(3, "Sync: gs://%s/%s", gcs_file->bucket.c_str(),
           gcs_file->object.c_str());
+  FilesystemRequest request("gs", "sync", status, Metrics());
   Flush(file, status);
 }
 
@@ -341,6 +452,15 @@ void Close(const TF_WritableFile* file, TF_Status* status) {
   auto gcs_file = static_cast<GCSWritableFile*>(file->plugin_file);
   TF_VLog(3, "Close: gs://%s/%s", gcs_file->bucket.c_str(),
           gcs_file->object.c_str());
+  FilesystemRequest request("gs", "sync", status, Metrics());
+  if (gcs_file->stream) {
+    if (gcs_file->stream->IsOpen()) gcs_file->stream->Close();
+    TF_SetStatusFromGCSStatus(gcs_file->stream->metadata().status(), status);
+    if (TF_GetCode(status) == TF_OK && gcs_file->on_upload) {
+      gcs_file->on_upload();
+    }
+    return;
+  }
   if (gcs_file->sync_need) {
     Flush(file, status);
   }
@@ -386,11 +506,14 @@ typedef struct GcsFileSystemStat {
 typedef struct GCSFileSystemImplementation {
   google::cloud::storage::Client gcs_client;  // owned
   bool compose;
+  bool stream;
   absl::Mutex block_cache_lock;
   std::shared_ptr<RamFileBlockCache> file_block_cache
       ABSL_GUARDED_BY(block_cache_lock);
   uint64_t block_size;  // Reads smaller than block_size will trigger a read
                         // of block_size.
+  size_t read_slice_size = kDefaultReadSliceSize;
+  size_t read_slice_concurrency = kDefaultReadSliceConcurrency;
   std::unique_ptr<ExpiringLRUCache<GcsFileSystemStat>> stat_cache;
   GCSFileSystemImplementation(google::cloud::storage::Client&& gcs_client);
   // This constructor is used for testing purpose only.
@@ -430,14 +553,28 @@ typedef struct GCSFileSystem {
   }
 } GCSFileSystem;
 
-// A helper function to actually read the data from GCS.
-static int64_t LoadBufferFromGCS(
-    const std::string& path, size_t offset, size_t buffer_size, char* buffer,
+// Runs `fn(i)` for every `i` in `[0, n)` on up to `max_threads` threads and
+// waits for all of them.
+static void ParallelFor(size_t n, size_t max_threads,
+                        const std::function<void(size_t)>& fn) {
+  if (n == 1) return fn(0);
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) fn(i);
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(n, max_threads); ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+}
+
+// Reads a range of an object with one ranged `ReadObject` stream.
+static int64_t LoadRangeFromGCS(
+    const std::string& path, const std::string& bucket,
+    const std::string& object, size_t offset, size_t buffer_size, char* buffer,
     tf_gcs_filesystem::GCSFileSystemImplementation* gcs_file,
     TF_Status* status) {
-  std::string bucket, object;
-  ParseGCSPath(path, false, &bucket, &object, status);
-  if (TF_GetCode(status) != TF_OK) return -1;
   auto stream = gcs_file->gcs_client.ReadObject(
       bucket, object, gcs::ReadRange(offset, offset + buffer_size));
   TF_SetStatusFromGCSStatus(stream.status(), status);
@@ -479,6 +616,56 @@ static int64_t LoadBufferFromGCS(
   return read;
 }
 
+// A helper function to actually read the data from GCS. Reads of more than
+// one slice are split into slices read concurrently, each into its own
+// section of `buffer`, so that they are not limited to the throughput of a
+// single connection.
+static int64_t LoadBufferFromGCS(
+    const std::string& path, size_t offset, size_t buffer_size, char* buffer,
+    tf_gcs_filesystem::GCSFileSystemImplementation* gcs_file,
+    TF_Status* status) {
+  std::string bucket, object;
+  ParseGCSPath(path, false, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  const size_t slice_size = gcs_file->read_slice_size;
+  if (gcs_file->read_slice_concurrency <= 1 || slice_size == 0 ||
+      buffer_size <= slice_size) {
+    return LoadRangeFromGCS(path, bucket, object, offset, buffer_size, buffer,
+                            gcs_file, status);
+  }
+  const size_t num_slices = (buffer_size + slice_size - 1) / slice_size;
+  std::vector<int64_t> reads(num_slices);
+  std::vector<std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)>> statuses;
+  for (size_t i = 0; i < num_slices; ++i) {
+    statuses.emplace_back(TF_NewStatus(), TF_DeleteStatus);
+  }
+  TF_VLog(1, "Sliced read of %s @ %u of size: %u in %u slices", path.c_str(),
+          offset, buffer_size, num_slices);
+  auto slice_length = [&](size_t i) {
+    return std::min(slice_size, buffer_size - i * slice_size);
+  };
+  ParallelFor(num_slices, gcs_file->read_slice_concurrency, [&](size_t i) {
+    const size_t start = i * slice_size;
+    reads[i] = LoadRangeFromGCS(path, bucket, object, offset + start,
+                                slice_length(i), buffer + start, gcs_file,
+                                statuses[i].get());
+  });
+  // The bytes read are those up to the first short or failed slice, the
+  // slices after a short one are past the end of the object.
+  int64_t read = 0;
+  for (size_t i = 0; i < num_slices; ++i) {
+    if (TF_GetCode(statuses[i].get()) != TF_OK) {
+      TF_SetStatus(status, TF_GetCode(statuses[i].get()),
+                   TF_Message(statuses[i].get()));
+      return -1;
+    }
+    read += reads[i];
+    if (static_cast<size_t>(reads[i]) < slice_length(i)) break;
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return read;
+}
+
 // TODO(vnvo2409): Use partial reponse for better performance.
 // TODO(vnvo2409): We could do some cleanups like `return TF_SetStatus`.
 // TODO(vnvo2409): Refactor the filesystem implementation when
@@ -488,14 +675,16 @@ GCSFileSystemImplementation::GCSFileSystemImplementation(
     : gcs_client(gcs_client), block_cache_lock() {
   const char* append_mode = std::getenv(kAppendMode);
   compose = (append_mode != nullptr) && (!strcmp(kComposeAppend, append_mode));
+  stream = (append_mode != nullptr) && (!strcmp(kStreamAppend, append_mode));
 
   uint64_t value;
   block_size = kDefaultBlockSize;
   size_t max_bytes = kDefaultMaxCacheSize;
   uint64_t max_staleness = kDefaultMaxStaleness;
+  size_t cache_shards = kDefaultCacheShards;
 
-  // Apply the overrides for the block size (MB), max bytes (MB), and max
-  // staleness (seconds) if provided.
+  // Apply the overrides for the block size (MB), max bytes (MB), max
+  // staleness (seconds) and shards if provided.
   if (absl::SimpleAtoi(std::getenv(kBlockSize), &value)) {
     block_size = value * 1024 * 1024;
   }
@@ -505,8 +694,19 @@ GCSFileSystemImplementation::GCSFileSystemImplementation(
   if (absl::SimpleAtoi(std::getenv(kMaxStaleness), &value)) {
     max_staleness = value;
   }
-  TF_VLog(1, "GCS cache max size = %u ; block size = %u ; max staleness = %u",
-          max_bytes, block_size, max_staleness);
+  if (absl::SimpleAtoi(std::getenv(kCacheShards), &value)) {
+    cache_shards = static_cast<size_t>(value);
+  }
+  if (absl::SimpleAtoi(std::getenv(kReadSliceSize), &value)) {
+    read_slice_size = static_cast<size_t>(value * 1024 * 1024);
+  }
+  if (absl::SimpleAtoi(std::getenv(kReadSliceConcurrency), &value)) {
+    read_slice_concurrency = static_cast<size_t>(value);
+  }
+  TF_VLog(1,
+          "GCS cache max size = %u ; block size = %u ; max staleness = %u ; "
+          "shards = %u",
+          max_bytes, block_size, max_staleness, cache_shards);
 
   file_block_cache = std::make_unique<RamFileBlockCache>(
       block_size, max_bytes, max_staleness,
@@ -514,18 +714,38 @@ GCSFileSystemImplementation::GCSFileSystemImplementation(
              char* buffer, TF_Status* status) {
         return LoadBufferFromGCS(filename, offset, buffer_size, buffer, this,
                                  status);
-      });
+      },
+      TF_NowSeconds, /*prefetch_blocks=*/0, /*prefetch_threads=*/1,
+      cache_shards);
 
   uint64_t stat_cache_max_age = kStatCacheDefaultMaxAge;
   size_t stat_cache_max_entries = kStatCacheDefaultMaxEntries;
+  uint64_t stat_cache_negative_max_age = kStatCacheDefaultNegativeMaxAge;
+  size_t stat_cache_shards = kStatCacheDefaultShards;
   if (absl::SimpleAtoi(std::getenv(kStatCacheMaxAge), &value)) {
     stat_cache_max_age = value;
   }
   if (absl::SimpleAtoi(std::getenv(kStatCacheMaxEntries), &value)) {
     stat_cache_max_entries = static_cast<size_t>(value);
   }
+  if (absl::SimpleAtoi(std::getenv(kStatCacheNegativeMaxAge), &value)) {
+    stat_cache_negative_max_age = value;
+  }
+  if (absl::SimpleAtoi(std::getenv(kStatCacheShards), &value)) {
+    stat_cache_shards = static_cast<size_t>(value);
+  }
   stat_cache = std::make_unique<ExpiringLRUCache<GcsFileSystemStat>>(
-      stat_cache_max_age, stat_cache_max_entries);
+      stat_cache_max_age, stat_cache_max_entries, TF_NowSeconds,
+      stat_cache_negative_max_age, stat_cache_shards);
+  TF_VLog(1,
+          "GCS stat cache max age = %u ; max entries = %u ; negative max age "
+          "= %u ; shards = %u",
+          stat_cache_max_age, stat_cache_max_entries,
+          stat_cache->negative_max_age(), stat_cache->num_shards());
+  file_block_cache->SetLookupObserver(
+      [](bool hit) { Metrics()->RecordCacheLookup("gs", "block", hit); });
+  stat_cache->SetLookupObserver(
+      [](bool hit) { Metrics()->RecordCacheLookup("gs", "stat", hit); });
 }
 
 GCSFileSystemImplementation::GCSFileSystemImplementation(
@@ -534,6 +754,7 @@ GCSFileSystemImplementation::GCSFileSystemImplementation(
     uint64_t stat_cache_max_age, size_t stat_cache_max_entries)
     : gcs_client(gcs_client),
       compose(compose),
+      stream(false),
       block_cache_lock(),
       block_size(block_size) {
   file_block_cache = std::make_unique<RamFileBlockCache>(
@@ -545,6 +766,10 @@ GCSFileSystemImplementation::GCSFileSystemImplementation(
       });
   stat_cache = std::make_unique<ExpiringLRUCache<GcsFileSystemStat>>(
       stat_cache_max_age, stat_cache_max_entries);
+  file_block_cache->SetLookupObserver(
+      [](bool hit) { Metrics()->RecordCacheLookup("gs", "block", hit); });
+  stat_cache->SetLookupObserver(
+      [](bool hit) { Metrics()->RecordCacheLookup("gs", "stat", hit); });
 }
 
 void Init(TF_Filesystem* filesystem, TF_Status* status) {
@@ -576,6 +801,45 @@ static void UncachedStatForObject(const std::string& bucket,
   return TF_SetStatus(status, TF_OK, "");
 }
 
+// Drops the negative Stat cache entries that the creation of `path` makes
+// stale: those of the path itself, as an object or a directory, and of the
+// directories above it.
+static void ClearNegativeStats(GCSFileSystemImplementation* gcs_file,
+                               const std::string& path) {
+  std::string bucket, object;
+  TF_Status* status = TF_NewStatus();
+  ParseGCSPath(path, true, &bucket, &object, status);
+  const bool parsed = TF_GetCode(status) == TF_OK;
+  TF_DeleteStatus(status);
+  if (!parsed) return;
+  const std::string root = absl::StrCat("gs://", bucket, "/");
+  gcs_file->stat_cache->DeleteNegative(path);
+  for (size_t pos = object.find('/'); pos != std::string::npos;
+       pos = object.find('/', pos + 1)) {
+    gcs_file->stat_cache->DeleteNegative(root + object.substr(0, pos + 1));
+  }
+  if (!object.empty() && object.back() != '/') {
+    gcs_file->stat_cache->DeleteNegative(root + object + "/");
+  }
+}
+
+static void ClearFileCaches(GCSFileSystemImplementation* gcs_file,
+                            const std::string& path) {
+  absl::ReaderMutexLock l(&gcs_file->block_cache_lock);
+  gcs_file->file_block_cache->RemoveFile(path);
+  gcs_file->stat_cache->Delete(path);
+  ClearNegativeStats(gcs_file, path);
+}
+
+// Makes the uploads of a writable file drop the cached stats of its path.
+static void ClearCachesOnUpload(GCSFileSystemImplementation* gcs_file,
+                                const char* path, TF_WritableFile* file) {
+  static_cast<tf_writable_file::GCSWritableFile*>(file->plugin_file)
+      ->on_upload = [gcs_file, path = std::string(path)]() {
+    ClearFileCaches(gcs_file, path);
+  };
+}
+
 // TODO(vnvo2409): Implement later
 void NewRandomAccessFile(const TF_Filesystem* filesystem, const char* path,
                          TF_RandomAccessFile* file, TF_Status* status) {
@@ -644,11 +908,27 @@ void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
+  if (gcs_file->stream) {
+    auto stream = std::make_unique<gcs::ObjectWriteStream>(
+        gcs_file->gcs_client.WriteObject(bucket, object));
+    if (!stream->IsOpen()) {
+      TF_SetStatusFromGCSStatus(stream->metadata().status(), status);
+      return;
+    }
+    file->plugin_file = new tf_writable_file::GCSWritableFile(
+        {std::move(bucket), std::move(object), &gcs_file->gcs_client,
+         TempFile(), false, 0, std::move(stream)});
+    ClearCachesOnUpload(gcs_file, path, file);
+    TF_VLog(3, "GcsWritableFile: %s with a resumable upload session", path);
+    TF_SetStatus(status, TF_OK, "");
+    return;
+  }
   std::string temp_file_name = GCSGetTempFileName("");
   file->plugin_file = new tf_writable_file::GCSWritableFile(
       {std::move(bucket), std::move(object), &gcs_file->gcs_client,
        TempFile(temp_file_name, std::ios::binary | std::ios::out), true,
        (gcs_file->compose ? 0 : -1)});
+  ClearCachesOnUpload(gcs_file, path, file);
   TF_VLog(3, "GcsWritableFile: %s", path);
   TF_SetStatus(status, TF_OK, "");
 }
@@ -698,6 +978,7 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
       return;
     }
   }
+  ClearCachesOnUpload(gcs_file, path, file);
   TF_VLog(3, "GcsWritableFile: %s with existing file %s", path,
           temp_file_name.c_str());
   TF_SetStatus(status, TF_OK, "");
@@ -761,7 +1042,7 @@ static void StatForObject(GCSFileSystemImplementation* gcs_file,
         UncachedStatForObject(bucket, object, stat, &gcs_file->gcs_client,
                               status);
       },
-      status);
+      status, TF_NOT_FOUND);
 }
 
 static bool ObjectExists(GCSFileSystemImplementation* gcs_file,
@@ -792,6 +1073,34 @@ static bool BucketExists(GCSFileSystemImplementation* gcs_file,
   return true;
 }
 
+// Inserts the stat of an object returned by a listing into the Stat cache,
+// so that a Stat of a listed file does not fetch its metadata again.
+static void CacheListedObject(GCSFileSystemImplementation* gcs_file,
+                              const std::string& bucket,
+                              const gcs::ObjectMetadata& metadata) {
+  GcsFileSystemStat stat;
+  stat.generation_number = metadata.generation();
+  stat.base.length = metadata.size();
+  stat.base.mtime_nsec =
+      metadata.time_storage_class_updated().time_since_epoch().count();
+  stat.base.is_directory =
+      !metadata.name().empty() && metadata.name().back() == '/';
+  gcs_file->stat_cache->Insert(
+      absl::StrCat("gs://", bucket, "/", metadata.name()), stat);
+}
+
+// Inserts a directory returned as a prefix by a listing into the Stat cache,
+// with the key used by FolderExists.
+static void CacheListedPrefix(GCSFileSystemImplementation* gcs_file,
+                              const std::string& bucket,
+                              const std::string& prefix) {
+  GcsFileSystemStat stat;
+  stat.base = {0, 0, true};
+  stat.generation_number = 0;
+  gcs_file->stat_cache->Insert(absl::StrCat("gs://", bucket, "/", prefix),
+                               stat);
+}
+
 static std::vector<std::string> GetChildrenBounded(
     GCSFileSystemImplementation* gcs_file, std::string dir,
     uint64_t max_results, bool recursive, bool include_self_directory_marker,
@@ -806,7 +1115,7 @@ static std::vector<std::string> GetChildrenBounded(
 
   for (auto&& item : gcs_file->gcs_client.ListObjectsAndPrefixes(
            bucket, gcs::Prefix(prefix), gcs::Delimiter(delimiter),
-           gcs::Fields("items(name),prefixes"))) {
+           gcs::Fields(kListFields))) {
     if (count == max_results) {
       TF_SetStatus(status, TF_OK, "");
       return result;
@@ -816,9 +1125,15 @@ static std::vector<std::string> GetChildrenBounded(
       return result;
     }
     auto value = *std::move(item);
-    std::string children = absl::holds_alternative<std::string>(value)
-                               ? absl::get<std::string>(value)
-                               : absl::get<gcs::ObjectMetadata>(value).name();
+    std::string children;
+    if (absl::holds_alternative<std::string>(value)) {
+      children = absl::get<std::string>(value);
+      CacheListedPrefix(gcs_file, bucket, children);
+    } else {
+      const auto& metadata = absl::get<gcs::ObjectMetadata>(value);
+      CacheListedObject(gcs_file, bucket, metadata);
+      children = metadata.name();
+    }
     auto pos = children.find(prefix);
     if (pos != 0) {
       TF_SetStatus(status, TF_INTERNAL,
@@ -854,7 +1169,8 @@ static bool FolderExists(GCSFileSystemImplementation* gcs_file, std::string dir,
       };
   GcsFileSystemStat stat;
   MaybeAppendSlash(&dir);
-  gcs_file->stat_cache->LookupOrCompute(dir, &stat, compute_func, status);
+  gcs_file->stat_cache->LookupOrCompute(dir, &stat, compute_func, status,
+                                        TF_INVALID_ARGUMENT);
   if (TF_GetCode(status) != TF_OK && TF_GetCode(status) != TF_INVALID_ARGUMENT)
     return false;
   if (TF_GetCode(status) == TF_INVALID_ARGUMENT) {
@@ -864,13 +1180,6 @@ static bool FolderExists(GCSFileSystemImplementation* gcs_file, std::string dir,
   return true;
 }
 
-static void ClearFileCaches(GCSFileSystemImplementation* gcs_file,
-                            const std::string& path) {
-  absl::ReaderMutexLock l(&gcs_file->block_cache_lock);
-  gcs_file->file_block_cache->RemoveFile(path);
-  gcs_file->stat_cache->Delete(path);
-}
-
 void PathExists(const TF_Filesystem* filesystem, const char* path,
                 TF_Status* status) {
   std::string bucket, object;
@@ -938,6 +1247,7 @@ void CreateDir(const TF_Filesystem* filesystem, const char* path,
       // will be returned if the object already exists, so avoid reuploading.
       gcs::IfGenerationMatch(0), gcs::Fields(""));
   TF_SetStatusFromGCSStatus(metadata.status(), status);
+  if (TF_GetCode(status) == TF_OK) ClearNegativeStats(gcs_file, dir);
   if (TF_GetCode(status) == TF_FAILED_PRECONDITION)
     TF_SetStatus(status, TF_ALREADY_EXISTS, path);
 }
@@ -1009,6 +1319,7 @@ void CopyFile(const TF_Filesystem* filesystem, const char* src, const char* dst,
       bucket_src, object_src, bucket_dst, object_dst,
       gcs::Fields("done,rewriteToken"));
   TF_SetStatusFromGCSStatus(metadata.status(), status);
+  if (TF_GetCode(status) == TF_OK) ClearFileCaches(gcs_file, dst);
 }
 
 bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
@@ -1102,11 +1413,21 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
   std::string dst_dir = dst;
   MaybeAppendSlash(&src_dir);
   MaybeAppendSlash(&dst_dir);
-  for (const std::string& children : childrens) {
-    RenameObject(filesystem, src_dir + children, dst_dir + children, status);
-    if (TF_GetCode(status) != TF_OK) return;
-  }
+  // Objects are renamed concurrently, rewrites within a bucket usually do not
+  // copy any data so the time is spent in round trips.
+  std::vector<TF_Status*> statuses(childrens.size());
+  for (auto& rename_status : statuses) rename_status = TF_NewStatus();
+  ParallelFor(childrens.size(), kMaxConcurrentRequests, [&](size_t i) {
+    RenameObject(filesystem, src_dir + childrens[i], dst_dir + childrens[i],
+                 statuses[i]);
+  });
   TF_SetStatus(status, TF_OK, "");
+  for (auto rename_status : statuses) {
+    if (TF_GetCode(status) == TF_OK && TF_GetCode(rename_status) != TF_OK)
+      TF_SetStatus(status, TF_GetCode(rename_status),
+                   TF_Message(rename_status));
+    TF_DeleteStatus(rename_status);
+  }
 }
 
 void DeleteRecursively(const TF_Filesystem* filesystem, const char* path,
@@ -1148,6 +1469,7 @@ void DeleteRecursively(const TF_Filesystem* filesystem, const char* path,
 
 int GetChildren(const TF_Filesystem* filesystem, const char* path,
                 char*** entries, TF_Status* status) {
+  FilesystemRequest request("gs", "list", status, Metrics());
   auto gcs_file =
       static_cast<GCSFileSystem*>(filesystem->plugin_filesystem)->Load(status);
   if (TF_GetCode(status) != TF_OK) {
@@ -1166,8 +1488,136 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
   return num_entries;
 }
 
+// Lists the objects and the directories directly under `prefix`, filling
+// the Stat cache with them.
+static void ListPrefix(GCSFileSystemImplementation* gcs_file,
+                       const std::string& bucket, const std::string& prefix,
+                       std::vector<std::string>* objects,
+                       std::vector<std::string>* prefixes, TF_Status* status) {
+  for (auto&& item : gcs_file->gcs_client.ListObjectsAndPrefixes(
+           bucket, gcs::Prefix(prefix), gcs::Delimiter("/"),
+           gcs::Fields(kListFields))) {
+    if (!item) return TF_SetStatusFromGCSStatus(item.status(), status);
+    auto value = *std::move(item);
+    if (absl::holds_alternative<std::string>(value)) {
+      CacheListedPrefix(gcs_file, bucket, absl::get<std::string>(value));
+      prefixes->push_back(std::move(absl::get<std::string>(value)));
+    } else {
+      const auto& metadata = absl::get<gcs::ObjectMetadata>(value);
+      CacheListedObject(gcs_file, bucket, metadata);
+      objects->push_back(metadata.name());
+    }
+  }
+  TF_SetStatus(status, TF_OK, "");
+}
+
+// The glob is expanded one component at a time. Every directory that
+// matches the components so far is listed concurrently, only with the
+// literal prefix of the next component, and only up to the next `/`.
+int GetMatchingPaths(const TF_Filesystem* filesystem, const char* glob,
+                     char*** entries, TF_Status* status) {
+  TF_VLog(1, "GetMatchingPaths for glob: %s\n", glob);
+  FilesystemRequest request("gs", "list", status, Metrics());
+  std::string bucket, object;
+  ParseGCSPath(glob, true, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+  if (bucket.find_first_of(kGlobChars) != std::string::npos) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT,
+                 absl::StrCat("Wildcards in the bucket of ", glob,
+                              " are not supported")
+                     .c_str());
+    return -1;
+  }
+  auto gcs_file =
+      static_cast<GCSFileSystem*>(filesystem->plugin_filesystem)->Load(status);
+  if (TF_GetCode(status) != TF_OK) return -1;
+
+  std::vector<std::string> result;
+  if (object.find_first_of(kGlobChars) == std::string::npos) {
+    // Not a glob, the path only matches itself.
+    PathExists(filesystem, glob, status);
+    if (TF_GetCode(status) == TF_OK)
+      result.push_back(glob);
+    else if (TF_GetCode(status) != TF_NOT_FOUND)
+      return -1;
+  } else {
+    while (!object.empty() && object.back() == '/') object.pop_back();
+    std::vector<std::string> components;
+    for (size_t start = 0;;) {
+      size_t end = object.find('/', start);
+      components.push_back(object.substr(start, end - start));
+      if (end == std::string::npos) break;
+      start = end + 1;
+    }
+
+    std::vector<std::string> dirs = {""};
+    for (size_t i = 0; i < components.size() && !dirs.empty(); ++i) {
+      const auto& component = components[i];
+      bool last = i + 1 == components.size();
+      size_t wildcard = component.find_first_of(kGlobChars);
+      if (wildcard == std::string::npos && !last) {
+        // A literal directory is not listed on its own. GCS only has object
+        // names, so a directory that no object is under yields an empty
+        // listing of the next prefix.
+        for (auto& dir : dirs) dir += component + "/";
+        continue;
+      }
+
+      size_t num_dirs = dirs.size();
+      std::vector<std::vector<std::string>> objects(num_dirs);
+      std::vector<std::vector<std::string>> prefixes(num_dirs);
+      std::vector<TF_Status*> statuses(num_dirs);
+      for (auto& list_status : statuses) list_status = TF_NewStatus();
+      ParallelFor(num_dirs, kMaxConcurrentRequests, [&](size_t j) {
+        ListPrefix(gcs_file, bucket, dirs[j] + component.substr(0, wildcard),
+                   &objects[j], &prefixes[j], statuses[j]);
+      });
+      TF_SetStatus(status, TF_OK, "");
+      for (auto list_status : statuses) {
+        if (TF_GetCode(status) == TF_OK && TF_GetCode(list_status) != TF_OK)
+          TF_SetStatus(status, TF_GetCode(list_status),
+                       TF_Message(list_status));
+        TF_DeleteStatus(list_status);
+      }
+      if (TF_GetCode(status) != TF_OK) return -1;
+
+      std::vector<std::string> next_dirs;
+      for (size_t j = 0; j < num_dirs; ++j) {
+        size_t length = dirs[j].length();
+        for (const auto& prefix : prefixes[j]) {
+          std::string name =
+              prefix.substr(length, prefix.length() - length - 1);
+          if (!MatchGlobComponent(component, name)) continue;
+          if (last)
+            result.push_back("gs://" + bucket + "/" + dirs[j] + name);
+          else
+            next_dirs.push_back(prefix);
+        }
+        if (!last) continue;
+        for (const auto& name : objects[j]) {
+          std::string child = name.substr(length);
+          if (!child.empty() && MatchGlobComponent(component, child))
+            result.push_back("gs://" + bucket + "/" + name);
+        }
+      }
+      dirs = std::move(next_dirs);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+  }
+
+  int num_entries = result.size();
+  *entries = static_cast<char**>(
+      plugin_memory_allocate(num_entries * sizeof((*entries)[0])));
+  for (int i = 0; i < num_entries; i++)
+    (*entries)[i] = strdup(result[i].c_str());
+  TF_SetStatus(status, TF_OK, "");
+  return num_entries;
+}
+
 void Stat(const TF_Filesystem* filesystem, const char* path,
           TF_FileStatistics* stats, TF_Status* status) {
+  FilesystemRequest request("gs", "stat", status, Metrics());
   std::string bucket, object;
   ParseGCSPath(path, true, &bucket, &object, status);
   if (TF_GetCode(status) != TF_OK) return;
@@ -1314,6 +1764,8 @@ void ProvideFilesystemSupportFor(TF_FilesystemPluginOps* ops, const char* uri) {
   ops->filesystem_ops->is_directory = tf_gcs_filesystem::IsDirectory;
   ops->filesystem_ops->stat = tf_gcs_filesystem::Stat;
   ops->filesystem_ops->get_children = tf_gcs_filesystem::GetChildren;
+  ops->filesystem_ops->get_matching_paths =
+      tf_gcs_filesystem::GetMatchingPaths;
   ops->filesystem_ops->translate_name = tf_gcs_filesystem::TranslateName;
   ops->filesystem_ops->flush_caches = tf_gcs_filesystem::FlushCaches;
   ops->filesystem_ops->set_filesystem_configuration =
@@ -26,12 +26,14 @@ limitations under the License.
 TempFile::TempFile(const std::string& temp_file_name, std::ios::openmode mode)
     : std::fstream(temp_file_name, mode), name_(temp_file_name) {}
 
+TempFile::TempFile() : std::fstream(), name_() {}
+
 TempFile::TempFile(TempFile&& rhs)
     : std::fstream(std::move(rhs)), name_(std::move(rhs.name_)) {}
 
 TempFile::~TempFile() {
   std::fstream::close();
-  std::remove(name_.c_str());
+  if (!name_.empty()) std::remove(name_.c_str());
 }
 
 const std::string TempFile::getName() const { return name_; }
@@ -22,6 +22,8 @@ class TempFile : public std::fstream {
  public:
   // We should specify openmode each time we call TempFile.
   TempFile(const std::string& temp_file_name, std::ios::openmode mode);
+  // A TempFile that is not backed by any file.
+  TempFile();
   TempFile(TempFile&& rhs);
   ~TempFile() override;
   const std::string getName() const;
@@ -15,7 +15,11 @@
 """Tests for read_archive."""
 
 
+import io
 import os
+import tarfile
+import numpy as np
+import pytest
 import tensorflow as tf
 import tensorflow_io.python.ops.archive_ops as archive_io
 
@@ -103,6 +107,34 @@ def test_tar_gz():
     assert elements[1].numpy() == tf.io.read_file(expected_filename).numpy()
 
 
+@pytest.mark.parametrize("compressed", [False, True])
+def test_tar_index(tmp_path, compressed):
+    """test_tar_index"""
+    rng = np.random.default_rng(0)
+    members = {}
+    for i in range(20):
+        name = "images/" + "shard_" * (i % 30) + f"{i}.bin"
+        members[name] = rng.integers(0, 256, size=i * 50000, dtype=np.uint8)
+    filename = str(tmp_path / ("data.tar.gz" if compressed else "data.tar"))
+    with tarfile.open(filename, "w:gz" if compressed else "w") as f:
+        for name, data in members.items():
+            info = tarfile.TarInfo(name)
+            info.size = data.size
+            f.addfile(info, io.BytesIO(data.tobytes()))
+
+    (
+        format,  # pylint: disable=redefined-builtin
+        entries,
+    ) = archive_io.list_archive_entries(filename, ["tar", "tar.gz"], seek_index=True)
+    assert format.numpy().decode() == ("tar.gz" if compressed else "tar")
+    assert [e.decode() for e in entries.numpy()] == list(members)
+
+    names = list(members)[::-1]
+    elements = archive_io.read_archive(filename, format, names, seek_index=True)
+    for name, element in zip(names, elements.numpy()):
+        assert element == members[name].tobytes()
+
+
 def test_dataset():
     """test_dataset"""
     filename = os.path.join(
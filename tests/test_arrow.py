@@ -563,6 +563,17 @@ class ArrowDatasetTest(ArrowTestBase):
         dataset = arrow_io.ArrowFeatherDataset.from_schema(f.name, batch.schema)
         self.run_test_case(dataset, truth_data)
 
+        # test memory mapped files, with and without 'file://' prefix
+        for filename in [f.name, f"file://{f.name}"]:
+            dataset = arrow_io.ArrowFeatherDataset(
+                filename,
+                list(range(len(truth_data.output_types))),
+                truth_data.output_types,
+                truth_data.output_shapes,
+                memory_map=True,
+            )
+            self.run_test_case(dataset, truth_data)
+
         os.unlink(f.name)
 
     def test_arrow_socket_dataset(self):
@@ -728,6 +739,44 @@ class ArrowDatasetTest(ArrowTestBase):
         for s in servers:
             s.join()
 
+    def test_arrow_flight_dataset(self):
+        """test_arrow_flight_dataset"""
+        import tensorflow_io.arrow as arrow_io
+
+        flight = pytest.importorskip("pyarrow.flight")
+
+        truth_data = TruthData(self.scalar_data, self.scalar_dtypes, self.scalar_shapes)
+        batch = self.make_record_batch(truth_data)
+        num_endpoints = 4
+
+        class Server(flight.FlightServerBase):
+            def get_flight_info(self, context, descriptor):
+                endpoints = [
+                    flight.FlightEndpoint(str(i), []) for i in range(num_endpoints)
+                ]
+                return flight.FlightInfo(batch.schema, descriptor, endpoints, -1, -1)
+
+            def do_get(self, context, ticket):
+                return flight.RecordBatchStream(pa.Table.from_batches([batch]))
+
+        with Server("grpc://127.0.0.1:0") as server:
+            location = "grpc://127.0.0.1:{}".format(server.port)
+            for num_parallel_endpoints, num_shards in [(1, 1), (3, 1), (2, 2)]:
+                dataset = arrow_io.ArrowFlightDataset.from_schema(
+                    location,
+                    "batches",
+                    batch.schema,
+                    batch_mode="auto",
+                    num_parallel_endpoints=num_parallel_endpoints,
+                    num_shards=num_shards,
+                    shard_index=num_shards - 1,
+                )
+                results = list(dataset)
+                self.assertEqual(len(results), num_endpoints // num_shards)
+                for result in results:
+                    for i, value in enumerate(result):
+                        npt.assert_almost_equal(value.numpy(), truth_data.data[i])
+
     def test_stream_from_pandas(self):
         """test_stream_from_pandas"""
         import tensorflow_io.arrow as arrow_io
@@ -756,6 +805,48 @@ class ArrowDatasetTest(ArrowTestBase):
         )
         self.run_test_case(dataset, truth_data, batch_size=batch_size)
 
+    @pytest.mark.skipif(os.name == "nt", reason="Unix only")
+    def test_stream_shared_memory(self):
+        """Test streaming record batches through a shared memory ring"""
+        import tensorflow_io.arrow as arrow_io
+
+        truth_data = TruthData(
+            self.scalar_data + self.list_fixed_data,
+            self.scalar_dtypes + self.list_fixed_dtypes,
+            self.scalar_shapes + self.list_fixed_shapes,
+        )
+        batch = self.make_record_batch(truth_data)
+
+        # A ring smaller than the stream, so that writes wrap around and wait
+        writer = arrow_io.ArrowShmStreamWriter(
+            "arrow_io_test_{}".format(os.getpid()), capacity=1024
+        )
+
+        def write_batches():
+            with pa.RecordBatchStreamWriter(writer, batch.schema) as stream:
+                for _ in range(4):
+                    stream.write_batch(batch)
+            writer.close()
+
+        thread = threading.Thread(target=write_batches)
+        thread.start()
+        try:
+            dataset = arrow_io.ArrowStreamDataset(
+                writer.endpoint,
+                list(range(batch.num_columns)),
+                truth_data.output_types,
+                truth_data.output_shapes,
+            )
+            truth_data = TruthData(
+                [d * 4 for d in truth_data.data],
+                truth_data.output_types,
+                truth_data.output_shapes,
+            )
+            self.run_test_case(dataset, truth_data)
+        finally:
+            thread.join()
+            writer.unlink()
+
     def test_stream_from_pandas_remainder(self):
         """Test stream from Pandas that produces partial batch"""
         import tensorflow_io.arrow as arrow_io
@@ -1017,6 +1108,187 @@ class ArrowDatasetTest(ArrowTestBase):
 
         self.run_test_case(dataset, truth_data, batch_size=batch.num_rows)
 
+    def test_batch_mode_auto_outlives_dataset(self):
+        """Test auto batch_mode tensors stay valid after the dataset is gone"""
+        import tensorflow_io.arrow as arrow_io
+
+        truth_data = TruthData(self.scalar_data, self.scalar_dtypes, self.scalar_shapes)
+        batch = self.make_record_batch(truth_data)
+
+        buf = io.BytesIO()
+        writer = pa.RecordBatchFileWriter(buf, batch.schema)
+        writer.write_batch(batch)
+        writer.close()
+
+        dataset = arrow_io.ArrowDataset(
+            tf.convert_to_tensor(buf.getvalue(), dtype=tf.dtypes.string),
+            tuple(range(batch.num_columns)),
+            truth_data.output_types,
+            truth_data.output_shapes,
+            batch_mode="auto",
+        )
+        results = list(dataset)
+        del dataset
+
+        self.assertEqual(len(results), 1)
+        for i, result in enumerate(results[0]):
+            npt.assert_almost_equal(result.numpy(), truth_data.data[i])
+
+    def test_parallel_columns(self):
+        """Test converting the columns of a batch in parallel"""
+        import tensorflow_io.arrow as arrow_io
+
+        truth_data = TruthData(
+            self.scalar_data + self.list_data,
+            self.scalar_dtypes + self.list_dtypes,
+            self.scalar_shapes + self.list_shapes,
+        )
+        batch = self.make_record_batch(truth_data)
+
+        buf = io.BytesIO()
+        writer = pa.RecordBatchFileWriter(buf, batch.schema)
+        writer.write_batch(batch)
+        writer.write_batch(batch)
+        writer.close()
+
+        def make_dataset(batch_size, batch_mode, **kwargs):
+            return arrow_io.ArrowDataset(
+                tf.convert_to_tensor(buf.getvalue(), dtype=tf.dtypes.string),
+                tuple(range(batch.num_columns)),
+                truth_data.output_types,
+                truth_data.output_shapes,
+                batch_size=batch_size,
+                batch_mode=batch_mode,
+                **kwargs,
+            )
+
+        for batch_size, batch_mode in [(None, "auto"), (3, "keep_remainder")]:
+            expected = list(make_dataset(batch_size, batch_mode))
+            for min_bytes in [0, 1, 2**40]:
+                results = list(
+                    make_dataset(
+                        batch_size,
+                        batch_mode,
+                        parallel_columns=2,
+                        parallel_columns_min_bytes=min_bytes,
+                    )
+                )
+                self.assertEqual(len(results), len(expected))
+                for result, expected_result in zip(results, expected):
+                    for value, expected_value in zip(result, expected_result):
+                        npt.assert_equal(value.numpy(), expected_value.numpy())
+
+    def test_ragged_and_dictionary_columns(self):
+        """Test variable-length list and dictionary-encoded string columns"""
+        import tensorflow_io.arrow as arrow_io
+
+        lists = [[1, 2], [], [3], [4, 5, 6], [7]]
+        words = ["a", "b", "a", "c", "b"]
+        schema = pa.schema(
+            [
+                ("lists", pa.list_(pa.int32())),
+                ("words", pa.dictionary(pa.int32(), pa.string())),
+                ("ids", pa.int64()),
+            ]
+        )
+        dictionary = pa.array(["a", "b", "c"])
+        batches = []
+        for start, end in [(0, 3), (3, 5)]:
+            indices = pa.array(
+                [["a", "b", "c"].index(w) for w in words[start:end]], pa.int32()
+            )
+            batches.append(
+                pa.RecordBatch.from_arrays(
+                    [
+                        pa.array(lists[start:end], pa.list_(pa.int32())),
+                        pa.DictionaryArray.from_arrays(indices, dictionary),
+                        pa.array(range(start, end), pa.int64()),
+                    ],
+                    schema=schema,
+                )
+            )
+
+        buf = io.BytesIO()
+        writer = pa.RecordBatchFileWriter(buf, schema)
+        for batch in batches:
+            writer.write_batch(batch)
+        writer.close()
+
+        for batch_size, batch_mode in [(None, "auto"), (2, "keep_remainder")]:
+            dataset = arrow_io.ArrowDataset(
+                tf.convert_to_tensor(buf.getvalue(), dtype=tf.dtypes.string),
+                (0, 1, 2),
+                (tf.int32, tf.string, tf.int64),
+                (
+                    tf.TensorShape([None]),
+                    tf.TensorShape([]),
+                    tf.TensorShape([]),
+                ),
+                batch_size=batch_size,
+                batch_mode=batch_mode,
+                ragged_columns=[0],
+                dictionary_columns=[1],
+            )
+            self.assertIsInstance(dataset.element_spec[0], tf.RaggedTensorSpec)
+            rows = []
+            for ragged, (indices, values), ids in dataset:
+                self.assertEqual(ragged.shape[0], ids.shape[0])
+                rows.extend(
+                    zip(
+                        ragged.to_list(),
+                        tf.gather(values, indices).numpy().tolist(),
+                        ids.numpy().tolist(),
+                    )
+                )
+            self.assertEqual(
+                rows,
+                [(l, w.encode(), i) for i, (l, w) in enumerate(zip(lists, words))],
+            )
+
+        with self.assertRaisesRegex(ValueError, "ragged_columns"):
+            arrow_io.ArrowDataset(
+                tf.constant(b""),
+                (0,),
+                (tf.int32,),
+                (tf.TensorShape([None]),),
+                ragged_columns=[0],
+            )
+
+    def test_read_ahead(self):
+        """Test reading record batches ahead on a background thread"""
+        import tensorflow_io.arrow as arrow_io
+
+        num_batches = 5
+        truth_data = TruthData(self.scalar_data, self.scalar_dtypes, self.scalar_shapes)
+        batch = self.make_record_batch(truth_data)
+
+        buf = io.BytesIO()
+        writer = pa.RecordBatchFileWriter(buf, batch.schema)
+        for _ in range(num_batches):
+            writer.write_batch(batch)
+        writer.close()
+
+        for read_ahead_bytes in [0, 1]:
+            dataset = arrow_io.ArrowDataset(
+                tf.convert_to_tensor(buf.getvalue(), dtype=tf.dtypes.string),
+                tuple(range(batch.num_columns)),
+                truth_data.output_types,
+                truth_data.output_shapes,
+                batch_mode="auto",
+                read_ahead_batches=2,
+                read_ahead_bytes=read_ahead_bytes,
+            )
+            results = list(dataset)
+            self.assertEqual(len(results), num_batches)
+            for result in results:
+                for i, value in enumerate(result):
+                    npt.assert_almost_equal(value.numpy(), truth_data.data[i])
+
+        # The queued batches are accounted to the memory budget until taken
+        usage, _ = tfio.experimental.filesystem.memory_budget_usage()
+        self.assertGreater(usage["arrow_read_ahead"]["peak_bytes"], 0)
+        self.assertEqual(usage["arrow_read_ahead"]["bytes"], 0)
+
     def test_batch_with_partials(self):
         """Test batch_size that divides an Arrow record batch into
         partial batches
@@ -1114,6 +1386,38 @@ class ArrowDatasetTest(ArrowTestBase):
 
         self.run_test_case(dataset, truth_data, batch_size=batch_size)
 
+    def test_batch_strings_and_lists_span_partials(self):
+        """Test batch_size spanning record batches with string and list columns"""
+        import tensorflow_io.arrow as arrow_io
+
+        num_batches = 3
+        strings = [b"a", b"bb", b"", b"dddd"]
+        lists = [[1, 2], [3, 4], [5, 6], [7, 8]]
+        batch = pa.RecordBatch.from_arrays(
+            [pa.array(strings), pa.array(lists, type=pa.list_(pa.int32()))],
+            ["strings", "lists"],
+        )
+        batch_size = 3
+
+        dataset = arrow_io.ArrowDataset.from_record_batches(
+            [batch] * num_batches,
+            (tf.dtypes.string, tf.dtypes.int32),
+            (tf.TensorShape([]), tf.TensorShape([2])),
+            batch_size=batch_size,
+        )
+        all_strings = strings * num_batches
+        all_lists = lists * num_batches
+        results = list(dataset)
+        self.assertEqual(len(results), len(all_strings) // batch_size)
+        for i, (result_strings, result_lists) in enumerate(results):
+            start = i * batch_size
+            self.assertEqual(
+                result_strings.numpy().tolist(), all_strings[start : start + batch_size]
+            )
+            npt.assert_equal(
+                result_lists.numpy(), all_lists[start : start + batch_size]
+            )
+
     def test_batch_fixed_lists(self):
         """Test batching with fixed length list types"""
         import tensorflow_io.arrow as arrow_io
@@ -1228,6 +1532,157 @@ class ArrowDatasetTest(ArrowTestBase):
 
         os.unlink(f.name)
 
+    def test_arrow_scanner_dataset(self):
+        """Test scanning a hive partitioned directory with a filter"""
+        import pyarrow.parquet as pq
+        import tensorflow_io.arrow as arrow_io
+
+        with tempfile.TemporaryDirectory() as path:
+            for year in [2020, 2021]:
+                os.makedirs(os.path.join(path, f"year={year}"))
+                table = pa.table(
+                    {
+                        "x": pa.array(range(10), pa.int64()),
+                        "y": pa.array([float(year)] * 10, pa.float64()),
+                        "unused": pa.array(["skip"] * 10),
+                    }
+                )
+                pq.write_table(
+                    table,
+                    os.path.join(path, f"year={year}", "part.parquet"),
+                    row_group_size=5,
+                )
+
+            dataset = arrow_io.ArrowScannerDataset.from_path(
+                path,
+                columns=["x", "y", "year"],
+                filters=[("year", "==", 2021), ("x", ">=", 7)],
+                batch_size=2,
+            )
+            xs, ys, years = [], [], []
+            for x, y, year in dataset:
+                xs.extend(x.numpy().tolist())
+                ys.extend(y.numpy().tolist())
+                years.extend(year.numpy().tolist())
+            self.assertEqual(sorted(xs), [7, 8, 9])
+            self.assertEqual(ys, [2021.0] * 3)
+            self.assertEqual(years, [2021] * 3)
+
+            with self.assertRaisesRegex(
+                tf.errors.InvalidArgumentError, "Unsupported filter op"
+            ):
+                next(
+                    iter(
+                        arrow_io.ArrowScannerDataset(
+                            path, ["x"], (tf.int64,), filters=[("x", "~", 1)]
+                        )
+                    )
+                )
+
+    def test_arrow_scanner_dataset_row_groups(self):
+        """Test scanning Parquet row groups in parallel with pre-buffering"""
+        import pyarrow.parquet as pq
+        import tensorflow_io.arrow as arrow_io
+
+        with tempfile.TemporaryDirectory() as path:
+            table = pa.table({"x": pa.array(range(100), pa.int64())})
+            pq.write_table(table, os.path.join(path, "part.parquet"), row_group_size=10)
+
+            dataset = arrow_io.ArrowScannerDataset.from_path(
+                path,
+                columns=["x"],
+                partitioning=None,
+                filters=[("x", ">=", 35)],
+                batch_mode="auto",
+                split_row_groups=True,
+                pre_buffer=True,
+            )
+            xs = []
+            for (x,) in dataset:
+                xs.extend(x.numpy().tolist())
+            self.assertEqual(xs, list(range(35, 100)))
+
+    def test_arrow_writer(self):
+        """Test writing batches of tensors to Arrow IPC files and streams"""
+        import pyarrow.feather as feather
+        import tensorflow_io.arrow as arrow_io
+
+        ids = tf.constant([1, 2, 3], tf.int64)
+        scores = tf.constant([[0.5, 1.5], [2.5, 3.5], [4.5, 5.5]], tf.float32)
+        names = tf.constant(["a", "bb", "ccc"])
+        flags = tf.constant([True, False, True])
+        with tempfile.TemporaryDirectory() as path:
+            for file_format, compression in [
+                ("feather", None),
+                ("file", "zstd"),
+                ("stream", "lz4"),
+            ]:
+                filename = os.path.join(path, f"{file_format}.arrow")
+                with arrow_io.ArrowWriter(
+                    filename,
+                    ["ids", "scores", "names", "flags"],
+                    file_format=file_format,
+                    compression=compression,
+                ) as writer:
+                    writer.write([ids, scores, names, flags])
+                    writer.write([ids, scores, names, flags])
+
+                if file_format == "stream":
+                    with pa.OSFile(filename, "rb") as f:
+                        table = pa.ipc.open_stream(f).read_all()
+                else:
+                    table = feather.read_table(filename)
+                self.assertEqual(table.num_rows, 6)
+                self.assertEqual(table.column("ids").to_pylist(), [1, 2, 3] * 2)
+                self.assertEqual(
+                    table.column("scores").to_pylist(),
+                    scores.numpy().tolist() * 2,
+                )
+                self.assertEqual(
+                    table.column("names").to_pylist(), ["a", "bb", "ccc"] * 2
+                )
+                self.assertEqual(
+                    table.column("flags").to_pylist(), [True, False, True] * 2
+                )
+
+    def test_parquet_writer(self):
+        """Test writing batches of tensors to Parquet files in row groups"""
+        import pyarrow.parquet as pq
+        import tensorflow_io.arrow as arrow_io
+
+        ids = tf.constant([1, 2, 3], tf.int64)
+        scores = tf.constant([[0.5, 1.5], [2.5, 3.5], [4.5, 5.5]], tf.float32)
+        names = tf.constant(["a", "bb", "ccc"])
+        with tempfile.TemporaryDirectory() as path:
+            for compression in [None, "snappy", "zstd"]:
+                filename = os.path.join(path, f"{compression}.parquet")
+                with arrow_io.ParquetWriter(
+                    filename,
+                    ["ids", "scores", "names"],
+                    compression=compression,
+                    row_group_size=4,
+                ) as writer:
+                    for _ in range(3):
+                        writer.write([ids, scores, names])
+
+                parquet_file = pq.ParquetFile(filename)
+                self.assertEqual(
+                    [
+                        parquet_file.metadata.row_group(i).num_rows
+                        for i in range(parquet_file.num_row_groups)
+                    ],
+                    [4, 4, 1],
+                )
+                table = parquet_file.read()
+                self.assertEqual(table.column("ids").to_pylist(), [1, 2, 3] * 3)
+                self.assertEqual(
+                    table.column("scores").to_pylist(),
+                    scores.numpy().tolist() * 3,
+                )
+                self.assertEqual(
+                    table.column("names").to_pylist(), ["a", "bb", "ccc"] * 3
+                )
+
     def test_arrow_feather_dataset_binary(self):
         """test_arrow_feather_dataset_binary"""
         import tensorflow_io.arrow as arrow_io
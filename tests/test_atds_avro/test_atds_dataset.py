@@ -0,0 +1,327 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for ATDSDataset"""
+
+import json
+import os
+
+import numpy as np
+import pytest
+import tensorflow as tf
+from avro.datafile import DataFileWriter
+from avro.io import DatumWriter
+from avro.schema import Parse as parse
+
+from tensorflow_io.python.experimental.atds.dataset import ATDSDataset
+from tensorflow_io.python.experimental.atds.features import (
+    DenseFeature,
+    RaggedFeature,
+    SparseFeature,
+    VarlenFeature,
+)
+
+_SCHEMA = json.dumps(
+    {
+        "type": "record",
+        "name": "row",
+        "fields": [
+            {"name": "id", "type": "long"},
+            {"name": "values", "type": {"type": "array", "items": "float"}},
+        ],
+    }
+)
+
+_FEATURES = {
+    "id": DenseFeature([], tf.int64),
+    "values": VarlenFeature([-1], tf.float32),
+}
+
+
+def _values(record_id):
+    return [float(record_id)] * (record_id % 4)
+
+
+def _write_avro_file(path, ids, codec="null", records_per_block=10):
+    """Writes records with the given ids, a new Avro block every
+    `records_per_block` records."""
+    with open(path, "wb") as out:
+        writer = DataFileWriter(out, DatumWriter(), parse(_SCHEMA), codec=codec)
+        for i, record_id in enumerate(ids):
+            writer.append({"id": record_id, "values": _values(record_id)})
+            if (i + 1) % records_per_block == 0:
+                writer.sync()
+        writer.close()
+    return path
+
+
+def _read_ids(dataset):
+    """Returns the ids of all records of the dataset in order, and checks
+    that the values of every record match its id."""
+    ids = []
+    for batch in dataset:
+        values = tf.sparse.to_dense(batch["values"]).numpy()
+        for record_id, row in zip(batch["id"].numpy(), values):
+            expected = _values(int(record_id))
+            np.testing.assert_array_equal(row[: len(expected)], expected)
+            ids.append(int(record_id))
+    return ids
+
+
+def test_atds_compressed_blocks_in_file_order(tmp_path):
+    """Blocks decompressed in parallel are still read in file order."""
+    ids = list(range(1000))
+    path = _write_avro_file(
+        os.path.join(tmp_path, "deflate.avro"), ids, codec="deflate"
+    )
+    dataset = ATDSDataset(
+        [path], batch_size=32, features=_FEATURES, num_parallel_calls=4
+    )
+    assert _read_ids(dataset) == ids
+
+
+def test_atds_parallel_reads(tmp_path):
+    """Parallel readers, also paused by a small byte limit, read every
+    record of every file once."""
+    filenames = []
+    ids = []
+    for i in range(5):
+        file_ids = list(range(i * 200, i * 200 + 150 + i * 10))
+        filenames.append(
+            _write_avro_file(
+                os.path.join(tmp_path, f"part-{i}.avro"),
+                file_ids,
+                codec="deflate" if i % 2 else "null",
+            )
+        )
+        ids.extend(file_ids)
+    for max_inflight_bytes in [0, 256]:
+        dataset = ATDSDataset(
+            filenames,
+            batch_size=16,
+            features=_FEATURES,
+            num_parallel_reads=3,
+            num_parallel_calls=2,
+            max_inflight_bytes=max_inflight_bytes,
+        )
+        assert sorted(_read_ids(dataset)) == ids
+
+
+def _batch_ids(iterator, num_batches=None):
+    """Returns the ids of the next `num_batches` batches, or of all
+    remaining batches if None."""
+    ids = []
+    while num_batches is None or num_batches > 0:
+        batch = next(iterator, None)
+        if batch is None:
+            break
+        ids.extend(batch["id"].numpy().tolist())
+        if num_batches is not None:
+            num_batches -= 1
+    return ids
+
+
+@pytest.mark.parametrize(
+    "shuffle_buffer_size, shuffle_mode",
+    [(0, "record"), (64, "record"), (64, "block")],
+)
+def test_atds_checkpoint_round_trip(tmp_path, shuffle_buffer_size, shuffle_mode):
+    """A restored iterator continues the epoch where it was saved."""
+    filenames = [
+        _write_avro_file(
+            os.path.join(tmp_path, f"part-{i}.avro"),
+            list(range(i * 300, i * 300 + 300)),
+            codec=codec,
+        )
+        for i, codec in enumerate(["deflate", "null"])
+    ]
+
+    def make_dataset():
+        return ATDSDataset(
+            filenames,
+            batch_size=16,
+            features=_FEATURES,
+            shuffle_buffer_size=shuffle_buffer_size,
+            shuffle_mode=shuffle_mode,
+            shuffle_seed=7,
+        )
+
+    iterator = iter(make_dataset())
+    checkpoint = tf.train.Checkpoint(iterator=iterator)
+    read_ids = _batch_ids(iterator, num_batches=10)
+    path = checkpoint.save(os.path.join(tmp_path, "ckpt"))
+    remaining_ids = _batch_ids(iterator)
+    assert sorted(read_ids + remaining_ids) == list(range(600))
+
+    restored = iter(make_dataset())
+    tf.train.Checkpoint(iterator=restored).restore(path)
+    restored_ids = _batch_ids(restored)
+    if shuffle_buffer_size == 0 and shuffle_mode == "record":
+        assert restored_ids == remaining_ids
+    else:
+        assert sorted(restored_ids) == sorted(remaining_ids)
+
+
+# Ragged features sort before, between and after the dense and sparse ones.
+_RAGGED_SCHEMA = json.dumps(
+    {
+        "type": "record",
+        "name": "row",
+        "fields": [
+            {"name": "a_tokens", "type": {"type": "array", "items": "long"}},
+            {"name": "id", "type": "long"},
+            {
+                "name": "s_sparse",
+                "type": {
+                    "type": "record",
+                    "name": "s_sparse_FloatSparseTensor",
+                    "fields": [
+                        {
+                            "name": "indices0",
+                            "type": {"type": "array", "items": "long"},
+                        },
+                        {
+                            "name": "values",
+                            "type": {"type": "array", "items": "float"},
+                        },
+                    ],
+                },
+            },
+            {"name": "values", "type": {"type": "array", "items": "float"}},
+        ],
+    }
+)
+
+_RAGGED_FEATURES = {
+    "values": RaggedFeature([-1], tf.float32),
+    "s_sparse": SparseFeature([8], tf.float32),
+    "id": DenseFeature([], tf.int64),
+    "a_tokens": RaggedFeature([-1], tf.int64),
+}
+
+
+def _tokens(record_id):
+    return list(range(record_id, record_id + record_id % 3))
+
+
+def _write_ragged_avro_file(path, ids):
+    with open(path, "wb") as out:
+        writer = DataFileWriter(out, DatumWriter(), parse(_RAGGED_SCHEMA))
+        for record_id in ids:
+            writer.append(
+                {
+                    "a_tokens": _tokens(record_id),
+                    "id": record_id,
+                    "s_sparse": {
+                        "indices0": [record_id % 8],
+                        "values": [float(record_id)],
+                    },
+                    "values": _values(record_id),
+                }
+            )
+        writer.close()
+    return path
+
+
+def _check_ragged_batch(batch):
+    """Checks every feature of a batch against its ids, and returns them."""
+    ids = batch["id"].numpy().tolist()
+    assert isinstance(batch["a_tokens"], tf.RaggedTensor)
+    assert isinstance(batch["values"], tf.RaggedTensor)
+    assert batch["a_tokens"].to_list() == [_tokens(i) for i in ids]
+    assert batch["values"].to_list() == [_values(i) for i in ids]
+    sparse = tf.sparse.to_dense(batch["s_sparse"]).numpy()
+    for record_id, row in zip(ids, sparse):
+        expected = np.zeros([8], np.float32)
+        expected[record_id % 8] = record_id
+        np.testing.assert_array_equal(row, expected)
+    return ids
+
+
+def test_atds_ragged_features(tmp_path):
+    """Ragged features are read in the flat component order of the sorted
+    feature keys, next to dense and sparse features."""
+    ids = list(range(50))
+    path = _write_ragged_avro_file(os.path.join(tmp_path, "ragged.avro"), ids)
+    dataset = ATDSDataset([path], batch_size=16, features=_RAGGED_FEATURES)
+    spec = dataset.element_spec
+    assert spec["a_tokens"] == tf.RaggedTensorSpec(
+        [None, None], tf.int64, ragged_rank=1
+    )
+    assert spec["values"] == tf.RaggedTensorSpec(
+        [None, None], tf.float32, ragged_rank=1
+    )
+    assert spec["s_sparse"] == tf.SparseTensorSpec([None, 8], tf.float32)
+    assert spec["id"] == tf.TensorSpec([None], tf.int64)
+
+    read_ids = []
+    for batch in dataset:
+        read_ids.extend(_check_ragged_batch(batch))
+    assert read_ids == ids
+
+
+def test_atds_ragged_features_drop_remainder(tmp_path):
+    """With drop_remainder, the row splits have a static batch_size + 1
+    rows."""
+    ids = list(range(50))
+    path = _write_ragged_avro_file(os.path.join(tmp_path, "ragged.avro"), ids)
+    dataset = ATDSDataset(
+        [path], batch_size=16, features=_RAGGED_FEATURES, drop_remainder=True
+    )
+    for key in ["a_tokens", "values"]:
+        assert dataset.element_spec[key].shape.as_list() == [16, None]
+    assert dataset.element_spec["id"].shape.as_list() == [16]
+
+    read_ids = []
+    for batch in dataset:
+        for key in ["a_tokens", "values"]:
+            assert batch[key].row_splits.shape == [17]
+        read_ids.extend(_check_ragged_batch(batch))
+    assert read_ids == ids[:48]
+
+
+@pytest.mark.parametrize("block_cache_bytes", [0, 1 << 20])
+def test_atds_from_memory(tmp_path, block_cache_bytes):
+    """Container bytes held in a tensor are read like the files they came
+    from, in every epoch."""
+    filenames = [
+        _write_avro_file(
+            os.path.join(tmp_path, f"part-{i}.avro"),
+            list(range(i * 300, i * 300 + 250)),
+            codec=codec,
+        )
+        for i, codec in enumerate(["deflate", "null"])
+    ]
+    contents = []
+    for filename in filenames:
+        with open(filename, "rb") as f:
+            contents.append(f.read())
+    expected = _read_ids(ATDSDataset(filenames, batch_size=16, features=_FEATURES))
+
+    dataset = ATDSDataset(
+        tf.constant(contents),
+        batch_size=16,
+        features=_FEATURES,
+        block_cache_bytes=block_cache_bytes,
+        from_memory=True,
+    )
+    for _ in range(2):
+        assert _read_ids(dataset) == expected
+
+    # Messages of a dataset are read by flat-mapping over their batches.
+    messages = tf.data.Dataset.from_tensor_slices(contents)
+    dataset = messages.batch(2).flat_map(
+        lambda m: ATDSDataset(m, batch_size=16, features=_FEATURES, from_memory=True)
+    )
+    assert _read_ids(dataset) == expected
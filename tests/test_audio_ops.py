@@ -21,6 +21,7 @@ import numpy as np
 
 import tensorflow as tf
 import tensorflow_io as tfio
+from tensorflow_io.python.ops import core_ops
 
 
 @pytest.fixture(name="fixture_lookup")
@@ -823,6 +824,95 @@ def test_encode_mp3_mono():
     _ = tfio.audio.encode_mp3(audio, rate=8000)
 
 
+def test_decode_batch():
+    """test_decode_batch"""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "test_audio")
+    filenames = [
+        "ZASFX_ADSR_no_sustain.wav",
+        "ZASFX_ADSR_no_sustain.flac",
+        "ZASFX_ADSR_no_sustain.s24.wav",
+    ]
+    content = tf.stack(
+        [tf.io.read_file(os.path.join(path, filename)) for filename in filenames]
+    )
+    expected = tf.audio.decode_wav(content[0]).audio
+
+    value, rate = tfio.audio.decode_batch(content)
+    assert value.shape[0] == 3
+    assert rate.numpy().tolist() == [44100] * 3
+    for i in range(3):
+        assert np.allclose(value[i].numpy(), expected.numpy())
+
+    value, _ = tfio.audio.decode_batch(content[:2], dtype=tf.int16)
+    for i in range(2):
+        assert np.array_equal(
+            value[i].numpy(), tf.cast(expected * (1 << 15), tf.int16).numpy()
+        )
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.audio.decode_batch(content, dtype=tf.int16)
+
+
+def test_decode_resample():
+    """test_decode_resample"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "ZASFX_ADSR_no_sustain.wav",
+    )
+    content = tf.io.read_file(path)
+    decoded = tf.audio.decode_wav(content).audio
+
+    value = tfio.audio.decode_resample(content, rate=16000)
+    expected = tfio.audio.resample(
+        tf.reduce_mean(decoded, axis=1, keepdims=True), 44100, 16000
+    )
+    assert value.shape == expected.shape
+    assert np.allclose(value.numpy(), expected.numpy(), atol=1e-4)
+
+    value = tfio.audio.decode_resample(content, rate=44100, mono=False)
+    assert np.allclose(value.numpy(), decoded.numpy())
+
+
+def test_audio_windows():
+    """test_audio_windows"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "ZASFX_ADSR_no_sustain.ogg",
+    )
+    audio = tfio.audio.AudioIOTensor(path)
+    expected = audio.to_tensor().numpy()
+    samples = expected.shape[0]
+
+    # Windows out of order, backwards and continuing the previous one.
+    windows = [(8000, 9000), (100, 1100), (1100, 2100), (samples - 500, samples)]
+    windows += [(start, start + 700) for start in range(samples - 700, 0, -2500)]
+    for start, stop in windows:
+        assert np.allclose(audio[start:stop].numpy(), expected[start:stop])
+
+
+@pytest.mark.parametrize("ext", ["wav", "flac"])
+def test_audio_writer(ext, tmp_path):
+    """test_audio_writer"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "ZASFX_ADSR_no_sustain.wav",
+    )
+    audio = tfio.audio.decode_wav(tf.io.read_file(path), dtype=tf.int16)
+    filename = str(tmp_path / "streamed.{}".format(ext))
+    with tfio.audio.AudioWriter(filename, rate=44100) as writer:
+        for start in range(0, audio.shape[0], 5000):
+            writer.write(audio[start : start + 5000])
+        with pytest.raises(tf.errors.InvalidArgumentError):
+            writer.write(tf.cast(audio[0:10], tf.float32))
+
+    streamed = tfio.audio.AudioIOTensor(filename)
+    assert streamed.rate == 44100
+    assert np.array_equal(streamed.to_tensor().numpy(), audio.numpy())
+
+
 def test_spectrogram():
     """test_spectrogram"""
 
@@ -891,6 +981,46 @@ def test_spectrogram():
     spec = tfio.audio.time_mask(spec, param=10)
 
 
+def test_mel_spectrogram():
+    """test_mel_spectrogram"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "mono_10khz.wav",
+    )
+    audio = tfio.audio.decode_wav(tf.io.read_file(path), dtype=tf.int16)
+    audio = tf.reshape(tf.cast(audio, tf.float32) / 32768.0, [-1])
+
+    nfft, window, stride = 400, 400, 200
+    rate, mels, fmin, fmax = 10000, 128, 0, 5000
+    expected = tfio.audio.melscale(
+        tfio.audio.spectrogram(audio, nfft=nfft, window=window, stride=stride),
+        rate=rate,
+        mels=mels,
+        fmin=fmin,
+        fmax=fmax,
+    )
+
+    value = tfio.audio.mel_spectrogram(
+        audio, rate, nfft, window, stride, mels, fmin, fmax
+    )
+    assert value.shape == [29, mels]
+    assert np.allclose(value.numpy(), expected.numpy(), rtol=1e-4, atol=1e-4)
+
+    value = tfio.audio.mel_spectrogram(
+        audio, rate, nfft, window, stride, mels, fmin, fmax, mfcc=13
+    )
+    mfcc = tf.signal.mfccs_from_log_mel_spectrograms(tf.math.log(expected + 1e-6))
+    assert value.shape == [29, 13]
+    assert np.allclose(value.numpy(), mfcc[:, :13].numpy(), rtol=1e-3, atol=1e-3)
+
+    value = tfio.audio.mel_spectrogram(
+        audio, rate, nfft, window, stride, mels, fmin, fmax, dtype=tf.float16
+    )
+    assert value.dtype == tf.float16
+    assert value.shape == [29, mels]
+
+
 @pytest.mark.parametrize(
     "audio_file, shape, spectrogram_shape",
     [
@@ -1027,3 +1157,68 @@ def test_audio_trim_split_remix():
 
         result = tfio.audio.remix(value, axis=axis, indices=indices)
         assert np.array_equal(ek, result)
+
+
+def order_indices_reference(indices, shape, axis):
+    """The expected output of io_order_indices, grouping the rows by their
+    coordinates but `axis` and keeping the rows of each group in order."""
+    groups = {}
+    for row in indices:
+        key = tuple(np.delete(row, axis))
+        groups.setdefault(key, []).append(row[axis])
+    dims = list(shape)
+    dims[axis] = max([len(e) for e in groups.values()], default=0)
+    expected = np.full(dims, -1, np.int64)
+    for key, values in groups.items():
+        for position, value in enumerate(values):
+            expected[key[:axis] + (position,) + key[axis:]] = value
+    return expected
+
+
+@pytest.mark.parametrize(
+    ("shape", "axis"),
+    [
+        # Keys up to twice the rows (or 1 << 16) are counted.
+        pytest.param([4, 8], 1, id="counting"),
+        pytest.param([3, 6, 5], 1, id="counting_inner"),
+        pytest.param([3, 6, 5], 0, id="counting_first_axis"),
+        # More keys are radix sorted.
+        pytest.param([300, 4, 1000], 1, id="radix"),
+        pytest.param([4, 400000], 0, id="radix_first_axis"),
+    ],
+)
+def test_order_indices(shape, axis):
+    """test_order_indices"""
+    rng = np.random.default_rng(0)
+    n = 64
+    indices = np.stack([rng.integers(0, dim, n) for dim in shape], axis=1)
+    indices = indices.astype(np.int64)
+    # Rows with duplicate keys, in no particular order along axis, whose
+    # output keeps the order of the input.
+    duplicate = indices[0].copy()
+    for value in [3, 0, 2, 3, 1]:
+        duplicate[axis] = value
+        indices = np.concatenate([indices, [duplicate]])
+    indices = indices[rng.permutation(len(indices))]
+
+    expected = order_indices_reference(indices, shape, axis)
+    result = core_ops.io_order_indices(indices, shape, axis)
+    np.testing.assert_array_equal(expected, result)
+    key = tuple(np.delete(duplicate, axis))
+    group = result.numpy()[key[:axis] + (slice(None),) + key[axis:]]
+    order = [row[axis] for row in indices if tuple(np.delete(row, axis)) == key]
+    np.testing.assert_array_equal(order, group[: len(order)])
+
+
+@pytest.mark.parametrize(
+    "shape",
+    [pytest.param([4, 8], id="counting"), pytest.param([4, 400000], id="radix")],
+)
+def test_order_indices_out_of_bounds(shape):
+    """test_order_indices_out_of_bounds"""
+    indices = np.array([[0, 1], [1, 2], [3, shape[1]]], np.int64)
+    with pytest.raises(tf.errors.InvalidArgumentError, match="out of bounds"):
+        core_ops.io_order_indices(indices, shape, 0)
+    indices = np.array([[0, 1], [-1, 2]], np.int64)
+    with pytest.raises(tf.errors.InvalidArgumentError, match="out of bounds"):
+        core_ops.io_order_indices(indices, shape, 1)
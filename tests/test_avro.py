@@ -16,6 +16,10 @@
 
 
 import os
+import struct
+import subprocess
+import sys
+import uuid
 import numpy as np
 
 import tensorflow as tf
@@ -23,6 +27,12 @@ import tensorflow as tf
 if not (hasattr(tf, "version") and tf.version.VERSION.startswith("2.")):
     tf.compat.v1.enable_eager_execution()
 import tensorflow_io as tfio  # pylint: disable=wrong-import-position
+from tensorflow_io.python.ops import (  # pylint: disable=wrong-import-position
+    core_ops,
+)
+from tensorflow.python.eager import (  # pylint: disable=wrong-import-position
+    context,
+)
 
 
 def test_avro():
@@ -135,6 +145,211 @@ def test_avro_dataset_partition():
             i += 1
         assert i == 100
 
+        dataset = tfio.IODataset.from_avro(filename, schema, ["im", "re"])
+        i = 0
+        for v in dataset:
+            im, re = v
+            assert im.numpy() == 100.0 + i
+            assert re.numpy() == 100.0 * i
+            i += 1
+        assert i == 100
+
+    for num_parallel_reads in [1, 2, 4]:
+        re_dataset = tfio.IODataset.from_avro(
+            filename, schema, ["re"], num_parallel_reads=num_parallel_reads
+        )
+        assert np.all(
+            np.array(list(re_dataset)) == np.array([100.0 * i for i in range(100)])
+        )
+
+        dataset = tfio.IODataset.from_avro(
+            filename, schema, ["im", "re"], num_parallel_reads=num_parallel_reads
+        )
+        i = 0
+        for im, re in dataset:
+            assert im.numpy() == 100.0 + i
+            assert re.numpy() == 100.0 * i
+            i += 1
+        assert i == 100
+
+
+def write_cpx_avro(filename, schema, blocks):
+    """Writes an Avro container file of cpx records, uncompressed, with one
+    block of `count` records for each count in `blocks`. The records are
+    re = 100 * i and im = 100 + i for the i-th record of the file."""
+
+    def long(n):
+        n = (n << 1) ^ (n >> 63)
+        encoded = bytearray()
+        while n & ~0x7F:
+            encoded.append((n & 0x7F) | 0x80)
+            n >>= 7
+        encoded.append(n)
+        return bytes(encoded)
+
+    def string(s):
+        return long(len(s)) + s
+
+    sync = bytes(range(16))
+    with open(filename, "wb") as f:
+        f.write(b"Obj\x01")
+        f.write(long(2))
+        f.write(string(b"avro.schema") + string(schema.encode()))
+        f.write(string(b"avro.codec") + string(b"null"))
+        f.write(long(0))
+        f.write(sync)
+        i = 0
+        for count in blocks:
+            data = b"".join(
+                struct.pack("<dd", 100.0 * e, 100.0 + e) for e in range(i, i + count)
+            )
+            f.write(long(count) + long(len(data)) + data + sync)
+            i += count
+
+
+def test_avro_uneven_blocks(tmp_path):
+    """test_avro_uneven_blocks"""
+    schema_filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_avro", "cpx.json"
+    )
+    with open(schema_filename) as f:
+        schema = f.read()
+    # More blocks than are cached, of different record counts, so that the
+    # record count of a block can not be guessed from another's.
+    blocks = [1, 7, 3, 12, 2, 30, 5, 1, 1, 9] * 4
+    total = sum(blocks)
+    filename = str(tmp_path / "uneven.avro")
+    write_cpx_avro(filename, schema, blocks)
+    filename = "file://" + filename
+    re_expected = 100.0 * np.arange(total)
+    im_expected = 100.0 + np.arange(total)
+
+    avro = tfio.IOTensor.from_avro(filename, schema)
+    assert avro("re").shape == [total]
+    assert np.array_equal(avro("re").to_tensor(), re_expected)
+    assert np.array_equal(avro("im").to_tensor(), im_expected)
+
+    # Ranges starting and stopping within, and at the boundaries of, blocks.
+    boundaries = np.cumsum([0] + blocks)
+    ranges = [(0, 1), (0, 8), (1, 8), (5, 14), (7, 11), (20, 60), (63, 64)]
+    ranges.extend((b - 1, b + 2) for b in boundaries[1:-1])
+    ranges.append((total - 40, total))
+    with tf.name_scope("AvroIOTensor") as scope:
+        resource, _ = core_ops.io_avro_readable_init(
+            filename,
+            metadata=["schema: %s" % schema],
+            container=scope,
+            shared_name=f"{filename}/{uuid.uuid4().hex}",
+        )
+    for start, stop in ranges:
+        # The components read one after the other, and together.
+        assert np.array_equal(avro("re")[start:stop], re_expected[start:stop])
+        assert np.array_equal(avro("im")[start:stop], im_expected[start:stop])
+        re, im = core_ops.io_avro_readable_read_components(
+            resource,
+            start=start,
+            stop=stop,
+            components=["re", "im"],
+            shapes=[tf.TensorShape([None])] * 2,
+            dtypes=[tf.float64] * 2,
+        )
+        assert np.array_equal(re, re_expected[start:stop])
+        assert np.array_equal(im, im_expected[start:stop])
+
+    dataset = tfio.IODataset.from_avro(filename, schema, ["im", "re"])
+    entries = list(zip(*dataset))
+    assert np.array_equal(np.array(entries[0]), im_expected)
+    assert np.array_equal(np.array(entries[1]), re_expected)
+
+
+def read_components_in_function(filename, schema, start, stop):
+    """Reads re and im over [start, stop) in a tf.function, and returns
+    their values and the ops of the graphs that were run."""
+    with tf.name_scope("AvroIOTensor") as scope:
+        resource, _ = core_ops.io_avro_readable_init(
+            filename,
+            metadata=["schema: %s" % schema],
+            container=scope,
+            shared_name=f"{filename}/{uuid.uuid4().hex}",
+        )
+
+    @tf.function(
+        input_signature=[tf.TensorSpec([], tf.int64), tf.TensorSpec([], tf.int64)]
+    )
+    def f(start, stop):
+        # Both reads share the resource, start and stop inputs.
+        return [
+            core_ops.io_avro_readable_read(
+                resource,
+                start=start,
+                stop=stop,
+                component=component,
+                shape=tf.TensorShape([None]),
+                dtype=tf.float64,
+            )
+            for component in ["re", "im"]
+        ]
+
+    context.enable_run_metadata()
+    try:
+        re, im = f(tf.constant(start, tf.int64), tf.constant(stop, tf.int64))
+        metadata = context.export_run_metadata()
+    finally:
+        context.disable_run_metadata()
+    ops = set()
+    for function_graph in metadata.function_graphs:
+        graphs = [function_graph.post_optimization_graph]
+        graphs.extend(function_graph.partition_graphs)
+        for graph in graphs:
+            ops.update(node.op for node in graph.node)
+    return re.numpy(), im.numpy(), ops
+
+
+def test_avro_graph_rewrite():
+    """test_avro_graph_rewrite"""
+    # The test.bin was created from avro/lang/c++/examples/datafile.cc.
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_avro", "test.bin"
+    )
+    filename = "file://" + filename
+
+    schema_filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_avro", "cpx.json"
+    )
+    with open(schema_filename) as f:
+        schema = f.read()
+
+    avro = tfio.IOTensor.from_avro(filename, schema)
+    for start, stop in [(0, 100), (13, 51)]:
+        re, im, ops = read_components_in_function(filename, schema, start, stop)
+        assert np.all(re == avro("re")[start:stop].numpy())
+        assert np.all(im == avro("im")[start:stop].numpy())
+        assert "IO>AvroReadableReadComponents" in ops
+
+    # The pass reads TFIO_GRAPH_REWRITE when the library is loaded.
+    script = (
+        "import sys; sys.path.insert(0, sys.argv[1]); import test_avro; "
+        "re, im, ops = test_avro.read_components_in_function("
+        "sys.argv[2], open(sys.argv[3]).read(), 13, 51); "
+        "assert 'IO>AvroReadableReadComponents' not in ops, ops; "
+        "assert 'IO>AvroReadableRead' in ops, ops; "
+        "assert list(re) == [100.0 * i for i in range(13, 51)], re; "
+        "assert list(im) == [100.0 + i for i in range(13, 51)], im"
+    )
+    env = dict(os.environ, TFIO_GRAPH_REWRITE="false")
+    subprocess.run(
+        [
+            sys.executable,
+            "-c",
+            script,
+            os.path.dirname(os.path.abspath(__file__)),
+            filename,
+            schema_filename,
+        ],
+        env=env,
+        check=True,
+    )
+
 
 if __name__ == "__main__":
     test.main()
@@ -104,6 +104,30 @@ class AZFSTestBase:
 
         tf.io.gfile.rmtree(self._path_to("wildcard"))
 
+    def test_wildcard_matching_nested(self):
+        """Test glob patterns with wildcards in several components"""
+        for part in ["a", "b", "skip"]:
+            for i in range(2):
+                file_path = self._path_to(f"nested/{part}/{i}/part-0.txt")
+                with tf.io.gfile.GFile(file_path, "w") as f:
+                    f.write("")
+
+        files = tf.io.gfile.glob(self._path_to("nested/[ab]/*/part-0.txt"))
+        self.assertEqual(
+            [
+                self._path_to(f"nested/{part}/{i}/part-0.txt")
+                for part in ["a", "b"]
+                for i in range(2)
+            ],
+            files,
+        )
+        self.assertEqual(
+            [self._path_to("nested/a/0/part-0.txt")],
+            tf.io.gfile.glob(self._path_to("nested/a/0/part-0.txt")),
+        )
+
+        tf.io.gfile.rmtree(self._path_to("nested"))
+
     def test_delete_recursively(self):
         """Test delete recursively."""
         # Setup and check preconditions.
@@ -623,6 +623,46 @@ class BigqueryOpsTest(test.TestCase):
             self.DEFAULT_VALUES, self._normalize_dictionary(itr.get_next())
         )
 
+    def test_concurrent_read_rows(self):
+        """Test for reading the rows of all streams within one dataset."""
+        client = BigQueryTestClient(BigqueryOpsTest.server.endpoint())
+        read_session = self._get_read_session(
+            client, selected_fields=self.SELECTED_FIELDS_DICT
+        )
+
+        dataset = read_session.concurrent_read_rows()
+        rows = [self._normalize_dictionary(row) for row in dataset]
+        expected_rows = [
+            self.STREAM_1_ROWS[0],
+            self.STREAM_1_ROWS[1],
+            self.STREAM_2_ROWS[0],
+            self.DEFAULT_VALUES,
+        ]
+        self.assertEqual(len(expected_rows), len(rows))
+        for expected_row in expected_rows:
+            self.assertIn(expected_row, rows)
+
+    def test_read_rows_batch_size(self):
+        """Test for reading batches of rows with non-repeated fields only."""
+        client = BigQueryTestClient(BigqueryOpsTest.server.endpoint())
+        read_session = self._get_read_session(
+            client,
+            selected_fields=self.SELECTED_FIELDS_LIST,
+            output_types=self.OUTPUT_TYPES_LIST,
+        )
+
+        streams_list = read_session.get_streams()
+        dataset2 = read_session.read_rows(streams_list[1], batch_size=2)
+        itr2 = iter(dataset2)
+        batch = self._normalize_dictionary(itr2.get_next())
+        for i, row in enumerate([self.STREAM_2_ROWS[0], self.DEFAULT_VALUES]):
+            expected_row = self._get_nonrepeated_only_fields(row)
+            self.assertEqual(
+                expected_row, {key: value[i] for key, value in batch.items()}
+            )
+        with self.assertRaises(errors.OutOfRangeError):
+            itr2.get_next()
+
 
 if __name__ == "__main__":
     test.main()
@@ -95,3 +95,52 @@ class BigtableReadTest(test.TestCase):
             r for r in table.read_rows(["fam1:col1", "fam2:col2"], row_set=row_s)
         ]
         self.assertEqual(len(read_rows), 10)
+
+    def test_read_batches(self):
+        os.environ["BIGTABLE_EMULATOR_HOST"] = self.emulator.get_addr()
+        self.emulator.create_table(
+            "fake_project",
+            "fake_instance",
+            "test-table",
+            ["fam1", "fam2"],
+            splits=["row005", "row010", "row015"],
+        )
+
+        values = [[f"[{i,j}]" for j in range(2)] for i in range(20)]
+
+        ten = tf.constant(values)
+
+        client = BigtableClient("fake_project", "fake_instance")
+        table = client.get_table("test-table")
+
+        self.emulator.write_tensor(
+            "fake_project",
+            "fake_instance",
+            "test-table",
+            ten,
+            ["row" + str(i).rjust(3, "0") for i in range(20)],
+            ["fam1:col1", "fam2:col2"],
+        )
+
+        row_s = row_set.from_rows_or_ranges(row_range.infinite())
+        batches = [
+            b.numpy()
+            for b in table.read_rows(
+                ["fam1:col1", "fam2:col2"], row_set=row_s, batch_size=8
+            )
+        ]
+        self.assertEqual([len(b) for b in batches], [8, 8, 4])
+        read_values = [[c.decode() for c in r] for b in batches for r in b]
+        self.assertEqual(read_values, values)
+
+        for num_parallel_reads, batch_size in [(4, None), (4, 3), (8, None)]:
+            dataset = table.read_rows(
+                ["fam1:col1", "fam2:col2"],
+                row_set=row_s,
+                batch_size=batch_size,
+                num_parallel_reads=num_parallel_reads,
+            )
+            if batch_size is not None:
+                dataset = dataset.unbatch()
+            read_values = [[c.decode() for c in r.numpy()] for r in dataset]
+            self.assertCountEqual(read_values, values)
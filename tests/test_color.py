@@ -183,3 +183,31 @@ def test_color(data, func, check, request):
         assert np.allclose(output_4d, expected_4d, rtol=0.03)
     else:
         assert np.array_equal(output_4d, expected_4d)
+
+
+@pytest.mark.parametrize(
+    ("func", "kwargs"),
+    [
+        (tfio.experimental.color.rgb_to_ypbpr, {}),
+        (tfio.experimental.color.ypbpr_to_rgb, {}),
+        (tfio.experimental.color.rgb_to_ydbdr, {}),
+        (tfio.experimental.color.ydbdr_to_rgb, {}),
+        (tfio.experimental.color.rgb_to_xyz, {}),
+        (tfio.experimental.color.xyz_to_rgb, {}),
+        (tfio.experimental.color.rgb_to_lab, {"illuminant": "D50"}),
+        (tfio.experimental.color.lab_to_rgb, {"illuminant": "A", "observer": "10"}),
+    ],
+)
+def test_color_native(func, kwargs):
+    """test_color_native"""
+    np.random.seed(1000)
+
+    # More pixels than a block of the native kernel, in a batch.
+    input = np.random.random((2, 30, 20, 3))
+    if func is tfio.experimental.color.lab_to_rgb:
+        input = input * [100.0, 20.0, 20.0]
+
+    expected = func(tf.constant(input, tf.float64), **kwargs)
+    output = func(tf.constant(input, tf.float32), **kwargs)
+    assert output.dtype == tf.float32
+    assert np.allclose(output, expected, rtol=1e-3, atol=1e-4)
@@ -22,6 +22,8 @@ import numpy as np
 
 import pandas as pd
 
+import tensorflow as tf
+
 import tensorflow_io as tfio  # pylint: disable=wrong-import-position
 
 
@@ -115,3 +117,73 @@ def test_str_csv_format():
 
 if __name__ == "__main__":
     test.main()
+
+
+def test_csv_stream_splits():
+    """test_csv_stream_splits"""
+    data = {
+        "int64": np.asarray(range(1000), np.int64),
+        "double": np.asarray(range(1000), np.float64),
+    }
+    df = pd.DataFrame(data)
+    with tempfile.NamedTemporaryFile(delete=False, mode="w") as f:
+        df.to_csv(f, index=False)
+
+    dataset = tfio.IODataset.from_csv(f.name, block_size=1024, capacity=100)
+    assert [int(e.numpy()) for e, _ in dataset] == list(range(1000))
+
+    size = os.path.getsize(f.name)
+    values = []
+    for offset in range(0, size, size // 3):
+        dataset = tfio.IODataset.from_csv(
+            f.name, columns=["int64"], offset=offset, length=size // 3
+        )
+        values.extend(int(e.numpy()) for e in dataset)
+    assert values == list(range(1000))
+
+    os.unlink(f.name)
+
+
+def test_csv_read_ahead():
+    """test_csv_read_ahead"""
+    data = {"int64": np.asarray(range(1000), np.int64)}
+    df = pd.DataFrame(data)
+    with tempfile.NamedTemporaryFile(delete=False, mode="w") as f:
+        df.to_csv(f, index=False)
+
+    dataset = tfio.IODataset.from_csv(f.name, columns=["int64"], capacity=7)
+    assert [int(e.numpy()) for e in dataset] == list(range(1000))
+
+    # Sequential slices are read ahead, others are read or taken from the cache
+    column = tfio.IOTensor.from_csv(f.name)("int64")
+    for start in [0, 100, 200, 100, 0, 300, 950]:
+        assert column[start : start + 100].numpy().tolist() == list(
+            range(start, min(start + 100, 1000))
+        )
+
+    os.unlink(f.name)
+
+
+def test_csv_options():
+    """test_csv_options"""
+    with tempfile.NamedTemporaryFile(delete=False, mode="w") as f:
+        f.write("a;b;c\n")
+        for i in range(10):
+            f.write(f"{i};'x;{i}';{i * 2}\n")
+
+    csv = tfio.IOTensor.from_csv(
+        f.name,
+        columns=["c", "b"],
+        column_types={"c": tf.float32},
+        delimiter=";",
+        quote_char="'",
+        use_threads=False,
+    )
+    assert csv.columns == ["c", "b"]
+    assert csv("c").dtype == tf.float32
+    assert np.all(csv("c").to_tensor().numpy() == [i * 2 for i in range(10)])
+    assert csv("b").to_tensor().numpy().tolist() == [
+        f"x;{i}".encode() for i in range(10)
+    ]
+
+    os.unlink(f.name)
@@ -88,6 +88,32 @@ def test_decode_dicom_image(fname, exp_shape):
     assert dcm_image.numpy().shape == exp_shape
 
 
+def test_decode_dicom_image_frames():
+    """test_decode_dicom_image_frames"""
+
+    dcm_path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_dicom",
+        "XA-MONO2-8-12x-catheter.dcm",
+    )
+
+    file_contents = tf.io.read_file(filename=dcm_path)
+
+    dcm_image = tfio.image.decode_dicom_image(
+        contents=file_contents, on_error="strict", color_dim=True
+    )
+    dcm_frames = tfio.image.decode_dicom_image(
+        contents=file_contents, on_error="strict", color_dim=True, start=3, count=4
+    )
+    assert dcm_frames.shape == (4, 512, 512, 1)
+    assert np.array_equal(dcm_frames.numpy(), dcm_image[3:7].numpy())
+
+    dcm_frames = tfio.image.decode_dicom_image(
+        contents=file_contents, on_error="strict", color_dim=True, start=10
+    )
+    assert np.array_equal(dcm_frames.numpy(), dcm_image[10:].numpy())
+
+
 @pytest.mark.parametrize(
     "fname, tag, exp_value",
     [
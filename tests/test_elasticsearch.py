@@ -137,6 +137,32 @@ def test_elasticsearch_io_dataset_batch():
             assert len(item[attr]) == BATCH_SIZE
 
 
+@pytest.mark.skipif(not is_container_running(), reason="The container is not running")
+def test_elasticsearch_io_dataset_sliced():
+    """Test the functionality of the ElasticsearchIODataset when a subset of
+    the columns is read from several slices in parallel.
+    """
+
+    COLUMNS = ["name", "age"]
+    dataset = tfio.experimental.elasticsearch.ElasticsearchIODataset(
+        nodes=[NODE],
+        index=INDEX,
+        doc_type=DOC_TYPE,
+        headers=HEADERS,
+        columns=COLUMNS,
+        num_slices=2,
+        page_size=1,
+    )
+
+    assert issubclass(type(dataset), tf.data.Dataset)
+
+    names = []
+    for item in dataset:
+        assert sorted(item.keys()) == sorted(COLUMNS)
+        names.append(item["name"].numpy())
+    assert sorted(names) == [b"person1", b"person2", b"person3", b"person4"]
+
+
 @pytest.mark.skipif(not is_container_running(), reason="The container is not running")
 def test_elasticsearch_io_dataset_training():
     """Test the functionality of the ElasticsearchIODataset by training a
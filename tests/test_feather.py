@@ -90,5 +90,38 @@ def test_binary_feather_format():
     os.unlink(f.name)
 
 
+@pytest.mark.parametrize(
+    ("compression"),
+    ["uncompressed", "lz4", "zstd"],
+)
+def test_feather_slice(compression):
+    """test_feather_slice"""
+    import numpy as np
+    import pandas as pd
+
+    from pyarrow import feather as pa_feather
+
+    data = {
+        "int64": np.asarray(range(1000), np.int64),
+        "double": np.asarray(range(1000), np.float64),
+    }
+    df = pd.DataFrame(data)
+    with tempfile.NamedTemporaryFile(delete=False) as f:
+        pa_feather.write_feather(df, f, compression=compression, chunksize=128)
+
+    # Columns are read on first access, across several record batches.
+    feather = tfio.IOTensor.from_feather(f.name)
+    assert feather("double").shape == [1000]
+    for start, stop in [(0, 10), (100, 300), (990, 1000), (500, 2000)]:
+        assert np.all(
+            feather("int64")[start:stop].numpy() == data["int64"][start:stop]
+        )
+        assert np.all(
+            feather("double")[start:stop].numpy() == data["double"][start:stop]
+        )
+
+    os.unlink(f.name)
+
+
 if __name__ == "__main__":
     test.main()
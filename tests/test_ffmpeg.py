@@ -117,6 +117,56 @@ def test_ffmpeg_decode_video_invalid_index(video_path):
         tfio.experimental.ffmpeg.decode_video(content, 1)
 
 
+@pytest.mark.skipif(
+    sys.platform == "darwin",
+    reason="TODO: macOS on GitHub use ffmpeg 5.0, needs update",
+)
+def test_ffmpeg_video_seek(video_path):
+    """test_ffmpeg_video_seek"""
+    content = tf.io.read_file(video_path)
+    video = tfio.experimental.ffmpeg.decode_video(content, 0)
+    for start in [1, 100, 165, 200]:
+        dataset = tfio.IODataset.graph(tf.uint8).from_ffmpeg(
+            video_path, "v:0", start=start
+        )
+        frames = [frame.numpy() for frame in dataset]
+        assert len(frames) == max(0, 166 - start)
+        if frames:
+            assert np.array_equal(np.stack(frames), video[start:].numpy())
+
+
+@pytest.mark.skipif(
+    sys.platform == "darwin",
+    reason="TODO: macOS on GitHub use ffmpeg 5.0, needs update",
+)
+def test_ffmpeg_video_batch(video_path):
+    """test_ffmpeg_video_batch"""
+    from tensorflow_io.python.ops import (  # pylint: disable=import-outside-toplevel
+        ffmpeg_ops,
+    )
+
+    content = tf.io.read_file(video_path)
+    video = tfio.experimental.ffmpeg.decode_video(content, 0)
+    # Decodes of the same dimensions reuse the pooled conversion contexts.
+    assert np.array_equal(
+        tfio.experimental.ffmpeg.decode_video(content, 0).numpy(), video.numpy()
+    )
+
+    resource = ffmpeg_ops.io_ffmpeg_video_readable_init(video_path, 0)
+    batches = []
+    reset = True
+    while True:
+        value = ffmpeg_ops.io_ffmpeg_video_readable_next(
+            resource, reset, dtype=tf.uint8, batch=16
+        )
+        reset = False
+        if value.shape[0] == 0:
+            break
+        batches.append(value.numpy())
+    assert [len(batch) for batch in batches] == [16] * 10 + [6]
+    assert np.array_equal(np.concatenate(batches), video.numpy())
+
+
 @pytest.mark.skipif(sys.platform == "darwin", reason="macOS fails now")
 def test_video_predict(video_path):
     """test_video_predict"""
@@ -0,0 +1,595 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""An in-process mock object store for the filesystem plugin benchmarks.
+
+The store serves, from memory, the subset of the S3, Azure Blob and plain
+HTTP protocols that the s3://, az:// and http:// plugins use, and simulates
+the latency, bandwidth and throttling of a remote object store.
+"""
+
+import email.utils
+import hashlib
+import http.server
+import random
+import re
+import threading
+import time
+import urllib.parse
+import uuid
+from xml.sax.saxutils import escape
+
+S3 = "s3"
+AZURE = "az"
+HTTP = "http"
+
+_RANGE = re.compile(r"bytes=(\d+)-(\d*)")
+_CHUNK_SIZE = 64 * 1024
+
+
+class Profile:
+    """The simulated network of a MockObjectStore.
+
+    Args:
+      latency: Seconds before the response to every request.
+      bandwidth: Bytes per second of every response body, 0 for unlimited.
+      throttle_rate: Fraction of requests answered with a 503, which the
+        clients retry.
+      seed: Seed of the throttled requests.
+    """
+
+    def __init__(self, latency=0.0, bandwidth=0, throttle_rate=0.0, seed=0):
+        self.latency = latency
+        self.bandwidth = bandwidth
+        self.throttle_rate = throttle_rate
+        self._random = random.Random(seed)
+        self._lock = threading.Lock()
+
+    def throttled(self):
+        with self._lock:
+            return self._random.random() < self.throttle_rate
+
+
+class _Object:
+    def __init__(self, data):
+        self.data = bytes(data)
+        self.etag = hashlib.md5(self.data).hexdigest()
+        self.modified = time.time()
+
+
+def _http_date(t):
+    return email.utils.formatdate(t, usegmt=True)
+
+
+def _iso_date(t):
+    return time.strftime("%Y-%m-%dT%H:%M:%S.000Z", time.gmtime(t))
+
+
+class _Handler(http.server.BaseHTTPRequestHandler):
+    """Dispatches a request to the protocol of its server."""
+
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):  # pylint: disable=redefined-builtin
+        pass
+
+    @property
+    def store(self):
+        return self.server.store
+
+    def do_HEAD(self):
+        self._dispatch()
+
+    def do_GET(self):
+        self._dispatch()
+
+    def do_PUT(self):
+        self._dispatch()
+
+    def do_POST(self):
+        self._dispatch()
+
+    def do_DELETE(self):
+        self._dispatch()
+
+    def _dispatch(self):
+        url = urllib.parse.urlsplit(self.path)
+        self.query = dict(urllib.parse.parse_qsl(url.query, keep_blank_values=True))
+        self.key = urllib.parse.unquote(url.path).lstrip("/")
+        self.body = self._read_body()
+        if self.store.count(self.store.profile.throttled()):
+            self._throttle()
+            return
+        getattr(self, "_" + self.store.protocol)()
+
+    def _read_body(self):
+        if self.headers.get("Transfer-Encoding", "").lower() == "chunked":
+            body = b""
+            while True:
+                size = int(self.rfile.readline().split(b";")[0], 16)
+                if size == 0:
+                    self.rfile.readline()
+                    return body
+                body += self.rfile.read(size)
+                self.rfile.readline()
+        return self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+    def _send(self, status, body=b"", headers=None, content_length=None):
+        profile = self.store.profile
+        if profile.latency > 0:
+            time.sleep(profile.latency)
+        self.send_response(status)
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.send_header("x-amz-request-id", "mock")
+        self.send_header("x-ms-request-id", str(uuid.uuid4()))
+        self.send_header("x-ms-version", "2020-08-04")
+        self.send_header("Date", _http_date(time.time()))
+        self.send_header(
+            "Content-Length",
+            str(len(body) if content_length is None else content_length),
+        )
+        self.end_headers()
+        if self.command == "HEAD":
+            return
+        for i in range(0, len(body), _CHUNK_SIZE):
+            chunk = body[i : i + _CHUNK_SIZE]
+            self.wfile.write(chunk)
+            if profile.bandwidth > 0:
+                time.sleep(len(chunk) / profile.bandwidth)
+
+    def _send_xml(self, status, xml, headers=None):
+        headers = dict(headers or {})
+        headers["Content-Type"] = "application/xml"
+        body = ('<?xml version="1.0" encoding="UTF-8"?>' + xml).encode()
+        self._send(status, body, headers)
+
+    def _throttle(self):
+        if self.store.protocol == S3:
+            self._send_xml(
+                503,
+                "<Error><Code>SlowDown</Code>"
+                "<Message>Please reduce your request rate.</Message></Error>",
+            )
+        elif self.store.protocol == AZURE:
+            self._send_xml(
+                503,
+                "<Error><Code>ServerBusy</Code>"
+                "<Message>The server is busy.</Message></Error>",
+                {"x-ms-error-code": "ServerBusy"},
+            )
+        else:
+            self._send(503, headers={"Retry-After": "0"})
+
+    def _send_object(self, obj, headers, range_header):
+        """Sends `obj`, or the range of it that `range_header` asks for."""
+        size = len(obj.data)
+        match = _RANGE.match(self.headers.get(range_header, "") or "")
+        if match is None:
+            self._send(200, obj.data, headers, content_length=size)
+            return
+        start = int(match.group(1))
+        stop = min(int(match.group(2)) + 1 if match.group(2) else size, size)
+        if start >= size:
+            headers["Content-Range"] = f"bytes */{size}"
+            self._send_xml(
+                416,
+                "<Error><Code>InvalidRange</Code>"
+                "<Message>The requested range is not satisfiable</Message>"
+                "</Error>",
+                headers,
+            )
+            return
+        headers["Content-Range"] = f"bytes {start}-{stop - 1}/{size}"
+        self._send(206, obj.data[start:stop], headers)
+
+    def _s3(self):
+        bucket, _, key = self.key.partition("/")
+        path = bucket + "/" + key
+        if not key:
+            if self.command == "GET" and self.query.get("list-type") == "2":
+                self._s3_list(bucket)
+            elif self.command == "POST" and "delete" in self.query:
+                keys = re.findall(r"<Key>(.*?)</Key>", self.body.decode())
+                deleted = ""
+                for name in keys:
+                    self.store.delete(bucket + "/" + name)
+                    deleted += f"<Deleted><Key>{escape(name)}</Key></Deleted>"
+                self._send_xml(200, f"<DeleteResult>{deleted}</DeleteResult>")
+            else:
+                self._send(200)
+            return
+
+        if self.command == "POST" and "uploads" in self.query:
+            upload_id = self.store.create_upload(path)
+            self._send_xml(
+                200,
+                "<InitiateMultipartUploadResult>"
+                f"<Bucket>{escape(bucket)}</Bucket><Key>{escape(key)}</Key>"
+                f"<UploadId>{upload_id}</UploadId>"
+                "</InitiateMultipartUploadResult>",
+            )
+        elif self.command == "POST" and "uploadId" in self.query:
+            parts = [
+                int(number)
+                for number in re.findall(
+                    r"<PartNumber>(\d+)</PartNumber>", self.body.decode()
+                )
+            ]
+            obj = self.store.complete_upload(path, self.query["uploadId"], parts)
+            self._send_xml(
+                200,
+                "<CompleteMultipartUploadResult>"
+                f"<Bucket>{escape(bucket)}</Bucket><Key>{escape(key)}</Key>"
+                f'<ETag>"{obj.etag}"</ETag>'
+                "</CompleteMultipartUploadResult>",
+            )
+        elif self.command == "PUT" and "uploadId" in self.query:
+            data = self._s3_copy_source() or self.body
+            etag = self.store.put_part(
+                self.query["uploadId"], int(self.query["partNumber"]), data
+            )
+            if "x-amz-copy-source" in self.headers:
+                self._send_xml(
+                    200,
+                    f'<CopyPartResult><ETag>"{etag}"</ETag>'
+                    f"<LastModified>{_iso_date(time.time())}</LastModified>"
+                    "</CopyPartResult>",
+                )
+            else:
+                self._send(200, headers={"ETag": f'"{etag}"'})
+        elif self.command == "PUT":
+            if "x-amz-copy-source" in self.headers:
+                obj = self.store.put(path, self._s3_copy_source())
+                self._send_xml(
+                    200,
+                    f'<CopyObjectResult><ETag>"{obj.etag}"</ETag>'
+                    f"<LastModified>{_iso_date(obj.modified)}</LastModified>"
+                    "</CopyObjectResult>",
+                )
+            else:
+                obj = self.store.put(path, self.body)
+                self._send(200, headers={"ETag": f'"{obj.etag}"'})
+        elif self.command == "DELETE":
+            if "uploadId" in self.query:
+                self.store.abort_upload(self.query["uploadId"])
+            else:
+                self.store.delete(path)
+            self._send(204)
+        else:
+            obj = self.store.get(path)
+            if obj is None:
+                if self.command == "HEAD":
+                    self._send(404)
+                else:
+                    self._send_xml(
+                        404,
+                        "<Error><Code>NoSuchKey</Code>"
+                        "<Message>The specified key does not exist.</Message>"
+                        "</Error>",
+                    )
+                return
+            headers = {
+                "ETag": f'"{obj.etag}"',
+                "Last-Modified": _http_date(obj.modified),
+                "Content-Type": "application/octet-stream",
+                "Accept-Ranges": "bytes",
+            }
+            self._send_object(obj, headers, "Range")
+
+    def _s3_copy_source(self):
+        source = self.headers.get("x-amz-copy-source")
+        if source is None:
+            return None
+        obj = self.store.get(urllib.parse.unquote(source).lstrip("/"))
+        data = obj.data if obj is not None else b""
+        match = _RANGE.match(self.headers.get("x-amz-copy-source-range", ""))
+        if match is not None:
+            data = data[int(match.group(1)) : int(match.group(2)) + 1]
+        return data
+
+    def _s3_list(self, bucket):
+        prefix = self.query.get("prefix", "")
+        delimiter = self.query.get("delimiter", "")
+        max_keys = int(self.query.get("max-keys", 1000))
+        start_after = self.query.get("continuation-token", "")
+        keys, prefixes, truncated = self.store.list(
+            bucket + "/", prefix, delimiter, start_after, max_keys
+        )
+        contents = "".join(
+            f"<Contents><Key>{escape(name)}</Key>"
+            f"<LastModified>{_iso_date(obj.modified)}</LastModified>"
+            f'<ETag>"{obj.etag}"</ETag><Size>{len(obj.data)}</Size>'
+            "<StorageClass>STANDARD</StorageClass></Contents>"
+            for name, obj in keys
+        )
+        common = "".join(
+            f"<CommonPrefixes><Prefix>{escape(name)}</Prefix></CommonPrefixes>"
+            for name in prefixes
+        )
+        token = ""
+        if truncated:
+            last = max([name for name, _ in keys] + prefixes)
+            token = f"<NextContinuationToken>{escape(last)}</NextContinuationToken>"
+        self._send_xml(
+            200,
+            '<ListBucketResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">'
+            f"<Name>{escape(bucket)}</Name><Prefix>{escape(prefix)}</Prefix>"
+            f"<KeyCount>{len(keys) + len(prefixes)}</KeyCount>"
+            f"<MaxKeys>{max_keys}</MaxKeys>"
+            f"<IsTruncated>{'true' if truncated else 'false'}</IsTruncated>"
+            f"{contents}{common}{token}</ListBucketResult>",
+        )
+
+    def _az(self):
+        account, _, rest = self.key.partition("/")
+        container, _, blob = rest.partition("/")
+        path = account + "/" + container + "/" + blob
+        now = time.time()
+        if not blob:
+            if self.query.get("comp") == "list":
+                self._az_list(account, container)
+            else:
+                status = 201 if self.command == "PUT" else 200
+                self._send(
+                    status,
+                    headers={
+                        "ETag": '"0x8D000000000000"',
+                        "Last-Modified": _http_date(now),
+                    },
+                )
+            return
+
+        comp = self.query.get("comp")
+        if self.command == "PUT" and comp == "block":
+            self.store.put_block(path, self.query["blockid"], self.body)
+            self._send(201, headers={"x-ms-request-server-encrypted": "true"})
+        elif self.command == "PUT" and comp == "blocklist":
+            ids = re.findall(
+                r"<(?:Latest|Uncommitted|Committed)>(.*?)</", self.body.decode()
+            )
+            obj = self.store.commit_blocks(path, ids)
+            self._send(201, headers=self._az_write_headers(obj))
+        elif self.command == "PUT":
+            source = self.headers.get("x-ms-copy-source")
+            if source is not None:
+                source_path = urllib.parse.unquote(
+                    urllib.parse.urlsplit(source).path
+                ).lstrip("/")
+                obj = self.store.get(source_path)
+                obj = self.store.put(path, obj.data if obj is not None else b"")
+                headers = self._az_write_headers(obj)
+                headers["x-ms-copy-id"] = str(uuid.uuid4())
+                headers["x-ms-copy-status"] = "success"
+                self._send(202, headers=headers)
+            else:
+                obj = self.store.put(path, self.body)
+                self._send(201, headers=self._az_write_headers(obj))
+        elif self.command == "DELETE":
+            self.store.delete(path)
+            self._send(202)
+        else:
+            obj = self.store.get(path)
+            if obj is None:
+                self._send_xml(
+                    404,
+                    "<Error><Code>BlobNotFound</Code>"
+                    "<Message>The specified blob does not exist.</Message>"
+                    "</Error>",
+                    {"x-ms-error-code": "BlobNotFound"},
+                )
+                return
+            headers = {
+                "ETag": f'"0x{obj.etag[:16].upper()}"',
+                "Last-Modified": _http_date(obj.modified),
+                "x-ms-creation-time": _http_date(obj.modified),
+                "x-ms-blob-type": "BlockBlob",
+                "x-ms-lease-status": "unlocked",
+                "x-ms-lease-state": "available",
+                "x-ms-server-encrypted": "true",
+                "Content-Type": "application/octet-stream",
+                "Accept-Ranges": "bytes",
+            }
+            range_header = "x-ms-range" if "x-ms-range" in self.headers else "Range"
+            self._send_object(obj, headers, range_header)
+
+    def _az_write_headers(self, obj):
+        return {
+            "ETag": f'"0x{obj.etag[:16].upper()}"',
+            "Last-Modified": _http_date(obj.modified),
+            "Content-MD5": "",
+            "x-ms-request-server-encrypted": "true",
+        }
+
+    def _az_list(self, account, container):
+        prefix = self.query.get("prefix", "")
+        delimiter = self.query.get("delimiter", "")
+        max_results = int(self.query.get("maxresults", 5000))
+        marker = self.query.get("marker", "")
+        keys, prefixes, truncated = self.store.list(
+            account + "/" + container + "/", prefix, delimiter, marker, max_results
+        )
+        blobs = "".join(
+            f"<Blob><Name>{escape(name)}</Name><Properties>"
+            f"<Creation-Time>{_http_date(obj.modified)}</Creation-Time>"
+            f"<Last-Modified>{_http_date(obj.modified)}</Last-Modified>"
+            f"<Etag>0x{obj.etag[:16].upper()}</Etag>"
+            f"<Content-Length>{len(obj.data)}</Content-Length>"
+            "<Content-Type>application/octet-stream</Content-Type>"
+            "<BlobType>BlockBlob</BlobType><AccessTier>Hot</AccessTier>"
+            "<LeaseStatus>unlocked</LeaseStatus><LeaseState>available</LeaseState>"
+            "<ServerEncrypted>true</ServerEncrypted></Properties></Blob>"
+            for name, obj in keys
+        )
+        blobs += "".join(
+            f"<BlobPrefix><Name>{escape(name)}</Name></BlobPrefix>"
+            for name in prefixes
+        )
+        next_marker = ""
+        if truncated:
+            next_marker = escape(max([name for name, _ in keys] + prefixes))
+        self._send_xml(
+            200,
+            f'<EnumerationResults ServiceEndpoint="http://{self.headers["Host"]}'
+            f'/{escape(account)}/" ContainerName="{escape(container)}">'
+            f"<Prefix>{escape(prefix)}</Prefix>"
+            f"<MaxResults>{max_results}</MaxResults>"
+            f"<Delimiter>{escape(delimiter)}</Delimiter>"
+            f"<Blobs>{blobs}</Blobs><NextMarker>{next_marker}</NextMarker>"
+            "</EnumerationResults>",
+        )
+
+    def _http(self):
+        obj = self.store.get(self.key)
+        if obj is None or self.command not in ("GET", "HEAD"):
+            self._send(404 if obj is None else 405)
+            return
+        headers = {
+            "ETag": f'"{obj.etag}"',
+            "Last-Modified": _http_date(obj.modified),
+            "Content-Type": "application/octet-stream",
+            "Accept-Ranges": "bytes",
+        }
+        self._send_object(obj, headers, "Range")
+
+
+class MockObjectStore:
+    """Serves the S3, Azure Blob or HTTP protocol from memory on localhost.
+
+    Objects are addressed by the path of their URL without the leading
+    slash, "bucket/key" for S3, "account/container/blob" for Azure and the
+    path of the file for HTTP.
+
+    Args:
+      protocol: One of S3, AZURE or HTTP.
+      profile: The simulated network, a Profile.
+    """
+
+    def __init__(self, protocol, profile=None):
+        self.protocol = protocol
+        self.profile = profile or Profile()
+        self.requests = 0
+        self.throttled = 0
+        self._objects = {}
+        self._uploads = {}
+        self._blocks = {}
+        self._lock = threading.Lock()
+        self._server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), _Handler)
+        self._server.daemon_threads = True
+        self._server.store = self
+        self._thread = threading.Thread(target=self._server.serve_forever)
+        self._thread.daemon = True
+
+    @property
+    def endpoint(self):
+        return "http://127.0.0.1:%d" % self._server.server_address[1]
+
+    def start(self):
+        self._thread.start()
+        return self
+
+    def stop(self):
+        self._server.shutdown()
+        self._server.server_close()
+        self._thread.join()
+
+    def __enter__(self):
+        return self.start()
+
+    def __exit__(self, *args):
+        self.stop()
+
+    def count(self, throttled):
+        """Counts a request, and returns whether it is `throttled`."""
+        with self._lock:
+            self.requests += 1
+            self.throttled += int(throttled)
+        return throttled
+
+    def get(self, path):
+        with self._lock:
+            return self._objects.get(path)
+
+    def put(self, path, data):
+        obj = _Object(data)
+        with self._lock:
+            self._objects[path] = obj
+        return obj
+
+    def delete(self, path):
+        with self._lock:
+            self._objects.pop(path, None)
+
+    def list(self, root, prefix, delimiter, start_after, max_keys):
+        """Lists the keys under `root + prefix`, S3 and Azure style.
+
+        Returns the (key, object) pairs and the common prefixes after
+        `start_after`, at most `max_keys` of them in total, and whether the
+        listing is truncated. Keys are relative to `root`.
+        """
+        with self._lock:
+            names = sorted(
+                name[len(root) :]
+                for name in self._objects
+                if name.startswith(root + prefix)
+            )
+            objects = {name: self._objects[root + name] for name in names}
+        keys, prefixes = [], []
+        for name in names:
+            if name <= start_after:
+                continue
+            if delimiter:
+                index = name.find(delimiter, len(prefix))
+                if index >= 0:
+                    common = name[: index + len(delimiter)]
+                    if common <= start_after:
+                        continue
+                    if common not in prefixes:
+                        if len(keys) + len(prefixes) == max_keys:
+                            return keys, prefixes, True
+                        prefixes.append(common)
+                    continue
+            if len(keys) + len(prefixes) == max_keys:
+                return keys, prefixes, True
+            keys.append((name, objects[name]))
+        return keys, prefixes, False
+
+    def create_upload(self, path):
+        upload_id = uuid.uuid4().hex
+        with self._lock:
+            self._uploads[upload_id] = (path, {})
+        return upload_id
+
+    def put_part(self, upload_id, number, data):
+        with self._lock:
+            self._uploads[upload_id][1][number] = bytes(data)
+        return hashlib.md5(data).hexdigest()
+
+    def complete_upload(self, path, upload_id, numbers):
+        with self._lock:
+            _, parts = self._uploads.pop(upload_id)
+        return self.put(path, b"".join(parts[number] for number in numbers))
+
+    def abort_upload(self, upload_id):
+        with self._lock:
+            self._uploads.pop(upload_id, None)
+
+    def put_block(self, path, block_id, data):
+        with self._lock:
+            self._blocks.setdefault(path, {})[block_id] = bytes(data)
+
+    def commit_blocks(self, path, block_ids):
+        with self._lock:
+            blocks = self._blocks.pop(path, {})
+        return self.put(path, b"".join(blocks[block_id] for block_id in block_ids))
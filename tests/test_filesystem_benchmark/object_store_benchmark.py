@@ -0,0 +1,317 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Command line tool to benchmark the s3://, az:// and http:// file systems.
+
+Each plugin is run against a MockObjectStore that injects latency, limits
+bandwidth and throttles requests, so that the effect of the read cache,
+read-ahead and parallel transfers of a plugin can be measured without a
+real object store:
+
+  python -m tests.test_filesystem_benchmark.object_store_benchmark \
+      --protocols s3,az --latency 0.02 --bandwidth 100e6 --output result.json
+
+The plugins read their configuration from the environment once, so every
+configuration of a plugin runs in a fresh subprocess. The result is a JSON
+list of one entry per protocol, configuration and workload, with the
+elapsed seconds, bytes per second, operations per second and the requests
+the store received.
+"""
+
+import argparse
+import json
+import logging
+import os
+import random
+import subprocess
+import sys
+import time
+
+from tests.test_filesystem_benchmark import mock_object_store
+
+# The environment of each configuration of each plugin, on top of the
+# environment that points the plugin to the store.
+CONFIGURATIONS = {
+    mock_object_store.S3: {
+        "default": {},
+        "no_cache": {"S3_READ_CACHE_MAX_SIZE_MB": "0"},
+        "executor_4": {"S3_EXECUTOR_POOL_SIZE": "4"},
+        "executor_64": {"S3_EXECUTOR_POOL_SIZE": "64"},
+        "read_ahead": {"S3_READ_AHEAD_WINDOWS": "4"},
+    },
+    mock_object_store.AZURE: {
+        "default": {},
+        "no_cache": {"TF_AZURE_READ_CACHE_MAX_SIZE_MB": "0"},
+    },
+    mock_object_store.HTTP: {
+        "default": {},
+        "no_read_ahead": {"HTTP_READ_AHEAD_SIZE": "0"},
+    },
+}
+
+WRITE = "write"
+SEQUENTIAL_READ = "sequential_read"
+RANDOM_READ = "random_read"
+SMALL_READ = "small_read"
+LIST = "list"
+
+# The http:// file system is read only.
+WORKLOADS = {
+    mock_object_store.S3: [WRITE, SEQUENTIAL_READ, RANDOM_READ, SMALL_READ, LIST],
+    mock_object_store.AZURE: [
+        WRITE,
+        SEQUENTIAL_READ,
+        RANDOM_READ,
+        SMALL_READ,
+        LIST,
+    ],
+    mock_object_store.HTTP: [SEQUENTIAL_READ, RANDOM_READ, SMALL_READ],
+}
+
+_MODULE = "tests.test_filesystem_benchmark.object_store_benchmark"
+_ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+_BUCKET = "benchmark"
+_ACCOUNT = "devstoreaccount1"
+
+
+def plugin_environment(protocol, endpoint):
+    """Returns the environment that points the plugin of `protocol` to a
+    store at `endpoint`."""
+    if protocol == mock_object_store.S3:
+        return {
+            "S3_ENDPOINT": endpoint,
+            "S3_VERIFY_SSL": "0",
+            "AWS_REGION": "us-east-1",
+            "AWS_ACCESS_KEY_ID": "ACCESS_KEY",
+            "AWS_SECRET_ACCESS_KEY": "SECRET_KEY",
+            "AWS_EC2_METADATA_DISABLED": "true",
+        }
+    if protocol == mock_object_store.AZURE:
+        return {
+            "TF_AZURE_STORAGE_USE_HTTP": "1",
+            "TF_AZURE_STORAGE_BLOB_ENDPOINT": endpoint + "/" + _ACCOUNT,
+        }
+    return {}
+
+
+def object_root(protocol, endpoint):
+    """Returns the URL of the directory of the benchmark objects."""
+    if protocol == mock_object_store.S3:
+        return f"s3://{_BUCKET}/data"
+    if protocol == mock_object_store.AZURE:
+        return f"az://{_ACCOUNT}/{_BUCKET}/data"
+    return f"{endpoint}/{_BUCKET}/data"
+
+
+def store_path(protocol, name):
+    """Returns the path of object `name` of the benchmark in the store."""
+    if protocol == mock_object_store.AZURE:
+        return f"{_ACCOUNT}/{_BUCKET}/data/{name}"
+    return f"{_BUCKET}/data/{name}"
+
+
+def run_workload(workload, root, args):
+    """Runs `workload` on the objects under `root` with tf.io.gfile.
+
+    Returns the bytes transferred and the operations performed.
+    """
+    import tensorflow as tf
+    import tensorflow_io as tfio  # pylint: disable=unused-import
+
+    path = root + "/object"
+    if workload == WRITE:
+        data = os.urandom(args.write_size)
+        total = 0
+        for i in range(args.files):
+            with tf.io.gfile.GFile(f"{root}/written_{i}", "wb") as f:
+                for offset in range(0, len(data), args.chunk_size):
+                    f.write(data[offset : offset + args.chunk_size])
+                f.flush()
+            total += len(data)
+        return total, args.files
+    if workload == SEQUENTIAL_READ:
+        total = 0
+        with tf.io.gfile.GFile(path, "rb") as f:
+            while True:
+                chunk = f.read(args.chunk_size)
+                if not chunk:
+                    break
+                total += len(chunk)
+        return total, 1
+    if workload in (RANDOM_READ, SMALL_READ):
+        size = args.random_read_size if workload == RANDOM_READ else 4096
+        rng = random.Random(args.seed)
+        total = 0
+        with tf.io.gfile.GFile(path, "rb") as f:
+            for _ in range(args.reads):
+                f.seek(rng.randrange(0, max(args.object_size - size, 1)))
+                total += len(f.read(size))
+        return total, args.reads
+    if workload == LIST:
+        for _ in range(args.reads):
+            tf.io.gfile.listdir(root + "/listed")
+        return 0, args.reads
+    raise ValueError(f"unknown workload: {workload}")
+
+
+def run_configuration(protocol, configuration, args):
+    """Benchmarks `configuration` of the plugin of `protocol` in a fresh
+    subprocess against a new store, and returns its results."""
+    profile = mock_object_store.Profile(
+        latency=args.latency,
+        bandwidth=args.bandwidth,
+        throttle_rate=args.throttle_rate,
+        seed=args.seed,
+    )
+    results = []
+    with mock_object_store.MockObjectStore(protocol, profile) as store:
+        data = os.urandom(args.object_size)
+        store.put(store_path(protocol, "object"), data)
+        for i in range(args.list_size):
+            store.put(store_path(protocol, f"listed/{i:06d}"), b"x")
+        env = dict(os.environ)
+        env.update(plugin_environment(protocol, store.endpoint))
+        env.update(CONFIGURATIONS[protocol][configuration])
+        for workload in WORKLOADS[protocol]:
+            if workload not in args.workloads:
+                continue
+            requests, throttled = store.requests, store.throttled
+            command = [
+                sys.executable,
+                "-m",
+                _MODULE,
+                "--workload",
+                workload,
+                "--root",
+                object_root(protocol, store.endpoint),
+            ] + _sizes(args)
+            output = subprocess.run(
+                command,
+                env=env,
+                cwd=_ROOT,
+                check=True,
+                capture_output=True,
+                text=True,
+            ).stdout
+            result = json.loads(output.strip().splitlines()[-1])
+            result.update(
+                {
+                    "protocol": protocol,
+                    "configuration": configuration,
+                    "workload": workload,
+                    "requests": store.requests - requests,
+                    "throttled": store.throttled - throttled,
+                }
+            )
+            logging.info("%s", result)
+            results.append(result)
+    return results
+
+
+def _sizes(args):
+    return [
+        "--object-size",
+        str(args.object_size),
+        "--write-size",
+        str(args.write_size),
+        "--chunk-size",
+        str(args.chunk_size),
+        "--random-read-size",
+        str(args.random_read_size),
+        "--reads",
+        str(args.reads),
+        "--files",
+        str(args.files),
+        "--seed",
+        str(args.seed),
+    ]
+
+
+def run(args):
+    """Runs all the requested protocols and configurations."""
+    results = []
+    for protocol in args.protocols:
+        configurations = args.configurations or list(CONFIGURATIONS[protocol])
+        for configuration in configurations:
+            if configuration in CONFIGURATIONS[protocol]:
+                results += run_configuration(protocol, configuration, args)
+    return results
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--protocols",
+        type=lambda s: s.split(","),
+        default=list(CONFIGURATIONS),
+        help="Comma separated protocols among s3, az and http.",
+    )
+    parser.add_argument(
+        "--configurations",
+        type=lambda s: s.split(","),
+        default=None,
+        help="Comma separated configurations, all of them by default.",
+    )
+    parser.add_argument(
+        "--workloads",
+        type=lambda s: s.split(","),
+        default=[WRITE, SEQUENTIAL_READ, RANDOM_READ, SMALL_READ, LIST],
+        help="Comma separated workloads.",
+    )
+    parser.add_argument("--latency", type=float, default=0.02)
+    parser.add_argument("--bandwidth", type=float, default=0)
+    parser.add_argument("--throttle-rate", type=float, default=0.0)
+    parser.add_argument("--object-size", type=int, default=64 << 20)
+    parser.add_argument("--write-size", type=int, default=16 << 20)
+    parser.add_argument("--chunk-size", type=int, default=1 << 20)
+    parser.add_argument("--random-read-size", type=int, default=64 << 10)
+    parser.add_argument("--reads", type=int, default=100)
+    parser.add_argument("--files", type=int, default=4)
+    parser.add_argument("--list-size", type=int, default=2500)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--output", default=None, help="The JSON result file.")
+    # Set in the subprocess of a workload.
+    parser.add_argument("--workload", default=None, help=argparse.SUPPRESS)
+    parser.add_argument("--root", default=None, help=argparse.SUPPRESS)
+    return parser.parse_args(argv)
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    if args.workload is not None:
+        start = time.perf_counter()
+        total, operations = run_workload(args.workload, args.root, args)
+        elapsed = time.perf_counter() - start
+        print(
+            json.dumps(
+                {
+                    "seconds": elapsed,
+                    "bytes": total,
+                    "bytes_per_second": total / elapsed,
+                    "operations_per_second": operations / elapsed,
+                }
+            )
+        )
+        return
+    logging.basicConfig(level=logging.INFO)
+    results = run(args)
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        print(json.dumps(results, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Tests for the object store benchmark of the file system plugins"""
+
+import sys
+import urllib.error
+import urllib.request
+
+import pytest
+
+from tests.test_filesystem_benchmark import mock_object_store
+from tests.test_filesystem_benchmark import object_store_benchmark
+
+
+def test_mock_object_store_range():
+    """Test case for the ranged reads and throttling of the mock store"""
+    profile = mock_object_store.Profile(throttle_rate=0.5, seed=1)
+    with mock_object_store.MockObjectStore(mock_object_store.HTTP, profile) as store:
+        store.put("bucket/object", b"0123456789")
+        statuses = []
+        for _ in range(8):
+            request = urllib.request.Request(
+                store.endpoint + "/bucket/object", headers={"Range": "bytes=2-5"}
+            )
+            try:
+                with urllib.request.urlopen(request) as response:
+                    assert response.read() == b"2345"
+                    assert response.headers["Content-Range"] == "bytes 2-5/10"
+                    statuses.append(response.status)
+            except urllib.error.HTTPError as e:
+                statuses.append(e.code)
+        assert set(statuses) == {206, 503}
+        assert store.requests == 8
+        assert store.throttled == statuses.count(503)
+
+
+def test_mock_object_store_list():
+    """Test case for the paginated listing of the mock store"""
+    store = mock_object_store.MockObjectStore(mock_object_store.S3)
+    for name in ["a/1", "a/2", "b/1", "c"]:
+        store.put("bucket/" + name, b"x")
+    keys, prefixes, truncated = store.list("bucket/", "", "/", "", 2)
+    assert (keys, prefixes, truncated) == ([], ["a/", "b/"], True)
+    keys, prefixes, truncated = store.list("bucket/", "", "/", "b/", 2)
+    assert [name for name, _ in keys] == ["c"]
+    assert (prefixes, truncated) == ([], False)
+
+
+@pytest.mark.skipif(
+    sys.platform in ("win32", "darwin"),
+    reason="TODO file system plugins not tested on macOS/Windows yet",
+)
+@pytest.mark.parametrize(
+    "protocol",
+    [mock_object_store.S3, mock_object_store.AZURE, mock_object_store.HTTP],
+)
+def test_object_store_benchmark(protocol):
+    """Test case for a small run of the benchmark of each plugin"""
+    args = object_store_benchmark.parse_args(
+        [
+            "--protocols",
+            protocol,
+            "--configurations",
+            "default",
+            "--latency",
+            "0.001",
+            "--throttle-rate",
+            "0.05",
+            "--object-size",
+            str(1 << 20),
+            "--write-size",
+            str(256 << 10),
+            "--chunk-size",
+            str(64 << 10),
+            "--reads",
+            "8",
+            "--files",
+            "2",
+            "--list-size",
+            "1200",
+        ]
+    )
+    results = object_store_benchmark.run(args)
+    workloads = object_store_benchmark.WORKLOADS[protocol]
+    assert [result["workload"] for result in results] == workloads
+    for result in results:
+        assert result["requests"] > 0
+        assert result["operations_per_second"] > 0
+        if result["workload"] == object_store_benchmark.SEQUENTIAL_READ:
+            assert result["bytes"] == 1 << 20
@@ -0,0 +1,277 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Command line tool to benchmark the throughput of the format readables.
+
+Synthetic files of `--rows` rows of `--columns` columns, alternately int64
+and float64, are generated in each format, then every column is read
+through the readable of the format, either at once ("full") or in windows
+of `--window` rows ("sliced"):
+
+  python -m tests.test_format_benchmark.format_benchmark \
+      --formats parquet,orc,csv --rows 1000000 --columns 8 --output result.json
+
+The result is a JSON list of one entry per format and mode, with the file
+size, the best and median seconds of `--rounds` rounds, and the rows and
+bytes per second of the best round.
+"""
+
+import argparse
+import json
+import logging
+import os
+import statistics
+import tempfile
+import time
+import uuid
+
+import numpy as np
+
+PARQUET = "parquet"
+ORC = "orc"
+CSV = "csv"
+JSON = "json"
+FEATHER = "feather"
+AVRO = "avro"
+HDF5 = "hdf5"
+
+FORMATS = [PARQUET, ORC, CSV, JSON, FEATHER, AVRO, HDF5]
+
+FULL = "full"
+SLICED = "sliced"
+
+
+def generate_columns(rows, columns, seed):
+    """Returns `columns` synthetic columns of `rows` rows, by name."""
+    rng = np.random.default_rng(seed)
+    data = {}
+    for i in range(columns):
+        if i % 2 == 0:
+            data[f"c{i}"] = rng.integers(-(1 << 40), 1 << 40, rows, dtype=np.int64)
+        else:
+            data[f"c{i}"] = rng.standard_normal(rows)
+    return data
+
+
+def write_file(fmt, filename, data):
+    """Writes the columns of `data` to `filename` in format `fmt`."""
+    if fmt in (PARQUET, ORC, FEATHER):
+        import pyarrow as pa
+
+        table = pa.table(data)
+        if fmt == PARQUET:
+            import pyarrow.parquet as pq
+
+            pq.write_table(table, filename)
+        elif fmt == ORC:
+            import pyarrow.orc as orc
+
+            orc.write_table(table, filename)
+        else:
+            import pyarrow.feather as feather
+
+            feather.write_feather(table, filename, version=1)
+    elif fmt == CSV:
+        import pandas as pd
+
+        pd.DataFrame(data).to_csv(filename, index=False)
+    elif fmt == JSON:
+        import pandas as pd
+
+        pd.DataFrame(data).to_json(filename, orient="records", lines=True)
+    elif fmt == AVRO:
+        from avro.datafile import DataFileWriter
+        from avro.io import DatumWriter
+        from avro.schema import parse
+
+        schema = parse(avro_schema(data))
+        names = list(data)
+        with open(filename, "wb") as f:
+            writer = DataFileWriter(f, DatumWriter(), schema)
+            for row in zip(*(data[name].tolist() for name in names)):
+                writer.append(dict(zip(names, row)))
+            writer.close()
+    elif fmt == HDF5:
+        import h5py
+
+        with h5py.File(filename, "w") as f:
+            for name, values in data.items():
+                f.create_dataset(name, data=values)
+    else:
+        raise ValueError(f"unknown format: {fmt}")
+
+
+def avro_schema(data):
+    """Returns the Avro schema of a record of the columns of `data`."""
+    fields = [
+        {
+            "name": name,
+            "type": "long" if values.dtype == np.int64 else "double",
+        }
+        for name, values in data.items()
+    ]
+    return json.dumps({"type": "record", "name": "row", "fields": fields})
+
+
+def open_columns(fmt, filename, data):
+    """Opens `filename` with the readable of `fmt`.
+
+    Returns a function of each column, by name, that reads the rows
+    [start, stop) of the column through the readable.
+    """
+    import tensorflow as tf
+    import tensorflow_io as tfio
+
+    if fmt == ORC:
+        from tensorflow_io.python.ops import core_ops
+
+        resource, _ = core_ops.io_orc_readable_init(
+            filename,
+            metadata=[],
+            container="ORCBenchmark",
+            shared_name=f"{filename}/{uuid.uuid4().hex}",
+        )
+        functions = {}
+        for name in data:
+            shape, dtype = core_ops.io_orc_readable_spec(resource, name)
+            shape = tf.TensorShape([None]).concatenate(shape.numpy()[1:])
+            dtype = tf.as_dtype(dtype.numpy())
+            functions[name] = (
+                lambda start, stop, name=name, shape=shape, dtype=dtype: (
+                    core_ops.io_orc_readable_read(
+                        resource,
+                        start=start,
+                        stop=stop,
+                        component=name,
+                        shape=shape,
+                        dtype=dtype,
+                    )
+                )
+            )
+        return functions
+
+    if fmt == PARQUET:
+        tensor = tfio.IOTensor.from_parquet(filename)
+    elif fmt == CSV:
+        tensor = tfio.IOTensor.from_csv(filename)
+    elif fmt == JSON:
+        tensor = tfio.IOTensor.from_json(filename)
+    elif fmt == FEATHER:
+        tensor = tfio.IOTensor.from_feather(filename)
+    elif fmt == AVRO:
+        tensor = tfio.IOTensor.from_avro(filename, avro_schema(data))
+    elif fmt == HDF5:
+        tensor = tfio.IOTensor.from_hdf5(filename)
+    else:
+        raise ValueError(f"unknown format: {fmt}")
+    key = (lambda name: "/" + name) if fmt == HDF5 else (lambda name: name)
+    return {
+        name: lambda start, stop, column=tensor(key(name)): column[start:stop]
+        for name in data
+    }
+
+
+def read_columns(functions, rows, mode, window):
+    """Reads all the rows of all the columns, and returns the rows read."""
+    step = rows if mode == FULL else window
+    read = 0
+    for function in functions.values():
+        for start in range(0, rows, step):
+            # A read of one row of an IOTensor is squeezed to a scalar.
+            value = function(start, min(start + step, rows)).numpy()
+            read += np.atleast_1d(value).shape[0]
+    return read // len(functions)
+
+
+def run_format(fmt, directory, args):
+    """Generates the file of `fmt` in `directory` and benchmarks it."""
+    data = generate_columns(args.rows, args.columns, args.seed)
+    filename = os.path.join(directory, f"benchmark.{fmt}")
+    write_file(fmt, filename, data)
+    size = os.path.getsize(filename)
+    results = []
+    for mode in args.modes:
+        seconds = []
+        for _ in range(args.rounds):
+            start = time.perf_counter()
+            # The readable is opened in every round, so that its setup,
+            # which is where some formats load the file, is measured too.
+            functions = open_columns(fmt, filename, data)
+            rows = read_columns(functions, args.rows, mode, args.window)
+            seconds.append(time.perf_counter() - start)
+            if rows != args.rows:
+                raise ValueError(f"{fmt} read {rows} rows of {args.rows}")
+        best = min(seconds)
+        result = {
+            "format": fmt,
+            "mode": mode,
+            "rows": args.rows,
+            "columns": args.columns,
+            "window": args.window if mode == SLICED else args.rows,
+            "file_bytes": size,
+            "seconds": best,
+            "median_seconds": statistics.median(seconds),
+            "rows_per_second": args.rows / best,
+            "bytes_per_second": size / best,
+        }
+        logging.info("%s", result)
+        results.append(result)
+    return results
+
+
+def run(args):
+    """Runs all the requested formats."""
+    results = []
+    with tempfile.TemporaryDirectory() as directory:
+        for fmt in args.formats:
+            results += run_format(fmt, directory, args)
+    return results
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--formats",
+        type=lambda s: s.split(","),
+        default=FORMATS,
+        help="Comma separated formats among " + ", ".join(FORMATS) + ".",
+    )
+    parser.add_argument(
+        "--modes",
+        type=lambda s: s.split(","),
+        default=[FULL, SLICED],
+        help="Comma separated modes among full and sliced.",
+    )
+    parser.add_argument("--rows", type=int, default=1 << 20)
+    parser.add_argument("--columns", type=int, default=8)
+    parser.add_argument("--window", type=int, default=1 << 14)
+    parser.add_argument("--rounds", type=int, default=3)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--output", default=None, help="The JSON result file.")
+    return parser.parse_args(argv)
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    logging.basicConfig(level=logging.INFO)
+    results = run(args)
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        print(json.dumps(results, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,47 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Tests for the throughput benchmark of the format readables"""
+
+import pytest
+
+from tests.test_format_benchmark import format_benchmark
+
+
+@pytest.mark.parametrize("fmt", format_benchmark.FORMATS)
+def test_format_benchmark(fmt):
+    """Test case for a small run of the benchmark of each format"""
+    args = format_benchmark.parse_args(
+        [
+            "--formats",
+            fmt,
+            "--rows",
+            "1001",
+            "--columns",
+            "3",
+            "--window",
+            "100",
+            "--rounds",
+            "1",
+        ]
+    )
+    results = format_benchmark.run(args)
+    assert [result["mode"] for result in results] == [
+        format_benchmark.FULL,
+        format_benchmark.SLICED,
+    ]
+    for result in results:
+        assert result["format"] == fmt
+        assert result["file_bytes"] > 0
+        assert result["rows_per_second"] > 0
@@ -16,6 +16,8 @@
 
 
 import os
+import struct
+import zlib
 import numpy as np
 import pytest
 
@@ -27,7 +29,6 @@ fastq_path = os.path.join(
 )
 
 
-@pytest.mark.skip(reason="TODO")
 def test_genome_fastq_reader():
     """test_genome_fastq_reader"""
 
@@ -51,6 +52,66 @@ def test_genome_fastq_reader():
     assert np.all(data.raw_quality == quality_expected)
 
 
+def _bgzf(data, block_size):
+    """Compresses data into BGZF blocks of block_size bytes"""
+    blocks = []
+    for i in range(0, len(data), block_size):
+        chunk = data[i : i + block_size]
+        compressor = zlib.compressobj(6, zlib.DEFLATED, -15)
+        payload = compressor.compress(chunk) + compressor.flush()
+        header = b"\x1f\x8b\x08\x04\x00\x00\x00\x00\x00\xff"
+        header += struct.pack("<H2sHH", 6, b"BC", 2, len(payload) + 25)
+        trailer = struct.pack("<II", zlib.crc32(chunk), len(chunk))
+        blocks.append(header + payload + trailer)
+    return b"".join(blocks)
+
+
+@pytest.mark.parametrize("compressed", [False, True])
+def test_genome_fastq_dataset(tmp_path, compressed):
+    """test_genome_fastq_dataset"""
+    records = []
+    for i in range(1000):
+        sequence = "ACGTN"[i % 5] * (i % 13) + "GATTACA"[: i % 8]
+        quality = "".join(chr(33 + (i + j) % 41) for j in range(len(sequence)))
+        records.append((sequence, quality))
+    data = "".join(f"@read{i} @\n{s}\n+\n{q}\n" for i, (s, q) in enumerate(records))
+    data = data.encode()
+    filename = str(tmp_path / "data.fastq")
+    with open(filename, "wb") as f:
+        f.write(_bgzf(data, 1000) if compressed else data)
+
+    dataset = tfio.IODataset.from_fastq(filename, batch_size=64)
+    batches = list(dataset)
+    assert [len(s) for s, _ in batches] == [64] * 15 + [40]
+    assert [
+        (s.decode(), q.decode()) for s, q in dataset.unbatch().as_numpy_iterator()
+    ] == records
+
+    size = os.path.getsize(filename)
+    shards = []
+    for offset in range(0, size, 1234):
+        shards.extend(
+            tfio.IODataset.from_fastq(
+                filename, offset=offset, length=1234, block_size=100
+            ).as_numpy_iterator()
+        )
+    assert [(s.decode(), q.decode()) for s, q in shards] == records
+
+    encoding = {"A": 0, "C": 1, "G": 2, "T": 3}
+    packed = tfio.IODataset.from_fastq(filename, batch_size=100, packed=True)
+    bases, qualities = [], []
+    for b, q in packed:
+        bases.extend(b.to_list())
+        qualities.extend(q.to_list())
+    for (sequence, quality), b, q in zip(records, bases, qualities):
+        assert len(b) == (len(sequence) + 3) // 4
+        assert len(q) == len(sequence)
+        for j, base in enumerate(sequence):
+            code = (b[j // 4] >> (6 - 2 * (j % 4))) & 3
+            assert code == encoding.get(base, 0)
+            assert q[j] == (ord(quality[j]) - 33 if base in encoding else 0)
+
+
 @pytest.mark.skip(reason="TODO")
 def test_genome_sequences_to_onehot():
     """test sequence one hot encoder"""
@@ -178,5 +178,69 @@ def test_hdf5_bool():
     shutil.rmtree(runpath)
 
 
+def test_hdf5_chunk_cache():
+    """test_hdf5_chunk_cache"""
+    runpath = tempfile.mkdtemp()
+    filename = f"{runpath}/chunked.h5"
+
+    data = np.random.random((1000, 16))
+    with h5py.File(filename, "w") as h5_obj:
+        h5_obj.create_dataset("chunked", data=data, chunks=(100, 16))
+
+    # A file:// url is read through the RandomAccessFile driver.
+    for path in [filename, "file://" + filename]:
+        for cache_dataset in [True, False]:
+            hdf5 = tfio.IOTensor.from_hdf5(
+                path,
+                cache_dataset=cache_dataset,
+                chunk_cache_bytes=4 * 1024 * 1024,
+                chunk_cache_slots=521,
+                chunk_cache_preemption=1.0,
+            )
+            assert np.array_equal(hdf5("/chunked").to_tensor(), data)
+            assert np.array_equal(hdf5("/chunked")[150:420], data[150:420])
+            assert np.array_equal(hdf5("/chunked")[990:], data[990:])
+
+        dataset = tfio.IODataset.from_hdf5(
+            path, "/chunked", chunk_cache_bytes=1024 * 1024
+        )
+        assert np.array_equal(np.stack([e.numpy() for e in dataset]), data)
+
+    shutil.rmtree(runpath)
+
+
+@pytest.mark.parametrize("gpu_compatible", [False, True])
+def test_hdf5_gpu_compatible(gpu_compatible):
+    """test_hdf5_gpu_compatible"""
+    runpath = tempfile.mkdtemp()
+    filename = f"{runpath}/data.h5"
+
+    data = np.random.random((1000, 16))
+    with h5py.File(filename, "w") as h5_obj:
+        h5_obj.create_dataset("data", data=data)
+
+    hdf5 = tfio.IOTensor.from_hdf5(filename, gpu_compatible=gpu_compatible)
+    assert np.array_equal(hdf5("/data").to_tensor(), data)
+    assert np.array_equal(hdf5("/data")[150:420], data[150:420])
+    graph = tf.function(lambda: hdf5("/data")[150:420]).get_concrete_function().graph
+    reads = [op for op in graph.get_operations() if op.type == "IO>HDF5ReadableRead"]
+    assert [op.get_attr("gpu_compatible") for op in reads] == [gpu_compatible]
+
+    dataset = tfio.IODataset.from_hdf5(filename, "/data", gpu_compatible=gpu_compatible)
+    assert np.array_equal(np.stack([e.numpy() for e in dataset]), data)
+    graph_def = tf.compat.v1.GraphDef.FromString(
+        dataset._as_serialized_graph().numpy()  # pylint: disable=protected-access
+    )
+    reads = [
+        node
+        for function in graph_def.library.function
+        for node in function.node_def
+        if node.op == "IO>HDF5ReadableRead"
+    ]
+    assert [node.attr["gpu_compatible"].b for node in reads] == [gpu_compatible]
+
+    shutil.rmtree(runpath)
+
+
 if __name__ == "__main__":
     test.main()
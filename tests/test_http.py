@@ -106,6 +106,17 @@ def test_gfile_tell(local_content, remote_filename):
     assert remote_gfile.tell() == 100
 
 
+@pytest.mark.skipif(sys.platform == "darwin", reason="macOS fails now")
+def test_gfile_size_after_read(local_content, remote_filename):
+    """Test case for the size of an http file learned from a ranged read"""
+
+    remote_gfile = tf.io.gfile.GFile(remote_filename, "rb")
+    remote_gfile.read(100)
+    size = len(local_content.encode())
+    assert remote_gfile.size() == size
+    assert tf.io.gfile.stat(remote_filename).length == size
+
+
 @pytest.mark.skipif(
     sys.platform in ("darwin", "win32"), reason="macOS/Windows fails now"
 )
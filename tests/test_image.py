@@ -16,6 +16,7 @@
 
 import os
 import numpy as np
+import pytest
 
 import tensorflow as tf
 import tensorflow_io as tfio
@@ -80,6 +81,41 @@ def test_decode_webp():
 
     assert np.all(webp_v == png)
 
+    webp_v = tfio.image.decode_webp(webp_contents, crop=[100, 50, 120, 200])
+    assert webp_v.shape == (120, 200, channel)
+    assert np.all(webp_v == png[100:220, 50:250])
+
+    webp_v = tfio.image.decode_webp(
+        webp_contents, size=[224, 224], crop=[100, 50, 120, 200]
+    )
+    assert webp_v.shape == (224, 224, channel)
+
+
+def test_decode_image_batch():
+    """Test case for decode_image_batch."""
+    contents = []
+    for filename in ["sample.png", "sample.webp", "kodim03_yuv420_8bpc.avif"]:
+        with open(
+            os.path.join(
+                os.path.dirname(os.path.abspath(__file__)), "test_image", filename
+            ),
+            "rb",
+        ) as f:
+            contents.append(f.read())
+    png = tf.image.decode_png(contents[0], channels=4)
+
+    images = tfio.experimental.image.decode_image_batch(
+        contents, size=[301, 400], channels=4
+    )
+    assert images.shape == (3, 301, 400, 4)
+    assert np.all(images[0] == png)
+
+    images = tfio.experimental.image.decode_image_batch(contents, size=[224, 224])
+    assert images.shape == (3, 224, 224, 3)
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_image_batch([b"invalid"], size=[224, 224])
+
 
 def test_tiff_file_dataset():
     """Test case for TIFFDataset."""
@@ -189,6 +225,39 @@ def test_decode_ppm():
     assert np.all(pgm.numpy() == png.numpy())
 
 
+@pytest.mark.parametrize(
+    ("filename", "decode"),
+    [
+        (
+            "r-1316653631.481244-81973200.ppm",
+            tfio.experimental.image.decode_pnm,
+        ),
+        (
+            "d-1316653631.269651-68451027.pgm",
+            lambda e: tfio.experimental.image.decode_pnm(e, dtype=tf.uint16),
+        ),
+        ("lena.bmp", tf.image.decode_bmp),
+        ("glacier.hdr", tfio.experimental.image.decode_hdr),
+    ],
+)
+def test_raster_io_tensor(filename, decode):
+    """Test case for reading rows of PNM, BMP and HDR files."""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_image", filename
+    )
+    expected = decode(tf.io.read_file(filename))
+
+    raster = tfio.experimental.IOTensor.from_raster(filename)
+    assert raster.shape == expected.shape
+    assert raster.dtype == expected.dtype
+    assert np.all(raster.to_tensor().numpy() == expected.numpy())
+
+    # Bands of rows, read out of order.
+    height = expected.shape[0]
+    for start in [height // 2, 0, height - 3]:
+        stop = min(start + 7, height)
+        assert np.all(raster[start:stop].numpy() == expected[start:stop].numpy())
+
 def test_encode_bmp():
     """Test case for encode_bmp."""
     width = 51
@@ -273,6 +342,19 @@ def test_openexr_io_tensor():
     assert np.all(g == exr_0_g)
     assert np.all(r == exr_0_r)
 
+    exr_0_rb = tfio.experimental.image.decode_exr(
+        tf.io.read_file(filename),
+        0,
+        ["R", "B"],
+        tf.float16,
+        start=100,
+        count=50,
+        threads=4,
+    )
+    assert exr_0_rb.shape == [50, 2048, 2]
+    assert np.all(exr_0_rb[:, :, 0] == exr_0_r[100:150])
+    assert np.all(exr_0_rb[:, :, 1] == exr_0_b[100:150])
+
 
 def test_decode_hdr():
     """Test case for decode_hdr"""
@@ -352,6 +434,35 @@ def test_decode_yuy2():
     assert np.all(rgb == png)
 
 
+@pytest.mark.parametrize(
+    ("fmt", "decode"),
+    [
+        ("nv12", tfio.experimental.image.decode_nv12),
+        ("yuy2", tfio.experimental.image.decode_yuy2),
+    ],
+)
+def test_decode_yuv_batch(fmt, decode):
+    """Test case for batched decode_nv12 and decode_yuy2"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "Jelly-Beans.{}".format(fmt),
+    )
+    png_filename = filename + ".png"
+    png = tf.image.decode_png(tf.io.read_file(png_filename))
+
+    contents = tf.io.read_file(filename)
+    rgb = decode(tf.stack([contents] * 3), size=[256, 256])
+    assert rgb.shape == [3, 256, 256, 3]
+    assert np.all(rgb == tf.stack([png] * 3))
+
+    rgb = decode(tf.stack([contents] * 3), size=[256, 256], resize=[128, 96])
+    assert rgb.shape == [3, 128, 96, 3]
+    expected = tf.image.resize(png, [128, 96])
+    assert np.abs(rgb[0].numpy().astype(np.float32) - expected.numpy()).mean() < 8
+    assert np.all(rgb[0] == rgb[2])
+
+
 def test_decode_avif():
     """Test case for decode_avif"""
     filename = os.path.join(
@@ -390,6 +501,29 @@ def test_decode_tiff_multipage():
         image = tfio.experimental.image.decode_tiff(tf.io.read_file(filename), index=i)
 
 
+def test_decode_tiff_region():
+    """Test case for decode_tiff_region"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "multipage_tiff_example.tif",
+    )
+    for index in [0, 3]:
+        image = tfio.experimental.image.decode_tiff(
+            tf.io.read_file(filename), index=index
+        )
+        for y, x, height, width in [(0, 0, 600, 800), (17, 250, 301, 99)]:
+            region = tfio.experimental.image.decode_tiff_region(
+                filename, [y, x, height, width], index=index
+            )
+            assert region.shape == [height, width, 4]
+            assert np.array_equal(
+                region.numpy(), image[y : y + height, x : x + width].numpy()
+            )
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_tiff_region(filename, [500, 0, 200, 10])
+
+
 def test_decode_jp2():
     """Test case for decode_jp2"""
     filename = os.path.join(
@@ -434,6 +568,32 @@ def test_decode_jp2_uint16():
     assert np.array_equal(rgb, data)
 
 
+def test_decode_jp2_region():
+    """Test case for decode_jp2 with a region, a reduce and threads"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "img.jp2",
+    )
+
+    contents = tf.io.read_file(filename)
+    rgb = tfio.experimental.image.decode_jp2(contents, dtype=tf.uint16)
+
+    region = tfio.experimental.image.decode_jp2(
+        contents, dtype=tf.uint16, region=[100, 200, 64, 128], threads=0
+    )
+    assert region.shape == [64, 128, 1]
+    assert np.array_equal(region, rgb[100:164, 200:328])
+
+    thumbnail = tfio.experimental.image.decode_jp2(
+        contents, dtype=tf.uint16, reduce=1
+    )
+    assert thumbnail.shape == [256, 256, 1]
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_jp2(contents, region=[500, 0, 100, 10])
+
+
 def test_encode_gif():
     """Test case for encode_gif."""
 
@@ -454,6 +614,14 @@ def test_encode_gif():
     encoded = tf.image.decode_gif(gif)
     assert np.allclose(image, encoded, atol=8.0)
 
+    gif = tfio.image.encode_gif(image, palette="local")
+    encoded = tf.image.decode_gif(gif)
+    assert np.allclose(image, encoded, atol=8.0)
+
+    gif = tfio.image.encode_gif(image, delta=False)
+    encoded = tf.image.decode_gif(gif)
+    assert np.allclose(image, encoded, atol=8.0)
+
 
 def test_decode_tiff_16bit():
     """Test case for 16 bit tiff"""
@@ -701,3 +701,66 @@ def test_io_tensor_benchmark(benchmark, fixture_lookup, io_tensor_fixture):
     entries = benchmark(f, args)
 
     assert equal(entries, expected)
+
+
+@pytest.mark.parametrize("gpu_compatible", [False, True])
+@pytest.mark.parametrize(
+    ("kind", "op"),
+    [
+        ("csv", "IO>CSVReadableRead"),
+        ("json", "IO>JSONReadableRead"),
+        ("feather", "IO>FeatherReadableRead"),
+        ("avro", "IO>AvroReadableRead"),
+    ],
+)
+def test_io_tensor_readable_gpu_compatible(tmp_path, kind, op, gpu_compatible):
+    """test_io_tensor_readable_gpu_compatible"""
+    path = os.path.dirname(os.path.abspath(__file__))
+    n = 100
+    if kind == "csv":
+        filename = str(tmp_path / "data.csv")
+        with open(filename, "w") as f:
+            f.write("a,b\n")
+            f.writelines(f"{i},{i * 0.5}\n" for i in range(n))
+        tensor = tfio.IOTensor.from_csv(filename, gpu_compatible=gpu_compatible)
+        columns, expected = ["a", "b"], [np.arange(n), np.arange(n) * 0.5]
+    elif kind == "json":
+        filename = str(tmp_path / "data.ndjson")
+        with open(filename, "w") as f:
+            f.writelines(f'{{"a": {i}, "b": {i * 0.5}}}\n' for i in range(n))
+        tensor = tfio.IOTensor.from_json(filename, gpu_compatible=gpu_compatible)
+        columns, expected = ["a", "b"], [np.arange(n), np.arange(n) * 0.5]
+    elif kind == "feather":
+        import pandas as pd
+        from pyarrow import feather as pa_feather
+
+        filename = str(tmp_path / "data.feather")
+        pa_feather.write_feather(
+            pd.DataFrame({"a": np.arange(n), "b": np.arange(n) * 0.5}), filename
+        )
+        tensor = tfio.IOTensor.from_feather(filename, gpu_compatible=gpu_compatible)
+        columns, expected = ["a", "b"], [np.arange(n), np.arange(n) * 0.5]
+    else:
+        filename = os.path.join(path, "test_avro", "test.bin")
+        with open(os.path.join(path, "test_avro", "cpx.json")) as f:
+            schema = f.read()
+        tensor = tfio.IOTensor.from_avro(
+            filename, schema, gpu_compatible=gpu_compatible
+        )
+        columns = ["re", "im"]
+        expected = [100.0 * np.arange(n), 100.0 + np.arange(n)]
+
+    for column, values in zip(columns, expected):
+        assert np.array_equal(tensor(column).to_tensor(), values)
+        # Slices up to and past the end of the records.
+        assert np.array_equal(tensor(column)[n - 3 :], values[n - 3 :])
+        assert np.array_equal(tensor(column)[n - 3 : n + 10], values[n - 3 :])
+
+        graph = (
+            tf.function(lambda column=column: tensor(column)[10:20])
+            .get_concrete_function()
+            .graph
+        )
+        reads = [e for e in graph.get_operations() if e.type == op]
+        assert reads
+        assert all(e.get_attr("gpu_compatible") == gpu_compatible for e in reads)
@@ -226,3 +226,27 @@ def test_json_empty():
 
 if __name__ == "__main__":
     test.main()
+
+
+def test_json_stream(tmp_path):
+    """Test case for JSON Dataset streamed in splits."""
+    filename = str(tmp_path / "stream.ndjson")
+    with open(filename, "w") as f:
+        for i in range(1000):
+            f.write('{"id": %d, "name": "n%d", "score": %d.5}\n' % (i, i, i))
+
+    dataset = tfio.IODataset.from_json(
+        filename, ["score", "id"], stream=True, block_size=1024
+    )
+    assert [(s.numpy(), i.numpy()) for s, i in dataset] == [
+        (i + 0.5, i) for i in range(1000)
+    ]
+
+    size = os.path.getsize(filename)
+    ids = []
+    for offset in range(0, size, size // 3):
+        dataset = tfio.IODataset.from_json(
+            filename, ["id"], stream=True, offset=offset, length=size // 3
+        )
+        ids.extend(int(e.numpy()) for e in dataset)
+    assert ids == list(range(1000))
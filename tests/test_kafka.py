@@ -151,6 +151,18 @@ def test_kafka_io_dataset():
         )
 
 
+def test_kafka_io_dataset_parallel_reads():
+    dataset = tfio.IODataset.from_kafka(
+        "test", configuration=["fetch.min.bytes=2"], num_parallel_reads=4
+    ).batch(2)
+    # messages are still returned in offset order
+    for _ in range(2):
+        assert np.all(
+            [k.numpy().tolist() for (k, _) in dataset]
+            == np.asarray([("D" + str(i)).encode() for i in range(10)]).reshape((5, 2))
+        )
+
+
 def test_avro_encode_decode():
     """test_avro_encode_decode"""
     schema = (
@@ -49,6 +49,31 @@ def test_basic():
             assert features[i, j] == v or (np.isnan(features[i, j]) and np.isnan(v))
 
 
+def test_csr():
+    """test_csr"""
+    content = [
+        "+1 1:3.4 2:0.5 4:0.231",
+        "-1",
+        "2 3:2.5 2:nan 1:0.105",
+    ] * 2000
+    (indices, values), labels = tfio.experimental.text.decode_libsvm(
+        content, num_features=6, layout="csr"
+    )
+    sparse_features, sparse_labels = tfio.experimental.text.decode_libsvm(
+        content, num_features=6
+    )
+
+    assert np.array_equal(labels, sparse_labels)
+    assert np.array_equal(labels[:3], [1, -1, 2])
+    assert np.array_equal(indices.row_lengths()[:3], [3, 0, 3])
+    assert np.array_equal(indices.flat_values, sparse_features.indices[:, 1])
+    assert np.array_equal(
+        values.flat_values, sparse_features.values, equal_nan=True
+    )
+    assert np.array_equal(indices[2], [3, 2, 1])
+    assert np.allclose(values[0], [3.4, 0.5, 0.231])
+
+
 def test_n_dimension():
     """test_n_dimension"""
     content = [
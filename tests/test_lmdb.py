@@ -45,5 +45,33 @@ def test_lmdb_read_from_file():
         shutil.rmtree(tmp_path)
 
 
+def test_lmdb_dataset_parallel_reads():
+    """test_lmdb_dataset_parallel_reads"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_lmdb", "data.mdb"
+    )
+    tmp_path = tempfile.mkdtemp()
+    filename = os.path.join(tmp_path, "data.mdb")
+    shutil.copy(path, filename)
+
+    expected = [(str(i).encode(), str(chr(ord("a") + i)).encode()) for i in range(10)]
+    for num_parallel_reads in [None, 3, 20]:
+        dataset = tfio.IODataset.from_lmdb(
+            filename, num_parallel_reads=num_parallel_reads
+        )
+        # Each pass reads all the records, in key order only without parallel
+        # reads.
+        for _ in range(2):
+            entries = [(k.numpy(), v.numpy()) for (k, v) in dataset]
+            if num_parallel_reads is None:
+                assert entries == expected
+            else:
+                assert sorted(entries) == expected
+
+    # TODO: Not working for Windows yet
+    if sys.platform in ("linux", "darwin"):
+        shutil.rmtree(tmp_path)
+
+
 if __name__ == "__main__":
     test.main()
@@ -15,6 +15,7 @@
 
 """Tests for the mongodb datasets"""
 
+import json
 import socket
 import pytest
 import tensorflow as tf
@@ -93,6 +94,33 @@ def test_dataset_read():
     assert count == len(RECORDS)
 
 
+@pytest.mark.skipif(not is_container_running(), reason="The container is not running")
+def test_dataset_read_filter_projection_parallel():
+    """Test the filter and projection pushdown and the parallel reads"""
+
+    dataset = tfio.experimental.mongodb.MongoDBIODataset(
+        uri=URI,
+        database=DATABASE,
+        collection=COLLECTION,
+        filter={"gender": "Female"},
+        projection={"_id": 0, "name": 1},
+        batch_size=100,
+    )
+    records = [json.loads(d.numpy()) for d in dataset]
+    assert records == [{"name": "person2"}] * (len(RECORDS) // 2)
+
+    for num_parallel_reads in [1, 4]:
+        dataset = tfio.experimental.mongodb.MongoDBIODataset(
+            uri=URI,
+            database=DATABASE,
+            collection=COLLECTION,
+            num_parallel_reads=num_parallel_reads,
+        )
+        ids = [json.loads(d.numpy())["_id"]["$oid"] for d in dataset]
+        assert len(ids) == len(RECORDS)
+        assert len(set(ids)) == len(RECORDS)
+
+
 @pytest.mark.skipif(not is_container_running(), reason="The container is not running")
 def test_train_model():
     """Test the dataset by training a tf.keras model"""
@@ -172,3 +200,34 @@ def test_dataset_read_after_delete():
     for d in dataset:
         count += 1
     assert count == 0
+
+
+@pytest.mark.skipif(not is_container_running(), reason="The container is not running")
+def test_writer_write_batch():
+    """Test the bulk writes of batches of documents and of columns"""
+
+    writer = tfio.experimental.mongodb.MongoDBWriter(
+        uri=URI, database=DATABASE, collection=COLLECTION, batch_size=300
+    )
+    writer.write_batch(RECORDS)
+    writer.write_batch(
+        {
+            "name": tf.constant(["person3", "person4"]),
+            "age": tf.constant([30, 40], tf.int32),
+            "fare": tf.constant([1.5, 2.5], tf.float64),
+            "vip": tf.constant([True, False]),
+        }
+    )
+
+    dataset = tfio.experimental.mongodb.MongoDBIODataset(
+        uri=URI,
+        database=DATABASE,
+        collection=COLLECTION,
+        projection={"_id": 0},
+    )
+    records = [json.loads(d.numpy()) for d in dataset]
+    assert len(records) == len(RECORDS) + 2
+    assert {"name": "person3", "age": 30, "fare": 1.5, "vip": True} in records
+    assert {"name": "person4", "age": 40, "fare": 2.5, "vip": False} in records
+
+    writer._delete_many({})
@@ -37,3 +37,32 @@ def test_decode_obj():
         dtype=np.float32,
     )
     assert np.array_equal(obj, expected)
+
+
+def test_decode_obj_batch():
+    """Test case for decode obj batch"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_obj",
+        "sample.obj",
+    )
+    with open(filename, "rb") as f:
+        sample = f.read()
+    textured = (
+        b"v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+        b"vt 0 0\nvt 1 0\nvt 0 1\nf 1/1/1 2/2/1 3/3/1\n"
+    )
+
+    obj = tfio.experimental.image.decode_obj_batch(
+        tf.constant([sample, textured, sample])
+    )
+    expected = tfio.experimental.image.decode_obj(sample)
+    assert np.array_equal(obj["vertices"][0], expected)
+    assert np.array_equal(obj["vertices"][2], expected)
+    assert obj["vertices"].row_lengths().numpy().tolist() == [4, 3, 4]
+    assert obj["normals"].row_lengths().numpy().tolist() == [0, 1, 0]
+    assert obj["texcoords"].row_lengths().numpy().tolist() == [0, 3, 0]
+    # The quad of sample.obj is split into two triangles
+    assert obj["indices"].row_lengths().numpy().tolist() == [6, 3, 6]
+    assert np.all(obj["indices"][0][:, 1:] == -1)
+    assert obj["indices"][1].numpy().tolist() == [[0, 0, 0], [1, 0, 1], [2, 0, 2]]
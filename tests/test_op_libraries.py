@@ -0,0 +1,34 @@
+# Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Tests for the op libraries split out of libtensorflow_io.so"""
+
+import pytest
+
+import tensorflow_io as tfio  # pylint: disable=unused-import
+from tensorflow_io.python.ops import core_ops
+from tensorflow_io.python.ops import op_libraries
+
+
+@pytest.mark.parametrize("library", sorted(op_libraries.OP_LIBRARIES))
+def test_op_libraries(library):
+    """Test case for the registry of the ops of each library"""
+    ops = op_libraries.OP_LIBRARIES[library]
+    mod = core_ops._load(library)  # pylint: disable=protected-access
+    default = core_ops._load()  # pylint: disable=protected-access
+    assert len(ops) == len(mod.OP_LIST.op)
+    for op in ops:
+        assert hasattr(mod, op)
+        assert not hasattr(default, op)
+        assert getattr(core_ops, op) is getattr(mod, op)
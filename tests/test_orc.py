@@ -44,6 +44,30 @@ def test_orc_input():
     assert packets_total == 150
 
 
+def test_orc_stream():
+    """Test ORCDataset read stripe by stripe with projected columns"""
+    orc_filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_orc", "iris.orc"
+    )
+    columns = ["sepal_length", "species"]
+    expected = list(tfio.IODataset.from_orc(orc_filename, columns=columns))
+    dataset = tfio.IODataset.from_orc(
+        orc_filename,
+        columns=columns,
+        stream=True,
+        batch_size=16,
+        num_parallel_reads=2,
+        capacity=32,
+    )
+    entries = list(dataset)
+    assert len(entries) == 150
+    for (sepal_length, species), (e_sepal_length, e_species) in zip(
+        entries, expected
+    ):
+        assert sepal_length.numpy() == e_sepal_length.numpy()
+        assert species.numpy() == e_species.numpy()
+
+
 def test_orc_keras():
     """Test case for ORCDataset with Keras"""
     orc_filename = os.path.join(
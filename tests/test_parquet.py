@@ -307,3 +307,61 @@ def test_parquet_dataset_from_dir_failure():
 
 if __name__ == "__main__":
     test.main()
+
+
+def test_parquet_row_group_slices(tmp_path):
+    """Test slices across row groups, read concurrently by column"""
+    df = pd.DataFrame(
+        {
+            "int_field": np.arange(1000, dtype=np.int64),
+            "str_field": ["parquet%04d" % i for i in range(1000)],
+        }
+    )
+    filename = str(tmp_path / "row_groups.parquet")
+    df.to_parquet(filename, row_group_size=128)
+
+    parquet = tfio.IOTensor.from_parquet(filename)
+    for start in range(0, 1000, 100):
+        assert np.array_equal(
+            parquet("int_field")[start : start + 100].numpy(),
+            df["int_field"][start : start + 100].values,
+        )
+
+    dataset = tf.data.Dataset.range(0, 1000, 100).map(
+        lambda start: (
+            parquet("int_field")[start : start + 100],
+            parquet("str_field")[start : start + 100],
+        ),
+        num_parallel_calls=4,
+    )
+    for i, (ints, strs) in enumerate(dataset):
+        assert np.array_equal(ints.numpy(), df["int_field"][i * 100 : i * 100 + 100])
+        assert [s.decode() for s in strs.numpy()] == list(
+            df["str_field"][i * 100 : i * 100 + 100]
+        )
+
+
+def test_parquet_nullable_columns(tmp_path):
+    """Test masked and dictionary reads of columns with nulls"""
+    ints = [None if i % 7 == 0 else i for i in range(500)]
+    strs = [None if i % 5 == 0 else "parquet%d" % (i % 3) for i in range(500)]
+    df = pd.DataFrame({"int_field": pd.array(ints, dtype="Int64"), "str_field": strs})
+    filename = str(tmp_path / "nullable.parquet")
+    df.to_parquet(filename, row_group_size=128)
+
+    parquet = tfio.IOTensor.from_parquet(filename)
+    value, mask = parquet("int_field").to_masked_tensor(100, 400)
+    assert mask.numpy().tolist() == [e is not None for e in ints[100:400]]
+    assert value.numpy().tolist() == [0 if e is None else e for e in ints[100:400]]
+
+    indices, dictionary, mask = parquet("str_field").to_dictionary_tensor(100, 400)
+    assert mask.numpy().tolist() == [e is not None for e in strs[100:400]]
+    assert indices.numpy().tolist().count(-1) == strs[100:400].count(None)
+    assert [
+        None if i < 0 else dictionary.numpy()[i].decode() for i in indices.numpy()
+    ] == strs[100:400]
+
+    dataset = tfio.IODataset.from_parquet(filename, columns=["int_field"], masked=True)
+    assert [
+        (v.numpy(), m.numpy()) for v, m in (e["int_field"] for e in dataset)
+    ] == [(0, False) if e is None else (e, True) for e in ints]
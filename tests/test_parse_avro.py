@@ -168,11 +168,13 @@ class AvroDatasetTestBase(tf.test.TestCase):
     """AvroDatasetTestBase"""
 
     @staticmethod
-    def _setup_files(writer_schema, records):
+    def _setup_files(writer_schema, records, codec="deflate"):
         """setup_files"""
         # Write test records into temporary output directory
         filename = os.path.join(tempfile.mkdtemp(), "test.avro")
-        writer = AvroRecordsToFile(filename=filename, writer_schema=writer_schema)
+        writer = AvroRecordsToFile(
+            filename=filename, writer_schema=writer_schema, codec=codec
+        )
         writer.write_records(records)
 
         return [filename]
@@ -303,7 +305,9 @@ class AvroRecordDatasetTest(AvroDatasetTestBase):
     def _test_pass_dataset(self, writer_schema, record_data, **kwargs):
         """test_pass_dataset"""
         filenames = AvroRecordDatasetTest._setup_files(
-            writer_schema=writer_schema, records=record_data
+            writer_schema=writer_schema,
+            records=record_data,
+            codec=kwargs.get("codec", "deflate"),
         )
         expected_data = AvroRecordDatasetTest._load_records_as_tensors(
             filenames, writer_schema
@@ -363,6 +367,95 @@ class AvroRecordDatasetTest(AvroDatasetTestBase):
         ]
         self._test_pass_dataset(writer_schema=writer_schema, record_data=record_data)
 
+    def test_wout_reader_schema_complex_types(self):
+        """test_wout_reader_schema_complex_types"""
+        writer_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "index", "type": "long"},
+                  {"name": "values", "type": {"type": "array", "items": "float"}},
+                  {"name": "tags", "type": {"type": "map", "values": "string"}},
+                  {"name": "label", "type": ["null", "string"]},
+                  {
+                     "name": "child",
+                     "type": {
+                         "type": "record",
+                         "name": "child_row",
+                         "fields": [
+                             {"name": "flag", "type": "boolean"},
+                             {"name": "next", "type": ["null", "child_row"]}
+                         ]
+                     }
+                  }
+              ]}"""
+        record_data = [
+            {
+                "index": i,
+                "values": [float(v) for v in range(i)],
+                "tags": {str(v): "tag" * v for v in range(i % 3)},
+                "label": None if i % 2 else "label_{}".format(i),
+                "child": {
+                    "flag": i % 2 == 0,
+                    "next": {"flag": True, "next": None} if i % 3 else None,
+                },
+            }
+            for i in range(20)
+        ]
+        for codec in ["null", "deflate"]:
+            self._test_pass_dataset(
+                writer_schema=writer_schema, record_data=record_data, codec=codec
+            )
+
+    def test_byte_ranges(self):
+        """test_byte_ranges"""
+        writer_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "index", "type": "int"},
+                  {"name": "string_value", "type": "string"}
+              ]}"""
+        filename = os.path.join(tempfile.mkdtemp(), "test.avro")
+        with open(filename, "wb") as out:
+            writer = DataFileWriter(
+                out,
+                DatumWriter(),
+                AvroParser(writer_schema).get_schema_object(),
+                codec="deflate",
+            )
+            for i in range(100):
+                writer.append({"index": i, "string_value": "value_{}".format(i)})
+                if i % 7 == 6:
+                    # Ends the block
+                    writer.flush()
+            writer.close()
+        serializer = AvroSerializer(writer_schema)
+        expected = [
+            serializer.serialize(record)
+            for record in AvroFileToRecords(filename).get_records()
+        ]
+
+        num_blocks = tfio.experimental.columnar.write_avro_block_index(
+            filename, filename + ".idx"
+        )
+        assert num_blocks == 15
+
+        file_size = os.path.getsize(filename)
+        for block_index_suffix in [None, ".idx"]:
+            for num_ranges in [1, 3, 8, 40]:
+                bounds = [file_size * i // num_ranges for i in range(num_ranges)]
+                actual = []
+                for byte_start, byte_end in zip(bounds, bounds[1:] + [-1]):
+                    dataset = tfio.experimental.columnar.AvroRecordDataset(
+                        filenames=[filename],
+                        byte_start=byte_start,
+                        byte_end=byte_end,
+                        block_index_suffix=block_index_suffix,
+                    )
+                    actual.extend(record.numpy() for record in dataset)
+                assert actual == expected
+
     @pytest.mark.skip(reason="failed with tf 2.2 rc3 on linux")
     def test_with_schema_projection(self):
         """test_with_schema_projection"""
@@ -1480,6 +1573,159 @@ class ParseAvroDatasetTest(AvroDatasetTestBase):
             batch_size=3,
         )
 
+    @pytest.mark.skipif(sys.platform == "darwin", reason="macOS fails now")
+    def test_minibatches_fill_outputs(self):
+        """test_minibatches_fill_outputs"""
+        reader_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "id", "type": "long"},
+                  {"name": "padding", "type": "string"},
+                  {
+                     "name": "int_list",
+                     "type": {
+                        "type": "array",
+                        "items": "int"
+                     }
+                  },
+                  {
+                     "name": "long_list",
+                     "type": {
+                        "type": "array",
+                        "items": "long"
+                     }
+                  }
+              ]}"""
+        # The padding makes the batch span several minibatches
+        num_records = 150
+        record_data = [
+            {
+                "id": i,
+                "padding": "x" * 1000,
+                "int_list": list(range(i % 4)),
+                "long_list": [i] * (i % 3),
+            }
+            for i in range(num_records)
+        ]
+        features = {
+            "id": tf.io.FixedLenFeature([], tf.dtypes.int64),
+            "int_list[*]": tf.io.FixedLenFeature(
+                [3], tf.dtypes.int32, default_value=[7, 8, 9]
+            ),
+            "long_list[*]": tfio.experimental.columnar.VarLenFeatureWithRank(
+                tf.dtypes.int64, 1
+            ),
+        }
+        long_list_indices = [[i, j] for i in range(num_records) for j in range(i % 3)]
+        expected_data = [
+            {
+                "id": tf.convert_to_tensor(list(range(num_records)), tf.int64),
+                "int_list[*]": tf.convert_to_tensor(
+                    [
+                        list(range(i % 4)) + [7, 8, 9][i % 4 :]
+                        for i in range(num_records)
+                    ],
+                    tf.int32,
+                ),
+                "long_list[*]": tf.compat.v1.SparseTensorValue(
+                    indices=long_list_indices,
+                    values=[i for i, _ in long_list_indices],
+                    dense_shape=[num_records, 2],
+                ),
+            }
+        ]
+        self._test_pass_dataset(
+            reader_schema=reader_schema,
+            record_data=record_data,
+            expected_data=expected_data,
+            features=features,
+            batch_size=num_records,
+        )
+
+    def test_skips_unrequested_fields(self):
+        """test_skips_unrequested_fields"""
+        reader_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "score", "type": "float"},
+                  {"name": "weight", "type": "double"},
+                  {"name": "tag", "type": {"type": "fixed", "name": "Tag", "size": 4}},
+                  {"name": "id", "type": "long"},
+                  {"name": "comment", "type": ["null", "string"]},
+                  {
+                     "name": "attributes",
+                     "type": {"type": "map", "values": "string"}
+                  },
+                  {
+                     "name": "person",
+                     "type": {
+                        "type": "record",
+                        "name": "Person",
+                        "fields": [
+                            {"name": "name", "type": "string"},
+                            {"name": "age", "type": "int"},
+                            {
+                                "name": "scores",
+                                "type": {"type": "array", "items": "double"}
+                            }
+                        ]
+                     }
+                  },
+                  {
+                     "name": "items",
+                     "type": {
+                        "type": "array",
+                        "items": {
+                            "type": "record",
+                            "name": "Item",
+                            "fields": [
+                                {"name": "label", "type": "string"},
+                                {"name": "count", "type": "long"}
+                            ]
+                        }
+                     }
+                  }
+              ]}"""
+        record_data = [
+            {
+                "score": float(i),
+                "weight": 2.0 * i,
+                "tag": b"abcd",
+                "id": i,
+                "comment": None if i % 2 == 0 else "comment",
+                "attributes": {"key": "value"},
+                "person": {"name": "name", "age": 20 + i, "scores": [1.0] * i},
+                "items": [{"label": "label", "count": j} for j in range(i)],
+            }
+            for i in range(4)
+        ]
+        features = {
+            "id": tf.io.FixedLenFeature([], tf.dtypes.int64),
+            "person.age": tf.io.FixedLenFeature([], tf.dtypes.int32),
+            "items[*].count": tf.io.VarLenFeature(tf.dtypes.int64),
+        }
+        items_indices = [[i, j] for i in range(4) for j in range(i)]
+        expected_data = [
+            {
+                "id": tf.convert_to_tensor([0, 1, 2, 3], tf.int64),
+                "person.age": tf.convert_to_tensor([20, 21, 22, 23], tf.int32),
+                "items[*].count": tf.compat.v1.SparseTensorValue(
+                    indices=items_indices,
+                    values=[j for _, j in items_indices],
+                    dense_shape=[4, 3],
+                ),
+            }
+        ]
+        self._test_pass_dataset(
+            reader_schema=reader_schema,
+            record_data=record_data,
+            expected_data=expected_data,
+            features=features,
+            batch_size=4,
+        )
+
     @pytest.mark.skipif(sys.platform == "darwin", reason="macOS fails now")
     def test_variable_length_2d(self):
         """test_variable_length_2d"""
@@ -2466,6 +2712,64 @@ class ParseAvroDatasetTest(AvroDatasetTestBase):
             batch_size=2,
         )
 
+    def test_confluent_wire_format(self):
+        """test_confluent_wire_format"""
+        writer_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "int_value", "type": "int"},
+                  {"name": "string_value", "type": "string"}
+              ]}"""
+        reader_schema = """{
+              "type": "record",
+              "name": "row",
+              "fields": [
+                  {"name": "int_value", "type": "long"},
+                  {"name": "string_value", "type": "string"}
+              ]}"""
+        record_data = [
+            {"int_value": 0, "string_value": "a"},
+            {"int_value": 1, "string_value": "bc"},
+        ]
+        features = {
+            "int_value": tf.io.FixedLenFeature([], tf.dtypes.int64),
+            "string_value": tf.io.FixedLenFeature([], tf.dtypes.string),
+        }
+        expected_data = {
+            "int_value": tf.convert_to_tensor([0, 1, 0, 1], dtype=tf.dtypes.int64),
+            "string_value": tf.convert_to_tensor([b"a", b"bc", b"a", b"bc"]),
+        }
+        # Records of the reader schema, id 1, and of an older writer schema,
+        # id 2, that is resolved into the reader schema
+        serialized = [
+            b"\x00" + schema_id.to_bytes(4, "big") + serializer.serialize(r)
+            for schema_id, serializer in [
+                (1, AvroSerializer(reader_schema)),
+                (2, AvroSerializer(writer_schema)),
+            ]
+            for r in record_data
+        ]
+        actual = tfio.experimental.columnar.parse_avro(
+            serialized=serialized,
+            reader_schema=reader_schema,
+            features=features,
+            confluent_wire_format=True,
+            writer_schemas={1: reader_schema, 2: writer_schema},
+        )
+        self.assert_data_equal(expected=expected_data, actual=actual)
+
+        # Records without the header and of unknown schemas are rejected
+        for writer_schemas in [{1: reader_schema}, None]:
+            with self.assertRaises(tf.errors.OpError):
+                _ = tfio.experimental.columnar.parse_avro(
+                    serialized=serialized if writer_schemas else [b"\x01"],
+                    reader_schema=reader_schema,
+                    features=features,
+                    confluent_wire_format=True,
+                    writer_schemas=writer_schemas,
+                )
+
 
 if __name__ == "__main__":
     test.main()
@@ -20,6 +20,7 @@ import os
 import numpy as np
 
 import tensorflow_io as tfio
+from tensorflow_io.python.ops import core_ops
 
 
 def test_pcap_input():
@@ -65,5 +66,37 @@ def test_pcap_input():
     )  # we know this is the correct number of packets in the test pcap file
 
 
+def test_pcap_ragged():
+    """test_pcap_ragged"""
+    pcap_filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_pcap", "http.pcap"
+    )
+    expected = list(tfio.IODataset.from_pcap(pcap_filename).as_numpy_iterator())
+
+    dataset = tfio.IODataset.from_pcap(pcap_filename, capacity=10, ragged=True)
+    timestamps, packets = [], []
+    for label, value in dataset:
+        assert label.shape[0] == value.nrows()
+        timestamps.extend(label.numpy())
+        packets.extend(bytes(v) for v in value.numpy())
+    assert timestamps == [t for t, _ in expected]
+    assert packets == [p for _, p in expected]
+
+    # Slices read out of order seek instead of failing or rescanning
+    dataset = tfio.IODataset.from_pcap(pcap_filename)
+    resource = dataset._resource  # pylint: disable=protected-access
+    for start in [30, 5, 40, 0]:
+        label, row_splits, value = core_ops.io_pcap_readable_read_ragged(
+            resource, start=start, stop=start + 3
+        )
+        stop = min(start + 3, len(expected))
+        assert list(label.numpy()) == [t for t, _ in expected[start:stop]]
+        data = value.numpy().tobytes()
+        splits = row_splits.numpy()
+        assert [
+            data[splits[i] : splits[i + 1]] for i in range(len(splits) - 1)
+        ] == [p for _, p in expected[start:stop]]
+
+
 if __name__ == "__main__":
     test.main()
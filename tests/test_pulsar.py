@@ -239,5 +239,44 @@ def test_pulsar_write_keyed_messages():
     assert kv["2"] == [("msg-" + str(i)).encode() for i in range(2, 10, 3)]
 
 
+
+@pytest.mark.skipif(
+    sys.platform in ("win32",),
+    reason="TODO Pulsar not setup properly on Windows yet",
+)
+def test_pulsar_write_batch_and_batch_receive():
+    """Test writing batches of messages with producer batching and compression,
+    and consuming them with batch receive"""
+
+    topic = "test-write-batch-messages"
+    writer = tfio.experimental.streaming.PulsarWriter(
+        service_url="pulsar://localhost:6650",
+        topic=topic,
+        batching_max_messages=100,
+        compression="lz4",
+    )
+    # 1. Write 100 messages in 4 batches, the keys set is 0,1,2,0,1,2,...
+    for i in range(0, 100, 25):
+        writer.write_batch(
+            ["msg-" + str(j) for j in range(i, i + 25)],
+            [str(j % 3) for j in range(i, i + 25)],
+        )
+    writer.flush()
+
+    # 2. Consume messages with batch receive and verify
+    dataset = tfio.experimental.streaming.PulsarIODataset(
+        service_url="pulsar://localhost:6650",
+        topic=topic,
+        subscription="subscription-0",
+        timeout=default_pulsar_timeout,
+        batch_receive_max_messages=32,
+        batch_receive_timeout=100,
+    )
+    messages = [(msg.numpy(), key.numpy()) for (msg, key) in dataset]
+    assert messages == [
+        (("msg-" + str(i)).encode(), str(i % 3).encode()) for i in range(100)
+    ]
+
+
 if __name__ == "__main__":
     test.main()
@@ -15,6 +15,7 @@
 """Tests for S3 file system"""
 
 import os
+import subprocess
 import sys
 import time
 import tempfile
@@ -56,3 +57,43 @@ def test_read_file():
 
     content = tf.io.read_file(f"s3://{bucket_name}/{key_name}")
     assert content == body
+
+
+@pytest.mark.skipif(
+    sys.platform in ("win32", "darwin"),
+    reason="TODO file system plugins not tested on macOS/Windows yet",
+)
+def test_read_file_retried():
+    """Test case for reads of S3 retried after throttled requests"""
+    from tests.test_filesystem_benchmark import mock_object_store
+    from tests.test_filesystem_benchmark import object_store_benchmark
+
+    # Half of the requests fail with a 503 SlowDown, whose error body the SDK
+    # writes into the response stream before it retries the request.
+    profile = mock_object_store.Profile(throttle_rate=0.5, seed=7)
+    with mock_object_store.MockObjectStore(mock_object_store.S3, profile) as store:
+        data = os.urandom(300000)
+        store.put("bucket/object", data)
+        env = dict(os.environ)
+        env.update(
+            object_store_benchmark.plugin_environment(
+                mock_object_store.S3, store.endpoint
+            )
+        )
+        env.update(
+            {"S3_DISABLE_MULTI_PART_DOWNLOAD": "1", "S3_READ_AHEAD_WINDOWS": "0"}
+        )
+        script = (
+            "import sys, tensorflow as tf, tensorflow_io\n"
+            "with tf.io.gfile.GFile('s3://bucket/object', 'rb') as f:\n"
+            "    sys.stdout.write(f.read().hex())\n"
+        )
+        output = subprocess.run(
+            [sys.executable, "-c", script],
+            env=env,
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout
+        assert store.throttled > 0
+    assert bytes.fromhex(output.strip().splitlines()[-1]) == data
@@ -170,6 +170,39 @@ def test_serialization_encode(
     )
 
 
+def test_encode_avro_batch(fixture_lookup):
+    """test_encode_avro_batch"""
+    _, _, specs = fixture_lookup("avro")
+    value = {
+        "station": tf.constant(["011990-99999", "", "012650-99999"], tf.string),
+        "time": tf.constant([-619524000000, 0, 1], tf.int64),
+        "temp": tf.constant([0, -11, 22], tf.int32),
+    }
+
+    encoded = tfio.experimental.serialization.encode_avro(value, specs)
+    assert encoded.shape == [3]
+    for i in range(3):
+        returned = tfio.experimental.serialization.decode_avro(encoded[i], specs)
+        for k, v in value.items():
+            assert np.array_equal(v[i], returned[k])
+
+    def zigzag(n):
+        n = (n << 1) ^ (n >> 63)
+        b = bytearray()
+        while n > 0x7F:
+            b.append((n & 0x7F) | 0x80)
+            n >>= 7
+        b.append(n)
+        return bytes(b)
+
+    block = tfio.experimental.serialization.encode_avro(
+        value, specs, container_block=True
+    )
+    assert block.shape == []
+    records = b"".join(encoded.numpy())
+    assert block.numpy() == zigzag(3) + zigzag(len(records)) + records
+
+
 @pytest.mark.parametrize(
     ("serialization_fixture", "decode_function"),
     [
@@ -214,3 +247,21 @@ def test_decode_json_partial_shape():
 
     v = parse_json(r)
     assert np.array_equal(v, [1, 2, 3, 4, 5])
+
+
+def test_decode_json_batch(fixture_lookup):
+    """Test case for decoding a batch of JSON strings at once."""
+    data, value, specs = fixture_lookup("json")
+
+    returned = tfio.experimental.serialization.decode_json(
+        tf.constant([data, data, data]), specs
+    )
+    tf.nest.assert_same_structure(value, returned)
+    for v, r in zip(tf.nest.flatten(value), tf.nest.flatten(returned)):
+        assert r.shape[0] == 3
+        assert all(np.array_equal(v, e) for e in r)
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.serialization.decode_json(
+            tf.constant([data, '{"R": {}}']), specs
+        )
@@ -767,3 +767,36 @@ def test_gfile_glob(fs, patchs, monkeypatch):
 
     txt_files = tf.io.gfile.glob(join(dname, "*.txt"))
     assert sorted(txt_files) == sorted(childs)
+
+
+@pytest.mark.parametrize(
+    "fs, patchs",
+    [(S3_URI, None), (AZ_URI, None), (GCS_URI, None)],
+    indirect=["fs"],
+)
+def test_gfile_glob_patterns(fs, patchs, monkeypatch):
+    _, path_to, _, write, _, join, _ = fs
+    mock_patchs(monkeypatch, patchs)
+
+    dname = path_to("test_gfile_glob_patterns/")
+    names = ["a1.txt", "a2.txt", "ab.txt", "a*.txt", "b1.txt", "c.md"]
+    names += ["d1/x.txt", "d2/x.txt", "d2/y.md", "e1/x.txt"]
+    for name in names:
+        write(join(dname, name), b"123456789")
+
+    def glob(pattern):
+        return sorted(tf.io.gfile.glob(join(dname, pattern)))
+
+    def paths(*names):
+        return sorted(join(dname, name) for name in names)
+
+    assert glob("*.txt") == paths("a1.txt", "a2.txt", "ab.txt", "a*.txt", "b1.txt")
+    assert glob("a?.txt") == paths("a1.txt", "a2.txt", "ab.txt", "a*.txt")
+    assert glob("[ab]1.txt") == paths("a1.txt", "b1.txt")
+    assert glob("a[0-9].txt") == paths("a1.txt", "a2.txt")
+    assert glob("a[!0-9].txt") == paths("ab.txt", "a*.txt")
+    assert glob("a\\*.txt") == paths("a*.txt")
+    assert glob("d[0-9]/*.txt") == paths("d1/x.txt", "d2/x.txt")
+    assert glob("d2/*") == paths("d2/x.txt", "d2/y.md")
+    assert glob("*/x.txt") == paths("d1/x.txt", "d2/x.txt", "e1/x.txt")
+    assert glob("f*/x.txt") == []
@@ -56,6 +56,40 @@ def test_read_text():
             assert entries[k].numpy().decode() + "\n" == v.decode()
 
 
+def test_read_text_large():
+    """test_read_text_large"""
+    lines = [f"line {i} " * (i % 7) for i in range(200000)]
+    tmp_path = tempfile.mkdtemp()
+    filename = os.path.join(tmp_path, "large.txt")
+    with open(filename, "wb") as f:
+        for i, line in enumerate(lines):
+            f.write((line + ("\r\n" if i % 3 == 0 else "\n")).encode())
+    filesize = os.path.getsize(filename)
+
+    offsets = []
+    offset = 0
+    for i, line in enumerate(lines):
+        offsets.append(offset)
+        offset += len(line) + (2 if i % 3 == 0 else 1)
+
+    # Chunks of several MB are split across the worker threads.
+    with open(filename, "rb") as f:
+        memory = f.read()
+    for kwargs in [{}, {"memory": memory}]:
+        for offset, length in [(0, -1), (1, -1), (123457, 3000000), (0, 1)]:
+            entries = tfio.experimental.text.read_text(
+                filename, offset=offset, length=length, **kwargs
+            )
+            if length < 0:
+                length = filesize - offset
+            expected = [
+                line
+                for (k, line) in zip(offsets, lines)
+                if offset <= k < offset + length
+            ]
+            assert [e.decode() for e in entries.numpy()] == expected
+
+
 @pytest.mark.skip(reason="TODO")
 def test_text_output_sequence():
     """Test case based on fashion mnist tutorial"""
@@ -108,6 +142,9 @@ def test_text_output_sequence():
                     self._sequence.setitem(index, class_names[np.argmax(output)])
                     index += 1
 
+        def on_predict_end(self, logs=None):
+            self._sequence.flush()
+
     f, filename = tempfile.mkstemp()
     os.close(f)
     # By default batch size is 32
@@ -121,6 +158,26 @@ def test_text_output_sequence():
         assert line == prediction
 
 
+def test_text_output_sequence_order():
+    """test_text_output_sequence_order"""
+    f, filename = tempfile.mkstemp()
+    os.close(f)
+    items = [f"item {i}" for i in range(1000)]
+    sequence = tfio.experimental.text.TextOutputSequence(filename)
+    # Items are written in order of their index once those before them are set.
+    order = list(range(len(items)))
+    np.random.shuffle(order)
+    for index in order:
+        sequence.setitem(index, items[index])
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        sequence.setitem(order[0], items[order[0]])
+    sequence.flush()
+    with open(filename) as f:
+        lines = [line.rstrip("\n") for line in f]
+    assert lines == items
+    os.remove(filename)
+
+
 def test_re2_extract():
     """test_text_input"""
     filename = os.path.join(
@@ -148,5 +205,28 @@ def test_re2_extract():
     assert i == len(lines)
 
 
+def test_re2_full_match_set():
+    """test_re2_full_match_set"""
+    patterns = [r"ERROR .*", r".*timeout.*", r"INFO .*", r"\d+"]
+    lines = [
+        "ERROR connection timeout",
+        "INFO started",
+        "12345",
+        "DEBUG nothing",
+    ]
+    expected = [
+        [i for i, p in enumerate(patterns) if re.fullmatch(p, line)]
+        for line in lines
+    ]
+    ids = tfio.experimental.text.re2_full_match_set(lines, patterns)
+    assert ids.to_list() == expected
+
+    ids = tfio.experimental.text.re2_full_match_set([lines[:2], lines[2:]], patterns)
+    assert ids.to_list() == [expected[:2], expected[2:]]
+
+    ids = tfio.experimental.text.re2_full_match_set(lines[0], patterns)
+    assert ids.numpy().tolist() == expected[0]
+
+
 if __name__ == "__main__":
     test.main()